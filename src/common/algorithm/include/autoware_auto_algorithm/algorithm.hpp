@@ -17,5 +17,6 @@
 #define AUTOWARE_AUTO_ALGORITHM__ALGORITHM_HPP_
 
 #include <autoware_auto_algorithm/quick_sort.hpp>
+#include <autoware_auto_algorithm/radix_sort.hpp>
 
 #endif  // AUTOWARE_AUTO_ALGORITHM__ALGORITHM_HPP_
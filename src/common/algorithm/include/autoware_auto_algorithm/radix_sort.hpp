@@ -0,0 +1,411 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/// \file
+/// \brief This file provides a stable radix sort for integer and floating point keys.
+#ifndef AUTOWARE_AUTO_ALGORITHM__RADIX_SORT_HPP_
+#define AUTOWARE_AUTO_ALGORITHM__RADIX_SORT_HPP_
+
+#include <thread_pool/parallel.hpp>
+#include <thread_pool/thread_pool.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace autoware
+{
+
+namespace common
+{
+
+namespace algorithm
+{
+
+/// \brief Maps a key to an unsigned integer of the same size that sorts in the same order.
+/// Specialized for integer and floating point keys.
+template<typename KeyT, typename Enable = void>
+struct RadixKeyTraits;
+
+/// \brief Unsigned integers are their own radix keys
+template<typename KeyT>
+struct RadixKeyTraits<KeyT,
+  typename std::enable_if<std::is_integral<KeyT>::value && std::is_unsigned<KeyT>::value>::type>
+{
+  using BitsT = KeyT;
+  static BitsT to_bits(const KeyT key) noexcept {return key;}
+};
+
+/// \brief Signed integers sort like unsigned integers with the sign bit flipped
+template<typename KeyT>
+struct RadixKeyTraits<KeyT,
+  typename std::enable_if<std::is_integral<KeyT>::value && std::is_signed<KeyT>::value>::type>
+{
+  using BitsT = typename std::make_unsigned<KeyT>::type;
+  static BitsT to_bits(const KeyT key) noexcept
+  {
+    constexpr auto SIGN_BIT = static_cast<BitsT>(BitsT{1U} << ((8U * sizeof(BitsT)) - 1U));
+    return static_cast<BitsT>(static_cast<BitsT>(key) ^ SIGN_BIT);
+  }
+};
+
+/// \brief IEEE 754 floating point numbers sort like unsigned integers if all bits of negative
+/// numbers and only the sign bit of positive numbers are flipped. -0 sorts before +0, NaNs with
+/// the sign bit set before -inf and other NaNs after +inf.
+template<typename KeyT>
+struct RadixKeyTraits<KeyT, typename std::enable_if<std::is_floating_point<KeyT>::value>::type>
+{
+  static_assert(
+    std::numeric_limits<KeyT>::is_iec559 && ((sizeof(KeyT) == 4U) || (sizeof(KeyT) == 8U)),
+    "RadixKeyTraits: only 32 and 64 bit IEEE 754 floating point keys are supported");
+  using BitsT = typename std::conditional<sizeof(KeyT) == 4U, std::uint32_t, std::uint64_t>::type;
+  static BitsT to_bits(const KeyT key) noexcept
+  {
+    constexpr auto SIGN_BIT = static_cast<BitsT>(BitsT{1U} << ((8U * sizeof(BitsT)) - 1U));
+    BitsT bits;
+    (void)std::memcpy(&bits, &key, sizeof(bits));
+    return ((bits & SIGN_BIT) != 0U) ? static_cast<BitsT>(~bits) : (bits | SIGN_BIT);
+  }
+};
+
+namespace details
+{
+/// \brief Number of bits sorted per pass
+constexpr std::uint32_t RADIX_SORT_DIGIT_BITS = 8U;
+/// \brief Number of buckets per pass
+constexpr std::size_t RADIX_SORT_NUM_BUCKETS = 1U << RADIX_SORT_DIGIT_BITS;
+/// \brief Maximum number of passes, for 64 bit keys
+constexpr std::size_t RADIX_SORT_MAX_PASSES = sizeof(std::uint64_t);
+/// \brief Minimum number of elements per worker for sorting on more than one thread
+constexpr std::size_t RADIX_SORT_MIN_PARALLEL_SIZE = 16384U;
+
+}  // namespace details
+
+/// \brief Stable least significant digit radix sort by integer or floating point keys, e.g. of
+/// key-index pairs. It sorts in O(n) for a fixed key size, with one pass per byte of the key where
+/// the keys differ. The scratch memory is allocated up front, so sorting does not allocate.
+/// Optionally, the passes are split over the workers of a thread pool. As the sort is stable, the
+/// result is the same for any number of threads.
+/// \tparam T The type of the elements to sort, must be default constructible and move assignable
+template<typename T>
+class RadixSorter
+{
+public:
+  RadixSorter(RadixSorter const &) = delete;
+  RadixSorter & operator=(RadixSorter const &) = delete;
+  RadixSorter(RadixSorter &&) = default;
+  /// \brief Move equals operator
+  RadixSorter & operator=(RadixSorter &&) = default;
+
+  /// \brief Default constructor, do not reserve capacity for the scratch memory
+  RadixSorter()
+  : m_histograms(details::RADIX_SORT_MAX_PASSES),
+    m_offsets(1U)
+  {
+  }
+
+  /// \brief Construct and reserve scratch memory, sort large ranges on a shared thread pool
+  /// \param[in] capacity The maximum size of the ranges to be sorted
+  /// \param[in] pool The pool to sort on together with the calling thread, must outlive the sorter
+  RadixSorter(const ::std::size_t capacity, thread_pool::ThreadPool & pool)
+  : m_histograms((pool.size() + 1U) * details::RADIX_SORT_MAX_PASSES),
+    m_offsets(pool.size() + 1U),
+    m_pool(&pool)
+  {
+    reserve(capacity);
+  }
+
+  /// \brief Construct and reserve scratch memory
+  /// \param[in] capacity The maximum size of the ranges to be sorted
+  /// \param[in] num_threads The number of threads to sort large ranges on, including the calling
+  ///                        thread. Prefer sharing a pool with the other constructor
+  /// \throw std::domain_error If num_threads is zero
+  explicit RadixSorter(const ::std::size_t capacity, const ::std::size_t num_threads = 1U)
+  {
+    if (num_threads == 0U) {
+      throw ::std::domain_error("RadixSorter: Number of threads must be positive");
+    }
+    if (num_threads > 1U) {
+      thread_pool::ThreadPoolConfig config;
+      config.num_threads = num_threads - 1U;
+      m_owned_pool = ::std::make_unique<thread_pool::ThreadPool>(config);
+      m_pool = m_owned_pool.get();
+    }
+    m_histograms.resize(num_threads * details::RADIX_SORT_MAX_PASSES);
+    m_offsets.resize(num_threads);
+    reserve(capacity);
+  }
+
+  /// \brief Sorts the range [first, last) stably by the keys of the elements
+  /// \param[in] first Start of the range to sort
+  /// \param[in] last End of the range to sort (not included)
+  /// \param[in] key_fn Returns the integer or floating point key of an element, is called several
+  ///                   times per element and must not throw
+  /// \throw std::length_error If the range is larger than the capacity
+  /// \tparam RandomIt A random access iterator to elements of type T
+  /// \tparam KeyFn A functor type that returns the key of a T
+  template<typename RandomIt, typename KeyFn>
+  void sort(const RandomIt first, const RandomIt last, const KeyFn key_fn) const
+  {
+    const auto dist = ::std::distance(first, last);
+    if (dist < 2) {
+      return;
+    }
+    const auto size = static_cast<::std::size_t>(dist);
+    if (size > m_buffer.size()) {
+      throw ::std::length_error("RadixSorter: Range is larger than the capacity");
+    }
+    using KeyT = typename ::std::decay<decltype(key_fn(*first))>::type;
+    using BitsT = typename RadixKeyTraits<KeyT>::BitsT;
+    constexpr ::std::size_t num_passes = sizeof(BitsT);
+
+    Context<RandomIt, KeyFn> ctx{this, first, key_fn, size, 1U, 0U, true};
+    if (m_pool && (size >= (2U * details::RADIX_SORT_MIN_PARALLEL_SIZE))) {
+      ctx.num_workers =
+        ::std::min(num_threads(), size / details::RADIX_SORT_MIN_PARALLEL_SIZE);
+    }
+    // Count all digits at once, the totals tell which passes can be skipped
+    run(ctx, &RadixSorter::count_task<RandomIt, KeyFn, BitsT, num_passes>);
+    ::std::array<bool, num_passes> skip{};
+    for (::std::size_t pass = 0U; pass < num_passes; ++pass) {
+      for (::std::size_t bucket = 0U; bucket < details::RADIX_SORT_NUM_BUCKETS; ++bucket) {
+        ::std::size_t count = 0U;
+        for (::std::size_t worker = 0U; worker < ctx.num_workers; ++worker) {
+          count += histogram(worker, pass)[bucket];
+        }
+        if (count != 0U) {
+          skip[pass] = (count == size);
+          break;
+        }
+      }
+    }
+
+    bool first_pass = true;
+    for (::std::size_t pass = 0U; pass < num_passes; ++pass) {
+      if (skip[pass]) {
+        continue;
+      }
+      ctx.pass = pass;
+      // The chunks of the workers only have the initial counts before the first pass
+      if ((!first_pass) && (ctx.num_workers > 1U)) {
+        run(ctx, &RadixSorter::count_task<RandomIt, KeyFn, BitsT, 0U>);
+      }
+      first_pass = false;
+      // Elements of a chunk go behind those of the previous chunks with the same digit
+      ::std::size_t offset = 0U;
+      for (::std::size_t bucket = 0U; bucket < details::RADIX_SORT_NUM_BUCKETS; ++bucket) {
+        for (::std::size_t worker = 0U; worker < ctx.num_workers; ++worker) {
+          m_offsets[worker][bucket] = offset;
+          offset += histogram(worker, pass)[bucket];
+        }
+      }
+      run(ctx, &RadixSorter::scatter_task<RandomIt, KeyFn, BitsT>);
+      ctx.from_range = !ctx.from_range;
+    }
+    if (!ctx.from_range) {
+      run(ctx, &RadixSorter::move_back_task<RandomIt, KeyFn>);
+    }
+  }
+
+  /// \brief Sorts a range of integer or floating point values stably
+  /// \param[in] first Start of the range to sort
+  /// \param[in] last End of the range to sort (not included)
+  /// \throw std::length_error If the range is larger than the capacity
+  /// \tparam RandomIt A random access iterator to elements of type T
+  template<typename RandomIt>
+  void sort(const RandomIt first, const RandomIt last) const
+  {
+    sort(first, last, [](const T & value) {return value;});
+  }
+
+  /// \brief Reserves the scratch memory such that no heap allocation is done during sorting
+  /// \param[in] capacity The maximum size of the ranges to be sorted
+  void reserve(const ::std::size_t capacity)
+  {
+    if (capacity > m_buffer.size()) {
+      m_buffer.resize(capacity);
+    }
+  }
+
+  /// \brief Returns the maximum size of a range that can be sorted
+  ::std::size_t capacity() const noexcept
+  {
+    return m_buffer.size();
+  }
+
+  /// \brief Returns the number of threads that large ranges are sorted on
+  ::std::size_t num_threads() const noexcept
+  {
+    return (nullptr != m_pool) ? (m_pool->size() + 1U) : 1U;
+  }
+
+private:
+  /// \brief A part of the sort, gets called with the context and the index of the worker
+  using Task = void (*)(void * context, ::std::size_t worker);
+  using Histogram = ::std::array<::std::size_t, details::RADIX_SORT_NUM_BUCKETS>;
+
+  /// \brief The state of a sort, shared by the workers
+  template<typename RandomIt, typename KeyFn>
+  struct Context
+  {
+    const RadixSorter * sorter;
+    RandomIt first;
+    KeyFn key_fn;
+    ::std::size_t size;
+    ::std::size_t num_workers;
+    ::std::size_t pass;
+    /// Whether the elements are in the range, otherwise in the scratch memory
+    bool from_range;
+
+    ::std::size_t chunk_begin(const ::std::size_t worker) const noexcept
+    {
+      return (size * worker) / num_workers;
+    }
+  };
+
+  template<typename BitsT, typename KeyFn, typename ElementT>
+  static ::std::size_t digit(
+    const KeyFn & key_fn, const ElementT & element,
+    const ::std::size_t pass)
+  {
+    using KeyT = typename ::std::decay<decltype(key_fn(element))>::type;
+    const BitsT bits = RadixKeyTraits<KeyT>::to_bits(key_fn(element));
+    return static_cast<::std::size_t>((bits >> (pass * details::RADIX_SORT_DIGIT_BITS)) & 0xFFU);
+  }
+
+  /// \brief Count the digits of the chunk of a worker. All digits if NumPasses is positive,
+  ///        otherwise the digit of the current pass.
+  template<typename RandomIt, typename KeyFn, typename BitsT, ::std::size_t NumPasses>
+  static void count_task(void * const context, const ::std::size_t worker)
+  {
+    const auto & ctx = *static_cast<const Context<RandomIt, KeyFn> *>(context);
+    const auto begin = static_cast<::std::ptrdiff_t>(ctx.chunk_begin(worker));
+    const auto end = static_cast<::std::ptrdiff_t>(ctx.chunk_begin(worker + 1U));
+    if (ctx.from_range) {
+      ctx.sorter->template count<BitsT>(ctx, worker, ctx.first + begin, ctx.first + end, NumPasses);
+    } else {
+      const auto buffer = ctx.sorter->m_buffer.begin();
+      ctx.sorter->template count<BitsT>(ctx, worker, buffer + begin, buffer + end, NumPasses);
+    }
+  }
+
+  template<typename BitsT, typename RandomIt, typename KeyFn, typename SrcIt>
+  void count(
+    const Context<RandomIt, KeyFn> & ctx, const ::std::size_t worker, const SrcIt begin,
+    const SrcIt end, const ::std::size_t num_passes) const
+  {
+    if (num_passes == 0U) {
+      auto & hist = histogram(worker, ctx.pass);
+      hist.fill(0U);
+      for (auto it = begin; it != end; ++it) {
+        ++hist[digit<BitsT>(ctx.key_fn, *it, ctx.pass)];
+      }
+      return;
+    }
+    for (::std::size_t pass = 0U; pass < num_passes; ++pass) {
+      histogram(worker, pass).fill(0U);
+    }
+    for (auto it = begin; it != end; ++it) {
+      for (::std::size_t pass = 0U; pass < num_passes; ++pass) {
+        ++histogram(worker, pass)[digit<BitsT>(ctx.key_fn, *it, pass)];
+      }
+    }
+  }
+
+  /// \brief Move the chunk of a worker to its place for the digit of the current pass
+  template<typename RandomIt, typename KeyFn, typename BitsT>
+  static void scatter_task(void * const context, const ::std::size_t worker)
+  {
+    const auto & ctx = *static_cast<const Context<RandomIt, KeyFn> *>(context);
+    const auto begin = static_cast<::std::ptrdiff_t>(ctx.chunk_begin(worker));
+    const auto end = static_cast<::std::ptrdiff_t>(ctx.chunk_begin(worker + 1U));
+    const auto buffer = ctx.sorter->m_buffer.begin();
+    if (ctx.from_range) {
+      scatter<BitsT>(ctx, worker, ctx.first + begin, ctx.first + end, buffer);
+    } else {
+      scatter<BitsT>(ctx, worker, buffer + begin, buffer + end, ctx.first);
+    }
+  }
+
+  template<typename BitsT, typename RandomIt, typename KeyFn, typename SrcIt, typename DstIt>
+  static void scatter(
+    const Context<RandomIt, KeyFn> & ctx, const ::std::size_t worker, const SrcIt begin,
+    const SrcIt end, const DstIt dst)
+  {
+    auto & offsets = ctx.sorter->m_offsets[worker];
+    for (auto it = begin; it != end; ++it) {
+      const auto idx = offsets[digit<BitsT>(ctx.key_fn, *it, ctx.pass)]++;
+      dst[static_cast<typename ::std::iterator_traits<DstIt>::difference_type>(idx)] =
+        ::std::move(*it);
+    }
+  }
+
+  /// \brief Move the chunk of a worker from the scratch memory back to the range
+  template<typename RandomIt, typename KeyFn>
+  static void move_back_task(void * const context, const ::std::size_t worker)
+  {
+    const auto & ctx = *static_cast<const Context<RandomIt, KeyFn> *>(context);
+    const auto buffer = ctx.sorter->m_buffer.begin();
+    const auto begin = static_cast<::std::ptrdiff_t>(ctx.chunk_begin(worker));
+    const auto end = static_cast<::std::ptrdiff_t>(ctx.chunk_begin(worker + 1U));
+    (void)::std::move(buffer + begin, buffer + end, ctx.first + begin);
+  }
+
+  template<typename RandomIt, typename KeyFn>
+  void run(Context<RandomIt, KeyFn> & ctx, const Task task) const
+  {
+    if (ctx.num_workers > 1U) {
+      // One chunk per worker, as the histograms and offsets are per worker
+      thread_pool::parallel_for(
+        *m_pool, 0U, ctx.num_workers, 1U,
+        [task, &ctx](const ::std::size_t begin, const ::std::size_t end) {
+          for (auto worker = begin; worker < end; ++worker) {
+            task(&ctx, worker);
+          }
+        });
+    } else {
+      task(&ctx, 0U);
+    }
+  }
+
+  Histogram & histogram(const ::std::size_t worker, const ::std::size_t pass) const
+  {
+    return m_histograms[(worker * details::RADIX_SORT_MAX_PASSES) + pass];
+  }
+
+  /// Scratch memory that the elements are moved to in every other pass
+  mutable ::std::vector<T> m_buffer;
+  /// Digit counts per worker and pass
+  mutable ::std::vector<Histogram> m_histograms;
+  /// Next position per worker and digit in the current pass
+  mutable ::std::vector<Histogram> m_offsets;
+  /// The pool if the sorter was constructed with a number of threads
+  ::std::unique_ptr<thread_pool::ThreadPool> m_owned_pool;
+  thread_pool::ThreadPool * m_pool{nullptr};
+};
+
+}  // namespace algorithm
+
+}  // namespace common
+
+}  // namespace autoware
+
+#endif  // AUTOWARE_AUTO_ALGORITHM__RADIX_SORT_HPP_
@@ -0,0 +1,156 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "autoware_auto_algorithm/algorithm.hpp"
+
+template<typename T>
+using RadixSorter = ::autoware::common::algorithm::RadixSorter<T>;
+
+TEST(radix_sort, empty_and_single) {
+  RadixSorter<int32_t> sorter;
+  ::std::vector<int32_t> vector;
+  sorter.sort(vector.begin(), vector.end());
+  ASSERT_EQ(sorter.capacity(), 0UL);
+  // A single element fits without capacity
+  vector = {42};
+  sorter.sort(vector.begin(), vector.end());
+  ASSERT_EQ(vector, ::std::vector<int32_t>({42}));
+}
+
+TEST(radix_sort, integers) {
+  ::std::vector<int32_t> vector = {5, -1, 300, -70000, 0, 2, 2,
+    ::std::numeric_limits<int32_t>::min(), ::std::numeric_limits<int32_t>::max(), -2};
+  RadixSorter<int32_t> sorter(vector.size());
+  ASSERT_EQ(sorter.capacity(), vector.size());
+  auto expected = vector;
+  ::std::sort(expected.begin(), expected.end());
+  sorter.sort(vector.begin(), vector.end());
+  ASSERT_EQ(vector, expected);
+
+  ::std::vector<uint16_t> small = {7U, 65535U, 0U, 256U, 255U};
+  RadixSorter<uint16_t> small_sorter(small.size());
+  small_sorter.sort(small.begin(), small.end());
+  ASSERT_EQ(small, ::std::vector<uint16_t>({0U, 7U, 255U, 256U, 65535U}));
+}
+
+TEST(radix_sort, floats) {
+  constexpr auto INF = ::std::numeric_limits<float>::infinity();
+  ::std::vector<float> vector = {1.5F, -0.25F, INF, 0.0F, -INF, 1.0e-30F, -3.0e20F, 7.0F, -0.0F,
+    ::std::numeric_limits<float>::denorm_min()};
+  RadixSorter<float> sorter(vector.size());
+  sorter.sort(vector.begin(), vector.end());
+  const ::std::vector<float> expected = {-INF, -3.0e20F, -0.25F, -0.0F, 0.0F,
+    ::std::numeric_limits<float>::denorm_min(), 1.0e-30F, 1.5F, 7.0F, INF};
+  ASSERT_EQ(vector, expected);
+  // -0 before +0
+  EXPECT_TRUE(::std::signbit(vector[3U]));
+  EXPECT_FALSE(::std::signbit(vector[4U]));
+
+  ::std::vector<double> doubles = {2.0, -1.0e300, 0.5, -0.5};
+  RadixSorter<double> double_sorter(doubles.size());
+  double_sorter.sort(doubles.begin(), doubles.end());
+  ASSERT_EQ(doubles, ::std::vector<double>({-1.0e300, -0.5, 0.5, 2.0}));
+}
+
+TEST(radix_sort, capacity) {
+  ::std::vector<int32_t> vector = {3, 2, 1};
+  RadixSorter<int32_t> sorter(2U);
+  EXPECT_THROW(sorter.sort(vector.begin(), vector.end()), ::std::length_error);
+  sorter.reserve(vector.size());
+  sorter.sort(vector.begin(), vector.end());
+  ASSERT_EQ(vector, ::std::vector<int32_t>({1, 2, 3}));
+  EXPECT_THROW(RadixSorter<int32_t>(1U, 0U), ::std::domain_error);
+}
+
+// Key-index pairs are sorted stably, also when spread over threads
+TEST(radix_sort, key_index_pairs) {
+  using KeyIndex = ::std::pair<float, ::std::size_t>;
+  const auto by_key = [](const KeyIndex & pair) {return pair.first;};
+  ::std::mt19937 gen{42U};
+  // Few distinct keys to get many ties
+  ::std::uniform_int_distribution<int32_t> dist{-500, 500};
+  ::std::vector<KeyIndex> pairs;
+  for (::std::size_t idx = 0U; idx < 100000U; ++idx) {
+    pairs.emplace_back(0.25F * static_cast<float>(dist(gen)), idx);
+  }
+  auto expected = pairs;
+  ::std::stable_sort(
+    expected.begin(), expected.end(),
+    [](const KeyIndex & a, const KeyIndex & b) {return a.first < b.first;});
+
+  for (const ::std::size_t num_threads : {1U, 2U, 4U}) {
+    RadixSorter<KeyIndex> sorter(pairs.size(), num_threads);
+    EXPECT_EQ(sorter.num_threads(), num_threads);
+    auto sorted = pairs;
+    sorter.sort(sorted.begin(), sorted.end(), by_key);
+    ASSERT_EQ(sorted, expected) << num_threads;
+    // Sorting again reuses the scratch memory
+    sorter.sort(sorted.begin(), sorted.end(), by_key);
+    ASSERT_EQ(sorted, expected) << num_threads;
+  }
+}
+
+// 64 bit keys, e.g. packed voxel indices, where most of the high bytes are the same
+TEST(radix_sort, voxel_keys) {
+  ::std::mt19937_64 gen{7U};
+  ::std::vector<uint64_t> keys;
+  for (::std::size_t idx = 0U; idx < 70000U; ++idx) {
+    keys.push_back((uint64_t{0x12U} << 56U) | (gen() & 0xFFFFFFU));
+  }
+  auto expected = keys;
+  ::std::sort(expected.begin(), expected.end());
+  RadixSorter<uint64_t> sorter(keys.size(), 3U);
+  sorter.sort(keys.begin(), keys.end());
+  ASSERT_EQ(keys, expected);
+}
+
+// Several sorters can share one pool, also from inside its tasks
+TEST(radix_sort, shared_pool) {
+  ::autoware::common::thread_pool::ThreadPoolConfig config;
+  config.num_threads = 2U;
+  ::autoware::common::thread_pool::ThreadPool pool{config};
+  ::std::mt19937 gen{3U};
+  ::std::uniform_int_distribution<int32_t> dist{-100000, 100000};
+  ::std::vector<::std::vector<int32_t>> vectors(2U);
+  for (auto & vector : vectors) {
+    for (::std::size_t idx = 0U; idx < 50000U; ++idx) {
+      vector.push_back(dist(gen));
+    }
+  }
+  auto expected = vectors;
+  for (auto & vector : expected) {
+    ::std::sort(vector.begin(), vector.end());
+  }
+  ::std::vector<RadixSorter<int32_t>> sorters;
+  for (::std::size_t idx = 0U; idx < vectors.size(); ++idx) {
+    sorters.emplace_back(vectors[idx].size(), pool);
+    EXPECT_EQ(sorters[idx].num_threads(), 3U);
+  }
+  ::autoware::common::thread_pool::parallel_for(
+    pool, 0U, vectors.size(), 1U,
+    [&sorters, &vectors](const ::std::size_t begin, const ::std::size_t end) {
+      for (auto idx = begin; idx < end; ++idx) {
+        sorters[idx].sort(vectors[idx].begin(), vectors[idx].end());
+      }
+    });
+  ASSERT_EQ(vectors, expected);
+}
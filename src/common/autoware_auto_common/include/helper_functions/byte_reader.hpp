@@ -33,14 +33,21 @@ namespace helper_functions
 class ByteReader
 {
 private:
-  const std::vector<uint8_t> & byte_vector_;
+  const uint8_t * byte_vector_;
   std::size_t index_;
 
 public:
   /// \brief Default constructor, byte reader class
   /// \param[in] byte_vector A vector to read bytes from
   explicit ByteReader(const std::vector<uint8_t> & byte_vector)
-  : byte_vector_(byte_vector),
+  : ByteReader(byte_vector.data())
+  {
+  }
+
+  /// \brief Constructor to read bytes in place, e.g. from a slice of a larger buffer
+  /// \param[in] bytes The first byte to read, the caller makes sure that enough bytes follow
+  explicit ByteReader(const uint8_t * bytes)
+  : byte_vector_(bytes),
     index_(0U)
   {
   }
@@ -22,7 +22,12 @@
 #define GEOMETRY__BOUNDING_BOX__LFIT_HPP_
 
 #include <geometry/bounding_box/eigenbox_2d.hpp>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <iterator>
 #include <limits>
+#include <stdexcept>
 #include <utility>
 
 namespace autoware
@@ -33,6 +38,20 @@ namespace geometry
 {
 namespace bounding_box
 {
+/// \brief Parameters of the angle search in lfit_search_bounding_box_2d
+struct LFitSearchConfig
+{
+  /// \brief Number of blocks of details::LFIT_SEARCH_BLOCK_SIZE orientations that are spread
+  ///        evenly over [0, pi/2) in the coarse search. The default gives a 5.6 deg spacing.
+  std::size_t coarse_blocks{2U};
+  /// \brief Number of refinements around the best orientation so far, each evaluates one block
+  ///        and makes the spacing 4.5 times finer
+  std::size_t refine_iterations{2U};
+  /// \brief Lower bound of the distance of a point to the box edges in the closeness score, so
+  ///        that single points on the edges don't dominate it
+  float32_t min_distance{0.01F};
+};  // struct LFitSearchConfig
+
 namespace details
 {
 
@@ -226,6 +245,121 @@ BoundingBox lfit_bounding_box_2d_impl(const IT begin, const IT end, const std::s
 
   return bbox;
 }
+
+/// \brief Number of orientations that the L-fit angle search evaluates in one pass over the
+///        points. The per orientation values are stored in arrays of this size that the compiler
+///        maps to SIMD registers, the points are broadcast into them.
+constexpr std::size_t LFIT_SEARCH_BLOCK_SIZE = 8U;
+/// \brief One value per orientation of a block
+using LFitSearchBlock = std::array<float32_t, LFIT_SEARCH_BLOCK_SIZE>;
+
+/// \brief A block of orientations and the extents of the points in the box frames they define
+struct LFitSearchWs
+{
+  /// \brief Cosine of the orientations
+  LFitSearchBlock cos_th;
+  /// \brief Sine of the orientations
+  LFitSearchBlock sin_th;
+  /// \brief Smallest projection onto (cos, sin)
+  LFitSearchBlock min1;
+  /// \brief Largest projection onto (cos, sin)
+  LFitSearchBlock max1;
+  /// \brief Smallest projection onto (-sin, cos)
+  LFitSearchBlock min2;
+  /// \brief Largest projection onto (-sin, cos)
+  LFitSearchBlock max2;
+};  // struct LFitSearchWs
+
+/// \brief Compute the extents of the points for all orientations of a block in one pass
+/// \param[in] begin An iterator pointing to the first point in a point list
+/// \param[in] end An iterator pointing to one past the last point in the point list
+/// \param[inout] ws The block with the orientations set, the extents get computed
+/// \tparam IT An iterator type dereferencable into a point with float members x and y
+template<typename IT>
+void lfit_search_extents(const IT begin, const IT end, LFitSearchWs & ws)
+{
+  ws.min1.fill(std::numeric_limits<float32_t>::max());
+  ws.max1.fill(-std::numeric_limits<float32_t>::max());
+  ws.min2.fill(std::numeric_limits<float32_t>::max());
+  ws.max2.fill(-std::numeric_limits<float32_t>::max());
+  for (auto it = begin; it != end; ++it) {
+    const float32_t px = point_adapter::x_(*it);
+    const float32_t py = point_adapter::y_(*it);
+    // Branch free so that the orientations are processed as one vector
+    for (std::size_t idx = 0U; idx < LFIT_SEARCH_BLOCK_SIZE; ++idx) {
+      const float32_t c1 = (px * ws.cos_th[idx]) + (py * ws.sin_th[idx]);
+      const float32_t c2 = (py * ws.cos_th[idx]) - (px * ws.sin_th[idx]);
+      ws.min1[idx] = (c1 < ws.min1[idx]) ? c1 : ws.min1[idx];
+      ws.max1[idx] = (c1 > ws.max1[idx]) ? c1 : ws.max1[idx];
+      ws.min2[idx] = (c2 < ws.min2[idx]) ? c2 : ws.min2[idx];
+      ws.max2[idx] = (c2 > ws.max2[idx]) ? c2 : ws.max2[idx];
+    }
+  }
+}
+
+/// \brief Compute the closeness score, as proposed in "Efficient L-Shape Fitting for Vehicle
+///        Detection Using Laser Scanners", for all orientations of a block in one pass
+/// \param[in] begin An iterator pointing to the first point in a point list
+/// \param[in] end An iterator pointing to one past the last point in the point list
+/// \param[in] ws The block with the orientations and the extents of the points
+/// \param[in] min_distance Lower bound of the distance of a point to the box edges
+/// \param[out] score The sum of the inverse distances of the points to their nearest box edge,
+///                   higher is better
+/// \tparam IT An iterator type dereferencable into a point with float members x and y
+template<typename IT>
+void lfit_search_closeness(
+  const IT begin, const IT end, const LFitSearchWs & ws, const float32_t min_distance,
+  LFitSearchBlock & score)
+{
+  score.fill(0.0F);
+  for (auto it = begin; it != end; ++it) {
+    const float32_t px = point_adapter::x_(*it);
+    const float32_t py = point_adapter::y_(*it);
+    for (std::size_t idx = 0U; idx < LFIT_SEARCH_BLOCK_SIZE; ++idx) {
+      const float32_t c1 = (px * ws.cos_th[idx]) + (py * ws.sin_th[idx]);
+      const float32_t c2 = (py * ws.cos_th[idx]) - (px * ws.sin_th[idx]);
+      const float32_t d1_lo = c1 - ws.min1[idx];
+      const float32_t d1_hi = ws.max1[idx] - c1;
+      const float32_t d2_lo = c2 - ws.min2[idx];
+      const float32_t d2_hi = ws.max2[idx] - c2;
+      const float32_t d1 = (d1_lo < d1_hi) ? d1_lo : d1_hi;
+      const float32_t d2 = (d2_lo < d2_hi) ? d2_lo : d2_hi;
+      const float32_t d = (d1 < d2) ? d1 : d2;
+      score[idx] += 1.0F / ((d > min_distance) ? d : min_distance);
+    }
+  }
+}
+
+/// \brief Evaluate a block of evenly spaced orientations
+/// \param[in] begin An iterator pointing to the first point in a point list
+/// \param[in] end An iterator pointing to one past the last point in the point list
+/// \param[in] first_angle The first orientation of the block in radians
+/// \param[in] step The spacing of the orientations in radians
+/// \param[in] min_distance Lower bound of the distance of a point to the box edges
+/// \return A pair of the best orientation of the block and its closeness score
+/// \tparam IT An iterator type dereferencable into a point with float members x and y
+template<typename IT>
+std::pair<float32_t, float32_t> lfit_search_block(
+  const IT begin, const IT end, const float32_t first_angle, const float32_t step,
+  const float32_t min_distance)
+{
+  LFitSearchWs ws;
+  for (std::size_t idx = 0U; idx < LFIT_SEARCH_BLOCK_SIZE; ++idx) {
+    const float32_t th = first_angle + (static_cast<float32_t>(idx) * step);
+    ws.cos_th[idx] = std::cos(th);
+    ws.sin_th[idx] = std::sin(th);
+  }
+  lfit_search_extents(begin, end, ws);
+  LFitSearchBlock score;
+  lfit_search_closeness(begin, end, ws, min_distance, score);
+  std::size_t best_idx = 0U;
+  for (std::size_t idx = 1U; idx < LFIT_SEARCH_BLOCK_SIZE; ++idx) {
+    if (score[idx] > score[best_idx]) {
+      best_idx = idx;
+    }
+  }
+  return std::make_pair(first_angle + (static_cast<float32_t>(best_idx) * step), score[best_idx]);
+}
 }  // namespace details
 
 /// \brief Compute bounding box which best fits an L-shaped cluster. Uses the method proposed
@@ -276,6 +410,70 @@ BoundingBox lfit_bounding_box_2d(const IT begin, const IT end)
   (void)eig2;
   return lfit_bounding_box_2d(begin, end, eig1, cov.num_points);
 }
+
+/// \brief Compute bounding box which best fits an L-shaped cluster by searching the orientation
+///        with the best closeness score, as proposed in "Efficient L-Shape Fitting for Vehicle
+///        Detection Using Laser Scanners". The orientations are first searched coarsely and then
+///        refined around the best one, several orientations are evaluated per pass over the
+///        points. Unlike lfit_bounding_box_2d, the points are not reordered.
+/// \param[in] begin An iterator pointing to the first point in a point list
+/// \param[in] end An iterator pointing to one past the last point in the point list
+/// \param[in] config The parameters of the search
+/// \return An oriented bounding box in x-y, value field is the closeness score. This bounding box
+///         has no height information
+/// \tparam IT An iterator type dereferencable into a point with float members x and y
+/// \throw std::domain_error If the number of points is too few or there are no coarse blocks
+template<typename IT>
+BoundingBox lfit_search_bounding_box_2d(
+  const IT begin,
+  const IT end,
+  const LFitSearchConfig & config = LFitSearchConfig{})
+{
+  if ((begin == end) || (std::next(begin) == end)) {
+    throw std::domain_error("LFit requires >= 2 points!");
+  }
+  if (config.coarse_blocks == 0U) {
+    throw std::domain_error("LFit search requires at least one coarse block");
+  }
+  constexpr float32_t HALF_PI = 1.57079632679F;
+  constexpr auto BLOCK_SIZE = details::LFIT_SEARCH_BLOCK_SIZE;
+  // A box is the same for orientations that are pi/2 apart
+  float32_t step = HALF_PI / static_cast<float32_t>(config.coarse_blocks * BLOCK_SIZE);
+  std::pair<float32_t, float32_t> best{0.0F, -std::numeric_limits<float32_t>::max()};
+  for (std::size_t block = 0U; block < config.coarse_blocks; ++block) {
+    const float32_t first_angle = static_cast<float32_t>(block * BLOCK_SIZE) * step;
+    const auto candidate =
+      details::lfit_search_block(begin, end, first_angle, step, config.min_distance);
+    if (candidate.second > best.second) {
+      best = candidate;
+    }
+  }
+  for (std::size_t iteration = 0U; iteration < config.refine_iterations; ++iteration) {
+    // Cover the open interval between the neighbours of the best orientation
+    const float32_t fine_step = (2.0F * step) / static_cast<float32_t>(BLOCK_SIZE + 1U);
+    const auto candidate = details::lfit_search_block(
+      begin, end, (best.first - step) + fine_step, fine_step, config.min_distance);
+    if (candidate.second > best.second) {
+      best = candidate;
+    }
+    step = fine_step;
+  }
+
+  using PointT = details::base_type<decltype(*begin)>;
+  PointT best_normal;
+  point_adapter::xr_(best_normal) = std::cos(best.first);
+  point_adapter::yr_(best_normal) = std::sin(best.first);
+  auto best_tangent = get_normal(best_normal);
+  details::Point4<IT> supports;
+  const bool8_t is_ccw = details::compute_supports(begin, end, best_normal, best_tangent, supports);
+  if (is_ccw) {
+    std::swap(best_normal, best_tangent);
+  }
+  BoundingBox bbox = details::compute_bounding_box(best_normal, best_tangent, supports);
+  bbox.value = best.second;
+
+  return bbox;
+}
 }  // namespace bounding_box
 }  // namespace geometry
 }  // namespace common
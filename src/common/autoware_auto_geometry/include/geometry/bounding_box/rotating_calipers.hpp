@@ -27,6 +27,7 @@
 #include <cstring>
 #include <limits>
 #include <list>
+#include <vector>
 
 namespace autoware
 {
@@ -259,7 +260,7 @@ BoundingBox minimum_perimeter_bounding_box(const IT begin, const IT end)
 }
 
 /// \brief Compute the minimum area bounding box given an unstructured list of points.
-/// Only a list is supported as it enables the convex hull to be formed in O(n log n) time and
+/// A list is used as it enables the convex hull to be formed in O(n log n) time and
 /// without memory allocation.
 /// \param[inout] list A list of points to form a hull around, gets reordered
 /// \return A minimum area bounding box, value field is the area
@@ -272,7 +273,7 @@ BoundingBox minimum_area_bounding_box(std::list<PointT> & list)
 }
 
 /// \brief Compute the minimum perimeter bounding box given an unstructured list of points
-/// Only a list is supported as it enables the convex hull to be formed in O(n log n) time and
+/// A list is used as it enables the convex hull to be formed in O(n log n) time and
 /// without memory allocation.
 /// \param[inout] list A list of points to form a hull around, gets reordered
 /// \return A minimum perimeter bounding box, value field is half the perimeter
@@ -283,6 +284,30 @@ BoundingBox minimum_perimeter_bounding_box(std::list<PointT> & list)
   const auto last = convex_hull(list);
   return minimum_perimeter_bounding_box(list.cbegin(), last);
 }
+
+/// \brief Compute the minimum area bounding box given an unstructured vector of points, with the
+/// convex hull formed in place in O(n log n) time
+/// \param[inout] points A vector of points to form a hull around, gets reordered
+/// \return A minimum area bounding box, value field is the area
+/// \tparam PointT Point type of the vector, must have float members x and y
+template<typename PointT>
+BoundingBox minimum_area_bounding_box(std::vector<PointT> & points)
+{
+  const auto last = convex_hull(points.begin(), points.end());
+  return minimum_area_bounding_box(points.begin(), last);
+}
+
+/// \brief Compute the minimum perimeter bounding box given an unstructured vector of points, with
+/// the convex hull formed in place in O(n log n) time
+/// \param[inout] points A vector of points to form a hull around, gets reordered
+/// \return A minimum perimeter bounding box, value field is half the perimeter
+/// \tparam PointT Point type of the vector, must have float members x and y
+template<typename PointT>
+BoundingBox minimum_perimeter_bounding_box(std::vector<PointT> & points)
+{
+  const auto last = convex_hull(points.begin(), points.end());
+  return minimum_perimeter_bounding_box(points.begin(), last);
+}
 }  // namespace bounding_box
 }  // namespace geometry
 }  // namespace common
@@ -16,7 +16,7 @@
 
 /// \file
 /// \brief This file implements the monotone chain algorithm to compute 2D convex hulls on linked
-///        lists of points
+///        lists of points and on random access ranges of points
 
 #ifndef GEOMETRY__CONVEX_HULL_HPP_
 #define GEOMETRY__CONVEX_HULL_HPP_
@@ -27,8 +27,10 @@
 //lint -e537 NOLINT pclint vs cpplint
 #include <algorithm>
 //lint -e537 NOLINT pclint vs cpplint
+#include <iterator>
 #include <list>
 #include <limits>
+#include <type_traits>
 #include <utility>
 
 using autoware::common::types::float32_t;
@@ -168,6 +170,69 @@ typename std::list<PointT>::const_iterator convex_hull_impl(std::list<PointT> &
   list.splice(ret, tmp_hull_list);
   return ret;
 }
+
+/// \brief Forms a chain of the convex hull in place, with the front of the range as stack.
+/// \param[in] stack_bottom The first point of the stack, which is never popped
+/// \param[in] begin The first point to process, [stack_bottom, begin) is the current stack
+/// \param[in] end One after the last point to process, [begin, end) is assumed to be sorted in
+///                the direction of the chain
+/// \return An iterator pointing to one after the stack, the points popped from the stack are moved
+///         to the positions between it and end
+/// \tparam IT A random access iterator type dereferencable into a point type
+template<typename IT>
+IT form_chain(const IT stack_bottom, const IT begin, const IT end)
+{
+  auto stack_end = begin;
+  for (auto point_it = begin; point_it != end; ++point_it) {
+    // pop points from the stack until the point is a ccw turn from the top of the stack
+    while ((std::distance(stack_bottom, stack_end) > 1) &&
+      ccw(*std::prev(stack_end, 2), *std::prev(stack_end), *point_it))
+    {
+      --stack_end;
+    }
+    // a point between stack_end and point_it is one that was already processed
+    std::iter_swap(stack_end, point_it);
+    ++stack_end;
+  }
+  return stack_end;
+}
+
+/// \brief An allocation free implementation of convex hull computation on random access ranges.
+///        Reorders the range such that the convex hull comes first, see convex_hull()
+/// \param[in] begin An iterator pointing to the first point of the range
+/// \param[in] end An iterator pointing to one past the last point of the range
+/// \return An iterator pointing to one after the last point contained in the hull
+/// \tparam IT A random access iterator type dereferencable into a point type
+template<typename IT>
+IT convex_hull_impl(const IT begin, const IT end)
+{
+  using PointT = typename std::iterator_traits<IT>::value_type;
+  // Lexical order (a.x < b.x), sorted by y if tied. Unlike for lists, ties are exact because
+  // std::sort requires a strict weak ordering.
+  const auto lexical_less = [](const PointT & a, const PointT & b) -> bool8_t
+    {
+      using point_adapter::x_;
+      using point_adapter::y_;
+      return (x_(a) < x_(b)) || (!(x_(b) < x_(a)) && (y_(a) < y_(b)));
+    };
+  std::sort(begin, end, lexical_less);
+  // Lower hull from the left-most to the right-most point, the rest follows in no order
+  const auto lower_hull_end = form_chain(begin, begin, end);
+  // Upper hull from the right-most point back to the left
+  std::sort(
+    lower_hull_end, end, [&lexical_less](const PointT & a, const PointT & b) {
+      return lexical_less(b, a);
+    });
+  const auto lower_hull_back = std::prev(lower_hull_end);
+  auto hull_end = form_chain(lower_hull_back, lower_hull_end, end);
+  // Close the upper hull at the left-most point, which already is at the front
+  while ((std::distance(lower_hull_back, hull_end) > 1) &&
+    ccw(*std::prev(hull_end, 2), *std::prev(hull_end), *begin))
+  {
+    --hull_end;
+  }
+  return hull_end;
+}
 }  // namespace details
 
 /// \brief A static memory implementation of convex hull computation. Shuffles points around the
@@ -187,6 +252,31 @@ typename std::list<PointT>::const_iterator convex_hull(std::list<PointT> & list)
   return (list.size() <= 3U) ? list.end() : details::convex_hull_impl(list);
 }
 
+/// \brief A static memory implementation of convex hull computation on random access ranges, e.g.
+///        a std::vector that is reused as buffer between calls. Swaps the points of the range such
+///        that the points of the convex hull come first, with the internal points following in
+///        an unspecified order.
+///
+///        The first point will be the point with the smallest x value, with the other points
+///        following in a counter-clockwise manner (from a top down view/facing -z direction). If
+///        the range has 3 or fewer points, nothing is done (e.g. the ordering result as
+///        previously stated does not hold). The points are sorted and kept in contiguous memory
+///        rather than spliced between list nodes, which is faster for all but the smallest ranges.
+/// \param[in] begin An iterator pointing to the first point of the range
+/// \param[in] end An iterator pointing to one past the last point of the range
+/// \return An iterator pointing to one after the last point contained in the hull
+/// \tparam IT A random access iterator type dereferencable into a point type with float members
+///            x and y
+template<typename IT>
+IT convex_hull(const IT begin, const IT end)
+{
+  static_assert(
+    std::is_base_of<std::random_access_iterator_tag,
+    typename std::iterator_traits<IT>::iterator_category>::value,
+    "convex_hull(begin, end) needs random access iterators, use convex_hull(list) otherwise");
+  return (std::distance(begin, end) <= 3) ? end : details::convex_hull_impl(begin, end);
+}
+
 }  // namespace geometry
 }  // namespace common
 }  // namespace autoware
@@ -31,6 +31,9 @@
 #include <utility>
 #include <type_traits>
 #include <algorithm>
+#include <array>
+#include <cstddef>
+#include <stdexcept>
 
 namespace autoware
 {
@@ -50,6 +53,46 @@ using autoware::common::geometry::closest_line_point_2d;
 
 using Point = geometry_msgs::msg::Point32;
 
+/// \brief A polygon with a fixed capacity of corners, stored in place (e.g. on the stack). It is
+/// the result of the allocation free intersection functions for std::array polygons.
+/// \tparam PointT Point type that have the adapters for the x and y fields.
+/// \tparam CapacityN The maximum number of corners
+template<typename PointT, std::size_t CapacityN>
+class StaticPolygon
+{
+public:
+  using value_type = PointT;
+  using iterator = typename std::array<PointT, CapacityN>::iterator;
+  using const_iterator = typename std::array<PointT, CapacityN>::const_iterator;
+
+  iterator begin() noexcept {return m_points.begin();}
+  iterator end() noexcept {return std::next(m_points.begin(), static_cast<std::ptrdiff_t>(m_size));}
+  const_iterator begin() const noexcept {return m_points.begin();}
+  const_iterator end() const noexcept
+  {
+    return std::next(m_points.begin(), static_cast<std::ptrdiff_t>(m_size));
+  }
+  const PointT & operator[](const std::size_t idx) const noexcept {return m_points[idx];}
+  std::size_t size() const noexcept {return m_size;}
+  bool empty() const noexcept {return m_size == 0U;}
+  void clear() noexcept {m_size = 0U;}
+
+  /// \brief Append a corner
+  /// \throws std::length_error if the polygon already has CapacityN corners
+  void push_back(const PointT & pt)
+  {
+    if (m_size >= CapacityN) {
+      throw std::length_error("StaticPolygon: capacity exceeded");
+    }
+    m_points[m_size] = pt;
+    ++m_size;
+  }
+
+private:
+  std::array<PointT, CapacityN> m_points{};
+  std::size_t m_size{0U};
+};
+
 namespace details
 {
 
@@ -156,6 +199,96 @@ void append_intersection_points(
 }
 
 
+/// \brief Copy the corners of a convex polygon and order them CCW, starting at the left-most
+/// corner, without allocating memory.
+/// \param[in] polygon Corners of a convex polygon in any order
+/// \param[out] corners The CCW ordered corners, collinear and duplicate corners are removed
+/// \return The number of corners in `corners`
+template<typename PointT, std::size_t N>
+std::size_t ccw_corners(const std::array<PointT, N> & polygon, std::array<PointT, N> & corners)
+{
+  static_assert(N > 0U, "A polygon needs at least one corner");
+  corners = polygon;
+  // The range version of the convex hull also orders triangles, unlike convex_hull()
+  const auto hull_end = details::convex_hull_impl(corners.begin(), corners.end());
+  return static_cast<std::size_t>(std::distance(corners.begin(), hull_end));
+}
+
+/// \brief Get the normals of the faces of a CCW ordered polygon, pointing outwards
+template<typename PointT, std::size_t N>
+void face_normals(
+  const std::array<PointT, N> & corners, const std::size_t size,
+  std::array<PointT, N> & normals)
+{
+  for (std::size_t idx = 0U; idx < size; ++idx) {
+    const auto & next = corners[(idx + 1U) % size];
+    normals[idx] = minus_2d(get_normal(minus_2d(next, corners[idx])));
+  }
+}
+
+/// \brief Extent (min, max) of the corners of a polygon projected onto a direction
+template<typename PointT, std::size_t N>
+std::pair<float32_t, float32_t> projected_extent(
+  const PointT & direction, const std::array<PointT, N> & corners, const std::size_t size)
+{
+  auto extent = std::make_pair(dot_2d(direction, corners[0U]), dot_2d(direction, corners[0U]));
+  for (std::size_t idx = 1U; idx < size; ++idx) {
+    const auto position = dot_2d(direction, corners[idx]);
+    extent.first = std::min(extent.first, position);
+    extent.second = std::max(extent.second, position);
+  }
+  return extent;
+}
+
+/// \brief Check whether the face normals of polygon 1 contain a separating axis with polygon 2
+/// \param[in] normals1 Face normals of polygon 1
+/// \param[in] extents1 Extents of polygon 1 along its face normals, see projected_extent()
+/// \param[in] size1 Number of faces of polygon 1
+/// \param[in] corners2 CCW ordered corners of polygon 2
+/// \param[in] size2 Number of corners of polygon 2
+template<typename PointT, std::size_t N1, std::size_t N2>
+bool has_separating_face(
+  const std::array<PointT, N1> & normals1,
+  const std::array<std::pair<float32_t, float32_t>, N1> & extents1, const std::size_t size1,
+  const std::array<PointT, N2> & corners2, const std::size_t size2)
+{
+  constexpr auto eps = std::numeric_limits<float32_t>::epsilon();
+  for (std::size_t idx = 0U; idx < size1; ++idx) {
+    const auto extent2 = projected_extent(normals1[idx], corners2, size2);
+    if (extents1[idx].first > extent2.second + eps || extent2.first > extents1[idx].second + eps) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/// \brief A convex polygon prepared for many separating axis tests, without allocation
+template<typename PointT, std::size_t N>
+struct SatPolygon
+{
+  explicit SatPolygon(const std::array<PointT, N> & polygon)
+  : size{ccw_corners(polygon, corners)}
+  {
+    face_normals(corners, size, normals);
+    for (std::size_t idx = 0U; idx < size; ++idx) {
+      extents[idx] = projected_extent(normals[idx], corners, size);
+    }
+  }
+
+  /// \brief Check whether the polygon intersects with another one
+  template<std::size_t OtherN>
+  bool intersects(const SatPolygon<PointT, OtherN> & other) const
+  {
+    return !has_separating_face(normals, extents, size, other.corners, other.size) &&
+           !has_separating_face(other.normals, other.extents, other.size, corners, size);
+  }
+
+  std::array<PointT, N> corners;
+  std::size_t size;
+  std::array<PointT, N> normals;
+  std::array<std::pair<float32_t, float32_t>, N> extents;
+};
+
 }  // namespace details
 
 // TODO(s.me) implement GJK(+EPA) algorithm as well as per Chris Ho's suggestion
@@ -221,6 +354,41 @@ bool intersect(const Iter begin1, const Iter end1, const Iter begin2, const Iter
   return true;
 }
 
+/// \brief Check if two convex polygons with a fixed number of corners, e.g. the corners of
+/// oriented bounding boxes, intersect. Same as intersect() on iterators, but all of the separating
+/// axis test is done on the stack, without any allocation.
+/// \tparam PointT Point type that have the adapters for the x and y fields.
+/// \param[in] polygon1 Corners of the first convex polygon, in any order
+/// \param[in] polygon2 Corners of the second convex polygon, in any order
+/// \return true if the polygons collide, false otherwise.
+template<typename PointT, std::size_t N1, std::size_t N2>
+bool intersect(const std::array<PointT, N1> & polygon1, const std::array<PointT, N2> & polygon2)
+{
+  return details::SatPolygon<PointT, N1>{polygon1}.intersects(
+    details::SatPolygon<PointT, N2>{polygon2});
+}
+
+/// \brief Find the first of many convex polygons that intersects a given one, e.g. the obstacles
+/// around a vehicle. The faces of the given polygon are only computed once, and no memory is
+/// allocated.
+/// \tparam PointT Point type that have the adapters for the x and y fields.
+/// \tparam Iter Iterator over std::array<PointT, M> polygons
+/// \param[in] polygon Corners of the convex polygon to test against, in any order
+/// \param[in] begin Start iterator of the polygons to test
+/// \param[in] end End iterator of the polygons to test
+/// \return An iterator to the first polygon that intersects with `polygon`, or `end` if none
+template<typename PointT, std::size_t N, typename Iter>
+Iter find_intersecting(const std::array<PointT, N> & polygon, const Iter begin, const Iter end)
+{
+  using OtherT = typename std::iterator_traits<Iter>::value_type;
+  const details::SatPolygon<PointT, N> sat_polygon{polygon};
+  return std::find_if(
+    begin, end, [&sat_polygon](const OtherT & other) {
+      return sat_polygon.intersects(
+        details::SatPolygon<PointT, std::tuple_size<OtherT>::value>{other});
+    });
+}
+
 /// \brief Get the intersection between two polygons. The polygons should be provided in an
 /// identical format to the output of `convex_hull` function as in the corners should be ordered
 /// in a CCW fashion.
@@ -256,6 +424,61 @@ std::list<PointT> convex_polygon_intersection2d(
 }
 
 
+/// \brief Get the intersection between two convex polygons with a fixed number of corners, e.g.
+/// the corners of oriented bounding boxes, without any allocation. The second polygon clips the
+/// first one (Sutherland-Hodgman), which is exact for convex polygons and needs at most N1 + N2
+/// corners.
+/// \tparam PointT Point type that have the adapters for the x and y fields.
+/// \param polygon1 A convex polygon, its corners in any order
+/// \param polygon2 A convex polygon, its corners in any order
+/// \return The resulting convex polygon in CCW order, empty if the polygons don't intersect or
+/// one of them spans no area
+/// \throws std::length_error If rounding leaves more than N1 + N2 corners, which only happens
+/// for polygons that aren't convex
+template<typename PointT, std::size_t N1, std::size_t N2>
+StaticPolygon<PointT, N1 + N2> convex_polygon_intersection2d(
+  const std::array<PointT, N1> & polygon1,
+  const std::array<PointT, N2> & polygon2)
+{
+  StaticPolygon<PointT, N1 + N2> result;
+  std::array<PointT, N1> corners1;
+  const auto size1 = details::ccw_corners(polygon1, corners1);
+  std::array<PointT, N2> corners2;
+  const auto size2 = details::ccw_corners(polygon2, corners2);
+  if ((size1 < 3U) || (size2 < 3U)) {
+    return result;
+  }
+  for (std::size_t idx = 0U; idx < size1; ++idx) {
+    result.push_back(corners1[idx]);
+  }
+
+  StaticPolygon<PointT, N1 + N2> input;
+  for (std::size_t edge_idx = 0U; (edge_idx < size2) && !result.empty(); ++edge_idx) {
+    // Keep the part of the polygon on the left of the edge
+    const auto & edge_start = corners2[edge_idx];
+    const auto edge = minus_2d(corners2[(edge_idx + 1U) % size2], edge_start);
+    input = result;
+    result.clear();
+    auto prev = input[input.size() - 1U];
+    auto prev_side = cross_2d(edge, minus_2d(prev, edge_start));
+    for (const auto & current : input) {
+      const auto current_side = cross_2d(edge, minus_2d(current, edge_start));
+      if ((current_side >= 0.0F) != (prev_side >= 0.0F)) {
+        // The sides differ in sign, so there is no division by zero
+        const auto t = prev_side / (prev_side - current_side);
+        result.push_back(plus_2d(prev, times_2d(minus_2d(current, prev), t)));
+      }
+      if (current_side >= 0.0F) {
+        result.push_back(current);
+      }
+      prev = current;
+      prev_side = current_side;
+    }
+  }
+  return result;
+}
+
+
 /// \brief Compute the intersection over union of two 2d convex polygons. If any of the polygons
 /// span a zero area, the result is 0.0.
 /// \tparam Iterable1T A container class that has stl style iterators defined.
@@ -297,6 +520,47 @@ common::types::float32_t convex_intersection_over_union_2d(
   return intersection_area / union_area;
 }
 
+/// \brief Compute the intersection over union of two 2d convex polygons with a fixed number of
+/// corners, e.g. the corners of oriented bounding boxes, without any allocation. If any of the
+/// polygons span a zero area, the result is 0.0.
+/// \tparam PointT Point type that have the adapters for the x and y fields.
+/// \param polygon1 A convex polygon, its corners in any order
+/// \param polygon2 A convex polygon, its corners in any order
+/// \return (Intersection / Union) between two given polygons.
+/// \throws std::domain_error If there is any inconsistency on the undderlying geometrical
+/// computation.
+template<typename PointT, std::size_t N1, std::size_t N2>
+common::types::float32_t convex_intersection_over_union_2d(
+  const std::array<PointT, N1> & polygon1,
+  const std::array<PointT, N2> & polygon2)
+{
+  constexpr auto eps = std::numeric_limits<float32_t>::epsilon();
+  const auto intersection = convex_polygon_intersection2d(polygon1, polygon2);
+
+  const auto intersection_area =
+    common::geometry::area_2d(intersection.begin(), intersection.end());
+
+  if (intersection_area < eps) {
+    return 0.0F;  // There's either no intersection or the points are collinear
+  }
+
+  std::array<PointT, N1> corners1;
+  const auto size1 = details::ccw_corners(polygon1, corners1);
+  std::array<PointT, N2> corners2;
+  const auto size2 = details::ccw_corners(polygon2, corners2);
+  const auto polygon1_area = common::geometry::area_2d(
+    corners1.begin(), std::next(corners1.begin(), static_cast<std::ptrdiff_t>(size1)));
+  const auto polygon2_area = common::geometry::area_2d(
+    corners2.begin(), std::next(corners2.begin(), static_cast<std::ptrdiff_t>(size2)));
+
+  const auto union_area = polygon1_area + polygon2_area - intersection_area;
+  if (union_area < eps) {
+    throw std::domain_error("IoU is undefined for polygons with a zero union area");
+  }
+
+  return intersection_area / union_area;
+}
+
 }  // namespace geometry
 }  // namespace common
 }  // namespace autoware
@@ -20,7 +20,9 @@
 #ifndef GEOMETRY__LOOKUP_TABLE_HPP_
 #define GEOMETRY__LOOKUP_TABLE_HPP_
 
+#include <array>
 #include <cmath>
+#include <cstddef>
 #include <stdexcept>
 #include <vector>
 
@@ -53,6 +55,19 @@ T interpolate(const T & a, const T & b, U scaling)
 }
 
 // TODO(c.ho) support more forms of interpolation as template functor
+// Interpolate within the domain segment [lower, upper] that contains value
+template<typename T>
+T interpolate_segment_1d(
+  const T lower, const T upper, const T lower_value, const T upper_value, const T value)
+{
+  // T must be a floating point between 0 and 1
+  const auto num = static_cast<double>(value - lower);
+  const auto den = static_cast<double>(upper - lower);
+  const auto t = num / den;
+  const auto val = interpolate(lower_value, upper_value, t);
+  return static_cast<T>(val);
+}
+
 // Actual lookup logic, assuming all invariants hold:
 // Throw if value is not finite
 template<typename T>
@@ -76,12 +91,63 @@ T lookup_impl_1d(const std::vector<T> & domain, const std::vector<T> & range, co
       break;
     }
   }
-  // T must be a floating point between 0 and 1
-  const auto num = static_cast<double>(value - domain[second_idx - 1U]);
-  const auto den = static_cast<double>(domain[second_idx] - domain[second_idx - 1U]);
-  const auto t = num / den;
-  const auto val = interpolate(range[second_idx - 1U], range[second_idx], t);
-  return static_cast<T>(val);
+  return interpolate_segment_1d(
+    domain[second_idx - 1U], domain[second_idx], range[second_idx - 1U], range[second_idx],
+    value);
+}
+
+// Same as lookup_impl_1d, but the segment is found in O(1) from the inverse of the mean spacing
+// of a domain that is close to evenly spaced. The guess is corrected if rounding or a slightly
+// uneven spacing puts it into a neighbouring segment, so that the result is the same.
+template<typename T>
+T lookup_uniform_impl_1d(
+  const std::vector<T> & domain, const std::vector<T> & range, const double inv_step,
+  const T value)
+{
+  if (!std::isfinite(value)) {
+    throw std::domain_error{"Query value is not finite (NAN or INF)"};
+  }
+  if (value <= domain.front()) {
+    return range.front();
+  } else if (value >= domain.back()) {
+    return range.back();
+  } else {
+    // Fall through to normal case
+  }
+
+  const auto offset = (static_cast<double>(value) - static_cast<double>(domain.front())) * inv_step;
+  auto idx = static_cast<std::size_t>(offset);
+  if (idx > (domain.size() - 2U)) {
+    idx = domain.size() - 2U;
+  }
+  while ((idx > 0U) && (value < domain[idx])) {
+    --idx;
+  }
+  // Terminates because value < domain.back()
+  while (value >= domain[idx + 1U]) {
+    ++idx;
+  }
+  return interpolate_segment_1d(domain[idx], domain[idx + 1U], range[idx], range[idx + 1U], value);
+}
+
+// Check whether each point of a sorted domain is within 1% of the mean spacing of where it would
+// be on an even grid
+template<typename T>
+bool is_evenly_spaced(const std::vector<T> & domain)
+{
+  if (domain.size() < 2U) {
+    return false;
+  }
+  const auto front = static_cast<double>(domain.front());
+  const auto step =
+    (static_cast<double>(domain.back()) - front) / static_cast<double>(domain.size() - 1U);
+  for (auto idx = 1U; idx < domain.size(); ++idx) {
+    const auto expected = front + (static_cast<double>(idx) * step);
+    if (std::fabs(static_cast<double>(domain[idx]) - expected) > (0.01 * step)) {
+      return false;
+    }
+  }
+  return true;
 }
 
 // Check invariants for table lookup:
@@ -141,6 +207,7 @@ public:
     m_range{range}
   {
     check_table_lookup_invariants(m_domain, m_range);
+    init_uniform();
   }
 
   /// Move constructor
@@ -154,28 +221,158 @@ public:
     m_range{range}
   {
     check_table_lookup_invariants(m_domain, m_range);
+    init_uniform();
   }
 
   /// Do a 1D table lookup
   /// If query value fall out of the domain, then the value at the corresponding edge of the domain
-  /// is returned.
+  /// is returned. This takes O(1) if the domain is evenly spaced, O(N) otherwise.
   /// \param[in] value The point in the domain to query, x
   /// \return A linearly interpolated value y, corresponding to the query, x
   /// \throw std::domain_error If value is not finite
   T lookup(const T value) const
   {
-    return lookup_impl_1d(m_domain, m_range, value);
+    return m_uniform ?
+           lookup_uniform_impl_1d(m_domain, m_range, m_inv_step, value) :
+           lookup_impl_1d(m_domain, m_range, value);
   }
+
+  /// Do a 1D table lookup for each value of a sequence, e.g. an array
+  /// \param[in] first An iterator to the first point in the domain to query
+  /// \param[in] last An iterator to one past the last point in the domain to query
+  /// \param[out] out An iterator to the first of the linearly interpolated values, which may be
+  ///                 the same as first
+  /// \return An iterator to one past the last written value
+  /// \throw std::domain_error If a value is not finite, the results of the previous values are
+  ///                          written
+  /// \tparam InputIt An iterator type dereferencable into T
+  /// \tparam OutputIt An output iterator type that T can be assigned to
+  template<typename InputIt, typename OutputIt>
+  OutputIt lookup(InputIt first, const InputIt last, OutputIt out) const
+  {
+    if (m_uniform) {
+      for (; first != last; ++first, ++out) {
+        *out = lookup_uniform_impl_1d(m_domain, m_range, m_inv_step, static_cast<T>(*first));
+      }
+    } else {
+      for (; first != last; ++first, ++out) {
+        *out = lookup_impl_1d(m_domain, m_range, static_cast<T>(*first));
+      }
+    }
+    return out;
+  }
+
   /// Get the domain table
   const std::vector<T> & domain() const noexcept {return m_domain;}
   /// Get the range table
   const std::vector<T> & range() const noexcept {return m_range;}
+  /// Whether the domain is evenly spaced, so that lookups take O(1)
+  bool is_uniform() const noexcept {return m_uniform;}
 
 private:
+  void init_uniform()
+  {
+    m_uniform = is_evenly_spaced(m_domain);
+    if (m_uniform) {
+      m_inv_step = static_cast<double>(m_domain.size() - 1U) /
+        (static_cast<double>(m_domain.back()) - static_cast<double>(m_domain.front()));
+    }
+  }
+
   std::vector<T> m_domain;
   std::vector<T> m_range;
+  bool m_uniform{false};
+  double m_inv_step{0.0};
 };  // class LookupTable1D
 
+/// A 1D lookup table on an evenly spaced domain with a fixed number of points, e.g. for
+/// calibration maps that are known at compile time. It can be constructed in constant
+/// expressions, does not allocate, and lookups take O(1).
+/// \tparam T The type of the function, must be interpolatable
+/// \tparam N The number of points in the domain and range
+template<typename T, std::size_t N>
+class UniformLookupTable1D
+{
+  static_assert(N >= 2U, "UniformLookupTable1D: need at least two points");
+
+public:
+  /// Constructor
+  /// \param[in] domain_min The first x value
+  /// \param[in] domain_max The last x value, the x values are evenly spaced in between
+  /// \param[in] range The set of y values
+  /// \throw std::domain_error If domain_max is not larger than domain_min
+  constexpr UniformLookupTable1D(
+    const T domain_min, const T domain_max,
+    const std::array<T, N> & range)
+  : m_domain_min{domain_min},
+    m_domain_max{domain_max > domain_min ? domain_max :
+      throw std::domain_error{"Domain is not sorted"}},
+    m_step{(static_cast<double>(domain_max) - static_cast<double>(domain_min)) /
+      static_cast<double>(N - 1U)},
+    m_range(range)
+  {
+  }
+
+  /// Do a 1D table lookup
+  /// If query value fall out of the domain, then the value at the corresponding edge of the domain
+  /// is returned.
+  /// \param[in] value The point in the domain to query, x
+  /// \return A linearly interpolated value y, corresponding to the query, x
+  /// \throw std::domain_error If value is not finite
+  T lookup(const T value) const
+  {
+    if (!std::isfinite(value)) {
+      throw std::domain_error{"Query value is not finite (NAN or INF)"};
+    }
+    if (value <= m_domain_min) {
+      return m_range.front();
+    } else if (value >= m_domain_max) {
+      return m_range.back();
+    } else {
+      // Fall through to normal case
+    }
+    const auto offset = static_cast<double>(value) - static_cast<double>(m_domain_min);
+    auto idx = static_cast<std::size_t>(offset / m_step);
+    if (idx > (N - 2U)) {
+      idx = N - 2U;
+    }
+    const auto lower = static_cast<double>(idx) * m_step;
+    return static_cast<T>(interpolate(m_range[idx], m_range[idx + 1U], (offset - lower) / m_step));
+  }
+
+  /// Do a 1D table lookup for each value of a sequence, e.g. an array
+  /// \param[in] first An iterator to the first point in the domain to query
+  /// \param[in] last An iterator to one past the last point in the domain to query
+  /// \param[out] out An iterator to the first of the linearly interpolated values, which may be
+  ///                 the same as first
+  /// \return An iterator to one past the last written value
+  /// \throw std::domain_error If a value is not finite, the results of the previous values are
+  ///                          written
+  /// \tparam InputIt An iterator type dereferencable into T
+  /// \tparam OutputIt An output iterator type that T can be assigned to
+  template<typename InputIt, typename OutputIt>
+  OutputIt lookup(InputIt first, const InputIt last, OutputIt out) const
+  {
+    for (; first != last; ++first, ++out) {
+      *out = lookup(static_cast<T>(*first));
+    }
+    return out;
+  }
+
+  /// Get the first x value
+  constexpr T domain_min() const noexcept {return m_domain_min;}
+  /// Get the last x value
+  constexpr T domain_max() const noexcept {return m_domain_max;}
+  /// Get the range table
+  constexpr const std::array<T, N> & range() const noexcept {return m_range;}
+
+private:
+  T m_domain_min;
+  T m_domain_max;
+  double m_step;
+  std::array<T, N> m_range;
+};  // class UniformLookupTable1D
+
 }  // namespace helper_functions
 }  // namespace common
 }  // namespace autoware
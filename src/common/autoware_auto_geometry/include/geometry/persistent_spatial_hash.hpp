@@ -0,0 +1,641 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+/// \file
+/// \brief This file implements a spatial hash for long-lived point sets in a window that follows
+///        the ego vehicle, e.g. rolling local maps
+
+#ifndef GEOMETRY__PERSISTENT_SPATIAL_HASH_HPP_
+#define GEOMETRY__PERSISTENT_SPATIAL_HASH_HPP_
+
+#include <common/types.hpp>
+#include <geometry/common_2d.hpp>
+#include <geometry/spatial_hash_config.hpp>
+#include <geometry/visibility_control.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace autoware
+{
+namespace common
+{
+namespace geometry
+{
+namespace spatial_hash
+{
+/// \brief Configuration class for a PersistentSpatialHash
+class GEOMETRY_PUBLIC PersistentConfig
+{
+public:
+  /// \brief Constructor
+  /// \param[in] side_length The side length of the bins, the lookup radius
+  /// \param[in] num_bins_x The number of bins of the window along x
+  /// \param[in] num_bins_y The number of bins of the window along y
+  /// \param[in] num_bins_z The number of bins of the window along z, 1 for a 2d spatial hash
+  /// \param[in] capacity The maximum number of points the spatial hash can store
+  /// \throw std::domain_error If the side length isn't positive, the window is empty, there are
+  ///                          too many bins or the capacity is 0
+  PersistentConfig(
+    const float32_t side_length,
+    const Index num_bins_x,
+    const Index num_bins_y,
+    const Index num_bins_z,
+    const Index capacity);
+
+  /// \brief Get the side length of the bins
+  float32_t get_side_length() const;
+  /// \brief Get the inverse of the side length of the bins
+  float32_t get_side_length_inv() const;
+  /// \brief Get the number of bins of the window along x
+  Index get_num_bins_x() const;
+  /// \brief Get the number of bins of the window along y
+  Index get_num_bins_y() const;
+  /// \brief Get the number of bins of the window along z
+  Index get_num_bins_z() const;
+  /// \brief Get the total number of bins of the window
+  Index get_num_bins() const;
+  /// \brief Get the maximum number of points
+  Index get_capacity() const;
+
+private:
+  float32_t m_side_length;
+  float32_t m_side_length_inv;
+  Index m_num_bins_x;
+  Index m_num_bins_y;
+  Index m_num_bins_z;
+  Index m_capacity;
+};  // class PersistentConfig
+
+/// \brief A spatial hash for point sets that live across many updates, e.g. rolling local maps.
+///        The bins form a window of a lattice aligned with the frame of the points, stored in a
+///        ring buffer in each direction, and each point lives in a slot of preallocated storage.
+/// \tparam PointT The point type stored in this data structure. Must have float members x, y, and z
+/// \tparam Is3d Whether the distances and bins are 3d, otherwise z is ignored
+///
+/// The slots of the points of a bin form a doubly linked list, so inserting, erasing and moving
+/// a point are O(1), and a point keeps its slot until it is erased. Points are referred to by
+/// handles, which detect that their point was erased. Moving the window, e.g. with the ego
+/// vehicle, only erases the points in the bins that scroll out, the other points are neither
+/// touched nor rehashed. Points outside of the window are not stored. Nothing is allocated after
+/// construction.
+template<typename PointT, bool8_t Is3d>
+class GEOMETRY_PUBLIC PersistentSpatialHash
+{
+public:
+  /// \brief A stable reference to a stored point
+  class Handle
+  {
+public:
+    /// \brief Constructor of a handle which refers to no point
+    Handle()
+    : m_slot{std::numeric_limits<Index>::max()},
+      m_generation{}
+    {
+    }
+    /// \brief Equality comparison
+    /// \param[in] other The handle to compare against
+    /// \return True if both handles refer to the same point
+    bool8_t operator==(const Handle & other) const
+    {
+      return (m_slot == other.m_slot) && (m_generation == other.m_generation);
+    }
+    /// \brief Inequality comparison
+    /// \param[in] other The handle to compare against
+    /// \return True if the handles refer to different points
+    bool8_t operator!=(const Handle & other) const
+    {
+      return !(*this == other);
+    }
+
+private:
+    friend class PersistentSpatialHash;
+    Handle(const Index slot, const uint32_t generation)
+    : m_slot{slot},
+      m_generation{generation}
+    {
+    }
+    Index m_slot;
+    uint32_t m_generation;
+  };  // class Handle
+
+  /// \brief A point found by a near neighbor query, and its distance to the reference point
+  class Output
+  {
+public:
+    /// \brief Constructor
+    /// \param[in] handle The handle of the point
+    /// \param[in] point The point
+    /// \param[in] distance The euclidean distance (2d or 3d) to a reference point
+    Output(const Handle handle, const PointT & point, const float32_t distance)
+    : m_handle{handle},
+      m_point{&point},
+      m_distance{distance}
+    {
+    }
+    /// \brief Get stored point
+    /// \return A const reference to the stored point
+    const PointT & get_point() const
+    {
+      return *m_point;
+    }
+    /// \brief Get the handle of the point
+    /// \return The handle
+    Handle get_handle() const
+    {
+      return m_handle;
+    }
+    /// \brief Get distance to reference point
+    /// \return The distance
+    float32_t get_distance() const
+    {
+      return m_distance;
+    }
+
+private:
+    Handle m_handle;
+    const PointT * m_point;
+    float32_t m_distance;
+  };  // class Output
+  using OutputVector = typename std::vector<Output>;
+
+  /// \brief Constructor of a window whose corner with the smallest coordinates is at the origin
+  /// \param[in] cfg The configuration object for this class
+  /// \throw std::domain_error If the configuration has more than one bin along z in 2d
+  explicit PersistentSpatialHash(const PersistentConfig & cfg)
+  : m_config{cfg},
+    m_slots(cfg.get_capacity()),
+    m_bin_heads(cfg.get_num_bins(), NONE),
+    m_bin_offsets(cfg.get_num_bins() + 1U),
+    m_order(cfg.get_capacity()),
+    m_neighbors{},
+    m_origin{},
+    m_free_head{NONE},
+    m_size{}
+  {
+    if (!Is3d && (cfg.get_num_bins_z() != 1U)) {
+      throw std::domain_error("PersistentSpatialHash: 2d hash must have one bin along z");
+    }
+    m_neighbors.reserve(cfg.get_capacity());
+    clear();
+  }
+
+  /// \brief Inserts a point, if it is inside of the window
+  /// \param[in] pt The point to insert
+  /// \return A handle to the inserted point, or a handle which refers to no point if the point
+  ///         is outside of the window
+  /// \throw std::length_error If the data structure is at capacity
+  Handle insert(const PointT & pt)
+  {
+    if (m_free_head == NONE) {
+      throw std::length_error{"PersistentSpatialHash: Cannot insert past capacity"};
+    }
+    Index bin{};
+    if (!find_bin(pt, bin)) {
+      return Handle{};
+    }
+    const Index slot = m_free_head;
+    m_free_head = m_slots[slot].next;
+    m_slots[slot].point = pt;
+    link(slot, bin);
+    ++m_size;
+    return Handle{slot, m_slots[slot].generation};
+  }
+
+  /// \brief Removes a point
+  /// \param[in] handle The handle of the point to remove
+  /// \throw std::domain_error If the handle doesn't refer to a stored point
+  void erase(const Handle handle)
+  {
+    check(handle);
+    release(handle.m_slot);
+  }
+
+  /// \brief Changes the position of a point, e.g. after a map correction. The point keeps its
+  ///        handle if it stays inside of the window, otherwise it is removed.
+  /// \param[in] handle The handle of the point to move
+  /// \param[in] pt The new value of the point
+  /// \return True if the point is still stored
+  /// \throw std::domain_error If the handle doesn't refer to a stored point
+  bool8_t move(const Handle handle, const PointT & pt)
+  {
+    check(handle);
+    const Index slot = handle.m_slot;
+    Index bin{};
+    if (!find_bin(pt, bin)) {
+      release(slot);
+      return false;
+    }
+    if (bin != m_slots[slot].bin) {
+      unlink(slot);
+      link(slot, bin);
+    }
+    m_slots[slot].point = pt;
+    return true;
+  }
+
+  /// \brief Whether a handle refers to a stored point
+  /// \param[in] handle The handle
+  /// \return True if the point of the handle is stored
+  bool8_t contains(const Handle handle) const
+  {
+    return (handle.m_slot < m_slots.size()) &&
+           (m_slots[handle.m_slot].bin != NONE) &&
+           (m_slots[handle.m_slot].generation == handle.m_generation);
+  }
+
+  /// \brief Get a stored point
+  /// \param[in] handle The handle of the point
+  /// \return A const reference to the point
+  /// \throw std::domain_error If the handle doesn't refer to a stored point
+  const PointT & get(const Handle handle) const
+  {
+    check(handle);
+    return m_slots[handle.m_slot].point;
+  }
+
+  /// \brief Move the window so that a position is in its center bin. The points in the bins
+  ///        which scroll out are removed, all other points and their handles are unchanged.
+  ///        Takes time proportional to the number of bins which scroll out and their points.
+  /// \param[in] x The x component of the position
+  /// \param[in] y The y component of the position
+  /// \param[in] z The z component of the position, respected only if the spatial hash is 3D
+  void recenter(const float32_t x, const float32_t y, const float32_t z)
+  {
+    const int64_t origin[3U] = {
+      to_cell(x) - static_cast<int64_t>(m_config.get_num_bins_x() / 2U),
+      to_cell(y) - static_cast<int64_t>(m_config.get_num_bins_y() / 2U),
+      Is3d ? (to_cell(z) - static_cast<int64_t>(m_config.get_num_bins_z() / 2U)) : 0};
+    const Index num_bins[3U] = {
+      m_config.get_num_bins_x(), m_config.get_num_bins_y(), m_config.get_num_bins_z()};
+    for (Index axis = 0U; axis < 3U; ++axis) {
+      const int64_t shift = origin[axis] - m_origin[axis];
+      const int64_t size = static_cast<int64_t>(num_bins[axis]);
+      if ((shift >= size) || (shift <= -size)) {
+        clear_bins();
+        break;
+      }
+      // The cells which leave the window on one side are the ones which wrap around to the
+      // storage of the cells which enter it on the other side
+      const int64_t first = (shift > 0) ? m_origin[axis] : (origin[axis] + size);
+      for (int64_t cell = first; cell < (first + std::abs(shift)); ++cell) {
+        clear_slice(axis, wrap(cell, num_bins[axis]));
+      }
+    }
+    std::copy(&origin[0U], &origin[3U], &m_origin[0U]);
+  }
+
+  /// \brief Sort the storage of the points by bin, so that the points of a bin are contiguous in
+  ///        memory again after many updates. Takes O(n + B) time where B is the number of bins.
+  ///        The points are moved, so all handles are invalidated.
+  void compact()
+  {
+    // Counting sort of the slots by bin, as the flat grid backend of SpatialHash does
+    std::fill(m_bin_offsets.begin(), m_bin_offsets.end(), Index{});
+    for (const auto & slot : m_slots) {
+      if (slot.bin != NONE) {
+        ++m_bin_offsets[slot.bin + 1U];
+      }
+    }
+    for (Index idx = 1U; idx < m_bin_offsets.size(); ++idx) {
+      m_bin_offsets[idx] += m_bin_offsets[idx - 1U];
+    }
+    for (Index idx = 0U; idx < m_slots.size(); ++idx) {
+      const Index bin = m_slots[idx].bin;
+      if (bin != NONE) {
+        Index & cursor = m_bin_offsets[bin];
+        m_order[cursor] = idx;
+        ++cursor;
+      }
+    }
+    // Move each point to its sorted position by following the cycles of the permutation
+    // m_order, so that no second storage is needed
+    for (Index idx = 0U; idx < m_size; ++idx) {
+      Index src = m_order[idx];
+      while (src < idx) {
+        src = m_order[src];
+      }
+      m_order[idx] = src;
+      if (src != idx) {
+        std::swap(m_slots[idx], m_slots[src]);
+      }
+    }
+    // Relink, the sorted slots of a bin are consecutive. All slots get a generation above any
+    // previous one, so that every handle is invalidated
+    uint32_t generation{};
+    for (const auto & slot : m_slots) {
+      generation = std::max(generation, slot.generation);
+    }
+    ++generation;
+    std::fill(m_bin_heads.begin(), m_bin_heads.end(), NONE);
+    for (Index idx = 0U; idx < m_slots.size(); ++idx) {
+      Slot & slot = m_slots[idx];
+      slot.generation = generation;
+      if (idx < m_size) {
+        const Index bin = slot.bin;
+        slot.prev = ((idx > 0U) && (m_slots[idx - 1U].bin == bin)) ? (idx - 1U) : NONE;
+        slot.next = ((idx + 1U < m_size) && (m_slots[idx + 1U].bin == bin)) ? (idx + 1U) : NONE;
+        if (slot.prev == NONE) {
+          m_bin_heads[bin] = idx;
+        }
+      } else {
+        slot.bin = NONE;
+        slot.next = (idx + 1U < m_slots.size()) ? (idx + 1U) : NONE;
+      }
+    }
+    m_free_head = (m_size < m_slots.size()) ? m_size : NONE;
+  }
+
+  /// \brief Remove all points, the window stays in place
+  void clear()
+  {
+    clear_bins();
+  }
+
+  /// \brief Finds all points within a fixed radius of a reference point
+  /// \param[in] pt The reference point. The z member is respected only if the spatial hash is 3D.
+  /// \param[in] radius The radius within which to find all near points
+  /// \return A const reference to a vector containing the handles of all points within the
+  ///         radius, the points and their distance to the reference point. It is invalidated by
+  ///         the next query.
+  const OutputVector & near(const PointT & pt, const float32_t radius)
+  {
+    m_neighbors.clear();
+    const float32_t x = point_adapter::x_(pt);
+    const float32_t y = point_adapter::y_(pt);
+    const float32_t z = point_adapter::z_(pt);
+    const float32_t radius2 = radius * radius;
+    // The cells of the window that the cube around the reference point touches
+    int64_t first[3U] = {to_cell(x - radius), to_cell(y - radius), 0};
+    int64_t last[3U] = {to_cell(x + radius), to_cell(y + radius), 0};
+    if (Is3d) {
+      first[2U] = to_cell(z - radius);
+      last[2U] = to_cell(z + radius);
+    }
+    const Index num_bins[3U] = {
+      m_config.get_num_bins_x(), m_config.get_num_bins_y(), m_config.get_num_bins_z()};
+    for (Index axis = 0U; axis < 3U; ++axis) {
+      first[axis] = std::max(first[axis], m_origin[axis]);
+      last[axis] = std::min(last[axis], m_origin[axis] + static_cast<int64_t>(num_bins[axis]) - 1);
+      if (first[axis] > last[axis]) {
+        return m_neighbors;
+      }
+    }
+    for (int64_t cz = first[2U]; cz <= last[2U]; ++cz) {
+      for (int64_t cy = first[1U]; cy <= last[1U]; ++cy) {
+        for (int64_t cx = first[0U]; cx <= last[0U]; ++cx) {
+          const Index bin = bin_of(cx, cy, cz);
+          for (Index slot = m_bin_heads[bin]; slot != NONE; slot = m_slots[slot].next) {
+            const PointT & point = m_slots[slot].point;
+            const float32_t dx = x - point_adapter::x_(point);
+            const float32_t dy = y - point_adapter::y_(point);
+            const float32_t dz = Is3d ? (z - point_adapter::z_(point)) : 0.0F;
+            const float32_t dist2 = (dx * dx) + (dy * dy) + (dz * dz);
+            if (dist2 <= radius2) {
+              m_neighbors.emplace_back(
+                Handle{slot, m_slots[slot].generation}, point, sqrtf(dist2));
+            }
+          }
+        }
+      }
+    }
+    return m_neighbors;
+  }
+
+  /// \brief Call a function on all stored points, in the order of their storage
+  /// \param[in] fn The function, called with the handle and a const reference to the point
+  /// \tparam FunctionT The type of the function
+  template<typename FunctionT>
+  void for_each(FunctionT && fn) const
+  {
+    for (Index idx = 0U; idx < m_slots.size(); ++idx) {
+      if (m_slots[idx].bin != NONE) {
+        fn(Handle{idx, m_slots[idx].generation}, m_slots[idx].point);
+      }
+    }
+  }
+
+  /// \brief Get current number of element stored in this data structure
+  /// \return Number of stored elements
+  Index size() const
+  {
+    return m_size;
+  }
+  /// \brief Get the maximum capacity of the data structure
+  /// \return The capacity of the data structure
+  Index capacity() const
+  {
+    return m_config.get_capacity();
+  }
+  /// \brief Whether the hash is empty
+  /// \return True if data structure is empty
+  bool8_t empty() const
+  {
+    return 0U == size();
+  }
+
+private:
+  /// \brief Marks the end of a list of slots, and the bin of a free slot
+  static constexpr Index NONE = std::numeric_limits<Index>::max();
+
+  /// \brief Storage of a point
+  struct Slot
+  {
+    PointT point{};
+    /// The bin of the point, or NONE if the slot is free
+    Index bin{NONE};
+    /// The neighbours in the list of the bin, the next free slot for a free slot
+    Index prev{NONE};
+    Index next{NONE};
+    /// Counts up whenever the point of the slot is erased or moved in storage
+    uint32_t generation{};
+  };  // struct Slot
+
+  /// \brief The cell of the lattice of a coordinate
+  GEOMETRY_LOCAL int64_t to_cell(const float32_t coordinate) const
+  {
+    return static_cast<int64_t>(std::floor(coordinate * m_config.get_side_length_inv()));
+  }
+
+  /// \brief The position of a cell in the ring buffer along one direction
+  GEOMETRY_LOCAL static Index wrap(const int64_t cell, const Index num_bins)
+  {
+    const int64_t size = static_cast<int64_t>(num_bins);
+    return static_cast<Index>(((cell % size) + size) % size);
+  }
+
+  /// \brief The bin of a cell of the lattice, which is inside of the window
+  GEOMETRY_LOCAL Index bin_of(const int64_t cx, const int64_t cy, const int64_t cz) const
+  {
+    return wrap(cx, m_config.get_num_bins_x()) +
+           (m_config.get_num_bins_x() *
+           (wrap(cy, m_config.get_num_bins_y()) +
+           (m_config.get_num_bins_y() * wrap(cz, m_config.get_num_bins_z()))));
+  }
+
+  /// \brief Compute the bin of a point
+  /// \return False if the point is outside of the window
+  GEOMETRY_LOCAL bool8_t find_bin(const PointT & pt, Index & bin) const
+  {
+    const int64_t cell[3U] = {
+      to_cell(point_adapter::x_(pt)), to_cell(point_adapter::y_(pt)),
+      Is3d ? to_cell(point_adapter::z_(pt)) : 0};
+    const Index num_bins[3U] = {
+      m_config.get_num_bins_x(), m_config.get_num_bins_y(), m_config.get_num_bins_z()};
+    for (Index axis = 0U; axis < 3U; ++axis) {
+      const int64_t offset = cell[axis] - m_origin[axis];
+      if ((offset < 0) || (offset >= static_cast<int64_t>(num_bins[axis]))) {
+        return false;
+      }
+    }
+    bin = bin_of(cell[0U], cell[1U], cell[2U]);
+    return true;
+  }
+
+  /// \brief Throw if a handle doesn't refer to a stored point
+  GEOMETRY_LOCAL void check(const Handle handle) const
+  {
+    if (!contains(handle)) {
+      throw std::domain_error{"PersistentSpatialHash: Invalid handle"};
+    }
+  }
+
+  /// \brief Add a slot to the front of the list of a bin
+  GEOMETRY_LOCAL void link(const Index slot, const Index bin)
+  {
+    Slot & value = m_slots[slot];
+    value.bin = bin;
+    value.prev = NONE;
+    value.next = m_bin_heads[bin];
+    if (value.next != NONE) {
+      m_slots[value.next].prev = slot;
+    }
+    m_bin_heads[bin] = slot;
+  }
+
+  /// \brief Remove a slot from the list of its bin
+  GEOMETRY_LOCAL void unlink(const Index slot)
+  {
+    const Slot & value = m_slots[slot];
+    if (value.prev != NONE) {
+      m_slots[value.prev].next = value.next;
+    } else {
+      m_bin_heads[value.bin] = value.next;
+    }
+    if (value.next != NONE) {
+      m_slots[value.next].prev = value.prev;
+    }
+  }
+
+  /// \brief Remove the point of a slot and add the slot to the free list
+  GEOMETRY_LOCAL void release(const Index slot)
+  {
+    unlink(slot);
+    push_free(slot);
+  }
+
+  /// \brief Add a slot which is in no list of a bin to the free list
+  GEOMETRY_LOCAL void push_free(const Index slot)
+  {
+    Slot & value = m_slots[slot];
+    value.bin = NONE;
+    value.prev = NONE;
+    value.next = m_free_head;
+    ++value.generation;
+    m_free_head = slot;
+    --m_size;
+  }
+
+  /// \brief Remove the points of a bin
+  GEOMETRY_LOCAL void clear_bin(const Index bin)
+  {
+    Index slot = m_bin_heads[bin];
+    while (slot != NONE) {
+      const Index next = m_slots[slot].next;
+      push_free(slot);
+      slot = next;
+    }
+    m_bin_heads[bin] = NONE;
+  }
+
+  /// \brief Remove the points of all bins at a position of the ring buffer along one direction
+  GEOMETRY_LOCAL void clear_slice(const Index axis, const Index position)
+  {
+    const Index nx = m_config.get_num_bins_x();
+    const Index ny = m_config.get_num_bins_y();
+    const Index nz = m_config.get_num_bins_z();
+    const Index begin[3U] = {
+      (axis == 0U) ? position : 0U, (axis == 1U) ? position : 0U, (axis == 2U) ? position : 0U};
+    const Index end[3U] = {
+      (axis == 0U) ? (position + 1U) : nx, (axis == 1U) ? (position + 1U) : ny,
+      (axis == 2U) ? (position + 1U) : nz};
+    for (Index iz = begin[2U]; iz < end[2U]; ++iz) {
+      for (Index iy = begin[1U]; iy < end[1U]; ++iy) {
+        for (Index ix = begin[0U]; ix < end[0U]; ++ix) {
+          clear_bin(ix + (nx * (iy + (ny * iz))));
+        }
+      }
+    }
+  }
+
+  /// \brief Remove all points, the generations of the slots are kept so that no handle becomes
+  ///        valid again
+  GEOMETRY_LOCAL void clear_bins()
+  {
+    std::fill(m_bin_heads.begin(), m_bin_heads.end(), NONE);
+    for (Index idx = 0U; idx < m_slots.size(); ++idx) {
+      Slot & slot = m_slots[idx];
+      if (slot.bin != NONE) {
+        ++slot.generation;
+      }
+      slot.bin = NONE;
+      slot.prev = NONE;
+      slot.next = (idx + 1U < m_slots.size()) ? (idx + 1U) : NONE;
+    }
+    m_free_head = m_slots.empty() ? NONE : 0U;
+    m_size = 0U;
+  }
+
+  const PersistentConfig m_config;
+  std::vector<Slot> m_slots;
+  // The first slot of each bin
+  std::vector<Index> m_bin_heads;
+  // Scratch storage of compact()
+  std::vector<Index> m_bin_offsets;
+  std::vector<Index> m_order;
+  OutputVector m_neighbors;
+  // The cell of the lattice at the corner of the window with the smallest coordinates
+  int64_t m_origin[3U];
+  Index m_free_head;
+  Index m_size;
+};  // class PersistentSpatialHash
+
+template<typename PointT, bool8_t Is3d>
+constexpr Index PersistentSpatialHash<PointT, Is3d>::NONE;
+
+template<typename T>
+using PersistentSpatialHash2d = PersistentSpatialHash<T, false>;
+template<typename T>
+using PersistentSpatialHash3d = PersistentSpatialHash<T, true>;
+}  // namespace spatial_hash
+}  // namespace geometry
+}  // namespace common
+}  // namespace autoware
+
+#endif  // GEOMETRY__PERSISTENT_SPATIAL_HASH_HPP_
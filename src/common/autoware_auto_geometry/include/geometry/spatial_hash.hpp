@@ -14,8 +14,8 @@
 //
 // Co-developed by Tier IV, Inc. and Apex.AI, Inc.
 /// \file
-/// \brief This file implements a spatial hash for efficient fixed-radius near neighbor queries in
-///        2D
+/// \brief This file implements a spatial hash for efficient fixed-radius and k nearest neighbor
+///        queries in 2D
 
 #ifndef GEOMETRY__SPATIAL_HASH_HPP_
 #define GEOMETRY__SPATIAL_HASH_HPP_
@@ -23,6 +23,8 @@
 #include <common/types.hpp>
 #include <geometry/spatial_hash_config.hpp>
 #include <geometry/visibility_control.hpp>
+#include <algorithm>
+#include <iterator>
 #include <vector>
 #include <unordered_map>
 #include <utility>
@@ -53,12 +55,97 @@ class GEOMETRY_PUBLIC SpatialHashBase
   using Index3 = details::Index3;
   //lint -e{9131} NOLINT There's no other way to make this work in a static assert
   static_assert(
-    std::is_same<ConfigT, Config2d>::value || std::is_same<ConfigT, Config3d>::value,
-    "SpatialHash only works with Config2d or Config3d");
+    std::is_same<ConfigT, Config2d>::value || std::is_same<ConfigT, Config3d>::value ||
+    std::is_same<ConfigT, ConfigPolar>::value,
+    "SpatialHash only works with Config2d, Config3d or ConfigPolar");
 
 public:
   using Hash = std::unordered_multimap<Index, PointT>;
-  using IT = typename Hash::const_iterator;
+  /// \brief The type of stored elements, a pair of bin index and point
+  using ValueType = typename Hash::value_type;
+
+  /// \brief Const iterator over the stored points, valid for either storage backend
+  ///
+  /// Dereferencing yields a pair where the first element is the bin index and the second
+  /// element is the stored point, as with an iterator into std::unordered_multimap.
+  class IT
+  {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = ValueType;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const ValueType *;
+    using reference = const ValueType &;
+
+    /// \brief Dereference operator
+    /// \return A reference to the stored bin index and point
+    reference operator*() const
+    {
+      return m_owner->is_flat() ? m_owner->m_flat_points[m_flat_idx] : *m_hash_it;
+    }
+    /// \brief Member access operator
+    /// \return A pointer to the stored bin index and point
+    pointer operator->() const
+    {
+      return &(operator*());
+    }
+    /// \brief Pre-increment operator, advances to the next stored point
+    /// \return A reference to this iterator
+    IT & operator++()
+    {
+      if (m_owner->is_flat()) {
+        m_flat_idx = m_owner->next_flat_idx(m_flat_idx + 1U);
+      } else {
+        ++m_hash_it;
+      }
+      return *this;
+    }
+    /// \brief Post-increment operator, advances to the next stored point
+    /// \return A copy of this iterator before it was incremented
+    IT operator++(int)
+    {
+      IT ret{*this};
+      (void)operator++();
+      return ret;
+    }
+    /// \brief Equality comparison
+    /// \param[in] other The iterator to compare against
+    /// \return True if both iterators point to the same stored point
+    bool8_t operator==(const IT & other) const
+    {
+      return m_owner->is_flat() ?
+             (m_flat_idx == other.m_flat_idx) : (m_hash_it == other.m_hash_it);
+    }
+    /// \brief Inequality comparison
+    /// \param[in] other The iterator to compare against
+    /// \return True if the iterators point to different stored points
+    bool8_t operator!=(const IT & other) const
+    {
+      return !(*this == other);
+    }
+
+private:
+    friend class SpatialHashBase;
+    /// \brief Constructor for the hash map backend
+    IT(const SpatialHashBase * owner, const typename Hash::const_iterator it)
+    : m_owner{owner},
+      m_hash_it{it},
+      m_flat_idx{}
+    {
+    }
+    /// \brief Constructor for the flat grid backend
+    IT(const SpatialHashBase * owner, const Index idx)
+    : m_owner{owner},
+      m_hash_it{},
+      m_flat_idx{idx}
+    {
+    }
+
+    const SpatialHashBase * m_owner;
+    typename Hash::const_iterator m_hash_it;
+    Index m_flat_idx;
+  };  // class IT
+
   /// \brief Wrapper around an iterator and a distance (from some query point)
   class Output
   {
@@ -113,10 +200,28 @@ private:
   explicit SpatialHashBase(const ConfigT & cfg)
   : m_config{cfg},
     m_hash(),
+    m_flat_points{},
+    m_flat_points_tmp{},
+    m_flat_erased{},
+    m_flat_order{},
+    m_flat_bin_offsets{},
+    m_flat_bin_cursor{},
+    m_flat_size{},
+    m_flat_first{},
+    m_flat_dirty{true},
     m_neighbors{},  // TODO(c.ho) reserve, but there's no default constructor for output
     m_bins_hit{},  // zero initialization (and below)
     m_neighbors_found{}
   {
+    if (is_flat()) {
+      // Preallocate everything so that no allocation happens during operation
+      m_flat_points.reserve(capacity());
+      m_flat_points_tmp.reserve(capacity());
+      m_flat_erased.reserve(capacity());
+      m_flat_order.resize(capacity());
+      m_flat_bin_offsets.resize(m_config.get_num_bins() + 1U);
+      m_flat_bin_cursor.resize(m_config.get_num_bins());
+    }
   }
 
   /// \brief Inserts point
@@ -159,22 +264,37 @@ private:
   /// should be used with care and only on valid iterators
   IT erase(const IT point)
   {
-    if (end() == m_hash.find(point->first)) {
+    if (is_flat()) {
+      const Index idx = point.m_flat_idx;
+      if ((this != point.m_owner) || (idx >= m_flat_points.size()) || m_flat_erased[idx]) {
+        throw std::domain_error{"SpatialHash: Attempting to erase invalid iterator"};
+      }
+      // Points are only marked as removed, storage is compacted on the next rebuild
+      m_flat_erased[idx] = true;
+      --m_flat_size;
+      return IT{this, next_flat_idx(idx + 1U)};
+    }
+    if (m_hash.end() == m_hash.find(point->first)) {
       throw std::domain_error{"SpatialHash: Attempting to erase invalid iterator"};
     }
-    return m_hash.erase(point);
+    return IT{this, m_hash.erase(point.m_hash_it)};
   }
 
   /// \brief Reset the state of the data structure
   void clear()
   {
     m_hash.clear();
+    m_flat_points.clear();
+    m_flat_erased.clear();
+    m_flat_size = 0U;
+    m_flat_first = 0U;
+    m_flat_dirty = true;
   }
   /// \brief Get current number of element stored in this data structure
   /// \return Number of stored elements
   Index size() const
   {
-    return m_hash.size();
+    return is_flat() ? m_flat_size : m_hash.size();
   }
   /// \brief Get the maximum capacity of the data structure
   /// \return The capacity of the data structure
@@ -186,19 +306,24 @@ private:
   /// \return True if data structure is empty
   bool8_t empty() const
   {
-    return m_hash.empty();
+    return 0U == size();
   }
   /// \brief Get iterator to beginning of data structure
   /// \return Iterator
   IT begin() const
   {
-    return m_hash.begin();
+    if (is_flat()) {
+      // Erased points stay erased until the next rebuild, so the first live point only moves forward
+      m_flat_first = next_flat_idx(m_flat_first);
+      return IT{this, m_flat_first};
+    }
+    return IT{this, m_hash.begin()};
   }
   /// \brief Get iterator to end of data structure
   /// \return Iterator
   IT end() const
   {
-    return m_hash.end();
+    return is_flat() ? IT{this, m_flat_points.size()} : IT{this, m_hash.end()};
   }
   /// \brief Get iterator to beginning of data structure
   /// \return Iterator
@@ -238,6 +363,9 @@ protected:
   /// \param[in] radius The radius within which to find all near points
   /// \return A const reference to a vector containing iterators pointing to
   ///         all points within the radius, and the actual distance to the reference point
+  ///
+  /// \note With the flat grid backend, the first query after an insertion sorts the stored points
+  ///       by bin, which invalidates all iterators
   const OutputVector & near_impl(
     const float32_t x,
     const float32_t y,
@@ -246,6 +374,9 @@ protected:
   {
     // reset output
     m_neighbors.clear();
+    if (is_flat() && m_flat_dirty) {
+      rebuild_flat();
+    }
     // Compute bin, bin range
     const Index3 ref_idx = m_config.index3(x, y, z);
     const float32_t radius2 = radius * radius;
@@ -259,13 +390,25 @@ protected:
       if (m_config.is_candidate_bin(ref_idx, idx, radius2)) {
         // For point in bin
         const Index jdx = m_config.index(idx);
-        const auto range = m_hash.equal_range(jdx);
-        for (auto it = range.first; it != range.second; ++it) {
-          const auto & pt = it->second;
-          const float32_t dist2 = m_config.distance_squared(x, y, z, pt);
-          if (dist2 <= radius2) {
-            // Only compute true distance if necessary
-            m_neighbors.emplace_back(it, sqrtf(dist2));
+        if (is_flat()) {
+          const Index last = m_flat_bin_offsets[jdx + 1U];
+          for (Index kdx = m_flat_bin_offsets[jdx]; kdx < last; ++kdx) {
+            if (!m_flat_erased[kdx]) {
+              const float32_t dist2 = m_config.distance_squared(x, y, z, m_flat_points[kdx].second);
+              if (dist2 <= radius2) {
+                m_neighbors.emplace_back(IT{this, kdx}, sqrtf(dist2));
+              }
+            }
+          }
+        } else {
+          const auto range = m_hash.equal_range(jdx);
+          for (auto it = range.first; it != range.second; ++it) {
+            const auto & pt = it->second;
+            const float32_t dist2 = m_config.distance_squared(x, y, z, pt);
+            if (dist2 <= radius2) {
+              // Only compute true distance if necessary
+              m_neighbors.emplace_back(IT{this, it}, sqrtf(dist2));
+            }
           }
         }
       }
@@ -275,7 +418,171 @@ protected:
     return m_neighbors;
   }
 
+  /// \brief Finds the k nearest points to a reference point
+  /// \param[in] x The x component of the reference point
+  /// \param[in] y The y component of the reference point
+  /// \param[in] z The z component of the reference point, respected only if the spatial hash is not
+  ///              2D.
+  /// \param[in] k The number of points to find
+  /// \return A const reference to a vector containing iterators pointing to the k nearest points,
+  ///         or all points if there are fewer, and the actual distance to the reference point,
+  ///         sorted by increasing distance
+  ///
+  /// The bins within a radius of the reference point are searched as in near_impl(), starting
+  /// with the size of a bin and doubling the radius until the k-th nearest point found is within
+  /// it. The nearest points found so far are kept in a max-heap of size k in the storage of the
+  /// output, so no allocation happens once the output has held k points.
+  ///
+  /// \note With the flat grid backend, the first query after an insertion sorts the stored points
+  ///       by bin, which invalidates all iterators
+  const OutputVector & knn_impl(
+    const float32_t x,
+    const float32_t y,
+    const float32_t z,
+    const Index k)
+  {
+    // reset output
+    m_neighbors.clear();
+    if (is_flat() && m_flat_dirty) {
+      rebuild_flat();
+    }
+    const Index num_neighbors = std::min(k, size());
+    if (0U == num_neighbors) {
+      return m_neighbors;
+    }
+    m_neighbors.reserve(num_neighbors);
+    const Index3 ref_idx = m_config.index3(x, y, z);
+    float32_t radius = m_config.get_bin_size();
+    while (true) {
+      m_neighbors.clear();
+      Index num_searched = 0U;
+      const float32_t radius2 = radius * radius;
+      const details::BinRange idx_range = m_config.bin_range(ref_idx, radius);
+      Index3 idx = idx_range.first;
+      do {  // guaranteed to have at least the bin ref_idx is in
+        // update book-keeping
+        ++m_bins_hit;
+        if (m_config.is_candidate_bin(ref_idx, idx, radius2)) {
+          num_searched += knn_bin(x, y, z, m_config.index(idx), num_neighbors);
+        }
+      } while (m_config.next_bin(idx_range, idx));
+      // All points within the radius were searched, so the nearest points are found once the
+      // k-th nearest point found is within it
+      if ((num_searched == size()) ||
+        ((m_neighbors.size() == num_neighbors) && (m_neighbors.front().get_distance() <= radius)))
+      {
+        break;
+      }
+      radius *= 2.0F;
+    }
+    std::sort_heap(m_neighbors.begin(), m_neighbors.end(), &SpatialHashBase::closer);
+    // update book-keeping
+    m_neighbors_found += m_neighbors.size();
+    return m_neighbors;
+  }
+
 private:
+  /// \brief Order of the max-heap of the k nearest neighbor search
+  GEOMETRY_LOCAL static bool8_t closer(const Output & lhs, const Output & rhs)
+  {
+    return lhs.get_distance() < rhs.get_distance();
+  }
+
+  /// \brief Offer the points of a bin to the max-heap of the k nearest neighbor search
+  /// \return The number of points in the bin
+  GEOMETRY_LOCAL Index knn_bin(
+    const float32_t x,
+    const float32_t y,
+    const float32_t z,
+    const Index bin,
+    const Index k)
+  {
+    Index count = 0U;
+    if (is_flat()) {
+      const Index last = m_flat_bin_offsets[bin + 1U];
+      for (Index kdx = m_flat_bin_offsets[bin]; kdx < last; ++kdx) {
+        if (!m_flat_erased[kdx]) {
+          ++count;
+          knn_push(IT{this, kdx}, m_config.distance_squared(x, y, z, m_flat_points[kdx].second), k);
+        }
+      }
+    } else {
+      const auto range = m_hash.equal_range(bin);
+      for (auto it = range.first; it != range.second; ++it) {
+        ++count;
+        knn_push(IT{this, it}, m_config.distance_squared(x, y, z, it->second), k);
+      }
+    }
+    return count;
+  }
+
+  /// \brief Keep a point in the max-heap of the k nearest neighbor search if it is one of the k
+  ///        nearest points so far
+  GEOMETRY_LOCAL void knn_push(const IT it, const float32_t dist2, const Index k)
+  {
+    if (m_neighbors.size() < k) {
+      m_neighbors.emplace_back(it, sqrtf(dist2));
+      std::push_heap(m_neighbors.begin(), m_neighbors.end(), &SpatialHashBase::closer);
+    } else {
+      const float32_t worst = m_neighbors.front().get_distance();
+      if (dist2 < (worst * worst)) {
+        std::pop_heap(m_neighbors.begin(), m_neighbors.end(), &SpatialHashBase::closer);
+        m_neighbors.back() = Output{it, sqrtf(dist2)};
+        std::push_heap(m_neighbors.begin(), m_neighbors.end(), &SpatialHashBase::closer);
+      }
+    }
+  }
+
+  /// \brief Whether points are stored in the flat grid rather than the hash map
+  GEOMETRY_LOCAL bool8_t is_flat() const
+  {
+    return StorageBackend::FLAT_GRID == m_config.get_backend();
+  }
+
+  /// \brief Get the first index at or after the given index which holds a point that was not
+  ///        erased, or the size of the flat storage if there is none
+  GEOMETRY_LOCAL Index next_flat_idx(Index idx) const
+  {
+    while ((idx < m_flat_points.size()) && m_flat_erased[idx]) {
+      ++idx;
+    }
+    return idx;
+  }
+
+  /// \brief Sort all live points by bin index with a counting sort, and build the table of
+  ///        offsets into the sorted storage for each bin. Erased points are dropped.
+  GEOMETRY_LOCAL void rebuild_flat()
+  {
+    // Histogram, stored shifted by one so the prefix sum yields the start offset for each bin
+    std::fill(m_flat_bin_offsets.begin(), m_flat_bin_offsets.end(), Index{});
+    for (Index idx = 0U; idx < m_flat_points.size(); ++idx) {
+      if (!m_flat_erased[idx]) {
+        ++m_flat_bin_offsets[m_flat_points[idx].first + 1U];
+      }
+    }
+    for (Index idx = 1U; idx < m_flat_bin_offsets.size(); ++idx) {
+      m_flat_bin_offsets[idx] += m_flat_bin_offsets[idx - 1U];
+    }
+    // Scatter source indices into their sorted position
+    std::copy(m_flat_bin_offsets.begin(), m_flat_bin_offsets.end() - 1, m_flat_bin_cursor.begin());
+    for (Index idx = 0U; idx < m_flat_points.size(); ++idx) {
+      if (!m_flat_erased[idx]) {
+        Index & cursor = m_flat_bin_cursor[m_flat_points[idx].first];
+        m_flat_order[cursor] = idx;
+        ++cursor;
+      }
+    }
+    // Gather points in sorted order
+    m_flat_points_tmp.clear();
+    for (Index idx = 0U; idx < m_flat_size; ++idx) {
+      m_flat_points_tmp.push_back(m_flat_points[m_flat_order[idx]]);
+    }
+    std::swap(m_flat_points, m_flat_points_tmp);
+    m_flat_erased.assign(m_flat_points.size(), false);
+    m_flat_first = 0U;
+    m_flat_dirty = false;
+  }
+
   /// \brief Internal insert method with no error checking
   /// \param[in] pt The Point to insert
   GEOMETRY_LOCAL IT insert_impl(const PointT & pt)
@@ -283,12 +590,30 @@ private:
     // Compute bin
     const Index idx =
       m_config.bin(point_adapter::x_(pt), point_adapter::y_(pt), point_adapter::z_(pt));
+    if (is_flat()) {
+      // Appended unsorted, the bin structure is lazily rebuilt on the next query
+      m_flat_points.emplace_back(idx, pt);
+      m_flat_erased.push_back(false);
+      ++m_flat_size;
+      m_flat_dirty = true;
+      return IT{this, m_flat_points.size() - 1U};
+    }
     // Insert into bin
-    return m_hash.insert(std::make_pair(idx, pt));
+    return IT{this, m_hash.insert(std::make_pair(idx, pt))};
   }
 
   const ConfigT m_config;
   Hash m_hash;
+  // Flat grid storage, only used with StorageBackend::FLAT_GRID
+  std::vector<ValueType> m_flat_points;
+  std::vector<ValueType> m_flat_points_tmp;
+  std::vector<bool8_t> m_flat_erased;
+  std::vector<Index> m_flat_order;
+  std::vector<Index> m_flat_bin_offsets;
+  std::vector<Index> m_flat_bin_cursor;
+  Index m_flat_size;
+  mutable Index m_flat_first;
+  bool8_t m_flat_dirty;
   OutputVector m_neighbors;
   Index m_bins_hit;
   Index m_neighbors_found;
@@ -335,6 +660,32 @@ public:
   {
     return near(point_adapter::x_(pt), point_adapter::y_(pt), radius);
   }
+
+  /// \brief Finds the k nearest points to a reference point
+  /// \param[in] x The x component of the reference point
+  /// \param[in] y The y component of the reference point
+  /// \param[in] k The number of points to find
+  /// \return A const reference to a vector containing iterators pointing to the k nearest points,
+  ///         or all points if there are fewer, and the actual distance to the reference point,
+  ///         sorted by increasing distance
+  const OutputVector & knn(
+    const float32_t x,
+    const float32_t y,
+    const Index k)
+  {
+    return this->knn_impl(x, y, 0.0F, k);
+  }
+
+  /// \brief Finds the k nearest points to a reference point
+  /// \param[in] pt The reference point. Only the x and y members are respected.
+  /// \param[in] k The number of points to find
+  /// \return A const reference to a vector containing iterators pointing to the k nearest points,
+  ///         or all points if there are fewer, and the actual distance to the reference point,
+  ///         sorted by increasing distance
+  const OutputVector & knn(const PointT & pt, const Index k)
+  {
+    return knn(point_adapter::x_(pt), point_adapter::y_(pt), k);
+  }
 };
 
 /// \brief Explicit specialization of SpatialHash for 3D configuration
@@ -376,12 +727,104 @@ public:
       point_adapter::x_(pt), point_adapter::y_(pt), point_adapter::z_(pt),
       radius);
   }
+
+  /// \brief Finds the k nearest points to a reference point
+  /// \param[in] x The x component of the reference point
+  /// \param[in] y The y component of the reference point
+  /// \param[in] z The z component of the reference point
+  /// \param[in] k The number of points to find
+  /// \return A const reference to a vector containing iterators pointing to the k nearest points,
+  ///         or all points if there are fewer, and the actual distance to the reference point,
+  ///         sorted by increasing distance
+  const OutputVector & knn(
+    const float32_t x,
+    const float32_t y,
+    const float32_t z,
+    const Index k)
+  {
+    return this->knn_impl(x, y, z, k);
+  }
+
+  /// \brief Finds the k nearest points to a reference point
+  /// \param[in] pt The reference point.
+  /// \param[in] k The number of points to find
+  /// \return A const reference to a vector containing iterators pointing to the k nearest points,
+  ///         or all points if there are fewer, and the actual distance to the reference point,
+  ///         sorted by increasing distance
+  const OutputVector & knn(const PointT & pt, const Index k)
+  {
+    return knn(point_adapter::x_(pt), point_adapter::y_(pt), point_adapter::z_(pt), k);
+  }
+};
+
+/// \brief Explicit specialization of SpatialHash for the polar configuration
+/// \tparam PointT The point type stored in this data structure.
+template<typename PointT>
+class GEOMETRY_PUBLIC SpatialHash<PointT, ConfigPolar>: public SpatialHashBase<PointT, ConfigPolar>
+{
+public:
+  using OutputVector = typename SpatialHashBase<PointT, ConfigPolar>::OutputVector;
+
+  explicit SpatialHash(const ConfigPolar & cfg)
+  : SpatialHashBase<PointT, ConfigPolar>(cfg) {}
+
+  /// \brief Finds all points within a fixed radius of a reference point
+  /// \param[in] x The x component of the reference point
+  /// \param[in] y The y component of the reference point
+  /// \param[in] radius The radius within which to find all near points
+  /// \return A const reference to a vector containing iterators pointing to
+  ///         all points within the radius, and the actual distance to the reference point
+  const OutputVector & near(
+    const float32_t x,
+    const float32_t y,
+    const float32_t radius)
+  {
+    return this->near_impl(x, y, 0.0F, radius);
+  }
+
+  /// \brief Finds all points within a fixed radius of a reference point
+  /// \param[in] pt The reference point. Only the x and y members are respected.
+  /// \param[in] radius The radius within which to find all near points
+  /// \return A const reference to a vector containing iterators pointing to
+  ///         all points within the radius, and the actual distance to the reference point
+  const OutputVector & near(const PointT & pt, const float32_t radius)
+  {
+    return near(point_adapter::x_(pt), point_adapter::y_(pt), radius);
+  }
+
+  /// \brief Finds the k nearest points to a reference point
+  /// \param[in] x The x component of the reference point
+  /// \param[in] y The y component of the reference point
+  /// \param[in] k The number of points to find
+  /// \return A const reference to a vector containing iterators pointing to the k nearest points,
+  ///         or all points if there are fewer, and the actual distance to the reference point,
+  ///         sorted by increasing distance
+  const OutputVector & knn(
+    const float32_t x,
+    const float32_t y,
+    const Index k)
+  {
+    return this->knn_impl(x, y, 0.0F, k);
+  }
+
+  /// \brief Finds the k nearest points to a reference point
+  /// \param[in] pt The reference point. Only the x and y members are respected.
+  /// \param[in] k The number of points to find
+  /// \return A const reference to a vector containing iterators pointing to the k nearest points,
+  ///         or all points if there are fewer, and the actual distance to the reference point,
+  ///         sorted by increasing distance
+  const OutputVector & knn(const PointT & pt, const Index k)
+  {
+    return knn(point_adapter::x_(pt), point_adapter::y_(pt), k);
+  }
 };
 
 template<typename T>
 using SpatialHash2d = SpatialHash<T, Config2d>;
 template<typename T>
 using SpatialHash3d = SpatialHash<T, Config3d>;
+template<typename T>
+using SpatialHashPolar = SpatialHash<T, ConfigPolar>;
 }  // namespace spatial_hash
 }  // namespace geometry
 }  // namespace common
@@ -66,6 +66,16 @@ struct GEOMETRY_PUBLIC Index3
 using BinRange = std::pair<Index3, Index3>;
 }  // namespace details
 
+/// \brief The storage strategy used by the spatial hash to hold points
+enum class StorageBackend : uint8_t
+{
+  /// Points are stored in a node-based std::unordered_multimap keyed on the bin index
+  HASH_MAP = 0U,
+  /// Points are stored in contiguous arrays, sorted by bin index via a counting sort before
+  /// each round of queries. Requires memory proportional to the total number of bins.
+  FLAT_GRID
+};  // enum class StorageBackend
+
 /// \brief The base class for the configuration object for the SpatialHash class
 /// \tparam Derived The type of the derived class to support static polymorphism/CRTP
 template<typename Derived>
@@ -81,6 +91,7 @@ public:
   /// \param[in] max_z The maximum z value for the spatial hash
   /// \param[in] radius The look up radius
   /// \param[in] capacity The maximum number of points the spatial hash can store
+  /// \param[in] backend The storage strategy used by the spatial hash
   Config(
     const float32_t min_x,
     const float32_t max_x,
@@ -89,7 +100,8 @@ public:
     const float32_t min_z,
     const float32_t max_z,
     const float32_t radius,
-    const Index capacity)
+    const Index capacity,
+    const StorageBackend backend)
   : m_min_x{min_x},
     m_min_y{min_y},
     m_min_z{min_z},
@@ -104,7 +116,8 @@ public:
     m_max_y_idx{check_basis_direction(min_y, max_y)},
     m_max_z_idx{check_basis_direction(min_z, max_z)},
     m_y_stride{m_max_x_idx + 1U},
-    m_z_stride{m_y_stride * (m_max_y_idx + 1U)}
+    m_z_stride{m_y_stride * (m_max_y_idx + 1U)},
+    m_backend{backend}
   {
     if (radius <= 0.0F) {
       throw std::domain_error("Error constructing SpatialHash: must have positive side length");
@@ -129,6 +142,11 @@ public:
     if (std::numeric_limits<Index>::max() == m_max_z_idx) {
       throw std::domain_error("SpatialHash::Config: max z index exceeds reasonable value");
     }
+    if ((StorageBackend::FLAT_GRID == m_backend) &&
+      ((m_max_z_idx + 1U) > (std::numeric_limits<Index>::max() / m_z_stride)))
+    {
+      throw std::domain_error("SpatialHash::Config: number of bins too large for flat grid");
+    }
   }
 
   /// \brief Given a reference index triple, compute the first and last bin
@@ -188,6 +206,28 @@ public:
     return m_side_length2;
   }
 
+  /// \brief Get the side length of a bin, the initial search radius of k nearest neighbor queries
+  /// \return The side length
+  float32_t get_bin_size() const
+  {
+    return m_side_length;
+  }
+
+  /// \brief Get the storage strategy of the spatial hash
+  /// \return The storage backend
+  StorageBackend get_backend() const
+  {
+    return m_backend;
+  }
+
+  /// \brief Get the total number of bins in the lattice, i.e. one past the largest valid return
+  ///        value of bin()
+  /// \return The number of bins
+  Index get_num_bins() const
+  {
+    return m_z_stride * (m_max_z_idx + 1U);
+  }
+
   ////////////////////////////////////////////////////////////////////////////////////////////
   // "Polymorphic" API
   /// \brief Compute the single index given a point
@@ -349,6 +389,7 @@ private:
   Index m_max_z_idx;
   Index m_y_stride;
   Index m_z_stride;
+  StorageBackend m_backend;
 };  // class Config
 
 /// \brief Configuration class for a 2d spatial hash
@@ -362,13 +403,15 @@ public:
   /// \param[in] max_y The maximum y value for the spatial hash
   /// \param[in] radius The lookup distance
   /// \param[in] capacity The maximum number of points the spatial hash can store
+  /// \param[in] backend The storage strategy used by the spatial hash
   Config2d(
     const float32_t min_x,
     const float32_t max_x,
     const float32_t min_y,
     const float32_t max_y,
     const float32_t radius,
-    const Index capacity);
+    const Index capacity,
+    const StorageBackend backend = StorageBackend::HASH_MAP);
   /// \brief The index of a point given it's x, y and z values, 2d implementation
   /// \param[in] x The x value of a point
   /// \param[in] y the y value of a point
@@ -430,6 +473,7 @@ public:
   /// \param[in] max_z The maximum z value for the spatial hash
   /// \param[in] radius The lookup distance
   /// \param[in] capacity The maximum number of points the spatial hash can store
+  /// \param[in] backend The storage strategy used by the spatial hash
   Config3d(
     const float32_t min_x,
     const float32_t max_x,
@@ -438,7 +482,8 @@ public:
     const float32_t min_z,
     const float32_t max_z,
     const float32_t radius,
-    const Index capacity);
+    const Index capacity,
+    const StorageBackend backend = StorageBackend::HASH_MAP);
   /// \brief The index of a point given it's x, y and z values, 3d implementation
   /// \param[in] x The x value of a point
   /// \param[in] y the y value of a point
@@ -486,6 +531,118 @@ public:
     return (dx * dx) + (dy * dy) + (dz * dz);
   }
 };  // class Config3d
+
+/// \brief Configuration class for a 2d spatial hash whose bins are range rings and azimuth
+///        sectors around the origin. Sectors get wider with range, so for a query radius that
+///        grows with range, the number of sectors touched stays the same and only the number of
+///        rings grows, where a grid would touch a number of bins growing with the square of it
+class GEOMETRY_PUBLIC ConfigPolar
+{
+public:
+  /// \brief Config constructor for a polar spatial hash
+  /// \param[in] max_range The range of the outermost ring, points further away are in that ring
+  /// \param[in] ring_width The radial width of the rings
+  /// \param[in] num_sectors The number of azimuth sectors of each ring
+  /// \param[in] capacity The maximum number of points the spatial hash can store
+  /// \param[in] backend The storage strategy used by the spatial hash
+  /// \throw std::domain_error If the range, ring width or number of sectors is not positive, or
+  ///                          if there are too many bins
+  ConfigPolar(
+    const float32_t max_range,
+    const float32_t ring_width,
+    const Index num_sectors,
+    const Index capacity,
+    const StorageBackend backend = StorageBackend::HASH_MAP);
+
+  /// \brief Given a reference index triple, compute the first and last bin. The sectors of the
+  ///        range are unwrapped by one turn, so that the range is contiguous
+  /// \param[in] ref The reference index triple
+  /// \param[in] radius The allowable radius for any point in the reference bin to any point in the
+  ///                   range
+  /// \return A pair where the first element is an index triple of the first bin, and the second
+  ///         element is an index triple for the last bin
+  details::BinRange bin_range(const details::Index3 & ref, const float32_t radius) const;
+  /// \brief Get next index within a given range
+  /// \return True if idx is valid and still in range
+  /// \param[in] range The max and min bin indices
+  /// \param[inout] idx The index to be incremented, updated even if a negative result occurs
+  bool8_t next_bin(const details::BinRange & range, details::Index3 & idx) const;
+  /// \brief Get the maximum capacity of the spatial hash
+  /// \return The capacity
+  Index get_capacity() const;
+  /// \brief Get the storage strategy of the spatial hash
+  /// \return The storage backend
+  StorageBackend get_backend() const;
+  /// \brief Get the radial width of a ring, the initial search radius of k nearest neighbor
+  ///        queries
+  /// \return The ring width
+  float32_t get_bin_size() const;
+  /// \brief Get the total number of bins, i.e. one past the largest valid return value of bin()
+  /// \return The number of bins
+  Index get_num_bins() const;
+  /// \brief The index of a point given it's x, y and z values
+  /// \param[in] x The x value of a point
+  /// \param[in] y the y value of a point
+  /// \param[in] z the z value of a point, ignored
+  /// \return The index of the bin for the specified point
+  Index bin(const float32_t x, const float32_t y, const float32_t z) const;
+  /// \brief Determine if a bin could possibly hold a point within a distance to any point in a
+  ///        reference bin
+  /// \param[in] ref The decomposed index triple of the reference bin
+  /// \param[in] query The decomposed index triple of the bin being queried
+  /// \param[in] ref_distance2 The squared threshold distance
+  /// \return True if the reference bin and query bin could possibly hold a point within the
+  ///         reference distance
+  bool is_candidate_bin(
+    const details::Index3 & ref,
+    const details::Index3 & query,
+    const float ref_distance2) const;
+  /// \brief Compute the decomposed index given a point, the ring is x and the sector is y
+  /// \param[in] x The x component of the point
+  /// \param[in] y The y component of the point
+  /// \param[in] z The z component of the point, ignored
+  /// \return The decomposed index triple of the bin for the given point
+  details::Index3 index3(const float32_t x, const float32_t y, const float32_t z) const;
+  /// \brief Compute the composed single index given a decomposed index, the sector may be
+  ///        unwrapped
+  /// \param[in] idx A decomposed index triple for a bin
+  /// \return The composed bin index
+  Index index(const details::Index3 & idx) const;
+  /// \brief Compute the squared distance between the two points, 2d implementation
+  /// \tparam PointT A point type with float members x, y and z, or point adapters defined
+  /// \param[in] x The x component of the first point
+  /// \param[in] y The y component of the first point
+  /// \param[in] z The z component of the first point
+  /// \param[in] pt The other point being compared
+  /// \return The squared distance between the points (2d)
+  template<typename PointT>
+  float32_t distance_squared(
+    const float32_t x,
+    const float32_t y,
+    const float32_t z,
+    const PointT & pt) const
+  {
+    (void)z;
+    const float32_t dx = x - point_adapter::x_(pt);
+    const float32_t dy = y - point_adapter::y_(pt);
+    return (dx * dx) + (dy * dy);
+  }
+
+private:
+  /// \brief The number of sectors between two sectors going around the shorter way, where
+  ///        adjacent sectors have zero distance
+  GEOMETRY_LOCAL Index sector_distance(const Index ref_idx, const Index query_idx) const;
+
+  float32_t m_max_range;
+  float32_t m_ring_width;
+  float32_t m_ring_width_inv;
+  float32_t m_sector_width;
+  float32_t m_sector_width_inv;
+  Index m_num_rings;
+  Index m_num_sectors;
+  Index m_capacity;
+  StorageBackend m_backend;
+};  // class ConfigPolar
 }  // namespace spatial_hash
 }  // namespace geometry
 }  // namespace common
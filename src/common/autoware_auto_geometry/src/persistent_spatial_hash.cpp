@@ -0,0 +1,102 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#include <geometry/persistent_spatial_hash.hpp>
+#include <geometry_msgs/msg/point32.hpp>
+//lint -e537 NOLINT repeated include file due to cpplint rule
+#include <limits>
+
+namespace autoware
+{
+namespace common
+{
+namespace geometry
+{
+namespace spatial_hash
+{
+////////////////////////////////////////////////////////////////////////////////
+PersistentConfig::PersistentConfig(
+  const float32_t side_length,
+  const Index num_bins_x,
+  const Index num_bins_y,
+  const Index num_bins_z,
+  const Index capacity)
+: m_side_length{side_length},
+  m_side_length_inv{1.0F / side_length},
+  m_num_bins_x{num_bins_x},
+  m_num_bins_y{num_bins_y},
+  m_num_bins_z{num_bins_z},
+  m_capacity{capacity}
+{
+  if (!(side_length > 0.0F)) {
+    throw std::domain_error("PersistentConfig: must have positive side length");
+  }
+  if ((num_bins_x == 0U) || (num_bins_y == 0U) || (num_bins_z == 0U)) {
+    throw std::domain_error("PersistentConfig: must have at least one bin along each axis");
+  }
+  // The bin index and the cells of the lattice have to fit, with some room
+  const Index max_bins = static_cast<Index>(std::numeric_limits<int32_t>::max());
+  if ((num_bins_x > max_bins) || (num_bins_y > (max_bins / num_bins_x)) ||
+    (num_bins_z > (max_bins / (num_bins_x * num_bins_y))))
+  {
+    throw std::domain_error("PersistentConfig: too many bins");
+  }
+  if (capacity == 0U) {
+    throw std::domain_error("PersistentConfig: must have positive capacity");
+  }
+}
+////////////////////////////////////////////////////////////////////////////////
+float32_t PersistentConfig::get_side_length() const
+{
+  return m_side_length;
+}
+////////////////////////////////////////////////////////////////////////////////
+float32_t PersistentConfig::get_side_length_inv() const
+{
+  return m_side_length_inv;
+}
+////////////////////////////////////////////////////////////////////////////////
+Index PersistentConfig::get_num_bins_x() const
+{
+  return m_num_bins_x;
+}
+////////////////////////////////////////////////////////////////////////////////
+Index PersistentConfig::get_num_bins_y() const
+{
+  return m_num_bins_y;
+}
+////////////////////////////////////////////////////////////////////////////////
+Index PersistentConfig::get_num_bins_z() const
+{
+  return m_num_bins_z;
+}
+////////////////////////////////////////////////////////////////////////////////
+Index PersistentConfig::get_num_bins() const
+{
+  return m_num_bins_x * m_num_bins_y * m_num_bins_z;
+}
+////////////////////////////////////////////////////////////////////////////////
+Index PersistentConfig::get_capacity() const
+{
+  return m_capacity;
+}
+////////////////////////////////////////////////////////////////////////////////
+template class PersistentSpatialHash<geometry_msgs::msg::Point32, false>;
+template class PersistentSpatialHash<geometry_msgs::msg::Point32, true>;
+}  // namespace spatial_hash
+}  // namespace geometry
+}  // namespace common
+}  // namespace autoware
@@ -19,6 +19,8 @@
 //lint -e537 NOLINT repeated include file due to cpplint rule
 #include <algorithm>
 //lint -e537 NOLINT repeated include file due to cpplint rule
+#include <cmath>
+//lint -e537 NOLINT repeated include file due to cpplint rule
 #include <limits>
 
 namespace autoware
@@ -36,9 +38,10 @@ Config2d::Config2d(
   const float32_t min_y,
   const float32_t max_y,
   const float32_t radius,
-  const Index capacity)
+  const Index capacity,
+  const StorageBackend backend)
 : Config(min_x, max_x, min_y, max_y, {}, std::numeric_limits<float32_t>::min(),
-    radius, capacity)
+    radius, capacity, backend)
 {
 }
 ////////////////////////////////////////////////////////////////////////////////
@@ -78,8 +81,9 @@ Config3d::Config3d(
   const float32_t min_z,
   const float32_t max_z,
   const float32_t radius,
-  const Index capacity)
-: Config(min_x, max_x, min_y, max_y, min_z, max_z, radius, capacity)
+  const Index capacity,
+  const StorageBackend backend)
+: Config(min_x, max_x, min_y, max_y, min_z, max_z, radius, capacity, backend)
 {
 }
 ////////////////////////////////////////////////////////////////////////////////
@@ -110,8 +114,155 @@ Index Config3d::index_(const details::Index3 & idx) const
   return bin_impl(idx.x, idx.y, idx.z);
 }
 ////////////////////////////////////////////////////////////////////////////////
+namespace
+{
+constexpr float32_t kPi = 3.14159265358979F;
+}  // namespace
+////////////////////////////////////////////////////////////////////////////////
+ConfigPolar::ConfigPolar(
+  const float32_t max_range,
+  const float32_t ring_width,
+  const Index num_sectors,
+  const Index capacity,
+  const StorageBackend backend)
+: m_max_range{max_range},
+  m_ring_width{ring_width},
+  m_ring_width_inv{1.0F / ring_width},
+  m_sector_width{(2.0F * kPi) / static_cast<float32_t>(num_sectors)},
+  m_sector_width_inv{static_cast<float32_t>(num_sectors) / (2.0F * kPi)},
+  m_num_rings{},
+  m_num_sectors{num_sectors},
+  m_capacity{capacity},
+  m_backend{backend}
+{
+  if (!(max_range > 0.0F)) {
+    throw std::domain_error("SpatialHash::ConfigPolar: must have positive range");
+  }
+  if (!(ring_width > 0.0F)) {
+    throw std::domain_error("SpatialHash::ConfigPolar: must have positive ring width");
+  }
+  if (num_sectors == 0U) {
+    throw std::domain_error("SpatialHash::ConfigPolar: must have at least one sector");
+  }
+  const float64_t rings =
+    static_cast<float64_t>(max_range) / static_cast<float64_t>(ring_width);
+  // Sectors are unwrapped by up to one turn, so twice their number has to fit too
+  const Index max_index = std::numeric_limits<Index>::max() / 4U;
+  if ((rings >= static_cast<float64_t>(max_index)) || (num_sectors > max_index)) {
+    throw std::domain_error("SpatialHash::ConfigPolar: bin index may overflow!");
+  }
+  m_num_rings = static_cast<Index>(rings) + 1U;
+  if (m_num_sectors > (std::numeric_limits<Index>::max() / m_num_rings)) {
+    throw std::domain_error("SpatialHash::ConfigPolar: bin index may overflow!");
+  }
+  // small fudging to prevent weird boundary effects, as in the grid configuration
+  m_max_range -= std::numeric_limits<float32_t>::epsilon();
+}
+////////////////////////////////////////////////////////////////////////////////
+details::BinRange ConfigPolar::bin_range(
+  const details::Index3 & ref,
+  const float32_t radius) const
+{
+  const Index iradius = static_cast<Index>(std::ceil(radius * m_ring_width_inv));
+  const Index xmin = (ref.x > iradius) ? (ref.x - iradius) : 0U;
+  const Index xmax = std::min(ref.x + iradius, m_num_rings - 1U);
+  // Every point of the reference bin is at least this far from the origin, so a disc of the
+  // radius around it spans at most this azimuth to either side
+  const float32_t inner = static_cast<float32_t>(ref.x) * m_ring_width;
+  Index isectors = m_num_sectors;
+  if (radius < inner) {
+    isectors = static_cast<Index>(std::ceil(std::asin(radius / inner) * m_sector_width_inv));
+  }
+  if (((2U * isectors) + 1U) >= m_num_sectors) {
+    return {{xmin, m_num_sectors, Index{}}, {xmax, (2U * m_num_sectors) - 1U, Index{}}};
+  }
+  return {
+    {xmin, (ref.y + m_num_sectors) - isectors, Index{}},
+    {xmax, ref.y + m_num_sectors + isectors, Index{}}};
+}
+////////////////////////////////////////////////////////////////////////////////
+bool8_t ConfigPolar::next_bin(const details::BinRange & range, details::Index3 & idx) const
+{
+  bool8_t ret = true;
+  ++idx.x;
+  if (idx.x > range.second.x) {
+    idx.x = range.first.x;
+    ++idx.y;
+    if (idx.y > range.second.y) {
+      ret = false;
+    }
+  }
+  return ret;
+}
+////////////////////////////////////////////////////////////////////////////////
+Index ConfigPolar::get_capacity() const
+{
+  return m_capacity;
+}
+////////////////////////////////////////////////////////////////////////////////
+StorageBackend ConfigPolar::get_backend() const
+{
+  return m_backend;
+}
+////////////////////////////////////////////////////////////////////////////////
+float32_t ConfigPolar::get_bin_size() const
+{
+  return m_ring_width;
+}
+////////////////////////////////////////////////////////////////////////////////
+Index ConfigPolar::get_num_bins() const
+{
+  return m_num_rings * m_num_sectors;
+}
+////////////////////////////////////////////////////////////////////////////////
+Index ConfigPolar::bin(const float32_t x, const float32_t y, const float32_t z) const
+{
+  return index(index3(x, y, z));
+}
+////////////////////////////////////////////////////////////////////////////////
+bool ConfigPolar::is_candidate_bin(
+  const details::Index3 & ref,
+  const details::Index3 & query,
+  const float ref_distance2) const
+{
+  const Index iring = (ref.x >= query.x) ? (ref.x - query.x) : (query.x - ref.x);
+  const float32_t radial = std::max(static_cast<float32_t>(iring) - 1.0F, 0.0F) * m_ring_width;
+  // Two points at least inner away from the origin whose azimuths differ by the angle are at
+  // least inner * sin(angle) apart, or inner for angles above a right angle
+  const float32_t inner = static_cast<float32_t>(std::min(ref.x, query.x)) * m_ring_width;
+  const float32_t angle = static_cast<float32_t>(sector_distance(ref.y, query.y)) * m_sector_width;
+  const float32_t lateral = inner * std::sin(std::min(angle, 0.5F * kPi));
+  const float32_t dist = std::max(radial, lateral);
+  return (dist * dist) <= ref_distance2;
+}
+////////////////////////////////////////////////////////////////////////////////
+details::Index3 ConfigPolar::index3(const float32_t x, const float32_t y, const float32_t z) const
+{
+  (void)z;
+  const float32_t range = std::min(std::sqrt((x * x) + (y * y)), m_max_range);
+  const Index ring = static_cast<Index>(range * m_ring_width_inv);
+  const Index sector = static_cast<Index>(
+    std::max((std::atan2(y, x) + kPi) * m_sector_width_inv, 0.0F));
+  return {std::min(ring, m_num_rings - 1U), std::min(sector, m_num_sectors - 1U), Index{}};
+}
+////////////////////////////////////////////////////////////////////////////////
+Index ConfigPolar::index(const details::Index3 & idx) const
+{
+  return idx.x + ((idx.y % m_num_sectors) * m_num_rings);
+}
+////////////////////////////////////////////////////////////////////////////////
+Index ConfigPolar::sector_distance(const Index ref_idx, const Index query_idx) const
+{
+  const Index ref = ref_idx % m_num_sectors;
+  const Index query = query_idx % m_num_sectors;
+  Index idist = (ref >= query) ? (ref - query) : (query - ref);
+  idist = std::min(idist, m_num_sectors - idist);
+  return (idist > 0U) ? (idist - 1U) : 0U;
+}
+////////////////////////////////////////////////////////////////////////////////
 template class SpatialHash<geometry_msgs::msg::Point32, Config2d>;
 template class SpatialHash<geometry_msgs::msg::Point32, Config3d>;
+template class SpatialHash<geometry_msgs::msg::Point32, ConfigPolar>;
 }  // namespace spatial_hash
 }  // namespace geometry
 }  // namespace common
@@ -66,6 +66,11 @@ protected:
     box = autoware::common::geometry::bounding_box::lfit_bounding_box_2d(begin, end);
     // apex_test_tools::memory_test::stop();
   }
+  template<typename IT>
+  void lfit_search_bounding_box_2d(const IT begin, const IT end)
+  {
+    box = autoware::common::geometry::bounding_box::lfit_search_bounding_box_2d(begin, end);
+  }
 
   PointT make(const float x, const float y)
   {
@@ -583,6 +588,48 @@ TYPED_TEST(BoxTest, eigenbox3)
   this->test_corners(
     {this->make(-4, -0.04), this->make(-4, 0.04), this->make(4, -0.04), this->make(4, 0.04)}, 0.2F);
   this->test_orientation(0.0F, 1.0F);
+  //// Angle search should produce the same box ////
+  this->lfit_search_bounding_box_2d(v.begin(), v.end());
+  this->test_corners(
+    {this->make(-4, -0.04), this->make(-4, 0.04), this->make(4, -0.04), this->make(4, 0.04)}, 0.2F);
+  this->test_orientation(0.0F, 1.0F);
+}
+
+// L-shape as seen from a sensor, on two sides of a rotated rectangle
+TYPED_TEST(BoxTest, lfit_search)
+{
+  constexpr float32_t TH = 0.5F;
+  const float32_t c = cosf(TH);
+  const float32_t s = sinf(TH);
+  std::vector<TypeParam> v;
+  for (int32_t idx = 0; idx <= 40; ++idx) {
+    const float32_t t = 0.1F * static_cast<float32_t>(idx);
+    // long side of 4 m
+    v.push_back(this->make(10.0F + (c * t), 5.0F + (s * t)));
+    // short side of 2 m
+    if (idx <= 20) {
+      v.push_back(this->make(10.0F - (s * t), 5.0F + (c * t)));
+    }
+  }
+  const std::vector<TypeParam> corners{
+    this->make(10.0F, 5.0F),
+    this->make(10.0F + (4.0F * c), 5.0F + (4.0F * s)),
+    this->make(10.0F - (2.0F * s), 5.0F + (2.0F * c)),
+    this->make(10.0F + (4.0F * c) - (2.0F * s), 5.0F + (4.0F * s) + (2.0F * c))};
+  this->lfit_search_bounding_box_2d(v.begin(), v.end());
+  this->test_corners(corners, 0.05F);
+  this->test_orientation(this->rad2deg(TH), 0.5F);
+  // The points are not reordered, so the search works on lists as well
+  std::list<TypeParam> l{v.begin(), v.end()};
+  this->lfit_search_bounding_box_2d(l.begin(), l.end());
+  this->test_corners(corners, 0.05F);
+
+  using autoware::common::geometry::bounding_box::lfit_search_bounding_box_2d;
+  using autoware::common::geometry::bounding_box::LFitSearchConfig;
+  EXPECT_THROW(lfit_search_bounding_box_2d(v.begin(), v.begin() + 1), std::domain_error);
+  EXPECT_THROW(
+    lfit_search_bounding_box_2d(v.begin(), v.end(), LFitSearchConfig{0U, 2U, 0.01F}),
+    std::domain_error);
 }
 
 // bad case: causes intersection2d to fail
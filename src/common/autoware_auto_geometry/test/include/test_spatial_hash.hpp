@@ -18,6 +18,8 @@
 #define TEST_SPATIAL_HASH_HPP_
 
 #include <geometry_msgs/msg/point32.hpp>
+#include <algorithm>
+#include <random>
 #include <vector>
 #include <limits>
 #include "geometry/spatial_hash.hpp"
@@ -27,9 +29,13 @@ using autoware::common::types::float64_t;
 using autoware::common::types::bool8_t;
 using autoware::common::geometry::spatial_hash::Config2d;
 using autoware::common::geometry::spatial_hash::Config3d;
+using autoware::common::geometry::spatial_hash::ConfigPolar;
+using autoware::common::geometry::spatial_hash::Index;
 using autoware::common::geometry::spatial_hash::SpatialHash;
 using autoware::common::geometry::spatial_hash::SpatialHash2d;
 using autoware::common::geometry::spatial_hash::SpatialHash3d;
+using autoware::common::geometry::spatial_hash::SpatialHashPolar;
+using autoware::common::geometry::spatial_hash::StorageBackend;
 
 template<typename PointT>
 class TypedSpatialHashTest : public ::testing::Test
@@ -230,9 +236,228 @@ TYPED_TEST(TypedSpatialHashTest, 3d)
   EXPECT_EQ(count, 0U);
 }
 
+/// flat grid backend gives the same results as the hash map backend
+TYPED_TEST(TypedSpatialHashTest, flat_grid_matches_hash_map)
+{
+  using PointT = TypeParam;
+  const float32_t dr = 1.0F;
+  Config2d hash_cfg{-10.0F, 10.0F, -10.0F, 10.0F, 1.0F, 1024U};
+  Config2d flat_cfg{-10.0F, 10.0F, -10.0F, 10.0F, 1.0F, 1024U, StorageBackend::FLAT_GRID};
+  SpatialHash2d<PointT> hash{hash_cfg};
+  SpatialHash2d<PointT> flat{flat_cfg};
+
+  const uint32_t PTS_PER_RING = 16U;
+  const uint32_t NUM_RINGS = 5U;
+  this->add_points(hash, PTS_PER_RING, NUM_RINGS, dr, 0.5F, -0.5F);
+  this->add_points(flat, PTS_PER_RING, NUM_RINGS, dr, 0.5F, -0.5F);
+  ASSERT_EQ(hash.size(), flat.size());
+
+  for (const float32_t r : {0.5F, 1.5F, 2.5F, 4.0F}) {
+    // Copy distances since the output is invalidated on next query
+    std::vector<float32_t> hash_dists{};
+    for (const auto & itd : hash.near(this->ref, r)) {
+      hash_dists.push_back(itd.get_distance());
+    }
+    std::vector<float32_t> flat_dists{};
+    for (const auto & itd : flat.near(this->ref, r)) {
+      const PointT & pt = itd;
+      ASSERT_FLOAT_EQ(sqrtf((pt.x * pt.x) + (pt.y * pt.y)), itd.get_distance());
+      flat_dists.push_back(itd.get_distance());
+    }
+    std::sort(hash_dists.begin(), hash_dists.end());
+    std::sort(flat_dists.begin(), flat_dists.end());
+    EXPECT_EQ(hash_dists, flat_dists);
+  }
+  EXPECT_EQ(hash.bins_hit(), flat.bins_hit());
+  EXPECT_EQ(hash.neighbors_found(), flat.neighbors_found());
+}
+
+/// erasing from the flat grid backend
+TYPED_TEST(TypedSpatialHashTest, flat_grid_erase)
+{
+  using PointT = TypeParam;
+  Config2d cfg{-10.0F, 10.0F, -10.0F, 10.0F, 1.0F, 64U, StorageBackend::FLAT_GRID};
+  SpatialHash2d<PointT> hash{cfg};
+  EXPECT_TRUE(hash.empty());
+  const uint32_t PTS_PER_RING = 8U;
+  this->add_points(hash, PTS_PER_RING, 2U, 1.0F);
+  EXPECT_EQ(hash.size(), 2U * PTS_PER_RING);
+
+  // Erase everything in the inner ring
+  const float32_t r = 1.0F + this->EPS;
+  {
+    const auto & nbrs = hash.near(this->ref, r);
+    ASSERT_EQ(nbrs.size(), PTS_PER_RING);
+    for (const auto & itd : nbrs) {
+      (void)hash.erase(itd);
+    }
+    // Double erase is detected
+    EXPECT_THROW(hash.erase(nbrs.front()), std::domain_error);
+  }
+  EXPECT_EQ(hash.size(), PTS_PER_RING);
+  EXPECT_TRUE(hash.near(this->ref, r).empty());
+  uint32_t count = 0U;
+  for (auto iter = hash.cbegin(); iter != hash.cend(); ++iter) {
+    EXPECT_GT(sqrtf((iter->second.x * iter->second.x) + (iter->second.y * iter->second.y)), r);
+    ++count;
+  }
+  EXPECT_EQ(count, PTS_PER_RING);
+
+  // Drain via begin() like EuclideanCluster does
+  while (hash.begin() != hash.end()) {
+    (void)hash.erase(hash.begin());
+  }
+  EXPECT_TRUE(hash.empty());
+
+  // Reinsertion after clearing
+  hash.clear();
+  this->add_points(hash, PTS_PER_RING, 1U, 1.0F);
+  EXPECT_EQ(hash.near(this->ref, r).size(), PTS_PER_RING);
+  EXPECT_THROW(this->add_points(hash, 64U, 1U, 1.0F), std::length_error);
+}
+
+/// polar bins give the same neighbors as a brute force search, also across the wrap of the
+/// azimuth, close to the origin and past the outermost ring
+TYPED_TEST(TypedSpatialHashTest, polar_matches_brute_force)
+{
+  using PointT = TypeParam;
+  std::mt19937 gen{3U};
+  std::uniform_real_distribution<float32_t> dist{-40.0F, 40.0F};
+  std::vector<PointT> points;
+  for (uint32_t idx = 0U; idx < 2000U; ++idx) {
+    PointT pt;
+    pt.x = dist(gen);
+    pt.y = dist(gen);
+    pt.z = 0.0F;
+    points.push_back(pt);
+  }
+  for (const auto backend : {StorageBackend::HASH_MAP, StorageBackend::FLAT_GRID}) {
+    SpatialHashPolar<PointT> hash{ConfigPolar{30.0F, 1.0F, 64U, points.size(), backend}};
+    hash.insert(points.begin(), points.end());
+    for (uint32_t qdx = 0U; qdx < 200U; ++qdx) {
+      const PointT & ref = points[qdx];
+      // radius growing with the range, like a clustering threshold
+      const float32_t radius = 0.5F + (0.1F * sqrtf((ref.x * ref.x) + (ref.y * ref.y)));
+      uint32_t expected = 0U;
+      for (const auto & pt : points) {
+        const float32_t dx = pt.x - ref.x;
+        const float32_t dy = pt.y - ref.y;
+        if (((dx * dx) + (dy * dy)) <= (radius * radius)) {
+          ++expected;
+        }
+      }
+      EXPECT_EQ(hash.near(ref, radius).size(), expected) << qdx;
+    }
+    // Both sides of the azimuth wrap and the origin
+    hash.clear();
+    PointT pt;
+    pt.z = 0.0F;
+    for (const float32_t y : {-0.01F, 0.01F}) {
+      pt.x = -10.0F;
+      pt.y = y;
+      (void)hash.insert(pt);
+    }
+    pt.x = 0.0F;
+    pt.y = 0.0F;
+    (void)hash.insert(pt);
+    EXPECT_EQ(hash.near(-10.0F, 0.01F, 0.1F).size(), 2U);
+    EXPECT_EQ(hash.near(0.1F, 0.0F, 0.2F).size(), 1U);
+  }
+}
+
+/// k nearest neighbors are the same as with a brute force search, for all configurations and
+/// backends
+TYPED_TEST(TypedSpatialHashTest, knn_matches_brute_force)
+{
+  using PointT = TypeParam;
+  std::mt19937 gen{5U};
+  std::uniform_real_distribution<float32_t> dist{-20.0F, 20.0F};
+  std::vector<PointT> points;
+  for (uint32_t idx = 0U; idx < 1000U; ++idx) {
+    PointT pt;
+    pt.x = dist(gen);
+    pt.y = dist(gen);
+    pt.z = 0.1F * dist(gen);
+    points.push_back(pt);
+  }
+  // Distances to the k nearest points
+  const auto brute_force = [&points](const PointT & ref, const bool8_t is_3d, const Index k) {
+      std::vector<float32_t> dists;
+      for (const auto & pt : points) {
+        const float32_t dx = pt.x - ref.x;
+        const float32_t dy = pt.y - ref.y;
+        const float32_t dz = is_3d ? (pt.z - ref.z) : 0.0F;
+        dists.push_back(sqrtf((dx * dx) + (dy * dy) + (dz * dz)));
+      }
+      std::sort(dists.begin(), dists.end());
+      dists.resize(std::min(k, dists.size()));
+      return dists;
+    };
+  const auto check = [&](auto & hash, const bool8_t is_3d) {
+      hash.insert(points.begin(), points.end());
+      for (uint32_t qdx = 0U; qdx < 100U; ++qdx) {
+        // Query points off the stored points too, and outside of the grids
+        PointT ref = points[qdx];
+        ref.x *= 1.4F;
+        for (const Index k : {1U, 8U, 30U}) {
+          const auto expected = brute_force(ref, is_3d, k);
+          const auto & nbrs = hash.knn(ref, k);
+          ASSERT_EQ(nbrs.size(), expected.size());
+          for (Index idx = 0U; idx < nbrs.size(); ++idx) {
+            EXPECT_NEAR(nbrs[idx].get_distance(), expected[idx], this->EPS) << qdx;
+          }
+        }
+      }
+      // Fewer points than asked for
+      EXPECT_TRUE(hash.knn(this->ref, 0U).empty());
+      EXPECT_EQ(hash.knn(this->ref, 2000U).size(), points.size());
+      // The output storage is reused
+      const auto capacity = hash.knn(this->ref, 2000U).capacity();
+      hash.clear();
+      EXPECT_TRUE(hash.knn(this->ref, 8U).empty());
+      hash.insert(points.begin(), points.end());
+      EXPECT_EQ(hash.knn(this->ref, 8U).capacity(), capacity);
+    };
+  for (const auto backend : {StorageBackend::HASH_MAP, StorageBackend::FLAT_GRID}) {
+    SpatialHash2d<PointT> hash2d{Config2d{-15.0F, 15.0F, -15.0F, 15.0F, 1.0F, 1000U, backend}};
+    check(hash2d, false);
+    SpatialHash3d<PointT> hash3d{
+      Config3d{-15.0F, 15.0F, -15.0F, 15.0F, -1.0F, 1.0F, 2.0F, 1000U, backend}};
+    check(hash3d, true);
+    SpatialHashPolar<PointT> polar{ConfigPolar{15.0F, 0.5F, 64U, 1000U, backend}};
+    check(polar, false);
+  }
+}
+
+/// with a radius that grows with the range, the polar bins touched grow linearly with the radius
+/// and grid bins quadratically
+TEST(SpatialHashPolar, bins_hit)
+{
+  SpatialHashPolar<geometry_msgs::msg::Point32> polar{ConfigPolar{100.0F, 0.5F, 720U, 16U}};
+  SpatialHash2d<geometry_msgs::msg::Point32> grid{
+    Config2d{-100.0F, 100.0F, -100.0F, 100.0F, 0.5F, 16U}};
+  std::vector<Index> polar_hit;
+  std::vector<Index> grid_hit;
+  for (const float32_t range : {10.0F, 90.0F}) {
+    const Index polar_before = polar.bins_hit();
+    const Index grid_before = grid.bins_hit();
+    (void)polar.near(range, 0.0F, 0.05F * range);
+    (void)grid.near(range, 0.0F, 0.05F * range);
+    polar_hit.push_back(polar.bins_hit() - polar_before);
+    grid_hit.push_back(grid.bins_hit() - grid_before);
+  }
+  // The number of sectors stays the same, only the number of rings grows
+  EXPECT_LT(polar_hit[1U], 9U * polar_hit[0U]);
+  EXPECT_GT(grid_hit[1U], 36U * grid_hit[0U]);
+}
+
 /// edge cases
 TEST(SpatialHashConfig, bad_cases)
 {
+  // polar configuration
+  EXPECT_THROW(ConfigPolar(0.0F, 1.0F, 10U, 1024U), std::domain_error);
+  EXPECT_THROW(ConfigPolar(10.0F, -1.0F, 10U, 1024U), std::domain_error);
+  EXPECT_THROW(ConfigPolar(10.0F, 1.0F, 0U, 1024U), std::domain_error);
   // negative side length
   EXPECT_THROW(Config2d({-30.0F, 30.0F, -30.0F, 30.0F, -1.0F, 1024U}), std::domain_error);
   // min_x >= max_x
@@ -19,12 +19,15 @@
 #include <geometry/lookup_table.hpp>
 #include <common/types.hpp>
 
+#include <array>
+#include <limits>
 #include <memory>
 #include <vector>
 
 using autoware::common::helper_functions::lookup_1d;
 using autoware::common::helper_functions::interpolate;
 using autoware::common::helper_functions::LookupTable1D;
+using autoware::common::helper_functions::UniformLookupTable1D;
 using autoware::common::types::float32_t;
 using autoware::common::types::float64_t;
 
@@ -129,6 +132,67 @@ TYPED_TEST(sanity_check, below_range)
   this->check(result, this->range_.front());
 }
 
+TYPED_TEST(sanity_check, uniform)
+{
+  using T = TypeParam;
+  EXPECT_TRUE(this->table_->is_uniform());
+  const LookupTable1D<T> uneven{{T{1}, T{3}, T{4}}, this->range_};
+  EXPECT_FALSE(uneven.is_uniform());
+  this->check(uneven.lookup(T{2}), T{3});
+}
+
+TYPED_TEST(sanity_check, batch)
+{
+  using T = TypeParam;
+  const std::array<T, 6U> x{{T{0}, T{1}, T{2}, T{3}, T{5}, T{999999}}};
+  std::array<T, 6U> y{};
+  EXPECT_EQ(this->table_->lookup(x.begin(), x.end(), y.begin()), y.end());
+  const std::array<T, 6U> expected{{T{2}, T{2}, T{3}, T{4}, T{0}, T{0}}};
+  for (std::size_t idx = 0U; idx < x.size(); ++idx) {
+    this->check(expected[idx], y[idx]);
+  }
+}
+
+TYPED_TEST(sanity_check, static_table)
+{
+  using T = TypeParam;
+  constexpr UniformLookupTable1D<T, 3U> table{T{1}, T{5}, {{T{2}, T{4}, T{0}}}};
+  static_assert(table.domain_max() == T{5}, "Table is not constructed at compile time");
+  for (const auto x : {T{0}, T{1}, T{2}, T{3}, T{5}, T{999999}}) {
+    this->check(this->table_->lookup(x), table.lookup(x));
+  }
+  std::array<T, 2U> y{{T{2}, T{3}}};
+  table.lookup(y.begin(), y.end(), y.begin());
+  this->check(T{3}, y[0U]);
+  this->check(T{4}, y[1U]);
+  EXPECT_THROW((UniformLookupTable1D<T, 2U>{T{1}, T{1}, {{T{1}, T{2}}}}), std::domain_error);
+}
+
+// The O(1) lookup of evenly spaced domains must give the same result as the search
+TEST(lookup_table_uniform, matches_search)
+{
+  std::vector<float32_t> domain;
+  std::vector<float32_t> range;
+  for (int32_t idx = 0; idx <= 100; ++idx) {
+    // Not exactly representable, so the index guess is sometimes off by one
+    domain.push_back(-2.0F + (0.1F * static_cast<float32_t>(idx)));
+    range.push_back(static_cast<float32_t>((idx * idx) % 17));
+  }
+  const LookupTable1D<float32_t> table{domain, range};
+  ASSERT_TRUE(table.is_uniform());
+  for (int32_t idx = -10; idx <= 1010; ++idx) {
+    const auto x = -2.0F + (0.01F * static_cast<float32_t>(idx));
+    EXPECT_EQ(table.lookup(x), lookup_1d(domain, range, x)) << x;
+  }
+  for (const auto x : domain) {
+    EXPECT_EQ(table.lookup(x), lookup_1d(domain, range, x)) << x;
+  }
+  EXPECT_THROW(table.lookup(std::numeric_limits<float32_t>::quiet_NaN()), std::domain_error);
+  const std::array<float32_t, 2U> x{{0.0F, std::numeric_limits<float32_t>::infinity()}};
+  std::array<float32_t, 2U> y{};
+  EXPECT_THROW(table.lookup(x.begin(), x.end(), y.begin()), std::domain_error);
+}
+
 TEST(lookup_table_helpers, interpolate) {
   {
     const auto scaling = 0.0f;
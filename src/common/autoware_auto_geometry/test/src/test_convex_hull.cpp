@@ -16,7 +16,9 @@
 
 #include <gtest/gtest.h>
 #include <geometry_msgs/msg/point32.hpp>
+#include <algorithm>
 #include <list>
+#include <random>
 #include <vector>
 #include "geometry/convex_hull.hpp"
 
@@ -64,6 +66,33 @@ protected:
     }
   }
 
+  // check that the random access implementation forms the same hull as the list, in the same
+  // order, and keeps all points. Must be called before convex_hull()
+  void check_random_access_hull()
+  {
+    std::vector<PointT> points{list.begin(), list.end()};
+    const auto vector_last = autoware::common::geometry::convex_hull(points.begin(), points.end());
+    const auto list_last = convex_hull();
+    ASSERT_EQ(
+      std::distance(points.begin(), vector_last),
+      std::distance(list.cbegin(), list_last));
+    auto list_it = list.cbegin();
+    for (auto it = points.begin(); it != vector_last; ++it, ++list_it) {
+      EXPECT_FLOAT_EQ(it->x, list_it->x);
+      EXPECT_FLOAT_EQ(it->y, list_it->y);
+    }
+    std::vector<float32_t> list_ids, vector_ids;
+    for (const auto & pt : list) {
+      list_ids.push_back(pt.z);
+    }
+    for (const auto & pt : points) {
+      vector_ids.push_back(pt.z);
+    }
+    std::sort(list_ids.begin(), list_ids.end());
+    std::sort(vector_ids.begin(), vector_ids.end());
+    EXPECT_EQ(list_ids, vector_ids);
+  }
+
   PointT make(const float32_t x, const float32_t y, const float32_t z)
   {
     PointT ret;
@@ -369,4 +398,61 @@ TYPED_TEST(TypedConvexHullTest, root)
   EXPECT_EQ(last->z, 6);
 }
 
+TYPED_TEST(TypedConvexHullTest, random_access_small)
+{
+  std::vector<TypeParam> data({this->make(1, 0, 0), this->make(3, 1, 1), this->make(2, 2, 2)});
+  const auto last = autoware::common::geometry::convex_hull(data.begin(), data.end());
+  EXPECT_EQ(last, data.end());
+  // nothing is done for 3 points or fewer
+  EXPECT_FLOAT_EQ(data[0].z, 0);
+  EXPECT_FLOAT_EQ(data[1].z, 1);
+  EXPECT_FLOAT_EQ(data[2].z, 2);
+}
+
+TYPED_TEST(TypedConvexHullTest, random_access_root)
+{
+  const std::vector<TypeParam> data({
+    this->make(0, 0, 1),
+    this->make(1, -1, 2),
+    this->make(3, -2, 3),
+    this->make(4, 0, 4),
+    this->make(3, 1, 5),
+    this->make(1, 0, 6),
+  });
+  std::vector<TypeParam> points{data.rbegin(), data.rend()};
+  const auto last = autoware::common::geometry::convex_hull(points.begin(), points.end());
+
+  ASSERT_EQ(std::distance(points.begin(), last), 5);
+  for (uint32_t idx = 0U; idx < 5U; ++idx) {
+    EXPECT_FLOAT_EQ(points[idx].z, data[idx].z);
+  }
+  EXPECT_FLOAT_EQ(last->z, 6);
+}
+
+// collinear, overlapping and random points in a small grid so that there are many degenerate cases
+TYPED_TEST(TypedConvexHullTest, random_access_matches_list)
+{
+  std::mt19937 gen{42U};
+  std::uniform_int_distribution<int32_t> coordinate{-5, 5};
+  std::uniform_int_distribution<uint32_t> size{4U, 60U};
+  for (uint32_t run = 0U; run < 200U; ++run) {
+    this->list.clear();
+    const auto num_points = size(gen);
+    for (uint32_t idx = 0U; idx < num_points; ++idx) {
+      this->list.push_back(
+        this->make(
+          static_cast<float32_t>(coordinate(gen)), static_cast<float32_t>(coordinate(gen)),
+          static_cast<float32_t>(idx)));
+    }
+    this->check_random_access_hull();
+  }
+
+  this->list.clear();
+  for (uint32_t idx = 0U; idx < 9U; ++idx) {
+    const auto fidx = static_cast<float32_t>(idx);
+    this->list.push_back(this->make(-3.0F * fidx, 4.0F, fidx));
+  }
+  this->check_random_access_hull();
+}
+
 // TODO(c.ho) random input, fuzzing, stress tests
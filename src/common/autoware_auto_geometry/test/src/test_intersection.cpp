@@ -17,7 +17,14 @@
 #include <gtest/gtest.h>
 #include <geometry/intersection.hpp>
 #include <geometry/convex_hull.hpp>
+#include <array>
+#include <cmath>
 #include <list>
+#include <random>
+#include <utility>
+#include <vector>
+
+using autoware::common::types::float32_t;
 
 struct TestPoint
 {
@@ -176,3 +183,104 @@ TEST(IoUTest, no_intersection) {
   EXPECT_FLOAT_EQ(
     autoware::common::geometry::convex_intersection_over_union_2d(polygon1, polygon2), 0.0F);
 }
+
+namespace
+{
+using Box = std::array<autoware::common::geometry::Point, 4U>;
+
+Box make_box(
+  const float32_t x, const float32_t y, const float32_t yaw, const float32_t length,
+  const float32_t width)
+{
+  const float32_t c = cosf(yaw);
+  const float32_t s = sinf(yaw);
+  Box box;
+  const std::array<std::pair<float32_t, float32_t>, 4U> signs{{{1, 1}, {-1, 1}, {-1, -1}, {1, -1}}};
+  for (std::size_t idx = 0U; idx < box.size(); ++idx) {
+    const auto dx = 0.5F * length * signs[idx].first;
+    const auto dy = 0.5F * width * signs[idx].second;
+    box[idx].x = x + (c * dx) - (s * dy);
+    box[idx].y = y + (s * dx) + (c * dy);
+  }
+  return box;
+}
+}  // namespace
+
+// The fixed size polygon functions must agree with the iterator and list based ones on random
+// oriented boxes, in any order of the corners
+TEST(StaticPolygonTest, boxes_match_list_implementation) {
+  std::mt19937 gen{7U};
+  std::uniform_real_distribution<float32_t> position{-4.0F, 4.0F};
+  std::uniform_real_distribution<float32_t> yaw{-3.14F, 3.14F};
+  std::uniform_real_distribution<float32_t> size{0.5F, 4.0F};
+  uint32_t num_intersecting = 0U;
+  for (uint32_t run = 0U; run < 500U; ++run) {
+    const auto box1 = make_box(0.0F, 0.0F, yaw(gen), size(gen), size(gen));
+    auto box2 = make_box(position(gen), position(gen), yaw(gen), size(gen), size(gen));
+    // not in CCW order
+    std::swap(box2[0U], box2[1U]);
+
+    const bool collides = autoware::common::geometry::intersect(
+      box1.cbegin(), box1.cend(), box2.cbegin(), box2.cend());
+    EXPECT_EQ(autoware::common::geometry::intersect(box1, box2), collides) << run;
+    if (collides) {
+      ++num_intersecting;
+    }
+
+    std::list<autoware::common::geometry::Point> list1{box1.begin(), box1.end()};
+    std::list<autoware::common::geometry::Point> list2{box2.begin(), box2.end()};
+    autoware::common::geometry::convex_hull(list1);
+    autoware::common::geometry::convex_hull(list2);
+    const auto expected_iou =
+      autoware::common::geometry::convex_intersection_over_union_2d(list1, list2);
+    EXPECT_NEAR(
+      autoware::common::geometry::convex_intersection_over_union_2d(box1, box2), expected_iou,
+      1.0E-4F) << run;
+  }
+  // Both cases are covered
+  EXPECT_GT(num_intersecting, 50U);
+  EXPECT_LT(num_intersecting, 450U);
+}
+
+TEST(StaticPolygonTest, intersection) {
+  const std::array<TestPoint, 4U> square{{{0.0F, 0.0F}, {10.0F, 0.0F}, {0.0F, 10.0F},
+    {10.0F, 10.0F}}};
+  const std::array<TestPoint, 3U> triangle{{{5.0F, 1.0F}, {5.0F, 9.0F}, {15.0F, 5.0F}}};
+  const auto result = autoware::common::geometry::convex_polygon_intersection2d(square, triangle);
+
+  std::list<TestPoint> expected{{5.0F, 1.0F}, {5.0F, 9.0F}, {10.0F, 3.0F}, {10.0F, 7.0F}};
+  order_ccw(expected);
+  std::list<TestPoint> ordered_result{result.begin(), result.end()};
+  order_ccw(ordered_result);
+  ASSERT_EQ(ordered_result.size(), expected.size());
+  auto expected_it = expected.begin();
+  for (const auto & pt : ordered_result) {
+    EXPECT_NEAR(pt.x, expected_it->x, 1.0E-5F);
+    EXPECT_NEAR(pt.y, expected_it->y, 1.0E-5F);
+    ++expected_it;
+  }
+  EXPECT_FLOAT_EQ(autoware::common::geometry::area_2d(result.begin(), result.end()), 30.0F);
+
+  const std::array<TestPoint, 3U> far_triangle{{{15.0F, 1.0F}, {15.0F, 9.0F}, {25.0F, 5.0F}}};
+  EXPECT_TRUE(
+    autoware::common::geometry::convex_polygon_intersection2d(square, far_triangle).empty());
+  const std::array<TestPoint, 3U> line{{{1.0F, 1.0F}, {2.0F, 2.0F}, {3.0F, 3.0F}}};
+  EXPECT_TRUE(autoware::common::geometry::convex_polygon_intersection2d(square, line).empty());
+  EXPECT_FLOAT_EQ(
+    autoware::common::geometry::convex_intersection_over_union_2d(square, line), 0.0F);
+}
+
+TEST(StaticPolygonTest, find_intersecting) {
+  const auto ego = make_box(0.0F, 0.0F, 0.3F, 4.0F, 2.0F);
+  const std::vector<Box> obstacles{
+    make_box(10.0F, 0.0F, 0.0F, 4.0F, 2.0F),
+    make_box(0.0F, 5.0F, 1.0F, 4.0F, 2.0F),
+    make_box(2.5F, 1.5F, 0.5F, 2.0F, 2.0F),
+    make_box(0.0F, 0.0F, 0.0F, 1.0F, 1.0F)};
+  const auto it =
+    autoware::common::geometry::find_intersecting(ego, obstacles.begin(), obstacles.end());
+  EXPECT_EQ(std::distance(obstacles.begin(), it), 2);
+  EXPECT_EQ(
+    autoware::common::geometry::find_intersecting(ego, obstacles.begin(), obstacles.begin() + 2),
+    obstacles.begin() + 2);
+}
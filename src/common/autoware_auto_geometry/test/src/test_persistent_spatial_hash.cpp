@@ -0,0 +1,266 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#include <gtest/gtest.h>
+#include <geometry/persistent_spatial_hash.hpp>
+#include <geometry_msgs/msg/point32.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using autoware::common::types::bool8_t;
+using autoware::common::types::float32_t;
+using autoware::common::geometry::spatial_hash::Index;
+using autoware::common::geometry::spatial_hash::PersistentConfig;
+using autoware::common::geometry::spatial_hash::PersistentSpatialHash2d;
+using autoware::common::geometry::spatial_hash::PersistentSpatialHash3d;
+using Point = geometry_msgs::msg::Point32;
+
+namespace
+{
+Point make_point(const float32_t x, const float32_t y, const float32_t z)
+{
+  Point pt;
+  pt.x = x;
+  pt.y = y;
+  pt.z = z;
+  return pt;
+}
+
+/// A model of the stored points, to compare near neighbor queries against
+template<typename HashT>
+struct Model
+{
+  using Handle = typename HashT::Handle;
+  std::vector<std::pair<Handle, Point>> points;
+
+  Index count_near(const Point & ref, const float32_t radius, const bool8_t is_3d) const
+  {
+    Index count = 0U;
+    for (const auto & entry : points) {
+      const float32_t dx = entry.second.x - ref.x;
+      const float32_t dy = entry.second.y - ref.y;
+      const float32_t dz = is_3d ? (entry.second.z - ref.z) : 0.0F;
+      if (((dx * dx) + (dy * dy) + (dz * dz)) <= (radius * radius)) {
+        ++count;
+      }
+    }
+    return count;
+  }
+};
+
+/// Drive through a random field of points, inserting the points around the ego vehicle, erasing
+/// and moving some of them, and compare queries against a model which drops the points that
+/// leave the window
+template<typename HashT>
+void check_rolling(HashT & hash, const bool8_t is_3d)
+{
+  constexpr float32_t SIDE = 1.0F;
+  // The window is 32 x 32 (x 4) bins
+  const auto in_window = [is_3d](const Point & pt, const Point & center) {
+      const auto inside = [](const float32_t value, const float32_t middle, const float32_t half) {
+          const float32_t first = (std::floor(middle / SIDE) - half) * SIDE;
+          return (value >= first) && (value < (first + (2.0F * half * SIDE)));
+        };
+      return inside(pt.x, center.x, 16.0F) && inside(pt.y, center.y, 16.0F) &&
+             (!is_3d || inside(pt.z, center.z, 2.0F));
+    };
+  std::mt19937 gen{7U};
+  std::uniform_real_distribution<float32_t> offset{-20.0F, 20.0F};
+  std::uniform_real_distribution<float32_t> height{-2.5F, 2.5F};
+  Model<HashT> model;
+  Point ego = make_point(0.0F, 0.0F, 0.0F);
+  hash.recenter(ego.x, ego.y, ego.z);
+  for (uint32_t step = 0U; step < 60U; ++step) {
+    // Drive, sometimes far enough that the whole window scrolls out
+    ego.x += (step == 30U) ? 100.0F : 2.3F;
+    ego.y += (step % 3U == 0U) ? -1.7F : 0.9F;
+    ego.z += (step % 5U == 0U) ? 1.2F : -0.3F;
+    hash.recenter(ego.x, ego.y, ego.z);
+    model.points.erase(
+      std::remove_if(
+        model.points.begin(), model.points.end(),
+        [&](const auto & entry) {return !in_window(entry.second, ego);}),
+      model.points.end());
+    for (const auto & entry : model.points) {
+      ASSERT_TRUE(hash.contains(entry.first));
+      ASSERT_EQ(hash.get(entry.first).x, entry.second.x);
+    }
+    // Insert points around the ego vehicle, some of them outside of the window
+    for (uint32_t idx = 0U; idx < 40U; ++idx) {
+      const Point pt = make_point(ego.x + offset(gen), ego.y + offset(gen), ego.z + height(gen));
+      const auto handle = hash.insert(pt);
+      ASSERT_EQ(hash.contains(handle), in_window(pt, ego));
+      if (hash.contains(handle)) {
+        model.points.emplace_back(handle, pt);
+      }
+    }
+    // Erase one point and move another one by a few bins
+    if (model.points.size() > 2U) {
+      hash.erase(model.points.front().first);
+      EXPECT_FALSE(hash.contains(model.points.front().first));
+      EXPECT_THROW(hash.erase(model.points.front().first), std::domain_error);
+      model.points.erase(model.points.begin());
+      auto & moved = model.points.back();
+      moved.second.x += 3.0F;
+      if (hash.move(moved.first, moved.second)) {
+        EXPECT_EQ(hash.get(moved.first).x, moved.second.x);
+      } else {
+        EXPECT_FALSE(in_window(moved.second, ego));
+        model.points.pop_back();
+      }
+    }
+    ASSERT_EQ(hash.size(), model.points.size());
+    // Query around stored points and the ego vehicle
+    for (Index qdx = 0U; qdx < std::min(model.points.size(), Index{10U}); ++qdx) {
+      const Point & ref = model.points[qdx * model.points.size() / 10U].second;
+      for (const float32_t radius : {0.7F, 2.5F, 6.0F}) {
+        const auto & nbrs = hash.near(ref, radius);
+        ASSERT_EQ(nbrs.size(), model.count_near(ref, radius, is_3d)) << step;
+        for (const auto & nbr : nbrs) {
+          ASSERT_TRUE(hash.contains(nbr.get_handle()));
+          EXPECT_LE(nbr.get_distance(), radius);
+        }
+      }
+    }
+    EXPECT_EQ(hash.near(ego, 30.0F).size(), model.count_near(ego, 30.0F, is_3d));
+  }
+}
+}  // namespace
+
+TEST(PersistentSpatialHash, handles)
+{
+  PersistentSpatialHash2d<Point> hash{PersistentConfig{1.0F, 10U, 10U, 1U, 3U}};
+  EXPECT_TRUE(hash.empty());
+  const auto first = hash.insert(make_point(0.5F, 0.5F, 100.0F));
+  const auto second = hash.insert(make_point(1.5F, 0.5F, 0.0F));
+  EXPECT_TRUE(hash.contains(first));
+  EXPECT_NE(first, second);
+  EXPECT_EQ(hash.size(), 2U);
+  // Outside of the window
+  const auto outside = hash.insert(make_point(-0.5F, 0.5F, 0.0F));
+  EXPECT_FALSE(hash.contains(outside));
+  EXPECT_THROW(hash.get(outside), std::domain_error);
+  EXPECT_EQ(hash.size(), 2U);
+
+  // Moving keeps the handle
+  EXPECT_TRUE(hash.move(first, make_point(5.5F, 5.5F, 0.0F)));
+  EXPECT_TRUE(hash.contains(first));
+  EXPECT_TRUE(hash.near(make_point(0.5F, 0.5F, 0.0F), 0.5F).empty());
+  ASSERT_EQ(hash.near(make_point(5.0F, 5.0F, 0.0F), 1.0F).size(), 1U);
+  EXPECT_EQ(hash.near(make_point(5.0F, 5.0F, 0.0F), 1.0F).front().get_handle(), first);
+  EXPECT_FALSE(hash.move(first, make_point(15.5F, 5.5F, 0.0F)));
+  EXPECT_FALSE(hash.contains(first));
+  EXPECT_EQ(hash.size(), 1U);
+
+  // A slot which is reused doesn't revive an old handle
+  hash.erase(second);
+  const auto third = hash.insert(make_point(1.5F, 0.5F, 0.0F));
+  EXPECT_FALSE(hash.contains(second));
+  EXPECT_TRUE(hash.contains(third));
+  EXPECT_THROW(hash.erase(second), std::domain_error);
+
+  (void)hash.insert(make_point(2.5F, 0.5F, 0.0F));
+  (void)hash.insert(make_point(3.5F, 0.5F, 0.0F));
+  EXPECT_THROW(hash.insert(make_point(4.5F, 0.5F, 0.0F)), std::length_error);
+  hash.clear();
+  EXPECT_TRUE(hash.empty());
+  EXPECT_FALSE(hash.contains(third));
+}
+
+TEST(PersistentSpatialHash, rolling_2d)
+{
+  PersistentSpatialHash2d<Point> hash{PersistentConfig{1.0F, 32U, 32U, 1U, 4096U}};
+  check_rolling(hash, false);
+}
+
+TEST(PersistentSpatialHash, rolling_3d)
+{
+  PersistentSpatialHash3d<Point> hash{PersistentConfig{1.0F, 32U, 32U, 4U, 4096U}};
+  check_rolling(hash, true);
+}
+
+TEST(PersistentSpatialHash, compact)
+{
+  PersistentSpatialHash2d<Point> hash{PersistentConfig{1.0F, 16U, 16U, 1U, 512U}};
+  std::mt19937 gen{11U};
+  std::uniform_real_distribution<float32_t> dist{0.0F, 16.0F};
+  std::vector<PersistentSpatialHash2d<Point>::Handle> handles;
+  for (uint32_t idx = 0U; idx < 500U; ++idx) {
+    handles.push_back(hash.insert(make_point(dist(gen), dist(gen), 0.0F)));
+  }
+  for (uint32_t idx = 0U; idx < 500U; idx += 3U) {
+    hash.erase(handles[idx]);
+  }
+  const Point ref = make_point(8.0F, 8.0F, 0.0F);
+  std::vector<float32_t> before;
+  for (const auto & nbr : hash.near(ref, 5.0F)) {
+    before.push_back(nbr.get_distance());
+  }
+  const Index size = hash.size();
+
+  hash.compact();
+  EXPECT_EQ(hash.size(), size);
+  std::vector<float32_t> after;
+  for (const auto & nbr : hash.near(ref, 5.0F)) {
+    after.push_back(nbr.get_distance());
+  }
+  std::sort(before.begin(), before.end());
+  std::sort(after.begin(), after.end());
+  EXPECT_EQ(before, after);
+  // Handles from before the compaction are invalid
+  for (const auto handle : handles) {
+    EXPECT_FALSE(hash.contains(handle));
+  }
+  // The points of a bin are one after the other in storage, and the storage is dense
+  Index count = 0U;
+  Point last = make_point(-1.0F, -1.0F, 0.0F);
+  Index num_runs = 0U;
+  hash.for_each(
+    [&](const PersistentSpatialHash2d<Point>::Handle handle, const Point & pt) {
+      EXPECT_TRUE(hash.contains(handle));
+      if ((std::floor(pt.x) != std::floor(last.x)) || (std::floor(pt.y) != std::floor(last.y))) {
+        ++num_runs;
+      }
+      last = pt;
+      ++count;
+    });
+  EXPECT_EQ(count, size);
+  EXPECT_LE(num_runs, 256U);
+  // Erasing and inserting still work
+  hash.erase(hash.near(ref, 5.0F).front().get_handle());
+  EXPECT_EQ(hash.size(), size - 1U);
+  for (Index idx = hash.size(); idx < hash.capacity(); ++idx) {
+    EXPECT_TRUE(hash.contains(hash.insert(make_point(dist(gen), dist(gen), 0.0F))));
+  }
+  EXPECT_THROW(hash.insert(ref), std::length_error);
+}
+
+TEST(PersistentSpatialHash, bad_config)
+{
+  EXPECT_THROW(PersistentConfig(0.0F, 10U, 10U, 1U, 10U), std::domain_error);
+  EXPECT_THROW(PersistentConfig(1.0F, 0U, 10U, 1U, 10U), std::domain_error);
+  EXPECT_THROW(PersistentConfig(1.0F, 10U, 10U, 0U, 10U), std::domain_error);
+  EXPECT_THROW(PersistentConfig(1.0F, 10U, 10U, 1U, 0U), std::domain_error);
+  EXPECT_THROW(PersistentConfig(1.0F, 1U << 16U, 1U << 16U, 1U, 10U), std::domain_error);
+  EXPECT_THROW(
+    PersistentSpatialHash2d<Point>{PersistentConfig(1.0F, 10U, 10U, 2U, 10U)},
+    std::domain_error);
+}
@@ -23,6 +23,7 @@
 #include <covariance_insertion/traits.hpp>
 #include <covariance_insertion/output_type_trait.hpp>
 
+#include <stdexcept>
 #include <string>
 #include <vector>
 
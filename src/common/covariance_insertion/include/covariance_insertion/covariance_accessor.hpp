@@ -0,0 +1,126 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef COVARIANCE_INSERTION__COVARIANCE_ACCESSOR_HPP_
+#define COVARIANCE_INSERTION__COVARIANCE_ACCESSOR_HPP_
+
+#include <common/types.hpp>
+#include <covariance_insertion/add_covariance.hpp>
+#include <covariance_insertion/traits.hpp>
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+namespace autoware
+{
+namespace covariance_insertion
+{
+
+/// @brief      The covariance entries of one field of a message.
+struct CovarianceSpan
+{
+  common::types::float64_t * data;
+  std::size_t size;
+};
+
+/// @brief      A function that finds the covariance of one field in a message.
+template<typename MsgT>
+using CovarianceAccessor = CovarianceSpan (*)(MsgT &);
+
+namespace detail
+{
+template<typename MsgT>
+CovarianceSpan direct_covariance(MsgT & msg) noexcept
+{
+  return CovarianceSpan{msg.covariance.data(), msg.covariance.size()};
+}
+
+template<typename MsgT>
+CovarianceSpan pose_covariance(MsgT & msg) noexcept
+{
+  return direct_covariance(msg.pose);
+}
+
+template<typename MsgT>
+CovarianceSpan twist_covariance(MsgT & msg) noexcept
+{
+  return direct_covariance(msg.twist);
+}
+}  // namespace detail
+
+/// @brief      Resolve the field of a message that holds the covariance directly.
+/// @throws     std::runtime_error if the field is not "directly".
+template<typename MsgT>
+CovarianceAccessor<MsgT> covariance_accessor(
+  const std::enable_if_t<has_covariance_member<MsgT>::value, std::string> & field)
+{
+  if (field != detail::kDirectlyTag) {
+    throw std::runtime_error("Message has covariance directly, but asked for field: " + field);
+  }
+  return &detail::direct_covariance<MsgT>;
+}
+
+/// @brief      Resolve the field of a message that only holds a twist with covariance.
+/// @throws     std::runtime_error if the field is not "twist".
+template<typename MsgT>
+CovarianceAccessor<MsgT> covariance_accessor(
+  const std::enable_if_t<
+    has_twist_member<MsgT>::value &&
+    !has_pose_member<MsgT>::value &&
+    !has_covariance_member<MsgT>::value, std::string> & field)
+{
+  if (field != detail::kTwistTag) {
+    throw std::runtime_error("Cannot set: " + field);
+  }
+  return &detail::twist_covariance<MsgT>;
+}
+
+/// @brief      Resolve the field of a message that only holds a pose with covariance.
+/// @throws     std::runtime_error if the field is not "pose".
+template<typename MsgT>
+CovarianceAccessor<MsgT> covariance_accessor(
+  const std::enable_if_t<
+    !has_twist_member<MsgT>::value &&
+    has_pose_member<MsgT>::value &&
+    !has_covariance_member<MsgT>::value, std::string> & field)
+{
+  if (field != detail::kPoseTag) {
+    throw std::runtime_error("Cannot set: " + field);
+  }
+  return &detail::pose_covariance<MsgT>;
+}
+
+/// @brief      Resolve the field of a message that holds a pose and a twist with covariance.
+/// @throws     std::runtime_error if the field is neither "pose" nor "twist".
+template<typename MsgT>
+CovarianceAccessor<MsgT> covariance_accessor(
+  const std::enable_if_t<
+    has_twist_member<MsgT>::value &&
+    has_pose_member<MsgT>::value &&
+    !has_covariance_member<MsgT>::value, std::string> & field)
+{
+  if (field == detail::kTwistTag) {
+    return &detail::twist_covariance<MsgT>;
+  } else if (field == detail::kPoseTag) {
+    return &detail::pose_covariance<MsgT>;
+  } else {
+    throw std::runtime_error("Cannot set: " + field);
+  }
+}
+
+}  // namespace covariance_insertion
+}  // namespace autoware
+
+#endif  // COVARIANCE_INSERTION__COVARIANCE_ACCESSOR_HPP_
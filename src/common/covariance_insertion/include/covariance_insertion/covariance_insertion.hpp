@@ -22,16 +22,63 @@
 
 #include <common/types.hpp>
 #include <covariance_insertion/add_covariance.hpp>
+#include <covariance_insertion/covariance_accessor.hpp>
 #include <covariance_insertion/visibility_control.hpp>
 
+#include <algorithm>
 #include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace autoware
 {
 namespace covariance_insertion
 {
+/// @brief Covariances for a fixed message type, with all fields resolved in advance so that
+///        inserting them into a message does not look anything up, check or allocate
+template<typename MsgT>
+class CovarianceInsertionPlan
+{
+public:
+  /// @brief      add a covariance to be written into the given field of every message
+  /// @throws     std::runtime_error if the message type has no such field or if the number of
+  ///             entries does not match this field
+  void add(const std::string & field, std::vector<common::types::float64_t> covariance)
+  {
+    const auto accessor = covariance_accessor<MsgT>(field);
+    MsgT msg{};
+    const auto size = accessor(msg).size;
+    if (size != covariance.size()) {
+      throw std::runtime_error(
+              "Number of covariance entries does not match. The message has " +
+              std::to_string(size) + " entries, while there are " +
+              std::to_string(covariance.size()) + " entries in parameters of this node.");
+    }
+    m_entries.push_back(Entry{accessor, std::move(covariance)});
+  }
+
+  /// @brief      write all covariances into the message
+  /// @param      msg  message to be populated
+  void apply(MsgT & msg) const noexcept
+  {
+    for (const auto & entry : m_entries) {
+      std::copy(entry.covariance.begin(), entry.covariance.end(), entry.accessor(msg).data);
+    }
+  }
+
+  /// @brief      check if there are no covariances to insert
+  bool empty() const noexcept {return m_entries.empty();}
+
+private:
+  struct Entry
+  {
+    CovarianceAccessor<MsgT> accessor;
+    std::vector<common::types::float64_t> covariance;
+  };
+  std::vector<Entry> m_entries;
+};
+
 /// @brief Class for performing covariance insertion
 class COVARIANCE_INSERTION_PUBLIC CovarianceInsertion
 {
@@ -52,6 +99,18 @@ public:
     }
   }
 
+  /// @brief      resolve all covariances for a message type, to insert them at a high rate
+  /// @throws     std::runtime_error if a covariance does not fit the message type
+  template<typename MsgT>
+  CovarianceInsertionPlan<MsgT> make_plan() const
+  {
+    CovarianceInsertionPlan<MsgT> plan{};
+    for (const auto & kv : m_covariances) {
+      plan.add(kv.first, kv.second);
+    }
+    return plan;
+  }
+
   /// @brief      check if the covariance map is empty
   bool covariances_empty();
 
@@ -23,6 +23,8 @@
 
 #include <string>
 #include <memory>
+#include <type_traits>
+#include <utility>
 #include <vector>
 #include <map>
 
@@ -56,6 +58,20 @@ static constexpr auto kTwistWithCovarianceStampedMsgType = "TwistWithCovarianceS
 static constexpr std::array<const char *, 3> kPossibleOverrideFieldNames{
   covariance_insertion::detail::kDirectlyTag, covariance_insertion::detail::kPoseTag,
   covariance_insertion::detail::kTwistTag};
+
+template<typename InputT>
+std::unique_ptr<typename output<InputT>::type> to_output(
+  std::unique_ptr<InputT> input_msg, std::false_type)
+{
+  return input_msg;
+}
+
+template<typename InputT>
+std::unique_ptr<typename output<InputT>::type> to_output(
+  std::unique_ptr<InputT> input_msg, std::true_type)
+{
+  return std::make_unique<typename output<InputT>::type>(convert(*input_msg));
+}
 }  // namespace
 
 CovarianceInsertionNode::CovarianceInsertionNode(const rclcpp::NodeOptions & options)
@@ -117,8 +133,7 @@ void CovarianceInsertionNode::validate(const MsgVariant & msg_variant)
     [&](const auto & msg) {
       using InputMsgT = std::decay_t<decltype(msg)>;
       using OutputType = typename output<InputMsgT>::type;
-      OutputType new_msg{};
-      m_core->set_all_covariances(&new_msg);
+      (void)m_core->make_plan<OutputType>();
     }, msg_variant);
 }
 
@@ -129,15 +144,18 @@ void CovarianceInsertionNode::create_pub_sub(const MsgVariant & msg_variant)
     [&](const auto & msg) {
       using InputMsgT = std::decay_t<decltype(msg)>;
       using OutputType = typename output<InputMsgT>::type;
-      m_publisher = create_publisher<OutputType>(m_output_topic, m_history_size);
+      auto publisher = create_publisher<OutputType>(m_output_topic, m_history_size);
+      m_publisher = publisher;
+      // The messages are owned by the callback, so they are modified in place and handed over to
+      // the publisher without copies when intra-process communication is enabled.
       m_subscription = create_subscription<InputMsgT>(
         m_input_topic, m_history_size,
-        [&](const typename InputMsgT::SharedPtr msg) {
+        [publisher, plan = m_core->make_plan<OutputType>()](
+          std::unique_ptr<InputMsgT> msg) {
           if (!msg) {return;}
-          auto new_msg = convert(*msg);
-          m_core->set_all_covariances(&new_msg);
-          auto publisher = std::static_pointer_cast<rclcpp::Publisher<OutputType>>(m_publisher);
-          publisher->publish(new_msg);
+          auto new_msg = to_output(std::move(msg), needs_conversion<InputMsgT>{});
+          plan.apply(*new_msg);
+          publisher->publish(std::move(new_msg));
         });
     }, msg_variant);
 }
@@ -201,3 +201,36 @@ TEST_F(CovarianceInsertionNodeTest, fail_on_wrong_number_of_entries) {
     std::vector<autoware::common::types::float64_t>(wrong_covariane_size, 42.0));
   EXPECT_THROW(CovarianceInsertionNode{node_options}, std::runtime_error);
 }
+
+/// @test Test that a plan writes all covariances into the fields they were resolved to.
+TEST(CovarianceInsertionPlanTest, apply_to_odometry) {
+  autoware::covariance_insertion::CovarianceInsertion core{};
+  core.insert_covariance("pose", std::vector<autoware::common::types::float64_t>(36UL, 42.0));
+  core.insert_covariance("twist", std::vector<autoware::common::types::float64_t>(36UL, 23.0));
+  const auto plan = core.make_plan<nav_msgs::msg::Odometry>();
+  EXPECT_FALSE(plan.empty());
+
+  nav_msgs::msg::Odometry msg{};
+  plan.apply(msg);
+  for (const auto & val : msg.pose.covariance) {
+    EXPECT_DOUBLE_EQ(42.0, val);
+  }
+  for (const auto & val : msg.twist.covariance) {
+    EXPECT_DOUBLE_EQ(23.0, val);
+  }
+}
+
+/// @test Test that a plan cannot be made for fields that do not fit the message type.
+TEST(CovarianceInsertionPlanTest, fail_on_wrong_fields) {
+  autoware::covariance_insertion::CovarianceInsertion wrong_field{};
+  wrong_field.insert_covariance(
+    "twist", std::vector<autoware::common::types::float64_t>(36UL, 42.0));
+  EXPECT_THROW(
+    wrong_field.make_plan<geometry_msgs::msg::PoseWithCovarianceStamped>(), std::runtime_error);
+
+  autoware::covariance_insertion::CovarianceInsertion wrong_size{};
+  wrong_size.insert_covariance(
+    "twist", std::vector<autoware::common::types::float64_t>(42UL, 42.0));
+  EXPECT_THROW(
+    wrong_size.make_plan<geometry_msgs::msg::TwistWithCovarianceStamped>(), std::runtime_error);
+}
@@ -0,0 +1,53 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief Callback groups of a node that are chosen by parameters
+
+#ifndef EXECUTOR_TOPOLOGY__CALLBACK_GROUPS_HPP_
+#define EXECUTOR_TOPOLOGY__CALLBACK_GROUPS_HPP_
+
+#include <common/types.hpp>
+#include <executor_topology/visibility_control.hpp>
+#include <rclcpp/node.hpp>
+
+#include <string>
+
+namespace autoware
+{
+namespace common
+{
+namespace executor_topology
+{
+using autoware::common::types::bool8_t;
+
+/// \brief Declare the parameter `callback_groups.<name>` of a node and create the callback group
+///        that it asks for. The values are "default" for the default group of the node, i.e.
+///        the behaviour of a node without this call, "mutually_exclusive" and "reentrant".
+///        Callbacks of different groups may run in parallel on a multi-threaded executor
+/// \param[in] node The node
+/// \param[in] name Name of the group within the node, e.g. "points"
+/// \param[in] reentrant_allowed Whether the callbacks of the group may run in parallel with
+///                              themselves, i.e. whether "reentrant" is a valid value
+/// \return The group to put into the options of subscriptions and timers. nullptr for the
+///         default group. The node only keeps a weak reference, i.e. it must keep the group
+///         alive as long as its entities
+/// \throws std::domain_error If the parameter has an unknown or a disallowed value
+EXECUTOR_TOPOLOGY_PUBLIC rclcpp::CallbackGroup::SharedPtr declare_callback_group(
+  rclcpp::Node & node, const std::string & name, bool8_t reentrant_allowed = false);
+}  // namespace executor_topology
+}  // namespace common
+}  // namespace autoware
+
+#endif  // EXECUTOR_TOPOLOGY__CALLBACK_GROUPS_HPP_
@@ -0,0 +1,100 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief An executor that hands nodes to per-node executors on configured threads
+
+#ifndef EXECUTOR_TOPOLOGY__DISPATCHING_EXECUTOR_HPP_
+#define EXECUTOR_TOPOLOGY__DISPATCHING_EXECUTOR_HPP_
+
+#include <executor_topology/executor_config.hpp>
+#include <executor_topology/visibility_control.hpp>
+#include <rclcpp/executors/single_threaded_executor.hpp>
+#include <rclcpp/node.hpp>
+
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace autoware
+{
+namespace common
+{
+namespace executor_topology
+{
+/// \brief A single-threaded executor that adds each node to the executor that the
+///        configuration assigns it to instead, based on its fully qualified name. Each of those
+///        spins on its own threads with their CPU affinity and priority. Nodes without an
+///        executor, e.g. the component manager, are spun by this executor itself in spin()
+class EXECUTOR_TOPOLOGY_PUBLIC DispatchingExecutor
+  : public rclcpp::executors::SingleThreadedExecutor
+{
+public:
+  /// \brief Constructor
+  /// \param[in] options The options of this executor. The assigned executors share its context
+  explicit DispatchingExecutor(const rclcpp::ExecutorOptions & options = rclcpp::ExecutorOptions());
+  /// \brief Destructor, stops the threads of the assigned executors
+  ~DispatchingExecutor() override;
+
+  /// \brief Create the executors and start their threads. Only nodes that are added afterwards
+  ///        are dispatched
+  /// \param[in] configs The executors
+  /// \throws std::domain_error If the configuration is invalid, see validate()
+  /// \throws std::logic_error If the executor was already started
+  /// \throws std::runtime_error If the affinity or the priority can't be applied
+  void start(const std::vector<ExecutorConfig> & configs);
+
+  using rclcpp::executors::SingleThreadedExecutor::add_node;
+  using rclcpp::executors::SingleThreadedExecutor::remove_node;
+
+  /// \brief Add a node to its executor, or to this one if it has none
+  void add_node(
+    rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_ptr,
+    bool notify = true) override;
+  /// \brief Remove a node from the executor that it was added to
+  void remove_node(
+    rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_ptr,
+    bool notify = true) override;
+
+private:
+  struct Worker
+  {
+    ExecutorConfig config;
+    std::shared_ptr<rclcpp::Executor> executor;
+    std::thread thread;
+    std::future<void> finished;
+  };
+
+  EXECUTOR_TOPOLOGY_LOCAL rclcpp::Executor & executor_of(
+    const rclcpp::node_interfaces::NodeBaseInterface & node);
+  EXECUTOR_TOPOLOGY_LOCAL void stop() noexcept;
+
+  std::vector<ExecutorConfig> m_configs;
+  std::vector<Worker> m_workers;
+};
+
+/// \brief Declare the parameters of the executors on a node, e.g. the component manager:
+///        `executors.names` and, for each name, `executors.<name>.nodes`, `.threads`,
+///        `.cpu_affinity` and `.priority`, see ExecutorConfig
+/// \param[in] node The node
+/// \return The executors, validated
+/// \throws std::domain_error If a parameter is out of range or the executors are invalid
+EXECUTOR_TOPOLOGY_PUBLIC std::vector<ExecutorConfig> declare_executor_configs(
+  rclcpp::Node & node);
+}  // namespace executor_topology
+}  // namespace common
+}  // namespace autoware
+
+#endif  // EXECUTOR_TOPOLOGY__DISPATCHING_EXECUTOR_HPP_
@@ -0,0 +1,70 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief The assignment of nodes to executors and of executors to threads
+
+#ifndef EXECUTOR_TOPOLOGY__EXECUTOR_CONFIG_HPP_
+#define EXECUTOR_TOPOLOGY__EXECUTOR_CONFIG_HPP_
+
+#include <executor_topology/visibility_control.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace autoware
+{
+namespace common
+{
+namespace executor_topology
+{
+/// \brief Index of find_executor() if no executor spins a node
+constexpr std::size_t kNoExecutor = std::numeric_limits<std::size_t>::max();
+
+/// \brief An executor and the nodes that it spins
+struct EXECUTOR_TOPOLOGY_PUBLIC ExecutorConfig
+{
+  /// Name of the executor, for the logs
+  std::string name{};
+  /// Fully qualified names of the nodes, e.g. "/perception/euclidean_cluster_node"
+  std::vector<std::string> nodes{};
+  /// Number of threads, a multi-threaded executor is used for more than one
+  std::size_t num_threads{1U};
+  /// CPUs that the threads may run on, empty for any
+  std::vector<std::size_t> cpu_affinity{};
+  /// SCHED_FIFO priority of the threads, 0 to keep the scheduling policy of the process
+  int32_t priority{0};
+};
+
+/// \brief Check a set of executors
+/// \param[in] configs The executors
+/// \throws std::domain_error If an executor has no threads, invalid CPUs or an invalid priority,
+///                           or if a node is assigned to more than one executor
+EXECUTOR_TOPOLOGY_PUBLIC void validate(const std::vector<ExecutorConfig> & configs);
+
+/// \brief Find the executor of a node
+/// \param[in] configs The executors
+/// \param[in] fully_qualified_name The fully qualified name of the node
+/// \return The index of the executor in configs, kNoExecutor if none spins the node
+EXECUTOR_TOPOLOGY_PUBLIC std::size_t find_executor(
+  const std::vector<ExecutorConfig> & configs,
+  const std::string & fully_qualified_name) noexcept;
+}  // namespace executor_topology
+}  // namespace common
+}  // namespace autoware
+
+#endif  // EXECUTOR_TOPOLOGY__EXECUTOR_CONFIG_HPP_
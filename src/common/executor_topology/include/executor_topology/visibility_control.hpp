@@ -0,0 +1,38 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef EXECUTOR_TOPOLOGY__VISIBILITY_CONTROL_HPP_
+#define EXECUTOR_TOPOLOGY__VISIBILITY_CONTROL_HPP_
+
+////////////////////////////////////////////////////////////////////////////////
+#if defined(__WIN32)
+  #if defined(EXECUTOR_TOPOLOGY_BUILDING_DLL) || defined(EXECUTOR_TOPOLOGY_EXPORTS)
+    #define EXECUTOR_TOPOLOGY_PUBLIC __declspec(dllexport)
+    #define EXECUTOR_TOPOLOGY_LOCAL
+  #else  // defined(EXECUTOR_TOPOLOGY_BUILDING_DLL) || defined(EXECUTOR_TOPOLOGY_EXPORTS)
+    #define EXECUTOR_TOPOLOGY_PUBLIC __declspec(dllimport)
+    #define EXECUTOR_TOPOLOGY_LOCAL
+  #endif  // defined(EXECUTOR_TOPOLOGY_BUILDING_DLL) || defined(EXECUTOR_TOPOLOGY_EXPORTS)
+#elif defined(__linux__)
+  #define EXECUTOR_TOPOLOGY_PUBLIC __attribute__((visibility("default")))
+  #define EXECUTOR_TOPOLOGY_LOCAL __attribute__((visibility("hidden")))
+#elif defined(__APPLE__)
+  #define EXECUTOR_TOPOLOGY_PUBLIC __attribute__((visibility("default")))
+  #define EXECUTOR_TOPOLOGY_LOCAL __attribute__((visibility("hidden")))
+#else  // defined(__linux__)
+  #error "Unsupported Build Configuration"
+#endif  // defined(__WIN32)
+
+#endif  // EXECUTOR_TOPOLOGY__VISIBILITY_CONTROL_HPP_
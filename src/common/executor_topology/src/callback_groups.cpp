@@ -0,0 +1,48 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "executor_topology/callback_groups.hpp"
+
+#include <stdexcept>
+
+namespace autoware
+{
+namespace common
+{
+namespace executor_topology
+{
+
+rclcpp::CallbackGroup::SharedPtr declare_callback_group(
+  rclcpp::Node & node, const std::string & name, const bool8_t reentrant_allowed)
+{
+  const auto parameter = "callback_groups." + name;
+  const auto type = node.declare_parameter(parameter, std::string{"default"});
+  if (type == "default") {
+    return nullptr;
+  }
+  if (type == "mutually_exclusive") {
+    return node.create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive);
+  }
+  if (type == "reentrant") {
+    if (!reentrant_allowed) {
+      throw std::domain_error{parameter + ": the callbacks aren't reentrant"};
+    }
+    return node.create_callback_group(rclcpp::CallbackGroupType::Reentrant);
+  }
+  throw std::domain_error{parameter + ": unknown callback group type " + type};
+}
+
+}  // namespace executor_topology
+}  // namespace common
+}  // namespace autoware
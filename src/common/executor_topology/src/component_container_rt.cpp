@@ -0,0 +1,37 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief A component container whose components are spun by the executors of its parameters
+
+#include <executor_topology/dispatching_executor.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <rclcpp_components/component_manager.hpp>
+
+#include <memory>
+
+using autoware::common::executor_topology::DispatchingExecutor;
+using autoware::common::executor_topology::declare_executor_configs;
+
+int main(int argc, char * argv[])
+{
+  rclcpp::init(argc, argv);
+  auto exec = std::make_shared<DispatchingExecutor>();
+  auto node = std::make_shared<rclcpp_components::ComponentManager>(exec);
+  exec->start(declare_executor_configs(*node));
+  exec->add_node(node);
+  exec->spin();
+  rclcpp::shutdown();
+  return 0;
+}
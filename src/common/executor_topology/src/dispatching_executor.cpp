@@ -0,0 +1,180 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "executor_topology/dispatching_executor.hpp"
+
+#include <rclcpp/executors/multi_threaded_executor.hpp>
+#include <thread_pool/thread_config.hpp>
+
+#include <chrono>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace autoware
+{
+namespace common
+{
+namespace executor_topology
+{
+
+namespace
+{
+/// How often a worker is cancelled again if it hasn't started spinning when it is stopped
+constexpr std::chrono::milliseconds kCancelRetryPeriod{10};
+}  // namespace
+
+DispatchingExecutor::DispatchingExecutor(const rclcpp::ExecutorOptions & options)
+: rclcpp::executors::SingleThreadedExecutor{options}
+{
+}
+
+DispatchingExecutor::~DispatchingExecutor()
+{
+  stop();
+}
+
+void DispatchingExecutor::start(const std::vector<ExecutorConfig> & configs)
+{
+  if (!m_workers.empty()) {
+    throw std::logic_error{"DispatchingExecutor: already started"};
+  }
+  validate(configs);
+  m_workers.reserve(configs.size());
+  try {
+    for (const auto & config : configs) {
+      // Each executor has its own memory strategy, only the context is shared
+      rclcpp::ExecutorOptions options;
+      options.context = context_;
+      Worker worker;
+      worker.config = config;
+      if (config.num_threads > 1U) {
+        worker.executor =
+          std::make_shared<rclcpp::executors::MultiThreadedExecutor>(options, config.num_threads);
+      } else {
+        worker.executor = std::make_shared<rclcpp::executors::SingleThreadedExecutor>(options);
+      }
+      // The thread waits until it is configured, the threads of a multi-threaded executor then
+      // inherit its affinity and priority
+      std::promise<bool> configured;
+      std::promise<void> finished;
+      worker.finished = finished.get_future();
+      worker.thread = std::thread{
+        [executor = worker.executor, go = configured.get_future(),
+        done = std::move(finished)]() mutable {
+          if (go.get()) {
+            executor->spin();
+          }
+          done.set_value();
+        }};
+      m_workers.push_back(std::move(worker));
+      try {
+        thread_pool::configure_thread(
+          m_workers.back().thread, config.cpu_affinity, config.priority);
+      } catch (...) {
+        configured.set_value(false);
+        throw;
+      }
+      configured.set_value(true);
+    }
+  } catch (...) {
+    stop();
+    m_workers.clear();
+    throw;
+  }
+  m_configs = configs;
+}
+
+void DispatchingExecutor::add_node(
+  rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_ptr,
+  bool notify)
+{
+  auto & executor = executor_of(*node_ptr);
+  if (&executor == this) {
+    rclcpp::executors::SingleThreadedExecutor::add_node(node_ptr, notify);
+  } else {
+    executor.add_node(node_ptr, notify);
+  }
+}
+
+void DispatchingExecutor::remove_node(
+  rclcpp::node_interfaces::NodeBaseInterface::SharedPtr node_ptr,
+  bool notify)
+{
+  auto & executor = executor_of(*node_ptr);
+  if (&executor == this) {
+    rclcpp::executors::SingleThreadedExecutor::remove_node(node_ptr, notify);
+  } else {
+    executor.remove_node(node_ptr, notify);
+  }
+}
+
+rclcpp::Executor & DispatchingExecutor::executor_of(
+  const rclcpp::node_interfaces::NodeBaseInterface & node)
+{
+  const auto index = find_executor(m_configs, node.get_fully_qualified_name());
+  if (kNoExecutor == index) {
+    return *this;
+  }
+  return *m_workers[index].executor;
+}
+
+void DispatchingExecutor::stop() noexcept
+{
+  for (auto & worker : m_workers) {
+    if (worker.thread.joinable()) {
+      // Cancelling before the thread spins has no effect, repeat until it returns
+      do {
+        worker.executor->cancel();
+      } while (std::future_status::ready != worker.finished.wait_for(kCancelRetryPeriod));
+      worker.thread.join();
+    }
+  }
+}
+
+std::vector<ExecutorConfig> declare_executor_configs(rclcpp::Node & node)
+{
+  std::vector<ExecutorConfig> configs;
+  const auto names = node.declare_parameter("executors.names", std::vector<std::string>{});
+  for (const auto & name : names) {
+    const auto prefix = "executors." + name + ".";
+    ExecutorConfig config;
+    config.name = name;
+    config.nodes = node.declare_parameter(prefix + "nodes", std::vector<std::string>{});
+    const auto num_threads = node.declare_parameter(prefix + "threads", int64_t{1});
+    if (num_threads < 1) {
+      throw std::domain_error{prefix + "threads must be positive"};
+    }
+    config.num_threads = static_cast<std::size_t>(num_threads);
+    for (const auto cpu : node.declare_parameter(prefix + "cpu_affinity", std::vector<int64_t>{})) {
+      if (cpu < 0) {
+        throw std::domain_error{prefix + "cpu_affinity must not be negative"};
+      }
+      config.cpu_affinity.push_back(static_cast<std::size_t>(cpu));
+    }
+    const auto priority = node.declare_parameter(prefix + "priority", int64_t{0});
+    if ((priority < 0) || (priority > std::numeric_limits<int32_t>::max())) {
+      throw std::domain_error{prefix + "priority is out of range"};
+    }
+    config.priority = static_cast<int32_t>(priority);
+    configs.push_back(std::move(config));
+  }
+  validate(configs);
+  return configs;
+}
+
+}  // namespace executor_topology
+}  // namespace common
+}  // namespace autoware
@@ -0,0 +1,67 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "executor_topology/executor_config.hpp"
+
+#include <thread_pool/thread_config.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace autoware
+{
+namespace common
+{
+namespace executor_topology
+{
+
+void validate(const std::vector<ExecutorConfig> & configs)
+{
+  std::unordered_set<std::string> nodes;
+  for (const auto & config : configs) {
+    if (0U == config.num_threads) {
+      throw std::domain_error{"Executor " + config.name + ": needs at least one thread"};
+    }
+    try {
+      thread_pool::validate_thread_config(config.cpu_affinity, config.priority);
+    } catch (const std::domain_error & error) {
+      throw std::domain_error{"Executor " + config.name + ": " + error.what()};
+    }
+    for (const auto & node : config.nodes) {
+      if (!nodes.insert(node).second) {
+        throw std::domain_error{
+                "Executor " + config.name + ": node " + node +
+                " is assigned to more than one executor"};
+      }
+    }
+  }
+}
+
+std::size_t find_executor(
+  const std::vector<ExecutorConfig> & configs,
+  const std::string & fully_qualified_name) noexcept
+{
+  for (std::size_t i = 0U; i < configs.size(); ++i) {
+    const auto & nodes = configs[i].nodes;
+    if (std::find(nodes.begin(), nodes.end(), fully_qualified_name) != nodes.end()) {
+      return i;
+    }
+  }
+  return kNoExecutor;
+}
+
+}  // namespace executor_topology
+}  // namespace common
+}  // namespace autoware
@@ -0,0 +1,65 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <executor_topology/executor_config.hpp>
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using autoware::common::executor_topology::ExecutorConfig;
+using autoware::common::executor_topology::find_executor;
+using autoware::common::executor_topology::kNoExecutor;
+using autoware::common::executor_topology::validate;
+
+namespace
+{
+ExecutorConfig make_config(const std::string & name, const std::vector<std::string> & nodes)
+{
+  ExecutorConfig config;
+  config.name = name;
+  config.nodes = nodes;
+  return config;
+}
+}  // namespace
+
+TEST(TestExecutorConfig, FindsExecutorOfNode)
+{
+  const std::vector<ExecutorConfig> configs{
+    make_config("lidar", {"/lidars/point_cloud_fusion_node", "/perception/ray_ground_classifier"}),
+    make_config("objects", {"/perception/euclidean_cluster_node"})};
+  EXPECT_NO_THROW(validate(configs));
+  EXPECT_EQ(find_executor(configs, "/perception/ray_ground_classifier"), 0U);
+  EXPECT_EQ(find_executor(configs, "/perception/euclidean_cluster_node"), 1U);
+  EXPECT_EQ(find_executor(configs, "/euclidean_cluster_node"), kNoExecutor);
+  EXPECT_EQ(find_executor({}, "/perception/euclidean_cluster_node"), kNoExecutor);
+}
+
+TEST(TestExecutorConfig, RejectsInvalidConfig)
+{
+  auto config = make_config("lidar", {"/node"});
+  config.num_threads = 0U;
+  EXPECT_THROW(validate({config}), std::domain_error);
+  config.num_threads = 2U;
+  config.cpu_affinity = {100000U};
+  EXPECT_THROW(validate({config}), std::domain_error);
+  config.cpu_affinity = {0U};
+  config.priority = -1;
+  EXPECT_THROW(validate({config}), std::domain_error);
+  config.priority = 0;
+  EXPECT_NO_THROW(validate({config}));
+  // A node can only be spun by one executor
+  EXPECT_THROW(validate({config, make_config("objects", {"/other", "/node"})}), std::domain_error);
+}
@@ -16,8 +16,11 @@
 #define HAD_MAP_UTILS__HAD_MAP_CONVERSION_HPP_
 
 #include <autoware_auto_msgs/msg/had_map_bin.hpp>
+#include <lanelet2_core/LaneletMap.h>
+#include <lanelet2_io/Projection.h>
 #include <cmath>
 #include <memory>
+#include <string>
 #include "had_map_utils/visibility_control.hpp"
 
 namespace autoware
@@ -27,14 +30,49 @@ namespace common
 namespace had_map_utils
 {
 
+/// \brief Serialize a map, in the flat encoding of had_map_flat_encoding.hpp. Maps that it can't
+/// encode, because a lanelet, area or regulatory element is used without being in its layer, are
+/// serialized through the Boost serialization of lanelet2
+/// \param[in] map the map
+/// \param[out] msg the data of the message is replaced by the serialized map
 void HAD_MAP_UTILS_PUBLIC toBinaryMsg(
   const std::shared_ptr<lanelet::LaneletMap> & map,
   autoware_auto_msgs::msg::HADMapBin & msg);
 
+/// \brief Deserialize a map of either serialization of toBinaryMsg()
+/// \param[in] msg the serialized map
+/// \param[in,out] map the map to deserialize into, a flat encoded map replaces it by a new map
+/// \throws std::runtime_error or std::out_of_range if a flat encoded map is corrupt
 void HAD_MAP_UTILS_PUBLIC fromBinaryMsg(
   const autoware_auto_msgs::msg::HADMapBin & msg,
   std::shared_ptr<lanelet::LaneletMap> & map);
 
+/// \brief Deserialize a map, sharing it with the other callers in this process. Nodes composed
+/// in one process that receive the same map get the same instance instead of one copy each.
+/// The map is deserialized again once all the users of the previous instance released it.
+/// \param[in] msg the serialized map
+/// \return the map, which is shared and must not be modified
+std::shared_ptr<lanelet::LaneletMap> HAD_MAP_UTILS_PUBLIC fromBinaryMsgShared(
+  const autoware_auto_msgs::msg::HADMapBin & msg);
+
+/// \brief A version of a serialized map for HADMapBin::map_version, which changes with the
+/// content of the map
+/// \param[in] msg the serialized map
+/// \return the version, a hexadecimal hash of the data of the message
+std::string HAD_MAP_UTILS_PUBLIC binaryMsgVersion(const autoware_auto_msgs::msg::HADMapBin & msg);
+
+/// \brief Load an OSM map through a binary cache of the parsed map. The cache is used if it was
+/// made by the same version of the cache format, from an OSM file with the same content and with
+/// the same projection origin. Otherwise the OSM file is parsed and the cache is written again.
+/// \param[in] osm_file the lanelet2 OSM map file
+/// \param[in] projector the projector of the map, its origin is part of the cache validation
+/// \param[in] cache_file the binary cache, not used if empty
+/// \return the map, nullptr if the OSM file could not be loaded
+std::shared_ptr<lanelet::LaneletMap> HAD_MAP_UTILS_PUBLIC loadMapWithCache(
+  const std::string & osm_file,
+  const lanelet::Projector & projector,
+  const std::string & cache_file);
+
 }  // namespace had_map_utils
 }  // namespace common
 }  // namespace autoware
@@ -0,0 +1,301 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief A flat binary encoding of lanelet2 maps, the payload of HADMapBin::data
+///
+/// The encoding is a header followed by tables of fixed size records: one table per primitive
+/// type, the attributes of all primitives, the references between primitives and a pool of the
+/// attribute strings. Primitives refer to each other by their index in the tables instead of by
+/// their id, so that decoding needs no lookups, and each table is one contiguous array, so that
+/// a buffer can be read in place, e.g. from shared memory, through FlatMapView.
+///
+/// The records are in the byte order of the host. A buffer of another byte order fails the magic
+/// check like any buffer that isn't a flat map.
+
+#ifndef HAD_MAP_UTILS__HAD_MAP_FLAT_ENCODING_HPP_
+#define HAD_MAP_UTILS__HAD_MAP_FLAT_ENCODING_HPP_
+
+#include <lanelet2_core/LaneletMap.h>
+#include <common/types.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "had_map_utils/visibility_control.hpp"
+
+namespace autoware
+{
+namespace common
+{
+namespace had_map_utils
+{
+namespace flat
+{
+using autoware::common::types::bool8_t;
+using autoware::common::types::float64_t;
+
+/// "HADF" in the first bytes of a little endian buffer
+constexpr uint32_t MAGIC = 0x46444148U;
+/// Version of the layout, to change with any record
+constexpr uint32_t VERSION = 1U;
+/// Set in a reference to a line string or polygon that is used inverted
+constexpr uint32_t INVERTED = 0x80000000U;
+/// A missing reference, e.g. the centerline of a lanelet without a custom centerline
+constexpr uint32_t NO_INDEX = 0xFFFFFFFFU;
+/// Set in the flags of a primitive that is in its layer of the map. The others are only used by
+/// other primitives, e.g. the points of a custom centerline
+constexpr uint32_t IN_LAYER = 1U;
+
+/// \brief A range of records of another table
+struct Range
+{
+  uint32_t begin;
+  uint32_t count;
+};
+
+/// \brief A string of the pool, the characters are in Section::CHARS
+struct StringRecord
+{
+  uint32_t offset;
+  uint32_t size;
+};
+
+/// \brief An attribute, its key and value are indices of strings
+struct AttributeRecord
+{
+  uint32_t key;
+  uint32_t value;
+};
+
+struct PointRecord
+{
+  int64_t id;
+  float64_t x;
+  float64_t y;
+  float64_t z;
+  /// In Section::ATTRIBUTES
+  Range attributes;
+  uint32_t flags;
+  uint32_t reserved;
+};
+
+/// \brief A line string or a polygon
+struct LineStringRecord
+{
+  int64_t id;
+  /// In Section::REFERENCES, indices of points
+  Range points;
+  Range attributes;
+  uint32_t flags;
+  uint32_t reserved;
+};
+
+struct LaneletRecord
+{
+  int64_t id;
+  /// Indices of line strings, with INVERTED
+  uint32_t left;
+  uint32_t right;
+  /// Index of a line string with INVERTED, or NO_INDEX
+  uint32_t centerline;
+  uint32_t flags;
+  /// In Section::REFERENCES, indices of regulatory elements
+  Range regulatory_elements;
+  Range attributes;
+};
+
+struct AreaRecord
+{
+  int64_t id;
+  /// In Section::REFERENCES, indices of line strings with INVERTED
+  Range outer;
+  /// In Section::BOUNDS, one range of line strings per inner bound
+  Range inner;
+  Range regulatory_elements;
+  Range attributes;
+  uint32_t flags;
+  uint32_t reserved;
+};
+
+struct RegulatoryElementRecord
+{
+  int64_t id;
+  /// In Section::PARAMETERS
+  Range parameters;
+  Range attributes;
+  uint32_t flags;
+  uint32_t reserved;
+};
+
+/// \brief The type of the primitive of a parameter of a regulatory element
+enum class ParameterType : uint32_t
+{
+  POINT,
+  LINE_STRING,
+  POLYGON,
+  LANELET,
+  AREA
+};
+
+struct ParameterRecord
+{
+  /// Index of a string
+  uint32_t role;
+  ParameterType type;
+  /// Index in the table of the type, with INVERTED for line strings and polygons
+  uint32_t index;
+  uint32_t reserved;
+};
+
+/// \brief The tables of an encoded map, in the order of the header
+enum class Section : uint32_t
+{
+  STRINGS,
+  CHARS,
+  ATTRIBUTES,
+  REFERENCES,
+  BOUNDS,
+  POINTS,
+  LINE_STRINGS,
+  POLYGONS,
+  LANELETS,
+  AREAS,
+  REGULATORY_ELEMENTS,
+  PARAMETERS,
+  COUNT
+};
+
+/// \brief Where a table is in the buffer
+struct SectionRecord
+{
+  /// In bytes from the start of the buffer, a multiple of 8
+  uint64_t offset;
+  /// In records
+  uint64_t count;
+};
+
+struct Header
+{
+  uint32_t magic;
+  uint32_t version;
+  /// The id counter of lanelet::utils::getId() when the map was encoded
+  int64_t id_counter;
+  SectionRecord sections[static_cast<std::size_t>(Section::COUNT)];
+};
+
+/// \brief A table of a buffer, the records are copied out of the buffer one at a time, so that
+///        the buffer needs no alignment
+template<typename RecordT>
+class Table
+{
+public:
+  Table(const uint8_t * const data, const std::size_t count)
+  : m_data{data}, m_count{count} {}
+
+  std::size_t size() const noexcept {return m_count;}
+
+  /// \throws std::out_of_range if the index is past the table
+  RecordT operator[](const std::size_t index) const
+  {
+    if (index >= m_count) {
+      throw std::out_of_range{"flat map: index past the table"};
+    }
+    RecordT record;
+    (void)std::memcpy(&record, m_data + (index * sizeof(RecordT)), sizeof(RecordT));
+    return record;
+  }
+
+private:
+  const uint8_t * m_data;
+  std::size_t m_count;
+};
+
+/// \brief Read access to an encoded map without decoding it. The view doesn't own the buffer
+class HAD_MAP_UTILS_PUBLIC FlatMapView
+{
+public:
+  /// \brief Check the header and that the tables are within the buffer
+  /// \param[in] data The buffer, it must outlive the view
+  /// \param[in] size The size of the buffer in bytes
+  /// \throws std::runtime_error if the buffer isn't a flat map of this version
+  FlatMapView(const uint8_t * data, std::size_t size);
+
+  /// \brief Whether a buffer starts like a flat map, of any version
+  static bool8_t isFlatMap(const uint8_t * data, std::size_t size) noexcept;
+
+  int64_t idCounter() const noexcept {return m_header.id_counter;}
+
+  Table<StringRecord> strings() const {return table<StringRecord>(Section::STRINGS);}
+  Table<AttributeRecord> attributes() const {return table<AttributeRecord>(Section::ATTRIBUTES);}
+  Table<uint32_t> references() const {return table<uint32_t>(Section::REFERENCES);}
+  Table<Range> bounds() const {return table<Range>(Section::BOUNDS);}
+  Table<PointRecord> points() const {return table<PointRecord>(Section::POINTS);}
+  Table<LineStringRecord> lineStrings() const
+  {
+    return table<LineStringRecord>(Section::LINE_STRINGS);
+  }
+  Table<LineStringRecord> polygons() const {return table<LineStringRecord>(Section::POLYGONS);}
+  Table<LaneletRecord> lanelets() const {return table<LaneletRecord>(Section::LANELETS);}
+  Table<AreaRecord> areas() const {return table<AreaRecord>(Section::AREAS);}
+  Table<RegulatoryElementRecord> regulatoryElements() const
+  {
+    return table<RegulatoryElementRecord>(Section::REGULATORY_ELEMENTS);
+  }
+  Table<ParameterRecord> parameters() const {return table<ParameterRecord>(Section::PARAMETERS);}
+
+  /// \brief The characters of a string of the pool, not null terminated
+  /// \throws std::out_of_range if the index or the string is out of the pool
+  const char * stringData(uint32_t index, std::size_t & size) const;
+  /// \brief A string of the pool
+  /// \throws std::out_of_range if the index or the string is out of the pool
+  std::string string(uint32_t index) const;
+
+private:
+  template<typename RecordT>
+  Table<RecordT> table(const Section section) const
+  {
+    const auto & record = m_header.sections[static_cast<std::size_t>(section)];
+    return Table<RecordT>{m_data + record.offset, static_cast<std::size_t>(record.count)};
+  }
+
+  const uint8_t * m_data;
+  Header m_header;
+};
+
+/// \brief Encode a map
+/// \param[in] map The map
+/// \param[out] data The encoded map, replaces the content
+/// \return false if the map can't be encoded, because a lanelet, area or regulatory element that
+///         is used by another primitive isn't in its layer. The content of data is unspecified
+bool8_t HAD_MAP_UTILS_PUBLIC encodeFlatMap(
+  const lanelet::LaneletMap & map, std::vector<uint8_t> & data);
+
+/// \brief Decode a map. The id counter of lanelet2 is advanced past the one of the encoded map,
+///        like with the Boost serialization
+/// \param[in] view The encoded map
+/// \return The map
+/// \throws std::runtime_error or std::out_of_range if the encoded map is corrupt
+std::unique_ptr<lanelet::LaneletMap> HAD_MAP_UTILS_PUBLIC decodeFlatMap(
+  const FlatMapView & view);
+}  // namespace flat
+}  // namespace had_map_utils
+}  // namespace common
+}  // namespace autoware
+
+#endif  // HAD_MAP_UTILS__HAD_MAP_FLAT_ENCODING_HPP_
@@ -22,8 +22,17 @@
 #include <lanelet2_core/primitives/Polygon.h>
 #include <lanelet2_core/utility/Units.h>
 
+#include <boost/geometry.hpp>
+#include <boost/geometry/index/rtree.hpp>
+#include <common/types.hpp>
+
 #include <cmath>
+#include <cstddef>
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 #include "had_map_utils/visibility_control.hpp"
 
 namespace autoware
@@ -54,6 +63,76 @@ lanelet::ConstLanelets HAD_MAP_UTILS_PUBLIC getConstLaneletLayer(
 lanelet::Lanelets HAD_MAP_UTILS_PUBLIC getLaneletLayer(
   const std::shared_ptr<lanelet::LaneletMap> & ll_map);
 
+/// \brief The areas, polygons and line strings of a map grouped by their subtype, with an R-tree
+///        per subtype. Built once per map, so that the subtype queries are lookups instead of
+///        string comparisons over a whole layer
+/// \note The index does not follow changes of the map after it was built
+class HAD_MAP_UTILS_PUBLIC SubtypeIndex
+{
+public:
+  /// \brief Build the index
+  /// \param[in] ll_map The map
+  /// \throws std::invalid_argument if the map is null
+  explicit SubtypeIndex(const lanelet::LaneletMapPtr & ll_map);
+
+  /// \brief Same as subtypeAreas() on the whole area layer
+  /// \return The areas of the subtype, in the order of the layer
+  const lanelet::Areas & areas(const std::string & subtype) const;
+  /// \brief Same as subtypeAreas() on the result of a search of the area layer
+  /// \return The areas of the subtype whose bounding box intersects bbox, in the order of the
+  ///         layer
+  lanelet::Areas areas(const std::string & subtype, const lanelet::BoundingBox2d & bbox) const;
+
+  /// \brief Same as subtypePolygons() on the whole polygon layer
+  /// \return The polygons of the subtype, in the order of the layer
+  const lanelet::Polygons3d & polygons(const std::string & subtype) const;
+  /// \brief Same as subtypePolygons() on the result of a search of the polygon layer
+  /// \return The polygons of the subtype whose bounding box intersects bbox, in the order of the
+  ///         layer
+  lanelet::Polygons3d polygons(
+    const std::string & subtype, const lanelet::BoundingBox2d & bbox) const;
+
+  /// \brief Same as subtypeLineStrings() on the whole line string layer
+  /// \return The line strings of the subtype, in the order of the layer
+  const lanelet::LineStrings3d & lineStrings(const std::string & subtype) const;
+  /// \brief Same as subtypeLineStrings() on the result of a search of the line string layer
+  /// \return The line strings of the subtype whose bounding box intersects bbox, in the order of
+  ///         the layer
+  lanelet::LineStrings3d lineStrings(
+    const std::string & subtype, const lanelet::BoundingBox2d & bbox) const;
+
+private:
+  using Point =
+    boost::geometry::model::point<common::types::float64_t, 2, boost::geometry::cs::cartesian>;
+  using Box = boost::geometry::model::box<Point>;
+  /// The bounding box of an element and its index in the elements of its subtype
+  using Value = std::pair<Box, std::size_t>;
+  using RTree = boost::geometry::index::rtree<Value, boost::geometry::index::rstar<16>>;
+
+  template<typename PrimitiveT>
+  struct Subtype
+  {
+    std::vector<PrimitiveT> elements;
+    RTree rtree;
+  };
+  template<typename PrimitiveT>
+  using Layer = std::unordered_map<std::string, Subtype<PrimitiveT>>;
+
+  template<typename PrimitiveT, typename LayerT>
+  static Layer<PrimitiveT> build(LayerT & layer);
+  template<typename PrimitiveT>
+  static const std::vector<PrimitiveT> & find(
+    const Layer<PrimitiveT> & layer, const std::string & subtype);
+  template<typename PrimitiveT>
+  static std::vector<PrimitiveT> search(
+    const Layer<PrimitiveT> & layer, const std::string & subtype,
+    const lanelet::BoundingBox2d & bbox);
+
+  Layer<lanelet::Area> m_areas;
+  Layer<lanelet::Polygon3d> m_polygons;
+  Layer<lanelet::LineString3d> m_line_strings;
+};
+
 }  // namespace had_map_utils
 }  // namespace common
 }  // namespace autoware
@@ -38,6 +38,14 @@ void HAD_MAP_UTILS_PUBLIC overwriteLaneletsCenterline(
 lanelet::LineString3d HAD_MAP_UTILS_PUBLIC generateFineCenterline(
   const lanelet::ConstLanelet & lanelet_obj, const float64_t resolution);
 
+/// \brief Same centerline as generateFineCenterline, generated once per lanelet and resolution
+///        and then shared by all callers in the process. A lanelet ID whose bounds changed, e.g.
+///        in a newly received map, gets a new centerline. Can be called from several threads.
+lanelet::ConstLineString3d HAD_MAP_UTILS_PUBLIC getFineCenterline(
+  const lanelet::ConstLanelet & lanelet_obj, const float64_t resolution);
+/// \brief Drop the centerlines shared by getFineCenterline
+void HAD_MAP_UTILS_PUBLIC clearFineCenterlineCache();
+
 }  // namespace had_map_utils
 }  // namespace common
 }  // namespace autoware
@@ -26,10 +26,14 @@
 #include <lanelet2_core/LaneletMap.h>
 
 #include <chrono>
+#include <cstdint>
+#include <map>
+#include <set>
 #include <unordered_set>
 #include <memory>
 #include <string>
 #include <cmath>
+#include <utility>
 #include <vector>
 
 #include "had_map_utils/visibility_control.hpp"
@@ -268,6 +272,119 @@ visualization_msgs::msg::MarkerArray HAD_MAP_UTILS_PUBLIC areasAsTriangleMarkerA
   const rclcpp::Time & t, const std::string & ns, const lanelet::Areas & areas,
   const std_msgs::msg::ColorRGBA & c);
 
+/// Indices of a square tile of the map, in the grid of MapMarkerTiles
+using MapTileKey = std::pair<int64_t, int64_t>;
+
+/**
+ * \brief Markers of a map, grouped into square tiles so that only the tiles around a position
+ *        need to be sent instead of one marker array of the whole map.
+ *
+ * The add functions mirror the marker array functions above. Each primitive goes to the tile of
+ * the center of its bounding box, and its markers are generated only once, when it's added: the
+ * triangulation of lanelets and areas, which dominates for large maps, runs in parallel. Lines
+ * shared by lanelets of several tiles belong to the first tile they are added to. Each add
+ * function shall be called with a distinct namespace.
+ */
+class HAD_MAP_UTILS_PUBLIC MapMarkerTiles
+{
+public:
+  /**
+   * \brief Constructor
+   * \param tile_size edge length of the tiles in meters, not positive for a single tile
+   * \param t time set to the markers
+   */
+  explicit MapMarkerTiles(const float64_t tile_size, const rclcpp::Time & t = rclcpp::Time(0));
+
+  /**
+   * \brief add the line strip markers of laneletsBoundaryAsMarkerArray
+   * \param lanelets input lanelet objects
+   * \param c color of the markers
+   * \param viz_centerline whether to add the centerlines
+   */
+  void addLaneletsBoundary(
+    const lanelet::ConstLanelets & lanelets, const std_msgs::msg::ColorRGBA & c,
+    const bool8_t viz_centerline);
+
+  /**
+   * \brief add the triangle markers of laneletsAsTriangleMarkerArray, one per tile
+   * \param ns namespace of the markers
+   * \param lanelets input lanelet objects
+   * \param c color of the markers
+   */
+  void addLaneletsTriangles(
+    const std::string & ns, const lanelet::ConstLanelets & lanelets,
+    const std_msgs::msg::ColorRGBA & c);
+
+  /**
+   * \brief add the line strip markers of areasBoundaryAsMarkerArray, with the area IDs as IDs
+   * \param ns namespace of the markers
+   * \param areas input area objects
+   * \param c color of the markers
+   */
+  void addAreasBoundary(
+    const std::string & ns, const lanelet::Areas & areas, const std_msgs::msg::ColorRGBA & c);
+
+  /**
+   * \brief add the triangle markers of areasAsTriangleMarkerArray, one per tile
+   * \param ns namespace of the markers
+   * \param areas input area objects
+   * \param c color of the markers
+   */
+  void addAreasTriangles(
+    const std::string & ns, const lanelet::Areas & areas, const std_msgs::msg::ColorRGBA & c);
+
+  /**
+   * \brief get the tiles that have markers and are within a distance of a position
+   * \param x x coordinate of the position in the map frame
+   * \param y y coordinate of the position in the map frame
+   * \param radius distance from the position in meters, not positive for all tiles
+   * \return keys of the tiles
+   */
+  std::set<MapTileKey> tilesNear(
+    const float64_t x, const float64_t y, const float64_t radius) const;
+
+  /**
+   * \brief get the markers that change the visible tiles
+   * \param visible tiles to show
+   * \param previous tiles shown so far
+   * \return all markers of the visible tiles, so that subscribers joining late get them too,
+   *         followed by DELETE markers for the previous tiles that aren't visible anymore
+   */
+  visualization_msgs::msg::MarkerArray markersFor(
+    const std::set<MapTileKey> & visible, const std::set<MapTileKey> & previous) const;
+
+  /**
+   * \brief get the markers of a tile
+   * \param key key of the tile
+   * \return markers of the tile, empty if there are none
+   */
+  const visualization_msgs::msg::MarkerArray & tileMarkers(const MapTileKey & key) const;
+
+  /**
+   * \brief get the tile of a position
+   * \param x x coordinate of the position in the map frame
+   * \param y y coordinate of the position in the map frame
+   * \return key of the tile
+   */
+  MapTileKey tileOf(const float64_t x, const float64_t y) const;
+
+private:
+  // Tile of the center of a bounding box
+  MapTileKey tileOf(const lanelet::BoundingBox2d & box) const;
+
+  void addTriangles(
+    const std::string & ns, const std::vector<MapTileKey> & keys,
+    const std::vector<std::vector<geometry_msgs::msg::Polygon>> & triangles,
+    const std_msgs::msg::ColorRGBA & c);
+
+  float64_t m_tile_size;
+  rclcpp::Time m_time;
+  std::map<MapTileKey, visualization_msgs::msg::MarkerArray> m_tiles;
+  // Marker IDs of the per tile triangle markers
+  std::map<MapTileKey, int32_t> m_tile_ids;
+  std::unordered_set<lanelet::Id> m_added_lines;
+};
+
 }  // namespace had_map_utils
 }  // namespace common
 }  // namespace autoware
@@ -16,18 +16,29 @@
 
 //lint -e537 pclint vs cpplint NOLINT
 
+#include <lanelet2_io/Io.h>
 #include <lanelet2_io/io_handlers/Serialize.h>
 
 #include <boost/archive/binary_iarchive.hpp>
 #include <boost/archive/binary_oarchive.hpp>
 
 #include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
 #include <limits>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "had_map_utils/had_map_conversion.hpp"
+#include "had_map_utils/had_map_flat_encoding.hpp"
 
 
 namespace autoware
@@ -41,6 +52,10 @@ void toBinaryMsg(
   const std::shared_ptr<lanelet::LaneletMap> & map,
   autoware_auto_msgs::msg::HADMapBin & msg)
 {
+  if (flat::encodeFlatMap(*map, msg.data)) {
+    return;
+  }
+  // The map refers to primitives outside of its layers, which only the Boost serialization keeps
   std::stringstream ss;
   boost::archive::binary_oarchive oa(ss);
   oa << *map;
@@ -57,6 +72,11 @@ void fromBinaryMsg(
   const autoware_auto_msgs::msg::HADMapBin & msg,
   std::shared_ptr<lanelet::LaneletMap> & map)
 {
+  if (flat::FlatMapView::isFlatMap(msg.data.data(), msg.data.size())) {
+    const flat::FlatMapView view{msg.data.data(), msg.data.size()};
+    map = flat::decodeFlatMap(view);
+    return;
+  }
   std::string data_str;
   data_str.assign(msg.data.begin(), msg.data.end());
   std::stringstream ss;
@@ -68,6 +88,201 @@ void fromBinaryMsg(
   lanelet::utils::registerId(id_counter);
 }
 
+namespace
+{
+/// Version of the layout of the map cache, to change with the layout or the lanelet2 serialization
+constexpr uint32_t MAP_CACHE_VERSION = 1U;
+
+constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+
+/// \brief Continue a FNV-1a hash with a range of bytes
+template<typename ByteT>
+uint64_t hashBytes(const ByteT * const data, const std::size_t size, uint64_t hash)
+{
+  for (std::size_t idx = 0U; idx < size; ++idx) {
+    hash = (hash ^ static_cast<uint8_t>(data[idx])) * 1099511628211ULL;
+  }
+  return hash;
+}
+
+/// \brief FNV-1a hash of the content of a file
+/// \return false if the file can't be read
+bool hashFile(const std::string & file, uint64_t & hash)
+{
+  std::ifstream stream(file, std::ios::binary);
+  if (!stream) {
+    return false;
+  }
+  hash = FNV_OFFSET_BASIS;
+  std::vector<char> buffer(1U << 16U);
+  while (stream) {
+    (void)stream.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    hash = hashBytes(buffer.data(), static_cast<std::size_t>(stream.gcount()), hash);
+  }
+  return true;
+}
+
+/// \brief Header identifying what a map cache was made from
+struct MapCacheHeader
+{
+  uint32_t version{0U};
+  uint64_t source_hash{0U};
+  double lat{0.0};
+  double lon{0.0};
+  double ele{0.0};
+
+  bool operator==(const MapCacheHeader & other) const
+  {
+    return (version == other.version) && (source_hash == other.source_hash) &&
+           (lat == other.lat) && (lon == other.lon) && (ele == other.ele);
+  }
+
+  template<typename Archive>
+  void serialize(Archive & ar, const unsigned int)
+  {
+    ar & version & source_hash & lat & lon & ele;
+  }
+};
+
+/// \brief Read a map from a cache made with an identical header
+/// \return nullptr if the cache is missing, stale or corrupt
+std::shared_ptr<lanelet::LaneletMap> readMapCache(
+  const std::string & cache_file, const MapCacheHeader & expected_header)
+{
+  // The whole file is read at once, then deserialized from memory
+  std::ifstream stream(cache_file, std::ios::binary);
+  if (!stream) {
+    return nullptr;
+  }
+  std::stringstream ss;
+  ss << stream.rdbuf();
+  try {
+    boost::archive::binary_iarchive ia(ss);
+    MapCacheHeader header;
+    ia >> header;
+    if (!(header == expected_header)) {
+      return nullptr;
+    }
+    auto map = std::make_shared<lanelet::LaneletMap>();
+    ia >> *map;
+    lanelet::Id id_counter;
+    ia >> id_counter;
+    lanelet::utils::registerId(id_counter);
+    return map;
+  } catch (const std::exception &) {
+    return nullptr;
+  }
+}
+
+/// \brief Write a map cache. It is written to a temporary file first, so that other processes
+/// loading the cache concurrently never read a partial file.
+void writeMapCache(
+  const std::string & cache_file, const MapCacheHeader & header,
+  const lanelet::LaneletMap & map)
+{
+  const std::string tmp_file = cache_file + ".tmp";
+  {
+    std::ofstream stream(tmp_file, std::ios::binary | std::ios::trunc);
+    if (!stream) {
+      return;
+    }
+    boost::archive::binary_oarchive oa(stream);
+    oa << header;
+    oa << map;
+    auto id_counter = lanelet::utils::getId();
+    oa << id_counter;
+  }
+  (void)std::rename(tmp_file.c_str(), cache_file.c_str());
+}
+
+/// \brief Maps shared in this process, by size and hash of their serialization
+class SharedMapRegistry
+{
+public:
+  using Key = std::pair<std::size_t, uint64_t>;
+
+  static SharedMapRegistry & instance()
+  {
+    static SharedMapRegistry registry;
+    return registry;
+  }
+
+  /// \brief Get the map of a key, or make it with make_map if no alive map has this key
+  template<typename MakeMap>
+  std::shared_ptr<lanelet::LaneletMap> get_or_make(const Key & key, MakeMap make_map)
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    for (auto it = m_maps.begin(); it != m_maps.end(); ) {
+      it = it->second.expired() ? m_maps.erase(it) : std::next(it);
+    }
+    const auto it = m_maps.find(key);
+    if (it != m_maps.end()) {
+      auto map = it->second.lock();
+      if (map) {
+        return map;
+      }
+    }
+    // Deserializing under the lock also makes concurrent callers wait for one map
+    std::shared_ptr<lanelet::LaneletMap> map = make_map();
+    m_maps[key] = map;
+    return map;
+  }
+
+private:
+  SharedMapRegistry() = default;
+
+  std::mutex m_mutex;
+  std::map<Key, std::weak_ptr<lanelet::LaneletMap>> m_maps;
+};
+}  // namespace
+
+std::shared_ptr<lanelet::LaneletMap> loadMapWithCache(
+  const std::string & osm_file,
+  const lanelet::Projector & projector,
+  const std::string & cache_file)
+{
+  MapCacheHeader header;
+  header.version = MAP_CACHE_VERSION;
+  header.lat = projector.origin().position.lat;
+  header.lon = projector.origin().position.lon;
+  header.ele = projector.origin().position.ele;
+  const bool use_cache = !cache_file.empty() && hashFile(osm_file, header.source_hash);
+  if (use_cache) {
+    auto map = readMapCache(cache_file, header);
+    if (map) {
+      return map;
+    }
+  }
+
+  lanelet::ErrorMessages errors;
+  std::shared_ptr<lanelet::LaneletMap> map = lanelet::load(osm_file, projector, &errors);
+  if (map && use_cache) {
+    writeMapCache(cache_file, header, *map);
+  }
+  return map;
+}
+
+std::shared_ptr<lanelet::LaneletMap> fromBinaryMsgShared(
+  const autoware_auto_msgs::msg::HADMapBin & msg)
+{
+  const SharedMapRegistry::Key key{msg.data.size(),
+    hashBytes(msg.data.data(), msg.data.size(), FNV_OFFSET_BASIS)};
+  return SharedMapRegistry::instance().get_or_make(
+    key, [&msg]() {
+      auto map = std::make_shared<lanelet::LaneletMap>();
+      fromBinaryMsg(msg, map);
+      return map;
+    });
+}
+
+std::string binaryMsgVersion(const autoware_auto_msgs::msg::HADMapBin & msg)
+{
+  std::ostringstream version;
+  version << std::hex << std::setfill('0') << std::setw(16) <<
+    hashBytes(msg.data.data(), msg.data.size(), FNV_OFFSET_BASIS);
+  return version.str();
+}
+
 }  // namespace had_map_utils
 }  // namespace common
 }  // namespace autoware
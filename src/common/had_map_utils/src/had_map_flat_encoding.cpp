@@ -0,0 +1,702 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "had_map_utils/had_map_flat_encoding.hpp"
+
+#include <lanelet2_core/primitives/Area.h>
+#include <lanelet2_core/primitives/Lanelet.h>
+#include <lanelet2_core/primitives/RegulatoryElement.h>
+#include <lanelet2_core/utility/Utilities.h>
+
+#include <boost/variant.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace autoware
+{
+namespace common
+{
+namespace had_map_utils
+{
+namespace flat
+{
+namespace
+{
+static_assert(sizeof(Range) == 8U, "Range must have no padding");
+static_assert(sizeof(StringRecord) == 8U, "StringRecord must have no padding");
+static_assert(sizeof(AttributeRecord) == 8U, "AttributeRecord must have no padding");
+static_assert(sizeof(PointRecord) == 48U, "PointRecord must have no padding");
+static_assert(sizeof(LineStringRecord) == 32U, "LineStringRecord must have no padding");
+static_assert(sizeof(LaneletRecord) == 40U, "LaneletRecord must have no padding");
+static_assert(sizeof(AreaRecord) == 48U, "AreaRecord must have no padding");
+static_assert(sizeof(RegulatoryElementRecord) == 32U, "RegulatoryElementRecord has padding");
+static_assert(sizeof(ParameterRecord) == 16U, "ParameterRecord must have no padding");
+static_assert(sizeof(Header) == 208U, "Header must have no padding");
+
+constexpr std::size_t NUM_SECTIONS = static_cast<std::size_t>(Section::COUNT);
+constexpr std::size_t SECTION_ALIGNMENT = 8U;
+
+/// The size of the records of each section, in the order of Section
+constexpr std::size_t RECORD_SIZES[NUM_SECTIONS] = {
+  sizeof(StringRecord), sizeof(char), sizeof(AttributeRecord), sizeof(uint32_t), sizeof(Range),
+  sizeof(PointRecord), sizeof(LineStringRecord), sizeof(LineStringRecord), sizeof(LaneletRecord),
+  sizeof(AreaRecord), sizeof(RegulatoryElementRecord), sizeof(ParameterRecord)};
+
+std::size_t sectionIndex(const Section section)
+{
+  return static_cast<std::size_t>(section);
+}
+
+/// \brief Encodes a map into tables, which are then copied to the buffer one after the other
+class Encoder
+{
+public:
+  explicit Encoder(const lanelet::LaneletMap & map)
+  : m_map{map} {}
+
+  bool8_t encode(std::vector<uint8_t> & data)
+  {
+    for (const auto & point : m_map.pointLayer) {
+      (void)addPoint(point, IN_LAYER);
+    }
+    for (const auto & line_string : m_map.lineStringLayer) {
+      (void)addLineString(line_string, IN_LAYER, m_line_strings, m_line_string_indices);
+    }
+    for (const auto & polygon : m_map.polygonLayer) {
+      (void)addLineString(polygon, IN_LAYER, m_polygons, m_polygon_indices);
+    }
+    // Lanelets, areas and regulatory elements can refer to each other, so all of them get their
+    // index before any record is written
+    indexLayer(m_map.laneletLayer, m_lanelet_indices);
+    indexLayer(m_map.areaLayer, m_area_indices);
+    indexLayer(m_map.regulatoryElementLayer, m_regulatory_element_indices);
+    if (!m_valid) {
+      return false;
+    }
+    for (const auto & lanelet : m_map.laneletLayer) {
+      addLanelet(lanelet);
+    }
+    for (const auto & area : m_map.areaLayer) {
+      addArea(area);
+    }
+    for (const auto & regulatory_element : m_map.regulatoryElementLayer) {
+      addRegulatoryElement(*regulatory_element);
+    }
+    if (!m_valid) {
+      return false;
+    }
+
+    Header header{};
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.id_counter = lanelet::utils::getId();
+    data.clear();
+    data.resize(sizeof(Header), 0U);
+    appendSection(Section::STRINGS, m_strings, header, data);
+    appendSection(Section::CHARS, m_chars, header, data);
+    appendSection(Section::ATTRIBUTES, m_attributes, header, data);
+    appendSection(Section::REFERENCES, m_references, header, data);
+    appendSection(Section::BOUNDS, m_bounds, header, data);
+    appendSection(Section::POINTS, m_points, header, data);
+    appendSection(Section::LINE_STRINGS, m_line_strings, header, data);
+    appendSection(Section::POLYGONS, m_polygons, header, data);
+    appendSection(Section::LANELETS, m_lanelets, header, data);
+    appendSection(Section::AREAS, m_areas, header, data);
+    appendSection(Section::REGULATORY_ELEMENTS, m_regulatory_elements, header, data);
+    appendSection(Section::PARAMETERS, m_parameters, header, data);
+    (void)std::memcpy(data.data(), &header, sizeof(Header));
+    return true;
+  }
+
+private:
+  using IndexMap = std::unordered_map<lanelet::Id, uint32_t>;
+
+  /// \brief The index of the next record of a table, the references need the top bit
+  uint32_t nextIndex(const std::size_t size)
+  {
+    if (size >= static_cast<std::size_t>(INVERTED)) {
+      m_valid = false;
+    }
+    return static_cast<uint32_t>(size);
+  }
+
+  uint32_t addString(const std::string & string)
+  {
+    const auto it = m_string_indices.find(string);
+    if (it != m_string_indices.end()) {
+      return it->second;
+    }
+    const auto index = nextIndex(m_strings.size());
+    if (m_chars.size() > std::numeric_limits<uint32_t>::max() - string.size()) {
+      m_valid = false;
+    }
+    m_strings.push_back(
+      StringRecord{static_cast<uint32_t>(m_chars.size()), static_cast<uint32_t>(string.size())});
+    m_chars.insert(m_chars.end(), string.begin(), string.end());
+    (void)m_string_indices.emplace(string, index);
+    return index;
+  }
+
+  Range addAttributes(const lanelet::AttributeMap & attributes)
+  {
+    const Range range{nextIndex(m_attributes.size()), static_cast<uint32_t>(attributes.size())};
+    for (const auto & attribute : attributes) {
+      const auto key = addString(attribute.first);
+      m_attributes.push_back(AttributeRecord{key, addString(attribute.second.value())});
+    }
+    return range;
+  }
+
+  /// \brief The index of a point, which is added if it wasn't yet. Only the points of the layer
+  ///        are IN_LAYER
+  uint32_t addPoint(const lanelet::ConstPoint3d & point, const uint32_t flags)
+  {
+    const auto it = m_point_indices.find(point.id());
+    if (it != m_point_indices.end()) {
+      return it->second;
+    }
+    const auto index = nextIndex(m_points.size());
+    (void)m_point_indices.emplace(point.id(), index);
+    const auto attributes = addAttributes(point.attributes());
+    m_points.push_back(
+      PointRecord{point.id(), point.x(), point.y(), point.z(), attributes, flags, 0U});
+    return index;
+  }
+
+  /// \brief The reference to a line string or polygon, which is added if it wasn't yet. It is
+  ///        stored in its original direction, the reference says if it is inverted
+  template<typename LineStringT>
+  uint32_t addLineString(
+    const LineStringT & line_string, const uint32_t flags,
+    std::vector<LineStringRecord> & records, IndexMap & indices)
+  {
+    const uint32_t inverted = line_string.inverted() ? INVERTED : 0U;
+    const auto it = indices.find(line_string.id());
+    if (it != indices.end()) {
+      return it->second | inverted;
+    }
+    const auto index = nextIndex(records.size());
+    (void)indices.emplace(line_string.id(), index);
+    // The points may be added too, so they are collected before the range is taken
+    std::vector<uint32_t> points;
+    points.reserve(line_string.size());
+    for (const auto & point : line_string) {
+      points.push_back(addPoint(point, 0U));
+    }
+    if (line_string.inverted()) {
+      std::reverse(points.begin(), points.end());
+    }
+    const Range point_range{nextIndex(m_references.size()), static_cast<uint32_t>(points.size())};
+    m_references.insert(m_references.end(), points.begin(), points.end());
+    const auto attributes = addAttributes(line_string.attributes());
+    records.push_back(LineStringRecord{line_string.id(), point_range, attributes, flags, 0U});
+    return index | inverted;
+  }
+
+  uint32_t addLineString(const lanelet::ConstLineString3d & line_string)
+  {
+    return addLineString(line_string, 0U, m_line_strings, m_line_string_indices);
+  }
+
+  uint32_t addPolygon(const lanelet::ConstPolygon3d & polygon)
+  {
+    return addLineString(polygon, 0U, m_polygons, m_polygon_indices);
+  }
+
+  /// \brief The index of a lanelet, area or regulatory element, which must be in its layer
+  uint32_t find(const IndexMap & indices, const lanelet::Id id)
+  {
+    const auto it = indices.find(id);
+    if (it == indices.end()) {
+      m_valid = false;
+      return NO_INDEX;
+    }
+    return it->second;
+  }
+
+  template<typename LayerT>
+  void indexLayer(const LayerT & layer, IndexMap & indices)
+  {
+    indices.reserve(layer.size());
+    for (auto it = layer.begin(); it != layer.end(); ++it) {
+      (void)indices.emplace(it->id(), nextIndex(indices.size()));
+    }
+  }
+
+  /// \brief The regulatory elements are held by pointer
+  void indexLayer(const lanelet::RegulatoryElementLayer & layer, IndexMap & indices)
+  {
+    indices.reserve(layer.size());
+    for (const auto & regulatory_element : layer) {
+      (void)indices.emplace(regulatory_element->id(), nextIndex(indices.size()));
+    }
+  }
+
+  Range addRegulatoryElementReferences(const lanelet::RegulatoryElementConstPtrs & elements)
+  {
+    std::vector<uint32_t> references;
+    references.reserve(elements.size());
+    for (const auto & element : elements) {
+      references.push_back(find(m_regulatory_element_indices, element->id()));
+    }
+    return addReferences(references);
+  }
+
+  Range addReferences(const std::vector<uint32_t> & references)
+  {
+    const Range range{nextIndex(m_references.size()), static_cast<uint32_t>(references.size())};
+    m_references.insert(m_references.end(), references.begin(), references.end());
+    return range;
+  }
+
+  Range addLineStringReferences(const lanelet::ConstLineStrings3d & line_strings)
+  {
+    std::vector<uint32_t> references;
+    references.reserve(line_strings.size());
+    for (const auto & line_string : line_strings) {
+      references.push_back(addLineString(line_string));
+    }
+    return addReferences(references);
+  }
+
+  void addLanelet(const lanelet::ConstLanelet & lanelet)
+  {
+    LaneletRecord record{};
+    record.id = lanelet.id();
+    record.left = addLineString(lanelet.leftBound());
+    record.right = addLineString(lanelet.rightBound());
+    record.centerline =
+      lanelet.hasCustomCenterline() ? addLineString(lanelet.centerline()) : NO_INDEX;
+    record.flags = IN_LAYER;
+    record.regulatory_elements = addRegulatoryElementReferences(lanelet.regulatoryElements());
+    record.attributes = addAttributes(lanelet.attributes());
+    m_lanelets.push_back(record);
+  }
+
+  void addArea(const lanelet::ConstArea & area)
+  {
+    AreaRecord record{};
+    record.id = area.id();
+    record.outer = addLineStringReferences(area.outerBound());
+    std::vector<Range> inner;
+    for (const auto & bound : area.innerBounds()) {
+      inner.push_back(addLineStringReferences(bound));
+    }
+    record.inner = Range{nextIndex(m_bounds.size()), static_cast<uint32_t>(inner.size())};
+    m_bounds.insert(m_bounds.end(), inner.begin(), inner.end());
+    record.regulatory_elements = addRegulatoryElementReferences(area.regulatoryElements());
+    record.attributes = addAttributes(area.attributes());
+    record.flags = IN_LAYER;
+    m_areas.push_back(record);
+  }
+
+  /// \brief Turns the parameters of a regulatory element into records
+  class ParameterVisitor : public boost::static_visitor<void>
+  {
+  public:
+    ParameterVisitor(Encoder & encoder, const uint32_t role)
+    : m_encoder(encoder), m_role{role} {}
+
+    void operator()(const lanelet::Point3d & point) const
+    {
+      add(ParameterType::POINT, m_encoder.addPoint(point, 0U));
+    }
+    void operator()(const lanelet::LineString3d & line_string) const
+    {
+      add(ParameterType::LINE_STRING, m_encoder.addLineString(line_string));
+    }
+    void operator()(const lanelet::Polygon3d & polygon) const
+    {
+      add(ParameterType::POLYGON, m_encoder.addPolygon(polygon));
+    }
+    void operator()(const lanelet::WeakLanelet & lanelet) const
+    {
+      // A parameter whose primitive is gone has nothing to refer to and is skipped
+      if (!lanelet.expired()) {
+        const auto id = lanelet.lock().id();
+        add(ParameterType::LANELET, m_encoder.find(m_encoder.m_lanelet_indices, id));
+      }
+    }
+    void operator()(const lanelet::WeakArea & area) const
+    {
+      if (!area.expired()) {
+        add(ParameterType::AREA, m_encoder.find(m_encoder.m_area_indices, area.lock().id()));
+      }
+    }
+
+  private:
+    void add(const ParameterType type, const uint32_t index) const
+    {
+      m_encoder.m_parameters.push_back(ParameterRecord{m_role, type, index, 0U});
+    }
+
+    Encoder & m_encoder;
+    uint32_t m_role;
+  };
+
+  void addRegulatoryElement(const lanelet::RegulatoryElement & regulatory_element)
+  {
+    RegulatoryElementRecord record{};
+    record.id = regulatory_element.id();
+    record.parameters.begin = nextIndex(m_parameters.size());
+    for (const auto & parameters : regulatory_element.constData()->parameters) {
+      const ParameterVisitor visitor{*this, addString(parameters.first)};
+      for (const auto & parameter : parameters.second) {
+        boost::apply_visitor(visitor, parameter);
+      }
+    }
+    record.parameters.count =
+      static_cast<uint32_t>(m_parameters.size()) - record.parameters.begin;
+    record.attributes = addAttributes(regulatory_element.attributes());
+    record.flags = IN_LAYER;
+    m_regulatory_elements.push_back(record);
+  }
+
+  template<typename RecordT>
+  static void appendSection(
+    const Section section, const std::vector<RecordT> & records, Header & header,
+    std::vector<uint8_t> & data)
+  {
+    const std::size_t offset =
+      ((data.size() + SECTION_ALIGNMENT) - 1U) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+    const std::size_t size = records.size() * sizeof(RecordT);
+    data.resize(offset + size, 0U);
+    if (size > 0U) {
+      (void)std::memcpy(&data[offset], records.data(), size);
+    }
+    header.sections[sectionIndex(section)] = SectionRecord{offset, records.size()};
+  }
+
+  const lanelet::LaneletMap & m_map;
+  /// False once the map turned out not to be encodable
+  bool8_t m_valid{true};
+
+  std::unordered_map<std::string, uint32_t> m_string_indices{};
+  IndexMap m_point_indices{};
+  IndexMap m_line_string_indices{};
+  IndexMap m_polygon_indices{};
+  IndexMap m_lanelet_indices{};
+  IndexMap m_area_indices{};
+  IndexMap m_regulatory_element_indices{};
+
+  std::vector<StringRecord> m_strings{};
+  std::vector<char> m_chars{};
+  std::vector<AttributeRecord> m_attributes{};
+  std::vector<uint32_t> m_references{};
+  std::vector<Range> m_bounds{};
+  std::vector<PointRecord> m_points{};
+  std::vector<LineStringRecord> m_line_strings{};
+  std::vector<LineStringRecord> m_polygons{};
+  std::vector<LaneletRecord> m_lanelets{};
+  std::vector<AreaRecord> m_areas{};
+  std::vector<RegulatoryElementRecord> m_regulatory_elements{};
+  std::vector<ParameterRecord> m_parameters{};
+};
+
+/// \brief Decodes the tables of a view in the order in which the primitives refer to each other
+class Decoder
+{
+public:
+  explicit Decoder(const FlatMapView & view)
+  : m_view{view} {}
+
+  std::unique_ptr<lanelet::LaneletMap> decode()
+  {
+    // Each string of the pool is made once, the attributes copy them
+    const auto strings = m_view.strings();
+    m_strings.reserve(strings.size());
+    for (std::size_t index = 0U; index < strings.size(); ++index) {
+      m_strings.push_back(m_view.string(static_cast<uint32_t>(index)));
+    }
+
+    lanelet::PointLayer::Map point_map;
+    const auto points = m_view.points();
+    m_points.reserve(points.size());
+    for (std::size_t index = 0U; index < points.size(); ++index) {
+      const auto record = points[index];
+      m_points.emplace_back(record.id, record.x, record.y, record.z, attributes(record.attributes));
+      addToLayer(record.flags, m_points.back(), point_map);
+    }
+
+    lanelet::LineStringLayer::Map line_string_map;
+    decodeLineStrings(m_view.lineStrings(), m_line_strings, line_string_map);
+    lanelet::PolygonLayer::Map polygon_map;
+    decodeLineStrings(m_view.polygons(), m_polygons, polygon_map);
+
+    lanelet::LaneletLayer::Map lanelet_map;
+    const auto lanelets = m_view.lanelets();
+    m_lanelets.reserve(lanelets.size());
+    for (std::size_t index = 0U; index < lanelets.size(); ++index) {
+      const auto record = lanelets[index];
+      m_lanelets.emplace_back(
+        record.id, resolve(m_line_strings, record.left), resolve(m_line_strings, record.right),
+        attributes(record.attributes));
+      if (record.centerline != NO_INDEX) {
+        m_lanelets.back().setCenterline(resolve(m_line_strings, record.centerline));
+      }
+      addToLayer(record.flags, m_lanelets.back(), lanelet_map);
+    }
+
+    lanelet::AreaLayer::Map area_map;
+    const auto areas = m_view.areas();
+    m_areas.reserve(areas.size());
+    for (std::size_t index = 0U; index < areas.size(); ++index) {
+      const auto record = areas[index];
+      lanelet::InnerBounds inner;
+      inner.reserve(record.inner.count);
+      for (std::size_t bound = 0U; bound < record.inner.count; ++bound) {
+        inner.push_back(lineStrings(m_view.bounds()[std::size_t{record.inner.begin} + bound]));
+      }
+      m_areas.emplace_back(
+        record.id, lineStrings(record.outer), std::move(inner), attributes(record.attributes));
+      addToLayer(record.flags, m_areas.back(), area_map);
+    }
+
+    // The regulatory elements come last, they are made with the lanelets and areas they refer
+    // to, which are then given the regulatory elements that refer to them
+    lanelet::RegulatoryElementLayer::Map regulatory_element_map;
+    const auto regulatory_elements = m_view.regulatoryElements();
+    m_regulatory_elements.reserve(regulatory_elements.size());
+    for (std::size_t index = 0U; index < regulatory_elements.size(); ++index) {
+      const auto record = regulatory_elements[index];
+      m_regulatory_elements.push_back(regulatoryElement(record));
+      addToLayer(record.flags, m_regulatory_elements.back(), regulatory_element_map);
+    }
+    for (std::size_t index = 0U; index < lanelets.size(); ++index) {
+      for (const auto & element : regulatoryElements(lanelets[index].regulatory_elements)) {
+        m_lanelets[index].addRegulatoryElement(element);
+      }
+    }
+    for (std::size_t index = 0U; index < areas.size(); ++index) {
+      for (const auto & element : regulatoryElements(areas[index].regulatory_elements)) {
+        m_areas[index].addRegulatoryElement(element);
+      }
+    }
+
+    lanelet::utils::registerId(m_view.idCounter());
+    return std::make_unique<lanelet::LaneletMap>(
+      std::move(lanelet_map), std::move(area_map), std::move(regulatory_element_map),
+      std::move(polygon_map), std::move(line_string_map), std::move(point_map));
+  }
+
+private:
+  template<typename PrimitiveT, typename MapT>
+  static void addToLayer(const uint32_t flags, const PrimitiveT & primitive, MapT & map)
+  {
+    if ((flags & IN_LAYER) != 0U) {
+      (void)map.emplace(primitive.id(), primitive);
+    }
+  }
+
+  static void addToLayer(
+    const uint32_t flags, const lanelet::RegulatoryElementPtr & element,
+    lanelet::RegulatoryElementLayer::Map & map)
+  {
+    if ((flags & IN_LAYER) != 0U) {
+      (void)map.emplace(element->id(), element);
+    }
+  }
+
+  const std::string & string(const uint32_t index) const
+  {
+    return m_strings.at(index);
+  }
+
+  lanelet::AttributeMap attributes(const Range range) const
+  {
+    const auto records = m_view.attributes();
+    lanelet::AttributeMap attributes;
+    for (std::size_t index = 0U; index < range.count; ++index) {
+      const auto record = records[std::size_t{range.begin} + index];
+      attributes[string(record.key)] = lanelet::Attribute{string(record.value)};
+    }
+    return attributes;
+  }
+
+  uint32_t reference(const Range range, const std::size_t index) const
+  {
+    return m_view.references()[std::size_t{range.begin} + index];
+  }
+
+  /// \brief A line string or polygon of a reference, inverted if the reference says so
+  template<typename PrimitiveT>
+  static PrimitiveT resolve(const std::vector<PrimitiveT> & primitives, const uint32_t reference)
+  {
+    const auto & primitive = primitives.at(reference & ~INVERTED);
+    return ((reference & INVERTED) != 0U) ? primitive.invert() : primitive;
+  }
+
+  template<typename PrimitiveT, typename MapT>
+  void decodeLineStrings(
+    const Table<LineStringRecord> & records, std::vector<PrimitiveT> & primitives, MapT & map)
+  {
+    primitives.reserve(records.size());
+    for (std::size_t index = 0U; index < records.size(); ++index) {
+      const auto record = records[index];
+      lanelet::Points3d points;
+      points.reserve(record.points.count);
+      for (std::size_t point = 0U; point < record.points.count; ++point) {
+        points.push_back(m_points.at(reference(record.points, point)));
+      }
+      primitives.emplace_back(record.id, std::move(points), attributes(record.attributes));
+      addToLayer(record.flags, primitives.back(), map);
+    }
+  }
+
+  lanelet::LineStrings3d lineStrings(const Range range) const
+  {
+    lanelet::LineStrings3d line_strings;
+    line_strings.reserve(range.count);
+    for (std::size_t index = 0U; index < range.count; ++index) {
+      line_strings.push_back(resolve(m_line_strings, reference(range, index)));
+    }
+    return line_strings;
+  }
+
+  lanelet::RegulatoryElementPtrs regulatoryElements(const Range range) const
+  {
+    lanelet::RegulatoryElementPtrs elements;
+    elements.reserve(range.count);
+    for (std::size_t index = 0U; index < range.count; ++index) {
+      elements.push_back(m_regulatory_elements.at(reference(range, index)));
+    }
+    return elements;
+  }
+
+  lanelet::RegulatoryElementPtr regulatoryElement(const RegulatoryElementRecord & record) const
+  {
+    const auto records = m_view.parameters();
+    lanelet::RuleParameterMap parameters;
+    for (std::size_t index = 0U; index < record.parameters.count; ++index) {
+      const auto parameter = records[std::size_t{record.parameters.begin} + index];
+      auto & role = parameters[string(parameter.role)];
+      switch (parameter.type) {
+        case ParameterType::POINT:
+          role.emplace_back(m_points.at(parameter.index));
+          break;
+        case ParameterType::LINE_STRING:
+          role.emplace_back(resolve(m_line_strings, parameter.index));
+          break;
+        case ParameterType::POLYGON:
+          role.emplace_back(resolve(m_polygons, parameter.index));
+          break;
+        case ParameterType::LANELET:
+          role.emplace_back(lanelet::WeakLanelet{m_lanelets.at(parameter.index)});
+          break;
+        case ParameterType::AREA:
+          role.emplace_back(lanelet::WeakArea{m_areas.at(parameter.index)});
+          break;
+        default:
+          throw std::runtime_error{"flat map: unknown type of a regulatory element parameter"};
+      }
+    }
+    auto data = std::make_shared<lanelet::RegulatoryElementData>(
+      record.id, std::move(parameters), attributes(record.attributes));
+    // Made by the subtype like by the lanelet2 loaders, so that it is of the registered class
+    const auto subtype = data->attributes.find(lanelet::AttributeNamesString::Subtype);
+    if (subtype == data->attributes.end()) {
+      return std::make_shared<lanelet::GenericRegulatoryElement>(data);
+    }
+    return lanelet::RegulatoryElementFactory::create(subtype->second.value(), data);
+  }
+
+  const FlatMapView & m_view;
+  std::vector<std::string> m_strings{};
+  std::vector<lanelet::Point3d> m_points{};
+  std::vector<lanelet::LineString3d> m_line_strings{};
+  std::vector<lanelet::Polygon3d> m_polygons{};
+  std::vector<lanelet::Lanelet> m_lanelets{};
+  std::vector<lanelet::Area> m_areas{};
+  std::vector<lanelet::RegulatoryElementPtr> m_regulatory_elements{};
+};
+}  // namespace
+
+FlatMapView::FlatMapView(const uint8_t * const data, const std::size_t size)
+: m_data{data},
+  m_header{}
+{
+  if ((data == nullptr) || (size < sizeof(Header))) {
+    throw std::runtime_error{"flat map: the buffer is smaller than the header"};
+  }
+  (void)std::memcpy(&m_header, data, sizeof(Header));
+  if (m_header.magic != MAGIC) {
+    throw std::runtime_error{"flat map: the buffer isn't a flat map"};
+  }
+  if (m_header.version != VERSION) {
+    throw std::runtime_error{
+            "flat map: version " + std::to_string(m_header.version) + " instead of " +
+            std::to_string(VERSION)};
+  }
+  for (std::size_t section = 0U; section < NUM_SECTIONS; ++section) {
+    const auto & record = m_header.sections[section];
+    // Compared by count, an offset and a size could overflow
+    if ((record.offset % SECTION_ALIGNMENT != 0U) || (record.offset > size) ||
+      (record.count > (size - record.offset) / RECORD_SIZES[section]))
+    {
+      throw std::runtime_error{"flat map: a table is outside the buffer"};
+    }
+  }
+}
+
+bool8_t FlatMapView::isFlatMap(const uint8_t * const data, const std::size_t size) noexcept
+{
+  uint32_t magic{0U};
+  if ((data == nullptr) || (size < sizeof(magic))) {
+    return false;
+  }
+  (void)std::memcpy(&magic, data, sizeof(magic));
+  return magic == MAGIC;
+}
+
+const char * FlatMapView::stringData(const uint32_t index, std::size_t & size) const
+{
+  const auto record = strings()[index];
+  const auto & chars = m_header.sections[sectionIndex(Section::CHARS)];
+  if (std::size_t{record.offset} + std::size_t{record.size} > chars.count) {
+    throw std::out_of_range{"flat map: a string is outside the pool"};
+  }
+  size = record.size;
+  return reinterpret_cast<const char *>(m_data + chars.offset + record.offset);
+}
+
+std::string FlatMapView::string(const uint32_t index) const
+{
+  std::size_t size{0U};
+  const char * const data = stringData(index, size);
+  return std::string(data, size);
+}
+
+bool8_t encodeFlatMap(const lanelet::LaneletMap & map, std::vector<uint8_t> & data)
+{
+  return Encoder{map}.encode(data);
+}
+
+std::unique_ptr<lanelet::LaneletMap> decodeFlatMap(const FlatMapView & view)
+{
+  return Decoder{view}.decode();
+}
+}  // namespace flat
+}  // namespace had_map_utils
+}  // namespace common
+}  // namespace autoware
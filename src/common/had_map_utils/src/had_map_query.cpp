@@ -16,10 +16,17 @@
 
 //lint -e537 pclint vs cpplint NOLINT
 
+#include <lanelet2_core/geometry/Area.h>
+#include <lanelet2_core/geometry/LineString.h>
+#include <lanelet2_core/geometry/Polygon.h>
+
 #include <algorithm>
+#include <iterator>
 #include <limits>
 #include <memory>
+#include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "had_map_utils/had_map_query.hpp"
@@ -127,6 +134,112 @@ lanelet::Lanelets getLaneletLayer(const std::shared_ptr<lanelet::LaneletMap> & l
   return lanelets;
 }
 
+SubtypeIndex::SubtypeIndex(const lanelet::LaneletMapPtr & ll_map)
+{
+  if (!ll_map) {
+    throw std::invalid_argument("SubtypeIndex: the map must not be null");
+  }
+  m_areas = build<lanelet::Area>(ll_map->areaLayer);
+  m_polygons = build<lanelet::Polygon3d>(ll_map->polygonLayer);
+  m_line_strings = build<lanelet::LineString3d>(ll_map->lineStringLayer);
+}
+
+const lanelet::Areas & SubtypeIndex::areas(const std::string & subtype) const
+{
+  return find(m_areas, subtype);
+}
+
+lanelet::Areas SubtypeIndex::areas(
+  const std::string & subtype, const lanelet::BoundingBox2d & bbox) const
+{
+  return search(m_areas, subtype, bbox);
+}
+
+const lanelet::Polygons3d & SubtypeIndex::polygons(const std::string & subtype) const
+{
+  return find(m_polygons, subtype);
+}
+
+lanelet::Polygons3d SubtypeIndex::polygons(
+  const std::string & subtype, const lanelet::BoundingBox2d & bbox) const
+{
+  return search(m_polygons, subtype, bbox);
+}
+
+const lanelet::LineStrings3d & SubtypeIndex::lineStrings(const std::string & subtype) const
+{
+  return find(m_line_strings, subtype);
+}
+
+lanelet::LineStrings3d SubtypeIndex::lineStrings(
+  const std::string & subtype, const lanelet::BoundingBox2d & bbox) const
+{
+  return search(m_line_strings, subtype, bbox);
+}
+
+template<typename PrimitiveT, typename LayerT>
+SubtypeIndex::Layer<PrimitiveT> SubtypeIndex::build(LayerT & layer)
+{
+  Layer<PrimitiveT> index;
+  std::unordered_map<std::string, std::vector<Value>> boxes;
+  for (auto it = layer.begin(); it != layer.end(); it++) {
+    const PrimitiveT element = *it;
+    if (!element.hasAttribute(lanelet::AttributeName::Subtype)) {
+      continue;
+    }
+    const std::string subtype = element.attribute(lanelet::AttributeName::Subtype).value();
+    auto & elements = index[subtype].elements;
+    const lanelet::BoundingBox2d bbox = lanelet::geometry::boundingBox2d(element);
+    // An element without points can't intersect anything
+    if (!bbox.isEmpty()) {
+      boxes[subtype].emplace_back(
+        Box{Point{bbox.min().x(), bbox.min().y()}, Point{bbox.max().x(), bbox.max().y()}},
+        elements.size());
+    }
+    elements.push_back(element);
+  }
+  for (auto & entry : boxes) {
+    // The range constructor packs the tree, which is faster to query than inserting one by one
+    index[entry.first].rtree = RTree(entry.second.begin(), entry.second.end());
+  }
+  return index;
+}
+
+template<typename PrimitiveT>
+const std::vector<PrimitiveT> & SubtypeIndex::find(
+  const Layer<PrimitiveT> & layer, const std::string & subtype)
+{
+  static const std::vector<PrimitiveT> kNone{};
+  const auto it = layer.find(subtype);
+  return (it == layer.end()) ? kNone : it->second.elements;
+}
+
+template<typename PrimitiveT>
+std::vector<PrimitiveT> SubtypeIndex::search(
+  const Layer<PrimitiveT> & layer, const std::string & subtype,
+  const lanelet::BoundingBox2d & bbox)
+{
+  std::vector<PrimitiveT> result;
+  const auto it = layer.find(subtype);
+  if ((it == layer.end()) || bbox.isEmpty()) {
+    return result;
+  }
+  std::vector<Value> hits;
+  const Box query{Point{bbox.min().x(), bbox.min().y()}, Point{bbox.max().x(), bbox.max().y()}};
+  (void)it->second.rtree.query(
+    boost::geometry::index::intersects(query), std::back_inserter(hits));
+  // The order of the results of a query is not specified
+  std::sort(
+    hits.begin(), hits.end(), [](const Value & lhs, const Value & rhs) {
+      return lhs.second < rhs.second;
+    });
+  result.reserve(hits.size());
+  for (const auto & hit : hits) {
+    result.push_back(it->second.elements[hit.second]);
+  }
+  return result;
+}
+
 }  // namespace had_map_utils
 }  // namespace common
 }  // namespace autoware
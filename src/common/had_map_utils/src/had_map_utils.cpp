@@ -23,9 +23,14 @@
 #include <common/types.hpp>
 #include <utility>
 #include <algorithm>
+#include <array>
+#include <future>
 #include <limits>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 using autoware::common::types::float64_t;
@@ -158,16 +163,123 @@ lanelet::LineString3d generateFineCenterline(
   return centerline;
 }
 
+namespace
+{
+// Identifies the geometry a centerline was generated from without comparing all points of the
+// bounds: their end points and sizes
+struct BoundsSignature
+{
+  std::array<float64_t, 8U> end_points;
+  std::array<size_t, 2U> sizes;
+
+  bool operator==(const BoundsSignature & other) const
+  {
+    return (end_points == other.end_points) && (sizes == other.sizes);
+  }
+};
+
+BoundsSignature getBoundsSignature(const lanelet::ConstLanelet & lanelet_obj)
+{
+  BoundsSignature signature{};
+  const auto left_bound = lanelet_obj.leftBound2d();
+  const auto right_bound = lanelet_obj.rightBound2d();
+  signature.sizes = {{left_bound.size(), right_bound.size()}};
+  if (!left_bound.empty() && !right_bound.empty()) {
+    signature.end_points = {{
+      left_bound.front().x(), left_bound.front().y(), left_bound.back().x(),
+      left_bound.back().y(), right_bound.front().x(), right_bound.front().y(),
+      right_bound.back().x(), right_bound.back().y()}};
+  }
+  return signature;
+}
+
+struct CachedCenterline
+{
+  BoundsSignature signature;
+  lanelet::ConstLineString3d centerline;
+};
+
+// Bounds the memory used when driving through large maps
+constexpr size_t MAX_CACHED_CENTERLINES = 10000U;
+
+std::mutex & centerlineCacheMutex()
+{
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::map<std::pair<lanelet::Id, float64_t>, CachedCenterline> & centerlineCache()
+{
+  static std::map<std::pair<lanelet::Id, float64_t>, CachedCenterline> cache;
+  return cache;
+}
+}  // namespace
+
+lanelet::ConstLineString3d getFineCenterline(
+  const lanelet::ConstLanelet & lanelet_obj, const float64_t resolution)
+{
+  const auto key = std::make_pair(lanelet_obj.id(), resolution);
+  const auto signature = getBoundsSignature(lanelet_obj);
+  {
+    std::lock_guard<std::mutex> lock{centerlineCacheMutex()};
+    const auto cached = centerlineCache().find(key);
+    if ((cached != centerlineCache().end()) && (cached->second.signature == signature)) {
+      return cached->second.centerline;
+    }
+  }
+
+  // Generated without holding the lock, so that other lanelets can be looked up meanwhile
+  const lanelet::ConstLineString3d centerline = generateFineCenterline(lanelet_obj, resolution);
+  std::lock_guard<std::mutex> lock{centerlineCacheMutex()};
+  auto & cache = centerlineCache();
+  if (cache.size() >= MAX_CACHED_CENTERLINES) {
+    cache.clear();
+  }
+  cache[key] = CachedCenterline{signature, centerline};
+  return centerline;
+}
+
+void clearFineCenterlineCache()
+{
+  std::lock_guard<std::mutex> lock{centerlineCacheMutex()};
+  centerlineCache().clear();
+}
+
 void overwriteLaneletsCenterline(
   lanelet::LaneletMapPtr lanelet_map,
   const autoware::common::types::bool8_t force_overwrite)
 {
+  std::vector<lanelet::Lanelet> lanelets;
   for (auto & lanelet_obj : lanelet_map->laneletLayer) {
     if (force_overwrite || !lanelet_obj.hasCustomCenterline()) {
-      const auto fine_center_line = generateFineCenterline(lanelet_obj, 2.0);
-      lanelet_obj.setCenterline(fine_center_line);
+      lanelets.push_back(lanelet_obj);
     }
   }
+
+  // The centerlines are independent of each other and dominate the time to load large maps, so
+  // they are generated in parallel. The map is only modified once they are all done.
+  std::vector<lanelet::LineString3d> fine_center_lines(lanelets.size());
+  const size_t num_threads = std::max(std::thread::hardware_concurrency(), 1U);
+  const size_t chunk_size = (lanelets.size() + num_threads - 1U) / num_threads;
+  std::vector<std::future<void>> workers;
+  for (size_t begin = 0U; begin < lanelets.size(); begin += chunk_size) {
+    const auto end = std::min(begin + chunk_size, lanelets.size());
+    workers.push_back(
+      std::async(
+        std::launch::async, [&lanelets, &fine_center_lines, begin, end] {
+          for (size_t i = begin; i < end; ++i) {
+            fine_center_lines[i] = generateFineCenterline(lanelets[i], 2.0);
+          }
+        }));
+  }
+  for (auto & worker : workers) {
+    // Forwards exceptions of the workers
+    worker.get();
+  }
+
+  for (size_t i = 0U; i < lanelets.size(); ++i) {
+    lanelets[i].setCenterline(fine_center_lines[i]);
+  }
 }
 
 }  // namespace had_map_utils
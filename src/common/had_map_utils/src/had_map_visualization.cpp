@@ -16,6 +16,8 @@
 
 //lint -e537 pclint vs cpplint NOLINT
 
+#include <lanelet2_core/geometry/Area.h>
+#include <lanelet2_core/geometry/Lanelet.h>
 #include <lanelet2_io/io_handlers/Serialize.h>
 
 #include <boost/archive/binary_iarchive.hpp>
@@ -23,9 +25,14 @@
 #include <common/types.hpp>
 
 #include <algorithm>
+#include <future>
 #include <limits>
+#include <map>
 #include <memory>
+#include <set>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 #include <unordered_set>
 
@@ -480,6 +487,36 @@ geometry_msgs::msg::Polygon lanelet2Polygon(
   return polygon;
 }
 
+namespace
+{
+// The primitives are triangulated independently of each other, and triangulating all of them
+// dominates the time to visualize large maps, so it's done in parallel
+template<typename PrimitiveT, typename TriangulateT>
+std::vector<std::vector<geometry_msgs::msg::Polygon>> triangulateInParallel(
+  const std::vector<PrimitiveT> & primitives, const TriangulateT & triangulate)
+{
+  std::vector<std::vector<geometry_msgs::msg::Polygon>> triangles(primitives.size());
+  const size_t num_threads = std::max(std::thread::hardware_concurrency(), 1U);
+  const size_t chunk_size = (primitives.size() + num_threads - 1U) / num_threads;
+  std::vector<std::future<void>> workers;
+  for (size_t begin = 0U; begin < primitives.size(); begin += chunk_size) {
+    const auto end = std::min(begin + chunk_size, primitives.size());
+    workers.push_back(
+      std::async(
+        std::launch::async, [&primitives, &triangles, &triangulate, begin, end] {
+          for (size_t i = begin; i < end; ++i) {
+            triangles[i] = triangulate(primitives[i]);
+          }
+        }));
+  }
+  for (auto & worker : workers) {
+    // Forwards exceptions of the workers
+    worker.get();
+  }
+  return triangles;
+}
+}  // namespace
+
 visualization_msgs::msg::MarkerArray laneletsAsTriangleMarkerArray(
   const rclcpp::Time & t,
   const std::string & ns,
@@ -499,10 +536,10 @@ visualization_msgs::msg::MarkerArray laneletsAsTriangleMarkerArray(
     visualization_msgs::msg::Marker::TRIANGLE_LIST,
     1.0);
 
-  for (auto ll : lanelets) {
-    std::vector<geometry_msgs::msg::Polygon> triangles = lanelet2Triangle(ll);
-
-    for (auto tri : triangles) {
+  const auto lanelets_triangles = triangulateInParallel(
+    lanelets, [](const lanelet::ConstLanelet & ll) {return lanelet2Triangle(ll);});
+  for (const auto & triangles : lanelets_triangles) {
+    for (const auto & tri : triangles) {
       geometry_msgs::msg::Point tri0[3];
 
       for (size_t i = 0; i < 3; i++) {
@@ -537,9 +574,10 @@ visualization_msgs::msg::MarkerArray areasAsTriangleMarkerArray(
     visualization_msgs::msg::Marker::TRIANGLE_LIST,
     1.0);
 
-  for (auto area : areas) {
-    std::vector<geometry_msgs::msg::Polygon> triangles = area2Triangle(area);
-    for (auto tri : triangles) {
+  const auto areas_triangles = triangulateInParallel(
+    areas, [](const lanelet::Area & area) {return area2Triangle(area);});
+  for (const auto & triangles : areas_triangles) {
+    for (const auto & tri : triangles) {
       for (size_t i = 0; i < 3; i++) {
         marker.points.push_back(toGeomMsgPt(tri.points[i]));
         marker.colors.push_back(c);
@@ -553,6 +591,185 @@ visualization_msgs::msg::MarkerArray areasAsTriangleMarkerArray(
   return marker_array;
 }
 
+MapMarkerTiles::MapMarkerTiles(const float64_t tile_size, const rclcpp::Time & t)
+: m_tile_size{tile_size}, m_time{t}
+{
+}
+
+MapTileKey MapMarkerTiles::tileOf(const float64_t x, const float64_t y) const
+{
+  if ((m_tile_size <= 0.0) || !std::isfinite(x) || !std::isfinite(y)) {
+    return MapTileKey{0, 0};
+  }
+  return MapTileKey{
+    static_cast<int64_t>(std::floor(x / m_tile_size)),
+    static_cast<int64_t>(std::floor(y / m_tile_size))};
+}
+
+MapTileKey MapMarkerTiles::tileOf(const lanelet::BoundingBox2d & box) const
+{
+  // Evaluated into a point, the center of an Eigen box refers to the box
+  const lanelet::BasicPoint2d center = box.center();
+  return tileOf(center.x(), center.y());
+}
+
+void MapMarkerTiles::addLaneletsBoundary(
+  const lanelet::ConstLanelets & lanelets, const std_msgs::msg::ColorRGBA & c,
+  const bool8_t viz_centerline)
+{
+  float32_t lss = 0.1f;
+  for (const auto & lll : lanelets) {
+    auto & markers = m_tiles[tileOf(lanelet::geometry::boundingBox2d(lll))].markers;
+    lanelet::ConstLineString3d left_ls = lll.leftBound();
+    lanelet::ConstLineString3d right_ls = lll.rightBound();
+
+    if (m_added_lines.insert(left_ls.id()).second) {
+      markers.push_back(lineString2Marker(m_time, left_ls, "map", "left_lane_bound", c, lss));
+    }
+    if (m_added_lines.insert(right_ls.id()).second) {
+      markers.push_back(lineString2Marker(m_time, right_ls, "map", "right_lane_bound", c, lss));
+    }
+    if (viz_centerline) {
+      lanelet::ConstLineString3d center_ls = lll.centerline();
+      if (m_added_lines.insert(center_ls.id()).second) {
+        markers.push_back(
+          lineString2Marker(
+            m_time, center_ls, "map", "center_lane_line", c,
+            std::max(lss * 0.1f, 0.01f)));
+      }
+    }
+  }
+}
+
+void MapMarkerTiles::addLaneletsTriangles(
+  const std::string & ns, const lanelet::ConstLanelets & lanelets,
+  const std_msgs::msg::ColorRGBA & c)
+{
+  std::vector<MapTileKey> keys;
+  keys.reserve(lanelets.size());
+  for (const auto & ll : lanelets) {
+    keys.push_back(tileOf(lanelet::geometry::boundingBox2d(ll)));
+  }
+  addTriangles(
+    ns, keys,
+    triangulateInParallel(
+      lanelets, [](const lanelet::ConstLanelet & ll) {return lanelet2Triangle(ll);}), c);
+}
+
+void MapMarkerTiles::addAreasBoundary(
+  const std::string & ns, const lanelet::Areas & areas, const std_msgs::msg::ColorRGBA & c)
+{
+  float32_t lss = 0.1f;
+  for (const auto & area : areas) {
+    lanelet::BasicPolygon3d bpg = area.outerBoundPolygon().basicPolygon();
+    if (bpg.empty()) {
+      continue;
+    }
+    m_tiles[tileOf(lanelet::geometry::boundingBox2d(area))].markers.push_back(
+      basicPolygon2Marker(m_time, static_cast<int32_t>(area.id()), bpg, "map", ns, c, lss));
+  }
+}
+
+void MapMarkerTiles::addAreasTriangles(
+  const std::string & ns, const lanelet::Areas & areas, const std_msgs::msg::ColorRGBA & c)
+{
+  std::vector<MapTileKey> keys;
+  keys.reserve(areas.size());
+  for (const auto & area : areas) {
+    keys.push_back(tileOf(lanelet::geometry::boundingBox2d(area)));
+  }
+  addTriangles(
+    ns, keys,
+    triangulateInParallel(areas, [](const lanelet::Area & area) {return area2Triangle(area);}),
+    c);
+}
+
+void MapMarkerTiles::addTriangles(
+  const std::string & ns, const std::vector<MapTileKey> & keys,
+  const std::vector<std::vector<geometry_msgs::msg::Polygon>> & triangles,
+  const std_msgs::msg::ColorRGBA & c)
+{
+  std::map<MapTileKey, visualization_msgs::msg::Marker> tile_markers;
+  for (size_t i = 0U; i < keys.size(); ++i) {
+    if (triangles[i].empty()) {
+      continue;
+    }
+    auto inserted = tile_markers.emplace(keys[i], visualization_msgs::msg::Marker{});
+    auto & marker = inserted.first->second;
+    if (inserted.second) {
+      const auto tile_id =
+        m_tile_ids.emplace(keys[i], static_cast<int32_t>(m_tile_ids.size())).first->second;
+      setMarkerHeader(
+        &marker, tile_id, m_time, "map", ns, c,
+        visualization_msgs::msg::Marker::ADD,
+        visualization_msgs::msg::Marker::TRIANGLE_LIST,
+        1.0);
+    }
+    for (const auto & tri : triangles[i]) {
+      for (size_t j = 0; j < 3; j++) {
+        marker.points.push_back(toGeomMsgPt(tri.points[j]));
+        marker.colors.push_back(c);
+      }
+    }
+  }
+  for (auto & tile_marker : tile_markers) {
+    m_tiles[tile_marker.first].markers.push_back(std::move(tile_marker.second));
+  }
+}
+
+std::set<MapTileKey> MapMarkerTiles::tilesNear(
+  const float64_t x, const float64_t y, const float64_t radius) const
+{
+  std::set<MapTileKey> keys;
+  for (const auto & tile : m_tiles) {
+    if ((radius <= 0.0) || (m_tile_size <= 0.0)) {
+      keys.insert(tile.first);
+      continue;
+    }
+    // Distance of the position to the square of the tile
+    const auto lower_x = static_cast<float64_t>(tile.first.first) * m_tile_size;
+    const auto lower_y = static_cast<float64_t>(tile.first.second) * m_tile_size;
+    const auto dx = std::max({lower_x - x, 0.0, x - (lower_x + m_tile_size)});
+    const auto dy = std::max({lower_y - y, 0.0, y - (lower_y + m_tile_size)});
+    if (((dx * dx) + (dy * dy)) <= (radius * radius)) {
+      keys.insert(tile.first);
+    }
+  }
+  return keys;
+}
+
+visualization_msgs::msg::MarkerArray MapMarkerTiles::markersFor(
+  const std::set<MapTileKey> & visible, const std::set<MapTileKey> & previous) const
+{
+  visualization_msgs::msg::MarkerArray marker_array;
+  for (const auto & key : visible) {
+    const auto & markers = tileMarkers(key).markers;
+    marker_array.markers.insert(marker_array.markers.end(), markers.begin(), markers.end());
+  }
+  for (const auto & key : previous) {
+    if (visible.find(key) != visible.end()) {
+      continue;
+    }
+    for (const auto & marker : tileMarkers(key).markers) {
+      visualization_msgs::msg::Marker deleted;
+      deleted.header = marker.header;
+      deleted.ns = marker.ns;
+      deleted.id = marker.id;
+      deleted.action = visualization_msgs::msg::Marker::DELETE;
+      marker_array.markers.push_back(deleted);
+    }
+  }
+  return marker_array;
+}
+
+const visualization_msgs::msg::MarkerArray & MapMarkerTiles::tileMarkers(
+  const MapTileKey & key) const
+{
+  static const visualization_msgs::msg::MarkerArray empty;
+  const auto tile = m_tiles.find(key);
+  return (tile != m_tiles.end()) ? tile->second : empty;
+}
+
 }  // namespace had_map_utils
 }  // namespace common
 }  // namespace autoware
@@ -0,0 +1,101 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief Reading of trace files and the reconstruction of the latencies of the stages
+
+#ifndef LATENCY_TRACING__TRACE_ANALYSIS_HPP_
+#define LATENCY_TRACING__TRACE_ANALYSIS_HPP_
+
+#include <common/types.hpp>
+#include <latency_tracing/trace_buffer.hpp>
+#include <latency_tracing/visibility_control.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace autoware
+{
+namespace common
+{
+namespace latency_tracing
+{
+using autoware::common::types::float64_t;
+
+/// \brief The contents of a trace file
+struct LATENCY_TRACING_PUBLIC TraceRecording
+{
+  /// The names of the stages, indexed by the id in the events
+  std::vector<std::string> stages;
+  std::vector<TraceEvent> events;
+};
+
+/// \brief Read a trace file. A file that ends in the middle of a chunk, e.g. because its process
+///        was killed, is read up to the last complete chunk
+/// \param[in] file_name The trace file
+/// \return The stages and events in the file
+/// \throw std::runtime_error If the file can't be opened or isn't a trace file
+LATENCY_TRACING_PUBLIC TraceRecording read_recording(const std::string & file_name);
+
+/// \brief Statistics of a latency, in milliseconds
+struct LATENCY_TRACING_PUBLIC LatencyStatistics
+{
+  std::size_t count{0U};
+  float64_t mean{0.0};
+  float64_t p50{0.0};
+  float64_t p99{0.0};
+  float64_t max{0.0};
+};
+
+/// \brief Compute the statistics of latency samples, with nearest rank percentiles
+/// \param[in] samples_ns The samples in nanoseconds, in any order
+/// \return The statistics in milliseconds, all zero if there are no samples
+LATENCY_TRACING_PUBLIC LatencyStatistics compute_statistics(std::vector<int64_t> samples_ns);
+
+/// \brief The latencies of a stage in the chain
+struct LATENCY_TRACING_PUBLIC StageLatency
+{
+  std::string stage;
+  /// From the end of the previous stage to the start of this one, i.e. the transport and the
+  /// waiting of the message in queues and synchronizers. Empty for the first stage of a trace
+  LatencyStatistics queue;
+  /// From the start to the end of the processing in this stage
+  LatencyStatistics processing;
+  /// Mean time from the start of the trace to the start of this stage, which orders the stages
+  float64_t mean_offset;
+};
+
+/// \brief The latencies of a chain, reconstructed from the recordings of all its processes
+struct LATENCY_TRACING_PUBLIC LatencyBreakdown
+{
+  /// The stages, ordered by their mean offset in the traces
+  std::vector<StageLatency> stages;
+  /// From the start of the first to the end of the last stage of a trace
+  LatencyStatistics end_to_end;
+};
+
+/// \brief Reconstruct the latencies of the stages that the traced messages passed through. The
+///        traces that are linked are joined, so that a trace covers everything that a message
+///        caused downstream. If a stage processed a joined trace more than once, e.g. a
+///        controller that follows one trajectory for several cycles, its first span counts
+/// \param[in] recordings The recordings of the processes of the chain, in any order
+/// \return The latencies of the stages
+LATENCY_TRACING_PUBLIC LatencyBreakdown analyze(const std::vector<TraceRecording> & recordings);
+}  // namespace latency_tracing
+}  // namespace common
+}  // namespace autoware
+
+#endif  // LATENCY_TRACING__TRACE_ANALYSIS_HPP_
@@ -0,0 +1,142 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief The events of a latency trace and the lock-free buffer they are recorded into
+
+#ifndef LATENCY_TRACING__TRACE_BUFFER_HPP_
+#define LATENCY_TRACING__TRACE_BUFFER_HPP_
+
+#include <common/types.hpp>
+#include <latency_tracing/visibility_control.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace autoware
+{
+namespace common
+{
+namespace latency_tracing
+{
+using autoware::common::types::bool8_t;
+
+/// \brief The id of a message that is traced through the nodes, see to_trace_id()
+using TraceId = uint64_t;
+/// \brief The id of a stage of the chain, i.e. of a node, in one tracer
+using StageId = uint32_t;
+
+/// \brief Get the trace id of a message from the stamp of its header. Nodes that pass the stamp
+///        on to their output continue the trace of their input without further ado
+/// \tparam StampT A builtin_interfaces::msg::Time or any type with sec and nanosec members
+/// \param[in] stamp The stamp of the message
+/// \return The stamp in nanoseconds
+template<typename StampT>
+TraceId to_trace_id(const StampT & stamp) noexcept
+{
+  constexpr TraceId kNanosecondsPerSecond{1000000000U};
+  return (static_cast<TraceId>(stamp.sec) * kNanosecondsPerSecond) +
+         static_cast<TraceId>(stamp.nanosec);
+}
+
+/// \brief What an event of a trace records
+enum class EventKind : uint8_t
+{
+  /// A stage processed a message, from time_ns to other
+  SPAN = 0U,
+  /// A stage produced the message of trace_id from the message of other
+  LINK = 1U
+};
+
+/// \brief An event of a trace as it is stored in the trace files
+struct LATENCY_TRACING_PUBLIC TraceEvent
+{
+  /// The message that the event belongs to
+  TraceId trace_id;
+  /// The steady clock time in nanoseconds when the stage started processing, unused for links
+  uint64_t time_ns;
+  /// The steady clock time in nanoseconds when a span ended or the input trace of a link
+  uint64_t other;
+  /// The stage that recorded the event
+  StageId stage;
+  EventKind kind;
+  uint8_t padding[3U];
+};
+static_assert(sizeof(TraceEvent) == 32U, "The trace file format relies on the size of an event");
+
+/// \brief The first bytes of a trace file, they are followed by chunks of a ChunkHeader and its
+///        payload
+constexpr const char kTraceFileMagic[] = "AWTRACE1";
+
+/// \brief What a chunk of a trace file contains
+enum class ChunkType : uint32_t
+{
+  /// The id of a stage followed by its name
+  STAGE = 1U,
+  /// An array of TraceEvent
+  EVENTS = 2U
+};
+
+/// \brief The header of a chunk of a trace file
+struct LATENCY_TRACING_PUBLIC ChunkHeader
+{
+  ChunkType type;
+  /// The size of the payload in bytes
+  uint32_t size;
+};
+
+/// \brief A fixed size ring of trace events that is filled by one thread and drained by another
+///        one without locks. Recording never blocks nor allocates: when the ring is full, the
+///        event is dropped and counted instead
+class LATENCY_TRACING_PUBLIC TraceBuffer
+{
+public:
+  /// \brief Constructor
+  /// \param[in] capacity The number of events the ring holds, rounded up to a power of two
+  /// \throw std::domain_error If the capacity is zero
+  explicit TraceBuffer(std::size_t capacity);
+
+  /// \brief Add an event. Must only be called from the thread that owns the buffer
+  /// \param[in] event The event
+  /// \return False if the buffer was full and the event was dropped
+  bool8_t push(const TraceEvent & event) noexcept;
+
+  /// \brief Move all events into a vector. Must only be called from one thread at a time
+  /// \param[inout] events The vector to append the events to
+  /// \return The number of events that were appended
+  std::size_t drain(std::vector<TraceEvent> & events);
+
+  /// \brief The number of events that were dropped since construction
+  uint64_t dropped() const noexcept;
+
+  /// \brief The number of events the ring holds
+  std::size_t capacity() const noexcept;
+
+private:
+  std::size_t m_mask;
+  std::unique_ptr<TraceEvent[]> m_events;
+  /// Number of events pushed, written by the owning thread only
+  std::atomic<std::size_t> m_head{0U};
+  /// Number of events drained, written by the draining thread only
+  std::atomic<std::size_t> m_tail{0U};
+  std::atomic<uint64_t> m_dropped{0U};
+};
+}  // namespace latency_tracing
+}  // namespace common
+}  // namespace autoware
+
+#endif  // LATENCY_TRACING__TRACE_BUFFER_HPP_
@@ -0,0 +1,169 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief Recording of the latency traces of the messages that pass through a process
+
+#ifndef LATENCY_TRACING__TRACER_HPP_
+#define LATENCY_TRACING__TRACER_HPP_
+
+#include <latency_tracing/trace_buffer.hpp>
+#include <latency_tracing/visibility_control.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace autoware
+{
+namespace common
+{
+namespace latency_tracing
+{
+/// \brief The environment variable with the directory that the process-wide tracer writes to. If
+///        it isn't set, tracing is disabled
+constexpr const char kTraceDirectoryVariable[] = "LATENCY_TRACE_DIR";
+
+/// \brief Records the spans and links of the traced messages into one buffer per thread and
+///        writes them to a trace file from a background thread
+class LATENCY_TRACING_PUBLIC Tracer
+{
+public:
+  /// \brief Constructor of a disabled tracer, which records nothing
+  Tracer();
+
+  /// \brief Constructor of a tracer that writes to a file
+  /// \param[in] file_name The trace file, it is overwritten
+  /// \param[in] flush_period How often the buffers are written to the file
+  /// \param[in] buffer_capacity The number of events each thread can record between two flushes
+  /// \throw std::runtime_error If the file can't be opened
+  explicit Tracer(
+    const std::string & file_name,
+    std::chrono::milliseconds flush_period = std::chrono::milliseconds{100},
+    std::size_t buffer_capacity = 4096U);
+
+  /// \brief Destructor, flushes the remaining events
+  ~Tracer();
+
+  Tracer(const Tracer &) = delete;
+  Tracer & operator=(const Tracer &) = delete;
+
+  /// \brief The tracer of this process. It writes to latency_trace_<pid>.bin in the directory in
+  ///        the LATENCY_TRACE_DIR environment variable, or is disabled if that isn't set
+  static Tracer & instance();
+
+  /// \brief The steady clock time in nanoseconds, which all processes of a machine share
+  static uint64_t now_ns() noexcept;
+
+  /// \brief Whether events are recorded
+  bool8_t enabled() const noexcept;
+
+  /// \brief Get the id of a stage, e.g. of a node, registering it if it is new
+  /// \param[in] name The name of the stage, which identifies it across processes
+  /// \return The id of the stage in this tracer
+  StageId register_stage(const std::string & name);
+
+  /// \brief Record that a stage processed a message
+  /// \param[in] stage The stage
+  /// \param[in] trace_id The message
+  /// \param[in] begin_ns The time the processing started, see now_ns()
+  /// \param[in] end_ns The time the processing ended
+  void span(StageId stage, TraceId trace_id, uint64_t begin_ns, uint64_t end_ns) noexcept;
+
+  /// \brief Record that a stage produced a message of a new trace from a traced message, e.g.
+  ///        because its output has a different stamp than the input
+  /// \param[in] stage The stage
+  /// \param[in] input The trace of the input
+  /// \param[in] output The trace of the output
+  void link(StageId stage, TraceId input, TraceId output) noexcept;
+
+  /// \brief Write all recorded events to the file
+  void flush();
+
+  /// \brief The number of events that were dropped since the buffers were full
+  uint64_t dropped() const;
+
+private:
+  /// Get the buffer of the calling thread, creating it on first use
+  TraceBuffer * local_buffer() noexcept;
+  void record(const TraceEvent & event) noexcept;
+  void write_chunk(ChunkType type, const void * data, std::size_t size);
+  void flush_loop(std::chrono::milliseconds flush_period);
+
+  bool8_t m_enabled;
+  /// Identifies the tracer in the cache of the buffers of each thread
+  uint64_t m_id;
+  std::size_t m_buffer_capacity;
+  /// Guards the stages, the buffers and the stop flag, recording only takes it on the first
+  /// event of a thread
+  mutable std::mutex m_mutex;
+  std::vector<std::string> m_stages{};
+  std::unordered_map<std::thread::id, std::unique_ptr<TraceBuffer>> m_buffers{};
+  std::condition_variable m_stop_condition{};
+  bool8_t m_stop{false};
+  /// Guards the file and what was written to it, to keep the chunks in the file intact
+  std::mutex m_flush_mutex;
+  std::ofstream m_file{};
+  std::size_t m_num_written_stages{0U};
+  std::vector<TraceEvent> m_events{};
+  std::thread m_flush_thread{};
+};
+
+/// \brief Records the span of a stage processing a message, from construction to destruction.
+///        The message usually isn't known before a callback has done part of its work, so the
+///        id is set during the processing, and nothing is recorded if it never is
+class LATENCY_TRACING_PUBLIC TraceScope
+{
+public:
+  /// \brief Constructor, starts the span
+  /// \param[in] tracer The tracer to record into
+  /// \param[in] stage The stage that processes the message
+  TraceScope(Tracer & tracer, StageId stage) noexcept;
+
+  /// \brief Destructor, records the span if the message is known
+  ~TraceScope();
+
+  TraceScope(const TraceScope &) = delete;
+  TraceScope & operator=(const TraceScope &) = delete;
+
+  /// \brief Set the message that is processed
+  /// \param[in] trace_id The trace of the message
+  void set_trace_id(TraceId trace_id) noexcept;
+
+  /// \brief Record that the message that is processed, see set_trace_id(), was produced from
+  ///        another traced message
+  /// \param[in] input The trace of the input message
+  void link(TraceId input) noexcept;
+
+private:
+  Tracer & m_tracer;
+  StageId m_stage;
+  uint64_t m_begin_ns;
+  TraceId m_trace_id{0U};
+  bool8_t m_has_trace_id{false};
+};
+}  // namespace latency_tracing
+}  // namespace common
+}  // namespace autoware
+
+#endif  // LATENCY_TRACING__TRACER_HPP_
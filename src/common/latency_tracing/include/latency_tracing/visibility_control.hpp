@@ -0,0 +1,38 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef LATENCY_TRACING__VISIBILITY_CONTROL_HPP_
+#define LATENCY_TRACING__VISIBILITY_CONTROL_HPP_
+
+////////////////////////////////////////////////////////////////////////////////
+#if defined(__WIN32)
+  #if defined(LATENCY_TRACING_BUILDING_DLL) || defined(LATENCY_TRACING_EXPORTS)
+    #define LATENCY_TRACING_PUBLIC __declspec(dllexport)
+    #define LATENCY_TRACING_LOCAL
+  #else  // defined(LATENCY_TRACING_BUILDING_DLL) || defined(LATENCY_TRACING_EXPORTS)
+    #define LATENCY_TRACING_PUBLIC __declspec(dllimport)
+    #define LATENCY_TRACING_LOCAL
+  #endif  // defined(LATENCY_TRACING_BUILDING_DLL) || defined(LATENCY_TRACING_EXPORTS)
+#elif defined(__linux__)
+  #define LATENCY_TRACING_PUBLIC __attribute__((visibility("default")))
+  #define LATENCY_TRACING_LOCAL __attribute__((visibility("hidden")))
+#elif defined(__APPLE__)
+  #define LATENCY_TRACING_PUBLIC __attribute__((visibility("default")))
+  #define LATENCY_TRACING_LOCAL __attribute__((visibility("hidden")))
+#else  // defined(__linux__)
+  #error "Unsupported Build Configuration"
+#endif  // defined(__WIN32)
+
+#endif  // LATENCY_TRACING__VISIBILITY_CONTROL_HPP_
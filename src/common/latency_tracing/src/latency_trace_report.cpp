@@ -0,0 +1,70 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief Prints the latency breakdown of the trace files of a run
+
+#include <latency_tracing/trace_analysis.hpp>
+
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+using autoware::common::latency_tracing::LatencyStatistics;
+
+void print_row(const std::string & name, const LatencyStatistics & statistics)
+{
+  std::cout << "  " << std::left << std::setw(40) << name << std::right << std::setw(8) <<
+    statistics.count << std::fixed << std::setprecision(3) <<
+    std::setw(10) << statistics.mean << std::setw(10) << statistics.p50 <<
+    std::setw(10) << statistics.p99 << std::setw(10) << statistics.max << "\n";
+}
+}  // namespace
+
+int32_t main(const int32_t argc, char ** const argv)
+{
+  namespace latency_tracing = autoware::common::latency_tracing;
+  if (argc < 2) {
+    std::cerr << "Usage: latency_trace_report <trace file>...\n"
+      "Prints the latencies of the stages of the traced messages in milliseconds, e.g. of\n"
+      "${LATENCY_TRACE_DIR}/latency_trace_*.bin of one run\n";
+    return 1;
+  }
+  try {
+    std::vector<latency_tracing::TraceRecording> recordings;
+    for (int32_t idx = 1; idx < argc; ++idx) {
+      recordings.push_back(latency_tracing::read_recording(argv[idx]));
+    }
+    const auto breakdown = latency_tracing::analyze(recordings);
+
+    std::cout << "  " << std::left << std::setw(40) << "latency [ms]" << std::right <<
+      std::setw(8) << "count" << std::setw(10) << "mean" << std::setw(10) << "p50" <<
+      std::setw(10) << "p99" << std::setw(10) << "max" << "\n";
+    for (const auto & stage : breakdown.stages) {
+      if (0U != stage.queue.count) {
+        print_row(stage.stage + " (queue)", stage.queue);
+      }
+      print_row(stage.stage, stage.processing);
+    }
+    print_row("end to end", breakdown.end_to_end);
+  } catch (const std::exception & e) {
+    std::cerr << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
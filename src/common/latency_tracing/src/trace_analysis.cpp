@@ -0,0 +1,253 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "latency_tracing/trace_analysis.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace autoware
+{
+namespace common
+{
+namespace latency_tracing
+{
+using autoware::common::types::bool8_t;
+
+namespace
+{
+/// A span with the stage identified across all recordings
+struct Span
+{
+  TraceId trace_id;
+  std::size_t stage;
+  uint64_t begin_ns;
+  uint64_t end_ns;
+};
+
+/// Joins the traces that are linked, with path compression
+class TraceSets
+{
+public:
+  TraceId find(const TraceId trace_id)
+  {
+    const auto it = m_parents.find(trace_id);
+    if ((it == m_parents.end()) || (it->second == trace_id)) {
+      return trace_id;
+    }
+    // Finding doesn't insert, so the iterator stays valid
+    const auto root = find(it->second);
+    it->second = root;
+    return root;
+  }
+
+  void join(const TraceId a, const TraceId b)
+  {
+    const auto root_a = find(a);
+    const auto root_b = find(b);
+    if (root_a != root_b) {
+      m_parents[root_b] = root_a;
+    }
+  }
+
+private:
+  std::unordered_map<TraceId, TraceId> m_parents{};
+};
+
+int64_t difference_ns(const uint64_t later_ns, const uint64_t earlier_ns) noexcept
+{
+  return static_cast<int64_t>(later_ns) - static_cast<int64_t>(earlier_ns);
+}
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+LatencyStatistics compute_statistics(std::vector<int64_t> samples_ns)
+{
+  LatencyStatistics ret{};
+  if (samples_ns.empty()) {
+    return ret;
+  }
+  std::sort(samples_ns.begin(), samples_ns.end());
+  const auto to_ms = [](const int64_t value_ns) {
+      return static_cast<float64_t>(value_ns) * 1.0e-6;
+    };
+  // Nearest rank percentiles
+  const auto percentile = [&samples_ns, &to_ms](const float64_t fraction) {
+      const auto rank = static_cast<std::size_t>(
+        std::ceil(fraction * static_cast<float64_t>(samples_ns.size())));
+      return to_ms(samples_ns[std::max(rank, std::size_t{1U}) - 1U]);
+    };
+  float64_t sum{0.0};
+  for (const auto sample : samples_ns) {
+    sum += to_ms(sample);
+  }
+  ret.count = samples_ns.size();
+  ret.mean = sum / static_cast<float64_t>(samples_ns.size());
+  ret.p50 = percentile(0.5);
+  ret.p99 = percentile(0.99);
+  ret.max = to_ms(samples_ns.back());
+  return ret;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TraceRecording read_recording(const std::string & file_name)
+{
+  std::ifstream file{file_name, std::ios::binary};
+  if (!file) {
+    throw std::runtime_error{"read_recording: can't open " + file_name};
+  }
+  char magic[sizeof(kTraceFileMagic) - 1U] = {};
+  if (!file.read(magic, sizeof(magic)) ||
+    (0 != std::memcmp(magic, kTraceFileMagic, sizeof(magic))))
+  {
+    throw std::runtime_error{"read_recording: " + file_name + " isn't a trace file"};
+  }
+
+  TraceRecording ret{};
+  ChunkHeader header{};
+  std::vector<char> payload;
+  while (file.read(reinterpret_cast<char *>(&header), sizeof(header))) {
+    payload.resize(header.size);
+    if (!file.read(payload.data(), static_cast<std::streamsize>(payload.size()))) {
+      break;
+    }
+    if (ChunkType::STAGE == header.type) {
+      if (payload.size() < sizeof(StageId)) {
+        throw std::runtime_error{"read_recording: bad stage in " + file_name};
+      }
+      StageId id{};
+      std::memcpy(&id, payload.data(), sizeof(id));
+      if (ret.stages.size() <= id) {
+        ret.stages.resize(std::size_t{id} + 1U);
+      }
+      ret.stages[id].assign(&payload[sizeof(id)], payload.size() - sizeof(id));
+    } else if (ChunkType::EVENTS == header.type) {
+      if (0U != (payload.size() % sizeof(TraceEvent))) {
+        throw std::runtime_error{"read_recording: bad events in " + file_name};
+      }
+      const auto old_size = ret.events.size();
+      ret.events.resize(old_size + (payload.size() / sizeof(TraceEvent)));
+      std::memcpy(&ret.events[old_size], payload.data(), payload.size());
+    }
+    // Chunks of other types are skipped, they are from a newer version of the format
+  }
+  return ret;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+LatencyBreakdown analyze(const std::vector<TraceRecording> & recordings)
+{
+  // Collect the spans with the stages identified by their names, since the ids are per process
+  std::vector<std::string> stage_names;
+  std::vector<Span> spans;
+  TraceSets traces;
+  for (const auto & recording : recordings) {
+    std::vector<std::size_t> stage_indices;
+    for (const auto & name : recording.stages) {
+      const auto it = std::find(stage_names.begin(), stage_names.end(), name);
+      stage_indices.push_back(static_cast<std::size_t>(std::distance(stage_names.begin(), it)));
+      if (it == stage_names.end()) {
+        stage_names.push_back(name);
+      }
+    }
+    for (const auto & event : recording.events) {
+      if ((0U == event.trace_id) || ((EventKind::LINK == event.kind) && (0U == event.other))) {
+        // Messages without a stamp can't be told apart, so they aren't traced
+        continue;
+      }
+      if (EventKind::LINK == event.kind) {
+        traces.join(event.other, event.trace_id);
+      } else if ((EventKind::SPAN == event.kind) && (event.stage < stage_indices.size())) {
+        spans.push_back({event.trace_id, stage_indices[event.stage], event.time_ns, event.other});
+      }
+    }
+  }
+
+  // The first span of each stage in each joined trace
+  constexpr auto kNone = std::numeric_limits<std::size_t>::max();
+  std::unordered_map<TraceId, std::vector<std::size_t>> first_spans;
+  for (std::size_t idx = 0U; idx < spans.size(); ++idx) {
+    auto & trace = first_spans[traces.find(spans[idx].trace_id)];
+    trace.resize(stage_names.size(), kNone);
+    auto & first = trace[spans[idx].stage];
+    if ((kNone == first) || (spans[idx].begin_ns < spans[first].begin_ns)) {
+      first = idx;
+    }
+  }
+
+  std::vector<std::vector<int64_t>> queue_ns(stage_names.size());
+  std::vector<std::vector<int64_t>> processing_ns(stage_names.size());
+  std::vector<std::vector<int64_t>> offset_ns(stage_names.size());
+  std::vector<int64_t> end_to_end_ns;
+  std::vector<std::size_t> trace_spans;
+  for (const auto & trace : first_spans) {
+    trace_spans.clear();
+    std::copy_if(
+      trace.second.begin(), trace.second.end(), std::back_inserter(trace_spans),
+      [](const std::size_t idx) {return kNone != idx;});
+    std::sort(
+      trace_spans.begin(), trace_spans.end(), [&spans](const std::size_t a, const std::size_t b) {
+        return spans[a].begin_ns < spans[b].begin_ns;
+      });
+    const auto start_ns = spans[trace_spans.front()].begin_ns;
+    uint64_t end_ns{start_ns};
+    for (const auto idx : trace_spans) {
+      const auto & span = spans[idx];
+      // The queue of a stage starts at the latest end of the stages that ended before it began
+      bool8_t has_previous{false};
+      uint64_t previous_end_ns{0U};
+      for (const auto other : trace_spans) {
+        if ((other != idx) && (spans[other].end_ns <= span.begin_ns)) {
+          has_previous = true;
+          previous_end_ns = std::max(previous_end_ns, spans[other].end_ns);
+        }
+      }
+      if (has_previous) {
+        queue_ns[span.stage].push_back(difference_ns(span.begin_ns, previous_end_ns));
+      }
+      processing_ns[span.stage].push_back(difference_ns(span.end_ns, span.begin_ns));
+      offset_ns[span.stage].push_back(difference_ns(span.begin_ns, start_ns));
+      end_ns = std::max(end_ns, span.end_ns);
+    }
+    end_to_end_ns.push_back(difference_ns(end_ns, start_ns));
+  }
+
+  LatencyBreakdown ret{};
+  for (std::size_t stage = 0U; stage < stage_names.size(); ++stage) {
+    if (processing_ns[stage].empty()) {
+      continue;
+    }
+    StageLatency latency{};
+    latency.stage = stage_names[stage];
+    latency.queue = compute_statistics(queue_ns[stage]);
+    latency.processing = compute_statistics(processing_ns[stage]);
+    latency.mean_offset = compute_statistics(offset_ns[stage]).mean;
+    ret.stages.push_back(latency);
+  }
+  std::sort(
+    ret.stages.begin(), ret.stages.end(), [](const StageLatency & a, const StageLatency & b) {
+      return a.mean_offset < b.mean_offset;
+    });
+  ret.end_to_end = compute_statistics(end_to_end_ns);
+  return ret;
+}
+}  // namespace latency_tracing
+}  // namespace common
+}  // namespace autoware
@@ -0,0 +1,86 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "latency_tracing/trace_buffer.hpp"
+
+#include <stdexcept>
+
+namespace autoware
+{
+namespace common
+{
+namespace latency_tracing
+{
+namespace
+{
+std::size_t next_power_of_two(const std::size_t value) noexcept
+{
+  std::size_t ret{1U};
+  while (ret < value) {
+    ret <<= 1U;
+  }
+  return ret;
+}
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+TraceBuffer::TraceBuffer(const std::size_t capacity)
+: m_mask{next_power_of_two(capacity) - 1U}
+{
+  if (0U == capacity) {
+    throw std::domain_error{"TraceBuffer: capacity must be positive"};
+  }
+  m_events.reset(new TraceEvent[m_mask + 1U]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool8_t TraceBuffer::push(const TraceEvent & event) noexcept
+{
+  const auto head = m_head.load(std::memory_order_relaxed);
+  if ((head - m_tail.load(std::memory_order_acquire)) > m_mask) {
+    (void)m_dropped.fetch_add(1U, std::memory_order_relaxed);
+    return false;
+  }
+  m_events[head & m_mask] = event;
+  m_head.store(head + 1U, std::memory_order_release);
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::size_t TraceBuffer::drain(std::vector<TraceEvent> & events)
+{
+  const auto tail = m_tail.load(std::memory_order_relaxed);
+  const auto head = m_head.load(std::memory_order_acquire);
+  events.reserve(events.size() + (head - tail));
+  for (auto idx = tail; idx != head; ++idx) {
+    events.push_back(m_events[idx & m_mask]);
+  }
+  m_tail.store(head, std::memory_order_release);
+  return head - tail;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+uint64_t TraceBuffer::dropped() const noexcept
+{
+  return m_dropped.load(std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::size_t TraceBuffer::capacity() const noexcept
+{
+  return m_mask + 1U;
+}
+}  // namespace latency_tracing
+}  // namespace common
+}  // namespace autoware
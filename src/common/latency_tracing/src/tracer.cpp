@@ -0,0 +1,305 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "latency_tracing/tracer.hpp"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+namespace autoware
+{
+namespace common
+{
+namespace latency_tracing
+{
+namespace
+{
+/// The events of a flush are split into chunks of at most this many events
+constexpr std::size_t kMaxEventsPerChunk = 65536U;
+
+/// The ids of the tracers start at one, so that the empty cache of a thread matches none
+std::atomic<uint64_t> g_next_tracer_id{1U};
+
+/// The buffer that the calling thread used last, so that recording doesn't have to look it up
+struct LocalBuffer
+{
+  uint64_t tracer_id{0U};
+  TraceBuffer * buffer{nullptr};
+};
+thread_local LocalBuffer t_local_buffer{};
+
+std::unique_ptr<Tracer> make_process_tracer()
+{
+  const char * const directory = std::getenv(kTraceDirectoryVariable);
+  if ((nullptr == directory) || ('\0' == directory[0U])) {
+    return std::make_unique<Tracer>();
+  }
+  const auto file_name =
+    std::string{directory} + "/latency_trace_" + std::to_string(::getpid()) + ".bin";
+  return std::make_unique<Tracer>(file_name);
+}
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+Tracer::Tracer()
+: m_enabled{false},
+  m_id{g_next_tracer_id.fetch_add(1U)},
+  m_buffer_capacity{0U}
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Tracer::Tracer(
+  const std::string & file_name,
+  const std::chrono::milliseconds flush_period,
+  const std::size_t buffer_capacity)
+: m_enabled{true},
+  m_id{g_next_tracer_id.fetch_add(1U)},
+  m_buffer_capacity{buffer_capacity},
+  m_file{file_name, std::ios::binary | std::ios::trunc}
+{
+  if (!m_file) {
+    throw std::runtime_error{"Tracer: can't open trace file " + file_name};
+  }
+  (void)m_file.write(kTraceFileMagic, sizeof(kTraceFileMagic) - 1U);
+  m_flush_thread = std::thread{[this, flush_period] {flush_loop(flush_period);}};
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Tracer::~Tracer()
+{
+  if (m_flush_thread.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock{m_mutex};
+      m_stop = true;
+    }
+    m_stop_condition.notify_all();
+    m_flush_thread.join();
+  }
+  if (m_enabled) {
+    try {
+      flush();
+    } catch (...) {
+      // A failed write at shutdown loses the last events, there is no one left to report it to
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Tracer & Tracer::instance()
+{
+  static const std::unique_ptr<Tracer> tracer{make_process_tracer()};
+  return *tracer;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+uint64_t Tracer::now_ns() noexcept
+{
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+           std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool8_t Tracer::enabled() const noexcept
+{
+  return m_enabled;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+StageId Tracer::register_stage(const std::string & name)
+{
+  std::lock_guard<std::mutex> lock{m_mutex};
+  const auto it = std::find(m_stages.begin(), m_stages.end(), name);
+  if (it != m_stages.end()) {
+    return static_cast<StageId>(std::distance(m_stages.begin(), it));
+  }
+  m_stages.push_back(name);
+  return static_cast<StageId>(m_stages.size() - 1U);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Tracer::span(
+  const StageId stage,
+  const TraceId trace_id,
+  const uint64_t begin_ns,
+  const uint64_t end_ns) noexcept
+{
+  TraceEvent event{};
+  event.trace_id = trace_id;
+  event.time_ns = begin_ns;
+  event.other = end_ns;
+  event.stage = stage;
+  event.kind = EventKind::SPAN;
+  record(event);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Tracer::link(const StageId stage, const TraceId input, const TraceId output) noexcept
+{
+  TraceEvent event{};
+  event.trace_id = output;
+  event.time_ns = 0U;
+  event.other = input;
+  event.stage = stage;
+  event.kind = EventKind::LINK;
+  record(event);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Tracer::flush()
+{
+  if (!m_enabled) {
+    return;
+  }
+  std::lock_guard<std::mutex> flush_lock{m_flush_mutex};
+  m_events.clear();
+  std::vector<std::string> new_stages;
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    for (auto & buffer : m_buffers) {
+      (void)buffer.second->drain(m_events);
+    }
+    // The stages are taken after the events: the stage of every drained event was registered
+    // before the event was recorded, so it is written before the event
+    new_stages.assign(
+      std::next(m_stages.begin(), static_cast<std::ptrdiff_t>(m_num_written_stages)),
+      m_stages.end());
+  }
+  for (const auto & name : new_stages) {
+    std::vector<char> payload(sizeof(StageId) + name.size());
+    const auto id = static_cast<StageId>(m_num_written_stages);
+    std::memcpy(payload.data(), &id, sizeof(id));
+    std::memcpy(&payload[sizeof(id)], name.data(), name.size());
+    write_chunk(ChunkType::STAGE, payload.data(), payload.size());
+    ++m_num_written_stages;
+  }
+  for (std::size_t begin = 0U; begin < m_events.size(); begin += kMaxEventsPerChunk) {
+    const auto count = std::min(kMaxEventsPerChunk, m_events.size() - begin);
+    write_chunk(ChunkType::EVENTS, &m_events[begin], count * sizeof(TraceEvent));
+  }
+  (void)m_file.flush();
+  if (!m_file) {
+    throw std::runtime_error{"Tracer: failed to write the trace file"};
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+uint64_t Tracer::dropped() const
+{
+  std::lock_guard<std::mutex> lock{m_mutex};
+  uint64_t ret{0U};
+  for (const auto & buffer : m_buffers) {
+    ret += buffer.second->dropped();
+  }
+  return ret;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TraceBuffer * Tracer::local_buffer() noexcept
+{
+  if (m_id == t_local_buffer.tracer_id) {
+    return t_local_buffer.buffer;
+  }
+  try {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    auto & buffer = m_buffers[std::this_thread::get_id()];
+    if (!buffer) {
+      buffer = std::make_unique<TraceBuffer>(m_buffer_capacity);
+    }
+    t_local_buffer.tracer_id = m_id;
+    t_local_buffer.buffer = buffer.get();
+    return buffer.get();
+  } catch (...) {
+    // Out of memory or a broken mutex, the event is lost but the traced node keeps running
+    return nullptr;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Tracer::record(const TraceEvent & event) noexcept
+{
+  if (!m_enabled) {
+    return;
+  }
+  const auto buffer = local_buffer();
+  if (nullptr != buffer) {
+    (void)buffer->push(event);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Tracer::write_chunk(const ChunkType type, const void * const data, const std::size_t size)
+{
+  ChunkHeader header{};
+  header.type = type;
+  header.size = static_cast<uint32_t>(size);
+  (void)m_file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  (void)m_file.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Tracer::flush_loop(const std::chrono::milliseconds flush_period)
+{
+  std::unique_lock<std::mutex> lock{m_mutex};
+  while (!m_stop) {
+    (void)m_stop_condition.wait_for(lock, flush_period, [this] {return m_stop;});
+    lock.unlock();
+    try {
+      flush();
+    } catch (...) {
+      // The file is broken, the events of the next flushes are lost as well
+    }
+    lock.lock();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TraceScope::TraceScope(Tracer & tracer, const StageId stage) noexcept
+: m_tracer{tracer},
+  m_stage{stage},
+  m_begin_ns{tracer.enabled() ? Tracer::now_ns() : 0U}
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TraceScope::~TraceScope()
+{
+  if (m_has_trace_id && m_tracer.enabled()) {
+    m_tracer.span(m_stage, m_trace_id, m_begin_ns, Tracer::now_ns());
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TraceScope::set_trace_id(const TraceId trace_id) noexcept
+{
+  m_trace_id = trace_id;
+  m_has_trace_id = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TraceScope::link(const TraceId input) noexcept
+{
+  if (m_has_trace_id) {
+    m_tracer.link(m_stage, input, m_trace_id);
+  }
+}
+}  // namespace latency_tracing
+}  // namespace common
+}  // namespace autoware
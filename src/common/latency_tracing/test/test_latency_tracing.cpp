@@ -0,0 +1,290 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <latency_tracing/trace_analysis.hpp>
+#include <latency_tracing/trace_buffer.hpp>
+#include <latency_tracing/tracer.hpp>
+
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using autoware::common::latency_tracing::analyze;
+using autoware::common::latency_tracing::compute_statistics;
+using autoware::common::latency_tracing::EventKind;
+using autoware::common::latency_tracing::read_recording;
+using autoware::common::latency_tracing::StageId;
+using autoware::common::latency_tracing::to_trace_id;
+using autoware::common::latency_tracing::TraceBuffer;
+using autoware::common::latency_tracing::TraceEvent;
+using autoware::common::latency_tracing::TraceId;
+using autoware::common::latency_tracing::Tracer;
+using autoware::common::latency_tracing::TraceRecording;
+using autoware::common::latency_tracing::TraceScope;
+
+namespace
+{
+constexpr uint64_t kMs = 1000000U;
+
+struct Stamp
+{
+  int32_t sec;
+  uint32_t nanosec;
+};
+
+std::string temporary_file_name(const std::string & name)
+{
+  return "/tmp/" + name + "_" + std::to_string(::getpid()) + ".bin";
+}
+
+TraceEvent make_span(
+  const StageId stage, const TraceId trace_id, const uint64_t begin_ms,
+  const uint64_t end_ms)
+{
+  TraceEvent event{};
+  event.trace_id = trace_id;
+  event.time_ns = begin_ms * kMs;
+  event.other = end_ms * kMs;
+  event.stage = stage;
+  event.kind = EventKind::SPAN;
+  return event;
+}
+
+TraceEvent make_link(const StageId stage, const TraceId input, const TraceId output)
+{
+  TraceEvent event{};
+  event.trace_id = output;
+  event.other = input;
+  event.stage = stage;
+  event.kind = EventKind::LINK;
+  return event;
+}
+}  // namespace
+
+TEST(TestTraceId, FromStamp)
+{
+  EXPECT_EQ(to_trace_id(Stamp{12, 345U}), 12000000345U);
+}
+
+TEST(TestTraceBuffer, DropsWhenFull)
+{
+  EXPECT_THROW(TraceBuffer{0U}, std::domain_error);
+  TraceBuffer buffer{3U};
+  ASSERT_EQ(buffer.capacity(), 4U);
+  for (uint64_t idx = 0U; idx < 4U; ++idx) {
+    EXPECT_TRUE(buffer.push(make_span(0U, idx + 1U, idx, idx + 1U)));
+  }
+  EXPECT_FALSE(buffer.push(make_span(0U, 5U, 4U, 5U)));
+  EXPECT_EQ(buffer.dropped(), 1U);
+
+  std::vector<TraceEvent> events;
+  EXPECT_EQ(buffer.drain(events), 4U);
+  ASSERT_EQ(events.size(), 4U);
+  for (uint64_t idx = 0U; idx < 4U; ++idx) {
+    EXPECT_EQ(events[idx].trace_id, idx + 1U);
+  }
+  // The drained space is reused
+  EXPECT_TRUE(buffer.push(make_span(0U, 6U, 5U, 6U)));
+  EXPECT_EQ(buffer.drain(events), 1U);
+  EXPECT_EQ(events.back().trace_id, 6U);
+}
+
+TEST(TestTraceBuffer, ConcurrentDrain)
+{
+  constexpr uint64_t kCount = 10000U;
+  TraceBuffer buffer{64U};
+  std::atomic<bool> done{false};
+  std::thread producer{[&buffer, &done] {
+      for (uint64_t idx = 1U; idx <= kCount; ++idx) {
+        while (!buffer.push(make_span(0U, idx, idx, idx))) {
+          std::this_thread::yield();
+        }
+      }
+      done = true;
+    }};
+  std::vector<TraceEvent> events;
+  while (!done) {
+    (void)buffer.drain(events);
+    std::this_thread::yield();
+  }
+  (void)buffer.drain(events);
+  producer.join();
+  ASSERT_EQ(events.size(), kCount);
+  for (uint64_t idx = 0U; idx < kCount; ++idx) {
+    ASSERT_EQ(events[idx].trace_id, idx + 1U);
+  }
+}
+
+TEST(TestTracer, Disabled)
+{
+  Tracer tracer{};
+  EXPECT_FALSE(tracer.enabled());
+  const auto stage = tracer.register_stage("a");
+  {
+    TraceScope scope{tracer, stage};
+    scope.set_trace_id(1U);
+  }
+  tracer.flush();
+  EXPECT_EQ(tracer.dropped(), 0U);
+}
+
+TEST(TestTracer, BadFile)
+{
+  EXPECT_THROW(Tracer{"/nonexistent/directory/trace.bin"}, std::runtime_error);
+  EXPECT_THROW(read_recording("/nonexistent/directory/trace.bin"), std::runtime_error);
+}
+
+TEST(TestTracer, RoundTrip)
+{
+  const auto file_name = temporary_file_name("latency_tracing_round_trip");
+  {
+    Tracer tracer{file_name, std::chrono::milliseconds{1}};
+    EXPECT_EQ(tracer.register_stage("a"), 0U);
+    EXPECT_EQ(tracer.register_stage("b"), 1U);
+    EXPECT_EQ(tracer.register_stage("a"), 0U);
+    // Record from several threads while the flush thread is draining
+    std::vector<std::thread> threads;
+    for (StageId stage = 0U; stage < 2U; ++stage) {
+      threads.emplace_back(
+        [&tracer, stage] {
+          for (TraceId trace_id = 1U; trace_id <= 1000U; ++trace_id) {
+            TraceScope scope{tracer, stage};
+            scope.set_trace_id(trace_id);
+            if (1U == stage) {
+              scope.link(trace_id + 1000U);
+            }
+          }
+        });
+    }
+    for (auto & thread : threads) {
+      thread.join();
+    }
+    tracer.span(tracer.register_stage("c"), 7U, 10U, 20U);
+    EXPECT_EQ(tracer.dropped(), 0U);
+  }
+  const auto recording = read_recording(file_name);
+  (void)std::remove(file_name.c_str());
+  ASSERT_EQ(recording.stages, (std::vector<std::string>{"a", "b", "c"}));
+  std::size_t num_spans[3U] = {0U, 0U, 0U};
+  std::size_t num_links{0U};
+  for (const auto & event : recording.events) {
+    ASSERT_LT(event.stage, 3U);
+    if (EventKind::SPAN == event.kind) {
+      EXPECT_LE(event.time_ns, event.other);
+      ++num_spans[event.stage];
+    } else {
+      EXPECT_EQ(event.other, event.trace_id + 1000U);
+      ++num_links;
+    }
+  }
+  EXPECT_EQ(num_spans[0U], 1000U);
+  EXPECT_EQ(num_spans[1U], 1000U);
+  EXPECT_EQ(num_spans[2U], 1U);
+  EXPECT_EQ(num_links, 1000U);
+}
+
+TEST(TestTracer, TruncatedFile)
+{
+  const auto file_name = temporary_file_name("latency_tracing_truncated");
+  {
+    Tracer tracer{file_name};
+    tracer.span(tracer.register_stage("a"), 1U, 10U, 20U);
+  }
+  {
+    // A trailing chunk header without its payload, as if the process died while writing
+    std::ofstream file{file_name, std::ios::binary | std::ios::app};
+    const uint32_t header[2U] = {2U, 32U};
+    (void)file.write(reinterpret_cast<const char *>(header), sizeof(header));
+  }
+  const auto recording = read_recording(file_name);
+  (void)std::remove(file_name.c_str());
+  ASSERT_EQ(recording.stages.size(), 1U);
+  ASSERT_EQ(recording.events.size(), 1U);
+  EXPECT_EQ(recording.events[0U].trace_id, 1U);
+}
+
+TEST(TestAnalysis, Statistics)
+{
+  EXPECT_EQ(compute_statistics({}).count, 0U);
+  const auto statistics = compute_statistics({4000000, 1000000, 3000000, 2000000});
+  EXPECT_EQ(statistics.count, 4U);
+  EXPECT_DOUBLE_EQ(statistics.mean, 2.5);
+  EXPECT_DOUBLE_EQ(statistics.p50, 2.0);
+  EXPECT_DOUBLE_EQ(statistics.p99, 4.0);
+  EXPECT_DOUBLE_EQ(statistics.max, 4.0);
+}
+
+// A driver and a filter in one process, a planner that restamps and a controller that follows
+// the plan for several cycles in another one
+TEST(TestAnalysis, Breakdown)
+{
+  TraceRecording perception{};
+  perception.stages = {"driver", "filter"};
+  TraceRecording planning{};
+  planning.stages = {"controller", "planner"};
+  for (uint64_t idx = 0U; idx < 10U; ++idx) {
+    const auto cloud = 1000U + idx;
+    const auto plan = 2000U + idx;
+    const auto t0 = idx * 100U;
+    perception.events.push_back(make_span(0U, cloud, t0, t0 + 2U));
+    perception.events.push_back(make_span(1U, cloud, t0 + 3U, t0 + 3U + idx));
+    planning.events.push_back(make_span(1U, plan, t0 + 20U, t0 + 30U));
+    planning.events.push_back(make_link(1U, cloud, plan));
+    for (uint64_t cycle = 0U; cycle < 3U; ++cycle) {
+      const auto begin = t0 + 35U + (cycle * 30U);
+      planning.events.push_back(make_span(0U, plan, begin, begin + 1U));
+    }
+  }
+  // Unstamped messages are ignored
+  perception.events.push_back(make_span(0U, 0U, 0U, 1000U));
+
+  const auto breakdown = analyze({planning, perception});
+  ASSERT_EQ(breakdown.stages.size(), 4U);
+  EXPECT_EQ(breakdown.stages[0U].stage, "driver");
+  EXPECT_EQ(breakdown.stages[1U].stage, "filter");
+  EXPECT_EQ(breakdown.stages[2U].stage, "planner");
+  EXPECT_EQ(breakdown.stages[3U].stage, "controller");
+
+  const auto & driver = breakdown.stages[0U];
+  EXPECT_EQ(driver.queue.count, 0U);
+  EXPECT_EQ(driver.processing.count, 10U);
+  EXPECT_DOUBLE_EQ(driver.processing.mean, 2.0);
+  const auto & filter = breakdown.stages[1U];
+  EXPECT_DOUBLE_EQ(filter.queue.mean, 1.0);
+  // 0 to 9 ms
+  EXPECT_DOUBLE_EQ(filter.processing.mean, 4.5);
+  EXPECT_DOUBLE_EQ(filter.processing.p50, 4.0);
+  EXPECT_DOUBLE_EQ(filter.processing.p99, 9.0);
+  EXPECT_DOUBLE_EQ(filter.processing.max, 9.0);
+  const auto & planner = breakdown.stages[2U];
+  // 8 to 17 ms
+  EXPECT_DOUBLE_EQ(planner.queue.p50, 12.0);
+  EXPECT_DOUBLE_EQ(planner.processing.mean, 10.0);
+  EXPECT_DOUBLE_EQ(planner.mean_offset, 20.0);
+  const auto & controller = breakdown.stages[3U];
+  EXPECT_EQ(controller.processing.count, 10U);
+  EXPECT_DOUBLE_EQ(controller.queue.mean, 5.0);
+  EXPECT_DOUBLE_EQ(controller.processing.mean, 1.0);
+  EXPECT_EQ(breakdown.end_to_end.count, 10U);
+  EXPECT_DOUBLE_EQ(breakdown.end_to_end.mean, 36.0);
+}
@@ -0,0 +1,125 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief A compressed representation of point clouds, e.g. to record them with less bandwidth
+
+#ifndef LIDAR_UTILS__POINT_CLOUD_CODEC_HPP_
+#define LIDAR_UTILS__POINT_CLOUD_CODEC_HPP_
+
+#include <lidar_utils/visibility_control.hpp>
+
+#include <common/types.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace autoware
+{
+namespace common
+{
+namespace lidar_utils
+{
+using autoware::common::types::bool8_t;
+using autoware::common::types::float32_t;
+
+/// \brief Name of the single uint8 field of a compressed cloud
+constexpr const char * COMPRESSED_CLOUD_FIELD = "point_cloud_codec";
+
+/// \brief Quantization of the PointCloudEncoder
+struct LIDAR_UTILS_PUBLIC PointCloudCodecConfig
+{
+  /// Step that x, y and z are rounded to, 0 keeps them exactly
+  float32_t xyz_resolution_m{0.001F};
+  /// Step that the intensity is rounded to, 0 keeps it exactly. The default keeps the integer
+  /// intensities of the Velodyne driver
+  float32_t intensity_resolution{1.0F};
+};
+
+/// \brief Check if a point cloud is the output of a PointCloudEncoder
+/// \param[in] cloud the point cloud to check
+/// \return true if the cloud has the single field of a compressed cloud
+LIDAR_UTILS_PUBLIC bool8_t is_compressed_cloud(const sensor_msgs::msg::PointCloud2 & cloud);
+
+/// \brief Compresses the x, y, z, intensity and id fields of point clouds.
+///
+/// Each value is quantized and predicted from the point at the same position in the previous
+/// firing, i.e. the run of points with the same id, so that the residuals of the rings are
+/// small. Clouds without id are predicted from the previous point. The residuals of each field
+/// are entropy coded with their own frequencies. The result is a PointCloud2 with the header of
+/// the input and the bytes in the single uint8 field COMPRESSED_CLOUD_FIELD, so that it can be
+/// recorded like any other cloud. All other fields of the input are dropped.
+class LIDAR_UTILS_PUBLIC PointCloudEncoder
+{
+public:
+  /// \brief Constructor
+  /// \param[in] config quantization of the values
+  /// \throw std::domain_error if a resolution is negative or not finite
+  explicit PointCloudEncoder(const PointCloudCodecConfig & config);
+
+  /// \brief Compress a point cloud. The buffers of the encoder and the data of the output are
+  /// reused, so a cloud of a size that was seen before is compressed without allocating.
+  /// \param[in] cloud the cloud to compress, with float32 x, y and z. A float32 intensity and
+  /// a uint16 id are kept if the cloud has them.
+  /// \param[out] compressed the compressed cloud
+  /// \throw std::runtime_error if the cloud is malformed, or a quantized value doesn't fit
+  void encode(
+    const sensor_msgs::msg::PointCloud2 & cloud,
+    sensor_msgs::msg::PointCloud2 & compressed);
+
+private:
+  const PointCloudCodecConfig m_config;
+  /// The quantized x, y, z and intensity of the points
+  std::array<std::vector<int64_t>, 4U> m_codes;
+  /// The ids of the points
+  std::vector<uint16_t> m_ids;
+  /// The varint coded residuals of each field, the last one is the id
+  std::array<std::vector<uint8_t>, 5U> m_symbols;
+  /// The entropy coder writes backwards into this buffer
+  std::vector<uint8_t> m_coded;
+};
+
+/// \brief Restores the point clouds compressed by a PointCloudEncoder
+class LIDAR_UTILS_PUBLIC PointCloudDecoder
+{
+public:
+  /// \brief Restore a point cloud. Clouds with id get the layout of init_pcl_msg_with_id, the
+  /// others the layout of init_pcl_msg, with an intensity of 0 if it wasn't encoded. The output
+  /// is only reinitialized if its layout changes, so its memory is reused.
+  /// \param[in] compressed the compressed cloud
+  /// \param[out] cloud the restored cloud with the header of the compressed cloud
+  /// \throw std::runtime_error if the data isn't a complete compressed cloud
+  void decode(
+    const sensor_msgs::msg::PointCloud2 & compressed,
+    sensor_msgs::msg::PointCloud2 & cloud);
+
+private:
+  /// The decoded varints of each field, the last one is the id
+  std::array<std::vector<uint8_t>, 5U> m_symbols;
+  /// The ids of the points
+  std::vector<uint16_t> m_ids;
+  /// The decoded points
+  std::vector<autoware::common::types::PointXYZIF> m_points;
+  /// The quantized x, y, z and intensity of the points, to predict the following ones
+  std::array<std::vector<int64_t>, 4U> m_codes;
+};
+
+}  // namespace lidar_utils
+}  // namespace common
+}  // namespace autoware
+
+#endif  // LIDAR_UTILS__POINT_CLOUD_CODEC_HPP_
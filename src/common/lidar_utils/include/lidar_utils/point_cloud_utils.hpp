@@ -33,6 +33,7 @@
 #include <Eigen/Geometry>
 
 #include <atomic>
+#include <cstddef>
 #include <limits>
 #include <memory>
 #include <string>
@@ -166,6 +167,22 @@ LIDAR_UTILS_PUBLIC void init_pcl_msg(
   modifier.resize(size);
 }
 
+/// \brief initializes a point cloud for x, y, z, intensity and the uint16 id of a point, with
+/// the memory layout of PointXYZIF including its padding. Points can then be added with
+/// add_point_to_cloud_raw and read back by reinterpreting the data, id included.
+/// \param[out] msg a point cloud message to initialize
+/// \param[in] frame_id the name of the frame for the point cloud (assumed fixed)
+/// \param[in] size number of points to preallocate for underyling data array
+LIDAR_UTILS_PUBLIC void init_pcl_msg_with_id(
+  sensor_msgs::msg::PointCloud2 & msg,
+  const std::string & frame_id,
+  const std::size_t size = static_cast<std::size_t>(MAX_SCAN_POINTS));
+
+/// \brief Check if a point cloud has the layout made by init_pcl_msg_with_id
+/// \param[in] cloud the point cloud to check
+/// \return true if the points of the cloud are laid out like PointXYZIF, id included
+LIDAR_UTILS_PUBLIC bool8_t has_pointxyzif_layout(const sensor_msgs::msg::PointCloud2 & cloud);
+
 /// \brief add a point in the cloud by memcpy instead of using iterators
 /// This version prioritize speed and ease of parallelisation
 /// it assumes : - PointXYZIF is a POD object equivalent to a point stored in the cloud,
@@ -177,6 +194,20 @@ LIDAR_UTILS_PUBLIC bool8_t add_point_to_cloud_raw(
   const autoware::common::types::PointXYZIF & pt,
   uint32_t point_cloud_idx);
 
+/// \brief add a run of points in the cloud by memcpy, as many as fit. When the cloud is laid out
+/// like PointXYZIF, as made by init_pcl_msg_with_id, the run is copied at once. Otherwise the
+/// leading point_step bytes of each point are copied, which is the layout made by init_pcl_msg.
+/// \param[inout] cloud the point cloud to add the points to
+/// \param[in] points the points to add
+/// \param[in] num_points number of points to add
+/// \param[inout] point_cloud_idx index of the first point to write, advanced past the added points
+/// \return number of points added, smaller than num_points if the cloud is full
+LIDAR_UTILS_PUBLIC std::size_t add_points_to_cloud_raw(
+  sensor_msgs::msg::PointCloud2 & cloud,
+  const autoware::common::types::PointXYZIF * const points,
+  const std::size_t num_points,
+  uint32_t & point_cloud_idx);
+
 LIDAR_UTILS_PUBLIC bool8_t add_point_to_cloud(
   PointCloudIts & cloud_its,
   const autoware::common::types::PointXYZIF & pt,
@@ -192,6 +223,12 @@ LIDAR_UTILS_PUBLIC bool8_t add_point_to_cloud(
   const autoware::common::types::PointXYZF & pt,
   uint32_t & point_cloud_idx);
 
+/// \brief Reset a point cloud to be filled again from its first point. The cloud keeps its
+/// memory, so a preallocated cloud is reused without allocating. The previous points are left in
+/// place until they are overwritten.
+/// \param[inout] msg the point cloud to reset
+/// \param[in] size number of points the cloud is resized to
+/// \param[out] point_cloud_idx the index of the next point to add, set to 0
 LIDAR_UTILS_PUBLIC void reset_pcl_msg(
   sensor_msgs::msg::PointCloud2 & msg,
   const std::size_t size,
@@ -201,6 +238,16 @@ LIDAR_UTILS_PUBLIC void resize_pcl_msg(
   sensor_msgs::msg::PointCloud2 & msg,
   const std::size_t new_size);
 
+/// \brief Move a point cloud into a new message and reinitialize the cloud with the same frame
+/// id and fields, so it can be filled again. Used to publish a preallocated cloud as a
+/// `std::unique_ptr`, which intra-process communication passes on without copying it.
+/// \param[inout] msg the point cloud to release. It is reset to the given capacity.
+/// \param[in] size number of points to preallocate for the reinitialized cloud
+/// \return the released point cloud
+LIDAR_UTILS_PUBLIC std::unique_ptr<sensor_msgs::msg::PointCloud2> release_pcl_msg(
+  sensor_msgs::msg::PointCloud2 & msg,
+  const std::size_t size);
+
 /// \brief Get cluster from clusters based on the cluster id
 /// \param[in] clusters The clusters object
 /// \param[in] cls_id The id of the target cluster
@@ -342,6 +389,18 @@ public:
            comp::abs_lte(pt_radius, m_max_r2, FEPS);
   }
 
+  /// \brief Check a batch of points stored as separate coordinate arrays. Same result as
+  /// operator() for each point, but without branches so that the compiler can vectorize the loop.
+  /// \param x X coordinates of the points
+  /// \param y Y coordinates of the points
+  /// \param z Z coordinates of the points
+  /// \param size Number of points
+  /// \param keep Cleared for the points outside of the range and unchanged for the others, so
+  /// that several filters can be applied to the same mask
+  void apply(
+    const float32_t * x, const float32_t * y, const float32_t * z, std::size_t size,
+    uint8_t * keep) const;
+
 private:
   float32_t m_min_r2;
   float32_t m_max_r2;
@@ -375,6 +434,45 @@ public:
     zr_(out) = out_mat[2];
   }
 
+  /// \brief Apply the transform to a batch of points stored as separate coordinate arrays. The
+  /// points do not depend on each other, so the compiler can vectorize the loop where it's inlined
+  /// into a caller that owns the arrays.
+  /// \param x_in X coordinates of the input points
+  /// \param y_in Y coordinates of the input points
+  /// \param z_in Z coordinates of the input points
+  /// \param size Number of points
+  /// \param x_out X coordinates of the output points, may be the same array as x_in
+  /// \param y_out Y coordinates of the output points, may be the same array as y_in
+  /// \param z_out Z coordinates of the output points, may be the same array as z_in
+  void transform(  //NOLINT (false positive: this is not std::transform)
+    const float32_t * const x_in, const float32_t * const y_in, const float32_t * const z_in,
+    const std::size_t size,
+    float32_t * const x_out, float32_t * const y_out, float32_t * const z_out) const
+  {
+    // Copy the coefficients, so that the compiler knows the output does not overwrite them
+    const Eigen::Matrix4f & tf = m_tf.matrix();
+    const float32_t r00 = tf(0, 0);
+    const float32_t r01 = tf(0, 1);
+    const float32_t r02 = tf(0, 2);
+    const float32_t r10 = tf(1, 0);
+    const float32_t r11 = tf(1, 1);
+    const float32_t r12 = tf(1, 2);
+    const float32_t r20 = tf(2, 0);
+    const float32_t r21 = tf(2, 1);
+    const float32_t r22 = tf(2, 2);
+    const float32_t t0 = tf(0, 3);
+    const float32_t t1 = tf(1, 3);
+    const float32_t t2 = tf(2, 3);
+    for (std::size_t i = 0U; i < size; ++i) {
+      const float32_t x = x_in[i];
+      const float32_t y = y_in[i];
+      const float32_t z = z_in[i];
+      x_out[i] = (r00 * x) + (r01 * y) + (r02 * z) + t0;
+      y_out[i] = (r10 * x) + (r11 * y) + (r12 * z) + t1;
+      z_out[i] = (r20 * x) + (r21 * y) + (r22 * z) + t2;
+    }
+  }
+
 private:
   Eigen::Affine3f m_tf;
 };
@@ -429,12 +527,46 @@ public:
     return ret;
   }
 
+  /// \brief Check a batch of points stored as separate coordinate arrays. Same result as
+  /// operator() for each point, but without branches so that the compiler can vectorize the loop.
+  /// \param x X coordinates of the points
+  /// \param y Y coordinates of the points
+  /// \param size Number of points
+  /// \param keep Cleared for the points outside of the range and unchanged for the others, so
+  /// that several filters can be applied to the same mask
+  void apply(const float32_t * x, const float32_t * y, std::size_t size, uint8_t * keep) const;
+
 private:
   VectorT m_range_normal;
   bool8_t m_threshold_negative;
   float32_t m_threshold2;
 };
 
+/// \brief Filter the points of a cloud by azimuth and radius and transform the remaining ones.
+/// The points are processed in blocks that are copied into separate coordinate arrays, so that
+/// the filters and the transform run in loops without branches the compiler can vectorize. The
+/// kept points are written directly into the data of the output cloud.
+/// \param[in] input The cloud to filter, with float32 x, y and z fields, and an optional uint8
+/// or float32 intensity field. Points without intensity get an intensity of 0.
+/// \param[in] angle_filter Filter for the azimuth of the points in the input frame
+/// \param[in] distance_filter Filter for the radius of the points in the input frame
+/// \param[in] transformer Transform from the input frame to the output frame
+/// \param[inout] output The cloud to add the points to, with float32 x, y, z and intensity fields
+/// and a single row, e.g. initialized by init_pcl_msg. Its size is not changed.
+/// \param[inout] point_cloud_idx Index in the output of the next point, advanced for each point
+/// added
+/// \return False if the output had no room for all the kept points. The points that fit are
+/// added.
+/// \throw std::runtime_error If a field is missing or has the wrong type, or the input has less
+/// data than its size
+LIDAR_UTILS_PUBLIC bool8_t filter_and_transform_points(
+  const sensor_msgs::msg::PointCloud2 & input,
+  const AngleFilter & angle_filter,
+  const DistanceFilter & distance_filter,
+  const StaticTransformer & transformer,
+  sensor_msgs::msg::PointCloud2 & output,
+  uint32_t & point_cloud_idx);
+
 class LIDAR_UTILS_PUBLIC IntensityIteratorWrapper
 {
 private:
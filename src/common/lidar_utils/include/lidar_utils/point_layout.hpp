@@ -0,0 +1,235 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+/// \file
+/// \brief This file defines compile-time point layouts and typed views of point clouds
+
+#ifndef LIDAR_UTILS__POINT_LAYOUT_HPP_
+#define LIDAR_UTILS__POINT_LAYOUT_HPP_
+
+#include <common/types.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace autoware
+{
+namespace common
+{
+namespace lidar_utils
+{
+using autoware::common::types::bool8_t;
+using autoware::common::types::char8_t;
+
+/// \brief Name, offset and datatype of a field of a point type
+struct PointFieldLayout
+{
+  const char8_t * name;
+  uint32_t offset;
+  uint8_t datatype;
+};
+
+/// \brief Size in bytes of a sensor_msgs::msg::PointField datatype, 0 if it is unknown
+constexpr uint32_t size_of_datatype(const uint8_t datatype)
+{
+  using sensor_msgs::msg::PointField;
+  return ((datatype == PointField::INT8) || (datatype == PointField::UINT8)) ? 1U :
+         ((datatype == PointField::INT16) || (datatype == PointField::UINT16)) ? 2U :
+         ((datatype == PointField::INT32) || (datatype == PointField::UINT32) ||
+         (datatype == PointField::FLOAT32)) ? 4U :
+         (datatype == PointField::FLOAT64) ? 8U : 0U;
+}
+
+/// \brief Compile-time layout of a point type. A specialization defines NUM_FIELDS and a
+/// constexpr fields() returning the fields in the order in which they are required.
+/// \tparam PointT The point type, it must be trivially copyable
+template<typename PointT>
+struct PointLayout;
+
+template<>
+struct PointLayout<autoware::common::types::PointXYZIF>
+{
+  using PointT = autoware::common::types::PointXYZIF;
+  static constexpr std::size_t NUM_FIELDS = 5U;
+  static constexpr std::array<PointFieldLayout, NUM_FIELDS> fields()
+  {
+    using sensor_msgs::msg::PointField;
+    return {{
+      {"x", static_cast<uint32_t>(offsetof(PointT, x)), PointField::FLOAT32},
+      {"y", static_cast<uint32_t>(offsetof(PointT, y)), PointField::FLOAT32},
+      {"z", static_cast<uint32_t>(offsetof(PointT, z)), PointField::FLOAT32},
+      {"intensity", static_cast<uint32_t>(offsetof(PointT, intensity)), PointField::FLOAT32},
+      {"id", static_cast<uint32_t>(offsetof(PointT, id)), PointField::UINT16}}};
+  }
+};
+
+template<>
+struct PointLayout<autoware::common::types::PointXYZI>
+{
+  using PointT = autoware::common::types::PointXYZI;
+  static constexpr std::size_t NUM_FIELDS = 4U;
+  static constexpr std::array<PointFieldLayout, NUM_FIELDS> fields()
+  {
+    using sensor_msgs::msg::PointField;
+    return {{
+      {"x", static_cast<uint32_t>(offsetof(PointT, x)), PointField::FLOAT32},
+      {"y", static_cast<uint32_t>(offsetof(PointT, y)), PointField::FLOAT32},
+      {"z", static_cast<uint32_t>(offsetof(PointT, z)), PointField::FLOAT32},
+      {"intensity", static_cast<uint32_t>(offsetof(PointT, intensity)), PointField::FLOAT32}}};
+  }
+};
+
+/// \brief Typed read-only view of the points of a point cloud. The fields of the cloud are
+/// matched once against PointLayout<PointT> on construction; reading a point is then a fixed
+/// list of memcpy at known offsets, without a lookup or a switch on the datatype. When the cloud
+/// is laid out like PointT, as clouds made by init_pcl_msg are, this list is a single memcpy.
+/// Fields of the layout that the cloud does not have, or has with another datatype, are left to
+/// the default value of PointT.
+/// \tparam PointT The point type, with a specialization of PointLayout
+template<typename PointT>
+class PointCloudView
+{
+  static_assert(std::is_trivially_copyable<PointT>::value, "PointT must be trivially copyable");
+  using Layout = PointLayout<PointT>;
+
+public:
+  /// \brief Validate the layout of a cloud
+  /// \param[in] cloud The point cloud to view, it must outlive the view
+  /// \param[in] num_required_fields Number of leading fields of the layout the cloud must have
+  /// \param[in] num_fields Number of leading fields of the layout to read if the cloud has them,
+  /// the others are left to their default value. The required fields are always read.
+  /// \throw std::runtime_error If a required field is missing, or the cloud is malformed
+  explicit PointCloudView(
+    const sensor_msgs::msg::PointCloud2 & cloud,
+    const std::size_t num_required_fields = Layout::NUM_FIELDS,
+    const std::size_t num_fields = Layout::NUM_FIELDS)
+  : m_data{cloud.data.data()},
+    m_point_step{cloud.point_step},
+    m_size{static_cast<std::size_t>(cloud.width) * static_cast<std::size_t>(cloud.height)}
+  {
+    const std::size_t row_size = static_cast<std::size_t>(cloud.width) * cloud.point_step;
+    if ((cloud.height > 1U) && (cloud.row_step != row_size)) {
+      throw std::runtime_error("PointCloud rows are not contiguous");
+    }
+    if (cloud.data.size() < (m_size * cloud.point_step)) {
+      throw std::runtime_error("PointCloud data is smaller than its points");
+    }
+    const auto fields = Layout::fields();
+    std::size_t max_fields =
+      (num_fields > num_required_fields) ? num_fields : num_required_fields;
+    if (max_fields > Layout::NUM_FIELDS) {
+      max_fields = Layout::NUM_FIELDS;
+    }
+    for (std::size_t idx = 0U; idx < max_fields; ++idx) {
+      const auto & layout = fields[idx];
+      const uint32_t size = size_of_datatype(layout.datatype);
+      const auto field_it = std::find_if(
+        cloud.fields.cbegin(), cloud.fields.cend(),
+        [&layout](const sensor_msgs::msg::PointField & field) {
+          return field.name == layout.name;
+        });
+      const bool8_t found = (field_it != cloud.fields.cend()) &&
+        (field_it->datatype == layout.datatype) && (field_it->count == 1U) &&
+        ((static_cast<std::size_t>(field_it->offset) + size) <= cloud.point_step);
+      if (!found) {
+        if (idx < num_required_fields) {
+          throw std::runtime_error(
+                  std::string{"PointCloud doesn't have correct "} + layout.name + " field");
+        }
+        continue;
+      }
+      m_has_field[idx] = true;
+      add_copy(idx, field_it->offset, layout.offset, size);
+    }
+  }
+
+  /// \brief Number of points of the cloud
+  std::size_t size() const noexcept
+  {
+    return m_size;
+  }
+
+  /// \brief Check if a field of the layout is read from the cloud
+  /// \param[in] idx Index of the field in PointLayout<PointT>::fields()
+  bool8_t has_field(const std::size_t idx) const noexcept
+  {
+    return (idx < Layout::NUM_FIELDS) && m_has_field[idx];
+  }
+
+  /// \brief Read a point, idx must be smaller than size()
+  PointT operator[](const std::size_t idx) const noexcept
+  {
+    PointT pt{};
+    //lint -e{925, 9110} Need to convert pointers and use bit for external API NOLINT
+    uint8_t * const dest = reinterpret_cast<uint8_t *>(&pt);
+    const uint8_t * const src = &m_data[idx * m_point_step];
+    for (std::size_t copy_idx = 0U; copy_idx < m_num_copies; ++copy_idx) {
+      const auto & copy = m_copies[copy_idx];
+      (void)std::memcpy(&dest[copy.dest_offset], &src[copy.src_offset], copy.size);
+    }
+    return pt;
+  }
+
+private:
+  /// \brief Append a copy of a field, or extend the previous copy if it is of the previous field
+  /// of the layout and the field follows it at the same distance in the cloud and in the point
+  void add_copy(
+    const std::size_t field_idx, const uint32_t src_offset, const uint32_t dest_offset,
+    const uint32_t size)
+  {
+    if ((m_num_copies > 0U) && ((m_last_field_idx + 1U) == field_idx)) {
+      Copy & last = m_copies[m_num_copies - 1U];
+      if ((dest_offset >= last.dest_offset) && (src_offset >= last.src_offset) &&
+        ((dest_offset - last.dest_offset) == (src_offset - last.src_offset)))
+      {
+        // Also copies the padding between the fields, e.g. between intensity and id
+        last.size = (dest_offset + size) - last.dest_offset;
+        m_last_field_idx = field_idx;
+        return;
+      }
+    }
+    m_copies[m_num_copies] = Copy{src_offset, dest_offset, size};
+    ++m_num_copies;
+    m_last_field_idx = field_idx;
+  }
+
+  struct Copy
+  {
+    uint32_t src_offset;
+    uint32_t dest_offset;
+    uint32_t size;
+  };
+
+  const uint8_t * m_data;
+  std::size_t m_point_step;
+  std::size_t m_size;
+  std::array<Copy, Layout::NUM_FIELDS> m_copies{};
+  std::size_t m_num_copies{0U};
+  std::size_t m_last_field_idx{0U};
+  std::array<bool8_t, Layout::NUM_FIELDS> m_has_field{};
+};
+
+}  // namespace lidar_utils
+}  // namespace common
+}  // namespace autoware
+
+#endif  // LIDAR_UTILS__POINT_LAYOUT_HPP_
@@ -0,0 +1,520 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lidar_utils/point_cloud_codec.hpp"
+#include "lidar_utils/point_cloud_utils.hpp"
+#include "lidar_utils/point_layout.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace autoware
+{
+namespace common
+{
+namespace lidar_utils
+{
+namespace
+{
+using autoware::common::types::float64_t;
+using autoware::common::types::PointXYZIF;
+
+/// The data starts with "APC" and the version of the format
+constexpr std::array<uint8_t, 4U> kMagic{{0x41U, 0x50U, 0x43U, 0x01U}};
+constexpr uint8_t kHasIntensity = 0x01U;
+constexpr uint8_t kHasId = 0x02U;
+/// x, y, z and intensity are quantized, the id is coded as is
+constexpr std::size_t kNumValueFields = 4U;
+constexpr std::size_t kIdField = 4U;
+/// A varint of an int64 has at most 10 bytes
+constexpr std::size_t kMaxVarintSize = 10U;
+/// Quantized values are exact integers in a float64
+constexpr float64_t kMaxQuantized = 4503599627370496.0;
+
+/// The frequencies of the byte-wise rANS coder sum up to kScale
+constexpr uint32_t kScaleBits = 12U;
+constexpr uint32_t kScale = 1U << kScaleBits;
+/// Lower bound of the coder state, which is renormalized one byte at a time
+constexpr uint32_t kRansLow = 1U << 23U;
+constexpr std::size_t kNumSymbols = 256U;
+using Frequencies = std::array<uint32_t, kNumSymbols>;
+
+/// Reads the data of a compressed cloud, and throws instead of reading past its end
+class Reader
+{
+public:
+  Reader(const uint8_t * const data, const std::size_t size)
+  : m_data{data}, m_size{size} {}
+
+  uint8_t byte()
+  {
+    if (m_pos >= m_size) {
+      throw std::runtime_error{"PointCloudDecoder: the compressed cloud is truncated"};
+    }
+    return m_data[m_pos++];
+  }
+
+  uint64_t varint()
+  {
+    uint64_t value = 0U;
+    for (uint32_t shift = 0U; shift < 64U; shift += 7U) {
+      const auto b = byte();
+      value |= static_cast<uint64_t>(b & 0x7FU) << shift;
+      if ((b & 0x80U) == 0U) {
+        return value;
+      }
+    }
+    throw std::runtime_error{"PointCloudDecoder: malformed varint"};
+  }
+
+  uint32_t u32()
+  {
+    uint32_t value = 0U;
+    for (uint32_t shift = 0U; shift < 32U; shift += 8U) {
+      value |= static_cast<uint32_t>(byte()) << shift;
+    }
+    return value;
+  }
+
+  float32_t f32()
+  {
+    const auto bits = u32();
+    float32_t value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  /// Skip a number of bytes and get a pointer to the first one
+  const uint8_t * take(const uint64_t size)
+  {
+    if (size > (m_size - m_pos)) {
+      throw std::runtime_error{"PointCloudDecoder: the compressed cloud is truncated"};
+    }
+    const auto * const data = &m_data[m_pos];
+    m_pos += static_cast<std::size_t>(size);
+    return data;
+  }
+
+private:
+  const uint8_t * m_data;
+  std::size_t m_size;
+  std::size_t m_pos{0U};
+};
+
+void put_varint(std::vector<uint8_t> & out, uint64_t value)
+{
+  while (value >= 0x80U) {
+    out.push_back(static_cast<uint8_t>(value | 0x80U));
+    value >>= 7U;
+  }
+  out.push_back(static_cast<uint8_t>(value));
+}
+
+void put_u32(std::vector<uint8_t> & out, const uint32_t value)
+{
+  for (uint32_t shift = 0U; shift < 32U; shift += 8U) {
+    out.push_back(static_cast<uint8_t>(value >> shift));
+  }
+}
+
+void put_f32(std::vector<uint8_t> & out, const float32_t value)
+{
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  put_u32(out, bits);
+}
+
+/// Map small residuals of either sign to small unsigned numbers
+uint64_t zigzag(const int64_t value)
+{
+  return (static_cast<uint64_t>(value) << 1U) ^ static_cast<uint64_t>(value >> 63U);
+}
+
+int64_t unzigzag(const uint64_t value)
+{
+  return static_cast<int64_t>(value >> 1U) ^ -static_cast<int64_t>(value & 1U);
+}
+
+int64_t quantize(const float32_t value, const float32_t resolution)
+{
+  if (resolution > 0.0F) {
+    const auto scaled = static_cast<float64_t>(value) / static_cast<float64_t>(resolution);
+    // Also rejects NaN
+    if (!(std::fabs(scaled) < kMaxQuantized)) {
+      throw std::runtime_error{"PointCloudEncoder: a value can't be quantized"};
+    }
+    return std::llround(scaled);
+  }
+  // Order the bits like the values, so that close values get close codes
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return static_cast<int64_t>(((bits & 0x80000000U) != 0U) ? ~bits : (bits | 0x80000000U));
+}
+
+float32_t dequantize(const int64_t code, const float32_t resolution)
+{
+  if (resolution > 0.0F) {
+    return static_cast<float32_t>(static_cast<float64_t>(code) *
+           static_cast<float64_t>(resolution));
+  }
+  const auto ordered = static_cast<uint32_t>(code);
+  const uint32_t bits = ((ordered & 0x80000000U) != 0U) ? (ordered & 0x7FFFFFFFU) : ~ordered;
+  float32_t value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+/// Finds the point that a point is predicted from: the one at the same position in the previous
+/// firing, or the previous point if that firing is shorter
+class ReferenceTracker
+{
+public:
+  static constexpr std::size_t NONE = std::numeric_limits<std::size_t>::max();
+
+  std::size_t next(const std::size_t idx, const bool8_t starts_firing)
+  {
+    if (starts_firing) {
+      m_previous_start = m_start;
+      m_previous_size = idx - m_start;
+      m_start = idx;
+    }
+    const auto position = idx - m_start;
+    if (position < m_previous_size) {
+      return m_previous_start + position;
+    }
+    return (idx > 0U) ? (idx - 1U) : NONE;
+  }
+
+private:
+  std::size_t m_start{0U};
+  std::size_t m_previous_start{0U};
+  std::size_t m_previous_size{0U};
+};
+constexpr std::size_t ReferenceTracker::NONE;
+
+/// Scale the counts of the symbols to sum up to kScale, every symbol that occurs keeps a frequency
+/// of at least 1
+Frequencies normalize(const std::vector<uint8_t> & symbols)
+{
+  std::array<std::size_t, kNumSymbols> counts{};
+  for (const auto symbol : symbols) {
+    ++counts[symbol];
+  }
+  Frequencies frequencies{};
+  uint32_t total = 0U;
+  std::size_t largest = 0U;
+  for (std::size_t symbol = 0U; symbol < kNumSymbols; ++symbol) {
+    if (counts[symbol] == 0U) {
+      continue;
+    }
+    frequencies[symbol] = std::max(
+      1U, static_cast<uint32_t>((counts[symbol] * kScale) / symbols.size()));
+    total += frequencies[symbol];
+    if (frequencies[symbol] > frequencies[largest]) {
+      largest = symbol;
+    }
+  }
+  // The rounding is corrected at the most frequent symbols, where it costs the least
+  if (total < kScale) {
+    frequencies[largest] += kScale - total;
+  }
+  while (total > kScale) {
+    const auto max_it = std::max_element(frequencies.begin(), frequencies.end());
+    const auto excess = std::min(total - kScale, *max_it - 1U);
+    *max_it -= excess;
+    total -= excess;
+  }
+  return frequencies;
+}
+
+/// Append the number of symbols, their frequencies and the rANS code of the symbols
+void encode_symbols(
+  const std::vector<uint8_t> & symbols, std::vector<uint8_t> & coded, std::vector<uint8_t> & out)
+{
+  put_varint(out, symbols.size());
+  if (symbols.empty()) {
+    return;
+  }
+  const auto frequencies = normalize(symbols);
+  Frequencies starts{};
+  uint32_t start = 0U;
+  for (std::size_t symbol = 0U; symbol < kNumSymbols; ++symbol) {
+    starts[symbol] = start;
+    start += frequencies[symbol];
+    put_varint(out, frequencies[symbol]);
+  }
+  // Each symbol adds at most 12 bits, and the final state 4 bytes
+  coded.resize((2U * symbols.size()) + 4U);
+  // The symbols are coded backwards into the buffer, so that the decoder reads them forwards
+  std::size_t pos = coded.size();
+  uint32_t state = kRansLow;
+  for (auto it = symbols.crbegin(); it != symbols.crend(); ++it) {
+    const auto frequency = frequencies[*it];
+    const uint32_t max_state = ((kRansLow >> kScaleBits) << 8U) * frequency;
+    while (state >= max_state) {
+      coded[--pos] = static_cast<uint8_t>(state);
+      state >>= 8U;
+    }
+    state = ((state / frequency) << kScaleBits) + (state % frequency) + starts[*it];
+  }
+  for (uint32_t shift = 32U; shift > 0U; shift -= 8U) {
+    coded[--pos] = static_cast<uint8_t>(state >> (shift - 8U));
+  }
+  put_varint(out, coded.size() - pos);
+  out.insert(out.end(), coded.cbegin() + static_cast<std::ptrdiff_t>(pos), coded.cend());
+}
+
+/// Read what encode_symbols() appended
+void decode_symbols(Reader & reader, const uint64_t max_symbols, std::vector<uint8_t> & symbols)
+{
+  const auto num_symbols = reader.varint();
+  if (num_symbols > max_symbols) {
+    throw std::runtime_error{"PointCloudDecoder: too many symbols for the number of points"};
+  }
+  symbols.resize(static_cast<std::size_t>(num_symbols));
+  if (symbols.empty()) {
+    return;
+  }
+  Frequencies frequencies{};
+  Frequencies starts{};
+  std::array<uint8_t, kScale> slots{};
+  uint32_t start = 0U;
+  for (std::size_t symbol = 0U; symbol < kNumSymbols; ++symbol) {
+    const auto frequency = reader.varint();
+    if (frequency > (kScale - start)) {
+      throw std::runtime_error{"PointCloudDecoder: malformed symbol frequencies"};
+    }
+    frequencies[symbol] = static_cast<uint32_t>(frequency);
+    starts[symbol] = start;
+    std::fill_n(&slots[start], frequencies[symbol], static_cast<uint8_t>(symbol));
+    start += frequencies[symbol];
+  }
+  if (start != kScale) {
+    throw std::runtime_error{"PointCloudDecoder: malformed symbol frequencies"};
+  }
+  const auto size = reader.varint();
+  Reader coded{reader.take(size), static_cast<std::size_t>(size)};
+  uint32_t state = coded.u32();
+  for (auto & symbol : symbols) {
+    const auto slot = state & (kScale - 1U);
+    symbol = slots[slot];
+    state = (frequencies[symbol] * (state >> kScaleBits)) + slot - starts[symbol];
+    while (state < kRansLow) {
+      state = (state << 8U) | coded.byte();
+    }
+  }
+  // The decoder ends in the state that the encoder started with
+  if (state != kRansLow) {
+    throw std::runtime_error{"PointCloudDecoder: the compressed cloud is corrupted"};
+  }
+}
+
+float32_t validate_resolution(const float32_t resolution)
+{
+  if (!std::isfinite(resolution) || (resolution < 0.0F)) {
+    throw std::domain_error{"PointCloudEncoder: resolutions must be finite and >= 0"};
+  }
+  return resolution;
+}
+
+/// The layout of init_pcl_msg
+bool8_t has_pointxyzi_layout(const sensor_msgs::msg::PointCloud2 & cloud)
+{
+  return (cloud.fields.size() == 4U) && (cloud.point_step == (4U * sizeof(float32_t))) &&
+         (cloud.fields[0U].name == "x") && (cloud.fields[1U].name == "y") &&
+         (cloud.fields[2U].name == "z") && (cloud.fields[3U].name == "intensity");
+}
+}  // namespace
+
+bool8_t is_compressed_cloud(const sensor_msgs::msg::PointCloud2 & cloud)
+{
+  return (cloud.fields.size() == 1U) && (cloud.fields[0U].name == COMPRESSED_CLOUD_FIELD) &&
+         (cloud.fields[0U].datatype == sensor_msgs::msg::PointField::UINT8) &&
+         (cloud.point_step == 1U) && (cloud.height == 1U) && (cloud.data.size() == cloud.width);
+}
+
+PointCloudEncoder::PointCloudEncoder(const PointCloudCodecConfig & config)
+: m_config{validate_resolution(config.xyz_resolution_m),
+    validate_resolution(config.intensity_resolution)}
+{
+}
+
+void PointCloudEncoder::encode(
+  const sensor_msgs::msg::PointCloud2 & cloud,
+  sensor_msgs::msg::PointCloud2 & compressed)
+{
+  const PointCloudView<PointXYZIF> view{cloud, 3U, 5U};
+  const auto num_points = view.size();
+  const auto has_intensity = view.has_field(3U);
+  const auto has_id = view.has_field(kIdField);
+  const auto num_value_fields = has_intensity ? kNumValueFields : 3U;
+  for (auto & codes : m_codes) {
+    codes.resize(num_points);
+  }
+  m_ids.resize(num_points);
+  for (auto & symbols : m_symbols) {
+    symbols.clear();
+  }
+
+  ReferenceTracker tracker;
+  for (std::size_t idx = 0U; idx < num_points; ++idx) {
+    const auto pt = view[idx];
+    const uint16_t previous_id = (idx > 0U) ? m_ids[idx - 1U] : 0U;
+    m_ids[idx] = pt.id;
+    // Without ids, each point is a firing of its own
+    const auto reference = tracker.next(idx, (!has_id) || (idx == 0U) || (pt.id != previous_id));
+    const std::array<float32_t, kNumValueFields> values{{pt.x, pt.y, pt.z, pt.intensity}};
+    for (std::size_t field = 0U; field < num_value_fields; ++field) {
+      const auto code = quantize(
+        values[field],
+        (field < 3U) ? m_config.xyz_resolution_m : m_config.intensity_resolution);
+      m_codes[field][idx] = code;
+      const auto prediction =
+        (reference == ReferenceTracker::NONE) ? 0 : m_codes[field][reference];
+      put_varint(m_symbols[field], zigzag(code - prediction));
+    }
+    if (has_id) {
+      put_varint(
+        m_symbols[kIdField],
+        zigzag(static_cast<int64_t>(pt.id) - static_cast<int64_t>(previous_id)));
+    }
+  }
+
+  auto & out = compressed.data;
+  out.clear();
+  for (const auto magic : kMagic) {
+    out.push_back(magic);
+  }
+  out.push_back(static_cast<uint8_t>((has_intensity ? kHasIntensity : 0U) |
+    (has_id ? kHasId : 0U)));
+  put_f32(out, m_config.xyz_resolution_m);
+  put_f32(out, m_config.intensity_resolution);
+  put_varint(out, num_points);
+  for (std::size_t field = 0U; field < num_value_fields; ++field) {
+    encode_symbols(m_symbols[field], m_coded, out);
+  }
+  if (has_id) {
+    encode_symbols(m_symbols[kIdField], m_coded, out);
+  }
+
+  compressed.header = cloud.header;
+  if (!is_compressed_cloud(compressed)) {
+    sensor_msgs::msg::PointField field;
+    field.name = COMPRESSED_CLOUD_FIELD;
+    field.offset = 0U;
+    field.datatype = sensor_msgs::msg::PointField::UINT8;
+    field.count = 1U;
+    compressed.fields.assign(1U, field);
+  }
+  compressed.height = 1U;
+  compressed.width = static_cast<uint32_t>(out.size());
+  compressed.point_step = 1U;
+  compressed.row_step = compressed.width;
+  compressed.is_bigendian = false;
+  compressed.is_dense = true;
+}
+
+void PointCloudDecoder::decode(
+  const sensor_msgs::msg::PointCloud2 & compressed,
+  sensor_msgs::msg::PointCloud2 & cloud)
+{
+  if (!is_compressed_cloud(compressed)) {
+    throw std::runtime_error{"PointCloudDecoder: the cloud isn't a compressed cloud"};
+  }
+  Reader reader{compressed.data.data(), compressed.data.size()};
+  for (const auto magic : kMagic) {
+    if (reader.byte() != magic) {
+      throw std::runtime_error{"PointCloudDecoder: unknown format of the compressed cloud"};
+    }
+  }
+  const auto flags = reader.byte();
+  if ((flags & ~(kHasIntensity | kHasId)) != 0U) {
+    throw std::runtime_error{"PointCloudDecoder: unknown format of the compressed cloud"};
+  }
+  const bool8_t has_intensity = (flags & kHasIntensity) != 0U;
+  const bool8_t has_id = (flags & kHasId) != 0U;
+  const auto num_value_fields = has_intensity ? kNumValueFields : 3U;
+  const auto xyz_resolution = reader.f32();
+  const auto intensity_resolution = reader.f32();
+  const auto num_encoded_points = reader.varint();
+  if (num_encoded_points > std::numeric_limits<uint32_t>::max()) {
+    throw std::runtime_error{"PointCloudDecoder: too many points"};
+  }
+  const auto num_points = static_cast<std::size_t>(num_encoded_points);
+  const auto max_symbols = num_encoded_points * kMaxVarintSize;
+  for (auto & symbols : m_symbols) {
+    symbols.clear();
+  }
+  for (std::size_t field = 0U; field < num_value_fields; ++field) {
+    decode_symbols(reader, max_symbols, m_symbols[field]);
+  }
+  if (has_id) {
+    decode_symbols(reader, max_symbols, m_symbols[kIdField]);
+  }
+
+  std::array<Reader, kNumValueFields + 1U> residuals{{
+    {m_symbols[0U].data(), m_symbols[0U].size()}, {m_symbols[1U].data(), m_symbols[1U].size()},
+    {m_symbols[2U].data(), m_symbols[2U].size()}, {m_symbols[3U].data(), m_symbols[3U].size()},
+    {m_symbols[4U].data(), m_symbols[4U].size()}}};
+  for (auto & codes : m_codes) {
+    codes.resize(num_points);
+  }
+  m_ids.resize(num_points);
+  m_points.resize(num_points);
+  ReferenceTracker tracker;
+  for (std::size_t idx = 0U; idx < num_points; ++idx) {
+    auto & pt = m_points[idx];
+    const uint16_t previous_id = (idx > 0U) ? m_ids[idx - 1U] : 0U;
+    pt.id = has_id ?
+      static_cast<uint16_t>(static_cast<int64_t>(previous_id) +
+      unzigzag(residuals[kIdField].varint())) : 0U;
+    m_ids[idx] = pt.id;
+    const auto reference = tracker.next(idx, (!has_id) || (idx == 0U) || (pt.id != previous_id));
+    std::array<float32_t, kNumValueFields> values{{0.0F, 0.0F, 0.0F, 0.0F}};
+    for (std::size_t field = 0U; field < num_value_fields; ++field) {
+      const auto prediction =
+        (reference == ReferenceTracker::NONE) ? 0 : m_codes[field][reference];
+      const auto code = prediction + unzigzag(residuals[field].varint());
+      m_codes[field][idx] = code;
+      values[field] =
+        dequantize(code, (field < 3U) ? xyz_resolution : intensity_resolution);
+    }
+    pt.x = values[0U];
+    pt.y = values[1U];
+    pt.z = values[2U];
+    pt.intensity = values[3U];
+  }
+
+  if (has_id ? !has_pointxyzif_layout(cloud) : !has_pointxyzi_layout(cloud)) {
+    if (has_id) {
+      init_pcl_msg_with_id(cloud, compressed.header.frame_id, 0U);
+    } else {
+      init_pcl_msg(cloud, compressed.header.frame_id, 0U);
+    }
+  }
+  resize_pcl_msg(cloud, num_points);
+  uint32_t point_cloud_idx = 0U;
+  (void)add_points_to_cloud_raw(cloud, m_points.data(), num_points, point_cloud_idx);
+  cloud.header = compressed.header;
+}
+
+}  // namespace lidar_utils
+}  // namespace common
+}  // namespace autoware
@@ -19,8 +19,13 @@
 #include <sensor_msgs/point_cloud2_iterator.hpp>
 
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
 #include <limits>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <utility>
 #include <vector>
@@ -200,6 +205,45 @@ void init_pcl_msg(
     "intensity", 1U, sensor_msgs::msg::PointField::FLOAT32);
 }
 
+void init_pcl_msg_with_id(
+  sensor_msgs::msg::PointCloud2 & msg,
+  const std::string & frame_id,
+  const std::size_t size)
+{
+  init_pcl_msg(
+    msg, frame_id, 0U, 5U,
+    "x", 1U, sensor_msgs::msg::PointField::FLOAT32,
+    "y", 1U, sensor_msgs::msg::PointField::FLOAT32,
+    "z", 1U, sensor_msgs::msg::PointField::FLOAT32,
+    "intensity", 1U, sensor_msgs::msg::PointField::FLOAT32,
+    "id", 1U, sensor_msgs::msg::PointField::UINT16);
+  // Pad each point to the size of the struct, so the points stay aligned
+  msg.point_step = static_cast<uint32_t>(sizeof(autoware::common::types::PointXYZIF));
+  sensor_msgs::PointCloud2Modifier modifier(msg);
+  modifier.resize(size);
+}
+
+bool8_t has_pointxyzif_layout(const sensor_msgs::msg::PointCloud2 & cloud)
+{
+  using autoware::common::types::PointXYZIF;
+  using sensor_msgs::msg::PointField;
+  if ((cloud.fields.size() != 5U) || (cloud.point_step != sizeof(PointXYZIF))) {
+    return false;
+  }
+  const auto check_field = [&cloud](
+    const std::size_t idx, const char8_t * const name, const std::size_t offset,
+    const decltype(PointField::datatype) datatype) -> bool8_t {
+      const auto & field = cloud.fields[idx];
+      return (name == field.name) && (offset == field.offset) &&
+             (datatype == field.datatype) && (1U == field.count);
+    };
+  return check_field(0U, "x", offsetof(PointXYZIF, x), PointField::FLOAT32) &&
+         check_field(1U, "y", offsetof(PointXYZIF, y), PointField::FLOAT32) &&
+         check_field(2U, "z", offsetof(PointXYZIF, z), PointField::FLOAT32) &&
+         check_field(3U, "intensity", offsetof(PointXYZIF, intensity), PointField::FLOAT32) &&
+         check_field(4U, "id", offsetof(PointXYZIF, id), PointField::UINT16);
+}
+
 bool8_t add_point_to_cloud_raw(
   sensor_msgs::msg::PointCloud2 & cloud,
   const autoware::common::types::PointXYZIF & pt,
@@ -233,6 +277,39 @@ bool8_t add_point_to_cloud_raw(
   return ret;
 }
 
+std::size_t add_points_to_cloud_raw(
+  sensor_msgs::msg::PointCloud2 & cloud,
+  const autoware::common::types::PointXYZIF * const points,
+  const std::size_t num_points,
+  uint32_t & point_cloud_idx)
+{
+  using autoware::common::types::PointXYZIF;
+  static_assert(
+    std::is_trivially_copyable<PointXYZIF>::value,
+    "PointXYZIF is not trivial, add_point_to_cloud instead of add_points_to_cloud_raw");
+
+  const std::size_t point_step = cloud.point_step;
+  if ((point_step == 0U) || (num_points == 0U)) {
+    return 0U;
+  }
+  const std::size_t capacity = cloud.data.size() / point_step;
+  if (point_cloud_idx >= capacity) {
+    return 0U;
+  }
+  const std::size_t num_added = std::min(num_points, capacity - point_cloud_idx);
+  uint8_t * const cloud_insertion_slot = &cloud.data[point_step * point_cloud_idx];
+  if (point_step == sizeof(PointXYZIF)) {
+    (void)std::memcpy(cloud_insertion_slot, points, num_added * sizeof(PointXYZIF));
+  } else {
+    const std::size_t copy_size = std::min(point_step, sizeof(PointXYZIF));
+    for (std::size_t idx = 0U; idx < num_added; ++idx) {
+      (void)std::memcpy(&cloud_insertion_slot[idx * point_step], &points[idx], copy_size);
+    }
+  }
+  point_cloud_idx = static_cast<uint32_t>(point_cloud_idx + num_added);
+  return num_added;
+}
+
 bool8_t add_point_to_cloud(
   PointCloudIts & cloud_its,
   const autoware::common::types::PointXYZIF & pt,
@@ -377,8 +454,9 @@ void reset_pcl_msg(
   const std::size_t size,
   uint32_t & point_cloud_idx)
 {
+  // The points are overwritten before they are read, so only the points past the end of the last
+  // cloud need to be initialized. The memory of the cloud is kept.
   sensor_msgs::PointCloud2Modifier pc_modifier(msg);
-  pc_modifier.clear();
   point_cloud_idx = 0;
   pc_modifier.resize(size);
 }
@@ -393,6 +471,24 @@ void resize_pcl_msg(
   pc_modifier.resize(new_size);
 }
 
+/////////////////////////////////////////////////////////////////////////////////////////
+
+std::unique_ptr<sensor_msgs::msg::PointCloud2> release_pcl_msg(
+  sensor_msgs::msg::PointCloud2 & msg,
+  const std::size_t size)
+{
+  auto released_msg = std::make_unique<sensor_msgs::msg::PointCloud2>(std::move(msg));
+  msg = sensor_msgs::msg::PointCloud2{};
+  msg.header.frame_id = released_msg->header.frame_id;
+  msg.fields = released_msg->fields;
+  msg.is_bigendian = released_msg->is_bigendian;
+  msg.point_step = released_msg->point_step;
+  msg.is_dense = released_msg->is_dense;
+  sensor_msgs::PointCloud2Modifier pc_modifier(msg);
+  pc_modifier.resize(size);
+  return released_msg;
+}
+
 DistanceFilter::DistanceFilter(float32_t min_radius, float32_t max_radius)
 : m_min_r2(min_radius * min_radius), m_max_r2(max_radius * max_radius)
 {
@@ -404,6 +500,21 @@ DistanceFilter::DistanceFilter(float32_t min_radius, float32_t max_radius)
 // odr-used by comp::abs_gte
 constexpr float32_t DistanceFilter::FEPS;
 
+void DistanceFilter::apply(
+  const float32_t * const x, const float32_t * const y, const float32_t * const z,
+  const std::size_t size, uint8_t * const keep) const
+{
+  for (std::size_t i = 0U; i < size; ++i) {
+    const float32_t pt_radius = (x[i] * x[i]) + (y[i] * y[i] + z[i] * z[i]);
+    // Same as comp::abs_gte and comp::abs_lte, also for NaN, with bitwise operators
+    const bool8_t is_above_min =
+      (std::fabs(pt_radius - m_min_r2) <= FEPS) | !(pt_radius < m_min_r2);
+    const bool8_t is_below_max =
+      (std::fabs(pt_radius - m_max_r2) <= FEPS) | (pt_radius < m_max_r2);
+    keep[i] = static_cast<uint8_t>(keep[i] & static_cast<uint8_t>(is_above_min & is_below_max));
+  }
+}
+
 
 StaticTransformer::StaticTransformer(const geometry_msgs::msg::Transform & tf)
 {
@@ -466,6 +577,148 @@ AngleFilter::AngleFilter(float32_t start_angle, float32_t end_angle)
   m_threshold2 = thresh * thresh;
 }
 
+void AngleFilter::apply(
+  const float32_t * const x, const float32_t * const y, const std::size_t size,
+  uint8_t * const keep) const
+{
+  const float32_t normal_x = m_range_normal.x;
+  const float32_t normal_y = m_range_normal.y;
+  for (std::size_t i = 0U; i < size; ++i) {
+    const float32_t pt_len2 = (x[i] * x[i]) + (y[i] * y[i]);
+    const float32_t proj_on_normal = (x[i] * normal_x) + (y[i] * normal_y);
+    const float32_t proj_on_normal2 = proj_on_normal * proj_on_normal;
+    const bool8_t is_proj_negative = (proj_on_normal + FEPS) < 0.0F;
+    // The four cases of operator(), selected by the signs of the projection and the threshold
+    const bool8_t is_in_positive =
+      m_threshold_negative | (proj_on_normal2 >= (pt_len2 * (m_threshold2 - FEPS)));
+    const bool8_t is_in_negative =
+      m_threshold_negative & (proj_on_normal2 <= (pt_len2 * (m_threshold2 + FEPS)));
+    const bool8_t is_in_range =
+      (is_proj_negative & is_in_negative) | (!is_proj_negative & is_in_positive);
+    keep[i] = static_cast<uint8_t>(keep[i] & static_cast<uint8_t>(is_in_range));
+  }
+}
+
+bool8_t filter_and_transform_points(
+  const sensor_msgs::msg::PointCloud2 & input,
+  const AngleFilter & angle_filter,
+  const DistanceFilter & distance_filter,
+  const StaticTransformer & transformer,
+  sensor_msgs::msg::PointCloud2 & output,
+  uint32_t & point_cloud_idx)
+{
+  using sensor_msgs::msg::PointField;
+  const auto find_field = [](
+    const sensor_msgs::msg::PointCloud2 & cloud, const char8_t * const name) -> const PointField * {
+      const auto field_it = std::find_if(
+        cloud.fields.begin(), cloud.fields.end(),
+        [name](const PointField & field) {return field.name == name;});
+      return (field_it == cloud.fields.end()) ? nullptr : &(*field_it);
+    };
+  const auto get_float_offset = [&find_field](
+    const sensor_msgs::msg::PointCloud2 & cloud, const char8_t * const name) -> std::size_t {
+      const PointField * const field = find_field(cloud, name);
+      if ((field == nullptr) || (field->datatype != PointField::FLOAT32) ||
+        ((field->offset + sizeof(float32_t)) > cloud.point_step))
+      {
+        throw std::runtime_error(
+                std::string{"filter_and_transform_points: no float32 field "} + name);
+      }
+      return field->offset;
+    };
+  const std::size_t x_offset = get_float_offset(input, "x");
+  const std::size_t y_offset = get_float_offset(input, "y");
+  const std::size_t z_offset = get_float_offset(input, "z");
+  const PointField * const intensity_field = find_field(input, "intensity");
+  if ((intensity_field != nullptr) && (intensity_field->datatype != PointField::UINT8) &&
+    (intensity_field->datatype != PointField::FLOAT32))
+  {
+    throw std::runtime_error(
+            "Intensity type not supported: " + std::to_string(intensity_field->datatype));
+  }
+  const std::size_t x_out_offset = get_float_offset(output, "x");
+  const std::size_t y_out_offset = get_float_offset(output, "y");
+  const std::size_t z_out_offset = get_float_offset(output, "z");
+  const std::size_t intensity_out_offset = get_float_offset(output, "intensity");
+
+  const std::size_t width = input.width;
+  const std::size_t point_step = input.point_step;
+  const std::size_t row_step = input.row_step;
+  if ((input.height > 0U) && (width > 0U) &&
+    ((row_step < (width * point_step)) ||
+    ((static_cast<std::size_t>(input.height - 1U) * row_step + width * point_step) >
+    input.data.size())))
+  {
+    throw std::runtime_error("filter_and_transform_points: point cloud has less data than size");
+  }
+  const std::size_t out_point_step = output.point_step;
+  const std::size_t capacity = output.data.size() / out_point_step;
+  std::size_t out_idx = point_cloud_idx;
+
+  // Blocks small enough for all their arrays to stay in the L1 cache
+  constexpr std::size_t BLOCK_SIZE = 256U;
+  std::array<float32_t, BLOCK_SIZE> xs;
+  std::array<float32_t, BLOCK_SIZE> ys;
+  std::array<float32_t, BLOCK_SIZE> zs;
+  std::array<float32_t, BLOCK_SIZE> intensities;
+  std::array<float32_t, BLOCK_SIZE> xs_out;
+  std::array<float32_t, BLOCK_SIZE> ys_out;
+  std::array<float32_t, BLOCK_SIZE> zs_out;
+  std::array<uint8_t, BLOCK_SIZE> keep;
+  for (std::size_t row = 0U; row < input.height; ++row) {
+    for (std::size_t block_begin = 0U; block_begin < width; block_begin += BLOCK_SIZE) {
+      const std::size_t block_size = std::min(BLOCK_SIZE, width - block_begin);
+      const uint8_t * const block_data =
+        &input.data[row * row_step + block_begin * point_step];
+      for (std::size_t i = 0U; i < block_size; ++i) {
+        const uint8_t * const point_data = &block_data[i * point_step];
+        std::memcpy(&xs[i], &point_data[x_offset], sizeof(float32_t));
+        std::memcpy(&ys[i], &point_data[y_offset], sizeof(float32_t));
+        std::memcpy(&zs[i], &point_data[z_offset], sizeof(float32_t));
+      }
+      if (intensity_field == nullptr) {
+        std::fill(intensities.begin(), intensities.end(), 0.0F);
+      } else if (intensity_field->datatype == PointField::FLOAT32) {
+        for (std::size_t i = 0U; i < block_size; ++i) {
+          std::memcpy(
+            &intensities[i], &block_data[i * point_step + intensity_field->offset],
+            sizeof(float32_t));
+        }
+      } else {
+        for (std::size_t i = 0U; i < block_size; ++i) {
+          intensities[i] =
+            static_cast<float32_t>(block_data[i * point_step + intensity_field->offset]);
+        }
+      }
+
+      // Filter and transform all points of the block, without branches
+      std::fill(keep.begin(), keep.end(), static_cast<uint8_t>(1U));
+      angle_filter.apply(xs.data(), ys.data(), block_size, keep.data());
+      distance_filter.apply(xs.data(), ys.data(), zs.data(), block_size, keep.data());
+      transformer.transform(
+        xs.data(), ys.data(), zs.data(), block_size, xs_out.data(), ys_out.data(), zs_out.data());
+
+      for (std::size_t i = 0U; i < block_size; ++i) {
+        if (keep[i] == 0U) {
+          continue;
+        }
+        if (out_idx >= capacity) {
+          point_cloud_idx = static_cast<uint32_t>(out_idx);
+          return false;
+        }
+        uint8_t * const out_data = &output.data[out_idx * out_point_step];
+        std::memcpy(&out_data[x_out_offset], &xs_out[i], sizeof(float32_t));
+        std::memcpy(&out_data[y_out_offset], &ys_out[i], sizeof(float32_t));
+        std::memcpy(&out_data[z_out_offset], &zs_out[i], sizeof(float32_t));
+        std::memcpy(&out_data[intensity_out_offset], &intensities[i], sizeof(float32_t));
+        ++out_idx;
+      }
+    }
+  }
+  point_cloud_idx = static_cast<uint32_t>(out_idx);
+  return true;
+}
+
 bool8_t IntensityIteratorWrapper::eof()
 {
   switch (m_intensity_datatype) {
@@ -192,6 +192,32 @@ static void BenchMsgWrapperAccessPoint(benchmark::State & state)
   }
 }
 
+static void BenchLidarUtilsFilterAndTransformPoints(benchmark::State & state)
+{
+  using autoware::common::types::PointXYZIF;
+  auto msg = create_point_cloud_through_utils(kCloudSize);
+  std::uint32_t idx{};
+  for (auto i = 0U; i < kCloudSize; ++i) {
+    PointXYZIF point{};
+    point.x = static_cast<float32_t>(i % 10U) - 4.5F;
+    point.y = static_cast<float32_t>(i / 10U) - 4.5F;
+    autoware::common::lidar_utils::add_point_to_cloud(msg, point, idx);
+  }
+  auto output = create_point_cloud_through_utils(kCloudSize);
+  geometry_msgs::msg::Transform tf;
+  tf.translation.x = 1.0;
+  tf.rotation.w = 1.0;
+  const autoware::common::lidar_utils::StaticTransformer transformer{tf};
+  const autoware::common::lidar_utils::AngleFilter angle_filter{-1.0F, 1.0F};
+  const autoware::common::lidar_utils::DistanceFilter distance_filter{1.0F, 5.0F};
+  for (auto _ : state) {
+    idx = 0U;
+    autoware::common::lidar_utils::filter_and_transform_points(
+      msg, angle_filter, distance_filter, transformer, output, idx);
+    benchmark::DoNotOptimize(output);
+  }
+}
+
 BENCHMARK(BenchMsgWrapperAddPointToCloud);
 BENCHMARK(BenchMsgWrapperResizeAndAddPointToCloud);
 BENCHMARK(BenchMsgWrapperPushBackPointToCloud);
@@ -200,3 +226,4 @@ BENCHMARK(BenchLidarUtilsAddPointToCloud);
 
 BENCHMARK(BenchMsgWrapperAccessPoint);
 BENCHMARK(BenchLidarUtilsAccessPoint);
+BENCHMARK(BenchLidarUtilsFilterAndTransformPoints);
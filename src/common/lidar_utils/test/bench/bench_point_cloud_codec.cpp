@@ -0,0 +1,123 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+#include <lidar_utils/point_cloud_codec.hpp>
+#include <lidar_utils/point_cloud_utils.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace
+{
+using autoware::common::types::float32_t;
+using autoware::common::types::float64_t;
+using autoware::common::lidar_utils::PointCloudCodecConfig;
+using autoware::common::lidar_utils::PointCloudDecoder;
+using autoware::common::lidar_utils::PointCloudEncoder;
+
+/// Firings of one revolution of a Velodyne at 10 Hz
+constexpr std::size_t kNumFirings = 1800U;
+
+/// A scan of a spinning lidar with ground in front of the lower rings and walls in front of the
+/// others, ordered by firing like the Velodyne driver
+sensor_msgs::msg::PointCloud2 make_scan(const std::size_t num_rings)
+{
+  sensor_msgs::msg::PointCloud2 cloud;
+  autoware::common::lidar_utils::init_pcl_msg_with_id(cloud, "lidar", num_rings * kNumFirings);
+  uint32_t noise = 12345U;
+  uint32_t idx = 0U;
+  for (std::size_t firing = 0U; firing < kNumFirings; ++firing) {
+    const auto azimuth = (6.2831853F * static_cast<float32_t>(firing)) /
+      static_cast<float32_t>(kNumFirings);
+    for (std::size_t ring = 0U; ring < num_rings; ++ring) {
+      noise = (noise * 1103515245U) + 12345U;
+      const auto elevation = -0.4F + ((0.6F * static_cast<float32_t>(ring)) /
+        static_cast<float32_t>(num_rings));
+      const auto wall = 15.0F + (8.0F * std::sin(2.0F * azimuth)) +
+        (2.0F * std::floor(4.0F * std::cos(5.0F * azimuth)));
+      const auto ground = (elevation < 0.0F) ? (-1.8F / std::sin(elevation)) : wall;
+      // Noise of about 2 cm, like the specified accuracy of a Velodyne
+      const auto range = std::fmin(wall, ground) +
+        (0.04F * (static_cast<float32_t>(noise >> 16U) / 65536.0F - 0.5F));
+      autoware::common::types::PointXYZIF pt;
+      pt.x = range * std::cos(elevation) * std::cos(azimuth);
+      pt.y = range * std::cos(elevation) * std::sin(azimuth);
+      pt.z = range * std::sin(elevation);
+      pt.intensity = static_cast<float32_t>(((ground < wall) ? 10U : 60U) + (noise >> 29U));
+      pt.id = static_cast<uint16_t>(firing);
+      (void)autoware::common::lidar_utils::add_point_to_cloud_raw(cloud, pt, idx);
+      ++idx;
+    }
+  }
+  return cloud;
+}
+
+PointCloudCodecConfig make_config(const int64_t lossless)
+{
+  return (lossless != 0) ? PointCloudCodecConfig{0.0F, 0.0F} : PointCloudCodecConfig{};
+}
+
+void set_counters(
+  benchmark::State & state, const sensor_msgs::msg::PointCloud2 & cloud,
+  const sensor_msgs::msg::PointCloud2 & compressed)
+{
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(cloud.width));
+  state.counters["ratio"] = static_cast<float64_t>(cloud.data.size()) /
+    static_cast<float64_t>(compressed.data.size());
+  state.counters["bytes_per_point"] = static_cast<float64_t>(compressed.data.size()) /
+    static_cast<float64_t>(cloud.width);
+}
+
+void BenchEncode(benchmark::State & state)
+{
+  const auto cloud = make_scan(static_cast<std::size_t>(state.range(0)));
+  PointCloudEncoder encoder{make_config(state.range(1))};
+  sensor_msgs::msg::PointCloud2 compressed;
+  for (auto _ : state) {
+    encoder.encode(cloud, compressed);
+    benchmark::DoNotOptimize(compressed.data.data());
+  }
+  set_counters(state, cloud, compressed);
+}
+
+void BenchDecode(benchmark::State & state)
+{
+  const auto cloud = make_scan(static_cast<std::size_t>(state.range(0)));
+  PointCloudEncoder encoder{make_config(state.range(1))};
+  PointCloudDecoder decoder;
+  sensor_msgs::msg::PointCloud2 compressed;
+  sensor_msgs::msg::PointCloud2 restored;
+  encoder.encode(cloud, compressed);
+  for (auto _ : state) {
+    decoder.decode(compressed, restored);
+    benchmark::DoNotOptimize(restored.data.data());
+  }
+  set_counters(state, cloud, compressed);
+}
+
+void CodecArgs(benchmark::internal::Benchmark * bench)
+{
+  bench->ArgNames({"rings", "lossless"});
+  for (const int64_t num_rings : {16, 128}) {
+    bench->Args({num_rings, 0});
+    bench->Args({num_rings, 1});
+  }
+}
+}  // namespace
+
+BENCHMARK(BenchEncode)->Apply(CodecArgs)->Unit(benchmark::kMillisecond);
+BENCHMARK(BenchDecode)->Apply(CodecArgs)->Unit(benchmark::kMillisecond);
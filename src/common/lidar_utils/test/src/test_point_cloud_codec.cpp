@@ -0,0 +1,186 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <common/types.hpp>
+#include <lidar_utils/point_cloud_codec.hpp>
+#include <lidar_utils/point_cloud_utils.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+using autoware::common::types::float32_t;
+using autoware::common::types::PointXYZIF;
+using autoware::common::lidar_utils::PointCloudCodecConfig;
+using autoware::common::lidar_utils::PointCloudDecoder;
+using autoware::common::lidar_utils::PointCloudEncoder;
+
+namespace
+{
+/// A spinning lidar in front of a wall, with the points of each firing ordered by ring and the
+/// firing as id, like the Velodyne driver
+sensor_msgs::msg::PointCloud2 make_scan(
+  const std::size_t num_rings, const std::size_t num_firings, const bool with_id)
+{
+  sensor_msgs::msg::PointCloud2 cloud;
+  if (with_id) {
+    autoware::common::lidar_utils::init_pcl_msg_with_id(cloud, "lidar", num_rings * num_firings);
+  } else {
+    autoware::common::lidar_utils::init_pcl_msg(cloud, "lidar", num_rings * num_firings);
+  }
+  uint32_t noise = 12345U;
+  uint32_t idx = 0U;
+  for (std::size_t firing = 0U; firing < num_firings; ++firing) {
+    const auto azimuth = (6.2831853F * static_cast<float32_t>(firing)) /
+      static_cast<float32_t>(num_firings);
+    for (std::size_t ring = 0U; ring < num_rings; ++ring) {
+      noise = (noise * 1103515245U) + 12345U;
+      const auto elevation = -0.26F + ((0.52F * static_cast<float32_t>(ring)) /
+        static_cast<float32_t>(num_rings));
+      const auto range = 20.0F + (5.0F * std::sin(3.0F * azimuth)) +
+        (0.01F * static_cast<float32_t>(noise >> 24U) / 256.0F);
+      PointXYZIF pt;
+      pt.x = range * std::cos(elevation) * std::cos(azimuth);
+      pt.y = range * std::cos(elevation) * std::sin(azimuth);
+      pt.z = range * std::sin(elevation);
+      pt.intensity = static_cast<float32_t>((ring * 7U + (noise >> 28U)) % 256U);
+      pt.id = static_cast<uint16_t>(firing);
+      EXPECT_TRUE(autoware::common::lidar_utils::add_point_to_cloud_raw(cloud, pt, idx));
+      ++idx;
+    }
+  }
+  cloud.header.stamp.sec = 10;
+  cloud.header.stamp.nanosec = 500U;
+  return cloud;
+}
+
+PointXYZIF get_point(const sensor_msgs::msg::PointCloud2 & cloud, const std::size_t idx)
+{
+  PointXYZIF pt;
+  std::memcpy(&pt, &cloud.data[idx * cloud.point_step], cloud.point_step);
+  return pt;
+}
+}  // namespace
+
+TEST(TestPointCloudCodec, lossless_round_trip)
+{
+  auto cloud = make_scan(16U, 100U, true);
+  // Values that only survive without quantization
+  float32_t pt_x = 1.0e-20F;
+  std::memcpy(&cloud.data[0U], &pt_x, sizeof(pt_x));
+  pt_x = -std::numeric_limits<float32_t>::infinity();
+  std::memcpy(&cloud.data[cloud.point_step], &pt_x, sizeof(pt_x));
+  PointCloudEncoder encoder{PointCloudCodecConfig{0.0F, 0.0F}};
+  PointCloudDecoder decoder;
+  sensor_msgs::msg::PointCloud2 compressed;
+  sensor_msgs::msg::PointCloud2 restored;
+  encoder.encode(cloud, compressed);
+  EXPECT_TRUE(autoware::common::lidar_utils::is_compressed_cloud(compressed));
+  decoder.decode(compressed, restored);
+  EXPECT_TRUE(autoware::common::lidar_utils::has_pointxyzif_layout(restored));
+  EXPECT_EQ(restored.header, cloud.header);
+  ASSERT_EQ(restored.width, cloud.width);
+  for (std::size_t idx = 0U; idx < cloud.width; ++idx) {
+    const auto expected = get_point(cloud, idx);
+    const auto pt = get_point(restored, idx);
+    EXPECT_EQ(std::memcmp(&pt.x, &expected.x, 4U * sizeof(float32_t)), 0) << idx;
+    EXPECT_EQ(pt.id, expected.id) << idx;
+  }
+}
+
+TEST(TestPointCloudCodec, lossy_round_trip)
+{
+  const auto cloud = make_scan(32U, 360U, true);
+  const PointCloudCodecConfig config{};
+  PointCloudEncoder encoder{config};
+  PointCloudDecoder decoder;
+  sensor_msgs::msg::PointCloud2 compressed;
+  sensor_msgs::msg::PointCloud2 restored;
+  encoder.encode(cloud, compressed);
+  // The wall is smooth along the rings, so the residuals are small
+  EXPECT_LT(compressed.data.size() * 4U, cloud.data.size());
+  // A second cloud reuses the buffers of the encoder and the decoder
+  for (std::size_t iteration = 0U; iteration < 2U; ++iteration) {
+    encoder.encode(cloud, compressed);
+    decoder.decode(compressed, restored);
+  }
+  ASSERT_EQ(restored.width, cloud.width);
+  const auto tolerance = (0.5F * config.xyz_resolution_m) + 1.0e-5F;
+  for (std::size_t idx = 0U; idx < cloud.width; ++idx) {
+    const auto expected = get_point(cloud, idx);
+    const auto pt = get_point(restored, idx);
+    EXPECT_NEAR(pt.x, expected.x, tolerance) << idx;
+    EXPECT_NEAR(pt.y, expected.y, tolerance) << idx;
+    EXPECT_NEAR(pt.z, expected.z, tolerance) << idx;
+    EXPECT_FLOAT_EQ(pt.intensity, expected.intensity) << idx;
+    EXPECT_EQ(pt.id, expected.id) << idx;
+  }
+}
+
+TEST(TestPointCloudCodec, cloud_without_id)
+{
+  const auto cloud = make_scan(8U, 50U, false);
+  PointCloudEncoder encoder{PointCloudCodecConfig{0.0F, 0.0F}};
+  PointCloudDecoder decoder;
+  sensor_msgs::msg::PointCloud2 compressed;
+  sensor_msgs::msg::PointCloud2 restored;
+  encoder.encode(cloud, compressed);
+  decoder.decode(compressed, restored);
+  EXPECT_EQ(restored.fields.size(), 4U);
+  ASSERT_EQ(restored.width, cloud.width);
+  ASSERT_EQ(restored.point_step, cloud.point_step);
+  EXPECT_EQ(restored.data, cloud.data);
+
+  // An empty cloud stays empty
+  sensor_msgs::msg::PointCloud2 empty_cloud;
+  autoware::common::lidar_utils::init_pcl_msg(empty_cloud, "lidar", 0U);
+  encoder.encode(empty_cloud, compressed);
+  decoder.decode(compressed, restored);
+  EXPECT_EQ(restored.width, 0U);
+}
+
+TEST(TestPointCloudCodec, bad_input)
+{
+  EXPECT_THROW(PointCloudEncoder(PointCloudCodecConfig{-0.1F, 1.0F}), std::domain_error);
+  EXPECT_THROW(
+    PointCloudEncoder(PointCloudCodecConfig{0.01F, std::numeric_limits<float32_t>::quiet_NaN()}),
+    std::domain_error);
+
+  PointCloudEncoder encoder{PointCloudCodecConfig{}};
+  PointCloudDecoder decoder;
+  auto cloud = make_scan(4U, 10U, true);
+  sensor_msgs::msg::PointCloud2 compressed;
+  sensor_msgs::msg::PointCloud2 restored;
+  // A NaN can't be quantized, and an uncompressed cloud can't be decoded
+  auto nan = std::numeric_limits<float32_t>::quiet_NaN();
+  std::memcpy(&cloud.data[0U], &nan, sizeof(nan));
+  EXPECT_THROW(encoder.encode(cloud, compressed), std::runtime_error);
+  EXPECT_THROW(decoder.decode(cloud, restored), std::runtime_error);
+
+  cloud = make_scan(4U, 10U, true);
+  encoder.encode(cloud, compressed);
+  auto truncated = compressed;
+  truncated.data.resize(truncated.data.size() - 3U);
+  truncated.width = static_cast<uint32_t>(truncated.data.size());
+  truncated.row_step = truncated.width;
+  EXPECT_THROW(decoder.decode(truncated, restored), std::runtime_error);
+  auto unknown = compressed;
+  unknown.data[3U] = 0xFFU;
+  EXPECT_THROW(decoder.decode(unknown, restored), std::runtime_error);
+}
@@ -17,9 +17,14 @@
 #include <common/types.hpp>
 #include <lidar_utils/lidar_utils.hpp>
 #include <lidar_utils/point_cloud_utils.hpp>
+#include <lidar_utils/point_layout.hpp>
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -62,6 +67,215 @@ TEST(TestPointCloudUtils, has_intensity_and_throw_if_no_xyz_test)
   EXPECT_TRUE(has_intensity_and_throw_if_no_xyz(five_fields_pc));
 }
 
+TEST(TestPointCloudUtils, reset_pcl_msg)
+{
+  using autoware::common::lidar_utils::add_point_to_cloud;
+  using autoware::common::lidar_utils::init_pcl_msg;
+  using autoware::common::lidar_utils::reset_pcl_msg;
+  using autoware::common::lidar_utils::resize_pcl_msg;
+
+  sensor_msgs::msg::PointCloud2 msg;
+  init_pcl_msg(msg, "lidar", 10U);
+  const auto * const data = msg.data.data();
+  uint32_t point_idx = 0U;
+  autoware::common::types::PointXYZIF pt;
+  for (uint32_t i = 0U; i < 3U; ++i) {
+    ASSERT_TRUE(add_point_to_cloud(msg, pt, point_idx));
+  }
+  resize_pcl_msg(msg, point_idx);
+  EXPECT_EQ(msg.width, 3U);
+
+  // The cloud is filled again in the same memory
+  reset_pcl_msg(msg, 10U, point_idx);
+  EXPECT_EQ(point_idx, 0U);
+  EXPECT_EQ(msg.width, 10U);
+  EXPECT_EQ(msg.row_step, 10U * msg.point_step);
+  EXPECT_EQ(msg.data.size(), 10U * msg.point_step);
+  EXPECT_EQ(msg.data.data(), data);
+}
+
+TEST(TestPointCloudUtils, release_pcl_msg)
+{
+  using autoware::common::lidar_utils::add_point_to_cloud;
+  using autoware::common::lidar_utils::init_pcl_msg;
+  using autoware::common::lidar_utils::release_pcl_msg;
+  using autoware::common::lidar_utils::resize_pcl_msg;
+
+  sensor_msgs::msg::PointCloud2 msg;
+  init_pcl_msg(msg, "lidar", 10U);
+  uint32_t point_idx = 0U;
+  autoware::common::types::PointXYZIF pt;
+  pt.x = 1.0F;
+  ASSERT_TRUE(add_point_to_cloud(msg, pt, point_idx));
+  resize_pcl_msg(msg, point_idx);
+  const auto * const data = msg.data.data();
+
+  const auto released = release_pcl_msg(msg, 10U);
+  // The data is moved, not copied.
+  EXPECT_EQ(released->data.data(), data);
+  EXPECT_EQ(released->width, 1U);
+  EXPECT_EQ(released->header.frame_id, "lidar");
+
+  EXPECT_EQ(msg.header.frame_id, "lidar");
+  EXPECT_EQ(msg.fields, released->fields);
+  EXPECT_EQ(msg.point_step, released->point_step);
+  EXPECT_EQ(msg.width, 10U);
+  EXPECT_EQ(msg.data.size(), 10U * msg.point_step);
+  point_idx = 0U;
+  EXPECT_TRUE(add_point_to_cloud(msg, pt, point_idx));
+}
+
+TEST(TestPointCloudUtils, init_pcl_msg_with_id)
+{
+  using autoware::common::lidar_utils::add_point_to_cloud_raw;
+  using autoware::common::lidar_utils::has_intensity_and_throw_if_no_xyz;
+  using autoware::common::lidar_utils::has_pointxyzif_layout;
+  using autoware::common::lidar_utils::init_pcl_msg;
+  using autoware::common::lidar_utils::init_pcl_msg_with_id;
+  using autoware::common::lidar_utils::reset_pcl_msg;
+  using autoware::common::types::PointXYZIF;
+
+  sensor_msgs::msg::PointCloud2 msg;
+  init_pcl_msg_with_id(msg, "lidar", 10U);
+  EXPECT_EQ(msg.point_step, sizeof(PointXYZIF));
+  EXPECT_EQ(msg.width, 10U);
+  EXPECT_EQ(msg.data.size(), 10U * sizeof(PointXYZIF));
+  EXPECT_TRUE(has_pointxyzif_layout(msg));
+  EXPECT_TRUE(has_intensity_and_throw_if_no_xyz(msg));
+
+  PointXYZIF pt;
+  pt.x = 1.0F;
+  pt.intensity = 2.0F;
+  pt.id = 42U;
+  ASSERT_TRUE(add_point_to_cloud_raw(msg, pt, 9U));
+  EXPECT_FALSE(add_point_to_cloud_raw(msg, pt, 10U));
+  const auto * const read_pt = reinterpret_cast<const PointXYZIF *>(&msg.data[9U * msg.point_step]);
+  EXPECT_EQ(read_pt->x, 1.0F);
+  EXPECT_EQ(read_pt->intensity, 2.0F);
+  EXPECT_EQ(read_pt->id, 42U);
+
+  // The padded layout survives a reset
+  uint32_t point_idx = 5U;
+  reset_pcl_msg(msg, 20U, point_idx);
+  EXPECT_EQ(point_idx, 0U);
+  EXPECT_EQ(msg.data.size(), 20U * sizeof(PointXYZIF));
+  EXPECT_TRUE(has_pointxyzif_layout(msg));
+
+  sensor_msgs::msg::PointCloud2 no_id_msg;
+  init_pcl_msg(no_id_msg, "lidar", 10U);
+  EXPECT_FALSE(has_pointxyzif_layout(no_id_msg));
+}
+
+TEST(TestPointCloudUtils, add_points_to_cloud_raw)
+{
+  using autoware::common::lidar_utils::add_points_to_cloud_raw;
+  using autoware::common::lidar_utils::init_pcl_msg;
+  using autoware::common::lidar_utils::init_pcl_msg_with_id;
+  using autoware::common::lidar_utils::PointCloudView;
+  using autoware::common::types::PointXYZI;
+  using autoware::common::types::PointXYZIF;
+
+  std::vector<PointXYZIF> points(6U);
+  for (uint32_t idx = 0U; idx < points.size(); ++idx) {
+    points[idx].x = static_cast<float32_t>(idx);
+    points[idx].intensity = 3.0F;
+    points[idx].id = static_cast<uint16_t>(idx + 100U);
+  }
+
+  // Same layout as the point: a single copy
+  sensor_msgs::msg::PointCloud2 msg;
+  init_pcl_msg_with_id(msg, "lidar", 10U);
+  uint32_t point_idx = 0U;
+  EXPECT_EQ(add_points_to_cloud_raw(msg, points.data(), points.size(), point_idx), 6U);
+  EXPECT_EQ(point_idx, 6U);
+  // Only the points that fit are added
+  EXPECT_EQ(add_points_to_cloud_raw(msg, points.data(), points.size(), point_idx), 4U);
+  EXPECT_EQ(point_idx, 10U);
+  EXPECT_EQ(add_points_to_cloud_raw(msg, points.data(), points.size(), point_idx), 0U);
+  const PointCloudView<PointXYZIF> view{msg};
+  EXPECT_FLOAT_EQ(view[5U].x, 5.0F);
+  EXPECT_EQ(view[5U].id, 105U);
+  EXPECT_FLOAT_EQ(view[9U].x, 3.0F);
+  EXPECT_EQ(view[9U].id, 103U);
+
+  // Without the id, the leading fields of each point are copied
+  sensor_msgs::msg::PointCloud2 no_id_msg;
+  init_pcl_msg(no_id_msg, "lidar", 4U);
+  point_idx = 1U;
+  EXPECT_EQ(add_points_to_cloud_raw(no_id_msg, points.data(), points.size(), point_idx), 3U);
+  EXPECT_EQ(point_idx, 4U);
+  const PointCloudView<PointXYZI> no_id_view{no_id_msg};
+  EXPECT_FLOAT_EQ(no_id_view[3U].x, 2.0F);
+  EXPECT_FLOAT_EQ(no_id_view[3U].intensity, 3.0F);
+}
+
+TEST(TestPointCloudUtils, point_cloud_view)
+{
+  using autoware::common::lidar_utils::add_point_to_cloud_raw;
+  using autoware::common::lidar_utils::create_custom_pcl;
+  using autoware::common::lidar_utils::init_pcl_msg_with_id;
+  using autoware::common::lidar_utils::PointCloudView;
+  using autoware::common::types::PointXYZI;
+  using autoware::common::types::PointXYZIF;
+
+  // Same layout as the point, id included
+  sensor_msgs::msg::PointCloud2 msg;
+  init_pcl_msg_with_id(msg, "lidar", 10U);
+  for (uint32_t idx = 0U; idx < 10U; ++idx) {
+    PointXYZIF pt;
+    pt.x = static_cast<float32_t>(idx);
+    pt.y = 1.0F;
+    pt.z = 2.0F;
+    pt.intensity = 3.0F;
+    pt.id = static_cast<uint16_t>(idx + 100U);
+    ASSERT_TRUE(add_point_to_cloud_raw(msg, pt, idx));
+  }
+  const PointCloudView<PointXYZIF> view{msg};
+  ASSERT_EQ(view.size(), 10U);
+  EXPECT_TRUE(view.has_field(4U));
+  EXPECT_FLOAT_EQ(view[7U].x, 7.0F);
+  EXPECT_FLOAT_EQ(view[7U].intensity, 3.0F);
+  EXPECT_EQ(view[7U].id, 107U);
+  // Only read the leading fields
+  const PointCloudView<PointXYZIF> xyzi_view{msg, 3U, 4U};
+  EXPECT_FALSE(xyzi_view.has_field(4U));
+  EXPECT_FLOAT_EQ(xyzi_view[7U].intensity, 3.0F);
+  EXPECT_EQ(xyzi_view[7U].id, 0U);
+
+  // Fields in another order are found by name
+  const auto reordered = create_custom_pcl<float32_t>({"intensity", "z", "y", "x", "t"}, 3U);
+  for (uint32_t idx = 0U; idx < 15U; ++idx) {
+    const auto value = static_cast<float32_t>(idx);
+    std::memcpy(&reordered->data[idx * sizeof(float32_t)], &value, sizeof(float32_t));
+  }
+  const PointCloudView<PointXYZI> reordered_view{*reordered};
+  ASSERT_EQ(reordered_view.size(), 3U);
+  EXPECT_FLOAT_EQ(reordered_view[1U].x, 8.0F);
+  EXPECT_FLOAT_EQ(reordered_view[1U].y, 7.0F);
+  EXPECT_FLOAT_EQ(reordered_view[1U].z, 6.0F);
+  EXPECT_FLOAT_EQ(reordered_view[1U].intensity, 5.0F);
+
+  // Intensity of another datatype is optional, but x, y and z are not
+  const auto uint8_intensity = create_custom_pcl<float32_t>({"x", "y", "z", "intensity"}, 3U);
+  uint8_intensity->fields[3U].datatype = sensor_msgs::msg::PointField::UINT8;
+  const PointCloudView<PointXYZI> uint8_view{*uint8_intensity, 3U};
+  EXPECT_FALSE(uint8_view.has_field(3U));
+  EXPECT_FLOAT_EQ(uint8_view[2U].intensity, 0.0F);
+  EXPECT_THROW(PointCloudView<PointXYZI>{*uint8_intensity}, std::runtime_error);
+  const auto no_z = create_custom_pcl<float32_t>({"x", "y", "w"}, 3U);
+  EXPECT_THROW(PointCloudView<PointXYZI>(*no_z, 3U), std::runtime_error);
+
+  // Malformed clouds
+  sensor_msgs::msg::PointCloud2 short_msg = msg;
+  short_msg.data.resize(short_msg.data.size() - 1U);
+  EXPECT_THROW(PointCloudView<PointXYZIF>{short_msg}, std::runtime_error);
+  sensor_msgs::msg::PointCloud2 small_step_msg = msg;
+  small_step_msg.point_step = 16U;
+  small_step_msg.width = 12U;
+  EXPECT_THROW(PointCloudView<PointXYZIF>{small_step_msg}, std::runtime_error);
+  EXPECT_NO_THROW(PointCloudView<PointXYZIF>(small_step_msg, 4U));
+}
+
 TEST(TestStaticTransformer, TransformPoint)
 {
   Eigen::Quaternionf rotation;
@@ -84,3 +298,181 @@ TEST(TestStaticTransformer, TransformPoint)
   EXPECT_FLOAT_EQ(7.0F, result_point.y);
   EXPECT_FLOAT_EQ(8.0F, result_point.z);
 }
+
+TEST(TestStaticTransformer, TransformBatch)
+{
+  Eigen::Quaternionf rotation;
+  rotation = Eigen::AngleAxisf(0.3F, Eigen::Vector3f{1.0F, 2.0F, 3.0F}.normalized());
+  geometry_msgs::msg::Transform tf;
+  tf.translation.x = 1.0;
+  tf.translation.y = -2.0;
+  tf.translation.z = 3.0;
+  tf.rotation.x = static_cast<float64_t>(rotation.x());
+  tf.rotation.y = static_cast<float64_t>(rotation.y());
+  tf.rotation.z = static_cast<float64_t>(rotation.z());
+  tf.rotation.w = static_cast<float64_t>(rotation.w());
+  autoware::common::lidar_utils::StaticTransformer transformer{tf};
+
+  std::vector<float32_t> xs{5.0F, -1.0F, 0.0F, 10.0F, 3.5F};
+  std::vector<float32_t> ys{5.0F, 2.0F, 0.0F, -7.0F, 0.25F};
+  std::vector<float32_t> zs{5.0F, 0.5F, 0.0F, 1.0F, -2.0F};
+  std::vector<float32_t> xs_out(xs.size());
+  std::vector<float32_t> ys_out(xs.size());
+  std::vector<float32_t> zs_out(xs.size());
+  transformer.transform(
+    xs.data(), ys.data(), zs.data(), xs.size(), xs_out.data(), ys_out.data(), zs_out.data());
+  for (std::size_t i = 0U; i < xs.size(); ++i) {
+    const autoware::common::types::PointXYZF point{xs[i], ys[i], zs[i]};
+    autoware::common::types::PointXYZF result_point{};
+    transformer.transform(point, result_point);
+    EXPECT_FLOAT_EQ(result_point.x, xs_out[i]);
+    EXPECT_FLOAT_EQ(result_point.y, ys_out[i]);
+    EXPECT_FLOAT_EQ(result_point.z, zs_out[i]);
+  }
+
+  // In place
+  transformer.transform(
+    xs.data(), ys.data(), zs.data(), xs.size(), xs.data(), ys.data(), zs.data());
+  EXPECT_EQ(xs, xs_out);
+  EXPECT_EQ(ys, ys_out);
+  EXPECT_EQ(zs, zs_out);
+}
+
+TEST(TestPointCloudUtils, filter_batch_matches_point_wise)
+{
+  using autoware::common::lidar_utils::AngleFilter;
+  using autoware::common::lidar_utils::DistanceFilter;
+  using autoware::common::types::PointXYZIF;
+  std::vector<float32_t> xs;
+  std::vector<float32_t> ys;
+  std::vector<float32_t> zs;
+  for (float32_t x = -12.0F; x <= 12.0F; x += 0.5F) {
+    for (float32_t y = -12.0F; y <= 12.0F; y += 0.5F) {
+      xs.push_back(x);
+      ys.push_back(y);
+      zs.push_back(0.1F * x);
+    }
+  }
+  xs.push_back(std::numeric_limits<float32_t>::quiet_NaN());
+  ys.push_back(1.0F);
+  zs.push_back(1.0F);
+
+  // Small and wide angle ranges, and a range of exactly half a turn
+  const std::vector<AngleFilter> angle_filters{
+    AngleFilter{0.0F, 1.0F}, AngleFilter{-1.0F, 4.0F}, AngleFilter{0.5F, 0.5F + AngleFilter::PI}};
+  for (const auto & angle_filter : angle_filters) {
+    std::vector<uint8_t> keep(xs.size(), 1U);
+    angle_filter.apply(xs.data(), ys.data(), xs.size(), keep.data());
+    for (std::size_t i = 0U; i < xs.size(); ++i) {
+      PointXYZIF pt;
+      pt.x = xs[i];
+      pt.y = ys[i];
+      pt.z = zs[i];
+      EXPECT_EQ(angle_filter(pt), keep[i] == 1U) << i;
+    }
+  }
+
+  const DistanceFilter distance_filter{2.0F, 10.0F};
+  std::vector<uint8_t> keep(xs.size(), 1U);
+  distance_filter.apply(xs.data(), ys.data(), zs.data(), xs.size(), keep.data());
+  for (std::size_t i = 0U; i < xs.size(); ++i) {
+    PointXYZIF pt;
+    pt.x = xs[i];
+    pt.y = ys[i];
+    pt.z = zs[i];
+    EXPECT_EQ(distance_filter(pt), keep[i] == 1U) << i;
+  }
+
+  // Points that are already removed stay removed
+  std::vector<uint8_t> removed(xs.size(), 0U);
+  distance_filter.apply(xs.data(), ys.data(), zs.data(), xs.size(), removed.data());
+  EXPECT_EQ(removed, std::vector<uint8_t>(xs.size(), 0U));
+}
+
+TEST(TestPointCloudUtils, filter_and_transform_points)
+{
+  using autoware::common::lidar_utils::AngleFilter;
+  using autoware::common::lidar_utils::DistanceFilter;
+  using autoware::common::lidar_utils::StaticTransformer;
+  using autoware::common::lidar_utils::add_point_to_cloud;
+  using autoware::common::lidar_utils::filter_and_transform_points;
+  using autoware::common::lidar_utils::init_pcl_msg;
+  using autoware::common::types::PointXYZIF;
+
+  // More points than a block of the kernel
+  constexpr uint32_t num_points = 1000U;
+  sensor_msgs::msg::PointCloud2 input;
+  init_pcl_msg(input, "lidar", num_points);
+  std::vector<PointXYZIF> points;
+  uint32_t input_idx = 0U;
+  for (uint32_t i = 0U; i < num_points; ++i) {
+    PointXYZIF pt;
+    const float32_t angle = 0.01F * static_cast<float32_t>(i);
+    const float32_t radius = 0.02F * static_cast<float32_t>(i);
+    pt.x = radius * std::cos(angle);
+    pt.y = radius * std::sin(angle);
+    pt.z = 0.5F;
+    pt.intensity = static_cast<float32_t>(i);
+    points.push_back(pt);
+    ASSERT_TRUE(add_point_to_cloud(input, pt, input_idx));
+  }
+
+  geometry_msgs::msg::Transform tf;
+  tf.translation.x = 1.0;
+  tf.rotation.z = std::sin(0.25);
+  tf.rotation.w = std::cos(0.25);
+  const StaticTransformer transformer{tf};
+  const AngleFilter angle_filter{0.0F, 3.0F};
+  const DistanceFilter distance_filter{1.0F, 15.0F};
+
+  // Expected output of the point-wise filters and transform
+  std::vector<PointXYZIF> expected;
+  for (const auto & pt : points) {
+    if (angle_filter(pt) && distance_filter(pt)) {
+      PointXYZIF out;
+      transformer.transform(pt, out);
+      out.intensity = pt.intensity;
+      expected.push_back(out);
+    }
+  }
+  ASSERT_GT(expected.size(), 256U);
+
+  sensor_msgs::msg::PointCloud2 output;
+  init_pcl_msg(output, "base_link", num_points);
+  uint32_t output_idx = 0U;
+  ASSERT_TRUE(
+    filter_and_transform_points(
+      input, angle_filter, distance_filter, transformer, output, output_idx));
+  ASSERT_EQ(output_idx, expected.size());
+  sensor_msgs::PointCloud2ConstIterator<float32_t> x_it(output, "x");
+  sensor_msgs::PointCloud2ConstIterator<float32_t> y_it(output, "y");
+  sensor_msgs::PointCloud2ConstIterator<float32_t> z_it(output, "z");
+  sensor_msgs::PointCloud2ConstIterator<float32_t> intensity_it(output, "intensity");
+  for (const auto & pt : expected) {
+    EXPECT_FLOAT_EQ(*x_it, pt.x);
+    EXPECT_FLOAT_EQ(*y_it, pt.y);
+    EXPECT_FLOAT_EQ(*z_it, pt.z);
+    EXPECT_FLOAT_EQ(*intensity_it, pt.intensity);
+    ++x_it;
+    ++y_it;
+    ++z_it;
+    ++intensity_it;
+  }
+
+  // Not enough capacity, the points that fit are added
+  sensor_msgs::msg::PointCloud2 small_output;
+  init_pcl_msg(small_output, "base_link", 10U);
+  output_idx = 0U;
+  EXPECT_FALSE(
+    filter_and_transform_points(
+      input, angle_filter, distance_filter, transformer, small_output, output_idx));
+  EXPECT_EQ(output_idx, 10U);
+
+  // Missing field
+  sensor_msgs::msg::PointCloud2 no_z_input = input;
+  no_z_input.fields[2U].name = "w";
+  EXPECT_THROW(
+    filter_and_transform_points(
+      no_z_input, angle_filter, distance_filter, transformer, output, output_idx),
+    std::runtime_error);
+}
@@ -20,6 +20,7 @@
 #ifndef MEASUREMENT_CONVERSION__MEASUREMENT_TRANSFORMATION_HPP_
 #define MEASUREMENT_CONVERSION__MEASUREMENT_TRANSFORMATION_HPP_
 
+#include <autoware_auto_msgs/msg/detected_objects.hpp>
 #include <measurement_conversion/eigen_utils.hpp>
 #include <measurement_conversion/measurement_conversion.hpp>
 #include <measurement_conversion/measurement_typedefs.hpp>
@@ -69,6 +70,26 @@ MeasurementT message_to_transformed_measurement(
   return transform_measurement(measurement, tf__world__frame_id);
 }
 
+///
+/// @brief      Convert the centroid positions of all detected objects of a message into position
+///             measurements and transform them into a different coordinate frame.
+///
+/// @details    This is the batched version of message_to_transformed_measurement for
+///             measurements of all objects of a frame. The transform is decomposed once and the
+///             covariances are read directly from the messages. The covariance is converted even
+///             if `has_position_covariance` is not set, then it is whatever the message holds.
+///
+/// @param[in]  msg                  The detected objects, all in the same frame.
+/// @param[in]  tf__world__frame_id  The transform from the frame of the message into the world
+///                                  frame.
+/// @param[out] measurements         One measurement per object, in the order of the objects. It is
+///                                  resized to the number of objects and only allocates if it
+///                                  grows beyond its capacity.
+///
+MEASUREMENT_CONVERSION_PUBLIC void detections_to_transformed_measurements(
+  const autoware_auto_msgs::msg::DetectedObjects & msg,
+  const Eigen::Isometry3d & tf__world__frame_id,
+  MeasurementVector<PoseMeasurementXYZ64> & measurements);
 
 // Doxygen is buggy when the parameters are repeated here, so they are omitted.
 
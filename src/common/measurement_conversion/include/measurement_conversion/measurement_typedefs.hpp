@@ -24,6 +24,10 @@
 #include <state_estimation/measurement/linear_measurement.hpp>
 #include <state_vector/common_variables.hpp>
 
+#include <Eigen/StdVector>
+
+#include <vector>
+
 namespace autoware
 {
 namespace common
@@ -61,6 +65,10 @@ using PoseMeasurementXYZRPY = LinearMeasurement<state_vector::GenericState<Scala
 using PoseMeasurementXYZRPY32 = PoseMeasurementXYZRPY<common::types::float32_t>;
 using PoseMeasurementXYZRPY64 = PoseMeasurementXYZRPY<common::types::float64_t>;
 
+/// A contiguous array of measurements, e.g. for converting all objects of a message at once.
+template<typename MeasurementT>
+using MeasurementVector = std::vector<MeasurementT, Eigen::aligned_allocator<MeasurementT>>;
+
 
 }  // namespace state_estimation
 }  // namespace common
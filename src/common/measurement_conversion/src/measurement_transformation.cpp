@@ -19,6 +19,21 @@
 
 #include <measurement_conversion/measurement_transformation.hpp>
 
+#include <common/types.hpp>
+
+#include <tuple>
+
+namespace
+{
+using autoware::common::types::float64_t;
+using RowMajorMatrix3d = Eigen::Matrix<float64_t, 3, 3, Eigen::RowMajor>;
+
+static_assert(
+  std::tuple_size<
+    autoware_auto_msgs::msg::DetectedObjectKinematics::_position_covariance_type>::value == 9U,
+  "We expect the DetectedObjectKinematics position covariance to have 9 entries.");
+}  // namespace
+
 namespace autoware
 {
 namespace common
@@ -49,6 +64,26 @@ Stamped<PoseMeasurementXYZ64> transform_measurement(
     transform_measurement(measurement.measurement, tf__world__frame_id)};
 }
 
+void detections_to_transformed_measurements(
+  const autoware_auto_msgs::msg::DetectedObjects & msg,
+  const Eigen::Isometry3d & tf__world__frame_id,
+  MeasurementVector<PoseMeasurementXYZ64> & measurements)
+{
+  const Eigen::Matrix3d rotation = tf__world__frame_id.linear();
+  const Eigen::Vector3d translation = tf__world__frame_id.translation();
+  measurements.resize(msg.objects.size());
+  for (std::size_t i = 0U; i < msg.objects.size(); ++i) {
+    const auto & kinematics = msg.objects[i].kinematics;
+    const auto & position = kinematics.centroid_position;
+    auto & measurement = measurements[i];
+    measurement.state().vector() =
+      rotation * Eigen::Vector3d{position.x, position.y, position.z} + translation;
+    measurement.covariance() =
+      rotation * Eigen::Map<const RowMajorMatrix3d>{kinematics.position_covariance.data()} *
+      rotation.transpose();
+  }
+}
+
 }  // namespace state_estimation
 }  // namespace common
 }  // namespace autoware
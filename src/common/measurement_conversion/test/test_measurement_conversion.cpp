@@ -21,11 +21,15 @@
 
 #include <common/types.hpp>
 #include <measurement_conversion/measurement_conversion.hpp>
+#include <measurement_conversion/measurement_transformation.hpp>
 
 using autoware::common::state_estimation::Stamped;
 using autoware::common::state_estimation::PoseMeasurementXYZ64;
 using autoware::common::state_estimation::PoseMeasurementXYZRPY64;
 using autoware::common::state_estimation::convert_to;
+using autoware::common::state_estimation::detections_to_transformed_measurements;
+using autoware::common::state_estimation::message_to_transformed_measurement;
+using autoware::common::state_estimation::MeasurementVector;
 using autoware::common::state_vector::variable::X;
 using autoware::common::state_vector::variable::Y;
 using autoware::common::state_vector::variable::Z;
@@ -131,3 +135,40 @@ TEST(MeasurementConversionTest, Pose) {
     measurement.timestamp.time_since_epoch(),
     std::chrono::seconds{42LL});
 }
+
+/// \test Convert all detections of a message at once.
+TEST(MeasurementConversionTest, DetectedObjects) {
+  autoware_auto_msgs::msg::DetectedObjects msg{};
+  msg.header = create_header();
+  const auto relative_pos_msg = create_relative_pos_msg();
+  msg.objects.resize(2U);
+  msg.objects[0U].kinematics.centroid_position = relative_pos_msg.position;
+  msg.objects[0U].kinematics.position_covariance = relative_pos_msg.covariance;
+  msg.objects[1U].kinematics.centroid_position.x = -1.0;
+  msg.objects[1U].kinematics.position_covariance[1] = 0.5;
+  msg.objects[1U].kinematics.position_covariance[3] = 0.5;
+  // Rotation around z axis by 90 degrees.
+  Eigen::Isometry3d tf__world__frame_id{Eigen::AngleAxisd{M_PI_2, Eigen::Vector3d::UnitZ()}};
+  tf__world__frame_id.translation() = Eigen::Vector3d{1.0, 2.0, 3.0};
+
+  // The vector is resized to the number of objects.
+  MeasurementVector<PoseMeasurementXYZ64> measurements(5U);
+  detections_to_transformed_measurements(msg, tf__world__frame_id, measurements);
+  ASSERT_EQ(measurements.size(), 2U);
+  // The same as converting and transforming each object on its own.
+  const auto expected = message_to_transformed_measurement<PoseMeasurementXYZ64>(
+    relative_pos_msg, tf__world__frame_id);
+  EXPECT_TRUE(measurements[0U].state().vector().isApprox(expected.state().vector()));
+  EXPECT_TRUE(measurements[0U].covariance().isApprox(expected.covariance()));
+  EXPECT_DOUBLE_EQ(measurements[0U].covariance()(0, 0), relative_pos_msg.covariance[4]);
+  EXPECT_DOUBLE_EQ(measurements[1U].state().at<X>(), 1.0);
+  EXPECT_DOUBLE_EQ(measurements[1U].state().at<Y>(), 1.0);
+  EXPECT_DOUBLE_EQ(measurements[1U].state().at<Z>(), 3.0);
+  // The correlation of x and y changes its sign.
+  EXPECT_DOUBLE_EQ(measurements[1U].covariance()(0, 1), -0.5);
+  EXPECT_DOUBLE_EQ(measurements[1U].covariance()(1, 0), -0.5);
+
+  msg.objects.clear();
+  detections_to_transformed_measurements(msg, tf__world__frame_id, measurements);
+  EXPECT_TRUE(measurements.empty());
+}
@@ -52,17 +52,15 @@ protected:
   ///
   /// @brief      A crtp-called function that predicts the state forward.
   ///
+  /// @details    Applies the closed form of the transition for every variable, without forming the
+  ///             Jacobian.
+  ///
   /// @param[in]  state  The current state vector
   /// @param[in]  dt     Time difference
   ///
   /// @return     New state after prediction.
   ///
-  inline State crtp_predict(
-    const State & state,
-    const std::chrono::nanoseconds & dt) const
-  {
-    return State{crtp_jacobian(state, dt) * state.vector()};
-  }
+  State crtp_predict(const State & state, const std::chrono::nanoseconds & dt) const;
 
   ///
   /// @brief      A crtp-called function that computes a Jacobian.
@@ -74,6 +72,23 @@ protected:
   /// @return     A matrix that represents the Jacobian.
   ///
   typename State::Matrix crtp_jacobian(const State &, const std::chrono::nanoseconds & dt) const;
+
+  ///
+  /// @brief      A crtp-called function that propagates a covariance with the Jacobian.
+  ///
+  /// @details    The Jacobian only has the same 3x3 block for every variable on its diagonal, so
+  ///             every 3x3 block of the covariance is propagated on its own instead of
+  ///             multiplying the full matrices.
+  ///
+  /// @param[in]  covariance  The covariance to propagate.
+  /// @param[in]  dt          Time difference
+  ///
+  /// @return     The propagated covariance.
+  ///
+  typename State::Matrix crtp_propagate_covariance(
+    const State &,
+    const typename State::Matrix & covariance,
+    const std::chrono::nanoseconds & dt) const;
 };
 
 }  // namespace motion_model
@@ -75,6 +75,48 @@ public:
       "\n\nStateT must be a GenericState\n\n");
     return this->impl().crtp_jacobian(state, dt);
   }
+  ///
+  /// @brief      Propagate a state covariance through this motion model.
+  ///
+  /// @details    This is J * P * J^T for the Jacobian J. Motion models that know the structure of
+  ///             their Jacobian can implement crtp_propagate_covariance to skip the zero entries
+  ///             of the Jacobian or to not form it at all. Otherwise, the Jacobian is only
+  ///             computed here, i.e., when the covariance is needed and not on every prediction.
+  ///
+  /// @param[in]  state       The state at which the Jacobian is evaluated.
+  /// @param[in]  covariance  The covariance to propagate.
+  /// @param[in]  dt          Time span.
+  ///
+  /// @tparam     StateT      Type of the state.
+  ///
+  /// @return     The propagated covariance, without any process noise.
+  ///
+  template<typename StateT>
+  inline auto propagate_covariance(
+    const StateT & state,
+    const typename StateT::Matrix & covariance,
+    const std::chrono::nanoseconds & dt) const
+  {
+    static_assert(
+      common::state_vector::is_state<StateT>::value,
+      "\n\nStateT must be a GenericState\n\n");
+    return this->impl().crtp_propagate_covariance(state, covariance, dt);
+  }
+
+protected:
+  ///
+  /// @brief      Default covariance propagation with the dense Jacobian, used unless the motion
+  ///             model implements its own.
+  ///
+  template<typename StateT>
+  typename StateT::Matrix crtp_propagate_covariance(
+    const StateT & state,
+    const typename StateT::Matrix & covariance,
+    const std::chrono::nanoseconds & dt) const
+  {
+    const typename StateT::Matrix motion_jacobian = jacobian(state, dt);
+    return motion_jacobian * covariance * motion_jacobian.transpose();
+  }
 };
 
 }  // namespace motion_model
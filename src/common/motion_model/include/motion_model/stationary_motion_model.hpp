@@ -69,6 +69,19 @@ protected:
   {
     return Eigen::Matrix<typename State::Scalar, State::size(), State::size()>::Identity();
   }
+
+  ///
+  /// @brief      A crtp-called function that propagates a covariance with the identity Jacobian.
+  ///
+  /// @return     The unchanged covariance.
+  ///
+  typename State::Matrix crtp_propagate_covariance(
+    const State &,
+    const typename State::Matrix & covariance,
+    const std::chrono::nanoseconds &) const
+  {
+    return covariance;
+  }
 };
 
 }  // namespace motion_model
@@ -57,6 +57,41 @@ namespace common
 namespace motion_model
 {
 
+template<typename StateT>
+StateT LinearMotionModel<StateT>::crtp_predict(
+  const State & state, const std::chrono::nanoseconds & dt) const
+{
+  using ScalarT = typename State::Scalar;
+  const auto t = std::chrono::duration<float64_t>{dt}.count();
+  const auto t_scalar = static_cast<ScalarT>(t);
+  const auto half_t2 = static_cast<ScalarT>(0.5 * t * t);
+  State result{state};
+  auto & vector = result.vector();
+  for (int i = 0; i < State::size(); i += 3) {
+    vector[i] += t_scalar * vector[i + 1] + half_t2 * vector[i + 2];
+    vector[i + 1] += t_scalar * vector[i + 2];
+  }
+  return result;
+}
+
+template<typename StateT>
+typename StateT::Matrix
+LinearMotionModel<StateT>::crtp_propagate_covariance(
+  const State &, const typename State::Matrix & covariance,
+  const std::chrono::nanoseconds & dt) const
+{
+  using ScalarT = typename State::Scalar;
+  const Eigen::Matrix<ScalarT, 3, 3> block{create_single_variable_block<ScalarT>(dt)};
+  typename State::Matrix result;
+  for (int row = 0; row < State::size(); row += 3) {
+    for (int col = 0; col < State::size(); col += 3) {
+      result.template block<3, 3>(row, col).noalias() =
+        block * covariance.template block<3, 3>(row, col) * block.transpose();
+    }
+  }
+  return result;
+}
+
 template<typename StateT>
 typename StateT::Matrix
 LinearMotionModel<StateT>::crtp_jacobian(
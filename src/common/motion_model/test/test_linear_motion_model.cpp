@@ -22,6 +22,7 @@
 using autoware::common::motion_model::LinearMotionModel;
 using autoware::common::state_vector::ConstAccelerationXY32;
 using autoware::common::state_vector::ConstAccelerationXYYaw32;
+using autoware::common::state_vector::ConstAccelerationXYZRPY64;
 using autoware::common::state_vector::variable::X;
 using autoware::common::state_vector::variable::Y;
 using autoware::common::state_vector::variable::YAW;
@@ -62,3 +63,25 @@ TEST(LinearMotionModel, PredictConstAccelerationXY) {
   EXPECT_FLOAT_EQ(1.1F, state.at<Y_VELOCITY>());
   EXPECT_FLOAT_EQ(1.0F, state.at<Y_ACCELERATION>());
 }
+
+/// @test Test that the closed forms give the same results as the Jacobian.
+TEST(LinearMotionModel, ClosedFormsMatchJacobian) {
+  using State = ConstAccelerationXYZRPY64;
+  State state{};
+  State::Matrix covariance{State::Matrix::Identity()};
+  for (auto i = 0; i < State::size(); ++i) {
+    state.vector()[i] = 0.5 * i - 3.0;
+    for (auto j = 0; j < i; ++j) {
+      covariance(i, j) = 0.01 * (i + j);
+      covariance(j, i) = covariance(i, j);
+    }
+  }
+  LinearMotionModel<State> motion_model{};
+  const std::chrono::milliseconds dt{150};
+  const State::Matrix jacobian = motion_model.jacobian(state, dt);
+  EXPECT_TRUE(
+    motion_model.predict(state, dt).vector().isApprox(jacobian * state.vector(), 1.0e-12));
+  EXPECT_TRUE(
+    motion_model.propagate_covariance(state, covariance, dt).isApprox(
+      jacobian * covariance * jacobian.transpose(), 1.0e-12));
+}
@@ -22,6 +22,8 @@
 #include <optimization/optimizer_options.hpp>
 #include <optimization/line_search/line_search.hpp>
 #include <Eigen/SVD>
+#include <algorithm>
+#include <chrono>
 #include <limits>
 #include <memory>
 #include <cmath>
@@ -52,6 +54,16 @@ public:
 
   /// Solves `x_out` for an objective `optimization_problem` and an initial value `x0`
   ///
+  /// The line search only computes the score and the jacobian. The hessian is computed lazily at
+  /// the beginning of each iteration, and all evaluations go through an `EvaluationTracker`, so
+  /// the score and the jacobian computed by the line search at the accepted step are not
+  /// recomputed, and the hessian is not computed at all at a step that terminates the
+  /// optimization.
+  ///
+  /// If the options have a time budget, no iteration is started that would likely end after it,
+  /// judging by the longest iteration so far. The optimization then terminates with
+  /// `TIME_BUDGET_EXCEEDED` and the latest iterate.
+  ///
   /// @param      optimization_problem  optimization_problem optimization objective
   /// @param      x0                    initial value
   /// @param      x_out                 optimized value
@@ -73,34 +85,57 @@ public:
     using Value = typename OptimizationProblemT::Value;
     using Jacobian = typename OptimizationProblemT::Jacobian;
     using Hessian = typename OptimizationProblemT::Hessian;
+    using Clock = std::chrono::steady_clock;
+    const auto start_time = Clock::now();
     TerminationType termination_type{TerminationType::NO_CONVERGENCE};
     Value score_previous{0.0};
     Jacobian jacobian{Jacobian{}.setZero()};
     Hessian hessian{Hessian{}.setZero()};
     DomainValueT opt_direction{DomainValueT{}.setZero()};
+    std::chrono::nanoseconds max_iteration_duration{std::chrono::nanoseconds::zero()};
 
     if (!x0.allFinite()) {   // Early exit for invalid input.
       return OptimizationSummary{0.0, TerminationType::FAILURE, 0UL};
     }
 
+    EvaluationTracker<OptimizationProblemT> problem{optimization_problem};
+    const auto make_summary = [&problem, &start_time, &max_iteration_duration](
+      float64_t dist, TerminationType termination, uint64_t iter) {
+        return OptimizationSummary{dist, termination, iter, problem.evaluation_counts(),
+          std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start_time),
+          max_iteration_duration};
+      };
+
     // Initialize
     x_out = x0;
 
-    // Get score, Jacobian and Hessian (pre-computed using evaluate)
-    optimization_problem.evaluate(x_out, ComputeMode{}.set_score().set_jacobian().set_hessian());
-    score_previous = optimization_problem(x_out);
-    optimization_problem.jacobian(x_out, jacobian);
-    optimization_problem.hessian(x_out, hessian);
+    // Get score and Jacobian (pre-computed using evaluate)
+    problem.evaluate(x_out, ComputeMode{}.set_score().set_jacobian());
+    score_previous = problem(x_out);
+    problem.jacobian(x_out, jacobian);
 
     // Early exit if the initial solution is good enough.
     if (jacobian.template lpNorm<Eigen::Infinity>() <= m_options.gradient_tolerance()) {
       // As there's no newton solution yet, jacobian can be a good substitute.
-      return OptimizationSummary{jacobian.norm(), TerminationType::CONVERGENCE, 0UL};
+      return make_summary(jacobian.norm(), TerminationType::CONVERGENCE, 0UL);
     }
 
     // Iterate until convergence, error, or maximum number of iterations
     auto nr_iterations = 0UL;
+    const auto time_budget = m_options.time_budget();
     for (; nr_iterations < m_options.max_num_iterations(); ++nr_iterations) {
+      if ((time_budget > std::chrono::nanoseconds::zero()) &&
+        ((Clock::now() - start_time) + max_iteration_duration > time_budget))
+      {
+        termination_type = TerminationType::TIME_BUDGET_EXCEEDED;
+        break;
+      }
+      const IterationTimer timer{max_iteration_duration};
+      // Only the hessian is missing at this point: The score and the jacobian were computed
+      // either during initialization or at the end of the previous iteration. Requesting all
+      // terms together still allows the problem to share computations if the cache was missed.
+      problem.evaluate(x_out, ComputeMode{}.set_score().set_jacobian().set_hessian());
+      problem.hessian(x_out, hessian);
       if (!x_out.allFinite() || !jacobian.allFinite() || !hessian.allFinite()) {
         termination_type = TerminationType::FAILURE;
         break;
@@ -122,7 +157,7 @@ public:
       // also needs the sign to know the direction of optimization?
       const auto step = m_line_searcher.compute_next_step(
         x_out, opt_direction,
-        optimization_problem);
+        problem);
       const auto prev_x_norm = x_out.norm();
       x_out += step;
 
@@ -137,11 +172,10 @@ public:
         break;
       }
 
-      // Update value, Jacobian and Hessian (pre-computed using evaluate)
-      optimization_problem.evaluate(x_out, ComputeMode{}.set_score().set_jacobian().set_hessian());
-      const auto score = optimization_problem(x_out);
-      optimization_problem.jacobian(x_out, jacobian);
-      optimization_problem.hessian(x_out, hessian);
+      // Update value and Jacobian. The hessian is only computed if another iteration is needed.
+      problem.evaluate(x_out, ComputeMode{}.set_score().set_jacobian());
+      const auto score = problem(x_out);
+      problem.jacobian(x_out, jacobian);
 
       // Check if the max-norm of the gradient is small enough.
       if (jacobian.template lpNorm<Eigen::Infinity>() <= m_options.gradient_tolerance()) {
@@ -161,10 +195,38 @@ public:
 
     // Returning summary consisting of the following three values:
     // estimated_distance_to_optimum, convergence_tolerance_criteria_met, number_of_iterations_made
-    return OptimizationSummary{opt_direction.norm(), termination_type, nr_iterations};
+    return make_summary(opt_direction.norm(), termination_type, nr_iterations);
+  }
+
+  /// Get the options used for the optimization
+  const OptimizationOptions & options() const noexcept
+  {
+    return m_options;
   }
 
 private:
+  /// Updates the longest iteration duration with the lifetime of this object.
+  class IterationTimer
+  {
+public:
+    explicit IterationTimer(std::chrono::nanoseconds & max_duration)
+    : m_max_duration(max_duration), m_start(std::chrono::steady_clock::now()) {}
+
+    ~IterationTimer()
+    {
+      m_max_duration = std::max(
+        m_max_duration, std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - m_start));
+    }
+
+    IterationTimer(const IterationTimer &) = delete;
+    IterationTimer & operator=(const IterationTimer &) = delete;
+
+private:
+    std::chrono::nanoseconds & m_max_duration;
+    std::chrono::steady_clock::time_point m_start;
+  };
+
   // initialize on construction
   LineSearchT m_line_searcher;
   OptimizationOptions m_options;
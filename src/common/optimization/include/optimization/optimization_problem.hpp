@@ -144,7 +144,7 @@ public:
 
   void hessian_(const DomainValue & x, HessianRef out)
   {
-    if (!m_cache_state.is_cached(x, common::optimization::ExpressionTerm::SCORE)) {
+    if (!m_cache_state.is_cached(x, common::optimization::ExpressionTerm::HESSIAN)) {
       evaluate(x, ComputeMode{}.set_hessian());
     }
     out = m_hessian;
@@ -19,6 +19,7 @@
 
 #include <optimization/optimizer_options.hpp>
 #include <optimization/line_search/line_search.hpp>
+#include <optimization/utils.hpp>
 #include <Eigen/SVD>
 
 namespace autoware
@@ -27,6 +28,90 @@ namespace common
 {
 namespace optimization
 {
+/// Wrapper around an optimization problem that is passed to the line search and used by the
+/// optimizers instead of the problem itself. It keeps track of the terms that were already
+/// requested for the last parameter value and only forwards the missing ones to `evaluate()`.
+/// This way, an optimizer can request the hessian for a point that was already evaluated by the
+/// line search without recomputing the score and the jacobian. The forwarded terms are counted.
+/// \tparam OptimizationProblemT Optimization problem type.
+template<typename OptimizationProblemT>
+class EvaluationTracker
+{
+public:
+  using DomainValue = typename OptimizationProblemT::DomainValue;
+  using Value = typename OptimizationProblemT::Value;
+  using Jacobian = typename OptimizationProblemT::Jacobian;
+  using Hessian = typename OptimizationProblemT::Hessian;
+  using JacobianRef = typename OptimizationProblemT::JacobianRef;
+  using HessianRef = typename OptimizationProblemT::HessianRef;
+
+  /// Constructor
+  /// \param problem Optimization problem to wrap. It must outlive the tracker.
+  explicit EvaluationTracker(OptimizationProblemT & problem)
+  : m_problem(problem) {}
+
+  /// Evaluate the terms of `mode` that were not yet requested for `x`.
+  /// \param x Parameter value.
+  /// \param mode Terms to be computed.
+  void evaluate(const DomainValue & x, const ComputeMode & mode)
+  {
+    if (!m_has_value || (x != m_last_value)) {
+      m_last_value = x;
+      m_has_value = true;
+      m_evaluated = ComputeMode{};
+    }
+    const ComputeMode missing{mode.score() && !m_evaluated.score(),
+      mode.jacobian() && !m_evaluated.jacobian(), mode.hessian() && !m_evaluated.hessian()};
+    if (!missing.score() && !missing.jacobian() && !missing.hessian()) {
+      return;
+    }
+    m_problem.evaluate(x, missing);
+    m_counts.score += missing.score() ? 1U : 0U;
+    m_counts.jacobian += missing.jacobian() ? 1U : 0U;
+    m_counts.hessian += missing.hessian() ? 1U : 0U;
+    m_evaluated = ComputeMode{m_evaluated.score() || missing.score(),
+      m_evaluated.jacobian() || missing.jacobian(), m_evaluated.hessian() || missing.hessian()};
+  }
+
+  /// Get the score at a given parameter value.
+  /// \param x Parameter value
+  /// \return Evaluated score
+  Value operator()(const DomainValue & x)
+  {
+    return m_problem(x);
+  }
+
+  /// Get the jacobian at a given parameter value.
+  /// \param x Parameter value.
+  /// \param out Evaluated jacobian matrix.
+  void jacobian(const DomainValue & x, JacobianRef out)
+  {
+    m_problem.jacobian(x, out);
+  }
+
+  /// Get the hessian at a given parameter value.
+  /// \param x Parameter value.
+  /// \param out Evaluated hessian matrix.
+  void hessian(const DomainValue & x, HessianRef out)
+  {
+    m_problem.hessian(x, out);
+  }
+
+  /// Get the number of forwarded evaluations of each term.
+  /// \return Evaluation counts.
+  const EvaluationCounts & evaluation_counts() const noexcept
+  {
+    return m_counts;
+  }
+
+private:
+  OptimizationProblemT & m_problem;
+  DomainValue m_last_value;
+  bool8_t m_has_value{false};
+  ComputeMode m_evaluated{};
+  EvaluationCounts m_counts{};
+};
+
 // Optimization solver base class(CRTP) for a given optimization problem.
 template<typename Derived>
 class OPTIMIZATION_PUBLIC Optimizer : public common::helper_functions::crtp<Derived>
@@ -19,6 +19,7 @@
 
 #include <common/types.hpp>
 #include <optimization/visibility_control.hpp>
+#include <chrono>
 #include <limits>
 #include <cstdint>
 
@@ -39,7 +40,10 @@ enum class TerminationType
   NO_CONVERGENCE = 1U,
   // An error occurred during optimization and the result is not usable.
   // Usually indicates a numerical issue.
-  FAILURE = 2U
+  FAILURE = 2U,
+  // The time budget ran out before convergence. The result is the latest iterate, i.e. the best
+  // estimate so far, but it is less accurate than a converged one.
+  TIME_BUDGET_EXCEEDED = 3U
 };
 
 // Optimization options class for newton's method.
@@ -51,11 +55,14 @@ public:
   /// \param function_tolerance minimum relative change in the cost function.
   /// \param parameter_tolerance minimum step size relative to the parameter's norm.
   /// \param gradient_tolerance minimum absolute change in the gradient.
-  /// \throws std::domain_error on negative or NaN tolerance values.
+  /// \param time_budget maximum wall time of an optimization, zero for no limit. An iteration is
+  /// not started if it would likely end after the budget, judging by the longest iteration so far.
+  /// \throws std::domain_error on negative or NaN tolerance values or a negative time budget.
   OptimizationOptions(
     uint64_t max_num_iterations = std::numeric_limits<int64_t>::max(),
     float64_t function_tolerance = 0.0, float64_t parameter_tolerance = 0.0,
-    float64_t gradient_tolerance = 0.0);
+    float64_t gradient_tolerance = 0.0,
+    std::chrono::nanoseconds time_budget = std::chrono::nanoseconds::zero());
 
   /// Get maximum number of iterations
   uint64_t max_num_iterations() const noexcept;
@@ -65,12 +72,25 @@ public:
   float64_t parameter_tolerance() const noexcept;
   /// Get minimum relative change in the gradient
   float64_t gradient_tolerance() const noexcept;
+  /// Get the maximum wall time of an optimization, zero if there is no limit
+  std::chrono::nanoseconds time_budget() const noexcept;
 
 private:
   uint64_t m_max_num_iterations;
   float64_t m_function_tolerance;
   float64_t m_parameter_tolerance;
   float64_t m_gradient_tolerance;
+  std::chrono::nanoseconds m_time_budget;
+};
+
+/// Number of times each term of the optimization problem was requested to be computed during
+/// an optimization. Terms that were already computed for the same parameter value are not
+/// counted again.
+struct OPTIMIZATION_PUBLIC EvaluationCounts
+{
+  uint64_t score{0U};
+  uint64_t jacobian{0U};
+  uint64_t hessian{0U};
 };
 
 // Optimization summary class.
@@ -81,7 +101,14 @@ public:
   /// \param dist estimated distance to the optimum
   /// \param termination_type Type of termination. Check the enum definition for possible outcomes.
   /// \param iter number of iterations that were made
-  OptimizationSummary(float64_t dist, TerminationType termination_type, uint64_t iter);
+  /// \param evaluation_counts number of evaluations of each term of the optimization problem
+  /// \param total_duration wall time spent in the optimization
+  /// \param max_iteration_duration wall time of the longest iteration
+  OptimizationSummary(
+    float64_t dist, TerminationType termination_type, uint64_t iter,
+    const EvaluationCounts & evaluation_counts = EvaluationCounts{},
+    std::chrono::nanoseconds total_duration = std::chrono::nanoseconds::zero(),
+    std::chrono::nanoseconds max_iteration_duration = std::chrono::nanoseconds::zero());
 
   /// Get the estimated distance to the optimum
   float64_t estimated_distance_to_optimum() const noexcept;
@@ -89,11 +116,20 @@ public:
   TerminationType termination_type() const noexcept;
   /// Get the number of iterations that were made
   uint64_t number_of_iterations_made() const noexcept;
+  /// Get the number of evaluations of each term of the optimization problem
+  const EvaluationCounts & evaluation_counts() const noexcept;
+  /// Get the wall time spent in the optimization
+  std::chrono::nanoseconds total_duration() const noexcept;
+  /// Get the wall time of the longest iteration
+  std::chrono::nanoseconds max_iteration_duration() const noexcept;
 
 private:
   float64_t m_estimated_distance_to_optimum;
   uint64_t m_number_of_iterations_made;
   TerminationType m_termination_type;
+  EvaluationCounts m_evaluation_counts;
+  std::chrono::nanoseconds m_total_duration;
+  std::chrono::nanoseconds m_max_iteration_duration;
 };
 
 }  // namespace optimization
@@ -121,17 +121,24 @@ public:
   CacheStateMachine(
     const DomainValue & value, const ComputeMode & mode,
     const ComparatorT & comparator = ComparatorT())
-  : m_comparator(comparator), m_last_mode(mode), m_last_value(value)
+  : m_comparator(comparator), m_last_mode(mode), m_last_value(value), m_has_value(true)
   {
   }
 
-  /// Update the state with the given parameter and the computation mode/
+  /// Update the state with the given parameter and the computation mode. If the parameter is
+  /// the same as the previous one, the terms that were already computed stay cached.
   /// \param value Parameter value used in computation
   /// \param mode Computation mode
   void update(const DomainValue & value, const ComputeMode & mode) noexcept
   {
-    m_last_mode = mode;
-    m_last_value = value;
+    if (m_has_value && m_comparator(value, m_last_value)) {
+      m_last_mode = ComputeMode{m_last_mode.score() || mode.score(),
+        m_last_mode.jacobian() || mode.jacobian(), m_last_mode.hessian() || mode.hessian()};
+    } else {
+      m_last_mode = mode;
+      m_last_value = value;
+      m_has_value = true;
+    }
   }
 
   /// Check if the term is already evaluated and cached for a given parameter
@@ -165,6 +172,7 @@ private:
   const ComparatorT m_comparator;
   DomainValue m_last_value;
   ComputeMode m_last_mode;
+  bool8_t m_has_value{false};
 };
 
 }  // namespace optimization
@@ -31,10 +31,11 @@ OptimizationOptions::OptimizationOptions(
   uint64_t max_num_iterations,
   float64_t function_tolerance,
   float64_t parameter_tolerance,
-  float64_t gradient_tolerance)
+  float64_t gradient_tolerance,
+  std::chrono::nanoseconds time_budget)
 : m_max_num_iterations(max_num_iterations),
   m_function_tolerance(function_tolerance), m_parameter_tolerance(parameter_tolerance),
-  m_gradient_tolerance(gradient_tolerance)
+  m_gradient_tolerance(gradient_tolerance), m_time_budget(time_budget)
 {
   if (!std::isfinite(m_function_tolerance) ||
     !std::isfinite(m_parameter_tolerance) ||
@@ -52,6 +53,10 @@ OptimizationOptions::OptimizationOptions(
             "There should at least be one positive tolerance value "
             "for convergence.");
   }
+
+  if (m_time_budget < std::chrono::nanoseconds::zero()) {
+    throw std::domain_error("OptimizationOptions: The time budget must not be negative.");
+  }
 }
 
 uint64_t OptimizationOptions::max_num_iterations() const noexcept
@@ -70,13 +75,21 @@ float64_t OptimizationOptions::gradient_tolerance() const noexcept
 {
   return m_gradient_tolerance;
 }
+std::chrono::nanoseconds OptimizationOptions::time_budget() const noexcept
+{
+  return m_time_budget;
+}
 
 OptimizationSummary::OptimizationSummary(
   float64_t dist, TerminationType termination_type,
-  uint64_t iter)
+  uint64_t iter, const EvaluationCounts & evaluation_counts,
+  std::chrono::nanoseconds total_duration, std::chrono::nanoseconds max_iteration_duration)
 : m_estimated_distance_to_optimum(dist),
   m_number_of_iterations_made(iter),
-  m_termination_type(termination_type)
+  m_termination_type(termination_type),
+  m_evaluation_counts(evaluation_counts),
+  m_total_duration(total_duration),
+  m_max_iteration_duration(max_iteration_duration)
 {}
 
 float64_t OptimizationSummary::estimated_distance_to_optimum() const noexcept
@@ -91,6 +104,18 @@ uint64_t OptimizationSummary::number_of_iterations_made() const noexcept
 {
   return m_number_of_iterations_made;
 }
+const EvaluationCounts & OptimizationSummary::evaluation_counts() const noexcept
+{
+  return m_evaluation_counts;
+}
+std::chrono::nanoseconds OptimizationSummary::total_duration() const noexcept
+{
+  return m_total_duration;
+}
+std::chrono::nanoseconds OptimizationSummary::max_iteration_duration() const noexcept
+{
+  return m_max_iteration_duration;
+}
 }  // namespace optimization
 }  // namespace common
 }  // namespace autoware
@@ -52,6 +52,21 @@ TEST_F(CacheStateMachineTest, numeric_test) {
   }
 }
 
+/// @test       Terms evaluated separately for the same value are all cached.
+TEST(CacheStateMachineIncrementalTest, incremental_update) {
+  CacheStateMachine<float64_t> csm{};
+  csm.update(1.5, ComputeMode{}.set_score().set_jacobian());
+  csm.update(1.5, ComputeMode{}.set_hessian());
+  EXPECT_TRUE(csm.is_cached(1.5, ExpressionTerm::SCORE));
+  EXPECT_TRUE(csm.is_cached(1.5, ExpressionTerm::JACOBIAN));
+  EXPECT_TRUE(csm.is_cached(1.5, ExpressionTerm::HESSIAN));
+
+  csm.update(2.5, ComputeMode{}.set_hessian());
+  EXPECT_FALSE(csm.is_cached(2.5, ExpressionTerm::SCORE));
+  EXPECT_FALSE(csm.is_cached(2.5, ExpressionTerm::JACOBIAN));
+  EXPECT_TRUE(csm.is_cached(2.5, ExpressionTerm::HESSIAN));
+  EXPECT_FALSE(csm.is_cached(1.5, ExpressionTerm::HESSIAN));
+}
 
 }  // namespace optimization
 }  // namespace common
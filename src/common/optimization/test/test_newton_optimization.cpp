@@ -17,15 +17,21 @@
 #include "test_newton_optimization.hpp"
 
 #include <optimization/line_search/fixed_line_search.hpp>
+#include <optimization/line_search/more_thuente_line_search.hpp>
 
 #include <common/types.hpp>
 #include <gtest/gtest.h>
+#include <chrono>
 #include <limits>
+#include <stdexcept>
 
 using autoware::common::types::float64_t;
 using autoware::common::optimization::Polynomial1dParam;
 using autoware::common::optimization::OptimizationOptions;
 using autoware::common::optimization::FixedLineSearch;
+using autoware::common::optimization::MoreThuenteLineSearch;
+using autoware::common::optimization::CountingCachedOptimizationProblem;
+using autoware::common::optimization::Vector2D;
 using autoware::common::optimization::NewtonsMethodOptimizer;
 using autoware::common::optimization::TerminationType;
 using autoware::common::optimization::Polynomial1DOptimizationProblem;
@@ -54,6 +60,65 @@ TEST_P(NewtonOptimizationParamTest, newton_optimization_validation) {
     EXPECT_FLOAT_EQ(x_out(0, 0), solution);
     EXPECT_LE(summary.estimated_distance_to_optimum(), line_search.get_step_max());
   }
+  // The hessian is only computed for the steps that are iterated on.
+  const auto & counts = summary.evaluation_counts();
+  EXPECT_LE(counts.hessian, counts.jacobian);
+  EXPECT_LE(counts.hessian, summary.number_of_iterations_made() + 1U);
+  EXPECT_LE(summary.max_iteration_duration(), summary.total_duration());
+}
+
+/// @test       The evaluations of the line search are reused instead of being recomputed and the
+///             reported counts match the computations done by the objective.
+TEST(NewtonOptimizationTest, cached_derivative_reuse) {
+  CountingCachedOptimizationProblem problem{};
+  const Vector2D x0{3.0, 1.0};
+  Vector2D x_out;
+  NewtonsMethodOptimizer<MoreThuenteLineSearch> optimizer{
+    MoreThuenteLineSearch{1.0F, 1e-4F}, OptimizationOptions{30, 0.0, 0.0, 1e-6}};
+  const auto summary = optimizer.solve(problem, x0, x_out);
+  ASSERT_EQ(summary.termination_type(), TerminationType::CONVERGENCE);
+  EXPECT_NEAR(x_out(1), -2.0, 1e-6);
+
+  const auto & counts = summary.evaluation_counts();
+  const auto & objective_counts = problem.get_objective().counts;
+  EXPECT_EQ(counts.score, objective_counts.score);
+  EXPECT_EQ(counts.jacobian, objective_counts.jacobian);
+  EXPECT_EQ(counts.hessian, objective_counts.hessian);
+  // One hessian per iteration: none is computed for the final, converged step.
+  EXPECT_EQ(counts.hessian, summary.number_of_iterations_made() + 1U);
+  EXPECT_GT(counts.jacobian, counts.hessian);
+  EXPECT_GT(summary.total_duration().count(), 0);
+}
+
+/// @test       The optimization stops with the latest iterate when the time budget runs out.
+TEST(NewtonOptimizationTest, time_budget) {
+  EXPECT_THROW(
+    OptimizationOptions(30, 0.0, 1e-5, 0.0, std::chrono::nanoseconds{-1}), std::domain_error);
+  auto problem = Polynomial1DOptimizationProblem{1.0, 2, 1.0};  // (x+1)^2+1
+  const Vector1D x0{3.0};
+  Vector1D x_out;
+
+  // The initial evaluation alone takes longer than the budget.
+  NewtonsMethodOptimizer<FixedLineSearch> optimizer{
+    FixedLineSearch(0.2), OptimizationOptions(30, 0.0, 1e-5, 0.0, std::chrono::nanoseconds{1})};
+  EXPECT_EQ(optimizer.options().time_budget(), std::chrono::nanoseconds{1});
+  const auto summary = optimizer.solve(problem, x0, x_out);
+  EXPECT_EQ(summary.termination_type(), TerminationType::TIME_BUDGET_EXCEEDED);
+  EXPECT_EQ(summary.number_of_iterations_made(), 0U);
+  EXPECT_EQ(x_out, x0);
+
+  // A generous budget doesn't change the result.
+  NewtonsMethodOptimizer<FixedLineSearch> unlimited_optimizer{
+    FixedLineSearch(0.2), OptimizationOptions(30, 0.0, 0.0, 1e-4)};
+  NewtonsMethodOptimizer<FixedLineSearch> budget_optimizer{
+    FixedLineSearch(0.2), OptimizationOptions(30, 0.0, 0.0, 1e-4, std::chrono::hours{1})};
+  Vector1D x_unlimited;
+  const auto unlimited_summary = unlimited_optimizer.solve(problem, x0, x_unlimited);
+  const auto budget_summary = budget_optimizer.solve(problem, x0, x_out);
+  EXPECT_EQ(budget_summary.termination_type(), TerminationType::CONVERGENCE);
+  EXPECT_EQ(
+    budget_summary.number_of_iterations_made(), unlimited_summary.number_of_iterations_made());
+  EXPECT_EQ(x_out, x_unlimited);
 }
 
 INSTANTIATE_TEST_CASE_P(
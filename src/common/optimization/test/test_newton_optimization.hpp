@@ -19,6 +19,7 @@
 
 #include <common/types.hpp>
 #include <optimization/newtons_method_optimizer.hpp>
+#include <cmath>
 
 using autoware::common::types::float64_t;
 
@@ -89,6 +90,50 @@ public:
   }
 };
 
+using Vector2D = Eigen::Matrix<float64_t, 2U, 1U>;
+
+/// This is the expression for `y = (x_0 - 1)^2 + 2 (x_1 + 2)^2 + 0.1 x_0^4` with a global minimum
+/// close to (0.8, -2). It counts how many times each of its terms was computed.
+class CountingCachedObjective
+  : public CachedExpression<CountingCachedObjective, Vector2D, 1U, 2U, EigenComparator>
+{
+public:
+  void evaluate_(const DomainValue & x, const ComputeMode & mode)
+  {
+    if (mode.score()) {
+      set_score(
+        std::pow(x(0) - 1.0, 2) + 2.0 * std::pow(x(1) + 2.0, 2) + 0.1 * std::pow(x(0), 4));
+      ++counts.score;
+    }
+    if (mode.jacobian()) {
+      Jacobian jacobian;
+      jacobian << 2.0 * (x(0) - 1.0) + 0.4 * std::pow(x(0), 3), 4.0 * (x(1) + 2.0);
+      set_jacobian(jacobian);
+      ++counts.jacobian;
+    }
+    if (mode.hessian()) {
+      Hessian hessian;
+      hessian << 2.0 + 1.2 * std::pow(x(0), 2), 0.0, 0.0, 4.0;
+      set_hessian(hessian);
+      ++counts.hessian;
+    }
+  }
+
+  EvaluationCounts counts{};
+};
+
+class CountingCachedOptimizationProblem : public
+  UnconstrainedOptimizationProblem<CountingCachedObjective, Vector2D, 2U>
+{
+public:
+  using UnconstrainedOptimizationProblem::UnconstrainedOptimizationProblem;
+
+  const CountingCachedObjective & get_objective()
+  {
+    return objective();
+  }
+};
+
 template<typename OptimmizationOptionsT, typename LineSearchT>
 struct Polynomial1dParam
 {
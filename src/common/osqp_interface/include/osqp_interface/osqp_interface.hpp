@@ -56,9 +56,14 @@ private:
   bool8_t m_work_initialized = false;
   // Exitflag
   int64_t m_exitflag;
+  // Matrices of the stored problem, the sparsity pattern is checked when updating the values
+  CSC_Matrix m_P_csc;
+  CSC_Matrix m_A_csc;
 
   // Runs the solver on the stored problem.
   std::tuple<std::vector<float64_t>, std::vector<float64_t>, int64_t, int64_t> solve();
+  // Frees the workspace and the matrices of the stored problem.
+  void cleanupProblem();
 
 public:
   /// \brief Constructor without problem formulation
@@ -129,6 +134,24 @@ public:
     const Eigen::MatrixXd & P, const Eigen::MatrixXd & A, const std::vector<float64_t> & q,
     const std::vector<float64_t> & l, const std::vector<float64_t> & u);
 
+  /// \brief Updates the values of the matrices of the stored problem. Unlike initializeProblem(),
+  ///        the workspace is kept, so the symbolic factorization isn't repeated and the next
+  ///        solve is warm started from the previous solution.
+  /// \param P (n,n) matrix defining relations between parameters.
+  /// \param A (m,n) matrix defining parameter constraints relative to the lower and upper bound.
+  /// \return False if no problem is set up or the sparsity pattern of a matrix changed. The stored
+  ///         problem is unchanged then and has to be set up again with initializeProblem().
+  bool8_t updateMatrices(const Eigen::MatrixXd & P, const Eigen::MatrixXd & A);
+  /// \brief Updates the linear cost of the stored problem.
+  /// \param q (n) vector defining the linear cost of the problem.
+  /// \return False if no problem is set up or the size doesn't match.
+  bool8_t updateQ(const std::vector<float64_t> & q);
+  /// \brief Updates the constraint bounds of the stored problem.
+  /// \param l (m) vector defining the lower bound problem constraint.
+  /// \param u (m) vector defining the upper bound problem constraint.
+  /// \return False if no problem is set up or the sizes don't match.
+  bool8_t updateBounds(const std::vector<float64_t> & l, const std::vector<float64_t> & u);
+
   /// \brief Get the number of iteration taken to solve the problem
   inline int64_t getTakenIter() const {return static_cast<int64_t>(m_latest_work_info.iter);}
   /// \brief Get the status message for the latest problem solved
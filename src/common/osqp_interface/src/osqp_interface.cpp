@@ -18,6 +18,7 @@
 #include <memory>
 #include <string>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include "osqp/osqp.h"
@@ -65,8 +66,9 @@ int64_t OSQPInterface::initializeProblem(
   /*******************
    * SET UP MATRICES
    *******************/
-  CSC_Matrix P_csc = calCSCMatrixTrapezoidal(P);
-  CSC_Matrix A_csc = calCSCMatrix(A);
+  // Kept for the sparsity pattern check of updateMatrices()
+  m_P_csc = calCSCMatrixTrapezoidal(P);
+  m_A_csc = calCSCMatrix(A);
   // Dynamic float arrays
   std::vector<float64_t> q_tmp(q.begin(), q.end());
   std::vector<float64_t> l_tmp(l.begin(), l.end());
@@ -86,21 +88,23 @@ int64_t OSQPInterface::initializeProblem(
   /*****************
    * POPULATE DATA
    *****************/
+  // The previous problem is replaced
+  cleanupProblem();
   m_data->m = constr_m;
   m_data->n = m_param_n;
   m_data->P = csc_matrix(
-    m_data->n, m_data->n, static_cast<c_int>(P_csc.m_vals.size()), P_csc.m_vals.data(),
-    P_csc.m_row_idxs.data(),
-    P_csc.m_col_idxs.data());
+    m_data->n, m_data->n, static_cast<c_int>(m_P_csc.m_vals.size()), m_P_csc.m_vals.data(),
+    m_P_csc.m_row_idxs.data(),
+    m_P_csc.m_col_idxs.data());
   m_data->q = q_dyn;
   m_data->A = csc_matrix(
-    m_data->m, m_data->n, static_cast<c_int>(A_csc.m_vals.size()), A_csc.m_vals.data(),
-    A_csc.m_row_idxs.data(),
-    A_csc.m_col_idxs.data());
+    m_data->m, m_data->n, static_cast<c_int>(m_A_csc.m_vals.size()), m_A_csc.m_vals.data(),
+    m_A_csc.m_row_idxs.data(),
+    m_A_csc.m_col_idxs.data());
   m_data->l = l_dyn;
   m_data->u = u_dyn;
 
-  // Setup workspace
+  // Setup workspace, which copies the data
   m_exitflag = osqp_setup(&m_work, m_data.get(), m_settings.get());
   m_work_initialized = true;
 
@@ -108,11 +112,69 @@ int64_t OSQPInterface::initializeProblem(
 }
 
 OSQPInterface::~OSQPInterface()
+{
+  cleanupProblem();
+}
+
+void OSQPInterface::cleanupProblem()
 {
   // Cleanup dynamic OSQP memory
   if (m_work) {
     osqp_cleanup(m_work);
+    m_work = nullptr;
+  }
+  // Only the matrix structures are allocated by csc_matrix, the arrays belong to the CSC matrices
+  if (m_data) {
+    c_free(m_data->P);
+    c_free(m_data->A);
+    m_data->P = nullptr;
+    m_data->A = nullptr;
+  }
+  m_work_initialized = false;
+}
+
+bool8_t OSQPInterface::updateMatrices(const Eigen::MatrixXd & P, const Eigen::MatrixXd & A)
+{
+  if (!m_work_initialized || (m_exitflag != 0)) {
+    return false;
+  }
+  CSC_Matrix P_csc = calCSCMatrixTrapezoidal(P);
+  CSC_Matrix A_csc = calCSCMatrix(A);
+  // The factorization of the workspace depends on the positions of the non-zero values
+  if ((P.rows() != m_param_n) || (A.rows() != m_data->m) ||
+    (P_csc.m_row_idxs != m_P_csc.m_row_idxs) || (P_csc.m_col_idxs != m_P_csc.m_col_idxs) ||
+    (A_csc.m_row_idxs != m_A_csc.m_row_idxs) || (A_csc.m_col_idxs != m_A_csc.m_col_idxs))
+  {
+    return false;
+  }
+  if (osqp_update_P_A(
+      m_work, P_csc.m_vals.data(), OSQP_NULL, static_cast<c_int>(P_csc.m_vals.size()),
+      A_csc.m_vals.data(), OSQP_NULL, static_cast<c_int>(A_csc.m_vals.size())) != 0)
+  {
+    return false;
+  }
+  m_P_csc.m_vals = std::move(P_csc.m_vals);
+  m_A_csc.m_vals = std::move(A_csc.m_vals);
+  return true;
+}
+
+bool8_t OSQPInterface::updateQ(const std::vector<float64_t> & q)
+{
+  if (!m_work_initialized || (m_exitflag != 0) || (static_cast<int64_t>(q.size()) != m_param_n)) {
+    return false;
+  }
+  return osqp_update_lin_cost(m_work, q.data()) == 0;
+}
+
+bool8_t OSQPInterface::updateBounds(
+  const std::vector<float64_t> & l, const std::vector<float64_t> & u)
+{
+  if (!m_work_initialized || (m_exitflag != 0) ||
+    (static_cast<c_int>(l.size()) != m_data->m) || (static_cast<c_int>(u.size()) != m_data->m))
+  {
+    return false;
   }
+  return osqp_update_bounds(m_work, l.data(), u.data()) == 0;
 }
 
 std::tuple<std::vector<float64_t>, std::vector<float64_t>, int64_t, int64_t> OSQPInterface::solve()
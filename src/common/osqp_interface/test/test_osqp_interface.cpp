@@ -88,4 +88,42 @@ TEST(test_osqp_interface, basic_qp) {
     check_result(result);
   }
 }
+
+TEST(test_osqp_interface, update_problem) {
+  Eigen::MatrixXd P(2, 2);
+  P << 4, 1, 1, 2;
+  Eigen::MatrixXd A(4, 2);
+  A << 1, 1, 1, 0, 0, 1, 0, 1;
+  std::vector<float64_t> q = {1.0, 1.0};
+  std::vector<float64_t> l = {1.0, 0.0, 0.0, -autoware::common::osqp::INF};
+  std::vector<float64_t> u = {1.0, 0.7, 0.7, autoware::common::osqp::INF};
+
+  autoware::common::osqp::OSQPInterface osqp(1e-6);
+  // Nothing to update before a problem is set up
+  EXPECT_FALSE(osqp.updateMatrices(P, A));
+  EXPECT_FALSE(osqp.updateQ(q));
+  EXPECT_FALSE(osqp.updateBounds(l, u));
+
+  // Start from another problem with the same sparsity pattern
+  Eigen::MatrixXd P_init(2, 2);
+  P_init << 1, 0.5, 0.5, 1;
+  std::vector<float64_t> q_init = {0.0, 0.0};
+  osqp.optimize(P_init, A, q_init, l, u);
+
+  ASSERT_TRUE(osqp.updateMatrices(P, A));
+  ASSERT_TRUE(osqp.updateQ(q));
+  ASSERT_TRUE(osqp.updateBounds(l, u));
+  const auto result = osqp.optimize();
+  EXPECT_EQ(std::get<3>(result), 1);
+  ASSERT_EQ(std::get<0>(result).size(), size_t(2));
+  EXPECT_NEAR(std::get<0>(result)[0], 0.3, 1e-4);
+  EXPECT_NEAR(std::get<0>(result)[1], 0.7, 1e-4);
+
+  // The workspace can't be reused for other non-zero positions or sizes
+  Eigen::MatrixXd P_diagonal(2, 2);
+  P_diagonal << 4, 0, 0, 2;
+  EXPECT_FALSE(osqp.updateMatrices(P_diagonal, A));
+  EXPECT_FALSE(osqp.updateQ({1.0, 1.0, 1.0}));
+  EXPECT_FALSE(osqp.updateBounds(q, q));
+}
 }  // namespace
@@ -0,0 +1,146 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief The measurement of the callbacks of a node against their budgets and the degradation
+///        level that the node follows
+
+#ifndef OVERLOAD_MANAGEMENT__LOAD_MONITOR_HPP_
+#define OVERLOAD_MANAGEMENT__LOAD_MONITOR_HPP_
+
+#include <common/types.hpp>
+#include <diagnostic_msgs/msg/diagnostic_array.hpp>
+#include <overload_management/load_report.hpp>
+#include <overload_management/visibility_control.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <std_msgs/msg/u_int8.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <string>
+
+namespace autoware
+{
+namespace common
+{
+namespace overload_management
+{
+using CallbackId = std::size_t;
+
+/// \brief Measures how long the calls of the callbacks of a node take, reports it to the
+///        overload supervisor every `overload.report_period_ms` and follows the degradation
+///        level that the supervisor commands.
+///
+/// Overload management is off unless the parameter `overload.enabled` is set at startup. The
+/// node degrades once the level reaches `overload.degrade_at_level`, which orders the nodes of
+/// a pipeline by the priority of the work they shed, 0 never degrades the node. The budget of a
+/// callback is the parameter `overload.<callback>.budget_ms`.
+class OVERLOAD_MANAGEMENT_PUBLIC LoadMonitor
+{
+public:
+  /// \brief Constructor, declares the parameters
+  /// \param[in] node The node whose callbacks are measured
+  /// \param[in] default_degrade_at_level The level the node degrades at, unless the parameter
+  ///            is set
+  /// \throw std::domain_error If the report period isn't positive or the level isn't in
+  ///        [0, 255]
+  LoadMonitor(rclcpp::Node & node, int64_t default_degrade_at_level);
+
+  LoadMonitor(const LoadMonitor &) = delete;
+  LoadMonitor & operator=(const LoadMonitor &) = delete;
+
+  /// \brief Register a callback of the node, to be measured with a LoadScope. Callbacks are
+  ///        registered before the node spins
+  /// \param[in] name The name of the callback, it is prefixed with the name of the node
+  /// \param[in] default_budget_ms The budget of the callback, unless the parameter is set
+  /// \return The id of the callback
+  /// \throw std::domain_error If the budget isn't positive
+  CallbackId add_callback(const std::string & name, float64_t default_budget_ms);
+
+  /// \brief Whether overload management is on
+  bool8_t enabled() const noexcept;
+
+  /// \brief Whether the node is to shed work, i.e. the commanded level reached the one of the
+  ///        node. Always false if overload management is off
+  bool8_t degraded() const noexcept;
+
+  /// \brief The latest commanded degradation level
+  uint8_t level() const noexcept;
+
+  /// \brief Add a call of a callback, this is what LoadScope does
+  /// \param[in] id The callback
+  /// \param[in] duration How long the call took
+  void record(CallbackId id, std::chrono::nanoseconds duration) noexcept;
+
+  /// \brief Publish the load of the callbacks that were called since the last report and
+  ///        start the next report period
+  void publish();
+
+private:
+  /// The calls of a callback in the current report period
+  struct CallbackStatistics
+  {
+    std::string name;
+    float64_t budget_ms;
+    std::atomic<uint64_t> calls{0U};
+    std::atomic<int64_t> total_ns{0};
+    std::atomic<int64_t> max_ns{0};
+  };
+
+  void on_level(const std_msgs::msg::UInt8 & msg);
+
+  rclcpp::Node & m_node;
+  bool8_t m_enabled;
+  uint8_t m_degrade_at_level{0U};
+  std::atomic<uint8_t> m_level{0U};
+  /// A deque, so that the statistics stay in place as callbacks are added
+  std::deque<CallbackStatistics> m_callbacks{};
+  rclcpp::Publisher<diagnostic_msgs::msg::DiagnosticArray>::SharedPtr m_publisher{};
+  rclcpp::Subscription<std_msgs::msg::UInt8>::SharedPtr m_level_sub{};
+  rclcpp::TimerBase::SharedPtr m_timer{};
+};
+
+/// \brief Measures a call of a callback from the construction to the destruction of the scope
+class OVERLOAD_MANAGEMENT_PUBLIC LoadScope
+{
+public:
+  /// \brief Start measuring
+  /// \param[in] monitor The monitor of the node
+  /// \param[in] id The callback, as registered in the monitor
+  LoadScope(LoadMonitor & monitor, const CallbackId id) noexcept
+  : m_monitor{monitor},
+    m_id{id},
+    m_start{std::chrono::steady_clock::now()} {}
+
+  LoadScope(const LoadScope &) = delete;
+  LoadScope & operator=(const LoadScope &) = delete;
+
+  ~LoadScope()
+  {
+    m_monitor.record(m_id, std::chrono::steady_clock::now() - m_start);
+  }
+
+private:
+  LoadMonitor & m_monitor;
+  CallbackId m_id;
+  std::chrono::steady_clock::time_point m_start;
+};
+
+}  // namespace overload_management
+}  // namespace common
+}  // namespace autoware
+
+#endif  // OVERLOAD_MANAGEMENT__LOAD_MONITOR_HPP_
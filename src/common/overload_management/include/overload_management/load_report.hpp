@@ -0,0 +1,77 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief The load of the callbacks of the nodes as they report it to the overload supervisor
+
+#ifndef OVERLOAD_MANAGEMENT__LOAD_REPORT_HPP_
+#define OVERLOAD_MANAGEMENT__LOAD_REPORT_HPP_
+
+#include <common/types.hpp>
+#include <diagnostic_msgs/msg/diagnostic_status.hpp>
+#include <overload_management/visibility_control.hpp>
+
+#include <cstdint>
+#include <string>
+
+namespace autoware
+{
+namespace common
+{
+namespace overload_management
+{
+using autoware::common::types::bool8_t;
+using autoware::common::types::float64_t;
+
+/// \brief The topic that the nodes report the load of their callbacks on
+constexpr const char * LOAD_REPORT_TOPIC = "/overload/load";
+/// \brief The topic that the supervisor commands the degradation level on, transient local so
+///        that nodes started late get the current level
+constexpr const char * DEGRADATION_LEVEL_TOPIC = "/overload/degradation_level";
+
+/// \brief How long the calls of a callback took during a report period, against its budget
+struct OVERLOAD_MANAGEMENT_PUBLIC CallbackLoad
+{
+  /// The fully qualified name of the node, a slash and the name of the callback
+  std::string name{};
+  /// The time a call may take, in milliseconds
+  float64_t budget_ms{0.0};
+  /// The number of calls in the period
+  uint64_t calls{0U};
+  float64_t mean_ms{0.0};
+  float64_t max_ms{0.0};
+
+  /// \brief The longest call relative to the budget, above 1 if a call overran it
+  float64_t load() const noexcept;
+};
+
+/// \brief Write the load of a callback into a diagnostic status
+/// \param[in] load The load of the callback
+/// \return The status, named after the callback, WARN if a call overran the budget
+OVERLOAD_MANAGEMENT_PUBLIC diagnostic_msgs::msg::DiagnosticStatus to_status(
+  const CallbackLoad & load);
+
+/// \brief Read the load of a callback from a status written by to_status()
+/// \param[in] status The status
+/// \return The load of the callback
+/// \throw std::runtime_error If a field is missing or isn't a number, or the budget isn't
+///        positive
+OVERLOAD_MANAGEMENT_PUBLIC CallbackLoad from_status(
+  const diagnostic_msgs::msg::DiagnosticStatus & status);
+
+}  // namespace overload_management
+}  // namespace common
+}  // namespace autoware
+
+#endif  // OVERLOAD_MANAGEMENT__LOAD_REPORT_HPP_
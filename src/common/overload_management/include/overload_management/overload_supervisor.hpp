@@ -0,0 +1,103 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief The decision of the degradation level of a pipeline from the load of its callbacks
+
+#ifndef OVERLOAD_MANAGEMENT__OVERLOAD_SUPERVISOR_HPP_
+#define OVERLOAD_MANAGEMENT__OVERLOAD_SUPERVISOR_HPP_
+
+#include <overload_management/load_report.hpp>
+#include <overload_management/visibility_control.hpp>
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace autoware
+{
+namespace common
+{
+namespace overload_management
+{
+
+struct OVERLOAD_MANAGEMENT_PUBLIC OverloadSupervisorConfig
+{
+  /// The pipeline is overloaded when the load of a callback is above this
+  float64_t overload_threshold{1.0};
+  /// The pipeline has recovered when the load of all callbacks is below this
+  float64_t recovery_threshold{0.7};
+  /// The number of consecutive overloaded evaluations to step the level up
+  uint32_t escalate_after{2U};
+  /// The number of consecutive recovered evaluations to step the level down
+  uint32_t recover_after{5U};
+  /// The highest level, the number of degradations of the pipeline
+  uint8_t max_level{4U};
+  /// Reports older than this are ignored, e.g. the ones of a node that stopped
+  int64_t stale_timeout_ns{2000000000};
+};
+
+/// \brief Steps the degradation level of a pipeline up while any callback overruns its budget
+///        and back down once all callbacks are well within their budgets again
+///
+/// The level changes by one step at a time, so that the pipeline sheds the least important work
+/// first and the effect of each step is seen before the next one. Both thresholds and the
+/// consecutive evaluations needed to step form a hysteresis, so that the level doesn't flap at
+/// the edge of a budget.
+class OVERLOAD_MANAGEMENT_PUBLIC OverloadSupervisor
+{
+public:
+  /// \brief Constructor
+  /// \param[in] config The configuration
+  /// \throw std::domain_error If the thresholds aren't positive and ordered, or a count or
+  ///        the timeout is zero
+  explicit OverloadSupervisor(const OverloadSupervisorConfig & config);
+
+  /// \brief Add the latest load of a callback, it replaces the previous one of the callback
+  /// \param[in] load The load
+  /// \param[in] now_ns The time of the receipt, in the clock of evaluate()
+  void add_report(const CallbackLoad & load, int64_t now_ns);
+
+  /// \brief Evaluate the reports that aren't stale and step the level if needed
+  /// \param[in] now_ns The current time
+  /// \return The degradation level, 0 if the pipeline isn't degraded
+  uint8_t evaluate(int64_t now_ns);
+
+  uint8_t level() const noexcept {return m_level;}
+  /// \brief The callback with the highest load at the last evaluation, empty if there was none
+  const std::string & worst_callback() const noexcept {return m_worst_callback;}
+  /// \brief The highest load at the last evaluation
+  float64_t worst_load() const noexcept {return m_worst_load;}
+
+private:
+  struct Report
+  {
+    CallbackLoad load;
+    int64_t received_ns;
+  };
+
+  OverloadSupervisorConfig m_config;
+  std::map<std::string, Report> m_reports{};
+  uint8_t m_level{0U};
+  uint32_t m_overloaded_count{0U};
+  uint32_t m_recovered_count{0U};
+  std::string m_worst_callback{};
+  float64_t m_worst_load{0.0};
+};
+
+}  // namespace overload_management
+}  // namespace common
+}  // namespace autoware
+
+#endif  // OVERLOAD_MANAGEMENT__OVERLOAD_SUPERVISOR_HPP_
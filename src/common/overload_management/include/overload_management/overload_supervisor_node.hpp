@@ -0,0 +1,61 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief A node that commands the degradation level of a pipeline from the load of its nodes
+
+#ifndef OVERLOAD_MANAGEMENT__OVERLOAD_SUPERVISOR_NODE_HPP_
+#define OVERLOAD_MANAGEMENT__OVERLOAD_SUPERVISOR_NODE_HPP_
+
+#include <diagnostic_msgs/msg/diagnostic_array.hpp>
+#include <overload_management/overload_supervisor.hpp>
+#include <overload_management/visibility_control.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <std_msgs/msg/u_int8.hpp>
+
+namespace autoware
+{
+namespace common
+{
+namespace overload_management
+{
+
+/// \brief Collects the load reports of the nodes, evaluates them every `evaluation_period_ms`
+///        and publishes the degradation level when it changes. The level and the worst
+///        callback are also published on `/diagnostics`
+class OVERLOAD_MANAGEMENT_PUBLIC OverloadSupervisorNode : public rclcpp::Node
+{
+public:
+  /// \brief Constructor
+  /// \param[in] options The options of the node
+  /// \throw std::domain_error If a parameter is out of its range
+  explicit OverloadSupervisorNode(const rclcpp::NodeOptions & options);
+
+private:
+  void on_load(const diagnostic_msgs::msg::DiagnosticArray & msg);
+  void evaluate();
+  void publish_level();
+
+  OverloadSupervisor m_supervisor;
+  rclcpp::Publisher<std_msgs::msg::UInt8>::SharedPtr m_level_pub;
+  rclcpp::Publisher<diagnostic_msgs::msg::DiagnosticArray>::SharedPtr m_diagnostics_pub;
+  rclcpp::Subscription<diagnostic_msgs::msg::DiagnosticArray>::SharedPtr m_load_sub;
+  rclcpp::TimerBase::SharedPtr m_timer{};
+};
+
+}  // namespace overload_management
+}  // namespace common
+}  // namespace autoware
+
+#endif  // OVERLOAD_MANAGEMENT__OVERLOAD_SUPERVISOR_NODE_HPP_
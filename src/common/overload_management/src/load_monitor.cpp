@@ -0,0 +1,148 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <overload_management/load_monitor.hpp>
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+namespace autoware
+{
+namespace common
+{
+namespace overload_management
+{
+namespace
+{
+constexpr const char * ENABLED_PARAMETER = "overload.enabled";
+constexpr const char * REPORT_PERIOD_PARAMETER = "overload.report_period_ms";
+constexpr const char * DEGRADE_AT_LEVEL_PARAMETER = "overload.degrade_at_level";
+constexpr float64_t NS_PER_MS = 1.0e6;
+}  // namespace
+
+LoadMonitor::LoadMonitor(rclcpp::Node & node, const int64_t default_degrade_at_level)
+: m_node{node},
+  m_enabled{node.declare_parameter(ENABLED_PARAMETER, false)}
+{
+  const auto report_period_ms = node.declare_parameter(REPORT_PERIOD_PARAMETER, 500);
+  if (report_period_ms <= 0) {
+    throw std::domain_error{"LoadMonitor: the report period must be positive"};
+  }
+  const auto degrade_at_level =
+    node.declare_parameter(DEGRADE_AT_LEVEL_PARAMETER, default_degrade_at_level);
+  if ((degrade_at_level < 0) || (degrade_at_level > 255)) {
+    throw std::domain_error{"LoadMonitor: the degradation level must be in [0, 255]"};
+  }
+  m_degrade_at_level = static_cast<uint8_t>(degrade_at_level);
+  if (!m_enabled) {
+    return;
+  }
+  m_publisher = node.create_publisher<diagnostic_msgs::msg::DiagnosticArray>(
+    LOAD_REPORT_TOPIC, rclcpp::QoS{rclcpp::KeepLast{10U}});
+  m_level_sub = node.create_subscription<std_msgs::msg::UInt8>(
+    DEGRADATION_LEVEL_TOPIC, rclcpp::QoS{rclcpp::KeepLast{1U}}.transient_local(),
+    [this](const std_msgs::msg::UInt8::SharedPtr msg) {on_level(*msg);});
+  m_timer = node.create_wall_timer(
+    std::chrono::milliseconds{report_period_ms}, [this]() {publish();});
+}
+
+CallbackId LoadMonitor::add_callback(const std::string & name, const float64_t default_budget_ms)
+{
+  const auto budget_ms =
+    m_node.declare_parameter("overload." + name + ".budget_ms", default_budget_ms);
+  if (!(budget_ms > 0.0)) {
+    throw std::domain_error{"LoadMonitor: the budget of " + name + " must be positive"};
+  }
+  m_callbacks.emplace_back();
+  auto & callback = m_callbacks.back();
+  callback.name = std::string{m_node.get_fully_qualified_name()} + "/" + name;
+  callback.budget_ms = budget_ms;
+  return m_callbacks.size() - 1U;
+}
+
+bool8_t LoadMonitor::enabled() const noexcept
+{
+  return m_enabled;
+}
+
+bool8_t LoadMonitor::degraded() const noexcept
+{
+  return m_enabled && (m_degrade_at_level > 0U) && (m_level >= m_degrade_at_level);
+}
+
+uint8_t LoadMonitor::level() const noexcept
+{
+  return m_level;
+}
+
+void LoadMonitor::record(const CallbackId id, const std::chrono::nanoseconds duration) noexcept
+{
+  if (!m_enabled || (id >= m_callbacks.size())) {
+    return;
+  }
+  auto & callback = m_callbacks[id];
+  const auto duration_ns = static_cast<int64_t>(duration.count());
+  (void)callback.calls.fetch_add(1U);
+  (void)callback.total_ns.fetch_add(duration_ns);
+  auto max_ns = callback.max_ns.load();
+  while ((duration_ns > max_ns) && !callback.max_ns.compare_exchange_weak(max_ns, duration_ns)) {
+    // max_ns was reloaded, retry while this call is still the longest
+  }
+}
+
+void LoadMonitor::publish()
+{
+  diagnostic_msgs::msg::DiagnosticArray diagnostics;
+  diagnostics.header.stamp = m_node.now();
+  for (auto & callback : m_callbacks) {
+    // A call that ends in between is counted in this period or the next, but not lost
+    const auto calls = callback.calls.exchange(0U);
+    const auto total_ns = callback.total_ns.exchange(0);
+    const auto max_ns = callback.max_ns.exchange(0);
+    if (calls == 0U) {
+      continue;
+    }
+    CallbackLoad load;
+    load.name = callback.name;
+    load.budget_ms = callback.budget_ms;
+    load.calls = calls;
+    load.mean_ms = (static_cast<float64_t>(total_ns) / static_cast<float64_t>(calls)) / NS_PER_MS;
+    load.max_ms = static_cast<float64_t>(max_ns) / NS_PER_MS;
+    diagnostics.status.push_back(to_status(load));
+  }
+  if (!diagnostics.status.empty()) {
+    m_publisher->publish(diagnostics);
+  }
+}
+
+void LoadMonitor::on_level(const std_msgs::msg::UInt8 & msg)
+{
+  const auto was_degraded = degraded();
+  m_level = msg.data;
+  const auto is_degraded = degraded();
+  if (is_degraded && !was_degraded) {
+    RCLCPP_WARN(
+      m_node.get_logger(), "Overload: shedding work at degradation level %u",
+      static_cast<uint32_t>(msg.data));
+  } else if (!is_degraded && was_degraded) {
+    RCLCPP_INFO(
+      m_node.get_logger(), "Overload: back to full work at degradation level %u",
+      static_cast<uint32_t>(msg.data));
+  }
+}
+
+}  // namespace overload_management
+}  // namespace common
+}  // namespace autoware
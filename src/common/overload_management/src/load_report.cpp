@@ -0,0 +1,102 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <overload_management/load_report.hpp>
+
+#include <stdexcept>
+#include <string>
+
+namespace autoware
+{
+namespace common
+{
+namespace overload_management
+{
+namespace
+{
+constexpr const char * BUDGET_KEY = "budget_ms";
+constexpr const char * CALLS_KEY = "calls";
+constexpr const char * MEAN_KEY = "mean_ms";
+constexpr const char * MAX_KEY = "max_ms";
+
+diagnostic_msgs::msg::KeyValue key_value(const std::string & key, const std::string & value)
+{
+  diagnostic_msgs::msg::KeyValue key_value_msg;
+  key_value_msg.key = key;
+  key_value_msg.value = value;
+  return key_value_msg;
+}
+}  // namespace
+
+float64_t CallbackLoad::load() const noexcept
+{
+  return (budget_ms > 0.0) ? (max_ms / budget_ms) : 0.0;
+}
+
+diagnostic_msgs::msg::DiagnosticStatus to_status(const CallbackLoad & load)
+{
+  diagnostic_msgs::msg::DiagnosticStatus status;
+  status.level = (load.max_ms > load.budget_ms) ?
+    diagnostic_msgs::msg::DiagnosticStatus::WARN : diagnostic_msgs::msg::DiagnosticStatus::OK;
+  status.name = load.name;
+  status.message = "At most " + std::to_string(load.max_ms) + " ms of a budget of " +
+    std::to_string(load.budget_ms) + " ms";
+  status.values.push_back(key_value(BUDGET_KEY, std::to_string(load.budget_ms)));
+  status.values.push_back(key_value(CALLS_KEY, std::to_string(load.calls)));
+  status.values.push_back(key_value(MEAN_KEY, std::to_string(load.mean_ms)));
+  status.values.push_back(key_value(MAX_KEY, std::to_string(load.max_ms)));
+  return status;
+}
+
+CallbackLoad from_status(const diagnostic_msgs::msg::DiagnosticStatus & status)
+{
+  CallbackLoad load;
+  load.name = status.name;
+  bool8_t has_budget = false;
+  bool8_t has_calls = false;
+  bool8_t has_mean = false;
+  bool8_t has_max = false;
+  for (const auto & value : status.values) {
+    try {
+      if (value.key == BUDGET_KEY) {
+        load.budget_ms = std::stod(value.value);
+        has_budget = true;
+      } else if (value.key == CALLS_KEY) {
+        load.calls = std::stoull(value.value);
+        has_calls = true;
+      } else if (value.key == MEAN_KEY) {
+        load.mean_ms = std::stod(value.value);
+        has_mean = true;
+      } else if (value.key == MAX_KEY) {
+        load.max_ms = std::stod(value.value);
+        has_max = true;
+      }
+    } catch (const std::logic_error &) {
+      // std::invalid_argument and std::out_of_range of the conversions
+      throw std::runtime_error{
+              "load report of " + status.name + ": " + value.key + " is not a number"};
+    }
+  }
+  if (!has_budget || !has_calls || !has_mean || !has_max) {
+    throw std::runtime_error{"load report of " + status.name + " is incomplete"};
+  }
+  if (!(load.budget_ms > 0.0)) {
+    throw std::runtime_error{"load report of " + status.name + " has no positive budget"};
+  }
+  return load;
+}
+
+}  // namespace overload_management
+}  // namespace common
+}  // namespace autoware
@@ -0,0 +1,95 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <overload_management/overload_supervisor.hpp>
+
+#include <stdexcept>
+#include <string>
+
+namespace autoware
+{
+namespace common
+{
+namespace overload_management
+{
+
+OverloadSupervisor::OverloadSupervisor(const OverloadSupervisorConfig & config)
+: m_config{config}
+{
+  if (!(m_config.recovery_threshold > 0.0) ||
+    !(m_config.recovery_threshold < m_config.overload_threshold))
+  {
+    throw std::domain_error{
+            "OverloadSupervisor: the recovery threshold must be positive and below the overload "
+            "threshold"};
+  }
+  if ((m_config.escalate_after == 0U) || (m_config.recover_after == 0U)) {
+    throw std::domain_error{"OverloadSupervisor: the evaluations to step must be positive"};
+  }
+  if (m_config.stale_timeout_ns <= 0) {
+    throw std::domain_error{"OverloadSupervisor: the stale timeout must be positive"};
+  }
+}
+
+void OverloadSupervisor::add_report(const CallbackLoad & load, const int64_t now_ns)
+{
+  m_reports[load.name] = Report{load, now_ns};
+}
+
+uint8_t OverloadSupervisor::evaluate(const int64_t now_ns)
+{
+  m_worst_callback.clear();
+  m_worst_load = 0.0;
+  for (auto it = m_reports.begin(); it != m_reports.end(); ) {
+    if ((now_ns - it->second.received_ns) > m_config.stale_timeout_ns) {
+      it = m_reports.erase(it);
+      continue;
+    }
+    const auto load = it->second.load.load();
+    if (m_worst_callback.empty() || (load > m_worst_load)) {
+      m_worst_callback = it->first;
+      m_worst_load = load;
+    }
+    ++it;
+  }
+
+  if (m_worst_load > m_config.overload_threshold) {
+    m_recovered_count = 0U;
+    if (m_level < m_config.max_level) {
+      ++m_overloaded_count;
+      if (m_overloaded_count >= m_config.escalate_after) {
+        ++m_level;
+        m_overloaded_count = 0U;
+      }
+    }
+  } else if (m_worst_load < m_config.recovery_threshold) {
+    // Also without any reports, e.g. when the pipeline stopped
+    m_overloaded_count = 0U;
+    if (m_level > 0U) {
+      ++m_recovered_count;
+      if (m_recovered_count >= m_config.recover_after) {
+        --m_level;
+        m_recovered_count = 0U;
+      }
+    }
+  } else {
+    m_overloaded_count = 0U;
+    m_recovered_count = 0U;
+  }
+  return m_level;
+}
+
+}  // namespace overload_management
+}  // namespace common
+}  // namespace autoware
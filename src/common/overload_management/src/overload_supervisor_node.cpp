@@ -0,0 +1,151 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <overload_management/overload_supervisor_node.hpp>
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+namespace autoware
+{
+namespace common
+{
+namespace overload_management
+{
+namespace
+{
+/// Reports of the nodes of a pipeline that can arrive between two evaluations
+constexpr std::size_t LOAD_HISTORY_DEPTH = 100U;
+
+/// The steady clock, so that the staleness of the reports doesn't depend on the time source
+int64_t steady_now_ns()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+OverloadSupervisorConfig declare_config(rclcpp::Node & node)
+{
+  OverloadSupervisorConfig config;
+  config.overload_threshold =
+    node.declare_parameter("overload_threshold", config.overload_threshold);
+  config.recovery_threshold =
+    node.declare_parameter("recovery_threshold", config.recovery_threshold);
+  const auto escalate_after = node.declare_parameter(
+    "escalate_after", static_cast<int64_t>(config.escalate_after));
+  const auto recover_after = node.declare_parameter(
+    "recover_after", static_cast<int64_t>(config.recover_after));
+  const auto max_level = node.declare_parameter(
+    "max_level", static_cast<int64_t>(config.max_level));
+  const auto stale_timeout_ms = node.declare_parameter("stale_timeout_ms", 2000);
+  if ((escalate_after < 0) || (recover_after < 0) || (stale_timeout_ms < 0)) {
+    throw std::domain_error{
+            "OverloadSupervisorNode: the counts and the timeout must not be negative"};
+  }
+  if ((max_level < 0) || (max_level > 255)) {
+    throw std::domain_error{"OverloadSupervisorNode: max_level must be in [0, 255]"};
+  }
+  config.escalate_after = static_cast<uint32_t>(escalate_after);
+  config.recover_after = static_cast<uint32_t>(recover_after);
+  config.max_level = static_cast<uint8_t>(max_level);
+  config.stale_timeout_ns = static_cast<int64_t>(stale_timeout_ms) * 1000000;
+  return config;
+}
+}  // namespace
+
+OverloadSupervisorNode::OverloadSupervisorNode(const rclcpp::NodeOptions & options)
+: Node("overload_supervisor", options),
+  m_supervisor{declare_config(*this)},
+  m_level_pub{create_publisher<std_msgs::msg::UInt8>(
+      DEGRADATION_LEVEL_TOPIC, rclcpp::QoS{rclcpp::KeepLast{1U}}.transient_local())},
+  m_diagnostics_pub{create_publisher<diagnostic_msgs::msg::DiagnosticArray>(
+      "/diagnostics", rclcpp::QoS{rclcpp::KeepLast{10U}})},
+  m_load_sub{create_subscription<diagnostic_msgs::msg::DiagnosticArray>(
+      LOAD_REPORT_TOPIC, rclcpp::QoS{rclcpp::KeepLast{LOAD_HISTORY_DEPTH}},
+      [this](const diagnostic_msgs::msg::DiagnosticArray::SharedPtr msg) {on_load(*msg);})}
+{
+  const auto evaluation_period_ms = declare_parameter("evaluation_period_ms", 500);
+  if (evaluation_period_ms <= 0) {
+    throw std::domain_error{"OverloadSupervisorNode: the evaluation period must be positive"};
+  }
+  m_timer = create_wall_timer(
+    std::chrono::milliseconds{evaluation_period_ms}, [this]() {evaluate();});
+  // The nodes start at full work
+  publish_level();
+}
+
+void OverloadSupervisorNode::on_load(const diagnostic_msgs::msg::DiagnosticArray & msg)
+{
+  const auto now_ns = steady_now_ns();
+  for (const auto & status : msg.status) {
+    try {
+      m_supervisor.add_report(from_status(status), now_ns);
+    } catch (const std::runtime_error & e) {
+      RCLCPP_WARN(get_logger(), "Ignoring a load report: %s", e.what());
+    }
+  }
+}
+
+void OverloadSupervisorNode::evaluate()
+{
+  const auto previous_level = m_supervisor.level();
+  const auto level = m_supervisor.evaluate(steady_now_ns());
+  if (level != previous_level) {
+    if (level > previous_level) {
+      RCLCPP_WARN(
+        get_logger(), "Overload: degradation level %u, %s is at %.0f %% of its budget",
+        static_cast<uint32_t>(level), m_supervisor.worst_callback().c_str(),
+        m_supervisor.worst_load() * 100.0);
+    } else {
+      RCLCPP_INFO(get_logger(), "Recovering: degradation level %u", static_cast<uint32_t>(level));
+    }
+    publish_level();
+  }
+
+  diagnostic_msgs::msg::DiagnosticStatus status;
+  status.level = (level > 0U) ?
+    diagnostic_msgs::msg::DiagnosticStatus::WARN : diagnostic_msgs::msg::DiagnosticStatus::OK;
+  status.name = std::string{get_name()} + ": degradation level";
+  status.message = "Degradation level " + std::to_string(level);
+  diagnostic_msgs::msg::KeyValue value;
+  value.key = "level";
+  value.value = std::to_string(level);
+  status.values.push_back(value);
+  value.key = "worst_callback";
+  value.value = m_supervisor.worst_callback();
+  status.values.push_back(value);
+  value.key = "worst_load";
+  value.value = std::to_string(m_supervisor.worst_load());
+  status.values.push_back(value);
+  diagnostic_msgs::msg::DiagnosticArray diagnostics;
+  diagnostics.header.stamp = now();
+  diagnostics.status.push_back(status);
+  m_diagnostics_pub->publish(diagnostics);
+}
+
+void OverloadSupervisorNode::publish_level()
+{
+  std_msgs::msg::UInt8 msg;
+  msg.data = m_supervisor.level();
+  m_level_pub->publish(msg);
+}
+
+}  // namespace overload_management
+}  // namespace common
+}  // namespace autoware
+
+#include "rclcpp_components/register_node_macro.hpp"
+
+RCLCPP_COMPONENTS_REGISTER_NODE(autoware::common::overload_management::OverloadSupervisorNode)
@@ -0,0 +1,145 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <overload_management/load_report.hpp>
+#include <overload_management/overload_supervisor.hpp>
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+using autoware::common::overload_management::CallbackLoad;
+using autoware::common::overload_management::OverloadSupervisor;
+using autoware::common::overload_management::OverloadSupervisorConfig;
+using autoware::common::overload_management::from_status;
+using autoware::common::overload_management::to_status;
+using diagnostic_msgs::msg::DiagnosticStatus;
+
+namespace
+{
+constexpr int64_t PERIOD_NS = 500000000;
+
+CallbackLoad make_load(const std::string & name, const double budget_ms, const double max_ms)
+{
+  CallbackLoad load;
+  load.name = name;
+  load.budget_ms = budget_ms;
+  load.calls = 10U;
+  load.mean_ms = max_ms * 0.5;
+  load.max_ms = max_ms;
+  return load;
+}
+
+/// Report the same load for a number of periods, and return the level after the last one
+uint8_t run(
+  OverloadSupervisor & supervisor, const CallbackLoad & load, const uint32_t periods,
+  int64_t & now_ns)
+{
+  for (uint32_t period = 0U; period < periods; ++period) {
+    now_ns += PERIOD_NS;
+    supervisor.add_report(load, now_ns);
+    (void)supervisor.evaluate(now_ns);
+  }
+  return supervisor.level();
+}
+}  // namespace
+
+TEST(TestLoadReport, round_trip)
+{
+  const auto load = make_load("/perception/voxel_grid_cloud_node/points", 20.0, 25.0);
+  EXPECT_DOUBLE_EQ(load.load(), 1.25);
+  const auto status = to_status(load);
+  EXPECT_EQ(status.name, load.name);
+  EXPECT_EQ(status.level, DiagnosticStatus::WARN);
+  const auto parsed = from_status(status);
+  EXPECT_EQ(parsed.name, load.name);
+  EXPECT_EQ(parsed.calls, 10U);
+  EXPECT_NEAR(parsed.budget_ms, 20.0, 1.0e-6);
+  EXPECT_NEAR(parsed.mean_ms, 12.5, 1.0e-6);
+  EXPECT_NEAR(parsed.max_ms, 25.0, 1.0e-6);
+  EXPECT_EQ(to_status(make_load("/node/callback", 20.0, 5.0)).level, DiagnosticStatus::OK);
+}
+
+TEST(TestLoadReport, bad_status)
+{
+  auto status = to_status(make_load("/node/callback", 20.0, 5.0));
+  status.values.pop_back();
+  EXPECT_THROW(from_status(status), std::runtime_error);
+  status = to_status(make_load("/node/callback", 20.0, 5.0));
+  status.values[1U].value = "many";
+  EXPECT_THROW(from_status(status), std::runtime_error);
+  status = to_status(make_load("/node/callback", 0.0, 5.0));
+  EXPECT_THROW(from_status(status), std::runtime_error);
+}
+
+TEST(TestOverloadSupervisor, bad_config)
+{
+  OverloadSupervisorConfig config;
+  config.recovery_threshold = config.overload_threshold;
+  EXPECT_THROW(OverloadSupervisor{config}, std::domain_error);
+  config = OverloadSupervisorConfig{};
+  config.escalate_after = 0U;
+  EXPECT_THROW(OverloadSupervisor{config}, std::domain_error);
+  config = OverloadSupervisorConfig{};
+  config.stale_timeout_ns = 0;
+  EXPECT_THROW(OverloadSupervisor{config}, std::domain_error);
+}
+
+TEST(TestOverloadSupervisor, escalate_and_recover)
+{
+  OverloadSupervisorConfig config;
+  config.escalate_after = 2U;
+  config.recover_after = 3U;
+  config.max_level = 2U;
+  OverloadSupervisor supervisor{config};
+  int64_t now_ns = 0;
+  const auto overloaded = make_load("/node/callback", 20.0, 30.0);
+  const auto recovered = make_load("/node/callback", 20.0, 5.0);
+  const auto marginal = make_load("/node/callback", 20.0, 18.0);
+
+  // One step per escalate_after overloaded evaluations, up to the highest level
+  EXPECT_EQ(run(supervisor, overloaded, 1U, now_ns), 0U);
+  EXPECT_EQ(run(supervisor, overloaded, 1U, now_ns), 1U);
+  EXPECT_EQ(supervisor.worst_callback(), "/node/callback");
+  EXPECT_DOUBLE_EQ(supervisor.worst_load(), 1.5);
+  EXPECT_EQ(run(supervisor, overloaded, 2U, now_ns), 2U);
+  EXPECT_EQ(run(supervisor, overloaded, 10U, now_ns), 2U);
+
+  // Between the thresholds the level holds, and an interruption restarts the count
+  EXPECT_EQ(run(supervisor, marginal, 10U, now_ns), 2U);
+  EXPECT_EQ(run(supervisor, recovered, 2U, now_ns), 2U);
+  EXPECT_EQ(run(supervisor, marginal, 1U, now_ns), 2U);
+  EXPECT_EQ(run(supervisor, recovered, 2U, now_ns), 2U);
+  EXPECT_EQ(run(supervisor, recovered, 1U, now_ns), 1U);
+  EXPECT_EQ(run(supervisor, recovered, 3U, now_ns), 0U);
+  EXPECT_EQ(run(supervisor, recovered, 10U, now_ns), 0U);
+}
+
+TEST(TestOverloadSupervisor, worst_callback_and_stale_reports)
+{
+  OverloadSupervisorConfig config;
+  config.escalate_after = 1U;
+  config.recover_after = 1U;
+  config.stale_timeout_ns = PERIOD_NS;
+  OverloadSupervisor supervisor{config};
+  int64_t now_ns = 0;
+  supervisor.add_report(make_load("/stalled_node/callback", 10.0, 50.0), now_ns);
+  EXPECT_EQ(run(supervisor, make_load("/node/callback", 20.0, 5.0), 1U, now_ns), 1U);
+  EXPECT_EQ(supervisor.worst_callback(), "/stalled_node/callback");
+  // The report of the stalled node times out, the other one keeps the pipeline recovering
+  EXPECT_EQ(run(supervisor, make_load("/node/callback", 20.0, 5.0), 1U, now_ns), 0U);
+  EXPECT_EQ(supervisor.worst_callback(), "/node/callback");
+  EXPECT_DOUBLE_EQ(supervisor.worst_load(), 0.25);
+}
@@ -0,0 +1,98 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief Publication of the heap allocations of the callbacks of a node as diagnostics
+
+#ifndef RT_MEMORY__ALLOCATION_DIAGNOSTICS_HPP_
+#define RT_MEMORY__ALLOCATION_DIAGNOSTICS_HPP_
+
+#include <common/types.hpp>
+#include <diagnostic_msgs/msg/diagnostic_array.hpp>
+#include <diagnostic_msgs/msg/diagnostic_status.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <rt_memory/allocation_profiler.hpp>
+#include <rt_memory/visibility_control.hpp>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace autoware
+{
+namespace common
+{
+namespace rt_memory
+{
+/// \brief The topic that the allocation statistics are published on
+constexpr const char * ALLOCATION_DIAGNOSTICS_TOPIC = "/diagnostics";
+
+/// \brief Write the heap allocations of a callback into a diagnostic status
+/// \param[in] allocations The statistics of the callback
+/// \return The status, named after the callback, with one value per statistic and the mean
+///         allocations per call
+RT_MEMORY_PUBLIC diagnostic_msgs::msg::DiagnosticStatus to_status(
+  const CallbackAllocations & allocations);
+
+/// \brief Profiles the heap allocations of the callbacks of a node and periodically publishes
+///        them on the diagnostics topic. Profiling is off unless the parameter
+///        `allocation_profiling.enabled` is set, at startup or at runtime, and it is published
+///        every `allocation_profiling.publish_period_ms`. Enabling it resets the statistics
+class RT_MEMORY_PUBLIC AllocationDiagnostics
+{
+public:
+  /// \brief Constructor, declares the parameters
+  /// \param[in] node The node whose callbacks are profiled
+  /// \param[in] profiler The profiler the callbacks are registered in
+  /// \throw std::domain_error If the publish period isn't positive
+  explicit AllocationDiagnostics(
+    rclcpp::Node & node,
+    AllocationProfiler & profiler = AllocationProfiler::instance());
+
+  AllocationDiagnostics(const AllocationDiagnostics &) = delete;
+  AllocationDiagnostics & operator=(const AllocationDiagnostics &) = delete;
+
+  /// \brief Register a callback of the node, to be profiled with an AllocationScope
+  /// \param[in] name The name of the callback, it is prefixed with the name of the node
+  /// \return The id of the callback in the profiler
+  /// \throw std::length_error If the profiler is full
+  CallbackId add_callback(const std::string & name);
+
+  /// \brief The profiler the callbacks are registered in
+  AllocationProfiler & profiler() noexcept;
+
+  /// \brief Whether the callbacks are profiled
+  bool8_t enabled() const noexcept;
+
+  /// \brief Publish the statistics of all callbacks of the node
+  void publish();
+
+private:
+  rcl_interfaces::msg::SetParametersResult on_parameters(
+    const std::vector<rclcpp::Parameter> & parameters);
+  void set_enabled(bool8_t enabled);
+
+  rclcpp::Node & m_node;
+  AllocationProfiler & m_profiler;
+  std::vector<CallbackId> m_callbacks{};
+  std::atomic<bool8_t> m_enabled{false};
+  rclcpp::Publisher<diagnostic_msgs::msg::DiagnosticArray>::SharedPtr m_publisher{};
+  rclcpp::TimerBase::SharedPtr m_timer{};
+  rclcpp::Node::OnSetParametersCallbackHandle::SharedPtr m_parameter_callback{};
+};
+}  // namespace rt_memory
+}  // namespace common
+}  // namespace autoware
+
+#endif  // RT_MEMORY__ALLOCATION_DIAGNOSTICS_HPP_
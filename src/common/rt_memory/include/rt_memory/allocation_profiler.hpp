@@ -0,0 +1,153 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief Attribution of the heap allocations of a process to the callbacks that make them
+
+#ifndef RT_MEMORY__ALLOCATION_PROFILER_HPP_
+#define RT_MEMORY__ALLOCATION_PROFILER_HPP_
+
+#include <common/types.hpp>
+#include <rt_memory/heap_allocation_guard.hpp>
+#include <rt_memory/visibility_control.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace autoware
+{
+namespace common
+{
+namespace rt_memory
+{
+/// \brief Identifies a callback in an AllocationProfiler
+using CallbackId = std::size_t;
+
+/// \brief The heap allocations of a callback since its statistics were reset
+struct RT_MEMORY_PUBLIC CallbackAllocations
+{
+  /// The name the callback was registered with
+  std::string name{};
+  /// Number of profiled calls
+  uint64_t calls{0U};
+  /// Number of allocations of all calls
+  uint64_t allocations{0U};
+  /// Bytes allocated by all calls
+  uint64_t bytes{0U};
+  /// Most allocations of a single call
+  uint64_t max_allocations{0U};
+  /// Most bytes allocated by a single call
+  uint64_t max_bytes{0U};
+};
+
+/// \brief Counts the heap allocations of named callbacks, e.g. of the subscriptions and timers of
+///        the nodes of a process. Profiling is enabled per callback, a disabled callback costs a
+///        relaxed atomic load per call. Allocations are only seen if the rt_memory_heap_tracking
+///        library is linked into the executable, see heap_tracking_enabled()
+class RT_MEMORY_PUBLIC AllocationProfiler
+{
+public:
+  /// The number of callbacks a profiler can hold
+  static constexpr std::size_t kMaxCallbacks = 256U;
+
+  /// \brief Constructor, without callbacks
+  AllocationProfiler() = default;
+
+  AllocationProfiler(const AllocationProfiler &) = delete;
+  AllocationProfiler & operator=(const AllocationProfiler &) = delete;
+
+  /// \brief The profiler of this process
+  static AllocationProfiler & instance();
+
+  /// \brief Get the id of a callback, registering it if it is new. Profiling of a new callback is
+  ///        disabled
+  /// \param[in] name The name of the callback, e.g. prefixed with the name of its node
+  /// \return The id of the callback in this profiler
+  /// \throw std::length_error If there are kMaxCallbacks callbacks already
+  CallbackId register_callback(const std::string & name);
+
+  /// \brief Enable or disable the profiling of a callback
+  /// \param[in] id The callback, ids that weren't registered are ignored
+  /// \param[in] enabled Whether calls are profiled
+  void set_enabled(CallbackId id, bool8_t enabled) noexcept;
+
+  /// \brief Whether the calls of a callback are profiled
+  bool8_t enabled(CallbackId id) const noexcept;
+
+  /// \brief Record a call of a callback, usually done by an AllocationScope
+  /// \param[in] id The callback
+  /// \param[in] allocations The heap allocations of the call
+  void record(CallbackId id, const HeapAllocations & allocations) noexcept;
+
+  /// \brief Get the statistics of a callback
+  /// \param[in] id The callback
+  /// \return The heap allocations of the callback since it was registered or reset
+  /// \throw std::out_of_range If the callback wasn't registered
+  CallbackAllocations statistics(CallbackId id) const;
+
+  /// \brief Set the statistics of a callback to zero
+  /// \param[in] id The callback
+  void reset(CallbackId id) noexcept;
+
+private:
+  /// Lock free, so that calls on any thread can record concurrently
+  struct Counters
+  {
+    std::atomic<bool8_t> enabled{false};
+    std::atomic<uint64_t> calls{0U};
+    std::atomic<uint64_t> allocations{0U};
+    std::atomic<uint64_t> bytes{0U};
+    std::atomic<uint64_t> max_allocations{0U};
+    std::atomic<uint64_t> max_bytes{0U};
+  };
+
+  /// Guards the names, only registration and the statistics take it
+  mutable std::mutex m_mutex;
+  std::vector<std::string> m_names{};
+  std::array<Counters, kMaxCallbacks> m_counters{};
+};
+
+/// \brief Profiles the heap allocations of the current thread from construction to destruction,
+///        e.g. of a callback. Costs a relaxed atomic load if the profiling of the callback is
+///        disabled, and two thread local lookups and a few atomic additions otherwise
+class RT_MEMORY_PUBLIC AllocationScope
+{
+public:
+  /// \brief Constructor, starts counting if the profiling of the callback is enabled
+  /// \param[in] profiler The profiler to record into
+  /// \param[in] id The callback that is called
+  AllocationScope(AllocationProfiler & profiler, CallbackId id) noexcept;
+
+  /// \brief Destructor, records the allocations since the construction
+  ~AllocationScope();
+
+  AllocationScope(const AllocationScope &) = delete;
+  AllocationScope & operator=(const AllocationScope &) = delete;
+
+private:
+  AllocationProfiler & m_profiler;
+  CallbackId m_id;
+  bool8_t m_enabled;
+  HeapAllocations m_start{0U, 0U};
+};
+}  // namespace rt_memory
+}  // namespace common
+}  // namespace autoware
+
+#endif  // RT_MEMORY__ALLOCATION_PROFILER_HPP_
@@ -0,0 +1,99 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief Detection of heap allocations in code that shouldn't allocate, e.g. callbacks
+
+#ifndef RT_MEMORY__HEAP_ALLOCATION_GUARD_HPP_
+#define RT_MEMORY__HEAP_ALLOCATION_GUARD_HPP_
+
+#include <common/types.hpp>
+#include <rt_memory/visibility_control.hpp>
+
+#include <cstddef>
+
+namespace autoware
+{
+namespace common
+{
+namespace rt_memory
+{
+using autoware::common::types::bool8_t;
+
+/// \brief What a guard does on a heap allocation
+enum class HeapAllocationMode
+{
+  /// Count the allocation
+  kCount,
+  /// Print the size of the allocation and abort, to get a core dump or a backtrace in gdb
+  kAbort
+};
+
+/// \brief Heap allocations of a thread
+struct RT_MEMORY_PUBLIC HeapAllocations
+{
+  /// Number of allocations
+  std::size_t count;
+  /// Sum of the requested sizes of the allocations, in bytes
+  std::size_t bytes;
+};
+
+/// \brief The heap allocations of the current thread since it started. Stays zero if heap
+///        allocations aren't tracked, see heap_tracking_enabled()
+RT_MEMORY_PUBLIC HeapAllocations thread_heap_allocations() noexcept;
+
+/// \brief Whether heap allocations are tracked, i.e. the rt_memory_heap_tracking library, which
+///        replaces the global operator new, is linked into the process. Otherwise, the guards
+///        don't see any allocations
+RT_MEMORY_PUBLIC bool8_t heap_tracking_enabled() noexcept;
+
+/// \brief Checks the heap allocations of the current thread during its lifetime, e.g. of a
+///        callback. Guards may be nested, the innermost mode applies. Costs a thread local
+///        lookup on construction and destruction
+class RT_MEMORY_PUBLIC HeapAllocationGuard
+{
+public:
+  /// \brief Constructor, starts checking
+  /// \param[in] mode What to do on a heap allocation
+  explicit HeapAllocationGuard(HeapAllocationMode mode = HeapAllocationMode::kCount) noexcept;
+  /// \brief Destructor, restores the mode of the enclosing guard, if any
+  ~HeapAllocationGuard();
+
+  HeapAllocationGuard(const HeapAllocationGuard &) = delete;
+  HeapAllocationGuard & operator=(const HeapAllocationGuard &) = delete;
+
+  /// \brief Number of heap allocations of the current thread since the construction
+  std::size_t count() const noexcept;
+  /// \brief Number of bytes allocated on the heap by the current thread since the construction
+  std::size_t bytes() const noexcept;
+
+private:
+  std::size_t m_start_count;
+  std::size_t m_start_bytes;
+  bool8_t m_was_active;
+  HeapAllocationMode m_previous_mode;
+};
+
+namespace details
+{
+/// \brief Called by the replaced operator new of rt_memory_heap_tracking on every allocation
+RT_MEMORY_PUBLIC void on_heap_allocation(std::size_t size) noexcept;
+/// \brief Called by rt_memory_heap_tracking when it is loaded
+RT_MEMORY_PUBLIC void enable_heap_tracking() noexcept;
+}  // namespace details
+}  // namespace rt_memory
+}  // namespace common
+}  // namespace autoware
+
+#endif  // RT_MEMORY__HEAP_ALLOCATION_GUARD_HPP_
@@ -0,0 +1,211 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief Memory resources and an allocator on top of them, modelled after std::pmr, which is
+///        only available from C++17 on
+
+#ifndef RT_MEMORY__MEMORY_RESOURCE_HPP_
+#define RT_MEMORY__MEMORY_RESOURCE_HPP_
+
+#include <common/types.hpp>
+#include <rt_memory/visibility_control.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+
+namespace autoware
+{
+namespace common
+{
+namespace rt_memory
+{
+using autoware::common::types::bool8_t;
+
+/// \brief The alignment of malloc, which all resources guarantee at least
+static constexpr std::size_t kDefaultAlignment = alignof(std::max_align_t);
+
+/// \brief Interface of a source of memory, like std::pmr::memory_resource. Unlike the standard,
+///        the resources of this package don't need the size and alignment on deallocation, as
+///        the C allocators of rcl don't know them on reallocation
+class RT_MEMORY_PUBLIC MemoryResource
+{
+public:
+  virtual ~MemoryResource() = default;
+
+  /// \brief Allocate memory
+  /// \param[in] bytes Size of the memory
+  /// \param[in] alignment Alignment of the memory, a power of two
+  /// \return Pointer to the memory
+  /// \throws std::bad_alloc If the resource is exhausted
+  void * allocate(const std::size_t bytes, const std::size_t alignment = kDefaultAlignment)
+  {
+    return do_allocate(bytes, alignment);
+  }
+
+  /// \brief Return memory to the resource
+  /// \param[in] ptr Pointer returned by allocate() of this resource
+  /// \param[in] bytes Size passed to allocate()
+  /// \param[in] alignment Alignment passed to allocate()
+  void deallocate(
+    void * const ptr, const std::size_t bytes,
+    const std::size_t alignment = kDefaultAlignment)
+  {
+    do_deallocate(ptr, bytes, alignment);
+  }
+
+  /// \brief Whether memory allocated from one resource can be deallocated from the other
+  bool8_t is_equal(const MemoryResource & other) const noexcept
+  {
+    return do_is_equal(other);
+  }
+
+protected:
+  virtual void * do_allocate(std::size_t bytes, std::size_t alignment) = 0;
+  virtual void do_deallocate(void * ptr, std::size_t bytes, std::size_t alignment) = 0;
+  virtual bool8_t do_is_equal(const MemoryResource & other) const noexcept
+  {
+    return this == &other;
+  }
+};
+
+/// \brief A resource that uses the global operator new, i.e. the heap
+RT_MEMORY_PUBLIC MemoryResource & new_delete_resource() noexcept;
+
+/// \brief A resource that hands out consecutive pieces of a fixed buffer, and only frees them
+///        all at once. Allocating costs a few instructions, e.g. for the scratch memory of one
+///        callback which is released at its end. Not thread safe
+class RT_MEMORY_PUBLIC MonotonicBufferResource : public MemoryResource
+{
+public:
+  /// \brief Constructor, allocates the buffer on the heap
+  /// \param[in] capacity Size of the buffer in bytes
+  explicit MonotonicBufferResource(std::size_t capacity);
+  /// \brief Constructor with an external buffer
+  /// \param[in] buffer The buffer, must outlive the resource
+  /// \param[in] capacity Size of the buffer in bytes
+  MonotonicBufferResource(void * buffer, std::size_t capacity) noexcept;
+
+  MonotonicBufferResource(const MonotonicBufferResource &) = delete;
+  MonotonicBufferResource & operator=(const MonotonicBufferResource &) = delete;
+
+  /// \brief Free all memory at once, the memory must no longer be used
+  void release() noexcept {m_used = 0U;}
+  /// \brief Size of the buffer in bytes
+  std::size_t capacity() const noexcept {return m_capacity;}
+  /// \brief Number of bytes in use, including the padding for alignment
+  std::size_t used() const noexcept {return m_used;}
+
+protected:
+  void * do_allocate(std::size_t bytes, std::size_t alignment) override;
+  void do_deallocate(void * ptr, std::size_t bytes, std::size_t alignment) override;
+
+private:
+  std::unique_ptr<unsigned char[]> m_owned_buffer;
+  unsigned char * m_buffer;
+  std::size_t m_capacity;
+  std::size_t m_used{0U};
+};
+
+/// \brief Makes another resource thread safe by guarding it with a mutex
+class RT_MEMORY_PUBLIC LockedResource : public MemoryResource
+{
+public:
+  /// \brief Constructor
+  /// \param[in] upstream The resource to guard, must outlive this resource
+  explicit LockedResource(MemoryResource & upstream) noexcept
+  : m_upstream{upstream} {}
+
+protected:
+  void * do_allocate(std::size_t bytes, std::size_t alignment) override;
+  void do_deallocate(void * ptr, std::size_t bytes, std::size_t alignment) override;
+
+private:
+  MemoryResource & m_upstream;
+  std::mutex m_mutex;
+};
+
+/// \brief An allocator for STL containers and rclcpp that allocates from a memory resource,
+///        like std::pmr::polymorphic_allocator. The memory is aligned like malloc at least, so
+///        that it can also back the C allocators of rcl, which retype it. Like the standard, a
+///        container keeps its allocator when it is assigned to, so a container which is
+///        assigned from one of another resource copies the elements into its own resource
+/// \tparam T The value type
+template<typename T>
+class Allocator
+{
+public:
+  using value_type = T;
+
+  /// \brief Constructor, allocates from the heap
+  Allocator() noexcept
+  : m_resource{&new_delete_resource()} {}
+
+  /// \brief Constructor
+  /// \param[in] resource The resource to allocate from, must outlive the allocator and all
+  ///                     memory allocated by it
+  Allocator(MemoryResource * const resource) noexcept  // NOLINT, converts like the standard
+  : m_resource{resource} {}
+
+  /// \brief Converting constructor, for rebinding
+  template<typename U>
+  Allocator(const Allocator<U> & other) noexcept  // NOLINT, converts like the standard
+  : m_resource{other.resource()} {}
+
+  /// \brief Allocate memory for n values
+  /// \throws std::bad_alloc If the resource is exhausted or the size overflows
+  T * allocate(const std::size_t n)
+  {
+    if (n > (static_cast<std::size_t>(-1) / sizeof(T))) {
+      throw std::bad_alloc{};
+    }
+    return static_cast<T *>(m_resource->allocate(n * sizeof(T), alignment()));
+  }
+
+  /// \brief Return memory for n values
+  void deallocate(T * const ptr, const std::size_t n)
+  {
+    m_resource->deallocate(ptr, n * sizeof(T), alignment());
+  }
+
+  /// \brief The resource that the allocator allocates from
+  MemoryResource * resource() const noexcept {return m_resource;}
+
+private:
+  static constexpr std::size_t alignment() noexcept
+  {
+    return (alignof(T) > kDefaultAlignment) ? alignof(T) : kDefaultAlignment;
+  }
+
+  MemoryResource * m_resource;
+};
+
+template<typename T, typename U>
+bool8_t operator==(const Allocator<T> & lhs, const Allocator<U> & rhs) noexcept
+{
+  return (lhs.resource() == rhs.resource()) || lhs.resource()->is_equal(*rhs.resource());
+}
+
+template<typename T, typename U>
+bool8_t operator!=(const Allocator<T> & lhs, const Allocator<U> & rhs) noexcept
+{
+  return !(lhs == rhs);
+}
+}  // namespace rt_memory
+}  // namespace common
+}  // namespace autoware
+
+#endif  // RT_MEMORY__MEMORY_RESOURCE_HPP_
@@ -0,0 +1,83 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief Helpers to let publishers and subscriptions allocate from a memory resource
+
+#ifndef RT_MEMORY__RCLCPP_ALLOCATOR_HPP_
+#define RT_MEMORY__RCLCPP_ALLOCATOR_HPP_
+
+#include <rclcpp/message_memory_strategy.hpp>
+#include <rclcpp/publisher_options.hpp>
+#include <rclcpp/subscription_options.hpp>
+#include <rt_memory/memory_resource.hpp>
+
+#include <memory>
+
+namespace autoware
+{
+namespace common
+{
+namespace rt_memory
+{
+/// \brief The allocator type to instantiate publishers and subscriptions with, e.g.
+///        `create_publisher<MsgT, RclcppAllocator>(...)`
+using RclcppAllocator = Allocator<void>;
+
+/// \brief The message memory strategy of a subscription
+template<typename MessageT>
+using MessageMemoryStrategy =
+  rclcpp::message_memory_strategy::MessageMemoryStrategy<MessageT, RclcppAllocator>;
+
+/// \brief Publisher options that allocate the messages and the state of rclcpp and rcl from a
+///        resource
+/// \param[in] resource The resource, must outlive the publisher. Use a LockedResource if the
+///                     publisher is used from several threads
+/// \return The options
+inline rclcpp::PublisherOptionsWithAllocator<RclcppAllocator> publisher_options(
+  MemoryResource & resource)
+{
+  rclcpp::PublisherOptionsWithAllocator<RclcppAllocator> options;
+  options.allocator = std::make_shared<RclcppAllocator>(&resource);
+  return options;
+}
+
+/// \brief Subscription options that allocate the state of rclcpp and rcl from a resource
+/// \param[in] resource The resource, must outlive the subscription
+/// \return The options
+inline rclcpp::SubscriptionOptionsWithAllocator<RclcppAllocator> subscription_options(
+  MemoryResource & resource)
+{
+  rclcpp::SubscriptionOptionsWithAllocator<RclcppAllocator> options;
+  options.allocator = std::make_shared<RclcppAllocator>(&resource);
+  return options;
+}
+
+/// \brief A strategy that allocates the received messages of a subscription from a resource,
+///        to be passed to create_subscription() together with subscription_options()
+/// \param[in] resource The resource, must outlive the subscription
+/// \tparam MessageT The message type of the subscription
+/// \return The strategy
+template<typename MessageT>
+typename MessageMemoryStrategy<MessageT>::SharedPtr message_memory_strategy(
+  MemoryResource & resource)
+{
+  return std::make_shared<MessageMemoryStrategy<MessageT>>(
+    std::make_shared<RclcppAllocator>(&resource));
+}
+}  // namespace rt_memory
+}  // namespace common
+}  // namespace autoware
+
+#endif  // RT_MEMORY__RCLCPP_ALLOCATOR_HPP_
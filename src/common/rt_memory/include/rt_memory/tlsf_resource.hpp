@@ -0,0 +1,96 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief A two level segregated fit (TLSF) memory resource with bounded allocation time
+
+#ifndef RT_MEMORY__TLSF_RESOURCE_HPP_
+#define RT_MEMORY__TLSF_RESOURCE_HPP_
+
+#include <rt_memory/memory_resource.hpp>
+#include <rt_memory/visibility_control.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace autoware
+{
+namespace common
+{
+namespace rt_memory
+{
+/// \brief A general purpose resource on a fixed buffer, after M. Masmano et al., "TLSF: a New
+///        Dynamic Memory Allocator for Real-Time Systems". Free blocks are kept in lists by
+///        size class, with 16 classes per power of two, and bitmaps tell which lists aren't
+///        empty. Allocating and freeing therefore take constant time, independent of the number
+///        of blocks, and freed blocks are merged with their free neighbours right away. Each
+///        block has a header of 16 bytes, and block sizes are multiples of 16 bytes.
+///        Not thread safe, see LockedResource
+class RT_MEMORY_PUBLIC TlsfResource : public MemoryResource
+{
+public:
+  /// \brief Constructor, allocates the buffer on the heap
+  /// \param[in] capacity Size of the buffer in bytes
+  /// \throws std::domain_error If the buffer is too small for a block
+  explicit TlsfResource(std::size_t capacity);
+  /// \brief Constructor with an external buffer
+  /// \param[in] buffer The buffer, must outlive the resource
+  /// \param[in] capacity Size of the buffer in bytes
+  /// \throws std::domain_error If the buffer is too small for a block
+  TlsfResource(void * buffer, std::size_t capacity);
+
+  TlsfResource(const TlsfResource &) = delete;
+  TlsfResource & operator=(const TlsfResource &) = delete;
+
+  /// \brief Number of bytes allocated, without headers and padding
+  std::size_t used() const noexcept {return m_used;}
+  /// \brief Maximum of used() so far, to size the buffer
+  std::size_t peak() const noexcept {return m_peak;}
+
+protected:
+  void * do_allocate(std::size_t bytes, std::size_t alignment) override;
+  void do_deallocate(void * ptr, std::size_t bytes, std::size_t alignment) override;
+
+private:
+  struct Block;
+
+  static constexpr std::size_t kSecondLevelBits = 4U;
+  static constexpr std::size_t kSecondLevelCount = 1U << kSecondLevelBits;
+  static constexpr std::size_t kFirstLevelCount = 57U;
+
+  /// \brief The size class of a free block, the largest class whose sizes are all at most its size
+  static void class_of(
+    std::size_t size, std::size_t & first_level,
+    std::size_t & second_level) noexcept;
+  void init(unsigned char * buffer, std::size_t capacity);
+  void insert(Block * block) noexcept;
+  void remove(Block * block) noexcept;
+  Block * find(std::size_t size) noexcept;
+  void split_leading(Block *& block, std::size_t gap) noexcept;
+  void split_trailing(Block * block, std::size_t size) noexcept;
+
+  std::unique_ptr<unsigned char[]> m_owned_buffer;
+  std::uint64_t m_first_level_bitmap{0U};
+  std::array<std::uint32_t, kFirstLevelCount> m_second_level_bitmaps{};
+  std::array<std::array<Block *, kSecondLevelCount>, kFirstLevelCount> m_free_lists{};
+  std::size_t m_used{0U};
+  std::size_t m_peak{0U};
+};
+}  // namespace rt_memory
+}  // namespace common
+}  // namespace autoware
+
+#endif  // RT_MEMORY__TLSF_RESOURCE_HPP_
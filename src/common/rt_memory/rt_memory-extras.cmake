@@ -0,0 +1,26 @@
+# Copyright 2021 The Autoware Foundation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Link the library that replaces the global operator new into an executable, so that the heap
+# allocations of the whole process are seen by the HeapAllocationGuard and the
+# AllocationProfiler. It has to be linked into the executable itself: a shared library that is
+# only a dependency of a node library, or that is loaded with a component, comes after the
+# standard library in the symbol lookup and doesn't replace operator new.
+#
+# :param target: the executable
+function(rt_memory_link_heap_tracking target)
+  set(_rt_memory_heap_tracking_libraries ${rt_memory_LIBRARIES})
+  list(FILTER _rt_memory_heap_tracking_libraries INCLUDE REGEX "rt_memory_heap_tracking")
+  target_link_libraries(${target} ${_rt_memory_heap_tracking_libraries})
+endfunction()
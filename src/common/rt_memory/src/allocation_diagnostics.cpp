@@ -0,0 +1,176 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rt_memory/allocation_diagnostics.hpp"
+
+#include <chrono>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace autoware
+{
+namespace common
+{
+namespace rt_memory
+{
+namespace
+{
+using autoware::common::types::float64_t;
+
+constexpr const char * ENABLED_PARAMETER = "allocation_profiling.enabled";
+constexpr const char * PUBLISH_PERIOD_PARAMETER = "allocation_profiling.publish_period_ms";
+
+diagnostic_msgs::msg::KeyValue key_value(const std::string & key, const std::string & value)
+{
+  diagnostic_msgs::msg::KeyValue key_value_msg;
+  key_value_msg.key = key;
+  key_value_msg.value = value;
+  return key_value_msg;
+}
+
+/// Whether the allocations of this thread are seen, which they aren't if the heap tracking
+/// library isn't linked into the executable, e.g. when it is only loaded with a component
+bool8_t allocations_are_tracked()
+{
+  const auto before = thread_heap_allocations().count;
+  void * volatile probe = ::operator new(1U);
+  ::operator delete(probe);
+  return thread_heap_allocations().count != before;
+}
+}  // namespace
+
+diagnostic_msgs::msg::DiagnosticStatus to_status(const CallbackAllocations & allocations)
+{
+  diagnostic_msgs::msg::DiagnosticStatus status;
+  status.level = diagnostic_msgs::msg::DiagnosticStatus::OK;
+  status.name = allocations.name;
+  const auto mean = (allocations.calls > 0U) ?
+    (static_cast<float64_t>(allocations.allocations) / static_cast<float64_t>(allocations.calls)) :
+    0.0;
+  status.message = std::to_string(allocations.allocations) + " heap allocations in " +
+    std::to_string(allocations.calls) + " calls";
+  status.values.push_back(key_value("calls", std::to_string(allocations.calls)));
+  status.values.push_back(key_value("allocations", std::to_string(allocations.allocations)));
+  status.values.push_back(key_value("bytes", std::to_string(allocations.bytes)));
+  status.values.push_back(key_value("allocations_per_call", std::to_string(mean)));
+  status.values.push_back(
+    key_value("max_allocations", std::to_string(allocations.max_allocations)));
+  status.values.push_back(key_value("max_bytes", std::to_string(allocations.max_bytes)));
+  return status;
+}
+
+AllocationDiagnostics::AllocationDiagnostics(
+  rclcpp::Node & node,
+  AllocationProfiler & profiler)
+: m_node{node},
+  m_profiler{profiler}
+{
+  const auto enabled = node.declare_parameter(ENABLED_PARAMETER, false);
+  const auto publish_period_ms = node.declare_parameter(PUBLISH_PERIOD_PARAMETER, 1000);
+  if (publish_period_ms <= 0) {
+    throw std::domain_error{"AllocationDiagnostics: the publish period must be positive"};
+  }
+  m_publisher = node.create_publisher<diagnostic_msgs::msg::DiagnosticArray>(
+    ALLOCATION_DIAGNOSTICS_TOPIC, rclcpp::QoS{rclcpp::KeepLast{10U}});
+  m_timer = node.create_wall_timer(
+    std::chrono::milliseconds{publish_period_ms}, [this]() {publish();});
+  m_timer->cancel();
+  set_enabled(enabled);
+  m_parameter_callback = node.add_on_set_parameters_callback(
+    [this](const std::vector<rclcpp::Parameter> & parameters) {
+      return on_parameters(parameters);
+    });
+}
+
+CallbackId AllocationDiagnostics::add_callback(const std::string & name)
+{
+  const auto id = m_profiler.register_callback(
+    std::string{m_node.get_fully_qualified_name()} + "/" + name);
+  m_callbacks.push_back(id);
+  m_profiler.reset(id);
+  m_profiler.set_enabled(id, m_enabled);
+  return id;
+}
+
+AllocationProfiler & AllocationDiagnostics::profiler() noexcept
+{
+  return m_profiler;
+}
+
+bool8_t AllocationDiagnostics::enabled() const noexcept
+{
+  return m_enabled;
+}
+
+void AllocationDiagnostics::publish()
+{
+  diagnostic_msgs::msg::DiagnosticArray diagnostics;
+  diagnostics.header.stamp = m_node.now();
+  for (const auto id : m_callbacks) {
+    diagnostics.status.push_back(to_status(m_profiler.statistics(id)));
+  }
+  m_publisher->publish(diagnostics);
+}
+
+rcl_interfaces::msg::SetParametersResult AllocationDiagnostics::on_parameters(
+  const std::vector<rclcpp::Parameter> & parameters)
+{
+  rcl_interfaces::msg::SetParametersResult result;
+  result.successful = true;
+  bool8_t enabled = m_enabled;
+  for (const auto & parameter : parameters) {
+    if (parameter.get_name() == ENABLED_PARAMETER) {
+      if (parameter.get_type() != rclcpp::ParameterType::PARAMETER_BOOL) {
+        result.successful = false;
+        result.reason = std::string{ENABLED_PARAMETER} + " must be a bool";
+        return result;
+      }
+      enabled = parameter.as_bool();
+    } else if (parameter.get_name() == PUBLISH_PERIOD_PARAMETER) {
+      result.successful = false;
+      result.reason = std::string{PUBLISH_PERIOD_PARAMETER} + " can only be set at startup";
+      return result;
+    }
+  }
+  set_enabled(enabled);
+  return result;
+}
+
+void AllocationDiagnostics::set_enabled(const bool8_t enabled)
+{
+  if (enabled == m_enabled) {
+    return;
+  }
+  m_enabled = enabled;
+  for (const auto id : m_callbacks) {
+    m_profiler.reset(id);
+    m_profiler.set_enabled(id, enabled);
+  }
+  if (enabled) {
+    if (!allocations_are_tracked()) {
+      RCLCPP_WARN(
+        m_node.get_logger(),
+        "Allocation profiling is enabled, but heap allocations aren't tracked: link "
+        "rt_memory_heap_tracking into the executable, see rt_memory_link_heap_tracking()");
+    }
+    m_timer->reset();
+  } else {
+    m_timer->cancel();
+  }
+}
+}  // namespace rt_memory
+}  // namespace common
+}  // namespace autoware
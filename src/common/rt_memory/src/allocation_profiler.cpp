@@ -0,0 +1,137 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rt_memory/allocation_profiler.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace autoware
+{
+namespace common
+{
+namespace rt_memory
+{
+constexpr std::size_t AllocationProfiler::kMaxCallbacks;
+
+namespace
+{
+void update_max(std::atomic<uint64_t> & max, const uint64_t value) noexcept
+{
+  auto current = max.load(std::memory_order_relaxed);
+  while ((value > current) &&
+    !max.compare_exchange_weak(current, value, std::memory_order_relaxed))
+  {
+  }
+}
+}  // namespace
+
+AllocationProfiler & AllocationProfiler::instance()
+{
+  static AllocationProfiler profiler;
+  return profiler;
+}
+
+CallbackId AllocationProfiler::register_callback(const std::string & name)
+{
+  std::lock_guard<std::mutex> lock{m_mutex};
+  const auto it = std::find(m_names.begin(), m_names.end(), name);
+  if (it != m_names.end()) {
+    return static_cast<CallbackId>(it - m_names.begin());
+  }
+  if (m_names.size() >= kMaxCallbacks) {
+    throw std::length_error{"AllocationProfiler: too many callbacks, can't register " + name};
+  }
+  m_names.push_back(name);
+  return m_names.size() - 1U;
+}
+
+void AllocationProfiler::set_enabled(const CallbackId id, const bool8_t enabled) noexcept
+{
+  if (id < kMaxCallbacks) {
+    m_counters[id].enabled.store(enabled, std::memory_order_relaxed);
+  }
+}
+
+bool8_t AllocationProfiler::enabled(const CallbackId id) const noexcept
+{
+  return (id < kMaxCallbacks) && m_counters[id].enabled.load(std::memory_order_relaxed);
+}
+
+void AllocationProfiler::record(const CallbackId id, const HeapAllocations & allocations) noexcept
+{
+  if (id >= kMaxCallbacks) {
+    return;
+  }
+  auto & counters = m_counters[id];
+  (void)counters.calls.fetch_add(1U, std::memory_order_relaxed);
+  (void)counters.allocations.fetch_add(allocations.count, std::memory_order_relaxed);
+  (void)counters.bytes.fetch_add(allocations.bytes, std::memory_order_relaxed);
+  update_max(counters.max_allocations, allocations.count);
+  update_max(counters.max_bytes, allocations.bytes);
+}
+
+CallbackAllocations AllocationProfiler::statistics(const CallbackId id) const
+{
+  CallbackAllocations statistics;
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    if (id >= m_names.size()) {
+      throw std::out_of_range{"AllocationProfiler: unknown callback " + std::to_string(id)};
+    }
+    statistics.name = m_names[id];
+  }
+  const auto & counters = m_counters[id];
+  statistics.calls = counters.calls.load(std::memory_order_relaxed);
+  statistics.allocations = counters.allocations.load(std::memory_order_relaxed);
+  statistics.bytes = counters.bytes.load(std::memory_order_relaxed);
+  statistics.max_allocations = counters.max_allocations.load(std::memory_order_relaxed);
+  statistics.max_bytes = counters.max_bytes.load(std::memory_order_relaxed);
+  return statistics;
+}
+
+void AllocationProfiler::reset(const CallbackId id) noexcept
+{
+  if (id >= kMaxCallbacks) {
+    return;
+  }
+  auto & counters = m_counters[id];
+  counters.calls.store(0U, std::memory_order_relaxed);
+  counters.allocations.store(0U, std::memory_order_relaxed);
+  counters.bytes.store(0U, std::memory_order_relaxed);
+  counters.max_allocations.store(0U, std::memory_order_relaxed);
+  counters.max_bytes.store(0U, std::memory_order_relaxed);
+}
+
+AllocationScope::AllocationScope(AllocationProfiler & profiler, const CallbackId id) noexcept
+: m_profiler{profiler},
+  m_id{id},
+  m_enabled{profiler.enabled(id)}
+{
+  if (m_enabled) {
+    m_start = thread_heap_allocations();
+  }
+}
+
+AllocationScope::~AllocationScope()
+{
+  if (m_enabled) {
+    const auto end = thread_heap_allocations();
+    m_profiler.record(m_id, HeapAllocations{end.count - m_start.count, end.bytes - m_start.bytes});
+  }
+}
+}  // namespace rt_memory
+}  // namespace common
+}  // namespace autoware
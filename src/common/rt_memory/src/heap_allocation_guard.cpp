@@ -0,0 +1,102 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rt_memory/heap_allocation_guard.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+
+namespace autoware
+{
+namespace common
+{
+namespace rt_memory
+{
+
+namespace
+{
+/// Trivial, so that accessing it doesn't run constructors from within operator new
+struct ThreadState
+{
+  std::size_t count;
+  std::size_t bytes;
+  bool8_t active;
+  HeapAllocationMode mode;
+};
+
+thread_local ThreadState t_state{0U, 0U, false, HeapAllocationMode::kCount};
+std::atomic<bool8_t> g_tracking_enabled{false};
+}  // namespace
+
+HeapAllocations thread_heap_allocations() noexcept
+{
+  return HeapAllocations{t_state.count, t_state.bytes};
+}
+
+bool8_t heap_tracking_enabled() noexcept
+{
+  return g_tracking_enabled.load();
+}
+
+HeapAllocationGuard::HeapAllocationGuard(const HeapAllocationMode mode) noexcept
+: m_start_count{t_state.count},
+  m_start_bytes{t_state.bytes},
+  m_was_active{t_state.active},
+  m_previous_mode{t_state.mode}
+{
+  t_state.active = true;
+  t_state.mode = mode;
+}
+
+HeapAllocationGuard::~HeapAllocationGuard()
+{
+  t_state.active = m_was_active;
+  t_state.mode = m_previous_mode;
+}
+
+std::size_t HeapAllocationGuard::count() const noexcept
+{
+  return t_state.count - m_start_count;
+}
+
+std::size_t HeapAllocationGuard::bytes() const noexcept
+{
+  return t_state.bytes - m_start_bytes;
+}
+
+namespace details
+{
+void on_heap_allocation(const std::size_t size) noexcept
+{
+  auto & state = t_state;
+  ++state.count;
+  state.bytes += size;
+  if (state.active && (HeapAllocationMode::kAbort == state.mode)) {
+    state.active = false;
+    (void)std::fprintf(
+      stderr, "HeapAllocationGuard: heap allocation of %zu bytes, aborting\n", size);
+    std::abort();
+  }
+}
+
+void enable_heap_tracking() noexcept
+{
+  g_tracking_enabled = true;
+}
+}  // namespace details
+
+}  // namespace rt_memory
+}  // namespace common
+}  // namespace autoware
@@ -0,0 +1,87 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Replaces the global operator new and delete to report every allocation to the
+// HeapAllocationGuard and AllocationProfiler. Each allocation costs a thread local update on top
+// of malloc, so it may be linked into release builds that profile their allocations.
+
+#include <rt_memory/heap_allocation_guard.hpp>
+
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+const bool kRegistered = (autoware::common::rt_memory::details::enable_heap_tracking(), true);
+
+void * allocate(const std::size_t size) noexcept
+{
+  autoware::common::rt_memory::details::on_heap_allocation(size);
+  return std::malloc((0U == size) ? 1U : size);
+}
+}  // namespace
+
+void * operator new(const std::size_t size)
+{
+  void * const ptr = allocate(size);
+  if (nullptr == ptr) {
+    throw std::bad_alloc{};
+  }
+  return ptr;
+}
+
+void * operator new[](const std::size_t size)
+{
+  return operator new(size);
+}
+
+void * operator new(const std::size_t size, const std::nothrow_t &) noexcept
+{
+  return allocate(size);
+}
+
+void * operator new[](const std::size_t size, const std::nothrow_t &) noexcept
+{
+  return allocate(size);
+}
+
+void operator delete(void * const ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void * const ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void * const ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void * const ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void * const ptr, const std::nothrow_t &) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void * const ptr, const std::nothrow_t &) noexcept
+{
+  std::free(ptr);
+}
@@ -0,0 +1,99 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rt_memory/memory_resource.hpp"
+
+#include <cstdint>
+
+namespace autoware
+{
+namespace common
+{
+namespace rt_memory
+{
+
+namespace
+{
+class NewDeleteResource : public MemoryResource
+{
+protected:
+  void * do_allocate(const std::size_t bytes, const std::size_t alignment) override
+  {
+    // Before C++17, operator new only aligns like malloc
+    if (alignment > kDefaultAlignment) {
+      throw std::bad_alloc{};
+    }
+    return ::operator new(bytes);
+  }
+
+  void do_deallocate(void * const ptr, std::size_t, std::size_t) override
+  {
+    ::operator delete(ptr);
+  }
+};
+}  // namespace
+
+MemoryResource & new_delete_resource() noexcept
+{
+  static NewDeleteResource resource;
+  return resource;
+}
+
+MonotonicBufferResource::MonotonicBufferResource(const std::size_t capacity)
+: m_owned_buffer{new unsigned char[capacity]},
+  m_buffer{m_owned_buffer.get()},
+  m_capacity{capacity}
+{
+}
+
+MonotonicBufferResource::MonotonicBufferResource(void * const buffer, const std::size_t capacity)
+noexcept
+: m_buffer{static_cast<unsigned char *>(buffer)},
+  m_capacity{capacity}
+{
+}
+
+void * MonotonicBufferResource::do_allocate(const std::size_t bytes, const std::size_t alignment)
+{
+  const auto address = reinterpret_cast<std::uintptr_t>(m_buffer) + m_used;
+  const auto padding = static_cast<std::size_t>((alignment - (address % alignment)) % alignment);
+  if ((padding > (m_capacity - m_used)) || (bytes > (m_capacity - m_used - padding))) {
+    throw std::bad_alloc{};
+  }
+  void * const ptr = &m_buffer[m_used + padding];
+  m_used += padding + bytes;
+  return ptr;
+}
+
+void MonotonicBufferResource::do_deallocate(void *, std::size_t, std::size_t)
+{
+}
+
+void * LockedResource::do_allocate(const std::size_t bytes, const std::size_t alignment)
+{
+  std::lock_guard<std::mutex> lock{m_mutex};
+  return m_upstream.allocate(bytes, alignment);
+}
+
+void LockedResource::do_deallocate(
+  void * const ptr, const std::size_t bytes,
+  const std::size_t alignment)
+{
+  std::lock_guard<std::mutex> lock{m_mutex};
+  m_upstream.deallocate(ptr, bytes, alignment);
+}
+
+}  // namespace rt_memory
+}  // namespace common
+}  // namespace autoware
@@ -0,0 +1,277 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "rt_memory/tlsf_resource.hpp"
+
+#include <limits>
+#include <new>
+#include <stdexcept>
+
+namespace autoware
+{
+namespace common
+{
+namespace rt_memory
+{
+
+/// A block is a header of two words followed by its payload. The free list links of free blocks
+/// are kept in their payload
+struct TlsfResource::Block
+{
+  /// Payload size in bytes, the lowest bit is set if the block is free
+  std::size_t size_and_flag;
+  /// The block before this one in the buffer, or nullptr for the first block
+  Block * prev_physical;
+  Block * next_free;
+  Block * prev_free;
+
+  std::size_t size() const noexcept {return size_and_flag & ~kFreeFlag;}
+  bool8_t is_free() const noexcept {return 0U != (size_and_flag & kFreeFlag);}
+  void set(const std::size_t size, const bool8_t free) noexcept
+  {
+    size_and_flag = size | (free ? kFreeFlag : 0U);
+  }
+  unsigned char * payload() noexcept {return reinterpret_cast<unsigned char *>(this) + kHeader;}
+  Block * next_physical() noexcept {return reinterpret_cast<Block *>(payload() + size());}
+
+  static Block * from_payload(void * const ptr) noexcept
+  {
+    return reinterpret_cast<Block *>(static_cast<unsigned char *>(ptr) - kHeader);
+  }
+
+  static constexpr std::size_t kFreeFlag = 1U;
+  static constexpr std::size_t kHeader = 2U * sizeof(std::size_t);
+};
+
+namespace
+{
+constexpr std::size_t kGranularity = 16U;
+constexpr std::size_t kHeaderSize = 16U;
+/// Large enough for the free list links
+constexpr std::size_t kMinPayload = 16U;
+/// Sizes below this are mapped linearly to the classes of the lowest first level
+constexpr std::size_t kSmallSize = 256U;
+constexpr std::size_t kFirstLevelShift = 8U;
+
+std::size_t round_up(const std::size_t value, const std::size_t multiple) noexcept
+{
+  return ((value + (multiple - 1U)) / multiple) * multiple;
+}
+
+std::size_t most_significant_bit(const std::size_t value) noexcept
+{
+  return static_cast<std::size_t>(std::numeric_limits<std::uint64_t>::digits - 1) -
+         static_cast<std::size_t>(__builtin_clzll(value));
+}
+
+std::size_t least_significant_bit(const std::uint64_t value) noexcept
+{
+  return static_cast<std::size_t>(__builtin_ctzll(value));
+}
+}  // namespace
+
+TlsfResource::TlsfResource(const std::size_t capacity)
+: m_owned_buffer{new unsigned char[capacity]}
+{
+  init(m_owned_buffer.get(), capacity);
+}
+
+TlsfResource::TlsfResource(void * const buffer, const std::size_t capacity)
+{
+  init(static_cast<unsigned char *>(buffer), capacity);
+}
+
+void TlsfResource::init(unsigned char * const buffer, const std::size_t capacity)
+{
+  static_assert(sizeof(Block) == (kHeaderSize + kMinPayload), "Unexpected block size");
+  static_assert(kGranularity >= alignof(std::max_align_t), "Blocks aren't aligned like malloc");
+  const auto address = reinterpret_cast<std::uintptr_t>(buffer);
+  const auto padding = static_cast<std::size_t>(round_up(address, kGranularity) - address);
+  // The first block and a used sentinel block at the end, which is never merged
+  constexpr auto kOverhead = (2U * kHeaderSize) + kMinPayload;
+  if ((capacity < padding) ||
+    ((((capacity - padding) / kGranularity) * kGranularity) < (kOverhead + kMinPayload)))
+  {
+    throw std::domain_error{"TlsfResource: the buffer is too small"};
+  }
+  const auto usable = ((capacity - padding) / kGranularity) * kGranularity;
+  auto * const first = new (&buffer[padding]) Block{};
+  first->set(usable - kOverhead, true);
+  first->prev_physical = nullptr;
+  auto * const sentinel = new (first->next_physical()) Block{};
+  sentinel->set(0U, false);
+  sentinel->prev_physical = first;
+  insert(first);
+}
+
+void * TlsfResource::do_allocate(const std::size_t bytes, const std::size_t alignment)
+{
+  const auto max_bytes = std::numeric_limits<std::size_t>::max() / 4U;
+  if ((bytes > max_bytes) || (alignment > max_bytes) || (0U != (alignment & (alignment - 1U)))) {
+    throw std::bad_alloc{};
+  }
+  const auto size = (bytes < kMinPayload) ? kMinPayload : round_up(bytes, kGranularity);
+  // Over aligned allocations need room to split off a free block in front
+  const auto is_over_aligned = alignment > kGranularity;
+  Block * block = find(is_over_aligned ? (size + alignment + kHeaderSize + kMinPayload) : size);
+  if (nullptr == block) {
+    throw std::bad_alloc{};
+  }
+  remove(block);
+  if (is_over_aligned) {
+    const auto address = reinterpret_cast<std::uintptr_t>(block->payload());
+    auto gap = static_cast<std::size_t>(round_up(address, alignment) - address);
+    if ((0U != gap) && (gap < (kHeaderSize + kMinPayload))) {
+      gap += alignment;
+    }
+    if (0U != gap) {
+      split_leading(block, gap);
+    }
+  }
+  split_trailing(block, size);
+  block->set(block->size(), false);
+  m_used += block->size();
+  m_peak = (m_used > m_peak) ? m_used : m_peak;
+  return block->payload();
+}
+
+void TlsfResource::do_deallocate(void * const ptr, std::size_t, std::size_t)
+{
+  if (nullptr == ptr) {
+    return;
+  }
+  Block * block = Block::from_payload(ptr);
+  m_used -= block->size();
+  Block * const next = block->next_physical();
+  if (next->is_free()) {
+    remove(next);
+    block->set(block->size() + kHeaderSize + next->size(), false);
+    block->next_physical()->prev_physical = block;
+  }
+  Block * const prev = block->prev_physical;
+  if ((nullptr != prev) && prev->is_free()) {
+    remove(prev);
+    prev->set(prev->size() + kHeaderSize + block->size(), false);
+    prev->next_physical()->prev_physical = prev;
+    block = prev;
+  }
+  block->set(block->size(), true);
+  insert(block);
+}
+
+void TlsfResource::class_of(
+  const std::size_t size, std::size_t & first_level,
+  std::size_t & second_level) noexcept
+{
+  if (size < kSmallSize) {
+    first_level = 0U;
+    second_level = size / (kSmallSize / kSecondLevelCount);
+  } else {
+    const auto msb = most_significant_bit(size);
+    second_level = (size >> (msb - kSecondLevelBits)) ^ kSecondLevelCount;
+    first_level = msb - (kFirstLevelShift - 1U);
+  }
+}
+
+void TlsfResource::insert(Block * const block) noexcept
+{
+  std::size_t first_level;
+  std::size_t second_level;
+  class_of(block->size(), first_level, second_level);
+  Block *& head = m_free_lists[first_level][second_level];
+  block->next_free = head;
+  block->prev_free = nullptr;
+  if (nullptr != head) {
+    head->prev_free = block;
+  }
+  head = block;
+  m_first_level_bitmap |= (std::uint64_t{1U} << first_level);
+  m_second_level_bitmaps[first_level] |= (1U << second_level);
+}
+
+void TlsfResource::remove(Block * const block) noexcept
+{
+  std::size_t first_level;
+  std::size_t second_level;
+  class_of(block->size(), first_level, second_level);
+  if (nullptr != block->next_free) {
+    block->next_free->prev_free = block->prev_free;
+  }
+  if (nullptr != block->prev_free) {
+    block->prev_free->next_free = block->next_free;
+  } else {
+    Block *& head = m_free_lists[first_level][second_level];
+    head = block->next_free;
+    if (nullptr == head) {
+      m_second_level_bitmaps[first_level] &= ~(1U << second_level);
+      if (0U == m_second_level_bitmaps[first_level]) {
+        m_first_level_bitmap &= ~(std::uint64_t{1U} << first_level);
+      }
+    }
+  }
+}
+
+TlsfResource::Block * TlsfResource::find(std::size_t size) noexcept
+{
+  // Round up to the next class, so that every block in the class is large enough
+  if (size >= kSmallSize) {
+    size += (std::size_t{1U} << (most_significant_bit(size) - kSecondLevelBits)) - 1U;
+  }
+  std::size_t first_level;
+  std::size_t second_level;
+  class_of(size, first_level, second_level);
+  if (first_level >= kFirstLevelCount) {
+    return nullptr;
+  }
+  std::uint32_t second_level_map =
+    m_second_level_bitmaps[first_level] & (~0U << second_level);
+  if (0U == second_level_map) {
+    const auto first_level_map =
+      m_first_level_bitmap & (~std::uint64_t{0U} << (first_level + 1U));
+    if (0U == first_level_map) {
+      return nullptr;
+    }
+    first_level = least_significant_bit(first_level_map);
+    second_level_map = m_second_level_bitmaps[first_level];
+  }
+  return m_free_lists[first_level][least_significant_bit(second_level_map)];
+}
+
+void TlsfResource::split_leading(Block *& block, const std::size_t gap) noexcept
+{
+  auto * const rest = new (block->payload() + (gap - kHeaderSize)) Block{};
+  rest->set(block->size() - gap, false);
+  rest->prev_physical = block;
+  rest->next_physical()->prev_physical = rest;
+  block->set(gap - kHeaderSize, true);
+  insert(block);
+  block = rest;
+}
+
+void TlsfResource::split_trailing(Block * const block, const std::size_t size) noexcept
+{
+  if (block->size() < (size + kHeaderSize + kMinPayload)) {
+    return;
+  }
+  auto * const rest = new (block->payload() + size) Block{};
+  rest->set(block->size() - size - kHeaderSize, true);
+  rest->prev_physical = block;
+  rest->next_physical()->prev_physical = rest;
+  block->set(size, block->is_free());
+  insert(rest);
+}
+
+}  // namespace rt_memory
+}  // namespace common
+}  // namespace autoware
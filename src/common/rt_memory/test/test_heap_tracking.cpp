@@ -0,0 +1,125 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <rt_memory/allocation_diagnostics.hpp>
+#include <rt_memory/allocation_profiler.hpp>
+#include <rt_memory/heap_allocation_guard.hpp>
+#include <rt_memory/memory_resource.hpp>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using autoware::common::rt_memory::AllocationProfiler;
+using autoware::common::rt_memory::AllocationScope;
+using autoware::common::rt_memory::Allocator;
+using autoware::common::rt_memory::CallbackAllocations;
+using autoware::common::rt_memory::HeapAllocationGuard;
+using autoware::common::rt_memory::HeapAllocationMode;
+using autoware::common::rt_memory::MonotonicBufferResource;
+using autoware::common::rt_memory::heap_tracking_enabled;
+using autoware::common::rt_memory::to_status;
+
+TEST(TestHeapAllocationGuard, CountsAllocations)
+{
+  ASSERT_TRUE(heap_tracking_enabled());
+  MonotonicBufferResource resource{1024U};
+  std::vector<int, Allocator<int>> arena_vector{Allocator<int>{&resource}};
+  std::vector<int> heap_vector;
+  HeapAllocationGuard guard;
+  arena_vector.reserve(100U);
+  EXPECT_EQ(guard.count(), 0U);
+  heap_vector.reserve(100U);
+  EXPECT_EQ(guard.count(), 1U);
+  {
+    HeapAllocationGuard inner;
+    auto ptr = std::make_unique<int>(1);
+    EXPECT_EQ(inner.count(), 1U);
+    EXPECT_EQ(inner.bytes(), sizeof(int));
+  }
+  EXPECT_EQ(guard.count(), 2U);
+  EXPECT_EQ(guard.bytes(), (100U + 1U) * sizeof(int));
+}
+
+TEST(TestHeapAllocationGuard, AbortsOnAllocation)
+{
+  ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+  std::vector<int> heap_vector;
+  {
+    HeapAllocationGuard guard{HeapAllocationMode::kAbort};
+    HeapAllocationGuard counting{HeapAllocationMode::kCount};
+    heap_vector.reserve(10U);
+  }
+  EXPECT_DEATH(
+  {
+    HeapAllocationGuard guard{HeapAllocationMode::kAbort};
+    heap_vector.reserve(100U);
+  }, "heap allocation of 400 bytes");
+}
+
+TEST(TestAllocationProfiler, ProfilesEnabledCallbacks)
+{
+  AllocationProfiler profiler;
+  const auto points = profiler.register_callback("node/points");
+  const auto timer = profiler.register_callback("node/timer");
+  EXPECT_EQ(profiler.register_callback("node/points"), points);
+  EXPECT_NE(points, timer);
+  profiler.set_enabled(points, true);
+  for (std::size_t size = 1U; size <= 3U; ++size) {
+    const AllocationScope scope{profiler, points};
+    std::vector<char> heap_vector(size * 10U);
+  }
+  {
+    const AllocationScope scope{profiler, timer};
+    auto ptr = std::make_unique<int>(1);
+  }
+  const auto statistics = profiler.statistics(points);
+  EXPECT_EQ(statistics.name, "node/points");
+  EXPECT_EQ(statistics.calls, 3U);
+  EXPECT_EQ(statistics.allocations, 3U);
+  EXPECT_EQ(statistics.bytes, 60U);
+  EXPECT_EQ(statistics.max_allocations, 1U);
+  EXPECT_EQ(statistics.max_bytes, 30U);
+  // Disabled callbacks record nothing
+  EXPECT_EQ(profiler.statistics(timer).calls, 0U);
+  profiler.reset(points);
+  EXPECT_EQ(profiler.statistics(points).bytes, 0U);
+  EXPECT_THROW(profiler.statistics(timer + 1U), std::out_of_range);
+  for (std::size_t i = 2U; i < AllocationProfiler::kMaxCallbacks; ++i) {
+    (void)profiler.register_callback(std::to_string(i));
+  }
+  EXPECT_THROW(profiler.register_callback("full"), std::length_error);
+}
+
+TEST(TestAllocationProfiler, ToStatus)
+{
+  CallbackAllocations allocations;
+  allocations.name = "/perception/node/points";
+  allocations.calls = 4U;
+  allocations.allocations = 10U;
+  allocations.bytes = 1000U;
+  allocations.max_allocations = 4U;
+  allocations.max_bytes = 400U;
+  const auto status = to_status(allocations);
+  EXPECT_EQ(status.name, allocations.name);
+  ASSERT_EQ(status.values.size(), 6U);
+  EXPECT_EQ(status.values[0U].key, "calls");
+  EXPECT_EQ(status.values[0U].value, "4");
+  EXPECT_EQ(status.values[2U].key, "bytes");
+  EXPECT_EQ(status.values[2U].value, "1000");
+  EXPECT_EQ(status.values[3U].key, "allocations_per_call");
+  EXPECT_DOUBLE_EQ(std::stod(status.values[3U].value), 2.5);
+}
@@ -0,0 +1,193 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <rt_memory/memory_resource.hpp>
+#include <rt_memory/tlsf_resource.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using autoware::common::rt_memory::Allocator;
+using autoware::common::rt_memory::LockedResource;
+using autoware::common::rt_memory::MonotonicBufferResource;
+using autoware::common::rt_memory::TlsfResource;
+using autoware::common::rt_memory::kDefaultAlignment;
+
+namespace
+{
+bool is_aligned(const void * const ptr, const std::size_t alignment)
+{
+  return 0U == (reinterpret_cast<std::uintptr_t>(ptr) % alignment);
+}
+}  // namespace
+
+TEST(TestMonotonicBufferResource, AllocatesUntilFull)
+{
+  MonotonicBufferResource resource{1024U};
+  void * const first = resource.allocate(10U, 1U);
+  void * const second = resource.allocate(100U);
+  EXPECT_TRUE(is_aligned(second, kDefaultAlignment));
+  EXPECT_GE(static_cast<unsigned char *>(second), static_cast<unsigned char *>(first) + 10U);
+  EXPECT_THROW(resource.allocate(1024U), std::bad_alloc);
+  resource.deallocate(second, 100U);
+  EXPECT_GE(resource.used(), 110U);
+  resource.release();
+  EXPECT_EQ(resource.used(), 0U);
+  EXPECT_EQ(resource.allocate(1024U, 1U), first);
+}
+
+TEST(TestTlsfResource, ReusesFreedMemory)
+{
+  TlsfResource resource{4096U};
+  void * const first = resource.allocate(100U);
+  void * const second = resource.allocate(200U);
+  EXPECT_TRUE(is_aligned(first, kDefaultAlignment));
+  EXPECT_TRUE(is_aligned(second, kDefaultAlignment));
+  EXPECT_EQ(resource.used(), 112U + 208U);
+  resource.deallocate(first, 100U);
+  // A block of the same class is reused
+  EXPECT_EQ(resource.allocate(90U), first);
+  resource.deallocate(first, 90U);
+  resource.deallocate(second, 200U);
+  EXPECT_EQ(resource.used(), 0U);
+  EXPECT_EQ(resource.peak(), 320U);
+}
+
+TEST(TestTlsfResource, MergesFreeBlocks)
+{
+  TlsfResource resource{64U * 1024U};
+  std::vector<void *> blocks;
+  for (std::size_t i = 0U; i < 16U; ++i) {
+    blocks.push_back(resource.allocate(1000U));
+  }
+  EXPECT_THROW(resource.allocate(64U * 1024U), std::bad_alloc);
+  // Free in an order that merges with the previous, the next and both neighbours
+  for (const auto i : {1U, 3U, 2U, 0U, 5U, 4U, 15U, 6U, 7U, 9U, 8U, 10U, 12U, 14U, 13U, 11U}) {
+    resource.deallocate(blocks[i], 1000U);
+  }
+  EXPECT_EQ(resource.used(), 0U);
+  // All of it is one block again
+  void * const all = resource.allocate(60U * 1024U);
+  EXPECT_EQ(all, blocks[0U]);
+  resource.deallocate(all, 60U * 1024U);
+}
+
+TEST(TestTlsfResource, OverAligned)
+{
+  TlsfResource resource{16U * 1024U};
+  void * const small = resource.allocate(16U);
+  for (const std::size_t alignment : {32U, 64U, 256U, 4096U}) {
+    void * const ptr = resource.allocate(100U, alignment);
+    EXPECT_TRUE(is_aligned(ptr, alignment)) << alignment;
+    std::memset(ptr, 0xFF, 100U);
+    resource.deallocate(ptr, 100U, alignment);
+  }
+  resource.deallocate(small, 16U);
+  EXPECT_EQ(resource.used(), 0U);
+  EXPECT_EQ(resource.allocate(15U * 1024U), small);
+}
+
+TEST(TestTlsfResource, RandomAllocations)
+{
+  TlsfResource resource{4U * 1024U * 1024U};
+  std::mt19937 gen{42U};
+  std::uniform_int_distribution<std::size_t> size_dist{1U, 5000U};
+  std::vector<std::pair<unsigned char *, std::size_t>> live;
+  for (std::size_t iteration = 0U; iteration < 20000U; ++iteration) {
+    if ((!live.empty()) && ((gen() % 2U) == 0U)) {
+      const auto idx = gen() % live.size();
+      const auto block = live[idx];
+      // The content survives the allocations of other blocks
+      for (std::size_t i = 0U; i < block.second; ++i) {
+        ASSERT_EQ(block.first[i], static_cast<unsigned char>(block.second));
+      }
+      resource.deallocate(block.first, block.second);
+      live[idx] = live.back();
+      live.pop_back();
+    } else {
+      const auto size = size_dist(gen);
+      auto * const ptr = static_cast<unsigned char *>(resource.allocate(size));
+      std::memset(ptr, static_cast<int>(static_cast<unsigned char>(size)), size);
+      live.emplace_back(ptr, size);
+    }
+  }
+  for (const auto & block : live) {
+    resource.deallocate(block.first, block.second);
+  }
+  EXPECT_EQ(resource.used(), 0U);
+  // Nothing is fragmented once all is freed
+  resource.deallocate(resource.allocate(1000U * 1024U), 1000U * 1024U);
+}
+
+TEST(TestTlsfResource, RejectsTinyBuffer)
+{
+  EXPECT_THROW(TlsfResource{32U}, std::domain_error);
+}
+
+TEST(TestAllocator, Containers)
+{
+  TlsfResource resource{64U * 1024U};
+  using Vector = std::vector<float, Allocator<float>>;
+  Vector values{Allocator<float>{&resource}};
+  for (std::size_t i = 0U; i < 1000U; ++i) {
+    values.push_back(static_cast<float>(i));
+  }
+  EXPECT_GE(resource.used(), 4000U);
+  const auto peak = resource.peak();
+  // Copies keep the resource
+  Vector copy{values};
+  EXPECT_EQ(copy.get_allocator(), values.get_allocator());
+  EXPECT_EQ(copy, values);
+  EXPECT_GT(resource.peak(), peak);
+  // Assigning from the heap copies into the resource
+  Vector heap(10U, 1.0F);
+  EXPECT_NE(heap.get_allocator(), values.get_allocator());
+  values = std::move(heap);
+  EXPECT_EQ(values.get_allocator().resource(), &resource);
+  EXPECT_EQ(values.size(), 10U);
+  values.clear();
+  values.shrink_to_fit();
+  copy.clear();
+  copy.shrink_to_fit();
+  EXPECT_EQ(resource.used(), 0U);
+  EXPECT_THROW(Allocator<float>{&resource}.allocate(1U << 20U), std::bad_alloc);
+}
+
+TEST(TestLockedResource, SharedByThreads)
+{
+  TlsfResource resource{1024U * 1024U};
+  LockedResource locked{resource};
+  std::vector<std::thread> threads;
+  for (std::size_t t = 0U; t < 4U; ++t) {
+    threads.emplace_back(
+      [&locked]() {
+        for (std::size_t i = 0U; i < 1000U; ++i) {
+          void * const ptr = locked.allocate(64U + i);
+          locked.deallocate(ptr, 64U + i);
+        }
+      });
+  }
+  for (auto & thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(resource.used(), 0U);
+}
@@ -0,0 +1,190 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief A ring of reference counted slots in POSIX shared memory, for handing large payloads
+///        to other processes on the same host without serializing them
+
+#ifndef SHARED_MEMORY_TRANSPORT__SHARED_MEMORY_RING_HPP_
+#define SHARED_MEMORY_TRANSPORT__SHARED_MEMORY_RING_HPP_
+
+#include <common/types.hpp>
+#include <shared_memory_transport/visibility_control.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace autoware
+{
+namespace common
+{
+namespace shared_memory_transport
+{
+using autoware::common::types::bool8_t;
+
+class SharedMemorySegment;
+
+/// \brief Refers to one sample in a shared memory ring. This is what is sent to the readers
+///        instead of the payload
+struct SHARED_MEMORY_TRANSPORT_PUBLIC SharedMemoryDescriptor
+{
+  /// The name of the shared memory segment of the ring
+  std::string segment{};
+  /// The slot of the ring that holds the sample
+  uint32_t slot{0U};
+  /// The sequence number of the sample, it tells a sample apart from later ones in the same slot
+  uint64_t sequence{0U};
+  /// The size of the payload in bytes
+  uint64_t size{0U};
+};
+
+/// \brief Write a descriptor into a byte array, e.g. the data of a message
+/// \param[in] descriptor The descriptor to write
+/// \param[out] bytes The bytes of the descriptor, their previous content is replaced
+SHARED_MEMORY_TRANSPORT_PUBLIC void serialize_descriptor(
+  const SharedMemoryDescriptor & descriptor,
+  std::vector<uint8_t> & bytes);
+
+/// \brief Check if a byte array is a descriptor written by serialize_descriptor()
+/// \param[in] bytes The bytes to check
+/// \return True if the bytes start like a descriptor
+SHARED_MEMORY_TRANSPORT_PUBLIC bool8_t is_descriptor(const std::vector<uint8_t> & bytes) noexcept;
+
+/// \brief Read a descriptor written by serialize_descriptor()
+/// \param[in] bytes The bytes of the descriptor
+/// \return The descriptor
+/// \throw std::runtime_error If the bytes are not a complete descriptor
+SHARED_MEMORY_TRANSPORT_PUBLIC SharedMemoryDescriptor parse_descriptor(
+  const std::vector<uint8_t> & bytes);
+
+/// \brief Make a segment name that is unique on the host, e.g. for the ring of a publisher
+/// \param[in] prefix The start of the name, characters that are invalid in a name are replaced
+/// \return The prefix, the process id and a counter of the process, with a leading '/'
+SHARED_MEMORY_TRANSPORT_PUBLIC std::string make_unique_segment_name(const std::string & prefix);
+
+/// \brief A fixed number of fixed size slots in a shared memory segment, written by the process
+///        that owns the ring and read by any number of processes with a SharedMemoryRingReader.
+///        Every slot has a reference count: a reader holds a reference while it uses a sample,
+///        and the writer only reuses slots that are not referenced. Otherwise the writer reuses
+///        the slot of the oldest sample, so a descriptor that arrives after its slot was reused
+///        is detected by its sequence number and the sample is lost, like a message that falls
+///        out of the history of a keep last QoS.
+///        The segment is removed from the file system when the ring is destroyed, but stays
+///        mapped as long as readers keep a sample or a reader of it
+class SHARED_MEMORY_TRANSPORT_PUBLIC SharedMemoryRing
+{
+public:
+  /// \brief Constructor, creates the shared memory segment. A stale segment of the same name,
+  ///        e.g. of a process that crashed, is replaced
+  /// \param[in] name The name of the segment, a leading '/' is added if it is missing. It must
+  ///                 consist of letters, digits, '_', '-' and '.' only
+  /// \param[in] slot_count The number of samples that can exist at the same time, at least 2
+  /// \param[in] slot_capacity The maximum size of a sample in bytes, at least 1
+  /// \throw std::domain_error If the name or a size is invalid
+  /// \throw std::runtime_error If the segment can't be created
+  SharedMemoryRing(const std::string & name, std::size_t slot_count, std::size_t slot_capacity);
+  SharedMemoryRing(const SharedMemoryRing &) = delete;
+  SharedMemoryRing & operator=(const SharedMemoryRing &) = delete;
+  ~SharedMemoryRing();
+
+  /// \brief Copy a payload into the next free slot. Must only be called by one thread at a time
+  /// \param[in] data The payload
+  /// \param[in] size The size of the payload in bytes
+  /// \param[out] descriptor Refers to the written sample, unchanged if nothing was written
+  /// \return False if every slot is referenced by a reader, in which case nothing is written
+  /// \throw std::domain_error If the payload is larger than a slot
+  bool8_t write(const void * data, std::size_t size, SharedMemoryDescriptor & descriptor);
+
+  /// \brief The name of the shared memory segment, with the leading '/'
+  const std::string & name() const noexcept;
+  /// \brief The number of slots of the ring
+  std::size_t slot_count() const noexcept;
+  /// \brief The maximum size of a sample in bytes
+  std::size_t slot_capacity() const noexcept;
+
+private:
+  std::string m_name;
+  std::unique_ptr<SharedMemorySegment> m_segment;
+  /// The slot after the most recently written one, where the search for a free slot starts
+  std::size_t m_next_slot{0U};
+  uint64_t m_sequence{0U};
+};
+
+/// \brief A reference to a sample in a shared memory ring. The slot of the sample is not reused
+///        by the writer while the reference exists. Move only
+class SHARED_MEMORY_TRANSPORT_PUBLIC SharedMemorySample
+{
+public:
+  /// \brief An empty sample
+  SharedMemorySample() = default;
+  SharedMemorySample(const SharedMemorySample &) = delete;
+  SharedMemorySample & operator=(const SharedMemorySample &) = delete;
+  SharedMemorySample(SharedMemorySample && other) noexcept;
+  SharedMemorySample & operator=(SharedMemorySample && other) noexcept;
+  /// \brief Releases the reference to the sample
+  ~SharedMemorySample();
+
+  /// \brief True if the sample refers to a payload
+  bool8_t valid() const noexcept;
+  /// \brief The payload, nullptr for an empty sample. It is valid until the sample is reset
+  const uint8_t * data() const noexcept;
+  /// \brief The size of the payload in bytes
+  std::size_t size() const noexcept;
+  /// \brief Release the reference early, the sample is empty afterwards
+  void reset() noexcept;
+
+private:
+  friend class SharedMemoryRingReader;
+  SharedMemorySample(
+    std::shared_ptr<const SharedMemorySegment> segment, std::size_t slot,
+    const uint8_t * data, std::size_t size) noexcept;
+
+  std::shared_ptr<const SharedMemorySegment> m_segment{};
+  std::size_t m_slot{0U};
+  const uint8_t * m_data{nullptr};
+  std::size_t m_size{0U};
+};
+
+/// \brief Reads the samples of a SharedMemoryRing, e.g. in another process. Any number of
+///        threads can acquire samples from the same reader
+class SHARED_MEMORY_TRANSPORT_PUBLIC SharedMemoryRingReader
+{
+public:
+  /// \brief Constructor, maps the shared memory segment of a ring
+  /// \param[in] name The name of the segment as in a descriptor
+  /// \throw std::runtime_error If the segment doesn't exist or isn't a ring
+  explicit SharedMemoryRingReader(const std::string & name);
+
+  /// \brief Take a reference to the sample of a descriptor, without copying it
+  /// \param[in] descriptor A descriptor of a sample of this ring
+  /// \return The sample, or an empty sample if its slot was already reused by a later sample
+  /// \throw std::runtime_error If the descriptor doesn't fit the ring
+  SharedMemorySample acquire(const SharedMemoryDescriptor & descriptor) const;
+
+  /// \brief The name of the shared memory segment, with the leading '/'
+  const std::string & name() const noexcept;
+
+private:
+  std::string m_name;
+  std::shared_ptr<const SharedMemorySegment> m_segment;
+};
+
+}  // namespace shared_memory_transport
+}  // namespace common
+}  // namespace autoware
+
+#endif  // SHARED_MEMORY_TRANSPORT__SHARED_MEMORY_RING_HPP_
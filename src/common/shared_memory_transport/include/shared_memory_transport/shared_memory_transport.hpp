@@ -0,0 +1,205 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief Publishers and subscriptions that send the data of large messages, e.g. point clouds
+///        and images, through a shared memory ring and only a descriptor of it through ROS
+
+#ifndef SHARED_MEMORY_TRANSPORT__SHARED_MEMORY_TRANSPORT_HPP_
+#define SHARED_MEMORY_TRANSPORT__SHARED_MEMORY_TRANSPORT_HPP_
+
+#include <common/types.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <shared_memory_transport/shared_memory_ring.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace autoware
+{
+namespace common
+{
+namespace shared_memory_transport
+{
+
+/// \brief Publishes messages with a `data` byte array, e.g. `sensor_msgs::msg::PointCloud2` or
+///        `sensor_msgs::msg::Image`, through a SharedMemoryRing. The data is copied into the ring
+///        once, and the message is published with the descriptor of the sample in place of its
+///        data. Subscribers in other processes on the same host then only receive the small
+///        message and read the data from the ring with a SharedMemorySubscription, so the cost of
+///        a subscriber doesn't grow with the size of the data.
+/// \tparam MessageT The type of the message, it must have a `std::vector<uint8_t> data` member
+template<typename MessageT>
+class SharedMemoryPublisher
+{
+public:
+  /// \brief Constructor, creates the ring and the publisher of the descriptors
+  /// \param[in] node The node to create the publisher with
+  /// \param[in] topic The topic of the descriptors
+  /// \param[in] qos The QoS of the descriptors
+  /// \param[in] slot_count The number of messages that can be in flight or read at once, the
+  ///                       ring holds the data of this many messages
+  /// \param[in] slot_capacity The maximum size of the data of a message in bytes
+  /// \throw std::domain_error If a size is invalid
+  /// \throw std::runtime_error If the ring can't be created
+  SharedMemoryPublisher(
+    rclcpp::Node & node, const std::string & topic, const rclcpp::QoS & qos,
+    const std::size_t slot_count, const std::size_t slot_capacity)
+  : m_ring{make_unique_segment_name(node.get_fully_qualified_name() + topic), slot_count,
+      slot_capacity},
+    m_publisher{node.create_publisher<MessageT>(topic, qos)}
+  {
+  }
+
+  /// \brief Copy the data of a message into the ring and publish its descriptor
+  /// \param[in] msg The message to publish. Its data is swapped out while it is published, so
+  ///                the message is unchanged afterwards
+  /// \return False if every slot of the ring is still read by subscribers, in which case
+  ///         nothing is published
+  /// \throw std::domain_error If the data doesn't fit into a slot
+  bool8_t publish(MessageT & msg)
+  {
+    SharedMemoryDescriptor descriptor{};
+    if (!m_ring.write(msg.data.data(), msg.data.size(), descriptor)) {
+      return false;
+    }
+    serialize_descriptor(descriptor, m_descriptor);
+    std::swap(msg.data, m_descriptor);
+    try {
+      m_publisher->publish(msg);
+    } catch (...) {
+      std::swap(msg.data, m_descriptor);
+      throw;
+    }
+    std::swap(msg.data, m_descriptor);
+    return true;
+  }
+
+  /// \brief The number of subscriptions of the descriptors, e.g. to skip the copy into the ring
+  std::size_t get_subscription_count() const
+  {
+    return m_publisher->get_subscription_count();
+  }
+
+  /// \brief The ring the data is written to
+  const SharedMemoryRing & ring() const noexcept
+  {
+    return m_ring;
+  }
+
+private:
+  SharedMemoryRing m_ring;
+  typename rclcpp::Publisher<MessageT>::SharedPtr m_publisher;
+  /// The bytes of the last descriptor, kept to reuse their memory
+  std::vector<uint8_t> m_descriptor{};
+};
+
+/// \brief Subscribes to the descriptors of a SharedMemoryPublisher and hands the data from the
+///        shared memory ring of the publisher to a callback, without copying it. The rings are
+///        opened when the first descriptor of a publisher arrives
+/// \tparam MessageT The type of the message, it must have a `std::vector<uint8_t> data` member
+template<typename MessageT>
+class SharedMemorySubscription
+{
+public:
+  /// \brief Called with the message, whose data is the descriptor, and the data from the ring.
+  ///        The data is only valid during the callback, unless the sample is moved out of it
+  using Callback = std::function<void (const MessageT &, SharedMemorySample &)>;
+
+  /// \brief Constructor, creates the subscription of the descriptors
+  /// \param[in] node The node to create the subscription with, it must outlive this object
+  /// \param[in] topic The topic of the descriptors
+  /// \param[in] qos The QoS of the descriptors
+  /// \param[in] callback Called for every message whose data could be read
+  SharedMemorySubscription(
+    rclcpp::Node & node, const std::string & topic, const rclcpp::QoS & qos, Callback callback)
+  : m_node{node},
+    m_callback{std::move(callback)},
+    m_subscription{node.create_subscription<MessageT>(
+        topic, qos, [this](const typename MessageT::ConstSharedPtr msg) {on_message(*msg);})}
+  {
+  }
+  SharedMemorySubscription(const SharedMemorySubscription &) = delete;
+  SharedMemorySubscription & operator=(const SharedMemorySubscription &) = delete;
+
+private:
+  /// Rings of publishers that restarted are released once this many rings were opened
+  static constexpr std::size_t kMaxReaders = 16U;
+
+  void on_message(const MessageT & msg)
+  {
+    SharedMemorySample sample{};
+    try {
+      const auto descriptor = parse_descriptor(msg.data);
+      sample = reader(descriptor.segment).acquire(descriptor);
+    } catch (const std::runtime_error & e) {
+      RCLCPP_WARN_THROTTLE(
+        m_node.get_logger(), *m_node.get_clock(), 5000,
+        "Dropping a message that can't be read from shared memory: %s", e.what());
+      return;
+    }
+    if (!sample.valid()) {
+      RCLCPP_WARN_THROTTLE(
+        m_node.get_logger(), *m_node.get_clock(), 5000,
+        "Dropping a message that was overwritten in shared memory before it was read. The ring "
+        "of the publisher has too few slots.");
+      return;
+    }
+    m_callback(msg, sample);
+  }
+
+  const SharedMemoryRingReader & reader(const std::string & segment)
+  {
+    auto it = m_readers.find(segment);
+    if (it == m_readers.end()) {
+      if (m_readers.size() >= kMaxReaders) {
+        // Samples keep their own reference to the mapping, so this is safe at any time.
+        m_readers.clear();
+      }
+      it = m_readers.emplace(segment, SharedMemoryRingReader{segment}).first;
+    }
+    return it->second;
+  }
+
+  rclcpp::Node & m_node;
+  Callback m_callback;
+  std::map<std::string, SharedMemoryRingReader> m_readers{};
+  typename rclcpp::Subscription<MessageT>::SharedPtr m_subscription;
+};
+
+/// \brief Restore a complete message from a message of a SharedMemorySubscription, for code that
+///        needs the data inside the message. This copies the data once
+/// \tparam MessageT The type of the message, it must have a `std::vector<uint8_t> data` member
+/// \param[in] msg The message with the descriptor
+/// \param[in] sample The data of the message
+/// \param[out] restored The message with its data, its memory is reused
+template<typename MessageT>
+void restore_message(const MessageT & msg, const SharedMemorySample & sample, MessageT & restored)
+{
+  auto data = std::move(restored.data);
+  restored = msg;
+  data.assign(sample.data(), sample.data() + sample.size());
+  restored.data = std::move(data);
+}
+
+}  // namespace shared_memory_transport
+}  // namespace common
+}  // namespace autoware
+
+#endif  // SHARED_MEMORY_TRANSPORT__SHARED_MEMORY_TRANSPORT_HPP_
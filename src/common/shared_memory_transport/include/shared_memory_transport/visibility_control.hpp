@@ -0,0 +1,38 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef SHARED_MEMORY_TRANSPORT__VISIBILITY_CONTROL_HPP_
+#define SHARED_MEMORY_TRANSPORT__VISIBILITY_CONTROL_HPP_
+
+////////////////////////////////////////////////////////////////////////////////
+#if defined(__WIN32)
+  #if defined(SHARED_MEMORY_TRANSPORT_BUILDING_DLL) || defined(SHARED_MEMORY_TRANSPORT_EXPORTS)
+    #define SHARED_MEMORY_TRANSPORT_PUBLIC __declspec(dllexport)
+    #define SHARED_MEMORY_TRANSPORT_LOCAL
+  #else  // defined(SHARED_MEMORY_TRANSPORT_BUILDING_DLL) || ...
+    #define SHARED_MEMORY_TRANSPORT_PUBLIC __declspec(dllimport)
+    #define SHARED_MEMORY_TRANSPORT_LOCAL
+  #endif  // defined(SHARED_MEMORY_TRANSPORT_BUILDING_DLL) || ...
+#elif defined(__linux__)
+  #define SHARED_MEMORY_TRANSPORT_PUBLIC __attribute__((visibility("default")))
+  #define SHARED_MEMORY_TRANSPORT_LOCAL __attribute__((visibility("hidden")))
+#elif defined(__APPLE__)
+  #define SHARED_MEMORY_TRANSPORT_PUBLIC __attribute__((visibility("default")))
+  #define SHARED_MEMORY_TRANSPORT_LOCAL __attribute__((visibility("hidden")))
+#else  // defined(__linux__)
+  #error "Unsupported Build Configuration"
+#endif  // defined(__WIN32)
+
+#endif  // SHARED_MEMORY_TRANSPORT__VISIBILITY_CONTROL_HPP_
@@ -0,0 +1,466 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <shared_memory_transport/shared_memory_ring.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// The counters are shared between processes, which is only well-defined for lock-free atomics.
+static_assert(ATOMIC_INT_LOCK_FREE == 2, "Shared memory rings need lock-free 32 bit atomics");
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "Shared memory rings need lock-free 64 bit atomics");
+
+namespace autoware
+{
+namespace common
+{
+namespace shared_memory_transport
+{
+namespace
+{
+constexpr uint32_t kRingMagic = 0x474E5253U;  // "SRNG"
+constexpr uint32_t kRingVersion = 1U;
+constexpr std::array<uint8_t, 4U> kDescriptorMagic{{0x53U, 0x48U, 0x4DU, 0x44U}};  // "SHMD"
+constexpr uint8_t kDescriptorVersion = 1U;
+constexpr std::size_t kDescriptorFixedSize = 4U + 1U + 4U + 8U + 8U + 2U;
+// Slots are aligned to cache lines, so that the counters of neighbouring slots don't share one.
+constexpr std::size_t kAlignment = 64U;
+// The reference count of a slot while the writer fills it.
+constexpr uint32_t kWriting = std::numeric_limits<uint32_t>::max();
+constexpr std::size_t kMaxNameLength = 200U;
+
+struct RingHeader
+{
+  uint32_t magic;
+  uint32_t version;
+  uint64_t slot_count;
+  uint64_t slot_capacity;
+  uint64_t slot_stride;
+};
+
+struct SlotHeader
+{
+  std::atomic<uint32_t> ref_count;
+  std::atomic<uint64_t> sequence;
+  // Only accessed by the writer while the slot is kWriting or by readers holding a reference.
+  uint64_t size;
+};
+
+constexpr std::size_t round_up(const std::size_t value) noexcept
+{
+  return ((value + kAlignment - 1U) / kAlignment) * kAlignment;
+}
+
+constexpr std::size_t kHeaderSize = round_up(sizeof(RingHeader));
+
+bool8_t is_valid_name_char(const char c) noexcept
+{
+  return ((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) ||
+         ((c >= '0') && (c <= '9')) || (c == '_') || (c == '-') || (c == '.');
+}
+
+std::string to_segment_name(const std::string & name)
+{
+  const auto segment = (!name.empty() && (name.front() == '/')) ? name : ("/" + name);
+  if ((segment.size() < 2U) || (segment.size() > kMaxNameLength) ||
+    !std::all_of(segment.begin() + 1, segment.end(), is_valid_name_char))
+  {
+    throw std::domain_error("SharedMemoryRing: invalid segment name " + name);
+  }
+  return segment;
+}
+
+template<typename T>
+void put(std::vector<uint8_t> & bytes, const T value)
+{
+  for (std::size_t i = 0U; i < sizeof(T); ++i) {
+    bytes.push_back(static_cast<uint8_t>((static_cast<uint64_t>(value) >> (8U * i)) & 0xFFU));
+  }
+}
+
+template<typename T>
+T get(const std::vector<uint8_t> & bytes, std::size_t & offset)
+{
+  uint64_t value = 0U;
+  for (std::size_t i = 0U; i < sizeof(T); ++i) {
+    value |= static_cast<uint64_t>(bytes[offset + i]) << (8U * i);
+  }
+  offset += sizeof(T);
+  return static_cast<T>(value);
+}
+}  // namespace
+
+/// The mapping of a ring segment, unmapped on destruction
+class SharedMemorySegment
+{
+public:
+  SharedMemorySegment(void * data, const std::size_t size) noexcept
+  : m_data{static_cast<uint8_t *>(data)}, m_size{size} {}
+  SharedMemorySegment(const SharedMemorySegment &) = delete;
+  SharedMemorySegment & operator=(const SharedMemorySegment &) = delete;
+  ~SharedMemorySegment()
+  {
+    (void) ::munmap(m_data, m_size);
+  }
+
+  RingHeader & header() const noexcept
+  {
+    return *reinterpret_cast<RingHeader *>(m_data);
+  }
+  SlotHeader & slot(const std::size_t index) const noexcept
+  {
+    return *reinterpret_cast<SlotHeader *>(m_data + kHeaderSize + (index * header().slot_stride));
+  }
+  uint8_t * payload(const std::size_t index) const noexcept
+  {
+    return reinterpret_cast<uint8_t *>(&slot(index)) + round_up(sizeof(SlotHeader));
+  }
+  std::size_t slot_count() const noexcept
+  {
+    return static_cast<std::size_t>(header().slot_count);
+  }
+  std::size_t slot_capacity() const noexcept
+  {
+    return static_cast<std::size_t>(header().slot_capacity);
+  }
+
+private:
+  uint8_t * m_data;
+  std::size_t m_size;
+};
+
+void serialize_descriptor(const SharedMemoryDescriptor & descriptor, std::vector<uint8_t> & bytes)
+{
+  if (descriptor.segment.size() > kMaxNameLength) {
+    throw std::domain_error("serialize_descriptor: the segment name is too long");
+  }
+  bytes.clear();
+  bytes.reserve(kDescriptorFixedSize + descriptor.segment.size());
+  for (const auto byte : kDescriptorMagic) {
+    bytes.push_back(byte);
+  }
+  bytes.push_back(kDescriptorVersion);
+  put(bytes, descriptor.slot);
+  put(bytes, descriptor.sequence);
+  put(bytes, descriptor.size);
+  put(bytes, static_cast<uint16_t>(descriptor.segment.size()));
+  bytes.insert(bytes.end(), descriptor.segment.begin(), descriptor.segment.end());
+}
+
+bool8_t is_descriptor(const std::vector<uint8_t> & bytes) noexcept
+{
+  return (bytes.size() >= kDescriptorFixedSize) &&
+         std::equal(kDescriptorMagic.begin(), kDescriptorMagic.end(), bytes.begin());
+}
+
+SharedMemoryDescriptor parse_descriptor(const std::vector<uint8_t> & bytes)
+{
+  if (!is_descriptor(bytes)) {
+    throw std::runtime_error("parse_descriptor: the data is not a shared memory descriptor");
+  }
+  std::size_t offset = kDescriptorMagic.size();
+  if (bytes[offset] != kDescriptorVersion) {
+    throw std::runtime_error("parse_descriptor: unknown descriptor version");
+  }
+  ++offset;
+  SharedMemoryDescriptor descriptor{};
+  descriptor.slot = get<uint32_t>(bytes, offset);
+  descriptor.sequence = get<uint64_t>(bytes, offset);
+  descriptor.size = get<uint64_t>(bytes, offset);
+  const auto name_length = static_cast<std::size_t>(get<uint16_t>(bytes, offset));
+  if (bytes.size() != (offset + name_length)) {
+    throw std::runtime_error("parse_descriptor: the descriptor is truncated");
+  }
+  descriptor.segment.assign(bytes.begin() + static_cast<std::ptrdiff_t>(offset), bytes.end());
+  return descriptor;
+}
+
+std::string make_unique_segment_name(const std::string & prefix)
+{
+  static std::atomic<uint32_t> counter{0U};
+  const auto suffix = "_" + std::to_string(::getpid()) + "_" +
+    std::to_string(counter.fetch_add(1U, std::memory_order_relaxed));
+  std::string name{"/"};
+  for (const auto c : prefix.substr(0U, kMaxNameLength - 32U)) {
+    name.push_back(is_valid_name_char(c) ? c : '_');
+  }
+  return name + suffix;
+}
+
+SharedMemoryRing::SharedMemoryRing(
+  const std::string & name,
+  const std::size_t slot_count,
+  const std::size_t slot_capacity)
+: m_name{to_segment_name(name)}
+{
+  if ((slot_count < 2U) || (slot_count > std::numeric_limits<uint32_t>::max())) {
+    throw std::domain_error("SharedMemoryRing: the slot count must be at least 2");
+  }
+  constexpr auto kMaxSize = static_cast<std::size_t>(std::numeric_limits<off_t>::max());
+  const auto slot_header_size = round_up(sizeof(SlotHeader));
+  if ((slot_capacity == 0U) ||
+    (slot_capacity > ((kMaxSize - kHeaderSize) / slot_count) - (slot_header_size + kAlignment)))
+  {
+    throw std::domain_error("SharedMemoryRing: the slot capacity must be at least 1 and fit");
+  }
+  const auto slot_stride = round_up(slot_header_size + slot_capacity);
+  const auto size = kHeaderSize + (slot_count * slot_stride);
+
+  (void) ::shm_unlink(m_name.c_str());
+  const auto fd = ::shm_open(m_name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+  if (fd < 0) {
+    throw std::runtime_error("SharedMemoryRing: " + m_name + " could not be created.");
+  }
+  if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+    (void) ::close(fd);
+    (void) ::shm_unlink(m_name.c_str());
+    throw std::runtime_error("SharedMemoryRing: " + m_name + " could not be resized.");
+  }
+  auto data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  // The mapping stays valid after closing the descriptor.
+  (void) ::close(fd);
+  if (data == MAP_FAILED) {
+    (void) ::shm_unlink(m_name.c_str());
+    throw std::runtime_error("SharedMemoryRing: " + m_name + " could not be mapped.");
+  }
+  m_segment = std::make_unique<SharedMemorySegment>(data, size);
+
+  auto & header = m_segment->header();
+  header.version = kRingVersion;
+  header.slot_count = slot_count;
+  header.slot_capacity = slot_capacity;
+  header.slot_stride = slot_stride;
+  for (std::size_t i = 0U; i < slot_count; ++i) {
+    auto slot = new (&m_segment->slot(i)) SlotHeader;
+    slot->ref_count.store(0U, std::memory_order_relaxed);
+    slot->sequence.store(0U, std::memory_order_relaxed);
+    slot->size = 0U;
+  }
+  // Readers check the magic, so it is written last.
+  std::atomic_thread_fence(std::memory_order_release);
+  header.magic = kRingMagic;
+}
+
+SharedMemoryRing::~SharedMemoryRing()
+{
+  // Readers keep their mappings, the segment is freed once the last one is unmapped.
+  (void) ::shm_unlink(m_name.c_str());
+}
+
+bool8_t SharedMemoryRing::write(
+  const void * const data,
+  const std::size_t size,
+  SharedMemoryDescriptor & descriptor)
+{
+  if (size > slot_capacity()) {
+    throw std::domain_error("SharedMemoryRing: the payload is larger than a slot");
+  }
+  const auto count = slot_count();
+  for (std::size_t i = 0U; i < count; ++i) {
+    const auto index = (m_next_slot + i) % count;
+    auto & slot = m_segment->slot(index);
+    uint32_t unreferenced = 0U;
+    // Acquire, so that the readers that released the slot are done with the old sample.
+    if (!slot.ref_count.compare_exchange_strong(
+        unreferenced, kWriting, std::memory_order_acquire, std::memory_order_relaxed))
+    {
+      continue;
+    }
+    if (size > 0U) {
+      (void) std::memcpy(m_segment->payload(index), data, size);
+    }
+    slot.size = size;
+    ++m_sequence;
+    slot.sequence.store(m_sequence, std::memory_order_relaxed);
+    // Release, so that a reader that takes a reference sees the new sample.
+    slot.ref_count.store(0U, std::memory_order_release);
+    m_next_slot = (index + 1U) % count;
+
+    descriptor.segment = m_name;
+    descriptor.slot = static_cast<uint32_t>(index);
+    descriptor.sequence = m_sequence;
+    descriptor.size = size;
+    return true;
+  }
+  return false;
+}
+
+const std::string & SharedMemoryRing::name() const noexcept
+{
+  return m_name;
+}
+
+std::size_t SharedMemoryRing::slot_count() const noexcept
+{
+  return m_segment->slot_count();
+}
+
+std::size_t SharedMemoryRing::slot_capacity() const noexcept
+{
+  return m_segment->slot_capacity();
+}
+
+SharedMemorySample::SharedMemorySample(
+  std::shared_ptr<const SharedMemorySegment> segment,
+  const std::size_t slot,
+  const uint8_t * const data,
+  const std::size_t size) noexcept
+: m_segment{std::move(segment)}, m_slot{slot}, m_data{data}, m_size{size}
+{
+}
+
+SharedMemorySample::SharedMemorySample(SharedMemorySample && other) noexcept
+: m_segment{std::move(other.m_segment)},
+  m_slot{other.m_slot},
+  m_data{other.m_data},
+  m_size{other.m_size}
+{
+  other.m_segment = nullptr;
+  other.m_data = nullptr;
+  other.m_size = 0U;
+}
+
+SharedMemorySample & SharedMemorySample::operator=(SharedMemorySample && other) noexcept
+{
+  if (this != &other) {
+    reset();
+    m_segment = std::move(other.m_segment);
+    m_slot = other.m_slot;
+    m_data = other.m_data;
+    m_size = other.m_size;
+    other.m_segment = nullptr;
+    other.m_data = nullptr;
+    other.m_size = 0U;
+  }
+  return *this;
+}
+
+SharedMemorySample::~SharedMemorySample()
+{
+  reset();
+}
+
+bool8_t SharedMemorySample::valid() const noexcept
+{
+  return m_segment != nullptr;
+}
+
+const uint8_t * SharedMemorySample::data() const noexcept
+{
+  return m_data;
+}
+
+std::size_t SharedMemorySample::size() const noexcept
+{
+  return m_size;
+}
+
+void SharedMemorySample::reset() noexcept
+{
+  if (m_segment) {
+    // Release, so that the writer only reuses the slot after the sample was read.
+    (void) m_segment->slot(m_slot).ref_count.fetch_sub(1U, std::memory_order_release);
+    m_segment = nullptr;
+    m_data = nullptr;
+    m_size = 0U;
+  }
+}
+
+SharedMemoryRingReader::SharedMemoryRingReader(const std::string & name)
+: m_name{name}
+{
+  const auto fd = ::shm_open(m_name.c_str(), O_RDWR, 0);
+  if (fd < 0) {
+    throw std::runtime_error("SharedMemoryRingReader: " + m_name + " could not be opened.");
+  }
+  struct stat segment_stat {};
+  if ((::fstat(fd, &segment_stat) != 0) ||
+    (static_cast<std::size_t>(segment_stat.st_size) < kHeaderSize))
+  {
+    (void) ::close(fd);
+    throw std::runtime_error("SharedMemoryRingReader: " + m_name + " is not a ring.");
+  }
+  const auto size = static_cast<std::size_t>(segment_stat.st_size);
+  auto data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  (void) ::close(fd);
+  if (data == MAP_FAILED) {
+    throw std::runtime_error("SharedMemoryRingReader: " + m_name + " could not be mapped.");
+  }
+  auto segment = std::make_shared<const SharedMemorySegment>(data, size);
+
+  const auto & header = segment->header();
+  const auto magic = header.magic;
+  std::atomic_thread_fence(std::memory_order_acquire);
+  const auto slot_header_size = round_up(sizeof(SlotHeader));
+  if ((magic != kRingMagic) || (header.version != kRingVersion) || (header.slot_count == 0U) ||
+    ((header.slot_stride % kAlignment) != 0U) || (header.slot_stride < slot_header_size) ||
+    (header.slot_capacity > (header.slot_stride - slot_header_size)) ||
+    (header.slot_stride > size) ||
+    (header.slot_count > ((size - kHeaderSize) / header.slot_stride)))
+  {
+    throw std::runtime_error("SharedMemoryRingReader: " + m_name + " is not a ring.");
+  }
+  m_segment = std::move(segment);
+}
+
+SharedMemorySample SharedMemoryRingReader::acquire(const SharedMemoryDescriptor & descriptor)
+const
+{
+  if ((descriptor.slot >= m_segment->slot_count()) ||
+    (descriptor.size > m_segment->slot_capacity()))
+  {
+    throw std::runtime_error("SharedMemoryRingReader: the descriptor doesn't fit " + m_name);
+  }
+  auto & slot = m_segment->slot(descriptor.slot);
+  auto ref_count = slot.ref_count.load(std::memory_order_relaxed);
+  do {
+    if (ref_count >= (kWriting - 1U)) {
+      // The writer is filling the slot, so the sample is gone.
+      return SharedMemorySample{};
+    }
+  } while (!slot.ref_count.compare_exchange_weak(
+    ref_count, ref_count + 1U, std::memory_order_acquire, std::memory_order_relaxed));
+
+  SharedMemorySample sample{m_segment, descriptor.slot, m_segment->payload(descriptor.slot),
+    static_cast<std::size_t>(descriptor.size)};
+  if ((slot.sequence.load(std::memory_order_relaxed) != descriptor.sequence) ||
+    (slot.size != descriptor.size))
+  {
+    // The slot already holds a later sample.
+    sample.reset();
+  }
+  return sample;
+}
+
+const std::string & SharedMemoryRingReader::name() const noexcept
+{
+  return m_name;
+}
+
+}  // namespace shared_memory_transport
+}  // namespace common
+}  // namespace autoware
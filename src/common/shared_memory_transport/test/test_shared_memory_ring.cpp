@@ -0,0 +1,206 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <shared_memory_transport/shared_memory_ring.hpp>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+using autoware::common::shared_memory_transport::SharedMemoryDescriptor;
+using autoware::common::shared_memory_transport::SharedMemoryRing;
+using autoware::common::shared_memory_transport::SharedMemoryRingReader;
+using autoware::common::shared_memory_transport::SharedMemorySample;
+using autoware::common::shared_memory_transport::is_descriptor;
+using autoware::common::shared_memory_transport::make_unique_segment_name;
+using autoware::common::shared_memory_transport::parse_descriptor;
+using autoware::common::shared_memory_transport::serialize_descriptor;
+
+namespace
+{
+std::vector<uint8_t> make_payload(const std::size_t size, const uint8_t first)
+{
+  std::vector<uint8_t> payload(size);
+  std::iota(payload.begin(), payload.end(), first);
+  return payload;
+}
+
+bool sample_equals(const SharedMemorySample & sample, const std::vector<uint8_t> & payload)
+{
+  return sample.valid() && (sample.size() == payload.size()) &&
+         std::equal(payload.begin(), payload.end(), sample.data());
+}
+}  // namespace
+
+TEST(TestSharedMemoryRing, round_trip)
+{
+  SharedMemoryRing ring{make_unique_segment_name("test_ring/round trip"), 4U, 1000U};
+  EXPECT_EQ(ring.name().front(), '/');
+  EXPECT_EQ(ring.slot_count(), 4U);
+  EXPECT_EQ(ring.slot_capacity(), 1000U);
+  SharedMemoryRingReader reader{ring.name()};
+
+  for (uint8_t i = 0U; i < 10U; ++i) {
+    const auto payload = make_payload(100U * i, i);
+    SharedMemoryDescriptor descriptor{};
+    ASSERT_TRUE(ring.write(payload.data(), payload.size(), descriptor));
+    EXPECT_EQ(descriptor.segment, ring.name());
+    EXPECT_EQ(descriptor.size, payload.size());
+
+    std::vector<uint8_t> bytes{};
+    serialize_descriptor(descriptor, bytes);
+    ASSERT_TRUE(is_descriptor(bytes));
+    const auto parsed = parse_descriptor(bytes);
+    EXPECT_EQ(parsed.segment, descriptor.segment);
+    EXPECT_EQ(parsed.slot, descriptor.slot);
+    EXPECT_EQ(parsed.sequence, descriptor.sequence);
+    EXPECT_EQ(parsed.size, descriptor.size);
+
+    EXPECT_TRUE(sample_equals(reader.acquire(parsed), payload));
+  }
+}
+
+TEST(TestSharedMemoryRing, referenced_slots_are_not_reused)
+{
+  SharedMemoryRing ring{make_unique_segment_name("test_ring"), 2U, 16U};
+  SharedMemoryRingReader reader{ring.name()};
+  const auto payload_a = make_payload(16U, 0U);
+  const auto payload_b = make_payload(8U, 100U);
+  SharedMemoryDescriptor descriptor_a{};
+  SharedMemoryDescriptor descriptor_b{};
+  ASSERT_TRUE(ring.write(payload_a.data(), payload_a.size(), descriptor_a));
+  ASSERT_TRUE(ring.write(payload_b.data(), payload_b.size(), descriptor_b));
+  EXPECT_NE(descriptor_a.slot, descriptor_b.slot);
+
+  auto sample_a = reader.acquire(descriptor_a);
+  const auto sample_b = reader.acquire(descriptor_b);
+  // A second reference to the same sample.
+  auto sample_a2 = reader.acquire(descriptor_a);
+  SharedMemoryDescriptor descriptor_c{};
+  EXPECT_FALSE(ring.write(payload_b.data(), payload_b.size(), descriptor_c));
+  EXPECT_TRUE(sample_equals(sample_a, payload_a));
+  EXPECT_TRUE(sample_equals(sample_b, payload_b));
+
+  // Moving the reference keeps the slot referenced.
+  const SharedMemorySample moved{std::move(sample_a)};
+  EXPECT_FALSE(sample_a.valid());
+  sample_a2.reset();
+  EXPECT_FALSE(ring.write(payload_b.data(), payload_b.size(), descriptor_c));
+  EXPECT_TRUE(sample_equals(moved, payload_a));
+}
+
+TEST(TestSharedMemoryRing, overwritten_samples_are_detected)
+{
+  SharedMemoryRing ring{make_unique_segment_name("test_ring"), 2U, 16U};
+  SharedMemoryRingReader reader{ring.name()};
+  const auto payload = make_payload(16U, 0U);
+  SharedMemoryDescriptor first{};
+  SharedMemoryDescriptor descriptor{};
+  ASSERT_TRUE(ring.write(payload.data(), payload.size(), first));
+  ASSERT_TRUE(ring.write(payload.data(), payload.size(), descriptor));
+  {
+    // Released samples don't block the writer.
+    const auto sample = reader.acquire(first);
+    EXPECT_TRUE(sample.valid());
+  }
+  ASSERT_TRUE(ring.write(payload.data(), payload.size(), descriptor));
+  EXPECT_EQ(descriptor.slot, first.slot);
+  EXPECT_FALSE(reader.acquire(first).valid());
+  EXPECT_TRUE(sample_equals(reader.acquire(descriptor), payload));
+}
+
+TEST(TestSharedMemoryRing, samples_outlive_the_ring)
+{
+  std::vector<uint8_t> payload = make_payload(10U, 5U);
+  SharedMemoryDescriptor descriptor{};
+  SharedMemorySample sample{};
+  {
+    SharedMemoryRing ring{make_unique_segment_name("test_ring"), 2U, 10U};
+    ASSERT_TRUE(ring.write(payload.data(), payload.size(), descriptor));
+    sample = SharedMemoryRingReader{ring.name()}.acquire(descriptor);
+  }
+  EXPECT_TRUE(sample_equals(sample, payload));
+  // The segment is gone for new readers.
+  EXPECT_THROW(SharedMemoryRingReader{descriptor.segment}, std::runtime_error);
+}
+
+TEST(TestSharedMemoryRing, other_process)
+{
+  SharedMemoryRing ring{make_unique_segment_name("test_ring"), 2U, 1U << 20U};
+  const auto payload = make_payload(1U << 20U, 7U);
+  SharedMemoryDescriptor descriptor{};
+  ASSERT_TRUE(ring.write(payload.data(), payload.size(), descriptor));
+  std::vector<uint8_t> bytes{};
+  serialize_descriptor(descriptor, bytes);
+
+  const auto pid = ::fork();
+  ASSERT_GE(pid, 0);
+  if (pid == 0) {
+    // Only the descriptor is handed over, as in a message.
+    int exit_code = 1;
+    try {
+      const auto received = parse_descriptor(bytes);
+      if (sample_equals(SharedMemoryRingReader{received.segment}.acquire(received), payload)) {
+        exit_code = 0;
+      }
+    } catch (...) {
+    }
+    ::_exit(exit_code);
+  }
+  int status = 0;
+  ASSERT_EQ(::waitpid(pid, &status, 0), pid);
+  ASSERT_TRUE(WIFEXITED(status));
+  EXPECT_EQ(WEXITSTATUS(status), 0);
+  // The reference of the other process was released.
+  EXPECT_TRUE(ring.write(payload.data(), payload.size(), descriptor));
+  EXPECT_TRUE(ring.write(payload.data(), payload.size(), descriptor));
+}
+
+TEST(TestSharedMemoryRing, bad_input)
+{
+  EXPECT_THROW(SharedMemoryRing("test_ring", 1U, 10U), std::domain_error);
+  EXPECT_THROW(SharedMemoryRing("test_ring", 2U, 0U), std::domain_error);
+  EXPECT_THROW(SharedMemoryRing("test/ring", 2U, 10U), std::domain_error);
+  EXPECT_THROW(SharedMemoryRing("", 2U, 10U), std::domain_error);
+
+  SharedMemoryRing ring{make_unique_segment_name("test_ring"), 2U, 10U};
+  const auto payload = make_payload(11U, 0U);
+  SharedMemoryDescriptor descriptor{};
+  EXPECT_THROW(ring.write(payload.data(), payload.size(), descriptor), std::domain_error);
+
+  SharedMemoryRingReader reader{ring.name()};
+  ASSERT_TRUE(ring.write(payload.data(), 10U, descriptor));
+  auto bad = descriptor;
+  bad.slot = 2U;
+  EXPECT_THROW(reader.acquire(bad), std::runtime_error);
+  bad = descriptor;
+  bad.size = 11U;
+  EXPECT_THROW(reader.acquire(bad), std::runtime_error);
+  EXPECT_THROW(SharedMemoryRingReader{"/does_not_exist_shared_memory_ring"}, std::runtime_error);
+
+  std::vector<uint8_t> bytes{};
+  serialize_descriptor(descriptor, bytes);
+  bytes.pop_back();
+  EXPECT_THROW(parse_descriptor(bytes), std::runtime_error);
+  bytes.resize(3U);
+  EXPECT_FALSE(is_descriptor(bytes));
+  EXPECT_THROW(parse_descriptor(bytes), std::runtime_error);
+  EXPECT_THROW(parse_descriptor(payload), std::runtime_error);
+}
@@ -0,0 +1,123 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/// \file
+/// \brief Interface definition for filters that process blocks of multi-channel samples
+#ifndef SIGNAL_FILTERS__BLOCK_FILTER_HPP_
+#define SIGNAL_FILTERS__BLOCK_FILTER_HPP_
+
+#include <common/types.hpp>
+#include <signal_filters/visibility_control.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace autoware
+{
+namespace common
+{
+namespace signal_filters
+{
+
+/// Interface class for filters that process a block of uniformly sampled observations of several
+/// independent channels per call, e.g. for offline processing or the wheel speeds of a vehicle.
+/// The state of every channel is carried over from one block to the next, so filtering a signal
+/// in one block or in several gives the same result. The samples are interleaved, i.e. all channels
+/// of one sample are consecutive, so that implementations can process the channels together.
+/// \tparam T A floating point type for the signal
+template<typename T>
+class SIGNAL_FILTERS_PUBLIC BlockFilterBase
+{
+  static_assert(std::is_floating_point<T>::value, "Filters require a floating point type");
+
+public:
+  using signal_type = T;
+
+  /// Constructor
+  /// \param[in] num_channels The number of channels that are filtered together
+  /// \throw std::domain_error If num_channels is zero
+  explicit BlockFilterBase(const std::size_t num_channels)
+  : m_num_channels{num_channels}
+  {
+    if (0U == num_channels) {
+      throw std::domain_error{"Number of channels is zero"};
+    }
+  }
+  /// Destructor
+  virtual ~BlockFilterBase() = default;
+
+  /// Primary API: filters a block of samples
+  /// \param[in] input num_samples * num_channels() observations, sample i of channel c at index
+  ///                  i * num_channels() + c
+  /// \param[out] output The results of the filter in the same layout, may be the same as input
+  /// \param[in] num_samples The number of samples in the block
+  /// \param[in] sample_period Time between two samples, must be positive
+  /// \throw std::domain_error If sample_period is not positive
+  /// \throw std::domain_error If any value is not finite, in which case the state is unchanged
+  void filter(
+    const T * input, T * output, const std::size_t num_samples,
+    const std::chrono::nanoseconds sample_period)
+  {
+    if (decltype(sample_period)::zero() >= sample_period) {
+      throw std::domain_error{"Duration is negative"};
+    }
+    const auto end = input + (num_samples * m_num_channels);
+    if (!std::all_of(input, end, [](const T value) {return std::isfinite(value);})) {
+      throw std::domain_error{"Value is not finite"};
+    }
+    filter_impl(input, output, num_samples, sample_period);
+  }
+  /// Filters a block of samples, see the pointer-based overload for the layout
+  /// \param[in] input The observations, the size must be a multiple of num_channels()
+  /// \param[out] output Resized to the size of the input and filled with the results
+  /// \param[in] sample_period Time between two samples, must be positive
+  /// \throw std::domain_error If the size of input is not a multiple of num_channels()
+  /// \throw std::domain_error If sample_period is not positive
+  /// \throw std::domain_error If any value is not finite, in which case the state is unchanged
+  void filter(
+    const std::vector<T> & input, std::vector<T> & output,
+    const std::chrono::nanoseconds sample_period)
+  {
+    if (0U != (input.size() % m_num_channels)) {
+      throw std::domain_error{"Input does not contain whole samples"};
+    }
+    output.resize(input.size());
+    filter(input.data(), output.data(), input.size() / m_num_channels, sample_period);
+  }
+  /// Resets the state of all channels to the initial state
+  void reset() {reset_impl();}
+  /// \return The number of channels that are filtered together
+  std::size_t num_channels() const noexcept {return m_num_channels;}
+
+protected:
+  /// Actual implementation, error checking already done, can assume sample_period is positive
+  virtual void filter_impl(
+    const T * input, T * output, std::size_t num_samples,
+    std::chrono::nanoseconds sample_period) = 0;
+  /// Actual implementation of reset
+  virtual void reset_impl() = 0;
+
+private:
+  std::size_t m_num_channels;
+};
+
+}  // namespace signal_filters
+}  // namespace common
+}  // namespace autoware
+
+#endif  // SIGNAL_FILTERS__BLOCK_FILTER_HPP_
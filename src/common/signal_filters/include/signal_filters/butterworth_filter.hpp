@@ -0,0 +1,207 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/// \file
+/// \brief Second order Butterworth low pass filters
+#ifndef SIGNAL_FILTERS__BUTTERWORTH_FILTER_HPP_
+#define SIGNAL_FILTERS__BUTTERWORTH_FILTER_HPP_
+
+#include <signal_filters/block_filter.hpp>
+#include <signal_filters/signal_filter.hpp>
+#include <signal_filters/visibility_control.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace autoware
+{
+namespace common
+{
+namespace signal_filters
+{
+namespace detail
+{
+/// Coefficients of a second order Butterworth low pass filter, discretized with the bilinear
+/// transform and normalized such that a0 is 1. The output is
+/// y0 = b0 * u0 + b1 * u1 + b2 * u2 - a1 * y1 - a2 * y2
+template<typename T>
+struct ButterworthCoefficients
+{
+  /// \param[in] cutoff_frequency_hz The cutoff frequency
+  /// \param[in] sample_period Time between two samples
+  ButterworthCoefficients(T cutoff_frequency_hz, std::chrono::nanoseconds sample_period)
+  {
+    constexpr T TAU{static_cast<T>(2.0 * 3.14159265358979323846)};
+    const auto dt = std::chrono::duration_cast<std::chrono::duration<T>>(sample_period).count();
+    const auto wc = TAU * cutoff_frequency_hz;
+    const auto n = T{2.0} / dt;
+    const auto sqrt2 = std::sqrt(T{2.0});
+    const auto a0 = (n * n) + (sqrt2 * wc * n) + (wc * wc);
+    a1 = ((T{2.0} * wc * wc) - (T{2.0} * n * n)) / a0;
+    a2 = ((n * n) - (sqrt2 * wc * n) + (wc * wc)) / a0;
+    b0 = (wc * wc) / a0;
+    b1 = T{2.0} * b0;
+    b2 = b0;
+  }
+
+  T a1;
+  T a2;
+  T b0;
+  T b1;
+  T b2;
+};  // struct ButterworthCoefficients
+
+/// Checks the cutoff frequency of a filter
+template<typename T>
+T checked_cutoff(T cutoff_frequency_hz)
+{
+  if (T{} >= cutoff_frequency_hz) {
+    throw std::domain_error{"Cutoff frequency is non-positve"};
+  }
+  return cutoff_frequency_hz;
+}
+}  // namespace detail
+
+/// Second order Butterworth low pass filter. The coefficients are recomputed whenever the time
+/// between two observations changes. The first observation initializes the filter as if the
+/// signal had been constant before, since the time before it is not meaningful
+/// \tparam T A floating point type for the signal
+template<typename T, typename ClockT = std::chrono::steady_clock>
+class SIGNAL_FILTERS_PUBLIC ButterworthFilter : public FilterBase<T, ClockT>
+{
+public:
+  explicit ButterworthFilter(T cutoff_frequency_hz)
+  : FilterBase<T, ClockT>{},
+    m_cutoff_frequency_hz{detail::checked_cutoff(cutoff_frequency_hz)}
+  {
+  }
+  /// Destructor
+  virtual ~ButterworthFilter() = default;
+
+protected:
+  T filter_impl(T value, std::chrono::nanoseconds duration) override
+  {
+    if (!m_initialized) {
+      m_u1 = value;
+      m_u2 = value;
+      m_y1 = value;
+      m_y2 = value;
+      m_initialized = true;
+      return value;
+    }
+    if (duration != m_sample_period) {
+      m_coefficients = detail::ButterworthCoefficients<T>{m_cutoff_frequency_hz, duration};
+      m_sample_period = duration;
+    }
+    const auto & c = m_coefficients;
+    const auto y0 = (c.b0 * value) + (c.b1 * m_u1) + (c.b2 * m_u2) - (c.a1 * m_y1) -
+      (c.a2 * m_y2);
+    m_y2 = m_y1;
+    m_y1 = y0;
+    m_u2 = m_u1;
+    m_u1 = value;
+    return y0;
+  }
+
+private:
+  T m_cutoff_frequency_hz;
+  std::chrono::nanoseconds m_sample_period{std::chrono::seconds{1LL}};
+  detail::ButterworthCoefficients<T> m_coefficients{m_cutoff_frequency_hz, m_sample_period};
+  T m_u1{};
+  T m_u2{};
+  T m_y1{};
+  T m_y2{};
+  bool8_t m_initialized{false};
+};
+
+/// Second order Butterworth low pass filter for blocks of multi-channel samples, gives the same
+/// results as ButterworthFilter per channel, including the initialization with the first sample
+/// \tparam T A floating point type for the signal
+template<typename T>
+class SIGNAL_FILTERS_PUBLIC BlockButterworthFilter : public BlockFilterBase<T>
+{
+public:
+  BlockButterworthFilter(T cutoff_frequency_hz, std::size_t num_channels)
+  : BlockFilterBase<T>{num_channels},
+    m_cutoff_frequency_hz{detail::checked_cutoff(cutoff_frequency_hz)},
+    m_state(4U * num_channels, T{})
+  {
+  }
+  /// Destructor
+  virtual ~BlockButterworthFilter() = default;
+
+protected:
+  void filter_impl(
+    const T * input, T * output, std::size_t num_samples,
+    std::chrono::nanoseconds sample_period) override
+  {
+    if (sample_period != m_sample_period) {
+      m_coefficients = detail::ButterworthCoefficients<T>{m_cutoff_frequency_hz, sample_period};
+      m_sample_period = sample_period;
+    }
+    const auto c = m_coefficients;
+    const auto num_channels = this->num_channels();
+    T * const u1 = m_state.data();
+    T * const u2 = u1 + num_channels;
+    T * const y1 = u2 + num_channels;
+    T * const y2 = y1 + num_channels;
+    std::size_t first = 0U;
+    if (!m_initialized && (num_samples > 0U)) {
+      for (std::size_t jdx = 0U; jdx < num_channels; ++jdx) {
+        const auto u0 = input[jdx];
+        u1[jdx] = u0;
+        u2[jdx] = u0;
+        y1[jdx] = u0;
+        y2[jdx] = u0;
+        output[jdx] = u0;
+      }
+      m_initialized = true;
+      first = 1U;
+    }
+    for (std::size_t idx = first; idx < num_samples; ++idx) {
+      const auto offset = idx * num_channels;
+      for (std::size_t jdx = 0U; jdx < num_channels; ++jdx) {
+        const auto u0 = input[offset + jdx];
+        const auto y0 = (c.b0 * u0) + (c.b1 * u1[jdx]) + (c.b2 * u2[jdx]) - (c.a1 * y1[jdx]) -
+          (c.a2 * y2[jdx]);
+        y2[jdx] = y1[jdx];
+        y1[jdx] = y0;
+        u2[jdx] = u1[jdx];
+        u1[jdx] = u0;
+        output[offset + jdx] = y0;
+      }
+    }
+  }
+  void reset_impl() override
+  {
+    std::fill(m_state.begin(), m_state.end(), T{});
+    m_initialized = false;
+  }
+
+private:
+  T m_cutoff_frequency_hz;
+  std::chrono::nanoseconds m_sample_period{std::chrono::seconds{1LL}};
+  detail::ButterworthCoefficients<T> m_coefficients{m_cutoff_frequency_hz, m_sample_period};
+  /// Previous inputs and outputs u1, u2, y1, y2 of all channels, one after another
+  std::vector<T> m_state;
+  bool8_t m_initialized{false};
+};
+}  // namespace signal_filters
+}  // namespace common
+}  // namespace autoware
+
+#endif  // SIGNAL_FILTERS__BUTTERWORTH_FILTER_HPP_
@@ -19,10 +19,13 @@
 #define SIGNAL_FILTERS__FILTER_FACTORY_HPP_
 
 #include <signal_filters/visibility_control.hpp>
+#include <signal_filters/block_filter.hpp>
+#include <signal_filters/butterworth_filter.hpp>
 #include <signal_filters/signal_filter.hpp>
 #include <signal_filters/low_pass_filter.hpp>
 
 #include <algorithm>
+#include <cstddef>
 #include <memory>
 #include <stdexcept>
 #include <string>
@@ -37,7 +40,8 @@ namespace signal_filters
 enum class FilterType : int32_t
 {
   None = 0,
-  LowPassFilter
+  LowPassFilter,
+  ButterworthFilter
 };  // enum class FilterType
 
 /// Factory class to create some kind of low pass filter
@@ -45,7 +49,8 @@ class SIGNAL_FILTERS_PUBLIC FilterFactory
 {
 public:
   /// Create a low pass filter
-  /// \param[in] type The name of the filter type, expects one of "none, "low_pass_filter"
+  /// \param[in] type The name of the filter type, expects one of "none, "low_pass_filter",
+  ///                 "butterworth_filter"
   /// \param[in] cutoff_frequency The filter starts to have < 1.0 frequency response starting
   ///                             around here
   /// \tparam T The floating point type of the filter
@@ -54,21 +59,7 @@ public:
   template<typename T, typename ClockT = DummyClock>
   static std::unique_ptr<FilterBase<T, ClockT>> create(const std::string & type, T cutoff_frequency)
   {
-    FilterType type_enum = FilterType::LowPassFilter;
-    auto type_clean = type;
-    (void)std::transform(
-      type_clean.begin(), type_clean.end(), type_clean.begin(),
-      [](auto c) {return std::tolower(c);});
-    if ("low_pass_filter" == type_clean) {
-      type_enum = FilterType::LowPassFilter;
-    } else if (type_clean.empty() || ("none" == type_clean)) {
-      type_enum = FilterType::None;
-    } else {
-      std::string err{"Unknown filter type: "};
-      err += type;
-      throw std::domain_error{err};
-    }
-    return create<T, ClockT>(type_enum, cutoff_frequency);
+    return create<T, ClockT>(to_filter_type(type), cutoff_frequency);
   }
 
   /// Create a low pass filter
@@ -86,10 +77,69 @@ public:
         return nullptr;
       case FilterType::LowPassFilter:
         return std::make_unique<LowPassFilter<T, ClockT>>(cutoff_frequency);
+      case FilterType::ButterworthFilter:
+        return std::make_unique<ButterworthFilter<T, ClockT>>(cutoff_frequency);
       default:
         throw std::domain_error{"Unknown filter type"};
     }
   }
+
+  /// Create a low pass filter for blocks of multi-channel samples
+  /// \param[in] type The name of the filter type, see create()
+  /// \param[in] cutoff_frequency The filter starts to have < 1.0 frequency response starting
+  ///                             around here
+  /// \param[in] num_channels The number of channels that are filtered together
+  /// \tparam T The floating point type of the filter
+  template<typename T>
+  static std::unique_ptr<BlockFilterBase<T>> create_block(
+    const std::string & type, T cutoff_frequency, std::size_t num_channels)
+  {
+    return create_block<T>(to_filter_type(type), cutoff_frequency, num_channels);
+  }
+
+  /// Create a low pass filter for blocks of multi-channel samples
+  /// \param[in] type The type of the filter type
+  /// \param[in] cutoff_frequency The filter starts to have < 1.0 frequency response starting
+  ///                             around here
+  /// \param[in] num_channels The number of channels that are filtered together
+  /// \tparam T The floating point type of the filter
+  template<typename T>
+  static std::unique_ptr<BlockFilterBase<T>> create_block(
+    FilterType type, T cutoff_frequency, std::size_t num_channels)
+  {
+    switch (type) {
+      case FilterType::None:
+        return nullptr;
+      case FilterType::LowPassFilter:
+        return std::make_unique<BlockLowPassFilter<T>>(cutoff_frequency, num_channels);
+      case FilterType::ButterworthFilter:
+        return std::make_unique<BlockButterworthFilter<T>>(cutoff_frequency, num_channels);
+      default:
+        throw std::domain_error{"Unknown filter type"};
+    }
+  }
+
+private:
+  static FilterType to_filter_type(const std::string & type)
+  {
+    FilterType type_enum = FilterType::LowPassFilter;
+    auto type_clean = type;
+    (void)std::transform(
+      type_clean.begin(), type_clean.end(), type_clean.begin(),
+      [](auto c) {return std::tolower(c);});
+    if ("low_pass_filter" == type_clean) {
+      type_enum = FilterType::LowPassFilter;
+    } else if ("butterworth_filter" == type_clean) {
+      type_enum = FilterType::ButterworthFilter;
+    } else if (type_clean.empty() || ("none" == type_clean)) {
+      type_enum = FilterType::None;
+    } else {
+      std::string err{"Unknown filter type: "};
+      err += type;
+      throw std::domain_error{err};
+    }
+    return type_enum;
+  }
 };  // class FilterFactory
 
 }  // namespace signal_filters
@@ -18,10 +18,14 @@
 #ifndef SIGNAL_FILTERS__LOW_PASS_FILTER_HPP_
 #define SIGNAL_FILTERS__LOW_PASS_FILTER_HPP_
 
+#include <signal_filters/block_filter.hpp>
 #include <signal_filters/signal_filter.hpp>
 #include <signal_filters/visibility_control.hpp>
 
+#include <algorithm>
 #include <chrono>
+#include <cstddef>
+#include <vector>
 
 namespace autoware
 {
@@ -62,6 +66,53 @@ private:
   T m_rc_inv{};
   T m_signal{};
 };
+
+/// Low pass filter for blocks of multi-channel samples, gives the same results as LowPassFilter
+/// per channel. The smoothing factor is computed once per block instead of once per sample
+/// 	param T A floating point type for the signal
+template<typename T>
+class SIGNAL_FILTERS_PUBLIC BlockLowPassFilter : public BlockFilterBase<T>
+{
+public:
+  BlockLowPassFilter(T cutoff_frequency_hz, std::size_t num_channels)
+  : BlockFilterBase<T>{num_channels},
+    m_signal(num_channels, T{})
+  {
+    if (T{} >= cutoff_frequency_hz) {
+      throw std::domain_error{"Cutoff frequency is non-positve"};
+    }
+    constexpr T TAU{static_cast<T>(2.0 * 3.14159)};
+    m_rc_inv = TAU * cutoff_frequency_hz;
+  }
+  /// Destructor
+  virtual ~BlockLowPassFilter() = default;
+
+protected:
+  void filter_impl(
+    const T * input, T * output, std::size_t num_samples,
+    std::chrono::nanoseconds sample_period) override
+  {
+    const auto dt = std::chrono::duration_cast<std::chrono::duration<T>>(sample_period).count();
+    const auto alpha = T{1.0} - std::exp(-dt * m_rc_inv);
+    const auto num_channels = m_signal.size();
+    T * const signal = m_signal.data();
+    for (std::size_t idx = 0U; idx < num_samples; ++idx) {
+      const auto offset = idx * num_channels;
+      for (std::size_t jdx = 0U; jdx < num_channels; ++jdx) {
+        signal[jdx] += alpha * (input[offset + jdx] - signal[jdx]);
+        output[offset + jdx] = signal[jdx];
+      }
+    }
+  }
+  void reset_impl() override
+  {
+    std::fill(m_signal.begin(), m_signal.end(), T{});
+  }
+
+private:
+  T m_rc_inv{};
+  std::vector<T> m_signal;
+};
 }  // namespace signal_filters
 }  // namespace common
 }  // namespace autoware
@@ -0,0 +1,132 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <common/types.hpp>
+#include <gtest/gtest.h>
+
+#include <signal_filters/filter_factory.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+using autoware::common::types::float32_t;
+using autoware::common::types::float64_t;
+using autoware::common::signal_filters::DummyClock;
+using autoware::common::signal_filters::FilterFactory;
+using autoware::common::signal_filters::FilterType;
+
+template<typename FloatT, FilterType TypeS>
+struct BlockParams
+{
+  using Float = FloatT;
+  static constexpr FilterType Type = TypeS;
+};
+
+template<typename T>
+class block_checks : public ::testing::Test
+{
+protected:
+  using Float = typename T::Float;
+  const std::size_t num_channels{3U};
+  const std::size_t num_samples{100U};
+  const std::chrono::nanoseconds period{std::chrono::milliseconds{10LL}};
+
+  // Interleaved samples of channels with different frequencies
+  std::vector<Float> signal() const
+  {
+    std::vector<Float> ret;
+    for (auto idx = 0U; idx < num_samples; ++idx) {
+      for (auto jdx = 0U; jdx < num_channels; ++jdx) {
+        const auto phase = 0.1 * static_cast<float64_t>((jdx + 1U) * idx);
+        ret.push_back(static_cast<Float>(std::sin(phase) + static_cast<float64_t>(jdx)));
+      }
+    }
+    return ret;
+  }
+};
+
+using BlockTypes = ::testing::Types<
+  BlockParams<float32_t, FilterType::LowPassFilter>,
+  BlockParams<float64_t, FilterType::LowPassFilter>,
+  BlockParams<float32_t, FilterType::ButterworthFilter>,
+  BlockParams<float64_t, FilterType::ButterworthFilter>
+>;
+// cppcheck-suppress syntaxError
+TYPED_TEST_CASE(block_checks, BlockTypes, );
+
+TYPED_TEST(block_checks, bad_factory)
+{
+  using Float = typename TypeParam::Float;
+  EXPECT_EQ(nullptr, FilterFactory::create_block<Float>("none", Float{1.0}, 1U));
+  EXPECT_THROW(FilterFactory::create_block<Float>("foo", Float{1.0}, 1U), std::domain_error);
+  EXPECT_THROW(
+    FilterFactory::create_block<Float>(TypeParam::Type, Float{-1.0}, 1U), std::domain_error);
+  EXPECT_THROW(
+    FilterFactory::create_block<Float>(TypeParam::Type, Float{1.0}, 0U), std::domain_error);
+}
+
+TYPED_TEST(block_checks, same_as_per_sample)
+{
+  using Float = typename TypeParam::Float;
+  const auto input = this->signal();
+  // Filter in blocks of different sizes, the state is carried over
+  const auto block = FilterFactory::create_block<Float>(TypeParam::Type, Float{5.0}, 3U);
+  ASSERT_EQ(block->num_channels(), 3U);
+  std::vector<Float> output(input.size());
+  std::size_t begin = 0U;
+  for (const auto count : {1U, 7U, 0U, 92U}) {
+    block->filter(&input[begin * 3U], &output[begin * 3U], count, this->period);
+    begin += count;
+  }
+  ASSERT_EQ(begin, this->num_samples);
+
+  for (auto jdx = 0U; jdx < 3U; ++jdx) {
+    const auto scalar = FilterFactory::create<Float, DummyClock>(TypeParam::Type, Float{5.0});
+    for (auto idx = 0U; idx < this->num_samples; ++idx) {
+      const auto expected = scalar->filter(input[(idx * 3U) + jdx], this->period);
+      constexpr auto EPS = Float{10.0} * std::numeric_limits<Float>::epsilon();
+      EXPECT_NEAR(output[(idx * 3U) + jdx], expected, EPS) << idx << ", " << jdx;
+    }
+  }
+
+  // In place, after a reset
+  block->reset();
+  auto in_place = input;
+  block->filter(in_place, in_place, this->period);
+  EXPECT_EQ(in_place, output);
+}
+
+TYPED_TEST(block_checks, bad_input)
+{
+  using Float = typename TypeParam::Float;
+  const auto input = this->signal();
+  const auto block = FilterFactory::create_block<Float>(TypeParam::Type, Float{5.0}, 3U);
+  std::vector<Float> expected;
+  block->filter(input, expected, this->period);
+  block->reset();
+
+  std::vector<Float> output;
+  EXPECT_THROW(block->filter(std::vector<Float>(4U), output, this->period), std::domain_error);
+  EXPECT_THROW(block->filter(input, output, std::chrono::nanoseconds{0LL}), std::domain_error);
+  auto bad = input;
+  bad.back() = std::numeric_limits<Float>::quiet_NaN();
+  EXPECT_THROW(block->filter(bad, output, this->period), std::domain_error);
+  bad.back() = -std::numeric_limits<Float>::infinity();
+  EXPECT_THROW(block->filter(bad, output, this->period), std::domain_error);
+  // The state was not changed by the failed calls
+  block->filter(input, output, this->period);
+  EXPECT_EQ(output, expected);
+}
@@ -99,7 +99,11 @@ using BasicTypes = ::testing::Types<
   BasicParams<float32_t, std::chrono::steady_clock, FilterType::LowPassFilter>,
   BasicParams<float64_t, DummyClock, FilterType::LowPassFilter>,
   BasicParams<float64_t, std::chrono::system_clock, FilterType::LowPassFilter>,
-  BasicParams<float64_t, std::chrono::steady_clock, FilterType::LowPassFilter>
+  BasicParams<float64_t, std::chrono::steady_clock, FilterType::LowPassFilter>,
+  BasicParams<float32_t, DummyClock, FilterType::ButterworthFilter>,
+  BasicParams<float32_t, std::chrono::steady_clock, FilterType::ButterworthFilter>,
+  BasicParams<float64_t, DummyClock, FilterType::ButterworthFilter>,
+  BasicParams<float64_t, std::chrono::steady_clock, FilterType::ButterworthFilter>
 >;
 TYPED_TEST_CASE(filter_checks, BasicTypes, );
 
@@ -266,7 +270,11 @@ using SanityCheckTypes = ::testing::Types<
   SanityCheckParam<double, std::chrono::steady_clock, FilterType::LowPassFilter, 1, 3, 1>,
   SanityCheckParam<double, DummyClock, FilterType::LowPassFilter, 1, 100, 1>,
   SanityCheckParam<double, std::chrono::system_clock, FilterType::LowPassFilter, 1, 100, 1>,
-  SanityCheckParam<double, std::chrono::steady_clock, FilterType::LowPassFilter, 1, 100, 1>
+  SanityCheckParam<double, std::chrono::steady_clock, FilterType::LowPassFilter, 1, 100, 1>,
+  SanityCheckParam<double, DummyClock, FilterType::ButterworthFilter, 1, 3, 1>,
+  SanityCheckParam<double, std::chrono::steady_clock, FilterType::ButterworthFilter, 1, 3, 1>,
+  SanityCheckParam<double, DummyClock, FilterType::ButterworthFilter, 1, 100, 1>,
+  SanityCheckParam<double, std::chrono::steady_clock, FilterType::ButterworthFilter, 1, 100, 1>
 >;
 TYPED_TEST_CASE(sanity_check, SanityCheckTypes, );
 
@@ -0,0 +1,63 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief A node that reports the time to ready of a stack
+
+#ifndef STARTUP_TRACKING__STARTUP_MONITOR_NODE_HPP_
+#define STARTUP_TRACKING__STARTUP_MONITOR_NODE_HPP_
+
+#include <diagnostic_msgs/msg/diagnostic_array.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <startup_tracking/startup_status.hpp>
+#include <startup_tracking/visibility_control.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace autoware
+{
+namespace common
+{
+namespace startup_tracking
+{
+
+/// \brief Collects the startup status of the nodes of a stack and logs each node as it becomes
+///        ready. Once all nodes of the `expected_nodes` parameter are ready, the time to ready of
+///        the stack is logged and published on `/diagnostics`
+class STARTUP_TRACKING_PUBLIC StartupMonitorNode : public rclcpp::Node
+{
+public:
+  /// \brief Constructor
+  /// \param[in] options The options of the node
+  explicit StartupMonitorNode(const rclcpp::NodeOptions & options);
+
+private:
+  void on_status(const diagnostic_msgs::msg::DiagnosticArray & msg);
+  void report_stack();
+
+  std::vector<std::string> m_expected_nodes;
+  /// The startup of the ready nodes by name
+  std::map<std::string, NodeStartup> m_ready_nodes{};
+  bool8_t m_reported{false};
+  rclcpp::Publisher<diagnostic_msgs::msg::DiagnosticArray>::SharedPtr m_diagnostics_pub;
+  rclcpp::Subscription<diagnostic_msgs::msg::DiagnosticArray>::SharedPtr m_status_sub;
+};
+
+}  // namespace startup_tracking
+}  // namespace common
+}  // namespace autoware
+
+#endif  // STARTUP_TRACKING__STARTUP_MONITOR_NODE_HPP_
@@ -0,0 +1,96 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief The startup status that nodes publish once they are ready, and its aggregation over
+///        the nodes of a stack
+
+#ifndef STARTUP_TRACKING__STARTUP_STATUS_HPP_
+#define STARTUP_TRACKING__STARTUP_STATUS_HPP_
+
+#include <common/types.hpp>
+#include <diagnostic_msgs/msg/diagnostic_status.hpp>
+#include <startup_tracking/visibility_control.hpp>
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace autoware
+{
+namespace common
+{
+namespace startup_tracking
+{
+using autoware::common::types::bool8_t;
+using autoware::common::types::float64_t;
+
+/// \brief The topic that the startup status of every node is published on, transient local so
+///        that a monitor started late still receives it
+constexpr const char * STARTUP_STATUS_TOPIC = "/startup_status";
+
+/// \brief How long a node took to become ready
+struct STARTUP_TRACKING_PUBLIC NodeStartup
+{
+  /// The fully qualified name of the node
+  std::string node{};
+  /// The system time at the start of the node, nanoseconds since the epoch
+  int64_t start_time_ns{0};
+  /// The system time at which the node became ready, nanoseconds since the epoch
+  int64_t ready_time_ns{0};
+  /// The time to ready of the node from the steady clock, in milliseconds
+  float64_t time_to_ready_ms{0.0};
+  /// Named steps of the startup and the time from the start to their end, in milliseconds
+  std::vector<std::pair<std::string, float64_t>> phases{};
+};
+
+/// \brief Write the startup of a node into a diagnostic status
+/// \param[in] startup The startup of the node
+/// \return The status, named after the node, with one value per field and phase
+STARTUP_TRACKING_PUBLIC diagnostic_msgs::msg::DiagnosticStatus to_status(
+  const NodeStartup & startup);
+
+/// \brief Read the startup of a node from a status written by to_status()
+/// \param[in] status The status
+/// \return The startup of the node
+/// \throw std::runtime_error If a field is missing or isn't a number
+STARTUP_TRACKING_PUBLIC NodeStartup from_status(
+  const diagnostic_msgs::msg::DiagnosticStatus & status);
+
+/// \brief How long the nodes of a stack took to become ready
+struct STARTUP_TRACKING_PUBLIC StackStartup
+{
+  /// From the earliest start to the latest ready time of the ready nodes, in milliseconds
+  float64_t time_to_ready_ms{0.0};
+  /// The ready node with the longest time to ready
+  std::string slowest_node{};
+  float64_t slowest_time_to_ready_ms{0.0};
+  /// The expected nodes that are not ready yet
+  std::vector<std::string> missing_nodes{};
+};
+
+/// \brief Aggregate the startup of the nodes of a stack
+/// \param[in] ready_nodes The startup of the nodes that are ready, in any order
+/// \param[in] expected_nodes The fully qualified names of the nodes the stack consists of
+/// \return The aggregated startup, all zero if no node is ready
+STARTUP_TRACKING_PUBLIC StackStartup summarize(
+  const std::vector<NodeStartup> & ready_nodes,
+  const std::vector<std::string> & expected_nodes);
+
+}  // namespace startup_tracking
+}  // namespace common
+}  // namespace autoware
+
+#endif  // STARTUP_TRACKING__STARTUP_STATUS_HPP_
@@ -0,0 +1,154 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief Measurement of the time to ready of a node, and a gate that finishes the startup of a
+///        node once the resources and peers it depends on are available
+
+#ifndef STARTUP_TRACKING__STARTUP_TRACKER_HPP_
+#define STARTUP_TRACKING__STARTUP_TRACKER_HPP_
+
+#include <common/types.hpp>
+#include <diagnostic_msgs/msg/diagnostic_array.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <startup_tracking/startup_status.hpp>
+#include <startup_tracking/visibility_control.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace autoware
+{
+namespace common
+{
+namespace startup_tracking
+{
+
+/// \brief Measures the time from the construction of a node until it is ready, i.e. until it
+///        serves its topics and services with loaded resources. The time to ready is logged and
+///        published once on STARTUP_STATUS_TOPIC, see to_status().
+///        Construct the tracker first thing in the constructor of the node, e.g. as its first
+///        member, so that it covers the whole startup
+class STARTUP_TRACKING_PUBLIC StartupTracker
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  /// \brief Constructor, starts the measurement
+  /// \param[in] node The node to measure, it must outlive the tracker
+  explicit StartupTracker(rclcpp::Node & node);
+
+  /// \brief Record the end of a named step of the startup, e.g. the loading of a map. Can be
+  ///        called from any thread, e.g. the one that loads the resource
+  /// \param[in] phase The name of the step
+  void phase_done(const std::string & phase);
+
+  /// \brief Mark the node as ready, and log and publish its time to ready. Only the first call
+  ///        has an effect
+  void mark_ready();
+
+  /// \brief True once mark_ready() was called
+  bool8_t is_ready() const;
+
+  /// \brief The time to ready, or zero if the node isn't ready yet
+  Clock::duration time_to_ready() const;
+
+  /// \brief The startup of the node as it is published, with a zero ready time before it is
+  ///        ready
+  NodeStartup startup() const;
+
+private:
+  rclcpp::Node & m_node;
+  rclcpp::Publisher<diagnostic_msgs::msg::DiagnosticArray>::SharedPtr m_publisher;
+  const Clock::time_point m_start;
+  mutable std::mutex m_mutex;
+  NodeStartup m_startup;
+  bool8_t m_ready{false};
+  Clock::duration m_time_to_ready{Clock::duration::zero()};
+};
+
+/// \brief Defers the part of the startup of a node that needs resources or peers, e.g. the
+///        creation of services and action servers, until all its requirements are met. Unlike
+///        waiting in the constructor, this lets the executor spin the node, and all other nodes
+///        of the process, while resources load in the background and peers come up, so that
+///        the nodes of a stack start concurrently
+class STARTUP_TRACKING_PUBLIC StartupGate
+{
+public:
+  /// \brief Checks a requirement, called from the executor thread of the node
+  using Requirement = std::function<bool8_t()>;
+
+  /// \brief Constructor
+  /// \param[in] node The node to check the requirements with, it must outlive the gate
+  /// \param[in] tracker Records a phase for every requirement when it is met, and is marked
+  ///                    ready when the gate opens
+  /// \param[in] poll_period How often the requirements are checked
+  StartupGate(
+    rclcpp::Node & node, StartupTracker & tracker,
+    std::chrono::milliseconds poll_period = std::chrono::milliseconds{100});
+
+  /// \brief Add a requirement. Requirements must be added before open_when_ready() is called
+  /// \param[in] name The name of the requirement for the log and the phases of the tracker
+  /// \param[in] requirement True once the requirement is met. It isn't called again afterwards
+  /// \throw std::domain_error If the gate is already waiting
+  void require(const std::string & name, Requirement requirement);
+
+  /// \brief Start checking the requirements, and call a function once all of them are met.
+  ///        The tracker is marked ready after the function returns
+  /// \param[in] on_ready Finishes the startup of the node. Exceptions from it, e.g. of the
+  ///                     futures of background loads, propagate out of the executor like
+  ///                     exceptions of a constructor
+  /// \throw std::domain_error If the gate is already waiting
+  void open_when_ready(std::function<void()> on_ready);
+
+  /// \brief True once the function given to open_when_ready() was called
+  bool8_t is_open() const noexcept;
+
+private:
+  void poll();
+
+  rclcpp::Node & m_node;
+  StartupTracker & m_tracker;
+  std::chrono::milliseconds m_poll_period;
+  std::vector<std::pair<std::string, Requirement>> m_requirements{};
+  std::function<void()> m_on_ready{};
+  rclcpp::TimerBase::SharedPtr m_timer{};
+  std::size_t m_poll_count{0U};
+  bool8_t m_open{false};
+};
+
+/// \brief A requirement that is met once a future, e.g. of a resource loaded with std::async,
+///        has its result, see StartupGate::require()
+/// \tparam T The type of the result
+/// \param[in] future The future, it must outlive the requirement
+/// \return The requirement
+template<typename T>
+StartupGate::Requirement future_ready(const std::future<T> & future)
+{
+  return [&future]() {
+           return future.wait_for(std::chrono::seconds::zero()) == std::future_status::ready;
+         };
+}
+
+}  // namespace startup_tracking
+}  // namespace common
+}  // namespace autoware
+
+#endif  // STARTUP_TRACKING__STARTUP_TRACKER_HPP_
@@ -0,0 +1,122 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <startup_tracking/startup_monitor_node.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace autoware
+{
+namespace common
+{
+namespace startup_tracking
+{
+namespace
+{
+/// Nodes of a stack that can be ready before the monitor starts
+constexpr std::size_t STATUS_HISTORY_DEPTH = 100U;
+
+std::string join(const std::vector<std::string> & names)
+{
+  std::string joined;
+  for (const auto & name : names) {
+    joined += (joined.empty() ? "" : ", ") + name;
+  }
+  return joined;
+}
+}  // namespace
+
+StartupMonitorNode::StartupMonitorNode(const rclcpp::NodeOptions & options)
+: Node("startup_monitor", options),
+  m_expected_nodes{declare_parameter("expected_nodes", std::vector<std::string>{})},
+  m_diagnostics_pub{create_publisher<diagnostic_msgs::msg::DiagnosticArray>(
+      "/diagnostics", rclcpp::QoS{rclcpp::KeepLast{10U}})},
+  m_status_sub{create_subscription<diagnostic_msgs::msg::DiagnosticArray>(
+      STARTUP_STATUS_TOPIC, rclcpp::QoS{rclcpp::KeepLast{STATUS_HISTORY_DEPTH}}.transient_local(),
+      [this](const diagnostic_msgs::msg::DiagnosticArray::SharedPtr msg) {on_status(*msg);})}
+{
+  if (m_expected_nodes.empty()) {
+    RCLCPP_WARN(
+      get_logger(), "No expected_nodes given, only the startup of single nodes is reported");
+  }
+}
+
+void StartupMonitorNode::on_status(const diagnostic_msgs::msg::DiagnosticArray & msg)
+{
+  for (const auto & status : msg.status) {
+    NodeStartup startup;
+    try {
+      startup = from_status(status);
+    } catch (const std::runtime_error & e) {
+      RCLCPP_WARN(get_logger(), "Ignoring a startup status: %s", e.what());
+      continue;
+    }
+    if (m_ready_nodes.count(startup.node) > 0U) {
+      continue;
+    }
+    RCLCPP_INFO(
+      get_logger(), "%s is ready after %.1f ms", startup.node.c_str(), startup.time_to_ready_ms);
+    m_ready_nodes[startup.node] = startup;
+  }
+  report_stack();
+}
+
+void StartupMonitorNode::report_stack()
+{
+  if (m_reported || m_expected_nodes.empty()) {
+    return;
+  }
+  std::vector<NodeStartup> ready_nodes;
+  for (const auto & node : m_ready_nodes) {
+    ready_nodes.push_back(node.second);
+  }
+  const auto stack = summarize(ready_nodes, m_expected_nodes);
+  if (!stack.missing_nodes.empty()) {
+    RCLCPP_INFO(get_logger(), "Waiting for %s", join(stack.missing_nodes).c_str());
+    return;
+  }
+  m_reported = true;
+  RCLCPP_INFO(
+    get_logger(), "The stack is ready after %.1f ms, the slowest node is %s with %.1f ms",
+    stack.time_to_ready_ms, stack.slowest_node.c_str(), stack.slowest_time_to_ready_ms);
+
+  diagnostic_msgs::msg::DiagnosticStatus status;
+  status.level = diagnostic_msgs::msg::DiagnosticStatus::OK;
+  status.name = std::string{get_name()} + ": stack startup";
+  status.message = "Stack ready after " + std::to_string(stack.time_to_ready_ms) + " ms";
+  diagnostic_msgs::msg::KeyValue value;
+  value.key = "time_to_ready_ms";
+  value.value = std::to_string(stack.time_to_ready_ms);
+  status.values.push_back(value);
+  value.key = "slowest_node";
+  value.value = stack.slowest_node;
+  status.values.push_back(value);
+  value.key = "slowest_time_to_ready_ms";
+  value.value = std::to_string(stack.slowest_time_to_ready_ms);
+  status.values.push_back(value);
+  diagnostic_msgs::msg::DiagnosticArray diagnostics;
+  diagnostics.header.stamp = now();
+  diagnostics.status.push_back(status);
+  m_diagnostics_pub->publish(diagnostics);
+}
+
+}  // namespace startup_tracking
+}  // namespace common
+}  // namespace autoware
+
+#include "rclcpp_components/register_node_macro.hpp"
+
+RCLCPP_COMPONENTS_REGISTER_NODE(autoware::common::startup_tracking::StartupMonitorNode)
@@ -0,0 +1,141 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <startup_tracking/startup_status.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace autoware
+{
+namespace common
+{
+namespace startup_tracking
+{
+namespace
+{
+constexpr const char * START_TIME_KEY = "start_time_ns";
+constexpr const char * READY_TIME_KEY = "ready_time_ns";
+constexpr const char * TIME_TO_READY_KEY = "time_to_ready_ms";
+const std::string PHASE_PREFIX = "phase.";
+const std::string PHASE_SUFFIX = "_ms";
+
+diagnostic_msgs::msg::KeyValue key_value(const std::string & key, const std::string & value)
+{
+  diagnostic_msgs::msg::KeyValue key_value_msg;
+  key_value_msg.key = key;
+  key_value_msg.value = value;
+  return key_value_msg;
+}
+
+bool8_t ends_with(const std::string & str, const std::string & suffix)
+{
+  return (str.size() >= suffix.size()) &&
+         (str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0);
+}
+}  // namespace
+
+diagnostic_msgs::msg::DiagnosticStatus to_status(const NodeStartup & startup)
+{
+  diagnostic_msgs::msg::DiagnosticStatus status;
+  status.level = diagnostic_msgs::msg::DiagnosticStatus::OK;
+  status.name = startup.node;
+  status.message = "Ready after " + std::to_string(startup.time_to_ready_ms) + " ms";
+  status.values.push_back(key_value(START_TIME_KEY, std::to_string(startup.start_time_ns)));
+  status.values.push_back(key_value(READY_TIME_KEY, std::to_string(startup.ready_time_ns)));
+  status.values.push_back(
+    key_value(TIME_TO_READY_KEY, std::to_string(startup.time_to_ready_ms)));
+  for (const auto & phase : startup.phases) {
+    status.values.push_back(
+      key_value(PHASE_PREFIX + phase.first + PHASE_SUFFIX, std::to_string(phase.second)));
+  }
+  return status;
+}
+
+NodeStartup from_status(const diagnostic_msgs::msg::DiagnosticStatus & status)
+{
+  NodeStartup startup;
+  startup.node = status.name;
+  bool8_t has_start = false;
+  bool8_t has_ready = false;
+  bool8_t has_time_to_ready = false;
+  for (const auto & value : status.values) {
+    try {
+      if (value.key == START_TIME_KEY) {
+        startup.start_time_ns = std::stoll(value.value);
+        has_start = true;
+      } else if (value.key == READY_TIME_KEY) {
+        startup.ready_time_ns = std::stoll(value.value);
+        has_ready = true;
+      } else if (value.key == TIME_TO_READY_KEY) {
+        startup.time_to_ready_ms = std::stod(value.value);
+        has_time_to_ready = true;
+      } else if ((value.key.compare(0U, PHASE_PREFIX.size(), PHASE_PREFIX) == 0) &&
+        ends_with(value.key, PHASE_SUFFIX) &&
+        (value.key.size() > PHASE_PREFIX.size() + PHASE_SUFFIX.size()))
+      {
+        startup.phases.emplace_back(
+          value.key.substr(
+            PHASE_PREFIX.size(),
+            value.key.size() - PHASE_PREFIX.size() - PHASE_SUFFIX.size()),
+          std::stod(value.value));
+      }
+    } catch (const std::logic_error &) {
+      // std::invalid_argument and std::out_of_range of the conversions
+      throw std::runtime_error{
+              "startup status of " + status.name + ": " + value.key + " is not a number"};
+    }
+  }
+  if (!has_start || !has_ready || !has_time_to_ready) {
+    throw std::runtime_error{"startup status of " + status.name + " is incomplete"};
+  }
+  return startup;
+}
+
+StackStartup summarize(
+  const std::vector<NodeStartup> & ready_nodes,
+  const std::vector<std::string> & expected_nodes)
+{
+  StackStartup stack;
+  for (const auto & expected : expected_nodes) {
+    const auto it = std::find_if(
+      ready_nodes.begin(), ready_nodes.end(),
+      [&expected](const NodeStartup & startup) {return startup.node == expected;});
+    if (it == ready_nodes.end()) {
+      stack.missing_nodes.push_back(expected);
+    }
+  }
+  if (ready_nodes.empty()) {
+    return stack;
+  }
+  int64_t earliest_start_ns = std::numeric_limits<int64_t>::max();
+  int64_t latest_ready_ns = std::numeric_limits<int64_t>::min();
+  for (const auto & startup : ready_nodes) {
+    earliest_start_ns = std::min(earliest_start_ns, startup.start_time_ns);
+    latest_ready_ns = std::max(latest_ready_ns, startup.ready_time_ns);
+    if (stack.slowest_node.empty() || (startup.time_to_ready_ms > stack.slowest_time_to_ready_ms)) {
+      stack.slowest_node = startup.node;
+      stack.slowest_time_to_ready_ms = startup.time_to_ready_ms;
+    }
+  }
+  stack.time_to_ready_ms = static_cast<float64_t>(latest_ready_ns - earliest_start_ns) * 1.0e-6;
+  return stack;
+}
+
+}  // namespace startup_tracking
+}  // namespace common
+}  // namespace autoware
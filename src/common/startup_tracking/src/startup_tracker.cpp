@@ -0,0 +1,184 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <startup_tracking/startup_tracker.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace autoware
+{
+namespace common
+{
+namespace startup_tracking
+{
+namespace
+{
+/// The requirements that are not met are logged every this many polls
+constexpr std::size_t LOG_PERIOD_POLLS = 10U;
+
+int64_t system_time_ns()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+float64_t to_ms(const StartupTracker::Clock::duration duration)
+{
+  return std::chrono::duration_cast<std::chrono::duration<float64_t, std::milli>>(duration).
+         count();
+}
+}  // namespace
+
+StartupTracker::StartupTracker(rclcpp::Node & node)
+: m_node{node},
+  m_publisher{node.create_publisher<diagnostic_msgs::msg::DiagnosticArray>(
+      STARTUP_STATUS_TOPIC, rclcpp::QoS{rclcpp::KeepLast{1U}}.transient_local())},
+  m_start{Clock::now()}
+{
+  m_startup.node = node.get_fully_qualified_name();
+  m_startup.start_time_ns = system_time_ns();
+}
+
+void StartupTracker::phase_done(const std::string & phase)
+{
+  const auto elapsed = Clock::now() - m_start;
+  std::lock_guard<std::mutex> lock{m_mutex};
+  m_startup.phases.emplace_back(phase, to_ms(elapsed));
+}
+
+void StartupTracker::mark_ready()
+{
+  const auto time_to_ready = Clock::now() - m_start;
+  const auto ready_time_ns = system_time_ns();
+  diagnostic_msgs::msg::DiagnosticArray diagnostics;
+  std::string phases;
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    if (m_ready) {
+      return;
+    }
+    m_ready = true;
+    m_time_to_ready = time_to_ready;
+    m_startup.ready_time_ns = ready_time_ns;
+    m_startup.time_to_ready_ms = to_ms(time_to_ready);
+    diagnostics.status.push_back(to_status(m_startup));
+    for (const auto & phase : m_startup.phases) {
+      std::ostringstream phase_stream;
+      phase_stream << std::fixed << std::setprecision(1) << " " << phase.first << ": " <<
+        phase.second << " ms,";
+      phases += phase_stream.str();
+    }
+  }
+  if (!phases.empty()) {
+    phases.back() = ')';
+    phases = " (" + phases.substr(1U);
+  }
+  RCLCPP_INFO(
+    m_node.get_logger(), "Ready after %.1f ms%s", to_ms(time_to_ready), phases.c_str());
+  diagnostics.header.stamp = m_node.now();
+  m_publisher->publish(diagnostics);
+}
+
+bool8_t StartupTracker::is_ready() const
+{
+  std::lock_guard<std::mutex> lock{m_mutex};
+  return m_ready;
+}
+
+StartupTracker::Clock::duration StartupTracker::time_to_ready() const
+{
+  std::lock_guard<std::mutex> lock{m_mutex};
+  return m_time_to_ready;
+}
+
+NodeStartup StartupTracker::startup() const
+{
+  std::lock_guard<std::mutex> lock{m_mutex};
+  return m_startup;
+}
+
+StartupGate::StartupGate(
+  rclcpp::Node & node, StartupTracker & tracker,
+  const std::chrono::milliseconds poll_period)
+: m_node{node},
+  m_tracker{tracker},
+  m_poll_period{poll_period}
+{
+}
+
+void StartupGate::require(const std::string & name, Requirement requirement)
+{
+  if (m_timer || m_open) {
+    throw std::domain_error{"StartupGate: requirements must be added before waiting for them"};
+  }
+  m_requirements.emplace_back(name, std::move(requirement));
+}
+
+void StartupGate::open_when_ready(std::function<void()> on_ready)
+{
+  if (m_timer || m_open) {
+    throw std::domain_error{"StartupGate: already waiting"};
+  }
+  m_on_ready = std::move(on_ready);
+  // The first check is in the executor as well, so that the constructor of the node returns
+  // before any on_ready runs
+  m_timer = m_node.create_wall_timer(m_poll_period, [this]() {poll();});
+}
+
+bool8_t StartupGate::is_open() const noexcept
+{
+  return m_open;
+}
+
+void StartupGate::poll()
+{
+  if (m_open) {
+    return;
+  }
+  const auto met_end = std::remove_if(
+    m_requirements.begin(), m_requirements.end(),
+    [this](const std::pair<std::string, Requirement> & requirement) {
+      if (!requirement.second()) {
+        return false;
+      }
+      m_tracker.phase_done(requirement.first);
+      return true;
+    });
+  m_requirements.erase(met_end, m_requirements.end());
+
+  if (!m_requirements.empty()) {
+    if ((++m_poll_count % LOG_PERIOD_POLLS) == 0U) {
+      std::string waiting_for;
+      for (const auto & requirement : m_requirements) {
+        waiting_for += (waiting_for.empty() ? "" : ", ") + requirement.first;
+      }
+      RCLCPP_INFO(m_node.get_logger(), "Waiting for %s", waiting_for.c_str());
+    }
+    return;
+  }
+  m_timer->cancel();
+  m_open = true;
+  m_on_ready();
+  m_tracker.mark_ready();
+}
+
+}  // namespace startup_tracking
+}  // namespace common
+}  // namespace autoware
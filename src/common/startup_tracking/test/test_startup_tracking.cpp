@@ -0,0 +1,188 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <rclcpp/rclcpp.hpp>
+#include <startup_tracking/startup_status.hpp>
+#include <startup_tracking/startup_tracker.hpp>
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using autoware::common::startup_tracking::NodeStartup;
+using autoware::common::startup_tracking::STARTUP_STATUS_TOPIC;
+using autoware::common::startup_tracking::StartupGate;
+using autoware::common::startup_tracking::StartupTracker;
+using autoware::common::startup_tracking::from_status;
+using autoware::common::startup_tracking::future_ready;
+using autoware::common::startup_tracking::summarize;
+using autoware::common::startup_tracking::to_status;
+using diagnostic_msgs::msg::DiagnosticArray;
+
+namespace
+{
+NodeStartup make_startup(
+  const std::string & node, const int64_t start_time_ns, const int64_t ready_time_ns)
+{
+  NodeStartup startup;
+  startup.node = node;
+  startup.start_time_ns = start_time_ns;
+  startup.ready_time_ns = ready_time_ns;
+  startup.time_to_ready_ms = static_cast<double>(ready_time_ns - start_time_ns) * 1.0e-6;
+  return startup;
+}
+}  // namespace
+
+TEST(TestStartupStatus, round_trip)
+{
+  auto startup = make_startup("/ns/map_provider", 1600000000000000000, 1600000002500000000);
+  startup.phases = {{"load_map", 2000.5}, {"serialize_map", 2400.0}};
+  const auto status = to_status(startup);
+  EXPECT_EQ(status.name, "/ns/map_provider");
+  const auto parsed = from_status(status);
+  EXPECT_EQ(parsed.node, startup.node);
+  EXPECT_EQ(parsed.start_time_ns, startup.start_time_ns);
+  EXPECT_EQ(parsed.ready_time_ns, startup.ready_time_ns);
+  EXPECT_NEAR(parsed.time_to_ready_ms, 2500.0, 1.0e-3);
+  ASSERT_EQ(parsed.phases.size(), 2U);
+  EXPECT_EQ(parsed.phases[0U].first, "load_map");
+  EXPECT_NEAR(parsed.phases[0U].second, 2000.5, 1.0e-3);
+  EXPECT_EQ(parsed.phases[1U].first, "serialize_map");
+}
+
+TEST(TestStartupStatus, bad_status)
+{
+  auto status = to_status(make_startup("/node", 0, 1000000));
+  status.values.pop_back();
+  EXPECT_THROW(from_status(status), std::runtime_error);
+  status = to_status(make_startup("/node", 0, 1000000));
+  status.values[0U].value = "soon";
+  EXPECT_THROW(from_status(status), std::runtime_error);
+  status = to_status(make_startup("/node", 0, 1000000));
+  status.values[1U].value = "99999999999999999999999";
+  EXPECT_THROW(from_status(status), std::runtime_error);
+}
+
+TEST(TestStartupStatus, summarize)
+{
+  const std::vector<std::string> expected{"/a", "/b", "/c"};
+  EXPECT_EQ(summarize({}, expected).missing_nodes, expected);
+  EXPECT_EQ(summarize({}, expected).time_to_ready_ms, 0.0);
+
+  // The nodes start at different times, the stack is ready with the last of them.
+  const std::vector<NodeStartup> ready{
+    make_startup("/a", 1000000000, 1500000000),
+    make_startup("/b", 1200000000, 4200000000),
+    make_startup("/c", 1100000000, 2000000000)};
+  auto stack = summarize({ready[0U], ready[2U]}, expected);
+  EXPECT_EQ(stack.missing_nodes, std::vector<std::string>{"/b"});
+  EXPECT_NEAR(stack.time_to_ready_ms, 1000.0, 1.0e-6);
+  EXPECT_EQ(stack.slowest_node, "/c");
+
+  stack = summarize(ready, expected);
+  EXPECT_TRUE(stack.missing_nodes.empty());
+  EXPECT_NEAR(stack.time_to_ready_ms, 3200.0, 1.0e-6);
+  EXPECT_EQ(stack.slowest_node, "/b");
+  EXPECT_NEAR(stack.slowest_time_to_ready_ms, 3000.0, 1.0e-6);
+}
+
+class TestStartupGate : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    rclcpp::init(0, nullptr);
+    ASSERT_TRUE(rclcpp::ok());
+    m_node = std::make_shared<rclcpp::Node>("startup_gate_test_node");
+  }
+
+  void TearDown() override
+  {
+    m_node.reset();
+    (void)rclcpp::shutdown();
+  }
+
+  std::shared_ptr<rclcpp::Node> m_node;
+};
+
+TEST_F(TestStartupGate, opens_when_all_requirements_are_met)
+{
+  std::vector<DiagnosticArray> received;
+  const auto listener = std::make_shared<rclcpp::Node>("startup_status_listener");
+  const auto sub = listener->create_subscription<DiagnosticArray>(
+    STARTUP_STATUS_TOPIC, rclcpp::QoS{rclcpp::KeepLast{10U}}.transient_local(),
+    [&received](const DiagnosticArray::SharedPtr msg) {received.push_back(*msg);});
+
+  StartupTracker tracker{*m_node};
+  StartupGate gate{*m_node, tracker, std::chrono::milliseconds{1}};
+  std::promise<void> peer_ready;
+  const auto peer_future = peer_ready.get_future();
+  auto resource = std::async(
+    std::launch::async, [&tracker]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds{20});
+      tracker.phase_done("load");
+      return 42;
+    });
+  gate.require("resource", future_ready(resource));
+  gate.require("peer", future_ready(peer_future));
+  int32_t value = 0;
+  gate.open_when_ready([&value, &resource]() {value = resource.get();});
+  EXPECT_THROW(gate.require("late", []() {return true;}), std::domain_error);
+  EXPECT_THROW(gate.open_when_ready([]() {}), std::domain_error);
+
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(m_node);
+  executor.add_node(listener);
+  const auto spin_for = [&executor](const std::chrono::milliseconds duration) {
+      const auto end = std::chrono::steady_clock::now() + duration;
+      while (std::chrono::steady_clock::now() < end) {
+        executor.spin_some();
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+      }
+    };
+  spin_for(std::chrono::milliseconds{100});
+  // The resource is loaded, but the peer is missing.
+  EXPECT_FALSE(gate.is_open());
+  EXPECT_FALSE(tracker.is_ready());
+  EXPECT_EQ(tracker.time_to_ready(), StartupTracker::Clock::duration::zero());
+
+  peer_ready.set_value();
+  spin_for(std::chrono::milliseconds{100});
+  EXPECT_TRUE(gate.is_open());
+  EXPECT_EQ(value, 42);
+  ASSERT_TRUE(tracker.is_ready());
+  EXPECT_GE(tracker.time_to_ready(), std::chrono::milliseconds{100});
+
+  const auto startup = tracker.startup();
+  EXPECT_EQ(startup.node, "/startup_gate_test_node");
+  ASSERT_EQ(startup.phases.size(), 3U);
+  EXPECT_EQ(startup.phases[0U].first, "load");
+  EXPECT_EQ(startup.phases[1U].first, "resource");
+  EXPECT_EQ(startup.phases[2U].first, "peer");
+  EXPECT_GE(startup.phases[2U].second, 100.0);
+
+  // The tracker is ready only once.
+  tracker.mark_ready();
+  spin_for(std::chrono::milliseconds{20});
+  ASSERT_EQ(received.size(), 1U);
+  ASSERT_EQ(received[0U].status.size(), 1U);
+  const auto published = from_status(received[0U].status[0U]);
+  EXPECT_EQ(published.node, startup.node);
+  EXPECT_EQ(published.ready_time_ns, startup.ready_time_ns);
+}
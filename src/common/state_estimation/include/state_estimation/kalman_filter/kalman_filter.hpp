@@ -20,13 +20,17 @@
 #include <helper_functions/float_comparisons.hpp>
 #include <motion_model/motion_model_interface.hpp>
 #include <motion_model/stationary_motion_model.hpp>
+#include <state_estimation/measurement/linear_measurement.hpp>
 #include <state_estimation/noise_model/noise_interface.hpp>
 #include <state_estimation/state_estimation_interface.hpp>
 #include <state_estimation/visibility_control.hpp>
 
 #include <Eigen/LU>
 
+#include <array>
+#include <cstddef>
 #include <limits>
+#include <type_traits>
 #include <vector>
 
 namespace autoware
@@ -90,15 +94,20 @@ public:
   State crtp_predict(const std::chrono::nanoseconds & dt)
   {
     m_state = m_motion_model.predict(m_state, dt);
-    const auto & motion_jacobian = m_motion_model.jacobian(m_state, dt);
     m_covariance =
-      motion_jacobian * m_covariance * motion_jacobian.transpose() + m_noise_model.covariance(dt);
+      m_motion_model.propagate_covariance(m_state, m_covariance, dt) +
+      m_noise_model.covariance(dt);
     return m_state;
   }
 
   ///
   /// @brief      Correct the predicted state given a measurement
   ///
+  /// @details    Measurements that directly observe a subset of the state variables, i.e., whose
+  ///             mapping matrix is a selection matrix, are detected at compile time and use the
+  ///             corresponding rows and columns of the covariance instead of dense products with
+  ///             the mapping matrix.
+  ///
   /// @note       It is expected that a prediction step was done right before the correction.
   ///
   /// @param[in]  measurement   Current measurement.
@@ -110,17 +119,7 @@ public:
   template<typename MeasurementT>
   State crtp_correct(const MeasurementT & measurement)
   {
-    const auto expected_measurement = measurement.create_new_instance_from(m_state);
-    const auto innovation = wrap_all_angles(measurement.state() - expected_measurement);
-    const auto mapping_matrix = measurement.mapping_matrix_from(m_state);
-    const auto innovation_covariance =
-      mapping_matrix * m_covariance * mapping_matrix.transpose() + measurement.covariance();
-    const auto kalman_gain =
-      m_covariance * mapping_matrix.transpose() * innovation_covariance.inverse();
-    m_state += kalman_gain * innovation.vector();
-    m_state.wrap_all_angles();
-    m_covariance = (State::Matrix::Identity() - kalman_gain * mapping_matrix) * m_covariance;
-    return m_state;
+    return correct_impl(measurement, is_selection_measurement<MeasurementT, State>{});
   }
 
   ///
@@ -146,6 +145,63 @@ public:
   const auto & crtp_covariance() const {return m_covariance;}
 
 private:
+  /// @brief      Correct the state with a measurement with a generic mapping matrix.
+  template<typename MeasurementT>
+  State correct_impl(const MeasurementT & measurement, std::false_type)
+  {
+    const auto expected_measurement = measurement.create_new_instance_from(m_state);
+    const auto innovation = wrap_all_angles(measurement.state() - expected_measurement);
+    const auto mapping_matrix = measurement.mapping_matrix_from(m_state);
+    const auto innovation_covariance =
+      mapping_matrix * m_covariance * mapping_matrix.transpose() + measurement.covariance();
+    const auto kalman_gain =
+      m_covariance * mapping_matrix.transpose() * innovation_covariance.inverse();
+    m_state += kalman_gain * innovation.vector();
+    m_state.wrap_all_angles();
+    m_covariance = (State::Matrix::Identity() - kalman_gain * mapping_matrix) * m_covariance;
+    return m_state;
+  }
+
+  ///
+  /// @brief      Correct the state with a measurement that directly observes some of its
+  ///             variables.
+  ///
+  /// @details    With H being a selection matrix, P * H^T and H * P are the columns and rows of
+  ///             the covariance of the measured variables and H * P * H^T is their sub-block, so
+  ///             the update costs O(n^2 * m) instead of O(n^3) for n state and m measured
+  ///             variables. The result is the same as for the generic correction.
+  ///
+  template<typename MeasurementT>
+  State correct_impl(const MeasurementT & measurement, std::true_type)
+  {
+    using MeasuredState = typename MeasurementT::State;
+    constexpr auto kMeasuredSize = MeasuredState::size();
+    using Gain = Eigen::Matrix<typename State::Scalar, State::size(), kMeasuredSize>;
+    using MappedCovariance = Eigen::Matrix<typename State::Scalar, kMeasuredSize, State::size()>;
+
+    // Index of every measured variable in the state.
+    constexpr auto indices = State::indices_of(MeasuredState::variables());
+
+    const auto expected_measurement = measurement.create_new_instance_from(m_state);
+    const auto innovation = wrap_all_angles(measurement.state() - expected_measurement);
+    Gain covariance_columns;
+    MappedCovariance covariance_rows;
+    typename MeasuredState::Matrix innovation_covariance{measurement.covariance()};
+    for (Eigen::Index i = 0; i < kMeasuredSize; ++i) {
+      const auto index = indices[static_cast<std::size_t>(i)];
+      covariance_columns.col(i) = m_covariance.col(index);
+      covariance_rows.row(i) = m_covariance.row(index);
+      for (Eigen::Index j = 0; j < kMeasuredSize; ++j) {
+        innovation_covariance(i, j) += m_covariance(index, indices[static_cast<std::size_t>(j)]);
+      }
+    }
+    const Gain kalman_gain = covariance_columns * innovation_covariance.inverse();
+    m_state += kalman_gain * innovation.vector();
+    m_state.wrap_all_angles();
+    m_covariance -= kalman_gain * covariance_rows;
+    return m_state;
+  }
+
   /// Motion model used to predict the state forward.
   MotionModelT m_motion_model{};
   /// Noise model of the movement.
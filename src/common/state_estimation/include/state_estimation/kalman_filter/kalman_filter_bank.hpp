@@ -0,0 +1,306 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef STATE_ESTIMATION__KALMAN_FILTER__KALMAN_FILTER_BANK_HPP_
+#define STATE_ESTIMATION__KALMAN_FILTER__KALMAN_FILTER_BANK_HPP_
+
+#include <motion_model/motion_model_interface.hpp>
+#include <state_estimation/kalman_filter/kalman_filter.hpp>
+#include <state_estimation/noise_model/noise_interface.hpp>
+#include <state_estimation/visibility_control.hpp>
+
+#include <Eigen/Core>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+namespace autoware
+{
+namespace common
+{
+namespace state_estimation
+{
+///
+/// @brief      A bank of Kalman filters that share a motion model and a noise model.
+///
+/// @details    The states and covariances of all filters are stored as structure of arrays: every
+///             state variable and every covariance entry is one contiguous row over the filters.
+///             The prediction computes the transition matrix and the motion noise once and then
+///             updates all filters with a few matrix products over these rows, which vectorize
+///             across the filters. Filters are addressed by index, removing a filter moves the
+///             last one into its place.
+///
+/// @note       The motion model must be linear, i.e., its Jacobian must not depend on the state,
+///             as it is evaluated only once per prediction for all filters.
+///
+/// @tparam     MotionModelT  Type of the motion model.
+/// @tparam     NoiseModelT   Type of the noise model.
+///
+template<typename MotionModelT, typename NoiseModelT>
+class STATE_ESTIMATION_PUBLIC KalmanFilterBank
+{
+  static_assert(
+    std::is_base_of<common::motion_model::MotionModelInterface<MotionModelT>, MotionModelT>::value,
+    "\n\nMotion model must inherit from MotionModelInterface\n\n");
+  static_assert(
+    std::is_base_of<NoiseInterface<NoiseModelT>, NoiseModelT>::value,
+    "\n\nNoise model must inherit from NoiseInterface\n\n");
+  static_assert(
+    std::is_same<typename MotionModelT::State, typename NoiseModelT::State>::value,
+    "\n\nMotion model and noise model must have the same underlying state\n\n");
+
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  using State = typename MotionModelT::State;
+  using StateMatrix = typename State::Matrix;
+  using Scalar = typename State::Scalar;
+
+  ///
+  /// @brief      Constructs a new empty bank.
+  ///
+  /// @param[in]  motion_model  The motion model to be used to predict the movement.
+  /// @param[in]  noise_model   The noise model that models the motion noise.
+  /// @param[in]  capacity      The number of filters to allocate memory for. More filters can be
+  ///                           added, but that allocates.
+  ///
+  explicit KalmanFilterBank(
+    MotionModelT motion_model,
+    NoiseModelT noise_model,
+    const std::size_t capacity = 0U)
+  : m_motion_model{motion_model},
+    m_noise_model{noise_model}
+  {
+    reserve(capacity);
+  }
+
+  ///
+  /// @brief      Add a filter to the bank.
+  ///
+  /// @param[in]  state       The initial state of the filter.
+  /// @param[in]  covariance  The initial state covariance.
+  ///
+  /// @return     The index of the new filter, which is the previous size of the bank.
+  ///
+  std::size_t add(const State & state, const StateMatrix & covariance)
+  {
+    if (m_size == capacity()) {
+      reserve(std::max(2U * m_size, std::size_t{1U}));
+    }
+    ++m_size;
+    reset(m_size - 1U, state, covariance);
+    return m_size - 1U;
+  }
+
+  ///
+  /// @brief      Remove a filter. The last filter is moved to the index of the removed one.
+  ///
+  /// @param[in]  index  The index of the filter to remove.
+  ///
+  /// @throws     std::out_of_range if there is no filter with this index.
+  ///
+  void remove(const std::size_t index)
+  {
+    check_index(index);
+    const auto last = m_size - 1U;
+    if (index != last) {
+      m_states.col(to_index(index)) = m_states.col(to_index(last));
+      m_covariances.col(to_index(index)) = m_covariances.col(to_index(last));
+    }
+    m_size = last;
+  }
+
+  ///
+  /// @brief      Reset the state and covariance of one filter.
+  ///
+  /// @throws     std::out_of_range if there is no filter with this index.
+  ///
+  void reset(const std::size_t index, const State & state, const StateMatrix & covariance)
+  {
+    check_index(index);
+    m_states.col(to_index(index)) = state.vector();
+    m_covariances.col(to_index(index)) =
+      Eigen::Map<const CovarianceVector>{covariance.data()};
+  }
+
+  ///
+  /// @brief      Predict all filters forward.
+  ///
+  /// @details    For the transition matrix F, the state rows are updated with X = F * X. Row
+  ///             r + c * n of the covariances holds the entry (r, c) of all covariances, so the
+  ///             rows of one column c form a n x N block and T = F * P is computed per column.
+  ///             The rows of one row r are the same kind of block with a stride of n rows and
+  ///             P = T * F^T + Q is computed per row. The transition matrices of the motion models
+  ///             are mostly zeros, each of the products only adds the rows for the non-zero
+  ///             entries of F.
+  ///
+  /// @param[in]  dt    Time difference to the time at which prediction is needed.
+  ///
+  void predict(const std::chrono::nanoseconds & dt)
+  {
+    if (m_size == 0U) {
+      return;
+    }
+    const StateMatrix transition = m_motion_model.jacobian(State{}, dt);
+    const StateMatrix noise = m_noise_model.covariance(dt);
+    const auto size = to_index(m_size);
+    const auto capacity = m_states.cols();
+    const Eigen::OuterStride<> stride{capacity};
+    const Eigen::OuterStride<> covariance_row_stride{kSize * capacity};
+
+    // Predicted states go to the buffer first, as every row is read by several output rows.
+    apply(
+      transition, StridedRows{m_states.data(), kSize, size, stride},
+      StridedRows{m_buffer.data(), kSize, size, stride});
+    m_states.leftCols(size) = m_buffer.topLeftCorner(kSize, size);
+
+    for (Eigen::Index c = 0; c < kSize; ++c) {
+      const auto offset = c * kSize * capacity;
+      apply(
+        transition, StridedRows{m_covariances.data() + offset, kSize, size, stride},
+        StridedRows{m_buffer.data() + offset, kSize, size, stride});
+    }
+    for (Eigen::Index r = 0; r < kSize; ++r) {
+      const auto offset = r * capacity;
+      apply(
+        transition, StridedRows{m_buffer.data() + offset, kSize, size, covariance_row_stride},
+        StridedRows{m_covariances.data() + offset, kSize, size, covariance_row_stride});
+    }
+    m_covariances.leftCols(size).colwise() += Eigen::Map<const CovarianceVector>{noise.data()};
+  }
+
+  ///
+  /// @brief      Correct one filter with a measurement.
+  ///
+  /// @param[in]  index         The index of the filter.
+  /// @param[in]  measurement   Current measurement.
+  ///
+  /// @tparam     MeasurementT  Measurement type.
+  ///
+  /// @return     State corrected with the measurement.
+  ///
+  /// @throws     std::out_of_range if there is no filter with this index.
+  ///
+  template<typename MeasurementT>
+  State correct(const std::size_t index, const MeasurementT & measurement)
+  {
+    auto filter = make_correction_only_kalman_filter(state(index), covariance(index));
+    const auto corrected = filter.correct(measurement);
+    reset(index, corrected, filter.covariance());
+    return corrected;
+  }
+
+  ///
+  /// @brief      Get the state of one filter.
+  ///
+  /// @throws     std::out_of_range if there is no filter with this index.
+  ///
+  State state(const std::size_t index) const
+  {
+    check_index(index);
+    return State{typename State::Vector{m_states.col(to_index(index))}};
+  }
+
+  ///
+  /// @brief      Get the covariance of one filter.
+  ///
+  /// @throws     std::out_of_range if there is no filter with this index.
+  ///
+  StateMatrix covariance(const std::size_t index) const
+  {
+    check_index(index);
+    StateMatrix covariance;
+    Eigen::Map<CovarianceVector>{covariance.data()} = m_covariances.col(to_index(index));
+    return covariance;
+  }
+
+  /// @brief      Get the number of filters.
+  std::size_t size() const noexcept {return m_size;}
+
+  /// @brief      Get the number of filters that fit into the allocated memory.
+  std::size_t capacity() const noexcept {return static_cast<std::size_t>(m_states.cols());}
+
+  ///
+  /// @brief      Allocate memory for the given number of filters. Does nothing if the bank has
+  ///             that capacity already.
+  ///
+  void reserve(const std::size_t capacity)
+  {
+    if (capacity <= this->capacity()) {
+      return;
+    }
+    const auto cols = to_index(capacity);
+    m_states.conservativeResize(Eigen::NoChange, cols);
+    m_covariances.conservativeResize(Eigen::NoChange, cols);
+    m_buffer.resize(Eigen::NoChange, cols);
+  }
+
+private:
+  static constexpr Eigen::Index kSize = State::size();
+  using StateRows = Eigen::Matrix<Scalar, kSize, Eigen::Dynamic, Eigen::RowMajor>;
+  using CovarianceRows = Eigen::Matrix<Scalar, kSize * kSize, Eigen::Dynamic, Eigen::RowMajor>;
+  using CovarianceVector = Eigen::Matrix<Scalar, kSize * kSize, 1>;
+  using StridedRows = Eigen::Map<StateRows, Eigen::Unaligned, Eigen::OuterStride<>>;
+
+  static Eigen::Index to_index(const std::size_t index) noexcept
+  {
+    return static_cast<Eigen::Index>(index);
+  }
+
+  /// @brief      Compute output = transition * input, skipping the zero entries of the transition.
+  static void apply(
+    const StateMatrix & transition, const StridedRows & input, StridedRows output) noexcept
+  {
+    for (Eigen::Index r = 0; r < kSize; ++r) {
+      output.row(r).setZero();
+      for (Eigen::Index c = 0; c < kSize; ++c) {
+        const auto value = transition(r, c);
+        if (value != Scalar{0}) {
+          output.row(r) += value * input.row(c);
+        }
+      }
+    }
+  }
+
+  void check_index(const std::size_t index) const
+  {
+    if (index >= m_size) {
+      throw std::out_of_range("KalmanFilterBank: There is no filter with this index.");
+    }
+  }
+
+  /// Motion model used to predict the states forward.
+  MotionModelT m_motion_model{};
+  /// Noise model of the movement.
+  NoiseModelT m_noise_model{};
+  /// One row per state variable, one column per filter.
+  StateRows m_states{kSize, 0};
+  /// One row per covariance entry in column-major order, one column per filter.
+  CovarianceRows m_covariances{kSize * kSize, 0};
+  /// Intermediate results of the prediction.
+  CovarianceRows m_buffer{kSize * kSize, 0};
+  /// Number of filters in the bank.
+  std::size_t m_size{0U};
+};
+
+template<typename MotionModelT, typename NoiseModelT>
+constexpr Eigen::Index KalmanFilterBank<MotionModelT, NoiseModelT>::kSize;
+
+}  // namespace state_estimation
+}  // namespace common
+}  // namespace autoware
+
+#endif  // STATE_ESTIMATION__KALMAN_FILTER__KALMAN_FILTER_BANK_HPP_
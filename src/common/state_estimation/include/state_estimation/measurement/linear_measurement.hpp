@@ -25,6 +25,7 @@
 
 #include <chrono>
 #include <tuple>
+#include <type_traits>
 
 namespace autoware
 {
@@ -193,6 +194,28 @@ private:
   typename StateT::Matrix m_covariance{StateT::Matrix::Zero()};
 };
 
+///
+/// @brief      A trait to check if a measurement directly observes a subset of the variables of a
+///             state, i.e., if its mapping matrix from that state is a selection matrix.
+///
+/// @tparam     MeasurementT  Measurement type.
+/// @tparam     StateT        State of the filter that is corrected with the measurement.
+///
+template<typename MeasurementT, typename StateT>
+struct STATE_ESTIMATION_PUBLIC is_selection_measurement : public std::false_type {};
+
+///
+/// @brief      A linear measurement is a selection measurement if all of its variables are present
+///             in the other state and the scalar types match.
+///
+template<typename MeasuredStateT, typename StateT>
+struct STATE_ESTIMATION_PUBLIC is_selection_measurement<LinearMeasurement<MeasuredStateT>, StateT>
+  : public std::integral_constant<bool,
+    std::is_same<typename MeasuredStateT::Scalar, typename StateT::Scalar>::value &&
+    (std::tuple_size<typename autoware::common::type_traits::intersect<
+      typename MeasuredStateT::Variables, typename StateT::Variables>::type>::value ==
+    static_cast<std::size_t>(MeasuredStateT::size()))> {};
+
 }  // namespace state_estimation
 }  // namespace common
 }  // namespace autoware
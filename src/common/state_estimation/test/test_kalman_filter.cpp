@@ -39,6 +39,7 @@ using autoware::common::state_vector::variable::YAW_CHANGE_ACCELERATION;
 using autoware::common::state_vector::Variable;
 using autoware::common::state_vector::FloatState;
 using autoware::common::state_estimation::LinearMeasurement;
+using autoware::common::state_estimation::is_selection_measurement;
 using autoware::common::state_estimation::KalmanFilter;
 using autoware::common::state_estimation::NoiseInterface;
 using autoware::common::state_estimation::WienerNoise;
@@ -247,6 +248,50 @@ TEST(TestKalmanFilter, TrackThrownBall) {
   EXPECT_NEAR(expected_state.at<Y_ACCELERATION>(), g, kRelaxedEpsilon);
 }
 
+/// @test Test that a measurement of some of the state variables gives the same correction as the
+///       generic one with the mapping matrix.
+TEST(TestKalmanFilter, SelectionMeasurementMatchesGenericCorrection) {
+  using State = ConstAccelerationXYYaw32;
+  using Matrix = State::Matrix;
+  using MeasurementState = FloatState<YAW, X>;
+  struct UNOBSERVABLE : public Variable {};
+  static_assert(
+    is_selection_measurement<LinearMeasurement<MeasurementState>, State>::value,
+    "Measurement of state variables must be a selection measurement.");
+  static_assert(
+    !is_selection_measurement<LinearMeasurement<FloatState<X, UNOBSERVABLE>>, State>::value,
+    "Measurement of other variables must not be a selection measurement.");
+
+  State state{};
+  for (auto i = 0; i < State::size(); ++i) {
+    state.vector()[i] = 0.1F * static_cast<float32_t>(i);
+  }
+  Matrix factor{Matrix::Identity()};
+  for (auto i = 0; i < State::size(); ++i) {
+    for (auto j = 0; j < i; ++j) {
+      factor(i, j) = 0.05F * static_cast<float32_t>(i + j);
+    }
+  }
+  const Matrix covariance{factor * factor.transpose()};
+  const auto measurement = LinearMeasurement<MeasurementState>::create_with_stddev(
+    MeasurementState::Vector{0.5F, 1.0F}, MeasurementState::Vector{0.2F, 0.3F});
+
+  auto kf = make_correction_only_kalman_filter(state, covariance);
+  kf.correct(measurement);
+
+  const auto mapping_matrix = measurement.mapping_matrix_from(state);
+  const MeasurementState::Matrix innovation_covariance =
+    mapping_matrix * covariance * mapping_matrix.transpose() + measurement.covariance();
+  const auto kalman_gain =
+    covariance * mapping_matrix.transpose() * innovation_covariance.inverse();
+  const State::Vector expected_state = state.vector() + kalman_gain *
+    (measurement.state().vector() - mapping_matrix * state.vector());
+  const Matrix expected_covariance =
+    (Matrix::Identity() - kalman_gain * mapping_matrix) * covariance;
+  EXPECT_TRUE(kf.state().vector().isApprox(expected_state, 1.0e-5F));
+  EXPECT_TRUE(kf.covariance().isApprox(expected_covariance, 1.0e-5F));
+}
+
 /// \test Check that Kalman Filter can be used for classification. In this example of a traffic
 /// light state.
 TEST(KalmanFilterWrapperTest, TrafficLightState) {
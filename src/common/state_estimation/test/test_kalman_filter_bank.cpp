@@ -0,0 +1,123 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <common/types.hpp>
+#include <motion_model/linear_motion_model.hpp>
+#include <state_estimation/kalman_filter/kalman_filter.hpp>
+#include <state_estimation/kalman_filter/kalman_filter_bank.hpp>
+#include <state_estimation/measurement/linear_measurement.hpp>
+#include <state_estimation/noise_model/wiener_noise.hpp>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+using autoware::common::state_vector::variable::X;
+using autoware::common::state_vector::variable::Y;
+using autoware::common::state_vector::FloatState;
+using autoware::common::state_vector::ConstAccelerationXY32;
+using autoware::common::state_estimation::KalmanFilter;
+using autoware::common::state_estimation::KalmanFilterBank;
+using autoware::common::state_estimation::LinearMeasurement;
+using autoware::common::state_estimation::WienerNoise;
+using autoware::common::motion_model::LinearMotionModel;
+using autoware::common::types::float32_t;
+
+namespace
+{
+using State = ConstAccelerationXY32;
+using Matrix = State::Matrix;
+using MotionModel = LinearMotionModel<State>;
+using NoiseModel = WienerNoise<State>;
+using Filter = KalmanFilter<MotionModel, NoiseModel>;
+using Bank = KalmanFilterBank<MotionModel, NoiseModel>;
+
+State make_state(const std::size_t index)
+{
+  State state{};
+  for (auto i = 0; i < State::size(); ++i) {
+    state.vector()[i] = 0.1F * static_cast<float32_t>(i) + static_cast<float32_t>(index);
+  }
+  return state;
+}
+
+Matrix make_covariance(const std::size_t index)
+{
+  Matrix factor{Matrix::Identity()};
+  for (auto i = 0; i < State::size(); ++i) {
+    for (auto j = 0; j < i; ++j) {
+      factor(i, j) = 0.01F * static_cast<float32_t>(i + j) + 0.1F * static_cast<float32_t>(index);
+    }
+  }
+  return factor * factor.transpose();
+}
+
+void expect_same(const Bank & bank, const std::vector<Filter> & filters)
+{
+  ASSERT_EQ(bank.size(), filters.size());
+  for (std::size_t i = 0U; i < filters.size(); ++i) {
+    EXPECT_TRUE(bank.state(i).vector().isApprox(filters[i].state().vector(), 1.0e-5F)) << i;
+    EXPECT_TRUE(bank.covariance(i).isApprox(filters[i].covariance(), 1.0e-5F)) << i;
+  }
+}
+}  // namespace
+
+/// @test Test that the filters in the bank behave like separate Kalman filters.
+TEST(TestKalmanFilterBank, MatchesSeparateFilters) {
+  const NoiseModel noise_model{{1.0F, 2.0F}};
+  Bank bank{MotionModel{}, noise_model, 2U};
+  std::vector<Filter> filters;
+  for (std::size_t i = 0U; i < 5U; ++i) {
+    EXPECT_EQ(bank.add(make_state(i), make_covariance(i)), i);
+    filters.emplace_back(MotionModel{}, noise_model, make_state(i), make_covariance(i));
+  }
+  EXPECT_GE(bank.capacity(), 5U);
+  expect_same(bank, filters);
+
+  using MeasurementState = FloatState<X, Y>;
+  const auto measurement = LinearMeasurement<MeasurementState>::create_with_stddev(
+    MeasurementState::Vector{1.0F, 2.0F}, MeasurementState::Vector{0.5F, 0.5F});
+  for (auto step = 0; step < 10; ++step) {
+    bank.predict(std::chrono::milliseconds{100LL});
+    for (auto & filter : filters) {
+      filter.predict(std::chrono::milliseconds{100LL});
+    }
+    const auto index = static_cast<std::size_t>(step) % filters.size();
+    bank.correct(index, measurement);
+    filters[index].correct(measurement);
+    expect_same(bank, filters);
+  }
+
+  // The last filter takes the place of the removed one.
+  bank.remove(1U);
+  filters[1U] = filters.back();
+  filters.pop_back();
+  expect_same(bank, filters);
+  bank.reset(0U, make_state(7U), make_covariance(7U));
+  filters[0U].reset(make_state(7U), make_covariance(7U));
+  bank.predict(std::chrono::milliseconds{50LL});
+  for (auto & filter : filters) {
+    filter.predict(std::chrono::milliseconds{50LL});
+  }
+  expect_same(bank, filters);
+
+  EXPECT_THROW(bank.state(filters.size()), std::out_of_range);
+  EXPECT_THROW(bank.remove(filters.size()), std::out_of_range);
+  while (bank.size() > 0U) {
+    bank.remove(0U);
+  }
+  EXPECT_NO_THROW(bank.predict(std::chrono::milliseconds{100LL}));
+}
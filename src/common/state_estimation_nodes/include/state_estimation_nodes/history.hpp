@@ -28,10 +28,13 @@
 #include <Eigen/Cholesky>
 #include <Eigen/Core>
 
+#include <algorithm>
 #include <chrono>
-#include <map>
+#include <cstddef>
 #include <memory>
+#include <stdexcept>
 #include <utility>
+#include <vector>
 
 namespace autoware
 {
@@ -91,11 +94,12 @@ struct ResetEvent
 ///
 /// @brief      This class encapsulates a history of events used with EKF.
 ///
-///             The class handles adding events to a history of a specified size. It models the
-///             behavior of a circular buffer, meaning that as new events come in, the oldest ones
-///             are removed. The events can be either measurement types or specific events like
-///             reset or prediction. Whenever an event is added to the middle of the history all the
-///             following events get rolled on top of this event to produce a new state.
+///             The class handles adding events to a history of a specified size. It is stored in
+///             a preallocated circular buffer sorted by time, meaning that as new events come in,
+///             the oldest ones are removed without any allocation. The events can be either
+///             measurement types or specific events like reset or prediction. Whenever an event is
+///             added to the middle of the history all the following events get rolled on top of
+///             the state stored with the previous event to produce a new state.
 ///
 /// @tparam     FilterT       Type of EKF filter used.
 /// @tparam     kNumOfStates  Dimensionality of the state in the filter.
@@ -116,8 +120,8 @@ class History
 
   /// Typedef for timestamps.
   using Timestamp = std::chrono::system_clock::time_point;
-  /// Typedef for history map type.
-  using HistoryMap = std::multimap<Timestamp, HistoryEntry>;
+  /// Typedef for a timestamped entry of the history buffer.
+  using TimedEntry = std::pair<Timestamp, HistoryEntry>;
 
 public:
   ///
@@ -126,14 +130,22 @@ public:
   /// @param      filter                 The filter pointer to be used internally.
   /// @param[in]  max_history_size       The maximum history size.
   /// @param[in]  mahalanobis_threshold  The mahalanobis threshold
+  /// @param[in]  max_replay_size        The maximum number of events that may be replayed when
+  ///                                    an event is added to the middle of the history, which
+  ///                                    bounds the time spent on a late event. Unbounded if 0.
   ///
   explicit History(
     FilterT & filter,
     const std::size_t max_history_size,
-    const common::types::float32_t mahalanobis_threshold)
+    const common::types::float32_t mahalanobis_threshold,
+    const std::size_t max_replay_size = 0U)
   : m_filter{filter},
     m_max_history_size{max_history_size},
-    m_mahalanobis_threshold{mahalanobis_threshold} {}
+    m_mahalanobis_threshold{mahalanobis_threshold},
+    m_max_replay_size{max_replay_size}
+  {
+    m_buffer.reserve(m_max_history_size);
+  }
 
   ///
   /// @brief      Add an event to history. If it is added to the middle the following ones are
@@ -142,15 +154,18 @@ public:
   /// @param[in]  timestamp  The timestamp of the event.
   /// @param[in]  entry      The entry to be added to history.
   ///
+  /// @throws     std::runtime_error if a non-reset event would be the oldest one, or more than
+  ///             the maximum replay size of events follow it. It is not added in that case.
+  ///
   void emplace_event(const Timestamp & timestamp, const HistoryEntry & entry);
   /// @brief      Check if the history is empty.
-  inline bool empty() const noexcept {return m_history.empty();}
+  inline bool empty() const noexcept {return m_size == 0U;}
   /// @brief      Get size of history.
-  inline std::size_t size() const noexcept {return m_history.size();}
+  inline std::size_t size() const noexcept {return m_size;}
   /// @brief      Get last timestamp in history.
-  inline const Timestamp & get_last_timestamp() const noexcept {return m_history.rbegin()->first;}
+  inline const Timestamp & get_last_timestamp() const noexcept {return at(m_size - 1U).first;}
   /// @brief      Get last event in history.
-  inline const HistoryEntry & get_last_event() const noexcept {return m_history.rbegin()->second;}
+  inline const HistoryEntry & get_last_event() const noexcept {return at(m_size - 1U).second;}
   /// @brief      Get the filter as a const ref.
   const FilterT & get_filter() const noexcept {return m_filter;}
   /// @brief      Get the filter.
@@ -162,22 +177,60 @@ private:
   ///
   inline void drop_oldest_event_if_needed()
   {
-    if ((m_history.size() >= m_max_history_size) && (m_max_history_size > 0U)) {
-      (void) m_history.erase(m_history.begin());
+    if ((m_size >= m_max_history_size) && (m_max_history_size > 0U)) {
+      drop_oldest_event();
     }
   }
 
+  /// @brief      Drop the oldest event, its slot is reused by the next one.
+  inline void drop_oldest_event() noexcept
+  {
+    m_head = (m_head + 1U) % m_buffer.size();
+    --m_size;
+  }
+
+  /// @brief      Get the entry at the given position in time order.
+  inline TimedEntry & at(const std::size_t index) noexcept
+  {
+    return m_buffer[(m_head + index) % m_buffer.size()];
+  }
+  /// @brief      Get the entry at the given position in time order.
+  inline const TimedEntry & at(const std::size_t index) const noexcept
+  {
+    return m_buffer[(m_head + index) % m_buffer.size()];
+  }
+
+  ///
+  /// @brief      Find where an event is inserted, after all events with the same timestamp.
+  ///
+  /// @param[in]  timestamp  The timestamp of the event.
+  ///
+  /// @return     The position in time order at which the event is to be inserted.
+  ///
+  std::size_t find_insertion_index(const Timestamp & timestamp) const noexcept;
+
+  ///
+  /// @brief      Insert an entry at the given position in time order, shifting the following
+  ///             entries towards the end of the buffer.
+  ///
+  void insert_at(const std::size_t index, const Timestamp & timestamp, const HistoryEntry & entry);
+
   ///
   /// @brief      Update all the following events as their state is based on the current one.
   ///
-  /// @param[in]  start_iter  The current iterator with the new state.
+  /// @param[in]  start_index  The position of the entry with the new event.
   ///
-  void update_impacted_events(const typename HistoryMap::iterator & start_iter);
+  void update_impacted_events(const std::size_t start_index);
 
-  HistoryMap m_history{};  ///< history of events.
+  /// Circular buffer of the events sorted by time. Only grows until it reaches the maximum
+  /// history size, the oldest one is at m_head.
+  std::vector<TimedEntry, Eigen::aligned_allocator<TimedEntry>> m_buffer{};
+  std::size_t m_head{0U};  ///< Position of the oldest event in the buffer.
+  std::size_t m_size{0U};  ///< Number of events in history.
   FilterT & m_filter{};  ///< pointer to the filter implementation.
   std::size_t m_max_history_size{};  ///< Maximum number of events in history.
   common::types::float32_t m_mahalanobis_threshold{};  ///< Mahalanobis distance threshold.
+  std::size_t m_max_replay_size{};  ///< Maximum number of events replayed over, 0 if unbounded.
 };
 
 template<typename FilterT, typename ... EventT>
@@ -278,41 +331,99 @@ template<typename FilterT, typename ... EventT>
 void History<FilterT, EventT...>::emplace_event(
   const Timestamp & timestamp, const HistoryEntry & entry)
 {
+  const auto index = find_insertion_index(timestamp);
+  if ((m_max_replay_size > 0U) && ((m_size - index) > m_max_replay_size)) {
+    throw std::runtime_error(
+            "Event too old to be replayed. Consider increasing the maximum replay size or debug "
+            "program latencies.");
+  }
+  // Dropping the oldest event cannot move the insertion point of a later one.
+  const auto dropped = (index > 0U) && (m_size >= m_max_history_size) &&
+    (m_max_history_size > 0U);
   drop_oldest_event_if_needed();
-  const auto iterator_to_inserted_position = m_history.emplace(timestamp, entry);
-  update_impacted_events(iterator_to_inserted_position);
+  const auto inserted_index = dropped ? (index - 1U) : index;
+  insert_at(inserted_index, timestamp, entry);
+  update_impacted_events(inserted_index);
+}
+
+template<typename FilterT, typename ... EventT>
+std::size_t History<FilterT, EventT...>::find_insertion_index(
+  const Timestamp & timestamp) const noexcept
+{
+  // Most events are newer than all others.
+  if ((m_size == 0U) || (get_last_timestamp() <= timestamp)) {
+    return m_size;
+  }
+  std::size_t first = 0U;
+  std::size_t count = m_size;
+  while (count > 0U) {
+    const auto step = count / 2U;
+    const auto middle = first + step;
+    if (at(middle).first <= timestamp) {
+      first = middle + 1U;
+      count -= step + 1U;
+    } else {
+      count = step;
+    }
+  }
+  return first;
+}
+
+template<typename FilterT, typename ... EventT>
+void History<FilterT, EventT...>::insert_at(
+  const std::size_t index, const Timestamp & timestamp, const HistoryEntry & entry)
+{
+  if (m_size == m_buffer.size()) {
+    // No free slot: grow the buffer, which only happens before it is full.
+    if (m_head != 0U) {
+      (void) std::rotate(
+        m_buffer.begin(),
+        m_buffer.begin() + static_cast<std::ptrdiff_t>(m_head),
+        m_buffer.end());
+      m_head = 0U;
+    }
+    (void) m_buffer.emplace(
+      m_buffer.begin() + static_cast<std::ptrdiff_t>(index), timestamp, entry);
+  } else {
+    // Move the following entries one slot further, into the free slot after the newest one.
+    for (auto i = m_size; i > index; --i) {
+      at(i) = std::move(at(i - 1U));
+    }
+    at(index) = TimedEntry{timestamp, entry};
+  }
+  ++m_size;
 }
 
 template<typename FilterT, typename ... EventT>
-void History<FilterT, EventT...>::update_impacted_events(
-  const typename HistoryMap::iterator & start_iter)
+void History<FilterT, EventT...>::update_impacted_events(const std::size_t start_index)
 {
   Timestamp previous_timestamp{};
-  if (start_iter == m_history.begin()) {
-    if (!mpark::holds_alternative<ResetEvent<FilterT>>(start_iter->second.event())) {
-      (void) m_history.erase(start_iter);
+  if (start_index == 0U) {
+    if (!mpark::holds_alternative<ResetEvent<FilterT>>(at(0U).second.event())) {
+      drop_oldest_event();
       throw std::runtime_error(
               "Non-reset event inserted to the beginning of history. This might "
               "happen if a very old event is inserted into the queue. Consider "
               "increasing the queue size or debug program latencies.");
     }
   } else {
-    const auto prev_iter = std::prev(start_iter);
-    previous_timestamp = prev_iter->first;
-    const auto & prev_entry = prev_iter->second;
+    const auto & prev = at(start_index - 1U);
+    previous_timestamp = prev.first;
+    const auto & prev_entry = prev.second;
     m_filter.reset(
       typename FilterT::State{prev_entry.stored_state()},
       prev_entry.stored_covariance());
   }
-  for (auto iter = start_iter; iter != m_history.end(); ++iter) {
-    const auto current_timestamp = iter->first;
-    auto & entry = iter->second;
+  for (auto index = start_index; index < m_size; ++index) {
+    auto & timed_entry = at(index);
+    const auto current_timestamp = timed_entry.first;
+    auto & entry = timed_entry.second;
     mpark::visit(
       EkfStateUpdater{m_filter, m_mahalanobis_threshold, current_timestamp - previous_timestamp},
       entry.event());
     entry.update_stored_state(m_filter.state());
     entry.update_stored_covariance(m_filter.covariance());
-    previous_timestamp = iter->first;
+    previous_timestamp = current_timestamp;
   }
 }
 
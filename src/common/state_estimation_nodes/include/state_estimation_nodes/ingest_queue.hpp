@@ -0,0 +1,116 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef STATE_ESTIMATION_NODES__INGEST_QUEUE_HPP_
+#define STATE_ESTIMATION_NODES__INGEST_QUEUE_HPP_
+
+#include <common/types.hpp>
+
+#include <Eigen/Core>
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace autoware
+{
+namespace common
+{
+namespace state_estimation
+{
+
+///
+/// @brief      A fixed size lock-free queue between one producer and one consumer thread.
+///
+/// @details    Used to hand measurements from a subscription callback to the prediction timer
+///             without either of them waiting on the other. Only one thread may push and only one
+///             thread may pop at a time, e.g., a subscription in a mutually exclusive callback
+///             group and a timer.
+///
+/// @tparam     T     Type of the elements, must be default constructible and copy assignable.
+///
+template<typename T>
+class IngestQueue
+{
+public:
+  ///
+  /// @brief      Constructs a new instance, allocating space for all the elements.
+  ///
+  /// @param[in]  capacity  The maximum number of elements in the queue.
+  ///
+  /// @throws     std::domain_error if the capacity is zero.
+  ///
+  explicit IngestQueue(const std::size_t capacity)
+  : m_elements(capacity)
+  {
+    if (capacity == 0U) {
+      throw std::domain_error("IngestQueue: Capacity must be positive.");
+    }
+  }
+
+  ///
+  /// @brief      Add an element, called by the producer.
+  ///
+  /// @param[in]  element  The element.
+  ///
+  /// @return     False if the queue is full, in which case the element is not added.
+  ///
+  common::types::bool8_t push(const T & element)
+  {
+    const auto tail = m_tail.load(std::memory_order_relaxed);
+    if (tail - m_head.load(std::memory_order_acquire) == m_elements.size()) {
+      return false;
+    }
+    m_elements[tail % m_elements.size()] = element;
+    m_tail.store(tail + 1U, std::memory_order_release);
+    return true;
+  }
+
+  ///
+  /// @brief      Remove the oldest element, called by the consumer.
+  ///
+  /// @param[out] element  The element, unchanged if the queue is empty.
+  ///
+  /// @return     False if the queue is empty.
+  ///
+  common::types::bool8_t pop(T & element)
+  {
+    const auto head = m_head.load(std::memory_order_relaxed);
+    if (head == m_tail.load(std::memory_order_acquire)) {
+      return false;
+    }
+    element = m_elements[head % m_elements.size()];
+    m_head.store(head + 1U, std::memory_order_release);
+    return true;
+  }
+
+  /// @brief      Get the maximum number of elements in the queue.
+  std::size_t capacity() const noexcept {return m_elements.size();}
+
+private:
+  std::vector<T, Eigen::aligned_allocator<T>> m_elements;
+  /// Number of elements popped so far, written by the consumer only.
+  std::atomic<std::size_t> m_head{0U};
+  /// Keeps the two counters on separate cache lines, without over-aligning the queue.
+  char m_padding[64U]{};
+  /// Number of elements pushed so far, written by the producer only.
+  std::atomic<std::size_t> m_tail{0U};
+};
+
+}  // namespace state_estimation
+}  // namespace common
+}  // namespace autoware
+
+#endif  // STATE_ESTIMATION_NODES__INGEST_QUEUE_HPP_
@@ -28,10 +28,12 @@
 #include <geometry_msgs/msg/quaternion_stamped.hpp>
 #include <geometry_msgs/msg/twist_with_covariance_stamped.hpp>
 #include <measurement_conversion/measurement_transformation.hpp>
+#include <measurement_conversion/measurement_typedefs.hpp>
 #include <nav_msgs/msg/odometry.hpp>
 #include <rclcpp/publisher.hpp>
 #include <rclcpp/rclcpp.hpp>
 #include <rclcpp/subscription.hpp>
+#include <state_estimation_nodes/ingest_queue.hpp>
 #include <state_estimation_nodes/kalman_filter_wrapper.hpp>
 #include <state_estimation_nodes/visibility_control.hpp>
 
@@ -77,6 +79,12 @@ private:
   using RelativePosMsgT = autoware_auto_msgs::msg::RelativePositionWithCovarianceStamped;
   using TfMsgT = tf2_msgs::msg::TFMessage;
   using FilterWrapperT = ConstantAccelerationFilterWrapperXYZRPY;
+  using PoseMeasurementT = Stamped<PoseMeasurementXYZRPY32>;
+  using RelativePosMeasurementT = Stamped<PoseMeasurementXYZ32>;
+  template<typename MeasurementT>
+  using QueuesT = std::vector<std::unique_ptr<IngestQueue<MeasurementT>>>;
+  template<typename MeasurementT>
+  using MeasurementsT = std::vector<MeasurementT, Eigen::aligned_allocator<MeasurementT>>;
 
   template<std::int32_t kDim>
   using VectorT = Eigen::Matrix<autoware::common::types::float32_t, kDim, 1>;
@@ -93,6 +101,20 @@ private:
   ///
   void STATE_ESTIMATION_NODES_LOCAL relative_pos_callback(const RelativePosMsgT::SharedPtr msg);
 
+  /// Check the frame of a pose message and convert it to a measurement.
+  PoseMeasurementT STATE_ESTIMATION_NODES_LOCAL to_measurement(const PoseMsgT & msg) const;
+
+  /// Check the frames of a relative position message and convert it to a measurement.
+  RelativePosMeasurementT STATE_ESTIMATION_NODES_LOCAL to_measurement(
+    const RelativePosMsgT & msg) const;
+
+  /// Add a measurement to the filter history, or initialize the filter with it.
+  template<typename MeasurementT>
+  void STATE_ESTIMATION_NODES_LOCAL add_measurement(const MeasurementT & measurement);
+
+  /// Add the measurements in the ingest queues to the filter history in timestamp order.
+  void STATE_ESTIMATION_NODES_LOCAL drain_ingest_queues();
+
   /// Predict the state and publish the current estimate.
   void STATE_ESTIMATION_NODES_LOCAL predict_and_publish_current_state();
 
@@ -108,9 +130,27 @@ private:
     std::vector<typename rclcpp::Subscription<MessageT>::SharedPtr> * subscribers,
     CallbackFnT<MessageT> callback);
 
+  /// Create one subscription per topic, each with its own callback group that converts the
+  /// messages and pushes them to its own ingest queue.
+  template<typename MessageT, typename MeasurementT>
+  void create_queued_subscriptions(
+    const std::vector<std::string> & input_topics,
+    std::vector<typename rclcpp::Subscription<MessageT>::SharedPtr> * subscribers,
+    QueuesT<MeasurementT> * queues);
+
   std::vector<rclcpp::Subscription<PoseMsgT>::SharedPtr> m_pose_subscribers;
   std::vector<rclcpp::Subscription<RelativePosMsgT>::SharedPtr> m_relative_pos_subscribers;
 
+  /// Capacity of the ingest queue of each subscription, zero if the measurements are added to the
+  /// filter in the subscription callbacks.
+  std::size_t m_ingest_queue_size{};
+  std::vector<rclcpp::CallbackGroup::SharedPtr> m_ingest_callback_groups{};
+  QueuesT<PoseMeasurementT> m_pose_queues{};
+  QueuesT<RelativePosMeasurementT> m_relative_pos_queues{};
+  // Measurements taken from the queues, kept to reuse their memory.
+  MeasurementsT<PoseMeasurementT> m_drained_poses{};
+  MeasurementsT<RelativePosMeasurementT> m_drained_relative_positions{};
+
   std::shared_ptr<rclcpp::Publisher<OdomMsgT>> m_publisher{};
   std::shared_ptr<rclcpp::Publisher<TfMsgT>> m_tf_publisher{};
 
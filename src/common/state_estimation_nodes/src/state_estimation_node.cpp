@@ -28,10 +28,12 @@
 #include <tf2_eigen/tf2_eigen.h>
 #include <tf2_geometry_msgs/tf2_geometry_msgs.h>
 
+#include <algorithm>
 #include <functional>
 #include <limits>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 using autoware::common::types::float32_t;
@@ -115,6 +117,16 @@ StateEstimationNode::StateEstimationNode(
   m_publish_data_driven = declare_parameter("data_driven", false);
   const auto time_between_publish_requests{
     validate_publish_frequency(m_publish_frequency, m_publish_data_driven)};
+  const auto ingest_queue_size = declare_parameter("ingest_queue_size", 0);
+  if (ingest_queue_size < 0) {
+    throw std::domain_error("ingest_queue_size must not be negative.");
+  }
+  m_ingest_queue_size = static_cast<std::size_t>(ingest_queue_size);
+  if ((m_ingest_queue_size > 0U) && m_publish_data_driven) {
+    throw std::logic_error(
+            "The ingest queues are drained by the publish timer, please provide an "
+            "'output_frequency' setting to use them.");
+  }
   if (!m_publish_data_driven) {
     m_wall_timer = create_wall_timer(
       time_between_publish_requests,
@@ -146,12 +158,21 @@ StateEstimationNode::StateEstimationNode(
   if (input_pose_topics.empty() && input_relative_pos_topics.empty()) {
     throw std::runtime_error("No input topics provided. Make sure to set these in the param file.");
   }
-  create_subscriptions<PoseMsgT>(
-    input_pose_topics, &m_pose_subscribers, &StateEstimationNode::pose_callback);
-  create_subscriptions<RelativePosMsgT>(
-    input_relative_pos_topics,
-    &m_relative_pos_subscribers,
-    &StateEstimationNode::relative_pos_callback);
+  if (m_ingest_queue_size > 0U) {
+    create_queued_subscriptions<PoseMsgT>(
+      input_pose_topics, &m_pose_subscribers, &m_pose_queues);
+    create_queued_subscriptions<RelativePosMsgT>(
+      input_relative_pos_topics, &m_relative_pos_subscribers, &m_relative_pos_queues);
+    m_drained_poses.reserve(m_pose_queues.size() * m_ingest_queue_size);
+    m_drained_relative_positions.reserve(m_relative_pos_queues.size() * m_ingest_queue_size);
+  } else {
+    create_subscriptions<PoseMsgT>(
+      input_pose_topics, &m_pose_subscribers, &StateEstimationNode::pose_callback);
+    create_subscriptions<RelativePosMsgT>(
+      input_relative_pos_topics,
+      &m_relative_pos_subscribers,
+      &StateEstimationNode::relative_pos_callback);
+  }
 
   m_publisher = create_publisher<nav_msgs::msg::Odometry>(kDefaultOutputTopic, kDefaultHistory);
 
@@ -163,18 +184,7 @@ StateEstimationNode::StateEstimationNode(
 
 void StateEstimationNode::pose_callback(const PoseMsgT::SharedPtr msg)
 {
-  if (msg->header.frame_id != m_frame_id) {
-    throw std::runtime_error("Pose message frames don't match the expected ones.");
-  }
-  const auto measurement =
-    convert_to<Stamped<PoseMeasurementXYZRPY64>>::from(*msg).cast<float32_t>();
-  if (m_ekf->is_initialized()) {
-    if (!m_ekf->add_observation_to_history(measurement)) {
-      throw std::runtime_error("Cannot add a pose observation to history.");
-    }
-  } else {
-    m_ekf->add_reset_event_to_history(measurement);
-  }
+  add_measurement(to_measurement(*msg));
   if (m_publish_data_driven && m_ekf->is_initialized()) {
     publish_current_state();
   }
@@ -182,24 +192,81 @@ void StateEstimationNode::pose_callback(const PoseMsgT::SharedPtr msg)
 
 void StateEstimationNode::relative_pos_callback(const RelativePosMsgT::SharedPtr msg)
 {
-  if ((msg->header.frame_id != m_frame_id) || (msg->child_frame_id != m_child_frame_id)) {
+  add_measurement(to_measurement(*msg));
+  if (m_publish_data_driven && m_ekf->is_initialized()) {
+    publish_current_state();
+  }
+}
+
+StateEstimationNode::PoseMeasurementT StateEstimationNode::to_measurement(
+  const PoseMsgT & msg) const
+{
+  if (msg.header.frame_id != m_frame_id) {
+    throw std::runtime_error("Pose message frames don't match the expected ones.");
+  }
+  return convert_to<Stamped<PoseMeasurementXYZRPY64>>::from(msg).cast<float32_t>();
+}
+
+StateEstimationNode::RelativePosMeasurementT StateEstimationNode::to_measurement(
+  const RelativePosMsgT & msg) const
+{
+  if ((msg.header.frame_id != m_frame_id) || (msg.child_frame_id != m_child_frame_id)) {
     throw std::runtime_error("RelativePosition message frames don't match the expected ones.");
   }
-  const auto measurement = convert_to<Stamped<PoseMeasurementXYZ64>>::from(*msg).cast<float32_t>();
+  return convert_to<Stamped<PoseMeasurementXYZ64>>::from(msg).cast<float32_t>();
+}
+
+template<typename MeasurementT>
+void StateEstimationNode::add_measurement(const MeasurementT & measurement)
+{
   if (m_ekf->is_initialized()) {
     if (!m_ekf->add_observation_to_history(measurement)) {
-      throw std::runtime_error("Cannot add a relative pose observation to history.");
+      throw std::runtime_error("Cannot add an observation to history.");
     }
   } else {
     m_ekf->add_reset_event_to_history(measurement);
   }
-  if (m_publish_data_driven && m_ekf->is_initialized()) {
-    publish_current_state();
+}
+
+void StateEstimationNode::drain_ingest_queues()
+{
+  const auto drain = [](auto & queues, auto & measurements) {
+      measurements.clear();
+      for (auto & queue : queues) {
+        typename std::decay_t<decltype(measurements)>::value_type measurement;
+        while (queue->pop(measurement)) {
+          measurements.push_back(measurement);
+        }
+      }
+      std::stable_sort(
+        measurements.begin(), measurements.end(), [](const auto & lhs, const auto & rhs) {
+          return lhs.timestamp < rhs.timestamp;
+        });
+    };
+  drain(m_pose_queues, m_drained_poses);
+  drain(m_relative_pos_queues, m_drained_relative_positions);
+
+  // Merge the two sorted lists, so that no measurement is added before an older one.
+  auto pose = m_drained_poses.cbegin();
+  const auto poses_end = m_drained_poses.cend();
+  auto relative_pos = m_drained_relative_positions.cbegin();
+  const auto relative_positions_end = m_drained_relative_positions.cend();
+  while ((pose != poses_end) || (relative_pos != relative_positions_end)) {
+    if ((relative_pos == relative_positions_end) ||
+      ((pose != poses_end) && (pose->timestamp <= relative_pos->timestamp)))
+    {
+      add_measurement(*pose);
+      ++pose;
+    } else {
+      add_measurement(*relative_pos);
+      ++relative_pos;
+    }
   }
 }
 
 void StateEstimationNode::predict_and_publish_current_state()
 {
+  drain_ingest_queues();
   if (!m_ekf->is_initialized()) {return;}
   if (!m_ekf->add_next_temporal_update_to_history()) {
     throw std::runtime_error("Could not perform a temporal update.");
@@ -241,6 +308,32 @@ void StateEstimationNode::create_subscriptions(
   }
 }
 
+template<typename MessageT, typename MeasurementT>
+void StateEstimationNode::create_queued_subscriptions(
+  const std::vector<std::string> & input_topics,
+  std::vector<typename rclcpp::Subscription<MessageT>::SharedPtr> * subscribers,
+  QueuesT<MeasurementT> * queues)
+{
+  for (const auto & input_topic : input_topics) {
+    queues->emplace_back(std::make_unique<IngestQueue<MeasurementT>>(m_ingest_queue_size));
+    auto * const queue = queues->back().get();
+    m_ingest_callback_groups.emplace_back(
+      create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive));
+    rclcpp::SubscriptionOptions options{};
+    options.callback_group = m_ingest_callback_groups.back();
+    subscribers->emplace_back(
+      create_subscription<MessageT>(
+        input_topic, kDefaultHistory,
+        [this, queue, input_topic](const typename MessageT::SharedPtr msg) {
+          if (!queue->push(to_measurement(*msg))) {
+            RCLCPP_WARN(
+              get_logger(), "Ingest queue of %s is full, dropping a measurement.",
+              input_topic.c_str());
+          }
+        }, options));
+  }
+}
+
 template void StateEstimationNode::create_subscriptions<StateEstimationNode::PoseMsgT>(
   const std::vector<std::string> &,
   std::vector<rclcpp::Subscription<PoseMsgT>::SharedPtr> *,
@@ -249,6 +342,16 @@ template void StateEstimationNode::create_subscriptions<StateEstimationNode::Rel
   const std::vector<std::string> &,
   std::vector<rclcpp::Subscription<RelativePosMsgT>::SharedPtr> *,
   CallbackFnT<StateEstimationNode::RelativePosMsgT>);
+template void StateEstimationNode::create_queued_subscriptions<
+  StateEstimationNode::PoseMsgT, StateEstimationNode::PoseMeasurementT>(
+  const std::vector<std::string> &,
+  std::vector<rclcpp::Subscription<PoseMsgT>::SharedPtr> *,
+  QueuesT<PoseMeasurementT> *);
+template void StateEstimationNode::create_queued_subscriptions<
+  StateEstimationNode::RelativePosMsgT, StateEstimationNode::RelativePosMeasurementT>(
+  const std::vector<std::string> &,
+  std::vector<rclcpp::Subscription<RelativePosMsgT>::SharedPtr> *,
+  QueuesT<RelativePosMeasurementT> *);
 
 
 }  // namespace state_estimation
@@ -216,3 +216,68 @@ TEST(HistoryTest, exhaust_history) {
   }
   ASSERT_EQ(history_size, history.size());
 }
+
+namespace
+{
+/// A filter that counts the predictions and corrections applied since the last reset.
+class CountingFilter
+{
+public:
+  using State = FilterState;
+
+  State state() const {return m_state;}
+  State::Matrix covariance() const {return State::Matrix::Identity();}
+  void reset(const State & state, const State::Matrix &) {m_state = state;}
+  void predict(std::chrono::system_clock::duration) {m_state.vector()[0] += 1.0F;}
+  void correct(const Measurement &) {m_state.vector()[0] += 100.0F;}
+
+private:
+  State m_state{};
+};
+}  // namespace
+
+/// @test Test that late events are inserted in order once the history wrapped around and that the
+///       replay size is bounded.
+TEST(HistoryTest, bounded_replay) {
+  using HistoryT =
+    History<CountingFilter, PredictionEvent, ResetEvent<CountingFilter>, Measurement>;
+
+  const std::chrono::system_clock::time_point timestamp{std::chrono::system_clock::now()};
+  const std::chrono::system_clock::duration dt{std::chrono::milliseconds{10}};
+  const auto last_count = [](const HistoryT & history) {
+      return history.get_last_event().stored_state().vector()[0];
+    };
+  CountingFilter filter{};
+  HistoryT history{filter, 5U, 1.0E6F, 2U};
+  history.emplace_event(
+    timestamp, ResetEvent<CountingFilter>{FilterState{}, FilterState::Matrix::Identity()});
+  for (std::int32_t i = 1; i <= 7; ++i) {
+    history.emplace_event(timestamp + i * dt, PredictionEvent{});
+  }
+  ASSERT_EQ(history.size(), 5U);
+  EXPECT_EQ(history.get_last_timestamp(), timestamp + 7 * dt);
+  EXPECT_EQ(last_count(history), 7.0F);
+
+  // Replayed on top of the state after the sixth prediction, the oldest event is dropped.
+  const Measurement measurement{FilterState::Vector{1.0F}, FilterState::Matrix::Identity()};
+  history.emplace_event(timestamp + 6 * dt + dt / 2, measurement);
+  ASSERT_EQ(history.size(), 5U);
+  EXPECT_EQ(history.get_last_timestamp(), timestamp + 7 * dt);
+  EXPECT_EQ(last_count(history), 108.0F);
+
+  // Goes after the events with the same timestamp.
+  history.emplace_event(timestamp + 7 * dt, measurement);
+  EXPECT_EQ(last_count(history), 209.0F);
+
+  // Would replay more than two events, history is left unchanged.
+  EXPECT_THROW(history.emplace_event(timestamp + 5 * dt, measurement), std::runtime_error);
+  ASSERT_EQ(history.size(), 5U);
+  EXPECT_EQ(last_count(history), 209.0F);
+
+  // Older than the history, also rejected before anything is dropped.
+  EXPECT_THROW(history.emplace_event(timestamp, PredictionEvent{}), std::runtime_error);
+  ASSERT_EQ(history.size(), 5U);
+  history.emplace_event(timestamp + 8 * dt, PredictionEvent{});
+  EXPECT_EQ(history.size(), 5U);
+  EXPECT_EQ(last_count(history), 210.0F);
+}
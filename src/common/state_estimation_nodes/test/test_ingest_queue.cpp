@@ -0,0 +1,79 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <state_estimation_nodes/ingest_queue.hpp>
+
+#include <cstddef>
+#include <stdexcept>
+#include <thread>
+
+using autoware::common::state_estimation::IngestQueue;
+
+/// \test Check that elements come out in order and that a full queue rejects elements.
+TEST(IngestQueueTest, PushAndPop) {
+  EXPECT_THROW(IngestQueue<int>{0U}, std::domain_error);
+  IngestQueue<int> queue{3U};
+  EXPECT_EQ(queue.capacity(), 3U);
+  int element{-1};
+  EXPECT_FALSE(queue.pop(element));
+  EXPECT_EQ(element, -1);
+  // Wraps around the end of the storage.
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_TRUE(queue.push(2 * i));
+    EXPECT_TRUE(queue.push(2 * i + 1));
+    EXPECT_TRUE(queue.pop(element));
+    EXPECT_EQ(element, 2 * i);
+    EXPECT_TRUE(queue.pop(element));
+    EXPECT_EQ(element, 2 * i + 1);
+  }
+  EXPECT_FALSE(queue.pop(element));
+
+  IngestQueue<int> small{2U};
+  EXPECT_TRUE(small.push(1));
+  EXPECT_TRUE(small.push(2));
+  EXPECT_FALSE(small.push(3));
+  EXPECT_TRUE(small.pop(element));
+  EXPECT_EQ(element, 1);
+  EXPECT_TRUE(small.push(3));
+  EXPECT_TRUE(small.pop(element));
+  EXPECT_EQ(element, 2);
+  EXPECT_TRUE(small.pop(element));
+  EXPECT_EQ(element, 3);
+  EXPECT_FALSE(small.pop(element));
+}
+
+/// \test Check that nothing is lost or reordered between a producer and a consumer thread.
+TEST(IngestQueueTest, ProducerAndConsumerThreads) {
+  constexpr std::size_t kCount{10000U};
+  IngestQueue<std::size_t> queue{16U};
+  std::thread producer{[&queue]() {
+      for (std::size_t i = 0U; i < kCount; ++i) {
+        while (!queue.push(i)) {
+          std::this_thread::yield();
+        }
+      }
+    }};
+  std::size_t expected{0U};
+  std::size_t element{0U};
+  while (expected < kCount) {
+    if (queue.pop(element)) {
+      ASSERT_EQ(element, expected);
+      ++expected;
+    }
+  }
+  producer.join();
+  EXPECT_FALSE(queue.pop(element));
+}
@@ -37,6 +37,8 @@
 #include <Eigen/Core>
 #pragma GCC diagnostic pop
 
+#include <array>
+#include <cstddef>
 #include <tuple>
 
 namespace autoware
@@ -68,12 +70,20 @@ class STATE_VECTOR_PUBLIC GenericState
     sizeof...(VariableTs) > 0, "\n\nCannot create state without variables.\n\n");
   // Hide this under private to make sure it is never ODR-used.
   constexpr static std::int32_t kSize = sizeof...(VariableTs);
+  // Number of scalars in one SIMD packet of the fixed-size Eigen types.
+  constexpr static std::int32_t kPacketSize =
+    (EIGEN_MAX_STATIC_ALIGN_BYTES > sizeof(ScalarT)) ?
+    static_cast<std::int32_t>(EIGEN_MAX_STATIC_ALIGN_BYTES / sizeof(ScalarT)) : 1;
+  constexpr static std::int32_t kPaddedSize =
+    ((kSize + kPacketSize - 1) / kPacketSize) * kPacketSize;
 
 public:
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW
   using Variables = std::tuple<VariableTs...>;
   using Vector = Eigen::Matrix<ScalarT, kSize, 1>;
   using Matrix = Eigen::Matrix<ScalarT, kSize, kSize>;
+  /// A vector padded to a multiple of the SIMD packet size, which Eigen aligns and vectorizes.
+  using PaddedVector = Eigen::Matrix<ScalarT, kPaddedSize, 1>;
   using Scalar = ScalarT;
 
   ///
@@ -89,6 +99,18 @@ public:
   explicit GenericState(const Vector & vector)
   : m_state{vector} {}
 
+  ///
+  /// @brief      Constructs a new instance from a padded Eigen vector, ignoring the padding.
+  ///
+  /// @param[in]  vector  A padded Eigen vector.
+  ///
+  /// @return     The state with the first size() entries of the vector.
+  ///
+  inline static GenericState from_padded(const PaddedVector & vector) noexcept
+  {
+    return GenericState{Vector{vector.template head<kSize>()}};
+  }
+
   ///
   /// @brief      Get underlying Eigen vector.
   ///
@@ -102,6 +124,18 @@ public:
   ///
   inline const Vector & vector() const noexcept {return m_state;}
 
+  ///
+  /// @brief      Get the state as a padded Eigen vector.
+  ///
+  /// @return     A copy of the underlying vector with the padding set to zero.
+  ///
+  inline PaddedVector padded_vector() const noexcept
+  {
+    PaddedVector padded{PaddedVector::Zero()};
+    padded.template head<kSize>() = m_state;
+    return padded;
+  }
+
   ///
   /// @brief      Get an element of the vector.
   ///
@@ -225,6 +259,23 @@ public:
     return common::type_traits::index<VariableT, Variables>::value;
   }
 
+  ///
+  /// @brief      Get the indices of a number of variables in the state.
+  ///
+  /// @details    The table is computed at compile time, so it can be used to gather the entries of
+  ///             a subset of the variables without iterating over the variables at runtime.
+  ///
+  /// @tparam     OtherVariableTs  Variables from the state, e.g. the ones of another state.
+  ///
+  /// @return     An array with the index of every given variable in the state vector.
+  ///
+  template<typename ... OtherVariableTs>
+  inline constexpr static std::array<Eigen::Index, sizeof...(OtherVariableTs)> indices_of(
+    const std::tuple<OtherVariableTs...> &) noexcept
+  {
+    return {{index_of<OtherVariableTs>()...}};
+  }
+
   ///
   /// @brief      Get the size of the state.
   ///
@@ -234,6 +285,15 @@ public:
   ///
   inline constexpr static Eigen::Index size() noexcept {return kSize;}
 
+  ///
+  /// @brief      Get the size of the state padded to a multiple of the SIMD packet size.
+  ///
+  /// @details    Storing batches of states with this stride keeps every state aligned.
+  ///
+  /// @return     Number of scalars in a PaddedVector.
+  ///
+  inline constexpr static Eigen::Index padded_size() noexcept {return kPaddedSize;}
+
   /// @brief      Get a variables tuple used for iteration over all variables.
   inline constexpr static Variables variables() noexcept{return Variables{};}
 
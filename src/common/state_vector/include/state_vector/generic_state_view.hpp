@@ -0,0 +1,173 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \copyright Copyright 2021 the Autoware Foundation
+/// All rights reserved.
+/// \file
+/// \brief This file defines a view that accesses externally stored values as a generic state.
+
+#ifndef STATE_VECTOR__GENERIC_STATE_VIEW_HPP_
+#define STATE_VECTOR__GENERIC_STATE_VIEW_HPP_
+
+#include <common/type_traits.hpp>
+#include <state_vector/generic_state.hpp>
+#include <state_vector/visibility_control.hpp>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wold-style-cast"
+#pragma GCC diagnostic ignored "-Wsign-conversion"
+#pragma GCC diagnostic ignored "-Wconversion"
+#pragma GCC diagnostic ignored "-Wuseless-cast"
+#include <Eigen/Core>
+#pragma GCC diagnostic pop
+
+#include <type_traits>
+
+namespace autoware
+{
+namespace common
+{
+namespace state_vector
+{
+
+///
+/// @brief      A view of external memory as a state, without copying the values.
+///
+/// @details    The values of the state need not be contiguous, consecutive variables are `stride`
+///             scalars apart. This allows to access one state of a batch stored as structure of
+///             arrays, i.e., with one row of values per variable, by pointing to the first value of
+///             the state and using the length of the rows as the stride. For a batch of states
+///             stored one after another, use a stride of 1 and StateT::padded_size() scalars per
+///             state to keep all of them aligned.
+///
+/// @tparam     StateT  The type of the state. If it is const, the view is read-only.
+///
+template<typename StateT>
+class STATE_VECTOR_PUBLIC GenericStateView
+{
+  using MutableState = std::remove_const_t<StateT>;
+  static_assert(is_state<MutableState>::value, "\n\nStateT must be a GenericState.\n\n");
+  static constexpr bool kIsConst = std::is_const<StateT>::value;
+
+public:
+  using State = MutableState;
+  using Scalar = std::conditional_t<kIsConst, const typename State::Scalar,
+      typename State::Scalar>;
+  using Variables = typename State::Variables;
+  using VectorMap = Eigen::Map<
+    std::conditional_t<kIsConst, const typename State::Vector, typename State::Vector>,
+    Eigen::Unaligned, Eigen::InnerStride<>>;
+
+  ///
+  /// @brief      Constructs a new view.
+  ///
+  /// @param[in]  data    Pointer to the value of the first variable.
+  /// @param[in]  stride  Number of scalars between the values of two consecutive variables.
+  ///
+  explicit GenericStateView(Scalar * data, const Eigen::Index stride = 1) noexcept
+  : m_state{data, State::size(), Eigen::InnerStride<>{stride}} {}
+
+  ///
+  /// @brief      Write the values of a state into the viewed memory.
+  ///
+  /// @param[in]  state  The state to copy the values from.
+  ///
+  /// @return     A reference to this view.
+  ///
+  template<typename T = StateT, typename = std::enable_if_t<!std::is_const<T>::value>>
+  inline GenericStateView & operator=(const State & state) noexcept
+  {
+    m_state = state.vector();
+    return *this;
+  }
+
+  /// @brief      Get the viewed memory as an Eigen vector.
+  inline VectorMap & vector() noexcept {return m_state;}
+  /// @brief      Get the viewed memory as an Eigen vector.
+  inline const VectorMap & vector() const noexcept {return m_state;}
+
+  /// @brief      Get an element of the state by its index.
+  inline Scalar & operator[](const Eigen::Index idx) noexcept
+  {
+    return *(m_state.data() + idx * m_state.innerStride());
+  }
+  /// @brief      Get an element of the state by its index.
+  inline const Scalar & operator[](const Eigen::Index idx) const noexcept
+  {
+    return *(m_state.data() + idx * m_state.innerStride());
+  }
+
+  ///
+  /// @brief      Get the element at a given variable.
+  ///
+  /// @tparam     VariableT  A variable from the state.
+  ///
+  /// @return     A reference to the viewed value of this variable.
+  ///
+  template<typename VariableT>
+  inline Scalar & at() noexcept
+  {
+    return (*this)[State::template index_of<VariableT>()];
+  }
+  ///
+  /// @brief      Get the element at a given variable.
+  ///
+  /// @tparam     VariableT  A variable from the state.
+  ///
+  /// @return     A reference to the viewed value of this variable.
+  ///
+  template<typename VariableT>
+  inline Scalar & at(const VariableT) noexcept {return at<VariableT>();}
+  ///
+  /// @brief      Get the element at a given variable.
+  ///
+  /// @tparam     VariableT  A variable from the state.
+  ///
+  /// @return     A const reference to the viewed value of this variable.
+  ///
+  template<typename VariableT>
+  inline const Scalar & at() const noexcept
+  {
+    return (*this)[State::template index_of<VariableT>()];
+  }
+  ///
+  /// @brief      Get the element at a given variable.
+  ///
+  /// @tparam     VariableT  A variable from the state.
+  ///
+  /// @return     A const reference to the viewed value of this variable.
+  ///
+  template<typename VariableT>
+  inline const Scalar & at(const VariableT) const noexcept {return at<VariableT>();}
+
+  ///
+  /// @brief      Copy the viewed values into a state.
+  ///
+  /// @return     A new state with the viewed values.
+  ///
+  inline State state() const noexcept {return State{typename State::Vector{m_state}};}
+
+  /// @brief      Get the size of the state.
+  inline constexpr static Eigen::Index size() noexcept {return State::size();}
+
+private:
+  /// Map onto the viewed memory.
+  VectorMap m_state;
+};
+
+}  // namespace state_vector
+}  // namespace common
+}  // namespace autoware
+
+#endif  // STATE_VECTOR__GENERIC_STATE_VIEW_HPP_
@@ -0,0 +1,107 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \copyright Copyright 2021 the Autoware Foundation
+/// All rights reserved.
+/// \file
+/// \brief This file defines tests for the generic state view.
+
+#include <state_vector/generic_state.hpp>
+#include <state_vector/generic_state_view.hpp>
+
+#include <common/types.hpp>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <tuple>
+#include <vector>
+
+using autoware::common::state_vector::GenericState;
+using autoware::common::state_vector::GenericStateView;
+using autoware::common::state_vector::variable::X;
+using autoware::common::state_vector::variable::X_VELOCITY;
+using autoware::common::state_vector::variable::Y;
+using autoware::common::state_vector::variable::Y_VELOCITY;
+using autoware::common::state_vector::variable::YAW;
+using autoware::common::types::float32_t;
+using autoware::common::types::float64_t;
+using State5 = GenericState<float64_t, X, Y, YAW, X_VELOCITY, Y_VELOCITY>;
+
+/// @test Indices of a subset of variables are known at compile time.
+TEST(GenericStateViewTest, IndexTable) {
+  constexpr auto indices = State5::indices_of(std::tuple<Y_VELOCITY, X, YAW>{});
+  static_assert(indices.size() == 3U, "Wrong size of the index table.");
+  static_assert(indices[0U] == 4, "Wrong index.");
+  static_assert(indices[1U] == 0, "Wrong index.");
+  static_assert(indices[2U] == 2, "Wrong index.");
+  using StateXY = GenericState<float32_t, X, Y>;
+  constexpr auto all = StateXY::indices_of(StateXY::variables());
+  EXPECT_EQ((std::array<Eigen::Index, 2U>{{0, 1}}), all);
+}
+
+/// @test The padded size is a multiple of the packet size and round-trips the state.
+TEST(GenericStateViewTest, Padding) {
+  static_assert(State5::padded_size() >= State5::size(), "Padding must not shrink the state.");
+  static_assert(
+    (State5::padded_size() * static_cast<Eigen::Index>(sizeof(float64_t))) %
+    std::max(EIGEN_MAX_STATIC_ALIGN_BYTES, static_cast<int>(sizeof(float64_t))) == 0,
+    "Padded size is not a multiple of the alignment.");
+  const State5 state{{1.0, 2.0, 3.0, 4.0, 5.0}};
+  const auto padded = state.padded_vector();
+  EXPECT_EQ(padded.head<5>(), state.vector());
+  EXPECT_TRUE(padded.tail(State5::padded_size() - State5::size()).isZero());
+  EXPECT_EQ(State5::from_padded(padded), state);
+}
+
+/// @test Access one state of a batch stored as structure of arrays.
+TEST(GenericStateViewTest, StructureOfArrays) {
+  constexpr Eigen::Index kCount = 3;
+  // One row per variable, one column per state.
+  Eigen::Matrix<float64_t, 5, kCount, Eigen::RowMajor> rows;
+  rows.setZero();
+  for (Eigen::Index i = 0; i < 5; ++i) {
+    rows(i, 1) = static_cast<float64_t>(i + 1);
+  }
+
+  GenericStateView<State5> view{&rows(0, 1), kCount};
+  EXPECT_EQ(view.state(), (State5{{1.0, 2.0, 3.0, 4.0, 5.0}}));
+  EXPECT_DOUBLE_EQ(view.at<YAW>(), 3.0);
+  EXPECT_DOUBLE_EQ(view.at(Y_VELOCITY{}), 5.0);
+  EXPECT_DOUBLE_EQ(view[1], 2.0);
+
+  view.at<X>() = 42.0;
+  EXPECT_DOUBLE_EQ(rows(0, 1), 42.0);
+  view = State5{{6.0, 7.0, 8.0, 9.0, 10.0}};
+  EXPECT_DOUBLE_EQ(rows(4, 1), 10.0);
+  view.vector() *= 2.0;
+  EXPECT_DOUBLE_EQ(rows(2, 1), 16.0);
+  // The other states are untouched.
+  EXPECT_TRUE(rows.col(0).isZero());
+  EXPECT_TRUE(rows.col(2).isZero());
+
+  const GenericStateView<const State5> const_view{&rows(0, 1), kCount};
+  EXPECT_DOUBLE_EQ(const_view.at<Y>(), 14.0);
+  EXPECT_EQ(const_view.state(), view.state());
+}
+
+/// @test Access states stored one after another with the padded size.
+TEST(GenericStateViewTest, PaddedArray) {
+  std::vector<float64_t> data(static_cast<std::size_t>(2 * State5::padded_size()), 0.0);
+  GenericStateView<State5> second{data.data() + State5::padded_size()};
+  second = State5{{1.0, 2.0, 3.0, 4.0, 5.0}};
+  EXPECT_DOUBLE_EQ(data[static_cast<std::size_t>(State5::padded_size())], 1.0);
+  EXPECT_DOUBLE_EQ(data[static_cast<std::size_t>(State5::padded_size() + 4)], 5.0);
+  EXPECT_DOUBLE_EQ(data[0U], 0.0);
+}
@@ -0,0 +1,171 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief Parallel loops on a thread pool, which partition the range independently of the
+///        number of threads
+
+#ifndef THREAD_POOL__PARALLEL_HPP_
+#define THREAD_POOL__PARALLEL_HPP_
+
+#include <thread_pool/thread_pool.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+
+namespace autoware
+{
+namespace common
+{
+namespace thread_pool
+{
+/// \brief Maximum number of chunks of parallel_reduce, which bounds its stack usage
+static constexpr std::size_t kMaxReduceChunks = 64U;
+
+namespace details
+{
+/// \brief State shared by the runners of a parallel_for, so that their tasks stay small
+struct ParallelForState
+{
+  std::size_t begin;
+  std::size_t end;
+  std::size_t grain;
+  std::size_t num_chunks;
+  std::atomic<std::size_t> next_chunk;
+  std::atomic<bool8_t> failed;
+};
+
+/// \brief Number of chunks of at most grain indices in a non-empty range
+inline std::size_t num_chunks(const std::size_t size, const std::size_t grain)
+{
+  return ((size - 1U) / grain) + 1U;
+}
+}  // namespace details
+
+/// \brief Call fn(chunk_begin, chunk_end) for consecutive chunks of grain indices in
+///        [begin, end), in the calling thread and the workers of the pool. The chunks only depend
+///        on the range and the grain, but not which thread runs a chunk or in which order. If a
+///        chunk throws, the remaining chunks are skipped and the first exception is rethrown
+///        once all started chunks are done
+/// \param[in] pool The pool to run on, may also be used from one of its workers
+/// \param[in] begin First index
+/// \param[in] end One past the last index
+/// \param[in] grain Chunk size
+/// \param[in] fn Callable taking the begin and end of a chunk, is called concurrently
+/// \throws std::domain_error If the grain is zero
+template<typename Fn>
+void parallel_for(
+  ThreadPool & pool, const std::size_t begin, const std::size_t end, const std::size_t grain,
+  Fn && fn)
+{
+  if (0U == grain) {
+    throw std::domain_error{"parallel_for: grain must be positive"};
+  }
+  if (end <= begin) {
+    return;
+  }
+  details::ParallelForState state{begin, end, grain, details::num_chunks(end - begin, grain),
+    {0U}, {false}};
+  auto runner = [&state, &fn]() {
+      for (auto chunk = state.next_chunk++; (chunk < state.num_chunks) && (!state.failed.load());
+        chunk = state.next_chunk++)
+      {
+        const auto chunk_begin = state.begin + (chunk * state.grain);
+        const auto chunk_end =
+          ((state.end - chunk_begin) > state.grain) ? (chunk_begin + state.grain) : state.end;
+        try {
+          fn(chunk_begin, chunk_end);
+        } catch (...) {
+          state.failed = true;
+          throw;
+        }
+      }
+    };
+  TaskGroup group;
+  const auto num_runners = std::min(state.num_chunks, pool.size() + 1U);
+  for (std::size_t i = 1U; i < num_runners; ++i) {
+    pool.submit(group, runner);
+  }
+  std::exception_ptr error;
+  try {
+    runner();
+  } catch (...) {
+    error = std::current_exception();
+  }
+  // The runners reference this stack frame, so always wait for them
+  try {
+    pool.wait(group);
+  } catch (...) {
+    if (!error) {
+      error = std::current_exception();
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+/// \brief Reduce [begin, end) as reduce(...reduce(reduce(identity, map(c0)), map(c1))..., map(cn))
+///        over consecutive chunks c0...cn. The chunks are grain indices long, or longer if that
+///        would give more than kMaxReduceChunks. As the chunks and the order of the reduction
+///        only depend on the range and the grain, the result is bitwise identical for any number
+///        of threads, including for floating point sums
+/// \param[in] pool The pool to run on, may also be used from one of its workers
+/// \param[in] begin First index
+/// \param[in] end One past the last index
+/// \param[in] grain Minimum chunk size
+/// \param[in] identity The result for an empty range, and the start of the reduction
+/// \param[in] map Callable taking the begin and end of a chunk and returning its T, is called
+///                concurrently
+/// \param[in] reduce Callable combining two T, is called in the calling thread
+/// \tparam T A default constructible and copy assignable type
+/// \return The reduced value
+/// \throws std::domain_error If the grain is zero
+template<typename T, typename MapFn, typename ReduceFn>
+T parallel_reduce(
+  ThreadPool & pool, const std::size_t begin, const std::size_t end, const std::size_t grain,
+  const T & identity, MapFn && map, ReduceFn && reduce)
+{
+  if (0U == grain) {
+    throw std::domain_error{"parallel_reduce: grain must be positive"};
+  }
+  if (end <= begin) {
+    return identity;
+  }
+  const auto chunk_size =
+    std::max(grain, details::num_chunks(end - begin, kMaxReduceChunks));
+  std::array<T, kMaxReduceChunks> partials{};
+  parallel_for(
+    pool, begin, end, chunk_size,
+    [&partials, &map, begin, chunk_size](const std::size_t chunk_begin, const std::size_t chunk_end)
+    {
+      partials[(chunk_begin - begin) / chunk_size] = map(chunk_begin, chunk_end);
+    });
+  T result = identity;
+  const auto num_chunks = details::num_chunks(end - begin, chunk_size);
+  for (std::size_t chunk = 0U; chunk < num_chunks; ++chunk) {
+    result = reduce(result, partials[chunk]);
+  }
+  return result;
+}
+}  // namespace thread_pool
+}  // namespace common
+}  // namespace autoware
+
+#endif  // THREAD_POOL__PARALLEL_HPP_
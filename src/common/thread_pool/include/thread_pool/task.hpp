@@ -0,0 +1,158 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief A type erased task with inline storage, so that queueing it doesn't allocate
+
+#ifndef THREAD_POOL__TASK_HPP_
+#define THREAD_POOL__TASK_HPP_
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace autoware
+{
+namespace common
+{
+namespace thread_pool
+{
+class TaskGroup;
+
+/// \brief A callable without arguments and its task group, stored in place. Unlike
+///        std::function, a callable that doesn't fit fails to compile instead of being allocated
+class Task
+{
+public:
+  /// \brief The maximum size of a callable, e.g. a lambda capturing up to six pointers
+  static constexpr std::size_t kStorageSize = 48U;
+
+  /// \brief Constructor of an empty task
+  Task() noexcept = default;
+
+  /// \brief Constructor
+  /// \param[in] fn The callable, is moved into the task
+  /// \param[in] group The group that the task counts towards
+  /// \tparam F A callable type without arguments that fits into kStorageSize
+  template<typename F>
+  Task(F && fn, TaskGroup * const group)
+  : m_group{group}
+  {
+    using Fn = typename std::decay<F>::type;
+    static_assert(sizeof(Fn) <= kStorageSize, "Task: the callable is too large");
+    static_assert(alignof(Fn) <= alignof(std::max_align_t), "Task: the callable is overaligned");
+    static_assert(
+      std::is_nothrow_move_constructible<Fn>::value,
+      "Task: the callable must be nothrow move constructible");
+    (void)new (storage()) Fn(std::forward<F>(fn));
+    m_manager = &manage<Fn>;
+  }
+
+  /// \brief Move constructor, leaves the other task empty
+  Task(Task && other) noexcept
+  {
+    take(other);
+  }
+
+  /// \brief Move assignment, leaves the other task empty
+  Task & operator=(Task && other) noexcept
+  {
+    if (this != &other) {
+      reset();
+      take(other);
+    }
+    return *this;
+  }
+
+  Task(const Task &) = delete;
+  Task & operator=(const Task &) = delete;
+
+  /// \brief Destructor, destroys the callable
+  ~Task()
+  {
+    reset();
+  }
+
+  /// \brief Call the callable, the task must not be empty
+  void operator()()
+  {
+    m_manager(Operation::kInvoke, storage(), nullptr);
+  }
+
+  /// \brief Whether the task holds a callable
+  explicit operator bool() const noexcept {return nullptr != m_manager;}
+
+  /// \brief The group that the task counts towards
+  TaskGroup * group() const noexcept {return m_group;}
+
+  /// \brief Destroy the callable, the task is empty afterwards
+  void reset() noexcept
+  {
+    if (nullptr != m_manager) {
+      m_manager(Operation::kDestroy, storage(), nullptr);
+      m_manager = nullptr;
+    }
+    m_group = nullptr;
+  }
+
+private:
+  enum class Operation
+  {
+    kInvoke,
+    kMove,
+    kDestroy
+  };
+  using Manager = void (*)(Operation, void *, void *);
+
+  template<typename Fn>
+  static void manage(const Operation operation, void * const storage, void * const other)
+  {
+    auto & fn = *static_cast<Fn *>(storage);
+    switch (operation) {
+      case Operation::kInvoke:
+        fn();
+        break;
+      case Operation::kMove:
+        (void)new (other) Fn(std::move(fn));
+        fn.~Fn();
+        break;
+      case Operation::kDestroy:
+        fn.~Fn();
+        break;
+    }
+  }
+
+  void take(Task & other) noexcept
+  {
+    if (nullptr != other.m_manager) {
+      other.m_manager(Operation::kMove, other.storage(), storage());
+    }
+    m_manager = other.m_manager;
+    m_group = other.m_group;
+    other.m_manager = nullptr;
+    other.m_group = nullptr;
+  }
+
+  void * storage() noexcept {return static_cast<void *>(&m_storage[0U]);}
+
+  alignas(std::max_align_t) unsigned char m_storage[kStorageSize];
+  Manager m_manager{nullptr};
+  TaskGroup * m_group{nullptr};
+};
+}  // namespace thread_pool
+}  // namespace common
+}  // namespace autoware
+
+#endif  // THREAD_POOL__TASK_HPP_
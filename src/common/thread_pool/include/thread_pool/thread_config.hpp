@@ -0,0 +1,58 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief CPU affinity and real-time priority of threads
+
+#ifndef THREAD_POOL__THREAD_CONFIG_HPP_
+#define THREAD_POOL__THREAD_CONFIG_HPP_
+
+#include <thread_pool/visibility_control.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace autoware
+{
+namespace common
+{
+namespace thread_pool
+{
+/// \brief Check a thread configuration without applying it
+/// \param[in] cpus CPUs that a thread may run on, empty for any
+/// \param[in] priority SCHED_FIFO priority, 0 to keep the scheduling policy
+/// \throws std::domain_error If a CPU or the priority is out of range
+/// \throws std::runtime_error If affinity or priority aren't supported on this platform
+THREAD_POOL_PUBLIC void validate_thread_config(
+  const std::vector<std::size_t> & cpus,
+  int32_t priority);
+
+/// \brief Restrict a thread to a set of CPUs and set its SCHED_FIFO priority. Threads that it
+///        starts afterwards inherit both
+/// \param[in] thread The thread to configure
+/// \param[in] cpus CPUs that the thread may run on, empty to keep the affinity
+/// \param[in] priority SCHED_FIFO priority, 0 to keep the scheduling policy
+/// \throws std::domain_error If the configuration is invalid, see validate_thread_config()
+/// \throws std::runtime_error If affinity or priority can't be applied, e.g. due to missing
+///                            permissions
+THREAD_POOL_PUBLIC void configure_thread(
+  std::thread & thread, const std::vector<std::size_t> & cpus,
+  int32_t priority);
+}  // namespace thread_pool
+}  // namespace common
+}  // namespace autoware
+
+#endif  // THREAD_POOL__THREAD_CONFIG_HPP_
@@ -0,0 +1,167 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief A fixed size work stealing thread pool
+
+#ifndef THREAD_POOL__THREAD_POOL_HPP_
+#define THREAD_POOL__THREAD_POOL_HPP_
+
+#include <common/types.hpp>
+#include <thread_pool/task.hpp>
+#include <thread_pool/visibility_control.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace autoware
+{
+namespace common
+{
+namespace thread_pool
+{
+using autoware::common::types::bool8_t;
+
+/// \brief Configuration of a thread pool, which is applied when the pool is constructed
+struct THREAD_POOL_PUBLIC ThreadPoolConfig
+{
+  /// \brief Number of worker threads
+  std::size_t num_threads{1U};
+  /// \brief Maximum number of queued tasks per worker, a submit to a full queue runs the task
+  ///        in the submitting thread instead
+  std::size_t queue_capacity{256U};
+  /// \brief CPUs to pin the workers to, worker i is pinned to cpu_affinity[i % size]. Empty
+  ///        means that the workers are not pinned
+  std::vector<std::size_t> cpu_affinity{};
+  /// \brief SCHED_FIFO priority of the workers, 0 keeps the scheduling policy of the process
+  int32_t priority{0};
+};
+
+/// \brief A set of tasks that can be waited on together. A group must outlive its tasks
+class THREAD_POOL_PUBLIC TaskGroup
+{
+public:
+  TaskGroup() = default;
+  TaskGroup(const TaskGroup &) = delete;
+  TaskGroup & operator=(const TaskGroup &) = delete;
+
+  /// \brief Number of tasks which were submitted and haven't finished yet
+  std::size_t pending() const noexcept {return m_pending.load();}
+
+private:
+  friend class ThreadPool;
+
+  std::atomic<std::size_t> m_pending{0U};
+  std::mutex m_error_mutex;
+  std::exception_ptr m_error;
+};
+
+namespace details
+{
+/// \brief A bounded queue of tasks, the owning worker takes the newest task and other threads
+///        steal the oldest. All storage is allocated on construction
+class THREAD_POOL_PUBLIC WorkQueue
+{
+public:
+  /// \brief Constructor
+  /// \param[in] capacity Maximum number of queued tasks
+  explicit WorkQueue(std::size_t capacity);
+
+  /// \brief Add a task at the back
+  /// \return False if the queue is full, in which case the task is left untouched
+  bool8_t push(Task & task);
+  /// \brief Take the task at the back, for the owning worker
+  bool8_t pop(Task & task);
+  /// \brief Take the task at the front, for other threads
+  bool8_t steal(Task & task);
+
+private:
+  std::mutex m_mutex;
+  std::vector<Task> m_tasks;
+  std::size_t m_head{0U};
+  std::size_t m_size{0U};
+};
+}  // namespace details
+
+/// \brief A fixed number of worker threads, each with its own bounded task queue. Idle workers
+///        steal from the others, and a thread waiting on a task group runs queued tasks while it
+///        waits, so nested parallelism doesn't deadlock. Submitting doesn't allocate
+class THREAD_POOL_PUBLIC ThreadPool
+{
+public:
+  /// \brief Constructor, starts the workers
+  /// \param[in] config The configuration of the pool
+  /// \throws std::domain_error If there are no threads, no queue capacity, or the priority or a
+  ///                           CPU is out of range
+  /// \throws std::runtime_error If affinity or priority can't be applied, e.g. due to missing
+  ///                            permissions
+  explicit ThreadPool(const ThreadPoolConfig & config = ThreadPoolConfig{});
+  /// \brief Destructor, runs the remaining queued tasks and joins the workers
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool & operator=(const ThreadPool &) = delete;
+
+  /// \brief Number of worker threads
+  std::size_t size() const noexcept {return m_threads.size();}
+
+  /// \brief Queue a task. If called from a worker of this pool, it goes to the queue of that
+  ///        worker, otherwise the queues are used round robin. If that queue is full, the task
+  ///        is run right away in the calling thread
+  /// \param[in] group The group that the task counts towards
+  /// \param[in] fn A callable without arguments, see Task for the requirements
+  template<typename F>
+  void submit(TaskGroup & group, F && fn)
+  {
+    Task task{std::forward<F>(fn), &group};
+    (void)group.m_pending.fetch_add(1U);
+    if (!enqueue(task)) {
+      run(task);
+    }
+  }
+
+  /// \brief Block until all tasks of a group are done, running queued tasks in the meantime
+  /// \param[in] group The group to wait on, can be reused afterwards
+  /// \throws Rethrows the first exception thrown by a task of the group
+  void wait(TaskGroup & group);
+
+private:
+  bool8_t enqueue(Task & task);
+  bool8_t try_run_one();
+  void run(Task & task);
+  void work(std::size_t index);
+  void stop() noexcept;
+
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  /// \brief Number of queued tasks, can be briefly negative between a push and its count
+  std::atomic<std::ptrdiff_t> m_queued{0};
+  std::atomic<std::size_t> m_next_queue{0U};
+  bool8_t m_stop{false};
+  std::vector<std::unique_ptr<details::WorkQueue>> m_queues;
+  std::vector<std::thread> m_threads;
+};
+}  // namespace thread_pool
+}  // namespace common
+}  // namespace autoware
+
+#endif  // THREAD_POOL__THREAD_POOL_HPP_
@@ -0,0 +1,88 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "thread_pool/thread_config.hpp"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace autoware
+{
+namespace common
+{
+namespace thread_pool
+{
+
+void validate_thread_config(const std::vector<std::size_t> & cpus, const int32_t priority)
+{
+#if defined(__linux__)
+  for (const auto cpu : cpus) {
+    if (cpu >= static_cast<std::size_t>(CPU_SETSIZE)) {
+      throw std::domain_error{"Thread config: CPU " + std::to_string(cpu) + " is out of range"};
+    }
+  }
+  if ((0 != priority) &&
+    ((priority < sched_get_priority_min(SCHED_FIFO)) ||
+    (priority > sched_get_priority_max(SCHED_FIFO))))
+  {
+    throw std::domain_error{"Thread config: priority is out of the SCHED_FIFO range"};
+  }
+#else
+  if ((!cpus.empty()) || (0 != priority)) {
+    throw std::runtime_error{"Thread config: affinity and priority are only supported on Linux"};
+  }
+#endif
+}
+
+void configure_thread(
+  std::thread & thread, const std::vector<std::size_t> & cpus,
+  const int32_t priority)
+{
+  validate_thread_config(cpus, priority);
+#if defined(__linux__)
+  if (!cpus.empty()) {
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (const auto cpu : cpus) {
+      CPU_SET(cpu, &cpu_set);
+    }
+    const auto error = pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set), &cpu_set);
+    if (0 != error) {
+      throw std::runtime_error{
+              std::string{"Thread config: failed to set the affinity: "} + std::strerror(error)};
+    }
+  }
+  if (0 != priority) {
+    sched_param param{};
+    param.sched_priority = priority;
+    const auto error = pthread_setschedparam(thread.native_handle(), SCHED_FIFO, &param);
+    if (0 != error) {
+      throw std::runtime_error{
+              std::string{"Thread config: failed to set the priority: "} + std::strerror(error)};
+    }
+  }
+#else
+  (void)thread;
+#endif
+}
+
+}  // namespace thread_pool
+}  // namespace common
+}  // namespace autoware
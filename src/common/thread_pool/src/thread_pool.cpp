@@ -0,0 +1,215 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "thread_pool/thread_pool.hpp"
+#include "thread_pool/thread_config.hpp"
+
+#include <stdexcept>
+
+namespace autoware
+{
+namespace common
+{
+namespace thread_pool
+{
+
+namespace
+{
+/// The pool that the current thread is a worker of, if any
+thread_local const ThreadPool * t_pool{nullptr};
+/// The index of the current thread in t_pool
+thread_local std::size_t t_index{0U};
+
+}  // namespace
+
+namespace details
+{
+WorkQueue::WorkQueue(const std::size_t capacity)
+: m_tasks(capacity)
+{
+}
+
+bool8_t WorkQueue::push(Task & task)
+{
+  std::lock_guard<std::mutex> lock{m_mutex};
+  if (m_size == m_tasks.size()) {
+    return false;
+  }
+  m_tasks[(m_head + m_size) % m_tasks.size()] = std::move(task);
+  ++m_size;
+  return true;
+}
+
+bool8_t WorkQueue::pop(Task & task)
+{
+  std::lock_guard<std::mutex> lock{m_mutex};
+  if (0U == m_size) {
+    return false;
+  }
+  --m_size;
+  task = std::move(m_tasks[(m_head + m_size) % m_tasks.size()]);
+  return true;
+}
+
+bool8_t WorkQueue::steal(Task & task)
+{
+  std::lock_guard<std::mutex> lock{m_mutex};
+  if (0U == m_size) {
+    return false;
+  }
+  task = std::move(m_tasks[m_head]);
+  m_head = (m_head + 1U) % m_tasks.size();
+  --m_size;
+  return true;
+}
+}  // namespace details
+
+ThreadPool::ThreadPool(const ThreadPoolConfig & config)
+{
+  if (0U == config.num_threads) {
+    throw std::domain_error{"ThreadPool: needs at least one thread"};
+  }
+  if (0U == config.queue_capacity) {
+    throw std::domain_error{"ThreadPool: needs a queue capacity of at least one task"};
+  }
+  validate_thread_config(config.cpu_affinity, config.priority);
+  m_queues.reserve(config.num_threads);
+  for (std::size_t i = 0U; i < config.num_threads; ++i) {
+    m_queues.emplace_back(std::make_unique<details::WorkQueue>(config.queue_capacity));
+  }
+  m_threads.reserve(config.num_threads);
+  try {
+    for (std::size_t i = 0U; i < config.num_threads; ++i) {
+      m_threads.emplace_back(&ThreadPool::work, this, i);
+      // Each worker gets one CPU
+      const auto cpus = config.cpu_affinity.empty() ? std::vector<std::size_t>{} :
+        std::vector<std::size_t>{config.cpu_affinity[i % config.cpu_affinity.size()]};
+      configure_thread(m_threads.back(), cpus, config.priority);
+    }
+  } catch (...) {
+    stop();
+    throw;
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  stop();
+}
+
+void ThreadPool::wait(TaskGroup & group)
+{
+  while (0U != group.m_pending.load()) {
+    if (!try_run_one()) {
+      std::unique_lock<std::mutex> lock{m_mutex};
+      m_cv.wait(lock, [this, &group] {
+          return (0U == group.m_pending.load()) || (m_queued.load() > 0);
+        });
+    }
+  }
+  std::exception_ptr error;
+  {
+    std::lock_guard<std::mutex> lock{group.m_error_mutex};
+    std::swap(error, group.m_error);
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+bool8_t ThreadPool::enqueue(Task & task)
+{
+  const auto index = (this == t_pool) ? t_index : (m_next_queue++ % m_queues.size());
+  if (!m_queues[index]->push(task)) {
+    return false;
+  }
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    ++m_queued;
+  }
+  m_cv.notify_one();
+  return true;
+}
+
+bool8_t ThreadPool::try_run_one()
+{
+  Task task;
+  const auto num_queues = m_queues.size();
+  const auto is_worker = (this == t_pool);
+  const auto start = is_worker ? t_index : 0U;
+  auto found = is_worker && m_queues[start]->pop(task);
+  for (std::size_t i = 1U; (!found) && (i <= num_queues); ++i) {
+    found = m_queues[(start + i) % num_queues]->steal(task);
+  }
+  if (!found) {
+    return false;
+  }
+  --m_queued;
+  run(task);
+  return true;
+}
+
+void ThreadPool::run(Task & task)
+{
+  TaskGroup * const group = task.group();
+  try {
+    task();
+  } catch (...) {
+    std::lock_guard<std::mutex> lock{group->m_error_mutex};
+    if (!group->m_error) {
+      group->m_error = std::current_exception();
+    }
+  }
+  // Destroy the callable before the group is released, the waiter may return right after
+  task.reset();
+  if (1U == group->m_pending.fetch_sub(1U)) {
+    // Taking the lock orders the notification after the predicate check of a waiter
+    { std::lock_guard<std::mutex> lock{m_mutex}; }
+    m_cv.notify_all();
+  }
+}
+
+void ThreadPool::work(const std::size_t index)
+{
+  t_pool = this;
+  t_index = index;
+  while (true) {
+    if (try_run_one()) {
+      continue;
+    }
+    std::unique_lock<std::mutex> lock{m_mutex};
+    m_cv.wait(lock, [this] {return m_stop || (m_queued.load() > 0);});
+    if (m_stop && (m_queued.load() <= 0)) {
+      break;
+    }
+  }
+}
+
+void ThreadPool::stop() noexcept
+{
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_stop = true;
+  }
+  m_cv.notify_all();
+  for (auto & thread : m_threads) {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+}
+
+}  // namespace thread_pool
+}  // namespace common
+}  // namespace autoware
@@ -0,0 +1,213 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <thread_pool/parallel.hpp>
+#include <thread_pool/thread_config.hpp>
+#include <thread_pool/thread_pool.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using autoware::common::thread_pool::TaskGroup;
+using autoware::common::thread_pool::ThreadPool;
+using autoware::common::thread_pool::ThreadPoolConfig;
+using autoware::common::thread_pool::configure_thread;
+using autoware::common::thread_pool::parallel_for;
+using autoware::common::thread_pool::parallel_reduce;
+
+namespace
+{
+ThreadPoolConfig make_config(const std::size_t num_threads, const std::size_t queue_capacity = 256U)
+{
+  ThreadPoolConfig config;
+  config.num_threads = num_threads;
+  config.queue_capacity = queue_capacity;
+  return config;
+}
+}  // namespace
+
+TEST(TestThreadPool, RunsAllTasks)
+{
+  ThreadPool pool{make_config(4U)};
+  EXPECT_EQ(pool.size(), 4U);
+  std::atomic<std::size_t> count{0U};
+  TaskGroup group;
+  for (std::size_t i = 0U; i < 1000U; ++i) {
+    pool.submit(group, [&count]() {++count;});
+  }
+  pool.wait(group);
+  EXPECT_EQ(group.pending(), 0U);
+  EXPECT_EQ(count.load(), 1000U);
+  // A group can be reused
+  pool.submit(group, [&count]() {++count;});
+  pool.wait(group);
+  EXPECT_EQ(count.load(), 1001U);
+}
+
+TEST(TestThreadPool, FullQueueRunsInline)
+{
+  ThreadPool pool{make_config(1U, 1U)};
+  std::atomic<bool> release{false};
+  std::atomic<std::size_t> count{0U};
+  TaskGroup group;
+  // Keep the only worker busy, so that its queue fills up
+  pool.submit(group, [&release]() {while (!release.load()) {}});
+  for (std::size_t i = 0U; i < 10U; ++i) {
+    pool.submit(group, [&count]() {++count;});
+  }
+  EXPECT_GE(count.load(), 8U);
+  release = true;
+  pool.wait(group);
+  EXPECT_EQ(count.load(), 10U);
+}
+
+TEST(TestThreadPool, RethrowsTaskException)
+{
+  ThreadPool pool{make_config(2U)};
+  std::atomic<std::size_t> count{0U};
+  TaskGroup group;
+  for (std::size_t i = 0U; i < 10U; ++i) {
+    pool.submit(
+      group, [&count, i]() {
+        ++count;
+        if (3U == i) {
+          throw std::runtime_error{"task failed"};
+        }
+      });
+  }
+  EXPECT_THROW(pool.wait(group), std::runtime_error);
+  EXPECT_EQ(count.load(), 10U);
+  // The error is cleared by the wait
+  pool.submit(group, []() {});
+  EXPECT_NO_THROW(pool.wait(group));
+}
+
+TEST(TestThreadPool, RejectsInvalidConfig)
+{
+  EXPECT_THROW(ThreadPool{make_config(0U)}, std::domain_error);
+  EXPECT_THROW(ThreadPool{make_config(1U, 0U)}, std::domain_error);
+  auto config = make_config(1U);
+  config.cpu_affinity = {100000U};
+  EXPECT_THROW(ThreadPool{config}, std::domain_error);
+  config = make_config(1U);
+  config.priority = -1;
+  EXPECT_THROW(ThreadPool{config}, std::domain_error);
+}
+
+TEST(TestThreadPool, PinsToCpu)
+{
+  auto config = make_config(2U);
+  config.cpu_affinity = {0U};
+  ThreadPool pool{config};
+  std::atomic<std::size_t> count{0U};
+  parallel_for(pool, 0U, 100U, 1U, [&count](std::size_t, std::size_t) {++count;});
+  EXPECT_EQ(count.load(), 100U);
+}
+
+TEST(TestThreadConfig, ConfiguresThread)
+{
+  std::thread thread{[]() {}};
+  EXPECT_NO_THROW(configure_thread(thread, {0U}, 0));
+  EXPECT_THROW(configure_thread(thread, {0U, 100000U}, 0), std::domain_error);
+  thread.join();
+}
+
+TEST(TestParallelFor, CoversRangeOnce)
+{
+  ThreadPool pool{make_config(3U)};
+  std::vector<std::size_t> hits(1003U, 0U);
+  parallel_for(
+    pool, 2U, 1001U, 10U, [&hits](const std::size_t begin, const std::size_t end) {
+      EXPECT_LE(end - begin, 10U);
+      EXPECT_EQ((begin - 2U) % 10U, 0U);
+      for (auto i = begin; i < end; ++i) {
+        ++hits[i];
+      }
+    });
+  for (std::size_t i = 0U; i < hits.size(); ++i) {
+    EXPECT_EQ(hits[i], ((i >= 2U) && (i < 1001U)) ? 1U : 0U) << i;
+  }
+  // Empty range
+  parallel_for(pool, 5U, 5U, 1U, [](std::size_t, std::size_t) {FAIL();});
+  EXPECT_THROW(
+    parallel_for(pool, 0U, 1U, 0U, [](std::size_t, std::size_t) {}), std::domain_error);
+}
+
+TEST(TestParallelFor, Nested)
+{
+  ThreadPool pool{make_config(2U, 4U)};
+  std::atomic<std::size_t> count{0U};
+  parallel_for(
+    pool, 0U, 16U, 1U, [&pool, &count](std::size_t, std::size_t) {
+      parallel_for(
+        pool, 0U, 64U, 4U, [&count](const std::size_t begin, const std::size_t end) {
+          count += end - begin;
+        });
+    });
+  EXPECT_EQ(count.load(), 16U * 64U);
+}
+
+TEST(TestParallelFor, Throws)
+{
+  ThreadPool pool{make_config(2U)};
+  EXPECT_THROW(
+    parallel_for(
+      pool, 0U, 1000U, 1U, [](const std::size_t begin, std::size_t) {
+        if (500U == begin) {
+          throw std::out_of_range{"chunk failed"};
+        }
+      }), std::out_of_range);
+}
+
+TEST(TestParallelReduce, DeterministicSum)
+{
+  // Summands of very different magnitude, so that the result depends on the order of the sum
+  std::vector<float> values(100000U);
+  for (std::size_t i = 0U; i < values.size(); ++i) {
+    values[i] = (0U == (i % 7U)) ? 1.0e6F : (0.1F + static_cast<float>(i % 13U));
+  }
+  const auto sum = [&values](const std::size_t num_threads) {
+      ThreadPool pool{make_config(num_threads)};
+      return parallel_reduce(
+        pool, 0U, values.size(), 100U, 0.0F,
+        [&values](const std::size_t begin, const std::size_t end) {
+          auto partial = 0.0F;
+          for (auto i = begin; i < end; ++i) {
+            partial += values[i];
+          }
+          return partial;
+        },
+        [](const float a, const float b) {return a + b;});
+    };
+  const auto reference = sum(1U);
+  for (std::size_t num_threads = 1U; num_threads <= 4U; ++num_threads) {
+    for (std::size_t repeat = 0U; repeat < 10U; ++repeat) {
+      EXPECT_EQ(sum(num_threads), reference);
+    }
+  }
+  EXPECT_NEAR(reference, 1.43e10F, 1.0e8F);
+}
+
+TEST(TestParallelReduce, EmptyRange)
+{
+  ThreadPool pool{make_config(1U)};
+  const auto result = parallel_reduce(
+    pool, 3U, 3U, 1U, 42, [](std::size_t, std::size_t) {return 0;},
+    [](const int a, const int b) {return a + b;});
+  EXPECT_EQ(result, 42);
+}
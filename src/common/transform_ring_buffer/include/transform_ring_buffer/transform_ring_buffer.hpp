@@ -0,0 +1,136 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief A lock-free, time-indexed buffer of the transforms between one pair of frames
+
+#ifndef TRANSFORM_RING_BUFFER__TRANSFORM_RING_BUFFER_HPP_
+#define TRANSFORM_RING_BUFFER__TRANSFORM_RING_BUFFER_HPP_
+
+#include <common/types.hpp>
+#include <transform_ring_buffer/visibility_control.hpp>
+
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace autoware
+{
+namespace common
+{
+namespace transform_ring_buffer
+{
+using autoware::common::types::bool8_t;
+using autoware::common::types::float64_t;
+
+/// \brief A rigid transform at a point in time
+struct TRANSFORM_RING_BUFFER_PUBLIC StampedTransform
+{
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  std::chrono::system_clock::time_point stamp{};
+  Eigen::Vector3d translation{Eigen::Vector3d::Zero()};
+  Eigen::Quaterniond rotation{Eigen::Quaterniond::Identity()};
+
+  /// \brief Get the transform as an isometry, e.g. to transform points
+  Eigen::Isometry3d isometry() const noexcept;
+};
+
+/// \brief Interpolate between two transforms, linearly for the translation and with a spherical
+///        linear interpolation for the rotation
+/// \param[in] a The transform at the time of a
+/// \param[in] b The transform at the time of b
+/// \param[in] stamp The time to interpolate at, clamped to the stamps of a and b
+/// \return The interpolated transform at the given time
+TRANSFORM_RING_BUFFER_PUBLIC StampedTransform interpolate(
+  const StampedTransform & a,
+  const StampedTransform & b,
+  std::chrono::system_clock::time_point stamp) noexcept;
+
+/// \brief A fixed size buffer of the most recent transforms between one pair of frames, sorted by
+///        time, that is filled by one thread and can be read by any number of threads without
+///        locks. Lookups are a binary search over the stamps and an interpolation between the two
+///        neighbouring transforms, i.e. O(log n) without any allocation or string comparison.
+///        Every entry is protected by a sequence counter: a reader that sees an entry change
+///        while reading it retries the lookup, so readers never block the writer
+class TRANSFORM_RING_BUFFER_PUBLIC TransformRingBuffer
+{
+public:
+  /// \brief Constructor
+  /// \param[in] capacity The number of transforms to keep, at least 2
+  /// \throw std::domain_error If the capacity is less than 2
+  explicit TransformRingBuffer(std::size_t capacity);
+
+  /// \brief Add a transform, overwriting the oldest one if the buffer is full. Must only be called
+  ///        from one thread at a time
+  /// \param[in] transform The transform, must be newer than all transforms in the buffer
+  /// \return False if the transform is not newer than the latest one, in which case it is dropped
+  bool8_t push(const StampedTransform & transform) noexcept;
+
+  /// \brief Get the transform at a point in time, interpolated between the buffered transforms.
+  ///        There is no extrapolation, the stamp must be within the buffered time span
+  /// \param[in] stamp The point in time
+  /// \param[out] transform The transform at this time, unchanged on failure
+  /// \return False if the stamp is outside of the buffered time span
+  bool8_t lookup(std::chrono::system_clock::time_point stamp, StampedTransform & transform) const
+  noexcept;
+
+  /// \brief Get the most recent transform
+  /// \param[out] transform The latest transform, unchanged on failure
+  /// \return False if the buffer is empty
+  bool8_t latest(StampedTransform & transform) const noexcept;
+
+  /// \brief The number of transforms that the buffer keeps
+  std::size_t capacity() const noexcept;
+
+  /// \brief The number of transforms that were added since construction
+  std::size_t count() const noexcept;
+
+private:
+  /// An entry of the ring, all fields are atomics so that concurrent reads are well-defined
+  struct Slot
+  {
+    /// Twice the number of completed writes, odd while a write is in progress
+    std::atomic<std::size_t> sequence{0U};
+    std::atomic<std::int64_t> stamp_ns{0};
+    /// Translation x, y, z, then rotation x, y, z, w
+    std::array<std::atomic<float64_t>, 7U> values{};
+  };
+
+  /// Read the stamp of the index-th transform added, false if it was overwritten meanwhile
+  bool8_t read_stamp(std::size_t index, std::int64_t & stamp_ns) const noexcept;
+  /// Read the index-th transform added, false if it was overwritten meanwhile
+  bool8_t read(std::size_t index, StampedTransform & transform) const noexcept;
+  /// One attempt of a lookup, false with retry set if it raced with the writer
+  bool8_t try_lookup(
+    std::chrono::system_clock::time_point stamp, StampedTransform & transform,
+    bool8_t & retry) const noexcept;
+  /// The sequence value of a slot after the index-th transform has been written to it
+  std::size_t sequence_after_write(std::size_t index) const noexcept;
+
+  std::size_t m_capacity;
+  std::unique_ptr<Slot[]> m_slots;
+  /// Number of transforms added, written by the writer only
+  std::atomic<std::size_t> m_count{0U};
+};
+}  // namespace transform_ring_buffer
+}  // namespace common
+}  // namespace autoware
+
+#endif  // TRANSFORM_RING_BUFFER__TRANSFORM_RING_BUFFER_HPP_
@@ -0,0 +1,82 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief Fills a TransformRingBuffer from the transforms published on a tf topic
+
+#ifndef TRANSFORM_RING_BUFFER__TRANSFORM_RING_LISTENER_HPP_
+#define TRANSFORM_RING_BUFFER__TRANSFORM_RING_LISTENER_HPP_
+
+#include <geometry_msgs/msg/transform_stamped.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <tf2_msgs/msg/tf_message.hpp>
+#include <transform_ring_buffer/transform_ring_buffer.hpp>
+#include <transform_ring_buffer/visibility_control.hpp>
+
+#include <cstddef>
+#include <string>
+
+namespace autoware
+{
+namespace common
+{
+namespace transform_ring_buffer
+{
+/// \brief Convert a transform message
+TRANSFORM_RING_BUFFER_PUBLIC StampedTransform from_message(
+  const geometry_msgs::msg::TransformStamped & msg) noexcept;
+
+/// \brief Subscribes once to a tf topic and buffers the transforms of one frame pair, so that
+///        high-rate consumers can look them up without the mutex and the frame name lookups of
+///        tf2_ros::Buffer. Only the transforms that are published directly between the two frames
+///        are buffered, there is no chaining over intermediate frames. Static transforms should
+///        still be looked up once with tf2_ros.
+class TRANSFORM_RING_BUFFER_PUBLIC TransformRingListener
+{
+public:
+  /// \brief Constructor
+  /// \param[in] node The node that owns the subscription. The callback must not run concurrently
+  ///                 with itself, i.e. it must not be in a reentrant callback group
+  /// \param[in] target_frame The frame_id of the buffered transforms
+  /// \param[in] source_frame The child_frame_id of the buffered transforms
+  /// \param[in] capacity The number of transforms to keep
+  /// \param[in] topic The topic to subscribe to
+  /// \throw std::domain_error If the capacity is less than 2
+  TransformRingListener(
+    rclcpp::Node & node,
+    const std::string & target_frame,
+    const std::string & source_frame,
+    std::size_t capacity,
+    const std::string & topic = "/tf");
+
+  TransformRingListener(const TransformRingListener &) = delete;
+  TransformRingListener & operator=(const TransformRingListener &) = delete;
+
+  /// \brief The buffered transforms, can be read from any thread
+  const TransformRingBuffer & buffer() const noexcept;
+
+private:
+  void on_transforms(const tf2_msgs::msg::TFMessage & msg);
+
+  std::string m_target_frame;
+  std::string m_source_frame;
+  TransformRingBuffer m_buffer;
+  rclcpp::Logger m_logger;
+  rclcpp::Subscription<tf2_msgs::msg::TFMessage>::SharedPtr m_subscription;
+};
+}  // namespace transform_ring_buffer
+}  // namespace common
+}  // namespace autoware
+
+#endif  // TRANSFORM_RING_BUFFER__TRANSFORM_RING_LISTENER_HPP_
@@ -0,0 +1,38 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef TRANSFORM_RING_BUFFER__VISIBILITY_CONTROL_HPP_
+#define TRANSFORM_RING_BUFFER__VISIBILITY_CONTROL_HPP_
+
+////////////////////////////////////////////////////////////////////////////////
+#if defined(__WIN32)
+  #if defined(TRANSFORM_RING_BUFFER_BUILDING_DLL) || defined(TRANSFORM_RING_BUFFER_EXPORTS)
+    #define TRANSFORM_RING_BUFFER_PUBLIC __declspec(dllexport)
+    #define TRANSFORM_RING_BUFFER_LOCAL
+  #else  // defined(TRANSFORM_RING_BUFFER_BUILDING_DLL) || defined(TRANSFORM_RING_BUFFER_EXPORTS)
+    #define TRANSFORM_RING_BUFFER_PUBLIC __declspec(dllimport)
+    #define TRANSFORM_RING_BUFFER_LOCAL
+  #endif  // defined(TRANSFORM_RING_BUFFER_BUILDING_DLL) || defined(TRANSFORM_RING_BUFFER_EXPORTS)
+#elif defined(__linux__)
+  #define TRANSFORM_RING_BUFFER_PUBLIC __attribute__((visibility("default")))
+  #define TRANSFORM_RING_BUFFER_LOCAL __attribute__((visibility("hidden")))
+#elif defined(__APPLE__)
+  #define TRANSFORM_RING_BUFFER_PUBLIC __attribute__((visibility("default")))
+  #define TRANSFORM_RING_BUFFER_LOCAL __attribute__((visibility("hidden")))
+#else  // defined(__linux__)
+  #error "Unsupported Build Configuration"
+#endif  // defined(__WIN32)
+
+#endif  // TRANSFORM_RING_BUFFER__VISIBILITY_CONTROL_HPP_
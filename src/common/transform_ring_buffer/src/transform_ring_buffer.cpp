@@ -0,0 +1,260 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "transform_ring_buffer/transform_ring_buffer.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace autoware
+{
+namespace common
+{
+namespace transform_ring_buffer
+{
+namespace
+{
+/// A lookup that raced with the writer is retried, this bounds the time spent in a lookup when the
+/// writer keeps overwriting the entries that are searched
+constexpr std::size_t kMaxAttempts = 3U;
+
+std::int64_t to_nanoseconds(const std::chrono::system_clock::time_point stamp) noexcept
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(stamp.time_since_epoch()).count();
+}
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+Eigen::Isometry3d StampedTransform::isometry() const noexcept
+{
+  Eigen::Isometry3d ret{Eigen::Isometry3d::Identity()};
+  ret.linear() = rotation.toRotationMatrix();
+  ret.translation() = translation;
+  return ret;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+StampedTransform interpolate(
+  const StampedTransform & a,
+  const StampedTransform & b,
+  const std::chrono::system_clock::time_point stamp) noexcept
+{
+  if (b.stamp <= a.stamp) {
+    return a;
+  }
+  using Seconds = std::chrono::duration<float64_t>;
+  const auto span = std::chrono::duration_cast<Seconds>(b.stamp - a.stamp).count();
+  const auto elapsed = std::chrono::duration_cast<Seconds>(stamp - a.stamp).count();
+  const auto t = std::min(std::max(elapsed / span, 0.0), 1.0);
+  StampedTransform ret{};
+  ret.stamp = std::min(std::max(stamp, a.stamp), b.stamp);
+  ret.translation = a.translation + (t * (b.translation - a.translation));
+  ret.rotation = a.rotation.slerp(t, b.rotation);
+  return ret;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TransformRingBuffer::TransformRingBuffer(const std::size_t capacity)
+: m_capacity{capacity}
+{
+  if (capacity < 2U) {
+    throw std::domain_error{"TransformRingBuffer: The capacity must be at least 2"};
+  }
+  m_slots = std::make_unique<Slot[]>(capacity);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool8_t TransformRingBuffer::push(const StampedTransform & transform) noexcept
+{
+  const auto count = m_count.load(std::memory_order_relaxed);
+  const auto stamp_ns = to_nanoseconds(transform.stamp);
+  if (count > 0U) {
+    // Only this thread writes, so the latest entry cannot change while reading it
+    std::int64_t latest_ns{};
+    (void)read_stamp(count - 1U, latest_ns);
+    if (stamp_ns <= latest_ns) {
+      return false;
+    }
+  }
+  const Eigen::Quaterniond rotation = transform.rotation.normalized();
+  auto & slot = m_slots[count % m_capacity];
+  const auto sequence = slot.sequence.load(std::memory_order_relaxed);
+  slot.sequence.store(sequence + 1U, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.stamp_ns.store(stamp_ns, std::memory_order_relaxed);
+  slot.values[0U].store(transform.translation.x(), std::memory_order_relaxed);
+  slot.values[1U].store(transform.translation.y(), std::memory_order_relaxed);
+  slot.values[2U].store(transform.translation.z(), std::memory_order_relaxed);
+  slot.values[3U].store(rotation.x(), std::memory_order_relaxed);
+  slot.values[4U].store(rotation.y(), std::memory_order_relaxed);
+  slot.values[5U].store(rotation.z(), std::memory_order_relaxed);
+  slot.values[6U].store(rotation.w(), std::memory_order_relaxed);
+  slot.sequence.store(sequence + 2U, std::memory_order_release);
+  m_count.store(count + 1U, std::memory_order_release);
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool8_t TransformRingBuffer::lookup(
+  const std::chrono::system_clock::time_point stamp,
+  StampedTransform & transform) const noexcept
+{
+  for (std::size_t attempt = 0U; attempt < kMaxAttempts; ++attempt) {
+    bool8_t retry = false;
+    if (try_lookup(stamp, transform, retry)) {
+      return true;
+    }
+    if (!retry) {
+      return false;
+    }
+  }
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool8_t TransformRingBuffer::latest(StampedTransform & transform) const noexcept
+{
+  for (std::size_t attempt = 0U; attempt < kMaxAttempts; ++attempt) {
+    const auto count = m_count.load(std::memory_order_acquire);
+    if (0U == count) {
+      return false;
+    }
+    if (read(count - 1U, transform)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::size_t TransformRingBuffer::capacity() const noexcept
+{
+  return m_capacity;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::size_t TransformRingBuffer::count() const noexcept
+{
+  return m_count.load(std::memory_order_acquire);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::size_t TransformRingBuffer::sequence_after_write(const std::size_t index) const noexcept
+{
+  return 2U * ((index / m_capacity) + 1U);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool8_t TransformRingBuffer::read_stamp(
+  const std::size_t index,
+  std::int64_t & stamp_ns) const noexcept
+{
+  const auto & slot = m_slots[index % m_capacity];
+  const auto expected = sequence_after_write(index);
+  if (slot.sequence.load(std::memory_order_acquire) != expected) {
+    return false;
+  }
+  const auto value = slot.stamp_ns.load(std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (slot.sequence.load(std::memory_order_relaxed) != expected) {
+    return false;
+  }
+  stamp_ns = value;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool8_t TransformRingBuffer::read(
+  const std::size_t index,
+  StampedTransform & transform) const noexcept
+{
+  const auto & slot = m_slots[index % m_capacity];
+  const auto expected = sequence_after_write(index);
+  if (slot.sequence.load(std::memory_order_acquire) != expected) {
+    return false;
+  }
+  const auto stamp_ns = slot.stamp_ns.load(std::memory_order_relaxed);
+  std::array<float64_t, 7U> values{};
+  for (std::size_t i = 0U; i < values.size(); ++i) {
+    values[i] = slot.values[i].load(std::memory_order_relaxed);
+  }
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (slot.sequence.load(std::memory_order_relaxed) != expected) {
+    return false;
+  }
+  transform.stamp = std::chrono::system_clock::time_point{} +
+    std::chrono::duration_cast<std::chrono::system_clock::duration>(
+    std::chrono::nanoseconds{stamp_ns});
+  transform.translation = Eigen::Vector3d{values[0U], values[1U], values[2U]};
+  transform.rotation = Eigen::Quaterniond{values[6U], values[3U], values[4U], values[5U]};
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool8_t TransformRingBuffer::try_lookup(
+  const std::chrono::system_clock::time_point stamp,
+  StampedTransform & transform,
+  bool8_t & retry) const noexcept
+{
+  retry = false;
+  const auto stamp_ns = to_nanoseconds(stamp);
+  const auto count = m_count.load(std::memory_order_acquire);
+  if (0U == count) {
+    return false;
+  }
+  const auto oldest = (count > m_capacity) ? (count - m_capacity) : std::size_t{0U};
+  // Find the first transform that is not older than the stamp
+  auto low = oldest;
+  auto high = count;
+  while (low < high) {
+    const auto mid = low + ((high - low) / 2U);
+    std::int64_t mid_ns{};
+    if (!read_stamp(mid, mid_ns)) {
+      retry = true;
+      return false;
+    }
+    if (mid_ns < stamp_ns) {
+      low = mid + 1U;
+    } else {
+      high = mid;
+    }
+  }
+  if (low == count) {
+    // Newer than the latest transform
+    return false;
+  }
+  StampedTransform after{};
+  if (!read(low, after)) {
+    retry = true;
+    return false;
+  }
+  if (to_nanoseconds(after.stamp) == stamp_ns) {
+    transform = after;
+    return true;
+  }
+  if (low == oldest) {
+    // Older than the oldest transform
+    return false;
+  }
+  StampedTransform before{};
+  if (!read(low - 1U, before)) {
+    retry = true;
+    return false;
+  }
+  transform = interpolate(before, after, stamp);
+  return true;
+}
+}  // namespace transform_ring_buffer
+}  // namespace common
+}  // namespace autoware
@@ -0,0 +1,80 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "transform_ring_buffer/transform_ring_listener.hpp"
+
+#include <time_utils/time_utils.hpp>
+
+#include <string>
+
+namespace autoware
+{
+namespace common
+{
+namespace transform_ring_buffer
+{
+////////////////////////////////////////////////////////////////////////////////
+StampedTransform from_message(const geometry_msgs::msg::TransformStamped & msg) noexcept
+{
+  StampedTransform ret{};
+  ret.stamp = time_utils::from_message(msg.header.stamp);
+  const auto & t = msg.transform.translation;
+  const auto & q = msg.transform.rotation;
+  ret.translation = Eigen::Vector3d{t.x, t.y, t.z};
+  ret.rotation = Eigen::Quaterniond{q.w, q.x, q.y, q.z};
+  return ret;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+TransformRingListener::TransformRingListener(
+  rclcpp::Node & node,
+  const std::string & target_frame,
+  const std::string & source_frame,
+  const std::size_t capacity,
+  const std::string & topic)
+: m_target_frame{target_frame},
+  m_source_frame{source_frame},
+  m_buffer{capacity},
+  m_logger{node.get_logger()},
+  m_subscription{node.create_subscription<tf2_msgs::msg::TFMessage>(
+      topic, rclcpp::QoS{100U},
+      [this](const tf2_msgs::msg::TFMessage::SharedPtr msg) {on_transforms(*msg);})}
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const TransformRingBuffer & TransformRingListener::buffer() const noexcept
+{
+  return m_buffer;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TransformRingListener::on_transforms(const tf2_msgs::msg::TFMessage & msg)
+{
+  for (const auto & transform : msg.transforms) {
+    if ((transform.header.frame_id != m_target_frame) ||
+      (transform.child_frame_id != m_source_frame))
+    {
+      continue;
+    }
+    if (!m_buffer.push(from_message(transform))) {
+      RCLCPP_WARN(
+        m_logger, "Dropping a transform from %s to %s that is not newer than the latest one",
+        m_source_frame.c_str(), m_target_frame.c_str());
+    }
+  }
+}
+}  // namespace transform_ring_buffer
+}  // namespace common
+}  // namespace autoware
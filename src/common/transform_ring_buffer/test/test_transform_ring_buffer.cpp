@@ -0,0 +1,147 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <transform_ring_buffer/transform_ring_buffer.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using autoware::common::transform_ring_buffer::StampedTransform;
+using autoware::common::transform_ring_buffer::TransformRingBuffer;
+using autoware::common::transform_ring_buffer::interpolate;
+using autoware::common::types::bool8_t;
+using autoware::common::types::float64_t;
+using std::chrono::milliseconds;
+
+namespace
+{
+const std::chrono::system_clock::time_point kStart{std::chrono::seconds{1000LL}};
+
+// Moves along x with 1 m/s and turns with 1 rad/s
+StampedTransform make_transform(const milliseconds t)
+{
+  const auto s = std::chrono::duration_cast<std::chrono::duration<float64_t>>(t).count();
+  StampedTransform ret{};
+  ret.stamp = kStart + t;
+  ret.translation = Eigen::Vector3d{s, 1.0, 0.0};
+  ret.rotation = Eigen::Quaterniond{Eigen::AngleAxisd{s, Eigen::Vector3d::UnitZ()}};
+  return ret;
+}
+
+void expect_near(const StampedTransform & expected, const StampedTransform & actual)
+{
+  EXPECT_EQ(expected.stamp, actual.stamp);
+  EXPECT_TRUE(expected.translation.isApprox(actual.translation, 1.0E-9)) <<
+    actual.translation.transpose();
+  EXPECT_NEAR(expected.rotation.angularDistance(actual.rotation), 0.0, 1.0E-9);
+}
+}  // namespace
+
+TEST(TransformRingBufferTest, Interpolate) {
+  const auto a = make_transform(milliseconds{0LL});
+  const auto b = make_transform(milliseconds{1000LL});
+  expect_near(make_transform(milliseconds{250LL}), interpolate(a, b, kStart + milliseconds{250LL}));
+  // Clamped to the interval
+  expect_near(b, interpolate(a, b, kStart + milliseconds{2000LL}));
+  expect_near(a, interpolate(a, b, kStart - milliseconds{1LL}));
+  const auto isometry = interpolate(a, b, kStart + milliseconds{500LL}).isometry();
+  const Eigen::Vector3d point = isometry * Eigen::Vector3d::UnitX();
+  EXPECT_NEAR(point.x(), 0.5 + std::cos(0.5), 1.0E-9);
+  EXPECT_NEAR(point.y(), 1.0 + std::sin(0.5), 1.0E-9);
+}
+
+TEST(TransformRingBufferTest, Lookup) {
+  EXPECT_THROW(TransformRingBuffer{1U}, std::domain_error);
+  TransformRingBuffer buffer{4U};
+  StampedTransform result{};
+  EXPECT_FALSE(buffer.lookup(kStart, result));
+  EXPECT_FALSE(buffer.latest(result));
+
+  EXPECT_TRUE(buffer.push(make_transform(milliseconds{0LL})));
+  EXPECT_TRUE(buffer.lookup(kStart, result));
+  expect_near(make_transform(milliseconds{0LL}), result);
+  EXPECT_FALSE(buffer.lookup(kStart + milliseconds{1LL}, result));
+
+  for (auto i = 1LL; i < 10LL; ++i) {
+    EXPECT_TRUE(buffer.push(make_transform(milliseconds{100LL * i})));
+  }
+  // Not newer than the latest transform
+  EXPECT_FALSE(buffer.push(make_transform(milliseconds{900LL})));
+  EXPECT_FALSE(buffer.push(make_transform(milliseconds{500LL})));
+  EXPECT_EQ(buffer.count(), 10U);
+  EXPECT_EQ(buffer.capacity(), 4U);
+
+  // Only the transforms from 600 ms to 900 ms are left
+  EXPECT_FALSE(buffer.lookup(kStart + milliseconds{599LL}, result));
+  EXPECT_FALSE(buffer.lookup(kStart + milliseconds{901LL}, result));
+  for (const auto t : {600LL, 650LL, 700LL, 777LL, 899LL, 900LL}) {
+    ASSERT_TRUE(buffer.lookup(kStart + milliseconds{t}, result)) << t;
+    expect_near(make_transform(milliseconds{t}), result);
+  }
+  ASSERT_TRUE(buffer.latest(result));
+  expect_near(make_transform(milliseconds{900LL}), result);
+}
+
+TEST(TransformRingBufferTest, ConcurrentReaders) {
+  constexpr auto kCount = 20000LL;
+  TransformRingBuffer buffer{16U};
+  (void)buffer.push(make_transform(milliseconds{0LL}));
+  std::atomic<bool8_t> done{false};
+  std::atomic<std::size_t> num_started{0U};
+  std::atomic<std::size_t> num_wrong{0U};
+  const auto read = [&]() {
+      ++num_started;
+      while (!done.load()) {
+        StampedTransform latest{};
+        if (!buffer.latest(latest)) {
+          continue;
+        }
+        // Somewhere within the last few transforms
+        const auto stamp = latest.stamp - milliseconds{5LL};
+        StampedTransform result{};
+        if (buffer.lookup(stamp, result)) {
+          const auto expected = make_transform(
+            std::chrono::duration_cast<milliseconds>(stamp - kStart));
+          if (!expected.translation.isApprox(result.translation, 1.0E-9)) {
+            ++num_wrong;
+          }
+        }
+      }
+    };
+  std::vector<std::thread> readers;
+  for (auto i = 0; i < 3; ++i) {
+    readers.emplace_back(read);
+  }
+  while (num_started.load() < readers.size()) {
+    std::this_thread::yield();
+  }
+  for (auto i = 1LL; i < kCount; ++i) {
+    EXPECT_TRUE(buffer.push(make_transform(milliseconds{i})));
+  }
+  done = true;
+  for (auto & reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(num_wrong.load(), 0U);
+  StampedTransform result{};
+  ASSERT_TRUE(buffer.lookup(kStart + milliseconds{kCount - 10LL}, result));
+  expect_near(make_transform(milliseconds{kCount - 10LL}), result);
+  EXPECT_EQ(buffer.count(), static_cast<std::size_t>(kCount));
+}
@@ -18,9 +18,17 @@
 #include <tvm_vendor/tvm/runtime/packed_func.h>
 #include <tvm_vendor/tvm/runtime/registry.h>
 
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
 #include <fstream>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -46,17 +54,19 @@ public:
     TVMArrayAlloc(
       &shape[0], shape.size(), dtype_code, dtype_bits, dtype_lanes, device_type,
       device_id, &x);
-    handle_ = std::make_shared<TVMArrayHandle>(x);
+    handle_ = std::shared_ptr<TVMArrayHandle>(
+      new TVMArrayHandle(x), [](TVMArrayHandle * ptr) {
+        if (*ptr) {
+          TVMArrayFree(*ptr);
+        }
+        delete ptr;
+      });
   }
 
-  TVMArrayHandle getArray() const {return *handle_.get();}
+  TVMArrayHandle getArray() const {return handle_ ? *handle_.get() : nullptr;}
 
 private:
-  std::shared_ptr<TVMArrayHandle> handle_{nullptr, [](TVMArrayHandle ptr) {
-      if (ptr) {
-        TVMArrayFree(ptr);
-      }
-    }};
+  std::shared_ptr<TVMArrayHandle> handle_{};
 };
 
 using TVMArrayContainerVector = std::vector<TVMArrayContainer>;
@@ -257,6 +267,8 @@ public:
           config.tvm_dtype_bits, config.tvm_dtype_lanes,
           kDLCPU, 0));
     }
+
+    allocate_batch_buffers();
   }
 
   TVMArrayContainerVector schedule(const TVMArrayContainerVector & input)
@@ -282,14 +294,456 @@ public:
     return output_;
   }
 
+  /**
+   * @brief Run the network once on a batch of inputs. The network must be
+   * compiled for a batch size, which is the leading dimension of all its
+   * input and output shapes in the configuration. The samples are packed
+   * into preallocated batch tensors on the inference device and the outputs
+   * are split into a preallocated pool of tensors on the CPU, so no tensor
+   * is allocated per call.
+   *
+   * @param inputs One set of network inputs per sample, each shaped like
+   * the network inputs with a leading dimension of 1. At most batch_size()
+   * samples, the remaining samples of the batch are computed on stale data
+   * and not returned.
+   * @return One set of network outputs per input, each shaped like the
+   * network outputs with a leading dimension of 1. The tensors are owned by
+   * the engine and overwritten by the next call.
+   */
+  std::vector<TVMArrayContainerVector> schedule_batch(
+    const std::vector<TVMArrayContainerVector> & inputs)
+  {
+    if (inputs.empty() || (inputs.size() > batch_size_)) {
+      throw std::runtime_error(
+              "number of inputs must be between 1 and the batch size of " +
+              std::to_string(batch_size_));
+    }
+
+    // Pack the samples into the batch input(s)
+    for (uint32_t index = 0; index < batch_input_.size(); ++index) {
+      for (std::size_t sample = 0; sample < inputs.size(); ++sample) {
+        if ((inputs[sample].size() != batch_input_.size()) ||
+          (inputs[sample][index].getArray() == nullptr))
+        {
+          throw std::runtime_error("input variable is null");
+        }
+        DLTensor view = sample_view(
+          batch_input_[index], sample_input_shapes_[index], sample_input_bytes_[index], sample);
+        check(TVMArrayCopyFromTo(inputs[sample][index].getArray(), &view, nullptr));
+      }
+      set_input(config_.network_inputs[index].first.c_str(), batch_input_[index].getArray());
+    }
+
+    // Execute the inference
+    execute();
+
+    // Split the batch output(s) into the output pool
+    for (uint32_t index = 0; index < output_.size(); ++index) {
+      get_output(index, output_[index].getArray());
+      for (std::size_t sample = 0; sample < inputs.size(); ++sample) {
+        DLTensor view = sample_view(
+          output_[index], sample_output_shapes_[index], sample_output_bytes_[index], sample);
+        check(TVMArrayCopyFromTo(&view, output_pool_[sample][index].getArray(), nullptr));
+      }
+    }
+    return std::vector<TVMArrayContainerVector>(
+      output_pool_.begin(), output_pool_.begin() + static_cast<std::ptrdiff_t>(inputs.size()));
+  }
+
+  /**
+   * @brief The number of samples the network computes in one run, 1 if the
+   * network inputs and outputs do not share a leading dimension.
+   */
+  std::size_t batch_size() const {return batch_size_;}
+
 private:
+  static void check(int result)
+  {
+    if (result != 0) {
+      throw std::runtime_error(TVMGetLastError());
+    }
+  }
+
+  // Non-owning tensor for one sample of a batch tensor
+  static DLTensor sample_view(
+    const TVMArrayContainer & batch, std::vector<int64_t> & sample_shape,
+    uint64_t sample_bytes, std::size_t sample)
+  {
+    DLTensor view = *batch.getArray();
+    view.shape = sample_shape.data();
+    view.byte_offset += sample_bytes * sample;
+    return view;
+  }
+
+  // Shape of one sample of a batched node and its size in bytes
+  std::vector<int64_t> sample_shape(const NetworkNode & node, uint64_t & sample_bytes) const
+  {
+    auto shape = node.second;
+    sample_bytes = (config_.tvm_dtype_bits * config_.tvm_dtype_lanes + 7U) / 8U;
+    for (std::size_t dim = 1; dim < shape.size(); ++dim) {
+      sample_bytes *= static_cast<uint64_t>(shape[dim]);
+    }
+    if (!shape.empty()) {
+      shape[0] = 1;
+    }
+    return shape;
+  }
+
+  void allocate_batch_buffers()
+  {
+    // The batch size is the leading dimension shared by all inputs and outputs
+    batch_size_ = 1U;
+    if (!config_.network_inputs.empty() && !config_.network_inputs[0].second.empty()) {
+      const auto leading = config_.network_inputs[0].second[0];
+      bool shared = leading > 1;
+      for (auto nodes : {&config_.network_inputs, &config_.network_outputs}) {
+        for (auto & node : *nodes) {
+          shared = shared && !node.second.empty() && (node.second[0] == leading);
+        }
+      }
+      if (shared) {
+        batch_size_ = static_cast<std::size_t>(leading);
+      }
+    }
+
+    for (auto & input_config : config_.network_inputs) {
+      batch_input_.push_back(
+        TVMArrayContainer(
+          input_config.second, config_.tvm_dtype_code,
+          config_.tvm_dtype_bits, config_.tvm_dtype_lanes,
+          config_.tvm_device_type, config_.tvm_device_id));
+      uint64_t bytes{};
+      sample_input_shapes_.push_back(sample_shape(input_config, bytes));
+      sample_input_bytes_.push_back(bytes);
+    }
+    for (auto & output_config : config_.network_outputs) {
+      uint64_t bytes{};
+      sample_output_shapes_.push_back(sample_shape(output_config, bytes));
+      sample_output_bytes_.push_back(bytes);
+    }
+
+    output_pool_.resize(batch_size_);
+    for (auto & sample_outputs : output_pool_) {
+      for (auto & shape : sample_output_shapes_) {
+        sample_outputs.push_back(
+          TVMArrayContainer(
+            shape, config_.tvm_dtype_code,
+            config_.tvm_dtype_bits, config_.tvm_dtype_lanes,
+            kDLCPU, 0));
+      }
+    }
+  }
+
   InferenceEngineTVMConfig config_;
   TVMArrayContainerVector output_;
+  // Preallocated tensors of the batched schedule
+  std::size_t batch_size_{1U};
+  TVMArrayContainerVector batch_input_;
+  std::vector<std::vector<int64_t>> sample_input_shapes_;
+  std::vector<std::vector<int64_t>> sample_output_shapes_;
+  std::vector<uint64_t> sample_input_bytes_;
+  std::vector<uint64_t> sample_output_bytes_;
+  std::vector<TVMArrayContainerVector> output_pool_;
   tvm::runtime::PackedFunc set_input;
   tvm::runtime::PackedFunc execute;
   tvm::runtime::PackedFunc get_output;
 };
 
+/**
+ * @class BoundedQueue
+ * @brief A blocking first-in first-out queue with a fixed capacity, used to
+ * pass data between the threads of the AsyncPipeline.
+ *
+ * @tparam T The type of the queued items, may be move-only.
+ */
+template<class T>
+class BoundedQueue
+{
+public:
+  /**
+   * @brief Construct a new BoundedQueue object
+   *
+   * @param capacity The maximum number of queued items, at least 1
+   */
+  explicit BoundedQueue(std::size_t capacity)
+  : capacity_(capacity)
+  {
+    if (capacity == 0U) {
+      throw std::runtime_error("queue capacity must be at least 1");
+    }
+  }
+
+  /**
+   * @brief Add an item to the back of the queue, blocking while it is full.
+   *
+   * @param item The item to add
+   * @return False if the queue was closed, in which case the item is dropped
+   */
+  bool push(T item)
+  {
+    std::unique_lock<std::mutex> lock{mutex_};
+    not_full_.wait(lock, [this] {return closed_ || (items_.size() < capacity_);});
+    if (closed_) {
+      return false;
+    }
+    items_.push_back(std::move(item));
+    lock.unlock();
+    not_empty_.notify_one();
+    return true;
+  }
+
+  /**
+   * @brief Take the item from the front of the queue, blocking while it is
+   * empty.
+   *
+   * @param item The item taken from the queue, unchanged on failure
+   * @return False if the queue was closed and all items were taken
+   */
+  bool pop(T & item)
+  {
+    std::unique_lock<std::mutex> lock{mutex_};
+    not_empty_.wait(lock, [this] {return closed_ || !items_.empty();});
+    if (items_.empty()) {
+      return false;
+    }
+    item = std::move(items_.front());
+    items_.pop_front();
+    lock.unlock();
+    not_full_.notify_one();
+    return true;
+  }
+
+  /**
+   * @brief Close the queue. No more items are accepted, the queued items can
+   * still be taken and blocked calls return.
+   */
+  void close()
+  {
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      closed_ = true;
+    }
+    not_full_.notify_all();
+    not_empty_.notify_all();
+  }
+
+private:
+  std::size_t capacity_;
+  std::deque<T> items_{};
+  bool closed_{false};
+  std::mutex mutex_{};
+  std::condition_variable not_full_{};
+  std::condition_variable not_empty_{};
+};
+
+/**
+ * @brief Copy the data of a set of tensors into another set of tensors of
+ * the same shapes and data types, possibly on another device.
+ *
+ * @param from The tensors to copy from
+ * @param to The tensors to copy into
+ */
+inline void copy_tensors(const TVMArrayContainerVector & from, const TVMArrayContainerVector & to)
+{
+  if (from.size() != to.size()) {
+    throw std::runtime_error("number of tensors does not match the network configuration");
+  }
+  for (std::size_t index = 0; index < from.size(); ++index) {
+    if (from[index].getArray() == nullptr) {
+      throw std::runtime_error("tensor to copy is null");
+    }
+    if (TVMArrayCopyFromTo(from[index].getArray(), to[index].getArray(), nullptr) != 0) {
+      throw std::runtime_error(TVMGetLastError());
+    }
+  }
+}
+
+/**
+ * @class AsyncPipeline
+ * @brief Inference Pipeline which runs each of its 3 stages in its own thread,
+ * so that consecutive inputs are processed concurrently: while the inference
+ * engine runs on one input, the pre-processor already works on the next one
+ * and the post-processor on the previous one. The throughput is then bound
+ * by the slowest stage instead of the sum of all stages.
+ *
+ * The tensors passed between the stages are copied into buffers owned by the
+ * pipeline, of which there are several sets per stage boundary. A stage
+ * writes into one set while the next stage reads from another, so stages can
+ * keep reusing their own output tensors. Every stage is only ever called from
+ * its own thread and does not need to be thread-safe. The buffers are shaped
+ * after the network inputs and outputs of the InferenceEngineTVMConfig and
+ * the engine outputs are placed on the CPU, as in InferenceEngineTVM.
+ */
+template<class PreProcessorType, class InferenceEngineType, class PostProcessorType>
+class AsyncPipeline
+{
+  using InputType = decltype(std::declval<PreProcessorType>().input_type_indicator_);
+  using OutputType = decltype(std::declval<PostProcessorType>().output_type_indicator_);
+
+public:
+  /**
+   * @brief Construct a new AsyncPipeline object and start its threads
+   *
+   * @param pre_processor a PreProcessor object
+   * @param inference_engine a InferenceEngine object
+   * @param post_processor a PostProcessor object
+   * @param config The configuration of the network, used to allocate the
+   * buffers between the stages
+   * @param num_buffers The number of buffer sets per stage boundary, at
+   * least 1. 2 lets every stage work while the next one reads, more absorb
+   * jitter in the stage times at the cost of memory and latency.
+   */
+  AsyncPipeline(
+    PreProcessorType pre_processor, InferenceEngineType inference_engine,
+    PostProcessorType post_processor, const InferenceEngineTVMConfig & config,
+    std::size_t num_buffers = 2U)
+  : pre_processor_(pre_processor), post_processor_(post_processor),
+    inference_engine_(inference_engine), input_queue_(num_buffers),
+    inference_queue_(num_buffers), post_queue_(num_buffers),
+    free_input_buffers_(num_buffers), free_output_buffers_(num_buffers)
+  {
+    for (std::size_t slot = 0; slot < num_buffers; ++slot) {
+      input_buffers_.push_back(allocate(config.network_inputs, config,
+        config.tvm_device_type, config.tvm_device_id));
+      output_buffers_.push_back(allocate(config.network_outputs, config, kDLCPU, 0));
+      free_input_buffers_.push(slot);
+      free_output_buffers_.push(slot);
+    }
+    pre_thread_ = std::thread{[this] {run_pre_processor();}};
+    inference_thread_ = std::thread{[this] {run_inference_engine();}};
+    post_thread_ = std::thread{[this] {run_post_processor();}};
+  }
+
+  AsyncPipeline(const AsyncPipeline &) = delete;
+  AsyncPipeline & operator=(const AsyncPipeline &) = delete;
+
+  /**
+   * @brief Destroy the AsyncPipeline object. Waits until all scheduled inputs
+   * are processed.
+   */
+  ~AsyncPipeline()
+  {
+    input_queue_.close();
+    pre_thread_.join();
+    inference_thread_.join();
+    post_thread_.join();
+  }
+
+  /**
+   * @brief Push data into the pipeline. Blocks while the pipeline is full,
+   * i.e. while the pre-processor falls behind.
+   *
+   * @param input The data to push into the pipeline. It is copied, as it is
+   * processed after this function returns.
+   * @return The pipeline output, available once the input has passed all
+   * stages. Outputs become available in the order of the inputs. An
+   * exception thrown by a stage is rethrown by the future.
+   */
+  std::future<OutputType> schedule(const InputType & input)
+  {
+    Job job{};
+    job.input = input;
+    auto output = job.promise.get_future();
+    if (!input_queue_.push(std::move(job))) {
+      throw std::runtime_error("pipeline is shutting down");
+    }
+    return output;
+  }
+
+private:
+  struct Job
+  {
+    InputType input{};
+    std::promise<OutputType> promise{};
+    // Index of the buffer set that holds the tensors of this job
+    std::size_t slot{0U};
+  };
+
+  static TVMArrayContainerVector allocate(
+    const std::vector<NetworkNode> & nodes, const InferenceEngineTVMConfig & config,
+    DLDeviceType device_type, uint32_t device_id)
+  {
+    TVMArrayContainerVector buffers{};
+    for (auto & node : nodes) {
+      buffers.push_back(
+        TVMArrayContainer(
+          node.second, config.tvm_dtype_code, config.tvm_dtype_bits,
+          config.tvm_dtype_lanes, device_type, device_id));
+    }
+    return buffers;
+  }
+
+  void run_pre_processor()
+  {
+    Job job{};
+    while (input_queue_.pop(job)) {
+      free_input_buffers_.pop(job.slot);
+      try {
+        copy_tensors(pre_processor_.schedule(job.input), input_buffers_[job.slot]);
+      } catch (...) {
+        job.promise.set_exception(std::current_exception());
+        free_input_buffers_.push(job.slot);
+        continue;
+      }
+      inference_queue_.push(std::move(job));
+    }
+    inference_queue_.close();
+  }
+
+  void run_inference_engine()
+  {
+    Job job{};
+    while (inference_queue_.pop(job)) {
+      const auto input_slot = job.slot;
+      free_output_buffers_.pop(job.slot);
+      try {
+        copy_tensors(
+          inference_engine_.schedule(input_buffers_[input_slot]), output_buffers_[job.slot]);
+      } catch (...) {
+        job.promise.set_exception(std::current_exception());
+        free_input_buffers_.push(input_slot);
+        free_output_buffers_.push(job.slot);
+        continue;
+      }
+      free_input_buffers_.push(input_slot);
+      post_queue_.push(std::move(job));
+    }
+    post_queue_.close();
+  }
+
+  void run_post_processor()
+  {
+    Job job{};
+    while (post_queue_.pop(job)) {
+      try {
+        job.promise.set_value(post_processor_.schedule(output_buffers_[job.slot]));
+      } catch (...) {
+        job.promise.set_exception(std::current_exception());
+      }
+      free_output_buffers_.push(job.slot);
+    }
+  }
+
+  PreProcessorType pre_processor_;
+  PostProcessorType post_processor_;
+  InferenceEngineType inference_engine_;
+
+  // Buffer sets between the pre-processor and the inference engine, and
+  // between the inference engine and the post-processor
+  std::vector<TVMArrayContainerVector> input_buffers_{};
+  std::vector<TVMArrayContainerVector> output_buffers_{};
+
+  BoundedQueue<Job> input_queue_;
+  BoundedQueue<Job> inference_queue_;
+  BoundedQueue<Job> post_queue_;
+  BoundedQueue<std::size_t> free_input_buffers_;
+  BoundedQueue<std::size_t> free_output_buffers_;
+
+  std::thread pre_thread_{};
+  std::thread inference_thread_{};
+  std::thread post_thread_{};
+};
+
 }  // namespace pipeline
 }  // namespace tvm_utility
 #endif  // TVM_UTILITY__PIPELINE_HPP_
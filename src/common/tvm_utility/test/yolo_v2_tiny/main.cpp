@@ -16,6 +16,7 @@
 #include <opencv2/opencv.hpp>
 
 #include <algorithm>
+#include <future>
 #include <string>
 #include <utility>
 #include <vector>
@@ -253,6 +254,27 @@ private:
   std::vector<std::pair<float, float>> anchors{};
 };
 
+void check_output(const std::vector<float> & output)
+{
+  // Define reference vector containing expected values, expressed as hexadecimal integers
+  std::vector<int32_t> int_output{
+    0x3eb64594, 0x3f435656, 0x3ece1600, 0x3e99d381,
+    0x3f1cd6bc, 0x3f14f4dd, 0x3ed8065f, 0x3ee9f4fa,
+    0x3ec1b5e8, 0x3f4e7c6c, 0x3f136af1};
+
+  std::vector<float> expected_output(int_output.size());
+
+  // A memcpy means that the floats in expected_output have a well-defined binary value
+  for (int i = 0; i < int_output.size(); i++) {
+    memcpy(&expected_output[i], &int_output[i], sizeof(expected_output[i]));
+  }
+
+  EXPECT_EQ(expected_output.size(), output.size()) << "Unexpected output size";
+  for (auto i = 0; i < output.size(); ++i) {
+    EXPECT_NEAR(expected_output[i], output[i], 0.0001) << "at index: " << i;
+  }
+}
+
 TEST(PipelineExamples, SimplePipeline) {
   // Instantiate the pipeline
   using PrePT = PreProcessorYoloV2Tiny;
@@ -274,24 +296,57 @@ TEST(PipelineExamples, SimplePipeline) {
   // Push data input the pipeline and get the output
   auto output = pipeline.schedule(IMAGE_FILENAME);
 
-  // Define reference vector containing expected values, expressed as hexadecimal integers
-  std::vector<int32_t> int_output{
-    0x3eb64594, 0x3f435656, 0x3ece1600, 0x3e99d381,
-    0x3f1cd6bc, 0x3f14f4dd, 0x3ed8065f, 0x3ee9f4fa,
-    0x3ec1b5e8, 0x3f4e7c6c, 0x3f136af1};
+  // Test: check if the generated output is equal to the reference
+  check_output(output);
+}
 
-  std::vector<float> expected_output(int_output.size());
+TEST(PipelineExamples, BatchedInference) {
+  using PrePT = PreProcessorYoloV2Tiny;
+  using IET = tvm_utility::pipeline::InferenceEngineTVM;
+  using PostPT = PostProcessorYoloV2Tiny;
+  const auto & config =
+    model_zoo::perception::camera_obstacle_detection::yolo_v2_tiny::tensorflow_fp32_coco::config;
+
+  PrePT PreP{config};
+  IET IE{config};
+  PostPT PostP{config};
+
+  // The network is compiled for a batch size of 1
+  ASSERT_EQ(IE.batch_size(), 1U);
+  auto outputs = IE.schedule_batch({PreP.schedule(IMAGE_FILENAME)});
+  ASSERT_EQ(outputs.size(), 1U);
+  check_output(PostP.schedule(outputs[0]));
+
+  // Test: more inputs than the batch size are rejected
+  auto input = PreP.schedule(IMAGE_FILENAME);
+  EXPECT_THROW(IE.schedule_batch({input, input}), std::runtime_error);
+}
 
-  // A memcpy means that the floats in expected_output have a well-defined binary value
-  for (int i = 0; i < int_output.size(); i++) {
-    memcpy(&expected_output[i], &int_output[i], sizeof(expected_output[i]));
+TEST(PipelineExamples, AsyncPipeline) {
+  // Instantiate the pipeline
+  using PrePT = PreProcessorYoloV2Tiny;
+  using IET = tvm_utility::pipeline::InferenceEngineTVM;
+  using PostPT = PostProcessorYoloV2Tiny;
+  const auto & config =
+    model_zoo::perception::camera_obstacle_detection::yolo_v2_tiny::tensorflow_fp32_coco::config;
+
+  tvm_utility::pipeline::AsyncPipeline<PrePT, IET, PostPT> pipeline(
+    PrePT{config}, IET{config}, PostPT{config}, config);
+
+  // Push several inputs before collecting the outputs, so that the stages run concurrently
+  std::vector<std::future<std::vector<float>>> outputs{};
+  for (int i = 0; i < 4; ++i) {
+    outputs.push_back(pipeline.schedule(IMAGE_FILENAME));
   }
 
-  // Test: check if the generated output is equal to the reference
-  EXPECT_EQ(expected_output.size(), output.size()) << "Unexpected output size";
-  for (auto i = 0; i < output.size(); ++i) {
-    EXPECT_NEAR(expected_output[i], output[i], 0.0001) << "at index: " << i;
+  // Test: check that the buffers of consecutive inputs did not interfere
+  for (auto & output : outputs) {
+    check_output(output.get());
   }
+
+  // Test: an exception in a stage is returned through the future
+  auto missing = pipeline.schedule("./missing_image.jpg");
+  EXPECT_THROW(missing.get(), std::runtime_error);
 }
 
 }  // namespace yolo_v2_tiny
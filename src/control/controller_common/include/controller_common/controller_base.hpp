@@ -96,8 +96,19 @@ public:
   /// \throw std::domain_error If state is not in the same frame as reference trajectory
   Command compute_command(const State & state);
 
+  /// Do the part of the computation of the next command which doesn't depend on the next state.
+  /// Called after a command was sent, so that it is outside of the latency between a state and
+  /// its command. Does nothing by default.
+  virtual void prepare_next_command();
   /// Computes stopping control command
   Command compute_stop_command(const State & state) const noexcept;
+  /// Command to use instead of one which was not computed in time, e.g. from the previous
+  /// solution of an optimization, evaluated at the time of the given state. By default, the
+  /// latest command is held, or a stopping command computed if there is none
+  virtual Command compute_fallback_command(const State & state);
+  /// Extrapolate a state to the given time with the motion model of the controller. The state
+  /// is returned as is if the time is not after its stamp
+  State extrapolate(const State & state, std::chrono::system_clock::time_point stamp) noexcept;
 
   /// Returns the index of the current reference point in the trajectory, i.e.
   /// the first point on the trajectory just after the current point spatially.
@@ -148,6 +159,8 @@ private:
   Index m_reference_spatial_index;
   Index m_reference_temporal_index;
   autoware::common::motion_model::CatrMotionModel32 m_model{};
+  Command m_last_command;
+  bool m_has_last_command{false};
 };  // class ControllerBase
 
 /// Fill out a controller diagnostic message
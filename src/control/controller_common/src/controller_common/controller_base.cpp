@@ -65,7 +65,8 @@ ControllerBase::ControllerBase(const BehaviorConfig & config)
   m_reference_trajectory{rosidl_runtime_cpp::MessageInitialization::ALL},
   m_latest_reference{decltype(m_latest_reference)::min()},
   m_reference_spatial_index{},  // zero initialization
-  m_reference_temporal_index{}  // zero initialization
+  m_reference_temporal_index{},  // zero initialization
+  m_last_command{rosidl_runtime_cpp::MessageInitialization::ALL}
 {
   m_reference_trajectory.points.reserve(100LL);  // TODO(c.ho) +1?
   m_reference_trajectory.points.clear();
@@ -109,21 +110,50 @@ const Trajectory & ControllerBase::get_reference_trajectory() const noexcept
 Command ControllerBase::compute_command(const State & state)
 {
   if (m_reference_trajectory.points.empty()) {
-    return compute_stop_command(state);
-  }
-  if (state.header.frame_id != m_reference_trajectory.header.frame_id) {
-    throw std::domain_error{"Vehicle state is not in same frame as reference trajectory"};
+    m_last_command = compute_stop_command(state);
+  } else {
+    if (state.header.frame_id != m_reference_trajectory.header.frame_id) {
+      throw std::domain_error{"Vehicle state is not in same frame as reference trajectory"};
+    }
+    update_reference_indices(state);
+    if (!is_state_ok(state)) {
+      m_last_command = compute_stop_command(state);
+    } else {
+      m_last_command = compute_command_impl(state);
+      // Ensure you're properly populating the stamp
+      m_last_command.stamp = state.header.stamp;
+    }
   }
-  update_reference_indices(state);
-  if (!is_state_ok(state)) {
+  m_has_last_command = true;
+  return m_last_command;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Command ControllerBase::compute_fallback_command(const State & state)
+{
+  if (!m_has_last_command) {
     return compute_stop_command(state);
   }
-  auto ret = compute_command_impl(state);
-  // Ensure you're properly populating the stamp
+  auto ret = m_last_command;
   ret.stamp = state.header.stamp;
   return ret;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+State ControllerBase::extrapolate(
+  const State & state,
+  const std::chrono::system_clock::time_point stamp) noexcept
+{
+  const auto dt = stamp - time_utils::from_message(state.header.stamp);
+  if (dt <= decltype(dt)::zero()) {
+    return state;
+  }
+  auto ret = state;
+  ret.state = predict(state.state, std::chrono::duration_cast<std::chrono::nanoseconds>(dt));
+  ret.header.stamp = time_utils::to_message(stamp);
+  return ret;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool ControllerBase::check_new_trajectory(const Trajectory & trajectory) const
 {
@@ -283,6 +313,11 @@ Index ControllerBase::get_compute_iterations() const
   return Index{};
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void ControllerBase::prepare_next_command()
+{
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void compute_diagnostic(
   const ControllerBase & ctrl,
@@ -202,3 +202,42 @@ TEST_F(motion_model, constant_turn_rate)
   }
   apex_test_tools::memory_test::stop();
 }
+
+TEST_F(motion_model, extrapolate)
+{
+  constexpr auto TOL = 1.0E-3F;
+  const auto t0 = std::chrono::system_clock::now();
+  auto s = make_state(1.0F, 2.0F, 0.0F, 10.0F, 0.0F, 0.0F, t0);
+  s.header.frame_id = "foo";
+  // Not after the stamp
+  for (const auto t : {t0, t0 - milliseconds(10)}) {
+    const auto p = controller_.extrapolate(s, t);
+    EXPECT_EQ(p.header.stamp, s.header.stamp);
+    EXPECT_EQ(p.state.x, s.state.x);
+  }
+  const auto p = controller_.extrapolate(s, t0 + milliseconds(100));
+  EXPECT_EQ(from_message(p.header.stamp), t0 + milliseconds(100));
+  EXPECT_EQ(p.header.frame_id, s.header.frame_id);
+  EXPECT_LT(std::fabs(p.state.x - 2.0F), TOL);
+  EXPECT_LT(std::fabs(p.state.y - 2.0F), TOL);
+}
+
+TEST_F(motion_model, fallback)
+{
+  const auto t0 = std::chrono::system_clock::now();
+  auto s = make_state(0.0F, 0.0F, 0.0F, 10.0F, 0.0F, 0.0F, t0);
+  s.header.frame_id = "foo";
+  // Stops without a previous command
+  EXPECT_FLOAT_EQ(controller_.compute_fallback_command(s).long_accel_mps2, -3.0F);
+  // Holds the previous command otherwise
+  auto traj = constant_velocity_trajectory(-1.0F, 0.0F, 0.0F, 10.0F, milliseconds(100LL));
+  traj.header.frame_id = "foo";
+  traj.header.stamp = s.header.stamp;
+  controller_.set_trajectory(traj);
+  const auto cmd = controller_.compute_command(s);
+  EXPECT_FLOAT_EQ(cmd.long_accel_mps2, 0.0F);
+  const auto later = controller_.extrapolate(s, t0 + milliseconds(50));
+  const auto fallback = controller_.compute_fallback_command(later);
+  EXPECT_FLOAT_EQ(fallback.long_accel_mps2, cmd.long_accel_mps2);
+  EXPECT_EQ(fallback.stamp, later.header.stamp);
+}
@@ -16,14 +16,18 @@
 
 #include <controller_common_nodes/visibility_control.hpp>
 #include <autoware_auto_msgs/msg/control_diagnostic.hpp>
+#include <autoware_auto_msgs/msg/diagnostic_header.hpp>
 #include <autoware_auto_msgs/msg/trajectory.hpp>
 #include <autoware_auto_msgs/msg/vehicle_kinematic_state.hpp>
 #include <controller_common/controller_base.hpp>
+#include <latency_tracing/tracer.hpp>
 #include <tf2/buffer_core.h>
 #include <tf2_msgs/msg/tf_message.hpp>
 
 #include <rclcpp/rclcpp.hpp>
 
+#include <chrono>
+#include <cstdint>
 #include <exception>
 #include <memory>
 #include <list>
@@ -35,6 +39,7 @@ namespace control
 {
 namespace controller_common_nodes
 {
+using autoware_auto_msgs::msg::DiagnosticHeader;
 using controller_common::Command;
 using controller_common::Diagnostic;
 using controller_common::State;
@@ -46,7 +51,8 @@ using ControllerPtr = std::unique_ptr<controller_common::ControllerBase>;
 class CONTROLLER_COMMON_NODES_PUBLIC ControllerBaseNode : public rclcpp::Node
 {
 public:
-  /// Parameter file constructor
+  /// Parameter file constructor. Commands are computed on each state unless control_period_ms
+  /// is positive, see set_control_period()
   ControllerBaseNode(const std::string & name, const std::string & ns);
   /// Explicit constructor
   ControllerBaseNode(
@@ -64,6 +70,18 @@ public:
 protected:
   /// Child class should call this to set the controller
   void set_controller(ControllerPtr && controller) noexcept;
+  /// Compute commands with a fixed period from the latest state, extrapolated to the time of the
+  /// timer, instead of on each state. A command not computed within the deadline after the timer
+  /// is replaced by the fallback command of the controller
+  /// \param[in] period The period of the commands
+  /// \param[in] deadline The compute deadline, the period if zero
+  /// \param[in] publish_timing Whether to publish the slack or overrun of each command on
+  ///            "control_timing", with the number of overruns so far as iterations
+  /// \throw std::domain_error If the period is not positive or the deadline is negative
+  void set_control_period(
+    std::chrono::nanoseconds period,
+    std::chrono::nanoseconds deadline,
+    bool publish_timing);
   /// Handles errors thrown by either check_new_trajectory(), handle_new_trajectory()
   /// or the std::domain_error from set_trajectory()
   virtual void on_bad_trajectory(std::exception_ptr eptr);
@@ -72,6 +90,9 @@ protected:
   virtual void on_bad_compute(std::exception_ptr eptr);
   /// Expose publishing in case a child class wants to do something during error handling
   void publish(const Command & msg);
+  /// Called after the command for a state was published. By default, lets the controller
+  /// prepare the next command. Errors are handled by on_bad_compute()
+  virtual void on_command_published(const State & state);
 
 private:
   // Common initialization
@@ -88,10 +109,20 @@ private:
   // should-we-pass-a-shared-ptr-by-reference-or-by-value/8741626
   CONTROLLER_COMMON_NODES_LOCAL void on_tf(const TFMessage::SharedPtr & msg);
   CONTROLLER_COMMON_NODES_LOCAL void on_static_tf(const TFMessage::SharedPtr & msg);
+  // Runs in its own callback group: only hands the message over to the control callbacks
   CONTROLLER_COMMON_NODES_LOCAL void on_trajectory(const Trajectory::SharedPtr & msg);
+  // Set the latest received trajectory on the controller, if any. True if one was set
+  CONTROLLER_COMMON_NODES_LOCAL bool commit_trajectory();
   CONTROLLER_COMMON_NODES_LOCAL void on_state(const State::SharedPtr & msg);
-  // Main computation, false if failure (due to missing tf?)
-  CONTROLLER_COMMON_NODES_LOCAL bool try_compute(const State & state);
+  CONTROLLER_COMMON_NODES_LOCAL void on_control_timer();
+  // Main computation, false if failure (due to missing tf?). The state is extrapolated to the
+  // command time and the deadline enforced if a command time is given
+  CONTROLLER_COMMON_NODES_LOCAL bool try_compute(
+    const State & state,
+    const std::chrono::system_clock::time_point * command_time = nullptr);
+  // Account for the time since the command time, false on overrun
+  CONTROLLER_COMMON_NODES_LOCAL bool check_deadline(
+    std::chrono::system_clock::time_point command_time);
   // Try to compute control commands from old states in the context of new trajectories and tfs
   CONTROLLER_COMMON_NODES_LOCAL void retry_compute();
 
@@ -100,12 +131,27 @@ private:
   rclcpp::Subscription<TFMessage>::SharedPtr m_tf_sub{};
   rclcpp::Subscription<TFMessage>::SharedPtr m_static_tf_sub{};
   rclcpp::Subscription<Trajectory>::SharedPtr m_trajectory_sub{};
+  rclcpp::CallbackGroup::SharedPtr m_trajectory_callback_group{};
   rclcpp::Publisher<Command>::SharedPtr m_command_pub{};
   rclcpp::Publisher<Diagnostic>::SharedPtr m_diagnostic_pub{};
+  rclcpp::Publisher<DiagnosticHeader>::SharedPtr m_timing_pub{};
+  rclcpp::TimerBase::SharedPtr m_control_timer{};
   tf2::BufferCore m_tf_buffer{tf2::BUFFER_CORE_DEFAULT_CACHE_TIME};
   // TODO(c.ho) diagnostics
   ControllerPtr m_controller{nullptr};
   std::list<State> m_uncomputed_states{};
+  // Fixed rate mode only
+  State m_latest_state{};
+  bool m_has_latest_state{false};
+  std::chrono::nanoseconds m_compute_deadline{};
+  std::uint32_t m_overrun_count{0U};
+  // Latest trajectory not yet given to the controller, only accessed through the std::atomic_*
+  // shared_ptr functions. Older pending trajectories are dropped
+  std::shared_ptr<const Trajectory> m_pending_trajectory{nullptr};
+  // Stage of the node in the latency traces of the trajectories
+  autoware::common::latency_tracing::StageId m_trace_stage{
+    autoware::common::latency_tracing::Tracer::instance().register_stage(
+      get_fully_qualified_name())};
 };  // class ControllerBaseNode
 }  // namespace controller_common_nodes
 }  // namespace control
@@ -16,6 +16,8 @@
 #include <motion_common/motion_common.hpp>
 #include <time_utils/time_utils.hpp>
 
+#include <chrono>
+#include <cstdint>
 #include <exception>
 #include <memory>
 #include <string>
@@ -41,6 +43,19 @@ ControllerBaseNode::ControllerBaseNode(const std::string & name, const std::stri
     declare_parameter("static_tf_topic", ParameterValue{""}, ParameterDescriptor{}).get<string>(),
     declare_parameter("trajectory_topic", ParameterValue{""}, ParameterDescriptor{}).get<string>(),
     declare_parameter("diagnostic_topic", ParameterValue{""}, ParameterDescriptor{}).get<string>());
+  // Optional fixed rate mode
+  const auto period_ms =
+    declare_parameter("control_period_ms", ParameterValue{std::int64_t{}}, ParameterDescriptor{});
+  if (period_ms.get<std::int64_t>() > 0) {
+    const auto deadline_ms = declare_parameter(
+      "compute_deadline_ms", ParameterValue{std::int64_t{}}, ParameterDescriptor{});
+    const auto publish_timing = declare_parameter(
+      "publish_control_timing", ParameterValue{false}, ParameterDescriptor{});
+    set_control_period(
+      std::chrono::milliseconds{period_ms.get<std::int64_t>()},
+      std::chrono::milliseconds{deadline_ms.get<std::int64_t>()},
+      publish_timing.get<bool>());
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -94,9 +109,13 @@ void ControllerBaseNode::init(
   m_state_sub = create_subscription<State>(
     state_topic, QoS{10},
     [this](const State::SharedPtr msg) {on_state(msg);}, SubAllocT{});
+  // Receiving a trajectory must not hold up the control loop in a multithreaded executor
+  m_trajectory_callback_group = create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive);
+  SubAllocT trajectory_options{};
+  trajectory_options.callback_group = m_trajectory_callback_group;
   m_trajectory_sub = create_subscription<Trajectory>(
     trajectory_topic, QoS{10},
-    [this](const Trajectory::SharedPtr msg) {on_trajectory(msg);}, SubAllocT{});
+    [this](const Trajectory::SharedPtr msg) {on_trajectory(msg);}, trajectory_options);
   m_tf_sub = create_subscription<TFMessage>(
     tf_topic, QoS{10},
     [this](const TFMessage::SharedPtr msg) {on_tf(msg);}, SubAllocT{});
@@ -114,6 +133,7 @@ void ControllerBaseNode::init(
 ////////////////////////////////////////////////////////////////////////////////
 void ControllerBaseNode::retry_compute()
 {
+  (void)commit_trajectory();
   // Really inelegant mechanism, but that's callbacks, need to maintain throughput
   while (!m_uncomputed_states.empty()) {
     const auto & state = m_uncomputed_states.front();
@@ -148,24 +168,80 @@ void ControllerBaseNode::on_static_tf(const TFMessage::SharedPtr & msg)
 ////////////////////////////////////////////////////////////////////////////////
 void ControllerBaseNode::on_trajectory(const Trajectory::SharedPtr & msg)
 {
+  // The message is not copied; the controller is only touched by the control callbacks
+  std::atomic_store(&m_pending_trajectory, std::shared_ptr<const Trajectory>{msg});
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ControllerBaseNode::commit_trajectory()
+{
+  const auto trajectory =
+    std::atomic_exchange(&m_pending_trajectory, std::shared_ptr<const Trajectory>{nullptr});
+  if (!trajectory) {
+    return false;
+  }
   try {
-    m_controller->set_trajectory(*msg);
-    // Only retry computation if new trajectory was successfully set
-    retry_compute();
+    m_controller->set_trajectory(*trajectory);
   } catch (...) {
     on_bad_trajectory(std::current_exception());
+    return false;
   }
+  return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void ControllerBaseNode::on_state(const State::SharedPtr & msg)
 {
+  // Computed on the next timer instead
+  if (m_control_timer) {
+    m_latest_state = *msg;
+    m_has_latest_state = true;
+    return;
+  }
+  // Only retry computation if new trajectory was successfully set
+  if (commit_trajectory()) {
+    retry_compute();
+  }
   if (!try_compute(*msg)) {
     m_uncomputed_states.push_back(*msg);
   }
 }
 ////////////////////////////////////////////////////////////////////////////////
-bool ControllerBaseNode::try_compute(const State & state)
+void ControllerBaseNode::on_control_timer()
+{
+  const auto command_time = std::chrono::system_clock::now();
+  (void)commit_trajectory();
+  if (m_has_latest_state) {
+    (void)try_compute(m_latest_state, &command_time);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ControllerBaseNode::check_deadline(const std::chrono::system_clock::time_point command_time)
+{
+  const auto elapsed = std::chrono::system_clock::now() - command_time;
+  const auto on_time = elapsed <= m_compute_deadline;
+  if (!on_time) {
+    ++m_overrun_count;
+  }
+  if (m_timing_pub) {
+    DiagnosticHeader msg;
+    msg.name = on_time ? "slack" : "overrun";
+    msg.data_stamp = time_utils::to_message(command_time);
+    msg.computation_start = time_utils::to_message(command_time);
+    msg.runtime = time_utils::to_message(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+        on_time ? (m_compute_deadline - elapsed) : (elapsed - m_compute_deadline)));
+    msg.iterations = static_cast<decltype(msg.iterations)>(m_overrun_count);
+    m_timing_pub->publish(msg);
+  }
+  return on_time;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ControllerBaseNode::try_compute(
+  const State & state,
+  const std::chrono::system_clock::time_point * command_time)
 {
   if (state.header.frame_id.empty()) {
     RCLCPP_WARN(get_logger(), "try_compute: empty state frame, ignoring");
@@ -178,6 +254,12 @@ bool ControllerBaseNode::try_compute(const State & state)
     //   "try_compute: empty trajectory frame, possibly uninitialized, deferring");
     return false;
   }
+  // The command is the end of the traces of the trajectory, the first one counts
+  autoware::common::latency_tracing::TraceScope trace{
+    autoware::common::latency_tracing::Tracer::instance(), m_trace_stage};
+  trace.set_trace_id(
+    autoware::common::latency_tracing::to_trace_id(
+      m_controller->get_reference_trajectory().header.stamp));
   // TODO(c.ho) these should honestly be two functions
   // Transform state into same frame as trajectory
   const auto traj_frame = m_controller->get_reference_trajectory().header.frame_id;
@@ -195,6 +277,9 @@ bool ControllerBaseNode::try_compute(const State & state)
 
   auto state_tf = state;
   motion_common::doTransform(state, state_tf, tf);
+  if (command_time != nullptr) {
+    state_tf = m_controller->extrapolate(state_tf, *command_time);
+  }
   // Diagnostic stuff: should maybe be different functions
   const auto start = std::chrono::system_clock::now();
   Diagnostic diag;
@@ -222,12 +307,24 @@ bool ControllerBaseNode::try_compute(const State & state)
     };
   // Compute result
   try {
-    const auto cmd{m_controller->compute_command(state_tf)};
+    auto cmd = m_controller->compute_command(state_tf);
+    if ((command_time != nullptr) && !check_deadline(*command_time)) {
+      // Too late for the command time, use what the controller had planned for now instead
+      cmd = m_controller->compute_fallback_command(
+        m_controller->extrapolate(state_tf, std::chrono::system_clock::now()));
+    }
     publish(cmd);
     diagnostic_fn();
   } catch (...) {
     diagnostic_fn();
     on_bad_compute(std::current_exception());
+    return true;
+  }
+  // Not part of the computation time of this command
+  try {
+    on_command_published(state_tf);
+  } catch (...) {
+    on_bad_compute(std::current_exception());
   }
   return true;
 }
@@ -238,12 +335,38 @@ void ControllerBaseNode::publish(const Command & msg)
   m_command_pub->publish(msg);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void ControllerBaseNode::on_command_published(const State & state)
+{
+  (void)state;
+  m_controller->prepare_next_command();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ControllerBaseNode::set_controller(ControllerPtr && controller) noexcept
 {
   m_controller = std::forward<ControllerPtr &&>(controller);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void ControllerBaseNode::set_control_period(
+  const std::chrono::nanoseconds period,
+  const std::chrono::nanoseconds deadline,
+  const bool publish_timing)
+{
+  if (period <= decltype(period)::zero()) {
+    throw std::domain_error{"Control period must be positive"};
+  }
+  if (deadline < decltype(deadline)::zero()) {
+    throw std::domain_error{"Compute deadline must not be negative"};
+  }
+  m_compute_deadline = (deadline == decltype(deadline)::zero()) ? period : deadline;
+  if (publish_timing) {
+    m_timing_pub = create_publisher<DiagnosticHeader>("control_timing", rclcpp::QoS{10LL});
+  }
+  m_control_timer = create_wall_timer(period, [this]() {on_control_timer();});
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void ControllerBaseNode::on_bad_trajectory(std::exception_ptr eptr)  // NOLINT
 {
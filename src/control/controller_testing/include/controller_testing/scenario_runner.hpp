@@ -0,0 +1,157 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief Headless closed-loop evaluation of a controller against a simulated vehicle model
+
+#ifndef CONTROLLER_TESTING__SCENARIO_RUNNER_HPP_
+#define CONTROLLER_TESTING__SCENARIO_RUNNER_HPP_
+
+#include <common/types.hpp>
+#include <controller_common/controller_base.hpp>
+#include <simple_planning_simulator/vehicle_model/sim_model_interface.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "controller_testing/visibility_control.hpp"
+
+namespace motion
+{
+namespace control
+{
+namespace controller_testing
+{
+using autoware::common::types::bool8_t;
+using autoware::common::types::float32_t;
+using autoware::common::types::float64_t;
+using controller_common::ControllerBase;
+using controller_common::State;
+using controller_common::Trajectory;
+
+/// \brief Which field of the command is the longitudinal input of the vehicle model, the other
+///        input being the front wheel angle
+enum class LongitudinalInput
+{
+  VELOCITY,  ///< e.g. IDEAL_STEER_VEL
+  ACCELERATION  ///< e.g. IDEAL_STEER_ACC or DELAY_STEER_ACC
+};  // enum class LongitudinalInput
+
+/// \brief A closed-loop scenario
+struct CONTROLLER_TESTING_PUBLIC Scenario
+{
+  /// The reference trajectory, its stamp is the start time of the scenario
+  Trajectory trajectory;
+  /// The initial state of the vehicle. Position, heading and velocity are used
+  State initial_state;
+  /// Simulated time between two commands
+  std::chrono::nanoseconds step{std::chrono::milliseconds{30LL}};
+  /// Number of commands to simulate
+  std::size_t num_steps{100U};
+};  // struct Scenario
+
+/// \brief Summary of a closed-loop run
+struct CONTROLLER_TESTING_PUBLIC ScenarioResult
+{
+  /// Number of commands computed
+  std::size_t num_steps{0U};
+  float64_t max_lateral_error_m{0.0};
+  float64_t rms_lateral_error_m{0.0};
+  float64_t max_yaw_error_rad{0.0};
+  float64_t rms_velocity_error_mps{0.0};
+  /// Wall clock time of the compute_command calls
+  float64_t mean_compute_time_us{0.0};
+  float64_t max_compute_time_us{0.0};
+  /// Whether the run was aborted by an exception, e.g. of the controller
+  bool8_t failed{false};
+  /// What the exception said
+  std::string error{};
+};  // struct ScenarioResult
+
+/// \brief Distribution of a metric over several scenarios
+struct CONTROLLER_TESTING_PUBLIC Distribution
+{
+  float64_t mean{0.0};
+  float64_t min{0.0};
+  float64_t max{0.0};
+  float64_t median{0.0};
+  float64_t percentile_95{0.0};
+
+  /// \brief Compute the distribution of the given values
+  /// \param[in] values The values, all zero if empty
+  /// \return The distribution
+  static Distribution compute(std::vector<float64_t> values);
+};  // struct Distribution
+
+/// \brief Results of a set of scenarios, failed runs are excluded from the distributions
+struct CONTROLLER_TESTING_PUBLIC SweepResult
+{
+  /// One result per scenario, in the order of the scenarios
+  std::vector<ScenarioResult> scenarios{};
+  std::size_t num_failed{0U};
+  Distribution max_lateral_error_m{};
+  Distribution rms_lateral_error_m{};
+  Distribution max_yaw_error_rad{};
+  Distribution rms_velocity_error_mps{};
+  Distribution mean_compute_time_us{};
+  Distribution max_compute_time_us{};
+};  // struct SweepResult
+
+/// \brief Runs scenarios by stepping a controller and a vehicle model directly, without ROS
+///        transport and faster than real time. Each run uses a new controller and a new model,
+///        so that the scenarios are independent and can run in parallel
+class CONTROLLER_TESTING_PUBLIC ScenarioRunner
+{
+public:
+  /// Creates a controller, called concurrently when running in parallel
+  using ControllerFactory = std::function<std::unique_ptr<ControllerBase>()>;
+  /// Creates a vehicle model, called concurrently when running in parallel. A shared pointer
+  /// because SimModelInterface has no virtual destructor
+  using ModelFactory = std::function<std::shared_ptr<SimModelInterface>()>;
+
+  /// \brief Constructor
+  /// \param[in] controller_factory Creates the controller under test
+  /// \param[in] model_factory Creates the simulated vehicle
+  /// \param[in] longitudinal_input Which command field the model takes
+  /// \throw std::invalid_argument If a factory is empty
+  ScenarioRunner(
+    ControllerFactory controller_factory,
+    ModelFactory model_factory,
+    const LongitudinalInput longitudinal_input);
+
+  /// \brief Run a single scenario
+  /// \param[in] scenario The scenario
+  /// \return The result, failed if the controller or the model threw
+  ScenarioResult run(const Scenario & scenario) const;
+
+  /// \brief Run scenarios in parallel
+  /// \param[in] scenarios The scenarios
+  /// \param[in] num_threads Number of worker threads, the number of hardware threads if zero
+  /// \return The result of each scenario and the distributions over them
+  SweepResult run(const std::vector<Scenario> & scenarios, std::size_t num_threads = 0U) const;
+
+private:
+  ControllerFactory m_controller_factory;
+  ModelFactory m_model_factory;
+  LongitudinalInput m_longitudinal_input;
+};  // class ScenarioRunner
+}  // namespace controller_testing
+}  // namespace control
+}  // namespace motion
+
+#endif  // CONTROLLER_TESTING__SCENARIO_RUNNER_HPP_
@@ -0,0 +1,235 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "controller_testing/scenario_runner.hpp"
+
+#include <motion_common/motion_common.hpp>
+#include <time_utils/time_utils.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace motion
+{
+namespace control
+{
+namespace controller_testing
+{
+namespace
+{
+/// Same state layout as SimplePlanningSimulator::set_initial_state
+Eigen::VectorXd to_model_state(const State & state, const int dim_x)
+{
+  if (dim_x < 3) {
+    throw std::invalid_argument{"The vehicle model has no pose in its state"};
+  }
+  Eigen::VectorXd out = Eigen::VectorXd::Zero(dim_x);
+  out(0) = static_cast<float64_t>(state.state.x);
+  out(1) = static_cast<float64_t>(state.state.y);
+  out(2) = static_cast<float64_t>(motion_common::to_angle(state.state.heading));
+  if (dim_x > 3) {
+    out(3) = static_cast<float64_t>(state.state.longitudinal_velocity_mps);
+  }
+  return out;
+}
+
+/// Same conversion as the simulator node, without measurement noise
+State to_state(SimModelInterface & model)
+{
+  State s;
+  s.state.x = static_cast<float32_t>(model.getX());
+  s.state.y = static_cast<float32_t>(model.getY());
+  s.state.heading = motion_common::from_angle(model.getYaw());
+  s.state.longitudinal_velocity_mps = static_cast<float32_t>(model.getVx());
+  s.state.lateral_velocity_mps = 0.0F;
+  s.state.acceleration_mps2 = static_cast<float32_t>(model.getAx());
+  s.state.heading_rate_rps = static_cast<float32_t>(model.getWz());
+  s.state.front_wheel_angle_rad = static_cast<float32_t>(model.getSteer());
+  s.state.rear_wheel_angle_rad = 0.0F;
+  return s;
+}
+
+float64_t to_us(const std::chrono::steady_clock::duration duration)
+{
+  using Microseconds = std::chrono::duration<float64_t, std::micro>;
+  return std::chrono::duration_cast<Microseconds>(duration).count();
+}
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+Distribution Distribution::compute(std::vector<float64_t> values)
+{
+  Distribution ret{};
+  if (values.empty()) {
+    return ret;
+  }
+  std::sort(values.begin(), values.end());
+  float64_t sum = 0.0;
+  for (const auto value : values) {
+    sum += value;
+  }
+  // Nearest rank
+  const auto percentile = [&values](const float64_t p) {
+      const auto size = static_cast<float64_t>(values.size());
+      const auto rank = static_cast<std::size_t>(std::ceil(p * size));
+      return values[std::max(rank, std::size_t{1U}) - 1U];
+    };
+  ret.mean = sum / static_cast<float64_t>(values.size());
+  ret.min = values.front();
+  ret.max = values.back();
+  ret.median = percentile(0.5);
+  ret.percentile_95 = percentile(0.95);
+  return ret;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ScenarioRunner::ScenarioRunner(
+  ControllerFactory controller_factory,
+  ModelFactory model_factory,
+  const LongitudinalInput longitudinal_input)
+: m_controller_factory{std::move(controller_factory)},
+  m_model_factory{std::move(model_factory)},
+  m_longitudinal_input{longitudinal_input}
+{
+  if (!m_controller_factory || !m_model_factory) {
+    throw std::invalid_argument{"ScenarioRunner: the factories must not be empty"};
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ScenarioResult ScenarioRunner::run(const Scenario & scenario) const
+{
+  ScenarioResult ret{};
+  float64_t sum_lateral_error_squared = 0.0;
+  float64_t sum_velocity_error_squared = 0.0;
+  float64_t sum_compute_time_us = 0.0;
+  try {
+    const auto controller = m_controller_factory();
+    const auto model = m_model_factory();
+    if (!controller || !model) {
+      throw std::runtime_error{"A factory returned no instance"};
+    }
+    model->setState(to_model_state(scenario.initial_state, model->getDimX()));
+    controller->set_trajectory(scenario.trajectory);
+
+    const auto dt = std::chrono::duration_cast<std::chrono::duration<float64_t>>(
+      scenario.step).count();
+    auto time = time_utils::from_message(scenario.trajectory.header.stamp);
+    Eigen::VectorXd input(model->getDimU());
+    motion_common::Diagnostic diagnostic{};
+    for (std::size_t i = 0U; i < scenario.num_steps; ++i) {
+      auto state = to_state(*model);
+      state.header.frame_id = scenario.trajectory.header.frame_id;
+      state.header.stamp = time_utils::to_message(time);
+
+      const auto start = std::chrono::steady_clock::now();
+      const auto command = controller->compute_command(state);
+      const auto compute_time_us = to_us(std::chrono::steady_clock::now() - start);
+
+      controller_common::compute_diagnostic(*controller, state, false, diagnostic);
+      const auto lateral_error = static_cast<float64_t>(diagnostic.lateral_error_m);
+      const auto velocity_error = static_cast<float64_t>(diagnostic.velocity_error_mps);
+      ret.max_lateral_error_m = std::max(ret.max_lateral_error_m, std::fabs(lateral_error));
+      const auto yaw_error = static_cast<float64_t>(diagnostic.yaw_error_rad);
+      ret.max_yaw_error_rad = std::max(ret.max_yaw_error_rad, std::fabs(yaw_error));
+      sum_lateral_error_squared += lateral_error * lateral_error;
+      sum_velocity_error_squared += velocity_error * velocity_error;
+      sum_compute_time_us += compute_time_us;
+      ret.max_compute_time_us = std::max(ret.max_compute_time_us, compute_time_us);
+      ++ret.num_steps;
+
+      const auto longitudinal = (m_longitudinal_input == LongitudinalInput::VELOCITY) ?
+        command.velocity_mps : command.long_accel_mps2;
+      input << static_cast<float64_t>(longitudinal),
+        static_cast<float64_t>(command.front_wheel_angle_rad);
+      model->setInput(input);
+      model->update(dt);
+      time += scenario.step;
+    }
+  } catch (const std::exception & e) {
+    ret.failed = true;
+    ret.error = e.what();
+  }
+  if (ret.num_steps > 0U) {
+    const auto n = static_cast<float64_t>(ret.num_steps);
+    ret.rms_lateral_error_m = std::sqrt(sum_lateral_error_squared / n);
+    ret.rms_velocity_error_mps = std::sqrt(sum_velocity_error_squared / n);
+    ret.mean_compute_time_us = sum_compute_time_us / n;
+  }
+  return ret;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+SweepResult ScenarioRunner::run(
+  const std::vector<Scenario> & scenarios,
+  std::size_t num_threads) const
+{
+  SweepResult ret{};
+  ret.scenarios.resize(scenarios.size());
+  if (num_threads == 0U) {
+    num_threads = std::max(std::thread::hardware_concurrency(), 1U);
+  }
+  num_threads = std::min(num_threads, scenarios.size());
+
+  // The scenarios are handed out one at a time, they may take very different times
+  std::atomic<std::size_t> next{0U};
+  const auto work = [this, &scenarios, &ret, &next]() {
+      for (auto i = next++; i < scenarios.size(); i = next++) {
+        ret.scenarios[i] = run(scenarios[i]);
+      }
+    };
+  std::vector<std::thread> workers;
+  workers.reserve(num_threads);
+  for (std::size_t i = 0U; i < num_threads; ++i) {
+    workers.emplace_back(work);
+  }
+  for (auto & worker : workers) {
+    worker.join();
+  }
+
+  std::vector<float64_t> max_lateral_error_m;
+  std::vector<float64_t> rms_lateral_error_m;
+  std::vector<float64_t> max_yaw_error_rad;
+  std::vector<float64_t> rms_velocity_error_mps;
+  std::vector<float64_t> mean_compute_time_us;
+  std::vector<float64_t> max_compute_time_us;
+  for (const auto & result : ret.scenarios) {
+    if (result.failed) {
+      ++ret.num_failed;
+      continue;
+    }
+    max_lateral_error_m.push_back(result.max_lateral_error_m);
+    rms_lateral_error_m.push_back(result.rms_lateral_error_m);
+    max_yaw_error_rad.push_back(result.max_yaw_error_rad);
+    rms_velocity_error_mps.push_back(result.rms_velocity_error_mps);
+    mean_compute_time_us.push_back(result.mean_compute_time_us);
+    max_compute_time_us.push_back(result.max_compute_time_us);
+  }
+  ret.max_lateral_error_m = Distribution::compute(std::move(max_lateral_error_m));
+  ret.rms_lateral_error_m = Distribution::compute(std::move(rms_lateral_error_m));
+  ret.max_yaw_error_rad = Distribution::compute(std::move(max_yaw_error_rad));
+  ret.rms_velocity_error_mps = Distribution::compute(std::move(rms_velocity_error_mps));
+  ret.mean_compute_time_us = Distribution::compute(std::move(mean_compute_time_us));
+  ret.max_compute_time_us = Distribution::compute(std::move(max_compute_time_us));
+  return ret;
+}
+}  // namespace controller_testing
+}  // namespace control
+}  // namespace motion
@@ -0,0 +1,167 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <controller_testing/scenario_runner.hpp>
+#include <motion_common/motion_common.hpp>
+#include <motion_testing/motion_testing.hpp>
+#include <simple_planning_simulator/vehicle_model/sim_model_ideal_steer_vel.hpp>
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+using motion::control::controller_common::BehaviorConfig;
+using motion::control::controller_common::Command;
+using motion::control::controller_common::ControlReference;
+using motion::control::controller_common::ControllerBase;
+using motion::control::controller_common::State;
+using motion::control::controller_testing::Distribution;
+using motion::control::controller_testing::LongitudinalInput;
+using motion::control::controller_testing::Scenario;
+using motion::control::controller_testing::ScenarioRunner;
+using motion::motion_testing::constant_velocity_trajectory;
+using motion::motion_testing::make_state;
+
+namespace
+{
+// Follows the reference velocity and steers against the lateral and the heading error
+class TestController : public ControllerBase
+{
+public:
+  TestController()
+  : ControllerBase{BehaviorConfig{3.0F, std::chrono::milliseconds(100LL),
+        ControlReference::SPATIAL}} {}
+
+protected:
+  Command compute_command_impl(const State & state) override
+  {
+    const auto & traj = get_reference_trajectory();
+    const auto & ref = traj.points[get_current_state_spatial_index()];
+    motion::motion_common::Diagnostic error{};
+    motion::motion_common::error(state.state, ref, error);
+    Command ret{};
+    ret.velocity_mps = ref.longitudinal_velocity_mps;
+    ret.front_wheel_angle_rad = (-0.2F * error.lateral_error_m) - (0.5F * error.yaw_error_rad);
+    return ret;
+  }
+};  // class TestController
+
+ScenarioRunner make_runner()
+{
+  return ScenarioRunner{
+    []() {return std::make_unique<TestController>();},
+    []() {return std::make_shared<SimModelIdealSteerVel>(2.7);},
+    LongitudinalInput::VELOCITY};
+}
+
+Scenario make_scenario(const float initial_offset)
+{
+  Scenario ret{};
+  ret.trajectory = constant_velocity_trajectory(0.0F, 0.0F, 0.0F, 5.0F,
+      std::chrono::milliseconds(100LL));
+  ret.trajectory.header.frame_id = "map";
+  ret.initial_state = make_state(0.0F, initial_offset, 0.0F, 5.0F, 0.0F, 0.0F,
+      std::chrono::system_clock::now());
+  ret.step = std::chrono::milliseconds(30LL);
+  ret.num_steps = 100U;
+  return ret;
+}
+}  // namespace
+
+TEST(test_scenario_runner, distribution) {
+  const auto empty = Distribution::compute({});
+  EXPECT_EQ(empty.mean, 0.0);
+  EXPECT_EQ(empty.max, 0.0);
+
+  std::vector<double> values;
+  for (auto i = 20; i > 0; --i) {
+    values.push_back(static_cast<double>(i));
+  }
+  const auto dist = Distribution::compute(values);
+  EXPECT_DOUBLE_EQ(dist.mean, 10.5);
+  EXPECT_EQ(dist.min, 1.0);
+  EXPECT_EQ(dist.max, 20.0);
+  EXPECT_EQ(dist.median, 10.0);
+  EXPECT_EQ(dist.percentile_95, 19.0);
+}
+
+TEST(test_scenario_runner, bad_factories) {
+  EXPECT_THROW(
+    ScenarioRunner(
+      nullptr, []() {return std::make_shared<SimModelIdealSteerVel>(2.7);},
+      LongitudinalInput::VELOCITY),
+    std::invalid_argument);
+  EXPECT_THROW(
+    ScenarioRunner(
+      []() {return std::make_unique<TestController>();}, nullptr,
+      LongitudinalInput::VELOCITY),
+    std::invalid_argument);
+}
+
+TEST(test_scenario_runner, single) {
+  const auto runner = make_runner();
+  const auto on_track = runner.run(make_scenario(0.0F));
+  ASSERT_FALSE(on_track.failed) << on_track.error;
+  EXPECT_EQ(on_track.num_steps, 100U);
+  EXPECT_LT(on_track.max_lateral_error_m, 1.0E-3);
+  EXPECT_LE(on_track.mean_compute_time_us, on_track.max_compute_time_us);
+
+  // The controller converges from an offset
+  const auto offset = runner.run(make_scenario(1.0F));
+  ASSERT_FALSE(offset.failed) << offset.error;
+  EXPECT_NEAR(offset.max_lateral_error_m, 1.0, 1.0E-3);
+  EXPECT_LT(offset.rms_lateral_error_m, offset.max_lateral_error_m);
+  EXPECT_GT(offset.max_yaw_error_rad, 0.0);
+
+  // Empty trajectories are rejected by the controller
+  auto bad = make_scenario(0.0F);
+  bad.trajectory.points.clear();
+  const auto failed = runner.run(bad);
+  EXPECT_TRUE(failed.failed);
+  EXPECT_FALSE(failed.error.empty());
+  EXPECT_EQ(failed.num_steps, 0U);
+}
+
+TEST(test_scenario_runner, parallel) {
+  const auto runner = make_runner();
+  std::vector<Scenario> scenarios;
+  for (auto i = 0; i < 16; ++i) {
+    scenarios.push_back(make_scenario(0.1F * static_cast<float>(i)));
+  }
+  scenarios[5U].trajectory.points.clear();
+
+  const auto sweep = runner.run(scenarios, 4U);
+  ASSERT_EQ(sweep.scenarios.size(), scenarios.size());
+  EXPECT_EQ(sweep.num_failed, 1U);
+  EXPECT_TRUE(sweep.scenarios[5U].failed);
+  // Same results as when run one by one
+  for (std::size_t i = 0U; i < scenarios.size(); ++i) {
+    const auto serial = runner.run(scenarios[i]);
+    EXPECT_EQ(sweep.scenarios[i].failed, serial.failed);
+    EXPECT_EQ(sweep.scenarios[i].num_steps, serial.num_steps);
+    EXPECT_EQ(sweep.scenarios[i].max_lateral_error_m, serial.max_lateral_error_m);
+    EXPECT_EQ(sweep.scenarios[i].rms_velocity_error_mps, serial.rms_velocity_error_mps);
+  }
+  EXPECT_NEAR(sweep.max_lateral_error_m.max, 1.5, 1.0E-3);
+  EXPECT_LE(sweep.max_lateral_error_m.median, sweep.max_lateral_error_m.percentile_95);
+  EXPECT_LE(sweep.mean_compute_time_us.min, sweep.mean_compute_time_us.max);
+
+  // More threads than scenarios
+  const auto small = runner.run(std::vector<Scenario>{make_scenario(0.0F)}, 8U);
+  ASSERT_EQ(small.scenarios.size(), 1U);
+  EXPECT_EQ(small.num_failed, 0U);
+  EXPECT_TRUE(runner.run(std::vector<Scenario>{}).scenarios.empty());
+}
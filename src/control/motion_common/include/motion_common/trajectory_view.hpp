@@ -0,0 +1,125 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MOTION_COMMON__TRAJECTORY_VIEW_HPP_
+#define MOTION_COMMON__TRAJECTORY_VIEW_HPP_
+
+#include <cstddef>
+#include <vector>
+
+#include "common/types.hpp"
+#include "motion_common/trajectory_common.hpp"
+#include "motion_common/visibility_control.hpp"
+
+namespace autoware
+{
+namespace motion
+{
+namespace motion_common
+{
+/**
+ * @brief geometry of a trajectory precomputed in a single pass over its points, with one array
+ *        per quantity. Build it once per trajectory instead of accumulating the arc length or
+ *        converting the headings at every query. The arrays keep their capacity across updates.
+ */
+class MOTION_COMMON_PUBLIC TrajectoryView
+{
+public:
+  /**
+   * @brief quantities of the trajectory at an arc length
+   */
+  struct Sample
+  {
+    float64_t s;
+    float64_t x;
+    float64_t y;
+    float64_t yaw;
+    float64_t curvature;
+    float64_t velocity;
+  };
+
+  TrajectoryView() = default;
+
+  /**
+   * @brief construct the view of the given points
+   * @param [in] points trajectory points
+   */
+  explicit TrajectoryView(const Points & points);
+
+  /**
+   * @brief recompute the view for new points
+   * @param [in] points trajectory points
+   */
+  void update(const Points & points);
+
+  /**
+   * @brief reserve the arrays so that updates with up to the given number of points don't
+   *        allocate
+   * @param [in] capacity number of points
+   */
+  void reserve(const std::size_t capacity);
+
+  /// @brief number of points of the trajectory
+  std::size_t size() const noexcept;
+  /// @brief whether the trajectory has no points
+  bool empty() const noexcept;
+  /// @brief arc length of the whole trajectory [m], zero if it is empty
+  float64_t length() const noexcept;
+
+  /// @brief cumulative arc length at each point [m], starting at zero
+  const std::vector<float64_t> & s() const noexcept;
+  /// @brief x position at each point [m]
+  const std::vector<float64_t> & x() const noexcept;
+  /// @brief y position at each point [m]
+  const std::vector<float64_t> & y() const noexcept;
+  /// @brief heading at each point [radians]
+  const std::vector<float64_t> & yaw() const noexcept;
+  /// @brief signed curvature at each point from the circle through it and its neighbours [1/m]
+  const std::vector<float64_t> & curvature() const noexcept;
+  /// @brief longitudinal velocity at each point [m/s]
+  const std::vector<float64_t> & velocity() const noexcept;
+
+  /**
+   * @brief find the segment containing an arc length, i.e. the last index whose arc length is
+   *        not greater, clamped to the last segment. The search walks from the hint, so it is
+   *        cheap for queries close to the previous one
+   * @param [in] s arc length [m]
+   * @param [in] hint index to start the search from, e.g. the result of the previous query
+   * @return index of the first point of the segment, zero for less than two points
+   */
+  std::size_t find_segment_index(const float64_t s, const std::size_t hint = 0U) const noexcept;
+
+  /**
+   * @brief linearly interpolate the trajectory at an arc length, clamped to the trajectory
+   * @param [in] s arc length [m]
+   * @param [inout] hint index to start the search from, set to the segment of the sample
+   * @return the interpolated sample
+   * @throw std::invalid_argument if the trajectory is empty
+   */
+  Sample interpolate(const float64_t s, std::size_t & hint) const;
+
+private:
+  std::vector<float64_t> m_s{};
+  std::vector<float64_t> m_x{};
+  std::vector<float64_t> m_y{};
+  std::vector<float64_t> m_yaw{};
+  std::vector<float64_t> m_curvature{};
+  std::vector<float64_t> m_velocity{};
+};
+
+}  // namespace motion_common
+}  // namespace motion
+}  // namespace autoware
+
+#endif  // MOTION_COMMON__TRAJECTORY_VIEW_HPP_
@@ -0,0 +1,172 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "motion_common/trajectory_view.hpp"
+
+namespace autoware
+{
+namespace motion
+{
+namespace motion_common
+{
+
+TrajectoryView::TrajectoryView(const Points & points)
+{
+  update(points);
+}
+
+void TrajectoryView::update(const Points & points)
+{
+  const auto n = points.size();
+  m_s.resize(n);
+  m_x.resize(n);
+  m_y.resize(n);
+  m_yaw.resize(n);
+  m_curvature.resize(n);
+  m_velocity.resize(n);
+
+  float64_t s = 0.0;
+  for (std::size_t i = 0U; i < n; ++i) {
+    const auto & pt = points[i];
+    m_x[i] = static_cast<float64_t>(pt.x);
+    m_y[i] = static_cast<float64_t>(pt.y);
+    m_yaw[i] = static_cast<float64_t>(::motion::motion_common::to_angle(pt.heading));
+    m_velocity[i] = static_cast<float64_t>(pt.longitudinal_velocity_mps);
+    if (i > 0U) {
+      s += std::hypot(m_x[i] - m_x[i - 1U], m_y[i] - m_y[i - 1U]);
+    }
+    m_s[i] = s;
+    // Circle fitting through the previous, the current and the next point, as soon as the next
+    // point is known
+    if (i >= 2U) {
+      const auto dx1 = m_x[i - 1U] - m_x[i - 2U];
+      const auto dy1 = m_y[i - 1U] - m_y[i - 2U];
+      const auto dx2 = m_x[i] - m_x[i - 2U];
+      const auto dy2 = m_y[i] - m_y[i - 2U];
+      const auto den = std::max(
+        (m_s[i - 1U] - m_s[i - 2U]) * (m_s[i] - m_s[i - 1U]) * std::hypot(dx2, dy2),
+        std::numeric_limits<float64_t>::epsilon());
+      m_curvature[i - 1U] = 2.0 * ((dx1 * dy2) - (dy1 * dx2)) / den;
+    }
+  }
+  // The end points get the curvature of their neighbour
+  if (n >= 3U) {
+    m_curvature.front() = m_curvature[1U];
+    m_curvature.back() = m_curvature[n - 2U];
+  } else {
+    std::fill(m_curvature.begin(), m_curvature.end(), 0.0);
+  }
+}
+
+void TrajectoryView::reserve(const std::size_t capacity)
+{
+  m_s.reserve(capacity);
+  m_x.reserve(capacity);
+  m_y.reserve(capacity);
+  m_yaw.reserve(capacity);
+  m_curvature.reserve(capacity);
+  m_velocity.reserve(capacity);
+}
+
+std::size_t TrajectoryView::size() const noexcept
+{
+  return m_s.size();
+}
+
+bool TrajectoryView::empty() const noexcept
+{
+  return m_s.empty();
+}
+
+float64_t TrajectoryView::length() const noexcept
+{
+  return m_s.empty() ? 0.0 : m_s.back();
+}
+
+const std::vector<float64_t> & TrajectoryView::s() const noexcept
+{
+  return m_s;
+}
+
+const std::vector<float64_t> & TrajectoryView::x() const noexcept
+{
+  return m_x;
+}
+
+const std::vector<float64_t> & TrajectoryView::y() const noexcept
+{
+  return m_y;
+}
+
+const std::vector<float64_t> & TrajectoryView::yaw() const noexcept
+{
+  return m_yaw;
+}
+
+const std::vector<float64_t> & TrajectoryView::curvature() const noexcept
+{
+  return m_curvature;
+}
+
+const std::vector<float64_t> & TrajectoryView::velocity() const noexcept
+{
+  return m_velocity;
+}
+
+std::size_t TrajectoryView::find_segment_index(
+  const float64_t s, const std::size_t hint) const noexcept
+{
+  if (m_s.size() < 2U) {
+    return 0U;
+  }
+  const auto last_segment = m_s.size() - 2U;
+  auto idx = std::min(hint, last_segment);
+  while ((idx < last_segment) && (m_s[idx + 1U] <= s)) {
+    ++idx;
+  }
+  while ((idx > 0U) && (m_s[idx] > s)) {
+    --idx;
+  }
+  return idx;
+}
+
+TrajectoryView::Sample TrajectoryView::interpolate(const float64_t s, std::size_t & hint) const
+{
+  if (m_s.empty()) {
+    throw std::invalid_argument("Empty points");
+  }
+  hint = find_segment_index(s, hint);
+  const auto clamped_s = std::min(std::max(s, 0.0), length());
+  if (m_s.size() == 1U) {
+    return Sample{clamped_s, m_x[0U], m_y[0U], m_yaw[0U], m_curvature[0U], m_velocity[0U]};
+  }
+  const auto i = hint;
+  const auto ds = m_s[i + 1U] - m_s[i];
+  const auto ratio = (ds > 0.0) ? ((clamped_s - m_s[i]) / ds) : 0.0;
+  const auto lerp = [ratio, i](const std::vector<float64_t> & values) {
+      return values[i] + (ratio * (values[i + 1U] - values[i]));
+    };
+  const auto yaw = autoware::common::helper_functions::wrap_angle(
+    m_yaw[i] + (ratio * calcYawDeviation(m_yaw[i], m_yaw[i + 1U])));
+  return Sample{clamped_s, lerp(m_x), lerp(m_y), yaw, lerp(m_curvature), lerp(m_velocity)};
+}
+
+}  // namespace motion_common
+}  // namespace motion
+}  // namespace autoware
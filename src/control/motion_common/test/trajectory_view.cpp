@@ -0,0 +1,136 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+/// \file
+/// \brief This file includes tests for the trajectory view
+
+#include <cmath>
+
+#include "common/types.hpp"
+#include "gtest/gtest.h"
+#include "motion_common/trajectory_view.hpp"
+
+using autoware::common::types::float32_t;
+using autoware::common::types::float64_t;
+using autoware::motion::motion_common::Points;
+using autoware::motion::motion_common::TrajectoryView;
+
+namespace
+{
+// Counterclockwise arc of the circle of the given radius around the origin, starting at (r, 0)
+Points make_arc(const float64_t radius, const std::size_t size, const float64_t step_rad)
+{
+  Points points;
+  for (std::size_t i = 0U; i < size; ++i) {
+    const auto angle = static_cast<float64_t>(i) * step_rad;
+    points.emplace_back();
+    points.back().x = static_cast<float32_t>(radius * std::cos(angle));
+    points.back().y = static_cast<float32_t>(radius * std::sin(angle));
+    points.back().heading = ::motion::motion_common::from_angle(angle + M_PI_2);
+    points.back().longitudinal_velocity_mps = static_cast<float32_t>(i);
+  }
+  return points;
+}
+}  // namespace
+
+TEST(trajectory_view, empty) {
+  TrajectoryView view{};
+  EXPECT_TRUE(view.empty());
+  EXPECT_EQ(view.length(), 0.0);
+  EXPECT_EQ(view.find_segment_index(1.0, 5U), 0U);
+  std::size_t hint = 0U;
+  EXPECT_THROW(view.interpolate(0.0, hint), std::invalid_argument);
+
+  Points points(1U);
+  points[0U].x = 1.0F;
+  view.update(points);
+  ASSERT_EQ(view.size(), 1U);
+  EXPECT_EQ(view.curvature()[0U], 0.0);
+  const auto sample = view.interpolate(3.0, hint);
+  EXPECT_EQ(sample.s, 0.0);
+  EXPECT_EQ(sample.x, 1.0);
+}
+
+TEST(trajectory_view, arc) {
+  constexpr float64_t radius = 10.0;
+  constexpr std::size_t size = 50U;
+  constexpr float64_t step = M_PI / 100.0;
+  const TrajectoryView view{make_arc(radius, size, step)};
+  ASSERT_EQ(view.size(), size);
+
+  // The chords are slightly shorter than the arc
+  const auto chord = 2.0 * radius * std::sin(0.5 * step);
+  EXPECT_NEAR(view.length(), static_cast<float64_t>(size - 1U) * chord, 1.0E-4);
+  for (std::size_t i = 0U; i < size; ++i) {
+    EXPECT_NEAR(view.s()[i], static_cast<float64_t>(i) * chord, 1.0E-4);
+    EXPECT_NEAR(view.curvature()[i], 1.0 / radius, 1.0E-4);
+    EXPECT_NEAR(view.yaw()[i], static_cast<float64_t>(i) * step + M_PI_2, 1.0E-5);
+    EXPECT_EQ(view.velocity()[i], static_cast<float64_t>(i));
+  }
+
+  // Clockwise arc
+  auto points = make_arc(radius, size, step);
+  for (auto & pt : points) {
+    pt.y = -pt.y;
+  }
+  const TrajectoryView clockwise_view{points};
+  EXPECT_NEAR(clockwise_view.curvature()[size / 2U], -1.0 / radius, 1.0E-4);
+}
+
+TEST(trajectory_view, queries) {
+  constexpr float64_t radius = 10.0;
+  constexpr std::size_t size = 50U;
+  constexpr float64_t step = M_PI / 100.0;
+  const TrajectoryView view{make_arc(radius, size, step)};
+  const auto chord = view.s()[1U];
+
+  // The result does not depend on the hint
+  for (const std::size_t hint : {0U, 10U, 20U, 49U, 100U}) {
+    EXPECT_EQ(view.find_segment_index(-1.0, hint), 0U);
+    EXPECT_EQ(view.find_segment_index(20.5 * chord, hint), 20U);
+    EXPECT_EQ(view.find_segment_index(20.0 * chord, hint), 20U);
+    EXPECT_EQ(view.find_segment_index(view.length(), hint), size - 2U);
+    EXPECT_EQ(view.find_segment_index(view.length() + 1.0, hint), size - 2U);
+  }
+
+  std::size_t hint = 0U;
+  const auto sample = view.interpolate(10.5 * chord, hint);
+  EXPECT_EQ(hint, 10U);
+  EXPECT_NEAR(sample.s, 10.5 * chord, 1.0E-5);
+  EXPECT_NEAR(sample.velocity, 10.5, 1.0E-5);
+  EXPECT_NEAR(sample.yaw, 10.5 * step + M_PI_2, 1.0E-5);
+  EXPECT_NEAR(sample.curvature, 1.0 / radius, 1.0E-4);
+  // On the chord between the points 10 and 11
+  const auto mid_radius = radius * std::cos(0.5 * step);
+  EXPECT_NEAR(sample.x, mid_radius * std::cos(10.5 * step), 1.0E-4);
+  EXPECT_NEAR(sample.y, mid_radius * std::sin(10.5 * step), 1.0E-4);
+
+  // Clamped to the trajectory
+  const auto end = view.interpolate(view.length() + 1.0, hint);
+  EXPECT_EQ(hint, size - 2U);
+  EXPECT_EQ(end.s, view.length());
+  EXPECT_EQ(end.x, view.x().back());
+  EXPECT_EQ(end.y, view.y().back());
+}
+
+TEST(trajectory_view, yaw_wrap) {
+  Points points(2U);
+  points[1U].x = 1.0F;
+  points[0U].heading = ::motion::motion_common::from_angle(M_PI - 0.1);
+  points[1U].heading = ::motion::motion_common::from_angle(-M_PI + 0.1);
+  const TrajectoryView view{points};
+  std::size_t hint = 0U;
+  // Interpolated through +-pi, not through zero
+  EXPECT_NEAR(std::fabs(view.interpolate(0.5, hint).yaw), M_PI, 1.0E-5);
+}
@@ -52,6 +52,16 @@ enum class Interpolation : uint8_t
   NO = 1U
 };
 
+/// \brief How the problem is updated when a new trajectory is received
+enum class TrajectoryUpdate : uint8_t
+{
+  /// Cold start the optimization problem on every new trajectory
+  RESTART = 0U,
+  /// If the new trajectory continues the previous one in time, shift the previous solution to
+  /// the start of the new trajectory and use it as the initial guess
+  SHIFT = 1U
+};
+
 /// \brief A configuration class for the MpcController
 class MPC_CONTROLLER_PUBLIC Config
 {
@@ -63,7 +73,8 @@ public:
     const OptimizationConfig & optimization_param,
     std::chrono::nanoseconds sample_period_tolerance,
     std::chrono::nanoseconds control_lookahead_duration,
-    Interpolation interpolation_option);
+    Interpolation interpolation_option,
+    TrajectoryUpdate trajectory_update_option = TrajectoryUpdate::RESTART);
   MPC_CONTROLLER_COPY_MOVE_ASSIGNABLE(Config)
 
   const LimitsConfig & limits() const noexcept;
@@ -73,6 +84,7 @@ public:
   std::chrono::nanoseconds sample_period_tolerance() const noexcept;
   std::chrono::nanoseconds control_lookahead_duration() const noexcept;
   bool do_interpolate() const noexcept;
+  bool do_shift_on_new_trajectory() const noexcept;
 
 private:
   LimitsConfig m_limits;
@@ -82,6 +94,7 @@ private:
   std::chrono::nanoseconds m_sample_period_tolerance;
   std::chrono::nanoseconds m_control_lookahead_duration;
   bool m_do_interpolate;
+  bool m_do_shift_on_new_trajectory;
 };  // class Config
 
 struct MPC_CONTROLLER_PUBLIC ControlDerivatives
@@ -21,9 +21,13 @@
 
 #include <controller_common/controller_base.hpp>
 #include <mpc_controller/config.hpp>
+#include <mpc_controller/warm_start_table.hpp>
 
+#include <chrono>
+#include <memory>
 #include <ostream>
 #include <string>
+#include <vector>
 
 namespace motion
 {
@@ -47,6 +51,19 @@ public:
   using State = autoware_auto_msgs::msg::VehicleKinematicState;
   using Trajectory = autoware_auto_msgs::msg::Trajectory;
 
+  /// Durations of the phases of the real-time iteration of the solver for the latest command
+  struct SolverTiming
+  {
+    /// Preparation phase, linearization and condensing around the previous solution
+    std::chrono::nanoseconds preparation{};
+    /// Feedback phase, solving the QP for the current state
+    std::chrono::nanoseconds feedback{};
+    /// Whole computation of the command
+    std::chrono::nanoseconds total{};
+    /// If the preparation was done after the previous command, outside of the critical path
+    bool prepared_in_advance{false};
+  };
+
   /// \brief Constructor
   explicit MpcController(const Config & config);
   ~MpcController() override = default;
@@ -72,6 +89,31 @@ public:
   /// Get name of algorithm, for debugging or diagnostic purposes
   Index get_compute_iterations() const override;
 
+  /// Run the preparation phase of the solver for the next command around the current solution.
+  /// It is used by the next command if no input of it changed in the meantime, e.g. because the
+  /// problem was advanced along the trajectory, otherwise the next command prepares again.
+  /// \throw std::runtime_error If the solver preparation fails
+  void prepare_next_command() override;
+  /// Get the timing of the solver for the latest command
+  const SolverTiming & get_solver_timing() const noexcept;
+  /// Evaluate the latest solution at the time of the given state, i.e. shifted by the time
+  /// since the state it was computed for. Holds the latest command if there is no solution
+  Command compute_fallback_command(const State & state) override;
+
+  /// Compute a warm start table for the current configuration. For each node of the grid, the
+  /// problem with a reference of constant speed and curvature and an initial state with the
+  /// errors of the node is solved with the given number of solver iterations. This takes a
+  /// while, so it is meant to be done once ahead of time, e.g. at startup
+  /// 	hrow std::logic_error If the controller already has a reference trajectory, since the
+  /// state of the solver is overwritten
+  /// 	hrow std::domain_error If the grid is invalid or there are no iterations
+  /// 	hrow std::runtime_error If the solver fails
+  WarmStartTable generate_warm_start_table(const WarmStartTable::Axes & axes, Index iterations);
+  /// Initialize the solver on cold starts from the control sequence interpolated from the table
+  /// for the current speed, curvature and errors, instead of from zero inputs
+  /// 	hrow std::domain_error If the sequences of the table don't match the solver horizon
+  void set_warm_start_table(const WarmStartTable & table);
+
 protected:
   /// Checks trajectory
   bool check_new_trajectory(const Trajectory & trajectory) const override;
@@ -81,12 +123,21 @@ protected:
   Command compute_command_impl(const State & state) override;
 
 private:
-  /// Run the solver subroutine
-  MPC_CONTROLLER_LOCAL void solve();
+  /// Run the solver subroutine, the preparation phase is skipped if it was done in advance
+  MPC_CONTROLLER_LOCAL void solve(bool prepared);
+  /// Run the preparation phase of the solver, returns its duration
+  MPC_CONTROLLER_LOCAL std::chrono::nanoseconds prepare();
+  /// Copy the solver variables the preparation phase depends on
+  MPC_CONTROLLER_LOCAL void get_preparation_inputs(std::vector<double> & inputs) const;
   /// Roll references forward and update weights appropriately, return true if cold start
   MPC_CONTROLLER_LOCAL bool update_references(Index current_idx);
   /// Set initial conditions for problem
   MPC_CONTROLLER_LOCAL void initial_conditions(const Point & state);
+  /// Set the controls of a cold start from the warm start table, or to zero without table.
+  /// Relies on x0 and the references being set
+  MPC_CONTROLLER_LOCAL void initialize_controls();
+  /// Set the first shooting node to the initial conditions
+  MPC_CONTROLLER_LOCAL void initialize_first_node() noexcept;
   /// Compute delta to roll state forward or back to match first reference
   MPC_CONTROLLER_LOCAL std::chrono::nanoseconds x0_time_offset(const State & state, Index idx);
   /// Compute interpolated command
@@ -121,11 +172,30 @@ private:
   MPC_CONTROLLER_LOCAL void advance_problem(Index count);
   /// Fills the last N trajectory reference points with points from the reference trajectory
   MPC_CONTROLLER_LOCAL void backfill_reference(Index count);
+  /// Shift the solution from the previous reference trajectory to the start of the given one,
+  /// return false if the trajectories don't line up in time
+  MPC_CONTROLLER_LOCAL bool shift_to_new_trajectory(const Trajectory & traj);
 
   Config m_config;
   Trajectory::UniquePtr m_interpolated_trajectory{nullptr};
   mutable Trajectory m_computed_trajectory;
   Index m_last_reference_index;
+  // If the solver holds a solution which the next command can start from
+  bool m_has_solution{false};
+  // Time of the initial state of the latest solution
+  std::chrono::system_clock::time_point m_solution_x0_time{};
+  // If the next command has to start cold, used with shifting on new trajectories
+  bool m_cold_start_pending{true};
+  // Inputs of the preparation done after the latest command, empty if there is none
+  std::vector<double> m_prepared_inputs;
+  // Inputs at the time of the current command, to be compared with the prepared ones
+  std::vector<double> m_current_inputs;
+  std::chrono::nanoseconds m_prepared_duration{};
+  // Initial guesses of cold starts, none by default
+  std::unique_ptr<WarmStartTable> m_warm_start_table{nullptr};
+  // Interpolated warm start, allocated with the table
+  std::vector<Real> m_warm_start_sequence;
+  SolverTiming m_timing{};
 };  // class MpcController
 }  // namespace mpc_controller
 }  // namespace control
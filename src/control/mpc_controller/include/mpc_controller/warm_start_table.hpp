@@ -0,0 +1,93 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef MPC_CONTROLLER__WARM_START_TABLE_HPP_
+#define MPC_CONTROLLER__WARM_START_TABLE_HPP_
+
+#include <mpc_controller/visibility_control.hpp>
+#include <mpc_controller/config.hpp>
+
+#include <array>
+#include <vector>
+
+namespace motion
+{
+namespace control
+{
+namespace mpc_controller
+{
+/// \brief An axis of the warm start table, with count nodes evenly spaced from min to max
+struct MPC_CONTROLLER_PUBLIC WarmStartAxis
+{
+  Real min;
+  Real max;
+  Index count;
+};  // struct WarmStartAxis
+
+/// \brief The situation at the start of a problem which a warm start is looked up for. The
+/// errors are the ones of the initial state with respect to the first reference point
+struct MPC_CONTROLLER_PUBLIC WarmStartKey
+{
+  Real speed_mps;
+  Real curvature;
+  Real lateral_error_m;
+  Real heading_error_rad;
+};  // struct WarmStartKey
+
+/// \brief A lookup of representative optimal control sequences on a regular grid of
+/// WarmStartKey, which is interpolated to initialize the solver instead of starting from zero
+/// inputs. The sequences are computed ahead of time, see MpcController::generate_warm_start_table
+class MPC_CONTROLLER_PUBLIC WarmStartTable
+{
+public:
+  static constexpr Index NUM_AXES = 4U;
+  /// Speed, curvature, lateral error and heading error, in the order of WarmStartKey
+  using Axes = std::array<WarmStartAxis, NUM_AXES>;
+
+  /// \brief Constructor, all sequences are zero
+  /// \param[in] axes The grid of the table
+  /// \param[in] sequence_size The number of values of each control sequence
+  /// \throw std::domain_error If an axis has no node, or several nodes but an empty range, or
+  /// if the sequences are empty
+  WarmStartTable(const Axes & axes, Index sequence_size);
+  MPC_CONTROLLER_COPY_MOVE_ASSIGNABLE(WarmStartTable)
+
+  const Axes & axes() const noexcept;
+  /// Number of nodes of the grid
+  Index size() const noexcept;
+  Index sequence_size() const noexcept;
+
+  /// \brief Get the key of a node of the grid, the first axis varies fastest
+  /// \throw std::out_of_range If there is no such node
+  WarmStartKey node(Index idx) const;
+  /// \brief Set the control sequence of a node of the grid
+  /// \throw std::out_of_range If there is no such node
+  /// \throw std::domain_error If the sequence doesn't have sequence_size() values
+  void set_sequence(Index idx, const std::vector<Real> & sequence);
+  /// \brief Interpolate the control sequences of the nodes around a key, multilinearly. Keys
+  /// outside of the grid are clamped to it
+  /// \param[in] key The situation to look up
+  /// \param[out] sequence The interpolated sequence, resized to sequence_size()
+  void interpolate(const WarmStartKey & key, std::vector<Real> & sequence) const;
+
+private:
+  Axes m_axes;
+  Index m_sequence_size;
+  Index m_size;
+  // The sequences of the nodes one after the other
+  std::vector<Real> m_sequences;
+};  // class WarmStartTable
+}  // namespace mpc_controller
+}  // namespace control
+}  // namespace motion
+#endif  // MPC_CONTROLLER__WARM_START_TABLE_HPP_
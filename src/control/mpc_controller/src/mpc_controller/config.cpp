@@ -30,14 +30,16 @@ Config::Config(
   const OptimizationConfig & optimization_param,
   const std::chrono::nanoseconds sample_period_tolerance,
   const std::chrono::nanoseconds control_lookahead_duration,
-  const Interpolation interpolation_option)
+  const Interpolation interpolation_option,
+  const TrajectoryUpdate trajectory_update_option)
 : m_limits{limits},
   m_vehicle_param{vehicle_param},
   m_behavior_param{behavior},
   m_optimization_param{optimization_param},
   m_sample_period_tolerance{sample_period_tolerance},
   m_control_lookahead_duration{control_lookahead_duration},
-  m_do_interpolate{interpolation_option == Interpolation::YES}
+  m_do_interpolate{interpolation_option == Interpolation::YES},
+  m_do_shift_on_new_trajectory{trajectory_update_option == TrajectoryUpdate::SHIFT}
 {
   if (sample_period_tolerance < decltype(sample_period_tolerance)::zero()) {
     throw std::domain_error{"Sample period tolerance must be positive"};
@@ -76,6 +78,10 @@ bool Config::do_interpolate() const noexcept
 {
   return m_do_interpolate;
 }
+bool Config::do_shift_on_new_trajectory() const noexcept
+{
+  return m_do_shift_on_new_trajectory;
+}
 }  // namespace mpc_controller
 }  // namespace control
 }  // namespace motion
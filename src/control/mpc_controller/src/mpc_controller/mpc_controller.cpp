@@ -20,10 +20,13 @@
 #include <time_utils/time_utils.hpp>
 
 #include <algorithm>
+#include <chrono>
+#include <iterator>
 #include <limits>
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 // extern variables in autogenerated code
 ACADOworkspace acadoWorkspace;
@@ -73,6 +76,9 @@ MpcController::MpcController(const Config & config)
   m_computed_trajectory.points.reserve(Trajectory::CAPACITY);
   acado_initializeSolver();
   apply_config(m_config);
+  // Allocate the storage of the preparation inputs up front
+  get_preparation_inputs(m_current_inputs);
+  m_prepared_inputs.reserve(m_current_inputs.size());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -92,11 +98,13 @@ void MpcController::set_config(const Config & config)
 ////////////////////////////////////////////////////////////////////////////////
 Command MpcController::compute_command_impl(const State & state)
 {
+  const auto start = std::chrono::steady_clock::now();
   const auto current_idx = get_current_state_temporal_index();
 
   auto cold_start = update_references(current_idx);
   const auto dt = x0_time_offset(state, current_idx);
   initial_conditions(predict(state.state, dt));
+  m_solution_x0_time = time_utils::from_message(state.header.stamp) + dt;
   {
     static_assert(sizeof(std::size_t) >= sizeof(Index), "static cast might truncate");
     // This HAS to happen after initial conditions; relies on x0 being set
@@ -107,26 +115,52 @@ Command MpcController::compute_command_impl(const State & state)
     cold_start = ensure_reference_consistency(horizon) || cold_start;
     // Consider different ways of updating initial guess for reference update
   }
+  // The preparation done after the previous command is only valid if the problem is the same,
+  // apart from x0 which only enters the feedback phase
+  auto prepared = false;
+  if (!cold_start && !m_prepared_inputs.empty()) {
+    get_preparation_inputs(m_current_inputs);
+    prepared = m_current_inputs == m_prepared_inputs;
+  }
+  m_prepared_inputs.clear();
+  if (!prepared) {
+    initialize_first_node();
+  }
   if (cold_start) {
-    std::fill(&acadoVariables.u[0U], &acadoVariables.u[HORIZON * NU], AcadoReal{});
+    initialize_controls();
     acado_initializeNodesByForwardSimulation();
   }
   // TODO(c.ho) further validation on state
-  solve();
+  solve(prepared);
   // Get result
-  return interpolated_command(dt);
+  const auto ret = interpolated_command(dt);
+  m_timing.total = std::chrono::steady_clock::now() - start;
+  return ret;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void MpcController::solve()
+Command MpcController::compute_fallback_command(const State & state)
 {
-  const auto prep_ret = acado_preparationStep();
-  if (0 != prep_ret) {
-    std::string err_str{"Solver preparation error: ", std::string::allocator_type{}};
-    err_str += std::to_string(prep_ret);
-    throw std::runtime_error{err_str};
+  if (!m_has_solution) {
+    return ControllerBase::compute_fallback_command(state);
   }
+  // The offset shrinks as time goes by, so the command is taken further along the solution
+  auto ret = interpolated_command(
+    m_solution_x0_time - time_utils::from_message(state.header.stamp));
+  ret.stamp = state.header.stamp;
+  return ret;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MpcController::solve(const bool prepared)
+{
+  m_timing.prepared_in_advance = prepared;
+  m_has_solution = false;
+  m_timing.preparation = prepared ? m_prepared_duration : prepare();
+  const auto start = std::chrono::steady_clock::now();
   const auto solve_ret = acado_feedbackStep();
+  m_timing.feedback = std::chrono::steady_clock::now() - start;
+  m_has_solution = (0 == solve_ret);
   if (0 != solve_ret) {
     std::string err_str{"Solver error: ", std::string::allocator_type{}};
     err_str += std::to_string(solve_ret);
@@ -134,10 +168,68 @@ void MpcController::solve()
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+std::chrono::nanoseconds MpcController::prepare()
+{
+  const auto start = std::chrono::steady_clock::now();
+  const auto prep_ret = acado_preparationStep();
+  const auto duration = std::chrono::steady_clock::now() - start;
+  if (0 != prep_ret) {
+    std::string err_str{"Solver preparation error: ", std::string::allocator_type{}};
+    err_str += std::to_string(prep_ret);
+    throw std::runtime_error{err_str};
+  }
+  return duration;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MpcController::prepare_next_command()
+{
+  m_prepared_inputs.clear();
+  if (get_reference_trajectory().points.empty()) {
+    return;
+  }
+  // Real-time iteration: linearize around the solution of the latest command, the feedback
+  // phase of the next command then only has to solve the QP for the new initial state
+  m_prepared_duration = prepare();
+  get_preparation_inputs(m_prepared_inputs);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MpcController::get_preparation_inputs(std::vector<double> & inputs) const
+{
+  // Everything the problem is built from except x0; bounds are included to be safe
+  inputs.clear();
+  const auto append = [&inputs](const auto & values) {
+      (void)inputs.insert(inputs.end(), std::begin(values), std::end(values));
+    };
+  append(acadoVariables.x);
+  append(acadoVariables.u);
+  append(acadoVariables.od);
+  append(acadoVariables.y);
+  append(acadoVariables.yN);
+  append(acadoVariables.W);
+  append(acadoVariables.WN);
+  append(acadoVariables.lbValues);
+  append(acadoVariables.ubValues);
+  append(acadoVariables.lbAValues);
+  append(acadoVariables.ubAValues);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const MpcController::SolverTiming & MpcController::get_solver_timing() const noexcept
+{
+  return m_timing;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool MpcController::update_references(const Index current_idx)
 {
-  const auto cold_start = Index{} == current_idx;
+  // By default, every command before the first reference point is passed starts cold. Shifting
+  // on new trajectories only starts cold when there is nothing to start from.
+  const auto cold_start = get_config().do_shift_on_new_trajectory() ?
+    (m_cold_start_pending || !m_has_solution) : (Index{} == current_idx);
+  m_cold_start_pending = false;
   // Roll forward previous solutions, references; backfill references or prune weights
   if (!cold_start) {
     const auto advance_idx = current_idx - m_last_reference_index;
@@ -167,6 +259,11 @@ void MpcController::initial_conditions(const Point & state)
   acadoVariables.x0[IDX_HEADING] =
     static_cast<AcadoReal>(motion_common::to_angle(state.heading));
   acadoVariables.x0[IDX_VEL_LONG] = static_cast<AcadoReal>(state.longitudinal_velocity_mps);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MpcController::initialize_first_node() noexcept
+{
   // Initialization stuff
   acadoVariables.x[IDX_X] = acadoVariables.x0[IDX_X];
   acadoVariables.x[IDX_Y] = acadoVariables.x0[IDX_Y];
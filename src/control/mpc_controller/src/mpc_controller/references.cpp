@@ -15,9 +15,13 @@
 // Treat as a system header since we don't want to touch that autogenerated stuff..
 #include <acado_common.h>
 #include <motion_common/motion_common.hpp>
+#include <time_utils/time_utils.hpp>
 
 #include <algorithm>
+#include <cmath>
+#include <memory>
 #include <stdexcept>
+#include <vector>
 
 #include "mpc_controller/mpc_controller.hpp"
 
@@ -38,10 +42,10 @@ constexpr auto NU = static_cast<std::size_t>(ACADO_NU);
 // State variables
 static_assert(ACADO_NX == 4, "Unexpected num of state variables");
 constexpr auto NX = static_cast<std::size_t>(ACADO_NX);
-// constexpr auto IDX_X = 0U;
-// constexpr auto IDX_Y = 1U;
+constexpr auto IDX_X = 0U;
+constexpr auto IDX_Y = 1U;
 constexpr auto IDX_HEADING = 2U;
-// constexpr auto IDX_VEL_LONG = 3U;
+constexpr auto IDX_VEL_LONG = 3U;
 static_assert(ACADO_NYN == 4, "Unexpected number of terminal reference variables");
 constexpr auto NYN = static_cast<std::size_t>(ACADO_NYN);
 constexpr auto IDYN_X = 0U;
@@ -192,6 +196,39 @@ void MpcController::backfill_reference(const Index count)
     zero_terminal_weights();
   }
 }
+////////////////////////////////////////////////////////////////////////////////
+bool MpcController::shift_to_new_trajectory(const Trajectory & traj)
+{
+  const auto & prev_traj = get_reference_trajectory();
+  if (prev_traj.points.size() <= m_last_reference_index ||
+    prev_traj.header.frame_id != traj.header.frame_id)
+  {
+    return false;
+  }
+  using time_utils::from_message;
+  // The first node of the current problem corresponds to the last reference index
+  const auto t_prev = from_message(prev_traj.header.stamp) +
+    from_message(prev_traj.points[m_last_reference_index].time_from_start);
+  const auto t_new =
+    from_message(traj.header.stamp) + from_message(traj.points.front().time_from_start);
+  const auto offset = t_new - t_prev;
+  if (offset < decltype(offset)::zero()) {
+    return false;
+  }
+  const auto count = (offset + (solver_time_step / 2)) / solver_time_step;
+  const auto remainder = offset - (count * solver_time_step);
+  const auto tolerance = get_config().sample_period_tolerance();
+  static_assert(sizeof(std::size_t) >= sizeof(Index), "static cast might truncate");
+  if ((static_cast<std::size_t>(count) >= HORIZON) || (remainder > tolerance) ||
+    (remainder < -tolerance))
+  {
+    return false;
+  }
+  // The references are replaced afterwards, only the solution is kept as initial guess
+  advance_problem(static_cast<Index>(count));
+  return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void MpcController::set_reference(
   const Trajectory & traj,
@@ -256,6 +293,9 @@ const Trajectory & MpcController::handle_new_trajectory(const Trajectory & traje
     sample(trajectory, *m_interpolated_trajectory, solver_time_step);
   }
   const auto & traj = m_interpolated_trajectory ? *m_interpolated_trajectory : trajectory;
+  // Needs to happen before the references are replaced
+  m_cold_start_pending =
+    !(get_config().do_shift_on_new_trajectory() && m_has_solution && shift_to_new_trajectory(traj));
   const auto t_max = std::min(static_cast<std::size_t>(traj.points.size()), HORIZON);
   set_reference(traj, Index{}, Index{}, t_max);
   const auto & weights = get_config().optimization_param();
@@ -279,6 +319,108 @@ const Trajectory & MpcController::handle_new_trajectory(const Trajectory & traje
 
   return traj;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+void MpcController::set_warm_start_table(const WarmStartTable & table)
+{
+  if (table.sequence_size() != (HORIZON * NU)) {
+    throw std::domain_error{"Warm start table sequences don't match the solver horizon"};
+  }
+  m_warm_start_table = std::make_unique<WarmStartTable>(table);
+  m_warm_start_sequence.resize(table.sequence_size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MpcController::initialize_controls()
+{
+  if (!m_warm_start_table) {
+    std::fill(&acadoVariables.u[0U], &acadoVariables.u[HORIZON * NU], AcadoReal{});
+    return;
+  }
+  // The errors of x0 in the frame of the first reference point
+  const auto heading = acadoVariables.y[IDY_HEADING];
+  const auto dx = acadoVariables.x0[IDX_X] - acadoVariables.y[IDY_X];
+  const auto dy = acadoVariables.x0[IDX_Y] - acadoVariables.y[IDY_Y];
+  const auto dth = acadoVariables.x0[IDX_HEADING] - heading;
+  // The curvature up to the next reference point, the headings are unwrapped at this point
+  const auto ds = std::hypot(
+    acadoVariables.y[NY + IDY_X] - acadoVariables.y[IDY_X],
+    acadoVariables.y[NY + IDY_Y] - acadoVariables.y[IDY_Y]);
+  constexpr auto MIN_DISTANCE = AcadoReal{1.0E-3};
+  const auto curvature = (ds > MIN_DISTANCE) ?
+    ((acadoVariables.y[NY + IDY_HEADING] - heading) / ds) : AcadoReal{};
+  const WarmStartKey key{
+    static_cast<Real>(acadoVariables.x0[IDX_VEL_LONG]),
+    static_cast<Real>(curvature),
+    static_cast<Real>((std::cos(heading) * dy) - (std::sin(heading) * dx)),
+    static_cast<Real>(std::atan2(std::sin(dth), std::cos(dth)))};
+  m_warm_start_table->interpolate(key, m_warm_start_sequence);
+  (void)std::transform(
+    m_warm_start_sequence.begin(), m_warm_start_sequence.end(), &acadoVariables.u[0U],
+    [](const Real u) {return static_cast<AcadoReal>(u);});
+}
+
+////////////////////////////////////////////////////////////////////////////////
+WarmStartTable MpcController::generate_warm_start_table(
+  const WarmStartTable::Axes & axes,
+  const Index iterations)
+{
+  if (!get_reference_trajectory().points.empty()) {
+    throw std::logic_error{"Warm start table must be generated before the first trajectory"};
+  }
+  if (Index{} == iterations) {
+    throw std::domain_error{"Warm start table generation needs at least one iteration"};
+  }
+  WarmStartTable table{axes, HORIZON * NU};
+  std::vector<Real> sequence(table.sequence_size());
+  Trajectory traj{rosidl_runtime_cpp::MessageInitialization::ALL};
+  traj.points.resize(HORIZON + 1U);
+  const auto & weights = get_config().optimization_param();
+  for (Index idx = {}; idx < table.size(); ++idx) {
+    const auto key = table.node(idx);
+    // Arc of constant speed and curvature from the origin along the x axis
+    for (Index i = {}; i < traj.points.size(); ++i) {
+      auto & pt = traj.points[i];
+      const auto t = i * solver_time_step;
+      const auto s = key.speed_mps * std::chrono::duration<Real>{t}.count();
+      const auto th = key.curvature * s;
+      constexpr auto MIN_CURVATURE = Real{1.0E-6F};
+      const auto is_straight = std::fabs(key.curvature) < MIN_CURVATURE;
+      pt.x = is_straight ? s : (std::sin(th) / key.curvature);
+      pt.y = is_straight ? Real{} : ((Real{1.0F} - std::cos(th)) / key.curvature);
+      pt.heading = motion_common::from_angle(th);
+      pt.longitudinal_velocity_mps = key.speed_mps;
+      pt.time_from_start = time_utils::to_message(t);
+    }
+    set_reference(traj, Index{}, Index{}, HORIZON);
+    apply_nominal_weights(weights.nominal(), Index{}, HORIZON);
+    set_terminal_reference(traj.points[HORIZON]);
+    set_terminal_weights(weights.terminal());
+    Point x0{rosidl_runtime_cpp::MessageInitialization::ALL};
+    x0.y = key.lateral_error_m;
+    x0.heading = motion_common::from_angle(key.heading_error_rad);
+    x0.longitudinal_velocity_mps = key.speed_mps;
+    initial_conditions(x0);
+    (void)ensure_reference_consistency(HORIZON);
+    initialize_first_node();
+    std::fill(&acadoVariables.u[0U], &acadoVariables.u[HORIZON * NU], AcadoReal{});
+    acado_initializeNodesByForwardSimulation();
+    // Each solve is one SQP iteration from the previous solution
+    for (Index i = {}; i < iterations; ++i) {
+      solve(false);
+    }
+    (void)std::transform(
+      &acadoVariables.u[0U], &acadoVariables.u[HORIZON * NU], sequence.begin(),
+      [](const AcadoReal u) {return static_cast<Real>(u);});
+    table.set_sequence(idx, sequence);
+  }
+  // Nothing of the synthetic problems is used by the next command
+  apply_config(m_config);
+  m_has_solution = false;
+  m_cold_start_pending = true;
+  m_prepared_inputs.clear();
+  return table;
+}
 }  // namespace mpc_controller
 }  // namespace control
 }  // namespace motion
@@ -0,0 +1,146 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mpc_controller/warm_start_table.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace motion
+{
+namespace control
+{
+namespace mpc_controller
+{
+constexpr Index WarmStartTable::NUM_AXES;
+
+namespace
+{
+std::array<Real, WarmStartTable::NUM_AXES> to_array(const WarmStartKey & key) noexcept
+{
+  return {key.speed_mps, key.curvature, key.lateral_error_m, key.heading_error_rad};
+}
+}  // namespace
+
+WarmStartTable::WarmStartTable(const Axes & axes, const Index sequence_size)
+: m_axes{axes},
+  m_sequence_size{sequence_size},
+  m_size{1U}
+{
+  for (const auto & axis : m_axes) {
+    if (Index{} == axis.count) {
+      throw std::domain_error{"Warm start table axis must have at least one node"};
+    }
+    if ((axis.count > 1U) && !(axis.max > axis.min)) {
+      throw std::domain_error{"Warm start table axis with several nodes must have max > min"};
+    }
+    m_size *= axis.count;
+  }
+  if (Index{} == m_sequence_size) {
+    throw std::domain_error{"Warm start table sequences must not be empty"};
+  }
+  m_sequences.resize(m_size * m_sequence_size, Real{});
+}
+
+const WarmStartTable::Axes & WarmStartTable::axes() const noexcept
+{
+  return m_axes;
+}
+
+Index WarmStartTable::size() const noexcept
+{
+  return m_size;
+}
+
+Index WarmStartTable::sequence_size() const noexcept
+{
+  return m_sequence_size;
+}
+
+WarmStartKey WarmStartTable::node(Index idx) const
+{
+  if (idx >= m_size) {
+    throw std::out_of_range{"Warm start table node index out of range"};
+  }
+  std::array<Real, NUM_AXES> values{};
+  for (Index a = {}; a < NUM_AXES; ++a) {
+    const auto & axis = m_axes[a];
+    const auto i = idx % axis.count;
+    idx /= axis.count;
+    values[a] = (axis.count > 1U) ?
+      (axis.min + (((axis.max - axis.min) * static_cast<Real>(i)) /
+      static_cast<Real>(axis.count - 1U))) : axis.min;
+  }
+  return WarmStartKey{values[0U], values[1U], values[2U], values[3U]};
+}
+
+void WarmStartTable::set_sequence(const Index idx, const std::vector<Real> & sequence)
+{
+  if (idx >= m_size) {
+    throw std::out_of_range{"Warm start table node index out of range"};
+  }
+  if (sequence.size() != m_sequence_size) {
+    throw std::domain_error{"Warm start sequence size does not match the table"};
+  }
+  (void)std::copy(
+    sequence.begin(), sequence.end(),
+    m_sequences.begin() + static_cast<std::ptrdiff_t>(idx * m_sequence_size));
+}
+
+void WarmStartTable::interpolate(const WarmStartKey & key, std::vector<Real> & sequence) const
+{
+  // Lower node, fraction towards the upper node and stride of each axis
+  std::array<Index, NUM_AXES> lower{};
+  std::array<Real, NUM_AXES> fraction{};
+  std::array<Index, NUM_AXES> stride{};
+  const auto values = to_array(key);
+  Index axis_stride = m_sequence_size;
+  for (Index a = {}; a < NUM_AXES; ++a) {
+    const auto & axis = m_axes[a];
+    stride[a] = axis_stride;
+    axis_stride *= axis.count;
+    if (axis.count < 2U) {
+      continue;
+    }
+    const auto last = static_cast<Real>(axis.count - 1U);
+    const auto t = std::min(
+      std::max(((values[a] - axis.min) / (axis.max - axis.min)) * last, Real{}), last);
+    lower[a] = std::min(static_cast<Index>(std::floor(t)), axis.count - 2U);
+    fraction[a] = t - static_cast<Real>(lower[a]);
+  }
+  sequence.resize(m_sequence_size);
+  std::fill(sequence.begin(), sequence.end(), Real{});
+  // Corners of the cell, a set bit meaning the upper node of the axis
+  for (Index corner = {}; corner < (Index{1U} << NUM_AXES); ++corner) {
+    auto weight = Real{1.0F};
+    auto offset = Index{};
+    for (Index a = {}; a < NUM_AXES; ++a) {
+      const auto is_upper = ((corner >> a) & 1U) != 0U;
+      weight *= is_upper ? fraction[a] : (Real{1.0F} - fraction[a]);
+      offset += (lower[a] + (is_upper ? 1U : 0U)) * stride[a];
+    }
+    // Also skips the missing upper nodes of axes with a single node
+    if (weight <= Real{}) {
+      continue;
+    }
+    for (Index i = {}; i < m_sequence_size; ++i) {
+      sequence[i] += weight * m_sequences[offset + i];
+    }
+  }
+}
+}  // namespace mpc_controller
+}  // namespace control
+}  // namespace motion
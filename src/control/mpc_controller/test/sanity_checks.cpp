@@ -16,6 +16,7 @@
 #include <motion_testing/motion_testing.hpp>
 #include <time_utils/time_utils.hpp>
 
+#include <stdexcept>
 #include <vector>
 
 using motion::control::controller_common::ControlReference;
@@ -27,6 +28,7 @@ using motion::control::mpc_controller::LimitsConfig;
 using motion::control::mpc_controller::OptimizationConfig;
 using motion::control::mpc_controller::VehicleConfig;
 using motion::control::mpc_controller::Interpolation;
+using motion::control::mpc_controller::TrajectoryUpdate;
 using motion::control::mpc_controller::MpcController;
 using motion::motion_testing::make_state;
 using motion::motion_testing::constant_velocity_trajectory;
@@ -142,6 +144,21 @@ protected:
       Interpolation::NO}};
 };  // class sanity_checks_no_interpolation
 
+class sanity_checks_shift : public sanity_checks_base
+{
+protected:
+  MpcController controller_{
+    Config{
+      limits_cfg_,
+      vehicle_cfg_,
+      behavior_cfg_,
+      opt_cfg_,
+      std::chrono::milliseconds(5LL),  // sample_period_tolerance
+      std::chrono::milliseconds(100LL),  // control_lookahead_duration
+      Interpolation::YES,
+      TrajectoryUpdate::SHIFT}};
+};  // class sanity_checks_shift
+
 TEST_F(sanity_checks_no_interpolation, bad_trajectory_sample_interval)
 {
   const auto dt = controller_.get_config().behavior().time_step();
@@ -281,6 +298,122 @@ TEST_F(sanity_checks, lateral_offset)
   }
 }
 
+// Cold starts interpolate the solutions of the warm start table
+TEST_F(sanity_checks, warm_start_table)
+{
+  using motion::control::mpc_controller::WarmStartKey;
+  using motion::control::mpc_controller::WarmStartTable;
+  const WarmStartTable::Axes axes{{
+    {10.0F, 10.0F, 1U},  // speed
+    {0.0F, 0.0F, 1U},  // curvature
+    {-3.0F, 3.0F, 3U},  // lateral error
+    {0.0F, 0.0F, 1U}  // heading error
+  }};
+  const auto table = controller_.generate_warm_start_table(axes, 10U);
+  ASSERT_EQ(table.size(), 3U);
+  // The solutions steer back towards the reference, the second control is the steering
+  std::vector<Real> sequence;
+  table.interpolate(WarmStartKey{10.0F, 0.0F, -3.0F, 0.0F}, sequence);
+  EXPECT_GT(sequence[1U], 0.0F);
+  table.interpolate(WarmStartKey{10.0F, 0.0F, 3.0F, 0.0F}, sequence);
+  EXPECT_LT(sequence[1U], 0.0F);
+  controller_.set_warm_start_table(table);
+
+  const auto dt = std::chrono::milliseconds(100LL);
+  const auto traj = constant_velocity_trajectory(0.0F, 0.0F, 0.0F, 10.0F, dt);
+  const auto state =
+    make_state(0.0F, -3.0F, 0.0F, 10.0F, 0.0F, 0.0F, from_message(traj.header.stamp));
+  apex_test_tools::memory_test::start();
+  controller_.set_trajectory(traj);
+  const auto cmd = controller_.compute_command(state);
+  apex_test_tools::memory_test::stop();
+  EXPECT_GT(cmd.front_wheel_angle_rad, 0.0F);
+  // The solver state can't be overwritten any more, and the horizon must match
+  EXPECT_THROW(controller_.generate_warm_start_table(axes, 10U), std::logic_error);
+  EXPECT_THROW(controller_.set_warm_start_table(WarmStartTable{axes, 1U}), std::domain_error);
+  if (HasFailure()) {
+    controller_.debug_print(std::cout);
+  }
+}
+
+// The preparation done after a command is used by the next one as long as the problem is the same
+TEST_F(sanity_checks, prepare_next_command)
+{
+  const auto dt = std::chrono::milliseconds(100LL);
+  const auto traj = constant_velocity_trajectory(0.0F, 0.0F, 0.0F, 10.0F, dt);
+  ASSERT_GT(traj.points.size(), 6U);
+  const auto state_at = [&traj](const std::size_t idx) {
+      const auto stamp =
+        from_message(traj.header.stamp) + from_message(traj.points[idx].time_from_start);
+      const auto & pt = traj.points[idx];
+      return make_state(pt.x, pt.y - 1.0F, 0.0F, 10.0F, 0.0F, 0.0F, stamp);
+    };
+  const auto state1 = state_at(5U);
+  controller_.set_trajectory(traj);
+  (void)controller_.compute_command(state1);
+  EXPECT_FALSE(controller_.get_solver_timing().prepared_in_advance);
+  controller_.prepare_next_command();
+  apex_test_tools::memory_test::start();
+  const auto cmd = controller_.compute_command(state1);
+  apex_test_tools::memory_test::stop();
+  const auto & timing = controller_.get_solver_timing();
+  EXPECT_TRUE(timing.prepared_in_advance);
+  EXPECT_GT(timing.feedback, std::chrono::nanoseconds::zero());
+  EXPECT_GE(timing.total, timing.feedback);
+  EXPECT_GT(cmd.front_wheel_angle_rad, 0.0F);
+  // Advancing along the trajectory changes the problem, so it has to be prepared again
+  controller_.prepare_next_command();
+  (void)controller_.compute_command(state_at(6U));
+  EXPECT_FALSE(controller_.get_solver_timing().prepared_in_advance);
+  EXPECT_GT(controller_.get_solver_timing().preparation, std::chrono::nanoseconds::zero());
+  if (HasFailure()) {
+    controller_.debug_print(std::cout);
+  }
+}
+
+// A new trajectory continuing the previous one starts from the shifted previous solution
+TEST_F(sanity_checks_shift, shift_on_new_trajectory)
+{
+  const auto dt = controller_.get_config().behavior().time_step();
+  const auto traj1 = constant_velocity_trajectory(0.0F, 0.0F, 0.0F, 10.0F, dt);
+  const auto t1 = from_message(traj1.header.stamp);
+  const auto state1 = make_state(0.0F, -1.0F, 0.0F, 10.0F, 0.0F, 0.0F, t1);
+  controller_.set_trajectory(traj1);
+  for (auto i = 0; i < 5; ++i) {
+    (void)controller_.compute_command(state1);
+  }
+  // Same path, starting 5 steps later
+  constexpr auto offset = 5U;
+  auto traj2 = constant_velocity_trajectory(traj1.points[offset].x, 0.0F, 0.0F, 10.0F, dt);
+  traj2.header.stamp = to_message(t1 + (offset * dt));
+  const auto prev_plan = controller_.get_computed_trajectory();
+  ASSERT_GT(prev_plan.points.size(), offset + 2U);
+  controller_.set_trajectory(traj2);
+  {
+    const auto & plan = controller_.get_computed_trajectory();
+    EXPECT_FLOAT_EQ(plan.points[1U].x, prev_plan.points[offset + 1U].x);
+    EXPECT_FLOAT_EQ(plan.points[1U].y, prev_plan.points[offset + 1U].y);
+  }
+  const auto t2 = from_message(traj2.header.stamp);
+  const auto state2 = make_state(traj2.points[0U].x, -1.0F, 0.0F, 10.0F, 0.0F, 0.0F, t2);
+  apex_test_tools::memory_test::start();
+  const auto cmd = controller_.compute_command(state2);
+  apex_test_tools::memory_test::stop();
+  EXPECT_GT(cmd.front_wheel_angle_rad, 0.0F);
+  // A trajectory which doesn't line up in time leaves the solution as it is
+  const auto plan2 = controller_.get_computed_trajectory();
+  auto traj3 = traj2;
+  traj3.header.stamp = to_message(t1 + (offset * dt) + (dt / 2));
+  controller_.set_trajectory(traj3);
+  {
+    const auto & plan = controller_.get_computed_trajectory();
+    EXPECT_FLOAT_EQ(plan.points[1U].x, plan2.points[1U].x);
+  }
+  if (HasFailure()) {
+    controller_.debug_print(std::cout);
+  }
+}
+
 // bad heading value in trajectory, should throw due to bad solution with Nan.
 TEST_F(sanity_checks, bad_trajectory_heading)
 {
@@ -0,0 +1,78 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <gtest/gtest.h>
+#include <mpc_controller/warm_start_table.hpp>
+
+#include <stdexcept>
+#include <vector>
+
+using motion::control::mpc_controller::Index;
+using motion::control::mpc_controller::Real;
+using motion::control::mpc_controller::WarmStartKey;
+using motion::control::mpc_controller::WarmStartTable;
+
+// The sequences are interpolated multilinearly between the nodes and clamped outside of the grid
+TEST(warm_start_table, interpolate)
+{
+  const WarmStartTable::Axes axes{{
+    {0.0F, 20.0F, 3U},  // speed
+    {-0.1F, 0.1F, 2U},  // curvature
+    {-1.0F, 1.0F, 2U},  // lateral error
+    {0.0F, 0.0F, 1U}  // heading error
+  }};
+  WarmStartTable table{axes, 2U};
+  ASSERT_EQ(table.size(), 12U);
+  // The sequence of each node is linear in its key
+  const auto linear = [](const WarmStartKey & key) {
+      return std::vector<Real>{
+        key.speed_mps + (10.0F * key.curvature),
+        key.lateral_error_m - key.heading_error_rad};
+    };
+  for (Index idx = {}; idx < table.size(); ++idx) {
+    table.set_sequence(idx, linear(table.node(idx)));
+  }
+  const auto first = table.node(1U);
+  EXPECT_FLOAT_EQ(first.speed_mps, 10.0F);
+  EXPECT_FLOAT_EQ(first.curvature, -0.1F);
+  std::vector<Real> sequence;
+  const WarmStartKey inside{13.0F, 0.02F, -0.4F, 0.5F};
+  table.interpolate(inside, sequence);
+  ASSERT_EQ(sequence.size(), 2U);
+  EXPECT_NEAR(sequence[0U], 13.2F, 1.0E-5F);
+  // The single heading error node is used for any heading error
+  EXPECT_NEAR(sequence[1U], -0.4F, 1.0E-5F);
+  const WarmStartKey outside{25.0F, -0.3F, 2.0F, 0.0F};
+  table.interpolate(outside, sequence);
+  EXPECT_NEAR(sequence[0U], 19.0F, 1.0E-5F);
+  EXPECT_NEAR(sequence[1U], 1.0F, 1.0E-5F);
+
+  EXPECT_THROW(table.node(12U), std::out_of_range);
+  EXPECT_THROW(table.set_sequence(12U, sequence), std::out_of_range);
+  EXPECT_THROW(table.set_sequence(0U, std::vector<Real>(3U)), std::domain_error);
+}
+
+TEST(warm_start_table, bad_axes)
+{
+  WarmStartTable::Axes axes{{
+    {0.0F, 20.0F, 3U},
+    {-0.1F, 0.1F, 2U},
+    {-1.0F, 1.0F, 2U},
+    {0.0F, 0.0F, 1U}
+  }};
+  EXPECT_THROW(WarmStartTable(axes, 0U), std::domain_error);
+  axes[3U].count = 0U;
+  EXPECT_THROW(WarmStartTable(axes, 2U), std::domain_error);
+  axes[3U].count = 2U;
+  EXPECT_THROW(WarmStartTable(axes, 2U), std::domain_error);
+}
@@ -17,6 +17,7 @@
 #include <mpc_controller_nodes/visibility_control.hpp>
 #include <controller_common_nodes/controller_base_node.hpp>
 #include <mpc_controller/mpc_controller.hpp>
+#include <autoware_auto_msgs/msg/diagnostic_header.hpp>
 
 #include <string>
 
@@ -44,7 +45,15 @@ public:
     const std::string & static_tf_topic,
     const mpc_controller::Config & config);
 
+protected:
+  /// Prepares the next command and publishes the solver timing of the latest command
+  void on_command_published(const controller_common_nodes::State & state) override;
+
 private:
+  using DiagnosticHeader = autoware_auto_msgs::msg::DiagnosticHeader;
+  // Non-owning, the controller is owned by the parent class
+  const mpc_controller::MpcController * m_mpc_controller{nullptr};
+  rclcpp::Publisher<DiagnosticHeader>::SharedPtr m_solver_timing_pub{};
   rclcpp::Publisher<autoware_auto_msgs::msg::Trajectory>::SharedPtr m_debug_traj_pub{};
   rclcpp::TimerBase::SharedPtr m_debug_timer{};
 };  // class MpcControllerNode
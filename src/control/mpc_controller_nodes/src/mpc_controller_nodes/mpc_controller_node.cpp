@@ -14,7 +14,11 @@
 
 #include "mpc_controller_nodes/mpc_controller_node.hpp"
 
+#include <time_utils/time_utils.hpp>
+
+#include <chrono>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <utility>
 
@@ -129,6 +133,11 @@ MpcControllerNode::MpcControllerNode(const std::string & name, const std::string
   if (declare_parameter("controller.interpolation").get<bool>()) {
     interpolation = Interpolation::YES;
   }
+  using mpc_controller::TrajectoryUpdate;
+  auto trajectory_update = TrajectoryUpdate::RESTART;
+  if (declare_parameter("controller.shift_on_new_trajectory", false)) {
+    trajectory_update = TrajectoryUpdate::SHIFT;
+  }
   const auto sample_tolerance_ms =
     std::chrono::milliseconds(declare_parameter("controller.sample_tolerance_ms").get<int64_t>());
 
@@ -143,14 +152,41 @@ MpcControllerNode::MpcControllerNode(const std::string & name, const std::string
           weights,
           sample_tolerance_ms,
           control_lookahead_ms,
-          interpolation});
+          interpolation,
+          trajectory_update});
   // I argue this is ok for the following reasons:
   // The parent class, ControllerBaseNode, has unique ownership of the controller, and the timer
   // only has a non-owning pointer. This is fine because the timer can never go out of scope before
   // the base class (and thus the owning pointer)
+  // Warm start table for cold starts, solved once at startup
+  if (declare_parameter("controller.warm_start.enabled", false)) {
+    const auto axis = [this](const std::string & name) {
+        const auto prefix = "controller.warm_start." + name;
+        return mpc_controller::WarmStartAxis{
+          static_cast<Real>(declare_parameter(prefix + ".min").get<double>()),
+          static_cast<Real>(declare_parameter(prefix + ".max").get<double>()),
+          static_cast<mpc_controller::Index>(
+            declare_parameter(prefix + ".count").get<int64_t>())};
+      };
+    const mpc_controller::WarmStartTable::Axes axes{
+      axis("speed_mps"), axis("curvature"), axis("lateral_error_m"), axis("heading_error_rad")};
+    const auto iterations = declare_parameter("controller.warm_start.iterations", 10);
+    if (iterations < 1) {
+      throw std::domain_error{"controller.warm_start.iterations must be positive"};
+    }
+    controller->set_warm_start_table(
+      controller->generate_warm_start_table(axes, static_cast<mpc_controller::Index>(iterations)));
+  }
   const auto ctrl_ptr = controller.get();
+  m_mpc_controller = ctrl_ptr;
   set_controller(std::move(controller));
 
+  // The preparation, feedback and total time of the solver, published after every command
+  if (declare_parameter("publish_solver_timing", false)) {
+    m_solver_timing_pub =
+      create_publisher<DiagnosticHeader>("mpc_solver_timing", rclcpp::QoS{10LL});
+  }
+
   const auto debug_cycle_duration_param = declare_parameter("debug_trajectory_publish_period_ms");
   if (rclcpp::PARAMETER_INTEGER == debug_cycle_duration_param.get_type()) {
     const auto cycle_duration =
@@ -190,7 +226,32 @@ MpcControllerNode::MpcControllerNode(
     diagnostic_topic,
     static_tf_topic}
 {
-  set_controller(std::make_unique<mpc_controller::MpcController>(config));
+  auto controller = std::make_unique<mpc_controller::MpcController>(config);
+  m_mpc_controller = controller.get();
+  set_controller(std::move(controller));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void MpcControllerNode::on_command_published(const controller_common_nodes::State & state)
+{
+  // Get the timing of the command first, the preparation is for the next one
+  const auto timing = m_mpc_controller->get_solver_timing();
+  ControllerBaseNode::on_command_published(state);
+  if (m_solver_timing_pub) {
+    DiagnosticHeader msg;
+    msg.data_stamp = state.header.stamp;
+    msg.computation_start = time_utils::to_message(std::chrono::system_clock::now());
+    const auto publish_duration = [this, &msg](const char * name, std::chrono::nanoseconds t) {
+        msg.name = name;
+        msg.runtime = time_utils::to_message(t);
+        m_solver_timing_pub->publish(msg);
+      };
+    const auto preparation_name =
+      timing.prepared_in_advance ? "preparation_in_advance" : "preparation";
+    publish_duration(preparation_name, timing.preparation);
+    publish_duration("feedback", timing.feedback);
+    publish_duration("total", timing.total);
+  }
 }
 }  // namespace mpc_controller_nodes
 }  // namespace control
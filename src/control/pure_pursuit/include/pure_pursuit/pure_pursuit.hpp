@@ -56,6 +56,10 @@ protected:
   /// \param[in] state The current position and velocity information
   /// \return the command for the vehicle control
   VehicleControlCommand compute_command_impl(const TrajectoryPointStamped & state) override;
+  /// \brief Reset the lookahead point search, which resumes from the previous target otherwise
+  /// \param[in] trajectory The new reference trajectory
+  /// \return The trajectory, unchanged
+  const Trajectory & handle_new_trajectory(const Trajectory & trajectory) override;
 
 private:
   /// \brief Compute error of the current vehicle state by comparing the nearest neighbor
@@ -85,7 +89,8 @@ private:
     const TrajectoryPoint & current_point,
     const TrajectoryPoint & target_point,
     const uint32_t idx);
-  /// \brief Compute the target point using the current pose and the trajectory
+  /// \brief Compute the target point using the current pose and the trajectory. The search for
+  ///        the first point beyond the lookahead distance resumes from the previous target
   /// \param[in] current_point The current position and velocity information
   /// \return True if the controller get the current target point
   PURE_PURSUIT_LOCAL bool8_t compute_target_point(const TrajectoryPoint & current_point);
@@ -121,6 +126,8 @@ private:
   Config m_config;
 
   uint32_t m_iterations;
+  /// Index of the last target point, where the next lookahead point search starts
+  uint32_t m_target_index;
 };  // class PurePursuit
 }  // namespace pure_pursuit
 }  // namespace control
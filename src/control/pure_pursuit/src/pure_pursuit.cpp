@@ -41,10 +41,19 @@ PurePursuit::PurePursuit(const Config & cfg)
   m_target_point{},
   m_command{},
   m_config(cfg),
-  m_iterations(0U)
+  m_iterations(0U),
+  m_target_index(0U)
 {
 }
 
+////////////////////////////////////////////////////////////////////////////////
+const Trajectory & PurePursuit::handle_new_trajectory(const Trajectory & trajectory)
+{
+  // The previous target index is meaningless on the new trajectory
+  m_target_index = 0U;
+  return trajectory;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 VehicleControlCommand PurePursuit::compute_command_impl(const TrajectoryPointStamped & current_pose)
 {
@@ -238,37 +247,50 @@ void PurePursuit::compute_interpolate_target_point(
 ////////////////////////////////////////////////////////////////////////////////
 bool8_t PurePursuit::compute_target_point(const TrajectoryPoint & current_point)
 {
-  auto idx = static_cast<uint32_t>(get_current_state_spatial_index());
-  bool8_t is_travel_direct = false;
-  uint32_t last_idx_for_noupdate = 0U;
   const auto & traj = get_reference_trajectory();
-  for (; idx < traj.points.size(); ++idx) {
-    const TrajectoryPoint & target_point = traj.points[idx];
-    // judge wheter the target point is in the forward of the traveling direction
-    if (in_traveling_direction(current_point, target_point)) {
-      is_travel_direct = true;
-      last_idx_for_noupdate = idx;
-
-      // Search the closest point over the lookahead distance
-      if ((sqrtf(compute_points_distance_squared(current_point, target_point)) >=
-        m_lookahead_distance))
-      {
-        if (m_config.get_is_interpolate_lookahead_point()) {
-          // interpolate points between idx-1 and idx
-          compute_interpolate_target_point(current_point, target_point, idx);
-        } else {
-          m_target_point = target_point;
-        }
-        break;
-      }
+  const auto size = static_cast<uint32_t>(traj.points.size());
+  const auto start_idx = static_cast<uint32_t>(get_current_state_spatial_index());
+  const float32_t lookahead_squared = m_lookahead_distance * m_lookahead_distance;
+  const auto is_target = [&](const uint32_t idx) -> bool8_t {
+      const TrajectoryPoint & point = traj.points[idx];
+      return (compute_points_distance_squared(current_point, point) >= lookahead_squared) &&
+             in_traveling_direction(current_point, point);
+    };
+  // The points before the previous target are assumed to lie within the lookahead circle, so the
+  // search resumes there. Step back in case the lookahead distance decreased since then.
+  auto idx = std::min(std::max(start_idx, m_target_index), size);
+  while ((idx > start_idx) && is_target(idx - 1U)) {
+    --idx;
+  }
+  for (; idx < size; ++idx) {
+    if (is_target(idx)) {
+      break;
     }
   }
 
   bool8_t is_success = true;
-  // If all points are within the distance threshold,
-  if (idx == traj.points.size()) {
+  if (idx < size) {
+    m_target_index = idx;
+    if (m_config.get_is_interpolate_lookahead_point()) {
+      // interpolate points between idx-1 and idx
+      compute_interpolate_target_point(current_point, traj.points[idx], idx);
+    } else {
+      m_target_point = traj.points[idx];
+    }
+  } else {
+    // If all points are within the distance threshold, use the farthest target index in the
+    // traveling direction. Only happens close to the end of the trajectory, so scan all points.
+    m_target_index = start_idx;
+    bool8_t is_travel_direct = false;
+    uint32_t last_idx_for_noupdate = 0U;
+    for (idx = start_idx; idx < size; ++idx) {
+      // judge wheter the target point is in the forward of the traveling direction
+      if (in_traveling_direction(current_point, traj.points[idx])) {
+        is_travel_direct = true;
+        last_idx_for_noupdate = idx;
+      }
+    }
     if (is_travel_direct) {
-      // use the farthest target index in the traveling direction
       m_target_point = traj.points[last_idx_for_noupdate];
     } else {
       // If the trajectory was not updated and there is no point in the traveling direction
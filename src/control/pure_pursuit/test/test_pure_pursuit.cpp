@@ -264,3 +264,36 @@ TEST_F(PurePursuitTest, replace_short_trajectory)
 
   EXPECT_NO_MEMORY_OPERATIONS_END();
 }
+
+TEST_F(PurePursuitTest, lookahead_search_resumes)
+{
+  const Config cfg(1.0F, 100.0F, 1.0F, false, false, 2.0F, 0.1F, 2.0F);
+  PurePursuit controller(cfg);
+  const float32_t dist_front_rear_wheels = cfg.get_distance_front_rear_wheel();
+
+  // The trajectory point k is at relative (k, k) from the vehicle, so the curvature is 1 / k
+  create_traj(traj, size);
+  create_current_pose(current_pose, 1.0F, 1.0F, 0.0F, 10.0F, 0.0F, 0.0F);
+
+  EXPECT_NO_MEMORY_OPERATIONS_BEGIN();
+  controller.set_trajectory(traj);
+  command = controller.compute_command(current_pose);
+  EXPECT_FLOAT_EQ(command.front_wheel_angle_rad, atanf(dist_front_rear_wheels / 8.0F));
+
+  // Shorter lookahead distance: the search steps back from the previous target
+  create_current_pose(current_pose, 1.0F, 1.0F, 0.0F, 3.0F, 0.0F, 0.0F);
+  command = controller.compute_command(current_pose);
+  EXPECT_FLOAT_EQ(command.front_wheel_angle_rad, atanf(dist_front_rear_wheels / 3.0F));
+
+  // Longer lookahead distance: the search continues from the previous target
+  create_current_pose(current_pose, 1.0F, 1.0F, 0.0F, 20.0F, 0.0F, 0.0F);
+  command = controller.compute_command(current_pose);
+  EXPECT_FLOAT_EQ(command.front_wheel_angle_rad, atanf(dist_front_rear_wheels / 15.0F));
+
+  // A new trajectory restarts the search
+  controller.set_trajectory(traj);
+  create_current_pose(current_pose, 1.0F, 1.0F, 0.0F, 3.0F, 0.0F, 0.0F);
+  command = controller.compute_command(current_pose);
+  EXPECT_FLOAT_EQ(command.front_wheel_angle_rad, atanf(dist_front_rear_wheels / 3.0F));
+  EXPECT_NO_MEMORY_OPERATIONS_END();
+}
@@ -141,6 +141,35 @@ struct MPCMatrix
   Eigen::MatrixXd Urefex;
   Eigen::MatrixXd Yrefex;
 };
+/**
+ * Storage of the QP problem built from the MPC matrices, kept between the control cycles so
+ * that it is only reallocated when the horizon or the vehicle model dimensions change
+ */
+struct MPCQPWorkspace
+{
+  //!< @brief Cex * Bex, block lower triangular
+  Eigen::MatrixXd CB;
+  //!< @brief Qex * Cex * Bex, block lower triangular
+  Eigen::MatrixXd QCB;
+  //!< @brief free response of the state: Aex * x0 + Wex
+  Eigen::VectorXd X;
+  //!< @brief free response of the output: Cex * (Aex * x0 + Wex)
+  Eigen::VectorXd CX;
+  //!< @brief hessian of the cost function
+  Eigen::MatrixXd H;
+  //!< @brief gradient of the cost function, as row vector
+  Eigen::MatrixXd f;
+  //!< @brief gradient of the cost function, as column vector passed to the solver
+  Eigen::MatrixXd f_vec;
+  //!< @brief constraint matrix of the steering rate
+  Eigen::MatrixXd A;
+  //!< @brief bounds of the steering angle
+  Eigen::VectorXd lb;
+  Eigen::VectorXd ub;
+  //!< @brief bounds of the steering rate
+  Eigen::VectorXd lbA;
+  Eigen::VectorXd ubA;
+};
 /**
  * MPC-based waypoints follower class
  * @brief calculate control command to follow reference waypoints
@@ -180,6 +209,10 @@ private:
   float64_t m_sign_vx = 0.0;
   //!< @brief buffer of sent command
   std::vector<autoware_auto_msgs::msg::AckermannLateralCommand> m_ctrl_cmd_vec;
+  //!< @brief MPC matrices, reused every control cycle
+  MPCMatrix m_mpc_matrix;
+  //!< @brief QP problem, reused every control cycle
+  MPCQPWorkspace m_qp_workspace;
 
   /**
    * @brief get variables for mpc calculation
@@ -220,8 +253,10 @@ private:
   /**
    * @brief generate MPC matrix with trajectory and vehicle model
    * @param [in] reference_trajectory used for linearization around reference trajectory
+   * @return the matrices, stored in this MPC until the next call
    */
-  MPCMatrix generateMPCMatrix(const trajectory_follower::MPCTrajectory & reference_trajectory);
+  const MPCMatrix & generateMPCMatrix(
+    const trajectory_follower::MPCTrajectory & reference_trajectory);
   /**
    * @brief generate MPC matrix with trajectory and vehicle model
    * @param [in] mpc_matrix parameters matrix to use for optimization
@@ -15,6 +15,8 @@
 #ifndef TRAJECTORY_FOLLOWER__QP_SOLVER__QP_SOLVER_OSQP_HPP_
 #define TRAJECTORY_FOLLOWER__QP_SOLVER__QP_SOLVER_OSQP_HPP_
 
+#include <vector>
+
 #include "trajectory_follower/qp_solver/qp_solver_interface.hpp"
 
 #include "common/types.hpp"
@@ -33,7 +35,9 @@ namespace trajectory_follower
 {
 using autoware::common::types::float64_t;
 using autoware::common::types::bool8_t;
-/// Solver for QP problems using the OSQP library
+/// Solver for QP problems using the OSQP library. The OSQP workspace is kept between the calls:
+/// while the dimensions and the sparsity pattern of the problem don't change, only its values are
+/// updated and the solver is warm started from the previous solution.
 class TRAJECTORY_FOLLOWER_PUBLIC QPSolverOSQP : public QPSolverInterface
 {
 public:
@@ -67,6 +71,11 @@ public:
 private:
   autoware::common::osqp::OSQPInterface osqpsolver_;
   rclcpp::Logger logger_;
+  // Problem data in the layout of OSQP, kept to avoid reallocations
+  Eigen::MatrixXd osqp_a_;
+  std::vector<float64_t> f_;
+  std::vector<float64_t> lower_bound_;
+  std::vector<float64_t> upper_bound_;
 };
 }  // namespace trajectory_follower
 }  // namespace control
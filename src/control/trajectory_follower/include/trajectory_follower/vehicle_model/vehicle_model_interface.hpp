@@ -15,6 +15,8 @@
 #ifndef TRAJECTORY_FOLLOWER__VEHICLE_MODEL__VEHICLE_MODEL_INTERFACE_HPP_
 #define TRAJECTORY_FOLLOWER__VEHICLE_MODEL__VEHICLE_MODEL_INTERFACE_HPP_
 
+#include <vector>
+
 #include "common/types.hpp"
 #include "eigen3/Eigen/Core"
 #include "trajectory_follower/visibility_control.hpp"
@@ -28,6 +30,12 @@ namespace control
 namespace trajectory_follower
 {
 using autoware::common::types::float64_t;
+using autoware::common::types::bool8_t;
+/**
+ * @brief states or inputs of several rollouts, one row per component and step, one column per
+ *        rollout. Each row is contiguous so that the rollouts are propagated together
+ */
+using RolloutMatrix = Eigen::Matrix<float64_t, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
 /**
  * Vehicle model class
  * @brief calculate model-related values
@@ -102,6 +110,58 @@ public:
    * @param [out] u_ref input
    */
   virtual void calculateReferenceInput(Eigen::MatrixXd & u_ref) = 0;
+
+  /**
+   * @brief propagate several input sequences from the same initial state with the discrete model
+   *        linearized at the current velocity and curvature. The model matrices are computed once
+   *        and applied to all the rollouts at each step
+   * @param [in] x0 initial state
+   * @param [in] u inputs, the rows k * dim_u to (k + 1) * dim_u - 1 are the inputs of step k
+   * @param [in] dt Discretization time [s]
+   * @param [out] x states after each step, the rows k * dim_x to (k + 1) * dim_x - 1 are the
+   *              states after step k
+   * @return false if the dimensions of the initial state or of the inputs don't match the model
+   */
+  bool8_t rollout(
+    const Eigen::VectorXd & x0, const RolloutMatrix & u, const float64_t dt, RolloutMatrix & x);
+
+  /**
+   * @brief propagate several input sequences like rollout(), with the model linearized at the
+   *        given velocity and curvature at each step, e.g. along a reference trajectory. The
+   *        velocity and curvature of the model are restored afterwards
+   * @param [in] x0 initial state
+   * @param [in] u inputs, the rows k * dim_u to (k + 1) * dim_u - 1 are the inputs of step k
+   * @param [in] velocity vehicle velocity at each step [m/s]
+   * @param [in] curvature curvature at each step
+   * @param [in] dt Discretization time [s]
+   * @param [out] x states after each step, the rows k * dim_x to (k + 1) * dim_x - 1 are the
+   *              states after step k
+   * @return false if the dimensions of the initial state, of the inputs or of the references
+   *         don't match
+   */
+  bool8_t rollout(
+    const Eigen::VectorXd & x0, const RolloutMatrix & u, const std::vector<float64_t> & velocity,
+    const std::vector<float64_t> & curvature, const float64_t dt, RolloutMatrix & x);
+
+private:
+  /**
+   * @brief check the dimensions of a rollout and size the output and the model matrices
+   * @return the number of steps, or a negative value if the dimensions don't match
+   */
+  int64_t prepareRollout(const Eigen::VectorXd & x0, const RolloutMatrix & u, RolloutMatrix & x);
+
+  /**
+   * @brief propagate all rollouts by one step with the current model matrices
+   * @param [in] step index of the step
+   */
+  void propagateRollout(
+    const int64_t step, const Eigen::VectorXd & x0, const RolloutMatrix & u, RolloutMatrix & x);
+
+  //!< @brief discrete model matrices of the rollouts, kept to avoid allocating them every step
+  Eigen::MatrixXd m_rollout_a_d;
+  Eigen::MatrixXd m_rollout_b_d;
+  Eigen::MatrixXd m_rollout_c_d;
+  Eigen::MatrixXd m_rollout_w_d;
 };
 }  // namespace trajectory_follower
 }  // namespace control
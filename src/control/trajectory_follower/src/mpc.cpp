@@ -75,7 +75,7 @@ bool8_t MPC::calculateMPC(
   }
 
   /* generate mpc matrix : predict equation Xec = Aex * x0 + Bex * Uex + Wex */
-  MPCMatrix mpc_matrix = generateMPCMatrix(mpc_resampled_ref_traj);
+  const MPCMatrix & mpc_matrix = generateMPCMatrix(mpc_resampled_ref_traj);
 
   /* solve quadratic optimization */
   Eigen::VectorXd Uex;
@@ -447,7 +447,7 @@ trajectory_follower::MPCTrajectory MPC::applyVelocityDynamicsFilter(
  * cost function: J = Xex' * Qex * Xex + (Uex - Uref)' * R1ex * (Uex - Urefex) + Uex' * R2ex * Uex
  * Qex = diag([Q,Q,...]), R1ex = diag([R,R,...])
  */
-MPCMatrix MPC::generateMPCMatrix(
+const MPCMatrix & MPC::generateMPCMatrix(
   const trajectory_follower::MPCTrajectory & reference_trajectory)
 {
   using Eigen::MatrixXd;
@@ -458,15 +458,16 @@ MPCMatrix MPC::generateMPCMatrix(
   const int64_t DIM_U = m_vehicle_model_ptr->getDimU();
   const int64_t DIM_Y = m_vehicle_model_ptr->getDimY();
 
-  MPCMatrix m;
-  m.Aex = MatrixXd::Zero(DIM_X * N, DIM_X);
-  m.Bex = MatrixXd::Zero(DIM_X * N, DIM_U * N);
-  m.Wex = MatrixXd::Zero(DIM_X * N, 1);
-  m.Cex = MatrixXd::Zero(DIM_Y * N, DIM_X * N);
-  m.Qex = MatrixXd::Zero(DIM_Y * N, DIM_Y * N);
-  m.R1ex = MatrixXd::Zero(DIM_U * N, DIM_U * N);
-  m.R2ex = MatrixXd::Zero(DIM_U * N, DIM_U * N);
-  m.Urefex = MatrixXd::Zero(DIM_U * N, 1);
+  // setZero only reallocates when the dimensions changed since the previous cycle
+  MPCMatrix & m = m_mpc_matrix;
+  m.Aex.setZero(DIM_X * N, DIM_X);
+  m.Bex.setZero(DIM_X * N, DIM_U * N);
+  m.Wex.setZero(DIM_X * N, 1);
+  m.Cex.setZero(DIM_Y * N, DIM_X * N);
+  m.Qex.setZero(DIM_Y * N, DIM_Y * N);
+  m.R1ex.setZero(DIM_U * N, DIM_U * N);
+  m.R2ex.setZero(DIM_U * N, DIM_U * N);
+  m.Urefex.setZero(DIM_U * N, 1);
 
   /* weight matrix depends on the vehicle model */
   MatrixXd Q = MatrixXd::Zero(DIM_Y, DIM_Y);
@@ -522,13 +523,13 @@ MPCMatrix MPC::generateMPCMatrix(
       m.Bex.block(0, 0, DIM_X, DIM_U) = Bd;
       m.Wex.block(0, 0, DIM_X, 1) = Wd;
     } else {
-      m.Aex.block(idx_x_i, 0, DIM_X, DIM_X) = Ad * m.Aex.block(idx_x_i_prev, 0, DIM_X, DIM_X);
-      for (int64_t j = 0; j < i; ++j) {
-        int64_t idx_u_j = j * DIM_U;
-        m.Bex.block(idx_x_i, idx_u_j, DIM_X, DIM_U) =
-          Ad * m.Bex.block(idx_x_i_prev, idx_u_j, DIM_X, DIM_U);
-      }
-      m.Wex.block(idx_x_i, 0, DIM_X, 1) = Ad * m.Wex.block(idx_x_i_prev, 0, DIM_X, 1) + Wd;
+      // the blocks of the previous step don't overlap the written ones, no temporaries needed
+      m.Aex.block(idx_x_i, 0, DIM_X, DIM_X).noalias() =
+        Ad * m.Aex.block(idx_x_i_prev, 0, DIM_X, DIM_X);
+      m.Bex.block(idx_x_i, 0, DIM_X, idx_u_i).noalias() =
+        Ad * m.Bex.block(idx_x_i_prev, 0, DIM_X, idx_u_i);
+      m.Wex.block(idx_x_i, 0, DIM_X, 1).noalias() = Ad * m.Wex.block(idx_x_i_prev, 0, DIM_X, 1);
+      m.Wex.block(idx_x_i, 0, DIM_X, 1) += Wd;
     }
     m.Bex.block(idx_x_i, idx_u_i, DIM_X, DIM_U) = Bd;
     m.Cex.block(idx_y_i, idx_x_i, DIM_Y, DIM_X) = Cd;
@@ -585,7 +586,6 @@ bool8_t MPC::executeOptimization(
   const MPCMatrix & m, const Eigen::VectorXd & x0, Eigen::VectorXd * Uex)
 {
   using Eigen::MatrixXd;
-  using Eigen::VectorXd;
 
   if (!isValid(m)) {
     RCLCPP_WARN_SKIPFIRST_THROTTLE(
@@ -593,33 +593,60 @@ bool8_t MPC::executeOptimization(
     return false;
   }
 
-  const int64_t DIM_U_N = m_param.prediction_horizon * m_vehicle_model_ptr->getDimU();
+  const int64_t N = m_param.prediction_horizon;
+  const int64_t DIM_X = m_vehicle_model_ptr->getDimX();
+  const int64_t DIM_U = m_vehicle_model_ptr->getDimU();
+  const int64_t DIM_Y = m_vehicle_model_ptr->getDimY();
+  const int64_t DIM_U_N = N * DIM_U;
+  MPCQPWorkspace & w = m_qp_workspace;
 
   // cost function: 1/2 * Uex' * H * Uex + f' * Uex,  H = B' * C' * Q * C * B + R
-  const MatrixXd CB = m.Cex * m.Bex;
-  const MatrixXd QCB = m.Qex * CB;
-  // MatrixXd H = CB.transpose() * QCB + m.R1ex + m.R2ex; // This calculation is heavy. looking for a good way.  //NOLINT
-  MatrixXd H = MatrixXd::Zero(DIM_U_N, DIM_U_N);
-  H.triangularView<Eigen::Upper>() = CB.transpose() * QCB;
-  H.triangularView<Eigen::Upper>() += m.R1ex + m.R2ex;
-  H.triangularView<Eigen::Lower>() = H.transpose();
-  MatrixXd f = (m.Cex * (m.Aex * x0 + m.Wex)).transpose() * QCB - m.Urefex.transpose() * m.R1ex;
-  addSteerWeightF(&f);
-
-  MatrixXd A = MatrixXd::Identity(DIM_U_N, DIM_U_N);
-  for (int64_t i = 1; i < DIM_U_N; i++) {
-    A(i, i - 1) = -1.0;
-  }
-
-  VectorXd lb = VectorXd::Constant(DIM_U_N, -m_steer_lim);  // min steering angle
-  VectorXd ub = VectorXd::Constant(DIM_U_N, m_steer_lim);   // max steering angle
-  VectorXd lbA = VectorXd::Constant(DIM_U_N, -m_steer_rate_lim * m_param.prediction_dt);
-  VectorXd ubA = VectorXd::Constant(DIM_U_N, m_steer_rate_lim * m_param.prediction_dt);
-  lbA(0, 0) = m_raw_steer_cmd_prev - m_steer_rate_lim * m_ctrl_period;
-  ubA(0, 0) = m_raw_steer_cmd_prev + m_steer_rate_lim * m_ctrl_period;
+  // Cex and Qex are block diagonal and Bex is block lower triangular: the output of step i only
+  // depends on the inputs up to step i, so only these blocks are multiplied instead of the full
+  // dense products.
+  w.CB.setZero(DIM_Y * N, DIM_U_N);
+  w.QCB.setZero(DIM_Y * N, DIM_U_N);
+  w.X.noalias() = m.Aex * x0;
+  w.X += m.Wex.col(0);
+  w.CX.resize(DIM_Y * N);
+  w.H = m.R1ex + m.R2ex;
+  for (int64_t i = 0; i < N; ++i) {
+    const int64_t idx_x_i = i * DIM_X;
+    const int64_t idx_y_i = i * DIM_Y;
+    const int64_t num_u = (i + 1) * DIM_U;
+    const auto Cd = m.Cex.block(idx_y_i, idx_x_i, DIM_Y, DIM_X);
+    const auto Qd = m.Qex.block(idx_y_i, idx_y_i, DIM_Y, DIM_Y);
+    auto CB_i = w.CB.block(idx_y_i, 0, DIM_Y, num_u);
+    auto QCB_i = w.QCB.block(idx_y_i, 0, DIM_Y, num_u);
+    CB_i.noalias() = Cd * m.Bex.block(idx_x_i, 0, DIM_X, num_u);
+    QCB_i.noalias() = Qd * CB_i;
+    w.H.topLeftCorner(num_u, num_u).triangularView<Eigen::Upper>() += CB_i.transpose() * QCB_i;
+    w.CX.segment(idx_y_i, DIM_Y).noalias() = Cd * w.X.segment(idx_x_i, DIM_X);
+  }
+  w.H.triangularView<Eigen::StrictlyLower>() = w.H.transpose();
+  w.f.noalias() = w.CX.transpose() * w.QCB;
+  w.f.noalias() -= m.Urefex.transpose() * m.R1ex;
+  addSteerWeightF(&w.f);
+  w.f_vec = w.f.transpose();
+
+  // the steering rate constraint only depends on the dimensions
+  if (w.A.rows() != DIM_U_N) {
+    w.A = MatrixXd::Identity(DIM_U_N, DIM_U_N);
+    for (int64_t i = 1; i < DIM_U_N; i++) {
+      w.A(i, i - 1) = -1.0;
+    }
+  }
+
+  w.lb.setConstant(DIM_U_N, -m_steer_lim);  // min steering angle
+  w.ub.setConstant(DIM_U_N, m_steer_lim);   // max steering angle
+  w.lbA.setConstant(DIM_U_N, -m_steer_rate_lim * m_param.prediction_dt);
+  w.ubA.setConstant(DIM_U_N, m_steer_rate_lim * m_param.prediction_dt);
+  w.lbA(0, 0) = m_raw_steer_cmd_prev - m_steer_rate_lim * m_ctrl_period;
+  w.ubA(0, 0) = m_raw_steer_cmd_prev + m_steer_rate_lim * m_ctrl_period;
 
   auto t_start = std::chrono::system_clock::now();
-  bool8_t solve_result = m_qpsolver_ptr->solve(H, f.transpose(), A, lb, ub, lbA, ubA, *Uex);
+  bool8_t solve_result = m_qpsolver_ptr->solve(
+    w.H, w.f_vec, w.A, w.lb, w.ub, w.lbA, w.ubA, *Uex);
   auto t_end = std::chrono::system_clock::now();
   if (!solve_result) {
     RCLCPP_WARN_SKIPFIRST_THROTTLE(m_logger, *m_clock, 1000 /*ms*/, "qp solver error");
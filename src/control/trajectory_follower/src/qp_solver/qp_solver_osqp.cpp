@@ -35,29 +35,32 @@ bool8_t QPSolverOSQP::solve(
   const Eigen::Index raw_a = a.rows();
   const Eigen::Index col_a = a.cols();
   const Eigen::Index dim_u = ub.size();
-  Eigen::MatrixXd Identity = Eigen::MatrixXd::Identity(dim_u, dim_u);
 
   // convert matrix to vector for osqpsolver
-  std::vector<float64_t> f(&f_vec(0), f_vec.data() + f_vec.cols() * f_vec.rows());
+  f_.assign(f_vec.data(), f_vec.data() + f_vec.cols() * f_vec.rows());
 
-  std::vector<float64_t> lower_bound;
-  std::vector<float64_t> upper_bound;
+  lower_bound_.clear();
+  upper_bound_.clear();
 
   for (int64_t i = 0; i < dim_u; ++i) {
-    lower_bound.push_back(lb(i));
-    upper_bound.push_back(ub(i));
+    lower_bound_.push_back(lb(i));
+    upper_bound_.push_back(ub(i));
   }
 
   for (int64_t i = 0; i < col_a; ++i) {
-    lower_bound.push_back(lb_a(i));
-    upper_bound.push_back(ub_a(i));
+    lower_bound_.push_back(lb_a(i));
+    upper_bound_.push_back(ub_a(i));
   }
 
-  Eigen::MatrixXd osqpA = Eigen::MatrixXd(dim_u + col_a, raw_a);
-  osqpA << Identity, a;
+  osqp_a_.resize(dim_u + col_a, raw_a);
+  osqp_a_ << Eigen::MatrixXd::Identity(dim_u, dim_u), a;
 
   /* execute optimization */
-  auto result = osqpsolver_.optimize(h_mat, osqpA, f, lower_bound, upper_bound);
+  // the problem of the previous call is updated if possible, otherwise it is set up again
+  const bool8_t updated = osqpsolver_.updateMatrices(h_mat, osqp_a_) &&
+    osqpsolver_.updateQ(f_) && osqpsolver_.updateBounds(lower_bound_, upper_bound_);
+  auto result = updated ? osqpsolver_.optimize() :
+    osqpsolver_.optimize(h_mat, osqp_a_, f_, lower_bound_, upper_bound_);
 
   std::vector<float64_t> U_osqp = std::get<0>(result);
   u =
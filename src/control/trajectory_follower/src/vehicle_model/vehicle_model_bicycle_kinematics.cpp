@@ -47,10 +47,12 @@ void KinematicsBicycleModel::calculateDiscreteMatrix(
   float64_t velocity = m_velocity;
   if (std::abs(m_velocity) < 1e-04) {velocity = 1e-04 * (m_velocity >= 0 ? 1 : -1);}
 
-  a_d << 0.0, velocity, 0.0, 0.0, 0.0, velocity / m_wheelbase * cos_delta_r_squared_inv, 0.0, 0.0,
+  // fixed size, so that the discretization is computed on the stack with a closed-form inverse
+  Eigen::Matrix3d a;
+  a << 0.0, velocity, 0.0, 0.0, 0.0, velocity / m_wheelbase * cos_delta_r_squared_inv, 0.0, 0.0,
     -1.0 / m_steer_tau;
-  Eigen::MatrixXd I = Eigen::MatrixXd::Identity(m_dim_x, m_dim_x);
-  a_d = (I - dt * 0.5 * a_d).inverse() * (I + dt * 0.5 * a_d);  // bilinear discretization
+  const Eigen::Matrix3d I = Eigen::Matrix3d::Identity();
+  a_d.noalias() = (I - dt * 0.5 * a).inverse() * (I + dt * 0.5 * a);  // bilinear discretization
 
   b_d << 0.0, 0.0, 1.0 / m_steer_tau;
   b_d *= dt;
@@ -45,9 +45,7 @@ void KinematicsBicycleModelNoDelay::calculateDiscreteMatrix(
   }
   float64_t cos_delta_r_squared_inv = 1 / (cos(delta_r) * cos(delta_r));
 
-  a_d << 0.0, m_velocity, 0.0, 0.0;
-  Eigen::MatrixXd I = Eigen::MatrixXd::Identity(m_dim_x, m_dim_x);
-  a_d = I + a_d * dt;
+  a_d << 1.0, m_velocity * dt, 0.0, 1.0;
 
   b_d << 0.0, m_velocity / m_wheelbase * cos_delta_r_squared_inv;
   b_d *= dt;
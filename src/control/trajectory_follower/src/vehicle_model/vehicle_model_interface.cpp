@@ -14,6 +14,8 @@
 
 #include "trajectory_follower/vehicle_model/vehicle_model_interface.hpp"
 
+#include <vector>
+
 namespace autoware
 {
 namespace motion
@@ -31,6 +33,72 @@ int64_t VehicleModelInterface::getDimU() {return m_dim_u;}
 int64_t VehicleModelInterface::getDimY() {return m_dim_y;}
 void VehicleModelInterface::setVelocity(const float64_t velocity) {m_velocity = velocity;}
 void VehicleModelInterface::setCurvature(const float64_t curvature) {m_curvature = curvature;}
+
+bool8_t VehicleModelInterface::rollout(
+  const Eigen::VectorXd & x0, const RolloutMatrix & u, const float64_t dt, RolloutMatrix & x)
+{
+  const int64_t horizon = prepareRollout(x0, u, x);
+  if (horizon < 0) {
+    return false;
+  }
+  calculateDiscreteMatrix(m_rollout_a_d, m_rollout_b_d, m_rollout_c_d, m_rollout_w_d, dt);
+  for (int64_t i = 0; i < horizon; ++i) {
+    propagateRollout(i, x0, u, x);
+  }
+  return true;
+}
+
+bool8_t VehicleModelInterface::rollout(
+  const Eigen::VectorXd & x0, const RolloutMatrix & u, const std::vector<float64_t> & velocity,
+  const std::vector<float64_t> & curvature, const float64_t dt, RolloutMatrix & x)
+{
+  const int64_t horizon = prepareRollout(x0, u, x);
+  if ((horizon < 0) || (velocity.size() != static_cast<size_t>(horizon)) ||
+    (curvature.size() != static_cast<size_t>(horizon)))
+  {
+    return false;
+  }
+  const float64_t velocity_backup = m_velocity;
+  const float64_t curvature_backup = m_curvature;
+  for (int64_t i = 0; i < horizon; ++i) {
+    m_velocity = velocity[static_cast<size_t>(i)];
+    m_curvature = curvature[static_cast<size_t>(i)];
+    calculateDiscreteMatrix(m_rollout_a_d, m_rollout_b_d, m_rollout_c_d, m_rollout_w_d, dt);
+    propagateRollout(i, x0, u, x);
+  }
+  m_velocity = velocity_backup;
+  m_curvature = curvature_backup;
+  return true;
+}
+
+int64_t VehicleModelInterface::prepareRollout(
+  const Eigen::VectorXd & x0, const RolloutMatrix & u, RolloutMatrix & x)
+{
+  if ((x0.size() != m_dim_x) || (u.rows() % m_dim_u != 0)) {
+    return -1;
+  }
+  const int64_t horizon = u.rows() / m_dim_u;
+  x.resize(horizon * m_dim_x, u.cols());
+  m_rollout_a_d.resize(m_dim_x, m_dim_x);
+  m_rollout_b_d.resize(m_dim_x, m_dim_u);
+  m_rollout_c_d.resize(m_dim_y, m_dim_x);
+  m_rollout_w_d.resize(m_dim_x, 1);
+  return horizon;
+}
+
+void VehicleModelInterface::propagateRollout(
+  const int64_t step, const Eigen::VectorXd & x0, const RolloutMatrix & u, RolloutMatrix & x)
+{
+  auto x_next = x.middleRows(step * m_dim_x, m_dim_x);
+  if (step == 0) {
+    // All rollouts start from the same state
+    x_next.colwise() = m_rollout_a_d * x0 + m_rollout_w_d.col(0);
+  } else {
+    x_next.noalias() = m_rollout_a_d * x.middleRows((step - 1) * m_dim_x, m_dim_x);
+    x_next.colwise() += m_rollout_w_d.col(0);
+  }
+  x_next.noalias() += m_rollout_b_d * u.middleRows(step * m_dim_u, m_dim_u);
+}
 }  // namespace trajectory_follower
 }  // namespace control
 }  // namespace motion
@@ -402,6 +402,41 @@ TEST_F(MPCTest, multi_solve_with_buffer) {
   EXPECT_EQ(mpc.m_input_buffer.size(), size_t(3));
 }
 
+TEST_F(MPCTest, resize_matrices) {
+  trajectory_follower::MPC mpc;
+  const std::string vehicle_model_type = "kinematics";
+  std::shared_ptr<trajectory_follower::VehicleModelInterface> vehicle_model_ptr =
+    std::make_shared<trajectory_follower::KinematicsBicycleModel>(
+    wheelbase, steer_limit, steer_tau);
+  mpc.setVehicleModel(vehicle_model_ptr, vehicle_model_type);
+  std::shared_ptr<trajectory_follower::QPSolverInterface> qpsolver_ptr =
+    std::make_shared<trajectory_follower::QPSolverEigenLeastSquareLLT>();
+  mpc.setQPSolver(qpsolver_ptr);
+
+  // Init parameters and reference trajectory
+  initializeMPC(mpc);
+  mpc.setReferenceTrajectory(
+    dummy_right_turn_trajectory, traj_resample_dist, enable_path_smoothing,
+    path_filter_moving_ave_num, enable_yaw_recalculation,
+    curvature_smoothing_num);
+
+  // The matrices kept from the previous calculation have to follow the horizon and the model
+  AckermannLateralCommand ctrl_cmd;
+  ASSERT_TRUE(mpc.calculateMPC(neutral_steer, default_velocity, pose_zero, ctrl_cmd));
+  EXPECT_LT(ctrl_cmd.steering_tire_angle, 0.0f);
+  mpc.m_param.prediction_horizon = 20;
+  ASSERT_TRUE(mpc.calculateMPC(neutral_steer, default_velocity, pose_zero, ctrl_cmd));
+  EXPECT_LT(ctrl_cmd.steering_tire_angle, 0.0f);
+  mpc.m_param.prediction_horizon = 40;
+  ASSERT_TRUE(mpc.calculateMPC(neutral_steer, default_velocity, pose_zero, ctrl_cmd));
+  EXPECT_LT(ctrl_cmd.steering_tire_angle, 0.0f);
+  vehicle_model_ptr = std::make_shared<trajectory_follower::DynamicsBicycleModel>(
+    wheelbase, mass_fl, mass_fr,
+    mass_rl, mass_rr, cf, cr);
+  mpc.setVehicleModel(vehicle_model_ptr, "dynamics");
+  EXPECT_TRUE(mpc.calculateMPC(neutral_steer, default_velocity, pose_zero, ctrl_cmd));
+}
+
 TEST_F(MPCTest, failure_cases) {
   trajectory_follower::MPC mpc;
   const std::string vehicle_model_type = "kinematics";
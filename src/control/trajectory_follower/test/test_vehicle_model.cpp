@@ -0,0 +1,214 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cmath>
+#include <vector>
+
+#include "common/types.hpp"
+#include "eigen3/Eigen/LU"
+#include "gtest/gtest.h"
+#include "trajectory_follower/vehicle_model/vehicle_model_bicycle_dynamics.hpp"
+#include "trajectory_follower/vehicle_model/vehicle_model_bicycle_kinematics.hpp"
+#include "trajectory_follower/vehicle_model/vehicle_model_bicycle_kinematics_no_delay.hpp"
+
+using autoware::common::types::float64_t;
+namespace trajectory_follower = ::autoware::motion::control::trajectory_follower;
+
+namespace
+{
+// Propagate one rollout step by step with the discrete matrices of the model
+Eigen::VectorXd propagate(
+  trajectory_follower::VehicleModelInterface & model, const Eigen::VectorXd & x0,
+  const Eigen::VectorXd & u, const float64_t dt)
+{
+  const auto dim_x = model.getDimX();
+  const auto dim_u = model.getDimU();
+  Eigen::MatrixXd a_d(dim_x, dim_x);
+  Eigen::MatrixXd b_d(dim_x, dim_u);
+  Eigen::MatrixXd c_d(model.getDimY(), dim_x);
+  Eigen::MatrixXd w_d(dim_x, 1);
+  model.calculateDiscreteMatrix(a_d, b_d, c_d, w_d, dt);
+  return a_d * x0 + b_d * u + w_d;
+}
+}  // namespace
+
+TEST(test_vehicle_model, rollout) {
+  trajectory_follower::KinematicsBicycleModel model(2.7, 0.6, 0.1);
+  model.setVelocity(5.0);
+  model.setCurvature(0.05);
+  constexpr float64_t dt = 0.1;
+  constexpr int64_t horizon = 10;
+  constexpr int64_t count = 7;
+
+  Eigen::VectorXd x0(3);
+  x0 << 0.3, -0.1, 0.05;
+  trajectory_follower::RolloutMatrix u(horizon, count);
+  for (int64_t i = 0; i < horizon; ++i) {
+    for (int64_t j = 0; j < count; ++j) {
+      u(i, j) = 0.01 * static_cast<float64_t>(j - 3) + 0.001 * static_cast<float64_t>(i);
+    }
+  }
+  trajectory_follower::RolloutMatrix x;
+  ASSERT_TRUE(model.rollout(x0, u, dt, x));
+  ASSERT_EQ(x.rows(), horizon * 3);
+  ASSERT_EQ(x.cols(), count);
+
+  for (int64_t j = 0; j < count; ++j) {
+    Eigen::VectorXd state = x0;
+    for (int64_t i = 0; i < horizon; ++i) {
+      state = propagate(model, state, u.block(i, j, 1, 1).transpose(), dt);
+      for (int64_t k = 0; k < 3; ++k) {
+        EXPECT_NEAR(x(i * 3 + k, j), state(k), 1.0E-12);
+      }
+    }
+  }
+
+  // Mismatching dimensions
+  EXPECT_FALSE(model.rollout(Eigen::VectorXd::Zero(4), u, dt, x));
+
+  // Other state dimension
+  trajectory_follower::DynamicsBicycleModel dynamics(
+    2.7, 600.0, 600.0, 600.0, 600.0, 1.5E5, 1.5E5);
+  dynamics.setVelocity(5.0);
+  dynamics.setCurvature(0.05);
+  ASSERT_TRUE(dynamics.rollout(Eigen::VectorXd::Zero(4), u, dt, x));
+  ASSERT_EQ(x.rows(), horizon * 4);
+  Eigen::VectorXd state = Eigen::VectorXd::Zero(4);
+  for (int64_t i = 0; i < horizon; ++i) {
+    state = propagate(dynamics, state, u.block(i, 0, 1, 1).transpose(), dt);
+  }
+  for (int64_t k = 0; k < 4; ++k) {
+    EXPECT_NEAR(x((horizon - 1) * 4 + k, 0), state(k), 1.0E-9);
+  }
+}
+
+TEST(test_vehicle_model, rollout_along_reference) {
+  trajectory_follower::KinematicsBicycleModel model(2.7, 0.6, 0.1);
+  model.setVelocity(1.0);
+  model.setCurvature(0.0);
+  constexpr float64_t dt = 0.1;
+  constexpr int64_t horizon = 5;
+  const std::vector<float64_t> velocity = {5.0, 5.5, 6.0, 6.5, 7.0};
+  const std::vector<float64_t> curvature = {0.0, 0.01, 0.02, 0.01, -0.01};
+
+  Eigen::VectorXd x0(3);
+  x0 << 0.2, 0.0, 0.0;
+  trajectory_follower::RolloutMatrix u = trajectory_follower::RolloutMatrix::Constant(
+    horizon, 3, 0.02);
+  u.col(1).setZero();
+  trajectory_follower::RolloutMatrix x;
+  ASSERT_TRUE(model.rollout(x0, u, velocity, curvature, dt, x));
+
+  trajectory_follower::KinematicsBicycleModel reference_model(2.7, 0.6, 0.1);
+  for (int64_t j = 0; j < u.cols(); ++j) {
+    Eigen::VectorXd state = x0;
+    for (int64_t i = 0; i < horizon; ++i) {
+      reference_model.setVelocity(velocity[static_cast<size_t>(i)]);
+      reference_model.setCurvature(curvature[static_cast<size_t>(i)]);
+      state = propagate(reference_model, state, u.block(i, j, 1, 1).transpose(), dt);
+      for (int64_t k = 0; k < 3; ++k) {
+        EXPECT_NEAR(x(i * 3 + k, j), state(k), 1.0E-12);
+      }
+    }
+  }
+
+  // The linearization point of the model is restored
+  Eigen::VectorXd u_one(1);
+  u_one << 0.02;
+  trajectory_follower::RolloutMatrix single_x;
+  ASSERT_TRUE(model.rollout(x0, u.block(0, 0, 1, 1), dt, single_x));
+  reference_model.setVelocity(1.0);
+  reference_model.setCurvature(0.0);
+  const auto expected = propagate(reference_model, x0, u_one, dt);
+  for (int64_t k = 0; k < 3; ++k) {
+    EXPECT_NEAR(single_x(k, 0), expected(k), 1.0E-12);
+  }
+
+  // The references must cover the horizon
+  EXPECT_FALSE(
+    model.rollout(x0, u, std::vector<float64_t>(4U, 5.0), curvature, dt, x));
+}
+
+TEST(test_vehicle_model, discrete_matrix) {
+  constexpr float64_t dt = 0.1;
+  constexpr float64_t wheelbase = 2.7;
+  constexpr float64_t velocity = 8.0;
+  constexpr float64_t curvature = 0.02;
+  Eigen::MatrixXd a_d(4, 4);
+  Eigen::MatrixXd b_d(4, 1);
+  Eigen::MatrixXd c_d(2, 4);
+  Eigen::MatrixXd w_d(4, 1);
+
+  // Bilinear discretization of the continuous dynamics model
+  trajectory_follower::DynamicsBicycleModel dynamics(
+    wheelbase, 600.0, 600.0, 600.0, 600.0, 1.5E5, 1.5E5);
+  dynamics.setVelocity(velocity);
+  dynamics.setCurvature(curvature);
+  dynamics.calculateDiscreteMatrix(a_d, b_d, c_d, w_d, dt);
+  const float64_t mass = 2400.0;
+  const float64_t lf = 1.35;
+  const float64_t iz = 2.0 * lf * lf * 1200.0;
+  const float64_t cf = 1.5E5;
+  Eigen::MatrixXd a = Eigen::MatrixXd::Zero(4, 4);
+  a(0, 1) = 1.0;
+  a(1, 1) = -2.0 * cf / (mass * velocity);
+  a(1, 2) = 2.0 * cf / mass;
+  a(2, 3) = 1.0;
+  a(3, 3) = -2.0 * lf * lf * cf / (iz * velocity);
+  Eigen::VectorXd b(4);
+  b << 0.0, cf / mass, 0.0, lf * cf / iz;
+  Eigen::VectorXd w(4);
+  w << 0.0, -velocity * velocity * curvature, 0.0, a(3, 3) * velocity * curvature;
+  const Eigen::MatrixXd I = Eigen::MatrixXd::Identity(4, 4);
+  const Eigen::MatrixXd inverse = (I - 0.5 * dt * a).inverse();
+  EXPECT_TRUE(a_d.isApprox(inverse * (I + 0.5 * dt * a), 1.0E-12));
+  EXPECT_TRUE(b_d.isApprox(dt * inverse * b, 1.0E-12));
+  EXPECT_TRUE(w_d.isApprox(dt * inverse * w, 1.0E-12));
+  EXPECT_EQ(c_d(0, 0), 1.0);
+  EXPECT_EQ(c_d(1, 2), 1.0);
+  EXPECT_EQ(c_d.sum(), 2.0);
+
+  // The state transition of the kinematics model is the one of the bilinear discretization
+  trajectory_follower::KinematicsBicycleModel kinematics(wheelbase, 0.6, 0.1);
+  kinematics.setVelocity(velocity);
+  kinematics.setCurvature(curvature);
+  a_d.resize(3, 3);
+  b_d.resize(3, 1);
+  c_d.resize(2, 3);
+  w_d.resize(3, 1);
+  kinematics.calculateDiscreteMatrix(a_d, b_d, c_d, w_d, dt);
+  const float64_t delta_r = std::atan(wheelbase * curvature);
+  const float64_t cos_delta_r_squared_inv = 1.0 / (std::cos(delta_r) * std::cos(delta_r));
+  Eigen::MatrixXd a_k(3, 3);
+  a_k << 0.0, velocity, 0.0, 0.0, 0.0, velocity / wheelbase * cos_delta_r_squared_inv,
+    0.0, 0.0, -1.0 / 0.1;
+  const Eigen::MatrixXd I_k = Eigen::MatrixXd::Identity(3, 3);
+  EXPECT_TRUE(a_d.isApprox((I_k - 0.5 * dt * a_k).inverse() * (I_k + 0.5 * dt * a_k), 1.0E-12));
+  EXPECT_DOUBLE_EQ(b_d(2, 0), dt / 0.1);
+
+  // Forward Euler discretization without delay
+  trajectory_follower::KinematicsBicycleModelNoDelay no_delay(wheelbase, 0.6);
+  no_delay.setVelocity(velocity);
+  no_delay.setCurvature(curvature);
+  a_d.resize(2, 2);
+  b_d.resize(2, 1);
+  c_d.resize(2, 2);
+  w_d.resize(2, 1);
+  no_delay.calculateDiscreteMatrix(a_d, b_d, c_d, w_d, dt);
+  EXPECT_DOUBLE_EQ(a_d(0, 0), 1.0);
+  EXPECT_DOUBLE_EQ(a_d(0, 1), velocity * dt);
+  EXPECT_DOUBLE_EQ(a_d(1, 0), 0.0);
+  EXPECT_DOUBLE_EQ(a_d(1, 1), 1.0);
+  EXPECT_DOUBLE_EQ(b_d(1, 0), velocity / wheelbase * cos_delta_r_squared_inv * dt);
+}
@@ -18,6 +18,7 @@
 #ifndef LGSVL_INTERFACE__LGSVL_INTERFACE_HPP_
 #define LGSVL_INTERFACE__LGSVL_INTERFACE_HPP_
 
+#include <lgsvl_interface/lockstep.hpp>
 #include <lgsvl_interface/visibility_control.hpp>
 
 #include <autoware_auto_msgs/msg/headlights_command.hpp>
@@ -35,6 +36,7 @@
 
 #include <geometry_msgs/msg/pose_with_covariance_stamped.hpp>
 #include <nav_msgs/msg/odometry.hpp>
+#include <rosgraph_msgs/msg/clock.hpp>
 #include <tf2_msgs/msg/tf_message.hpp>
 
 #include <geometry/lookup_table.hpp>
@@ -103,7 +105,8 @@ public:
     Table1D && brake_table,
     Table1D && steer_table,
     bool publish_tf = NO_PUBLISH,
-    bool publish_pose = PUBLISH);
+    bool publish_pose = PUBLISH,
+    const LockstepConfig & lockstep = LockstepConfig{});
 
   ~LgsvlInterface() noexcept override = default;
   /// Receives data from ROS 2 subscriber, and updates output messages.
@@ -115,7 +118,8 @@ public:
   /// Send control command data with whatever state data came along last
   bool send_control_command(const autoware_auto_msgs::msg::VehicleControlCommand & msg) override;
   /// Send control data with whatever state data came along last; applies scaling here too.
-  /// If both brake and throttle is nonzero, decide based on config
+  /// If both brake and throttle is nonzero, decide based on config.
+  /// In lockstep mode, a command for the current simulated time requests the next step
   bool send_control_command(const autoware_auto_msgs::msg::RawControlCommand & msg) override;
   /// Respond to request for changing autonomy mode. For LGSVL, this means nothing.
   bool handle_mode_change_request(
@@ -137,6 +141,11 @@ private:
   // store state_report with gear value correction
   void on_state_report(const autoware_auto_msgs::msg::VehicleStateReport & msg);
 
+  // Lockstep mode: publish the reached time on /clock and request the next step
+  void on_step_done(const rosgraph_msgs::msg::Clock & msg);
+  void on_lockstep_timeout();
+  void request_step();
+
   rclcpp::Publisher<lgsvl_msgs::msg::VehicleControlData>::SharedPtr m_cmd_pub{};
   rclcpp::Publisher<lgsvl_msgs::msg::VehicleStateData>::SharedPtr m_state_pub{};
   rclcpp::Publisher<autoware_auto_msgs::msg::VehicleKinematicState>::SharedPtr
@@ -149,6 +158,15 @@ private:
   rclcpp::Subscription<lgsvl_msgs::msg::VehicleOdometry>::SharedPtr m_veh_odom_sub{};
   rclcpp::TimerBase::SharedPtr m_nav_base_tf_timer{};
 
+  // lockstep mode, only set if enabled
+  std::unique_ptr<LockstepClock> m_lockstep{};
+  rclcpp::Publisher<rosgraph_msgs::msg::Clock>::SharedPtr m_clock_pub{};
+  rclcpp::Publisher<rosgraph_msgs::msg::Clock>::SharedPtr m_step_request_pub{};
+  rclcpp::Subscription<rosgraph_msgs::msg::Clock>::SharedPtr m_step_done_sub{};
+  rclcpp::TimerBase::SharedPtr m_lockstep_timer{};
+  std::size_t m_lockstep_last_step{0U};  // step count at the last timeout check
+  bool m_lockstep_last_waiting{false};  // whether the command was awaited at the last check
+
   Table1D m_throttle_table;
   Table1D m_brake_table;
   Table1D m_steer_table;
@@ -0,0 +1,96 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief Stepping of the LGSVL simulator in lockstep with the command of the stack
+#ifndef LGSVL_INTERFACE__LOCKSTEP_HPP_
+#define LGSVL_INTERFACE__LOCKSTEP_HPP_
+
+#include <common/types.hpp>
+#include <lgsvl_interface/visibility_control.hpp>
+
+#include <chrono>
+#include <cstddef>
+
+namespace lgsvl_interface
+{
+
+using autoware::common::types::bool8_t;
+
+/// Configuration of the lockstep mode of LgsvlInterface
+struct LGSVL_INTERFACE_PUBLIC LockstepConfig
+{
+  /// If false, the simulator runs freely on wall time
+  bool8_t enabled{false};
+  /// Simulated time of one step
+  std::chrono::nanoseconds step{std::chrono::milliseconds{20}};
+  /// Wall time after which a request is sent again while the simulator hasn't finished the step,
+  /// or the next step is requested while the command for the current step is missing
+  std::chrono::nanoseconds timeout{std::chrono::milliseconds{1000}};
+};
+
+/// Keeps track of the steps of the simulator in lockstep mode. The simulator is requested to run
+/// up to the end of a step, and the next step is requested once the stack has sent the command
+/// for the time the simulator reached, so the simulated time advances as fast as the stack
+/// computes instead of on wall time.
+class LGSVL_INTERFACE_PUBLIC LockstepClock
+{
+public:
+  using Duration = std::chrono::nanoseconds;
+
+  /// Constructor, the first step is requested from the time zero
+  /// \param[in] step Simulated time of one step
+  /// \throw std::domain_error If the step is not positive
+  explicit LockstepClock(Duration step);
+
+  /// Record that the simulator finished a step
+  /// \param[in] time The simulated time the simulator reached, in the clock of its stamps
+  /// \return False if the time is not newer than the current one, e.g. for a repeated message
+  bool8_t on_step_done(Duration time);
+
+  /// Record that a command was sent to the simulator
+  /// \param[in] stamp The stamp of the command
+  /// \return True if the command completes the current step, the next step is then to be
+  ///         requested. Commands stamped before the current time are for an older step
+  bool8_t on_command(Duration stamp);
+
+  /// Give up on the command for the current step, e.g. while the stack isn't engaged yet
+  /// \return True if the command was awaited, the next step is then to be requested
+  bool8_t skip_command();
+
+  /// Whether the simulator is running a step, i.e. the latest request isn't done yet
+  bool8_t waiting_for_simulator() const noexcept {return !m_waiting_for_command;}
+
+  /// Whether the stack is computing the command for the current time
+  bool8_t waiting_for_command() const noexcept {return m_waiting_for_command;}
+
+  /// The simulated time the simulator reached
+  Duration now() const noexcept {return m_now;}
+
+  /// The simulated time the simulator is to run up to
+  Duration target() const noexcept {return m_now + m_step;}
+
+  /// The number of steps the simulator finished
+  std::size_t step_count() const noexcept {return m_step_count;}
+
+private:
+  Duration m_step;
+  Duration m_now{Duration::zero()};
+  std::size_t m_step_count{0U};
+  bool8_t m_waiting_for_command{false};
+};  // class LockstepClock
+
+}  // namespace lgsvl_interface
+
+#endif  // LGSVL_INTERFACE__LOCKSTEP_HPP_
@@ -82,7 +82,8 @@ LgsvlInterface::LgsvlInterface(
   Table1D && brake_table,
   Table1D && steer_table,
   bool publish_tf,
-  bool publish_pose)
+  bool publish_pose,
+  const LockstepConfig & lockstep)
 : m_throttle_table{throttle_table},
   m_brake_table{brake_table},
   m_steer_table{steer_table},
@@ -161,6 +162,8 @@ LgsvlInterface::LgsvlInterface(
     rclcpp::QoS{10},
     [this](lgsvl_msgs::msg::CanBusData::SharedPtr msg) {
       autoware_auto_msgs::msg::VehicleStateReport state_report;
+      auto headlights = HeadlightsReport::DISABLE;
+      auto wipers = WipersReport::DISABLE;
       // state_report.set__fuel(nullptr);  // no fuel status from LGSVL
       if (msg->left_turn_signal_active) {
         state_report.set__blinker(autoware_auto_msgs::msg::VehicleStateReport::BLINKER_LEFT);
@@ -172,21 +175,19 @@ LgsvlInterface::LgsvlInterface(
 
       if (msg->low_beams_active) {
         state_report.set__headlight(autoware_auto_msgs::msg::VehicleStateReport::HEADLIGHT_ON);
-        headlights_report().report = HeadlightsReport::ENABLE_LOW;
+        headlights = HeadlightsReport::ENABLE_LOW;
       } else if (msg->high_beams_active) {
         state_report.set__headlight(autoware_auto_msgs::msg::VehicleStateReport::HEADLIGHT_HIGH);
-        headlights_report().report = HeadlightsReport::ENABLE_HIGH;
+        headlights = HeadlightsReport::ENABLE_HIGH;
       } else {
         state_report.set__headlight(autoware_auto_msgs::msg::VehicleStateReport::HEADLIGHT_OFF);
-        headlights_report().report = HeadlightsReport::DISABLE;
       }
 
       if (msg->wipers_active) {
         state_report.set__wiper(autoware_auto_msgs::msg::VehicleStateReport::WIPER_LOW);
-        wipers_report().report = WipersReport::ENABLE_LOW;
+        wipers = WipersReport::ENABLE_LOW;
       } else {
         state_report.set__wiper(autoware_auto_msgs::msg::VehicleStateReport::WIPER_OFF);
-        wipers_report().report = WipersReport::DISABLE;
       }
 
       state_report.set__gear(static_cast<uint8_t>(msg->selected_gear));
@@ -194,16 +195,22 @@ LgsvlInterface::LgsvlInterface(
       state_report.set__hand_brake(msg->parking_brake_active);
       // state_report.set__horn()  // no horn status from LGSVL
       on_state_report(state_report);
+      headlights_report().modify([headlights](HeadlightsReport & report) {
+          report.report = headlights;
+        });
+      wipers_report().modify([wipers](WipersReport & report) {report.report = wipers;});
     });
 
   m_veh_odom_sub = node.create_subscription<lgsvl_msgs::msg::VehicleOdometry>(
     sim_veh_odom_topic,
     rclcpp::QoS{10},
     [this](lgsvl_msgs::msg::VehicleOdometry::SharedPtr msg) {
-      odometry().set__stamp(msg->header.stamp);
-      odometry().set__velocity_mps(msg->velocity);
-      odometry().set__rear_wheel_angle_rad(msg->rear_wheel_angle);
-      odometry().set__front_wheel_angle_rad(msg->front_wheel_angle);
+      odometry().modify([&msg](autoware_auto_msgs::msg::VehicleOdometry & odometry) {
+          odometry.set__stamp(msg->header.stamp);
+          odometry.set__velocity_mps(msg->velocity);
+          odometry.set__rear_wheel_angle_rad(msg->rear_wheel_angle);
+          odometry.set__front_wheel_angle_rad(msg->front_wheel_angle);
+        });
     });
 
   // Setup Tf Buffer with listener
@@ -242,6 +249,23 @@ LgsvlInterface::LgsvlInterface(
           sim_odom_child_frame.c_str());
       }
     });
+
+  if (lockstep.enabled) {
+    if (lockstep.timeout <= std::chrono::nanoseconds::zero()) {
+      throw std::domain_error{"Lockstep timeout must be positive"};
+    }
+    m_lockstep = std::make_unique<LockstepClock>(lockstep.step);
+    m_clock_pub = node.create_publisher<rosgraph_msgs::msg::Clock>("/clock", rclcpp::QoS{10});
+    m_step_request_pub = node.create_publisher<rosgraph_msgs::msg::Clock>(
+      "step_request", rclcpp::QoS{10});
+    m_step_done_sub = node.create_subscription<rosgraph_msgs::msg::Clock>(
+      "step_done",
+      rclcpp::QoS{10},
+      [this](rosgraph_msgs::msg::Clock::SharedPtr msg) {on_step_done(*msg);});
+    // Wall timer: the simulated time doesn't advance while the lockstep is stuck
+    m_lockstep_timer = node.create_wall_timer(lockstep.timeout, [this]() {on_lockstep_timeout();});
+    request_step();
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -260,7 +284,7 @@ bool8_t LgsvlInterface::send_state_command(const autoware_auto_msgs::msg::Vehicl
   // Correcting blinker: it is shifted down by one,
   // as the first value BLINKER_NO_COMMAND does not exisit in LGSVL
   if (msg.blinker == VSC::BLINKER_NO_COMMAND) {
-    msg_corrected.blinker = get_state_report().blinker;
+    msg_corrected.blinker = state_report().latest().blinker;
   }
   msg_corrected.blinker--;
 
@@ -319,7 +343,7 @@ bool8_t LgsvlInterface::send_control_command(
   raw_msg.brake = 0;
 
   using VSR = autoware_auto_msgs::msg::VehicleStateReport;
-  const auto directional_accel = get_state_report().gear ==
+  const auto directional_accel = state_report().latest().gear ==
     VSR::GEAR_REVERSE ? -msg.long_accel_mps2 : msg.long_accel_mps2;
 
   if (directional_accel >= decltype(msg.long_accel_mps2) {}) {
@@ -348,6 +372,11 @@ bool8_t LgsvlInterface::send_control_command(const autoware_auto_msgs::msg::RawC
   // control_data.set__target_wheel_angular_rate();  // Missing angular rate in raw command
   // control_data.set__target_gear(); // Missing target gear in raw command
   m_cmd_pub->publish(control_data);
+  if (m_lockstep &&
+    m_lockstep->on_command(std::chrono::nanoseconds{rclcpp::Time{msg.stamp}.nanoseconds()}))
+  {
+    request_step();
+  }
   return true;
 }
 
@@ -426,10 +455,13 @@ void LgsvlInterface::on_odometry(const nav_msgs::msg::Odometry & msg)
       vse_t.header.stamp = msg.header.stamp;
 
       // Get values from vehicle odometry
-      vse_t.state.longitudinal_velocity_mps = get_odometry().velocity_mps;
-      vse_t.state.front_wheel_angle_rad = get_odometry().front_wheel_angle_rad;
-      vse_t.state.rear_wheel_angle_rad = get_odometry().rear_wheel_angle_rad;
-      if (state_report().gear == autoware_auto_msgs::msg::VehicleStateReport::GEAR_REVERSE) {
+      const auto odom = odometry().latest();
+      vse_t.state.longitudinal_velocity_mps = odom.velocity_mps;
+      vse_t.state.front_wheel_angle_rad = odom.front_wheel_angle_rad;
+      vse_t.state.rear_wheel_angle_rad = odom.rear_wheel_angle_rad;
+      if (state_report().latest().gear ==
+        autoware_auto_msgs::msg::VehicleStateReport::GEAR_REVERSE)
+      {
         vse_t.state.longitudinal_velocity_mps *= -1.0f;
       }
 
@@ -511,7 +543,50 @@ void LgsvlInterface::on_state_report(const autoware_auto_msgs::msg::VehicleState
   // instead reporting true blinker status
   corrected_report.blinker++;
 
-  state_report() = corrected_report;
+  state_report().modify(
+    [&corrected_report](autoware_auto_msgs::msg::VehicleStateReport & report) {
+      report = corrected_report;
+    });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LgsvlInterface::on_step_done(const rosgraph_msgs::msg::Clock & msg)
+{
+  const auto time = std::chrono::nanoseconds{rclcpp::Time{msg.clock}.nanoseconds()};
+  if (!m_lockstep->on_step_done(time)) {
+    return;
+  }
+  // The stack runs on the simulated time, so that it computes the command for this step
+  m_clock_pub->publish(msg);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LgsvlInterface::on_lockstep_timeout()
+{
+  const auto step = m_lockstep->step_count();
+  const auto waiting = m_lockstep->waiting_for_command();
+  // Only act if nothing happened during a whole period
+  const auto stuck = (step == m_lockstep_last_step) && (waiting == m_lockstep_last_waiting);
+  m_lockstep_last_step = step;
+  m_lockstep_last_waiting = waiting;
+  if (!stuck) {
+    return;
+  }
+  if (m_lockstep->skip_command()) {
+    RCLCPP_WARN(
+      m_logger, "Lockstep: no command for the simulated time %.3f s, stepping without it",
+      std::chrono::duration<float64_t>(m_lockstep->now()).count());
+  }
+  // Also sent again if the simulator missed the request, it is ignored if already done
+  request_step();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LgsvlInterface::request_step()
+{
+  rosgraph_msgs::msg::Clock request;
+  request.clock = rclcpp::Time{m_lockstep->target().count(), RCL_ROS_TIME};
+  m_step_request_pub->publish(request);
 }
 
 }  // namespace lgsvl_interface
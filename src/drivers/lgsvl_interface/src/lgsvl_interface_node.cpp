@@ -16,6 +16,7 @@
 
 #include <common/types.hpp>
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <unordered_set>
@@ -66,6 +67,11 @@ LgsvlInterfaceNode::LgsvlInterfaceNode(
   const auto pub_tf_param = declare_parameter("lgsvl.publish_tf");
   const bool pub_tf = rclcpp::ParameterType::PARAMETER_NOT_SET == pub_tf_param.get_type() ?
     NO_PUBLISH : pub_tf_param.get<bool>();
+  LockstepConfig lockstep{};
+  lockstep.enabled = declare_parameter("lgsvl.lockstep.enabled", false);
+  lockstep.step = std::chrono::milliseconds{declare_parameter("lgsvl.lockstep.step_ms", 20)};
+  lockstep.timeout =
+    std::chrono::milliseconds{declare_parameter("lgsvl.lockstep.timeout_ms", 1000)};
 
   // Set up interface
   set_interface(
@@ -82,7 +88,8 @@ LgsvlInterfaceNode::LgsvlInterfaceNode(
       table("brake"),
       table("steer"),
       pub_tf,
-      pub_pose
+      pub_pose,
+      lockstep
   ));
   // TODO(c.ho) low pass filter and velocity controller
 }
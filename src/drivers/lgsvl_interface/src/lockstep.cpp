@@ -0,0 +1,58 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <stdexcept>
+
+#include "lgsvl_interface/lockstep.hpp"
+
+namespace lgsvl_interface
+{
+
+LockstepClock::LockstepClock(const Duration step)
+: m_step{step}
+{
+  if (m_step <= Duration::zero()) {
+    throw std::domain_error{"Lockstep step must be positive"};
+  }
+}
+
+bool8_t LockstepClock::on_step_done(const Duration time)
+{
+  // The first step starts from zero, so the simulator may report any time for it
+  if ((m_step_count > 0U) && (time <= m_now)) {
+    return false;
+  }
+  m_now = time;
+  ++m_step_count;
+  m_waiting_for_command = true;
+  return true;
+}
+
+bool8_t LockstepClock::on_command(const Duration stamp)
+{
+  if (!m_waiting_for_command || (stamp < m_now)) {
+    return false;
+  }
+  m_waiting_for_command = false;
+  return true;
+}
+
+bool8_t LockstepClock::skip_command()
+{
+  const auto was_waiting = m_waiting_for_command;
+  m_waiting_for_command = false;
+  return was_waiting;
+}
+
+}  // namespace lgsvl_interface
@@ -0,0 +1,71 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <stdexcept>
+
+#include "lgsvl_interface/lockstep.hpp"
+
+using lgsvl_interface::LockstepClock;
+using std::chrono::milliseconds;
+
+TEST(test_lockstep, steps_after_command)
+{
+  LockstepClock lockstep{milliseconds(20)};
+  // The first step is requested before anything was sent
+  EXPECT_TRUE(lockstep.waiting_for_simulator());
+  EXPECT_EQ(lockstep.target(), milliseconds(20));
+  EXPECT_FALSE(lockstep.on_command(milliseconds(0)));
+
+  // The simulator may start from any time
+  EXPECT_TRUE(lockstep.on_step_done(milliseconds(1000)));
+  EXPECT_TRUE(lockstep.waiting_for_command());
+  EXPECT_EQ(lockstep.now(), milliseconds(1000));
+  EXPECT_EQ(lockstep.step_count(), 1U);
+  // A repeated answer of the simulator doesn't count as a step
+  EXPECT_FALSE(lockstep.on_step_done(milliseconds(1000)));
+  EXPECT_EQ(lockstep.step_count(), 1U);
+
+  // A command for an older time doesn't complete the step
+  EXPECT_FALSE(lockstep.on_command(milliseconds(980)));
+  EXPECT_TRUE(lockstep.waiting_for_command());
+  EXPECT_TRUE(lockstep.on_command(milliseconds(1000)));
+  EXPECT_TRUE(lockstep.waiting_for_simulator());
+  EXPECT_EQ(lockstep.target(), milliseconds(1020));
+  // Only the first command of a step requests the next one
+  EXPECT_FALSE(lockstep.on_command(milliseconds(1000)));
+
+  EXPECT_TRUE(lockstep.on_step_done(milliseconds(1020)));
+  EXPECT_EQ(lockstep.step_count(), 2U);
+}
+
+TEST(test_lockstep, skips_missing_command)
+{
+  LockstepClock lockstep{milliseconds(10)};
+  EXPECT_FALSE(lockstep.skip_command());
+  for (int i = 1; i <= 100; ++i) {
+    ASSERT_TRUE(lockstep.on_step_done(lockstep.target()));
+    ASSERT_TRUE(lockstep.skip_command());
+  }
+  EXPECT_EQ(lockstep.now(), milliseconds(1000));
+  EXPECT_EQ(lockstep.step_count(), 100U);
+}
+
+TEST(test_lockstep, bad_step)
+{
+  EXPECT_THROW(LockstepClock{milliseconds(0)}, std::domain_error);
+  EXPECT_THROW(LockstepClock{milliseconds(-10)}, std::domain_error);
+}
@@ -282,12 +282,9 @@ private:
 
   // In case multiple signals arrive at the same time
   std::mutex m_vehicle_kin_state_mutex;
-  std::mutex m_accel_cmd_mutex;
-  std::mutex m_brake_cmd_mutex;
-  std::mutex m_gear_cmd_mutex;
-  std::mutex m_gl_en_cmd_mutex;
-  std::mutex m_misc_cmd_mutex;
-  std::mutex m_steer_cmd_mutex;
+  // One lock for all commands, so that each cycle sends a consistent set and
+  // takes a single lock
+  std::mutex m_cmd_mutex;
 
   /** \brief Receives the brake state report from the vehicle platform.
    * Gets parking brake status for VehicleStateReport.
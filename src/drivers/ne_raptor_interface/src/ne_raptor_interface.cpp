@@ -133,12 +133,7 @@ void NERaptorInterface::cmdCallback()
   if (m_rolling_counter > 15) {
     m_rolling_counter = 0;
   }
-  std::lock_guard<std::mutex> guard_ac(m_accel_cmd_mutex);
-  std::lock_guard<std::mutex> guard_bc(m_brake_cmd_mutex);
-  std::lock_guard<std::mutex> guard_gc(m_gear_cmd_mutex);
-  std::lock_guard<std::mutex> guard_ec(m_gl_en_cmd_mutex);
-  std::lock_guard<std::mutex> guard_mc(m_misc_cmd_mutex);
-  std::lock_guard<std::mutex> guard_sc(m_steer_cmd_mutex);
+  std::lock_guard<std::mutex> guard(m_cmd_mutex);
 
   // Set rolling counters
   m_accel_cmd.rolling_counter = m_rolling_counter;
@@ -194,9 +189,7 @@ bool8_t NERaptorInterface::send_state_command(const VehicleStateCommand & msg)
 {
   bool8_t ret{true};
 
-  std::lock_guard<std::mutex> guard_gc(m_gear_cmd_mutex);
-  std::lock_guard<std::mutex> guard_ec(m_gl_en_cmd_mutex);
-  std::lock_guard<std::mutex> guard_mc(m_misc_cmd_mutex);
+  std::lock_guard<std::mutex> guard(m_cmd_mutex);
 
   // Set gear values
   switch (msg.gear) {
@@ -255,7 +248,6 @@ bool8_t NERaptorInterface::send_state_command(const VehicleStateCommand & msg)
       break;
   }
 
-  std::lock_guard<std::mutex> guard_bc(m_brake_cmd_mutex);
   m_brake_cmd.park_brake_cmd.status =
     (msg.hand_brake) ? ParkingBrake::ON : ParkingBrake::OFF;
 
@@ -271,9 +263,7 @@ bool8_t NERaptorInterface::send_control_command(const HighLevelControlCommand &
   bool8_t ret{true};
   float32_t velocity_checked{0.0F};
 
-  std::lock_guard<std::mutex> guard_ac(m_accel_cmd_mutex);
-  std::lock_guard<std::mutex> guard_bc(m_brake_cmd_mutex);
-  std::lock_guard<std::mutex> guard_sc(m_steer_cmd_mutex);
+  std::lock_guard<std::mutex> guard(m_cmd_mutex);
 
   // Using curvature for control
   m_accel_cmd.control_type.value = ActuatorControlMode::CLOSED_LOOP_VEHICLE;  // vehicle speed
@@ -284,9 +274,10 @@ bool8_t NERaptorInterface::send_control_command(const HighLevelControlCommand &
   m_steer_cmd.angle_velocity = m_max_steer_angle;
 
   // Check for invalid changes in direction
-  if ( ( (state_report().gear == VehicleStateReport::GEAR_DRIVE) &&
+  const auto gear = state_report().latest().gear;
+  if ( ( (gear == VehicleStateReport::GEAR_DRIVE) &&
     (msg.velocity_mps < 0.0F) ) ||
-    ( (state_report().gear == VehicleStateReport::GEAR_REVERSE) &&
+    ( (gear == VehicleStateReport::GEAR_REVERSE) &&
     (msg.velocity_mps > 0.0F) ) )
   {
     velocity_checked = 0.0F;
@@ -323,9 +314,7 @@ bool8_t NERaptorInterface::send_control_command(const VehicleControlCommand & ms
   float32_t velocity_checked{0.0F};
   float32_t angle_checked{0.0F};
 
-  std::lock_guard<std::mutex> guard_ac(m_accel_cmd_mutex);
-  std::lock_guard<std::mutex> guard_bc(m_brake_cmd_mutex);
-  std::lock_guard<std::mutex> guard_sc(m_steer_cmd_mutex);
+  std::lock_guard<std::mutex> guard(m_cmd_mutex);
 
   // Using steering wheel angle for control
   m_accel_cmd.control_type.value = ActuatorControlMode::CLOSED_LOOP_VEHICLE;   // vehicle speed
@@ -348,9 +337,10 @@ bool8_t NERaptorInterface::send_control_command(const VehicleControlCommand & ms
   }
 
   // Check for invalid changes in direction
-  if ( ( (state_report().gear == VehicleStateReport::GEAR_DRIVE) &&
+  const auto gear = state_report().latest().gear;
+  if ( ( (gear == VehicleStateReport::GEAR_DRIVE) &&
     (msg.velocity_mps < 0.0F) ) ||
-    ( (state_report().gear == VehicleStateReport::GEAR_REVERSE) &&
+    ( (gear == VehicleStateReport::GEAR_REVERSE) &&
     (msg.velocity_mps > 0.0F) ) )
   {
     velocity_checked = 0.0F;
@@ -408,6 +398,8 @@ bool8_t NERaptorInterface::handle_mode_change_request(ModeChangeRequest::SharedP
 
 void NERaptorInterface::send_headlights_command(const HeadlightsCommand & msg)
 {
+  std::lock_guard<std::mutex> guard(m_cmd_mutex);
+
   switch (msg.command) {
     case HeadlightsCommand::NO_COMMAND:
       // Keep previous
@@ -435,6 +427,8 @@ void NERaptorInterface::send_headlights_command(const HeadlightsCommand & msg)
 
 void NERaptorInterface::send_wipers_command(const WipersCommand & msg)
 {
+  std::lock_guard<std::mutex> guard(m_cmd_mutex);
+
   switch (msg.command) {
     case WipersCommand::NO_COMMAND:
       // Keep previous
@@ -466,51 +460,56 @@ void NERaptorInterface::send_wipers_command(const WipersCommand & msg)
 
 void NERaptorInterface::on_brake_report(const BrakeReport::SharedPtr & msg)
 {
+  bool8_t hand_brake{false};
   switch (msg->parking_brake.status) {
     case ParkingBrake::OFF:
-      state_report().hand_brake = false;
+      hand_brake = false;
       break;
     case ParkingBrake::ON:
-      state_report().hand_brake = true;
+      hand_brake = true;
       break;
     case ParkingBrake::NO_REQUEST:
     case ParkingBrake::FAULT:
     default:
-      state_report().hand_brake = false;
+      hand_brake = false;
       RCLCPP_WARN_THROTTLE(
         m_logger, m_clock, CLOCK_1_SEC,
         "Received invalid parking brake value from NE Raptor DBW.");
       break;
   }
+  state_report().modify(
+    [hand_brake](VehicleStateReport & report) {report.hand_brake = hand_brake;});
   m_seen_brake_rpt = true;
 }
 
 void NERaptorInterface::on_gear_report(const GearReport::SharedPtr & msg)
 {
+  uint8_t gear{0U};
   switch (msg->state.gear) {
     case Gear::PARK:
-      state_report().gear = VehicleStateReport::GEAR_PARK;
+      gear = VehicleStateReport::GEAR_PARK;
       break;
     case Gear::REVERSE:
-      state_report().gear = VehicleStateReport::GEAR_REVERSE;
+      gear = VehicleStateReport::GEAR_REVERSE;
       break;
     case Gear::NEUTRAL:
-      state_report().gear = VehicleStateReport::GEAR_NEUTRAL;
+      gear = VehicleStateReport::GEAR_NEUTRAL;
       break;
     case Gear::DRIVE:
-      state_report().gear = VehicleStateReport::GEAR_DRIVE;
+      gear = VehicleStateReport::GEAR_DRIVE;
       break;
     case Gear::LOW:
-      state_report().gear = VehicleStateReport::GEAR_LOW;
+      gear = VehicleStateReport::GEAR_LOW;
       break;
     case Gear::NONE:
     default:
-      state_report().gear = 0;
+      gear = 0;
       RCLCPP_WARN_THROTTLE(
         m_logger, m_clock, CLOCK_1_SEC,
         "Received invalid gear value from NE Raptor DBW.");
       break;
   }
+  state_report().modify([gear](VehicleStateReport & report) {report.gear = gear;});
   m_seen_gear_rpt = true;
 }
 
@@ -523,15 +522,18 @@ void NERaptorInterface::on_misc_report(const MiscReport::SharedPtr & msg)
   float32_t prev_speed_mps{0.0F};
   float32_t dT{0.0F};
 
-  odometry().velocity_mps = speed_mps;
+  odometry().modify([speed_mps](VehicleOdometry & odometry) {odometry.velocity_mps = speed_mps;});
 
-  state_report().fuel = static_cast<uint8_t>(msg->fuel_level);
+  state_report().modify(
+    [&msg](VehicleStateReport & report) {
+      report.fuel = static_cast<uint8_t>(msg->fuel_level);
 
-  if (msg->drive_by_wire_enabled) {
-    state_report().mode = VehicleStateReport::MODE_AUTONOMOUS;
-  } else {
-    state_report().mode = VehicleStateReport::MODE_MANUAL;
-  }
+      if (msg->drive_by_wire_enabled) {
+        report.mode = VehicleStateReport::MODE_AUTONOMOUS;
+      } else {
+        report.mode = VehicleStateReport::MODE_MANUAL;
+      }
+    });
   m_dbw_state_machine->dbw_feedback(msg->by_wire_ready && !msg->general_driver_activity);
 
   std::lock_guard<std::mutex> guard_vks(m_vehicle_kin_state_mutex);
@@ -598,16 +600,21 @@ void NERaptorInterface::on_misc_report(const MiscReport::SharedPtr & msg)
 
 void NERaptorInterface::on_other_actuators_report(const OtherActuatorsReport::SharedPtr & msg)
 {
+  bool8_t horn{false};
+  uint8_t blinker{0U};
+  uint8_t headlight{0U};
+  uint8_t wiper{0U};
+
   switch (msg->horn_state.status) {
     case HornState::OFF:
-      state_report().horn = false;
+      horn = false;
       break;
     case HornState::ON:
-      state_report().horn = true;
+      horn = true;
       break;
     case HornState::SNA:
     default:
-      state_report().horn = false;
+      horn = false;
       RCLCPP_WARN_THROTTLE(
         m_logger, m_clock, CLOCK_1_SEC,
         "Received invalid horn value from NE Raptor DBW.");
@@ -616,20 +623,20 @@ void NERaptorInterface::on_other_actuators_report(const OtherActuatorsReport::Sh
 
   switch (msg->turn_signal_state.value) {
     case TurnSignal::NONE:
-      state_report().blinker = VehicleStateReport::BLINKER_OFF;
+      blinker = VehicleStateReport::BLINKER_OFF;
       break;
     case TurnSignal::LEFT:
-      state_report().blinker = VehicleStateReport::BLINKER_LEFT;
+      blinker = VehicleStateReport::BLINKER_LEFT;
       break;
     case TurnSignal::RIGHT:
-      state_report().blinker = VehicleStateReport::BLINKER_RIGHT;
+      blinker = VehicleStateReport::BLINKER_RIGHT;
       break;
     case TurnSignal::HAZARDS:
-      state_report().blinker = VehicleStateReport::BLINKER_HAZARD;
+      blinker = VehicleStateReport::BLINKER_HAZARD;
       break;
     case TurnSignal::SNA:
     default:
-      state_report().blinker = 0;
+      blinker = 0;
       RCLCPP_WARN_THROTTLE(
         m_logger, m_clock, CLOCK_1_SEC,
         "Received invalid turn signal value from NE Raptor DBW.");
@@ -638,15 +645,15 @@ void NERaptorInterface::on_other_actuators_report(const OtherActuatorsReport::Sh
 
   switch (msg->high_beam_state.value) {
     case HighBeamState::OFF:
-      state_report().headlight = VehicleStateReport::HEADLIGHT_OFF;
+      headlight = VehicleStateReport::HEADLIGHT_OFF;
       break;
     case HighBeamState::ON:
-      state_report().headlight = VehicleStateReport::HEADLIGHT_HIGH;
+      headlight = VehicleStateReport::HEADLIGHT_HIGH;
       break;
     case HighBeamState::RESERVED:
     case HighBeamState::SNA:
     default:
-      state_report().headlight = 0;
+      headlight = 0;
       RCLCPP_WARN_THROTTLE(
         m_logger, m_clock, CLOCK_1_SEC,
         "Received invalid headlight value from NE Raptor DBW.");
@@ -655,27 +662,34 @@ void NERaptorInterface::on_other_actuators_report(const OtherActuatorsReport::Sh
 
   switch (msg->front_wiper_state.status) {
     case WiperFront::OFF:
-      state_report().wiper = VehicleStateReport::WIPER_OFF;
+      wiper = VehicleStateReport::WIPER_OFF;
       break;
     case WiperFront::CONSTANT_LOW:
-      state_report().wiper = VehicleStateReport::WIPER_LOW;
+      wiper = VehicleStateReport::WIPER_LOW;
       break;
     case WiperFront::CONSTANT_HIGH:
-      state_report().wiper = VehicleStateReport::WIPER_HIGH;
+      wiper = VehicleStateReport::WIPER_HIGH;
       break;
     case WiperFront::WASH_BRIEF:
-      state_report().wiper = VehicleStateReport::WIPER_CLEAN;
+      wiper = VehicleStateReport::WIPER_CLEAN;
       break;
     case WiperFront::SNA:
     default:
-      state_report().wiper = 0;
+      wiper = 0;
       RCLCPP_WARN_THROTTLE(
         m_logger, m_clock, CLOCK_1_SEC,
         "Received invalid wiper value from NE Raptor DBW.");
       break;
   }
 
-  state_report().stamp = msg->header.stamp;
+  state_report().modify(
+    [&msg, horn, blinker, headlight, wiper](VehicleStateReport & report) {
+      report.horn = horn;
+      report.blinker = blinker;
+      report.headlight = headlight;
+      report.wiper = wiper;
+      report.stamp = msg->header.stamp;
+    });
 }
 
 void NERaptorInterface::on_steering_report(const SteeringReport::SharedPtr & msg)
@@ -684,15 +698,18 @@ void NERaptorInterface::on_steering_report(const SteeringReport::SharedPtr & msg
   const float32_t f_wheel_angle_rad = (msg->steering_wheel_angle * DEGREES_TO_RADIANS) /
     m_steer_to_tire_ratio;
 
-  odometry().front_wheel_angle_rad = f_wheel_angle_rad;
-  odometry().rear_wheel_angle_rad = 0.0F;
+  odometry().modify(
+    [&msg, f_wheel_angle_rad](VehicleOdometry & odometry) {
+      odometry.front_wheel_angle_rad = f_wheel_angle_rad;
+      odometry.rear_wheel_angle_rad = 0.0F;
+      odometry.stamp = msg->header.stamp;
+    });
 
   std::lock_guard<std::mutex> guard_vks(m_vehicle_kin_state_mutex);
   m_vehicle_kin_state.state.front_wheel_angle_rad = f_wheel_angle_rad;
   m_vehicle_kin_state.state.rear_wheel_angle_rad = 0.0F;
 
   m_seen_steering_rpt = true;
-  odometry().stamp = msg->header.stamp;
 }
 
 void NERaptorInterface::on_wheel_spd_report(const WheelSpeedReport::SharedPtr & msg)
@@ -90,6 +90,9 @@ public:
   /// Set a function that is going to be called when an image arrives.
   void set_image_callback(CameraWrapper::ImageCallbackFunction callback);
 
+  /// Set a function that is going to be called with a view of each image when it arrives.
+  void set_image_view_callback(CameraWrapper::ImageViewCallbackFunction callback);
+
 private:
   /// Get the serial number of camera.
   static std::string get_camera_serial_number(const Spinnaker::CameraPtr camera);
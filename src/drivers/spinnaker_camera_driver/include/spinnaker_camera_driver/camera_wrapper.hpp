@@ -25,6 +25,8 @@
 #include <spinnaker_camera_driver/visibility_control.hpp>
 #include <sensor_msgs/msg/image.hpp>
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <functional>
@@ -38,6 +40,25 @@ namespace camera
 namespace spinnaker
 {
 
+/// A non-owning view of an image received from the camera.
+///
+/// The data points into the image buffer of the Spinnaker SDK, so no copy of the frame is made.
+/// It is only valid during the callback that receives the view, the buffer is handed back to the
+/// SDK afterwards.
+struct SPINNAKER_CAMERA_PUBLIC ImageView
+{
+  /// Acquisition time and frame id, as in the image message.
+  std_msgs::msg::Header header{};
+  std::uint32_t height{};
+  std::uint32_t width{};
+  std::string encoding{};
+  /// Length of a row in bytes.
+  std::uint32_t step{};
+  /// The pixels, step * height bytes.
+  const std::uint8_t * data{};
+  std::size_t size{};
+};
+
 /// A wrapper around the Spinnaker camera.
 ///
 /// It handles correct creation and destruction of the camera along with handling
@@ -49,6 +70,10 @@ public:
   using ImageCallbackFunction = std::function<void (
         std::uint32_t,
         std::unique_ptr<sensor_msgs::msg::Image>)>;
+  /// A typedef for the callback function used to pass a view of an image to the user.
+  using ImageViewCallbackFunction = std::function<void (
+        std::uint32_t,
+        const ImageView &)>;
 
   /// Construct a camera that wraps the spinnaker camera pointer.
   explicit CameraWrapper(
@@ -91,7 +116,18 @@ public:
   /// Set the callback function called upon image arrival from the SDK.
   void set_on_image_callback(ImageCallbackFunction callback);
 
+  /// Set the callback function called with a view of the SDK image buffer upon image arrival.
+  /// This avoids copying the frame into a message, e.g. for processing in the same process.
+  void set_on_image_view_callback(ImageViewCallbackFunction callback);
+
 private:
+  /// Register this camera as event handler on the first callback that is set.
+  void register_event_handler();
+
+  /// Make a view of a Spinnaker image, false if the image is incomplete.
+  static bool make_image_view(
+    const Spinnaker::ImagePtr & image, const std::string & frame_id, ImageView & view);
+
   /// Convert Spinnaker image to image message.
   static std::unique_ptr<sensor_msgs::msg::Image> convert_to_image_msg(
     const Spinnaker::ImagePtr & image, const std::string & frame_id);
@@ -114,6 +150,10 @@ private:
 
   /// A callback that the user can set to receive an image message when a new image is available.
   ImageCallbackFunction m_on_image_callback{};
+  /// A callback that the user can set to receive a view of each new image.
+  ImageViewCallbackFunction m_on_image_view_callback{};
+  /// An indicator that this camera is registered to receive image events.
+  bool m_is_event_handler_registered{};
 };
 
 }  //  namespace spinnaker
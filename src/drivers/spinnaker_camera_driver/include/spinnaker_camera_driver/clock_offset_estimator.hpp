@@ -0,0 +1,83 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SPINNAKER_CAMERA_DRIVER__CLOCK_OFFSET_ESTIMATOR_HPP_
+#define SPINNAKER_CAMERA_DRIVER__CLOCK_OFFSET_ESTIMATOR_HPP_
+
+#include <spinnaker_camera_driver/visibility_control.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+namespace autoware
+{
+namespace drivers
+{
+namespace camera
+{
+namespace spinnaker
+{
+
+/// Estimate the offset between the clock of a camera and the clock of the host.
+///
+/// Every image carries the time at which the camera acquired it in the clock of the device. The
+/// difference to the time at which the host received the image is the clock offset plus the
+/// transmission latency, which is never negative. The smallest difference over a window of recent
+/// images is therefore the best estimate of the offset, it is reached by the images that were
+/// delivered fastest. Limiting this to a window follows a slow drift between the two clocks.
+class SPINNAKER_CAMERA_PUBLIC ClockOffsetEstimator
+{
+public:
+  /// Create an estimator that uses the given number of most recent images, at least 1.
+  explicit ClockOffsetEstimator(std::size_t window_size = 100U);
+
+  /// Add an image and convert its device time to host time.
+  ///
+  /// A device time that is older than the previous one means the camera clock was reset, which
+  /// restarts the estimation.
+  ///
+  /// \param[in] device_time_ns Acquisition time of the image in the clock of the camera.
+  /// \param[in] receive_time_ns Time at which the host received the image.
+  /// \return The acquisition time in the clock of the host.
+  std::int64_t to_host_time(std::int64_t device_time_ns, std::int64_t receive_time_ns);
+
+  /// The current estimate of host time minus device time.
+  inline std::int64_t get_offset() const noexcept {return m_offset_ns;}
+
+  /// Forget all images.
+  void reset();
+
+private:
+  struct Sample
+  {
+    std::uint64_t index;
+    std::int64_t offset_ns;
+  };
+
+  std::size_t m_window_size;
+  /// Samples of the window that can still become the minimum, with increasing offsets.
+  std::deque<Sample> m_candidates{};
+  /// Number of images added since the last reset.
+  std::uint64_t m_count{};
+  std::int64_t m_last_device_time_ns{};
+  std::int64_t m_offset_ns{};
+};
+
+}  //  namespace spinnaker
+}  //  namespace camera
+}  //  namespace drivers
+}  //  namespace autoware
+
+#endif  // SPINNAKER_CAMERA_DRIVER__CLOCK_OFFSET_ESTIMATOR_HPP_
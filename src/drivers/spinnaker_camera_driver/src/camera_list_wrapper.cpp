@@ -99,6 +99,14 @@ void CameraListWrapper::set_image_callback(CameraWrapper::ImageCallbackFunction
   }
 }
 
+void CameraListWrapper::set_image_view_callback(
+  CameraWrapper::ImageViewCallbackFunction callback)
+{
+  for (auto & camera : m_cameras) {
+    camera.set_on_image_view_callback(callback);
+  }
+}
+
 std::unique_ptr<sensor_msgs::msg::Image> CameraListWrapper::retreive_image_from_camera(
   const std::uint32_t camera_index) const
 {
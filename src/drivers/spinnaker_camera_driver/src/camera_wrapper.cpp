@@ -22,6 +22,7 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 
 namespace
 {
@@ -58,7 +59,7 @@ CameraWrapper::CameraWrapper(
 
 CameraWrapper::~CameraWrapper()
 {
-  if (m_on_image_callback) {
+  if (m_is_event_handler_registered) {
     m_camera->UnregisterEventHandler(*this);
   }
   if (m_camera->IsStreaming()) {
@@ -69,15 +70,24 @@ CameraWrapper::~CameraWrapper()
 
 void CameraWrapper::OnImageEvent(Spinnaker::ImagePtr image)
 {
+  if (!m_is_event_handler_registered) {
+    return;
+  }
+  if (m_on_image_view_callback) {
+    ImageView view{};
+    if (make_image_view(image, m_frame_id, view)) {
+      m_on_image_view_callback(m_camera_index, view);
+    }
+  }
   if (m_on_image_callback) {
     m_on_image_callback(m_camera_index, convert_to_image_msg(image, m_frame_id));
-    image->Release();
   }
+  image->Release();
 }
 
 std::unique_ptr<sensor_msgs::msg::Image> CameraWrapper::retreive_image() const
 {
-  if (m_on_image_callback) {
+  if (m_is_event_handler_registered) {
     throw std::logic_error("A callback is set, please use it to retreive images.");
   }
   auto image = m_camera->GetNextImage();
@@ -103,41 +113,67 @@ void CameraWrapper::stop_capturing()
 
 void CameraWrapper::set_on_image_callback(ImageCallbackFunction callback)
 {
-  if (!m_on_image_callback) {
+  register_event_handler();
+  m_on_image_callback = callback;
+}
+
+void CameraWrapper::set_on_image_view_callback(ImageViewCallbackFunction callback)
+{
+  register_event_handler();
+  m_on_image_view_callback = callback;
+}
+
+void CameraWrapper::register_event_handler()
+{
+  if (!m_is_event_handler_registered) {
     // This is the first time we are setting a callback so we want to register
     // event handling for this camera.
     m_camera->RegisterEventHandler(*this);
+    m_is_event_handler_registered = true;
   }
-  m_on_image_callback = callback;
 }
 
-std::unique_ptr<sensor_msgs::msg::Image> CameraWrapper::convert_to_image_msg(
-  const Spinnaker::ImagePtr & image, const std::string & frame_id)
+bool CameraWrapper::make_image_view(
+  const Spinnaker::ImagePtr & image, const std::string & frame_id, ImageView & view)
 {
   if (image->IsIncomplete()) {
     std::cerr << "Received an incomplete image. Skipping." << std::endl;
-    return nullptr;
+    return false;
   }
   auto acquisition_time = image->GetTimeStamp();
 
-  const std::string encoding_pattern = convert_to_pixel_format_string(image->GetPixelFormat());
   const auto seconds = acquisition_time / kNanoSecondsInSecond;
-  std_msgs::msg::Header header;
-  header.stamp.sec = static_cast<std::int32_t>(seconds);
-  header.stamp.nanosec = static_cast<std::uint32_t>(acquisition_time - seconds);
-  header.frame_id = frame_id;
+  view.header.stamp.sec = static_cast<std::int32_t>(seconds);
+  view.header.stamp.nanosec =
+    static_cast<std::uint32_t>(acquisition_time - seconds * kNanoSecondsInSecond);
+  view.header.frame_id = frame_id;
+  view.height = static_cast<std::uint32_t>(image->GetHeight());
+  view.width = static_cast<std::uint32_t>(image->GetWidth());
+  view.encoding = convert_to_pixel_format_string(image->GetPixelFormat());
+  view.step = static_cast<std::uint32_t>(image->GetStride());
+  view.data = static_cast<const std::uint8_t *>(image->GetData());
+  view.size = image->GetImageSize();
+  return true;
+}
+
+std::unique_ptr<sensor_msgs::msg::Image> CameraWrapper::convert_to_image_msg(
+  const Spinnaker::ImagePtr & image, const std::string & frame_id)
+{
+  ImageView view{};
+  if (!make_image_view(image, frame_id, view)) {
+    return nullptr;
+  }
 
   auto msg{std::make_unique<sensor_msgs::msg::Image>()};
-  msg->header = header;
-  msg->height = static_cast<std::uint32_t>(image->GetHeight());
-  msg->width = static_cast<std::uint32_t>(image->GetWidth());
-  msg->encoding = encoding_pattern;
-  msg->step = static_cast<std::uint32_t>(image->GetStride());
-
-  const size_t image_size = image->GetImageSize();
-  msg->data.resize(static_cast<std::uint32_t>(image_size));
-  std::copy_n(static_cast<std::uint8_t *>(
-      image->GetData()), image_size, msg->data.data());
+  msg->header = std::move(view.header);
+  msg->height = view.height;
+  msg->width = view.width;
+  msg->encoding = std::move(view.encoding);
+  msg->step = view.step;
+
+  // Assigning the range allocates and copies in one pass, resizing first would also zero the
+  // whole frame before overwriting it.
+  msg->data.assign(view.data, view.data + view.size);
   return msg;
 }
 
@@ -0,0 +1,70 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <spinnaker_camera_driver/clock_offset_estimator.hpp>
+
+#include <stdexcept>
+
+namespace autoware
+{
+namespace drivers
+{
+namespace camera
+{
+namespace spinnaker
+{
+
+ClockOffsetEstimator::ClockOffsetEstimator(std::size_t window_size)
+: m_window_size{window_size}
+{
+  if (window_size < 1U) {
+    throw std::invalid_argument("The clock offset window must hold at least one image.");
+  }
+}
+
+std::int64_t ClockOffsetEstimator::to_host_time(
+  std::int64_t device_time_ns, std::int64_t receive_time_ns)
+{
+  if ((m_count > 0U) && (device_time_ns < m_last_device_time_ns)) {
+    reset();
+  }
+  m_last_device_time_ns = device_time_ns;
+
+  // Keep the candidates sorted by offset, a sample with a smaller offset than older ones makes
+  // them irrelevant for as long as it stays in the window.
+  const Sample sample{m_count, receive_time_ns - device_time_ns};
+  while (!m_candidates.empty() && (m_candidates.back().offset_ns >= sample.offset_ns)) {
+    m_candidates.pop_back();
+  }
+  m_candidates.push_back(sample);
+  ++m_count;
+  if (m_candidates.front().index + m_window_size < m_count) {
+    m_candidates.pop_front();
+  }
+  m_offset_ns = m_candidates.front().offset_ns;
+  return device_time_ns + m_offset_ns;
+}
+
+void ClockOffsetEstimator::reset()
+{
+  m_candidates.clear();
+  m_count = 0U;
+  m_last_device_time_ns = 0;
+  m_offset_ns = 0;
+}
+
+}  //  namespace spinnaker
+}  //  namespace camera
+}  //  namespace drivers
+}  //  namespace autoware
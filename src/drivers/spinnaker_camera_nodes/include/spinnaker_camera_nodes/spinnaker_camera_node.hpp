@@ -20,11 +20,17 @@
 #include <rclcpp/rclcpp.hpp>
 #include <rclcpp/publisher.hpp>
 #include <sensor_msgs/msg/image.hpp>
+#include <shared_memory_transport/shared_memory_transport.hpp>
+#include <spinnaker_camera_driver/clock_offset_estimator.hpp>
 #include <spinnaker_camera_driver/system_wrapper.hpp>
 #include <spinnaker_camera_nodes/visibility_control.hpp>
 
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
 #include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 #include <mutex>
 
@@ -43,11 +49,18 @@ public:
   explicit SpinnakerCameraNode(
     const rclcpp::NodeOptions & node_options);
 
+  /// Stops capturing before the publishers are destroyed.
+  ~SpinnakerCameraNode() override;
+
 private:
   /// A wrapper around a publisher that handles proper multithreading protection.
   class SPINNAKER_CAMERA_NODES_LOCAL ProtectedPublisher;
 
-  /// This funciton is called to publish an image.
+  /// A queue and a thread that publish the images of one camera.
+  class SPINNAKER_CAMERA_NODES_LOCAL CameraStream;
+
+  /// This funciton is called by the driver for every image, in the acquisition thread of the
+  /// camera. It stamps the image in host time and queues it for publication.
   SPINNAKER_CAMERA_NODES_LOCAL void publish_image(
     std::uint32_t camera_index,
     std::unique_ptr<sensor_msgs::msg::Image> image);
@@ -63,23 +76,74 @@ private:
     bool use_publisher_per_camera);
 
   std::unique_ptr<spinnaker::SystemWrapper> m_spinnaker_wrapper{};
+  /// The size in bytes of the largest image of the configured cameras.
+  std::size_t m_max_image_size{};
   std::vector<ProtectedPublisher> m_publishers{};
+  /// One stream per camera, declared after the publishers to be destroyed before them.
+  std::vector<std::unique_ptr<CameraStream>> m_streams{};
   bool m_use_publisher_per_camera{};
 };
 
 class SpinnakerCameraNode::ProtectedPublisher
 {
   using PublisherT = ::rclcpp::Publisher<::sensor_msgs::msg::Image>;
+  using SharedMemoryPublisherT =
+    common::shared_memory_transport::SharedMemoryPublisher<::sensor_msgs::msg::Image>;
 
 public:
   /// Co-share ownership of a rclcpp publisher.
   void set_publisher(PublisherT::SharedPtr publisher);
+  /// Also publish the images through shared memory, on the topic of the publisher with a
+  /// `_shared_memory` suffix. The regular topic is then only published to while it has
+  /// subscribers.
+  /// \param[in] node The node to create the publisher with, it must outlive this object.
+  /// \param[in] slot_count The number of images that can be read through shared memory at once.
+  /// \param[in] max_image_size The size in bytes of the largest image.
+  void enable_shared_memory(
+    ::rclcpp::Node & node, std::size_t slot_count, std::size_t max_image_size);
   /// Publish an image.
   void publish(std::unique_ptr<sensor_msgs::msg::Image> image);
 
 private:
   std::mutex m_publish_mutex{};
   PublisherT::SharedPtr m_publisher{};
+  std::unique_ptr<SharedMemoryPublisherT> m_shared_memory_publisher{};
+  ::rclcpp::Node * m_node{};
+};
+
+class SpinnakerCameraNode::CameraStream
+{
+public:
+  /// Start the publication thread of a camera.
+  /// \param[in] publisher The publisher for the images of this camera, must outlive the stream.
+  /// \param[in] queue_size The number of images that can wait for publication, at least 1.
+  /// \param[in] clock_offset_window The number of images used to estimate the clock offset.
+  CameraStream(
+    ProtectedPublisher & publisher, std::size_t queue_size, std::size_t clock_offset_window);
+  /// Publishes the images that are still queued and joins the thread.
+  ~CameraStream();
+
+  CameraStream(const CameraStream &) = delete;
+  CameraStream & operator=(const CameraStream &) = delete;
+
+  /// Convert the stamp of an image from device time to host time. Must only be called from the
+  /// acquisition thread of the camera.
+  void stamp(sensor_msgs::msg::Image & image, std::int64_t receive_time_ns);
+  /// Queue an image for publication, dropping the oldest queued image if the queue is full.
+  /// \return False if an image was dropped.
+  bool push(std::unique_ptr<sensor_msgs::msg::Image> image);
+
+private:
+  void run();
+
+  ProtectedPublisher & m_publisher;
+  std::size_t m_queue_size;
+  spinnaker::ClockOffsetEstimator m_clock_offset_estimator;
+  std::mutex m_mutex{};
+  std::condition_variable m_image_available{};
+  std::deque<std::unique_ptr<sensor_msgs::msg::Image>> m_queue{};
+  bool m_stop{};
+  std::thread m_thread{};
 };
 
 }  // namespace camera
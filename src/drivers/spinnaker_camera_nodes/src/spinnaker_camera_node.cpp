@@ -43,6 +43,12 @@ namespace
 static constexpr const char kDefaultCameraFrame[] = "camera";
 static constexpr const char kCameraSerial[] = "";
 static constexpr std::int64_t kDefaultDeviceThroughputLimit = 100000000L;
+static constexpr std::int64_t kDefaultPublicationQueueSize = 2L;
+static constexpr std::int64_t kDefaultClockOffsetWindow = 100L;
+static constexpr std::int64_t kNanoSecondsInSecond = 1000000000L;
+static constexpr std::int64_t kDefaultSharedMemorySlotCount = 4L;
+// The largest pixel of the supported pixel formats, rgb8 and bgr8.
+static constexpr std::size_t kMaxBytesPerPixel = 3U;
 }  // namespace
 
 namespace autoware
@@ -71,11 +77,42 @@ SpinnakerCameraNode::SpinnakerCameraNode(
     // TODO(igor): this should really be a terminate. It is a post-condition violation.
     throw std::runtime_error("No publishers created. Cannot start node.");
   }
+  if (declare_parameter("shared_memory.enabled", false)) {
+    const auto slot_count =
+      declare_parameter("shared_memory.slot_count", kDefaultSharedMemorySlotCount);
+    if (slot_count < 2L) {
+      throw std::domain_error("The shared memory ring needs at least 2 slots.");
+    }
+    for (auto & publisher : m_publishers) {
+      publisher.enable_shared_memory(*this, static_cast<std::size_t>(slot_count), m_max_image_size);
+    }
+  }
+  const auto queue_size = declare_parameter("publication_queue_size", kDefaultPublicationQueueSize);
+  const auto clock_offset_window =
+    declare_parameter("clock_offset_window", kDefaultClockOffsetWindow);
+  if ((queue_size < 1L) || (clock_offset_window < 1L)) {
+    throw std::domain_error("The publication queue and clock offset window must not be empty.");
+  }
+  for (auto i = 0U; i < number_of_cameras; ++i) {
+    const auto publisher_index = m_use_publisher_per_camera ? i : 0UL;
+    m_streams.push_back(
+      std::make_unique<CameraStream>(
+        m_publishers.at(publisher_index), static_cast<std::size_t>(queue_size),
+        static_cast<std::size_t>(clock_offset_window)));
+  }
   cameras.set_image_callback(std::bind(
       &SpinnakerCameraNode::publish_image, this, std::placeholders::_1, std::placeholders::_2));
   cameras.start_capturing();
 }
 
+SpinnakerCameraNode::~SpinnakerCameraNode()
+{
+  // No more images must arrive once the streams are destroyed.
+  if (m_spinnaker_wrapper) {
+    m_spinnaker_wrapper->get_cameras().stop_capturing();
+  }
+}
+
 spinnaker::CameraListWrapper & SpinnakerCameraNode::create_cameras_from_params(
   spinnaker::SystemWrapper * spinnaker_wrapper)
 {
@@ -93,11 +130,18 @@ spinnaker::CameraListWrapper & SpinnakerCameraNode::create_cameras_from_params(
       const auto device_link_throughput_limit_param{
         declare_parameter(
           prefix_dot + "device_link_throughput_limit", kDefaultDeviceThroughputLimit)};
+      const auto window_width{
+        static_cast<std::uint32_t>(
+          declare_parameter(prefix_dot + "window_width").get<std::uint64_t>())};
+      const auto window_height{
+        static_cast<std::uint32_t>(
+          declare_parameter(prefix_dot + "window_height").get<std::uint64_t>())};
+      m_max_image_size = std::max(
+        m_max_image_size,
+        static_cast<std::size_t>(window_width) * window_height * kMaxBytesPerPixel);
       return spinnaker::CameraSettings{
-      static_cast<std::uint32_t>(
-        declare_parameter(prefix_dot + "window_width").get<std::uint64_t>()),
-      static_cast<std::uint32_t>(
-        declare_parameter(prefix_dot + "window_height").get<std::uint64_t>()),
+      window_width,
+      window_height,
       declare_parameter(prefix_dot + "fps").template get<float64_t>(),
       declare_parameter(prefix_dot + "pixel_format").template get<std::string>(),
       camera_frame_id_param,
@@ -152,9 +196,15 @@ void SpinnakerCameraNode::publish_image(
   std::uint32_t camera_index,
   std::unique_ptr<sensor_msgs::msg::Image> image)
 {
-  const auto publisher_index = m_use_publisher_per_camera ? camera_index : 0UL;
-  if (image) {
-    m_publishers.at(publisher_index).publish(std::move(image));
+  if (!image) {
+    return;
+  }
+  auto & stream = *m_streams.at(camera_index);
+  stream.stamp(*image, get_clock()->now().nanoseconds());
+  if (!stream.push(std::move(image))) {
+    RCLCPP_WARN_THROTTLE(
+      get_logger(), *get_clock(), 5000,
+      "Publication of camera %u falls behind, dropping images.", camera_index);
   }
 }
 
@@ -163,19 +213,113 @@ void SpinnakerCameraNode::ProtectedPublisher::set_publisher(PublisherT::SharedPt
   m_publisher = publisher;
 }
 
+void SpinnakerCameraNode::ProtectedPublisher::enable_shared_memory(
+  ::rclcpp::Node & node, const std::size_t slot_count, const std::size_t max_image_size)
+{
+  if (!m_publisher) {
+    throw std::runtime_error("Publisher is nullptr, cannot enable shared memory.");
+  }
+  m_shared_memory_publisher = std::make_unique<SharedMemoryPublisherT>(
+    node, std::string{m_publisher->get_topic_name()} + "_shared_memory", ::rclcpp::QoS{10},
+    slot_count, max_image_size);
+  m_node = &node;
+}
+
 void SpinnakerCameraNode::ProtectedPublisher::publish(
   std::unique_ptr<sensor_msgs::msg::Image> image)
 {
   if (m_publisher) {
     const std::lock_guard<std::mutex> lock{m_publish_mutex};
-    if (image) {
-      m_publisher->publish(std::move(image));
+    if (!image) {
+      return;
     }
+    if (m_shared_memory_publisher) {
+      try {
+        if (!m_shared_memory_publisher->publish(*image)) {
+          RCLCPP_WARN_THROTTLE(
+            m_node->get_logger(), *m_node->get_clock(), 5000,
+            "All shared memory slots of %s are still read, dropping an image there.",
+            m_publisher->get_topic_name());
+        }
+      } catch (const std::domain_error & e) {
+        RCLCPP_WARN_THROTTLE(
+          m_node->get_logger(), *m_node->get_clock(), 5000,
+          "An image can't be published through shared memory: %s", e.what());
+      }
+      // Subscribers in other processes read the image from shared memory, the regular topic is
+      // only serialized for the subscribers that still use it.
+      if (m_publisher->get_subscription_count() == 0U) {
+        return;
+      }
+    }
+    m_publisher->publish(std::move(image));
   } else {
     throw std::runtime_error("Publisher is nullptr, cannot publish.");
   }
 }
 
+SpinnakerCameraNode::CameraStream::CameraStream(
+  ProtectedPublisher & publisher, std::size_t queue_size, std::size_t clock_offset_window)
+: m_publisher{publisher},
+  m_queue_size{queue_size},
+  m_clock_offset_estimator{clock_offset_window}
+{
+  m_thread = std::thread{&CameraStream::run, this};
+}
+
+SpinnakerCameraNode::CameraStream::~CameraStream()
+{
+  {
+    const std::lock_guard<std::mutex> lock{m_mutex};
+    m_stop = true;
+  }
+  m_image_available.notify_one();
+  m_thread.join();
+}
+
+void SpinnakerCameraNode::CameraStream::stamp(
+  sensor_msgs::msg::Image & image, std::int64_t receive_time_ns)
+{
+  const auto device_time_ns =
+    (static_cast<std::int64_t>(image.header.stamp.sec) * kNanoSecondsInSecond) +
+    static_cast<std::int64_t>(image.header.stamp.nanosec);
+  const auto host_time_ns = m_clock_offset_estimator.to_host_time(device_time_ns, receive_time_ns);
+  image.header.stamp.sec = static_cast<std::int32_t>(host_time_ns / kNanoSecondsInSecond);
+  image.header.stamp.nanosec = static_cast<std::uint32_t>(host_time_ns % kNanoSecondsInSecond);
+}
+
+bool SpinnakerCameraNode::CameraStream::push(std::unique_ptr<sensor_msgs::msg::Image> image)
+{
+  bool dropped{false};
+  {
+    const std::lock_guard<std::mutex> lock{m_mutex};
+    if (m_queue.size() >= m_queue_size) {
+      m_queue.pop_front();
+      dropped = true;
+    }
+    m_queue.push_back(std::move(image));
+  }
+  m_image_available.notify_one();
+  return !dropped;
+}
+
+void SpinnakerCameraNode::CameraStream::run()
+{
+  std::unique_lock<std::mutex> lock{m_mutex};
+  while (true) {
+    m_image_available.wait(lock, [this] {return m_stop || !m_queue.empty();});
+    if (m_queue.empty()) {
+      return;
+    }
+    auto image = std::move(m_queue.front());
+    m_queue.pop_front();
+    // Publish without holding the lock, so that the camera can queue the next image meanwhile.
+    lock.unlock();
+    m_publisher.publish(std::move(image));
+    lock.lock();
+  }
+}
+
 }  // namespace camera
 }  // namespace drivers
 }  // namespace autoware
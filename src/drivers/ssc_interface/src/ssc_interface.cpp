@@ -151,11 +151,12 @@ bool8_t SscInterface::send_state_command(const VehicleStateCommand & msg)
 bool8_t SscInterface::send_control_command(const HighLevelControlCommand & msg)
 {
   auto desired_velocity{0.0F};
+  const auto gear = state_report().latest().gear;
 
   // Handle velocities opposite the current direction of travel
   if (
-    (state_report().gear == VehicleStateReport::GEAR_DRIVE && msg.velocity_mps < 0.0F) ||
-    (state_report().gear == VehicleStateReport::GEAR_REVERSE && msg.velocity_mps > 0.0F))
+    (gear == VehicleStateReport::GEAR_DRIVE && msg.velocity_mps < 0.0F) ||
+    (gear == VehicleStateReport::GEAR_REVERSE && msg.velocity_mps > 0.0F))
   {
     desired_velocity = 0.0F;
   } else {
@@ -196,7 +197,9 @@ bool8_t SscInterface::send_control_command(const VehicleControlCommand & msg)
 {
   auto signed_velocity = msg.velocity_mps;
 
-  if (msg.velocity_mps > 0.0F && state_report().gear == VehicleStateReport::GEAR_REVERSE) {
+  if (msg.velocity_mps > 0.0F &&
+    state_report().latest().gear == VehicleStateReport::GEAR_REVERSE)
+  {
     signed_velocity = -msg.velocity_mps;
   }
 
@@ -232,46 +235,48 @@ bool8_t SscInterface::handle_mode_change_request(ModeChangeRequest::SharedPtr re
 
 void SscInterface::on_dbw_state_report(const std_msgs::msg::Bool::SharedPtr & msg)
 {
-  if (msg->data) {
-    state_report().mode = VehicleStateReport::MODE_AUTONOMOUS;
-  } else {
-    state_report().mode = VehicleStateReport::MODE_MANUAL;
-  }
+  const auto mode = msg->data ? VehicleStateReport::MODE_AUTONOMOUS :
+    VehicleStateReport::MODE_MANUAL;
+  state_report().modify([mode](VehicleStateReport & report) {report.mode = mode;});
 
   m_dbw_state_machine->dbw_feedback(msg->data);
 }
 
 void SscInterface::on_gear_report(const GearFeedback::SharedPtr & msg)
 {
+  uint8_t gear{0U};
   switch (msg->current_gear.gear) {
     case SscGear::PARK:
-      state_report().gear = VehicleStateReport::GEAR_PARK;
+      gear = VehicleStateReport::GEAR_PARK;
       break;
     case SscGear::REVERSE:
-      state_report().gear = VehicleStateReport::GEAR_REVERSE;
+      gear = VehicleStateReport::GEAR_REVERSE;
       break;
     case SscGear::NEUTRAL:
-      state_report().gear = VehicleStateReport::GEAR_NEUTRAL;
+      gear = VehicleStateReport::GEAR_NEUTRAL;
       break;
     case SscGear::DRIVE:
-      state_report().gear = VehicleStateReport::GEAR_DRIVE;
+      gear = VehicleStateReport::GEAR_DRIVE;
       break;
     case SscGear::LOW:
-      state_report().gear = VehicleStateReport::GEAR_LOW;
+      gear = VehicleStateReport::GEAR_LOW;
       break;
     case SscGear::NONE:
     default:
-      state_report().gear = 0;
       RCLCPP_WARN(m_logger, "Received invalid gear value from SSC.");
   }
+  state_report().modify([gear](VehicleStateReport & report) {report.gear = gear;});
 }
 
 void SscInterface::on_steer_report(const SteeringFeedback::SharedPtr & msg)
 {
   const auto front_wheel_angle_rad = msg->steering_wheel_angle * STEERING_TO_TIRE_RATIO;
-  odometry().stamp = msg->header.stamp;
-  odometry().front_wheel_angle_rad = front_wheel_angle_rad;
-  odometry().rear_wheel_angle_rad = 0.0F;
+  odometry().modify(
+    [&msg, front_wheel_angle_rad](VehicleOdometry & odometry) {
+      odometry.stamp = msg->header.stamp;
+      odometry.front_wheel_angle_rad = front_wheel_angle_rad;
+      odometry.rear_wheel_angle_rad = 0.0F;
+    });
 
   std::lock_guard<std::mutex> guard(m_vehicle_kinematic_state_mutex);
   m_vehicle_kinematic_state.state.front_wheel_angle_rad = front_wheel_angle_rad;
@@ -280,8 +285,11 @@ void SscInterface::on_steer_report(const SteeringFeedback::SharedPtr & msg)
 
 void SscInterface::on_vel_accel_report(const VelocityAccelCov::SharedPtr & msg)
 {
-  odometry().stamp = msg->header.stamp;
-  odometry().velocity_mps = msg->velocity;
+  odometry().modify(
+    [&msg](VehicleOdometry & odometry) {
+      odometry.stamp = msg->header.stamp;
+      odometry.velocity_mps = msg->velocity;
+    });
 
   std::lock_guard<std::mutex> guard(m_vehicle_kinematic_state_mutex);
   // Input velocity is (assumed to be) measured at the rear axle, but we're
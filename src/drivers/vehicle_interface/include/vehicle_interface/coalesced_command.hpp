@@ -0,0 +1,115 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/// \file
+/// \brief Holds the latest command of one kind until it is sent to the vehicle platform
+#ifndef VEHICLE_INTERFACE__COALESCED_COMMAND_HPP_
+#define VEHICLE_INTERFACE__COALESCED_COMMAND_HPP_
+
+#include <common/types.hpp>
+#include <vehicle_interface/visibility_control.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+
+namespace autoware
+{
+namespace drivers
+{
+namespace vehicle_interface
+{
+using autoware::common::types::bool8_t;
+
+/// Counters for the commands of one kind that went through a CoalescedCommand
+struct VEHICLE_INTERFACE_PUBLIC CommandStatistics
+{
+  /// Number of commands that were set
+  std::size_t received{0U};
+  /// Number of commands that were sent
+  std::size_t sent{0U};
+  /// Number of commands that were replaced by a newer one before they were sent
+  std::size_t dropped{0U};
+  /// Sum of the times between setting and sending the sent commands
+  std::chrono::nanoseconds total_latency{std::chrono::nanoseconds::zero()};
+  /// Largest time between setting and sending a command
+  std::chrono::nanoseconds max_latency{std::chrono::nanoseconds::zero()};
+
+  /// Average time between setting and sending a command, zero if nothing was sent
+  std::chrono::nanoseconds mean_latency() const noexcept
+  {
+    return (0U == sent) ? std::chrono::nanoseconds::zero() :
+           (total_latency / static_cast<std::chrono::nanoseconds::rep>(sent));
+  }
+};  // struct CommandStatistics
+
+/// Keeps only the latest command of one kind, so that several commands that arrive between two
+/// sends result in a single message to the vehicle platform
+/// \tparam CommandT The type of the command
+template<typename CommandT>
+class CoalescedCommand
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  /// Replace the pending command
+  /// \param[in] command The command to send next
+  /// \param[in] now The time at which the command was received
+  void set(const CommandT & command, const Clock::time_point now)
+  {
+    if (m_pending) {
+      ++m_statistics.dropped;
+    }
+    m_command = command;
+    m_pending = true;
+    m_received = now;
+    ++m_statistics.received;
+  }
+
+  /// Send the pending command, if there is one. The command is no longer pending afterwards,
+  /// even if sending throws
+  /// \param[in] now The time at which the command is sent
+  /// \param[in] send A callable that takes the command and sends it
+  /// \return True if a command was pending and handed to send
+  template<typename SendT>
+  bool8_t send(const Clock::time_point now, SendT && send)
+  {
+    if (!m_pending) {
+      return false;
+    }
+    m_pending = false;
+    const auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_received);
+    ++m_statistics.sent;
+    m_statistics.total_latency += latency;
+    m_statistics.max_latency = std::max(m_statistics.max_latency, latency);
+    send(m_command);
+    return true;
+  }
+
+  /// Whether a command was set since the last send
+  bool8_t pending() const noexcept {return m_pending;}
+  /// The counters of this kind of command
+  const CommandStatistics & statistics() const noexcept {return m_statistics;}
+
+private:
+  CommandT m_command{};
+  bool8_t m_pending{false};
+  Clock::time_point m_received{};
+  CommandStatistics m_statistics{};
+};  // class CoalescedCommand
+
+}  // namespace vehicle_interface
+}  // namespace drivers
+}  // namespace autoware
+
+#endif  // VEHICLE_INTERFACE__COALESCED_COMMAND_HPP_
@@ -29,6 +29,7 @@
 #include <autoware_auto_msgs/msg/vehicle_state_command.hpp>
 #include <autoware_auto_msgs/msg/vehicle_state_report.hpp>
 #include <autoware_auto_msgs/srv/autonomy_mode_change.hpp>
+#include <vehicle_interface/report_buffer.hpp>
 #include <vehicle_interface/visibility_control.hpp>
 
 #include <chrono>
@@ -56,7 +57,8 @@ namespace vehicle_interface
 
 /// Interface class for specific vehicle implementations. Child classes which implement this
 /// interface are expected to have wrap their own communication mechanism, and create a subclass
-/// from the VehicleInterfaceNode
+/// from the VehicleInterfaceNode. The reports are kept in ReportBuffers, so child classes may
+/// update them from any thread while the VehicleInterfaceNode reads them in its timer
 class VEHICLE_INTERFACE_PUBLIC PlatformInterface
 {
 public:
@@ -102,6 +104,8 @@ public:
   /// data from the vehicle platform implies a state should be changed. For example, if the gear
   /// state is drive, the StateReport should be in drive until the vehicle platform reports that
   /// it is in neutral or some other gear state.
+  /// The getters never block, but must only be called from one thread, e.g. the timer of the
+  /// VehicleInterfaceNode, and the reference is only valid until the next call of the same getter
   /// \return A StateReport message intended to be published.
   const VehicleStateReport & get_state_report() const noexcept;
   /// Get the most recent odomoetry of the vehicle
@@ -127,20 +131,20 @@ public:
   virtual void send_wipers_command(const WipersCommand & msg);
 
 protected:
-  /// Get the underlying state report for modification
-  VehicleStateReport & state_report() noexcept;
-  /// Get the underlying odometry for modification
-  VehicleOdometry & odometry() noexcept;
-  /// Get the underlying headlight state for modification
-  HeadlightsReport & headlights_report() noexcept;
-  /// Get the underlying wiper state for modification
-  WipersReport & wipers_report() noexcept;
+  /// Get the underlying state report for modification, or for reading outside of the timer
+  ReportBuffer<VehicleStateReport> & state_report() noexcept;
+  /// Get the underlying odometry for modification, or for reading outside of the timer
+  ReportBuffer<VehicleOdometry> & odometry() noexcept;
+  /// Get the underlying headlight state for modification, or for reading outside of the timer
+  ReportBuffer<HeadlightsReport> & headlights_report() noexcept;
+  /// Get the underlying wiper state for modification, or for reading outside of the timer
+  ReportBuffer<WipersReport> & wipers_report() noexcept;
 
 private:
-  HeadlightsReport m_headlights_report{};
-  WipersReport m_wipers_report{};
-  VehicleStateReport m_state_report{};
-  VehicleOdometry m_odometry{};
+  ReportBuffer<HeadlightsReport> m_headlights_report{};
+  ReportBuffer<WipersReport> m_wipers_report{};
+  ReportBuffer<VehicleStateReport> m_state_report{};
+  ReportBuffer<VehicleOdometry> m_odometry{};
 };  // class PlatformInterface
 }  // namespace vehicle_interface
 }  // namespace drivers
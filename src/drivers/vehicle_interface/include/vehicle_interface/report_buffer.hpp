@@ -0,0 +1,100 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+/// \file
+/// \brief Hands the latest report of one kind from the vehicle platform to the publishing thread
+#ifndef VEHICLE_INTERFACE__REPORT_BUFFER_HPP_
+#define VEHICLE_INTERFACE__REPORT_BUFFER_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+
+namespace autoware
+{
+namespace drivers
+{
+namespace vehicle_interface
+{
+
+/// A triple buffer for a report that is assembled from the callbacks of the vehicle platform and
+/// published from the timer of the VehicleInterfaceNode. Writers modify their own copy of the
+/// report under a lock that is only shared with other writers, then swap a snapshot of it into the
+/// middle buffer. The reader swaps the middle buffer with its own one if it holds a newer report,
+/// so reading never waits on a writer and always sees a report that no writer is touching
+/// \tparam ReportT The type of the report, must be default constructible and copy assignable
+template<typename ReportT>
+class ReportBuffer
+{
+public:
+  /// Apply a modification to the report and make the result visible to the reader. Any number of
+  /// threads may call this, they are serialized among each other but never wait on the reader
+  /// \param[in] modify A callable that takes the report by reference and changes it. If it throws,
+  ///                   nothing is handed to the reader, but the changes made so far are kept
+  template<typename ModifyT>
+  void modify(ModifyT && modify)
+  {
+    std::lock_guard<std::mutex> lock{m_write_mutex};
+    modify(m_latest);
+    m_slots[m_back] = m_latest;
+    m_back = m_middle.exchange(m_back | kFresh, std::memory_order_acq_rel) & kIndexMask;
+  }
+
+  /// Get a copy of the report as the writers last left it, e.g. to use it while translating a
+  /// command. Waits for a concurrent modification to finish, so the reader should use read()
+  ReportT latest() const
+  {
+    std::lock_guard<std::mutex> lock{m_write_mutex};
+    return m_latest;
+  }
+
+  /// Get the most recent report that was handed to the reader. Wait-free, but must only be called
+  /// from one thread at a time, and the returned reference is only valid until the next call
+  /// \return The most recent report, or a default constructed one if nothing was written yet
+  const ReportT & read() const noexcept
+  {
+    if (0U != (m_middle.load(std::memory_order_relaxed) & kFresh)) {
+      // Only a writer can change the middle buffer meanwhile, and it keeps it fresh
+      m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & kIndexMask;
+    }
+    return m_slots[m_front];
+  }
+
+private:
+  /// Set on the middle index when it holds a report that the reader has not seen yet
+  static constexpr std::size_t kFresh = 4U;
+  static constexpr std::size_t kIndexMask = 3U;
+
+  std::array<ReportT, 3U> m_slots{};
+  /// Index of the slot that is only accessed by the reader
+  mutable std::size_t m_front{0U};
+  /// Index of the slot that is exchanged between the reader and the writers, plus kFresh
+  mutable std::atomic<std::size_t> m_middle{1U};
+  /// Index of the slot that is only accessed by the writers
+  std::size_t m_back{2U};
+  /// The report that the writers modify, guarded by m_write_mutex
+  ReportT m_latest{};
+  mutable std::mutex m_write_mutex{};
+};  // class ReportBuffer
+
+template<typename ReportT>
+constexpr std::size_t ReportBuffer<ReportT>::kFresh;
+template<typename ReportT>
+constexpr std::size_t ReportBuffer<ReportT>::kIndexMask;
+
+}  // namespace vehicle_interface
+}  // namespace drivers
+}  // namespace autoware
+
+#endif  // VEHICLE_INTERFACE__REPORT_BUFFER_HPP_
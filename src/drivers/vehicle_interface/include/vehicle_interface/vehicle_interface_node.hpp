@@ -18,6 +18,7 @@
 #ifndef VEHICLE_INTERFACE__VEHICLE_INTERFACE_NODE_HPP_
 #define VEHICLE_INTERFACE__VEHICLE_INTERFACE_NODE_HPP_
 
+#include <vehicle_interface/coalesced_command.hpp>
 #include <vehicle_interface/platform_interface.hpp>
 #include <vehicle_interface/safety_state_machine.hpp>
 #include <vehicle_interface/visibility_control.hpp>
@@ -34,6 +35,7 @@
 #include <autoware_auto_msgs/msg/vehicle_state_command.hpp>
 #include <autoware_auto_msgs/msg/vehicle_state_report.hpp>
 #include <autoware_auto_msgs/srv/autonomy_mode_change.hpp>
+#include <diagnostic_msgs/msg/diagnostic_array.hpp>
 
 #include <experimental/optional>
 #include <chrono>
@@ -114,6 +116,17 @@ protected:
   /// Get access to Safety State Machine
   const SafetyStateMachine get_state_machine() const noexcept;
 
+  /// Counters of the commands that went through the coalesced output, per kind of command
+  struct OutputStatistics
+  {
+    CommandStatistics control;
+    CommandStatistics state;
+    CommandStatistics headlights;
+    CommandStatistics wipers;
+  };
+  /// Get the counters of the coalesced command output, all zero if commands are sent immediately
+  OutputStatistics output_statistics() const noexcept;
+
   /// Error handling behavior for when sending a control command has failed, default is throwing an
   /// exception, which is caught and turned into a change in the NodeState to ERROR
   /// TODO(c.ho) add command which failed to send as an argument
@@ -149,8 +162,16 @@ private:
   // Run just before main loop, ensure that all invariants (possibly from child class) are enforced
   VEHICLE_INTERFACE_LOCAL void check_invariants();
 
-  // Send state command
+  // Send control command now, or with the next cycle if commands are coalesced
+  VEHICLE_INTERFACE_LOCAL void send_control_command(const RawControlCommand & msg);
+  VEHICLE_INTERFACE_LOCAL void send_control_command(const VehicleControlCommand & msg);
+  // Send state command now, or with the next cycle if commands are coalesced
   VEHICLE_INTERFACE_LOCAL void send_state_command(const MaybeStateCommand & maybe_command);
+  // Send feature commands now, or with the next cycle if commands are coalesced
+  VEHICLE_INTERFACE_LOCAL void send_headlights_command(const HeadlightsCommand & msg);
+  VEHICLE_INTERFACE_LOCAL void send_wipers_command(const WipersCommand & msg);
+  // Send the latest command of each kind that was received since the last cycle
+  VEHICLE_INTERFACE_LOCAL void send_coalesced_commands();
   // Read data from vehicle platform for time budget, publish data
   VEHICLE_INTERFACE_LOCAL void read_and_publish();
   // Core loop for different input commands. Specialized differently for each topic type
@@ -161,6 +182,11 @@ private:
     ModeChangeRequest::SharedPtr request, ModeChangeResponse::SharedPtr response);
   /// Log a warning from the safety state machine: transition node state and/or log
   VEHICLE_INTERFACE_LOCAL void state_machine_report();
+  /// Publish a fault of the main loop or of a command, then handle it with on_error()
+  VEHICLE_INTERFACE_LOCAL void handle_error(std::exception_ptr eptr);
+  /// Publish faults on /diagnostics, so that e.g. a black box recorder can dump the data before
+  /// them
+  VEHICLE_INTERFACE_LOCAL void publish_faults(diagnostic_msgs::msg::DiagnosticArray & faults);
 
   rclcpp::TimerBase::SharedPtr m_read_timer{nullptr};
   rclcpp::Publisher<autoware_auto_msgs::msg::VehicleOdometry>::SharedPtr m_odom_pub{nullptr};
@@ -172,6 +198,7 @@ private:
   rclcpp::Publisher<WipersReport>::SharedPtr m_wipers_rpt_pub{nullptr};
   rclcpp::Subscription<WipersCommand>::SharedPtr m_wipers_cmd_sub{nullptr};
   rclcpp::Service<autoware_auto_msgs::srv::AutonomyModeChange>::SharedPtr m_mode_service{nullptr};
+  rclcpp::Publisher<diagnostic_msgs::msg::DiagnosticArray>::SharedPtr m_diagnostics_pub{nullptr};
 
   using BasicSub = rclcpp::Subscription<BasicControlCommand>::SharedPtr;
   using RawSub = rclcpp::Subscription<autoware_auto_msgs::msg::RawControlCommand>::SharedPtr;
@@ -187,6 +214,13 @@ private:
   std::chrono::system_clock::time_point m_last_command_stamp{};
   std::chrono::nanoseconds m_cycle_time{};
   MaybeStateCommand m_last_state_command{};
+  // Latest commands of each kind, only used if commands are coalesced
+  bool8_t m_coalesce_commands{false};
+  CoalescedCommand<RawControlCommand> m_raw_output{};
+  CoalescedCommand<VehicleControlCommand> m_control_output{};
+  CoalescedCommand<VehicleStateCommand> m_state_output{};
+  CoalescedCommand<HeadlightsCommand> m_headlights_output{};
+  CoalescedCommand<WipersCommand> m_wipers_output{};
 
   std::map<std::string, ViFeature> m_avail_features =
   {
@@ -26,15 +26,15 @@ namespace vehicle_interface
 const autoware_auto_msgs::msg::VehicleStateReport &
 PlatformInterface::get_state_report() const noexcept
 {
-  return m_state_report;
+  return m_state_report.read();
 }
 
 const autoware_auto_msgs::msg::VehicleOdometry & PlatformInterface::get_odometry() const noexcept
 {
-  return m_odometry;
+  return m_odometry.read();
 }
 
-autoware_auto_msgs::msg::VehicleStateReport & PlatformInterface::state_report() noexcept
+ReportBuffer<VehicleStateReport> & PlatformInterface::state_report() noexcept
 {
   return m_state_report;
 }
@@ -42,26 +42,26 @@ autoware_auto_msgs::msg::VehicleStateReport & PlatformInterface::state_report()
 const autoware_auto_msgs::msg::HeadlightsReport &
 PlatformInterface::get_headlights_report() const noexcept
 {
-  return m_headlights_report;
+  return m_headlights_report.read();
 }
 
 const autoware_auto_msgs::msg::WipersReport &
 PlatformInterface::get_wipers_report() const noexcept
 {
-  return m_wipers_report;
+  return m_wipers_report.read();
 }
 
-autoware_auto_msgs::msg::VehicleOdometry & PlatformInterface::odometry() noexcept
+ReportBuffer<VehicleOdometry> & PlatformInterface::odometry() noexcept
 {
   return m_odometry;
 }
 
-autoware_auto_msgs::msg::HeadlightsReport & PlatformInterface::headlights_report() noexcept
+ReportBuffer<HeadlightsReport> & PlatformInterface::headlights_report() noexcept
 {
   return m_headlights_report;
 }
 
-autoware_auto_msgs::msg::WipersReport & PlatformInterface::wipers_report() noexcept
+ReportBuffer<WipersReport> & PlatformInterface::wipers_report() noexcept
 {
   return m_wipers_report;
 }
@@ -18,6 +18,7 @@
 #include <signal_filters/filter_factory.hpp>
 #include <time_utils/time_utils.hpp>
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <tuple>
@@ -116,6 +117,12 @@ VehicleInterfaceNode::VehicleInterfaceNode(
     }
   }
 
+  // Optionally send only the latest commands, once per cycle
+  const auto coalesce_commands = declare_parameter("coalesce_commands");
+  if (coalesce_commands.get_type() != rclcpp::PARAMETER_NOT_SET) {
+    m_coalesce_commands = coalesce_commands.get<bool8_t>();
+  }
+
   // Actually init
   init(
     topic_num_matches_from_param("control_command"),
@@ -147,6 +154,23 @@ void VehicleInterfaceNode::set_interface(std::unique_ptr<PlatformInterface> && i
   m_interface = std::forward<std::unique_ptr<PlatformInterface>&&>(interface);
 }
 
+VehicleInterfaceNode::OutputStatistics VehicleInterfaceNode::output_statistics() const noexcept
+{
+  // Only one kind of control command is used by a node
+  auto control = m_control_output.statistics();
+  const auto & raw = m_raw_output.statistics();
+  control.received += raw.received;
+  control.sent += raw.sent;
+  control.dropped += raw.dropped;
+  control.total_latency += raw.total_latency;
+  control.max_latency = std::max(control.max_latency, raw.max_latency);
+  return OutputStatistics{
+    control,
+    m_state_output.statistics(),
+    m_headlights_output.statistics(),
+    m_wipers_output.statistics()};
+}
+
 rclcpp::Logger VehicleInterfaceNode::logger() const noexcept {return get_logger();}
 
 const SafetyStateMachine VehicleInterfaceNode::get_state_machine() const noexcept
@@ -174,9 +198,7 @@ template<>
 void VehicleInterfaceNode::on_command_message(
   const autoware_auto_msgs::msg::RawControlCommand & msg)
 {
-  if (!m_interface->send_control_command(msg)) {
-    on_control_send_failure();
-  }
+  send_control_command(msg);
   send_state_command(m_last_state_command);
   m_last_state_command = MaybeStateCommand{};
 }
@@ -210,9 +232,7 @@ void VehicleInterfaceNode::on_command_message(
     // Hit commands with state machine
     const auto commands = m_state_machine->compute_safe_commands({cmd, maybe_state_command});
     // Send
-    if (!m_interface->send_control_command(commands.control())) {
-      on_control_send_failure();
-    }
+    send_control_command(commands.control());
     send_state_command(commands.state());
   } else {
     RCLCPP_WARN(logger(), "Vehicle interface time did not increase, skipping");
@@ -264,7 +284,7 @@ void VehicleInterfaceNode::init(
       try {
         read_and_publish();
       } catch (...) {
-        on_error(std::current_exception());
+        handle_error(std::current_exception());
       }
     });
   // Make publishers
@@ -272,6 +292,8 @@ void VehicleInterfaceNode::init(
     state_report.topic + "_out", rclcpp::QoS{10U});
   m_odom_pub =
     create_publisher<autoware_auto_msgs::msg::VehicleOdometry>(odometry.topic, rclcpp::QoS{10U});
+  m_diagnostics_pub =
+    create_publisher<diagnostic_msgs::msg::DiagnosticArray>("/diagnostics", rclcpp::QoS{10U});
   // Make subordinate subscriber TODO(c.ho) parameterize time better
   using VSC = autoware_auto_msgs::msg::VehicleStateCommand;
   m_state_sub = create_subscription<VSC>(
@@ -285,7 +307,7 @@ void VehicleInterfaceNode::init(
     m_headlights_cmd_sub = create_subscription<autoware_auto_msgs::msg::HeadlightsCommand>(
       "headlights_command", rclcpp::QoS{10U},
       [this](autoware_auto_msgs::msg::HeadlightsCommand::SharedPtr msg)
-      {m_interface->send_headlights_command(*msg);});
+      {send_headlights_command(*msg);});
   }
 
   if (m_enabled_features.find(ViFeature::WIPERS) != m_enabled_features.end()) {
@@ -294,7 +316,7 @@ void VehicleInterfaceNode::init(
     m_wipers_cmd_sub = create_subscription<autoware_auto_msgs::msg::WipersCommand>(
       "wipers_command", rclcpp::QoS{10U},
       [this](autoware_auto_msgs::msg::WipersCommand::SharedPtr msg)
-      {m_interface->send_wipers_command(*msg);});
+      {send_wipers_command(*msg);});
   }
 
   // State machine boilerplate for better errors
@@ -311,7 +333,7 @@ void VehicleInterfaceNode::init(
                try {
                  on_command_message(*msg);
                } catch (...) {
-                 on_error(std::current_exception());
+                 handle_error(std::current_exception());
                }
              };
     };
@@ -395,25 +417,106 @@ void VehicleInterfaceNode::check_invariants()
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+void VehicleInterfaceNode::send_control_command(const RawControlCommand & msg)
+{
+  if (m_coalesce_commands) {
+    m_raw_output.set(msg, std::chrono::steady_clock::now());
+  } else if (!m_interface->send_control_command(msg)) {
+    on_control_send_failure();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void VehicleInterfaceNode::send_control_command(const VehicleControlCommand & msg)
+{
+  if (m_coalesce_commands) {
+    m_control_output.set(msg, std::chrono::steady_clock::now());
+  } else if (!m_interface->send_control_command(msg)) {
+    on_control_send_failure();
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void VehicleInterfaceNode::send_state_command(const MaybeStateCommand & maybe_command)
 {
   if (maybe_command) {
-    if (!m_interface->send_state_command(maybe_command.value())) {
+    if (m_coalesce_commands) {
+      m_state_output.set(maybe_command.value(), std::chrono::steady_clock::now());
+    } else if (!m_interface->send_state_command(maybe_command.value())) {
       on_state_send_failure();
     }
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void VehicleInterfaceNode::send_headlights_command(const HeadlightsCommand & msg)
+{
+  if (m_coalesce_commands) {
+    m_headlights_output.set(msg, std::chrono::steady_clock::now());
+  } else {
+    m_interface->send_headlights_command(msg);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void VehicleInterfaceNode::send_wipers_command(const WipersCommand & msg)
+{
+  if (m_coalesce_commands) {
+    m_wipers_output.set(msg, std::chrono::steady_clock::now());
+  } else {
+    m_interface->send_wipers_command(msg);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void VehicleInterfaceNode::send_coalesced_commands()
+{
+  // All commands of one cycle are sent together, state after control as without coalescing
+  const auto now = std::chrono::steady_clock::now();
+  const auto send_control = [this](const auto & msg) {
+      if (!m_interface->send_control_command(msg)) {
+        on_control_send_failure();
+      }
+    };
+  (void)m_raw_output.send(now, send_control);
+  (void)m_control_output.send(now, send_control);
+  (void)m_state_output.send(
+    now, [this](const VehicleStateCommand & msg) {
+      if (!m_interface->send_state_command(msg)) {
+        on_state_send_failure();
+      }
+    });
+  (void)m_headlights_output.send(
+    now, [this](const HeadlightsCommand & msg) {m_interface->send_headlights_command(msg);});
+  (void)m_wipers_output.send(
+    now, [this](const WipersCommand & msg) {m_interface->send_wipers_command(msg);});
+
+  using Milliseconds = std::chrono::duration<float64_t, std::milli>;
+  const auto control = output_statistics().control;
+  RCLCPP_DEBUG_THROTTLE(
+    logger(), *get_clock(), 1000,
+    "Control commands: %zu sent, %zu dropped, latency mean %.3f ms, max %.3f ms",
+    control.sent, control.dropped,
+    std::chrono::duration_cast<Milliseconds>(control.mean_latency()).count(),
+    std::chrono::duration_cast<Milliseconds>(control.max_latency).count());
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void VehicleInterfaceNode::read_and_publish()
 {
+  // Send first, so that the commands leave at the rate of the timer however long reading takes
+  if (m_coalesce_commands) {
+    send_coalesced_commands();
+  }
   if (!m_interface->update(m_cycle_time - std::chrono::milliseconds{2LL})) {
     on_read_timeout();
   }
-  // Publish data from interface
-  m_odom_pub->publish(m_interface->get_odometry());
-  m_state_pub->publish(m_interface->get_state_report());
+  // Publish data from interface, reading every report once so that all uses see the same one
+  const auto & odometry = m_interface->get_odometry();
+  const auto & state_report = m_interface->get_state_report();
+  m_odom_pub->publish(odometry);
+  m_state_pub->publish(state_report);
 
   // Publish feature reports
   if (m_headlights_rpt_pub) {
@@ -426,7 +529,7 @@ void VehicleInterfaceNode::read_and_publish()
 
   // Update
   if (m_state_machine) {
-    m_state_machine->update(m_interface->get_odometry(), m_interface->get_state_report());
+    m_state_machine->update(odometry, state_report);
     state_machine_report();
   }
 }
@@ -467,39 +570,89 @@ void VehicleInterfaceNode::on_error(std::exception_ptr eptr)
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void VehicleInterfaceNode::handle_error(std::exception_ptr eptr)
+{
+  diagnostic_msgs::msg::DiagnosticArray faults;
+  faults.status.resize(1U);
+  faults.status[0U].level = diagnostic_msgs::msg::DiagnosticStatus::ERROR;
+  try {
+    std::rethrow_exception(eptr);
+  } catch (const std::exception & e) {
+    faults.status[0U].message = e.what();
+  } catch (...) {
+    faults.status[0U].message = "VehicleInterface: Unknown error!";
+  }
+  publish_faults(faults);
+  on_error(eptr);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void VehicleInterfaceNode::publish_faults(diagnostic_msgs::msg::DiagnosticArray & faults)
+{
+  faults.header.stamp = now();
+  for (auto & status : faults.status) {
+    status.name = get_fully_qualified_name();
+  }
+  m_diagnostics_pub->publish(faults);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void VehicleInterfaceNode::state_machine_report()
 {
+  using diagnostic_msgs::msg::DiagnosticStatus;
+  diagnostic_msgs::msg::DiagnosticArray faults;
+  const auto add_fault = [&faults](const uint8_t level, const char * const message) {
+      DiagnosticStatus status;
+      status.level = level;
+      status.message = message;
+      faults.status.push_back(status);
+    };
   for (const auto report : m_state_machine->reports()) {
     switch (report) {
       case StateMachineReport::CLAMP_PAST_THRESHOLD:
-        RCLCPP_WARN(logger(), "Control command wildly out of range");
+        {
+          const auto warn_str = "Control command wildly out of range";
+          RCLCPP_WARN(logger(), warn_str);
+          add_fault(DiagnosticStatus::WARN, warn_str);
+        }
         break;
       case StateMachineReport::BAD_STATE:
-        RCLCPP_WARN(logger(), "Bad state command sanitized");
+        {
+          const auto warn_str = "Bad state command sanitized";
+          RCLCPP_WARN(logger(), warn_str);
+          add_fault(DiagnosticStatus::WARN, warn_str);
+        }
         break;
       case StateMachineReport::WIPERS_ON_HEADLIGHTS_ON:
         RCLCPP_INFO(logger(), "Added headlights on due to wipers on");
         break;
       case StateMachineReport::REMOVE_GEAR_COMMAND:
-        RCLCPP_WARN(logger(), "Bad gear command removed");
+        {
+          const auto warn_str = "Bad gear command removed";
+          RCLCPP_WARN(logger(), warn_str);
+          add_fault(DiagnosticStatus::WARN, warn_str);
+        }
         break;
       case StateMachineReport::HIGH_FREQUENCY_ACCELERATION_COMMAND:
         {
           const auto err_str = "High frequency acceleration command";
           RCLCPP_ERROR(logger(), err_str);
+          add_fault(DiagnosticStatus::ERROR, err_str);
         }
         break;
       case StateMachineReport::HIGH_FREQUENCY_STEER_COMMAND:
         {
           const auto err_str = "High frequency steering command";
           RCLCPP_ERROR(logger(), err_str);
+          add_fault(DiagnosticStatus::ERROR, err_str);
         }
         break;
       case StateMachineReport::HIGH_FREQUENCY_VELOCITY_REPORT:
         {
           const auto err_str = "High frequency velocity report";
           RCLCPP_ERROR(logger(), err_str);
+          add_fault(DiagnosticStatus::ERROR, err_str);
         }
         RCLCPP_WARN(logger(), "Control command wildly out of range");
         break;
@@ -507,6 +660,7 @@ void VehicleInterfaceNode::state_machine_report()
         {
           const auto err_str = "High frequency steering report";
           RCLCPP_ERROR(logger(), err_str);
+          add_fault(DiagnosticStatus::ERROR, err_str);
         }
         break;
       case StateMachineReport::STATE_TRANSITION_TIMEOUT:
@@ -518,6 +672,9 @@ void VehicleInterfaceNode::state_machine_report()
         throw std::logic_error{"Bad state machine report"};
     }
   }
+  if (!faults.status.empty()) {
+    publish_faults(faults);
+  }
 }
 
 }  // namespace vehicle_interface
@@ -0,0 +1,65 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "test_vi_node.hpp"
+
+// Send several commands per cycle, expect that only the latest one of each cycle is sent
+TEST_F(sanity_checks, coalesced_output)
+{
+  const auto control_topic = "vehicle_command";
+
+  // Construct
+  rclcpp::NodeOptions options{};
+  options
+  .append_parameter_override("control_command", "basic")
+  .append_parameter_override("coalesce_commands", true);
+
+  const auto vi_node = std::make_shared<TestVINode>(
+    "coalesced_output_vi_node", options, false);  // no failure
+
+  // Test publisher
+  const auto pub_node = std::make_shared<rclcpp::Node>("coalesced_output_vi_pub_node");
+  const auto test_pub =
+    pub_node->create_publisher<VehicleControlCommand>(control_topic, rclcpp::QoS{10});
+  VehicleControlCommand msg{};
+  // Publish faster than the cycle time of 30 ms
+  constexpr auto max_iters{100};
+  auto count{0};
+  while (vi_node->interface().controls().size() < 3U) {
+    for (auto idx = 0; idx < 3; ++idx) {
+      ++msg.stamp.nanosec;
+      test_pub->publish(msg);
+    }
+    rclcpp::spin_some(vi_node);
+    std::this_thread::sleep_for(std::chrono::milliseconds{10LL});
+    ++count;
+    if (count > max_iters) {
+      EXPECT_TRUE(false);  // soft fail
+      break;
+    }
+  }
+  // Every sent command went through the coalesced output, most of them were replaced
+  const auto statistics = vi_node->output_statistics().control;
+  EXPECT_EQ(statistics.sent, vi_node->interface().controls().size());
+  EXPECT_GT(statistics.dropped, 0U);
+  EXPECT_GE(statistics.received, statistics.sent + statistics.dropped);
+  EXPECT_LE(statistics.received, statistics.sent + statistics.dropped + 1U);
+  EXPECT_LE(statistics.mean_latency(), statistics.max_latency);
+}
@@ -0,0 +1,61 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <stdexcept>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "vehicle_interface/coalesced_command.hpp"
+
+using autoware::drivers::vehicle_interface::CoalescedCommand;
+
+using Command = CoalescedCommand<int32_t>;
+
+TEST(test_coalesced_command, sends_latest_once) {
+  Command command{};
+  const Command::Clock::time_point start{};
+  std::vector<int32_t> sent{};
+  const auto send = [&sent](const int32_t value) {sent.push_back(value);};
+
+  EXPECT_FALSE(command.send(start, send));
+  command.set(1, start);
+  command.set(2, start + std::chrono::milliseconds{2});
+  command.set(3, start + std::chrono::milliseconds{4});
+  EXPECT_TRUE(command.pending());
+  EXPECT_TRUE(command.send(start + std::chrono::milliseconds{10}, send));
+  EXPECT_FALSE(command.pending());
+  EXPECT_FALSE(command.send(start + std::chrono::milliseconds{20}, send));
+  command.set(4, start + std::chrono::milliseconds{25});
+  EXPECT_TRUE(command.send(start + std::chrono::milliseconds{27}, send));
+
+  ASSERT_EQ(sent, (std::vector<int32_t>{3, 4}));
+  const auto & statistics = command.statistics();
+  EXPECT_EQ(statistics.received, 4U);
+  EXPECT_EQ(statistics.sent, 2U);
+  EXPECT_EQ(statistics.dropped, 2U);
+  EXPECT_EQ(statistics.max_latency, std::chrono::milliseconds{6});
+  EXPECT_EQ(statistics.mean_latency(), std::chrono::milliseconds{4});
+}
+
+TEST(test_coalesced_command, not_pending_after_throw) {
+  Command command{};
+  const Command::Clock::time_point start{};
+  command.set(1, start);
+  EXPECT_THROW(
+    command.send(start, [](const int32_t) {throw std::runtime_error{"send failed"};}),
+    std::runtime_error);
+  EXPECT_FALSE(command.pending());
+  EXPECT_EQ(command.statistics().sent, 1U);
+}
@@ -0,0 +1,103 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "vehicle_interface/report_buffer.hpp"
+
+using autoware::drivers::vehicle_interface::ReportBuffer;
+
+namespace
+{
+struct Report
+{
+  int32_t first{0};
+  int32_t second{0};
+  int32_t count{0};
+};
+}  // namespace
+
+TEST(test_report_buffer, read_sees_latest) {
+  ReportBuffer<Report> buffer{};
+  EXPECT_EQ(buffer.read().count, 0);
+  buffer.modify([](Report & report) {report.first = 1;});
+  buffer.modify([](Report & report) {report.second = 2;});
+  // Modifications accumulate, and the reader skips to the latest one
+  EXPECT_EQ(buffer.read().first, 1);
+  EXPECT_EQ(buffer.read().second, 2);
+  EXPECT_EQ(buffer.latest().second, 2);
+  // Reading again without a modification returns the same report
+  EXPECT_EQ(&buffer.read(), &buffer.read());
+  buffer.modify([](Report & report) {report.first = 3;});
+  EXPECT_EQ(buffer.latest().first, 3);
+  EXPECT_EQ(buffer.read().first, 3);
+  EXPECT_EQ(buffer.read().second, 2);
+}
+
+TEST(test_report_buffer, throwing_modification_is_not_published) {
+  ReportBuffer<Report> buffer{};
+  buffer.modify([](Report & report) {report.first = 1;});
+  EXPECT_EQ(buffer.read().first, 1);
+  EXPECT_THROW(
+    buffer.modify(
+      [](Report & report) {
+        report.second = 2;
+        throw std::runtime_error{"failed"};
+      }),
+    std::runtime_error);
+  EXPECT_EQ(buffer.read().second, 0);
+  EXPECT_EQ(buffer.latest().second, 2);
+}
+
+TEST(test_report_buffer, concurrent_writers_and_reader) {
+  ReportBuffer<Report> buffer{};
+  constexpr int32_t kUpdatesPerWriter = 20000;
+  std::atomic<bool> done{false};
+  // Each writer updates its own field, the count changes in every modification
+  const auto write = [&buffer](const bool first) {
+      for (int32_t i = 1; i <= kUpdatesPerWriter; ++i) {
+        buffer.modify(
+          [first, i](Report & report) {
+            (first ? report.first : report.second) = i;
+            ++report.count;
+          });
+      }
+    };
+  std::thread reader{[&buffer, &done]() {
+      int32_t last_count{0};
+      while (!done.load()) {
+        const auto & report = buffer.read();
+        // Never torn or older than a report that was already seen
+        EXPECT_GE(report.count, last_count);
+        EXPECT_EQ(report.first + report.second, report.count);
+        last_count = report.count;
+      }
+    }};
+  std::thread first_writer{write, true};
+  std::thread second_writer{write, false};
+  first_writer.join();
+  second_writer.join();
+  done.store(true);
+  reader.join();
+
+  const auto & report = buffer.read();
+  EXPECT_EQ(report.first, kUpdatesPerWriter);
+  EXPECT_EQ(report.second, kUpdatesPerWriter);
+  EXPECT_EQ(report.count, 2 * kUpdatesPerWriter);
+}
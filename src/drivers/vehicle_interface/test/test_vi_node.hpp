@@ -167,6 +167,8 @@ public:
     set_interface(std::move(interface));
   }
 
+  using VehicleInterfaceNode::output_statistics;
+
   const FakeInterface & interface() const noexcept {return *m_interface;}
   bool8_t error_handler_called() const noexcept {return m_error_handler_called;}
   bool8_t control_handler_called() const noexcept {return m_control_send_error_handler_called;}
@@ -55,6 +55,11 @@ static constexpr uint32_t NUM_INTENSITY_VALUES = 256U;
 static constexpr uint16_t NUM_BLOCKS_PER_PACKET = 12U;
 /// number of points stored in a data block
 static constexpr uint16_t NUM_POINTS_PER_BLOCK = 32U;
+/// return mode of a packet, from its first factory byte: the strongest or the last return are
+/// single return modes, in dual return mode each firing is delivered in a pair of blocks
+static constexpr uint8_t STRONGEST_RETURN_MODE = 0x37U;
+static constexpr uint8_t LAST_RETURN_MODE = 0x38U;
+static constexpr uint8_t DUAL_RETURN_MODE = 0x39U;
 
 /// \brief computes 2 byte representation of two bytes from out of order velodyne packet
 inline uint32_t to_uint32(const uint8_t first, const uint8_t second)
@@ -27,6 +27,11 @@
 #include <velodyne_driver/vlp16_data.hpp>
 #include <velodyne_driver/vlp32c_data.hpp>
 #include <velodyne_driver/vls128_data.hpp>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
 #include <vector>
 
 namespace autoware
@@ -42,6 +47,116 @@ namespace drivers
 ///        velodne LiDARs respectively.
 namespace velodyne_driver
 {
+/// \brief Optional filters applied to the points while a packet is decoded, so that rejected
+///        points are never written to the output. By default, all points are kept. The angles and
+///        coordinates are in the frame of the output points.
+class PointFilter
+{
+public:
+  /// \brief Keep the points whose range is in [min_radius_m, max_radius_m]
+  /// \param[in] min_radius_m Minimum distance of a point to the sensor in meters
+  /// \param[in] max_radius_m Maximum distance of a point to the sensor in meters
+  /// \throw std::runtime_error if the radii are negative or in the wrong order
+  void set_range(const float32_t min_radius_m, const float32_t max_radius_m)
+  {
+    if (!(min_radius_m >= 0.0F) || !(max_radius_m >= min_radius_m)) {
+      throw std::runtime_error("PointFilter: radii must be positive and min <= max");
+    }
+    m_min_radius_m = min_radius_m;
+    m_max_radius_m = max_radius_m;
+  }
+
+  /// \brief Keep the points whose azimuth is on the counterclockwise arc from the start angle to
+  ///        the end angle. An arc of a full revolution or more keeps all points
+  /// \param[in] start_angle_rad Azimuth where the arc starts in radians
+  /// \param[in] end_angle_rad Azimuth where the arc ends in radians
+  /// \throw std::runtime_error if an angle is not finite
+  void set_angle_window(const float32_t start_angle_rad, const float32_t end_angle_rad)
+  {
+    if (!std::isfinite(start_angle_rad) || !std::isfinite(end_angle_rad)) {
+      throw std::runtime_error("PointFilter: angles must be finite");
+    }
+    constexpr float32_t TAU = 6.283185307179586476925286766559F;
+    m_start_x = cosf(start_angle_rad);
+    m_start_y = sinf(start_angle_rad);
+    if ((end_angle_rad - start_angle_rad) >= TAU) {
+      // A wide arc from the start to itself contains every direction
+      m_end_x = m_start_x;
+      m_end_y = m_start_y;
+      m_is_wide_arc = true;
+    } else {
+      m_end_x = cosf(end_angle_rad);
+      m_end_y = sinf(end_angle_rad);
+      float32_t span = fmodf(end_angle_rad - start_angle_rad, TAU);
+      span = (span < 0.0F) ? (span + TAU) : span;
+      m_is_wide_arc = span > (0.5F * TAU);
+    }
+  }
+
+  /// \brief Drop the points inside an axis aligned box, e.g. the returns of the ego vehicle
+  /// \param[in] min_pt Corner of the box with the smallest coordinates in meters
+  /// \param[in] max_pt Corner of the box with the largest coordinates in meters
+  /// \throw std::runtime_error if the corners are in the wrong order
+  void set_crop_box(
+    const geometry_msgs::msg::Point32 & min_pt,
+    const geometry_msgs::msg::Point32 & max_pt)
+  {
+    if (!(min_pt.x <= max_pt.x) || !(min_pt.y <= max_pt.y) || !(min_pt.z <= max_pt.z)) {
+      throw std::runtime_error("PointFilter: crop box min must not be greater than max");
+    }
+    m_box_min = min_pt;
+    m_box_max = max_pt;
+  }
+
+  /// \brief Flag the points to keep. There is no branch per point, so the loop vectorizes
+  /// \param[in] r Range of each point
+  /// \param[in] x x coordinate of each point
+  /// \param[in] y y coordinate of each point
+  /// \param[in] z z coordinate of each point
+  /// \param[in] size Number of points
+  /// \param[out] keep Gets 1 for the points which pass all filters and 0 for the others
+  void apply(
+    const float32_t * const r, const float32_t * const x, const float32_t * const y,
+    const float32_t * const z, const std::size_t size, uint8_t * const keep) const
+  {
+    for (std::size_t idx = 0U; idx < size; ++idx) {
+      const bool8_t is_in_range = (r[idx] >= m_min_radius_m) & (r[idx] <= m_max_radius_m);
+      // The point is counterclockwise of the start and clockwise of the end
+      const bool8_t is_after_start = ((m_start_x * y[idx]) - (m_start_y * x[idx])) >= 0.0F;
+      const bool8_t is_before_end = ((x[idx] * m_end_y) - (y[idx] * m_end_x)) >= 0.0F;
+      const bool8_t is_in_arc = m_is_wide_arc ?
+        (is_after_start | is_before_end) : (is_after_start & is_before_end);
+      const bool8_t is_in_box =
+        (x[idx] >= m_box_min.x) & (x[idx] <= m_box_max.x) &
+        (y[idx] >= m_box_min.y) & (y[idx] <= m_box_max.y) &
+        (z[idx] >= m_box_min.z) & (z[idx] <= m_box_max.z);
+      keep[idx] = static_cast<uint8_t>(is_in_range & is_in_arc & !is_in_box);
+    }
+  }
+
+private:
+  static geometry_msgs::msg::Point32 make_point(const float32_t value)
+  {
+    geometry_msgs::msg::Point32 pt;
+    pt.x = value;
+    pt.y = value;
+    pt.z = value;
+    return pt;
+  }
+
+  float32_t m_min_radius_m{0.0F};
+  float32_t m_max_radius_m{std::numeric_limits<float32_t>::max()};
+  /// unit vectors of the start and end of the arc, the default wide arc keeps everything
+  float32_t m_start_x{1.0F};
+  float32_t m_start_y{0.0F};
+  float32_t m_end_x{1.0F};
+  float32_t m_end_y{0.0F};
+  bool8_t m_is_wide_arc{true};
+  /// the default box is empty
+  geometry_msgs::msg::Point32 m_box_min{make_point(std::numeric_limits<float32_t>::max())};
+  geometry_msgs::msg::Point32 m_box_max{make_point(std::numeric_limits<float32_t>::lowest())};
+};  // class PointFilter
+
 /// \brief This class handles converting packets from a velodyne lidar into cartesian points.
 /// \tparam SensorData Data class representing a specific sensor model.
 template<typename SensorData>
@@ -56,9 +171,20 @@ public:
 public:
     /// \brief Constructor
     /// \param[in] rpm rotation speed of the velodyne, determines how many points per scan
-    explicit Config(const float32_t rpm)
-    : m_rpm(rpm)
+    /// \param[in] sector_size_deg if positive, a scan ends every time the azimuth enters a new
+    ///                            sector of this size instead of after a full revolution
+    /// \param[in] filter filters applied to the points while they are decoded
+    /// \throw std::runtime_error if the sector size is negative or bigger than a revolution
+    explicit Config(
+      const float32_t rpm, const float32_t sector_size_deg = 0.0F,
+      const PointFilter & filter = PointFilter{})
+    : m_rpm(rpm),
+      m_sector_size_deg(sector_size_deg),
+      m_filter(filter)
     {
+      if ((sector_size_deg < 0.0F) || (sector_size_deg > 360.0F)) {
+        throw std::runtime_error("VelodyneTranslator: sector size must be in [0, 360] degrees");
+      }
     }
     /// \brief Gets rpm value
     /// \return rpm
@@ -66,10 +192,26 @@ public:
     {
       return m_rpm;
     }
+    /// \brief Gets the sector size, 0 if scans are full revolutions
+    /// \return sector size in degrees
+    float32_t get_sector_size_deg() const
+    {
+      return m_sector_size_deg;
+    }
+    /// \brief Gets the filters applied to the points while they are decoded
+    /// \return point filter
+    const PointFilter & get_filter() const
+    {
+      return m_filter;
+    }
 
 private:
     /// rotation speed of the velodyne, determines how many points per scan
     float32_t m_rpm;
+    /// size of the azimuth sector of a scan, 0 for full revolutions
+    float32_t m_sector_size_deg;
+    /// filters applied to the points while they are decoded
+    PointFilter m_filter;
   };
   /// \brief corresponds to an individual laser's firing and return
   /// First two bytes are distance, last byte is intensity
@@ -98,53 +240,65 @@ private:
   /// \param[in] config config struct with rpm, transform, radial and angle pruning params
   /// \throw std::runtime_error if pruning parameters are inconsistent
   explicit VelodyneTranslator(const Config & config)
-  : m_sensor_data(config.get_rpm())
+  : m_sector_size_ind(static_cast<uint32_t>(std::lround(config.get_sector_size_deg() * DEG2IDX))),
+    m_filter(config.get_filter()),
+    m_sensor_data(config.get_rpm())
   {
     init_trig_tables();
     init_intensity_table();
+    init_channel_tables();
   }
 
-  /// \brief Convert a packet into a block of cartesian points
+  /// \brief Convert a packet into a block of cartesian points. The channels of a block are
+  ///        decoded together, see decode_block(). In dual return mode, the two returns of a firing
+  ///        get the same id and a second return equal to the first one is dropped. A point with
+  ///        the id END_OF_SCAN_ID is inserted after a full revolution or, in sector mode, before
+  ///        the first block of each new sector.
   /// \param[in] pkt A packet from a VLP16 HiRes sensor for conversion
   /// \param[out] output Gets filled with cartesian points and any additional flags
   void convert(const Packet & pkt, std::vector<autoware::common::types::PointXYZIF> & output)
   {
     output.clear();
+    const bool8_t is_dual_return = (pkt.factory_bytes[0U] == DUAL_RETURN_MODE);
+    const DataBlock * first_return = nullptr;
 
-    for (uint32_t block_id = 0U; block_id < NUM_BLOCKS_PER_PACKET; ++block_id, ++m_block_counter) {
+    for (uint32_t block_id = 0U; block_id < NUM_BLOCKS_PER_PACKET; ++block_id) {
       const DataBlock & block = pkt.blocks[block_id];
+      // In dual return mode, blocks come in pairs holding the two returns of the same firings
+      const bool8_t is_second_return = is_dual_return && ((block_id % 2U) == 1U);
+      const bool8_t ends_firing = (!is_dual_return) || is_second_return;
       const auto flag_check_result = m_sensor_data.check_flag(block.flag);
-      // Ignore block with invalid flag.
-      if (!flag_check_result.first) {
-        continue;
-      }
       // Number of points from the sequence that has already been delivered in previous blocks.
-      const auto num_banked_pts = flag_check_result.second;
-      const uint32_t azimuth_base = to_uint32(block.azimuth_bytes[1U], block.azimuth_bytes[0U]);
-
-      for (uint16_t pt_id = 0U; pt_id < NUM_POINTS_PER_BLOCK; ++pt_id) {
-        const DataChannel & channel = block.channels[pt_id];
-        const uint32_t th = (azimuth_base + m_sensor_data.azimuth_offset(
-            num_banked_pts, block_id, pt_id)) % AZIMUTH_ROTATION_RESOLUTION;
-        const float32_t r = compute_distance_m(channel.data[1U], channel.data[0U]);
-        const uint32_t phi = m_sensor_data.altitude(num_banked_pts, block_id, pt_id);
-
-        // Compute the point
-        PointXYZIF pt;
-        polar_to_xyz(pt, r, th, phi);
-        pt.intensity = m_intensity_table[channel.data[2U]];
-        pt.id = m_sensor_data.seq_id(m_block_counter, pt_id);
-
-        output.push_back(pt);
+      const uint32_t bank =
+        static_cast<uint32_t>(flag_check_result.second) / NUM_POINTS_PER_BLOCK;
+      // Ignore block with invalid flag.
+      if (flag_check_result.first && (bank < NUM_BANKS)) {
+        if (m_sector_size_ind > 0U) {
+          const uint32_t azimuth = to_uint32(block.azimuth_bytes[1U], block.azimuth_bytes[0U]);
+          const uint32_t sector = azimuth / m_sector_size_ind;
+          // the previous sector is complete, the azimuth wraps around with a single sector
+          if ((m_sector != INVALID_SECTOR) && ((sector != m_sector) || (azimuth < m_azimuth))) {
+            push_end_of_scan(output);
+          }
+          m_sector = sector;
+          m_azimuth = azimuth;
+        }
+        decode_block(block, block_id, bank, is_second_return ? first_return : nullptr, output);
+        first_return = &block;
+        if (ends_firing &&
+          (static_cast<float32_t>(m_block_counter) > m_sensor_data.num_blocks_per_revolution()))
+        {
+          // full revolution reached.
+          if (m_sector_size_ind == 0U) {
+            push_end_of_scan(output);
+          }
+          m_block_counter = uint16_t{0U};
+        }
+      } else {
+        first_return = nullptr;
       }
-
-      if (static_cast<float32_t>(m_block_counter) > m_sensor_data.num_blocks_per_revolution()) {
-        // full revolution reached.
-        PointXYZIF pt;
-        pt.id =
-          static_cast<uint16_t>(PointXYZIF::END_OF_SCAN_ID);
-        output.push_back(pt);
-        m_block_counter = uint16_t{0U};
+      if (ends_firing) {
+        ++m_block_counter;
       }
     }
   }
@@ -160,22 +314,92 @@ private:
     ((NUM_POINTS_PER_BLOCK * NUM_BLOCKS_PER_PACKET) + 1U),
     "Number of points from one VLP16 packet cannot fit into a point block");
 
-  /// \brief converts polar coordinates into cartesian (xyz), not threadsafe: modifies a
-  ///        preallocated workspace member variable (m_point)
-  /// \param[out] pt Gets filled with the requisite cartesian information
-  /// \param[in] r_m the radius in meters
-  /// \param[in] th_ind the index of the azimuth in lookup tables (angle about the z-axis)
-  /// \param[in] phi_ind the altitude angle index from lookup tables(angle orthogonal to z-axis)
-  inline void polar_to_xyz(
-    autoware::common::types::PointXYZIF & pt,
-    const float32_t r_m,
-    const uint32_t th_ind,
-    const uint32_t phi_ind) const
-  {
-    const float32_t r_xy = r_m * m_cos_table[phi_ind];
-    pt.x = r_xy * m_cos_table[th_ind];  // y (vlp-frame)
-    pt.y = -r_xy * m_sin_table[th_ind];  // -x (vlp-frame)
-    pt.z = r_m * m_sin_table[phi_ind];
+  /// \brief Decode all the channels of a block and append them to the output. The angles of each
+  ///        channel are precomputed by init_channel_tables(), and the azimuth of a channel is the
+  ///        azimuth of the block rotated by the offset of the channel. The channels are then
+  ///        converted and filtered as arrays with no lookup nor branch, which the compiler
+  ///        vectorizes. Only the points which pass the filter are written to the output.
+  /// \param[in] block The block to decode
+  /// \param[in] block_id Index of the block in its packet
+  /// \param[in] bank Index of the bank of NUM_POINTS_PER_BLOCK lasers the block belongs to
+  /// \param[in] first_return The first return of the firing if the block is a second return,
+  ///                         channels equal to the first return are skipped. nullptr otherwise.
+  /// \param[out] output Gets the points of the block appended
+  void decode_block(
+    const DataBlock & block,
+    const uint32_t block_id,
+    const uint32_t bank,
+    const DataBlock * const first_return,
+    std::vector<autoware::common::types::PointXYZIF> & output) const
+  {
+    const uint32_t azimuth_base =
+      to_uint32(block.azimuth_bytes[1U], block.azimuth_bytes[0U]) % AZIMUTH_ROTATION_RESOLUTION;
+    const float32_t cos_base = m_cos_table[azimuth_base];
+    const float32_t sin_base = m_sin_table[azimuth_base];
+    const std::size_t table_offset =
+      ((bank * NUM_BLOCKS_PER_PACKET) + block_id) * NUM_POINTS_PER_BLOCK;
+    const float32_t * const cos_th_offset = &m_cos_azimuth_offset_table[table_offset];
+    const float32_t * const sin_th_offset = &m_sin_azimuth_offset_table[table_offset];
+    const float32_t * const cos_phi = &m_cos_altitude_table[table_offset];
+    const float32_t * const sin_phi = &m_sin_altitude_table[table_offset];
+
+    std::array<float32_t, NUM_POINTS_PER_BLOCK> r_m;
+    for (uint32_t pt_id = 0U; pt_id < NUM_POINTS_PER_BLOCK; ++pt_id) {
+      const DataChannel & channel = block.channels[pt_id];
+      r_m[pt_id] = compute_distance_m(channel.data[1U], channel.data[0U]);
+    }
+    std::array<float32_t, NUM_POINTS_PER_BLOCK> x;
+    std::array<float32_t, NUM_POINTS_PER_BLOCK> y;
+    std::array<float32_t, NUM_POINTS_PER_BLOCK> z;
+    for (uint32_t pt_id = 0U; pt_id < NUM_POINTS_PER_BLOCK; ++pt_id) {
+      const float32_t r_xy = r_m[pt_id] * cos_phi[pt_id];
+      const float32_t cos_th =
+        (cos_base * cos_th_offset[pt_id]) - (sin_base * sin_th_offset[pt_id]);
+      const float32_t sin_th =
+        (sin_base * cos_th_offset[pt_id]) + (cos_base * sin_th_offset[pt_id]);
+      x[pt_id] = r_xy * cos_th;  // y (vlp-frame)
+      y[pt_id] = -r_xy * sin_th;  // -x (vlp-frame)
+      z[pt_id] = r_m[pt_id] * sin_phi[pt_id];
+    }
+    std::array<uint8_t, NUM_POINTS_PER_BLOCK> keep;
+    m_filter.apply(r_m.data(), x.data(), y.data(), z.data(), NUM_POINTS_PER_BLOCK, keep.data());
+
+    // The points are written in place rather than pushed back one by one
+    const uint16_t first_id = m_sensor_data.seq_id(m_block_counter, 0U);
+    std::size_t out_idx = output.size();
+    output.resize(out_idx + NUM_POINTS_PER_BLOCK);
+    for (uint32_t pt_id = 0U; pt_id < NUM_POINTS_PER_BLOCK; ++pt_id) {
+      const DataChannel & channel = block.channels[pt_id];
+      if ((keep[pt_id] == 0U) ||
+        ((first_return != nullptr) && is_same_return(channel, first_return->channels[pt_id])))
+      {
+        continue;
+      }
+      PointXYZIF & pt = output[out_idx];
+      pt.x = x[pt_id];
+      pt.y = y[pt_id];
+      pt.z = z[pt_id];
+      pt.intensity = m_intensity_table[channel.data[2U]];
+      pt.id = static_cast<uint16_t>(first_id + m_seq_id_offset_table[pt_id]);
+      ++out_idx;
+    }
+    output.resize(out_idx);
+  }
+
+  /// \brief Append the point delimiting two scans
+  inline void push_end_of_scan(std::vector<autoware::common::types::PointXYZIF> & output) const
+  {
+    PointXYZIF pt;
+    pt.id =
+      static_cast<uint16_t>(PointXYZIF::END_OF_SCAN_ID);
+    output.push_back(pt);
+  }
+
+  /// \brief Check if two channels hold the same return
+  inline bool8_t is_same_return(const DataChannel & first, const DataChannel & second) const
+  {
+    return (first.data[0U] == second.data[0U]) && (first.data[1U] == second.data[1U]) &&
+           (first.data[2U] == second.data[2U]);
   }
 
   /// \brief converts the two byte representation of distance into meters
@@ -213,8 +437,43 @@ private:
     }
   }
 
+  /// \brief initializes the angle and sequence id lookup tables of the channels
+  VELODYNE_DRIVER_LOCAL void init_channel_tables()
+  {
+    std::size_t table_idx = 0U;
+    for (uint32_t bank = 0U; bank < NUM_BANKS; ++bank) {
+      const auto num_banked_pts = static_cast<uint16_t>(bank * NUM_POINTS_PER_BLOCK);
+      for (uint32_t block_id = 0U; block_id < NUM_BLOCKS_PER_PACKET; ++block_id) {
+        for (uint32_t pt_id = 0U; pt_id < NUM_POINTS_PER_BLOCK; ++pt_id) {
+          const uint32_t th = m_sensor_data.azimuth_offset(num_banked_pts, block_id, pt_id) %
+            AZIMUTH_ROTATION_RESOLUTION;
+          const uint32_t phi = m_sensor_data.altitude(num_banked_pts, block_id, pt_id) %
+            AZIMUTH_ROTATION_RESOLUTION;
+          m_cos_azimuth_offset_table[table_idx] = m_cos_table[th];
+          m_sin_azimuth_offset_table[table_idx] = m_sin_table[th];
+          m_cos_altitude_table[table_idx] = m_cos_table[phi];
+          m_sin_altitude_table[table_idx] = m_sin_table[phi];
+          ++table_idx;
+        }
+      }
+    }
+    // The sequence id of a channel is the one of the first channel of its block plus an offset
+    // that only depends on the channel
+    for (uint32_t pt_id = 0U; pt_id < NUM_POINTS_PER_BLOCK; ++pt_id) {
+      m_seq_id_offset_table[pt_id] = static_cast<uint16_t>(
+        m_sensor_data.seq_id(0U, pt_id) - m_sensor_data.seq_id(0U, 0U));
+    }
+  }
+
   /// tau = 2 pi
   static constexpr float32_t TAU = 6.283185307179586476925286766559F;
+  /// number of banks of NUM_POINTS_PER_BLOCK lasers, each bank is delivered in its own blocks
+  static constexpr uint32_t NUM_BANKS =
+    (static_cast<uint32_t>(SensorData::NUM_LASERS) + NUM_POINTS_PER_BLOCK - 1U) /
+    NUM_POINTS_PER_BLOCK;
+  /// number of entries of the channel angle tables: one per channel of each bank and block
+  static constexpr std::size_t NUM_CHANNEL_ANGLES =
+    static_cast<std::size_t>(NUM_BANKS) * NUM_BLOCKS_PER_PACKET * NUM_POINTS_PER_BLOCK;
 
   /// parameters
   /// lookup table for sin
@@ -222,10 +481,27 @@ private:
   /// lookup table for cos
   std::array<float32_t, AZIMUTH_ROTATION_RESOLUTION> m_cos_table;
   /// lookup table for intensity
-  std::array<float32_t, AZIMUTH_ROTATION_RESOLUTION> m_intensity_table;
+  std::array<float32_t, NUM_INTENSITY_VALUES> m_intensity_table;
+  /// lookup tables for the cos and sin of the azimuth offset and altitude of each channel
+  std::array<float32_t, NUM_CHANNEL_ANGLES> m_cos_azimuth_offset_table;
+  std::array<float32_t, NUM_CHANNEL_ANGLES> m_sin_azimuth_offset_table;
+  std::array<float32_t, NUM_CHANNEL_ANGLES> m_cos_altitude_table;
+  std::array<float32_t, NUM_CHANNEL_ANGLES> m_sin_altitude_table;
+  /// lookup table for the sequence id of each channel, relative to the first channel of a block
+  std::array<uint16_t, NUM_POINTS_PER_BLOCK> m_seq_id_offset_table;
+
+  /// sector of a state without a previous block
+  static constexpr uint32_t INVALID_SECTOR = std::numeric_limits<uint32_t>::max();
 
   /// mask to avoid modulo: packet id can go up to 3617: 0000 1111 1111 1111 = 4096
   uint16_t m_block_counter{0U};
+  /// size of a sector in azimuth indices, 0 if scans are full revolutions
+  const uint32_t m_sector_size_ind;
+  /// filters applied to the points while they are decoded
+  const PointFilter m_filter;
+  /// sector and azimuth of the last decoded block
+  uint32_t m_sector{INVALID_SECTOR};
+  uint32_t m_azimuth{0U};
   SensorData m_sensor_data;
 };  // class Driver
 using Vlp16Translator = VelodyneTranslator<VLP16Data>;
@@ -24,6 +24,7 @@
 #include <vector>
 #include <limits>
 #include <algorithm>
+#include <iterator>
 
 #include "common/types.hpp"
 #include "velodyne_driver/velodyne_translator.hpp"
@@ -257,6 +258,187 @@ TEST_F(velodyne_driver, basic)
   EXPECT_LE(phi_diff, (20.0F * 3.14159F / 180.0F) + 0.001F);
 }
 
+// the points match polar coordinates computed from the trig tables of each channel
+TEST_F(velodyne_driver, block_decode)
+{
+  using autoware::drivers::velodyne_driver::AZIMUTH_ROTATION_RESOLUTION;
+  using autoware::drivers::velodyne_driver::VLP16Data;
+  using autoware::drivers::velodyne_driver::to_uint32;
+  const Vlp16Translator::Config cfg{300.0F};
+  Vlp16Translator driver(cfg);
+  const VLP16Data sensor_data{300.0F};
+  driver.convert(pkt, out);
+  ASSERT_EQ(out.size(), static_cast<size_t>(NUM_POINTS_PER_BLOCK * NUM_BLOCKS_PER_PACKET));
+  constexpr float32_t IDX2RAD = 6.283185307179586F / AZIMUTH_ROTATION_RESOLUTION;
+  for (uint32_t block_id = 0U; block_id < NUM_BLOCKS_PER_PACKET; ++block_id) {
+    const auto & block = pkt.blocks[block_id];
+    const uint32_t azimuth_base = to_uint32(block.azimuth_bytes[1U], block.azimuth_bytes[0U]);
+    for (uint32_t pt_id = 0U; pt_id < NUM_POINTS_PER_BLOCK; ++pt_id) {
+      const auto & channel = block.channels[pt_id];
+      const uint32_t th = (azimuth_base + sensor_data.azimuth_offset(0U, block_id, pt_id)) %
+        AZIMUTH_ROTATION_RESOLUTION;
+      const uint32_t phi = sensor_data.altitude(0U, block_id, pt_id);
+      const float32_t r = static_cast<float32_t>(to_uint32(channel.data[1U], channel.data[0U])) *
+        VLP16Data::distance_resolution();
+      const float32_t r_xy = r * cosf(static_cast<float32_t>(phi) * IDX2RAD);
+      const auto & pt = out[(block_id * NUM_POINTS_PER_BLOCK) + pt_id];
+      EXPECT_NEAR(pt.x, r_xy * cosf(static_cast<float32_t>(th) * IDX2RAD), 1.0E-3F);
+      EXPECT_NEAR(pt.y, -r_xy * sinf(static_cast<float32_t>(th) * IDX2RAD), 1.0E-3F);
+      EXPECT_NEAR(pt.z, r * sinf(static_cast<float32_t>(phi) * IDX2RAD), 1.0E-3F);
+      EXPECT_FLOAT_EQ(pt.intensity, static_cast<float32_t>(channel.data[2U]));
+      EXPECT_EQ(pt.id, sensor_data.seq_id(static_cast<uint16_t>(block_id), pt_id));
+    }
+  }
+}
+
+// in dual return mode, both returns of a firing get the same id and duplicates are dropped
+TEST_F(velodyne_driver, dual_return)
+{
+  using autoware::drivers::velodyne_driver::DUAL_RETURN_MODE;
+  pkt.factory_bytes[0U] = DUAL_RETURN_MODE;
+  for (uint32_t block_id = 1U; block_id < NUM_BLOCKS_PER_PACKET; block_id += 2U) {
+    pkt.blocks[block_id] = pkt.blocks[block_id - 1U];
+    // Only the third channel has a different second return
+    pkt.blocks[block_id].channels[3U].data[1U] =
+      static_cast<uint8_t>(pkt.blocks[block_id].channels[3U].data[1U] + 1U);
+  }
+  const Vlp16Translator::Config cfg{300.0F};
+  Vlp16Translator driver(cfg);
+  driver.convert(pkt, out);
+  constexpr uint32_t num_points_per_firing = NUM_POINTS_PER_BLOCK + 1U;
+  ASSERT_EQ(out.size(), static_cast<size_t>(num_points_per_firing * (NUM_BLOCKS_PER_PACKET / 2U)));
+  for (uint32_t firing_id = 0U; firing_id < (NUM_BLOCKS_PER_PACKET / 2U); ++firing_id) {
+    const auto & first = out[(firing_id * num_points_per_firing) + 3U];
+    const auto & second = out[(firing_id * num_points_per_firing) + NUM_POINTS_PER_BLOCK];
+    EXPECT_EQ(first.id, second.id);
+    EXPECT_GT(fabsf(first.x - second.x) + fabsf(first.y - second.y), 0.0F);
+    if (firing_id > 0U) {
+      // the two blocks of a firing count as one block
+      EXPECT_EQ(
+        out[firing_id * num_points_per_firing].id,
+        out[(firing_id - 1U) * num_points_per_firing].id + 2U);
+    }
+  }
+}
+
+// in sector mode, a scan ends every time the azimuth enters a new sector
+TEST_F(velodyne_driver, sector_mode)
+{
+  using autoware::common::types::PointXYZIF;
+  EXPECT_THROW(Vlp16Translator::Config(300.0F, -1.0F), std::runtime_error);
+  EXPECT_THROW(Vlp16Translator::Config(300.0F, 361.0F), std::runtime_error);
+  // The blocks of the packet span from 271.77 to 276.17 degrees
+  const Vlp16Translator::Config cfg{300.0F, 1.0F};
+  Vlp16Translator driver(cfg);
+  const auto count_end_of_scans = [this]() {
+      return std::count_if(
+        out.begin(), out.end(), [](const PointXYZIF & pt) {
+          return pt.id == static_cast<uint16_t>(PointXYZIF::END_OF_SCAN_ID);
+        });
+    };
+  driver.convert(pkt, out);
+  // The first sector has no previous one to end
+  EXPECT_EQ(count_end_of_scans(), 5);
+  EXPECT_EQ(out.size(), static_cast<size_t>((NUM_POINTS_PER_BLOCK * NUM_BLOCKS_PER_PACKET) + 5U));
+  // Going back to the first sector ends the last one
+  driver.convert(pkt, out);
+  EXPECT_EQ(count_end_of_scans(), 6);
+  EXPECT_EQ(out.front().id, static_cast<uint16_t>(PointXYZIF::END_OF_SCAN_ID));
+}
+
+// the filters keep the same points as filtering the unfiltered output
+TEST_F(velodyne_driver, point_filter)
+{
+  using autoware::common::types::PointXYZIF;
+  using autoware::drivers::velodyne_driver::PointFilter;
+  const auto make_point = [](const float32_t x, const float32_t y, const float32_t z) {
+      geometry_msgs::msg::Point32 pt;
+      pt.x = x;
+      pt.y = y;
+      pt.z = z;
+      return pt;
+    };
+  PointFilter filter;
+  EXPECT_THROW(filter.set_range(-1.0F, 10.0F), std::runtime_error);
+  EXPECT_THROW(filter.set_range(10.0F, 5.0F), std::runtime_error);
+  EXPECT_THROW(filter.set_angle_window(0.0F, NAN), std::runtime_error);
+  EXPECT_THROW(
+    filter.set_crop_box(make_point(1.0F, 0.0F, 0.0F), make_point(0.0F, 1.0F, 1.0F)),
+    std::runtime_error);
+
+  Vlp16Translator unfiltered_driver{Vlp16Translator::Config{300.0F}};
+  std::vector<PointXYZIF> unfiltered;
+  unfiltered.reserve(Vlp16Translator::POINT_BLOCK_CAPACITY);
+  unfiltered_driver.convert(pkt, unfiltered);
+  // The default filter keeps everything
+  Vlp16Translator default_driver{Vlp16Translator::Config{300.0F, 0.0F, filter}};
+  default_driver.convert(pkt, out);
+  ASSERT_EQ(out.size(), unfiltered.size());
+
+  const auto check = [this, &unfiltered](
+    const PointFilter & point_filter, const auto & is_kept) {
+      Vlp16Translator driver{Vlp16Translator::Config{300.0F, 0.0F, point_filter}};
+      driver.convert(pkt, out);
+      std::vector<PointXYZIF> expected;
+      std::copy_if(unfiltered.begin(), unfiltered.end(), std::back_inserter(expected), is_kept);
+      EXPECT_GT(expected.size(), 0U);
+      EXPECT_LT(expected.size(), unfiltered.size());
+      ASSERT_EQ(out.size(), expected.size());
+      for (std::size_t idx = 0U; idx < out.size(); ++idx) {
+        EXPECT_EQ(out[idx].x, expected[idx].x);
+        EXPECT_EQ(out[idx].id, expected[idx].id);
+      }
+    };
+  const auto range = [](const PointXYZIF & pt) {
+      return sqrtf((pt.x * pt.x) + (pt.y * pt.y) + (pt.z * pt.z));
+    };
+
+  PointFilter range_filter;
+  range_filter.set_range(8.001F, 15.001F);
+  check(
+    range_filter, [&range](const PointXYZIF & pt) {
+      return (range(pt) >= 8.001F) && (range(pt) <= 15.001F);
+    });
+
+  // Split the azimuths of the packet in two
+  float32_t min_th = std::numeric_limits<float32_t>::max();
+  float32_t max_th = std::numeric_limits<float32_t>::lowest();
+  for (const auto & pt : unfiltered) {
+    if (range(pt) > 0.0F) {
+      min_th = std::min(min_th, atan2f(pt.y, pt.x));
+      max_th = std::max(max_th, atan2f(pt.y, pt.x));
+    }
+  }
+  const float32_t mid_th = 0.5F * (min_th + max_th);
+  const auto is_after_mid = [mid_th](const PointXYZIF & pt) {
+      return atan2f(pt.y, pt.x) >= mid_th;
+    };
+  PointFilter narrow_filter;
+  narrow_filter.set_angle_window(mid_th, mid_th + 1.0F);
+  // The missing returns at the origin are on every arc
+  check(
+    narrow_filter, [&](const PointXYZIF & pt) {return (range(pt) == 0.0F) || is_after_mid(pt);});
+  // The wide arc wraps around
+  PointFilter wide_filter;
+  wide_filter.set_angle_window(mid_th - 4.0F, mid_th);
+  check(
+    wide_filter, [&](const PointXYZIF & pt) {return (range(pt) == 0.0F) || !is_after_mid(pt);});
+
+  PointFilter box_filter;
+  box_filter.set_crop_box(make_point(-200.0F, -200.0F, -200.0F), make_point(200.0F, 200.0F, 0.0F));
+  check(box_filter, [](const PointXYZIF & pt) {return pt.z > 0.0F;});
+
+  // All filters at once
+  PointFilter filter_all = range_filter;
+  filter_all.set_angle_window(mid_th, mid_th + 1.0F);
+  filter_all.set_crop_box(
+    make_point(-200.0F, -200.0F, -200.0F), make_point(200.0F, 200.0F, 0.0F));
+  check(
+    filter_all, [&](const PointXYZIF & pt) {
+      return (range(pt) >= 8.001F) && (range(pt) <= 15.001F) && is_after_mid(pt) && (pt.z > 0.0F);
+    });
+}
+
 // figure out what the runtime of convert() is, locally
 TEST_F(velodyne_driver, benchmark)
 {
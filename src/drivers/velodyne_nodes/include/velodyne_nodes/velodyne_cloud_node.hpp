@@ -24,16 +24,11 @@
 #define VELODYNE_NODES__VELODYNE_CLOUD_NODE_HPP_
 
 #include <string>
-#include <vector>
-#include "common/types.hpp"
-#include "lidar_utils/point_cloud_utils.hpp"
 #include "rclcpp/rclcpp.hpp"
 #include "udp_driver/udp_driver.hpp"
 #include "velodyne_driver/velodyne_translator.hpp"
+#include "velodyne_nodes/velodyne_sensor.hpp"
 #include "velodyne_nodes/visibility_control.hpp"
-#include "sensor_msgs/msg/point_cloud2.hpp"
-
-using autoware::common::types::bool8_t;
 
 namespace autoware
 {
@@ -56,38 +51,15 @@ public:
 
   VelodyneCloudNode(const std::string & node_name, const rclcpp::NodeOptions & options);
 
-  /// Handle data packet from the udp driver
-  /// \param buffer Data from the udp driver
-  void receiver_callback(const std::vector<uint8_t> & buffer);
-
-protected:
-  void init_output(sensor_msgs::msg::PointCloud2 & output);
-  bool8_t convert(
-    const Packet & pkt,
-    sensor_msgs::msg::PointCloud2 & output);
-  bool8_t get_output_remainder(sensor_msgs::msg::PointCloud2 & output);
+  /// Constructor used when the node is loaded as a component
+  /// \param options Node options. If intra-process communication is enabled, every cloud is
+  /// published as a unique pointer so that intra-process subscribers receive it without a copy.
+  explicit VelodyneCloudNode(const rclcpp::NodeOptions & options);
 
 private:
-  void init_udp_driver();
-
   IoContext m_io_cxt;
-  ::drivers::udp_driver::UdpDriver m_udp_driver;
-  VelodyneTranslatorT m_translator;
-  std::vector<autoware::common::types::PointXYZIF> m_point_block;
-
-  std::string m_ip;
-  uint16_t m_port;
-  rclcpp::Publisher<sensor_msgs::msg::PointCloud2>::SharedPtr m_pc2_pub_ptr;
-  sensor_msgs::msg::PointCloud2 m_pc2_msg{};
-  bool m_published_cloud = false;
-  // Keeps track of where you left off on the converted point block in case you needed to publish
-  // a point cloud in the middle of processing it
-  uint32_t m_remainder_start_idx;
-  // keeps track of the constructed point cloud to continue growing it with new data
-  uint32_t m_point_cloud_idx;
-  autoware::common::lidar_utils::PointCloudIts m_point_cloud_its;
-  const std::string m_frame_id;
-  const std::size_t m_cloud_size;
+  /// The sensor, with the parameters of the node
+  VelodyneSensor<SensorData> m_sensor;
 };  // class VelodyneCloudNode
 
 using VLP16DriverNode = VelodyneCloudNode<velodyne_driver::VLP16Data>;
@@ -0,0 +1,71 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+/// \file
+/// \brief This file defines a ROS 2 velodyne driver that services several sensors in one node
+
+#ifndef VELODYNE_NODES__VELODYNE_MULTI_CLOUD_NODE_HPP_
+#define VELODYNE_NODES__VELODYNE_MULTI_CLOUD_NODE_HPP_
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "rclcpp/rclcpp.hpp"
+#include "udp_driver/udp_driver.hpp"
+#include "velodyne_nodes/velodyne_sensor.hpp"
+#include "velodyne_nodes/visibility_control.hpp"
+
+namespace autoware
+{
+namespace drivers
+{
+namespace velodyne_nodes
+{
+
+/// Velodyne driver node for several sensors, e.g. of a vehicle with many lidars. The sockets of
+/// all sensors are serviced by the few threads of one I/O context, instead of an I/O context per
+/// sensor node, and each sensor publishes its own clouds.
+class VELODYNE_NODES_PUBLIC VelodyneMultiCloudNode : public rclcpp::Node
+{
+public:
+  /// Constructor. The parameter `sensors` lists the names of the sensors, and the parameters of
+  /// each sensor are the ones of VelodyneCloudNode prefixed by its name, plus its `model`.
+  /// \param node_name Name of the node
+  /// \param options Node options
+  /// \throw std::runtime_error If there is no sensor, a model is not supported or the parameters
+  /// of a sensor are invalid
+  VelodyneMultiCloudNode(const std::string & node_name, const rclcpp::NodeOptions & options);
+
+  /// Constructor used when the node is loaded as a component
+  /// \param options Node options
+  explicit VelodyneMultiCloudNode(const rclcpp::NodeOptions & options);
+
+private:
+  /// Create a sensor from its parameters
+  /// \param name Name of the sensor, the prefix of its parameters
+  /// \return The sensor
+  std::unique_ptr<VelodyneSensorBase> create_sensor(const std::string & name);
+
+  /// Services the sockets of all sensors with the number of threads of the parameter
+  /// `io_threads`, one by default
+  IoContext m_io_cxt;
+  std::vector<std::unique_ptr<VelodyneSensorBase>> m_sensors;
+};  // class VelodyneMultiCloudNode
+}  // namespace velodyne_nodes
+}  // namespace drivers
+}  // namespace autoware
+
+#endif  // VELODYNE_NODES__VELODYNE_MULTI_CLOUD_NODE_HPP_
@@ -0,0 +1,139 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+/// \file
+/// \brief This file defines the reception and conversion of the packets of one velodyne sensor
+
+#ifndef VELODYNE_NODES__VELODYNE_SENSOR_HPP_
+#define VELODYNE_NODES__VELODYNE_SENSOR_HPP_
+
+#include <string>
+#include <vector>
+#include "common/types.hpp"
+#include "latency_tracing/tracer.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "udp_driver/udp_driver.hpp"
+#include "velodyne_driver/velodyne_translator.hpp"
+#include "velodyne_nodes/visibility_control.hpp"
+#include "sensor_msgs/msg/point_cloud2.hpp"
+
+using autoware::common::types::bool8_t;
+using autoware::common::types::PointXYZIF;
+
+namespace autoware
+{
+namespace drivers
+{
+namespace velodyne_nodes
+{
+
+/// Base class of the sensors, so that sensors of different models can be owned together
+class VELODYNE_NODES_PUBLIC VelodyneSensorBase
+{
+public:
+  virtual ~VelodyneSensorBase() = default;
+};  // class VelodyneSensorBase
+
+/// Receives the packets of one velodyne sensor on a socket of an I/O context, converts them
+/// and publishes the clouds on a publisher of a node. The context can be shared by several
+/// sensors, which are then all serviced by the threads of the context.
+/// \tparam SensorData SensorData implementation for the specific velodyne sensor model.
+template<typename SensorData>
+class VELODYNE_NODES_PUBLIC VelodyneSensor : public VelodyneSensorBase
+{
+public:
+  using VelodyneTranslatorT = velodyne_driver::VelodyneTranslator<SensorData>;
+  using Config = typename VelodyneTranslatorT::Config;
+  using Packet = typename VelodyneTranslatorT::Packet;
+
+  /// Declare the parameters of the sensor, create its publisher and start receiving
+  /// \param node Node which gets the parameters and the publisher, must outlive the sensor
+  /// \param io_cxt I/O context that services the socket of the sensor, must outlive the sensor
+  /// \param prefix Prefix of the parameter names, e.g. "front." or "" for the parameters of a
+  /// node with a single sensor
+  /// \throw std::runtime_error If the cloud size is not larger than a point block
+  VelodyneSensor(rclcpp::Node & node, const IoContext & io_cxt, const std::string & prefix);
+
+  /// Handle data packet from the udp driver
+  /// \param buffer Data from the udp driver
+  void receiver_callback(const std::vector<uint8_t> & buffer);
+
+protected:
+  void init_output(sensor_msgs::msg::PointCloud2 & output);
+  /// Convert a packet and add its points to the current cloud.
+  /// \return True if the cloud is complete and must be published.
+  bool8_t convert(
+    const Packet & pkt,
+    sensor_msgs::msg::PointCloud2 & output);
+  /// Start a new cloud from the points of the last converted packet that follow the published
+  /// cloud. Must be called after each publication until it returns false.
+  /// \return True if the new cloud is complete too and must be published.
+  bool8_t get_output_remainder(sensor_msgs::msg::PointCloud2 & output);
+
+private:
+  void init_udp_driver();
+  /// Declare the optional parameters of the filters applied to the points while they are
+  /// decoded. By default, all points are kept.
+  /// \return The point filter of the translator
+  velodyne_driver::PointFilter declare_filter_parameters();
+  /// Publish the current cloud. With intra-process communication the cloud is moved into the
+  /// message and a new one is allocated for the next sweep.
+  void publish_cloud();
+  /// Add the points of the converted block in [begin_idx, end_idx) to the current cloud and
+  /// advance the point index.
+  /// \return Number of points added, fewer than requested if the cloud is full.
+  uint32_t add_points(
+    sensor_msgs::msg::PointCloud2 & output, const uint32_t begin_idx, const uint32_t end_idx);
+  /// Add the points of the converted block from begin_idx up to the next end of scan.
+  /// \return True if the cloud is complete, the remaining points are kept for the next cloud.
+  bool8_t add_scan_points(sensor_msgs::msg::PointCloud2 & output, const uint32_t begin_idx);
+
+  rclcpp::Node & m_node;
+  const std::string m_prefix;
+  ::drivers::udp_driver::UdpDriver m_udp_driver;
+  VelodyneTranslatorT m_translator;
+  std::vector<autoware::common::types::PointXYZIF> m_point_block;
+
+  std::string m_ip;
+  uint16_t m_port;
+  rclcpp::Publisher<sensor_msgs::msg::PointCloud2>::SharedPtr m_pc2_pub_ptr;
+  sensor_msgs::msg::PointCloud2 m_pc2_msg{};
+  bool m_published_cloud = false;
+  // Keeps track of where you left off on the converted point block in case you needed to publish
+  // a point cloud in the middle of processing it
+  uint32_t m_remainder_start_idx;
+  // keeps track of the constructed point cloud to continue growing it with new data
+  uint32_t m_point_cloud_idx;
+  const std::string m_frame_id;
+  const std::size_t m_cloud_size;
+  const bool8_t m_use_intra_process;
+  // If true, the cloud has the layout of PointXYZIF, including the id of the firing sequence of
+  // each point, e.g. for the structured mode of the ray ground classifier
+  const bool8_t m_include_id_field;
+  /// The stage of the sensor in the latency traces of the clouds
+  const autoware::common::latency_tracing::StageId m_trace_stage;
+  /// When the current packet started being processed, the begin of the span of a cloud
+  uint64_t m_packet_begin_ns{0U};
+};  // class VelodyneSensor
+
+using VLP16Sensor = VelodyneSensor<velodyne_driver::VLP16Data>;
+using VLP32CSensor = VelodyneSensor<velodyne_driver::VLP32CData>;
+using VLS128Sensor = VelodyneSensor<velodyne_driver::VLS128Data>;
+}  // namespace velodyne_nodes
+}  // namespace drivers
+}  // namespace autoware
+
+#endif  // VELODYNE_NODES__VELODYNE_SENSOR_HPP_
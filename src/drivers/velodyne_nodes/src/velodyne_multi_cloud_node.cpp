@@ -0,0 +1,89 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#include <algorithm>
+#include <cctype>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "velodyne_nodes/velodyne_multi_cloud_node.hpp"
+
+namespace autoware
+{
+namespace drivers
+{
+namespace velodyne_nodes
+{
+namespace
+{
+/// The number of threads of the I/O context of the node
+std::size_t declare_io_threads(rclcpp::Node & node)
+{
+  const auto io_threads = node.declare_parameter("io_threads", 1);
+  if (io_threads < 1) {
+    throw std::runtime_error("VelodyneMultiCloudNode: io_threads must be positive");
+  }
+  return static_cast<std::size_t>(io_threads);
+}
+}  // namespace
+
+VelodyneMultiCloudNode::VelodyneMultiCloudNode(
+  const std::string & node_name,
+  const rclcpp::NodeOptions & options)
+: rclcpp::Node(node_name, options),
+  m_io_cxt(declare_io_threads(*this))
+{
+  const auto names = declare_parameter("sensors").get<std::vector<std::string>>();
+  if (names.empty()) {
+    throw std::runtime_error("VelodyneMultiCloudNode: sensors must not be empty");
+  }
+  for (const auto & name : names) {
+    m_sensors.push_back(create_sensor(name));
+  }
+}
+
+VelodyneMultiCloudNode::VelodyneMultiCloudNode(const rclcpp::NodeOptions & options)
+: VelodyneMultiCloudNode("velodyne_multi_cloud_node", options)
+{
+}
+
+std::unique_ptr<VelodyneSensorBase> VelodyneMultiCloudNode::create_sensor(
+  const std::string & name)
+{
+  const auto prefix = name + ".";
+  auto model = declare_parameter(prefix + "model").get<std::string>();
+  std::transform(
+    model.begin(), model.end(), model.begin(), [](const char c) {
+      return static_cast<char>(std::tolower(c));
+    });
+  if (model == "vlp16") {
+    return std::make_unique<VLP16Sensor>(*this, m_io_cxt, prefix);
+  } else if (model == "vlp32c") {
+    return std::make_unique<VLP32CSensor>(*this, m_io_cxt, prefix);
+  } else if (model == "vls128") {
+    return std::make_unique<VLS128Sensor>(*this, m_io_cxt, prefix);
+  }
+  throw std::runtime_error(
+          "VelodyneMultiCloudNode: model " + model + " of sensor " + name + " is not supported");
+}
+}  // namespace velodyne_nodes
+}  // namespace drivers
+}  // namespace autoware
+
+#include "rclcpp_components/register_node_macro.hpp"  // NOLINT
+RCLCPP_COMPONENTS_REGISTER_NODE(autoware::drivers::velodyne_nodes::VelodyneMultiCloudNode)
@@ -0,0 +1,262 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#include <algorithm>
+#include <string>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+#include "common/types.hpp"
+#include "lidar_utils/point_cloud_utils.hpp"
+#include "velodyne_nodes/velodyne_sensor.hpp"
+
+using autoware::common::types::bool8_t;
+using autoware::common::types::float32_t;
+using autoware::common::types::float64_t;
+
+namespace autoware
+{
+namespace drivers
+{
+namespace velodyne_nodes
+{
+
+namespace
+{
+/// The name of the stage of a sensor in the latency traces, the node name for a single sensor
+std::string get_stage_name(const rclcpp::Node & node, const std::string & prefix)
+{
+  const std::string node_name = node.get_fully_qualified_name();
+  return prefix.empty() ? node_name : (node_name + "/" + prefix.substr(0U, prefix.size() - 1U));
+}
+}  // namespace
+
+template<typename T>
+VelodyneSensor<T>::VelodyneSensor(
+  rclcpp::Node & node,
+  const IoContext & io_cxt,
+  const std::string & prefix)
+: m_node(node),
+  m_prefix(prefix),
+  m_udp_driver(io_cxt),
+  m_translator(Config{
+      static_cast<float32_t>(node.declare_parameter(prefix + "rpm").template get<int>()),
+      static_cast<float32_t>(node.declare_parameter(prefix + "sector_size_deg", 0.0)),
+      declare_filter_parameters()}),
+  m_ip(node.declare_parameter(prefix + "ip").template get<std::string>().c_str()),
+  m_port(static_cast<uint16_t>(node.declare_parameter(prefix + "port").template get<uint16_t>())),
+  m_pc2_pub_ptr(node.create_publisher<sensor_msgs::msg::PointCloud2>(
+      node.declare_parameter(prefix + "topic").template
+      get<std::string>(), rclcpp::QoS{10})),
+  m_remainder_start_idx(0U),
+  m_point_cloud_idx(0),
+  m_frame_id(node.declare_parameter(prefix + "frame_id").template get<std::string>().c_str()),
+  m_cloud_size(static_cast<std::size_t>(
+      node.declare_parameter(prefix + "cloud_size").template get<std::size_t>())),
+  m_use_intra_process(node.get_node_options().use_intra_process_comms()),
+  m_include_id_field(node.declare_parameter(prefix + "include_id_field", false)),
+  m_trace_stage(autoware::common::latency_tracing::Tracer::instance().register_stage(
+      get_stage_name(node, prefix)))
+{
+  m_point_block.reserve(VelodyneTranslatorT::POINT_BLOCK_CAPACITY);
+  // If your preallocated cloud size is too small, the node really won't operate well at all
+  if (static_cast<uint32_t>(m_point_block.capacity()) >= m_cloud_size) {
+    throw std::runtime_error("VelodyneSensor: cloud_size must be > PointBlock::CAPACITY");
+  }
+
+  init_udp_driver();
+  init_output(m_pc2_msg);
+}
+
+template<typename T>
+velodyne_driver::PointFilter VelodyneSensor<T>::declare_filter_parameters()
+{
+  constexpr float64_t TAU = 6.283185307179586476925286766559;
+  const auto declare = [this](const std::string & name, const float64_t default_value) {
+      return static_cast<float32_t>(m_node.declare_parameter(m_prefix + name, default_value));
+    };
+  velodyne_driver::PointFilter filter;
+  filter.set_range(
+    declare("filter.min_radius_m", 0.0),
+    declare("filter.max_radius_m", static_cast<float64_t>(std::numeric_limits<float32_t>::max())));
+  // The arc is only set if it is smaller than a revolution, by default it is a full one
+  const auto start_angle_rad = m_node.declare_parameter(m_prefix + "filter.start_angle_rad", 0.0);
+  const auto end_angle_rad = m_node.declare_parameter(m_prefix + "filter.end_angle_rad", TAU);
+  if ((end_angle_rad - start_angle_rad) < TAU) {
+    filter.set_angle_window(
+      static_cast<float32_t>(start_angle_rad), static_cast<float32_t>(end_angle_rad));
+  }
+  if (m_node.declare_parameter(m_prefix + "filter.crop_box.enabled", false)) {
+    geometry_msgs::msg::Point32 min_pt;
+    min_pt.x = declare("filter.crop_box.min_x", 0.0);
+    min_pt.y = declare("filter.crop_box.min_y", 0.0);
+    min_pt.z = declare("filter.crop_box.min_z", 0.0);
+    geometry_msgs::msg::Point32 max_pt;
+    max_pt.x = declare("filter.crop_box.max_x", 0.0);
+    max_pt.y = declare("filter.crop_box.max_y", 0.0);
+    max_pt.z = declare("filter.crop_box.max_z", 0.0);
+    filter.set_crop_box(min_pt, max_pt);
+  }
+  return filter;
+}
+
+template<typename T>
+void VelodyneSensor<T>::init_udp_driver()
+{
+  m_udp_driver.init_receiver(m_ip, m_port);
+  m_udp_driver.receiver()->open();
+  m_udp_driver.receiver()->bind();
+  m_udp_driver.receiver()->asyncReceive(
+    std::bind(&VelodyneSensor<T>::receiver_callback, this, std::placeholders::_1));
+}
+
+template<typename T>
+void VelodyneSensor<T>::receiver_callback(const std::vector<uint8_t> & buffer)
+{
+  m_packet_begin_ns = autoware::common::latency_tracing::Tracer::now_ns();
+  Packet pkt{};
+  // A truncated packet leaves the remaining blocks zeroed, which have an invalid flag
+  std::memcpy(&pkt, buffer.data(), std::min(buffer.size(), sizeof(Packet)));
+  try {
+    // message received, convert and publish
+    if (this->convert(pkt, m_pc2_msg)) {
+      publish_cloud();
+      while (this->get_output_remainder(m_pc2_msg)) {
+        publish_cloud();
+      }
+    }
+  } catch (const std::exception & e) {
+    RCLCPP_WARN(m_node.get_logger(), e.what());
+    // And then just continue running
+  } catch (...) {
+    // Something really weird happened and I can't handle it here
+    RCLCPP_WARN(m_node.get_logger(), "Unknown exception occured in VelodyneSensor");
+    throw;
+  }
+}
+////////////////////////////////////////////////////////////////////////////////
+template<typename T>
+void VelodyneSensor<T>::publish_cloud()
+{
+  // The stamp of the cloud starts its latency trace, the span covers the packet that completed it
+  const auto trace_id = autoware::common::latency_tracing::to_trace_id(m_pc2_msg.header.stamp);
+  if (m_use_intra_process) {
+    m_pc2_pub_ptr->publish(
+      autoware::common::lidar_utils::release_pcl_msg(m_pc2_msg, m_cloud_size));
+  } else {
+    m_pc2_pub_ptr->publish(m_pc2_msg);
+  }
+  auto & tracer = autoware::common::latency_tracing::Tracer::instance();
+  tracer.span(m_trace_stage, trace_id, m_packet_begin_ns, tracer.now_ns());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+template<typename T>
+void VelodyneSensor<T>::init_output(sensor_msgs::msg::PointCloud2 & output)
+{
+  if (m_include_id_field) {
+    autoware::common::lidar_utils::init_pcl_msg_with_id(output, m_frame_id.c_str(), m_cloud_size);
+  } else {
+    autoware::common::lidar_utils::init_pcl_msg(output, m_frame_id.c_str(), m_cloud_size);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+template<typename T>
+uint32_t VelodyneSensor<T>::add_points(
+  sensor_msgs::msg::PointCloud2 & output,
+  const uint32_t begin_idx,
+  const uint32_t end_idx)
+{
+  if (begin_idx >= end_idx) {
+    return 0U;
+  }
+  // Both layouts of the cloud start like the point, so the points are copied without iterators
+  return static_cast<uint32_t>(autoware::common::lidar_utils::add_points_to_cloud_raw(
+           output, &m_point_block[begin_idx], end_idx - begin_idx, m_point_cloud_idx));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+template<typename T>
+bool8_t VelodyneSensor<T>::add_scan_points(
+  sensor_msgs::msg::PointCloud2 & output,
+  const uint32_t begin_idx)
+{
+  // The points up to the next end of scan, if any, go into the current cloud
+  const auto begin_it = std::next(m_point_block.cbegin(), static_cast<std::ptrdiff_t>(begin_idx));
+  const auto end_of_scan_it = std::find_if(
+    begin_it, m_point_block.cend(), [](const PointXYZIF & pt) {
+      return static_cast<uint16_t>(PointXYZIF::END_OF_SCAN_ID) == pt.id;
+    });
+  const auto end_idx =
+    static_cast<uint32_t>(std::distance(m_point_block.cbegin(), end_of_scan_it));
+  const uint32_t num_added = add_points(output, begin_idx, end_idx);
+  if ((begin_idx + num_added) < end_idx) {
+    // The cloud is full, the rest of the block goes into the next cloud
+    m_published_cloud = true;
+    m_remainder_start_idx = begin_idx + num_added;
+  } else if (end_of_scan_it != m_point_block.cend()) {
+    // The points after the end of scan go into the next cloud
+    m_published_cloud = true;
+    m_remainder_start_idx = end_idx + 1U;
+  }
+  if (m_published_cloud) {
+    // resize pointcloud down to its actual size, the stamp is the time the scan or sector ended
+    autoware::common::lidar_utils::resize_pcl_msg(output, m_point_cloud_idx);
+    output.header.stamp = m_node.now();
+  }
+  return m_published_cloud;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+template<typename T>
+bool8_t VelodyneSensor<T>::convert(
+  const Packet & pkt,
+  sensor_msgs::msg::PointCloud2 & output)
+{
+  // The remainder of the previous block is normally consumed by get_output_remainder() right
+  // after publishing. If the publication failed, the clouds it completes are dropped.
+  while (get_output_remainder(output)) {
+  }
+  m_translator.convert(pkt, m_point_block);
+  return add_scan_points(output, 0U);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+template<typename T>
+bool8_t VelodyneSensor<T>::get_output_remainder(sensor_msgs::msg::PointCloud2 & output)
+{
+  if (!m_published_cloud) {
+    return false;
+  }
+  // reset the pointcloud and deserialize the remainder of the block into it. The remainder always
+  // fits: in the constructor I ensure that cloud_size > PointBlock::CAPACITY. It can hold more
+  // ends of scan, e.g. with small sectors, so this is called until it returns false.
+  autoware::common::lidar_utils::reset_pcl_msg(output, m_cloud_size, m_point_cloud_idx);
+  m_published_cloud = false;
+  return add_scan_points(output, m_remainder_start_idx);
+}
+
+template class VelodyneSensor<velodyne_driver::VLP16Data>;
+template class VelodyneSensor<velodyne_driver::VLP32CData>;
+template class VelodyneSensor<velodyne_driver::VLS128Data>;
+}  // namespace velodyne_nodes
+}  // namespace drivers
+}  // namespace autoware
@@ -17,6 +17,7 @@
 #include <common/types.hpp>
 #include <gtest/gtest.h>
 #include <velodyne_nodes/velodyne_cloud_node.hpp>
+#include <velodyne_nodes/velodyne_multi_cloud_node.hpp>
 #include <lidar_integration/lidar_integration.hpp>
 #include <lidar_integration/udp_sender.hpp>
 #include <memory>
@@ -62,6 +63,47 @@ TEST(velodyne_node, constructor)
   rclcpp::shutdown();
 }
 
+// The sensors of the multi cloud node are configured by prefixed parameters
+TEST(velodyne_multi_cloud_node, constructor)
+{
+  rclcpp::init(0, nullptr);
+
+  const auto name = "test_multi_node";
+  const auto make_params = [](const std::string & rear_model) {
+      std::vector<rclcpp::Parameter> params;
+      params.emplace_back("sensors", std::vector<std::string>{"front", "rear"});
+      for (const auto & sensor : {std::string{"front"}, std::string{"rear"}}) {
+        params.emplace_back(sensor + ".model", (sensor == "rear") ? rear_model : "vlp16");
+        params.emplace_back(sensor + ".ip", "127.0.0.1");
+        params.emplace_back(sensor + ".port", (sensor == "rear") ? 9998 : 9999);
+        params.emplace_back(sensor + ".frame_id", sensor);
+        params.emplace_back(sensor + ".cloud_size", 10000);
+        params.emplace_back(sensor + ".rpm", 600);
+        params.emplace_back(sensor + ".topic", sensor + "/points_xyzi");
+      }
+      return params;
+    };
+  using autoware::drivers::velodyne_nodes::VelodyneMultiCloudNode;
+  rclcpp::NodeOptions options = rclcpp::NodeOptions();
+  options.parameter_overrides(make_params("VLP32C"));
+  EXPECT_NO_THROW(VelodyneMultiCloudNode(name, options));
+
+  options.parameter_overrides(make_params("hdl64"));
+  EXPECT_THROW(VelodyneMultiCloudNode(name, options), std::runtime_error);
+
+  auto params = make_params("vlp16");
+  params.emplace_back("io_threads", 0);
+  options.parameter_overrides(params);
+  EXPECT_THROW(VelodyneMultiCloudNode(name, options), std::runtime_error);
+
+  params = make_params("vlp16");
+  params.front() = rclcpp::Parameter("sensors", std::vector<std::string>{});
+  options.parameter_overrides(params);
+  EXPECT_THROW(VelodyneMultiCloudNode(name, options), std::runtime_error);
+
+  rclcpp::shutdown();
+}
+
 struct VelodyneNodeTestParam
 {
   uint32_t reserved_size;
@@ -22,10 +22,14 @@
 #include <common/types.hpp>
 #include <xsens_driver/xsens_common.hpp>
 #include <xsens_driver/visibility_control.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <cstdint>
-#include <mutex>
+#include <cstring>
 #include <numeric>
-#include <vector>
+#include <stdexcept>
+#include <type_traits>
 
 #include "helper_functions/crtp.hpp"
 
@@ -51,26 +55,38 @@ public:
   };
 
 protected:
-  enum class State
+  /// First byte of every frame
+  static constexpr uint8_t kPreamble = 0xFA;
+  /// Second byte of every frame
+  static constexpr uint8_t kBusIdentifier = 0xFF;
+  /// Preamble, bus identifier, message identifier and length
+  static constexpr std::size_t kHeaderSize = 4U;
+  /// Header, up to 255 data bytes and the checksum
+  static constexpr std::size_t kMaxFrameSize = kHeaderSize + 255U + 1U;
+  /// Data identifier (2 bytes) and size (1 byte) of a MTData2 field
+  static constexpr std::size_t kFieldHeaderSize = 3U;
+
+  enum class FrameStatus
   {
-    START,
-    PREAMBLE_READ,
-    BID_READ,
-    MID_READ,
-    LENGTH_READ,
+    INCOMPLETE,
+    INVALID,
+    COMPLETE,
   };
 
-  std::vector<uint8_t> raw_message_;
+  /// The start of a frame that was cut off at the end of the last block
+  std::array<uint8_t, kMaxFrameSize> partial_frame_;
 
-  State current_state_;
+  std::size_t partial_frame_size_;
 
-  MID current_mid_;
+  /// When the block with the preamble of the partial frame was read
+  std::chrono::steady_clock::time_point partial_frame_time_;
 
-  std::size_t current_length_;
+  /// When the block with the preamble of the last complete frame was read
+  std::chrono::steady_clock::time_point frame_time_;
 
 public:
   XsensBaseTranslator()
-  : current_state_(State::START) {}
+  : partial_frame_size_(0U) {}
 
   bool8_t use_double_precision(int32_t data_id)
   {
@@ -83,7 +99,8 @@ public:
     }
   }
 
-  /// \brief Convert Xsens frames into ROS messages.
+  /// \brief Convert Xsens frames into ROS messages, one byte at a time. Prefer converting
+  ///        everything that was read at once, see the overload for blocks of bytes.
   ///        An Xsens frame is composed of the following bytes:
   ///        - A preamble (byte value 0xFA)
   ///        - Bus Identifier (or BID, byte value 0xFF)
@@ -93,95 +110,170 @@ public:
   ///        - Checksum (1 byte)
   bool8_t convert(const Packet & pkt, MessageT & output)
   {
-    switch (current_state_) {
-      case State::START:
-        if (pkt.data == 0xFA) {
-          current_state_ = State::PREAMBLE_READ;
-        } else {
-          current_state_ = State::START;
-        }
-        return false;
-      case State::PREAMBLE_READ:
-        if (pkt.data == 0xFF) {
-          current_state_ = State::BID_READ;
-        } else {
-          current_state_ = State::START;
+    bool8_t has_output = false;
+    (void)convert(&pkt.data, 1U, output, has_output, std::chrono::steady_clock::now());
+    return has_output;
+  }
+
+  /// \brief Convert a block of bytes read from the serial port into ROS messages. The block is
+  ///        searched for preambles with memchr and frames that are completely inside the block
+  ///        are parsed in place. Only a frame that is cut off at the end of the block is copied,
+  ///        to be completed by the next block. Conversion stops after each complete frame, so
+  ///        that the output can be used before converting the rest of the block.
+  /// \param[in] data The bytes that were read
+  /// \param[in] size The number of bytes that were read
+  /// \param[out] output The message to fill with the next complete frame
+  /// \param[out] has_output True if a frame was completed and parsed into output
+  /// \param[in] receive_time When the bytes were read, see frame_time()
+  /// \return The number of bytes consumed, which is less than size only if has_output is true
+  /// \throw std::runtime_error If a valid frame contains unsupported data, the rest of the block
+  ///        is dropped in this case
+  std::size_t convert(
+    const uint8_t * data, const std::size_t size, MessageT & output, bool8_t & has_output,
+    const std::chrono::steady_clock::time_point receive_time)
+  {
+    has_output = false;
+    std::size_t consumed = 0U;
+    std::size_t frame_size = 0U;
+    while (consumed < size) {
+      if (0U != partial_frame_size_) {
+        // Only copy as many bytes as needed to check the frame, the rest is parsed in place
+        (void)check_frame(partial_frame_.data(), partial_frame_size_, frame_size);
+        const auto count = std::min(frame_size - partial_frame_size_, size - consumed);
+        std::memcpy(&partial_frame_[partial_frame_size_], data + consumed, count);
+        partial_frame_size_ += count;
+        consumed += count;
+        const auto status = check_frame(partial_frame_.data(), partial_frame_size_, frame_size);
+        if (FrameStatus::INCOMPLETE != status) {
+          partial_frame_size_ = 0U;
         }
-        return false;
-      case State::BID_READ:
-        current_mid_ = MID_from_int(pkt.data);
-        current_state_ = State::MID_READ;
-        return false;
-      case State::MID_READ:
-        current_length_ = pkt.data;
-        current_state_ = State::LENGTH_READ;
-        return false;
-      case State::LENGTH_READ:
-        if (raw_message_.size() == current_length_) {
-          std::size_t checksum = 0xFF;
-          // NOTE(esteve): workaround for uncrustify. The standard ROS 2 configuration does not
-          // understand nested < > in templates
-          using MID_underlying_type = std::underlying_type_t<decltype(current_mid_)>;
-          checksum += static_cast<MID_underlying_type>(current_mid_);
-          checksum += current_length_;
-          checksum += pkt.data;
-          std::size_t sum =
-            std::accumulate(std::begin(raw_message_), std::end(raw_message_), checksum);
-          if (0xFF & sum) {
-            // Checksum error, start over
-            current_state_ = State::START;
-            current_length_ = 0;
-            raw_message_.clear();
-            return false;
-          } else {
-            if (current_mid_ == MID::MT_DATA) {
-              // TODO(esteve): parse legacy data
-              throw std::runtime_error("Legacy data not supported yet");
-            } else if (current_mid_ == MID::MT_DATA2) {
-              parse_mtdata2(output);
-            }
-            current_state_ = State::START;
-            current_length_ = 0;
-            raw_message_.clear();
-          }
-          return true;
-        } else {
-          raw_message_.push_back(pkt.data);
-          return false;
+        if (FrameStatus::COMPLETE == status) {
+          frame_time_ = partial_frame_time_;
+          has_output = true;
+          parse_frame(partial_frame_.data(), output);
+          return consumed;
         }
-        return false;
+        continue;
+      }
+      const auto begin = data + consumed;
+      const auto preamble =
+        static_cast<const uint8_t *>(std::memchr(begin, kPreamble, size - consumed));
+      if (nullptr == preamble) {
+        return size;
+      }
+      consumed += static_cast<std::size_t>(preamble - begin);
+      switch (check_frame(preamble, size - consumed, frame_size)) {
+        case FrameStatus::COMPLETE:
+          consumed += frame_size;
+          frame_time_ = receive_time;
+          has_output = true;
+          parse_frame(preamble, output);
+          return consumed;
+        case FrameStatus::INVALID:
+          consumed += frame_size;
+          break;
+        case FrameStatus::INCOMPLETE:
+          std::memcpy(partial_frame_.data(), preamble, size - consumed);
+          partial_frame_size_ = size - consumed;
+          partial_frame_time_ = receive_time;
+          return size;
+      }
     }
-    return false;
+    return consumed;
   }
 
-  void parse_mtdata2(MessageT & output)
+  /// \brief Get when the last complete frame started to arrive, i.e. the receive time of the
+  ///        block that contained its preamble. The latency of the last output is the time
+  ///        between this and its publication.
+  std::chrono::steady_clock::time_point frame_time() const noexcept
   {
-    auto data = raw_message_;
-
-    // Read bytes from the byte vector until there are no more messages left
-    while (!data.empty()) {
-      const int32_t data_id = data[1] | data[0] << 8;
-      const int32_t message_size = data[2];
-
-      // Create a slice from the byte vector, skipping the first three bytes (data_id and
-      // message_size)
-      auto content = decltype(data)(
-        std::begin(data) + 3,
-        std::begin(data) + 3 + message_size);
+    return frame_time_;
+  }
 
-      // Overwrite data with the bytes after the slice
-      data = decltype(data)(
-        std::begin(data) + 3 + message_size,
-        std::end(data));
+  /// \brief Parse the fields of a MTData2 message
+  /// \param[in] data The data bytes of the frame, i.e. without header and checksum
+  /// \param[in] size The number of data bytes
+  /// \param[out] output The message to fill
+  /// \throw std::runtime_error If a field is cut off or of an unknown group
+  void parse_mtdata2(const uint8_t * data, const std::size_t size, MessageT & output)
+  {
+    // Read fields from the data until there are no more fields left, without copying them
+    std::size_t offset = 0U;
+    while (offset < size) {
+      if ((size - offset) < kFieldHeaderSize) {
+        throw std::runtime_error("MTData2 field header is cut off");
+      }
+      const auto field = data + offset;
+      const int32_t data_id = field[1U] | field[0U] << 8;
+      const std::size_t content_size = field[2U];
+      offset += kFieldHeaderSize;
+      if ((size - offset) < content_size) {
+        throw std::runtime_error("MTData2 field is cut off");
+      }
 
       int32_t group = data_id & 0xF800;
       XDIGroup xdigroup = XDIGroup_from_int(static_cast<uint16_t>(group));
       // Dispatch the rest of the parsing to the translator specialization via CRTP
-      this->impl().parse_xdigroup_mtdata2(xdigroup, output, data_id, content);
+      this->impl().parse_xdigroup_mtdata2(
+        xdigroup, output, data_id, FieldContent{data + offset, content_size});
+      offset += content_size;
+    }
+  }
+
+protected:
+  /// \brief Check a frame that starts with a preamble
+  /// \param[in] frame The preamble
+  /// \param[in] available The number of bytes from the preamble on
+  /// \param[out] frame_size The number of bytes needed to check the frame, which is the size of
+  ///             the frame once it is complete, or the number of bytes to skip if it is invalid
+  /// \return Whether the frame is complete and valid, invalid or needs more bytes to decide
+  FrameStatus check_frame(
+    const uint8_t * frame, const std::size_t available, std::size_t & frame_size) const noexcept
+  {
+    frame_size = 2U;
+    if (available < frame_size) {
+      return FrameStatus::INCOMPLETE;
+    }
+    if (kBusIdentifier != frame[1U]) {
+      return FrameStatus::INVALID;
+    }
+    frame_size = kHeaderSize;
+    if (available < frame_size) {
+      return FrameStatus::INCOMPLETE;
+    }
+    frame_size = kHeaderSize + frame[3U] + 1U;
+    if (available < frame_size) {
+      return FrameStatus::INCOMPLETE;
+    }
+    // All bytes after the preamble, including the checksum, add up to zero in the lowest byte
+    const auto sum = std::accumulate(frame + 1U, frame + frame_size, std::size_t{0U});
+    return (0U == (sum & 0xFFU)) ? FrameStatus::COMPLETE : FrameStatus::INVALID;
+  }
+
+  /// \brief Parse a complete and valid frame
+  void parse_frame(const uint8_t * frame, MessageT & output)
+  {
+    const auto mid = MID_from_int(frame[2U]);
+    if (mid == MID::MT_DATA) {
+      // TODO(esteve): parse legacy data
+      throw std::runtime_error("Legacy data not supported yet");
+    } else if (mid == MID::MT_DATA2) {
+      parse_mtdata2(frame + kHeaderSize, frame[3U], output);
     }
   }
 };
 
+template<typename Derived, typename MessageT>
+constexpr uint8_t XsensBaseTranslator<Derived, MessageT>::kPreamble;
+template<typename Derived, typename MessageT>
+constexpr uint8_t XsensBaseTranslator<Derived, MessageT>::kBusIdentifier;
+template<typename Derived, typename MessageT>
+constexpr std::size_t XsensBaseTranslator<Derived, MessageT>::kHeaderSize;
+template<typename Derived, typename MessageT>
+constexpr std::size_t XsensBaseTranslator<Derived, MessageT>::kMaxFrameSize;
+template<typename Derived, typename MessageT>
+constexpr std::size_t XsensBaseTranslator<Derived, MessageT>::kFieldHeaderSize;
+
 }  // namespace xsens_driver
 }  // namespace drivers
 }  // namespace autoware
@@ -20,6 +20,7 @@
 #define XSENS_DRIVER__XSENS_COMMON_HPP_
 
 #include <xsens_driver/visibility_control.hpp>
+#include <cstddef>
 #include <cstdint>
 #include <mutex>
 #include <numeric>
@@ -178,6 +179,13 @@ enum class GNSS : uint8_t
 
 XSENS_DRIVER_PUBLIC GNSS GNSS_from_int(uint8_t value);
 
+/// \brief The content of one MTData2 field, a view of the bytes inside the received frame
+struct XSENS_DRIVER_PUBLIC FieldContent
+{
+  const uint8_t * data;
+  std::size_t size;
+};
+
 }  // namespace xsens_driver
 }  // namespace drivers
 }  // namespace autoware
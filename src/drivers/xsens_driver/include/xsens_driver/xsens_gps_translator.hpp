@@ -55,12 +55,12 @@ private:
     XDIGroup xdigroup,
     sensor_msgs::msg::NavSatFix & message,
     int32_t data_id,
-    const std::vector<uint8_t> & content);
+    const FieldContent & content);
 
   void parse_gnss(
     sensor_msgs::msg::NavSatFix & message,
     int32_t data_id,
-    const std::vector<uint8_t> & content);
+    const FieldContent & content);
 };  // class Driver
 }  // namespace xsens_driver
 }  // namespace drivers
@@ -22,8 +22,10 @@
 #include <xsens_driver/visibility_control.hpp>
 #include <xsens_driver/xsens_common.hpp>
 #include <xsens_driver/xsens_base_translator.hpp>
+#include <array>
 #include <cstdint>
 #include <mutex>
+#include <stdexcept>
 #include <vector>
 #include "sensor_msgs/msg/imu.hpp"
 #include "helper_functions/byte_reader.hpp"
@@ -55,54 +57,57 @@ private:
   void parse_timestamp(
     sensor_msgs::msg::Imu & message,
     int32_t data_id,
-    const std::vector<uint8_t> & content);
+    const FieldContent & content);
 
   void parse_acceleration(
     sensor_msgs::msg::Imu & message,
     int32_t data_id,
-    const std::vector<uint8_t> & content);
+    const FieldContent & content);
 
   template<typename MessageT>
   void parse_acceleration_internal(
     sensor_msgs::msg::Imu & message,
-    const std::vector<uint8_t> & content);
+    const FieldContent & content);
 
   void parse_orientation_data(
     sensor_msgs::msg::Imu & message,
     int32_t data_id,
-    const std::vector<uint8_t> & content);
+    const FieldContent & content);
 
   void parse_angular_velocity(
     sensor_msgs::msg::Imu & message,
     int32_t data_id,
-    const std::vector<uint8_t> & content);
+    const FieldContent & content);
 
   template<typename MessageT>
   void parse_orientation_quaternion(
     sensor_msgs::msg::Imu & message,
-    const std::vector<uint8_t> & content);
+    const FieldContent & content);
 
   template<typename MessageT>
   void parse_angular_velocity_rate_of_turn(
     sensor_msgs::msg::Imu & message,
-    const std::vector<uint8_t> & content);
+    const FieldContent & content);
 
   void parse_xdigroup_mtdata2(
     XDIGroup xdigroup,
     sensor_msgs::msg::Imu & message,
     int32_t data_id,
-    const std::vector<uint8_t> & content);
+    const FieldContent & content);
 
   void parse_xdi_coordinates(
     int32_t data_id,
     sensor_msgs::msg::Imu & message);
 
   template<typename T, std::size_t kNumber_of_values>
-  std::array<T, kNumber_of_values> read_values(const std::vector<uint8_t> & content)
+  std::array<T, kNumber_of_values> read_values(const FieldContent & content)
   {
+    if (content.size < (sizeof(T) * kNumber_of_values)) {
+      throw std::runtime_error("Field is too short for its data type");
+    }
     std::array<T, kNumber_of_values> values;
 
-    common::helper_functions::ByteReader byte_reader(content);
+    common::helper_functions::ByteReader byte_reader(content.data);
 
     for (std::size_t i = 0; i < kNumber_of_values; ++i) {
       byte_reader.read(values[i]);
@@ -51,7 +51,7 @@ void XsensGpsTranslator::parse_xdigroup_mtdata2(
   XDIGroup xdigroup,
   sensor_msgs::msg::NavSatFix & message,
   int32_t data_id,
-  const std::vector<uint8_t> & content)
+  const FieldContent & content)
 {
   switch (xdigroup) {
     case XDIGroup::TEMPERATURE:
@@ -91,14 +91,19 @@ void XsensGpsTranslator::parse_xdigroup_mtdata2(
 void XsensGpsTranslator::parse_gnss(
   sensor_msgs::msg::NavSatFix & message,
   int32_t data_id,
-  const std::vector<uint8_t> & content)
+  const FieldContent & content)
 {
   const GNSS value = GNSS_from_int(static_cast<uint8_t>(data_id & 0x00F0));
 
   switch (value) {
     case GNSS::PVT_DATA:
       {
-        autoware::common::helper_functions::ByteReader byte_reader(content);
+        // Size of all the values read below
+        constexpr std::size_t kPvtDataSize = 94U;
+        if (content.size < kPvtDataSize) {
+          throw std::runtime_error("PVT data field is too short");
+        }
+        autoware::common::helper_functions::ByteReader byte_reader(content.data);
 
         uint32_t itow = 0;
         byte_reader.read(itow);
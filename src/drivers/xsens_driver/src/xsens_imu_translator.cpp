@@ -50,7 +50,7 @@ void XsensImuTranslator::parse_xdigroup_mtdata2(
   XDIGroup xdigroup,
   sensor_msgs::msg::Imu & message,
   int32_t data_id,
-  const std::vector<uint8_t> & content)
+  const FieldContent & content)
 {
   switch (xdigroup) {
     case XDIGroup::TEMPERATURE:
@@ -93,7 +93,7 @@ void XsensImuTranslator::parse_xdigroup_mtdata2(
 void XsensImuTranslator::parse_timestamp(
   sensor_msgs::msg::Imu & message,
   int32_t data_id,
-  const std::vector<uint8_t> & content)
+  const FieldContent & content)
 {
   (void)message;
   (void)data_id;
@@ -103,7 +103,7 @@ void XsensImuTranslator::parse_timestamp(
 void XsensImuTranslator::parse_acceleration(
   sensor_msgs::msg::Imu & message,
   int32_t data_id,
-  const std::vector<uint8_t> & content)
+  const FieldContent & content)
 {
   parse_xdi_coordinates(data_id, message);
 
@@ -117,7 +117,7 @@ void XsensImuTranslator::parse_acceleration(
 template<typename MessageT>
 void XsensImuTranslator::parse_acceleration_internal(
   sensor_msgs::msg::Imu & message,
-  const std::vector<uint8_t> & content)
+  const FieldContent & content)
 {
   std::array<MessageT, 3> values = read_values<MessageT, 3>(content);
 
@@ -129,7 +129,7 @@ void XsensImuTranslator::parse_acceleration_internal(
 void XsensImuTranslator::parse_orientation_data(
   sensor_msgs::msg::Imu & message,
   int32_t data_id,
-  const std::vector<uint8_t> & content)
+  const FieldContent & content)
 {
   parse_xdi_coordinates(data_id, message);
 
@@ -158,7 +158,7 @@ void XsensImuTranslator::parse_orientation_data(
 void XsensImuTranslator::parse_angular_velocity(
   sensor_msgs::msg::Imu & message,
   int32_t data_id,
-  const std::vector<uint8_t> & content)
+  const FieldContent & content)
 {
   parse_xdi_coordinates(data_id, message);
 
@@ -190,7 +190,7 @@ void XsensImuTranslator::parse_angular_velocity(
 template<typename MessageT>
 void XsensImuTranslator::parse_orientation_quaternion(
   sensor_msgs::msg::Imu & message,
-  const std::vector<uint8_t> & content)
+  const FieldContent & content)
 {
   std::array<MessageT, 4> values = read_values<MessageT, 4>(content);
 
@@ -203,7 +203,7 @@ void XsensImuTranslator::parse_orientation_quaternion(
 template<typename MessageT>
 void XsensImuTranslator::parse_angular_velocity_rate_of_turn(
   sensor_msgs::msg::Imu & message,
-  const std::vector<uint8_t> & content)
+  const FieldContent & content)
 {
   std::array<MessageT, 3> values = read_values<MessageT, 3>(content);
 
@@ -19,6 +19,8 @@
 #ifndef XSENS_DRIVER__TEST_XSENS_COMMON_HPP_
 #define XSENS_DRIVER__TEST_XSENS_COMMON_HPP_
 
+#include <algorithm>
+#include <chrono>
 #include <vector>
 #include "gtest/gtest.h"
 
@@ -57,6 +59,78 @@ protected:
     pkt.data = data[length];
     ASSERT_TRUE(driver.convert(pkt, out));
   }
+
+  /// Convert a stream of bytes in blocks of the given size and collect all outputs
+  std::vector<MessageT> convert_blocks(const std::vector<uint8_t> & stream, std::size_t block_size)
+  {
+    const typename TranslatorT::Config cfg{};
+    TranslatorT driver(cfg);
+    std::vector<MessageT> outputs;
+    for (std::size_t begin = 0U; begin < stream.size(); begin += block_size) {
+      const auto size = std::min(block_size, stream.size() - begin);
+      std::size_t consumed = 0U;
+      while (consumed < size) {
+        MessageT output;
+        bool8_t has_output = false;
+        consumed += driver.convert(
+          &stream[begin + consumed], size - consumed, output, has_output,
+          std::chrono::steady_clock::now());
+        if (has_output) {
+          outputs.push_back(output);
+        }
+      }
+    }
+    return outputs;
+  }
+
+  /// Check that converting blocks gives the same messages as converting single bytes, however
+  /// the stream is split
+  void xsens_driver_block_test(const std::vector<uint8_t> & data)
+  {
+    std::vector<uint8_t> frame = {
+      0xFA, 0xFF, static_cast<MID_underlying_type>(MID::MT_DATA2),
+      static_cast<uint8_t>(data.size() - 1)
+    };
+    frame.insert(frame.end(), data.begin(), data.end());
+    auto corrupted = frame;
+    corrupted.back() = static_cast<uint8_t>(corrupted.back() ^ 0x01);
+
+    // Noise, a preamble with a wrong bus identifier, a frame, a frame with a wrong checksum and
+    // another frame
+    std::vector<uint8_t> stream = {0x00, 0x12, 0xFA, 0x00, 0x34};
+    stream.insert(stream.end(), frame.begin(), frame.end());
+    stream.insert(stream.end(), corrupted.begin(), corrupted.end());
+    stream.insert(stream.end(), frame.begin(), frame.end());
+
+    const typename TranslatorT::Config cfg{};
+    TranslatorT driver(cfg);
+    std::vector<MessageT> expected;
+    for (const auto byte : stream) {
+      pkt.data = byte;
+      MessageT output;
+      if (driver.convert(pkt, output)) {
+        expected.push_back(output);
+      }
+    }
+    ASSERT_EQ(expected.size(), 2U);
+
+    for (std::size_t block_size = 1U; block_size <= stream.size(); ++block_size) {
+      EXPECT_EQ(convert_blocks(stream, block_size), expected) << "block size " << block_size;
+    }
+
+    // The frame time is the receive time of the block with the preamble
+    const std::chrono::steady_clock::time_point first{std::chrono::milliseconds{1}};
+    const std::chrono::steady_clock::time_point second{std::chrono::milliseconds{2}};
+    bool8_t has_output = false;
+    const auto half = frame.size() / 2U;
+    ASSERT_EQ(driver.convert(frame.data(), half, out, has_output, first), half);
+    ASSERT_FALSE(has_output);
+    ASSERT_EQ(driver.convert(&frame[half], frame.size() - half, out, has_output, second),
+      frame.size() - half);
+    ASSERT_TRUE(has_output);
+    EXPECT_EQ(driver.frame_time(), first);
+    EXPECT_EQ(out, expected.front());
+  }
 };  // class xsens_driver_common
 
 #endif  // XSENS_DRIVER__TEST_XSENS_COMMON_HPP_
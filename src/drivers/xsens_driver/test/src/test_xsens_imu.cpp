@@ -29,21 +29,29 @@ using autoware::drivers::xsens_driver::XsensImuTranslator;
 
 using xsens_driver = xsens_driver_common<XsensImuTranslator, sensor_msgs::msg::Imu>;
 
+namespace
+{
+const std::vector<uint8_t> kData = {
+  0x70, 0x20, 0x78, 0x1C, 0x10, 0x5C, 0x4A, 0x1C, 0x00, 0x00, 0x00, 0x00, 0x01, 0x19, 0x5C, 0x00,
+  0x05, 0x00, 0x11, 0x00, 0x07, 0x1E, 0x5E, 0x00, 0x08, 0x0D, 0x14, 0x00, 0x0B, 0x21, 0x5F, 0x00,
+  0x0D, 0x2B, 0x5F, 0x00, 0x0F, 0x1A, 0x54, 0x00, 0x11, 0x24, 0x5F, 0x00, 0x12, 0x0B, 0x5C, 0x00,
+  0x13, 0x1C, 0x5F, 0x00, 0x1C, 0x21, 0x5F, 0x00, 0x1E, 0x24, 0x5F, 0x01, 0x83, 0x25, 0x16, 0x01,
+  0x85, 0x23, 0x16, 0x01, 0x8A, 0x1E, 0x16, 0x05, 0x01, 0x18, 0x1C, 0x05, 0x04, 0x00, 0x21, 0x05,
+  0x05, 0x00, 0x21, 0x06, 0x05, 0x1A, 0x1D, 0x06, 0x06, 0x16, 0x14, 0x06, 0x0E, 0x14, 0x1C, 0x06,
+  0x0F, 0x1E, 0x1F, 0x06, 0x10, 0x00, 0x10, 0x06, 0x11, 0x14, 0x14, 0x06, 0x12, 0x00, 0x10, 0x06,
+  0x17, 0x0A, 0x14, 0x06, 0x18, 0x16, 0x1C, 0x06, 0x1E, 0x00, 0x10, 0x10, 0x60, 0x04, 0x22, 0xD5,
+  0x58, 0x97, 0x24
+};
+}  // namespace
+
 TEST_F(xsens_driver, basic)
 {
-  std::vector<uint8_t> data = {
-    0x70, 0x20, 0x78, 0x1C, 0x10, 0x5C, 0x4A, 0x1C, 0x00, 0x00, 0x00, 0x00, 0x01, 0x19, 0x5C, 0x00,
-    0x05, 0x00, 0x11, 0x00, 0x07, 0x1E, 0x5E, 0x00, 0x08, 0x0D, 0x14, 0x00, 0x0B, 0x21, 0x5F, 0x00,
-    0x0D, 0x2B, 0x5F, 0x00, 0x0F, 0x1A, 0x54, 0x00, 0x11, 0x24, 0x5F, 0x00, 0x12, 0x0B, 0x5C, 0x00,
-    0x13, 0x1C, 0x5F, 0x00, 0x1C, 0x21, 0x5F, 0x00, 0x1E, 0x24, 0x5F, 0x01, 0x83, 0x25, 0x16, 0x01,
-    0x85, 0x23, 0x16, 0x01, 0x8A, 0x1E, 0x16, 0x05, 0x01, 0x18, 0x1C, 0x05, 0x04, 0x00, 0x21, 0x05,
-    0x05, 0x00, 0x21, 0x06, 0x05, 0x1A, 0x1D, 0x06, 0x06, 0x16, 0x14, 0x06, 0x0E, 0x14, 0x1C, 0x06,
-    0x0F, 0x1E, 0x1F, 0x06, 0x10, 0x00, 0x10, 0x06, 0x11, 0x14, 0x14, 0x06, 0x12, 0x00, 0x10, 0x06,
-    0x17, 0x0A, 0x14, 0x06, 0x18, 0x16, 0x1C, 0x06, 0x1E, 0x00, 0x10, 0x10, 0x60, 0x04, 0x22, 0xD5,
-    0x58, 0x97, 0x24
-  };
-
-  xsens_driver_common_test(data);
+  xsens_driver_common_test(kData);
+}
+
+TEST_F(xsens_driver, blocks)
+{
+  xsens_driver_block_test(kData);
 }
 
 int32_t main(int32_t argc, char ** argv)
@@ -0,0 +1,193 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+/// \copyright Copyright 2021 the Autoware Foundation
+/// \file
+/// \brief Header for a linear assignment solver that splits sparse problems into independent
+///        components
+#ifndef HUNGARIAN_ASSIGNER__SPARSE_ASSIGNER_HPP_
+#define HUNGARIAN_ASSIGNER__SPARSE_ASSIGNER_HPP_
+
+#include <hungarian_assigner/hungarian_assigner.hpp>
+#include <hungarian_assigner/visibility_control.hpp>
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include "common/types.hpp"
+
+using autoware::common::types::bool8_t;
+using autoware::common::types::float32_t;
+using autoware::common::types::float64_t;
+
+namespace autoware
+{
+namespace fusion
+{
+namespace hungarian_assigner
+{
+
+/// \brief Minimum weight assignment with the same interface and total cost as
+///        hungarian_assigner_c, for problems where most weights are never set. On assign(), the
+///        rows and columns are split into the connected components of the set weights, and each
+///        component is solved on its own with the shortest augmenting path method of Jonker and
+///        Volgenant, in O(n^2 m) time for a component of n rows and m columns. The run time
+///        therefore grows with the size of the largest groups of rows that compete for the same
+///        columns, and not with the size of the whole problem. All memory is allocated on
+///        construction and in set_num_threads().
+/// \tparam Capacity maximum number of things that can be matched
+template<uint16_t Capacity>
+class HUNGARIAN_ASSIGNER_PUBLIC sparse_assigner_c
+{
+  static_assert(Capacity > 0, "Capacity must be positive");
+
+public:
+  /// \brief This index denotes a worker for which no job assignment was possible
+  static constexpr index_t UNASSIGNED = std::numeric_limits<index_t>::max();
+  /// \brief Upper bound of the weights, and the cost of leaving a row unassigned
+  static constexpr float MAX_WEIGHT = hungarian_assigner_c<Capacity>::MAX_WEIGHT;
+  /// \brief Components are only solved on multiple threads if the sum of n^2 m over all
+  ///        components is at least this, below that, starting the threads costs more than it saves
+  static constexpr std::size_t MIN_PARALLEL_WORK = 1U << 18U;
+
+  /// \brief constructor
+  sparse_assigner_c();
+
+  /// \brief constructor, equivalent of construct(); set_size(num_rows, num_cols)
+  /// \param[in] num_rows number of rows/jobs
+  /// \param[in] num_cols number of columns/workers
+  sparse_assigner_c(const index_t num_rows, const index_t num_cols);
+
+  /// \brief set the number of threads that solve components in assign(), including the calling
+  ///        thread. Allocates scratch space, so this should be done before operation
+  /// \param[in] num_threads the number of threads, defaults to 1
+  /// \throw std::domain_error if num_threads is 0
+  void set_num_threads(const std::size_t num_threads);
+
+  /// \brief set the size of the matrix. Must be less than capacity. This should be done before
+  ///        set_weight() calls
+  /// \param[in] num_rows number of rows/jobs
+  /// \param[in] num_cols number of columns/workers
+  /// \throw std::length_error if num_rows or num_cols is bigger than capacity
+  /// \throw std::domain_error if matrix shape is skinny
+  void set_size(const index_t num_rows, const index_t num_cols);
+
+  /// \brief set weight. Weights that are not set are impossible assignments. This function can
+  ///        be called concurrently if a thread has fixed ownership over a given idx
+  /// \param[in] weight the weight for assignment of job idx to worker jdx
+  /// \param[in] idx the index of the job
+  /// \param[in] jdx the index of the worker
+  /// \throw std::out_of_range if idx or jdx are outside of range specified by set_size(), or
+  ///                          if the weight is not smaller than MAX_WEIGHT
+  void set_weight(const float32_t weight, const index_t idx, const index_t jdx);
+
+  /// \brief reset weights and size, must be called after assign(), and before set_weight()
+  void reset();
+
+  /// \brief reset and set_size, equivalent to reset(); set_size(num_rows, num_cols);
+  /// \param[in] num_rows number of rows/jobs
+  /// \param[in] num_cols number of columns/workers
+  void reset(const index_t num_rows, const index_t num_cols);
+
+  /// \brief compute minimum cost assignment. As with hungarian_assigner_c, leaving a row without
+  ///        an assignment costs MAX_WEIGHT, so as many rows as possible are assigned
+  /// \return true, the assignment is always found. Rows that have no assignment in the optimum
+  ///         get UNASSIGNED from get_assignment()
+  bool8_t assign();
+
+  /// \brief dictate what the assignment for a given row/task is, should be called after assign()
+  /// \param[in] idx the index for the task, starting at 0
+  /// \return the index for the assigned job, starting at 0, or UNASSIGNED if the row has no
+  ///         assignment
+  /// \throw std::range_error if idx is out of bounds
+  index_t get_assignment(const index_t idx) const;
+
+  /// \brief says what columns have been unassigned, in ascending order
+  /// \param[in] idx the i'th unassigned column, starts from 0 to num_cols - num_rows
+  /// \return the index of the i'th unassigned column
+  /// \throw std::range_error if idx is out of bounds (i.e. there are no unassigned columns)
+  index_t get_unassigned(const index_t idx) const;
+
+private:
+  /// \brief Scratch space of one thread for solving a component
+  struct HUNGARIAN_ASSIGNER_LOCAL Workspace
+  {
+    /// \brief Allocate space for a component with Capacity rows and columns
+    Workspace();
+    // Dual value of each row, indexed from 1
+    std::vector<float64_t> row_potential;
+    // Dual value of each column (including one dummy column per row), indexed from 1
+    std::vector<float64_t> col_potential;
+    // Shortest path distance to each column in the current augmentation
+    std::vector<float64_t> min_slack;
+    // Row assigned to each column, 0 if none
+    std::vector<index_t> col_row;
+    // Previous column on the shortest path to each column
+    std::vector<index_t> path;
+    std::vector<bool8_t> visited;
+    // Whether each row is assigned, indexed from 1
+    std::vector<bool8_t> is_row_assigned;
+  };
+
+  /// \brief Find the connected components of the set weights, sorted by decreasing work
+  /// \return The summed work estimate n^2 m of the components
+  HUNGARIAN_ASSIGNER_LOCAL std::size_t find_components();
+  /// \brief Solve the share of the components of a thread
+  HUNGARIAN_ASSIGNER_LOCAL void solve_components(const std::size_t thread_idx);
+  /// \brief Solve a single component and write its assignments
+  HUNGARIAN_ASSIGNER_LOCAL void solve_component(const std::size_t comp_idx, Workspace & ws);
+  /// \brief Call fn on m_num_threads threads, the calling thread gets index 0
+  HUNGARIAN_ASSIGNER_LOCAL void run(void (sparse_assigner_c::* fn)(std::size_t));
+  /// \brief Union-find root of a node, rows come first and columns after them
+  HUNGARIAN_ASSIGNER_LOCAL index_t find_root(index_t node);
+  /// \brief Weight of a pair, MAX_WEIGHT if it was not set
+  HUNGARIAN_ASSIGNER_LOCAL float32_t weight(const index_t idx, const index_t jdx) const
+  {
+    return m_weights[static_cast<std::size_t>(idx * Capacity + jdx)];
+  }
+
+  index_t m_num_rows;
+  index_t m_num_cols;
+  // Extent of the weights that may have been set since the last reset
+  index_t m_used_rows;
+  index_t m_used_cols;
+  std::size_t m_num_threads;
+  // Row major Capacity x Capacity weights
+  std::vector<float32_t> m_weights;
+  std::vector<index_t> m_assignments;
+  std::vector<index_t> m_unassigned;
+  std::vector<bool8_t> m_is_col_assigned;
+  // Union-find parents of the rows followed by the columns
+  std::vector<index_t> m_parents;
+  // Component of each union-find root
+  std::vector<index_t> m_root_components;
+  // Rows and columns of the components, grouped by component
+  std::vector<index_t> m_comp_rows;
+  std::vector<index_t> m_comp_cols;
+  // Offsets of each component into m_comp_rows and m_comp_cols
+  std::vector<index_t> m_comp_row_offsets;
+  std::vector<index_t> m_comp_col_offsets;
+  // Components with rows and columns, in the order they are solved
+  std::vector<index_t> m_comp_order;
+  std::vector<std::size_t> m_comp_work;
+  std::vector<Workspace> m_workspaces;
+  // Whether the current assign() call uses all threads
+  bool8_t m_parallel;
+};  // class sparse_assigner_c
+
+}  // namespace hungarian_assigner
+}  // namespace fusion
+}  // namespace autoware
+#endif  // HUNGARIAN_ASSIGNER__SPARSE_ASSIGNER_HPP_
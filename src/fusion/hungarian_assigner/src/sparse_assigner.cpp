@@ -0,0 +1,461 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+/// \copyright Copyright 2021 the Autoware Foundation
+/// \file
+/// \brief source file for the sparse linear assignment solver
+
+//lint -e537 cpplint complains otherwise NOLINT
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "hungarian_assigner/sparse_assigner.hpp"
+#include "common/types.hpp"
+
+using autoware::common::types::bool8_t;
+using autoware::common::types::float32_t;
+using autoware::common::types::float64_t;
+
+namespace autoware
+{
+namespace fusion
+{
+namespace hungarian_assigner
+{
+
+///
+template<uint16_t Capacity>
+constexpr index_t sparse_assigner_c<Capacity>::UNASSIGNED;
+
+template<uint16_t Capacity>
+constexpr float sparse_assigner_c<Capacity>::MAX_WEIGHT;
+
+template<uint16_t Capacity>
+constexpr std::size_t sparse_assigner_c<Capacity>::MIN_PARALLEL_WORK;
+
+///
+template<uint16_t Capacity>
+sparse_assigner_c<Capacity>::Workspace::Workspace()
+: row_potential(Capacity + 1U),
+  col_potential(2U * Capacity + 1U),
+  min_slack(2U * Capacity + 1U),
+  col_row(2U * Capacity + 1U),
+  path(2U * Capacity + 1U),
+  visited(2U * Capacity + 1U),
+  is_row_assigned(Capacity + 1U)
+{
+}
+
+///
+template<uint16_t Capacity>
+sparse_assigner_c<Capacity>::sparse_assigner_c(const index_t num_rows, const index_t num_cols)
+: m_num_rows(),
+  m_num_cols(),
+  m_used_rows(Capacity),
+  m_used_cols(Capacity),
+  m_num_threads(1U),
+  m_weights(static_cast<std::size_t>(Capacity) * Capacity),
+  m_assignments(Capacity, UNASSIGNED),
+  m_unassigned(Capacity, UNASSIGNED),
+  m_is_col_assigned(Capacity, false),
+  m_parents(2U * Capacity),
+  m_root_components(2U * Capacity),
+  m_comp_rows(Capacity),
+  m_comp_cols(Capacity),
+  m_comp_row_offsets(2U * Capacity + 1U),
+  m_comp_col_offsets(2U * Capacity + 1U),
+  m_comp_work(2U * Capacity),
+  m_workspaces(1U),
+  m_parallel(false)
+{
+  m_comp_order.reserve(2U * Capacity);
+  reset(num_rows, num_cols);
+}
+
+///
+template<uint16_t Capacity>
+sparse_assigner_c<Capacity>::sparse_assigner_c()
+: sparse_assigner_c(index_t(), index_t())  // zero initialization
+{
+}
+
+///
+template<uint16_t Capacity>
+void sparse_assigner_c<Capacity>::set_num_threads(const std::size_t num_threads)
+{
+  if (num_threads == 0U) {
+    throw std::domain_error("Sparse assigner needs at least one thread");
+  }
+  m_num_threads = num_threads;
+  m_workspaces.resize(num_threads);
+}
+
+///
+template<uint16_t Capacity>
+void sparse_assigner_c<Capacity>::set_size(const index_t num_rows, const index_t num_cols)
+{
+  if ((num_rows > Capacity) || (num_cols > Capacity)) {
+    throw std::length_error("Cannot make sparse assigner bigger than capacity");
+  }
+  if (num_rows > num_cols) {
+    throw std::domain_error("Cost matrix must be fat or square");
+  }
+  m_num_rows = num_rows;
+  m_num_cols = num_cols;
+  m_used_rows = std::max(m_used_rows, num_rows);
+  m_used_cols = std::max(m_used_cols, num_cols);
+  // initialize assignments to "unassigned"
+  std::fill(m_assignments.begin(), m_assignments.end(), UNASSIGNED);
+  std::fill(m_unassigned.begin(), m_unassigned.end(), UNASSIGNED);
+}
+
+///
+template<uint16_t Capacity>
+void sparse_assigner_c<Capacity>::set_weight(
+  const float32_t weight,
+  const index_t idx,
+  const index_t jdx)
+{
+  if ((idx < index_t()) || (jdx < index_t()) || (idx >= m_num_rows) || (jdx >= m_num_cols)) {
+    throw std::out_of_range("Cannot set weight outside of range");
+  }
+  if (weight >= MAX_WEIGHT) {
+    throw std::out_of_range("Cannot set weight greater than or equal to MAX_WEIGHT");
+  }
+  m_weights[static_cast<std::size_t>(idx * Capacity + jdx)] = weight;
+}
+
+///
+template<uint16_t Capacity>
+void sparse_assigner_c<Capacity>::reset()
+{
+  // Only the block that set_weight() could have written to needs to be cleared
+  for (index_t idx = index_t(); idx < m_used_rows; ++idx) {
+    const auto row = m_weights.begin() + idx * Capacity;
+    std::fill(row, row + m_used_cols, MAX_WEIGHT);
+  }
+  m_used_rows = index_t();
+  m_used_cols = index_t();
+  m_num_rows = index_t();
+  m_num_cols = index_t();
+  std::fill(m_assignments.begin(), m_assignments.end(), UNASSIGNED);
+  std::fill(m_unassigned.begin(), m_unassigned.end(), UNASSIGNED);
+}
+
+///
+template<uint16_t Capacity>
+void sparse_assigner_c<Capacity>::reset(const index_t num_rows, const index_t num_cols)
+{
+  reset();
+  set_size(num_rows, num_cols);
+}
+
+///
+template<uint16_t Capacity>
+bool8_t sparse_assigner_c<Capacity>::assign()
+{
+  std::fill(m_assignments.begin(), m_assignments.end(), UNASSIGNED);
+  std::fill(m_is_col_assigned.begin(), m_is_col_assigned.end(), false);
+  const std::size_t work = find_components();
+  m_parallel = (m_num_threads > 1U) && (m_comp_order.size() > 1U) && (work >= MIN_PARALLEL_WORK);
+  if (m_parallel) {
+    run(&sparse_assigner_c::solve_components);
+  } else {
+    solve_components(0U);
+  }
+  // At most num_rows columns are assigned, so there are at least num_cols - num_rows left
+  index_t num_unassigned = index_t();
+  for (index_t jdx = index_t(); jdx < m_num_cols; ++jdx) {
+    if (!m_is_col_assigned[static_cast<std::size_t>(jdx)]) {
+      m_unassigned[static_cast<std::size_t>(num_unassigned)] = jdx;
+      ++num_unassigned;
+    }
+  }
+  return true;
+}
+
+///
+template<uint16_t Capacity>
+index_t sparse_assigner_c<Capacity>::get_assignment(const index_t idx) const
+{
+  if ((idx < index_t()) || (idx >= m_num_rows)) {
+    throw std::range_error("Querying out of bounds assignment index");
+  }
+  return m_assignments[static_cast<std::size_t>(idx)];
+}
+
+///
+template<uint16_t Capacity>
+index_t sparse_assigner_c<Capacity>::get_unassigned(const index_t idx) const
+{
+  if ((idx < index_t()) || ((idx + m_num_rows) >= m_num_cols)) {
+    throw std::range_error("Querying out of bounds assignment index");
+  }
+  return m_unassigned[static_cast<std::size_t>(idx)];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// private methods
+////////////////////////////////////////////////////////////////////////////////
+template<uint16_t Capacity>
+index_t sparse_assigner_c<Capacity>::find_root(index_t node)
+{
+  // Path halving
+  while (m_parents[static_cast<std::size_t>(node)] != node) {
+    const auto parent = m_parents[static_cast<std::size_t>(node)];
+    m_parents[static_cast<std::size_t>(node)] = m_parents[static_cast<std::size_t>(parent)];
+    node = parent;
+  }
+  return node;
+}
+
+///
+template<uint16_t Capacity>
+std::size_t sparse_assigner_c<Capacity>::find_components()
+{
+  const index_t num_nodes = m_num_rows + m_num_cols;
+  for (index_t node = index_t(); node < num_nodes; ++node) {
+    m_parents[static_cast<std::size_t>(node)] = node;
+  }
+  for (index_t idx = index_t(); idx < m_num_rows; ++idx) {
+    for (index_t jdx = index_t(); jdx < m_num_cols; ++jdx) {
+      if (weight(idx, jdx) < MAX_WEIGHT) {
+        const index_t row_root = find_root(idx);
+        const index_t col_root = find_root(m_num_rows + jdx);
+        if (row_root != col_root) {
+          // The smaller index is the root, so the components are numbered by their first row
+          m_parents[static_cast<std::size_t>(std::max(row_root, col_root))] =
+            std::min(row_root, col_root);
+        }
+      }
+    }
+  }
+  // Number the components and count their rows and columns
+  index_t num_comps = index_t();
+  for (index_t node = index_t(); node < num_nodes; ++node) {
+    const auto root = static_cast<std::size_t>(find_root(node));
+    if (root == static_cast<std::size_t>(node)) {
+      m_root_components[root] = num_comps;
+      m_comp_row_offsets[static_cast<std::size_t>(num_comps) + 1U] = index_t();
+      m_comp_col_offsets[static_cast<std::size_t>(num_comps) + 1U] = index_t();
+      ++num_comps;
+    }
+    const auto comp = static_cast<std::size_t>(m_root_components[root]);
+    if (node < m_num_rows) {
+      ++m_comp_row_offsets[comp + 1U];
+    } else {
+      ++m_comp_col_offsets[comp + 1U];
+    }
+  }
+  m_comp_row_offsets[0U] = index_t();
+  m_comp_col_offsets[0U] = index_t();
+  m_comp_order.clear();
+  std::size_t total_work = 0U;
+  for (std::size_t comp = 0U; comp < static_cast<std::size_t>(num_comps); ++comp) {
+    const auto num_rows = static_cast<std::size_t>(m_comp_row_offsets[comp + 1U]);
+    const auto num_cols = static_cast<std::size_t>(m_comp_col_offsets[comp + 1U]);
+    // Rows or columns without any weight stay unassigned
+    if ((num_rows > 0U) && (num_cols > 0U)) {
+      m_comp_work[comp] = num_rows * num_rows * (num_rows + num_cols);
+      total_work += m_comp_work[comp];
+      m_comp_order.push_back(static_cast<index_t>(comp));
+    }
+    m_comp_row_offsets[comp + 1U] += m_comp_row_offsets[comp];
+    m_comp_col_offsets[comp + 1U] += m_comp_col_offsets[comp];
+  }
+  // Scatter the nodes in ascending order, this moves each offset to the start of the next
+  // component, which the shift afterwards undoes
+  for (index_t node = index_t(); node < num_nodes; ++node) {
+    const auto root = static_cast<std::size_t>(find_root(node));
+    const auto comp = static_cast<std::size_t>(m_root_components[root]);
+    if (node < m_num_rows) {
+      m_comp_rows[static_cast<std::size_t>(m_comp_row_offsets[comp]++)] = node;
+    } else {
+      m_comp_cols[static_cast<std::size_t>(m_comp_col_offsets[comp]++)] = node - m_num_rows;
+    }
+  }
+  for (auto comp = static_cast<std::size_t>(num_comps); comp > 0U; --comp) {
+    m_comp_row_offsets[comp] = m_comp_row_offsets[comp - 1U];
+    m_comp_col_offsets[comp] = m_comp_col_offsets[comp - 1U];
+  }
+  m_comp_row_offsets[0U] = index_t();
+  m_comp_col_offsets[0U] = index_t();
+  // Largest components first, so that threads finish at similar times
+  std::sort(
+    m_comp_order.begin(), m_comp_order.end(),
+    [this](const index_t lhs, const index_t rhs) {
+      const auto lhs_work = m_comp_work[static_cast<std::size_t>(lhs)];
+      const auto rhs_work = m_comp_work[static_cast<std::size_t>(rhs)];
+      return (lhs_work > rhs_work) || ((lhs_work == rhs_work) && (lhs < rhs));
+    });
+  return total_work;
+}
+
+///
+template<uint16_t Capacity>
+void sparse_assigner_c<Capacity>::solve_components(const std::size_t thread_idx)
+{
+  auto & ws = m_workspaces[thread_idx];
+  // The components are sorted by size, so dealing them out in turn balances the threads
+  const std::size_t num_threads = m_parallel ? m_num_threads : 1U;
+  for (std::size_t order_idx = thread_idx; order_idx < m_comp_order.size();
+    order_idx += num_threads)
+  {
+    solve_component(static_cast<std::size_t>(m_comp_order[order_idx]), ws);
+  }
+}
+
+///
+template<uint16_t Capacity>
+void sparse_assigner_c<Capacity>::solve_component(const std::size_t comp_idx, Workspace & ws)
+{
+  constexpr float64_t INF = std::numeric_limits<float64_t>::infinity();
+  constexpr auto DUMMY_WEIGHT = static_cast<float64_t>(MAX_WEIGHT);
+  const index_t * const rows = &m_comp_rows[static_cast<std::size_t>(m_comp_row_offsets[comp_idx])];
+  const index_t * const cols = &m_comp_cols[static_cast<std::size_t>(m_comp_col_offsets[comp_idx])];
+  const index_t num_rows = m_comp_row_offsets[comp_idx + 1U] - m_comp_row_offsets[comp_idx];
+  const index_t num_cols = m_comp_col_offsets[comp_idx + 1U] - m_comp_col_offsets[comp_idx];
+  // Each row gets a private dummy column that costs MAX_WEIGHT, which stands for leaving the row
+  // unassigned. Rows and columns are indexed from 1, column 0 is the root of the search tree
+  const index_t num_all_cols = num_cols + num_rows;
+  // Reduced cost of a pair, infinite for impossible assignments
+  const auto slack = [&](const index_t row, const index_t col) -> float64_t {
+      float64_t cost = INF;
+      if (col <= num_cols) {
+        const float32_t w = weight(rows[row - 1], cols[col - 1]);
+        if (w < MAX_WEIGHT) {
+          cost = static_cast<float64_t>(w);
+        }
+      } else if ((col - num_cols) == row) {
+        cost = DUMMY_WEIGHT;
+      }
+      return cost - ws.row_potential[static_cast<std::size_t>(row)] -
+             ws.col_potential[static_cast<std::size_t>(col)];
+    };
+  const index_t all_cols = num_all_cols + 1;
+  std::fill(ws.col_potential.begin(), ws.col_potential.begin() + all_cols, 0.0);
+  std::fill(ws.col_row.begin(), ws.col_row.begin() + all_cols, index_t());
+  // Initialization: with zero column potentials, the row minima are feasible row potentials, and
+  // each row takes its cheapest column unless another row already did
+  for (index_t row = 1; row <= num_rows; ++row) {
+    index_t best_col = num_cols + row;
+    float64_t best = DUMMY_WEIGHT;
+    for (index_t col = 1; col <= num_cols; ++col) {
+      const float32_t w = weight(rows[row - 1], cols[col - 1]);
+      if (static_cast<float64_t>(w) < best) {
+        best = static_cast<float64_t>(w);
+        best_col = col;
+      }
+    }
+    ws.row_potential[static_cast<std::size_t>(row)] = best;
+    const bool8_t is_free = (ws.col_row[static_cast<std::size_t>(best_col)] == index_t());
+    if (is_free) {
+      ws.col_row[static_cast<std::size_t>(best_col)] = row;
+    }
+    ws.is_row_assigned[static_cast<std::size_t>(row)] = is_free;
+  }
+  // Augmentation: grow a shortest path tree from each unassigned row until it reaches a free
+  // column, updating the potentials so that reduced costs stay non-negative
+  for (index_t row = 1; row <= num_rows; ++row) {
+    if (ws.is_row_assigned[static_cast<std::size_t>(row)]) {
+      continue;
+    }
+    ws.col_row[0U] = row;
+    std::fill(ws.min_slack.begin(), ws.min_slack.begin() + all_cols, INF);
+    std::fill(ws.visited.begin(), ws.visited.begin() + all_cols, false);
+    index_t col = index_t();
+    // Each iteration visits one more column, and the dummy column of this row is always free
+    for (index_t iter = index_t(); iter <= num_all_cols; ++iter) {
+      ws.visited[static_cast<std::size_t>(col)] = true;
+      const index_t tree_row = ws.col_row[static_cast<std::size_t>(col)];
+      float64_t delta = INF;
+      index_t next_col = index_t();
+      for (index_t jdx = 1; jdx <= num_all_cols; ++jdx) {
+        const auto j = static_cast<std::size_t>(jdx);
+        if (!ws.visited[j]) {
+          const float64_t cur = slack(tree_row, jdx);
+          if (cur < ws.min_slack[j]) {
+            ws.min_slack[j] = cur;
+            ws.path[j] = col;
+          }
+          if (ws.min_slack[j] < delta) {
+            delta = ws.min_slack[j];
+            next_col = jdx;
+          }
+        }
+      }
+      if (next_col == index_t()) {
+        throw std::logic_error("Sparse assigner found no augmenting path");
+      }
+      for (std::size_t j = 0U; j < static_cast<std::size_t>(all_cols); ++j) {
+        if (ws.visited[j]) {
+          ws.row_potential[static_cast<std::size_t>(ws.col_row[j])] += delta;
+          ws.col_potential[j] -= delta;
+        } else {
+          ws.min_slack[j] -= delta;
+        }
+      }
+      col = next_col;
+      if (ws.col_row[static_cast<std::size_t>(col)] == index_t()) {
+        break;
+      }
+    }
+    // Flip the assignments along the path
+    while (col != index_t()) {
+      const index_t prev_col = ws.path[static_cast<std::size_t>(col)];
+      ws.col_row[static_cast<std::size_t>(col)] = ws.col_row[static_cast<std::size_t>(prev_col)];
+      col = prev_col;
+    }
+  }
+  for (index_t col = 1; col <= num_cols; ++col) {
+    const index_t row = ws.col_row[static_cast<std::size_t>(col)];
+    if (row != index_t()) {
+      m_assignments[static_cast<std::size_t>(rows[row - 1])] = cols[col - 1];
+      m_is_col_assigned[static_cast<std::size_t>(cols[col - 1])] = true;
+    }
+  }
+}
+
+///
+template<uint16_t Capacity>
+void sparse_assigner_c<Capacity>::run(void (sparse_assigner_c::* fn)(std::size_t))
+{
+  std::vector<std::thread> workers;
+  workers.reserve(m_num_threads - 1U);
+  for (std::size_t thread_idx = 1U; thread_idx < m_num_threads; ++thread_idx) {
+    workers.emplace_back([this, fn, thread_idx] {(this->*fn)(thread_idx);});
+  }
+  (this->*fn)(0U);
+  for (auto & worker : workers) {
+    worker.join();
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+// precompile
+template class HUNGARIAN_ASSIGNER_PUBLIC sparse_assigner_c<16U>;
+template class HUNGARIAN_ASSIGNER_PUBLIC sparse_assigner_c<32U>;
+template class HUNGARIAN_ASSIGNER_PUBLIC sparse_assigner_c<64U>;
+template class HUNGARIAN_ASSIGNER_PUBLIC sparse_assigner_c<96U>;
+template class HUNGARIAN_ASSIGNER_PUBLIC sparse_assigner_c<128U>;
+template class HUNGARIAN_ASSIGNER_PUBLIC sparse_assigner_c<192U>;
+template class HUNGARIAN_ASSIGNER_PUBLIC sparse_assigner_c<256U>;
+
+}  // namespace hungarian_assigner
+}  // namespace fusion
+}  // namespace autoware
@@ -0,0 +1,348 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#ifndef TEST_SPARSE_ASSIGNER_HPP_
+#define TEST_SPARSE_ASSIGNER_HPP_
+
+#include <hungarian_assigner/hungarian_assigner.hpp>
+#include <hungarian_assigner/sparse_assigner.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <set>
+#include <vector>
+#include "common/types.hpp"
+
+using autoware::common::types::bool8_t;
+using autoware::common::types::float32_t;
+using autoware::common::types::float64_t;
+using autoware::fusion::hungarian_assigner::hungarian_assigner_c;
+using autoware::fusion::hungarian_assigner::sparse_assigner_c;
+
+/// Weights of a tracking-like problem: rows and columns are at random positions on a line, and
+/// only pairs that are closer than the gate get a weight. Missing weights are negative
+inline std::vector<std::vector<float32_t>> make_gated_weights(
+  const std::size_t num_rows, const std::size_t num_cols, const float32_t length,
+  const float32_t gate, std::mt19937 & gen)
+{
+  std::uniform_real_distribution<float32_t> pos(0.0F, length);
+  std::vector<float32_t> col_pos(num_cols);
+  for (auto & p : col_pos) {
+    p = pos(gen);
+  }
+  std::vector<std::vector<float32_t>> weights(num_rows, std::vector<float32_t>(num_cols, -1.0F));
+  for (auto & row : weights) {
+    const float32_t row_pos = pos(gen);
+    for (std::size_t jdx = 0U; jdx < num_cols; ++jdx) {
+      const float32_t dist = std::fabs(row_pos - col_pos[jdx]);
+      if (dist < gate) {
+        // Round so that ties happen
+        row[jdx] = std::round(dist * 4.0F);
+      }
+    }
+  }
+  return weights;
+}
+
+template<typename AssignerT>
+void set_gated_weights(AssignerT & assign, const std::vector<std::vector<float32_t>> & weights)
+{
+  assign.reset(
+    static_cast<int64_t>(weights.size()), static_cast<int64_t>(weights.front().size()));
+  for (std::size_t idx = 0U; idx < weights.size(); ++idx) {
+    for (std::size_t jdx = 0U; jdx < weights[idx].size(); ++jdx) {
+      if (weights[idx][jdx] >= 0.0F) {
+        assign.set_weight(weights[idx][jdx], static_cast<int64_t>(idx), static_cast<int64_t>(jdx));
+      }
+    }
+  }
+}
+
+/// Total cost of an assignment, where unassigned rows cost MAX_WEIGHT. Also checks that the
+/// assignment only uses set weights and that no column is used twice
+template<typename AssignerT>
+float64_t total_cost(const AssignerT & assign, const std::vector<std::vector<float32_t>> & weights)
+{
+  std::set<int64_t> used_cols;
+  float64_t cost = 0.0;
+  for (std::size_t idx = 0U; idx < weights.size(); ++idx) {
+    const auto jdx = assign.get_assignment(static_cast<int64_t>(idx));
+    if (jdx == AssignerT::UNASSIGNED) {
+      cost += static_cast<float64_t>(AssignerT::MAX_WEIGHT);
+    } else {
+      EXPECT_GE(weights[idx][static_cast<std::size_t>(jdx)], 0.0F);
+      EXPECT_TRUE(used_cols.insert(jdx).second);
+      cost += static_cast<float64_t>(weights[idx][static_cast<std::size_t>(jdx)]);
+    }
+  }
+  return cost;
+}
+
+// Same cases as for the dense assigner, where the optimum is unique
+TEST(sparse_assigner, minimal)
+{
+  sparse_assigner_c<16U> assign;
+  ASSERT_THROW(assign.set_size(5U, 4U), std::domain_error);
+  ASSERT_THROW(assign.set_size(15, 17), std::length_error);
+  ASSERT_THROW(assign.set_num_threads(0U), std::domain_error);
+  for (uint32_t iter = 0U; iter < 2U; ++iter) {
+    assign.set_size(3U, 3U);
+    assign.set_weight(1.0F, 0U, 1U);
+    assign.set_weight(1.0F, 1U, 2U);
+    assign.set_weight(1.0F, 2U, 0U);
+    ASSERT_THROW(assign.set_weight(1.0F, 2U, 3U), std::out_of_range);
+    ASSERT_THROW(assign.set_weight(1.0F, 3U, 0U), std::out_of_range);
+    ASSERT_THROW(assign.set_weight(assign.MAX_WEIGHT, 0U, 0U), std::out_of_range);
+    ASSERT_TRUE(assign.assign());
+    ASSERT_EQ(assign.get_assignment(0U), 1U);
+    ASSERT_EQ(assign.get_assignment(1U), 2U);
+    ASSERT_EQ(assign.get_assignment(2U), 0U);
+    ASSERT_THROW(assign.get_unassigned(0U), std::range_error);
+    ASSERT_THROW(assign.get_assignment(3U), std::range_error);
+    ASSERT_NO_THROW(assign.reset());
+    ASSERT_THROW(assign.get_assignment(0U), std::range_error);
+    ASSERT_THROW(assign.get_unassigned(0U), std::range_error);
+  }
+}
+
+TEST(sparse_assigner, unbalanced)
+{
+  sparse_assigner_c<16U> assign;
+  set_gated_weights(
+    assign, {
+      {5, 7, 11, 6, 7},
+      {8, 5, 5, 6, 5},
+      {6, 7, 10, 7, 3},
+      {10, 4, 8, 2, 4}
+    });
+  ASSERT_TRUE(assign.assign());
+  ASSERT_EQ(assign.get_assignment(0U), 0U);
+  ASSERT_EQ(assign.get_assignment(1U), 1U);
+  ASSERT_EQ(assign.get_assignment(2U), 4U);
+  ASSERT_EQ(assign.get_assignment(3U), 3U);
+  ASSERT_EQ(assign.get_unassigned(0U), 2U);
+  ASSERT_THROW(assign.get_unassigned(1U), std::range_error);
+}
+
+/*
+0 1 2 3
+0 1 2 -
+0 1 - -
+0 - - -
+*/
+TEST(sparse_assigner, ill_conditioned)
+{
+  sparse_assigner_c<16U> assign;
+  set_gated_weights(
+    assign, {
+      {0, 1, 2, 3},
+      {0, 1, 2, -1},
+      {0, 1, -1, -1},
+      {0, -1, -1, -1}
+    });
+  ASSERT_TRUE(assign.assign());
+  ASSERT_EQ(assign.get_assignment(0U), 3U);
+  ASSERT_EQ(assign.get_assignment(1U), 2U);
+  ASSERT_EQ(assign.get_assignment(2U), 1U);
+  ASSERT_EQ(assign.get_assignment(3U), 0U);
+}
+
+/*
+1 2 X X
+X 2 1 X
+X X X X
+2 1 X X
+*/
+TEST(sparse_assigner, partial)
+{
+  sparse_assigner_c<16U> assign;
+  set_gated_weights(
+    assign, {
+      {1, 2, -1, -1},
+      {-1, 2, 1, -1},
+      {-1, -1, -1, -1},
+      {2, 1, -1, -1}
+    });
+  ASSERT_TRUE(assign.assign());
+  ASSERT_EQ(assign.get_assignment(0), 0);
+  ASSERT_EQ(assign.get_assignment(1), 2);
+  ASSERT_EQ(assign.get_assignment(2), assign.UNASSIGNED);
+  ASSERT_EQ(assign.get_assignment(3), 1);
+}
+
+/*
+   x  4 x 12 x
+   x  0 x  8 x
+   x  4 x  4 x
+   x  8 x  0 x
+   x 12 x  4 x
+*/
+TEST(sparse_assigner, degenerate)
+{
+  sparse_assigner_c<32U> assign;
+  set_gated_weights(
+    assign, {
+      {-1, 4, -1, 12, -1},
+      {-1, 0, -1, 8, -1},
+      {-1, 4, -1, 4, -1},
+      {-1, 8, -1, 0, -1},
+      {-1, 12, -1, 4, -1}
+    });
+  ASSERT_TRUE(assign.assign());
+  EXPECT_EQ(assign.get_assignment(0), assign.UNASSIGNED);
+  EXPECT_EQ(assign.get_assignment(1), 1);
+  EXPECT_EQ(assign.get_assignment(2), assign.UNASSIGNED);
+  EXPECT_EQ(assign.get_assignment(3), 3);
+  EXPECT_EQ(assign.get_assignment(4), assign.UNASSIGNED);
+  // Nothing set at all
+  assign.reset(2, 2);
+  ASSERT_TRUE(assign.assign());
+  EXPECT_EQ(assign.get_assignment(0), assign.UNASSIGNED);
+  EXPECT_EQ(assign.get_assignment(1), assign.UNASSIGNED);
+}
+
+/// Minimum total cost by dynamic programming over the subsets of used columns, for few columns
+inline float64_t brute_force_cost(const std::vector<std::vector<float32_t>> & weights)
+{
+  const std::size_t num_cols = weights.front().size();
+  const float64_t inf = std::numeric_limits<float64_t>::infinity();
+  std::vector<float64_t> cost(1U << num_cols, inf);
+  cost[0U] = 0.0;
+  for (const auto & row : weights) {
+    std::vector<float64_t> next(cost.size(), inf);
+    for (std::size_t used = 0U; used < cost.size(); ++used) {
+      if (cost[used] < inf) {
+        next[used] = std::min(
+          next[used], cost[used] + static_cast<float64_t>(sparse_assigner_c<16U>::MAX_WEIGHT));
+        for (std::size_t jdx = 0U; jdx < num_cols; ++jdx) {
+          const std::size_t col = 1U << jdx;
+          if (((used & col) == 0U) && (row[jdx] >= 0.0F)) {
+            next[used | col] =
+              std::min(next[used | col], cost[used] + static_cast<float64_t>(row[jdx]));
+          }
+        }
+      }
+    }
+    cost = next;
+  }
+  return *std::min_element(cost.begin(), cost.end());
+}
+
+// The sparse assigner finds the optimum, from almost no weights to all weights
+TEST(sparse_assigner, matches_brute_force)
+{
+  std::mt19937 gen(1U);
+  sparse_assigner_c<16U> assign;
+  for (uint32_t iter = 0U; iter < 500U; ++iter) {
+    const std::size_t num_rows = 1U + (gen() % 10U);
+    const std::size_t num_cols = num_rows + (gen() % (11U - num_rows));
+    const auto scale = static_cast<float32_t>(iter % 10U);
+    const auto weights = make_gated_weights(num_rows, num_cols, 30.0F, 0.5F * scale * scale, gen);
+    set_gated_weights(assign, weights);
+    ASSERT_TRUE(assign.assign());
+    EXPECT_NEAR(total_cost(assign, weights), brute_force_cost(weights), 1.0E-3) << iter;
+    // Columns that are not assigned are listed in ascending order
+    std::set<int64_t> assigned;
+    for (std::size_t idx = 0U; idx < num_rows; ++idx) {
+      assigned.insert(assign.get_assignment(static_cast<int64_t>(idx)));
+    }
+    int64_t last = -1;
+    for (std::size_t idx = 0U; idx < (num_cols - num_rows); ++idx) {
+      const auto jdx = assign.get_unassigned(static_cast<int64_t>(idx));
+      EXPECT_GT(jdx, last);
+      EXPECT_EQ(assigned.count(jdx), 0U);
+      last = jdx;
+    }
+    EXPECT_THROW(
+      assign.get_unassigned(static_cast<int64_t>(num_cols - num_rows)), std::range_error);
+  }
+}
+
+// On bigger problems, the sparse assigner is never worse than the dense one
+TEST(sparse_assigner, not_worse_than_dense)
+{
+  std::mt19937 gen(42U);
+  hungarian_assigner_c<64U> dense;
+  sparse_assigner_c<64U> sparse;
+  for (uint32_t iter = 0U; iter < 50U; ++iter) {
+    const std::size_t num_rows = 1U + (gen() % 64U);
+    const std::size_t num_cols = num_rows + (gen() % (65U - num_rows));
+    const auto scale = static_cast<float32_t>(iter % 10U);
+    const auto weights = make_gated_weights(num_rows, num_cols, 100.0F, 0.5F * scale * scale, gen);
+    set_gated_weights(dense, weights);
+    set_gated_weights(sparse, weights);
+    (void)dense.assign();
+    ASSERT_TRUE(sparse.assign());
+    EXPECT_LE(total_cost(sparse, weights), total_cost(dense, weights) + 1.0E-3) << iter;
+  }
+}
+
+// Solving the components on several threads gives the same result as on one
+TEST(sparse_assigner, parallel)
+{
+  std::mt19937 gen(3U);
+  // 8 groups of 32 rows and columns, enough work to use the threads
+  std::vector<std::vector<float32_t>> weights(256U, std::vector<float32_t>(256U, -1.0F));
+  std::uniform_real_distribution<float32_t> dist(0.0F, 100.0F);
+  for (std::size_t idx = 0U; idx < 256U; ++idx) {
+    const std::size_t group = idx / 32U;
+    for (std::size_t jdx = group * 32U; jdx < (group + 1U) * 32U; ++jdx) {
+      if ((gen() % 4U) != 0U) {
+        weights[idx][jdx] = dist(gen);
+      }
+    }
+  }
+  sparse_assigner_c<256U> serial;
+  sparse_assigner_c<256U> parallel;
+  parallel.set_num_threads(4U);
+  set_gated_weights(serial, weights);
+  set_gated_weights(parallel, weights);
+  ASSERT_TRUE(serial.assign());
+  ASSERT_TRUE(parallel.assign());
+  for (int64_t idx = 0; idx < 256; ++idx) {
+    EXPECT_EQ(serial.get_assignment(idx), parallel.get_assignment(idx));
+  }
+}
+
+// Gated problems are solved much faster than with the dense assigner
+TEST(sparse_assigner, benchmark)
+{
+  std::mt19937 gen(7U);
+  hungarian_assigner_c<256U> dense;
+  sparse_assigner_c<256U> sparse;
+  const auto weights = make_gated_weights(200U, 250U, 1000.0F, 3.0F, gen);
+  using clock = std::chrono::steady_clock;
+  set_gated_weights(dense, weights);
+  const auto dense_start = clock::now();
+  (void)dense.assign();
+  const auto dense_time = clock::now() - dense_start;
+  set_gated_weights(sparse, weights);
+  const auto sparse_start = clock::now();
+  ASSERT_TRUE(sparse.assign());
+  const auto sparse_time = clock::now() - sparse_start;
+  EXPECT_LE(total_cost(sparse, weights), total_cost(dense, weights) + 1.0E-3);
+  const auto to_us = [](const clock::duration d) {
+      return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+    };
+  std::cout << "200x250 gated: dense " << to_us(dense_time) << "us, sparse " <<
+    to_us(sparse_time) << "us" << std::endl;
+  EXPECT_LT(sparse_time, dense_time);
+}
+
+#endif  // TEST_SPARSE_ASSIGNER_HPP_
@@ -0,0 +1,148 @@
+# Copyright 2021 the Autoware Foundation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from ament_index_python import get_package_share_directory
+from launch import LaunchDescription
+from launch.actions import DeclareLaunchArgument
+from launch.substitutions import LaunchConfiguration
+from launch_ros.actions import ComposableNodeContainer
+from launch_ros.descriptions import ComposableNode
+
+import os
+
+
+def generate_launch_description():
+    """
+    Launch the front lidar pipeline as components in a single process.
+
+     * velodyne_node
+     * point_cloud_filter_transform
+     * ray_ground_classifier
+     * euclidean_cluster
+     * voxel_grid_node
+
+    With intra-process communication, the point clouds are passed between the components
+    without being copied or serialized.
+    """
+    autoware_auto_launch_pkg_prefix = get_package_share_directory(
+        'autoware_auto_launch')
+    velodyne_param_file = os.path.join(
+        autoware_auto_launch_pkg_prefix, 'param/vlp16_front_vehicle.param.yaml')
+    point_cloud_filter_transform_param_file = os.path.join(
+        autoware_auto_launch_pkg_prefix, 'param/point_cloud_filter_transform.param.yaml')
+    ray_ground_classifier_param_file = os.path.join(
+        autoware_auto_launch_pkg_prefix, 'param/ray_ground_classifier.param.yaml')
+    euclidean_cluster_param_file = os.path.join(
+        autoware_auto_launch_pkg_prefix, 'param/euclidean_cluster.param.yaml')
+    voxel_grid_node_param_file = os.path.join(
+        autoware_auto_launch_pkg_prefix, 'param/voxel_grid_node.param.yaml')
+
+    # Arguments
+    velodyne_param = DeclareLaunchArgument(
+        'velodyne_param_file',
+        default_value=velodyne_param_file,
+        description='Path to config file for the front Velodyne driver'
+    )
+    point_cloud_filter_transform_param = DeclareLaunchArgument(
+        'point_cloud_filter_transform_param_file',
+        default_value=point_cloud_filter_transform_param_file,
+        description='Path to config file for Point Cloud Filter/Transform Nodes'
+    )
+    ray_ground_classifier_param = DeclareLaunchArgument(
+        'ray_ground_classifier_param_file',
+        default_value=ray_ground_classifier_param_file,
+        description='Path to config file for Ray Ground Classifier'
+    )
+    euclidean_cluster_param = DeclareLaunchArgument(
+        'euclidean_cluster_param_file',
+        default_value=euclidean_cluster_param_file,
+        description='Path to config file for Euclidean Clustering'
+    )
+    voxel_grid_node_param = DeclareLaunchArgument(
+        'voxel_grid_node_param_file',
+        default_value=voxel_grid_node_param_file,
+        description='Path to config file for lidar scan downsampler'
+    )
+
+    intra_process = [{'use_intra_process_comms': True}]
+
+    # Nodes
+    lidar_pipeline_container = ComposableNodeContainer(
+        package='rclcpp_components',
+        executable='component_container',
+        name='lidar_pipeline_container',
+        namespace='',
+        composable_node_descriptions=[
+            ComposableNode(
+                package='velodyne_nodes',
+                plugin='autoware::drivers::velodyne_nodes::VLP16DriverNode',
+                name='vlp16_driver_node',
+                namespace='lidar_front',
+                parameters=[LaunchConfiguration('velodyne_param_file')],
+                extra_arguments=intra_process
+            ),
+            ComposableNode(
+                package='point_cloud_filter_transform_nodes',
+                plugin=('autoware::perception::filters::point_cloud_filter_transform_nodes'
+                        '::PointCloud2FilterTransformNode'),
+                name='filter_transform_vlp16_front',
+                namespace='lidar_front',
+                parameters=[LaunchConfiguration('point_cloud_filter_transform_param_file')],
+                remappings=[("points_in", "points_xyzi")],
+                extra_arguments=intra_process
+            ),
+            ComposableNode(
+                package='ray_ground_classifier_nodes',
+                plugin=('autoware::perception::filters::ray_ground_classifier_nodes'
+                        '::RayGroundClassifierCloudNode'),
+                name='ray_ground_classifier',
+                namespace='perception',
+                parameters=[LaunchConfiguration('ray_ground_classifier_param_file')],
+                remappings=[("points_in", "/lidar_front/points_filtered")],
+                extra_arguments=intra_process
+            ),
+            ComposableNode(
+                package='euclidean_cluster_nodes',
+                plugin=('autoware::perception::segmentation::euclidean_cluster_nodes'
+                        '::EuclideanClusterNode'),
+                name='euclidean_cluster_node',
+                namespace='perception',
+                parameters=[LaunchConfiguration('euclidean_cluster_param_file')],
+                remappings=[("points_in", "points_nonground")],
+                extra_arguments=intra_process
+            ),
+            ComposableNode(
+                package='voxel_grid_nodes',
+                plugin='autoware::perception::filters::voxel_grid_nodes::VoxelCloudNode',
+                name='voxel_grid_cloud_node',
+                namespace='lidars',
+                parameters=[LaunchConfiguration('voxel_grid_node_param_file')],
+                remappings=[
+                    ("points_in", "/lidar_front/points_filtered"),
+                    ("points_downsampled", "points_filtered_downsampled")
+                ],
+                extra_arguments=intra_process
+            ),
+        ],
+        output='screen'
+    )
+
+    return LaunchDescription([
+        velodyne_param,
+        point_cloud_filter_transform_param,
+        ray_ground_classifier_param,
+        euclidean_cluster_param,
+        voxel_grid_node_param,
+        lidar_pipeline_container,
+    ])
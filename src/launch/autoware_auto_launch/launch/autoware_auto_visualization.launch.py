@@ -30,10 +30,13 @@ def generate_launch_description():
      * rviz2
      * avp_web_interface
      * rosbridge_server
+     * web_relay, which rate limits and decimates the topics for the web interface
     """
     avp_web_interface_pkg_prefix = get_package_share_directory(
         'avp_web_interface')
     web_files_root = os.path.join(avp_web_interface_pkg_prefix, 'web')
+    web_relay_param_file = os.path.join(
+        avp_web_interface_pkg_prefix, 'param', 'web_relay.param.yaml')
     rviz_cfg_path = os.path.join(get_package_share_directory('autoware_auto_launch'),
                                  'config', 'avp.rviz')
 
@@ -43,6 +46,11 @@ def generate_launch_description():
         default_value='True',
         description='Launch RVIZ2 in addition to other nodes'
     )
+    web_relay_param = DeclareLaunchArgument(
+        'web_relay_param_file',
+        default_value=web_relay_param_file,
+        description='Path to config file for the web relay'
+    )
     rviz_cfg_path_param = DeclareLaunchArgument(
         'rviz_cfg_path_param',
         default_value=rviz_cfg_path,
@@ -65,6 +73,19 @@ def generate_launch_description():
         namespace='gui',
         executable='rosbridge_websocket'
     )
+    web_relay = Node(
+        package='avp_web_interface',
+        name='web_relay',
+        namespace='gui',
+        executable='web_relay_node_exe',
+        parameters=[LaunchConfiguration('web_relay_param_file')],
+        remappings=[
+            ('vehicle_state', '/vehicle/vehicle_kinematic_state'),
+            ('trajectory', '/planning/trajectory'),
+            ('objects', '/perception/lidar_bounding_boxes_filtered'),
+            ('points', '/lidars/points_fused_downsampled'),
+        ]
+    )
     web_server = ExecuteProcess(
       cmd=["python3", "-m", "http.server", "8000"],
       cwd=web_files_root
@@ -72,8 +93,10 @@ def generate_launch_description():
 
     return LaunchDescription([
         with_rviz_param,
+        web_relay_param,
         rviz_cfg_path_param,
         rviz2,
         web_server,
         web_bridge,
+        web_relay,
     ])
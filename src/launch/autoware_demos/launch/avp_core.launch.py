@@ -248,6 +248,19 @@ def generate_launch_description():
             ('HAD_Map_Service', '/had_maps/HAD_Map_Service'),
         ]
     )
+    # Reports the time to ready of the nodes that finish their startup in the background
+    startup_monitor = Node(
+        package='startup_tracking',
+        name='startup_monitor_node',
+        executable='startup_monitor_node_exe',
+        parameters=[{'expected_nodes': [
+            '/had_maps/lanelet2_map_provider_node',
+            '/planning/lane_planner_node',
+            '/planning/parking_planner_node',
+            '/planning/behavior_planner_node',
+        ]}],
+        output='screen'
+    )
 
     return LaunchDescription([
         euclidean_cluster_param,
@@ -273,4 +286,5 @@ def generate_launch_description():
         object_collision_estimator,
         behavior_planner,
         off_map_obstacles_filter,
+        startup_monitor,
     ])
@@ -0,0 +1,144 @@
+# Copyright 2021 the Autoware Foundation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Launch the lidar perception of the AVP Demo as components in a single process."""
+
+from ament_index_python import get_package_share_directory
+from launch import LaunchDescription
+from launch.actions import DeclareLaunchArgument
+from launch.substitutions import LaunchConfiguration
+from launch_ros.actions import ComposableNodeContainer
+from launch_ros.descriptions import ComposableNode
+
+import os
+
+
+def generate_launch_description():
+    """
+    Launch the lidar perception nodes of avp_core.launch.py in one container.
+
+     * point_cloud_fusion_node
+     * ray_ground_classifier
+     * euclidean_cluster_node
+     * voxel_grid_cloud_node
+
+    The container spins the nodes on the executors, threads, CPUs and priorities of
+    executor_topology_param_file instead of a single thread. It is an alternative to the same
+    nodes in avp_core.launch.py, the two must not run at the same time.
+    """
+    avp_demo_pkg_prefix = get_package_share_directory('autoware_demos')
+    autoware_launch_pkg_prefix = get_package_share_directory('autoware_auto_launch')
+    point_cloud_fusion_node_pkg_prefix = get_package_share_directory(
+        'point_cloud_fusion_nodes')
+
+    executor_topology_param_file = os.path.join(
+        avp_demo_pkg_prefix, 'param/avp/executor_topology.param.yaml')
+    point_cloud_fusion_param_file = os.path.join(
+        point_cloud_fusion_node_pkg_prefix, 'param/vlp16_sim_lexus_pc_fusion.param.yaml')
+    euclidean_cluster_param_file = os.path.join(
+        autoware_launch_pkg_prefix, 'param/euclidean_cluster.param.yaml')
+    ray_ground_classifier_param_file = os.path.join(
+        autoware_launch_pkg_prefix, 'param/ray_ground_classifier.param.yaml')
+    scan_downsampler_param_file = os.path.join(
+        autoware_launch_pkg_prefix, 'param/scan_downsampler.param.yaml')
+
+    # Arguments
+    executor_topology_param = DeclareLaunchArgument(
+        'executor_topology_param_file',
+        default_value=executor_topology_param_file,
+        description='Path to config file for the executors of the container'
+    )
+    euclidean_cluster_param = DeclareLaunchArgument(
+        'euclidean_cluster_param_file',
+        default_value=euclidean_cluster_param_file,
+        description='Path to config file for Euclidean Clustering'
+    )
+    ray_ground_classifier_param = DeclareLaunchArgument(
+        'ray_ground_classifier_param_file',
+        default_value=ray_ground_classifier_param_file,
+        description='Path to config file for Ray Ground Classifier'
+    )
+    scan_downsampler_param = DeclareLaunchArgument(
+        'scan_downsampler_param_file',
+        default_value=scan_downsampler_param_file,
+        description='Path to config file for lidar scan downsampler'
+    )
+
+    intra_process = [{'use_intra_process_comms': True}]
+
+    # Nodes
+    perception_container = ComposableNodeContainer(
+        package='executor_topology',
+        executable='component_container_rt',
+        name='avp_perception_container',
+        namespace='',
+        parameters=[LaunchConfiguration('executor_topology_param_file')],
+        composable_node_descriptions=[
+            ComposableNode(
+                package='point_cloud_fusion_nodes',
+                plugin=('autoware::perception::filters::point_cloud_fusion_nodes'
+                        '::PointCloudFusionNode'),
+                name='point_cloud_fusion_node',
+                namespace='lidars',
+                parameters=[point_cloud_fusion_param_file],
+                remappings=[
+                    ("output_topic", "points_fused"),
+                    ("input_topic1", "/lidar_front/points_filtered"),
+                    ("input_topic2", "/lidar_rear/points_filtered")
+                ],
+                extra_arguments=intra_process
+            ),
+            ComposableNode(
+                package='ray_ground_classifier_nodes',
+                plugin=('autoware::perception::filters::ray_ground_classifier_nodes'
+                        '::RayGroundClassifierCloudNode'),
+                name='ray_ground_classifier',
+                namespace='perception',
+                parameters=[LaunchConfiguration('ray_ground_classifier_param_file')],
+                remappings=[("points_in", "/lidars/points_fused")],
+                extra_arguments=intra_process
+            ),
+            ComposableNode(
+                package='euclidean_cluster_nodes',
+                plugin=('autoware::perception::segmentation::euclidean_cluster_nodes'
+                        '::EuclideanClusterNode'),
+                name='euclidean_cluster_node',
+                namespace='perception',
+                parameters=[LaunchConfiguration('euclidean_cluster_param_file')],
+                remappings=[("points_in", "points_nonground")],
+                extra_arguments=intra_process
+            ),
+            ComposableNode(
+                package='voxel_grid_nodes',
+                plugin='autoware::perception::filters::voxel_grid_nodes::VoxelCloudNode',
+                name='voxel_grid_cloud_node',
+                namespace='lidars',
+                parameters=[LaunchConfiguration('scan_downsampler_param_file')],
+                remappings=[
+                    ("points_in", "points_fused"),
+                    ("points_downsampled", "points_fused_downsampled")
+                ],
+                extra_arguments=intra_process
+            ),
+        ],
+        output='screen'
+    )
+
+    return LaunchDescription([
+        executor_topology_param,
+        euclidean_cluster_param,
+        ray_ground_classifier_param,
+        scan_downsampler_param,
+        perception_container,
+    ])
@@ -19,10 +19,16 @@
 #define LOCALIZATION_COMMON__INITIALIZATION_HPP_
 
 #include <localization_common/visibility_control.hpp>
+#include <common/types.hpp>
 #include <geometry_msgs/msg/transform.hpp>
+#include <geometry_msgs/msg/twist_stamped.hpp>
+#include <geometry_msgs/msg/vector3_stamped.hpp>
 #include <helper_functions/crtp.hpp>
 #include <time_utils/time_utils.hpp>
 #include <tf2/buffer_core.h>
+#include <tf2/LinearMath/Vector3.h>
+#include <chrono>
+#include <deque>
 #include <experimental/optional>
 #include <string>
 
@@ -34,6 +40,7 @@ namespace localization
 {
 namespace localization_common
 {
+using autoware::common::types::bool8_t;
 
 /// The Pose initializer helps initialize relative localizer algorithms with an initial guess.
 /// Extrapolation policy must be defined within the implementation class.
@@ -92,6 +99,15 @@ public:
     m_fallback_pose.emplace(pose);
   }
 
+  /// \brief Report a registration result, i.e. the transform the localizer estimated from
+  /// a guess. Implementations that predict the pose from the past results override this, the
+  /// default ignores it.
+  /// \param pose Estimated transform between the frames of the guess
+  void add_registration_result(const PoseT & pose)
+  {
+    (void) pose;
+  }
+
 private:
   std::experimental::optional<PoseT> m_fallback_pose{std::experimental::nullopt};
 };
@@ -115,6 +131,88 @@ public:
     const std::string & target_frame, const std::string & source_frame);
 };
 
+/// Configuration of the ConstantVelocityInitializer
+struct LOCALIZATION_COMMON_PUBLIC ConstantVelocityInitializerConfig
+{
+  /// Number of latest registration results the twist is estimated from, at least 2. The twist
+  /// is the average over the time they span.
+  std::size_t pose_history_size{2U};
+  /// Number of latest twist and angular velocity samples kept for the integration
+  std::size_t twist_history_size{200U};
+  /// The motion is predicted for at most this duration after the latest known pose, so that
+  /// an outdated twist can't move the guess arbitrarily far.
+  std::chrono::nanoseconds max_extrapolation{std::chrono::milliseconds{500}};
+};
+
+/// Pose initialization implementation that predicts the motion since the latest known pose.
+/// The latest known pose is the more recent of the latest transform in the transform graph and
+/// the latest registration result. The twist in the source frame is the one of a constant twist
+/// motion between the oldest and the latest kept registration result. Twist samples, e.g. from
+/// wheel odometry, and angular velocity samples, e.g. from an IMU, replace it where available:
+/// they are integrated as piecewise constant until the requested time. Without any of this
+/// information, the latest available transform is returned like by the BestEffortInitializer.
+class LOCALIZATION_COMMON_PUBLIC ConstantVelocityInitializer
+  : public PoseInitializerBase<ConstantVelocityInitializer>
+{
+  using PoseT = geometry_msgs::msg::TransformStamped;
+  using Base = PoseInitializerBase<ConstantVelocityInitializer>;
+
+public:
+  /// Constructor
+  /// \param config Configuration of the initializer
+  /// \throws std::domain_error If the pose history can't hold two poses
+  explicit ConstantVelocityInitializer(
+    const ConstantVelocityInitializerConfig & config = ConstantVelocityInitializerConfig{});
+
+  /// Predict the transform at a time newer than the transform graph.
+  /// \param tf_graph Transform graph that contains all the transforms to look up.
+  /// \param time_point Time to guess the pose.
+  /// \param target_frame Target frame of the transform. (i.e. "map")
+  /// \param source_frame Source frame of the transform. (i.e. "base_link")
+  /// \return The transform at the given time point, or the latest known transform if the
+  /// motion is unknown
+  /// \throws std::domain_error If the time point is older than the transform graph
+  PoseT extrapolate(
+    const tf2::BufferCore & tf_graph, tf2::TimePoint time_point,
+    const std::string & target_frame, const std::string & source_frame);
+
+  /// Add a registration result to the pose history. Results that aren't newer than the latest
+  /// one are ignored, results between other frames than the latest one restart the history.
+  /// \param pose Estimated transform between the frames of the guess
+  void add_registration_result(const PoseT & pose);
+
+  /// Add a twist sample, e.g. of the wheel odometry. Samples that aren't newer than the latest
+  /// one are ignored.
+  /// \param twist The linear and angular velocity, expressed in the source frame
+  void add_twist(const geometry_msgs::msg::TwistStamped & twist);
+
+  /// Add an angular velocity sample, e.g. of an IMU. The linear velocity is taken from the
+  /// registration results. Samples that aren't newer than the latest one are ignored.
+  /// \param angular_velocity The angular velocity, expressed in the source frame
+  void add_angular_velocity(const geometry_msgs::msg::Vector3Stamped & angular_velocity);
+
+  /// Set a fallback pose, see PoseInitializerBase::set_fallback_pose(). The pose history is
+  /// cleared since the vehicle is relocalized.
+  /// \param pose Fallback pose to set
+  void set_fallback_pose(const PoseT & pose);
+
+private:
+  /// A piecewise constant twist that starts at its stamp
+  struct TwistSample
+  {
+    tf2::TimePoint stamp;
+    tf2::Vector3 linear;
+    tf2::Vector3 angular;
+    bool8_t has_linear;
+  };
+
+  void add_sample(const TwistSample & sample);
+
+  ConstantVelocityInitializerConfig m_config;
+  std::deque<PoseT> m_poses;
+  std::deque<TwistSample> m_twists;
+};
+
 }  // namespace localization_common
 }  // namespace localization
 }  // namespace autoware
@@ -17,8 +17,10 @@
 #ifndef LOCALIZATION_COMMON__OPTIMIZED_REGISTRATION_SUMMARY_HPP_
 #define LOCALIZATION_COMMON__OPTIMIZED_REGISTRATION_SUMMARY_HPP_
 
+#include <common/types.hpp>
 #include <localization_common/visibility_control.hpp>
 #include <optimization/optimizer_options.hpp>
+#include <cstddef>
 #include <experimental/optional>
 
 namespace autoware
@@ -27,20 +29,35 @@ namespace localization
 {
 namespace localization_common
 {
+using autoware::common::types::bool8_t;
+
 /// Basic Registration Summary for localizers using an optimizer.
-/// It only wraps the optimization summary of the optimizer.
+/// It wraps the optimization summary of the optimizer and tells how much of the measurement
+/// was used.
 class LOCALIZATION_COMMON_PUBLIC OptimizedRegistrationSummary
 {
 public:
   using OptimizationSummary = common::optimization::OptimizationSummary;
-  explicit OptimizedRegistrationSummary(const OptimizationSummary & opt_summary);
+  /// Constructor
+  /// \param opt_summary Summary of the optimization.
+  /// \param scan_stride Only every `scan_stride`-th point of the measurement was registered.
+  explicit OptimizedRegistrationSummary(
+    const OptimizationSummary & opt_summary, std::size_t scan_stride = 1U);
   OptimizedRegistrationSummary();
 
   /// Get optimization summary.
   OptimizationSummary optimization_summary() const;
 
+  /// Get the stride the measurement was subsampled with, 1 if all of it was registered.
+  std::size_t scan_stride() const noexcept;
+
+  /// Check whether the result is degraded to meet the time budget, i.e. the optimization ran
+  /// out of time or the measurement was subsampled.
+  bool8_t degraded() const noexcept;
+
 private:
   OptimizationSummary m_optimization_summary;
+  std::size_t m_scan_stride;
 };
 }  // namespace localization_common
 }  // namespace localization
@@ -16,6 +16,12 @@
 
 #include <localization_common/initialization.hpp>
 #include <time_utils/time_utils.hpp>
+#include <tf2/LinearMath/Quaternion.h>
+#include <tf2/LinearMath/Transform.h>
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <stdexcept>
 #include <string>
 
 namespace autoware
@@ -24,6 +30,88 @@ namespace localization
 {
 namespace localization_common
 {
+namespace
+{
+using autoware::common::types::float64_t;
+
+/// Below this rotation angle in radians, the series expansions of the SE(3) maps are used
+constexpr float64_t kSmallAngle{1.0e-6};
+
+tf2::Transform from_message(const geometry_msgs::msg::Transform & transform)
+{
+  return tf2::Transform{
+    tf2::Quaternion{transform.rotation.x, transform.rotation.y, transform.rotation.z,
+      transform.rotation.w},
+    tf2::Vector3{transform.translation.x, transform.translation.y, transform.translation.z}};
+}
+
+geometry_msgs::msg::Transform to_message(const tf2::Transform & transform)
+{
+  const auto & rotation = transform.getRotation();
+  const auto & translation = transform.getOrigin();
+  geometry_msgs::msg::Transform ret;
+  ret.rotation.set__x(rotation.x()).set__y(rotation.y()).set__z(rotation.z()).
+  set__w(rotation.w());
+  ret.translation.set__x(translation.x()).set__y(translation.y()).set__z(translation.z());
+  return ret;
+}
+
+tf2::Vector3 to_vector(const geometry_msgs::msg::Vector3 & vector)
+{
+  return tf2::Vector3{vector.x, vector.y, vector.z};
+}
+
+float64_t to_seconds(const std::chrono::nanoseconds duration)
+{
+  return std::chrono::duration_cast<std::chrono::duration<float64_t>>(duration).count();
+}
+
+/// The motion with a constant twist over the given duration, i.e. the exponential map of SE(3)
+tf2::Transform integrate(
+  const tf2::Vector3 & linear, const tf2::Vector3 & angular,
+  const float64_t duration)
+{
+  const auto rho = linear * duration;
+  const auto phi = angular * duration;
+  const auto theta = phi.length();
+  // The translation follows the arc, V * rho in the usual notation
+  if (theta < kSmallAngle) {
+    return tf2::Transform{tf2::Quaternion::getIdentity(), rho + 0.5 * phi.cross(rho)};
+  }
+  const auto a = (1.0 - std::cos(theta)) / (theta * theta);
+  const auto b = (theta - std::sin(theta)) / (theta * theta * theta);
+  return tf2::Transform{
+    tf2::Quaternion{phi / theta, theta},
+    rho + a * phi.cross(rho) + b * phi.cross(phi.cross(rho))};
+}
+
+/// The constant twist that moves from one pose to the other over the given duration, i.e. the
+/// logarithmic map of SE(3)
+void differentiate(
+  const tf2::Transform & from, const tf2::Transform & to, const float64_t duration,
+  tf2::Vector3 & linear, tf2::Vector3 & angular)
+{
+  const auto delta = from.inverseTimes(to);
+  auto rotation = delta.getRotation();
+  if (rotation.w() < 0.0) {
+    // Take the shorter way around
+    rotation = -rotation;
+  }
+  const tf2::Vector3 axis{rotation.x(), rotation.y(), rotation.z()};
+  const auto sin_half_theta = axis.length();
+  const auto theta = 2.0 * std::atan2(sin_half_theta, rotation.w());
+  const auto phi = (sin_half_theta < kSmallAngle) ? (2.0 * axis) :
+    (axis * (theta / sin_half_theta));
+  // Inverse of V, with the series expansion of its last coefficient for small angles
+  const auto c = (theta < kSmallAngle) ? (1.0 / 12.0) :
+    ((1.0 - ((theta * std::sin(theta)) / (2.0 * (1.0 - std::cos(theta))))) / (theta * theta));
+  const auto & t = delta.getOrigin();
+  const auto rho = t - 0.5 * phi.cross(t) + c * phi.cross(phi.cross(t));
+  linear = rho / duration;
+  angular = phi / duration;
+}
+}  // namespace
+
 geometry_msgs::msg::TransformStamped BestEffortInitializer::extrapolate(
   const tf2::BufferCore & tf_graph, tf2::TimePoint time_point,
   const std::string & target_frame, const std::string & source_frame)
@@ -41,6 +129,144 @@ geometry_msgs::msg::TransformStamped BestEffortInitializer::extrapolate(
   return ret;
 }
 
+ConstantVelocityInitializer::ConstantVelocityInitializer(
+  const ConstantVelocityInitializerConfig & config)
+: m_config{config}
+{
+  if (m_config.pose_history_size < 2U) {
+    throw std::domain_error(
+            "ConstantVelocityInitializer: The pose history needs to hold at least two poses.");
+  }
+}
+
+geometry_msgs::msg::TransformStamped ConstantVelocityInitializer::extrapolate(
+  const tf2::BufferCore & tf_graph, tf2::TimePoint time_point,
+  const std::string & target_frame, const std::string & source_frame)
+{
+  auto anchor = tf_graph.lookupTransform(target_frame, source_frame, tf2::TimePointZero);
+  auto anchor_time = ::time_utils::from_message(anchor.header.stamp);
+  if (anchor_time > time_point) {
+    throw std::domain_error(
+            "ConstantVelocityInitializer: Backwards extrapolation is not supported."
+            "Initialization timepoint is older than the oldest available "
+            "transform in the transform graph.");
+  }
+  const auto history_valid = (!m_poses.empty()) &&
+    (m_poses.back().header.frame_id == target_frame) &&
+    (m_poses.back().child_frame_id == source_frame);
+  if (history_valid) {
+    const auto latest_result_time = ::time_utils::from_message(m_poses.back().header.stamp);
+    if ((latest_result_time > anchor_time) && (latest_result_time <= time_point)) {
+      anchor = m_poses.back();
+      anchor_time = latest_result_time;
+    }
+  }
+
+  tf2::Vector3 linear{0.0, 0.0, 0.0};
+  tf2::Vector3 angular{0.0, 0.0, 0.0};
+  const auto history_span = history_valid ?
+    (::time_utils::from_message(m_poses.back().header.stamp) -
+    ::time_utils::from_message(m_poses.front().header.stamp)) : std::chrono::nanoseconds::zero();
+  const auto twist_known = history_span > std::chrono::nanoseconds::zero();
+  if (twist_known) {
+    differentiate(
+      from_message(m_poses.front().transform), from_message(m_poses.back().transform),
+      to_seconds(history_span), linear, angular);
+  }
+  if ((!twist_known) && m_twists.empty()) {
+    return anchor;
+  }
+
+  // Integrate the piecewise constant twist, starting with the sample that was valid at the
+  // anchor unless that one is outdated
+  const auto end_time = std::min(time_point, anchor_time + m_config.max_extrapolation);
+  auto next_sample = std::upper_bound(
+    m_twists.begin(), m_twists.end(), anchor_time,
+    [](const tf2::TimePoint stamp, const TwistSample & sample) {return stamp < sample.stamp;});
+  const TwistSample * current_sample = nullptr;
+  if ((next_sample != m_twists.begin()) &&
+    ((anchor_time - std::prev(next_sample)->stamp) <= m_config.max_extrapolation))
+  {
+    current_sample = &(*std::prev(next_sample));
+  }
+  auto pose = from_message(anchor.transform);
+  for (auto segment_begin = anchor_time; segment_begin < end_time; ) {
+    const auto segment_end = (next_sample == m_twists.end()) ? end_time :
+      std::min(end_time, next_sample->stamp);
+    const auto duration = to_seconds(segment_end - segment_begin);
+    if (current_sample == nullptr) {
+      pose *= integrate(linear, angular, duration);
+    } else {
+      pose *= integrate(
+        current_sample->has_linear ? current_sample->linear : linear, current_sample->angular,
+        duration);
+    }
+    if ((next_sample != m_twists.end()) && (segment_end == next_sample->stamp)) {
+      current_sample = &(*next_sample);
+      ++next_sample;
+    }
+    segment_begin = segment_end;
+  }
+  anchor.transform = to_message(pose);
+  anchor.header.stamp = ::time_utils::to_message(time_point);
+  return anchor;
+}
+
+void ConstantVelocityInitializer::add_registration_result(const PoseT & pose)
+{
+  if (!m_poses.empty()) {
+    const auto & latest = m_poses.back();
+    if ((latest.header.frame_id != pose.header.frame_id) ||
+      (latest.child_frame_id != pose.child_frame_id))
+    {
+      m_poses.clear();
+    } else if (::time_utils::from_message(pose.header.stamp) <=
+      ::time_utils::from_message(latest.header.stamp))
+    {
+      return;
+    }
+  }
+  m_poses.push_back(pose);
+  if (m_poses.size() > m_config.pose_history_size) {
+    m_poses.pop_front();
+  }
+}
+
+void ConstantVelocityInitializer::add_twist(const geometry_msgs::msg::TwistStamped & twist)
+{
+  add_sample(
+    TwistSample{::time_utils::from_message(twist.header.stamp), to_vector(twist.twist.linear),
+      to_vector(twist.twist.angular), true});
+}
+
+void ConstantVelocityInitializer::add_angular_velocity(
+  const geometry_msgs::msg::Vector3Stamped & angular_velocity)
+{
+  add_sample(
+    TwistSample{::time_utils::from_message(angular_velocity.header.stamp),
+      tf2::Vector3{0.0, 0.0, 0.0}, to_vector(angular_velocity.vector), false});
+}
+
+void ConstantVelocityInitializer::set_fallback_pose(const PoseT & pose)
+{
+  m_poses.clear();
+  Base::set_fallback_pose(pose);
+}
+
+void ConstantVelocityInitializer::add_sample(const TwistSample & sample)
+{
+  if (0U == m_config.twist_history_size) {
+    return;
+  }
+  if ((!m_twists.empty()) && (sample.stamp <= m_twists.back().stamp)) {
+    return;
+  }
+  m_twists.push_back(sample);
+  if (m_twists.size() > m_config.twist_history_size) {
+    m_twists.pop_front();
+  }
+}
+
 }  // namespace localization_common
 }  // namespace localization
 }  // namespace autoware
@@ -24,13 +24,14 @@ namespace localization
 namespace localization_common
 {
 
-OptimizedRegistrationSummary::OptimizedRegistrationSummary(const OptimizationSummary & opt_summary)
-: m_optimization_summary{opt_summary} {}
+OptimizedRegistrationSummary::OptimizedRegistrationSummary(
+  const OptimizationSummary & opt_summary, const std::size_t scan_stride)
+: m_optimization_summary{opt_summary}, m_scan_stride{scan_stride} {}
 
 OptimizedRegistrationSummary::OptimizedRegistrationSummary()
 : m_optimization_summary{OptimizationSummary{std::numeric_limits<float64_t>::max(),
       common::optimization::TerminationType::NO_CONVERGENCE,
-      0}} {}
+      0}}, m_scan_stride{1U} {}
 
 OptimizedRegistrationSummary::OptimizationSummary
 OptimizedRegistrationSummary::optimization_summary() const
@@ -38,6 +39,18 @@ OptimizedRegistrationSummary::optimization_summary() const
   return m_optimization_summary;
 }
 
+std::size_t OptimizedRegistrationSummary::scan_stride() const noexcept
+{
+  return m_scan_stride;
+}
+
+bool8_t OptimizedRegistrationSummary::degraded() const noexcept
+{
+  return (m_scan_stride > 1U) ||
+         (m_optimization_summary.termination_type() ==
+         common::optimization::TerminationType::TIME_BUDGET_EXCEEDED);
+}
+
 }  // namespace localization_common
 }  // namespace localization
 }  // namespace autoware
@@ -17,9 +17,12 @@
 #include <gtest/gtest.h>
 #include <localization_common/initialization.hpp>
 #include <time_utils/time_utils.hpp>
+#include <cmath>
 #include "test_initialization.hpp"
 
 using autoware::localization::localization_common::BestEffortInitializer;
+using autoware::localization::localization_common::ConstantVelocityInitializer;
+using autoware::localization::localization_common::ConstantVelocityInitializerConfig;
 
 class BestEffortInitializationTest : public
   ::testing::TestWithParam<BestEffortInitializerTestParams>
@@ -136,6 +139,148 @@ INSTANTIATE_TEST_CASE_P(
     // cppcheck-suppress syntaxError
   ), );
 
+namespace
+{
+constexpr auto kMapFrame{"map"};
+constexpr auto kBaseFrame{"base_link"};
+
+// Pose at time t on a circle driven with a constant twist, starting at the origin along x.
+geometry_msgs::msg::TransformStamped arc_pose(
+  const std::chrono::system_clock::time_point stamp, const float32_t speed,
+  const float32_t yaw_rate, const float32_t t)
+{
+  auto ret = make_transform(
+    0.0F, 0.0F, yaw_rate * t,
+    (speed / yaw_rate) * std::sin(yaw_rate * t),
+    (speed / yaw_rate) * (1.0F - std::cos(yaw_rate * t)), 0.0F);
+  ret.header.frame_id = kMapFrame;
+  ret.child_frame_id = kBaseFrame;
+  ret.header.stamp = time_utils::to_message(stamp);
+  return ret;
+}
+
+geometry_msgs::msg::TransformStamped line_pose(
+  const std::chrono::system_clock::time_point stamp, const float32_t x)
+{
+  auto ret = make_transform(0.0F, 0.0F, 0.0F, x, 0.0F, 0.0F);
+  ret.header.frame_id = kMapFrame;
+  ret.child_frame_id = kBaseFrame;
+  ret.header.stamp = time_utils::to_message(stamp);
+  return ret;
+}
+// The expected poses are computed in single precision, unlike the prediction
+void check_transform_near(
+  const geometry_msgs::msg::TransformStamped & t1,
+  const geometry_msgs::msg::TransformStamped & t2)
+{
+  constexpr auto tol = 1.0e-5;
+  EXPECT_EQ(t1.header, t2.header);
+  EXPECT_EQ(t1.child_frame_id, t2.child_frame_id);
+  EXPECT_NEAR(t1.transform.translation.x, t2.transform.translation.x, tol);
+  EXPECT_NEAR(t1.transform.translation.y, t2.transform.translation.y, tol);
+  EXPECT_NEAR(t1.transform.translation.z, t2.transform.translation.z, tol);
+  EXPECT_NEAR(t1.transform.rotation.x, t2.transform.rotation.x, tol);
+  EXPECT_NEAR(t1.transform.rotation.y, t2.transform.rotation.y, tol);
+  EXPECT_NEAR(t1.transform.rotation.z, t2.transform.rotation.z, tol);
+  EXPECT_NEAR(t1.transform.rotation.w, t2.transform.rotation.w, tol);
+}
+}  // namespace
+
+TEST(ConstantVelocityInitializationTest, bad_config) {
+  ConstantVelocityInitializerConfig config;
+  config.pose_history_size = 1U;
+  EXPECT_THROW(ConstantVelocityInitializer{config}, std::domain_error);
+}
+
+TEST(ConstantVelocityInitializationTest, best_effort_without_motion) {
+  ConstantVelocityInitializer initializer;
+  const auto now = std::chrono::system_clock::now();
+  constexpr std::chrono::milliseconds dt{100};
+  tf2::BufferCore tf_graph;
+  const auto transform = line_pose(now, 1.0F);
+  tf_graph.setTransform(transform, "testauthority");
+  // A single registration result doesn't tell the motion
+  initializer.add_registration_result(transform);
+  check_transform_eq(transform, initializer.guess(tf_graph, now, kMapFrame, kBaseFrame));
+  check_transform_eq(transform, initializer.guess(tf_graph, now + dt, kMapFrame, kBaseFrame));
+  EXPECT_THROW(initializer.guess(tf_graph, now - dt, kMapFrame, kBaseFrame), std::domain_error);
+}
+
+TEST(ConstantVelocityInitializationTest, constant_twist) {
+  constexpr float32_t speed{10.0F};
+  constexpr float32_t yaw_rate{0.5F};
+  const auto t0 = std::chrono::system_clock::now();
+  constexpr std::chrono::milliseconds dt{100};
+  tf2::BufferCore tf_graph;
+  tf_graph.setTransform(arc_pose(t0, speed, yaw_rate, 0.0F), "testauthority");
+
+  ConstantVelocityInitializer initializer;
+  initializer.add_registration_result(arc_pose(t0, speed, yaw_rate, 0.0F));
+  initializer.add_registration_result(arc_pose(t0 + dt, speed, yaw_rate, 0.1F));
+  // Older results are ignored
+  initializer.add_registration_result(arc_pose(t0 + dt / 2, speed, 0.0F, 0.0F));
+  // The guess continues from the latest registration result, which is newer than the tf graph
+  check_transform_near(
+    arc_pose(t0 + 3 * dt, speed, yaw_rate, 0.3F),
+    initializer.guess(tf_graph, t0 + 3 * dt, kMapFrame, kBaseFrame));
+
+  // The motion is only predicted up to the maximum extrapolation
+  ConstantVelocityInitializerConfig config;
+  config.max_extrapolation = 2 * dt;
+  ConstantVelocityInitializer bounded_initializer{config};
+  bounded_initializer.add_registration_result(arc_pose(t0, speed, yaw_rate, 0.0F));
+  bounded_initializer.add_registration_result(arc_pose(t0 + dt, speed, yaw_rate, 0.1F));
+  auto expected = arc_pose(t0 + 10 * dt, speed, yaw_rate, 0.3F);
+  check_transform_near(
+    expected, bounded_initializer.guess(tf_graph, t0 + 10 * dt, kMapFrame, kBaseFrame));
+
+  // Relocalizing discards the motion
+  bounded_initializer.set_fallback_pose(arc_pose(t0, speed, yaw_rate, 0.0F));
+  check_transform_near(
+    arc_pose(t0, speed, yaw_rate, 0.0F),
+    bounded_initializer.guess(tf_graph, t0 + dt, kMapFrame, kBaseFrame));
+}
+
+TEST(ConstantVelocityInitializationTest, twist_samples) {
+  const auto t0 = std::chrono::system_clock::now();
+  constexpr std::chrono::milliseconds dt{100};
+  tf2::BufferCore tf_graph;
+  tf_graph.setTransform(line_pose(t0, 0.0F), "testauthority");
+  tf_graph.setTransform(line_pose(t0 + dt, 1.0F), "testauthority");
+
+  // Registration results of a straight drive at 10 m/s
+  ConstantVelocityInitializer initializer;
+  initializer.add_registration_result(line_pose(t0, 0.0F));
+  initializer.add_registration_result(line_pose(t0 + dt, 1.0F));
+  check_transform_near(
+    line_pose(t0 + 2 * dt, 2.0F), initializer.guess(tf_graph, t0 + 2 * dt, kMapFrame, kBaseFrame));
+
+  // Odometry reports 5 m/s from the latest pose on, and 20 m/s later
+  geometry_msgs::msg::TwistStamped twist;
+  twist.header.stamp = time_utils::to_message(t0 + dt);
+  twist.twist.linear.x = 5.0;
+  initializer.add_twist(twist);
+  twist.header.stamp = time_utils::to_message(t0 + 2 * dt);
+  twist.twist.linear.x = 20.0;
+  initializer.add_twist(twist);
+  check_transform_near(
+    line_pose(t0 + 3 * dt, 3.5F), initializer.guess(tf_graph, t0 + 3 * dt, kMapFrame, kBaseFrame));
+
+  // The IMU turns the straight drive into an arc from the latest pose on
+  constexpr float32_t yaw_rate{0.5F};
+  ConstantVelocityInitializer imu_initializer;
+  imu_initializer.add_registration_result(line_pose(t0, 0.0F));
+  imu_initializer.add_registration_result(line_pose(t0 + dt, 1.0F));
+  geometry_msgs::msg::Vector3Stamped angular_velocity;
+  angular_velocity.header.stamp = time_utils::to_message(t0 + dt);
+  angular_velocity.vector.z = yaw_rate;
+  imu_initializer.add_angular_velocity(angular_velocity);
+  auto expected = arc_pose(t0 + 3 * dt, 10.0F, yaw_rate, 0.2F);
+  expected.transform.translation.x += 1.0;
+  check_transform_near(
+    expected, imu_initializer.guess(tf_graph, t0 + 3 * dt, kMapFrame, kBaseFrame));
+}
+
 /////////// Helper function implementations:
 
 geometry_msgs::msg::TransformStamped make_transform(
@@ -0,0 +1,111 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#ifndef LOCALIZATION_NODES__LATENCY_TRACKER_HPP_
+#define LOCALIZATION_NODES__LATENCY_TRACKER_HPP_
+
+#include <localization_nodes/visibility_control.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace autoware
+{
+namespace localization
+{
+namespace localization_nodes
+{
+/// Keeps the latencies of the last `window_size` runs of each stage of a processing pipeline in
+/// fixed-size ring buffers. Stages are timed by taking a steady clock timestamp at the start of
+/// a run and at the end of each stage, so recording doesn't allocate. This class is not thread
+/// safe.
+class LOCALIZATION_NODES_PUBLIC LatencyTracker
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  /// Latency statistics of a stage over the samples in its window.
+  struct Statistics
+  {
+    Clock::duration min;
+    Clock::duration mean;
+    Clock::duration p99;
+    std::size_t num_samples;
+  };
+
+  /// Constructor
+  /// \param stage_names Names of the stages. Stages are referred to by their index.
+  /// \param window_size Number of latest samples kept per stage.
+  /// \throws std::domain_error if the window size is 0.
+  LatencyTracker(const std::vector<std::string> & stage_names, std::size_t window_size);
+
+  /// Start a new run. Subsequent stages are timed relative to this point.
+  void start() noexcept;
+
+  /// Get the time since the end of the previous stage of the current run, or since its start,
+  /// and start the next stage. Can be used to split a stage into externally measured parts.
+  /// \return Latency of the current stage.
+  Clock::duration lap() noexcept;
+
+  /// Record the latency of a stage as the time since the end of the previous stage of the
+  /// current run, or since its start.
+  /// \param stage Index of the stage.
+  /// \throws std::out_of_range if the stage doesn't exist.
+  void stamp(std::size_t stage);
+
+  /// Record the time since the start of the current run as the latency of a stage.
+  /// \param stage Index of the stage.
+  /// \throws std::out_of_range if the stage doesn't exist.
+  void stamp_total(std::size_t stage);
+
+  /// Record a latency that was measured externally.
+  /// \param stage Index of the stage.
+  /// \param latency Latency to record.
+  /// \throws std::out_of_range if the stage doesn't exist.
+  void record(std::size_t stage, Clock::duration latency);
+
+  /// Compute the statistics of a stage. All values are zero if no samples were recorded.
+  /// \param stage Index of the stage.
+  /// \return Statistics of the samples in the window of the stage.
+  /// \throws std::out_of_range if the stage doesn't exist.
+  Statistics statistics(std::size_t stage) const;
+
+  /// Get the names of the stages.
+  const std::vector<std::string> & stage_names() const noexcept;
+
+  /// Get the number of samples kept per stage.
+  std::size_t window_size() const noexcept;
+
+private:
+  std::vector<std::string> m_stage_names;
+  std::size_t m_window_size;
+  // Ring buffers of all stages stored back to back.
+  std::vector<Clock::duration> m_samples;
+  std::vector<std::size_t> m_next_sample;
+  std::vector<std::size_t> m_num_samples;
+  Clock::time_point m_run_start{};
+  Clock::time_point m_last_stamp{};
+  // Scratch space to compute the percentiles without allocating.
+  mutable std::vector<Clock::duration> m_sorted_samples;
+};
+
+}  // namespace localization_nodes
+}  // namespace localization
+}  // namespace autoware
+
+#endif  // LOCALIZATION_NODES__LATENCY_TRACKER_HPP_
@@ -24,14 +24,22 @@
 #include <tf2_ros/transform_listener.h>
 #include <tf2_geometry_msgs/tf2_geometry_msgs.h>
 #include <sensor_msgs/msg/point_cloud2.hpp>
+#include <diagnostic_msgs/msg/diagnostic_array.hpp>
+#include <nav_msgs/msg/odometry.hpp>
 #include <time_utils/time_utils.hpp>
 #include <helper_functions/message_adapters.hpp>
 #include <localization_nodes/visibility_control.hpp>
 #include <localization_nodes/constraints.hpp>
+#include <localization_nodes/latency_tracker.hpp>
+#include <localization_nodes/map_double_buffer.hpp>
+#include <localization_nodes/pose_propagator.hpp>
+#include <algorithm>
+#include <chrono>
 #include <memory>
 #include <string>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 namespace autoware
 {
@@ -78,6 +86,27 @@ public:
   // During the experiments, it was found out that running the `tf_listener` in parallel
   // resulted in more robust ndt initialization performance: #868
   static constexpr bool USE_DEDICATED_TF_THREAD{true};
+  /// Default number of observations the latency statistics are computed over.
+  static constexpr std::size_t DEFAULT_LATENCY_WINDOW_SIZE{100U};
+  /// Default number of odometry messages kept to propagate the registration results.
+  static constexpr std::size_t DEFAULT_POSE_HISTORY_SIZE{100U};
+
+  /// Stages of the observation processing whose latencies are tracked.
+  enum class LatencyStage : std::size_t
+  {
+    /// Swapping in and updating the map.
+    MAP_UPDATE = 0U,
+    /// Looking up the initial guess.
+    INITIAL_GUESS,
+    /// Registration time that is not spent in the optimizer, i.e. converting the observation.
+    MESSAGE_CONVERSION,
+    /// Solving the registration problem.
+    OPTIMIZATION,
+    /// Validating and publishing the result.
+    PUBLICATION,
+    /// All of the above.
+    TOTAL
+  };
 
   /// Constructor
   /// \param node_name Name of node
@@ -208,6 +237,12 @@ public:
     return m_pose_publisher;
   }
 
+  /// Get the latencies of the stages of the observation processing.
+  const LatencyTracker & latency_tracker() const noexcept
+  {
+    return m_latency_tracker;
+  }
+
 protected:
   /// Set the localizer.
   /// \param localizer_ptr rvalue to the localizer to set.
@@ -219,6 +254,52 @@ protected:
   void set_map(std::unique_ptr<MapT> && map_ptr)
   {
     m_map_ptr = std::forward<std::unique_ptr<MapT>>(map_ptr);
+    m_map_buffer_ptr.reset();
+  }
+
+  /// Set a double buffered map. Map messages are applied to the back buffer on a background
+  /// thread and the buffers are exchanged before the next observation is registered, so
+  /// registrations keep using the previous map while a new map is being set.
+  /// \param map_ptr rvalue to the map to use for registration.
+  /// \param back_map_ptr rvalue to the map to use as the back buffer. It must be configured
+  /// identically to `map_ptr`.
+  void set_map(std::unique_ptr<MapT> && map_ptr, std::unique_ptr<MapT> && back_map_ptr)
+  {
+    m_map_ptr = std::forward<std::unique_ptr<MapT>>(map_ptr);
+    m_map_buffer_ptr = std::make_unique<MapDoubleBuffer<MapT, MapMsgT>>(
+      std::forward<std::unique_ptr<MapT>>(back_map_ptr));
+  }
+
+  /// Publish the min/mean/p99 latencies of each stage of the observation processing to the
+  /// `/diagnostics` topic periodically.
+  /// \param period Publication period.
+  /// \param window_size Number of latest observations the statistics are computed over. The
+  /// recorded latencies are reset.
+  void enable_latency_diagnostics(
+    const std::chrono::milliseconds period,
+    const std::size_t window_size = DEFAULT_LATENCY_WINDOW_SIZE)
+  {
+    m_latency_tracker = LatencyTracker{latency_stage_names(), window_size};
+    m_latency_publisher = create_publisher<diagnostic_msgs::msg::DiagnosticArray>(
+      "/diagnostics", rclcpp::QoS{rclcpp::KeepLast{10}});
+    m_latency_timer = create_wall_timer(period, [this] {publish_latency_diagnostics();});
+  }
+
+  /// Propagate the registration results with the odometry received on the `odometry_in` topic
+  /// and publish the propagated pose on the `ndt_pose_propagated` topic at the odometry rate,
+  /// stamped with the odometry. The odometry has to describe the frame of the observations.
+  /// The covariance is the one of the latest registration result.
+  /// \param history_size Number of latest odometry messages kept, which has to cover the
+  /// latency of the registration.
+  /// \throws std::domain_error if the history size is 0.
+  void enable_pose_propagation(const std::size_t history_size = DEFAULT_POSE_HISTORY_SIZE)
+  {
+    m_pose_propagator_ptr = std::make_unique<PosePropagator>(history_size);
+    m_propagated_pose_publisher = create_publisher<PoseWithCovarianceStamped>(
+      "ndt_pose_propagated", rclcpp::QoS{rclcpp::KeepLast{10}});
+    m_odometry_sub = create_subscription<nav_msgs::msg::Odometry>(
+      "odometry_in", rclcpp::QoS{rclcpp::KeepLast{10}},
+      [this](const nav_msgs::msg::Odometry::ConstSharedPtr msg) {odometry_callback(msg);});
   }
 
   /// Handle the exceptions during registration.
@@ -265,6 +346,22 @@ protected:
   }
 
 
+  /// Update the map in place before an observation is registered, e.g. with streamed map
+  /// tiles. By default does nothing.
+  /// \param map Map to update.
+  virtual void update_map(MapT & map)
+  {
+    (void) map;
+  }
+
+  /// Called with every new pose estimate of the vehicle in the map frame, i.e. with each
+  /// published registration result and each initial pose. By default does nothing.
+  /// \param pose Latest pose estimate.
+  virtual void on_pose_update(const geometry_msgs::msg::Pose & pose)
+  {
+    (void) pose;
+  }
+
   /// Validate the pose estimate given the registration summary and the initial guess.
   /// This function by default returns true.
   /// \param summary Registration summary.
@@ -302,6 +399,71 @@ private:
     if (declare_parameter("load_initial_pose_from_parameters", false)) {
       m_pose_initializer.set_fallback_pose(get_initial_pose());
     }
+    const auto latency_period_ms =
+      declare_parameter("latency_diagnostics.period_ms", int64_t{0});
+    if (latency_period_ms > 0) {
+      enable_latency_diagnostics(
+        std::chrono::milliseconds{latency_period_ms},
+        static_cast<std::size_t>(
+          declare_parameter(
+            "latency_diagnostics.window_size",
+            static_cast<int64_t>(DEFAULT_LATENCY_WINDOW_SIZE))));
+    }
+    const auto pose_history_size =
+      declare_parameter("pose_propagation.history_size", int64_t{0});
+    if (pose_history_size > 0) {
+      enable_pose_propagation(static_cast<std::size_t>(pose_history_size));
+    }
+  }
+
+  static std::vector<std::string> latency_stage_names()
+  {
+    return {"map_update", "initial_guess", "message_conversion", "optimization", "publication",
+      "total"};
+  }
+
+  void record_latency(const LatencyStage stage, const LatencyTracker::Clock::duration latency)
+  {
+    m_latency_tracker.record(static_cast<std::size_t>(stage), latency);
+  }
+
+  void stamp_latency(const LatencyStage stage)
+  {
+    m_latency_tracker.stamp(static_cast<std::size_t>(stage));
+  }
+
+  /// Publish the latency statistics of all stages as one diagnostic status per stage.
+  void publish_latency_diagnostics()
+  {
+    const auto to_ms = [](const LatencyTracker::Clock::duration latency) {
+        return std::to_string(
+          std::chrono::duration_cast<std::chrono::duration<float64_t, std::milli>>(latency).
+          count());
+      };
+    const auto key_value = [](const std::string & key, const std::string & value) {
+        diagnostic_msgs::msg::KeyValue key_value_msg;
+        key_value_msg.key = key;
+        key_value_msg.value = value;
+        return key_value_msg;
+      };
+
+    diagnostic_msgs::msg::DiagnosticArray diagnostics;
+    diagnostics.header.stamp = now();
+    const auto & stage_names = m_latency_tracker.stage_names();
+    for (std::size_t stage = 0U; stage < stage_names.size(); ++stage) {
+      const auto statistics = m_latency_tracker.statistics(stage);
+      diagnostic_msgs::msg::DiagnosticStatus status;
+      status.level = diagnostic_msgs::msg::DiagnosticStatus::OK;
+      status.name = std::string{get_name()} + ": " + stage_names[stage] + " latency";
+      status.message = "Latency over the last " + std::to_string(statistics.num_samples) +
+        " observations";
+      status.values.push_back(key_value("min_ms", to_ms(statistics.min)));
+      status.values.push_back(key_value("mean_ms", to_ms(statistics.mean)));
+      status.values.push_back(key_value("p99_ms", to_ms(statistics.p99)));
+      status.values.push_back(key_value("num_samples", std::to_string(statistics.num_samples)));
+      diagnostics.status.push_back(status);
+    }
+    m_latency_publisher->publish(diagnostics);
   }
 
   geometry_msgs::msg::TransformStamped get_initial_pose()
@@ -332,6 +494,17 @@ private:
     assert_ptr_not_null(m_localizer_ptr, "localizer");
     assert_ptr_not_null(m_map_ptr, "map");
 
+    m_latency_tracker.start();
+    try {
+      if (m_map_buffer_ptr) {
+        (void) m_map_buffer_ptr->try_swap(m_map_ptr);
+      }
+      update_map(*m_map_ptr);
+    } catch (...) {
+      on_bad_map(std::current_exception());
+    }
+    stamp_latency(LatencyStage::MAP_UPDATE);
+
     if (!m_map_ptr->valid()) {
       on_observation_with_invalid_map(msg_ptr);
       return;
@@ -344,11 +517,25 @@ private:
     try {
       geometry_msgs::msg::TransformStamped initial_guess = m_pose_initializer.guess(
         m_tf_buffer, observation_time, map_frame, observation_frame);
+      stamp_latency(LatencyStage::INITIAL_GUESS);
       RegistrationSummary summary{};
       const auto pose_out =
         m_localizer_ptr->register_measurement(*msg_ptr, initial_guess, *m_map_ptr, &summary);
+      // The optimizer measures its own duration, the rest of the registration is spent on
+      // preparing the observation.
+      const auto registration_latency = m_latency_tracker.lap();
+      const auto optimization_latency = std::min(
+        std::chrono::duration_cast<LatencyTracker::Clock::duration>(
+          summary.optimization_summary().total_duration()), registration_latency);
+      record_latency(LatencyStage::MESSAGE_CONVERSION, registration_latency - optimization_latency);
+      record_latency(LatencyStage::OPTIMIZATION, optimization_latency);
       if (validate_output(summary, pose_out, initial_guess)) {
         m_pose_publisher->publish(pose_out);
+        m_pose_initializer.add_registration_result(
+          to_transform(pose_out, observation_frame));
+        if (m_pose_propagator_ptr) {
+          anchor_propagation(pose_out, observation_time, observation_frame);
+        }
         // This is to be used when no state estimator or alternative source of
         // localization is available.
         if (m_tf_publisher) {
@@ -363,9 +550,12 @@ private:
         }
 
         handle_registration_summary(summary);
+        on_pose_update(pose_out.pose.pose);
       } else {
         on_invalid_output(pose_out);
       }
+      stamp_latency(LatencyStage::PUBLICATION);
+      m_latency_tracker.stamp_total(static_cast<std::size_t>(LatencyStage::TOTAL));
     } catch (...) {
       on_bad_registration(std::current_exception());
     }
@@ -376,6 +566,10 @@ private:
   void map_callback(typename MapMsgT::ConstSharedPtr msg_ptr)
   {
     assert_ptr_not_null(m_map_ptr, "map");
+    if (m_map_buffer_ptr) {
+      m_map_buffer_ptr->update(msg_ptr);
+      return;
+    }
     try {
       m_map_ptr->set(*msg_ptr);
     } catch (...) {
@@ -383,6 +577,59 @@ private:
     }
   }
 
+  /// Callback that propagates the latest registration result with each odometry message and
+  /// publishes the result.
+  /// \param msg_ptr Pointer to the odometry message.
+  void odometry_callback(const nav_msgs::msg::Odometry::ConstSharedPtr msg_ptr)
+  {
+    m_odometry_child_frame = msg_ptr->child_frame_id;
+    if (!m_pose_propagator_ptr->add_odometry(
+        ::time_utils::from_message(msg_ptr->header.stamp), msg_ptr->pose.pose))
+    {
+      RCLCPP_WARN(get_logger(), "Received odometry out of order, ignoring the message.");
+      return;
+    }
+    if (m_pose_propagator_ptr->propagate(m_propagated_pose_msg.pose.pose)) {
+      m_propagated_pose_msg.header.stamp = msg_ptr->header.stamp;
+      m_propagated_pose_publisher->publish(m_propagated_pose_msg);
+    }
+  }
+
+  /// Anchor the odometry on a registration result.
+  void anchor_propagation(
+    const PoseWithCovarianceStamped & pose_msg, const tf2::TimePoint observation_time,
+    const std::string & observation_frame)
+  {
+    if (!m_odometry_child_frame.empty() && (m_odometry_child_frame != observation_frame)) {
+      RCLCPP_WARN(
+        get_logger(), "The odometry describes %s instead of %s, not propagating the pose.",
+        m_odometry_child_frame.c_str(), observation_frame.c_str());
+      return;
+    }
+    if (m_pose_propagator_ptr->set_registration(observation_time, pose_msg.pose.pose)) {
+      m_propagated_pose_msg.header.frame_id = pose_msg.header.frame_id;
+      m_propagated_pose_msg.pose.covariance = pose_msg.pose.covariance;
+    } else {
+      RCLCPP_WARN(
+        get_logger(), "The registration result is older than the kept odometry, "
+        "not propagating it. Increase pose_propagation.history_size.");
+    }
+  }
+
+  /// Convert a registration result into the transform it estimates.
+  static geometry_msgs::msg::TransformStamped to_transform(
+    const PoseWithCovarianceStamped & pose_msg, const std::string & child_frame_id)
+  {
+    const auto & pose = pose_msg.pose.pose;
+    geometry_msgs::msg::TransformStamped ret;
+    ret.header = pose_msg.header;
+    ret.child_frame_id = child_frame_id;
+    ret.transform.translation.set__x(pose.position.x).set__y(pose.position.y).
+    set__z(pose.position.z);
+    ret.transform.rotation = pose.orientation;
+    return ret;
+  }
+
   /// Publish the pose message as a transform.
   void publish_tf(const PoseWithCovarianceStamped & pose_msg)
   {
@@ -473,10 +720,18 @@ private:
     // We'd need to know the current time before it can be published, and set the
     // time in the header to a recent time.
     m_pose_initializer.set_fallback_pose(transformed_pose_stamped);
+
+    geometry_msgs::msg::Pose initial_pose;
+    initial_pose.position.x = transformed_pose_stamped.transform.translation.x;
+    initial_pose.position.y = transformed_pose_stamped.transform.translation.y;
+    initial_pose.position.z = transformed_pose_stamped.transform.translation.z;
+    initial_pose.orientation = transformed_pose_stamped.transform.rotation;
+    on_pose_update(initial_pose);
   }
 
   std::unique_ptr<LocalizerT> m_localizer_ptr;
   std::unique_ptr<MapT> m_map_ptr;
+  std::unique_ptr<MapDoubleBuffer<MapT, MapMsgT>> m_map_buffer_ptr{nullptr};
   PoseInitializerT m_pose_initializer;
   tf2::BufferCore m_tf_buffer;
   tf2_ros::TransformListener m_tf_listener;
@@ -489,12 +744,33 @@ private:
 
   // Receive updates from "/initialpose" (e.g. rviz2)
   typename rclcpp::Subscription<PoseWithCovarianceStamped>::SharedPtr m_initial_pose_sub;
+
+  // The latencies are only accessed by the callbacks of the node, which are mutually exclusive.
+  LatencyTracker m_latency_tracker{latency_stage_names(), DEFAULT_LATENCY_WINDOW_SIZE};
+  rclcpp::Publisher<diagnostic_msgs::msg::DiagnosticArray>::SharedPtr m_latency_publisher{
+    nullptr};
+  rclcpp::TimerBase::SharedPtr m_latency_timer{nullptr};
+
+  std::unique_ptr<PosePropagator> m_pose_propagator_ptr{nullptr};
+  std::string m_odometry_child_frame{};
+  PoseWithCovarianceStamped m_propagated_pose_msg{};
+  typename rclcpp::Publisher<PoseWithCovarianceStamped>::SharedPtr m_propagated_pose_publisher{
+    nullptr};
+  rclcpp::Subscription<nav_msgs::msg::Odometry>::SharedPtr m_odometry_sub{nullptr};
 };
 
 template<typename ObservationMsgT, typename MapMsgT, typename MapT, typename LocalizerT,
   typename PoseInitializerT, Requires R1, Requires R2>
 constexpr bool RelativeLocalizerNode<ObservationMsgT, MapMsgT, MapT,
   LocalizerT, PoseInitializerT, R1, R2>::USE_DEDICATED_TF_THREAD;
+template<typename ObservationMsgT, typename MapMsgT, typename MapT, typename LocalizerT,
+  typename PoseInitializerT, Requires R1, Requires R2>
+constexpr std::size_t RelativeLocalizerNode<ObservationMsgT, MapMsgT, MapT,
+  LocalizerT, PoseInitializerT, R1, R2>::DEFAULT_LATENCY_WINDOW_SIZE;
+template<typename ObservationMsgT, typename MapMsgT, typename MapT, typename LocalizerT,
+  typename PoseInitializerT, Requires R1, Requires R2>
+constexpr std::size_t RelativeLocalizerNode<ObservationMsgT, MapMsgT, MapT,
+  LocalizerT, PoseInitializerT, R1, R2>::DEFAULT_POSE_HISTORY_SIZE;
 }  // namespace localization_nodes
 }  // namespace localization
 }  // namespace autoware
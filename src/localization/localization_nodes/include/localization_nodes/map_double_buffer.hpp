@@ -0,0 +1,186 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#ifndef LOCALIZATION_NODES__MAP_DOUBLE_BUFFER_HPP_
+#define LOCALIZATION_NODES__MAP_DOUBLE_BUFFER_HPP_
+
+#include <common/types.hpp>
+#include <localization_nodes/visibility_control.hpp>
+
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace autoware
+{
+namespace localization
+{
+namespace localization_nodes
+{
+using autoware::common::types::bool8_t;
+
+/// Applies map messages to a back buffer map on a background thread so that the map in use
+/// (the front buffer) stays untouched until the update is complete. The owner of the front
+/// buffer exchanges both maps via `try_swap(...)` at a point where the front buffer is not in
+/// use, so registrations never see a partially updated map. After a swap, the previous front
+/// buffer is brought up to date in the background, so maps that support incremental updates
+/// only apply the difference to the latest message.
+/// \tparam MapT Map type. Must provide `set(const MapMsgT &)`.
+/// \tparam MapMsgT Map message type.
+template<typename MapT, typename MapMsgT>
+class LOCALIZATION_NODES_PUBLIC MapDoubleBuffer
+{
+public:
+  using MapMsgConstPtr = typename MapMsgT::ConstSharedPtr;
+
+  /// Constructor. Starts the background thread.
+  /// \param back_map_ptr Map to use as the back buffer. It must be configured identically to the
+  /// front buffer.
+  /// \throws std::domain_error if the map is null.
+  explicit MapDoubleBuffer(std::unique_ptr<MapT> && back_map_ptr)
+  : m_back_map_ptr{std::move(back_map_ptr)}
+  {
+    if (!m_back_map_ptr) {
+      throw std::domain_error("MapDoubleBuffer: Back buffer map must not be null.");
+    }
+    m_thread = std::thread{[this] {run();}};
+  }
+
+  /// Destructor. Stops the background thread after the current update finished.
+  ~MapDoubleBuffer()
+  {
+    {
+      std::lock_guard<std::mutex> lock{m_mutex};
+      m_stop = true;
+    }
+    m_wake_up.notify_one();
+    if (m_thread.joinable()) {
+      m_thread.join();
+    }
+  }
+
+  MapDoubleBuffer(const MapDoubleBuffer &) = delete;
+  MapDoubleBuffer & operator=(const MapDoubleBuffer &) = delete;
+  MapDoubleBuffer(MapDoubleBuffer &&) = delete;
+  MapDoubleBuffer & operator=(MapDoubleBuffer &&) = delete;
+
+  /// Queue a new map message. This call doesn't block; only the latest message is applied if the
+  /// background thread is busy.
+  /// \param msg_ptr Map message.
+  void update(const MapMsgConstPtr & msg_ptr)
+  {
+    {
+      std::lock_guard<std::mutex> lock{m_mutex};
+      m_latest_msg = msg_ptr;
+    }
+    m_wake_up.notify_one();
+  }
+
+  /// Exchange the given front buffer with the back buffer if the back buffer holds a newer map.
+  /// Rethrows errors that occurred while applying a map message.
+  /// \param front_map_ptr Front buffer map.
+  /// \return True if the maps were exchanged.
+  bool8_t try_swap(std::unique_ptr<MapT> & front_map_ptr)
+  {
+    std::unique_lock<std::mutex> lock{m_mutex};
+    if (m_error) {
+      std::exception_ptr error{nullptr};
+      std::swap(error, m_error);
+      std::rethrow_exception(error);
+    }
+    if (m_busy || !m_back_msg || (m_back_msg == m_front_msg)) {
+      return false;
+    }
+    std::swap(front_map_ptr, m_back_map_ptr);
+    std::swap(m_front_msg, m_back_msg);
+    lock.unlock();
+    // The new back buffer holds the previous map and is resynchronized with the latest message.
+    m_wake_up.notify_one();
+    return true;
+  }
+
+  /// Block until the back buffer reflects the latest message or applying it failed.
+  void wait_until_idle()
+  {
+    std::unique_lock<std::mutex> lock{m_mutex};
+    m_idle.wait(lock, [this] {return !m_busy && !needs_update();});
+  }
+
+private:
+  /// Check if the back buffer has to be updated. Must be called with the lock held.
+  bool8_t needs_update() const noexcept
+  {
+    return m_latest_msg && (m_latest_msg != m_back_msg) && (m_latest_msg != m_failed_msg);
+  }
+
+  /// Main loop of the background thread.
+  void run()
+  {
+    std::unique_lock<std::mutex> lock{m_mutex};
+    while (true) {
+      m_wake_up.wait(lock, [this] {return m_stop || needs_update();});
+      if (m_stop) {
+        return;
+      }
+      const auto msg_ptr = m_latest_msg;
+      m_busy = true;
+      lock.unlock();
+      std::exception_ptr error{nullptr};
+      try {
+        m_back_map_ptr->set(*msg_ptr);
+      } catch (...) {
+        error = std::current_exception();
+      }
+      lock.lock();
+      if (error) {
+        // The back buffer is in an unknown state and is not swapped in until a new message
+        // was applied successfully.
+        m_error = error;
+        m_failed_msg = msg_ptr;
+        m_back_msg = nullptr;
+      } else {
+        m_back_msg = msg_ptr;
+      }
+      m_busy = false;
+      m_idle.notify_all();
+    }
+  }
+
+  // The back buffer is only accessed by the background thread while `m_busy` is set.
+  std::unique_ptr<MapT> m_back_map_ptr;
+  std::mutex m_mutex{};
+  std::condition_variable m_wake_up{};
+  std::condition_variable m_idle{};
+  // Messages are identified by their pointers.
+  MapMsgConstPtr m_latest_msg{nullptr};
+  MapMsgConstPtr m_front_msg{nullptr};
+  MapMsgConstPtr m_back_msg{nullptr};
+  MapMsgConstPtr m_failed_msg{nullptr};
+  bool8_t m_busy{false};
+  bool8_t m_stop{false};
+  std::exception_ptr m_error{nullptr};
+  std::thread m_thread;
+};
+
+}  // namespace localization_nodes
+}  // namespace localization
+}  // namespace autoware
+
+#endif  // LOCALIZATION_NODES__MAP_DOUBLE_BUFFER_HPP_
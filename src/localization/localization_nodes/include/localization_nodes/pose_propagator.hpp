@@ -0,0 +1,107 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#ifndef LOCALIZATION_NODES__POSE_PROPAGATOR_HPP_
+#define LOCALIZATION_NODES__POSE_PROPAGATOR_HPP_
+
+#include <common/types.hpp>
+#include <geometry_msgs/msg/pose.hpp>
+#include <localization_nodes/visibility_control.hpp>
+#include <tf2/LinearMath/Transform.h>
+#include <tf2/time.h>
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace autoware
+{
+namespace localization
+{
+namespace localization_nodes
+{
+using autoware::common::types::bool8_t;
+
+/// Propagates the latest registration result with the odometry received since, so that a pose
+/// in the map frame is available at the odometry rate and without the latency of the
+/// registration. The odometry poses of the last `history_size` messages are kept in a
+/// fixed-size ring buffer. A registration result anchors the odometry: the odometry pose at the
+/// time of the registered observation is interpolated from the ring buffer, and the propagated
+/// pose is the registration result moved by the odometry since that time. The odometry has to
+/// describe the frame of the registered observations. This class is not thread safe.
+class LOCALIZATION_NODES_PUBLIC PosePropagator
+{
+public:
+  /// Constructor
+  /// \param history_size Number of latest odometry poses kept. It has to cover the latency of
+  /// the registration.
+  /// \throws std::domain_error if the history size is 0.
+  explicit PosePropagator(std::size_t history_size);
+
+  /// Add an odometry pose. Resolves a pending registration result once the odometry reaches
+  /// its stamp.
+  /// \param stamp Stamp of the odometry pose.
+  /// \param odometry_pose Pose in the odometry frame.
+  /// \return False if the pose is not newer than the latest one and was ignored.
+  bool8_t add_odometry(const tf2::TimePoint stamp, const geometry_msgs::msg::Pose & odometry_pose);
+
+  /// Anchor the odometry on a registration result. A result newer than the latest odometry
+  /// pose is kept pending until the odometry reaches it, while the previous anchor stays in use.
+  /// \param stamp Stamp of the registered observation.
+  /// \param map_pose Registered pose in the map frame.
+  /// \return False if the result is older than the kept odometry poses and was ignored.
+  bool8_t set_registration(const tf2::TimePoint stamp, const geometry_msgs::msg::Pose & map_pose);
+
+  /// Get the pose in the map frame at the stamp of the latest odometry pose.
+  /// \param[out] map_pose Propagated pose.
+  /// \return False if there is no odometry pose or no registration result anchored yet, in
+  /// which case the pose is not modified.
+  bool8_t propagate(geometry_msgs::msg::Pose & map_pose) const;
+
+  /// Get the stamp of the latest odometry pose, or the epoch if there is none.
+  tf2::TimePoint latest_stamp() const noexcept;
+
+  /// Get the number of kept odometry poses.
+  std::size_t size() const noexcept;
+
+  /// Drop all odometry poses and registration results, e.g. after a jump of the odometry.
+  void reset() noexcept;
+
+private:
+  using StampedTransform = std::pair<tf2::TimePoint, tf2::Transform>;
+
+  /// Get a kept odometry pose, 0 being the oldest one.
+  const StampedTransform & at(const std::size_t index) const;
+  /// Interpolate the odometry at a stamp within the kept poses.
+  tf2::Transform interpolate(const tf2::TimePoint stamp) const;
+  /// Anchor the odometry on a registration result within the kept poses.
+  void anchor(const tf2::TimePoint stamp, const tf2::Transform & map_transform);
+
+  std::vector<StampedTransform> m_history;
+  std::size_t m_next{0U};
+  std::size_t m_size{0U};
+  /// Transform from the odometry frame to the map frame of the anchored registration result.
+  tf2::Transform m_correction{};
+  bool8_t m_anchored{false};
+  StampedTransform m_pending{};
+  bool8_t m_has_pending{false};
+};
+
+}  // namespace localization_nodes
+}  // namespace localization
+}  // namespace autoware
+
+#endif  // LOCALIZATION_NODES__POSE_PROPAGATOR_HPP_
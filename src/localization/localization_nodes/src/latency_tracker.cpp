@@ -0,0 +1,119 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#include <localization_nodes/latency_tracker.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace autoware
+{
+namespace localization
+{
+namespace localization_nodes
+{
+LatencyTracker::LatencyTracker(
+  const std::vector<std::string> & stage_names,
+  const std::size_t window_size)
+: m_stage_names{stage_names},
+  m_window_size{window_size},
+  m_samples(stage_names.size() * window_size, Clock::duration::zero()),
+  m_next_sample(stage_names.size(), 0U),
+  m_num_samples(stage_names.size(), 0U)
+{
+  if (m_window_size == 0U) {
+    throw std::domain_error("LatencyTracker: Window size must be positive.");
+  }
+  m_sorted_samples.reserve(m_window_size);
+}
+
+void LatencyTracker::start() noexcept
+{
+  m_run_start = Clock::now();
+  m_last_stamp = m_run_start;
+}
+
+LatencyTracker::Clock::duration LatencyTracker::lap() noexcept
+{
+  const auto now = Clock::now();
+  const auto latency = now - m_last_stamp;
+  m_last_stamp = now;
+  return latency;
+}
+
+void LatencyTracker::stamp(const std::size_t stage)
+{
+  record(stage, lap());
+}
+
+void LatencyTracker::stamp_total(const std::size_t stage)
+{
+  record(stage, Clock::now() - m_run_start);
+}
+
+void LatencyTracker::record(const std::size_t stage, const Clock::duration latency)
+{
+  if (stage >= m_stage_names.size()) {
+    throw std::out_of_range("LatencyTracker: Stage " + std::to_string(stage) + " doesn't exist.");
+  }
+  auto & next_sample = m_next_sample[stage];
+  m_samples[(stage * m_window_size) + next_sample] = latency;
+  next_sample = (next_sample + 1U) % m_window_size;
+  m_num_samples[stage] = std::min(m_num_samples[stage] + 1U, m_window_size);
+}
+
+LatencyTracker::Statistics LatencyTracker::statistics(const std::size_t stage) const
+{
+  if (stage >= m_stage_names.size()) {
+    throw std::out_of_range("LatencyTracker: Stage " + std::to_string(stage) + " doesn't exist.");
+  }
+  const auto num_samples = m_num_samples[stage];
+  if (num_samples == 0U) {
+    return Statistics{Clock::duration::zero(), Clock::duration::zero(), Clock::duration::zero(),
+      0U};
+  }
+  // The ring buffer is filled from its start, so the samples are always at the front.
+  const auto begin = m_samples.begin() + static_cast<std::ptrdiff_t>(stage * m_window_size);
+  m_sorted_samples.assign(begin, begin + static_cast<std::ptrdiff_t>(num_samples));
+
+  Clock::duration sum{Clock::duration::zero()};
+  for (const auto & sample : m_sorted_samples) {
+    sum += sample;
+  }
+  // Nearest-rank percentile.
+  const auto p99_rank = ((99U * num_samples) + 99U) / 100U;
+  const auto p99_it = m_sorted_samples.begin() + static_cast<std::ptrdiff_t>(p99_rank - 1U);
+  std::nth_element(m_sorted_samples.begin(), p99_it, m_sorted_samples.end());
+  const auto p99 = *p99_it;
+  const auto min = *std::min_element(m_sorted_samples.begin(), p99_it + 1);
+  return Statistics{min, sum / static_cast<Clock::rep>(num_samples), p99, num_samples};
+}
+
+const std::vector<std::string> & LatencyTracker::stage_names() const noexcept
+{
+  return m_stage_names;
+}
+
+std::size_t LatencyTracker::window_size() const noexcept
+{
+  return m_window_size;
+}
+
+}  // namespace localization_nodes
+}  // namespace localization
+}  // namespace autoware
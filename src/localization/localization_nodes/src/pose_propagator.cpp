@@ -0,0 +1,160 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#include <localization_nodes/pose_propagator.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+namespace autoware
+{
+namespace localization
+{
+namespace localization_nodes
+{
+namespace
+{
+using autoware::common::types::float64_t;
+
+tf2::Transform to_transform(const geometry_msgs::msg::Pose & pose)
+{
+  return tf2::Transform{
+    tf2::Quaternion{pose.orientation.x, pose.orientation.y, pose.orientation.z,
+      pose.orientation.w},
+    tf2::Vector3{pose.position.x, pose.position.y, pose.position.z}};
+}
+
+geometry_msgs::msg::Pose to_pose(const tf2::Transform & transform)
+{
+  geometry_msgs::msg::Pose pose;
+  const auto & translation = transform.getOrigin();
+  const auto rotation = transform.getRotation();
+  pose.position.set__x(translation.x()).set__y(translation.y()).set__z(translation.z());
+  pose.orientation.set__x(rotation.x()).set__y(rotation.y()).set__z(rotation.z()).
+  set__w(rotation.w());
+  return pose;
+}
+}  // namespace
+
+PosePropagator::PosePropagator(const std::size_t history_size)
+: m_history(history_size)
+{
+  if (history_size == 0U) {
+    throw std::domain_error("PosePropagator: History size must be positive.");
+  }
+}
+
+bool8_t PosePropagator::add_odometry(
+  const tf2::TimePoint stamp,
+  const geometry_msgs::msg::Pose & odometry_pose)
+{
+  if ((m_size > 0U) && (stamp <= latest_stamp())) {
+    return false;
+  }
+  m_history[m_next] = StampedTransform{stamp, to_transform(odometry_pose)};
+  m_next = (m_next + 1U) % m_history.size();
+  m_size = std::min(m_size + 1U, m_history.size());
+
+  if (m_has_pending && (m_pending.first <= stamp)) {
+    m_has_pending = false;
+    // The pending result can only fall out of the history if it holds a single pose.
+    if (at(0U).first <= m_pending.first) {
+      anchor(m_pending.first, m_pending.second);
+    }
+  }
+  return true;
+}
+
+bool8_t PosePropagator::set_registration(
+  const tf2::TimePoint stamp,
+  const geometry_msgs::msg::Pose & map_pose)
+{
+  if ((m_size == 0U) || (stamp > latest_stamp())) {
+    m_pending = StampedTransform{stamp, to_transform(map_pose)};
+    m_has_pending = true;
+    return true;
+  }
+  if (stamp < at(0U).first) {
+    return false;
+  }
+  anchor(stamp, to_transform(map_pose));
+  return true;
+}
+
+bool8_t PosePropagator::propagate(geometry_msgs::msg::Pose & map_pose) const
+{
+  if (!m_anchored || (m_size == 0U)) {
+    return false;
+  }
+  map_pose = to_pose(m_correction * at(m_size - 1U).second);
+  return true;
+}
+
+tf2::TimePoint PosePropagator::latest_stamp() const noexcept
+{
+  if (m_size == 0U) {
+    return tf2::TimePoint{};
+  }
+  return m_history[(m_next + m_history.size() - 1U) % m_history.size()].first;
+}
+
+std::size_t PosePropagator::size() const noexcept
+{
+  return m_size;
+}
+
+void PosePropagator::reset() noexcept
+{
+  m_next = 0U;
+  m_size = 0U;
+  m_anchored = false;
+  m_has_pending = false;
+}
+
+const PosePropagator::StampedTransform & PosePropagator::at(const std::size_t index) const
+{
+  return m_history[(m_next + m_history.size() - m_size + index) % m_history.size()];
+}
+
+tf2::Transform PosePropagator::interpolate(const tf2::TimePoint stamp) const
+{
+  for (auto index = m_size - 1U; index > 0U; --index) {
+    const auto & before = at(index - 1U);
+    if (before.first > stamp) {
+      continue;
+    }
+    const auto & after = at(index);
+    const auto ratio =
+      std::chrono::duration_cast<std::chrono::duration<float64_t>>(stamp - before.first).count() /
+      std::chrono::duration_cast<std::chrono::duration<float64_t>>(
+      after.first - before.first).count();
+    return tf2::Transform{
+      before.second.getRotation().slerp(after.second.getRotation(), ratio),
+      before.second.getOrigin().lerp(after.second.getOrigin(), ratio)};
+  }
+  return at(0U).second;
+}
+
+void PosePropagator::anchor(const tf2::TimePoint stamp, const tf2::Transform & map_transform)
+{
+  m_correction = map_transform * interpolate(stamp).inverse();
+  m_anchored = true;
+}
+
+}  // namespace localization_nodes
+}  // namespace localization
+}  // namespace autoware
@@ -0,0 +1,78 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#include <gtest/gtest.h>
+#include <localization_nodes/latency_tracker.hpp>
+
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using autoware::localization::localization_nodes::LatencyTracker;
+using std::chrono::milliseconds;
+
+TEST(LatencyTrackerTest, statistics) {
+  LatencyTracker tracker{{"first", "second"}, 100U};
+  EXPECT_EQ(tracker.stage_names(), (std::vector<std::string>{"first", "second"}));
+  EXPECT_EQ(tracker.window_size(), 100U);
+
+  const auto empty = tracker.statistics(0U);
+  EXPECT_EQ(empty.num_samples, 0U);
+  EXPECT_EQ(empty.min, LatencyTracker::Clock::duration::zero());
+  EXPECT_EQ(empty.mean, LatencyTracker::Clock::duration::zero());
+  EXPECT_EQ(empty.p99, LatencyTracker::Clock::duration::zero());
+
+  // Record 1ms ... 100ms in reverse order.
+  for (auto i = 100; i > 0; --i) {
+    tracker.record(0U, milliseconds{i});
+  }
+  auto statistics = tracker.statistics(0U);
+  EXPECT_EQ(statistics.num_samples, 100U);
+  EXPECT_EQ(statistics.min, milliseconds{1});
+  EXPECT_EQ(statistics.mean, std::chrono::microseconds{50500});
+  EXPECT_EQ(statistics.p99, milliseconds{99});
+  EXPECT_EQ(tracker.statistics(1U).num_samples, 0U);
+
+  // The oldest samples are overwritten once the window is full.
+  for (auto i = 0; i < 50; ++i) {
+    tracker.record(0U, milliseconds{200});
+  }
+  statistics = tracker.statistics(0U);
+  EXPECT_EQ(statistics.num_samples, 100U);
+  EXPECT_EQ(statistics.min, milliseconds{1});
+  EXPECT_EQ(statistics.p99, milliseconds{200});
+  EXPECT_EQ(statistics.mean, std::chrono::microseconds{100000 + 12750});
+
+  EXPECT_THROW(tracker.record(2U, milliseconds{1}), std::out_of_range);
+  EXPECT_THROW(tracker.statistics(2U), std::out_of_range);
+  EXPECT_THROW(LatencyTracker({"first"}, 0U), std::domain_error);
+}
+
+TEST(LatencyTrackerTest, stamps) {
+  LatencyTracker tracker{{"first", "second", "total"}, 10U};
+  tracker.start();
+  tracker.stamp(0U);
+  const auto lap = tracker.lap();
+  tracker.record(1U, lap);
+  tracker.stamp_total(2U);
+
+  for (auto stage = 0U; stage < 3U; ++stage) {
+    EXPECT_EQ(tracker.statistics(stage).num_samples, 1U);
+  }
+  EXPECT_EQ(tracker.statistics(1U).min, lap);
+  EXPECT_GE(tracker.statistics(2U).min, tracker.statistics(0U).min + lap);
+}
@@ -0,0 +1,115 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#include <gtest/gtest.h>
+#include <localization_nodes/pose_propagator.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+using autoware::localization::localization_nodes::PosePropagator;
+using std::chrono::milliseconds;
+
+namespace
+{
+/// Pose at a position with a heading.
+geometry_msgs::msg::Pose make_pose(const double x, const double y, const double yaw)
+{
+  geometry_msgs::msg::Pose pose;
+  pose.position.x = x;
+  pose.position.y = y;
+  pose.orientation.z = std::sin(yaw / 2.0);
+  pose.orientation.w = std::cos(yaw / 2.0);
+  return pose;
+}
+
+double yaw_of(const geometry_msgs::msg::Pose & pose)
+{
+  return 2.0 * std::atan2(pose.orientation.z, pose.orientation.w);
+}
+
+tf2::TimePoint at_ms(const int64_t ms)
+{
+  return tf2::TimePoint{milliseconds{ms}};
+}
+}  // namespace
+
+TEST(PosePropagatorTest, propagate) {
+  EXPECT_THROW(PosePropagator{0U}, std::domain_error);
+
+  PosePropagator propagator{10U};
+  geometry_msgs::msg::Pose pose;
+  EXPECT_FALSE(propagator.propagate(pose));
+
+  // The odometry drives straight along its x axis at 10 m/s, while the vehicle heads along
+  // the y axis of the map.
+  for (int64_t ms = 0; ms <= 100; ms += 20) {
+    EXPECT_TRUE(propagator.add_odometry(at_ms(ms), make_pose(0.01 * ms, 0.0, 0.0)));
+  }
+  EXPECT_EQ(propagator.latest_stamp(), at_ms(100));
+  EXPECT_FALSE(propagator.propagate(pose));
+  EXPECT_FALSE(propagator.add_odometry(at_ms(100), make_pose(5.0, 0.0, 0.0)));
+
+  // The registration result between two odometry poses is moved by the odometry since.
+  EXPECT_TRUE(propagator.set_registration(at_ms(50), make_pose(10.0, 20.0, M_PI_2)));
+  ASSERT_TRUE(propagator.propagate(pose));
+  EXPECT_NEAR(pose.position.x, 10.0, 1.0E-9);
+  EXPECT_NEAR(pose.position.y, 20.5, 1.0E-9);
+  EXPECT_NEAR(yaw_of(pose), M_PI_2, 1.0E-9);
+
+  EXPECT_TRUE(propagator.add_odometry(at_ms(120), make_pose(1.2, 0.0, 0.0)));
+  ASSERT_TRUE(propagator.propagate(pose));
+  EXPECT_NEAR(pose.position.y, 20.7, 1.0E-9);
+
+  // A result newer than the odometry waits for it, the previous anchor stays in use.
+  EXPECT_TRUE(propagator.set_registration(at_ms(130), make_pose(10.0, 30.0, M_PI_2)));
+  ASSERT_TRUE(propagator.propagate(pose));
+  EXPECT_NEAR(pose.position.y, 20.7, 1.0E-9);
+  EXPECT_TRUE(propagator.add_odometry(at_ms(140), make_pose(1.4, 0.0, 0.0)));
+  ASSERT_TRUE(propagator.propagate(pose));
+  EXPECT_NEAR(pose.position.y, 30.1, 1.0E-9);
+
+  // Results older than the history are ignored.
+  EXPECT_EQ(propagator.size(), 8U);
+  for (int64_t ms = 160; ms <= 240; ms += 20) {
+    EXPECT_TRUE(propagator.add_odometry(at_ms(ms), make_pose(0.01 * ms, 0.0, 0.0)));
+  }
+  EXPECT_EQ(propagator.size(), 10U);
+  EXPECT_FALSE(propagator.set_registration(at_ms(50), make_pose(0.0, 0.0, 0.0)));
+  ASSERT_TRUE(propagator.propagate(pose));
+  EXPECT_NEAR(pose.position.y, 31.1, 1.0E-9);
+
+  propagator.reset();
+  EXPECT_EQ(propagator.size(), 0U);
+  EXPECT_FALSE(propagator.propagate(pose));
+}
+
+TEST(PosePropagatorTest, rotation) {
+  // The odometry turns at 1 rad/s on the spot, then drives forward.
+  PosePropagator propagator{100U};
+  for (int64_t ms = 0; ms <= 1000; ms += 10) {
+    EXPECT_TRUE(propagator.add_odometry(at_ms(ms), make_pose(0.0, 0.0, 0.001 * ms)));
+  }
+  EXPECT_TRUE(propagator.set_registration(at_ms(505), make_pose(1.0, 2.0, 0.0)));
+  EXPECT_TRUE(propagator.add_odometry(at_ms(1010), make_pose(std::cos(1.0), std::sin(1.0), 1.0)));
+  geometry_msgs::msg::Pose pose;
+  ASSERT_TRUE(propagator.propagate(pose));
+  // The vehicle turned by 0.495 rad since the registration, then moved by 1 m along its heading.
+  EXPECT_NEAR(yaw_of(pose), 0.495, 1.0E-9);
+  EXPECT_NEAR(pose.position.x, 1.0 + std::cos(0.495), 1.0E-9);
+  EXPECT_NEAR(pose.position.y, 2.0 + std::sin(0.495), 1.0E-9);
+}
@@ -17,6 +17,7 @@
 
 
 #include <localization_nodes/localization_node.hpp>
+#include <localization_nodes/map_double_buffer.hpp>
 #include <geometry_msgs/msg/transform_stamped.hpp>
 
 #include <string>
@@ -262,6 +263,51 @@ TEST_F(RelativeLocalizationNodeTest, exception_handling) {
   EXPECT_TRUE(localizer_node->register_exception());
 }
 
+TEST(MapDoubleBufferTest, swap) {
+  using autoware::localization::localization_nodes::MapDoubleBuffer;
+  auto front_tracker = std::make_shared<MsgWithHeader>();
+  auto back_tracker = std::make_shared<MsgWithHeader>();
+  set_msg_id(*front_tracker, INITIAL_ID);
+  set_msg_id(*back_tracker, INITIAL_ID);
+  auto front_ptr = std::make_unique<TestMap>(front_tracker);
+  MapDoubleBuffer<TestMap, MsgWithHeader> buffer{std::make_unique<TestMap>(back_tracker)};
+
+  // Nothing to swap before a message is received.
+  EXPECT_FALSE(buffer.try_swap(front_ptr));
+  EXPECT_FALSE(front_ptr->valid());
+
+  auto msg1 = std::make_shared<MsgWithHeader>();
+  set_msg_id(*msg1, 1);
+  buffer.update(msg1);
+  buffer.wait_until_idle();
+  // The front buffer is untouched until it is swapped.
+  EXPECT_FALSE(front_ptr->valid());
+  EXPECT_TRUE(buffer.try_swap(front_ptr));
+  EXPECT_EQ(get_msg_id(*front_ptr->get_msg_tracker()), 1);
+  EXPECT_EQ(front_ptr->get_msg_tracker(), back_tracker);
+  // The previous front buffer is resynchronized, which doesn't result in another swap.
+  buffer.wait_until_idle();
+  EXPECT_EQ(get_msg_id(*front_tracker), 1);
+  EXPECT_FALSE(buffer.try_swap(front_ptr));
+
+  auto msg2 = std::make_shared<MsgWithHeader>();
+  set_msg_id(*msg2, 2);
+  buffer.update(msg2);
+  buffer.wait_until_idle();
+  EXPECT_EQ(get_msg_id(*front_ptr->get_msg_tracker()), 1);
+  EXPECT_TRUE(buffer.try_swap(front_ptr));
+  EXPECT_EQ(get_msg_id(*front_ptr->get_msg_tracker()), 2);
+
+  // Failed updates are reported once and never swapped in.
+  auto bad_msg = std::make_shared<MsgWithHeader>();
+  set_msg_id(*bad_msg, TEST_ERROR_ID);
+  buffer.update(bad_msg);
+  buffer.wait_until_idle();
+  EXPECT_THROW(buffer.try_swap(front_ptr), TestMapException);
+  EXPECT_FALSE(buffer.try_swap(front_ptr));
+  EXPECT_EQ(get_msg_id(*front_ptr->get_msg_tracker()), 2);
+}
+
 //////////////////////////////////////////////////////////////////////// Implementations
 
 TestMap::TestMap(const std::shared_ptr<MapMsg> & map_ptr)
@@ -378,3 +424,5 @@ Transform MockInitializer::guess(
 }
 
 void MockInitializer::set_fallback_pose(const geometry_msgs::msg::TransformStamped &) {}
+
+void MockInitializer::add_registration_result(const geometry_msgs::msg::TransformStamped &) {}
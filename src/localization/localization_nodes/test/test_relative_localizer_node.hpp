@@ -84,6 +84,8 @@ public:
     const std::string & id1, const std::string & id2);
 
   void set_fallback_pose(const geometry_msgs::msg::TransformStamped &);
+
+  void add_registration_result(const geometry_msgs::msg::TransformStamped &);
 };
 
 class TestRelativeLocalizerNode : public RelativeLocalizerNode<
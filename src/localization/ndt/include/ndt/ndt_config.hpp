@@ -19,8 +19,14 @@
 
 #include <ndt/ndt_common.hpp>
 #include <voxel_grid/config.hpp>
+#include <chrono>
+#include <cstddef>
+#include <stdexcept>
 #include <utility>
 
+using autoware::common::types::bool8_t;
+using autoware::common::types::float32_t;
+
 namespace autoware
 {
 namespace localization
@@ -34,9 +40,19 @@ class NDTLocalizerConfigBase
 public:
   /// Constructor
   /// \param guess_time_tolerance
+  /// \param max_scan_stride Largest stride the scan is subsampled with when the optimizer runs
+  /// out of its time budget. 1 disables the subsampling.
+  /// \throws std::domain_error if the maximum stride is 0.
   NDTLocalizerConfigBase(
-    std::chrono::nanoseconds guess_time_tolerance)
-  : m_guess_time_tol{guess_time_tolerance} {}
+    std::chrono::nanoseconds guess_time_tolerance,
+    std::size_t max_scan_stride = 1U)
+  : m_guess_time_tol{guess_time_tolerance},
+    m_max_scan_stride{max_scan_stride}
+  {
+    if (m_max_scan_stride == 0U) {
+      throw std::domain_error("NDTLocalizerConfigBase: Maximum scan stride must be positive.");
+    }
+  }
 
   /// Get optimizer config.
   /// \return optimizer config
@@ -45,8 +61,16 @@ public:
     return m_guess_time_tol;
   }
 
+  /// Get the largest stride the scan is subsampled with.
+  /// \return maximum scan stride.
+  std::size_t max_scan_stride() const noexcept
+  {
+    return m_max_scan_stride;
+  }
+
 private:
   std::chrono::nanoseconds m_guess_time_tol;
+  std::size_t m_max_scan_stride;
 };
 
 
@@ -57,7 +81,51 @@ public:
   /// Constructor
   /// \param outlier_ratio Outlier ratio to be used in the gaussian distribution variation used
   /// in (eq. 6.7) [Magnusson 2009]
-  explicit P2DNDTOptimizationConfig(Real outlier_ratio)
+  /// \param num_threads Number of threads the scan points are partitioned into when evaluating
+  /// the objective. 1 evaluates the objective on the calling thread only.
+  /// \param single_precision_gradient If true, evaluations that don't need the hessian (i.e. line
+  /// search steps) use a single precision kernel operating on a structure-of-arrays layout.
+  /// \throws std::domain_error if the number of threads is 0.
+  explicit P2DNDTOptimizationConfig(
+    Real outlier_ratio,
+    uint32_t num_threads = 1U,
+    bool8_t single_precision_gradient = false)
+  : m_outlier_ratio{outlier_ratio},
+    m_num_threads{num_threads},
+    m_single_precision_gradient{single_precision_gradient}
+  {
+    if (m_num_threads == 0U) {
+      throw std::domain_error("P2DNDTOptimizationConfig: number of threads must be positive");
+    }
+  }
+
+  /// Get outlier ratio.
+  /// \return outlier ratio.
+  Real outlier_ratio() const noexcept {return m_outlier_ratio;}
+
+  /// Get the number of threads used to evaluate the objective.
+  /// \return number of threads.
+  uint32_t num_threads() const noexcept {return m_num_threads;}
+
+  /// Check if the single precision kernel is used for the score and the jacobian.
+  /// \return True if the single precision kernel is used.
+  bool8_t single_precision_gradient() const noexcept {return m_single_precision_gradient;}
+
+private:
+  Real m_outlier_ratio;
+  uint32_t m_num_threads;
+  bool8_t m_single_precision_gradient;
+};
+
+
+/// Config class for d2d optimization problem
+class NDT_PUBLIC D2DNDTOptimizationConfig
+{
+public:
+  /// Constructor
+  /// \param outlier_ratio Outlier ratio to be used in the gaussian distribution variation used
+  /// in (eq. 6.7) [Magnusson 2009]
+  explicit D2DNDTOptimizationConfig(Real outlier_ratio)
   : m_outlier_ratio{outlier_ratio} {}
 
   /// Get outlier ratio.
@@ -69,6 +137,35 @@ private:
 };
 
 
+/// Config class for registering a measurement from multiple initial guesses.
+class NDT_PUBLIC NDTMultiStartConfig
+{
+public:
+  /// Constructor
+  /// \param num_threads Number of threads the hypotheses are solved on. If 0, the hardware
+  /// concurrency is used.
+  /// \param early_stop_score No further hypotheses are started once a hypothesis converged with
+  /// a score above this value. Hypotheses that converged outside of the map have a score of 0.
+  explicit NDTMultiStartConfig(
+    uint32_t num_threads = 0U,
+    Real early_stop_score = 0.0)
+  : m_num_threads{num_threads},
+    m_early_stop_score{early_stop_score} {}
+
+  /// Get the number of threads the hypotheses are solved on.
+  /// \return number of threads.
+  uint32_t num_threads() const noexcept {return m_num_threads;}
+
+  /// Get the score above which a converged hypothesis stops the search.
+  /// \return early stop score.
+  Real early_stop_score() const noexcept {return m_early_stop_score;}
+
+private:
+  uint32_t m_num_threads;
+  Real m_early_stop_score;
+};
+
+
 /// config class for p2d ndt localizer
 class NDT_PUBLIC P2DNDTLocalizerConfig : public NDTLocalizerConfigBase
 {
@@ -78,11 +175,32 @@ public:
   /// points expected in a single lidar scan.
   /// \param guess_time_tolerance Time difference tolerance between the initial guess timestamp
   /// and the timestamp of the scan.
+  /// \param scan_voxel_size Edge length of the voxels the scan is downsampled with. The scan is
+  /// not downsampled if it is 0. If it is downsampled, the scan capacity is the maximum number of
+  /// occupied voxels.
+  /// \param max_scan_stride Largest stride the scan is subsampled with when the optimizer runs
+  /// out of its time budget. 1 disables the subsampling.
+  /// \param scan_max_points Maximum number of scan points used for the registration, selected
+  /// by azimuth sector and range. 0 uses all points.
+  /// \param scan_num_sectors Number of azimuth sectors the point budget is split over.
+  /// \throws std::domain_error if the maximum stride or the number of sectors is 0.
   P2DNDTLocalizerConfig(
     const uint32_t scan_capacity,
-    std::chrono::nanoseconds guess_time_tolerance)
-  : NDTLocalizerConfigBase{guess_time_tolerance},
-    m_scan_capacity(scan_capacity) {}
+    std::chrono::nanoseconds guess_time_tolerance,
+    const float32_t scan_voxel_size = 0.0F,
+    const std::size_t max_scan_stride = 1U,
+    const std::size_t scan_max_points = 0U,
+    const std::size_t scan_num_sectors = 16U)
+  : NDTLocalizerConfigBase{guess_time_tolerance, max_scan_stride},
+    m_scan_capacity(scan_capacity),
+    m_scan_voxel_size(scan_voxel_size),
+    m_scan_max_points(scan_max_points),
+    m_scan_num_sectors(scan_num_sectors)
+  {
+    if (m_scan_num_sectors == 0U) {
+      throw std::domain_error("P2DNDTLocalizerConfig: Number of scan sectors must be positive.");
+    }
+  }
 
   /// Get scan capacity.
   /// \return scan capacity.
@@ -91,8 +209,79 @@ public:
     return m_scan_capacity;
   }
 
+  /// Get the voxel size the scan is downsampled with.
+  /// \return scan voxel size.
+  float32_t scan_voxel_size() const noexcept
+  {
+    return m_scan_voxel_size;
+  }
+
+  /// Get the maximum number of scan points used for the registration.
+  /// \return scan point budget, 0 if all points are used.
+  std::size_t scan_max_points() const noexcept
+  {
+    return m_scan_max_points;
+  }
+
+  /// Get the number of azimuth sectors the point budget is split over.
+  /// \return number of scan sectors.
+  std::size_t scan_num_sectors() const noexcept
+  {
+    return m_scan_num_sectors;
+  }
+
+private:
+  uint32_t m_scan_capacity;
+  float32_t m_scan_voxel_size;
+  std::size_t m_scan_max_points;
+  std::size_t m_scan_num_sectors;
+};
+
+/// config class for d2d ndt localizer
+class NDT_PUBLIC D2DNDTLocalizerConfig : public NDTLocalizerConfigBase
+{
+public:
+  /// Constructor
+  /// \param scan_capacity Capacity of the ndt scan. This corresponds to the maximum number of
+  /// voxels occupied by the points of a single lidar scan.
+  /// \param guess_time_tolerance Time difference tolerance between the initial guess timestamp
+  /// and the timestamp of the scan.
+  /// \param scan_voxel_size Edge length of the voxels the Gaussian cells of the scan are built
+  /// from. It should be in the order of the cell size of the map.
+  /// \param max_scan_stride Largest stride the scan is subsampled with when the optimizer runs
+  /// out of its time budget. 1 disables the subsampling.
+  /// \throws std::domain_error if the voxel size is not positive or the maximum stride is 0.
+  D2DNDTLocalizerConfig(
+    const uint32_t scan_capacity,
+    std::chrono::nanoseconds guess_time_tolerance,
+    const float32_t scan_voxel_size,
+    const std::size_t max_scan_stride = 1U)
+  : NDTLocalizerConfigBase{guess_time_tolerance, max_scan_stride},
+    m_scan_capacity(scan_capacity),
+    m_scan_voxel_size(scan_voxel_size)
+  {
+    if (!(m_scan_voxel_size > 0.0F)) {
+      throw std::domain_error("D2DNDTLocalizerConfig: Scan voxel size must be positive.");
+    }
+  }
+
+  /// Get scan capacity.
+  /// \return scan capacity.
+  uint32_t scan_capacity() const noexcept
+  {
+    return m_scan_capacity;
+  }
+
+  /// Get the voxel size of the cells of the scan.
+  /// \return scan voxel size.
+  float32_t scan_voxel_size() const noexcept
+  {
+    return m_scan_voxel_size;
+  }
+
 private:
   uint32_t m_scan_capacity;
+  float32_t m_scan_voxel_size;
 };
 
 }  // namespace ndt
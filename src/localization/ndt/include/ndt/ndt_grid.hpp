@@ -20,6 +20,8 @@
 #include <common/types.hpp>
 #include <ndt/ndt_common.hpp>
 #include <ndt/ndt_voxel_view.hpp>
+#include <algorithm>
+#include <cstdlib>
 #include <vector>
 #include <limits>
 #include <unordered_map>
@@ -34,6 +36,17 @@ namespace localization
 {
 namespace ndt
 {
+/// \brief Which cells are returned by a lookup in the NDT grid
+enum class CellLookupMode : uint8_t
+{
+  /// Only the cell containing the query point
+  SINGLE = 0U,
+  /// The cell containing the query point and the 6 cells sharing a face with it
+  FACE_NEIGHBOURS,
+  /// The cell containing the query point and all 26 cells surrounding it
+  ALL_NEIGHBOURS
+};
+
 /// \brief A voxel grid implementation for normal distribution transform
 /// \tparam VoxelT Voxel type
 template<typename VoxelT>
@@ -48,10 +61,13 @@ public:
 
   /// Constructor
   /// \param voxel_grid_config Voxel grid config to configure the underlying voxel grid.
-  explicit NDTGrid(const Config & voxel_grid_config)
-  : m_config(voxel_grid_config), m_map(m_config.get_capacity())
+  /// \param lookup_mode Which cells are returned by a lookup.
+  explicit NDTGrid(
+    const Config & voxel_grid_config,
+    const CellLookupMode lookup_mode = CellLookupMode::SINGLE)
+  : m_config(voxel_grid_config), m_map(m_config.get_capacity()), m_lookup_mode{lookup_mode}
   {
-    m_output_vector.reserve(1U);
+    compute_neighbour_offsets();
   }
 
   // Maps should be moved rather than being copied.
@@ -68,8 +84,8 @@ public:
   /// \param x x coordinate
   /// \param y y coordinate
   /// \param z z coordinate
-  /// \return A vector containing the cell at given coordinates. A vector is used to support
-  /// near-neighbour cell queries in the future.
+  /// \return A vector containing the usable cells around the given coordinates, as configured by
+  /// the lookup mode. The cell containing the coordinates always comes first if it is usable.
   const VoxelViewVector & cell(float32_t x, float32_t y, float32_t z) const
   {
     return cell(Point({x, y, z}));
@@ -77,20 +93,58 @@ public:
 
   /// Lookup the cell at location.
   /// \param pt point to lookup
-  /// \return A vector containing the cell at given coordinates. A vector is used to support
-  /// near-neighbour cell queries in the future.
+  /// \return A vector containing the usable cells around the given point, as configured by
+  /// the lookup mode. The cell containing the point always comes first if it is usable.
   const VoxelViewVector & cell(const Point & pt) const
   {
-    // TODO(yunus.caliskan): revisit after multi-cell lookup support. #985
-    m_output_vector.clear();
-    const auto vx_it = m_map.find(m_config.index(pt));
-    // Only return a voxel if it's occupied (i.e. has enough points to compute covariance.)
-    if (vx_it != m_map.end() && vx_it->second.usable()) {
-      m_output_vector.emplace_back(vx_it->second);
-    }
+    cell(pt, m_output_vector);
     return m_output_vector;
   }
 
+  /// Lookup the cell at location into a caller owned vector. Unlike the other lookups, this
+  /// doesn't modify the state of the grid and hence can be called concurrently.
+  /// \param pt point to lookup
+  /// \param output Vector to be filled with the usable cells around the given point, as
+  /// configured by the lookup mode. It is cleared before use.
+  void cell(const Point & pt, VoxelViewVector & output) const
+  {
+    output.clear();
+    const auto base_idx = m_config.index(pt);
+    if (m_neighbour_offsets.empty()) {
+      add_usable_cell(base_idx, output);
+      return;
+    }
+    // Decompose the index once to discard neighbours wrapping around the x or y borders
+    const auto y_stride = m_config.get_y_stride();
+    const auto z_stride = m_config.get_z_stride();
+    const auto x_idx = base_idx % y_stride;
+    const auto y_idx = (base_idx % z_stride) / y_stride;
+    const auto y_width = z_stride / y_stride;
+    for (const auto & offset : m_neighbour_offsets) {
+      if (((x_idx == 0U) && (offset.dx < 0)) || ((x_idx + 1U >= y_stride) && (offset.dx > 0)) ||
+        ((y_idx == 0U) && (offset.dy < 0)) || ((y_idx + 1U >= y_width) && (offset.dy > 0)))
+      {
+        continue;
+      }
+      // Out of range z indices wrap around to indices that are never occupied
+      add_usable_cell(base_idx + static_cast<uint64_t>(offset.index_offset), output);
+    }
+  }
+
+  /// Get the maximum number of cells a single lookup can return.
+  /// \return Maximum number of cells per lookup.
+  std::size_t max_cells_per_lookup() const noexcept
+  {
+    return std::max<std::size_t>(m_neighbour_offsets.size(), 1U);
+  }
+
+  /// Get the lookup mode of the grid.
+  /// \return The lookup mode.
+  CellLookupMode lookup_mode() const noexcept
+  {
+    return m_lookup_mode;
+  }
+
   /// Get size of the map
   /// \return Number of voxels in the map. This number includes the voxels that do not have
   /// enough numbers to be used yet.
@@ -171,11 +225,54 @@ public:
     return m_map.emplace(std::forward<Args>(args)...);
   }
 
+  /// \brief Remove the voxel with the given index from the grid.
+  /// \param idx Index of the voxel.
+  /// \return Number of removed voxels.
+  std::size_t erase_voxel(const uint64_t idx)
+  {
+    return m_map.erase(idx);
+  }
+
+  /// \brief Remove the voxel at the given position from the grid.
+  /// \param it Iterator to the voxel.
+  /// \return Iterator following the removed voxel.
+  typename Grid::iterator erase_voxel(typename Grid::const_iterator it)
+  {
+    return m_map.erase(it);
+  }
+
   /// \brief Add a point to its corresponding voxel in the grid.
   /// \param pt Point to be added
-  void add_observation(const Point & pt)
+  /// \return The voxel the point was added to
+  VoxelT & add_observation(const Point & pt)
+  {
+    auto & voxel = m_map[index(pt)];
+    voxel.add_observation(pt);
+    return voxel;
+  }
+
+  /// \brief Get the number of buckets of the underlying hash map.
+  /// \return Number of buckets
+  std::size_t bucket_count() const noexcept
+  {
+    return m_map.bucket_count();
+  }
+
+  /// \brief Returns a const iterator to the first voxel of a bucket of the underlying hash map
+  /// \param bucket Index of the bucket, smaller than `bucket_count()`
+  /// \return Iterator
+  typename Grid::const_local_iterator cbegin(const std::size_t bucket) const
+  {
+    return m_map.cbegin(bucket);
+  }
+
+  /// \brief Returns a const iterator to one past the last voxel of a bucket of the underlying
+  /// hash map
+  /// \param bucket Index of the bucket, smaller than `bucket_count()`
+  /// \return Iterator
+  typename Grid::const_local_iterator cend(const std::size_t bucket) const
   {
-    m_map[index(pt)].add_observation(pt);
+    return m_map.cend(bucket);
   }
 
   /// \brief Set the configuration
@@ -183,6 +280,7 @@ public:
   void set_config(const Config & config)
   {
     m_config = config;
+    compute_neighbour_offsets();
   }
 
   /// \brief Get the underlying voxel grid configuration
@@ -193,9 +291,57 @@ public:
   }
 
 private:
+  /// Offset of a neighbouring cell relative to a reference cell.
+  struct NeighbourOffset
+  {
+    int64_t dx;
+    int64_t dy;
+    int64_t index_offset;
+  };
+
+  /// Add the cell at the given index to the output if it's occupied (i.e. has enough points to
+  /// compute covariance.)
+  /// \param idx Voxel index
+  /// \param output Vector to add the cell to.
+  void add_usable_cell(const uint64_t idx, VoxelViewVector & output) const
+  {
+    const auto vx_it = m_map.find(idx);
+    if (vx_it != m_map.end() && vx_it->second.usable()) {
+      output.emplace_back(vx_it->second);
+    }
+  }
+
+  /// Precompute the index offsets of the neighbouring cells so that a lookup only has to compute
+  /// the index of the query point once. The reference cell itself is the first offset.
+  void compute_neighbour_offsets()
+  {
+    m_neighbour_offsets.clear();
+    if (CellLookupMode::SINGLE != m_lookup_mode) {
+      const auto y_stride = static_cast<int64_t>(m_config.get_y_stride());
+      const auto z_stride = static_cast<int64_t>(m_config.get_z_stride());
+      m_neighbour_offsets.push_back({0, 0, 0});
+      for (int64_t dz = -1; dz <= 1; ++dz) {
+        for (int64_t dy = -1; dy <= 1; ++dy) {
+          for (int64_t dx = -1; dx <= 1; ++dx) {
+            const auto manhattan_distance = std::abs(dx) + std::abs(dy) + std::abs(dz);
+            if ((0 == manhattan_distance) ||
+              ((CellLookupMode::FACE_NEIGHBOURS == m_lookup_mode) && (1 < manhattan_distance)))
+            {
+              continue;
+            }
+            m_neighbour_offsets.push_back({dx, dy, dx + (dy * y_stride) + (dz * z_stride)});
+          }
+        }
+      }
+    }
+    m_output_vector.reserve(max_cells_per_lookup());
+  }
+
   mutable VoxelViewVector m_output_vector;
   Config m_config;
   Grid m_map;
+  CellLookupMode m_lookup_mode;
+  std::vector<NeighbourOffset> m_neighbour_offsets;
 };
 
 }  // namespace ndt
@@ -24,12 +24,22 @@
 #include <geometry_msgs/msg/transform_stamped.hpp>
 #include <geometry_msgs/msg/pose_with_covariance_stamped.hpp>
 #include <ndt/ndt_common.hpp>
+#include <ndt/ndt_map_pyramid.hpp>
 #include <ndt/ndt_optimization_problem.hpp>
 #include <ndt/constraints.hpp>
 #include <optimization/optimizer_options.hpp>
 #include <experimental/optional>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <utility>
 #include <string>
+#include <vector>
 
 namespace autoware
 {
@@ -109,12 +119,15 @@ public:
     transform_adapters::transform_to_pose(transform_initial.transform, eig_pose_initial);
 
     // Set the scan
+    const auto scan_stride = m_scan_stride;
     m_scan.clear();
+    m_scan.set_stride(scan_stride);
     m_scan.insert(msg);
 
     // Define and solve the problem.
     NDTOptimizationProblemT problem(m_scan, map, m_optimization_problem_config);
     const auto opt_summary = m_optimizer.solve(problem, eig_pose_initial, eig_pose_result);
+    update_scan_stride(opt_summary);
 
     if (opt_summary.termination_type() == common::optimization::TerminationType::FAILURE) {
       throw std::runtime_error(
@@ -133,12 +146,253 @@ public:
     // Populate covariance information. It is implementation defined.
     set_covariance(problem, eig_pose_initial, eig_pose_result, pose_out);
     if (summary != nullptr) {
-      *summary = localization_common::OptimizedRegistrationSummary{opt_summary};
+      *summary = localization_common::OptimizedRegistrationSummary{opt_summary, scan_stride};
     }
     return pose_out;
   }
 
+  /// Register a measurement coarse-to-fine on a map pyramid and return the transformation from
+  /// map to the measurement. The scan is inserted once and registered to each level, starting
+  /// from the coarsest one, where each level starts from the result of the previous one. The
+  /// coarse levels widen the basin of convergence while the finest level determines the
+  /// accuracy. Coarse levels that are empty or whose optimization fails numerically are skipped.
+  /// Each level is solved with the full options of the optimizer, the summary reports the
+  /// termination and the distance of the finest level together with the iterations, the
+  /// evaluations and the duration of all levels, which also drive the scan stride adaptation.
+  /// \tparam VoxelT Voxel type of the pyramid, which must match the map type of the
+  /// optimization problem.
+  /// \param[in] msg Measurement message to register.
+  /// \param[in] transform_initial Initial guess of the pose for the coarsest level.
+  /// \param[in] pyramid Map pyramid to register.
+  /// \param[out] summary (Optional) Reference to the registration summary.
+  /// \return Pose estimate after registration on the finest level.
+  /// \throws std::logic_error on measurements older than the map.
+  /// \throws std::domain_error on pose estimates that are not within the configured duration
+  /// range from the measurement.
+  /// \throws std::runtime_error on numerical errors in the optimization of the finest level.
+  template<typename VoxelT>
+  PoseWithCovarianceStamped register_measurement(
+    const CloudT & msg,
+    const Transform & transform_initial,
+    const BasicNDTMapPyramid<VoxelT> & pyramid,
+    Summary * const summary = nullptr)
+  {
+    PoseWithCovarianceStamped pose_out{};
+    validate_msg(msg, pyramid);
+    validate_guess(msg, transform_initial);
+    EigenPose<Real> eig_pose_initial, eig_pose_level, eig_pose_result;
+    eig_pose_initial.setZero();
+    eig_pose_result.setZero();
+    transform_adapters::transform_to_pose(transform_initial.transform, eig_pose_initial);
+
+    const auto scan_stride = m_scan_stride;
+    m_scan.clear();
+    m_scan.set_stride(scan_stride);
+    m_scan.insert(msg);
+
+    using common::optimization::TerminationType;
+    uint64_t num_iterations{0U};
+    common::optimization::EvaluationCounts evaluation_counts{};
+    std::chrono::nanoseconds total_duration{std::chrono::nanoseconds::zero()};
+    std::chrono::nanoseconds max_iteration_duration{std::chrono::nanoseconds::zero()};
+    const auto accumulate = [&](const common::optimization::OptimizationSummary & level_summary) {
+        num_iterations += level_summary.number_of_iterations_made();
+        evaluation_counts.score += level_summary.evaluation_counts().score;
+        evaluation_counts.jacobian += level_summary.evaluation_counts().jacobian;
+        evaluation_counts.hessian += level_summary.evaluation_counts().hessian;
+        total_duration += level_summary.total_duration();
+        max_iteration_duration =
+          std::max(max_iteration_duration, level_summary.max_iteration_duration());
+      };
+
+    eig_pose_level = eig_pose_initial;
+    for (auto level = pyramid.num_levels() - 1U; level > 0U; --level) {
+      const auto & level_map = pyramid.level(level);
+      if (level_map.size() == 0U) {
+        continue;
+      }
+      NDTOptimizationProblemT level_problem(m_scan, level_map, m_optimization_problem_config);
+      const auto level_summary = m_optimizer.solve(level_problem, eig_pose_level, eig_pose_result);
+      accumulate(level_summary);
+      if (level_summary.termination_type() != TerminationType::FAILURE) {
+        eig_pose_level = eig_pose_result;
+      }
+    }
+
+    NDTOptimizationProblemT problem(m_scan, pyramid.level(0U), m_optimization_problem_config);
+    const auto fine_summary = m_optimizer.solve(problem, eig_pose_level, eig_pose_result);
+    accumulate(fine_summary);
+    const common::optimization::OptimizationSummary opt_summary{
+      fine_summary.estimated_distance_to_optimum(), fine_summary.termination_type(),
+      num_iterations, evaluation_counts, total_duration, max_iteration_duration};
+    update_scan_stride(opt_summary);
+
+    if (opt_summary.termination_type() == TerminationType::FAILURE) {
+      throw std::runtime_error(
+              "NDT localizer has likely encountered a numerical "
+              "error during optimization.");
+    }
+
+    transform_adapters::pose_to_transform(eig_pose_result, pose_out.pose.pose);
+    pose_out.header.stamp = msg.header.stamp;
+    pose_out.header.frame_id = pyramid.frame_id();
+
+    set_covariance(problem, eig_pose_initial, eig_pose_result, pose_out);
+    if (summary != nullptr) {
+      *summary = localization_common::OptimizedRegistrationSummary{opt_summary, scan_stride};
+    }
+    return pose_out;
+  }
+
+  /// Register a measurement starting from several initial guesses and return the best pose
+  /// estimate. This is meant for (re)initialization when the pose is ambiguous, e.g. after an
+  /// outage. The scan is inserted once and shared read-only by all hypotheses, which are solved
+  /// in parallel by a fixed number of worker threads, each with its own copy of the optimizer.
+  /// Hypotheses are started in the given order and no new hypothesis is started once one of
+  /// them converged with a score above the configured early stop score, so the guesses should be
+  /// ordered by their likelihood. Hypotheses that are already running are finished. The
+  /// finished hypothesis with the highest ndt score wins, so hypotheses that converged far away
+  /// from the map don't win over better aligned ones that hit the iteration limit.
+  /// \tparam MapT Map type to be used. This map should conform the interface specied in
+  /// `LocalizationMapConstraint`
+  /// \param[in] msg Measurement message to register.
+  /// \param[in] initial_guesses Initial guesses of the pose, ordered by priority.
+  /// \param[in] map Map to register.
+  /// \param[in] multi_start_config Number of worker threads and early stop criterion. No more
+  /// threads than hypotheses are started.
+  /// \param[out] summary (Optional) Reference to the registration summary of the best hypothesis.
+  /// \param[out] best_index (Optional) Index of the best hypothesis in `initial_guesses`.
+  /// \return Pose estimate of the best hypothesis.
+  /// \throws std::logic_error on measurements older than the map.
+  /// \throws std::domain_error if there are no initial guesses or on guesses that are not within
+  /// the configured duration range from the measurement.
+  /// \throws std::runtime_error if the optimization of all hypotheses failed.
+  template<typename MapT,
+    Requires = traits::LocalizationMapConstraint<MapT>::value>
+  PoseWithCovarianceStamped register_measurement(
+    const CloudT & msg,
+    const std::vector<Transform> & initial_guesses,
+    const MapT & map,
+    const NDTMultiStartConfig & multi_start_config,
+    Summary * const summary = nullptr,
+    std::size_t * const best_index = nullptr)
+  {
+    if (initial_guesses.empty()) {
+      throw std::domain_error("NDT localizer needs at least one initial guess.");
+    }
+    validate_msg(msg, map);
+    for (const auto & guess : initial_guesses) {
+      validate_guess(msg, guess);
+    }
+
+    // The full scan is used since the pose is ambiguous.
+    m_scan.clear();
+    m_scan.set_stride(1U);
+    m_scan.insert(msg);
+
+    using common::optimization::TerminationType;
+    struct Hypothesis
+    {
+      std::size_t index;
+      std::unique_ptr<NDTOptimizationProblemT> problem;
+      EigenPose<Real> pose_initial;
+      EigenPose<Real> pose_result;
+      common::optimization::OptimizationSummary summary;
+      Real score;
+    };
+    // Lower indices win on equal scores so the result doesn't depend on the scheduling.
+    const auto is_better = [](const Hypothesis & lhs, const Hypothesis & rhs) {
+        return (lhs.score > rhs.score) || ((lhs.score == rhs.score) && (lhs.index < rhs.index));
+      };
+
+    std::atomic<std::size_t> next_index{0U};
+    std::atomic<bool8_t> stop{false};
+    std::mutex mutex;
+    std::experimental::optional<Hypothesis> best{};
+    std::exception_ptr error{nullptr};
+    const auto work = [&]() {
+        auto optimizer = m_optimizer;
+        while (!stop.load()) {
+          const auto index = next_index.fetch_add(1U);
+          if (index >= initial_guesses.size()) {
+            return;
+          }
+          try {
+            Hypothesis hypothesis{index,
+              std::make_unique<NDTOptimizationProblemT>(m_scan, map, m_optimization_problem_config),
+              EigenPose<Real>::Zero(), EigenPose<Real>::Zero(),
+              common::optimization::OptimizationSummary{0.0, TerminationType::FAILURE, 0U},
+              0.0};
+            transform_adapters::transform_to_pose(
+              initial_guesses[index].transform, hypothesis.pose_initial);
+            hypothesis.summary = optimizer.solve(
+              *hypothesis.problem, hypothesis.pose_initial, hypothesis.pose_result);
+            if (hypothesis.summary.termination_type() == TerminationType::FAILURE) {
+              continue;
+            }
+            hypothesis.score = (*hypothesis.problem)(hypothesis.pose_result);
+            if ((hypothesis.summary.termination_type() == TerminationType::CONVERGENCE) &&
+              (hypothesis.score > multi_start_config.early_stop_score()))
+            {
+              stop.store(true);
+            }
+            std::lock_guard<std::mutex> lock{mutex};
+            if (!best || is_better(hypothesis, *best)) {
+              best = std::move(hypothesis);
+            }
+          } catch (...) {
+            std::lock_guard<std::mutex> lock{mutex};
+            if (!error) {
+              error = std::current_exception();
+            }
+          }
+        }
+      };
+
+    std::size_t thread_count{multi_start_config.num_threads()};
+    if (thread_count == 0U) {
+      thread_count = std::max(std::size_t{std::thread::hardware_concurrency()}, std::size_t{1U});
+    }
+    thread_count = std::min(thread_count, initial_guesses.size());
+    std::vector<std::thread> workers;
+    workers.reserve(thread_count - 1U);
+    for (std::size_t i = 1U; i < thread_count; ++i) {
+      workers.emplace_back(work);
+    }
+    // The calling thread is one of the workers.
+    work();
+    for (auto & worker : workers) {
+      worker.join();
+    }
+
+    if (!best) {
+      if (error) {
+        std::rethrow_exception(error);
+      }
+      throw std::runtime_error(
+              "NDT localizer has likely encountered a numerical "
+              "error during optimization of all hypotheses.");
+    }
 
+    PoseWithCovarianceStamped pose_out{};
+    transform_adapters::pose_to_transform(best->pose_result, pose_out.pose.pose);
+    pose_out.header.stamp = msg.header.stamp;
+    pose_out.header.frame_id = map.frame_id();
+    set_covariance(*best->problem, best->pose_initial, best->pose_result, pose_out);
+    if (summary != nullptr) {
+      *summary = localization_common::OptimizedRegistrationSummary{best->summary};
+    }
+    if (best_index != nullptr) {
+      *best_index = best->index;
+    }
+    return pose_out;
+  }
+
+  /// Get the stride the next scan is subsampled with.
+  std::size_t scan_stride() const noexcept
+  {
+    return m_scan_stride;
+  }
   /// Get the last used scan.
   const ScanT & scan() const noexcept
   {
@@ -223,10 +477,30 @@ protected:
   }
 
 private:
+  /// Adapt the subsampling of the next scans to the time budget of the optimizer. The stride is
+  /// doubled after a scan that ran out of time, and halved after a scan that took less than a
+  /// third of the budget, so that twice the number of points is still likely to fit.
+  /// \param opt_summary Summary of the optimization of the latest scan.
+  void update_scan_stride(const common::optimization::OptimizationSummary & opt_summary)
+  {
+    const auto time_budget = m_optimizer.options().time_budget();
+    if (time_budget <= std::chrono::nanoseconds::zero()) {
+      return;
+    }
+    if (opt_summary.termination_type() ==
+      common::optimization::TerminationType::TIME_BUDGET_EXCEEDED)
+    {
+      m_scan_stride = std::min(2U * m_scan_stride, m_config.max_scan_stride());
+    } else if ((m_scan_stride > 1U) && ((3 * opt_summary.total_duration()) < time_budget)) {
+      m_scan_stride = std::max(m_scan_stride / 2U, std::size_t{1U});
+    }
+  }
+
   NDTLocalizerConfigBase m_config;
   OptimizationProblemConfigT m_optimization_problem_config;
   OptimizerT m_optimizer;
   ScanT m_scan;
+  std::size_t m_scan_stride{1U};
 };
 
 /// P2D localizer implementation.
@@ -250,11 +524,17 @@ public:
     const P2DNDTLocalizerConfig & config,
     const OptimizerT & optimizer,
     const Real outlier_ratio)
+  : P2DNDTLocalizer{config, optimizer, P2DNDTOptimizationConfig{outlier_ratio}} {}
+
+  P2DNDTLocalizer(
+    const P2DNDTLocalizerConfig & config,
+    const OptimizerT & optimizer,
+    const P2DNDTOptimizationConfig & optimization_config)
   : ParentT{
       config,
-      P2DNDTOptimizationConfig{outlier_ratio},
+      optimization_config,
       optimizer,
-      ScanT{config.scan_capacity()}} {}
+      make_scan(config)} {}
 
 protected:
   void set_covariance(
@@ -265,6 +545,51 @@ protected:
   {
     // For now, do nothing.
   }
+
+private:
+  static ScanT make_scan(const P2DNDTLocalizerConfig & config)
+  {
+    ScanT scan{config.scan_capacity(), config.scan_voxel_size()};
+    scan.set_point_budget(config.scan_max_points(), config.scan_num_sectors());
+    return scan;
+  }
+};
+
+/// D2D localizer implementation. The scan is converted into Gaussian cells which are registered
+/// against the cells of the map.
+/// \tparam OptimizerT Optimizer type.
+/// \tparam MapT Type of map to be used. By default it is StaticNDTMap.
+template<typename OptimizerT, typename MapT = StaticNDTMap>
+class NDT_PUBLIC D2DNDTLocalizer : public NDTLocalizerBase<
+    D2DNDTScan, D2DNDTOptimizationProblem<MapT>, D2DNDTOptimizationConfig, OptimizerT>
+{
+public:
+  using CloudT = sensor_msgs::msg::PointCloud2;
+  using ParentT = NDTLocalizerBase<
+    D2DNDTScan, D2DNDTOptimizationProblem<MapT>, D2DNDTOptimizationConfig, OptimizerT>;
+  using Transform = typename ParentT::Transform;
+  using PoseWithCovarianceStamped = typename ParentT::PoseWithCovarianceStamped;
+  using ScanT = D2DNDTScan;
+
+  D2DNDTLocalizer(
+    const D2DNDTLocalizerConfig & config,
+    const OptimizerT & optimizer,
+    const Real outlier_ratio)
+  : ParentT{
+      config,
+      D2DNDTOptimizationConfig{outlier_ratio},
+      optimizer,
+      ScanT{config.scan_capacity(), config.scan_voxel_size()}} {}
+
+protected:
+  void set_covariance(
+    const D2DNDTOptimizationProblem<MapT> &,
+    const EigenPose<Real> &,
+    const EigenPose<Real> &,
+    PoseWithCovarianceStamped &) const override
+  {
+    // For now, do nothing.
+  }
 };
 
 }  // namespace ndt
@@ -22,10 +22,13 @@
 #include <ndt/ndt_voxel_view.hpp>
 #include <ndt/ndt_grid.hpp>
 #include <sensor_msgs/point_cloud2_iterator.hpp>
+#include <thread_pool/thread_pool.hpp>
 #include <time_utils/time_utils.hpp>
+#include <chrono>
 #include <vector>
 #include <limits>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <string>
 
@@ -37,6 +40,23 @@ namespace localization
 {
 namespace ndt
 {
+class NDTMapBinaryFile;
+
+/// How a `DynamicNDTMap` forgets old observations, so that a map that is updated for a long time
+/// follows the changes of the environment and doesn't keep growing. The defaults never forget.
+struct NDT_PUBLIC DynamicNDTMapForgetting
+{
+  /// Voxels that were not observed for longer than this, relative to the latest inserted point
+  /// cloud, are removed from the map. Zero never removes voxels.
+  std::chrono::nanoseconds max_voxel_age{0};
+  /// Maximum number of points the statistics of a voxel represent. Beyond that, older points are
+  /// forgotten exponentially, see `DynamicNDTVoxel::limit_num_points()`. Zero doesn't bound them.
+  uint64_t max_points_per_voxel{0U};
+  /// Number of buckets of the voxel hash map checked for stale voxels at every insertion, so that
+  /// the cost of the removal is spread over the insertions.
+  std::size_t num_buckets_swept_per_insert{4096U};
+};
+
 /// Ndt Map for a dynamic voxel type. This map representation is only to be used
 /// when a dense point cloud is intended to be represented as a map. (i.e. by the map publisher)
 class NDT_PUBLIC DynamicNDTMap
@@ -44,6 +64,7 @@ class NDT_PUBLIC DynamicNDTMap
 public:
   using Voxel = DynamicNDTVoxel;
   using Config = autoware::perception::filters::voxel_grid::Config;
+  using Forgetting = DynamicNDTMapForgetting;
   using Point = Eigen::Vector3d;
   using TimePoint = std::chrono::system_clock::time_point;
   using VoxelViewVector = std::vector<VoxelView<Voxel>>;
@@ -54,7 +75,14 @@ public:
   /// Min point, max point and the voxel size.
   static constexpr uint32_t kNumConfigPoints = 3U;
 
-  explicit DynamicNDTMap(const Config & voxel_grid_config);
+  /// Constructor
+  /// \param voxel_grid_config Voxel grid config to configure the underlying voxel grid.
+  /// \param lookup_mode Which cells are returned by `cell(...)`.
+  /// \param forgetting How old observations are forgotten.
+  explicit DynamicNDTMap(
+    const Config & voxel_grid_config,
+    const CellLookupMode lookup_mode = CellLookupMode::SINGLE,
+    const Forgetting & forgetting = Forgetting{});
 
   /// \brief Set the contents of the pointcloud as the new map.
   /// \param msg Pointcloud to be inserted.
@@ -62,9 +90,33 @@ public:
 
   /// Insert the dense point cloud to the map. This is intended for converting a dense
   /// point cloud into the ndt representation. Ideal for reading dense pcd files.
+  /// The observed voxels are stamped with the stamp of the message and, if configured, a part of
+  /// the map is swept for stale voxels.
   /// \param msg PointCloud2 message to add.
   void insert(const sensor_msgs::msg::PointCloud2 & msg);
 
+  /// Insert the dense point cloud to the map on a thread pool, for building large maps. The voxel
+  /// indices of the points are computed in parallel, then the points are sorted by voxel with a
+  /// radix sort and the points of each voxel are added in parallel, in their order in the
+  /// message. The covariances are stabilized in parallel as well. The resulting map is identical
+  /// to the one of `insert(msg)` for any number of threads, but the sorting takes temporary
+  /// memory of about 48 bytes per point.
+  /// \param msg PointCloud2 message to add.
+  /// \param pool Pool to run on together with the calling thread.
+  /// \throws std::length_error If the message has more than 2^32 - 1 points.
+  void insert(
+    const sensor_msgs::msg::PointCloud2 & msg,
+    common::thread_pool::ThreadPool & pool);
+
+  /// Remove all the voxels that were not observed for longer than the configured maximum age,
+  /// relative to the stamp of the map. Does nothing if the maximum age is zero.
+  /// \return Number of removed voxels.
+  std::size_t remove_stale_voxels();
+
+  /// Get the forgetting configuration.
+  /// \return How old observations are forgotten.
+  const Forgetting & forgetting() const noexcept;
+
   /// Iterate over the map representation and convert it into a PointCloud2 message where each
   /// voxel in the map corresponds to a single point in the PointCloud2 field.
   /// \tparam DeserializingMapT The map type that can deserialize the serialized message.
@@ -75,18 +127,25 @@ public:
 
   /// Lookup the cell at location.
   /// \param pt point to lookup
-  /// \return A vector containing the cell at given coordinates. A vector is used to support
-  /// near-neighbour cell queries in the future.
+  /// \return A vector containing the usable cells around the given point, as configured by
+  /// the lookup mode.
   const VoxelViewVector & cell(const Point & pt) const;
 
   /// Lookup the cell at location.
   /// \param x x coordinate
   /// \param y y coordinate
   /// \param z z coordinate
-  /// \return A vector containing the cell at given coordinates. A vector is used to support
-  /// near-neighbour cell queries in the future.
+  /// \return A vector containing the usable cells around the given coordinates, as configured by
+  /// the lookup mode.
   const VoxelViewVector & cell(float32_t x, float32_t y, float32_t z) const;
 
+  /// Lookup the cell at location into a caller owned vector. This lookup can be called
+  /// concurrently.
+  /// \param pt point to lookup
+  /// \param output Vector to be filled with the usable cells around the given point, as
+  /// configured by the lookup mode.
+  void cell(const Point & pt, VoxelViewVector & output) const;
+
   /// Get map's frame id.
   /// \return Frame id of the map.
   const std::string & frame_id() const noexcept;
@@ -103,6 +162,10 @@ public:
   /// \return A point representing the dimensions of the cell.
   const ConfigPoint & cell_size() const noexcept;
 
+  /// Get the configuration of the underlying voxel grid.
+  /// \return Voxel grid config.
+  const Config & config() const noexcept;
+
   /// Get size of the map
   /// \return Number of voxels in the map. This number includes the voxels that do not have
   /// enough numbers to be used yet.
@@ -120,24 +183,40 @@ public:
   void clear() noexcept;
 
 private:
+  /// Remove the stale voxels of the given number of buckets, starting from the sweep cursor.
+  std::size_t sweep(const std::size_t num_buckets);
+  /// Stamp the map after an insertion and sweep for stale voxels.
+  void finish_insert(const sensor_msgs::msg::PointCloud2 & msg, const TimePoint stamp);
+
   NDTGrid<DynamicNDTVoxel> m_grid;
   TimePoint m_stamp{};
   std::string m_frame_id{};
+  Forgetting m_forgetting;
+  // Next bucket of the voxel hash map to sweep, bucket indices stay valid across rehashes
+  std::size_t m_sweep_bucket{0U};
+  std::vector<uint64_t> m_stale_voxels;
 };
 
-/// NDT map using StaticNDTVoxels. This class is to be used when the pointcloud
+/// NDT map using static voxels. This class is to be used when the pointcloud
 /// messages to be inserted already have the correct format (see validate_pcl_map(...)) and
 /// represent a transformed map. No centroid/covariance computation is done during run-time.
-class NDT_PUBLIC StaticNDTMap
+/// \tparam VoxelT Type of the static voxels, `StaticNDTVoxel` or the smaller `PackedNDTVoxel`.
+/// Use the `StaticNDTMap` and `PackedStaticNDTMap` aliases.
+template<typename VoxelT>
+class NDT_PUBLIC BasicStaticNDTMap
 {
 public:
-  using Voxel = StaticNDTVoxel;
+  using Voxel = VoxelT;
   using Config = autoware::perception::filters::voxel_grid::Config;
   using TimePoint = std::chrono::system_clock::time_point;
   using Point = Eigen::Vector3d;
   using VoxelViewVector = std::vector<VoxelView<Voxel>>;
-  using VoxelGrid = NDTGrid<Voxel>::Grid;
-  using ConfigPoint = NDTGrid<Voxel>::ConfigPoint;
+  using VoxelGrid = typename NDTGrid<Voxel>::Grid;
+  using ConfigPoint = typename NDTGrid<Voxel>::ConfigPoint;
+
+  /// Constructor
+  /// \param lookup_mode Which cells are returned by `cell(...)`.
+  explicit BasicStaticNDTMap(const CellLookupMode lookup_mode = CellLookupMode::SINGLE);
 
   /// Set point cloud message representing the map to the map representation instance.
   /// Map is assumed to have correct format (see `validate_pcl_map(...)`) and was generated
@@ -147,22 +226,63 @@ public:
   /// message which is expected to be equal to the voxel grid ID in the map's voxel grid. Since
   /// the grid's index will be a long value to avoid overflows, `cell_id` field should be an array
   /// of 2 unsigned integers. That is because there is no direct long support as a PointField.
+  /// If the map already holds a grid with the same configuration, it is updated in place: voxels
+  /// that are identical in the message keep their storage, changed voxels are overwritten and
+  /// voxels that are missing from the message are removed.
   void set(const sensor_msgs::msg::PointCloud2 & msg);
 
+  /// Set the contents of a memory mapped binary ndt map (see `write_ndt_map_binary(...)`) as the
+  /// new map. The voxel records are read directly from the mapped file using their stored grid
+  /// indices, so no point cloud decoding or index computation is done.
+  /// \param file Mapped binary ndt map.
+  void set(const NDTMapBinaryFile & file);
+
+  /// Merge the voxels of a memory mapped binary ndt map into the existing map. Voxels with the
+  /// same index are replaced. This is used to add map tiles incrementally. Throws if the voxel
+  /// grid configuration of the file differs from the configuration of the current map.
+  /// \param file Mapped binary ndt map.
+  void insert(const NDTMapBinaryFile & file);
+
+  /// Remove the voxels of a memory mapped binary ndt map from the map. This is used to evict map
+  /// tiles that were previously added via `insert(...)`.
+  /// \param file Mapped binary ndt map.
+  void remove(const NDTMapBinaryFile & file);
+
+  /// Replace the contents of the map with a coarser version of another map. The voxel grid has
+  /// the minimum corner and the capacity of the other map's grid and `factor` times its voxel
+  /// size, so that each coarse voxel covers whole voxels of the other map. The maximum corner is
+  /// rounded up to whole coarse voxels. The usable voxels falling into the same coarse voxel are
+  /// merged into a single Gaussian by matching its first two moments, with an equal weight per
+  /// voxel since static voxels don't store their number of points. The merged covariance is
+  /// stabilized as in the dynamic map and voxels whose covariance can't be stabilized are
+  /// dropped. The frame id and the stamp are copied.
+  /// \param fine Map to coarsen, which must be a different map.
+  /// \param factor Ratio of the voxel sizes of this map and the other map.
+  /// \throws std::domain_error if the factor is zero or if the map is given to coarsen itself.
+  /// \throws std::runtime_error if the other map isn't set.
+  void set_coarsened(const BasicStaticNDTMap & fine, const uint32_t factor);
+
   /// Lookup the cell at location.
   /// \param pt point to lookup
-  /// \return A vector containing the cell at given coordinates. A vector is used to support
-  /// near-neighbour cell queries in the future.
+  /// \return A vector containing the usable cells around the given point, as configured by
+  /// the lookup mode.
   const VoxelViewVector & cell(const Point & pt) const;
 
   /// Lookup the cell at location.
   /// \param x x coordinate
   /// \param y y coordinate
   /// \param z z coordinate
-  /// \return A vector containing the cell at given coordinates. A vector is used to support
-  /// near-neighbour cell queries in the future.
+  /// \return A vector containing the usable cells around the given coordinates, as configured by
+  /// the lookup mode.
   const VoxelViewVector & cell(float32_t x, float32_t y, float32_t z) const;
 
+  /// Lookup the cell at location into a caller owned vector. This lookup can be called
+  /// concurrently.
+  /// \param pt point to lookup
+  /// \param output Vector to be filled with the usable cells around the given point, as
+  /// configured by the lookup mode.
+  void cell(const Point & pt, VoxelViewVector & output) const;
+
   /// Get map's frame id.
   /// \return Frame id of the map.
   const std::string & frame_id() const noexcept;
@@ -199,10 +319,21 @@ private:
   /// Deserialize the given serialized point cloud map.
   /// \param msg PointCloud2 message containing the deserialized data.
   void deserialize_from(const sensor_msgs::msg::PointCloud2 & msg);
-  std::experimental::optional<NDTGrid<StaticNDTVoxel>> m_grid{};
+  std::experimental::optional<NDTGrid<Voxel>> m_grid{};
+  CellLookupMode m_lookup_mode;
+  // Indices contained in the last incremental update, kept to reuse the allocation.
+  std::unordered_set<uint64_t> m_updated_indices{};
   TimePoint m_stamp{};
   std::string m_frame_id{};
 };
+
+/// Static map with double precision voxels.
+using StaticNDTMap = BasicStaticNDTMap<StaticNDTVoxel>;
+/// Static map with single precision voxels, which takes less than half the memory.
+using PackedStaticNDTMap = BasicStaticNDTMap<PackedNDTVoxel>;
+
+extern template class BasicStaticNDTMap<StaticNDTVoxel>;
+extern template class BasicStaticNDTMap<PackedNDTVoxel>;
 }  // namespace ndt
 }  // namespace localization
 }  // namespace autoware
@@ -0,0 +1,175 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#ifndef NDT__NDT_MAP_BINARY_HPP_
+#define NDT__NDT_MAP_BINARY_HPP_
+
+#include <common/types.hpp>
+#include <ndt/ndt_map.hpp>
+#include <ndt/visibility_control.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace autoware
+{
+namespace localization
+{
+namespace ndt
+{
+using autoware::common::types::float32_t;
+using autoware::common::types::float64_t;
+
+/// Version of the binary ndt map layout. Increment whenever `NDTMapBinaryHeader` or
+/// `NDTMapBinaryVoxel` change.
+static constexpr uint32_t kNDTMapBinaryVersion = 1U;
+
+/// Magic bytes at the beginning of every binary ndt map file.
+static constexpr std::array<char, 8U> kNDTMapBinaryMagic{{'N', 'D', 'T', 'M', 'A', 'P', '\0',
+    '\0'}};
+
+/// Header of a binary ndt map file. The header is followed by `num_voxels` records of type
+/// `NDTMapBinaryVoxel`. All values are stored in the native byte order of the writing machine.
+struct NDTMapBinaryHeader
+{
+  std::array<char, 8U> magic;
+  uint32_t version;
+  /// Size of a single voxel record in bytes, used to detect layout mismatches.
+  uint32_t voxel_record_size;
+  std::array<float32_t, 3U> min_point;
+  std::array<float32_t, 3U> max_point;
+  std::array<float32_t, 3U> voxel_size;
+  uint32_t reserved;
+  uint64_t num_voxels;
+  /// Stamp of the map in nanoseconds since epoch.
+  int64_t stamp_ns;
+  /// Null terminated frame id of the map.
+  std::array<char, 64U> frame_id;
+};
+
+/// A single pre-computed ndt voxel as stored in a binary ndt map file.
+struct NDTMapBinaryVoxel
+{
+  /// Index of the voxel in the voxel grid described by the file header.
+  uint64_t index;
+  std::array<float64_t, 3U> centroid;
+  /// Upper triangle of the inverse covariance: xx, xy, xz, yy, yz, zz.
+  std::array<float64_t, 6U> inv_covariance;
+};
+
+static_assert(
+  std::is_trivially_copyable<NDTMapBinaryHeader>::value &&
+  std::is_standard_layout<NDTMapBinaryHeader>::value,
+  "NDTMapBinaryHeader must be readable directly from a mapped file.");
+static_assert(
+  std::is_trivially_copyable<NDTMapBinaryVoxel>::value &&
+  std::is_standard_layout<NDTMapBinaryVoxel>::value,
+  "NDTMapBinaryVoxel must be readable directly from a mapped file.");
+static_assert(
+  (sizeof(NDTMapBinaryHeader) % alignof(NDTMapBinaryVoxel)) == 0U,
+  "Voxel records following the header must be aligned.");
+
+/// Convert the usable voxels of a dense ndt map into binary voxel records. Only voxels with an
+/// invertible covariance are converted, identical to `DynamicNDTMap::serialize_as<StaticNDTMap>`.
+/// \param map Map to convert.
+/// \return Voxel records of the map.
+std::vector<NDTMapBinaryVoxel> NDT_PUBLIC make_ndt_map_binary_voxels(const DynamicNDTMap & map);
+
+/// Write the given voxel records into a binary ndt map file, using the voxel grid configuration,
+/// frame id and stamp of the map they were created from. Throws if the file cannot be written.
+/// \param map Map the voxels were created from.
+/// \param voxels Voxel records to write.
+/// \param file_name Name of the output file.
+/// \return Number of voxels written.
+std::size_t NDT_PUBLIC write_ndt_map_binary(
+  const DynamicNDTMap & map,
+  const std::vector<NDTMapBinaryVoxel> & voxels,
+  const std::string & file_name);
+
+/// Write the usable voxels of a dense ndt map into a binary ndt map file.
+/// Throws if the file cannot be written.
+/// \param map Map to write.
+/// \param file_name Name of the output file.
+/// \return Number of voxels written.
+std::size_t NDT_PUBLIC write_ndt_map_binary(
+  const DynamicNDTMap & map,
+  const std::string & file_name);
+
+/// Read only memory mapping of a binary ndt map file. The file is validated on construction and
+/// the voxel records can be accessed directly from the mapped pages without any parsing.
+class NDT_PUBLIC NDTMapBinaryFile
+{
+public:
+  /// Map the given file into memory. Throws if the file cannot be mapped or does not contain a
+  /// valid binary ndt map of the current version.
+  /// \param file_name Name of the binary ndt map file.
+  explicit NDTMapBinaryFile(const std::string & file_name);
+  ~NDTMapBinaryFile();
+
+  NDTMapBinaryFile(const NDTMapBinaryFile &) = delete;
+  NDTMapBinaryFile & operator=(const NDTMapBinaryFile &) = delete;
+  NDTMapBinaryFile(NDTMapBinaryFile &&) = delete;
+  NDTMapBinaryFile & operator=(NDTMapBinaryFile &&) = delete;
+
+  /// Get the header of the file.
+  /// \return File header.
+  const NDTMapBinaryHeader & header() const noexcept;
+
+  /// Get the voxel grid config described by the header, with the capacity set to the number of
+  /// voxels in the file.
+  /// \return Voxel grid config.
+  DynamicNDTMap::Config config() const;
+
+  /// Get map's frame id.
+  /// \return Frame id of the map.
+  std::string frame_id() const;
+
+  /// Get the number of voxel records in the file.
+  /// \return Number of voxels.
+  std::size_t size() const noexcept;
+
+  /// \brief Returns a pointer to the first voxel record in the mapped file.
+  /// \return Pointer to the first record.
+  const NDTMapBinaryVoxel * begin() const noexcept;
+
+  /// \brief Returns a pointer to one past the last voxel record in the mapped file.
+  /// \return Pointer to one past the last record.
+  const NDTMapBinaryVoxel * end() const noexcept;
+
+private:
+  void * m_data{nullptr};
+  std::size_t m_size{0U};
+};
+
+/// Convert a binary ndt map into the serialized point cloud format understood by
+/// `StaticNDTMap::set(...)`. The result is identical to serializing the original dense map via
+/// `DynamicNDTMap::serialize_as<StaticNDTMap>(...)`.
+/// \param file Mapped binary ndt map.
+/// \param msg_out Reference to the pointcloud message that will store the serialized map data.
+/// The message will be initialized before use.
+void NDT_PUBLIC serialize_from_binary(
+  const NDTMapBinaryFile & file,
+  sensor_msgs::msg::PointCloud2 & msg_out);
+
+}  // namespace ndt
+}  // namespace localization
+}  // namespace autoware
+
+#endif  // NDT__NDT_MAP_BINARY_HPP_
@@ -75,6 +75,12 @@ void NDT_PUBLIC read_from_pcd(
   const std::string & file_name,
   sensor_msgs::msg::PointCloud2 * msg);
 
+/// Read the map origin from the yaml file and convert it into a geocentric pose. Throws if the
+/// file name is empty or the file cannot be read.
+/// \param yaml_file_name File name of the yaml file.
+/// \return The geocentric position.
+geocentric_pose_t NDT_PUBLIC load_map_origin(const std::string & yaml_file_name);
+
 /// \brief  Read the pcd file with filename into a PointCloud2 message, transform it into an NDT
 /// representation and then serialize the ndt representation back into a PointCloud2 message
 /// that can be published.
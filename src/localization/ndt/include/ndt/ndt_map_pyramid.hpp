@@ -0,0 +1,121 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#ifndef NDT__NDT_MAP_PYRAMID_HPP_
+#define NDT__NDT_MAP_PYRAMID_HPP_
+
+#include <common/types.hpp>
+#include <ndt/ndt_map.hpp>
+#include <ndt/visibility_control.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace autoware
+{
+namespace localization
+{
+namespace ndt
+{
+class NDTMapBinaryFile;
+
+/// Static ndt maps of the same area at several resolutions, for coarse-to-fine registration.
+/// Large voxels give the optimization a wide basin of convergence while small voxels give an
+/// accurate result. Level 0 holds the map as it is set, each further level has `level_scale`
+/// times the voxel size of the previous level and is rebuilt from level 0 (see
+/// `BasicStaticNDTMap::set_coarsened(...)`) whenever level 0 changes.
+/// \tparam VoxelT Type of the static voxels of all levels. Use the `NDTMapPyramid` and
+/// `PackedNDTMapPyramid` aliases.
+template<typename VoxelT>
+class NDT_PUBLIC BasicNDTMapPyramid
+{
+public:
+  using Map = BasicStaticNDTMap<VoxelT>;
+  using TimePoint = typename Map::TimePoint;
+
+  /// Constructor
+  /// \param num_levels Number of resolutions, including the finest one.
+  /// \param level_scale Ratio of the voxel sizes of consecutive levels.
+  /// \param lookup_mode Which cells are returned by the lookups of all levels.
+  /// \throws std::domain_error if there are no levels or if the scale is below 2.
+  explicit BasicNDTMapPyramid(
+    const std::size_t num_levels = 3U,
+    const uint32_t level_scale = 2U,
+    const CellLookupMode lookup_mode = CellLookupMode::SINGLE);
+
+  /// Set the finest level from a point cloud map and rebuild the coarser levels.
+  /// See `BasicStaticNDTMap::set(...)`.
+  /// \param msg PointCloud2 message representing the map.
+  void set(const sensor_msgs::msg::PointCloud2 & msg);
+
+  /// Set the finest level from a memory mapped binary ndt map and rebuild the coarser levels.
+  /// \param file Mapped binary ndt map.
+  void set(const NDTMapBinaryFile & file);
+
+  /// Merge the voxels of a memory mapped binary ndt map into the finest level and rebuild the
+  /// coarser levels. See `BasicStaticNDTMap::insert(...)`.
+  /// \param file Mapped binary ndt map.
+  void insert(const NDTMapBinaryFile & file);
+
+  /// Remove the voxels of a memory mapped binary ndt map from the finest level and rebuild the
+  /// coarser levels.
+  /// \param file Mapped binary ndt map.
+  void remove(const NDTMapBinaryFile & file);
+
+  /// Get the number of resolutions.
+  /// \return Number of levels, including the finest one.
+  std::size_t num_levels() const noexcept;
+
+  /// Get the map of a resolution.
+  /// \param index Index of the level, 0 is the finest one.
+  /// \return Map of the level.
+  /// \throws std::out_of_range if there is no such level.
+  const Map & level(const std::size_t index) const;
+
+  /// Get map's frame id.
+  /// \return Frame id of the map.
+  const std::string & frame_id() const noexcept;
+
+  /// Get map's time stamp.
+  /// \return map's time stamp.
+  TimePoint stamp() const noexcept;
+
+  /// \brief Check if the finest level is valid.
+  /// \return True if the finest level is valid.
+  bool valid() const noexcept;
+
+private:
+  /// Rebuild the coarser levels from the finest one.
+  void build_coarse_levels();
+
+  std::vector<Map> m_levels{};
+  uint32_t m_level_scale;
+};
+
+/// Pyramid of static maps with double precision voxels.
+using NDTMapPyramid = BasicNDTMapPyramid<StaticNDTVoxel>;
+/// Pyramid of static maps with single precision voxels.
+using PackedNDTMapPyramid = BasicNDTMapPyramid<PackedNDTVoxel>;
+
+extern template class BasicNDTMapPyramid<StaticNDTVoxel>;
+extern template class BasicNDTMapPyramid<PackedNDTVoxel>;
+}  // namespace ndt
+}  // namespace localization
+}  // namespace autoware
+#endif  // NDT__NDT_MAP_PYRAMID_HPP_
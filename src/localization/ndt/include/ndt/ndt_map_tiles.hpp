@@ -0,0 +1,182 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#ifndef NDT__NDT_MAP_TILES_HPP_
+#define NDT__NDT_MAP_TILES_HPP_
+
+#include <common/types.hpp>
+#include <ndt/ndt_map.hpp>
+#include <ndt/ndt_map_binary.hpp>
+#include <ndt/visibility_control.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace autoware
+{
+namespace localization
+{
+namespace ndt
+{
+using autoware::common::types::bool8_t;
+using autoware::common::types::float64_t;
+
+/// Index of a square map tile in the x-y plane. Tile (x, y) covers the area
+/// [x * tile_size, (x + 1) * tile_size) x [y * tile_size, (y + 1) * tile_size).
+struct NDTMapTileIndex
+{
+  int32_t x;
+  int32_t y;
+
+  friend bool8_t operator==(const NDTMapTileIndex & lhs, const NDTMapTileIndex & rhs) noexcept
+  {
+    return (lhs.x == rhs.x) && (lhs.y == rhs.y);
+  }
+};
+
+/// Hash functor for tile indices.
+struct NDT_PUBLIC NDTMapTileIndexHash
+{
+  std::size_t operator()(const NDTMapTileIndex & index) const noexcept;
+};
+
+/// Get the index of the tile containing the given position.
+/// \param x x coordinate
+/// \param y y coordinate
+/// \param tile_size Edge length of the tiles.
+/// \return Index of the tile containing the position.
+NDTMapTileIndex NDT_PUBLIC tile_index(float64_t x, float64_t y, float64_t tile_size);
+
+/// Get the file name of a tile in a tile directory.
+/// \param directory Directory containing the tiles.
+/// \param index Index of the tile.
+/// \return File name of the tile.
+std::string NDT_PUBLIC tile_file_name(const std::string & directory, const NDTMapTileIndex & index);
+
+/// Split the usable voxels of a dense ndt map into square tiles by their centroid and write each
+/// tile as a binary ndt map file into the given directory. All tiles share the voxel grid
+/// configuration of the map, so they can be merged into a single `StaticNDTMap`. The tile size
+/// is stored in a metadata file next to the tiles. Throws if the tiles cannot be written.
+/// \param map Map to write.
+/// \param tile_size Edge length of the tiles.
+/// \param directory Output directory. It is created if it doesn't exist.
+/// \return Number of tiles written.
+std::size_t NDT_PUBLIC write_ndt_map_tiles(
+  const DynamicNDTMap & map,
+  float64_t tile_size,
+  const std::string & directory);
+
+/// Read the tile size of a tile directory written by `write_ndt_map_tiles(...)`.
+/// Throws if the metadata file cannot be read.
+/// \param directory Directory containing the tiles.
+/// \return Edge length of the tiles.
+float64_t NDT_PUBLIC read_tile_size(const std::string & directory);
+
+/// Streams the tiles of a tiled ndt map around a moving position. Tiles are memory mapped on a
+/// background thread and the resulting additions and evictions are merged into a
+/// `StaticNDTMap` by the owner of the map via `apply_updates(...)`, so the map is never rebuilt
+/// and lookups don't need synchronization.
+class NDT_PUBLIC NDTMapTileLoader
+{
+public:
+  /// Constructor. Starts the background thread.
+  /// \param directory Directory containing the tiles, as written by `write_ndt_map_tiles(...)`.
+  /// \param radius Tiles intersecting the circle of this radius around the position are loaded.
+  /// Loaded tiles are evicted once they're further than `radius + tile_size` away to avoid
+  /// reloading tiles when the position moves along a tile border.
+  /// \throws std::domain_error if the radius is not positive.
+  NDTMapTileLoader(const std::string & directory, float64_t radius);
+
+  /// Destructor. Stops the background thread.
+  ~NDTMapTileLoader();
+
+  NDTMapTileLoader(const NDTMapTileLoader &) = delete;
+  NDTMapTileLoader & operator=(const NDTMapTileLoader &) = delete;
+  NDTMapTileLoader(NDTMapTileLoader &&) = delete;
+  NDTMapTileLoader & operator=(NDTMapTileLoader &&) = delete;
+
+  /// Set the position to load the tiles around. This call doesn't block; only the latest
+  /// position is processed if the background thread is busy.
+  /// \param x x coordinate in the map frame.
+  /// \param y y coordinate in the map frame.
+  void set_position(float64_t x, float64_t y);
+
+  /// Merge all tile additions and evictions finished since the last call into the map.
+  /// Rethrows errors that occurred while loading tiles.
+  /// \param map Map to update, a `StaticNDTMap` or a `PackedStaticNDTMap`.
+  /// \return True if the map was modified.
+  template<typename VoxelT>
+  bool8_t apply_updates(BasicStaticNDTMap<VoxelT> & map);
+
+  /// Block until the latest position was processed by the background thread.
+  void wait_until_idle();
+
+  /// Get the edge length of the tiles.
+  /// \return Tile size.
+  float64_t tile_size() const noexcept;
+
+  /// Get the number of tiles currently held by the loader, including updates that have not been
+  /// applied yet.
+  /// \return Number of loaded tiles.
+  std::size_t num_loaded_tiles() const;
+
+private:
+  using TilePtr = std::shared_ptr<const NDTMapBinaryFile>;
+
+  /// A tile to be added to or removed from the map.
+  struct TileUpdate
+  {
+    TilePtr tile;
+    bool8_t add;
+  };
+
+  /// Main loop of the background thread.
+  void run();
+
+  /// Load and evict tiles around the given position. Called by the background thread.
+  void update_tiles(float64_t x, float64_t y);
+
+  const std::string m_directory;
+  const float64_t m_tile_size;
+  const float64_t m_radius;
+  mutable std::mutex m_mutex{};
+  std::condition_variable m_wake_up{};
+  std::condition_variable m_idle{};
+  float64_t m_x{0.0};
+  float64_t m_y{0.0};
+  bool8_t m_position_pending{false};
+  bool8_t m_busy{false};
+  bool8_t m_stop{false};
+  std::vector<TileUpdate> m_pending_updates{};
+  std::exception_ptr m_error{nullptr};
+  // Tiles are only accessed by the background thread except for their count. Tiles without a
+  // file are stored as null pointers so the file system isn't queried repeatedly.
+  std::unordered_map<NDTMapTileIndex, TilePtr, NDTMapTileIndexHash> m_tiles{};
+  std::thread m_thread;
+};
+
+}  // namespace ndt
+}  // namespace localization
+}  // namespace autoware
+
+#endif  // NDT__NDT_MAP_TILES_HPP_
@@ -67,11 +67,18 @@
 #include <experimental/optional>
 #include <Eigen/Core>
 #include <Eigen/Geometry>
+#include <Eigen/StdVector>
+#include <algorithm>
+#include <array>
+#include <iterator>
 #include <limits>
+#include <thread>
 #include <tuple>
+#include <vector>
 #include "common/types.hpp"
 
 using autoware::common::types::bool8_t;
+using autoware::common::types::float32_t;
 using autoware::common::types::float64_t;
 
 namespace autoware
@@ -90,6 +97,32 @@ bool8_t is_valid_probability(ScalarT p)
   return std::isfinite(p) && abs_lte(p, 1.0, eps) && abs_gte(p, 0.0, eps);
 }
 
+/// Compute the gaussian fitting parameters (eq. 6.8) [Magnusson 2009]
+/// \tparam CellSizeT Type of the cell size, with `x`, `y` and `z` members.
+/// \param outlier_ratio Outlier ratio to be used in the gaussian distribution variation
+/// used in (eq. 6.7) [Magnusson 2009]
+/// \param c_size Cell size of the map.
+/// \param[out] gauss_d1 The d_1 parameter.
+/// \param[out] gauss_d2 The d_2 parameter.
+/// \throws std::domain_error if the outlier ratio is not between 0 and 1.
+template<typename CellSizeT>
+void compute_gauss_parameters(
+  const Real outlier_ratio, const CellSizeT & c_size, Real & gauss_d1, Real & gauss_d2)
+{
+  if (!is_valid_probability(outlier_ratio)) {
+    throw std::domain_error("Outlier ratio must be between 0 and 1");
+  }
+  // The gaussian fitting parameters below are taken from the PCL implementation.
+  // 10.0 seems to be a magic number. For details on the gaussian
+  // approximation of the mixture probability in see [Biber et al, 2004] and [Magnusson 2009].
+  const auto gauss_c1 = 10.0 * (1.0 - outlier_ratio);
+  const auto gauss_c2 = outlier_ratio / static_cast<Real>(c_size.x * c_size.y * c_size.z);
+  const auto gauss_d3 = -std::log(gauss_c2);
+  gauss_d1 = -std::log(gauss_c1 + gauss_c2) - gauss_d3;
+  gauss_d2 = -2 *
+    std::log((-std::log(gauss_c1 * std::exp(-0.5) + gauss_c2) - gauss_d3) / gauss_d1);
+}
+
 /// P2D ndt objective. This class implements the P2D ndt score function, its analytical
 /// jacobian and hessian values.
 /// \tparam MapT Type of map to be used. This type should conform the interface specified in
@@ -127,103 +160,77 @@ public:
   ///
   P2DNDTObjective(
     const P2DNDTScan & scan, const Map & map, const P2DNDTOptimizationConfig config)
-  : m_scan_ref(scan), m_map_ref(map)
+  : m_scan_ref(scan), m_map_ref(map),
+    m_single_precision_gradient{config.single_precision_gradient()},
+    m_partitions(config.num_threads())
   {
     init(config.outlier_ratio());
   }
 
+  /// Evaluate the objective. The scan is split into `num_threads` contiguous partitions, each of
+  /// which is accumulated separately. The partial results are then summed in partition order so
+  /// that the result only depends on the number of threads and not on thread scheduling.
+  /// \param x Pose to evaluate the objective at.
+  /// \param mode Which of the score, jacobian and hessian to compute.
   void evaluate_(const DomainValue & x, const ComputeMode & mode)
   {
     // Convert pose vector to transform matrix for easy point transformation
-    Eigen::Transform<float64_t, 3, Eigen::Affine, Eigen::ColMajor> transform;
+    Transform transform;
     transform.setIdentity();
     transform_adapters::pose_to_transform(x, transform);
 
-    Value score{0.0};
-
-    Jacobian jacobian;
     std::experimental::optional<GradientAngleParameters> grad_params;
-
-    Hessian hessian;
     std::experimental::optional<HessianAngleParameters> hessian_params;
-
     {
       // Angle parameters to be used by all elements (eq. 6.12) [Magnusson 2009]
       const AngleParameters angle_params{x};
       // Only construct jacobian/hessian variables if they are needed.
       if (mode.jacobian() || mode.hessian()) {
-        jacobian.setZero();
         grad_params.emplace(angle_params);
       }
       if (mode.hessian()) {
-        hessian.setZero();
         hessian_params.emplace(angle_params);
       }
     }
-
-    for (const auto & pt : m_scan_ref) {
-      PointGrad point_gradient;
-      PointHessian point_hessian;
-
-      if (mode.jacobian() || mode.hessian()) {
-        point_gradient.setZero();
-        point_gradient.block<3, 3>(0, 0).setIdentity();
-        compute_point_gradients(grad_params.value(), pt, point_gradient);
-
-        if (mode.hessian()) {
-          point_hessian.setZero();
-          compute_point_hessians(hessian_params.value(), pt, point_hessian);
-        }
+    const EvaluationContext context{transform, mode, grad_params, hessian_params};
+
+    const auto num_points = m_scan_ref.size();
+    const auto num_partitions = m_partitions.size();
+    const auto partition_size = (num_points + num_partitions - 1U) / num_partitions;
+    const auto evaluate_partition = [this, &context, num_points, partition_size](std::size_t i) {
+        const auto begin_idx = std::min(i * partition_size, num_points);
+        const auto end_idx = std::min(begin_idx + partition_size, num_points);
+        evaluate_range(begin_idx, end_idx, context, m_partitions[i]);
+      };
+
+    if (num_partitions == 1U) {
+      evaluate_partition(0U);
+    } else {
+      // The calling thread evaluates the first partition itself.
+      std::vector<std::thread> workers;
+      workers.reserve(num_partitions - 1U);
+      for (auto i = 1U; i < num_partitions; ++i) {
+        workers.emplace_back(evaluate_partition, i);
       }
+      evaluate_partition(0U);
+      for (auto & worker : workers) {
+        worker.join();
+      }
+    }
 
-      const Point pt_trans = transform * pt;
-      const auto & cells = m_map_ref.cell(pt_trans);
-
-      for (const auto & cell : cells) {
-        const Point pt_trans_norm = pt_trans - cell.centroid();
-        // Cell iteration used for compatibility with maps with multi-cell lookup
-        if (!cell.usable()) {
-          continue;
-        }
-        const auto & inv_cov = cell.inverse_covariance();
-        // e^(-d_2/2 * (x_k - mu_k)^T Sigma_k^-1 (x_k - mu_k)) Equation 6.9 [Magnusson 2009]
-        Real e_minus_half_d2_x_cov_x =
-          std::exp(-m_gauss_d2 * pt_trans_norm.dot(inv_cov * pt_trans_norm) / 2.0);
-
-        if (mode.score()) {
-          score += -m_gauss_d1 * e_minus_half_d2_x_cov_x;
-        }
-
-        if (!mode.jacobian() && !mode.hessian()) {
-          continue;
-        }
-        const auto d2_e_minus_half_d2_x_cov_x = m_gauss_d2 * e_minus_half_d2_x_cov_x;
-
-        // Error checking for invalid values.
-        if (!is_valid_probability(d2_e_minus_half_d2_x_cov_x)) {
-          continue;
-        }
-
-        // Reusable portion of Equation 6.12 and 6.13 [Magnusson 2009]
-        const auto d1_d2_e_minus_half_d2_x_cov_x = m_gauss_d1 * d2_e_minus_half_d2_x_cov_x;
-
-        for (auto i = 0U; i < jacobian.rows(); ++i) {
-          const Point cov_dxd_pi = inv_cov * point_gradient.col(i);
-          if (mode.jacobian()) {
-            jacobian(i) += pt_trans_norm.dot(cov_dxd_pi) * d1_d2_e_minus_half_d2_x_cov_x;
-          }
-          if (mode.hessian()) {
-            for (auto j = 0U; j < hessian.cols(); ++j) {
-              hessian(i, j) += d1_d2_e_minus_half_d2_x_cov_x *
-                (-m_gauss_d2 * pt_trans_norm.dot(cov_dxd_pi) *
-                pt_trans_norm.dot(inv_cov * point_gradient.col(j)) +
-                pt_trans_norm.dot(inv_cov * point_hessian.block<3, 1>(3 * i, j)) +
-                point_gradient.col(j).dot(cov_dxd_pi));
-            }
-          }
-        }
+    Value score{0.0};
+    Jacobian jacobian{Jacobian::Zero()};
+    Hessian hessian{Hessian::Zero()};
+    for (const auto & partition : m_partitions) {
+      score += partition.score;
+      if (mode.jacobian()) {
+        jacobian += partition.jacobian;
+      }
+      if (mode.hessian()) {
+        hessian += partition.hessian;
       }
     }
+
     if (mode.score()) {
       this->set_score(score);
     }
@@ -396,10 +403,249 @@ public:
       h_ang_f1, h_ang_f2, h_ang_f3;
   };
 
+  using Transform = P2DNDTScan::Transform;
+
+  /// Inputs shared by all the partitions of a single evaluation.
+  struct EvaluationContext
+  {
+    const Transform & transform;
+    const ComputeMode & mode;
+    const std::experimental::optional<GradientAngleParameters> & grad_params;
+    const std::experimental::optional<HessianAngleParameters> & hessian_params;
+  };
+
+  /// Point-cell pairs of a partition in a structure-of-arrays layout, used by the single precision
+  /// kernel. Only the untransformed point, the distance of the transformed point to the cell
+  /// centroid and the unique elements of the symmetric inverse covariance are needed.
+  struct SoATerms
+  {
+    void clear() noexcept
+    {
+      for (auto * const column : columns()) {
+        column->clear();
+      }
+    }
+
+    void push_back(const Point & pt, const Point & pt_trans_norm, const Eigen::Matrix3d & inv_cov)
+    {
+      px.push_back(static_cast<float32_t>(pt(0)));
+      py.push_back(static_cast<float32_t>(pt(1)));
+      pz.push_back(static_cast<float32_t>(pt(2)));
+      nx.push_back(static_cast<float32_t>(pt_trans_norm(0)));
+      ny.push_back(static_cast<float32_t>(pt_trans_norm(1)));
+      nz.push_back(static_cast<float32_t>(pt_trans_norm(2)));
+      c00.push_back(static_cast<float32_t>(inv_cov(0, 0)));
+      c01.push_back(static_cast<float32_t>(inv_cov(0, 1)));
+      c02.push_back(static_cast<float32_t>(inv_cov(0, 2)));
+      c11.push_back(static_cast<float32_t>(inv_cov(1, 1)));
+      c12.push_back(static_cast<float32_t>(inv_cov(1, 2)));
+      c22.push_back(static_cast<float32_t>(inv_cov(2, 2)));
+    }
+
+    std::size_t size() const noexcept
+    {
+      return px.size();
+    }
+
+    std::array<std::vector<float32_t> *, 12U> columns() noexcept
+    {
+      return {&px, &py, &pz, &nx, &ny, &nz, &c00, &c01, &c02, &c11, &c12, &c22};
+    }
+
+    std::vector<float32_t> px, py, pz, nx, ny, nz, c00, c01, c02, c11, c12, c22;
+  };
+
+  /// Accumulator and scratch space owned by a single partition of the scan.
+  struct Partition
+  {
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    Value score{0.0};
+    Jacobian jacobian;
+    Hessian hessian;
+    typename Map::VoxelViewVector cells;
+    SoATerms terms;
+    P2DNDTScan::TransformedPoints transformed_points;
+  };
+
+  /// Evaluate the objective for a range of scan points.
+  /// \param begin_idx Index of the first point.
+  /// \param end_idx Index past the last point.
+  /// \param context Inputs of the evaluation.
+  /// \param partition Partition to accumulate the result into.
+  void evaluate_range(
+    const std::size_t begin_idx, const std::size_t end_idx,
+    const EvaluationContext & context, Partition & partition) const
+  {
+    const auto & mode = context.mode;
+    partition.score = 0.0;
+    partition.jacobian.setZero();
+    partition.hessian.setZero();
+    // All points of the partition are transformed at once.
+    m_scan_ref.transform(context.transform, begin_idx, end_idx, partition.transformed_points);
+    const auto num_points = end_idx - begin_idx;
+
+    if (m_single_precision_gradient && !mode.hessian()) {
+      partition.terms.clear();
+      for (std::size_t k = 0U; k < num_points; ++k) {
+        const Point pt_trans = partition.transformed_points.row(static_cast<Eigen::Index>(k));
+        m_map_ref.cell(pt_trans, partition.cells);
+        for (const auto & cell : partition.cells) {
+          partition.terms.push_back(
+            m_scan_ref.point(begin_idx + k), pt_trans - cell.centroid(),
+            cell.inverse_covariance());
+        }
+      }
+      evaluate_terms_single_precision(context, partition);
+      return;
+    }
+
+    auto & score = partition.score;
+    auto & jacobian = partition.jacobian;
+    auto & hessian = partition.hessian;
+    for (std::size_t k = 0U; k < num_points; ++k) {
+      const Point pt = m_scan_ref.point(begin_idx + k);
+      PointGrad point_gradient;
+      PointHessian point_hessian;
+
+      if (mode.jacobian() || mode.hessian()) {
+        point_gradient.setZero();
+        point_gradient.block<3, 3>(0, 0).setIdentity();
+        compute_point_gradients(context.grad_params.value(), pt, point_gradient);
+
+        if (mode.hessian()) {
+          point_hessian.setZero();
+          compute_point_hessians(context.hessian_params.value(), pt, point_hessian);
+        }
+      }
+
+      const Point pt_trans = partition.transformed_points.row(static_cast<Eigen::Index>(k));
+      m_map_ref.cell(pt_trans, partition.cells);
+
+      for (const auto & cell : partition.cells) {
+        const Point pt_trans_norm = pt_trans - cell.centroid();
+        // Cell iteration used for compatibility with maps with multi-cell lookup
+        if (!cell.usable()) {
+          continue;
+        }
+        const auto & inv_cov = cell.inverse_covariance();
+        // e^(-d_2/2 * (x_k - mu_k)^T Sigma_k^-1 (x_k - mu_k)) Equation 6.9 [Magnusson 2009]
+        Real e_minus_half_d2_x_cov_x =
+          std::exp(-m_gauss_d2 * pt_trans_norm.dot(inv_cov * pt_trans_norm) / 2.0);
+
+        if (mode.score()) {
+          score += -m_gauss_d1 * e_minus_half_d2_x_cov_x;
+        }
+
+        if (!mode.jacobian() && !mode.hessian()) {
+          continue;
+        }
+        const auto d2_e_minus_half_d2_x_cov_x = m_gauss_d2 * e_minus_half_d2_x_cov_x;
+
+        // Error checking for invalid values.
+        if (!is_valid_probability(d2_e_minus_half_d2_x_cov_x)) {
+          continue;
+        }
+
+        // Reusable portion of Equation 6.12 and 6.13 [Magnusson 2009]
+        const auto d1_d2_e_minus_half_d2_x_cov_x = m_gauss_d1 * d2_e_minus_half_d2_x_cov_x;
+
+        for (auto i = 0U; i < jacobian.rows(); ++i) {
+          const Point cov_dxd_pi = inv_cov * point_gradient.col(i);
+          if (mode.jacobian()) {
+            jacobian(i) += pt_trans_norm.dot(cov_dxd_pi) * d1_d2_e_minus_half_d2_x_cov_x;
+          }
+          if (mode.hessian()) {
+            for (auto j = 0U; j < hessian.cols(); ++j) {
+              hessian(i, j) += d1_d2_e_minus_half_d2_x_cov_x *
+                (-m_gauss_d2 * pt_trans_norm.dot(cov_dxd_pi) *
+                pt_trans_norm.dot(inv_cov * point_gradient.col(j)) +
+                pt_trans_norm.dot(inv_cov * point_hessian.block<3, 1>(3 * i, j)) +
+                point_gradient.col(j).dot(cov_dxd_pi));
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /// Single precision score and jacobian kernel over the gathered point-cell pairs. The loop
+  /// body is branch free and only reads contiguous arrays so that it can be vectorized. It
+  /// computes the same terms as the double precision path, but with the sparsity of the point
+  /// gradient (eq. 6.18) [Magnusson 2009] exploited explicitly.
+  /// \param context Inputs of the evaluation.
+  /// \param partition Partition containing the gathered terms and the accumulator.
+  void evaluate_terms_single_precision(
+    const EvaluationContext & context, Partition & partition) const
+  {
+    const auto & terms = partition.terms;
+    const auto num_terms = terms.size();
+    const auto compute_jacobian = context.mode.jacobian();
+    const auto gauss_d1 = static_cast<float32_t>(m_gauss_d1);
+    const auto gauss_d2 = static_cast<float32_t>(m_gauss_d2);
+    constexpr auto eps = std::numeric_limits<float32_t>::epsilon();
+    std::array<float32_t, 24U> j_ang{};
+    if (compute_jacobian) {
+      const auto & params = context.grad_params.value();
+      const std::array<const Point *, 8U> j_ang_vectors{&params.j_ang_a, &params.j_ang_b,
+        &params.j_ang_c, &params.j_ang_d, &params.j_ang_e, &params.j_ang_f, &params.j_ang_g,
+        &params.j_ang_h};
+      for (auto i = 0U; i < j_ang_vectors.size(); ++i) {
+        for (auto j = 0U; j < 3U; ++j) {
+          j_ang[(3U * i) + j] = static_cast<float32_t>((*j_ang_vectors[i])(j));
+        }
+      }
+    }
+
+    float64_t score{0.0};
+    std::array<float64_t, 6U> jacobian{};
+    for (auto k = 0U; k < num_terms; ++k) {
+      const auto x = terms.px[k];
+      const auto y = terms.py[k];
+      const auto z = terms.pz[k];
+      const auto nx = terms.nx[k];
+      const auto ny = terms.ny[k];
+      const auto nz = terms.nz[k];
+      // Sigma_k^-1 (x_k - mu_k)
+      const auto q0 = (terms.c00[k] * nx) + (terms.c01[k] * ny) + (terms.c02[k] * nz);
+      const auto q1 = (terms.c01[k] * nx) + (terms.c11[k] * ny) + (terms.c12[k] * nz);
+      const auto q2 = (terms.c02[k] * nx) + (terms.c12[k] * ny) + (terms.c22[k] * nz);
+      // Equation 6.9 [Magnusson 2009]
+      const auto e_minus_half_d2_x_cov_x =
+        std::exp(-gauss_d2 * ((nx * q0) + (ny * q1) + (nz * q2)) / 2.0F);
+      score += static_cast<float64_t>(-gauss_d1 * e_minus_half_d2_x_cov_x);
+      if (!compute_jacobian) {
+        continue;
+      }
+      const auto d2_e_minus_half_d2_x_cov_x = gauss_d2 * e_minus_half_d2_x_cov_x;
+      // Invalid values (including NaN) are masked out rather than skipped.
+      const auto valid = (d2_e_minus_half_d2_x_cov_x >= -eps) &&
+        (d2_e_minus_half_d2_x_cov_x <= 1.0F + eps);
+      const auto weight = valid ? (gauss_d1 * d2_e_minus_half_d2_x_cov_x) : 0.0F;
+      jacobian[0U] += static_cast<float64_t>(weight * q0);
+      jacobian[1U] += static_cast<float64_t>(weight * q1);
+      jacobian[2U] += static_cast<float64_t>(weight * q2);
+      jacobian[3U] += static_cast<float64_t>(weight *
+        ((q1 * ((x * j_ang[0U]) + (y * j_ang[1U]) + (z * j_ang[2U]))) +
+        (q2 * ((x * j_ang[3U]) + (y * j_ang[4U]) + (z * j_ang[5U])))));
+      jacobian[4U] += static_cast<float64_t>(weight *
+        ((q0 * ((x * j_ang[6U]) + (y * j_ang[7U]) + (z * j_ang[8U]))) +
+        (q1 * ((x * j_ang[9U]) + (y * j_ang[10U]) + (z * j_ang[11U]))) +
+        (q2 * ((x * j_ang[12U]) + (y * j_ang[13U]) + (z * j_ang[14U])))));
+      jacobian[5U] += static_cast<float64_t>(weight *
+        ((q0 * ((x * j_ang[15U]) + (y * j_ang[16U]) + (z * j_ang[17U]))) +
+        (q1 * ((x * j_ang[18U]) + (y * j_ang[19U]) + (z * j_ang[20U]))) +
+        (q2 * ((x * j_ang[21U]) + (y * j_ang[22U]) + (z * j_ang[23U])))));
+    }
+    partition.score = score;
+    for (auto i = 0U; i < jacobian.size(); ++i) {
+      partition.jacobian(i) = jacobian[i];
+    }
+  }
+
   void compute_point_gradients(
     const GradientAngleParameters & params,
     const Point & x,
-    PointGrad & point_gradient)
+    PointGrad & point_gradient) const
   {
     point_gradient(1, 3) = x.dot(params.j_ang_a);
     point_gradient(2, 3) = x.dot(params.j_ang_b);
@@ -414,7 +660,7 @@ public:
   void compute_point_hessians(
     const HessianAngleParameters & params,
     const Point & x,
-    PointHessian & point_hessian)
+    PointHessian & point_hessian) const
   {
     const Point a{0.0, x.dot(params.h_ang_a2), x.dot(params.h_ang_a3)};
     const Point b{0.0, x.dot(params.h_ang_b2), x.dot(params.h_ang_b3)};
@@ -442,33 +688,257 @@ public:
   /// used in (eq. 6.7) [Magnusson 2009]
   void init(Real outlier_ratio)
   {
-    if (!is_valid_probability(outlier_ratio)) {
-      throw std::domain_error("Outlier ratio must be between 0 and 1");
-    }
-    const auto c_size = m_map_ref.cell_size();
-    // The gaussian fitting parameters below are taken from the PCL implementation.
-    // 10.0 seems to be a magic number. For details on the gaussian
-    // approximation of the mixture probability in see [Biber et al, 2004] and [Magnusson 2009].
-    const auto gauss_c1 = 10.0 * (1.0 - outlier_ratio);
-    const auto gauss_c2 = outlier_ratio / static_cast<Real>(c_size.x * c_size.y * c_size.z);
-    const auto gauss_d3 = -std::log(gauss_c2);
-    m_gauss_d1 = -std::log(gauss_c1 + gauss_c2) - gauss_d3;
-    m_gauss_d2 = -2 *
-      std::log((-std::log(gauss_c1 * std::exp(-0.5) + gauss_c2) - gauss_d3) / m_gauss_d1);
+    compute_gauss_parameters(outlier_ratio, m_map_ref.cell_size(), m_gauss_d1, m_gauss_d2);
   }
 
   // references as class members to be initialized at constructor.
   const Scan & m_scan_ref;
   const Map & m_map_ref;
+  bool8_t m_single_precision_gradient;
   // States:
   Real m_gauss_d1{0.0};
   Real m_gauss_d2{0.0};
+  std::vector<Partition, Eigen::aligned_allocator<Partition>> m_partitions;
 };
 
 template<typename MapT>
 using P2DNDTOptimizationProblem =
   common::optimization::UnconstrainedOptimizationProblem<P2DNDTObjective<MapT>, EigenPose<Real>,
     6U>;
+
+/// D2D ndt objective. This class implements the D2D ndt score function of [Stoyanov et al, 2012],
+/// its analytical jacobian and hessian values. Each Gaussian cell of the scan is compared with the
+/// Gaussian cells of the map around its transformed centroid. For a scan cell with centroid mu
+/// and covariance C and a map cell with centroid mu_j and covariance C_j, the score term is
+/// -d_1 * exp(-d_2/2 * q^T B q) with q = R mu + t - mu_j and B = (R C R^T + C_j)^-1. The
+/// rotation thus also changes the combined covariance, which is taken into account in the
+/// derivatives. With a zero scan covariance, the terms are the ones of the P2D objective.
+/// \tparam MapT Type of map to be used. This type should conform the interface specified in
+/// `P2DNDTOptimizationMapConstraint`
+template<typename MapT,
+  Requires = traits::P2DNDTOptimizationMapConstraint<MapT>::value>
+class D2DNDTObjective : public common::optimization::CachedExpression<D2DNDTObjective<MapT>,
+    EigenPose<Real>, 1U, 6U, common::optimization::EigenComparator>
+{
+public:
+  // getting aliases from the base class.
+  using ExpressionT = common::optimization::CachedExpression<D2DNDTObjective<MapT>,
+      EigenPose<Real>, 1U, 6U, common::optimization::EigenComparator>;
+  using DomainValue = typename ExpressionT::DomainValue;
+  using Value = typename ExpressionT::Value;
+  using Jacobian = typename ExpressionT::Jacobian;
+  using Hessian = typename ExpressionT::Hessian;
+  using Map = MapT;
+  using Scan = D2DNDTScan;
+  using Point = Eigen::Vector3d;
+  using Comparator = common::optimization::EigenComparator;
+  using ComputeMode = common::optimization::ComputeMode;
+
+  /// Constructor.
+  ///
+  /// It should be noted here that ndt optimization problem does not take ownership of neither the
+  /// scan nor the map but uses the references. Hence an optimization problem must not outlive the
+  /// scan or the map.
+  ///
+  /// @param      scan    Scan to align with the map.
+  /// @param      map     NDT map to be aligned.
+  /// @param      config  Optimization config for this objective.
+  ///
+  D2DNDTObjective(
+    const D2DNDTScan & scan, const Map & map, const D2DNDTOptimizationConfig config)
+  : m_scan_ref(scan), m_map_ref(map)
+  {
+    compute_gauss_parameters(config.outlier_ratio(), m_map_ref.cell_size(), m_gauss_d1, m_gauss_d2);
+  }
+
+  /// Evaluate the objective.
+  /// \param x Pose to evaluate the objective at.
+  /// \param mode Which of the score, jacobian and hessian to compute.
+  void evaluate_(const DomainValue & x, const ComputeMode & mode)
+  {
+    Transform transform;
+    transform.setIdentity();
+    transform_adapters::pose_to_transform(x, transform);
+    const Eigen::Matrix3d rotation = transform.linear();
+    const auto derivatives = mode.jacobian() || mode.hessian();
+    if (derivatives) {
+      compute_rotation_derivatives(x, mode.hessian());
+    }
+    // Reusable portion of Equation 6.12 and 6.13 [Magnusson 2009], with the factor 2 of the
+    // derivative of the quadratic form taken out.
+    const auto half_d1_d2 = 0.5 * m_gauss_d1 * m_gauss_d2;
+
+    Value score{0.0};
+    Jacobian jacobian{Jacobian::Zero()};
+    Hessian hessian{Hessian::Zero()};
+    for (std::size_t i = 0U; i < m_scan_ref.size(); ++i) {
+      const Point & centroid = *(m_scan_ref.begin() + static_cast<std::ptrdiff_t>(i));
+      const auto & cov = m_scan_ref.covariance(i);
+      const Point centroid_trans = transform * centroid;
+      const Eigen::Matrix3d cov_rot = cov * rotation.transpose();
+      const Eigen::Matrix3d cov_trans = rotation * cov_rot;
+
+      // Jacobian of the transformed centroid and the rotated covariance terms that don't depend
+      // on the map cell: dR_k C R^T, and for the hessian d2R_kl C R^T, dR_k C dR_l^T and
+      // d2R_kl mu.
+      Eigen::Matrix<float64_t, 3, 6> centroid_gradient;
+      std::array<Eigen::Matrix3d, 3U> cov_gradient;
+      std::array<std::array<Eigen::Matrix3d, 3U>, 3U> cov_hessian;
+      std::array<std::array<Point, 3U>, 3U> centroid_hessian;
+      if (derivatives) {
+        centroid_gradient.setZero();
+        centroid_gradient.block<3, 3>(0, 0).setIdentity();
+        for (auto k = 0U; k < 3U; ++k) {
+          centroid_gradient.col(k + 3U) = m_rotation_gradient[k] * centroid;
+          cov_gradient[k] = m_rotation_gradient[k] * cov_rot;
+          if (!mode.hessian()) {
+            continue;
+          }
+          for (auto l = 0U; l < 3U; ++l) {
+            centroid_hessian[k][l] = m_rotation_hessian[k][l] * centroid;
+            cov_hessian[k][l] = (m_rotation_hessian[k][l] * cov_rot) +
+              (m_rotation_gradient[k] * cov * m_rotation_gradient[l].transpose());
+          }
+        }
+      }
+
+      m_map_ref.cell(centroid_trans, m_cells);
+      for (const auto & cell : m_cells) {
+        // Cell iteration used for compatibility with maps with multi-cell lookup
+        if (!cell.usable()) {
+          continue;
+        }
+        const Eigen::Matrix3d combined_inv_cov =
+          (cov_trans + cell.inverse_covariance().inverse()).inverse();
+        const Point diff = centroid_trans - cell.centroid();
+        const Point weighted_diff = combined_inv_cov * diff;
+        const auto e_minus_half_d2_x_cov_x = std::exp(-m_gauss_d2 * diff.dot(weighted_diff) / 2.0);
+
+        if (mode.score()) {
+          score += -m_gauss_d1 * e_minus_half_d2_x_cov_x;
+        }
+        if (!derivatives) {
+          continue;
+        }
+        // Error checking for invalid values.
+        if (!is_valid_probability(m_gauss_d2 * e_minus_half_d2_x_cov_x)) {
+          continue;
+        }
+        const auto weight = half_d1_d2 * e_minus_half_d2_x_cov_x;
+
+        // Derivatives of the quadratic form s = q^T B q: ds_k = 2 z^T J_k - z^T dC_k z
+        // with z = B q, and the vectors w_k = J_k - dC_k z for the hessian, where dC_k is the
+        // derivative of the rotated covariance.
+        Eigen::Matrix<float64_t, 6, 1> form_gradient;
+        Eigen::Matrix<float64_t, 3, 6> w = centroid_gradient;
+        for (auto k = 0U; k < 6U; ++k) {
+          form_gradient(k) = 2.0 * weighted_diff.dot(centroid_gradient.col(k));
+          if (k >= 3U) {
+            const auto & cov_grad = cov_gradient[k - 3U];
+            const Point cov_grad_z = cov_grad * weighted_diff;
+            form_gradient(k) -= 2.0 * weighted_diff.dot(cov_grad_z);
+            w.col(k) -= cov_grad_z + (cov_grad.transpose() * weighted_diff);
+          }
+        }
+        if (mode.jacobian()) {
+          jacobian += weight * form_gradient;
+        }
+        if (!mode.hessian()) {
+          continue;
+        }
+        // d2s_kl = 2 w_l^T B w_k + 2 z^T d2mu_kl - z^T d2C_kl z
+        Hessian form_hessian = 2.0 * (w.transpose() * combined_inv_cov * w);
+        for (auto k = 0U; k < 3U; ++k) {
+          for (auto l = 0U; l < 3U; ++l) {
+            form_hessian(k + 3U, l + 3U) += 2.0 * (weighted_diff.dot(centroid_hessian[k][l]) -
+              weighted_diff.dot(cov_hessian[k][l] * weighted_diff));
+          }
+        }
+        hessian += weight *
+          (form_hessian - ((m_gauss_d2 / 2.0) * form_gradient * form_gradient.transpose()));
+      }
+    }
+
+    if (mode.score()) {
+      this->set_score(score);
+    }
+    if (mode.jacobian()) {
+      this->set_jacobian(jacobian);
+    }
+    if (mode.hessian()) {
+      this->set_hessian(hessian);
+    }
+  }
+
+private:
+  using Transform = Eigen::Transform<float64_t, 3, Eigen::Affine, Eigen::ColMajor>;
+
+  /// Compute the derivatives of the rotation R = Rx(roll) * Ry(pitch) * Rz(yaw) with respect to
+  /// the angles of the pose.
+  /// \param x Pose to compute the derivatives at.
+  /// \param hessian Whether to compute the second derivatives as well.
+  void compute_rotation_derivatives(const DomainValue & x, const bool8_t hessian)
+  {
+    // The elementary rotations and their first and second derivatives.
+    std::array<std::array<Eigen::Matrix3d, 3U>, 3U> factors;
+    for (auto k = 0U; k < 3U; ++k) {
+      const auto c = std::cos(x(k + 3U));
+      const auto s = std::sin(x(k + 3U));
+      // The two axes spanning the plane of the rotation and the sign of the sine below the
+      // diagonal.
+      const auto a = (k + 1U) % 3U;
+      const auto b = (k + 2U) % 3U;
+      for (auto d = 0U; d < 3U; ++d) {
+        auto & factor = factors[d][k];
+        factor.setZero();
+        factor(k, k) = (d == 0U) ? 1.0 : 0.0;
+      }
+      factors[0U][k](a, a) = c;
+      factors[0U][k](b, b) = c;
+      factors[0U][k](a, b) = -s;
+      factors[0U][k](b, a) = s;
+      factors[1U][k](a, a) = -s;
+      factors[1U][k](b, b) = -s;
+      factors[1U][k](a, b) = -c;
+      factors[1U][k](b, a) = c;
+      factors[2U][k] = -factors[0U][k];
+      factors[2U][k](k, k) = 0.0;
+    }
+    const auto product = [&factors](const std::array<uint32_t, 3U> & orders) {
+        Eigen::Matrix3d result = factors[orders[0U]][0U];
+        result = result * factors[orders[1U]][1U];
+        return Eigen::Matrix3d{result * factors[orders[2U]][2U]};
+      };
+    for (auto k = 0U; k < 3U; ++k) {
+      std::array<uint32_t, 3U> orders{0U, 0U, 0U};
+      ++orders[k];
+      m_rotation_gradient[k] = product(orders);
+      if (!hessian) {
+        continue;
+      }
+      for (auto l = 0U; l < 3U; ++l) {
+        auto second_orders = orders;
+        ++second_orders[l];
+        m_rotation_hessian[k][l] = product(second_orders);
+      }
+    }
+  }
+
+  // references as class members to be initialized at constructor.
+  const Scan & m_scan_ref;
+  const Map & m_map_ref;
+  // States:
+  Real m_gauss_d1{0.0};
+  Real m_gauss_d2{0.0};
+  typename Map::VoxelViewVector m_cells;
+  std::array<Eigen::Matrix3d, 3U> m_rotation_gradient;
+  std::array<std::array<Eigen::Matrix3d, 3U>, 3U> m_rotation_hessian;
+};
+
+template<typename MapT>
+using D2DNDTOptimizationProblem =
+  common::optimization::UnconstrainedOptimizationProblem<D2DNDTObjective<MapT>, EigenPose<Real>,
+    6U>;
 }  // namespace ndt
 }  // namespace localization
 }  // namespace autoware
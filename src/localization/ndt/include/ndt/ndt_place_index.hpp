@@ -0,0 +1,239 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#ifndef NDT__NDT_PLACE_INDEX_HPP_
+#define NDT__NDT_PLACE_INDEX_HPP_
+
+#include <common/types.hpp>
+#include <ndt/ndt_common.hpp>
+#include <ndt/ndt_map.hpp>
+#include <ndt/utils.hpp>
+#include <ndt/visibility_control.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
+#include <Eigen/Core>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace autoware
+{
+namespace localization
+{
+namespace ndt
+{
+using autoware::common::types::float32_t;
+using autoware::common::types::float64_t;
+
+/// Configuration of the scan context descriptors of a `ScanContextIndex`.
+class NDT_PUBLIC ScanContextConfig
+{
+public:
+  /// Constructor
+  /// \param num_rings Number of range bins of a descriptor.
+  /// \param num_sectors Number of azimuth bins of a descriptor. The yaw of a candidate is
+  /// resolved to a sector.
+  /// \param min_range Points closer to the sensor than this, e.g. on the ego vehicle, are
+  /// ignored.
+  /// \param max_range Points further from the sensor than this are ignored.
+  /// \param min_height Points lower than this relative to the sensor are ignored. A bin holds
+  /// the height of its highest point above this value.
+  /// \param max_height Points higher than this relative to the sensor are ignored.
+  /// \param num_key_candidates Number of places with the closest ring keys whose full
+  /// descriptors are compared to a query.
+  /// \throws std::domain_error if a number of bins or of key candidates is 0 or if a range is
+  /// empty.
+  explicit ScanContextConfig(
+    uint32_t num_rings = 20U,
+    uint32_t num_sectors = 60U,
+    float32_t min_range = 1.0F,
+    float32_t max_range = 80.0F,
+    float32_t min_height = -3.0F,
+    float32_t max_height = 10.0F,
+    uint32_t num_key_candidates = 25U);
+
+  /// Get the number of range bins.
+  uint32_t num_rings() const noexcept {return m_num_rings;}
+  /// Get the number of azimuth bins.
+  uint32_t num_sectors() const noexcept {return m_num_sectors;}
+  /// Get the range below which points are ignored.
+  float32_t min_range() const noexcept {return m_min_range;}
+  /// Get the range above which points are ignored.
+  float32_t max_range() const noexcept {return m_max_range;}
+  /// Get the height below which points are ignored.
+  float32_t min_height() const noexcept {return m_min_height;}
+  /// Get the height above which points are ignored.
+  float32_t max_height() const noexcept {return m_max_height;}
+  /// Get the number of places whose full descriptors are compared to a query.
+  uint32_t num_key_candidates() const noexcept {return m_num_key_candidates;}
+
+private:
+  uint32_t m_num_rings;
+  uint32_t m_num_sectors;
+  float32_t m_min_range;
+  float32_t m_max_range;
+  float32_t m_min_height;
+  float32_t m_max_height;
+  uint32_t m_num_key_candidates;
+};
+
+/// A place of a `ScanContextIndex` that matches a scan.
+struct NDT_PUBLIC PlaceCandidate
+{
+  /// Pose of the scan in the frame of the index: the position of the place and the yaw of the
+  /// best alignment of the descriptors. Roll and pitch are 0. Use
+  /// `transform_adapters::pose_to_transform(...)` to get an initial guess for the localizer.
+  EigenPose<Real> pose;
+  /// Descriptor distance in [0, 1], smaller is more similar.
+  Real distance;
+  /// Index of the place in the order the places were added.
+  std::size_t place_index;
+};
+
+/// Version of the binary place index layout. Increment whenever `ScanContextIndexHeader` or
+/// the record layout change.
+static constexpr uint32_t kScanContextIndexVersion = 1U;
+
+/// Magic bytes at the beginning of every binary place index file.
+static constexpr std::array<char, 8U> kScanContextIndexMagic{{'N', 'D', 'T', 'P', 'L', 'A',
+    'C', 'E'}};
+
+/// Header of a binary place index file. The header is followed by `num_places` records, each
+/// made of the position as 3 float64 values and the descriptor as `num_rings * num_sectors`
+/// float32 values in ring major order. All values are stored in the native byte order of the
+/// writing machine.
+struct ScanContextIndexHeader
+{
+  std::array<char, 8U> magic;
+  uint32_t version;
+  uint32_t num_rings;
+  uint32_t num_sectors;
+  uint32_t num_key_candidates;
+  float32_t min_range;
+  float32_t max_range;
+  float32_t min_height;
+  float32_t max_height;
+  uint64_t num_places;
+  /// Null terminated frame id of the places.
+  std::array<char, 64U> frame_id;
+};
+
+static_assert(
+  std::is_trivially_copyable<ScanContextIndexHeader>::value &&
+  std::is_standard_layout<ScanContextIndexHeader>::value,
+  "ScanContextIndexHeader must be readable directly from a file.");
+
+/// Place recognition index for the global (re)localization on an ndt map, e.g. after a restart
+/// without a usable initial pose. It is built offline from places sampled along the drivable
+/// area, e.g. the mapping trajectory or the lane centerlines, and stores a scan context
+/// descriptor [Kim 2018] of the map around each place: a polar grid around the sensor holding
+/// the height of the highest point of each bin, which doesn't depend on the point density of
+/// the map or of the scan. A query compares the rotation invariant ring keys, the fraction of
+/// occupied bins of each ring, of all places and then aligns the full descriptors of the places
+/// with the closest keys over all sector shifts, which also gives the yaw. The candidates are
+/// meant as the initial guesses of the multi-start registration of the ndt localizer, which
+/// refines them and picks the best one. The sensor is assumed to be roughly level.
+class NDT_PUBLIC ScanContextIndex
+{
+public:
+  /// Constructor
+  /// \param config Configuration of the descriptors.
+  explicit ScanContextIndex(const ScanContextConfig & config = ScanContextConfig{});
+
+  /// Add places with descriptors made from the usable voxel centroids of a static ndt map.
+  /// \tparam VoxelT Voxel type of the map.
+  /// \param map Map to describe.
+  /// \param positions Positions of the sensor at the places in the map frame.
+  /// \throws std::domain_error if the index already holds places of a different frame.
+  /// \throws std::runtime_error if the map isn't set.
+  template<typename VoxelT>
+  void add_places(
+    const BasicStaticNDTMap<VoxelT> & map,
+    const std::vector<Eigen::Vector3d> & positions);
+
+  /// Add a place with a descriptor made from points.
+  /// \param position Position of the sensor at the place.
+  /// \param points Points around the place in the same frame as the position.
+  void add_place(const Eigen::Vector3d & position, const std::vector<Eigen::Vector3d> & points);
+
+  /// Find the places that match a scan.
+  /// \param scan Point cloud with float32 x, y and z fields in the frame of the sensor.
+  /// \param num_candidates Maximum number of candidates to return.
+  /// \return Candidates ordered by increasing descriptor distance. There are fewer candidates
+  /// than requested if the index holds fewer places than the configured number of key
+  /// candidates.
+  /// \throws std::domain_error if the scan lacks a float32 x, y or z field.
+  std::vector<PlaceCandidate> query(
+    const sensor_msgs::msg::PointCloud2 & scan,
+    const std::size_t num_candidates) const;
+
+  /// Write the index to a binary file, see `ScanContextIndexHeader`.
+  /// \param file_name Path of the file.
+  /// \throws std::runtime_error if the file can't be written or the frame id is too long.
+  void write(const std::string & file_name) const;
+
+  /// Read an index written with `write(...)`.
+  /// \param file_name Path of the file.
+  /// \return The index.
+  /// \throws std::runtime_error if the file can't be read or is not a valid place index.
+  static ScanContextIndex read(const std::string & file_name);
+
+  /// Get the number of places.
+  std::size_t size() const noexcept;
+
+  /// Get the position of a place.
+  /// \param place_index Index of the place.
+  /// \return Position of the sensor at the place.
+  const Eigen::Vector3d & position(const std::size_t place_index) const;
+
+  /// Get the frame id of the places, which is empty if no place was added from a map.
+  const std::string & frame_id() const noexcept;
+
+  /// Get the configuration of the descriptors.
+  const ScanContextConfig & config() const noexcept;
+
+private:
+  /// Add a place from a descriptor, computing its ring key.
+  void add_descriptor(const Eigen::Vector3d & position, const std::vector<float32_t> & descriptor);
+  /// Compute the ring key of a descriptor.
+  void ring_key(const float32_t * const descriptor, float32_t * const key) const;
+  /// Descriptor distance of a place to a query and the sector shift that achieves it.
+  Real align(
+    const std::vector<float32_t> & query_descriptor,
+    const std::vector<float32_t> & query_column_norms,
+    const std::size_t place_index,
+    uint32_t & best_shift) const;
+
+  ScanContextConfig m_config;
+  std::size_t m_descriptor_size;
+  std::vector<Eigen::Vector3d> m_positions{};
+  /// Descriptors of all places in ring major order, one after the other.
+  std::vector<float32_t> m_descriptors{};
+  std::vector<float32_t> m_ring_keys{};
+  std::string m_frame_id{};
+};
+
+extern template void ScanContextIndex::add_places<StaticNDTVoxel>(
+  const BasicStaticNDTMap<StaticNDTVoxel> &, const std::vector<Eigen::Vector3d> &);
+extern template void ScanContextIndex::add_places<PackedNDTVoxel>(
+  const BasicStaticNDTMap<PackedNDTVoxel> &, const std::vector<Eigen::Vector3d> &);
+}  // namespace ndt
+}  // namespace localization
+}  // namespace autoware
+#endif  // NDT__NDT_PLACE_INDEX_HPP_
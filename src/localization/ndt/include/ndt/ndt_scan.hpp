@@ -18,6 +18,7 @@
 #define NDT__NDT_SCAN_HPP_
 
 #include <helper_functions/crtp.hpp>
+#include <ndt/ndt_voxel.hpp>
 #include <ndt/visibility_control.hpp>
 #include <point_cloud_msg_wrapper/point_cloud_msg_wrapper.hpp>
 #include <sensor_msgs/msg/point_cloud2.hpp>
@@ -25,10 +26,14 @@
 #include <common/types.hpp>
 #include <time_utils/time_utils.hpp>
 #include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <cstddef>
+#include <iterator>
 #include <vector>
 
 using autoware::common::types::bool8_t;
 using autoware::common::types::float32_t;
+using autoware::common::types::float64_t;
 
 namespace autoware
 {
@@ -95,14 +100,130 @@ public:
   }
 };
 
-/// Represents a lidar scan in a P2D optimization problem. It is a wrapper around an
-/// std::vector<Eigen::Vector3d>
+/// Random access iterator over the points of a `P2DNDTScan`. Points are stored in single
+/// precision column arrays and are returned by value as `Eigen::Vector3d`.
+class NDT_PUBLIC P2DNDTScanIterator
+{
+public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = Eigen::Vector3d;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const Eigen::Vector3d *;
+  using reference = Eigen::Vector3d;
+
+  P2DNDTScanIterator() = default;
+
+  /// Constructor
+  /// \param x Pointer to the x coordinate of the point.
+  /// \param y Pointer to the y coordinate of the point.
+  /// \param z Pointer to the z coordinate of the point.
+  P2DNDTScanIterator(const float32_t * x, const float32_t * y, const float32_t * z) noexcept
+  : m_x{x}, m_y{y}, m_z{z} {}
+
+  Eigen::Vector3d operator*() const noexcept
+  {
+    return Eigen::Vector3d{
+      static_cast<float64_t>(*m_x), static_cast<float64_t>(*m_y), static_cast<float64_t>(*m_z)};
+  }
+
+  Eigen::Vector3d operator[](const difference_type n) const noexcept
+  {
+    return *(*this + n);
+  }
+
+  P2DNDTScanIterator & operator+=(const difference_type n) noexcept
+  {
+    m_x += n;
+    m_y += n;
+    m_z += n;
+    return *this;
+  }
+
+  P2DNDTScanIterator & operator-=(const difference_type n) noexcept
+  {
+    return *this += -n;
+  }
+
+  P2DNDTScanIterator & operator++() noexcept
+  {
+    return *this += 1;
+  }
+
+  P2DNDTScanIterator operator++(int) noexcept
+  {
+    const auto it = *this;
+    ++(*this);
+    return it;
+  }
+
+  P2DNDTScanIterator & operator--() noexcept
+  {
+    return *this -= 1;
+  }
+
+  P2DNDTScanIterator operator--(int) noexcept
+  {
+    const auto it = *this;
+    --(*this);
+    return it;
+  }
+
+  friend P2DNDTScanIterator operator+(P2DNDTScanIterator it, const difference_type n) noexcept
+  {
+    return it += n;
+  }
+
+  friend P2DNDTScanIterator operator-(P2DNDTScanIterator it, const difference_type n) noexcept
+  {
+    return it -= n;
+  }
+
+  friend difference_type operator-(
+    const P2DNDTScanIterator & lhs, const P2DNDTScanIterator & rhs) noexcept
+  {
+    return lhs.m_x - rhs.m_x;
+  }
+
+  friend bool8_t operator==(
+    const P2DNDTScanIterator & lhs, const P2DNDTScanIterator & rhs) noexcept
+  {
+    return lhs.m_x == rhs.m_x;
+  }
+
+  friend bool8_t operator!=(
+    const P2DNDTScanIterator & lhs, const P2DNDTScanIterator & rhs) noexcept
+  {
+    return !(lhs == rhs);
+  }
+
+  friend bool8_t operator<(
+    const P2DNDTScanIterator & lhs, const P2DNDTScanIterator & rhs) noexcept
+  {
+    return lhs.m_x < rhs.m_x;
+  }
+
+private:
+  const float32_t * m_x{nullptr};
+  const float32_t * m_y{nullptr};
+  const float32_t * m_z{nullptr};
+};
+
+/// Represents a lidar scan in a P2D optimization problem. The x, y and z coordinates are read
+/// directly from the point cloud buffer into preallocated single precision column arrays, so
+/// inserting a scan doesn't allocate. Since the point cloud fields are single precision, no
+/// precision is lost. Optionally, the scan is downsampled to the centroids of a voxel grid in
+/// the same pass, so full resolution point clouds can be used without a separate
+/// downsampling step. The scan can further be capped to a point budget, which is spread over
+/// azimuth sectors and ranges so the remaining points still constrain all degrees of freedom.
 class NDT_PUBLIC P2DNDTScan : public NDTScanBase<P2DNDTScan,
-    Eigen::Vector3d, std::vector<Eigen::Vector3d>::const_iterator>
+    Eigen::Vector3d, P2DNDTScanIterator>
 {
 public:
-  using Container = std::vector<Eigen::Vector3d>;
-  using iterator = Container::const_iterator;
+  using iterator = P2DNDTScanIterator;
+  /// Points in a structure-of-arrays layout: one column per coordinate.
+  using PointMatrix = Eigen::Matrix<float32_t, Eigen::Dynamic, 3>;
+  using TransformedPoints = Eigen::Matrix<float64_t, Eigen::Dynamic, 3>;
+  using Transform = Eigen::Transform<float64_t, 3, Eigen::Affine, Eigen::ColMajor>;
 
   // Make sure the given iterator type in the template is compatible with the used container.
   // container should have `iterator` type/alias defined.
@@ -115,13 +236,12 @@ public:
   /// \param msg Point cloud message to initialize this scan with.
   /// \param capacity Capacity of the scan. It should be configured according to the max. expected
   /// point cloud message size from the lidar.
+  /// \param voxel_size Edge length of the voxels the scan is downsampled with. The scan is not
+  /// downsampled if it is 0.
   P2DNDTScan(
     const sensor_msgs::msg::PointCloud2 & msg,
-    std::size_t capacity)
-  {
-    m_points.reserve(capacity);
-    insert_(msg);
-  }
+    std::size_t capacity,
+    float32_t voxel_size = 0.0F);
 
   // Scans should be moved rather than being copied.
   P2DNDTScan(const P2DNDTScan &) = delete;
@@ -133,69 +253,117 @@ public:
 
   /// Constructor
   /// \param capacity Capacity of the scan. It should be configured according to the max. expected
-  /// point cloud message size from the lidar.
-  explicit P2DNDTScan(std::size_t capacity)
-  {
-    m_points.reserve(capacity);
-  }
+  /// point cloud message size from the lidar. If the scan is downsampled, it is the maximum
+  /// number of occupied voxels instead.
+  /// \param voxel_size Edge length of the voxels the scan is downsampled with. The scan is not
+  /// downsampled if it is 0.
+  /// \throws std::domain_error if the voxel size is negative.
+  explicit P2DNDTScan(std::size_t capacity, float32_t voxel_size = 0.0F);
 
   /// Insert a point cloud into the NDTScan. This is the step where the pointcloud is
-  /// converted into the ndt scan representation.
+  /// converted into the ndt scan representation. Only the float32 `x`, `y` and `z` fields are
+  /// used, other fields are ignored. Points with non-finite coordinates are skipped.
   /// \param msg Point cloud to insert.
-  void insert_(const sensor_msgs::msg::PointCloud2 & msg)
+  /// \throws std::length_error if the scan doesn't fit into the capacity.
+  /// \throws std::domain_error if the point cloud has no float32 `x`, `y` and `z` fields.
+  void insert_(const sensor_msgs::msg::PointCloud2 & msg);
+
+  /// Transform a range of points with the given transform in a single batched operation.
+  /// \param transform Transform to apply.
+  /// \param begin_idx Index of the first point.
+  /// \param end_idx Index past the last point.
+  /// \param output Matrix to store the transformed points in, one point per row. It is only
+  /// reallocated if the size of the range changes.
+  void transform(
+    const Transform & transform,
+    std::size_t begin_idx,
+    std::size_t end_idx,
+    TransformedPoints & output) const;
+
+  /// Get a point of the scan.
+  /// \param idx Index of the point.
+  /// \return The point.
+  Eigen::Vector3d point(const std::size_t idx) const noexcept
+  {
+    const auto row = static_cast<Eigen::Index>(idx);
+    return Eigen::Vector3d{
+      static_cast<float64_t>(m_points(row, 0)),
+      static_cast<float64_t>(m_points(row, 1)),
+      static_cast<float64_t>(m_points(row, 2))};
+  }
+
+  /// Get the edge length of the voxels the scan is downsampled with.
+  /// \return The voxel size, 0 if the scan is not downsampled.
+  float32_t voxel_size() const noexcept
   {
-    if (!m_points.empty()) {
-      m_points.clear();
-    }
+    return m_voxel_size;
+  }
+
+  /// Subsample the point clouds that are inserted from now on: only every `stride`-th point is
+  /// used, before the voxel downsampling if that is enabled as well.
+  /// \param stride The stride, 1 to use all points.
+  /// \throws std::domain_error if the stride is 0.
+  void set_stride(std::size_t stride);
 
-    m_stamp = ::time_utils::from_message(msg.header.stamp);
+  /// Get the stride the inserted point clouds are subsampled with.
+  /// \return The stride, 1 if all points are used.
+  std::size_t stride() const noexcept
+  {
+    return m_stride;
+  }
 
-    constexpr auto container_full_error = "received a lidar scan with more points than the "
-      "ndt scan representation can contain. Please re-configure the scan"
-      "representation accordingly.";
+  /// Cap the number of points of the point clouds that are inserted from now on. If a cloud
+  /// has more points after the subsampling and the voxel downsampling, the budget is split over
+  /// azimuth sectors around the sensor: sectors with fewer points than their share keep all of
+  /// them and pass the rest of their share on to the others. Within a sector, the selected
+  /// points are spread evenly over the range, since distant points constrain the rotation and
+  /// close ones are the most accurate. The order of the selected points is preserved. The
+  /// capacity still has to fit all points before the selection. Allocates the working memory
+  /// of the selection.
+  /// \param max_points Maximum number of points, 0 to keep all points.
+  /// \param num_sectors Number of azimuth sectors the budget is split over.
+  /// \throws std::domain_error if the number of sectors is 0.
+  void set_point_budget(std::size_t max_points, std::size_t num_sectors = 16U);
 
-    if (msg.width > m_points.capacity()) {
-      throw std::length_error(container_full_error);
-    }
-    using PointXYZI = autoware::common::types::PointXYZI;
-    point_cloud_msg_wrapper::PointCloud2View<PointXYZI> msg_view{msg};
-    for (const auto & point : msg_view) {
-      m_points.emplace_back(point.x, point.y, point.z);
-    }
+  /// Get the maximum number of points of the scan.
+  /// \return The point budget, 0 if all points are kept.
+  std::size_t max_points() const noexcept
+  {
+    return m_max_points;
   }
 
   /// Get iterator pointing to the beginning of the internal container.
   /// \return Begin iterator.
   iterator begin_() const
   {
-    return m_points.cbegin();
+    return iterator{m_points.col(0).data(), m_points.col(1).data(), m_points.col(2).data()};
   }
 
   /// Get iterator pointing to the end of the internal container.
   /// \return End iterator.
   iterator end_() const
   {
-    return m_points.cend();
+    return begin_() + static_cast<std::ptrdiff_t>(m_size);
   }
 
   /// Check if there is any data in the scan.
   /// \return True if the internal container is empty.
   bool8_t empty_()
   {
-    return m_points.empty();
+    return m_size == 0U;
   }
 
   /// Clear the states and the internal cache of the scan.
   void clear_()
   {
-    m_points.clear();
+    m_size = 0U;
   }
 
   /// Number of points inside the scan.
   /// \return Number of points
   std::size_t size_() const
   {
-    return m_points.size();
+    return m_size;
   }
 
   TimePoint stamp_()
@@ -204,7 +372,160 @@ public:
   }
 
 private:
-  Container m_points;
+  /// Add a point to the scan, or to the centroid of its voxel if the scan is downsampled.
+  void add_point(float32_t x, float32_t y, float32_t z);
+  /// Reduce the scan to the point budget.
+  void select_points();
+
+  PointMatrix m_points;
+  std::size_t m_size{0U};
+  float32_t m_voxel_size;
+  std::size_t m_stride{1U};
+  // Downsampling state: an open addressing table mapping packed voxel coordinates to the index
+  // of the voxel's point, and the coordinate sums and point counts of the voxels.
+  std::vector<uint64_t> m_voxel_keys{};
+  std::vector<uint32_t> m_voxel_indices{};
+  Eigen::Matrix<float64_t, Eigen::Dynamic, 3> m_voxel_sums{};
+  std::vector<uint32_t> m_voxel_counts{};
+  // Point budget state: the sector and squared range of each point, the point indices sorted by
+  // both, the selected points and the number of points and the budget of each sector.
+  std::size_t m_max_points{0U};
+  std::vector<uint32_t> m_selection_sectors{};
+  std::vector<float32_t> m_selection_ranges{};
+  std::vector<uint32_t> m_selection_order{};
+  std::vector<uint8_t> m_selection_keep{};
+  std::vector<std::size_t> m_sector_counts{};
+  std::vector<std::size_t> m_sector_budgets{};
+  NDTScanBase::TimePoint m_stamp{};
+};
+
+/// Represents a lidar scan in a D2D optimization problem. The points of the scan are binned
+/// into a voxel grid and each voxel with enough points to have an invertible covariance becomes
+/// a Gaussian cell, which is then registered against the Gaussian cells of the map. Other than
+/// in the P2D scan, the covariance of the cells carries the local surface shape into the
+/// registration, and far fewer cells than points have to be matched. The voxels use the same
+/// statistics as the cells of the dynamic map, see `DynamicNDTVoxel`. Iterating the scan yields
+/// the centroids of the cells, their covariances are accessed by index.
+class NDT_PUBLIC D2DNDTScan : public NDTScanBase<D2DNDTScan,
+    Eigen::Vector3d, std::vector<Eigen::Vector3d>::const_iterator>
+{
+public:
+  using Container = std::vector<Eigen::Vector3d>;
+  using iterator = Container::const_iterator;
+  using Covariance = Eigen::Matrix3d;
+
+  // Make sure the given iterator type in the template is compatible with the used container.
+  static_assert(
+    std::is_same<decltype(std::declval<NDTScanBase>().begin()), iterator>::value,
+    "D2DNDTScan: The iterator type parameter should match the "
+    "iterator of the container.");
+
+  /// Constructor
+  /// \param capacity Maximum number of voxels the points of a scan occupy, including the ones
+  /// with too few points to become a cell.
+  /// \param voxel_size Edge length of the voxels.
+  /// \throws std::domain_error if the voxel size is not positive.
+  D2DNDTScan(std::size_t capacity, float32_t voxel_size);
+
+  // Scans should be moved rather than being copied.
+  D2DNDTScan(const D2DNDTScan &) = delete;
+  D2DNDTScan & operator=(const D2DNDTScan &) = delete;
+
+  // Explicitly declaring to default is needed since we explicitly deleted the copy methods.
+  D2DNDTScan(D2DNDTScan &&) = default;
+  D2DNDTScan & operator=(D2DNDTScan &&) = default;
+
+  /// Insert a point cloud into the NDTScan. This is the step where the pointcloud is
+  /// converted into the ndt scan representation. Only the float32 `x`, `y` and `z` fields are
+  /// used, other fields are ignored. Points with non-finite coordinates are skipped.
+  /// \param msg Point cloud to insert.
+  /// \throws std::length_error if the points occupy more voxels than the capacity.
+  /// \throws std::domain_error if the point cloud has no float32 `x`, `y` and `z` fields.
+  void insert_(const sensor_msgs::msg::PointCloud2 & msg);
+
+  /// Get the covariance of a cell of the scan.
+  /// \param idx Index of the cell, in the order of iteration.
+  /// \return The stabilized covariance of the points of the cell.
+  const Covariance & covariance(const std::size_t idx) const noexcept
+  {
+    return m_covariances[idx];
+  }
+
+  /// Get the edge length of the voxels of the scan.
+  /// \return The voxel size.
+  float32_t voxel_size() const noexcept
+  {
+    return m_voxel_size;
+  }
+
+  /// Subsample the point clouds that are inserted from now on: only every `stride`-th point is
+  /// binned into the voxels.
+  /// \param stride The stride, 1 to use all points.
+  /// \throws std::domain_error if the stride is 0.
+  void set_stride(std::size_t stride);
+
+  /// Get the stride the inserted point clouds are subsampled with.
+  /// \return The stride, 1 if all points are used.
+  std::size_t stride() const noexcept
+  {
+    return m_stride;
+  }
+
+  /// Get iterator pointing to the beginning of the internal container.
+  /// \return Begin iterator.
+  iterator begin_() const
+  {
+    return m_centroids.begin();
+  }
+
+  /// Get iterator pointing to the end of the internal container.
+  /// \return End iterator.
+  iterator end_() const
+  {
+    return m_centroids.end();
+  }
+
+  /// Check if there is any data in the scan.
+  /// \return True if the internal container is empty.
+  bool8_t empty_()
+  {
+    return m_centroids.empty();
+  }
+
+  /// Clear the states and the internal cache of the scan.
+  void clear_()
+  {
+    m_centroids.clear();
+    m_covariances.clear();
+  }
+
+  /// Number of cells inside the scan.
+  /// \return Number of cells
+  std::size_t size_() const
+  {
+    return m_centroids.size();
+  }
+
+  TimePoint stamp_()
+  {
+    return m_stamp;
+  }
+
+private:
+  /// Add a point to the statistics of its voxel.
+  void add_point(float32_t x, float32_t y, float32_t z);
+
+  float32_t m_voxel_size;
+  std::size_t m_stride{1U};
+  // Binning state: an open addressing table mapping packed voxel coordinates to the index of the
+  // voxel, and the voxels occupied by the current scan.
+  std::vector<uint64_t> m_voxel_keys{};
+  std::vector<uint32_t> m_voxel_indices{};
+  std::vector<DynamicNDTVoxel, Eigen::aligned_allocator<DynamicNDTVoxel>> m_voxels{};
+  std::size_t m_num_voxels{0U};
+  // The usable cells, with preallocated storage for one per voxel.
+  Container m_centroids{};
+  std::vector<Covariance> m_covariances{};
   NDTScanBase::TimePoint m_stamp{};
 };
 
@@ -24,7 +24,13 @@
 
 #include <Eigen/Core>
 
+#include <array>
+#include <chrono>
+#include <stdexcept>
+
 using autoware::common::types::bool8_t;
+using autoware::common::types::float32_t;
+using autoware::common::types::float64_t;
 
 namespace autoware
 {
@@ -49,6 +55,7 @@ public:
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW
   using Point = Eigen::Vector3d;
   using Cov = Eigen::Matrix3d;
+  using TimePoint = std::chrono::system_clock::time_point;
   DynamicNDTVoxel();
 
   // TODO(yunus.caliskan): make this configurable.
@@ -61,6 +68,21 @@ public:
   /// \param pt Point to add to the voxel.
   void add_observation(const Point & pt);
 
+  /// Bound the number of points the statistics of the voxel represent. If the voxel has more
+  /// points, the count is reduced and the covariance is kept. Bounding the count after every
+  /// observation makes the centroid and the covariance exponentially weighted averages, where
+  /// older observations are gradually forgotten.
+  /// \param max_num_points Maximum number of points, ignored if smaller than NUM_POINT_THRESHOLD.
+  void limit_num_points(const uint64_t max_num_points) noexcept;
+
+  /// Set the time of the last observation of the voxel.
+  /// \param stamp Time of the observation.
+  void set_last_observation(const TimePoint stamp) noexcept;
+
+  /// Get the time of the last observation of the voxel.
+  /// \return Time of the last observation, the epoch if it was never set.
+  TimePoint last_observation() const noexcept;
+
   /// Try to stabilize the covariance
   /// \return True if stabilization succeeds and covariance is invertible
   bool8_t try_stabilize();
@@ -94,6 +116,7 @@ private:
   Cov m_covariance;
   Invertibility m_invertible{Invertibility::UNKNOWN};
   uint64_t m_num_points{0U};
+  TimePoint m_last_observation{};
 };
 
 /// Static Voxel implementation for the NDT map. A static voxel is used to represent a pre-computed
@@ -131,6 +154,83 @@ private:
   Cov m_inv_covariance;
   bool8_t m_occupied{false};
 };
+
+/// Compact static voxel for read-only NDT maps. It stores the centroid and the 6 unique entries
+/// of the symmetric inverse covariance in single precision, which takes 40 instead of the 104
+/// bytes of a `StaticNDTVoxel`. More voxels thus fit into the cache during the lookups of the
+/// optimization. The values are rounded once when the map is loaded and expanded to double
+/// precision when they are accessed.
+class NDT_PUBLIC PackedNDTVoxel
+{
+public:
+  using Point = Eigen::Vector3d;
+  using Cov = Eigen::Matrix3d;
+  /// Initialize an empty voxel
+  PackedNDTVoxel() = default;
+
+  /// Initialize a voxel given the centroid and the inverse covariance.
+  /// \param centroid Centroid of the voxel.
+  /// \param inv_covariance Inverse covariance of the voxel, assumed to be symmetric. Only the
+  /// upper triangle is used.
+  PackedNDTVoxel(const Point & centroid, const Cov & inv_covariance);
+
+  /// Calculates and returns the covariance of the points in the voxel. Throw if voxel is empty.
+  /// \return covariance of the cell
+  Cov covariance() const;
+  /// Returns the mean of the points in the cell. Throw if voxel is empty.
+  /// \return centroid of the cell
+  Point centroid() const;
+
+  /// Returns the inverse covariance of the points in the voxel. Throw if voxel is empty.
+  /// \return inverse covariance of the cell
+  Cov inverse_covariance() const;
+
+  /// Check if the cell is occupied and can be used in ndt matching
+  /// \return True if cell is occupied
+  bool8_t usable() const noexcept;
+
+private:
+  std::array<float32_t, 3U> m_centroid{};
+  /// Upper triangle of the inverse covariance: xx, xy, xz, yy, yz, zz.
+  std::array<float32_t, 6U> m_inv_covariance{};
+  bool8_t m_occupied{false};
+};
+
+// The accessors of the packed voxel are inline since they are used in the inner loop of the
+// optimization, where the storage is expanded.
+inline PackedNDTVoxel::Point PackedNDTVoxel::centroid() const
+{
+  if (!m_occupied) {
+    throw std::out_of_range("PackedNDTVoxel: Cannot get centroid from an unoccupied voxel");
+  }
+  return Point{
+    static_cast<float64_t>(m_centroid[0U]), static_cast<float64_t>(m_centroid[1U]),
+    static_cast<float64_t>(m_centroid[2U])};
+}
+
+inline PackedNDTVoxel::Cov PackedNDTVoxel::inverse_covariance() const
+{
+  if (!m_occupied) {
+    throw std::out_of_range(
+            "PackedNDTVoxel: Cannot get inverse covariance "
+            "from an unoccupied voxel");
+  }
+  const auto & icov = m_inv_covariance;
+  Cov inv_covariance;
+  inv_covariance <<
+    static_cast<float64_t>(icov[0U]), static_cast<float64_t>(icov[1U]),
+    static_cast<float64_t>(icov[2U]),
+    static_cast<float64_t>(icov[1U]), static_cast<float64_t>(icov[3U]),
+    static_cast<float64_t>(icov[4U]),
+    static_cast<float64_t>(icov[2U]), static_cast<float64_t>(icov[4U]),
+    static_cast<float64_t>(icov[5U]);
+  return inv_covariance;
+}
+
+inline bool8_t PackedNDTVoxel::usable() const noexcept
+{
+  return m_occupied;
+}
 }  // namespace ndt
 }  // namespace localization
 }  // namespace autoware
@@ -29,8 +29,9 @@ namespace ndt
 template<typename VoxelT>
 class NDT_PUBLIC VoxelView;
 
-/// Base CRTP interface for the voxel view. It assumes a cached
-/// centroid and inverse covariance are provided by the implementation. This interface
+/// Base CRTP interface for the voxel view. It assumes a cached or packed
+/// centroid and inverse covariance are provided by the implementation, which are returned by
+/// reference or by value respectively. This interface
 /// does not contain a covariance access function as it's not directly needed for the
 /// gaussian term shared in ndt optimization problems.
 /// It should be noted that, as this is purely a view of an existing voxel,
@@ -46,11 +47,11 @@ public:
   explicit VoxelViewBase(const VoxelT & vx)
   : m_data_ref{vx} {}
 
-  const Point & centroid() const
+  decltype(auto) centroid() const
   {
     return this->impl().centroid_();
   }
-  const Cov & inverse_covariance() const
+  decltype(auto) inverse_covariance() const
   {
     return this->impl().inverse_covariance_();
   }
@@ -110,6 +111,32 @@ private:
   bool8_t m_usable{true};
 };
 
+/// VoxelViewBase implementation for `PackedNDTVoxel`. It's a pure wrapper as well, the packed
+/// values are only expanded when they are accessed.
+template<>
+class NDT_PUBLIC VoxelView<PackedNDTVoxel>
+  : public VoxelViewBase<PackedNDTVoxel, VoxelView<PackedNDTVoxel>>
+{
+public:
+  using Point = Eigen::Vector3d;
+  using Cov = Eigen::Matrix3d;
+  using Base = VoxelViewBase<PackedNDTVoxel, VoxelView<PackedNDTVoxel>>;
+  explicit VoxelView(const PackedNDTVoxel & voxel)
+  : Base{voxel} {}
+
+  Cov inverse_covariance_() const
+  {
+    return this->get().inverse_covariance();
+  }
+  Point centroid_() const
+  {
+    return this->get().centroid();
+  }
+  bool8_t usable_() const noexcept
+  {
+    return this->get().usable();
+  }
+};
 
 }  // namespace ndt
 }  // namespace localization
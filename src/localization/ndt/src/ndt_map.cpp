@@ -15,11 +15,19 @@
 // Co-developed by Tier IV, Inc. and Apex.AI, Inc.
 
 #include <ndt/ndt_map.hpp>
+#include <ndt/ndt_map_binary.hpp>
 #include <ndt/utils.hpp>
 #include <sensor_msgs/point_cloud2_iterator.hpp>
 #include <point_cloud_msg_wrapper/point_cloud_msg_wrapper.hpp>
+#include <autoware_auto_algorithm/radix_sort.hpp>
+#include <thread_pool/parallel.hpp>
 #include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace autoware
 {
@@ -27,8 +35,46 @@ namespace localization
 {
 namespace ndt
 {
-DynamicNDTMap::DynamicNDTMap(const Config & voxel_grid_config)
-: m_grid{voxel_grid_config} {}
+namespace
+{
+/// Check if two voxel grid configurations describe the same grid, ignoring the capacity.
+bool8_t same_grid(
+  const DynamicNDTMap::Config & config,
+  const DynamicNDTMap::ConfigPoint & min_point,
+  const DynamicNDTMap::ConfigPoint & max_point,
+  const DynamicNDTMap::ConfigPoint & voxel_size)
+{
+  const auto equal = [](const DynamicNDTMap::ConfigPoint & p1,
+      const DynamicNDTMap::ConfigPoint & p2) {
+      return (p1.x == p2.x) && (p1.y == p2.y) && (p1.z == p2.z);
+    };
+  return equal(config.get_min_point(), min_point) && equal(config.get_max_point(), max_point) &&
+         equal(config.get_voxel_size(), voxel_size);
+}
+
+/// Upper bound of a grid axis such that the axis holds a whole number of voxels. The voxel grid
+/// truncates the number of voxels per axis, so a partial voxel at the end of an axis would share
+/// its indices with the first voxel of the next row.
+float32_t whole_voxel_max(const float32_t min, const float32_t max, const float32_t voxel_size)
+{
+  const auto extent = static_cast<float64_t>(max) - static_cast<float64_t>(min);
+  const auto num_voxels = std::ceil(extent / static_cast<float64_t>(voxel_size));
+  auto whole_max = static_cast<float32_t>(
+    static_cast<float64_t>(min) + (num_voxels * static_cast<float64_t>(voxel_size)));
+  while (((static_cast<float64_t>(whole_max) - static_cast<float64_t>(min)) /
+    static_cast<float64_t>(voxel_size)) < num_voxels)
+  {
+    whole_max = std::nextafter(whole_max, std::numeric_limits<float32_t>::max());
+  }
+  return whole_max;
+}
+}  // namespace
+
+DynamicNDTMap::DynamicNDTMap(
+  const Config & voxel_grid_config,
+  const CellLookupMode lookup_mode,
+  const Forgetting & forgetting)
+: m_grid{voxel_grid_config, lookup_mode}, m_forgetting{forgetting} {}
 
 const std::string & DynamicNDTMap::frame_id() const noexcept
 {
@@ -50,6 +96,11 @@ const DynamicNDTMap::ConfigPoint & DynamicNDTMap::cell_size() const noexcept
   return m_grid.cell_size();
 }
 
+const DynamicNDTMap::Config & DynamicNDTMap::config() const noexcept
+{
+  return m_grid.config();
+}
+
 void DynamicNDTMap::set(const sensor_msgs::msg::PointCloud2 & msg)
 {
   m_grid.clear();
@@ -60,9 +111,12 @@ void DynamicNDTMap::insert(const sensor_msgs::msg::PointCloud2 & msg)
 {
   using PointXYZI = autoware::common::types::PointXYZI;
   point_cloud_msg_wrapper::PointCloud2View<PointXYZI> msg_view{msg};
+  const auto stamp = ::time_utils::from_message(msg.header.stamp);
 
   for (const auto & point : msg_view) {
-    m_grid.add_observation({point.x, point.y, point.z});
+    auto & vx = m_grid.add_observation({point.x, point.y, point.z});
+    vx.limit_num_points(m_forgetting.max_points_per_voxel);
+    vx.set_last_observation(stamp);
   }
 
   // try to stabilizie the covariance after inserting all the points
@@ -70,8 +124,141 @@ void DynamicNDTMap::insert(const sensor_msgs::msg::PointCloud2 & msg)
     auto & vx = vx_it.second;
     (void) vx.try_stabilize();
   }
-  m_stamp = ::time_utils::from_message(msg.header.stamp);
+  finish_insert(msg, stamp);
+}
+
+void DynamicNDTMap::insert(
+  const sensor_msgs::msg::PointCloud2 & msg,
+  common::thread_pool::ThreadPool & pool)
+{
+  using PointXYZI = autoware::common::types::PointXYZI;
+  using common::thread_pool::parallel_for;
+  point_cloud_msg_wrapper::PointCloud2View<PointXYZI> msg_view{msg};
+  const auto stamp = ::time_utils::from_message(msg.header.stamp);
+  const auto num_points = msg_view.size();
+  if (num_points > std::numeric_limits<uint32_t>::max()) {
+    throw std::length_error("DynamicNDTMap: Too many points for a parallel insertion.");
+  }
+
+  // A point with the index of its voxel, and its index in the message to restore the order
+  struct VoxelPoint
+  {
+    uint64_t voxel_idx;
+    uint32_t msg_idx;
+    float32_t x;
+    float32_t y;
+    float32_t z;
+  };
+  constexpr std::size_t kPointGrain = 16384U;
+  std::vector<VoxelPoint> points(num_points);
+  parallel_for(
+    pool, 0U, num_points, kPointGrain,
+    [this, &msg_view, &points](const std::size_t begin, const std::size_t end) {
+      for (auto i = begin; i < end; ++i) {
+        const auto & point = msg_view[i];
+        points[i] = VoxelPoint{m_grid.index({point.x, point.y, point.z}),
+          static_cast<uint32_t>(i), point.x, point.y, point.z};
+      }
+    });
+  // The sort is stable, so the points of a voxel keep their order in the message
+  common::algorithm::RadixSorter<VoxelPoint>{num_points, pool}.sort(
+    points.begin(), points.end(), [](const VoxelPoint & pt) {return pt.voxel_idx;});
+
+  // The points of a voxel are a run in the sorted points
+  struct Run
+  {
+    uint32_t first_msg_idx;
+    std::size_t begin;
+    std::size_t end;
+    Voxel * voxel;
+  };
+  std::vector<Run> runs;
+  for (std::size_t i = 0U; i < num_points; ++i) {
+    if ((0U == i) || (points[i].voxel_idx != points[i - 1U].voxel_idx)) {
+      runs.push_back(Run{points[i].msg_idx, i, i, nullptr});
+    }
+    ++runs.back().end;
+  }
+  // Voxels are created in the order of the message, so that the hash map and hence the
+  // serialization of the map are the same as after a serial insertion
+  common::algorithm::RadixSorter<Run>{runs.size(), pool}.sort(
+    runs.begin(), runs.end(), [](const Run & run) {return run.first_msg_idx;});
+  for (auto & run : runs) {
+    run.voxel = &m_grid.emplace_voxel(points[run.begin].voxel_idx, Voxel{}).first->second;
+  }
+
+  constexpr std::size_t kVoxelGrain = 256U;
+  const auto max_points_per_voxel = m_forgetting.max_points_per_voxel;
+  parallel_for(
+    pool, 0U, runs.size(), kVoxelGrain,
+    [&runs, &points, max_points_per_voxel, stamp](const std::size_t begin, const std::size_t end) {
+      for (auto i = begin; i < end; ++i) {
+        auto & vx = *runs[i].voxel;
+        for (auto j = runs[i].begin; j < runs[i].end; ++j) {
+          vx.add_observation({points[j].x, points[j].y, points[j].z});
+          vx.limit_num_points(max_points_per_voxel);
+        }
+        vx.set_last_observation(stamp);
+      }
+    });
+
+  // try to stabilizie the covariance after inserting all the points
+  std::vector<Voxel *> voxels;
+  voxels.reserve(m_grid.size());
+  for (auto & vx_it : m_grid) {
+    voxels.push_back(&vx_it.second);
+  }
+  parallel_for(
+    pool, 0U, voxels.size(), kVoxelGrain,
+    [&voxels](const std::size_t begin, const std::size_t end) {
+      for (auto i = begin; i < end; ++i) {
+        (void) voxels[i]->try_stabilize();
+      }
+    });
+  finish_insert(msg, stamp);
+}
+
+void DynamicNDTMap::finish_insert(
+  const sensor_msgs::msg::PointCloud2 & msg,
+  const TimePoint stamp)
+{
+  m_stamp = stamp;
   m_frame_id = msg.header.frame_id;
+  (void)sweep(m_forgetting.num_buckets_swept_per_insert);
+}
+
+std::size_t DynamicNDTMap::remove_stale_voxels()
+{
+  m_sweep_bucket = 0U;
+  return sweep(m_grid.bucket_count());
+}
+
+const DynamicNDTMap::Forgetting & DynamicNDTMap::forgetting() const noexcept
+{
+  return m_forgetting;
+}
+
+std::size_t DynamicNDTMap::sweep(const std::size_t num_buckets)
+{
+  if (m_forgetting.max_voxel_age.count() <= 0) {
+    return 0U;
+  }
+  const auto oldest_stamp = m_stamp - m_forgetting.max_voxel_age;
+  const auto bucket_count = m_grid.bucket_count();
+  m_stale_voxels.clear();
+  for (std::size_t i = 0U; i < std::min(num_buckets, bucket_count); ++i) {
+    const auto bucket = (m_sweep_bucket + i) % bucket_count;
+    for (auto vx_it = m_grid.cbegin(bucket); vx_it != m_grid.cend(bucket); ++vx_it) {
+      if (vx_it->second.last_observation() < oldest_stamp) {
+        m_stale_voxels.push_back(vx_it->first);
+      }
+    }
+  }
+  m_sweep_bucket = (m_sweep_bucket + std::min(num_buckets, bucket_count)) % bucket_count;
+  for (const auto idx : m_stale_voxels) {
+    (void)m_grid.erase_voxel(idx);
+  }
+  return m_stale_voxels.size();
 }
 
 /// The resulting point cloud has the following fields: x, y, z, cov_xx, cov_xy, cov_xz, cov_yy,
@@ -140,6 +327,11 @@ const
   return cell(Point({x, y, z}));
 }
 
+void DynamicNDTMap::cell(const Point & pt, VoxelViewVector & output) const
+{
+  m_grid.cell(pt, output);
+}
+
 std::size_t DynamicNDTMap::size() const noexcept
 {
   return m_grid.size();
@@ -160,22 +352,38 @@ void DynamicNDTMap::clear() noexcept
   m_grid.clear();
 }
 
-const std::string & StaticNDTMap::frame_id() const noexcept
+template<>
+void DynamicNDTMap::serialize_as<PackedStaticNDTMap>(sensor_msgs::msg::PointCloud2 & msg_out)
+const
+{
+  // Both static maps are deserialized from the same format
+  serialize_as<StaticNDTMap>(msg_out);
+}
+
+template<typename VoxelT>
+BasicStaticNDTMap<VoxelT>::BasicStaticNDTMap(const CellLookupMode lookup_mode)
+: m_lookup_mode{lookup_mode} {}
+
+template<typename VoxelT>
+const std::string & BasicStaticNDTMap<VoxelT>::frame_id() const noexcept
 {
   return m_frame_id;
 }
 
-StaticNDTMap::TimePoint StaticNDTMap::stamp() const noexcept
+template<typename VoxelT>
+typename BasicStaticNDTMap<VoxelT>::TimePoint BasicStaticNDTMap<VoxelT>::stamp() const noexcept
 {
   return m_stamp;
 }
 
-bool StaticNDTMap::valid() const noexcept
+template<typename VoxelT>
+bool BasicStaticNDTMap<VoxelT>::valid() const noexcept
 {
   return m_grid && (m_grid->size() > 0U) && (!m_frame_id.empty());
 }
 
-const StaticNDTMap::ConfigPoint & StaticNDTMap::cell_size() const
+template<typename VoxelT>
+const typename BasicStaticNDTMap<VoxelT>::ConfigPoint & BasicStaticNDTMap<VoxelT>::cell_size() const
 {
   if (!m_grid) {
     throw std::runtime_error("Static ndt map was attempted to be used before a map was set.");
@@ -183,17 +391,144 @@ const StaticNDTMap::ConfigPoint & StaticNDTMap::cell_size() const
   return m_grid->cell_size();
 }
 
-void StaticNDTMap::set(const sensor_msgs::msg::PointCloud2 & msg)
+template<typename VoxelT>
+void BasicStaticNDTMap<VoxelT>::set(const sensor_msgs::msg::PointCloud2 & msg)
 {
-  if (m_grid) {
-    m_grid->clear();
-  }
   deserialize_from(msg);
   m_stamp = ::time_utils::from_message(msg.header.stamp);
   m_frame_id = msg.header.frame_id;
 }
 
-void StaticNDTMap::deserialize_from(const sensor_msgs::msg::PointCloud2 & msg)
+template<typename VoxelT>
+void BasicStaticNDTMap<VoxelT>::set(const NDTMapBinaryFile & file)
+{
+  if (m_grid) {
+    m_grid->clear();
+    m_grid->set_config(file.config());
+  }
+  insert(file);
+}
+
+template<typename VoxelT>
+void BasicStaticNDTMap<VoxelT>::insert(const NDTMapBinaryFile & file)
+{
+  if (!m_grid) {
+    m_grid.emplace(file.config(), m_lookup_mode);
+  } else if (m_grid->size() == 0U) {
+    m_grid->set_config(file.config());
+  } else {
+    const auto file_config = file.config();
+    if (!same_grid(
+        m_grid->config(), file_config.get_min_point(), file_config.get_max_point(),
+        file_config.get_voxel_size()))
+    {
+      throw std::runtime_error(
+              "StaticNDTMap: Binary map has a different voxel grid configuration than the map.");
+    }
+  }
+
+  for (const auto & record : file) {
+    const Point centroid{record.centroid[0U], record.centroid[1U], record.centroid[2U]};
+    const auto & icov = record.inv_covariance;
+    Eigen::Matrix3d inv_covariance;
+    inv_covariance <<
+      icov[0U], icov[1U], icov[2U],
+      icov[1U], icov[3U], icov[4U],
+      icov[2U], icov[4U], icov[5U];
+
+    const auto insert_res = m_grid->emplace_voxel(record.index, Voxel{centroid, inv_covariance});
+    if (!insert_res.second) {
+      // if a voxel already exist at this index, replace.
+      insert_res.first->second = Voxel{centroid, inv_covariance};
+    }
+  }
+  m_stamp = TimePoint{std::chrono::duration_cast<TimePoint::duration>(
+        std::chrono::nanoseconds{file.header().stamp_ns})};
+  m_frame_id = file.frame_id();
+}
+
+template<typename VoxelT>
+void BasicStaticNDTMap<VoxelT>::remove(const NDTMapBinaryFile & file)
+{
+  if (!m_grid) {
+    return;
+  }
+  for (const auto & record : file) {
+    (void) m_grid->erase_voxel(record.index);
+  }
+}
+
+template<typename VoxelT>
+void BasicStaticNDTMap<VoxelT>::set_coarsened(const BasicStaticNDTMap & fine, const uint32_t factor)
+{
+  if (factor == 0U) {
+    throw std::domain_error("StaticNDTMap: Coarsening factor must be positive.");
+  }
+  if (&fine == this) {
+    throw std::domain_error("StaticNDTMap: A map cannot be coarsened into itself.");
+  }
+  if (!fine.m_grid) {
+    throw std::runtime_error("Static ndt map was attempted to be used before a map was set.");
+  }
+
+  const auto & fine_config = fine.m_grid->config();
+  auto voxel_size = fine_config.get_voxel_size();
+  voxel_size.x *= static_cast<float32_t>(factor);
+  voxel_size.y *= static_cast<float32_t>(factor);
+  voxel_size.z *= static_cast<float32_t>(factor);
+  const auto & min_point = fine_config.get_min_point();
+  auto max_point = fine_config.get_max_point();
+  max_point.x = whole_voxel_max(min_point.x, max_point.x, voxel_size.x);
+  max_point.y = whole_voxel_max(min_point.y, max_point.y, voxel_size.y);
+  max_point.z = whole_voxel_max(min_point.z, max_point.z, voxel_size.z);
+  const Config config{min_point, max_point, voxel_size, fine_config.get_capacity()};
+  if (m_grid) {
+    m_grid->clear();
+    m_grid->set_config(config);
+  } else {
+    m_grid.emplace(config, m_lookup_mode);
+  }
+  m_updated_indices.clear();
+
+  // Number, sum of the centroids and sum of the second moments of the fine voxels per coarse
+  // voxel. The second moment of a voxel is its covariance plus the outer product of its centroid.
+  struct Moments
+  {
+    std::size_t count{0U};
+    Point centroid_sum{Point::Zero()};
+    Eigen::Matrix3d second_moment_sum{Eigen::Matrix3d::Zero()};
+  };
+  std::unordered_map<uint64_t, Moments> moments{};
+  moments.reserve(fine.m_grid->size());
+  for (const auto & vx_it : *fine.m_grid) {
+    const auto & voxel = vx_it.second;
+    if (!voxel.usable()) {
+      continue;
+    }
+    const Point centroid = voxel.centroid();
+    auto & coarse = moments[m_grid->index(centroid)];
+    ++coarse.count;
+    coarse.centroid_sum += centroid;
+    coarse.second_moment_sum += voxel.covariance() + (centroid * centroid.transpose());
+  }
+
+  for (const auto & moments_it : moments) {
+    const auto & coarse = moments_it.second;
+    const auto count = static_cast<float64_t>(coarse.count);
+    const Point centroid = coarse.centroid_sum / count;
+    Eigen::Matrix3d covariance =
+      (coarse.second_moment_sum / count) - (centroid * centroid.transpose());
+    if (!try_stabilize_covariance(covariance)) {
+      continue;
+    }
+    (void) m_grid->emplace_voxel(moments_it.first, Voxel{centroid, covariance.inverse()});
+  }
+  m_stamp = fine.m_stamp;
+  m_frame_id = fine.m_frame_id;
+}
+
+template<typename VoxelT>
+void BasicStaticNDTMap<VoxelT>::deserialize_from(const sensor_msgs::msg::PointCloud2 & msg)
 {
   using PointXYZ = geometry_msgs::msg::Point32;
   constexpr auto num_config_fields = 3U;
@@ -216,12 +551,22 @@ void StaticNDTMap::deserialize_from(const sensor_msgs::msg::PointCloud2 & msg)
     set__z(static_cast<float>(voxel_size.z)),
     map_size};
 
-  // Either update the map config or initialize the map.
-  if (m_grid) {
-    m_grid->set_config(config);
-  } else {
-    m_grid.emplace(config);
+  // A map with the same grid configuration is updated in place: only voxels that changed are
+  // written and voxels missing from the message are removed, so the storage of the unchanged
+  // voxels is kept. Otherwise the map is rebuilt.
+  const auto incremental = m_grid &&
+    same_grid(
+    m_grid->config(), config.get_min_point(), config.get_max_point(),
+    config.get_voxel_size());
+  if (!incremental) {
+    if (m_grid) {
+      m_grid->clear();
+      m_grid->set_config(config);
+    } else {
+      m_grid.emplace(config, m_lookup_mode);
+    }
   }
+  m_updated_indices.clear();
 
   for (auto it = std::next(msg_view.begin(), num_config_fields); it != msg_view.end(); ++it) {
     const auto & voxel_point = *it;
@@ -233,16 +578,38 @@ void StaticNDTMap::deserialize_from(const sensor_msgs::msg::PointCloud2 & msg)
       voxel_point.icov_xx, voxel_point.icov_xy, voxel_point.icov_xz,
       voxel_point.icov_xy, voxel_point.icov_yy, voxel_point.icov_yz,
       voxel_point.icov_xz, voxel_point.icov_yz, voxel_point.icov_zz;
-    const Voxel vx{centroid, inv_covariance};
 
-    const auto insert_res = m_grid->emplace_voxel(voxel_idx, Voxel{centroid, inv_covariance});
+    const Voxel voxel{centroid, inv_covariance};
+    const auto insert_res = m_grid->emplace_voxel(voxel_idx, voxel);
     if (!insert_res.second) {
-      // if a voxel already exist at this point, replace.
-      insert_res.first->second = vx;
+      auto & existing_vx = insert_res.first->second;
+      // if a different voxel already exist at this point, replace. The voxels are compared by
+      // their stored values, which may be rounded.
+      if ((existing_vx.centroid() != voxel.centroid()) ||
+        (existing_vx.inverse_covariance() != voxel.inverse_covariance()))
+      {
+        existing_vx = voxel;
+      }
+    }
+    if (incremental) {
+      (void) m_updated_indices.insert(voxel_idx);
+    }
+  }
+
+  if (incremental && (m_updated_indices.size() != m_grid->size())) {
+    for (auto it = m_grid->begin(); it != m_grid->end(); ) {
+      if (m_updated_indices.find(it->first) == m_updated_indices.end()) {
+        it = m_grid->erase_voxel(it);
+      } else {
+        ++it;
+      }
     }
   }
 }
-const StaticNDTMap::VoxelViewVector & StaticNDTMap::cell(const Point & pt) const
+
+template<typename VoxelT>
+const typename BasicStaticNDTMap<VoxelT>::VoxelViewVector &
+BasicStaticNDTMap<VoxelT>::cell(const Point & pt) const
 {
   if (!m_grid) {
     throw std::runtime_error("Static ndt map was attempted to be used before a map was set.");
@@ -250,13 +617,24 @@ const StaticNDTMap::VoxelViewVector & StaticNDTMap::cell(const Point & pt) const
   return m_grid->cell(pt);
 }
 
-const StaticNDTMap::VoxelViewVector & StaticNDTMap::cell(float32_t x, float32_t y, float32_t z)
-const
+template<typename VoxelT>
+const typename BasicStaticNDTMap<VoxelT>::VoxelViewVector &
+BasicStaticNDTMap<VoxelT>::cell(float32_t x, float32_t y, float32_t z) const
 {
   return cell(Point({x, y, z}));
 }
 
-std::size_t StaticNDTMap::size() const
+template<typename VoxelT>
+void BasicStaticNDTMap<VoxelT>::cell(const Point & pt, VoxelViewVector & output) const
+{
+  if (!m_grid) {
+    throw std::runtime_error("Static ndt map was attempted to be used before a map was set.");
+  }
+  m_grid->cell(pt, output);
+}
+
+template<typename VoxelT>
+std::size_t BasicStaticNDTMap<VoxelT>::size() const
 {
   if (!m_grid) {
     throw std::runtime_error("Static ndt map was attempted to be used before a map was set.");
@@ -264,7 +642,9 @@ std::size_t StaticNDTMap::size() const
   return m_grid->size();
 }
 
-typename StaticNDTMap::VoxelGrid::const_iterator StaticNDTMap::begin() const
+template<typename VoxelT>
+typename BasicStaticNDTMap<VoxelT>::VoxelGrid::const_iterator
+BasicStaticNDTMap<VoxelT>::begin() const
 {
   if (!m_grid) {
     throw std::runtime_error("Static ndt map was attempted to be used before a map was set.");
@@ -272,7 +652,9 @@ typename StaticNDTMap::VoxelGrid::const_iterator StaticNDTMap::begin() const
   return m_grid->cbegin();
 }
 
-typename StaticNDTMap::VoxelGrid::const_iterator StaticNDTMap::end() const
+template<typename VoxelT>
+typename BasicStaticNDTMap<VoxelT>::VoxelGrid::const_iterator
+BasicStaticNDTMap<VoxelT>::end() const
 {
   if (!m_grid) {
     throw std::runtime_error("Static ndt map was attempted to be used before a map was set.");
@@ -280,13 +662,17 @@ typename StaticNDTMap::VoxelGrid::const_iterator StaticNDTMap::end() const
   return m_grid->cend();
 }
 
-void StaticNDTMap::clear()
+template<typename VoxelT>
+void BasicStaticNDTMap<VoxelT>::clear()
 {
   if (!m_grid) {
     throw std::runtime_error("Static ndt map was attempted to be used before a map was set.");
   }
   m_grid->clear();
 }
+
+template class BasicStaticNDTMap<StaticNDTVoxel>;
+template class BasicStaticNDTMap<PackedNDTVoxel>;
 }  // namespace ndt
 }  // namespace localization
 }  // namespace autoware
@@ -0,0 +1,236 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#include <ndt/ndt_map_binary.hpp>
+#include <ndt/utils.hpp>
+#include <time_utils/time_utils.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace autoware
+{
+namespace localization
+{
+namespace ndt
+{
+namespace
+{
+std::array<float32_t, 3U> to_array(const DynamicNDTMap::ConfigPoint & pt)
+{
+  return {{pt.x, pt.y, pt.z}};
+}
+
+DynamicNDTMap::ConfigPoint to_config_point(const std::array<float32_t, 3U> & arr)
+{
+  return DynamicNDTMap::ConfigPoint{}.set__x(arr[0U]).set__y(arr[1U]).set__z(arr[2U]);
+}
+}  // namespace
+
+std::vector<NDTMapBinaryVoxel> make_ndt_map_binary_voxels(const DynamicNDTMap & map)
+{
+  std::vector<NDTMapBinaryVoxel> voxels;
+  voxels.reserve(map.size());
+  for (const auto & vx_it : map) {
+    const auto & vx = vx_it.second;
+    if (!vx.usable()) {
+      continue;
+    }
+    const auto inv_covariance_opt = vx.inverse_covariance();
+    if (!inv_covariance_opt) {
+      continue;
+    }
+    const auto & centroid = vx.centroid();
+    const auto & icov = inv_covariance_opt.value();
+    voxels.push_back(
+      NDTMapBinaryVoxel{
+          vx_it.first,
+          {{centroid(0U), centroid(1U), centroid(2U)}},
+          {{icov(0U, 0U), icov(0U, 1U), icov(0U, 2U), icov(1U, 1U), icov(1U, 2U), icov(2U, 2U)}}});
+  }
+  return voxels;
+}
+
+std::size_t write_ndt_map_binary(
+  const DynamicNDTMap & map,
+  const std::vector<NDTMapBinaryVoxel> & voxels,
+  const std::string & file_name)
+{
+  if (map.frame_id().size() >= std::tuple_size<decltype(NDTMapBinaryHeader::frame_id)>::value) {
+    throw std::runtime_error("write_ndt_map_binary: frame id of the map is too long.");
+  }
+  std::ofstream out{file_name, std::ios::binary | std::ios::trunc};
+  if (!out) {
+    throw std::runtime_error("write_ndt_map_binary: " + file_name + " could not be opened.");
+  }
+
+  NDTMapBinaryHeader header{};
+  header.magic = kNDTMapBinaryMagic;
+  header.version = kNDTMapBinaryVersion;
+  header.voxel_record_size = static_cast<uint32_t>(sizeof(NDTMapBinaryVoxel));
+  header.min_point = to_array(map.config().get_min_point());
+  header.max_point = to_array(map.config().get_max_point());
+  header.voxel_size = to_array(map.config().get_voxel_size());
+  header.num_voxels = voxels.size();
+  header.stamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    map.stamp().time_since_epoch()).count();
+  std::copy(map.frame_id().begin(), map.frame_id().end(), header.frame_id.begin());
+
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  out.write(
+    reinterpret_cast<const char *>(voxels.data()),
+    static_cast<std::streamsize>(voxels.size() * sizeof(NDTMapBinaryVoxel)));
+  if (!out) {
+    throw std::runtime_error("write_ndt_map_binary: failed writing to " + file_name + ".");
+  }
+  return voxels.size();
+}
+
+std::size_t write_ndt_map_binary(const DynamicNDTMap & map, const std::string & file_name)
+{
+  return write_ndt_map_binary(map, make_ndt_map_binary_voxels(map), file_name);
+}
+
+NDTMapBinaryFile::NDTMapBinaryFile(const std::string & file_name)
+{
+  const auto fd = ::open(file_name.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("NDTMapBinaryFile: " + file_name + " could not be opened.");
+  }
+  struct stat file_stat {};
+  if (::fstat(fd, &file_stat) != 0) {
+    (void) ::close(fd);
+    throw std::runtime_error("NDTMapBinaryFile: " + file_name + " could not be read.");
+  }
+  if (static_cast<std::size_t>(file_stat.st_size) < sizeof(NDTMapBinaryHeader)) {
+    (void) ::close(fd);
+    throw std::runtime_error("NDTMapBinaryFile: " + file_name + " is too small.");
+  }
+  m_size = static_cast<std::size_t>(file_stat.st_size);
+  m_data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping stays valid after closing the descriptor.
+  (void) ::close(fd);
+  if (m_data == MAP_FAILED) {
+    m_data = nullptr;
+    throw std::runtime_error("NDTMapBinaryFile: " + file_name + " could not be mapped.");
+  }
+  // Records are consumed front to back when the map is set.
+  (void) ::madvise(m_data, m_size, MADV_SEQUENTIAL);
+
+  const auto & hdr = header();
+  std::string error{};
+  if (hdr.magic != kNDTMapBinaryMagic) {
+    error = " is not a binary ndt map.";
+  } else if (hdr.version != kNDTMapBinaryVersion) {
+    error = " has unsupported version " + std::to_string(hdr.version) + ".";
+  } else if (hdr.voxel_record_size != sizeof(NDTMapBinaryVoxel)) {
+    error = " has a mismatching voxel record size.";
+  } else if ((m_size - sizeof(NDTMapBinaryHeader)) / sizeof(NDTMapBinaryVoxel) !=
+    hdr.num_voxels ||
+    (m_size - sizeof(NDTMapBinaryHeader)) % sizeof(NDTMapBinaryVoxel) != 0U)
+  {
+    error = " is truncated or corrupted.";
+  } else if (std::find(hdr.frame_id.begin(), hdr.frame_id.end(), '\0') == hdr.frame_id.end()) {
+    error = " has an invalid frame id.";
+  }
+  if (!error.empty()) {
+    (void) ::munmap(m_data, m_size);
+    m_data = nullptr;
+    throw std::runtime_error("NDTMapBinaryFile: " + file_name + error);
+  }
+}
+
+NDTMapBinaryFile::~NDTMapBinaryFile()
+{
+  if (m_data != nullptr) {
+    (void) ::munmap(m_data, m_size);
+  }
+}
+
+const NDTMapBinaryHeader & NDTMapBinaryFile::header() const noexcept
+{
+  return *static_cast<const NDTMapBinaryHeader *>(m_data);
+}
+
+DynamicNDTMap::Config NDTMapBinaryFile::config() const
+{
+  const auto & hdr = header();
+  return DynamicNDTMap::Config{
+    to_config_point(hdr.min_point),
+    to_config_point(hdr.max_point),
+    to_config_point(hdr.voxel_size),
+    std::max(hdr.num_voxels, uint64_t{1U})};
+}
+
+std::string NDTMapBinaryFile::frame_id() const
+{
+  return std::string{header().frame_id.data()};
+}
+
+std::size_t NDTMapBinaryFile::size() const noexcept
+{
+  return header().num_voxels;
+}
+
+const NDTMapBinaryVoxel * NDTMapBinaryFile::begin() const noexcept
+{
+  return reinterpret_cast<const NDTMapBinaryVoxel *>(
+    static_cast<const uint8_t *>(m_data) + sizeof(NDTMapBinaryHeader));
+}
+
+const NDTMapBinaryVoxel * NDTMapBinaryFile::end() const noexcept
+{
+  return begin() + size();
+}
+
+void serialize_from_binary(
+  const NDTMapBinaryFile & file,
+  sensor_msgs::msg::PointCloud2 & msg_out)
+{
+  ndt::NdtMapCloudModifier msg_modifier{msg_out, file.frame_id()};
+  msg_modifier.reserve(file.size() + DynamicNDTMap::kNumConfigPoints);
+  msg_out.header.stamp = time_utils::to_message(
+    DynamicNDTMap::TimePoint{std::chrono::duration_cast<DynamicNDTMap::TimePoint::duration>(
+        std::chrono::nanoseconds{file.header().stamp_ns})});
+
+  const auto & hdr = file.header();
+  for (const auto & pt : {hdr.min_point, hdr.max_point, hdr.voxel_size}) {
+    msg_modifier.push_back(
+      PointWithCovariances{
+          static_cast<float64_t>(pt[0U]), static_cast<float64_t>(pt[1U]),
+          static_cast<float64_t>(pt[2U]), 0.0, 0.0, 0.0, 0.0, 0.0, 0.0});
+  }
+  for (const auto & vx : file) {
+    msg_modifier.push_back(
+      PointWithCovariances{
+          vx.centroid[0U], vx.centroid[1U], vx.centroid[2U],
+          vx.inv_covariance[0U], vx.inv_covariance[1U], vx.inv_covariance[2U],
+          vx.inv_covariance[3U], vx.inv_covariance[4U], vx.inv_covariance[5U]});
+  }
+}
+
+}  // namespace ndt
+}  // namespace localization
+}  // namespace autoware
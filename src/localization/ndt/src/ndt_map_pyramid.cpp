@@ -0,0 +1,126 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#include <ndt/ndt_map_pyramid.hpp>
+#include <ndt/ndt_map_binary.hpp>
+
+#include <stdexcept>
+#include <string>
+
+namespace autoware
+{
+namespace localization
+{
+namespace ndt
+{
+template<typename VoxelT>
+BasicNDTMapPyramid<VoxelT>::BasicNDTMapPyramid(
+  const std::size_t num_levels,
+  const uint32_t level_scale,
+  const CellLookupMode lookup_mode)
+: m_level_scale{level_scale}
+{
+  if (num_levels == 0U) {
+    throw std::domain_error("NDTMapPyramid: There must be at least one level.");
+  }
+  if (level_scale < 2U) {
+    throw std::domain_error("NDTMapPyramid: Level scale must be at least 2.");
+  }
+  m_levels.reserve(num_levels);
+  for (std::size_t i = 0U; i < num_levels; ++i) {
+    m_levels.emplace_back(lookup_mode);
+  }
+}
+
+template<typename VoxelT>
+void BasicNDTMapPyramid<VoxelT>::set(const sensor_msgs::msg::PointCloud2 & msg)
+{
+  m_levels.front().set(msg);
+  build_coarse_levels();
+}
+
+template<typename VoxelT>
+void BasicNDTMapPyramid<VoxelT>::set(const NDTMapBinaryFile & file)
+{
+  m_levels.front().set(file);
+  build_coarse_levels();
+}
+
+template<typename VoxelT>
+void BasicNDTMapPyramid<VoxelT>::insert(const NDTMapBinaryFile & file)
+{
+  m_levels.front().insert(file);
+  build_coarse_levels();
+}
+
+template<typename VoxelT>
+void BasicNDTMapPyramid<VoxelT>::remove(const NDTMapBinaryFile & file)
+{
+  m_levels.front().remove(file);
+  build_coarse_levels();
+}
+
+template<typename VoxelT>
+std::size_t BasicNDTMapPyramid<VoxelT>::num_levels() const noexcept
+{
+  return m_levels.size();
+}
+
+template<typename VoxelT>
+const typename BasicNDTMapPyramid<VoxelT>::Map &
+BasicNDTMapPyramid<VoxelT>::level(const std::size_t index) const
+{
+  if (index >= m_levels.size()) {
+    throw std::out_of_range(
+            "NDTMapPyramid: Level " + std::to_string(index) + " does not exist.");
+  }
+  return m_levels[index];
+}
+
+template<typename VoxelT>
+const std::string & BasicNDTMapPyramid<VoxelT>::frame_id() const noexcept
+{
+  return m_levels.front().frame_id();
+}
+
+template<typename VoxelT>
+typename BasicNDTMapPyramid<VoxelT>::TimePoint BasicNDTMapPyramid<VoxelT>::stamp() const noexcept
+{
+  return m_levels.front().stamp();
+}
+
+template<typename VoxelT>
+bool BasicNDTMapPyramid<VoxelT>::valid() const noexcept
+{
+  return m_levels.front().valid();
+}
+
+template<typename VoxelT>
+void BasicNDTMapPyramid<VoxelT>::build_coarse_levels()
+{
+  // Each level is built from the finest one so that all fine voxels have the same weight.
+  uint32_t factor{1U};
+  for (std::size_t i = 1U; i < m_levels.size(); ++i) {
+    factor *= m_level_scale;
+    m_levels[i].set_coarsened(m_levels.front(), factor);
+  }
+}
+
+template class BasicNDTMapPyramid<StaticNDTVoxel>;
+template class BasicNDTMapPyramid<PackedNDTVoxel>;
+}  // namespace ndt
+}  // namespace localization
+}  // namespace autoware
@@ -0,0 +1,280 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#include <ndt/ndt_map_tiles.hpp>
+#include <yaml-cpp/yaml.h>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace autoware
+{
+namespace localization
+{
+namespace ndt
+{
+namespace
+{
+constexpr auto kTileMetadataFileName = "tiles.yaml";
+
+/// Distance from a point to the area covered by a tile.
+float64_t distance_to_tile(
+  const float64_t x, const float64_t y, const NDTMapTileIndex & index,
+  const float64_t tile_size)
+{
+  const auto min_x = static_cast<float64_t>(index.x) * tile_size;
+  const auto min_y = static_cast<float64_t>(index.y) * tile_size;
+  const auto dx = std::max({min_x - x, 0.0, x - (min_x + tile_size)});
+  const auto dy = std::max({min_y - y, 0.0, y - (min_y + tile_size)});
+  return std::hypot(dx, dy);
+}
+}  // namespace
+
+std::size_t NDTMapTileIndexHash::operator()(const NDTMapTileIndex & index) const noexcept
+{
+  const auto packed = (static_cast<uint64_t>(static_cast<uint32_t>(index.x)) << 32U) |
+    static_cast<uint64_t>(static_cast<uint32_t>(index.y));
+  return std::hash<uint64_t>{}(packed);
+}
+
+NDTMapTileIndex tile_index(const float64_t x, const float64_t y, const float64_t tile_size)
+{
+  return NDTMapTileIndex{
+    static_cast<int32_t>(std::floor(x / tile_size)),
+    static_cast<int32_t>(std::floor(y / tile_size))};
+}
+
+std::string tile_file_name(const std::string & directory, const NDTMapTileIndex & index)
+{
+  return directory + "/tile_" + std::to_string(index.x) + "_" + std::to_string(index.y) +
+         ".ndtmap";
+}
+
+std::size_t write_ndt_map_tiles(
+  const DynamicNDTMap & map,
+  const float64_t tile_size,
+  const std::string & directory)
+{
+  if (tile_size <= 0.0) {
+    throw std::domain_error("write_ndt_map_tiles: Tile size must be positive.");
+  }
+  if ((::mkdir(directory.c_str(), 0755) != 0) && (errno != EEXIST)) {
+    throw std::runtime_error("write_ndt_map_tiles: " + directory + " could not be created.");
+  }
+
+  std::unordered_map<NDTMapTileIndex, std::vector<NDTMapBinaryVoxel>, NDTMapTileIndexHash> tiles;
+  for (const auto & voxel : make_ndt_map_binary_voxels(map)) {
+    tiles[tile_index(voxel.centroid[0U], voxel.centroid[1U], tile_size)].push_back(voxel);
+  }
+  for (const auto & tile : tiles) {
+    (void) write_ndt_map_binary(map, tile.second, tile_file_name(directory, tile.first));
+  }
+
+  YAML::Emitter metadata;
+  metadata << YAML::BeginMap;
+  metadata << YAML::Key << "version" << YAML::Value << kNDTMapBinaryVersion;
+  metadata << YAML::Key << "tile_size" << YAML::Value << tile_size;
+  metadata << YAML::Key << "num_tiles" << YAML::Value << tiles.size();
+  metadata << YAML::EndMap;
+  std::ofstream metadata_file{directory + "/" + kTileMetadataFileName};
+  metadata_file << metadata.c_str() << std::endl;
+  if (!metadata_file) {
+    throw std::runtime_error("write_ndt_map_tiles: Metadata could not be written.");
+  }
+  return tiles.size();
+}
+
+float64_t read_tile_size(const std::string & directory)
+{
+  try {
+    const auto metadata = YAML::LoadFile(directory + "/" + kTileMetadataFileName);
+    const auto tile_size = metadata["tile_size"].as<float64_t>();
+    if (tile_size <= 0.0) {
+      throw std::runtime_error("read_tile_size: Tile size must be positive.");
+    }
+    return tile_size;
+  } catch (const YAML::Exception & e) {
+    throw std::runtime_error(
+            "read_tile_size: Tile metadata in " + directory + " could not be read: " + e.what());
+  }
+}
+
+NDTMapTileLoader::NDTMapTileLoader(const std::string & directory, const float64_t radius)
+: m_directory{directory},
+  m_tile_size{read_tile_size(directory)},
+  m_radius{radius}
+{
+  if (m_radius <= 0.0) {
+    throw std::domain_error("NDTMapTileLoader: Radius must be positive.");
+  }
+  m_thread = std::thread{[this] {run();}};
+}
+
+NDTMapTileLoader::~NDTMapTileLoader()
+{
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_stop = true;
+  }
+  m_wake_up.notify_one();
+  if (m_thread.joinable()) {
+    m_thread.join();
+  }
+}
+
+void NDTMapTileLoader::set_position(const float64_t x, const float64_t y)
+{
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_x = x;
+    m_y = y;
+    m_position_pending = true;
+  }
+  m_wake_up.notify_one();
+}
+
+template<typename VoxelT>
+bool8_t NDTMapTileLoader::apply_updates(BasicStaticNDTMap<VoxelT> & map)
+{
+  std::vector<TileUpdate> updates;
+  std::exception_ptr error{nullptr};
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    std::swap(updates, m_pending_updates);
+    std::swap(error, m_error);
+  }
+  // Updates are applied in the order they were produced, so a tile that was
+  // loaded and evicted in the meantime ends up removed.
+  for (const auto & update : updates) {
+    if (update.add) {
+      map.insert(*update.tile);
+    } else {
+      map.remove(*update.tile);
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  return !updates.empty();
+}
+
+template bool8_t NDTMapTileLoader::apply_updates(StaticNDTMap & map);
+template bool8_t NDTMapTileLoader::apply_updates(PackedStaticNDTMap & map);
+
+void NDTMapTileLoader::wait_until_idle()
+{
+  std::unique_lock<std::mutex> lock{m_mutex};
+  m_idle.wait(lock, [this] {return !m_position_pending && !m_busy;});
+}
+
+float64_t NDTMapTileLoader::tile_size() const noexcept
+{
+  return m_tile_size;
+}
+
+std::size_t NDTMapTileLoader::num_loaded_tiles() const
+{
+  std::lock_guard<std::mutex> lock{m_mutex};
+  return static_cast<std::size_t>(
+    std::count_if(
+      m_tiles.begin(), m_tiles.end(), [](const auto & tile) {return tile.second != nullptr;}));
+}
+
+void NDTMapTileLoader::run()
+{
+  std::unique_lock<std::mutex> lock{m_mutex};
+  while (true) {
+    m_wake_up.wait(lock, [this] {return m_stop || m_position_pending;});
+    if (m_stop) {
+      return;
+    }
+    const auto x = m_x;
+    const auto y = m_y;
+    m_position_pending = false;
+    m_busy = true;
+    lock.unlock();
+    try {
+      update_tiles(x, y);
+    } catch (...) {
+      lock.lock();
+      m_error = std::current_exception();
+      lock.unlock();
+    }
+    lock.lock();
+    m_busy = false;
+    m_idle.notify_all();
+  }
+}
+
+void NDTMapTileLoader::update_tiles(const float64_t x, const float64_t y)
+{
+  std::vector<TileUpdate> updates;
+  std::vector<std::pair<NDTMapTileIndex, TilePtr>> loaded_tiles;
+
+  const auto min_index = tile_index(x - m_radius, y - m_radius, m_tile_size);
+  const auto max_index = tile_index(x + m_radius, y + m_radius, m_tile_size);
+  for (auto ix = min_index.x; ix <= max_index.x; ++ix) {
+    for (auto iy = min_index.y; iy <= max_index.y; ++iy) {
+      const NDTMapTileIndex index{ix, iy};
+      if (distance_to_tile(x, y, index, m_tile_size) > m_radius) {
+        continue;
+      }
+      {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        if (m_tiles.find(index) != m_tiles.end()) {
+          continue;
+        }
+      }
+      // Mapping the file is done without holding the lock.
+      TilePtr tile{nullptr};
+      const auto file_name = tile_file_name(m_directory, index);
+      if (::access(file_name.c_str(), F_OK) == 0) {
+        tile = std::make_shared<const NDTMapBinaryFile>(file_name);
+        updates.push_back(TileUpdate{tile, true});
+      }
+      loaded_tiles.emplace_back(index, std::move(tile));
+    }
+  }
+
+  std::lock_guard<std::mutex> lock{m_mutex};
+  m_tiles.insert(loaded_tiles.begin(), loaded_tiles.end());
+  const auto eviction_distance = m_radius + m_tile_size;
+  for (auto it = m_tiles.begin(); it != m_tiles.end(); ) {
+    if (distance_to_tile(x, y, it->first, m_tile_size) > eviction_distance) {
+      if (it->second) {
+        updates.push_back(TileUpdate{it->second, false});
+      }
+      it = m_tiles.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  m_pending_updates.insert(m_pending_updates.end(), updates.begin(), updates.end());
+}
+
+}  // namespace ndt
+}  // namespace localization
+}  // namespace autoware
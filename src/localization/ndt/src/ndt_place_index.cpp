@@ -0,0 +1,469 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#include <ndt/ndt_place_index.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <experimental/optional>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace autoware
+{
+namespace localization
+{
+namespace ndt
+{
+namespace
+{
+constexpr float64_t kPi = 3.14159265358979323846;
+
+/// Find the offset of a float32 field of a point cloud.
+uint32_t float32_field_offset(const sensor_msgs::msg::PointCloud2 & msg, const std::string & name)
+{
+  const auto field_it = std::find_if(
+    msg.fields.begin(), msg.fields.end(),
+    [&name](const sensor_msgs::msg::PointField & field) {return field.name == name;});
+  if ((field_it == msg.fields.end()) ||
+    (field_it->datatype != sensor_msgs::msg::PointField::FLOAT32) || (field_it->count != 1U))
+  {
+    throw std::domain_error("ScanContextIndex: Point cloud has no float32 field " + name + ".");
+  }
+  return field_it->offset;
+}
+
+/// Read a float32 value from a possibly unaligned position in a point cloud buffer.
+float32_t read_float32(const uint8_t * const data)
+{
+  float32_t value;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+/// Add a point relative to the sensor to a descriptor, keeping the highest point of each bin.
+void add_to_descriptor(
+  const ScanContextConfig & config,
+  const float64_t x, const float64_t y, const float64_t z,
+  std::vector<float32_t> & descriptor)
+{
+  if ((z < static_cast<float64_t>(config.min_height())) ||
+    (z > static_cast<float64_t>(config.max_height())))
+  {
+    return;
+  }
+  const auto range = std::hypot(x, y);
+  if ((range < static_cast<float64_t>(config.min_range())) ||
+    (range >= static_cast<float64_t>(config.max_range())))
+  {
+    return;
+  }
+  const auto num_rings = config.num_rings();
+  const auto num_sectors = config.num_sectors();
+  const auto ring = std::min(
+    static_cast<uint32_t>(
+      range / static_cast<float64_t>(config.max_range()) * static_cast<float64_t>(num_rings)),
+    num_rings - 1U);
+  const auto sector = std::min(
+    static_cast<uint32_t>(
+      (std::atan2(y, x) + kPi) / (2.0 * kPi) * static_cast<float64_t>(num_sectors)),
+    num_sectors - 1U);
+  auto & bin = descriptor[(static_cast<std::size_t>(ring) * num_sectors) + sector];
+  bin = std::max(bin, static_cast<float32_t>(z - static_cast<float64_t>(config.min_height())));
+}
+
+/// Key of the square of a 2D hash grid that holds a coordinate.
+uint64_t square_key(const int64_t ix, const int64_t iy)
+{
+  return (static_cast<uint64_t>(static_cast<uint32_t>(ix)) << 32U) |
+         static_cast<uint64_t>(static_cast<uint32_t>(iy));
+}
+}  // namespace
+
+ScanContextConfig::ScanContextConfig(
+  uint32_t num_rings,
+  uint32_t num_sectors,
+  float32_t min_range,
+  float32_t max_range,
+  float32_t min_height,
+  float32_t max_height,
+  uint32_t num_key_candidates)
+: m_num_rings{num_rings},
+  m_num_sectors{num_sectors},
+  m_min_range{min_range},
+  m_max_range{max_range},
+  m_min_height{min_height},
+  m_max_height{max_height},
+  m_num_key_candidates{num_key_candidates}
+{
+  if ((num_rings == 0U) || (num_sectors == 0U)) {
+    throw std::domain_error("ScanContextConfig: Number of rings and sectors must be positive.");
+  }
+  if (!(min_range >= 0.0F) || !(min_range < max_range)) {
+    throw std::domain_error("ScanContextConfig: Range must be a non-negative interval.");
+  }
+  if (!(min_height < max_height)) {
+    throw std::domain_error("ScanContextConfig: Minimum height must be below maximum height.");
+  }
+  if (num_key_candidates == 0U) {
+    throw std::domain_error("ScanContextConfig: Number of key candidates must be positive.");
+  }
+}
+
+ScanContextIndex::ScanContextIndex(const ScanContextConfig & config)
+: m_config{config},
+  m_descriptor_size{static_cast<std::size_t>(config.num_rings()) * config.num_sectors()} {}
+
+template<typename VoxelT>
+void ScanContextIndex::add_places(
+  const BasicStaticNDTMap<VoxelT> & map,
+  const std::vector<Eigen::Vector3d> & positions)
+{
+  // Throws if the map isn't set.
+  const auto map_size = map.size();
+  if (!m_frame_id.empty() && (m_frame_id != map.frame_id())) {
+    throw std::domain_error(
+            "ScanContextIndex: Map frame " + map.frame_id() + " differs from the index frame " +
+            m_frame_id + ".");
+  }
+
+  // The centroids are bucketed in squares of the maximum range, so that the points of a place
+  // are in the 3x3 squares around it.
+  const auto square_size = static_cast<float64_t>(m_config.max_range());
+  std::vector<Eigen::Vector3d> centroids{};
+  centroids.reserve(map_size);
+  std::unordered_map<uint64_t, std::vector<std::size_t>> squares{};
+  for (const auto & vx_it : map) {
+    if (!vx_it.second.usable()) {
+      continue;
+    }
+    centroids.emplace_back(vx_it.second.centroid());
+    const auto & centroid = centroids.back();
+    squares[square_key(
+        static_cast<int64_t>(std::floor(centroid.x() / square_size)),
+        static_cast<int64_t>(std::floor(centroid.y() / square_size)))].push_back(
+      centroids.size() - 1U);
+  }
+
+  std::vector<float32_t> descriptor(m_descriptor_size);
+  for (const auto & position : positions) {
+    std::fill(descriptor.begin(), descriptor.end(), 0.0F);
+    const auto ix = static_cast<int64_t>(std::floor(position.x() / square_size));
+    const auto iy = static_cast<int64_t>(std::floor(position.y() / square_size));
+    for (auto dx = -1; dx <= 1; ++dx) {
+      for (auto dy = -1; dy <= 1; ++dy) {
+        const auto square_it = squares.find(square_key(ix + dx, iy + dy));
+        if (square_it == squares.end()) {
+          continue;
+        }
+        for (const auto idx : square_it->second) {
+          const Eigen::Vector3d offset = centroids[idx] - position;
+          add_to_descriptor(m_config, offset.x(), offset.y(), offset.z(), descriptor);
+        }
+      }
+    }
+    add_descriptor(position, descriptor);
+  }
+  m_frame_id = map.frame_id();
+}
+
+void ScanContextIndex::add_place(
+  const Eigen::Vector3d & position,
+  const std::vector<Eigen::Vector3d> & points)
+{
+  std::vector<float32_t> descriptor(m_descriptor_size, 0.0F);
+  for (const auto & point : points) {
+    const Eigen::Vector3d offset = point - position;
+    add_to_descriptor(m_config, offset.x(), offset.y(), offset.z(), descriptor);
+  }
+  add_descriptor(position, descriptor);
+}
+
+std::vector<PlaceCandidate> ScanContextIndex::query(
+  const sensor_msgs::msg::PointCloud2 & scan,
+  const std::size_t num_candidates) const
+{
+  const auto x_offset = float32_field_offset(scan, "x");
+  const auto y_offset = float32_field_offset(scan, "y");
+  const auto z_offset = float32_field_offset(scan, "z");
+  std::vector<float32_t> descriptor(m_descriptor_size, 0.0F);
+  const auto num_points = static_cast<std::size_t>(scan.width) * scan.height;
+  for (std::size_t i = 0U; i < num_points; ++i) {
+    const auto * point_data = scan.data.data() + (i * scan.point_step);
+    const auto x = read_float32(point_data + x_offset);
+    const auto y = read_float32(point_data + y_offset);
+    const auto z = read_float32(point_data + z_offset);
+    if (!std::isfinite(x) || !std::isfinite(y) || !std::isfinite(z)) {
+      continue;
+    }
+    add_to_descriptor(
+      m_config, static_cast<float64_t>(x), static_cast<float64_t>(y),
+      static_cast<float64_t>(z), descriptor);
+  }
+
+  const auto num_rings = m_config.num_rings();
+  const auto num_sectors = m_config.num_sectors();
+  std::vector<float32_t> key(num_rings);
+  ring_key(descriptor.data(), key.data());
+  std::vector<float32_t> column_norms(num_sectors, 0.0F);
+  for (std::size_t ring = 0U; ring < num_rings; ++ring) {
+    for (std::size_t sector = 0U; sector < num_sectors; ++sector) {
+      const auto value = descriptor[(ring * num_sectors) + sector];
+      column_norms[sector] += value * value;
+    }
+  }
+  for (auto & norm : column_norms) {
+    norm = std::sqrt(norm);
+  }
+
+  // The ring keys don't depend on the yaw, so they preselect the places to align.
+  std::vector<std::pair<float32_t, std::size_t>> key_distances{};
+  key_distances.reserve(size());
+  for (std::size_t place = 0U; place < size(); ++place) {
+    const auto * const place_key = m_ring_keys.data() + (place * num_rings);
+    float32_t distance{0.0F};
+    for (std::size_t ring = 0U; ring < num_rings; ++ring) {
+      const auto diff = place_key[ring] - key[ring];
+      distance += diff * diff;
+    }
+    key_distances.emplace_back(distance, place);
+  }
+  const auto num_aligned = std::min(
+    key_distances.size(), static_cast<std::size_t>(m_config.num_key_candidates()));
+  std::partial_sort(
+    key_distances.begin(), key_distances.begin() + static_cast<std::ptrdiff_t>(num_aligned),
+    key_distances.end());
+
+  std::vector<PlaceCandidate> candidates{};
+  candidates.reserve(num_aligned);
+  const auto sector_angle = 2.0 * kPi / static_cast<float64_t>(num_sectors);
+  for (std::size_t i = 0U; i < num_aligned; ++i) {
+    const auto place = key_distances[i].second;
+    uint32_t shift{0U};
+    const auto distance = align(descriptor, column_norms, place, shift);
+    // The map sector of a scan point is its scan sector shifted by the yaw.
+    auto yaw = static_cast<float64_t>(shift) * sector_angle;
+    if (yaw > kPi) {
+      yaw -= 2.0 * kPi;
+    }
+    EigenPose<Real> pose;
+    pose << m_positions[place].x(), m_positions[place].y(), m_positions[place].z(), 0.0, 0.0,
+      yaw;
+    candidates.push_back(PlaceCandidate{pose, distance, place});
+  }
+  std::stable_sort(
+    candidates.begin(), candidates.end(),
+    [](const PlaceCandidate & lhs, const PlaceCandidate & rhs) {
+      return lhs.distance < rhs.distance;
+    });
+  if (candidates.size() > num_candidates) {
+    candidates.resize(num_candidates);
+  }
+  return candidates;
+}
+
+void ScanContextIndex::write(const std::string & file_name) const
+{
+  if (m_frame_id.size() >= std::tuple_size<decltype(ScanContextIndexHeader::frame_id)>::value) {
+    throw std::runtime_error("ScanContextIndex: Frame id of the index is too long.");
+  }
+  std::ofstream out{file_name, std::ios::binary | std::ios::trunc};
+  if (!out) {
+    throw std::runtime_error("ScanContextIndex: " + file_name + " could not be opened.");
+  }
+  ScanContextIndexHeader header{};
+  header.magic = kScanContextIndexMagic;
+  header.version = kScanContextIndexVersion;
+  header.num_rings = m_config.num_rings();
+  header.num_sectors = m_config.num_sectors();
+  header.num_key_candidates = m_config.num_key_candidates();
+  header.min_range = m_config.min_range();
+  header.max_range = m_config.max_range();
+  header.min_height = m_config.min_height();
+  header.max_height = m_config.max_height();
+  header.num_places = size();
+  std::copy(m_frame_id.begin(), m_frame_id.end(), header.frame_id.begin());
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  for (std::size_t place = 0U; place < size(); ++place) {
+    const std::array<float64_t, 3U> position{{m_positions[place].x(), m_positions[place].y(),
+        m_positions[place].z()}};
+    out.write(reinterpret_cast<const char *>(position.data()), sizeof(position));
+    out.write(
+      reinterpret_cast<const char *>(m_descriptors.data() + (place * m_descriptor_size)),
+      static_cast<std::streamsize>(m_descriptor_size * sizeof(float32_t)));
+  }
+  if (!out) {
+    throw std::runtime_error("ScanContextIndex: Failed writing to " + file_name + ".");
+  }
+}
+
+ScanContextIndex ScanContextIndex::read(const std::string & file_name)
+{
+  std::ifstream in{file_name, std::ios::binary};
+  if (!in) {
+    throw std::runtime_error("ScanContextIndex: " + file_name + " could not be opened.");
+  }
+  ScanContextIndexHeader header{};
+  if (!in.read(reinterpret_cast<char *>(&header), sizeof(header))) {
+    throw std::runtime_error("ScanContextIndex: " + file_name + " is too small.");
+  }
+  if (header.magic != kScanContextIndexMagic) {
+    throw std::runtime_error("ScanContextIndex: " + file_name + " is not a place index.");
+  }
+  if (header.version != kScanContextIndexVersion) {
+    throw std::runtime_error(
+            "ScanContextIndex: " + file_name + " has unsupported version " +
+            std::to_string(header.version) + ".");
+  }
+  if (std::find(header.frame_id.begin(), header.frame_id.end(), '\0') == header.frame_id.end()) {
+    throw std::runtime_error("ScanContextIndex: " + file_name + " has an invalid frame id.");
+  }
+
+  std::experimental::optional<ScanContextConfig> config{};
+  try {
+    config.emplace(
+      header.num_rings, header.num_sectors, header.min_range, header.max_range,
+      header.min_height, header.max_height, header.num_key_candidates);
+  } catch (const std::domain_error &) {
+    throw std::runtime_error(
+            "ScanContextIndex: " + file_name + " has an invalid descriptor configuration.");
+  }
+  ScanContextIndex index{*config};
+  std::array<float64_t, 3U> position{};
+  std::vector<float32_t> descriptor(index.m_descriptor_size);
+  for (uint64_t place = 0U; place < header.num_places; ++place) {
+    in.read(reinterpret_cast<char *>(position.data()), sizeof(position));
+    in.read(
+      reinterpret_cast<char *>(descriptor.data()),
+      static_cast<std::streamsize>(descriptor.size() * sizeof(float32_t)));
+    if (!in) {
+      throw std::runtime_error("ScanContextIndex: " + file_name + " is truncated or corrupted.");
+    }
+    index.add_descriptor(Eigen::Vector3d{position[0U], position[1U], position[2U]}, descriptor);
+  }
+  if (in.peek() != std::ifstream::traits_type::eof()) {
+    throw std::runtime_error("ScanContextIndex: " + file_name + " is truncated or corrupted.");
+  }
+  index.m_frame_id = header.frame_id.data();
+  return index;
+}
+
+std::size_t ScanContextIndex::size() const noexcept
+{
+  return m_positions.size();
+}
+
+const Eigen::Vector3d & ScanContextIndex::position(const std::size_t place_index) const
+{
+  return m_positions.at(place_index);
+}
+
+const std::string & ScanContextIndex::frame_id() const noexcept
+{
+  return m_frame_id;
+}
+
+const ScanContextConfig & ScanContextIndex::config() const noexcept
+{
+  return m_config;
+}
+
+void ScanContextIndex::add_descriptor(
+  const Eigen::Vector3d & position,
+  const std::vector<float32_t> & descriptor)
+{
+  m_positions.push_back(position);
+  m_descriptors.insert(m_descriptors.end(), descriptor.begin(), descriptor.end());
+  m_ring_keys.resize(m_ring_keys.size() + m_config.num_rings());
+  ring_key(descriptor.data(), m_ring_keys.data() + (m_ring_keys.size() - m_config.num_rings()));
+}
+
+void ScanContextIndex::ring_key(const float32_t * const descriptor, float32_t * const key) const
+{
+  const auto num_sectors = m_config.num_sectors();
+  for (std::size_t ring = 0U; ring < m_config.num_rings(); ++ring) {
+    const auto * const ring_begin = descriptor + (ring * num_sectors);
+    const auto occupied = std::count_if(
+      ring_begin, ring_begin + num_sectors, [](const float32_t value) {return value > 0.0F;});
+    key[ring] = static_cast<float32_t>(occupied) / static_cast<float32_t>(num_sectors);
+  }
+}
+
+Real ScanContextIndex::align(
+  const std::vector<float32_t> & query_descriptor,
+  const std::vector<float32_t> & query_column_norms,
+  const std::size_t place_index,
+  uint32_t & best_shift) const
+{
+  const auto num_rings = m_config.num_rings();
+  const auto num_sectors = m_config.num_sectors();
+  const auto * const place_descriptor = m_descriptors.data() + (place_index * m_descriptor_size);
+  std::vector<float32_t> place_column_norms(num_sectors, 0.0F);
+  for (std::size_t ring = 0U; ring < num_rings; ++ring) {
+    for (std::size_t sector = 0U; sector < num_sectors; ++sector) {
+      const auto value = place_descriptor[(ring * num_sectors) + sector];
+      place_column_norms[sector] += value * value;
+    }
+  }
+  for (auto & norm : place_column_norms) {
+    norm = std::sqrt(norm);
+  }
+
+  // Mean cosine distance of the columns that are occupied in both descriptors [Kim 2018].
+  Real best_distance{1.0};
+  best_shift = 0U;
+  for (uint32_t shift = 0U; shift < num_sectors; ++shift) {
+    Real distance_sum{0.0};
+    std::size_t num_columns{0U};
+    for (uint32_t sector = 0U; sector < num_sectors; ++sector) {
+      const auto place_sector = (sector + shift) % num_sectors;
+      const auto query_norm = query_column_norms[sector];
+      const auto place_norm = place_column_norms[place_sector];
+      if ((query_norm <= 0.0F) || (place_norm <= 0.0F)) {
+        continue;
+      }
+      float32_t dot{0.0F};
+      for (std::size_t ring = 0U; ring < num_rings; ++ring) {
+        dot += query_descriptor[(ring * num_sectors) + sector] *
+          place_descriptor[(ring * num_sectors) + place_sector];
+      }
+      distance_sum += 1.0 - static_cast<Real>(dot / (query_norm * place_norm));
+      ++num_columns;
+    }
+    if (num_columns == 0U) {
+      continue;
+    }
+    const auto distance = distance_sum / static_cast<Real>(num_columns);
+    if (distance < best_distance) {
+      best_distance = distance;
+      best_shift = shift;
+    }
+  }
+  return best_distance;
+}
+
+template void ScanContextIndex::add_places<StaticNDTVoxel>(
+  const BasicStaticNDTMap<StaticNDTVoxel> &, const std::vector<Eigen::Vector3d> &);
+template void ScanContextIndex::add_places<PackedNDTVoxel>(
+  const BasicStaticNDTMap<PackedNDTVoxel> &, const std::vector<Eigen::Vector3d> &);
+}  // namespace ndt
+}  // namespace localization
+}  // namespace autoware
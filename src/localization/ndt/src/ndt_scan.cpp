@@ -0,0 +1,410 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#include <ndt/ndt_scan.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace autoware
+{
+namespace localization
+{
+namespace ndt
+{
+namespace
+{
+constexpr auto kEmptyVoxelKey = std::numeric_limits<uint64_t>::max();
+// Voxel coordinates are packed into 21 bits each, which covers +-2^20 voxels around the origin
+// of the sensor frame.
+constexpr auto kVoxelCoordinateBits = 21U;
+constexpr int64_t kVoxelCoordinateOffset = int64_t{1} << (kVoxelCoordinateBits - 1U);
+constexpr uint64_t kVoxelCoordinateMask = (uint64_t{1} << kVoxelCoordinateBits) - 1U;
+
+/// Find the byte offset of a float32 field of a point cloud.
+uint32_t float32_field_offset(
+  const sensor_msgs::msg::PointCloud2 & msg, const std::string & name,
+  const std::string & scan_name)
+{
+  const auto field_it = std::find_if(
+    msg.fields.begin(), msg.fields.end(),
+    [&name](const sensor_msgs::msg::PointField & field) {return field.name == name;});
+  if ((field_it == msg.fields.end()) ||
+    (field_it->datatype != sensor_msgs::msg::PointField::FLOAT32) || (field_it->count != 1U))
+  {
+    throw std::domain_error(scan_name + ": Point cloud has no float32 field " + name + ".");
+  }
+  return field_it->offset;
+}
+
+/// Read a float32 value from a possibly unaligned position in a point cloud buffer.
+float32_t read_float32(const uint8_t * const data)
+{
+  float32_t value;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+/// Split a budget over bins such that no bin gets more than its count and the bins that are
+/// limited by their count pass the rest of their share on to the others.
+void distribute_budget(
+  const std::vector<std::size_t> & counts, std::size_t budget,
+  std::vector<std::size_t> & budgets)
+{
+  std::fill(budgets.begin(), budgets.end(), 0U);
+  while (budget > 0U) {
+    std::size_t num_open{0U};
+    for (std::size_t i = 0U; i < counts.size(); ++i) {
+      if (budgets[i] < counts[i]) {
+        ++num_open;
+      }
+    }
+    if (num_open == 0U) {
+      break;
+    }
+    const auto share = std::max(budget / num_open, std::size_t{1U});
+    for (std::size_t i = 0U; (i < counts.size()) && (budget > 0U); ++i) {
+      const auto added = std::min({share, counts[i] - budgets[i], budget});
+      budgets[i] += added;
+      budget -= added;
+    }
+  }
+}
+
+uint64_t pack_voxel_coordinate(const float32_t coordinate, const float32_t inv_voxel_size)
+{
+  const auto idx = static_cast<int64_t>(std::floor(coordinate * inv_voxel_size)) +
+    kVoxelCoordinateOffset;
+  return static_cast<uint64_t>(idx) & kVoxelCoordinateMask;
+}
+
+/// Pack the voxel coordinates of a point into a single key.
+uint64_t pack_voxel_key(
+  const float32_t x, const float32_t y, const float32_t z,
+  const float32_t inv_voxel_size)
+{
+  return pack_voxel_coordinate(x, inv_voxel_size) |
+    (pack_voxel_coordinate(y, inv_voxel_size) << kVoxelCoordinateBits) |
+    (pack_voxel_coordinate(z, inv_voxel_size) << (2U * kVoxelCoordinateBits));
+}
+
+/// Find the slot of a key in an open addressing table, or the empty slot to insert it into.
+/// Fibonacci hashing followed by linear probing. The table size is a power of two.
+std::size_t find_voxel_slot(const std::vector<uint64_t> & keys, const uint64_t key)
+{
+  const auto mask = keys.size() - 1U;
+  auto slot = static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ULL) >> 32U) & mask;
+  while ((keys[slot] != kEmptyVoxelKey) && (keys[slot] != key)) {
+    slot = (slot + 1U) & mask;
+  }
+  return slot;
+}
+
+/// Size of an open addressing table that keeps the load factor at or below 0.5.
+std::size_t voxel_table_size(const std::size_t capacity)
+{
+  std::size_t table_size{1U};
+  while (table_size < (2U * capacity)) {
+    table_size *= 2U;
+  }
+  return table_size;
+}
+}  // namespace
+
+P2DNDTScan::P2DNDTScan(
+  const sensor_msgs::msg::PointCloud2 & msg,
+  const std::size_t capacity,
+  const float32_t voxel_size)
+: P2DNDTScan{capacity, voxel_size}
+{
+  insert_(msg);
+}
+
+P2DNDTScan::P2DNDTScan(const std::size_t capacity, const float32_t voxel_size)
+: m_points(static_cast<Eigen::Index>(capacity), 3),
+  m_voxel_size{voxel_size}
+{
+  if (!(m_voxel_size >= 0.0F)) {
+    throw std::domain_error("P2DNDTScan: Voxel size must not be negative.");
+  }
+  if (m_voxel_size > 0.0F) {
+    const auto table_size = voxel_table_size(capacity);
+    m_voxel_keys.resize(table_size, kEmptyVoxelKey);
+    m_voxel_indices.resize(table_size, 0U);
+    m_voxel_sums.resize(static_cast<Eigen::Index>(capacity), 3);
+    m_voxel_counts.resize(capacity, 0U);
+  }
+}
+
+void P2DNDTScan::insert_(const sensor_msgs::msg::PointCloud2 & msg)
+{
+  m_size = 0U;
+  m_stamp = ::time_utils::from_message(msg.header.stamp);
+
+  constexpr auto container_full_error = "received a lidar scan with more points than the "
+    "ndt scan representation can contain. Please re-configure the scan"
+    "representation accordingly.";
+
+  const auto num_points = std::size_t{msg.width} * std::size_t{msg.height};
+  const auto capacity = static_cast<std::size_t>(m_points.rows());
+  const auto num_used_points = (num_points + m_stride - 1U) / m_stride;
+  if ((m_voxel_size <= 0.0F) && (num_used_points > capacity)) {
+    throw std::length_error(container_full_error);
+  }
+  if (msg.data.size() < (num_points * msg.point_step)) {
+    throw std::domain_error("P2DNDTScan: Point cloud data is smaller than its dimensions.");
+  }
+  const auto x_offset = float32_field_offset(msg, "x", "P2DNDTScan");
+  const auto y_offset = float32_field_offset(msg, "y", "P2DNDTScan");
+  const auto z_offset = float32_field_offset(msg, "z", "P2DNDTScan");
+
+  if (m_voxel_size > 0.0F) {
+    std::fill(m_voxel_keys.begin(), m_voxel_keys.end(), kEmptyVoxelKey);
+  }
+  for (std::size_t i = 0U; i < num_points; i += m_stride) {
+    const auto * point_data = msg.data.data() + (i * msg.point_step);
+    const auto x = read_float32(point_data + x_offset);
+    const auto y = read_float32(point_data + y_offset);
+    const auto z = read_float32(point_data + z_offset);
+    if (!std::isfinite(x) || !std::isfinite(y) || !std::isfinite(z)) {
+      continue;
+    }
+    add_point(x, y, z);
+  }
+
+  if (m_voxel_size > 0.0F) {
+    // Replace the sums by the centroids of the voxels.
+    for (std::size_t i = 0U; i < m_size; ++i) {
+      const auto row = static_cast<Eigen::Index>(i);
+      m_points.row(row) = (m_voxel_sums.row(row) /
+        static_cast<float64_t>(m_voxel_counts[i])).cast<float32_t>();
+    }
+  }
+  if ((m_max_points > 0U) && (m_size > m_max_points)) {
+    select_points();
+  }
+}
+
+void P2DNDTScan::add_point(const float32_t x, const float32_t y, const float32_t z)
+{
+  const auto capacity = static_cast<std::size_t>(m_points.rows());
+  if (m_voxel_size <= 0.0F) {
+    const auto row = static_cast<Eigen::Index>(m_size);
+    m_points(row, 0) = x;
+    m_points(row, 1) = y;
+    m_points(row, 2) = z;
+    ++m_size;
+    return;
+  }
+
+  const auto inv_voxel_size = 1.0F / m_voxel_size;
+  const auto key = pack_voxel_key(x, y, z, inv_voxel_size);
+  const auto slot = find_voxel_slot(m_voxel_keys, key);
+
+  if (m_voxel_keys[slot] == kEmptyVoxelKey) {
+    if (m_size >= capacity) {
+      throw std::length_error(
+              "received a lidar scan occupying more voxels than the ndt scan representation can "
+              "contain. Please re-configure the scan representation accordingly.");
+    }
+    m_voxel_keys[slot] = key;
+    m_voxel_indices[slot] = static_cast<uint32_t>(m_size);
+    m_voxel_sums.row(static_cast<Eigen::Index>(m_size)).setZero();
+    m_voxel_counts[m_size] = 0U;
+    ++m_size;
+  }
+  const auto idx = m_voxel_indices[slot];
+  const auto row = static_cast<Eigen::Index>(idx);
+  m_voxel_sums(row, 0) += static_cast<float64_t>(x);
+  m_voxel_sums(row, 1) += static_cast<float64_t>(y);
+  m_voxel_sums(row, 2) += static_cast<float64_t>(z);
+  ++m_voxel_counts[idx];
+}
+
+void P2DNDTScan::set_stride(const std::size_t stride)
+{
+  if (stride == 0U) {
+    throw std::domain_error("P2DNDTScan: Stride must be positive.");
+  }
+  m_stride = stride;
+}
+
+void P2DNDTScan::set_point_budget(const std::size_t max_points, const std::size_t num_sectors)
+{
+  if (num_sectors == 0U) {
+    throw std::domain_error("P2DNDTScan: Number of sectors must be positive.");
+  }
+  m_max_points = max_points;
+  const auto capacity = static_cast<std::size_t>(m_points.rows());
+  const auto selection_capacity = (max_points > 0U) ? capacity : 0U;
+  m_selection_sectors.resize(selection_capacity);
+  m_selection_ranges.resize(selection_capacity);
+  m_selection_order.resize(selection_capacity);
+  m_selection_keep.resize(selection_capacity);
+  m_sector_counts.resize(num_sectors);
+  m_sector_budgets.resize(num_sectors);
+}
+
+void P2DNDTScan::select_points()
+{
+  using autoware::common::types::PI;
+  using autoware::common::types::TAU;
+  const auto num_sectors = m_sector_counts.size();
+  const auto sector_scale = static_cast<float32_t>(num_sectors) / TAU;
+  std::fill(m_sector_counts.begin(), m_sector_counts.end(), 0U);
+  for (std::size_t i = 0U; i < m_size; ++i) {
+    const auto row = static_cast<Eigen::Index>(i);
+    const auto azimuth = std::atan2(m_points(row, 1), m_points(row, 0)) + PI;
+    const auto sector = std::min(
+      static_cast<std::size_t>(azimuth * sector_scale), num_sectors - 1U);
+    m_selection_sectors[i] = static_cast<uint32_t>(sector);
+    m_selection_ranges[i] = m_points.row(row).squaredNorm();
+    m_selection_order[i] = static_cast<uint32_t>(i);
+    m_selection_keep[i] = 0U;
+    ++m_sector_counts[sector];
+  }
+  distribute_budget(m_sector_counts, m_max_points, m_sector_budgets);
+
+  const auto order_begin = m_selection_order.begin();
+  std::sort(
+    order_begin, order_begin + static_cast<std::ptrdiff_t>(m_size),
+    [this](const uint32_t lhs, const uint32_t rhs) {
+      return (m_selection_sectors[lhs] < m_selection_sectors[rhs]) ||
+      ((m_selection_sectors[lhs] == m_selection_sectors[rhs]) &&
+      (m_selection_ranges[lhs] < m_selection_ranges[rhs]));
+    });
+  // Take the points at evenly spaced ranks of each sector.
+  std::size_t sector_begin{0U};
+  for (std::size_t sector = 0U; sector < num_sectors; ++sector) {
+    const auto count = m_sector_counts[sector];
+    const auto budget = m_sector_budgets[sector];
+    for (std::size_t k = 0U; k < budget; ++k) {
+      const auto rank = (((2U * k) + 1U) * count) / (2U * budget);
+      m_selection_keep[m_selection_order[sector_begin + rank]] = 1U;
+    }
+    sector_begin += count;
+  }
+
+  std::size_t num_selected{0U};
+  for (std::size_t i = 0U; i < m_size; ++i) {
+    if (m_selection_keep[i] != 0U) {
+      m_points.row(static_cast<Eigen::Index>(num_selected)) =
+        m_points.row(static_cast<Eigen::Index>(i));
+      ++num_selected;
+    }
+  }
+  m_size = num_selected;
+}
+
+void P2DNDTScan::transform(
+  const Transform & transform,
+  const std::size_t begin_idx,
+  const std::size_t end_idx,
+  TransformedPoints & output) const
+{
+  const auto num_points = static_cast<Eigen::Index>(end_idx - begin_idx);
+  output.resize(num_points, 3);
+  output.noalias() =
+    m_points.middleRows(static_cast<Eigen::Index>(begin_idx), num_points).cast<float64_t>() *
+    transform.linear().transpose();
+  output.rowwise() += transform.translation().transpose();
+}
+
+D2DNDTScan::D2DNDTScan(const std::size_t capacity, const float32_t voxel_size)
+: m_voxel_size{voxel_size}
+{
+  if (!(m_voxel_size > 0.0F)) {
+    throw std::domain_error("D2DNDTScan: Voxel size must be positive.");
+  }
+  const auto table_size = voxel_table_size(capacity);
+  m_voxel_keys.resize(table_size, kEmptyVoxelKey);
+  m_voxel_indices.resize(table_size, 0U);
+  m_voxels.resize(capacity);
+  m_centroids.reserve(capacity);
+  m_covariances.reserve(capacity);
+}
+
+void D2DNDTScan::insert_(const sensor_msgs::msg::PointCloud2 & msg)
+{
+  clear_();
+  m_num_voxels = 0U;
+  m_stamp = ::time_utils::from_message(msg.header.stamp);
+
+  const auto num_points = std::size_t{msg.width} * std::size_t{msg.height};
+  if (msg.data.size() < (num_points * msg.point_step)) {
+    throw std::domain_error("D2DNDTScan: Point cloud data is smaller than its dimensions.");
+  }
+  const auto x_offset = float32_field_offset(msg, "x", "D2DNDTScan");
+  const auto y_offset = float32_field_offset(msg, "y", "D2DNDTScan");
+  const auto z_offset = float32_field_offset(msg, "z", "D2DNDTScan");
+
+  std::fill(m_voxel_keys.begin(), m_voxel_keys.end(), kEmptyVoxelKey);
+  for (std::size_t i = 0U; i < num_points; i += m_stride) {
+    const auto * point_data = msg.data.data() + (i * msg.point_step);
+    const auto x = read_float32(point_data + x_offset);
+    const auto y = read_float32(point_data + y_offset);
+    const auto z = read_float32(point_data + z_offset);
+    if (!std::isfinite(x) || !std::isfinite(y) || !std::isfinite(z)) {
+      continue;
+    }
+    add_point(x, y, z);
+  }
+
+  // Only the voxels with a well defined distribution become cells.
+  for (std::size_t i = 0U; i < m_num_voxels; ++i) {
+    auto & voxel = m_voxels[i];
+    if (voxel.usable() && voxel.try_stabilize()) {
+      m_centroids.push_back(voxel.centroid());
+      m_covariances.push_back(voxel.covariance());
+    }
+  }
+}
+
+void D2DNDTScan::add_point(const float32_t x, const float32_t y, const float32_t z)
+{
+  const auto key = pack_voxel_key(x, y, z, 1.0F / m_voxel_size);
+  const auto slot = find_voxel_slot(m_voxel_keys, key);
+  if (m_voxel_keys[slot] == kEmptyVoxelKey) {
+    if (m_num_voxels >= m_voxels.size()) {
+      throw std::length_error(
+              "received a lidar scan occupying more voxels than the ndt scan representation can "
+              "contain. Please re-configure the scan representation accordingly.");
+    }
+    m_voxel_keys[slot] = key;
+    m_voxel_indices[slot] = static_cast<uint32_t>(m_num_voxels);
+    m_voxels[m_num_voxels] = DynamicNDTVoxel{};
+    ++m_num_voxels;
+  }
+  m_voxels[m_voxel_indices[slot]].add_observation(
+    Eigen::Vector3d{static_cast<float64_t>(x), static_cast<float64_t>(y),
+      static_cast<float64_t>(z)});
+}
+
+void D2DNDTScan::set_stride(const std::size_t stride)
+{
+  if (stride == 0U) {
+    throw std::domain_error("D2DNDTScan: Stride must be positive.");
+  }
+  m_stride = stride;
+}
+
+}  // namespace ndt
+}  // namespace localization
+}  // namespace autoware
@@ -59,6 +59,25 @@ void DynamicNDTVoxel::add_observation(const Point & pt)
   m_invertible = Invertibility::UNKNOWN;
 }
 
+void DynamicNDTVoxel::limit_num_points(const uint64_t max_num_points) noexcept
+{
+  if ((max_num_points < NUM_POINT_THRESHOLD) || (m_num_points <= max_num_points)) {
+    return;
+  }
+  // covariance = M2 / (n - 1) stays the same with the reduced count
+  m_M2 *= static_cast<float64_t>(max_num_points - 1U) / static_cast<float64_t>(m_num_points - 1U);
+  m_num_points = max_num_points;
+}
+
+void DynamicNDTVoxel::set_last_observation(const TimePoint stamp) noexcept
+{
+  m_last_observation = stamp;
+}
+
+DynamicNDTVoxel::TimePoint DynamicNDTVoxel::last_observation() const noexcept
+{
+  return m_last_observation;
+}
 
 bool8_t DynamicNDTVoxel::try_stabilize()
 {
@@ -173,6 +192,31 @@ bool8_t StaticNDTVoxel::usable() const noexcept
 {
   return m_occupied;
 }
+
+/////////////////////////////////////////////////
+
+PackedNDTVoxel::PackedNDTVoxel(const Point & centroid, const Cov & inv_covariance)
+: m_centroid{{static_cast<float32_t>(centroid(0U)), static_cast<float32_t>(centroid(1U)),
+      static_cast<float32_t>(centroid(2U))}},
+  m_inv_covariance{{static_cast<float32_t>(inv_covariance(0U, 0U)),
+      static_cast<float32_t>(inv_covariance(0U, 1U)),
+      static_cast<float32_t>(inv_covariance(0U, 2U)),
+      static_cast<float32_t>(inv_covariance(1U, 1U)),
+      static_cast<float32_t>(inv_covariance(1U, 2U)),
+      static_cast<float32_t>(inv_covariance(2U, 2U))}},
+  m_occupied{true}
+{}
+
+Eigen::Matrix3d PackedNDTVoxel::covariance() const
+{
+  Eigen::Matrix3d covariance;
+  bool8_t invertible{false};
+  inverse_covariance().computeInverseWithCheck(covariance, invertible);
+  if (!invertible) {
+    throw std::out_of_range("PackedNDTVoxel: Inverse covariance is not invertible");
+  }
+  return covariance;
+}
 }  // namespace ndt
 }  // namespace localization
 }  // namespace autoware
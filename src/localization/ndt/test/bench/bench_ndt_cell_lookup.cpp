@@ -0,0 +1,148 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#include <benchmark/benchmark.h>
+#include <ndt/ndt_map.hpp>
+#include <ndt/ndt_optimization_problem.hpp>
+#include <ndt/ndt_scan.hpp>
+#include <ndt/utils.hpp>
+#include <optimization/newtons_method_optimizer.hpp>
+#include <optimization/line_search/more_thuente_line_search.hpp>
+#include <point_cloud_msg_wrapper/point_cloud_msg_wrapper.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
+
+#include <vector>
+
+namespace
+{
+using autoware::common::types::float32_t;
+using autoware::common::types::float64_t;
+using autoware::common::types::PointXYZI;
+using autoware::localization::ndt::CellLookupMode;
+using autoware::localization::ndt::DynamicNDTMap;
+using autoware::localization::ndt::EigenPose;
+using autoware::localization::ndt::EigenTransform;
+using autoware::localization::ndt::P2DNDTOptimizationConfig;
+using autoware::localization::ndt::P2DNDTOptimizationProblem;
+using autoware::localization::ndt::P2DNDTScan;
+using autoware::localization::ndt::PackedStaticNDTMap;
+using autoware::localization::ndt::Real;
+using autoware::localization::ndt::StaticNDTMap;
+using autoware::common::optimization::MoreThuenteLineSearch;
+using autoware::common::optimization::NewtonsMethodOptimizer;
+using autoware::common::optimization::OptimizationOptions;
+
+constexpr auto kGridExtent = 20.0F;
+constexpr auto kVoxelSize = 2.0F;
+constexpr auto kSampleStep = 0.2F;
+
+/// Points sampled from a floor, two walls and a slanted surface in the map frame.
+std::vector<Eigen::Vector3d> make_environment()
+{
+  std::vector<Eigen::Vector3d> points;
+  for (auto u = -15.0F; u < 15.0F; u += kSampleStep) {
+    for (auto v = 0.0F; v < 6.0F; v += kSampleStep) {
+      points.emplace_back(u, 2.5 * v - 7.5, 0.0);
+      points.emplace_back(u, 12.0, v);
+      points.emplace_back(-12.0, u, v);
+      points.emplace_back(u, -10.0 + 0.5 * v, 0.5 * v + 0.1 * u);
+    }
+  }
+  return points;
+}
+
+sensor_msgs::msg::PointCloud2 make_cloud(
+  const std::vector<Eigen::Vector3d> & points,
+  const EigenTransform<Real> & transform)
+{
+  sensor_msgs::msg::PointCloud2 msg;
+  point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI> modifier{msg, "map"};
+  for (const auto & pt : points) {
+    const Eigen::Vector3d pt_trans = transform * pt;
+    modifier.push_back(
+      {static_cast<float32_t>(pt_trans.x()), static_cast<float32_t>(pt_trans.y()),
+        static_cast<float32_t>(pt_trans.z()), 1.0F});
+  }
+  return msg;
+}
+
+/// Align a scan that is offset from the map using the given lookup mode and report the number
+/// of newton iterations along with the remaining translation error.
+/// \tparam MapT Static map type, to compare the voxel layouts.
+template<typename MapT>
+void BenchNDTAlignment(benchmark::State & state)
+{
+  const auto lookup_mode = static_cast<CellLookupMode>(state.range(0));
+  geometry_msgs::msg::Point32 min_point;
+  min_point.set__x(-kGridExtent).set__y(-kGridExtent).set__z(-kGridExtent);
+  geometry_msgs::msg::Point32 max_point;
+  max_point.set__x(kGridExtent).set__y(kGridExtent).set__z(kGridExtent);
+  geometry_msgs::msg::Point32 voxel_size;
+  voxel_size.set__x(kVoxelSize).set__y(kVoxelSize).set__z(kVoxelSize);
+  const autoware::perception::filters::voxel_grid::Config grid_config{
+    min_point, max_point, voxel_size, 100000U};
+
+  const auto environment = make_environment();
+  EigenTransform<Real> identity;
+  identity.setIdentity();
+  DynamicNDTMap dynamic_map{grid_config};
+  dynamic_map.insert(make_cloud(environment, identity));
+  sensor_msgs::msg::PointCloud2 serialized_map;
+  dynamic_map.serialize_as<MapT>(serialized_map);
+  MapT map{lookup_mode};
+  map.set(serialized_map);
+
+  // The scan is observed from the ground truth pose, which the optimizer has to recover
+  EigenPose<Real> ground_truth_pose;
+  ground_truth_pose << 0.8, -0.6, 0.1, 0.0, 0.0, 0.05;
+  EigenTransform<Real> ground_truth;
+  autoware::localization::ndt::transform_adapters::pose_to_transform(
+    ground_truth_pose, ground_truth);
+  const auto scan_msg = make_cloud(environment, ground_truth.inverse());
+  const P2DNDTScan scan{scan_msg, scan_msg.width};
+
+  using Optimizer = NewtonsMethodOptimizer<MoreThuenteLineSearch>;
+  Optimizer optimizer{
+    MoreThuenteLineSearch{0.12F, 0.0001F,
+      MoreThuenteLineSearch::OptimizationDirection::kMaximization},
+    OptimizationOptions{50U, 0.001, 0.001, 0.001}};
+
+  uint64_t iterations{0U};
+  float64_t translation_error{0.0};
+  for (auto _ : state) {
+    P2DNDTOptimizationProblem<MapT> problem{scan, map, P2DNDTOptimizationConfig{0.55}};
+    const EigenPose<Real> guess{EigenPose<Real>::Zero()};
+    EigenPose<Real> result;
+    const auto summary = optimizer.solve(problem, guess, result);
+    iterations = summary.number_of_iterations_made();
+    translation_error = (result.head(3) - ground_truth_pose.head(3)).norm();
+    benchmark::DoNotOptimize(result);
+  }
+  state.counters["iterations"] = static_cast<float64_t>(iterations);
+  state.counters["translation_error"] = translation_error;
+}
+}  // namespace
+
+BENCHMARK_TEMPLATE(BenchNDTAlignment, StaticNDTMap)
+->Arg(static_cast<int64_t>(CellLookupMode::SINGLE))
+->Arg(static_cast<int64_t>(CellLookupMode::FACE_NEIGHBOURS))
+->Arg(static_cast<int64_t>(CellLookupMode::ALL_NEIGHBOURS))
+->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BenchNDTAlignment, PackedStaticNDTMap)
+->Arg(static_cast<int64_t>(CellLookupMode::SINGLE))
+->Arg(static_cast<int64_t>(CellLookupMode::FACE_NEIGHBOURS))
+->Arg(static_cast<int64_t>(CellLookupMode::ALL_NEIGHBOURS))
+->Unit(benchmark::kMillisecond);
@@ -17,9 +17,13 @@
 #include <tf2_sensor_msgs/tf2_sensor_msgs.h>
 #include <geometry_msgs/msg/transform_stamped.hpp>
 #include <ndt/ndt_localizer.hpp>
+#include <ndt/ndt_map_pyramid.hpp>
 #include <optimization/newtons_method_optimizer.hpp>
 #include <optimization/line_search/fixed_line_search.hpp>
+#include <optimization/line_search/more_thuente_line_search.hpp>
+#include <cmath>
 #include <limits>
+#include <vector>
 #include "test_ndt_optimization.hpp"
 #include "test_ndt_utils.hpp"
 #include "common/types.hpp"
@@ -236,3 +240,176 @@ TEST_F(P2DLocalizerParameterTest, async_initial_guess) {
     localizer.register_measurement(m_downsampled_cloud, set_and_get(guess_time_early), map),
     std::domain_error);
 }
+
+TEST_F(P2DLocalizerParameterTest, multi_start) {
+  const auto map_time = std::chrono::system_clock::now();
+  const auto scan_time = map_time + std::chrono::seconds(10);
+
+  P2DTestLocalizer localizer{
+    m_localizer_config,
+    NewtonOptimizer{FixedLineSearch{m_step_size}, m_optimizer_options},
+    m_outlier_ratio};
+
+  sensor_msgs::msg::PointCloud2 serialized_map;
+  m_dynamic_map.serialize_as<autoware::localization::ndt::StaticNDTMap>(serialized_map);
+  serialized_map.header.stamp = ::time_utils::to_message(map_time);
+  autoware::localization::ndt::StaticNDTMap map{};
+  map.set(serialized_map);
+
+  // Translate the scan away from the map.
+  EigenPose<Real> diff;
+  diff << 0.0, 0.65, 0.0, 0.0, 0.0, 0.0;
+  geometry_msgs::msg::TransformStamped diff_tf2;
+  pose_to_transform(diff, diff_tf2.transform);
+  diff_tf2.header.frame_id = "custom";
+  auto translated_cloud = m_downsampled_cloud;
+  tf2::doTransform(m_downsampled_cloud, translated_cloud, diff_tf2);
+  translated_cloud.header.stamp = ::time_utils::to_message(scan_time);
+
+  // Only the last guess is close to the true pose. The first one is far outside of the map.
+  std::vector<P2DTestLocalizer::Transform> guesses(3U);
+  for (auto & guess : guesses) {
+    guess.header.stamp = ::time_utils::to_message(scan_time);
+    guess.transform.rotation.w = 1.0;
+  }
+  guesses[0U].transform.translation.x = 100.0;
+  guesses[1U].transform.translation.y = -3.0 * static_cast<float64_t>(m_voxel_size.y);
+
+  P2DTestLocalizer::Summary summary{};
+  std::size_t best_index{0U};
+  // Disable the early stop so the result doesn't depend on the scheduling of the hypotheses.
+  const autoware::localization::ndt::NDTMultiStartConfig multi_start_config{
+    3U, std::numeric_limits<Real>::max()};
+  const auto ros_pose_out = localizer.register_measurement(
+    translated_cloud, guesses, map, multi_start_config, &summary, &best_index);
+
+  EXPECT_EQ(best_index, 2U);
+  EXPECT_NE(
+    summary.optimization_summary().termination_type(),
+    autoware::common::optimization::TerminationType::FAILURE);
+  EXPECT_EQ(ros_pose_out.header.frame_id, map.frame_id());
+
+  // The result is the same as registering the best guess alone.
+  const auto single_pose_out =
+    localizer.register_measurement(translated_cloud, guesses[2U], map);
+  EXPECT_EQ(single_pose_out.pose.pose.position.x, ros_pose_out.pose.pose.position.x);
+  EXPECT_EQ(single_pose_out.pose.pose.position.y, ros_pose_out.pose.pose.position.y);
+  EXPECT_EQ(single_pose_out.pose.pose.position.z, ros_pose_out.pose.pose.position.z);
+
+  EXPECT_THROW(
+    localizer.register_measurement(
+      translated_cloud, std::vector<P2DTestLocalizer::Transform>{}, map, multi_start_config),
+    std::domain_error);
+  guesses[1U].header.stamp = ::time_utils::to_message(scan_time + std::chrono::seconds(1));
+  EXPECT_THROW(
+    localizer.register_measurement(translated_cloud, guesses, map, multi_start_config),
+    std::domain_error);
+}
+
+TEST_F(P2DLocalizerParameterTest, time_budget) {
+  const auto map_time = std::chrono::system_clock::now();
+  const auto scan_time = map_time + std::chrono::seconds(10);
+
+  sensor_msgs::msg::PointCloud2 serialized_map;
+  m_dynamic_map.serialize_as<autoware::localization::ndt::StaticNDTMap>(serialized_map);
+  serialized_map.header.stamp = ::time_utils::to_message(map_time);
+  autoware::localization::ndt::StaticNDTMap map{};
+  map.set(serialized_map);
+
+  m_downsampled_cloud.header.stamp = ::time_utils::to_message(scan_time);
+  P2DTestLocalizer::Transform transform_initial{};
+  transform_initial.header.stamp = ::time_utils::to_message(scan_time);
+  transform_initial.transform.rotation.w = 1.0;
+
+  // Every registration runs out of time, so the scan is subsampled up to the maximum stride.
+  const P2DNDTLocalizerConfig localizer_config{
+    m_downsampled_cloud.width, m_guess_time_tol, 0.0F, 4U};
+  P2DTestLocalizer localizer{
+    localizer_config,
+    NewtonOptimizer{FixedLineSearch{m_step_size},
+      OptimizerOptions{5U, 0.0002, 0.0002, 1e-4, std::chrono::nanoseconds{1}}},
+    m_outlier_ratio};
+  for (const std::size_t expected_stride : {1U, 2U, 4U, 4U}) {
+    P2DTestLocalizer::Summary summary{};
+    const auto pose_out = localizer.register_measurement(
+      m_downsampled_cloud, transform_initial, map, &summary);
+    EXPECT_EQ(
+      summary.optimization_summary().termination_type(),
+      autoware::common::optimization::TerminationType::TIME_BUDGET_EXCEEDED);
+    EXPECT_TRUE(summary.degraded());
+    EXPECT_EQ(summary.scan_stride(), expected_stride);
+    EXPECT_EQ(localizer.scan().size(), (m_downsampled_cloud.width - 1U) / expected_stride + 1U);
+    // The best pose so far is the initial guess since no iteration fit into the budget.
+    EXPECT_EQ(pose_out.pose.pose.position.x, 0.0);
+    EXPECT_EQ(pose_out.pose.pose.orientation.w, 1.0);
+  }
+
+  // Without a time budget the scan isn't subsampled.
+  P2DTestLocalizer unlimited_localizer{
+    localizer_config,
+    NewtonOptimizer{FixedLineSearch{m_step_size}, m_optimizer_options},
+    m_outlier_ratio};
+  P2DTestLocalizer::Summary summary{};
+  unlimited_localizer.register_measurement(m_downsampled_cloud, transform_initial, map, &summary);
+  EXPECT_FALSE(summary.degraded());
+  EXPECT_EQ(summary.scan_stride(), 1U);
+  EXPECT_EQ(unlimited_localizer.scan_stride(), 1U);
+}
+
+TEST_F(P2DLocalizerParameterTest, coarse_to_fine) {
+  using autoware::common::optimization::MoreThuenteLineSearch;
+  using MoreThuenteNewtonOptimizer =
+    autoware::common::optimization::NewtonsMethodOptimizer<MoreThuenteLineSearch>;
+  const auto map_time = std::chrono::system_clock::now();
+  const auto scan_time = map_time + std::chrono::seconds(10);
+
+  sensor_msgs::msg::PointCloud2 serialized_map;
+  m_dynamic_map.serialize_as<autoware::localization::ndt::StaticNDTMap>(serialized_map);
+  serialized_map.header.stamp = ::time_utils::to_message(map_time);
+  autoware::localization::ndt::StaticNDTMap map{};
+  map.set(serialized_map);
+  autoware::localization::ndt::NDTMapPyramid pyramid{3U};
+  pyramid.set(serialized_map);
+
+  // The scan is translated by more than a voxel. The voxels of the map form a lattice, so a
+  // registration on the finest level alone locks onto the wrong row of voxels.
+  EigenPose<Real> diff;
+  diff << 0.0, 1.2, 0.0, 0.0, 0.0, 0.0;
+  geometry_msgs::msg::TransformStamped diff_tf2;
+  pose_to_transform(diff, diff_tf2.transform);
+  diff_tf2.header.frame_id = "custom";
+  auto translated_cloud = m_downsampled_cloud;
+  tf2::doTransform(m_downsampled_cloud, translated_cloud, diff_tf2);
+  translated_cloud.header.stamp = ::time_utils::to_message(scan_time);
+
+  P2DTestLocalizer::Transform transform_initial{};
+  transform_initial.header.stamp = ::time_utils::to_message(scan_time);
+  transform_initial.transform.rotation.w = 1.0;
+
+  P2DNDTLocalizer<MoreThuenteNewtonOptimizer> localizer{
+    m_localizer_config,
+    MoreThuenteNewtonOptimizer{
+      MoreThuenteLineSearch{0.5F, 1e-4F,
+        MoreThuenteLineSearch::OptimizationDirection::kMaximization},
+      m_optimizer_options},
+    m_outlier_ratio};
+
+  EigenPose<Real> pose_out;
+  const auto single_pose_out =
+    localizer.register_measurement(translated_cloud, transform_initial, map);
+  transform_to_pose(single_pose_out.pose.pose, pose_out);
+  EXPECT_GT(std::abs(pose_out(1) + diff(1)), 0.5);
+
+  P2DTestLocalizer::Summary summary{};
+  const auto ros_pose_out =
+    localizer.register_measurement(translated_cloud, transform_initial, pyramid, &summary);
+  transform_to_pose(ros_pose_out.pose.pose, pose_out);
+  EigenPose<Real> neg_diff = -diff;
+  is_pose_approx(pose_out, neg_diff, 1e-2, 1e-2);
+  EXPECT_LT((pose_out.head(3) + diff.head(3)).norm(), 1e-2);
+  EXPECT_EQ(ros_pose_out.header.frame_id, map.frame_id());
+  EXPECT_NE(
+    summary.optimization_summary().termination_type(),
+    autoware::common::optimization::TerminationType::FAILURE);
+  EXPECT_GT(summary.optimization_summary().number_of_iterations_made(), 0U);
+}
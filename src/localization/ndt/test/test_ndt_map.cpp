@@ -15,9 +15,19 @@
 // Co-developed by Tier IV, Inc. and Apex.AI, Inc.
 
 #include <gtest/gtest.h>
+#include <ndt/ndt_map_binary.hpp>
+#include <ndt/ndt_map_pyramid.hpp>
+#include <ndt/ndt_map_tiles.hpp>
 #include <ndt/utils.hpp>
 #include <Eigen/LU>
 #include <point_cloud_msg_wrapper/point_cloud_msg_wrapper.hpp>
+#include <thread_pool/thread_pool.hpp>
+#include <unistd.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <random>
 #include <vector>
 #include <limits>
 #include <string>
@@ -30,9 +40,15 @@ using autoware::common::types::float64_t;
 
 using autoware::localization::ndt::DynamicNDTVoxel;
 using autoware::localization::ndt::StaticNDTVoxel;
+using autoware::localization::ndt::PackedNDTVoxel;
 using autoware::localization::ndt::Real;
 using autoware::localization::ndt::try_stabilize_covariance;
 using autoware::localization::ndt::StaticNDTMap;
+using autoware::localization::ndt::PackedStaticNDTMap;
+using autoware::localization::ndt::CellLookupMode;
+using autoware::localization::ndt::NDTMapBinaryFile;
+using autoware::localization::ndt::NDTMapTileLoader;
+using autoware::localization::ndt::NDTMapPyramid;
 using autoware::perception::filters::voxel_grid::Config;
 constexpr std::uint32_t DenseNDTMapContext::NUM_POINTS;
 
@@ -117,6 +133,34 @@ TEST(DynamicNDTVoxelTest, ndt_dense_voxel_basic) {
   );
 }
 
+TEST(DynamicNDTVoxelTest, ndt_dense_voxel_limit_num_points) {
+  constexpr auto eps = 1e-6;
+  DynamicNDTVoxel voxel;
+  for (auto i = 0U; i < 5U; i++) {
+    const auto coord = static_cast<float64_t>(i);
+    voxel.add_observation(Eigen::Vector3d{coord, coord, coord});
+  }
+  const Eigen::Vector3d centroid = voxel.centroid();
+  const Eigen::Matrix3d covariance = voxel.covariance();
+
+  // Limits below the point threshold or above the count are ignored
+  voxel.limit_num_points(DynamicNDTVoxel::NUM_POINT_THRESHOLD - 1U);
+  voxel.limit_num_points(10U);
+  EXPECT_EQ(voxel.count(), 5U);
+
+  // Reducing the count keeps the statistics
+  voxel.limit_num_points(DynamicNDTVoxel::NUM_POINT_THRESHOLD);
+  EXPECT_EQ(voxel.count(), DynamicNDTVoxel::NUM_POINT_THRESHOLD);
+  EXPECT_TRUE(voxel.centroid().isApprox(centroid, eps));
+  EXPECT_TRUE(voxel.covariance().isApprox(covariance, eps));
+
+  // but a new point weighs more than in the unbounded voxel
+  voxel.add_observation(Eigen::Vector3d{10.0, 10.0, 10.0});
+  const auto expected_centroid = 2.0 + (10.0 - 2.0) /
+    static_cast<float64_t>(DynamicNDTVoxel::NUM_POINT_THRESHOLD + 1U);
+  EXPECT_NEAR(voxel.centroid()(0U), expected_centroid, eps);
+}
+
 
 TEST_F(DenseNDTMapTest, map_lookup) {
   constexpr auto eps = 1e-5;
@@ -183,6 +227,47 @@ TEST_F(DenseNDTMapTest, map_lookup) {
   }
 }
 
+TEST_F(DenseNDTMapTest, multi_cell_lookup) {
+  auto grid_config = Config(m_min_point, m_max_point, m_voxel_size, m_capacity);
+  build_pc(grid_config);
+
+  DynamicNDTMap single_map(grid_config, CellLookupMode::SINGLE);
+  DynamicNDTMap face_map(grid_config, CellLookupMode::FACE_NEIGHBOURS);
+  DynamicNDTMap all_map(grid_config, CellLookupMode::ALL_NEIGHBOURS);
+  single_map.insert(m_pc);
+  face_map.insert(m_pc);
+  all_map.insert(m_pc);
+
+  // Center of the 5x5x5 grid has all of its neighbours
+  EXPECT_EQ(single_map.cell(3.0F, 3.0F, 3.0F).size(), 1U);
+  EXPECT_EQ(face_map.cell(3.0F, 3.0F, 3.0F).size(), 7U);
+  EXPECT_EQ(all_map.cell(3.0F, 3.0F, 3.0F).size(), 27U);
+  // Corners only have neighbours on one side in each direction
+  EXPECT_EQ(face_map.cell(1.0F, 1.0F, 1.0F).size(), 4U);
+  EXPECT_EQ(all_map.cell(1.0F, 1.0F, 1.0F).size(), 8U);
+  EXPECT_EQ(face_map.cell(5.0F, 5.0F, 5.0F).size(), 4U);
+  EXPECT_EQ(all_map.cell(5.0F, 5.0F, 5.0F).size(), 8U);
+  // Cells on a face of the grid must not wrap around to the opposite face
+  EXPECT_EQ(face_map.cell(1.0F, 3.0F, 3.0F).size(), 6U);
+  EXPECT_EQ(all_map.cell(3.0F, 5.0F, 3.0F).size(), 18U);
+
+  for (auto x = 1; x <= POINTS_PER_DIM; x++) {
+    for (auto y = 1; y <= POINTS_PER_DIM; y++) {
+      for (auto z = 1; z <= POINTS_PER_DIM; z++) {
+        const Eigen::Vector3d pt(x, y, z);
+        const auto expected_idx = grid_config.index(pt);
+        // The cell containing the point comes first
+        EXPECT_EQ(grid_config.index(face_map.cell(pt)[0].centroid()), expected_idx);
+        EXPECT_EQ(grid_config.index(all_map.cell(pt)[0].centroid()), expected_idx);
+        // All returned cells are at most one cell away in each direction
+        for (const auto & cell : all_map.cell(pt)) {
+          EXPECT_LE((cell.centroid() - pt).lpNorm<Eigen::Infinity>(), 1.0 + 1e-5);
+        }
+      }
+    }
+  }
+}
+
 ///////////////////////////////////////
 
 TEST(StaticNDTVoxelTest, ndt_map_voxel_basics) {
@@ -239,6 +324,32 @@ TEST(StaticNDTVoxelTest, ndt_map_voxel_inverse_covariance_basic) {
   EXPECT_TRUE(voxel.usable());
 }
 
+TEST(PackedNDTVoxelTest, ndt_map_voxel_basics) {
+  EXPECT_LE(sizeof(PackedNDTVoxel), sizeof(StaticNDTVoxel) / 2U);
+  PackedNDTVoxel vx;
+  // default constructor doesn't set the voxel as occupied
+  EXPECT_FALSE(vx.usable());
+  EXPECT_THROW(vx.centroid(), std::out_of_range);
+  EXPECT_THROW(vx.inverse_covariance(), std::out_of_range);
+  EXPECT_THROW(vx.covariance(), std::out_of_range);
+
+  const Eigen::Vector3d pt{5.1, -3.3, 1.7};
+  Eigen::Matrix3d icov;
+  icov <<
+    7.0, 0.5, -0.25,
+    0.5, 17.0, 0.1,
+    -0.25, 0.1, 3.0;
+  const PackedNDTVoxel vx2{pt, icov};
+  const StaticNDTVoxel static_vx{pt, icov};
+  constexpr auto eps = std::numeric_limits<float32_t>::epsilon();
+  EXPECT_TRUE(vx2.usable());
+  EXPECT_TRUE(vx2.centroid().isApprox(pt, eps));
+  EXPECT_TRUE(vx2.inverse_covariance().isApprox(icov, eps));
+  // The lower triangle is restored from the upper one
+  EXPECT_EQ(vx2.inverse_covariance(), vx2.inverse_covariance().transpose());
+  EXPECT_TRUE(vx2.covariance().isApprox(static_vx.covariance(), 10.0 * eps));
+}
+
 TEST_F(NDTMapTest, map_representation_bad_input) {
   sensor_msgs::msg::PointCloud2 invalid_pc1;
   sensor_msgs::msg::PointCloud2 invalid_pc2;
@@ -336,6 +447,371 @@ TEST_F(NDTMapTest, map_representation_basics) {
 }
 
 
+TEST_F(DenseNDTMapTest, binary_map_round_trip) {
+  const std::string file_name{"/tmp/ndt_test_binary_map.bin"};
+  auto grid_config = Config(m_min_point, m_max_point, m_voxel_size, m_capacity);
+  build_pc(grid_config);
+  DynamicNDTMap dense_map(grid_config);
+  dense_map.insert(m_pc);
+
+  ASSERT_NO_THROW(autoware::localization::ndt::write_ndt_map_binary(dense_map, file_name));
+  const NDTMapBinaryFile binary_map{file_name};
+  EXPECT_EQ(binary_map.size(), dense_map.size());
+  EXPECT_EQ(binary_map.frame_id(), dense_map.frame_id());
+
+  // Setting the binary map directly and through its point cloud serialization must result in
+  // the same map as the regular serialization path.
+  sensor_msgs::msg::PointCloud2 expected_msg;
+  sensor_msgs::msg::PointCloud2 binary_msg;
+  dense_map.serialize_as<StaticNDTMap>(expected_msg);
+  autoware::localization::ndt::serialize_from_binary(binary_map, binary_msg);
+  EXPECT_EQ(binary_msg.header.frame_id, expected_msg.header.frame_id);
+  EXPECT_EQ(binary_msg.header.stamp, expected_msg.header.stamp);
+  EXPECT_EQ(binary_msg.width, expected_msg.width);
+
+  StaticNDTMap expected_map{};
+  StaticNDTMap msg_map{};
+  StaticNDTMap binary_static_map{};
+  expected_map.set(expected_msg);
+  msg_map.set(binary_msg);
+  binary_static_map.set(binary_map);
+  ASSERT_EQ(binary_static_map.size(), expected_map.size());
+  ASSERT_EQ(msg_map.size(), expected_map.size());
+  EXPECT_EQ(binary_static_map.frame_id(), expected_map.frame_id());
+  EXPECT_EQ(binary_static_map.stamp(), expected_map.stamp());
+  for (const auto & vx_it : expected_map) {
+    const auto & centroid = vx_it.second.centroid();
+    for (const auto * map : {&msg_map, &binary_static_map}) {
+      const auto & cells = map->cell(centroid);
+      ASSERT_EQ(cells.size(), 1U);
+      EXPECT_TRUE(cells[0U].centroid().isApprox(centroid));
+      EXPECT_TRUE(
+        cells[0U].inverse_covariance().isApprox(vx_it.second.inverse_covariance()));
+    }
+  }
+
+  // The packed map holds the same voxels in single precision.
+  PackedStaticNDTMap packed_map{};
+  packed_map.set(binary_map);
+  ASSERT_EQ(packed_map.size(), expected_map.size());
+  for (const auto & vx_it : expected_map) {
+    const auto & centroid = vx_it.second.centroid();
+    const auto & cells = packed_map.cell(centroid);
+    ASSERT_EQ(cells.size(), 1U);
+    constexpr auto eps = std::numeric_limits<float32_t>::epsilon();
+    EXPECT_TRUE(cells[0U].centroid().isApprox(centroid, eps));
+    EXPECT_TRUE(cells[0U].inverse_covariance().isApprox(vx_it.second.inverse_covariance(), eps));
+  }
+  // Setting an identical message keeps all voxels
+  packed_map.set(expected_msg);
+  EXPECT_EQ(packed_map.size(), expected_map.size());
+
+  // A truncated file is rejected. The header is copied first since the file is still mapped.
+  const auto header = binary_map.header();
+  {
+    std::ofstream truncated{file_name, std::ios::binary | std::ios::trunc};
+    truncated.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  }
+  EXPECT_THROW(NDTMapBinaryFile{file_name}, std::runtime_error);
+  EXPECT_THROW(NDTMapBinaryFile{"/tmp/ndt_test_missing_binary_map.bin"}, std::runtime_error);
+  (void) std::remove(file_name.c_str());
+}
+
+TEST_F(DenseNDTMapTest, incremental_map_update) {
+  using autoware::localization::ndt::NdtMapCloudModifier;
+  using autoware::localization::ndt::NdtMapCloudView;
+  using autoware::localization::ndt::PointWithCovariances;
+  auto grid_config = Config(m_min_point, m_max_point, m_voxel_size, m_capacity);
+  build_pc(grid_config);
+  DynamicNDTMap dense_map(grid_config);
+  dense_map.insert(m_pc);
+  sensor_msgs::msg::PointCloud2 full_msg;
+  dense_map.serialize_as<StaticNDTMap>(full_msg);
+
+  // The updated map drops the voxels at x = 5 and changes the voxel at (1, 1, 1).
+  sensor_msgs::msg::PointCloud2 updated_msg;
+  {
+    NdtMapCloudModifier modifier{updated_msg, full_msg.header.frame_id};
+    updated_msg.header.stamp = full_msg.header.stamp;
+    updated_msg.header.stamp.sec += 1;
+    NdtMapCloudView view{full_msg};
+    for (auto i = 0U; i < view.size(); ++i) {
+      auto pt = view[i];
+      if ((i >= DynamicNDTMap::kNumConfigPoints) && (pt.x > 4.5)) {
+        continue;
+      }
+      if ((std::fabs(pt.x - 1.0) < 0.1) && (std::fabs(pt.y - 1.0) < 0.1) &&
+        (std::fabs(pt.z - 1.0) < 0.1))
+      {
+        pt.icov_xx *= 2.0;
+      }
+      modifier.push_back(pt);
+    }
+  }
+
+  StaticNDTMap map{};
+  map.set(full_msg);
+  ASSERT_EQ(map.size(), 125U);
+  const auto * const unchanged_voxel = &map.cell(3.0F, 3.0F, 3.0F)[0U].get();
+  const auto old_icov_xx = map.cell(1.0F, 1.0F, 1.0F)[0U].inverse_covariance()(0U, 0U);
+  const auto old_stamp = map.stamp();
+
+  map.set(updated_msg);
+  EXPECT_EQ(map.size(), 100U);
+  EXPECT_GT(map.stamp(), old_stamp);
+  // Identical voxels are not rebuilt.
+  EXPECT_EQ(&map.cell(3.0F, 3.0F, 3.0F)[0U].get(), unchanged_voxel);
+  EXPECT_DOUBLE_EQ(
+    map.cell(1.0F, 1.0F, 1.0F)[0U].inverse_covariance()(0U, 0U), 2.0 * old_icov_xx);
+  EXPECT_TRUE(map.cell(5.0F, 3.0F, 3.0F).empty());
+
+  // Removed voxels are added back.
+  map.set(full_msg);
+  EXPECT_EQ(map.size(), 125U);
+  EXPECT_EQ(map.cell(5.0F, 3.0F, 3.0F).size(), 1U);
+  EXPECT_EQ(&map.cell(3.0F, 3.0F, 3.0F)[0U].get(), unchanged_voxel);
+  EXPECT_DOUBLE_EQ(map.cell(1.0F, 1.0F, 1.0F)[0U].inverse_covariance()(0U, 0U), old_icov_xx);
+}
+
+TEST_F(DenseNDTMapTest, stale_voxel_removal) {
+  using PointXYZI = autoware::common::types::PointXYZI;
+  auto grid_config = Config(m_min_point, m_max_point, m_voxel_size, m_capacity);
+  build_pc(grid_config);
+  DynamicNDTMap::Forgetting forgetting;
+  forgetting.max_voxel_age = std::chrono::seconds{1};
+  forgetting.num_buckets_swept_per_insert = 0U;
+  DynamicNDTMap dense_map(grid_config, CellLookupMode::SINGLE, forgetting);
+  dense_map.insert(m_pc);
+  ASSERT_EQ(dense_map.size(), 125U);
+
+  // Observe all the voxels except the ones at x = 5 again, two seconds later
+  sensor_msgs::msg::PointCloud2 update_msg;
+  {
+    point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI> modifier{
+      update_msg, m_pc.header.frame_id};
+    point_cloud_msg_wrapper::PointCloud2View<PointXYZI> view{m_pc};
+    for (const auto & pt : view) {
+      if (pt.x < 4.5F) {
+        modifier.push_back(pt);
+      }
+    }
+  }
+  update_msg.header.stamp = m_pc.header.stamp;
+  update_msg.header.stamp.sec += 2;
+  dense_map.insert(update_msg);
+  // No bucket is swept during the insertion
+  EXPECT_EQ(dense_map.size(), 125U);
+
+  EXPECT_EQ(dense_map.remove_stale_voxels(), 25U);
+  EXPECT_EQ(dense_map.size(), 100U);
+  EXPECT_TRUE(dense_map.cell(5.0F, 3.0F, 3.0F).empty());
+  EXPECT_EQ(dense_map.cell(3.0F, 3.0F, 3.0F).size(), 1U);
+  EXPECT_EQ(dense_map.remove_stale_voxels(), 0U);
+}
+
+TEST_F(DenseNDTMapTest, map_pyramid) {
+  auto grid_config = Config(m_min_point, m_max_point, m_voxel_size, m_capacity);
+  build_pc(grid_config);
+  DynamicNDTMap dense_map(grid_config);
+  dense_map.insert(m_pc);
+  sensor_msgs::msg::PointCloud2 map_msg;
+  dense_map.serialize_as<StaticNDTMap>(map_msg);
+
+  EXPECT_THROW(NDTMapPyramid{0U}, std::domain_error);
+  EXPECT_THROW(NDTMapPyramid(2U, 1U), std::domain_error);
+  StaticNDTMap unset_map{};
+  StaticNDTMap coarse_map{};
+  EXPECT_THROW(coarse_map.set_coarsened(unset_map, 2U), std::runtime_error);
+  EXPECT_THROW(coarse_map.set_coarsened(coarse_map, 2U), std::domain_error);
+
+  NDTMapPyramid pyramid{3U};
+  EXPECT_FALSE(pyramid.valid());
+  pyramid.set(map_msg);
+  ASSERT_TRUE(pyramid.valid());
+  ASSERT_EQ(pyramid.num_levels(), 3U);
+  EXPECT_THROW(pyramid.level(3U), std::out_of_range);
+  const auto & fine_map = pyramid.level(0U);
+  EXPECT_EQ(fine_map.size(), dense_map.size());
+  EXPECT_THROW(coarse_map.set_coarsened(fine_map, 0U), std::domain_error);
+
+  // The 5x5x5 voxels of 1m fall into 3x3x3 voxels of 2m and 2x2x2 voxels of 4m.
+  EXPECT_EQ(pyramid.level(1U).size(), 27U);
+  EXPECT_EQ(pyramid.level(2U).size(), 8U);
+  for (auto i = 1U; i < pyramid.num_levels(); ++i) {
+    const auto & level = pyramid.level(i);
+    EXPECT_FLOAT_EQ(level.cell_size().x, static_cast<float32_t>(1U << i));
+    EXPECT_EQ(level.frame_id(), pyramid.frame_id());
+    EXPECT_EQ(level.stamp(), pyramid.stamp());
+  }
+
+  // The voxel of 2m at the origin merges the 8 voxels with coordinates 1 and 2. Its covariance
+  // also contains the spread of their centroids.
+  Eigen::Vector3d expected_centroid{Eigen::Vector3d::Zero()};
+  Eigen::Matrix3d second_moment{Eigen::Matrix3d::Zero()};
+  for (auto x = 1; x <= 2; ++x) {
+    for (auto y = 1; y <= 2; ++y) {
+      for (auto z = 1; z <= 2; ++z) {
+        const auto & fine_cells = fine_map.cell(
+          static_cast<float32_t>(x), static_cast<float32_t>(y), static_cast<float32_t>(z));
+        ASSERT_EQ(fine_cells.size(), 1U);
+        const Eigen::Vector3d centroid = fine_cells[0U].centroid();
+        expected_centroid += centroid / 8.0;
+        second_moment +=
+          (fine_cells[0U].get().covariance() + (centroid * centroid.transpose())) / 8.0;
+      }
+    }
+  }
+  const Eigen::Matrix3d expected_covariance =
+    second_moment - (expected_centroid * expected_centroid.transpose());
+  const auto & coarse_cells = pyramid.level(1U).cell(1.5F, 1.5F, 1.5F);
+  ASSERT_EQ(coarse_cells.size(), 1U);
+  EXPECT_TRUE(coarse_cells[0U].centroid().isApprox(expected_centroid));
+  EXPECT_TRUE(coarse_cells[0U].get().covariance().isApprox(expected_covariance, 1e-6));
+  EXPECT_GT(coarse_cells[0U].get().covariance()(0U, 0U), 0.25);
+
+  // A voxel of 2m with a single voxel of 1m keeps it.
+  const auto & corner_cells = pyramid.level(1U).cell(5.0F, 5.0F, 5.0F);
+  const auto & fine_corner_cells = fine_map.cell(5.0F, 5.0F, 5.0F);
+  ASSERT_EQ(corner_cells.size(), 1U);
+  ASSERT_EQ(fine_corner_cells.size(), 1U);
+  EXPECT_TRUE(corner_cells[0U].centroid().isApprox(fine_corner_cells[0U].centroid()));
+  EXPECT_TRUE(
+    corner_cells[0U].inverse_covariance().isApprox(
+      fine_corner_cells[0U].inverse_covariance(), 1e-6));
+}
+
+TEST(DynamicNDTMapTest, parallel_insert) {
+  using PointXYZI = autoware::common::types::PointXYZI;
+  using autoware::common::thread_pool::ThreadPool;
+  using autoware::common::thread_pool::ThreadPoolConfig;
+  PointXYZ min_point;
+  min_point.set__x(-10.0F).set__y(-10.0F).set__z(-10.0F);
+  PointXYZ max_point;
+  max_point.set__x(10.0F).set__y(10.0F).set__z(10.0F);
+  PointXYZ voxel_size;
+  voxel_size.set__x(1.0F).set__y(1.0F).set__z(1.0F);
+  const Config grid_config{min_point, max_point, voxel_size, 10000U};
+
+  // Enough points for several chunks, with about 25 points per voxel
+  std::mt19937 gen{42U};
+  std::uniform_real_distribution<float32_t> dist{-9.9F, 9.9F};
+  std::vector<sensor_msgs::msg::PointCloud2> msgs(2U);
+  for (auto & msg : msgs) {
+    point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI> modifier{msg, "map"};
+    for (std::size_t i = 0U; i < 100000U; ++i) {
+      modifier.push_back(PointXYZI{dist(gen), dist(gen), dist(gen), 1.0F});
+    }
+  }
+  msgs[1U].header.stamp.sec = 1;
+
+  ThreadPoolConfig pool_config;
+  pool_config.num_threads = 3U;
+  ThreadPool pool{pool_config};
+  for (const uint64_t max_points_per_voxel : {0U, 20U}) {
+    DynamicNDTMap::Forgetting forgetting;
+    forgetting.max_points_per_voxel = max_points_per_voxel;
+    DynamicNDTMap serial_map{grid_config, CellLookupMode::SINGLE, forgetting};
+    DynamicNDTMap parallel_map{grid_config, CellLookupMode::SINGLE, forgetting};
+    // The second message is added to the voxels of the first one
+    for (const auto & msg : msgs) {
+      serial_map.insert(msg);
+      parallel_map.insert(msg, pool);
+    }
+    EXPECT_EQ(parallel_map.stamp(), serial_map.stamp());
+    EXPECT_EQ(parallel_map.frame_id(), serial_map.frame_id());
+    ASSERT_EQ(parallel_map.size(), serial_map.size());
+    // The voxels are identical and even in the same order
+    auto parallel_it = parallel_map.begin();
+    for (const auto & vx_it : serial_map) {
+      EXPECT_EQ(parallel_it->first, vx_it.first);
+      const auto & vx = parallel_it->second;
+      EXPECT_EQ(vx.count(), vx_it.second.count());
+      EXPECT_EQ(vx.last_observation(), vx_it.second.last_observation());
+      if (vx.usable()) {
+        EXPECT_EQ(vx.centroid(), vx_it.second.centroid());
+        EXPECT_EQ(vx.covariance(), vx_it.second.covariance());
+      }
+      ++parallel_it;
+    }
+    sensor_msgs::msg::PointCloud2 serial_msg;
+    sensor_msgs::msg::PointCloud2 parallel_msg;
+    serial_map.serialize_as<StaticNDTMap>(serial_msg);
+    parallel_map.serialize_as<StaticNDTMap>(parallel_msg);
+    EXPECT_EQ(parallel_msg.data, serial_msg.data);
+  }
+
+  // An empty message doesn't change the map
+  DynamicNDTMap map{grid_config};
+  map.insert(msgs[0U], pool);
+  const auto size = map.size();
+  sensor_msgs::msg::PointCloud2 empty_msg;
+  point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI> modifier{empty_msg, "map"};
+  map.insert(empty_msg, pool);
+  EXPECT_EQ(map.size(), size);
+}
+
+TEST_F(DenseNDTMapTest, tiled_map_streaming) {
+  const std::string directory{"/tmp/ndt_test_map_tiles"};
+  auto grid_config = Config(m_min_point, m_max_point, m_voxel_size, m_capacity);
+  build_pc(grid_config);
+  DynamicNDTMap dense_map(grid_config);
+  dense_map.insert(m_pc);
+
+  // Centroids range from 1 to 5, which results in 3x3 tiles of size 2.
+  constexpr auto tile_size = 2.0;
+  ASSERT_EQ(autoware::localization::ndt::write_ndt_map_tiles(dense_map, tile_size, directory), 9U);
+  EXPECT_EQ(autoware::localization::ndt::read_tile_size(directory), tile_size);
+  EXPECT_THROW(NDTMapTileLoader(directory, 0.0), std::domain_error);
+  EXPECT_THROW(NDTMapTileLoader("/tmp/ndt_test_missing_tiles", 1.0), std::runtime_error);
+
+  StaticNDTMap map{};
+  {
+    NDTMapTileLoader loader{directory, 0.5};
+    EXPECT_FALSE(loader.apply_updates(map));
+
+    // Only the tile containing the position is within the radius.
+    loader.set_position(1.0, 1.0);
+    loader.wait_until_idle();
+    EXPECT_EQ(loader.num_loaded_tiles(), 1U);
+    EXPECT_TRUE(loader.apply_updates(map));
+    EXPECT_TRUE(map.valid());
+    EXPECT_EQ(map.size(), 5U);
+    EXPECT_EQ(map.cell(1.0F, 1.0F, 3.0F).size(), 1U);
+
+    // Moving to the opposite corner loads the tile there and evicts the first one.
+    loader.set_position(5.0, 5.0);
+    loader.wait_until_idle();
+    EXPECT_EQ(loader.num_loaded_tiles(), 1U);
+    EXPECT_TRUE(loader.apply_updates(map));
+    EXPECT_EQ(map.size(), 20U);
+    EXPECT_TRUE(map.cell(1.0F, 1.0F, 3.0F).empty());
+
+    // The center tile is loaded while the previous tile is still within the eviction distance.
+    loader.set_position(3.0, 3.0);
+    loader.wait_until_idle();
+    EXPECT_EQ(loader.num_loaded_tiles(), 2U);
+    EXPECT_TRUE(loader.apply_updates(map));
+    EXPECT_EQ(map.size(), 40U);
+    EXPECT_FALSE(loader.apply_updates(map));
+  }
+
+  // The streamed voxels are identical to the ones of the full map.
+  for (const auto & vx_it : map) {
+    const auto & cells = dense_map.cell(vx_it.second.centroid());
+    ASSERT_EQ(cells.size(), 1U);
+    EXPECT_TRUE(cells[0U].inverse_covariance().isApprox(vx_it.second.inverse_covariance()));
+  }
+
+  for (auto x = 0; x < 3; ++x) {
+    for (auto y = 0; y < 3; ++y) {
+      (void) std::remove(
+        autoware::localization::ndt::tile_file_name(directory, {x, y}).c_str());
+    }
+  }
+  (void) std::remove((directory + "/tiles.yaml").c_str());
+  (void) ::rmdir(directory.c_str());
+}
+
 ///////////////////////////// Function definitions:
 
 sensor_msgs::msg::PointCloud2 make_pcl(
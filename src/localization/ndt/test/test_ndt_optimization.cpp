@@ -26,12 +26,16 @@ using autoware::common::types::bool8_t;
 using autoware::common::types::float32_t;
 using autoware::common::types::float64_t;
 
+using autoware::localization::ndt::D2DNDTOptimizationConfig;
+using autoware::localization::ndt::D2DNDTOptimizationProblem;
+using autoware::localization::ndt::D2DNDTScan;
 using autoware::localization::ndt::P2DNDTScan;
 using autoware::localization::ndt::P2DNDTOptimizationProblem;
 using autoware::localization::ndt::P2DNDTOptimizationConfig;
 using autoware::localization::ndt::transform_adapters::pose_to_transform;
 
 using P2DProblem = P2DNDTOptimizationProblem<autoware::localization::ndt::StaticNDTMap>;
+using D2DProblem = D2DNDTOptimizationProblem<autoware::localization::ndt::StaticNDTMap>;
 
 constexpr double kPoseEpsilon{0.01};
 
@@ -122,6 +126,118 @@ TEST_P(P2DOptimizationNumericalTest, numerical_analysis) {
     }
   }
 }
+/// @test       Splitting the scan over several threads and using the single precision kernel
+///             give the same results as the serial double precision evaluation.
+TEST_F(P2DOptimizationTest, parallel_and_single_precision_evaluation) {
+  P2DNDTScan scan(m_downsampled_cloud, m_downsampled_cloud.width);
+  EigenPose<Real> pose;
+  pose << 0.3, -0.2, 0.1, 0.05, -0.02, 0.1;
+
+  P2DProblem serial_problem{scan, m_static_map, P2DNDTOptimizationConfig{0.55}};
+  serial_problem.evaluate(pose, autoware::common::optimization::ComputeMode{true, true, true});
+  P2DProblem::Jacobian serial_jacobian;
+  P2DProblem::Hessian serial_hessian;
+  serial_problem.jacobian(pose, serial_jacobian);
+  serial_problem.hessian(pose, serial_hessian);
+  const auto serial_score = serial_problem(pose);
+  ASSERT_FALSE(serial_jacobian.isZero());
+
+  // More threads than points must also work.
+  for (const auto num_threads : {2U, 3U, 4U, static_cast<uint32_t>(scan.size() + 1U)}) {
+    P2DProblem problem{scan, m_static_map, P2DNDTOptimizationConfig{0.55, num_threads}};
+    problem.evaluate(pose, autoware::common::optimization::ComputeMode{true, true, true});
+    P2DProblem::Jacobian jacobian;
+    P2DProblem::Hessian hessian;
+    problem.jacobian(pose, jacobian);
+    problem.hessian(pose, hessian);
+    EXPECT_NEAR(problem(pose), serial_score, 1e-9 * std::fabs(serial_score));
+    EXPECT_TRUE(jacobian.isApprox(serial_jacobian, 1e-9));
+    EXPECT_TRUE(hessian.isApprox(serial_hessian, 1e-9));
+  }
+
+  P2DProblem single_precision_problem{scan, m_static_map,
+    P2DNDTOptimizationConfig{0.55, 2U, true}};
+  single_precision_problem.evaluate(
+    pose, autoware::common::optimization::ComputeMode{}.set_score().set_jacobian());
+  P2DProblem::Jacobian jacobian;
+  single_precision_problem.jacobian(pose, jacobian);
+  EXPECT_NEAR(single_precision_problem(pose), serial_score, 1e-4 * std::fabs(serial_score));
+  EXPECT_TRUE(jacobian.isApprox(serial_jacobian, 1e-4));
+  // The hessian is always computed in double precision.
+  single_precision_problem.evaluate(
+    pose, autoware::common::optimization::ComputeMode{true, true, true});
+  P2DProblem::Hessian hessian;
+  single_precision_problem.hessian(pose, hessian);
+  EXPECT_TRUE(hessian.isApprox(serial_hessian, 1e-9));
+
+  EXPECT_THROW(P2DNDTOptimizationConfig(0.55, 0U), std::domain_error);
+}
+
+/// @test       The analytical jacobian and hessian of the D2D objective match the numerical
+///             ones. The rotation also changes the combined covariance of the cells, so the
+///             poses have large angles.
+TEST_F(P2DOptimizationTest, d2d_numerical_analysis) {
+  // The voxels of the scan are offset from the ones of the map, so the cells differ.
+  D2DNDTScan scan{m_capacity, 1.0F};
+  scan.insert(m_pc);
+  ASSERT_FALSE(scan.empty());
+  D2DProblem problem{scan, m_static_map, D2DNDTOptimizationConfig{0.55}};
+
+  for (const auto & param : {OptTestParams{0.0, 0.0, 0.0, 0.0, 0.0, 0.0, true, false},
+      OptTestParams{0.3, -0.2, 0.1, 0.25, -0.32, 0.4, true, false},
+      OptTestParams{0.5, 0.9, 0.1, 1.0, -3.1, 0.05, true, false}})
+  {
+    EigenPose<Real> pose = param.diff;
+    problem.evaluate(pose, autoware::common::optimization::ComputeMode{true, true, true});
+    D2DProblem::Jacobian jacobian;
+    D2DProblem::Hessian hessian;
+    problem.jacobian(pose, jacobian);
+    problem.hessian(pose, hessian);
+
+    decltype(hessian) numerical_hessian;
+    decltype(jacobian) numerical_jacobian;
+    numerical_diff(problem, pose, numerical_jacobian, numerical_hessian);
+    constexpr auto zero_eps = 1e-4;
+    if (!jacobian.isZero(zero_eps) || !numerical_jacobian.isZero(zero_eps)) {
+      EXPECT_TRUE(jacobian.isApprox(numerical_jacobian, 1e-6)) << pose.transpose();
+    }
+    if (!hessian.isZero(zero_eps) || !numerical_hessian.isZero(zero_eps)) {
+      EXPECT_TRUE(hessian.isApprox(numerical_hessian, 1e-4)) << pose.transpose();
+    }
+  }
+}
+
+/// @test       The map cloud, shifted by half a voxel so that each cell of the scan contains the
+///             points of one map cell, is aligned back with the map by Newton's method.
+TEST_F(P2DOptimizationTest, d2d_alignment) {
+  EigenPose<Real> shift;
+  shift << 0.5, 0.5, 0.5, 0.0, 0.0, 0.0;
+  geometry_msgs::msg::TransformStamped shift_tf2;
+  shift_tf2.header.frame_id = "custom";
+  pose_to_transform(shift, shift_tf2.transform);
+  auto shifted_cloud = m_pc;
+  tf2::doTransform(m_pc, shifted_cloud, shift_tf2);
+
+  D2DNDTScan scan{m_capacity, 1.0F};
+  scan.insert(shifted_cloud);
+  ASSERT_EQ(scan.size(), m_static_map.size());
+  D2DProblem problem{scan, m_static_map, D2DNDTOptimizationConfig{0.55}};
+
+  D2DProblem::DomainValue guess;
+  guess << -0.45, -0.52, -0.47, 0.01, 0.0, -0.01;
+  for (auto i = 0U; i < 10U; ++i) {
+    problem.evaluate(guess, autoware::common::optimization::ComputeMode{true, true, true});
+    D2DProblem::Jacobian jacobian;
+    D2DProblem::Hessian hessian;
+    problem.jacobian(guess, jacobian);
+    problem.hessian(guess, hessian);
+    guess += hessian.ldlt().solve(-jacobian);
+  }
+  for (int i = 0; i < guess.size(); ++i) {
+    EXPECT_NEAR(guess[i], -shift[i], kPoseEpsilon) << "Not matching at index " << i;
+  }
+}
+
 /// @test       The shape is fitting exactly into a single voxel. Its copy is moved in different
 ///             directions and aligned with the original.
 TEST_P(AlignmentXyzTest, AlignShapesWithinOneVoxel) {
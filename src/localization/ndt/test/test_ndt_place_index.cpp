@@ -0,0 +1,177 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#include <gtest/gtest.h>
+#include <ndt/ndt_map.hpp>
+#include <ndt/ndt_place_index.hpp>
+#include <Eigen/Geometry>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "test_ndt_map.hpp"
+#include "common/types.hpp"
+
+using autoware::common::types::float32_t;
+using autoware::common::types::float64_t;
+using autoware::localization::ndt::DynamicNDTMap;
+using autoware::localization::ndt::ScanContextConfig;
+using autoware::localization::ndt::ScanContextIndex;
+using autoware::localization::ndt::StaticNDTMap;
+using autoware::perception::filters::voxel_grid::Config;
+
+class ScanContextIndexTest : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    // Pillars of random footprint and height, so that every place sees a different skyline.
+    std::mt19937 generator{42U};
+    std::uniform_real_distribution<float64_t> position{-55.0, 55.0};
+    std::uniform_real_distribution<float64_t> height{1.0, 12.0};
+    std::uniform_real_distribution<float64_t> unit{0.0, 1.0};
+    for (auto pillar = 0; pillar < 150; ++pillar) {
+      const auto cx = position(generator);
+      const auto cy = position(generator);
+      const auto h = height(generator);
+      for (auto i = 0; i < static_cast<int32_t>(40.0 * h); ++i) {
+        m_world.emplace_back(
+          cx + (1.5 * unit(generator)), cy + (1.5 * unit(generator)), h * unit(generator));
+      }
+    }
+
+    PointXYZ min_point, max_point, voxel_size;
+    min_point.x = -60.0F;
+    min_point.y = -60.0F;
+    min_point.z = -1.0F;
+    max_point.x = 60.0F;
+    max_point.y = 60.0F;
+    max_point.z = 15.0F;
+    voxel_size.x = 1.0F;
+    voxel_size.y = 1.0F;
+    voxel_size.z = 1.0F;
+    DynamicNDTMap dynamic_map{Config{min_point, max_point, voxel_size, 100000U}};
+    auto world_cloud = make_pcl(m_world);
+    world_cloud.header.frame_id = "map";
+    dynamic_map.insert(world_cloud);
+    sensor_msgs::msg::PointCloud2 serialized_map;
+    dynamic_map.serialize_as<StaticNDTMap>(serialized_map);
+    m_map.set(serialized_map);
+
+    for (auto x = -40; x <= 40; x += 10) {
+      m_places.emplace_back(static_cast<float64_t>(x), 0.0, kSensorHeight);
+    }
+  }
+
+  /// Points of the world seen by a sensor at a pose, in the frame of the sensor.
+  sensor_msgs::msg::PointCloud2 make_scan(const Eigen::Vector3d & position, float64_t yaw) const
+  {
+    const Eigen::AngleAxisd rotation{yaw, Eigen::Vector3d::UnitZ()};
+    std::vector<Eigen::Vector3d> points;
+    for (const auto & point : m_world) {
+      if ((point - position).head<2>().norm() < 60.0) {
+        points.emplace_back(rotation.inverse() * (point - position));
+      }
+    }
+    return make_pcl(points);
+  }
+
+  static constexpr float64_t kSensorHeight{2.0};
+  std::vector<Eigen::Vector3d> m_world;
+  StaticNDTMap m_map;
+  std::vector<Eigen::Vector3d> m_places;
+};
+
+constexpr float64_t ScanContextIndexTest::kSensorHeight;
+
+TEST(ScanContextConfigTest, bad_config) {
+  EXPECT_THROW(ScanContextConfig(0U), std::domain_error);
+  EXPECT_THROW(ScanContextConfig(20U, 0U), std::domain_error);
+  EXPECT_THROW(ScanContextConfig(20U, 60U, 10.0F, 5.0F), std::domain_error);
+  EXPECT_THROW(ScanContextConfig(20U, 60U, -1.0F, 5.0F), std::domain_error);
+  EXPECT_THROW(ScanContextConfig(20U, 60U, 1.0F, 80.0F, 3.0F, 3.0F), std::domain_error);
+  EXPECT_THROW(ScanContextConfig(20U, 60U, 1.0F, 80.0F, -3.0F, 10.0F, 0U), std::domain_error);
+}
+
+TEST_F(ScanContextIndexTest, query) {
+  ScanContextIndex index{};
+  index.add_places(m_map, m_places);
+  ASSERT_EQ(index.size(), m_places.size());
+  EXPECT_EQ(index.frame_id(), "map");
+
+  // The scans are taken near the places with arbitrary headings.
+  const auto sector_angle = 2.0 * M_PI / static_cast<float64_t>(index.config().num_sectors());
+  for (const std::size_t true_place : {1U, 4U, 7U}) {
+    for (const float64_t yaw : {0.0, 0.7, -2.5}) {
+      const Eigen::Vector3d position = m_places[true_place] + Eigen::Vector3d{0.8, -0.6, 0.0};
+      const auto candidates = index.query(make_scan(position, yaw), 3U);
+      ASSERT_EQ(candidates.size(), 3U);
+      EXPECT_EQ(candidates[0U].place_index, true_place);
+      EXPECT_LE(candidates[0U].distance, candidates[1U].distance);
+      EXPECT_LE(candidates[1U].distance, candidates[2U].distance);
+      EXPECT_TRUE(candidates[0U].pose.head<3>().isApprox(m_places[true_place]));
+      const auto yaw_error = std::remainder(candidates[0U].pose(5U) - yaw, 2.0 * M_PI);
+      EXPECT_LT(std::abs(yaw_error), 2.0 * sector_angle);
+    }
+  }
+
+  // Fewer candidates than requested are returned if there are fewer places.
+  ScanContextIndex small_index{};
+  small_index.add_places(m_map, {m_places[0U], m_places[1U]});
+  EXPECT_EQ(small_index.query(make_scan(m_places[0U], 0.0), 5U).size(), 2U);
+
+  StaticNDTMap other_map{};
+  EXPECT_THROW(small_index.add_places(other_map, m_places), std::runtime_error);
+  sensor_msgs::msg::PointCloud2 bad_scan;
+  EXPECT_THROW(index.query(bad_scan, 1U), std::domain_error);
+}
+
+TEST_F(ScanContextIndexTest, file_round_trip) {
+  const std::string file_name{"/tmp/ndt_test_place_index.bin"};
+  ScanContextIndex index{ScanContextConfig{10U, 36U}};
+  index.add_places(m_map, m_places);
+  index.write(file_name);
+
+  const auto read_index = ScanContextIndex::read(file_name);
+  ASSERT_EQ(read_index.size(), index.size());
+  EXPECT_EQ(read_index.frame_id(), index.frame_id());
+  EXPECT_EQ(read_index.config().num_sectors(), 36U);
+  for (std::size_t place = 0U; place < index.size(); ++place) {
+    EXPECT_EQ(read_index.position(place), index.position(place));
+  }
+  const auto scan = make_scan(m_places[3U], 1.0);
+  const auto candidates = index.query(scan, 4U);
+  const auto read_candidates = read_index.query(scan, 4U);
+  ASSERT_EQ(read_candidates.size(), candidates.size());
+  for (std::size_t i = 0U; i < candidates.size(); ++i) {
+    EXPECT_EQ(read_candidates[i].place_index, candidates[i].place_index);
+    EXPECT_EQ(read_candidates[i].distance, candidates[i].distance);
+    EXPECT_EQ(read_candidates[i].pose, candidates[i].pose);
+  }
+
+  // A truncated file is rejected.
+  {
+    std::ofstream truncated{file_name, std::ios::binary | std::ios::trunc};
+    truncated << "NDTPLACE";
+  }
+  EXPECT_THROW(ScanContextIndex::read(file_name), std::runtime_error);
+  EXPECT_THROW(
+    ScanContextIndex::read("/tmp/ndt_test_missing_place_index.bin"), std::runtime_error);
+  (void) std::remove(file_name.c_str());
+}
@@ -16,11 +16,17 @@
 
 #include <ndt/ndt_scan.hpp>
 #include <gtest/gtest.h>
-#include <vector>
 #include <algorithm>
+#include <array>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <vector>
 #include "test_ndt_scan.hpp"
 
+using autoware::localization::ndt::D2DNDTScan;
 using autoware::localization::ndt::P2DNDTScan;
+using autoware::common::types::float32_t;
 
 TEST_F(NDTScanTest, bad_input) {
   const auto capacity = 5U;
@@ -70,3 +76,180 @@ TEST_F(NDTScanTest, basics) {
   EXPECT_TRUE(ndt_scan.empty());
   EXPECT_EQ(ndt_scan.size(), 0U);
 }
+
+TEST_F(NDTScanTest, direct_buffer_read) {
+  // A cloud with an unusual layout: an extra leading field and a z field before y.
+  constexpr auto point_step = 16U;
+  const std::vector<sensor_msgs::msg::PointField> fields{
+    make_pf("ring", 0U, sensor_msgs::msg::PointField::UINT8, 1U),
+    make_pf("x", 1U, sensor_msgs::msg::PointField::FLOAT32, 1U),
+    make_pf("z", 5U, sensor_msgs::msg::PointField::FLOAT32, 1U),
+    make_pf("y", 9U, sensor_msgs::msg::PointField::FLOAT32, 1U)};
+  const std::vector<std::array<float32_t, 3U>> points{
+    {{1.0F, 2.0F, 3.0F}},
+    {{std::numeric_limits<float32_t>::quiet_NaN(), 2.0F, 3.0F}},
+    {{-4.0F, -5.0F, -6.0F}}};
+  auto msg = make_pcl(
+    fields, 1U, static_cast<uint32_t>(points.size()) * point_step,
+    static_cast<uint32_t>(points.size()) * point_step, static_cast<uint32_t>(points.size()),
+    point_step);
+  for (auto i = 0U; i < points.size(); ++i) {
+    auto * const data = &msg.data[i * point_step];
+    std::memcpy(data + 1U, &points[i][0U], sizeof(float32_t));
+    std::memcpy(data + 9U, &points[i][1U], sizeof(float32_t));
+    std::memcpy(data + 5U, &points[i][2U], sizeof(float32_t));
+  }
+
+  P2DNDTScan ndt_scan(points.size());
+  ASSERT_NO_THROW(ndt_scan.insert(msg));
+  // The non-finite point is skipped.
+  ASSERT_EQ(ndt_scan.size(), 2U);
+  EXPECT_EQ(ndt_scan.point(0U), Eigen::Vector3d(1.0, 2.0, 3.0));
+  EXPECT_EQ(ndt_scan.point(1U), Eigen::Vector3d(-4.0, -5.0, -6.0));
+  EXPECT_EQ(*std::next(ndt_scan.begin()), ndt_scan.point(1U));
+  EXPECT_EQ(std::distance(ndt_scan.begin(), ndt_scan.end()), 2);
+
+  // All points are transformed at once.
+  P2DNDTScan::Transform transform{Eigen::AngleAxisd{0.3, Eigen::Vector3d::UnitZ()}};
+  transform.translation() = Eigen::Vector3d{1.0, -2.0, 0.5};
+  P2DNDTScan::TransformedPoints transformed;
+  ndt_scan.transform(transform, 0U, ndt_scan.size(), transformed);
+  ASSERT_EQ(transformed.rows(), 2);
+  for (auto i = 0U; i < ndt_scan.size(); ++i) {
+    const Eigen::Vector3d expected = transform * ndt_scan.point(i);
+    EXPECT_TRUE(transformed.row(i).transpose().isApprox(expected));
+  }
+
+  msg.fields[1U].datatype = sensor_msgs::msg::PointField::FLOAT64;
+  EXPECT_THROW(ndt_scan.insert(msg), std::domain_error);
+}
+
+TEST_F(NDTScanTest, downsampling) {
+  EXPECT_THROW(P2DNDTScan(m_num_points, -1.0F), std::domain_error);
+
+  // All points in a voxel are replaced by their centroid.
+  const std::vector<Point> points{
+    {0.1, 0.1, 0.1}, {0.3, 0.5, 0.7}, {0.5, 0.3, 0.1},
+    {1.5, 0.5, 0.5},
+    {-0.5, -0.5, -0.5}, {-0.7, -0.1, -0.9}};
+  const auto msg = make_pcl(points);
+
+  P2DNDTScan ndt_scan(3U, 1.0F);
+  EXPECT_EQ(ndt_scan.voxel_size(), 1.0F);
+  ASSERT_NO_THROW(ndt_scan.insert(msg));
+  ASSERT_EQ(ndt_scan.size(), 3U);
+  const std::vector<Point> expected{{0.3, 0.3, 0.3}, {1.5, 0.5, 0.5}, {-0.6, -0.3, -0.7}};
+  for (auto i = 0U; i < expected.size(); ++i) {
+    EXPECT_TRUE(ndt_scan.point(i).isApprox(expected[i], 1e-6)) << i;
+  }
+
+  // The capacity limits the number of voxels rather than the number of points.
+  P2DNDTScan small_scan(2U, 1.0F);
+  EXPECT_THROW(small_scan.insert(msg), std::length_error);
+  P2DNDTScan coarse_scan(2U, 4.0F);
+  ASSERT_NO_THROW(coarse_scan.insert(msg));
+  EXPECT_EQ(coarse_scan.size(), 2U);
+}
+
+TEST_F(NDTScanTest, subsampling) {
+  const std::vector<Point> points{
+    {0.0, 0.0, 0.0}, {1.0, 0.0, 0.0}, {2.0, 0.0, 0.0}, {3.0, 0.0, 0.0}, {4.0, 0.0, 0.0}};
+  const auto msg = make_pcl(points);
+
+  // Only every other point needs to fit into the capacity.
+  P2DNDTScan ndt_scan(3U);
+  EXPECT_THROW(ndt_scan.set_stride(0U), std::domain_error);
+  EXPECT_EQ(ndt_scan.stride(), 1U);
+  EXPECT_THROW(ndt_scan.insert(msg), std::length_error);
+  ndt_scan.set_stride(2U);
+  ASSERT_NO_THROW(ndt_scan.insert(msg));
+  ASSERT_EQ(ndt_scan.size(), 3U);
+  for (auto i = 0U; i < ndt_scan.size(); ++i) {
+    EXPECT_EQ(ndt_scan.point(i), points[2U * i]) << i;
+  }
+  ndt_scan.set_stride(4U);
+  ASSERT_NO_THROW(ndt_scan.insert(msg));
+  ASSERT_EQ(ndt_scan.size(), 2U);
+  EXPECT_EQ(ndt_scan.point(1U), points[4U]);
+
+  // The points are subsampled before the downsampling.
+  P2DNDTScan downsampled_scan(5U, 2.0F);
+  downsampled_scan.set_stride(3U);
+  ASSERT_NO_THROW(downsampled_scan.insert(msg));
+  ASSERT_EQ(downsampled_scan.size(), 2U);
+  EXPECT_EQ(downsampled_scan.point(0U), points[0U]);
+  EXPECT_EQ(downsampled_scan.point(1U), points[3U]);
+}
+
+TEST_F(NDTScanTest, point_budget) {
+  // Ten points along the diagonal of one quadrant, one and two points in two other quadrants.
+  std::vector<Point> points;
+  for (auto r = 1; r <= 10; ++r) {
+    points.emplace_back(r, r, 0.0);
+  }
+  points.emplace_back(-1.0, -1.0, 0.0);
+  points.emplace_back(-1.0, 2.0, 0.0);
+  points.emplace_back(-2.0, 1.0, 0.0);
+  const auto msg = make_pcl(points);
+
+  P2DNDTScan ndt_scan(points.size());
+  EXPECT_THROW(ndt_scan.set_point_budget(7U, 0U), std::domain_error);
+  EXPECT_EQ(ndt_scan.max_points(), 0U);
+  ASSERT_NO_THROW(ndt_scan.insert(msg));
+  EXPECT_EQ(ndt_scan.size(), points.size());
+
+  // The sparse quadrants keep all of their points, the rest of the budget is spread over the
+  // range of the dense one. The order of the points is kept.
+  ndt_scan.set_point_budget(7U, 4U);
+  EXPECT_EQ(ndt_scan.max_points(), 7U);
+  ASSERT_NO_THROW(ndt_scan.insert(msg));
+  ASSERT_EQ(ndt_scan.size(), 7U);
+  const std::vector<Point> expected{
+    points[1U], points[3U], points[6U], points[8U], points[10U], points[11U], points[12U]};
+  for (auto i = 0U; i < expected.size(); ++i) {
+    EXPECT_EQ(ndt_scan.point(i), expected[i]) << i;
+  }
+
+  // Scans within the budget are kept as they are.
+  ndt_scan.set_point_budget(points.size(), 4U);
+  ASSERT_NO_THROW(ndt_scan.insert(msg));
+  EXPECT_EQ(ndt_scan.size(), points.size());
+}
+
+TEST_F(NDTScanTest, d2d_cells) {
+  EXPECT_THROW(D2DNDTScan(m_num_points, 0.0F), std::domain_error);
+
+  // Only voxels with enough points for a covariance become cells: the second voxel has too few
+  // points and the points of the third one coincide.
+  const std::vector<Point> points{
+    {0.1, 0.1, 0.1}, {0.9, 0.1, 0.1}, {1.5, 0.5, 0.5}, {0.1, 0.9, 0.1}, {0.1, 0.1, 0.9},
+    {1.5, 0.7, 0.5}, {-0.5, -0.5, -0.5}, {-0.5, -0.5, -0.5}, {-0.5, -0.5, -0.5}};
+  const auto msg = make_pcl(points);
+
+  D2DNDTScan ndt_scan(3U, 1.0F);
+  EXPECT_EQ(ndt_scan.voxel_size(), 1.0F);
+  EXPECT_TRUE(ndt_scan.empty());
+  ASSERT_NO_THROW(ndt_scan.insert(msg));
+  ASSERT_EQ(ndt_scan.size(), 1U);
+  EXPECT_TRUE(ndt_scan.begin()->isApprox(Point{0.3, 0.3, 0.3}, 1e-6));
+  // Sample covariance of the corners of a tetrahedron with edges of 0.8 along the axes.
+  const Eigen::Matrix3d expected_covariance =
+    (0.64 / 3.0) * (Eigen::Matrix3d::Identity() - (0.25 * Eigen::Matrix3d::Ones()));
+  EXPECT_TRUE(ndt_scan.covariance(0U).isApprox(expected_covariance, 1e-6));
+
+  // The capacity limits the number of occupied voxels, including the ones that aren't cells.
+  D2DNDTScan small_scan(2U, 1.0F);
+  EXPECT_THROW(small_scan.insert(msg), std::length_error);
+
+  // The points are subsampled before they are binned.
+  EXPECT_THROW(ndt_scan.set_stride(0U), std::domain_error);
+  ndt_scan.set_stride(2U);
+  ASSERT_NO_THROW(ndt_scan.insert(msg));
+  EXPECT_TRUE(ndt_scan.empty());
+
+  ndt_scan.set_stride(1U);
+  ASSERT_NO_THROW(ndt_scan.insert(msg));
+  EXPECT_EQ(ndt_scan.size(), 1U);
+  ndt_scan.clear();
+  EXPECT_TRUE(ndt_scan.empty());
+}
@@ -21,10 +21,12 @@
 #include <ndt/ndt_map_publisher.hpp>
 #include <sensor_msgs/msg/point_cloud2.hpp>
 #include <ndt/ndt_map.hpp>
+#include <startup_tracking/startup_tracker.hpp>
 #include <tf2_geometry_msgs/tf2_geometry_msgs.h>
 #include <tf2_msgs/msg/tf_message.hpp>
 #include <tf2_ros/static_transform_broadcaster.h>
 #include <voxel_grid_nodes/algorithm/voxel_cloud_centroid.hpp>
+#include <future>
 #include <string>
 #include <memory>
 #include "common/types.hpp"
@@ -47,21 +49,25 @@ public:
   using SerializedMap = ndt::StaticNDTMap;
   using MapConfig = perception::filters::voxel_grid::Config;
   using VoxelGrid = perception::filters::voxel_grid_nodes::algorithm::VoxelCloudCentroid;
-  /// \brief Parameter constructor
+  /// \brief Parameter constructor. Publishes the earth to map transform and starts loading the
+  /// map in the background, see load_map(). The map is published once it is loaded.
   /// \param node_options Additional options to control creation of the node.
   explicit NDTMapPublisherNode(
     const rclcpp::NodeOptions & node_options
   );
 
-  /// Run the publisher. Following actions are executed in order:
-  /// 1. Wait until the map publisher matches the configured number of subscribers. If the
-  /// configured timeout occurs, it throws an exception.
-  /// 2. Load the PCD file into a PointCloud2 message.
-  /// 3. Apply the normal distribution transform loaded PointCloud2 message.
-  /// 4. Convert the resulting map representation into a `PointCloud2` message and publish.
-  void run();
+  /// \brief Waits for the loading of the map to end
+  ~NDTMapPublisherNode() override;
 
 private:
+  /// Load the map. Following actions are executed in order:
+  /// 1. Load the PCD file into a PointCloud2 message.
+  /// 2. Apply the normal distribution transform loaded PointCloud2 message.
+  /// 3. Convert the resulting map representation into a `PointCloud2` message.
+  /// If a binary map file is configured, steps 1. and 2. are replaced by memory mapping the
+  /// pre-computed ndt map.
+  void load_map();
+
   /// Initialize and allocate memory for the point clouds that are used as intermediate
   /// representations during  conversions. & setup visualization publisher if required
   /// \param map_frame Frame of the map
@@ -74,6 +80,10 @@ private:
 
   void publish_earth_to_map_transform(ndt::geocentric_pose_t pose);
 
+  /// Load the pre-computed ndt map from the configured binary map file. The voxel centroids are
+  /// used as the source cloud for visualization.
+  void load_binary_map();
+
   /// Publish the loaded map file. If no new map is loaded, it will publish the
   /// previous map, or an empty map.
   void publish();
@@ -84,6 +94,8 @@ private:
   /// Use a Voxel Grid filter to downsample the loaded map prior to publishing.
   void downsample_pc();
 
+  common::startup_tracking::StartupTracker m_startup_tracker;
+  common::startup_tracking::StartupGate m_startup_gate;
   rclcpp::Publisher<tf2_msgs::msg::TFMessage>::SharedPtr m_pub_earth_map;
   rclcpp::Publisher<sensor_msgs::msg::PointCloud2>::SharedPtr m_pub;
   std::unique_ptr<ndt::DynamicNDTMap> m_ndt_map_ptr;
@@ -92,7 +104,10 @@ private:
   sensor_msgs::msg::PointCloud2 m_downsampled_pc;
   const std::string m_pcl_file_name;
   const std::string m_yaml_file_name;
+  const std::string m_binary_file_name;
   const bool8_t m_viz_map;
+  /// Number of threads that voxelize the pcd map, including the thread of the node
+  const std::size_t m_num_threads;
   rclcpp::Publisher<sensor_msgs::msg::PointCloud2>::SharedPtr m_viz_pub;
   std::unique_ptr<MapConfig> m_map_config_ptr;
   std::unique_ptr<MapConfig> m_viz_map_config_ptr;
@@ -100,6 +115,8 @@ private:
   // Workaround. TODO(yunus.caliskan): Remove in #380
   rclcpp::TimerBase::SharedPtr m_visualization_timer{nullptr};
   rclcpp::TimerBase::SharedPtr m_transform_pub_timer{nullptr};
+  /// Loads the map in the background
+  std::future<void> m_map_load;
 };
 
 }  // namespace ndt_nodes
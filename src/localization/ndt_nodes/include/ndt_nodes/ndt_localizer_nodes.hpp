@@ -20,6 +20,7 @@
 #include <common/types.hpp>
 #include <ndt_nodes/visibility_control.hpp>
 #include <ndt/ndt_localizer.hpp>
+#include <ndt/ndt_map_tiles.hpp>
 #include <localization_nodes/localization_node.hpp>
 #include <sensor_msgs/msg/point_cloud2.hpp>
 #include <optimization/newtons_method_optimizer.hpp>
@@ -44,11 +45,12 @@ namespace ndt_nodes
 // TODO(yunus.caliskan) remove the hard-coded optimizer set up and make it fully configurable
 using Optimizer_ =
   common::optimization::NewtonsMethodOptimizer<common::optimization::MoreThuenteLineSearch>;
-using PoseInitializer_ = localization_common::BestEffortInitializer;
+using PoseInitializer_ = localization_common::ConstantVelocityInitializer;
 
 /// P2D NDT localizer node. Currently uses the hard coded optimizer and pose initializers.
 /// \tparam OptimizerT Hard coded for Newton optimizer. TODO(yunus.caliskan): Make Configurable
-/// \tparam PoseInitializerT Hard coded for Best effort. TODO(yunus.caliskan): Make Configurable
+/// \tparam PoseInitializerT Hard coded for constant velocity. TODO(yunus.caliskan): Make
+///         Configurable
 template<typename OptimizerT = Optimizer_, typename PoseInitializerT = PoseInitializer_>
 class NDT_NODES_PUBLIC P2DNDTLocalizerNode
   : public localization_nodes::RelativeLocalizerNode<
@@ -119,6 +121,11 @@ protected:
       case common::optimization::TerminationType::NO_CONVERGENCE:
         ret = on_non_convergence(summary, pose, guess);
         break;
+      case common::optimization::TerminationType::TIME_BUDGET_EXCEEDED:
+        // The best estimate within the time budget, it is checked against the guess like any
+        // other result.
+        RCLCPP_DEBUG(this->get_logger(), "NDT localizer ran out of its time budget.");
+        break;
       default:
         break;
     }
@@ -133,6 +140,22 @@ protected:
     return ret;
   }
 
+  /// Merge the finished tile loads and evictions into the map if the map is tiled.
+  void update_map(ndt::StaticNDTMap & map) override
+  {
+    if (m_tile_loader) {
+      (void) m_tile_loader->apply_updates(map);
+    }
+  }
+
+  /// Stream the map tiles around the latest pose estimate if the map is tiled.
+  void on_pose_update(const geometry_msgs::msg::Pose & pose) override
+  {
+    if (m_tile_loader) {
+      m_tile_loader->set_position(pose.position.x, pose.position.y);
+    }
+  }
+
 private:
   virtual bool on_non_convergence(
     const RegistrationSummary &,
@@ -189,11 +212,18 @@ private:
       template get<uint32_t>()),
       std::chrono::milliseconds(
         static_cast<uint64_t>(
-          this->declare_parameter("localizer.guess_time_tolerance_ms").template get<uint64_t>()))
+          this->declare_parameter("localizer.guess_time_tolerance_ms").template get<uint64_t>())),
+      static_cast<float32_t>(this->declare_parameter("localizer.scan.voxel_size", 0.0)),
+      static_cast<std::size_t>(this->declare_parameter("localizer.scan.max_stride", 1)),
+      static_cast<std::size_t>(this->declare_parameter("localizer.scan.max_points", 0)),
+      static_cast<std::size_t>(this->declare_parameter("localizer.scan.num_sectors", 16))
     };
 
-    const auto outlier_ratio{this->declare_parameter(
-        "localizer.optimization.outlier_ratio").template get<float64_t>()};
+    const ndt::P2DNDTOptimizationConfig optimization_config{
+      this->declare_parameter("localizer.optimization.outlier_ratio").template get<float64_t>(),
+      static_cast<uint32_t>(this->declare_parameter("localizer.optimization.num_threads", 1)),
+      this->declare_parameter("localizer.optimization.single_precision_gradient", false)
+    };
 
     common::optimization::OptimizationOptions optimizer_options{
       static_cast<uint64_t>(
@@ -201,7 +231,9 @@ private:
       this->declare_parameter("localizer.optimizer.score_tolerance").template get<float64_t>(),
       this->declare_parameter(
         "localizer.optimizer.parameter_tolerance").template get<float64_t>(),
-      this->declare_parameter("localizer.optimizer.gradient_tolerance").template get<float64_t>()
+      this->declare_parameter("localizer.optimizer.gradient_tolerance").template get<float64_t>(),
+      std::chrono::milliseconds{
+        this->declare_parameter("localizer.optimizer.time_budget_ms", 0)}
     };
 
     // Construct and set the localizer.
@@ -220,15 +252,57 @@ private:
               common::optimization::MoreThuenteLineSearch::OptimizationDirection::kMaximization},
             optimizer_options
           },
-      outlier_ratio);
-    auto map_ptr = std::make_unique<ndt::StaticNDTMap>();
+      optimization_config);
+    const auto lookup_mode = cell_lookup_mode_from_string(
+      this->declare_parameter("localizer.map.cell_lookup_mode", std::string{"single"}));
+    auto map_ptr = std::make_unique<ndt::StaticNDTMap>(lookup_mode);
+
+    // Tiled maps are streamed from disk around the pose estimate instead of being received on
+    // the map topic.
+    const auto tile_directory =
+      this->declare_parameter("localizer.map.tiles.directory", std::string{});
+    const auto tile_radius = this->declare_parameter("localizer.map.tiles.radius", 100.0);
+    // Map messages are applied in the background while registration continues on the previous
+    // map. Tiles are merged into the map in place, so they don't use the double buffer.
+    const auto double_buffered =
+      this->declare_parameter("localizer.map.double_buffered", false) && tile_directory.empty();
 
     this->set_localizer(std::move(localizer_ptr));
-    this->set_map(std::move(map_ptr));
+    if (double_buffered) {
+      this->set_map(std::move(map_ptr), std::make_unique<ndt::StaticNDTMap>(lookup_mode));
+    } else {
+      this->set_map(std::move(map_ptr));
+    }
+
+    if (!tile_directory.empty()) {
+      m_tile_loader = std::make_unique<ndt::NDTMapTileLoader>(tile_directory, tile_radius);
+      if (this->has_parameter("initial_pose.translation.x")) {
+        m_tile_loader->set_position(
+          this->get_parameter("initial_pose.translation.x").as_double(),
+          this->get_parameter("initial_pose.translation.y").as_double());
+      }
+    }
+  }
+
+  /// Parse the cell lookup mode of the map.
+  /// \param mode One of "single", "face_neighbours" or "all_neighbours".
+  /// \return The corresponding lookup mode.
+  /// \throws std::domain_error on unknown modes.
+  static ndt::CellLookupMode cell_lookup_mode_from_string(const std::string & mode)
+  {
+    if (mode == "single") {
+      return ndt::CellLookupMode::SINGLE;
+    } else if (mode == "face_neighbours") {
+      return ndt::CellLookupMode::FACE_NEIGHBOURS;
+    } else if (mode == "all_neighbours") {
+      return ndt::CellLookupMode::ALL_NEIGHBOURS;
+    }
+    throw std::domain_error("P2DNDTLocalizerNode: Unknown cell lookup mode: " + mode);
   }
 
   ndt::Real m_predict_translation_threshold;
   ndt::Real m_predict_rotation_threshold;
+  std::unique_ptr<ndt::NDTMapTileLoader> m_tile_loader{nullptr};
 };
 }  // namespace ndt_nodes
 }  // namespace localization
@@ -15,12 +15,15 @@
 // Co-developed by Tier IV, Inc. and Apex.AI, Inc.
 
 #include <common/types.hpp>
+#include <ndt/ndt_map_binary.hpp>
 #include <ndt_nodes/map_publisher.hpp>
 #include <rclcpp_components/register_node_macro.hpp>
 #include <point_cloud_msg_wrapper/point_cloud_msg_wrapper.hpp>
+#include <thread_pool/thread_pool.hpp>
 #include <tf2_geometry_msgs/tf2_geometry_msgs.h>
 #include <tf2/LinearMath/Quaternion.h>
 
+#include <future>
 #include <memory>
 #include <string>
 
@@ -44,9 +47,13 @@ NDTMapPublisherNode::NDTMapPublisherNode(
   const rclcpp::NodeOptions & node_options
 )
 : Node("ndt_map_publisher_node", node_options),
-  m_pcl_file_name(declare_parameter("map_pcd_file").get<std::string>()),
+  m_startup_tracker{*this},
+  m_startup_gate{*this, m_startup_tracker},
+  m_pcl_file_name(declare_parameter("map_pcd_file", std::string{})),
   m_yaml_file_name(declare_parameter("map_yaml_file").get<std::string>()),
-  m_viz_map(declare_parameter("viz_map", false))
+  m_binary_file_name(declare_parameter("map_binary_file", std::string{})),
+  m_viz_map(declare_parameter("viz_map", false)),
+  m_num_threads(static_cast<std::size_t>(declare_parameter("num_threads", 1)))
 {
   using PointXYZ = perception::filters::voxel_grid::PointXYZ;
   PointXYZ min_point;
@@ -78,7 +85,38 @@ NDTMapPublisherNode::NDTMapPublisherNode(
 
   m_map_config_ptr = std::make_unique<MapConfig>(min_point, max_point, voxel_size, capacity);
   init(map_frame, map_topic, viz_map_topic);
-  run();
+  // The origin is published right away, since the lanelet2 map provider may wait for it
+  publish_earth_to_map_transform(ndt::load_map_origin(m_yaml_file_name));
+
+  // Voxelizing a large map takes seconds, so it is done in the background while the executor
+  // spins the other nodes of the process. The maps are only used after the loading ended.
+  m_map_load = std::async(std::launch::async, [this]() {load_map();});
+  m_startup_gate.require("map", common::startup_tracking::future_ready(m_map_load));
+  m_startup_gate.open_when_ready(
+    [this]() {
+      // Rethrows the errors of the loading
+      m_map_load.get();
+      publish();
+      if (m_viz_map) {
+        // Periodic publishing is a temp. hack until the rviz in ade has transient_local qos
+        // support. TODO(yunus.caliskan): Remove the loop and publish only once after #380
+        m_visualization_timer = create_wall_timer(
+          std::chrono::seconds(1),
+          [this]() {
+            if (m_downsampled_pc.width > 0U) {
+              m_viz_pub->publish(m_downsampled_pc);
+            }
+          });
+      }
+    });
+}
+
+NDTMapPublisherNode::~NDTMapPublisherNode()
+{
+  // The loading uses the members, so it has to end before they are destroyed
+  if (m_map_load.valid()) {
+    m_map_load.wait();
+  }
 }
 
 void NDTMapPublisherNode::init(
@@ -116,16 +154,6 @@ void NDTMapPublisherNode::init(
     point_cloud_msg_wrapper::PointCloud2Modifier<common::types::PointXYZI>
     downsampled_pc_initializer{m_downsampled_pc, map_frame};
     m_voxelgrid_ptr = std::make_unique<VoxelGrid>(*m_viz_map_config_ptr);
-
-    // Periodic publishing is a temp. hack until the rviz in ade has transient_local qos support.
-    // TODO(yunus.caliskan): Remove the loop and publish only once after #380
-    m_visualization_timer = create_wall_timer(
-      std::chrono::seconds(1),
-      [this]() {
-        if (m_downsampled_pc.width > 0U) {
-          m_viz_pub->publish(m_downsampled_pc);
-        }
-      });
   }
 
   m_pub_earth_map = create_publisher<tf2_msgs::msg::TFMessage>(
@@ -133,18 +161,51 @@ void NDTMapPublisherNode::init(
     rclcpp::QoS(rclcpp::KeepLast(5U)).transient_local());
 }
 
-void NDTMapPublisherNode::run()
+void NDTMapPublisherNode::load_map()
 {
-  ndt::geocentric_pose_t pose = ndt::load_map(m_yaml_file_name, m_pcl_file_name, m_source_pc);
-  publish_earth_to_map_transform(pose);
-  m_ndt_map_ptr->insert(m_source_pc);
-  m_ndt_map_ptr->serialize_as<SerializedMap>(m_map_pc);
+  if (m_binary_file_name.empty()) {
+    (void)ndt::load_map(m_yaml_file_name, m_pcl_file_name, m_source_pc);
+    m_startup_tracker.phase_done("load_pcd");
+    if (m_num_threads > 1U) {
+      // The loading thread joins in while it waits, so the pool needs one worker less
+      common::thread_pool::ThreadPoolConfig pool_config;
+      pool_config.num_threads = m_num_threads - 1U;
+      common::thread_pool::ThreadPool pool{pool_config};
+      m_ndt_map_ptr->insert(m_source_pc, pool);
+    } else {
+      m_ndt_map_ptr->insert(m_source_pc);
+    }
+    m_ndt_map_ptr->serialize_as<SerializedMap>(m_map_pc);
+    m_startup_tracker.phase_done("voxelize_map");
+  } else {
+    load_binary_map();
+    m_startup_tracker.phase_done("load_binary_map");
+  }
 
   if (m_viz_map) {
     reset_pc_msg(m_downsampled_pc);
     downsample_pc();
   }
-  publish();
+}
+
+void NDTMapPublisherNode::load_binary_map()
+{
+  const ndt::NDTMapBinaryFile binary_map{m_binary_file_name};
+  ndt::serialize_from_binary(binary_map, m_map_pc);
+
+  if (m_viz_map) {
+    point_cloud_msg_wrapper::PointCloud2Modifier<common::types::PointXYZI> source_modifier{
+      m_source_pc};
+    source_modifier.clear();
+    source_modifier.reserve(binary_map.size());
+    for (const auto & voxel : binary_map) {
+      common::types::PointXYZI pt{};
+      pt.x = static_cast<float32_t>(voxel.centroid[0U]);
+      pt.y = static_cast<float32_t>(voxel.centroid[1U]);
+      pt.z = static_cast<float32_t>(voxel.centroid[2U]);
+      source_modifier.push_back(pt);
+    }
+  }
 }
 
 void NDTMapPublisherNode::publish_earth_to_map_transform(ndt::geocentric_pose_t pose)
@@ -0,0 +1,127 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+// Offline tool converting a pcd map into a binary ndt map that can be loaded by the map
+// publisher via the `map_binary_file` parameter. The map is voxelized with the `map_config` and
+// `map_frame` parameters of the given map publisher parameter file so that the result is
+// identical to the map the publisher would compute from the pcd file at startup.
+// If a tile size is given, the map is split into square tiles of that size instead and the
+// output is a directory that can be streamed by the localizer via `localizer.map.tiles.directory`.
+// The map is voxelized with `num_threads` threads if the parameter is set, and with all hardware
+// threads otherwise.
+//
+// Usage: ndt_map_binary_writer <map_publisher.param.yaml> <input.pcd> <output.ndtmap>
+//        ndt_map_binary_writer <map_publisher.param.yaml> <input.pcd> <output_dir> <tile_size>
+
+#include <common/types.hpp>
+#include <ndt/ndt_map.hpp>
+#include <ndt/ndt_map_binary.hpp>
+#include <ndt/ndt_map_publisher.hpp>
+#include <ndt/ndt_map_tiles.hpp>
+#include <point_cloud_msg_wrapper/point_cloud_msg_wrapper.hpp>
+#include <thread_pool/thread_pool.hpp>
+#include <yaml-cpp/yaml.h>
+
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using autoware::common::types::float32_t;
+using autoware::common::types::float64_t;
+using autoware::localization::ndt::DynamicNDTMap;
+
+namespace
+{
+/// Find the `ros__parameters` of the first node in a ROS 2 parameter file.
+YAML::Node find_ros_parameters(const YAML::Node & params_file)
+{
+  for (const auto & node : params_file) {
+    if (node.second["ros__parameters"]) {
+      return node.second["ros__parameters"];
+    }
+  }
+  throw std::runtime_error("Parameter file does not contain ros__parameters.");
+}
+
+DynamicNDTMap::ConfigPoint read_point(const YAML::Node & node)
+{
+  return DynamicNDTMap::ConfigPoint{}.set__x(node["x"].as<float32_t>()).
+         set__y(node["y"].as<float32_t>()).set__z(node["z"].as<float32_t>());
+}
+}  // namespace
+
+int32_t main(const int32_t argc, char ** const argv)
+{
+  if ((argc != 4) && (argc != 5)) {
+    std::cerr << "Usage: " << argv[0] <<
+      " <map_publisher.param.yaml> <input.pcd> <output.ndtmap>" << std::endl <<
+      "       " << argv[0] <<
+      " <map_publisher.param.yaml> <input.pcd> <output_dir> <tile_size>" << std::endl;
+    return 1;
+  }
+  const std::string params_file_name{argv[1]};
+  const std::string pcd_file_name{argv[2]};
+  const std::string output_file_name{argv[3]};
+
+  try {
+    const auto params = find_ros_parameters(YAML::LoadFile(params_file_name));
+    const auto map_config = params["map_config"];
+    const DynamicNDTMap::Config config{
+      read_point(map_config["min_point"]),
+      read_point(map_config["max_point"]),
+      read_point(map_config["voxel_size"]),
+      map_config["capacity"].as<uint64_t>()};
+    const auto map_frame = params["map_frame"] ? params["map_frame"].as<std::string>() : "map";
+
+    sensor_msgs::msg::PointCloud2 cloud;
+    point_cloud_msg_wrapper::PointCloud2Modifier<autoware::common::types::PointXYZI>{
+      cloud, map_frame};
+    autoware::localization::ndt::read_from_pcd(pcd_file_name, &cloud);
+    // The frame of the pcd file may be overwritten when it's read.
+    cloud.header.frame_id = map_frame;
+
+    const std::size_t num_threads = params["num_threads"] ?
+      params["num_threads"].as<std::size_t>() :
+      std::max(std::thread::hardware_concurrency(), 1U);
+
+    DynamicNDTMap map{config};
+    if (num_threads > 1U) {
+      // The main thread joins in while it waits, so the pool needs one worker less
+      autoware::common::thread_pool::ThreadPoolConfig pool_config;
+      pool_config.num_threads = num_threads - 1U;
+      autoware::common::thread_pool::ThreadPool pool{pool_config};
+      map.insert(cloud, pool);
+    } else {
+      map.insert(cloud);
+    }
+    if (argc == 5) {
+      const float64_t tile_size{std::stod(argv[4])};
+      const auto num_tiles =
+        autoware::localization::ndt::write_ndt_map_tiles(map, tile_size, output_file_name);
+      std::cout << "Wrote " << num_tiles << " tiles to " << output_file_name << std::endl;
+    } else {
+      const auto num_voxels =
+        autoware::localization::ndt::write_ndt_map_binary(map, output_file_name);
+      std::cout << "Wrote " << num_voxels << " voxels to " << output_file_name << std::endl;
+    }
+  } catch (const std::exception & e) {
+    std::cerr << "ndt_map_binary_writer: " << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
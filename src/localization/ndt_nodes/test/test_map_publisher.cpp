@@ -204,7 +204,9 @@ TEST_F(MapPublisherTest, core_functionality)
   std::shared_ptr<NDTMapPublisherNode> map_publisher;
   EXPECT_NO_THROW(map_publisher = std::make_shared<NDTMapPublisherNode>(node_options));
 
+  // The map is loaded in the background and published by the executor of the node
   while (callback_counter < 1U) {
+    rclcpp::spin_some(map_publisher);
     rclcpp::spin_some(listener_node);
   }
 
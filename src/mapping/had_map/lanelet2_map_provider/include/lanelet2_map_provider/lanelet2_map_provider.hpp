@@ -56,21 +56,23 @@ public:
   /// \param stf The earth to map transform for projection of map data
   /// \param offset_lat Latitude offset in degrees to be added to the map frame origin
   /// \param offset_lon Longitude offset in degrees to be added to the map origin
+  /// \param map_cache_filename Binary cache of the parsed map, not used if empty
   // TODO(nikolai.morin): Remove offsets as part of #849
   Lanelet2MapProvider(
     const std::string & map_filename,
     const geometry_msgs::msg::TransformStamped & stf, const float64_t offset_lat = 0.0,
-    const float64_t offset_lon = 0.0);
+    const float64_t offset_lon = 0.0, const std::string & map_cache_filename = "");
   /// \brief Constructor from latitude, longitude, altitude
   /// \param map_filename The lanelet map filename
   /// \param map_frame_origin The map frame origin
   /// \param offset_lat Latitude offset in degrees to be added to the map frame origin
   /// \param offset_lon Longitude offset in degrees to be added to the map frame origin
+  /// \param map_cache_filename Binary cache of the parsed map, not used if empty
   // TODO(nikolai.morin): Remove offsets as part of #849
   Lanelet2MapProvider(
     const std::string & map_filename, const LatLonAlt map_frame_origin,
     const float64_t offset_lat = 0.0,
-    const float64_t offset_lon = 0.0);
+    const float64_t offset_lon = 0.0, const std::string & map_cache_filename = "");
   /// The map itself. After the constructor logic has been done,
   /// this is guaranteed to be initialized.
   std::shared_ptr<lanelet::LaneletMap> m_map;
@@ -79,8 +81,11 @@ private:
   /// \brief Internal function used by the constructor
   /// \param map_filename The lanelet map filename
   /// \param map_frame_origin The map frame origin
+  /// \param map_cache_filename Binary cache of the parsed map, not used if empty. It is written
+  /// if it is missing or was made from another map file or origin.
   void load_map(
-    const std::string & map_filename, const LatLonAlt map_frame_origin);
+    const std::string & map_filename, const LatLonAlt map_frame_origin,
+    const std::string & map_cache_filename);
 };
 
 }  // namespace lanelet2_map_provider
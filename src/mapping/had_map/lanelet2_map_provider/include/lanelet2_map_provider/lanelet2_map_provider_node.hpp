@@ -22,10 +22,19 @@
 #include <rclcpp/rclcpp.hpp>
 
 #include <lanelet2_map_provider/lanelet2_map_provider.hpp>
+#include <startup_tracking/startup_tracker.hpp>
+#include <array>
+#include <deque>
+#include <future>
+#include <map>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "autoware_auto_msgs/srv/had_map_service.hpp"
 #include "autoware_auto_msgs/msg/had_map_bin.hpp"
+#include "had_map_utils/had_map_query.hpp"
+#include "std_msgs/msg/string.hpp"
 
 namespace autoware
 {
@@ -43,14 +52,21 @@ namespace lanelet2_map_provider
 class LANELET2_MAP_PROVIDER_PUBLIC Lanelet2MapProviderNode : public rclcpp::Node
 {
 public:
-  /// \brief default constructor, loads the map and transforms it from earth frame
-  /// into map frame.
+  /// \brief default constructor, starts loading the map and transforming it from earth frame
+  /// into map frame in the background. The service is created once the map is loaded.
   /// *breaks docs test - no node_name generated by automatic package generator
   /// -- param[in] node_name name of the node for rclcpp internals
   /// \throw runtime error if failed to start threads or configure driver
   explicit Lanelet2MapProviderNode(const rclcpp::NodeOptions & options);
 
-  /// \brief Handles the node service requests
+  /// \brief Waits for the loading of the map to end
+  ~Lanelet2MapProviderNode() override;
+
+  /// \brief Handles the node service requests. The full map is serialized once, and the
+  /// serialized submaps of the last `submap_cache_size` distinct requests are kept. With a
+  /// positive `submap_tile_size`, the requested bounds are extended to multiples of it so that
+  /// nearby requests get the same submap. The map_version of every response is the version of
+  /// the full map, which is also published on the transient local topic `had_map_version`.
   /// \param request Service request message for map data specifying map content and geom. bounds
   /// \param response Service repsone to request, containing a sub-set of map data
   /// but nethertheless containing a complete and valid lanelet2 map
@@ -65,8 +81,27 @@ private:
   /// \return The map origin in ECEF ENU transform
   geometry_msgs::msg::TransformStamped get_map_origin();
 
+  /// Requested primitives and x, y of the lower and upper bounds of a submap
+  using SubmapKey = std::pair<std::vector<uint8_t>, std::array<float64_t, 4U>>;
+
+  common::startup_tracking::StartupTracker m_startup_tracker;
+  common::startup_tracking::StartupGate m_startup_gate;
   std::unique_ptr<Lanelet2MapProvider> m_map_provider;
+  /// The line strings of the map by subtype, for the submaps
+  std::unique_ptr<const common::had_map_utils::SubtypeIndex> m_subtypes;
   rclcpp::Service<autoware_auto_msgs::srv::HADMapService>::SharedPtr m_map_service;
+  /// Tells the clients which map the service provides, so that they can keep their maps until
+  /// it changes
+  rclcpp::Publisher<std_msgs::msg::String>::SharedPtr m_map_version_pub;
+  /// The serialized full map
+  autoware_auto_msgs::msg::HADMapBin m_full_map_bin;
+  /// Serialized submaps by request, and their keys from the oldest to the newest
+  std::map<SubmapKey, autoware_auto_msgs::msg::HADMapBin> m_submap_cache;
+  std::deque<SubmapKey> m_submap_cache_order;
+  float64_t m_submap_tile_size;
+  std::size_t m_submap_cache_size;
+  /// Loads the map, the subtypes and the serialized full map in the background
+  std::future<void> m_map_load;
 };
 
 }  // namespace lanelet2_map_provider
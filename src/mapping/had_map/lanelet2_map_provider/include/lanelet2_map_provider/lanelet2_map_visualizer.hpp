@@ -18,8 +18,12 @@
 #define LANELET2_MAP_PROVIDER__LANELET2_MAP_VISUALIZER_HPP_
 
 #include <rclcpp/rclcpp.hpp>
+#include <tf2/buffer_core.h>
+#include <tf2_ros/transform_listener.h>
 #include <common/types.hpp>
+#include <had_map_utils/had_map_visualization.hpp>
 
+#include <set>
 #include <string>
 #include <memory>
 
@@ -31,7 +35,9 @@ namespace lanelet2_map_provider
 {
 
 /// \class Lanelet2MapVisualizaer
-/// \brief ROS 2 Node for visualization of lanelet2 semantic map.
+/// \brief ROS 2 Node for visualization of lanelet2 semantic map. The markers are generated once
+///        per map tile, and only the tiles within `visible_radius` of the `follow_frame` are
+///        published, so that large maps don't need one huge marker array.
 
 class LANELET2_MAP_PROVIDER_PUBLIC Lanelet2MapVisualizer : public rclcpp::Node
 {
@@ -42,9 +48,22 @@ public:
 private:
   rclcpp::Client<autoware_auto_msgs::srv::HADMapService>::SharedPtr m_client;
   rclcpp::Publisher<visualization_msgs::msg::MarkerArray>::SharedPtr m_viz_pub;
+  rclcpp::TimerBase::SharedPtr m_timer;
+  tf2::BufferCore m_tf_buffer;
+  tf2_ros::TransformListener m_tf_listener;
+
+  common::types::float64_t m_tile_size;
+  common::types::float64_t m_visible_radius;
+  std::string m_follow_frame;
+  std::unique_ptr<common::had_map_utils::MapMarkerTiles> m_tiles;
+  std::set<common::had_map_utils::MapTileKey> m_visible_tiles;
+  common::types::bool8_t m_published{false};
 
   void visualize_map_callback(
     rclcpp::Client<autoware_auto_msgs::srv::HADMapService>::SharedFuture response);
+
+  /// \brief publish the markers of the tiles that became visible or hidden since the last call
+  void publish_visible_tiles();
 };
 
 }  // namespace lanelet2_map_provider
@@ -17,6 +17,7 @@
 #include <string>
 
 #include "common/types.hpp"
+#include "had_map_utils/had_map_conversion.hpp"
 #include "had_map_utils/had_map_utils.hpp"
 
 #include "GeographicLib/Geocentric.hpp"
@@ -36,7 +37,7 @@ namespace lanelet2_map_provider
 Lanelet2MapProvider::Lanelet2MapProvider(
   const std::string & map_filename,
   const geometry_msgs::msg::TransformStamped & stf, const float64_t offset_lat,
-  const float64_t offset_lon)
+  const float64_t offset_lon, const std::string & map_cache_filename)
 {
   GeographicLib::Geocentric earth(
     GeographicLib::Constants::WGS84_a(),
@@ -50,28 +51,32 @@ Lanelet2MapProvider::Lanelet2MapProvider(
     stf.transform.translation.y,
     stf.transform.translation.z,
     origin_lat, origin_lon, origin_alt);
-  this->load_map(map_filename, {origin_lat + offset_lat, origin_lon + offset_lon, origin_alt});
+  this->load_map(
+    map_filename, {origin_lat + offset_lat, origin_lon + offset_lon, origin_alt},
+    map_cache_filename);
 }
 
 Lanelet2MapProvider::Lanelet2MapProvider(
   const std::string & map_filename,
   const LatLonAlt map_frame_origin,
-  const float64_t offset_lat, const float64_t offset_lon)
+  const float64_t offset_lat, const float64_t offset_lon,
+  const std::string & map_cache_filename)
 {
   LatLonAlt adjusted_origin{map_frame_origin.lat + offset_lat, map_frame_origin.lon + offset_lon,
     map_frame_origin.alt};
-  this->load_map(map_filename, adjusted_origin);
+  this->load_map(map_filename, adjusted_origin, map_cache_filename);
 }
 
 void Lanelet2MapProvider::load_map(
-  const std::string & map_filename, const LatLonAlt map_frame_origin)
+  const std::string & map_filename, const LatLonAlt map_frame_origin,
+  const std::string & map_cache_filename)
 {
-  lanelet::ErrorMessages errors;
   lanelet::GPSPoint originGps{map_frame_origin.lat, map_frame_origin.lon, map_frame_origin.alt};
   lanelet::Origin origin{originGps};
 
   lanelet::projection::UtmProjector projector(origin);
-  m_map = lanelet::load(map_filename, projector, &errors);
+  m_map = autoware::common::had_map_utils::loadMapWithCache(
+    map_filename, projector, map_cache_filename);
   autoware::common::had_map_utils::overwriteLaneletsCenterline(m_map, true);
 }
 
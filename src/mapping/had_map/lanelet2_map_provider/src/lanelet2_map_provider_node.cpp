@@ -28,9 +28,13 @@
 #include <rclcpp/time_source.hpp>
 #include <rclcpp_components/register_node_macro.hpp>
 #include <common/types.hpp>
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <future>
 #include <string>
 #include <memory>
+#include <stdexcept>
 #include <utility>
 
 #include "autoware_auto_msgs/srv/had_map_service.hpp"
@@ -45,31 +49,82 @@ namespace autoware
 namespace lanelet2_map_provider
 {
 Lanelet2MapProviderNode::Lanelet2MapProviderNode(const rclcpp::NodeOptions & options)
-: Node("Lanelet2MapProvider", options)
+: Node("Lanelet2MapProvider", options),
+  m_startup_tracker{*this},
+  m_startup_gate{*this, m_startup_tracker}
 {
   const std::string map_filename = declare_parameter("map_osm_file").get<std::string>();
   const float64_t origin_offset_lat = declare_parameter("origin_offset_lat", 0.0);
   const float64_t origin_offset_lon = declare_parameter("origin_offset_lon", 0.0);
-  if (has_parameter("latitude") && has_parameter("longitude") && has_parameter("elevation")) {
-    const float64_t origin_lat = declare_parameter("latitude").get<float64_t>();
-    const float64_t origin_lon = declare_parameter("longitude").get<float64_t>();
-    const float64_t origin_alt = declare_parameter("elevation").get<float64_t>();
-    LatLonAlt map_origin{origin_lat, origin_lon, origin_alt};
-    m_map_provider = std::make_unique<Lanelet2MapProvider>(
-      map_filename, map_origin, origin_offset_lat, origin_offset_lon);
-  } else {
-    /// This could potentially also read the same yaml that the ndt map publisher reads
-    auto earth_from_map = get_map_origin();
-    m_map_provider = std::make_unique<Lanelet2MapProvider>(
-      map_filename, std::move(
-        earth_from_map), origin_offset_lat, origin_offset_lon);
+  const std::string map_cache_filename = declare_parameter("map_cache_file", std::string{});
+  const bool8_t has_origin =
+    has_parameter("latitude") && has_parameter("longitude") && has_parameter("elevation");
+  LatLonAlt map_origin{0.0, 0.0, 0.0};
+  if (has_origin) {
+    map_origin = LatLonAlt{
+      declare_parameter("latitude").get<float64_t>(),
+      declare_parameter("longitude").get<float64_t>(),
+      declare_parameter("elevation").get<float64_t>()};
   }
 
-  m_map_service =
-    this->create_service<autoware_auto_msgs::srv::HADMapService>(
-    "HAD_Map_Service", std::bind(
-      &Lanelet2MapProviderNode::handle_request, this,
-      std::placeholders::_1, std::placeholders::_2));
+  m_submap_tile_size = declare_parameter("submap_tile_size", 0.0);
+  if (m_submap_tile_size < 0.0) {
+    throw std::domain_error("submap_tile_size must not be negative");
+  }
+  m_submap_cache_size =
+    static_cast<std::size_t>(std::max(declare_parameter("submap_cache_size", 16), 0));
+
+  // Loading and serializing a large map takes seconds, so it is done in the background while
+  // the executor spins the other nodes of the process. The map members are only used by the
+  // service, which is created once they are complete.
+  m_map_load = std::async(
+    std::launch::async, [ = ]() {
+      if (has_origin) {
+        m_map_provider = std::make_unique<Lanelet2MapProvider>(
+          map_filename, map_origin, origin_offset_lat, origin_offset_lon, map_cache_filename);
+      } else {
+        /// This could potentially also read the same yaml that the ndt map publisher reads
+        auto earth_from_map = get_map_origin();
+        m_startup_tracker.phase_done("map_origin");
+        m_map_provider = std::make_unique<Lanelet2MapProvider>(
+          map_filename, std::move(
+            earth_from_map), origin_offset_lat, origin_offset_lon, map_cache_filename);
+      }
+      m_startup_tracker.phase_done("load_map");
+      m_subtypes =
+        std::make_unique<const common::had_map_utils::SubtypeIndex>(m_map_provider->m_map);
+      // The map does not change, so it is serialized and versioned only once
+      m_full_map_bin.header.frame_id = "map";
+      autoware::common::had_map_utils::toBinaryMsg(m_map_provider->m_map, m_full_map_bin);
+      m_full_map_bin.map_version =
+        autoware::common::had_map_utils::binaryMsgVersion(m_full_map_bin);
+    });
+
+  m_startup_gate.require("map", common::startup_tracking::future_ready(m_map_load));
+  m_startup_gate.open_when_ready(
+    [this]() {
+      // Rethrows the errors of the loading
+      m_map_load.get();
+      m_map_service =
+      this->create_service<autoware_auto_msgs::srv::HADMapService>(
+        "HAD_Map_Service", std::bind(
+          &Lanelet2MapProviderNode::handle_request, this,
+          std::placeholders::_1, std::placeholders::_2));
+
+      m_map_version_pub = this->create_publisher<std_msgs::msg::String>(
+        "had_map_version", rclcpp::QoS{1U}.transient_local());
+      std_msgs::msg::String version_msg;
+      version_msg.data = m_full_map_bin.map_version;
+      m_map_version_pub->publish(version_msg);
+    });
+}
+
+Lanelet2MapProviderNode::~Lanelet2MapProviderNode()
+{
+  // The loading uses the members, so it has to end before they are destroyed
+  if (m_map_load.valid()) {
+    m_map_load.wait();
+  }
 }
 
 geometry_msgs::msg::TransformStamped Lanelet2MapProviderNode::get_map_origin()
@@ -108,21 +163,13 @@ void Lanelet2MapProviderNode::handle_request(
   std::shared_ptr<autoware_auto_msgs::srv::HADMapService_Request> request,
   std::shared_ptr<autoware_auto_msgs::srv::HADMapService_Response> response)
 {
-  autoware_auto_msgs::msg::HADMapBin msg;
-  msg.header.frame_id = "map";
-
-  // TODO(simon) add map version and format information to message header
-  // msg.format_version = format_version;
-  // msg.map_version = map_version;
-
   auto primitive_sequence = request->requested_primitives;
 
   // special case where we send existing map as is
   if (primitive_sequence.size() == 1 && *(primitive_sequence.begin()) ==
     autoware_auto_msgs::srv::HADMapService_Request::FULL_MAP)
   {
-    autoware::common::had_map_utils::toBinaryMsg(m_map_provider->m_map, msg);
-    response->map = msg;
+    response->map = m_full_map_bin;
     return;
   }
 
@@ -131,6 +178,32 @@ void Lanelet2MapProviderNode::handle_request(
   auto lower_bound = request->geom_lower_bound;
   bool8_t geom_bound_requested = (upper_bound.size() == 3) && (lower_bound.size() == 3);
 
+  SubmapKey key{primitive_sequence, {0.0, 0.0, 0.0, 0.0}};
+  if (geom_bound_requested) {
+    // Snap the bounds outward to the tiles, so that nearby requests share a submap
+    const auto snap = [this](const float64_t value, const bool8_t upper) {
+        if (m_submap_tile_size <= 0.0) {
+          return value;
+        }
+        const float64_t tile = value / m_submap_tile_size;
+        return (upper ? std::ceil(tile) : std::floor(tile)) * m_submap_tile_size;
+      };
+    key.second = {snap(lower_bound[0], false), snap(lower_bound[1], false),
+      snap(upper_bound[0], true), snap(upper_bound[1], true)};
+  }
+  const auto cached_it = m_submap_cache.find(key);
+  if (cached_it != m_submap_cache.end()) {
+    response->map = cached_it->second;
+    return;
+  }
+
+  autoware_auto_msgs::msg::HADMapBin msg;
+  msg.header.frame_id = "map";
+
+  // TODO(simon) add map version and format information to message header
+  // msg.format_version = format_version;
+  // msg.map_version = map_version;
+
   lanelet::LaneletMapPtr requested_map;
   lanelet::Lanelets requested_lanelets;
   lanelet::Areas requested_areas;
@@ -139,46 +212,30 @@ void Lanelet2MapProviderNode::handle_request(
 
   if (geom_bound_requested) {
     geom_bbox = lanelet::BoundingBox2d(
-      lanelet::BasicPoint2d(lower_bound[0], lower_bound[1]),
-      lanelet::BasicPoint2d(upper_bound[0], upper_bound[1]));
+      lanelet::BasicPoint2d(key.second[0U], key.second[1U]),
+      lanelet::BasicPoint2d(key.second[2U], key.second[3U]));
   }
 
   for (auto primitive : primitive_sequence) {
     if (primitive == autoware_auto_msgs::srv::HADMapService_Request::DRIVEABLE_GEOMETRY) {
-      lanelet::LineStrings3d linestrings;
-
       if (!geom_bound_requested) {
         requested_lanelets =
           autoware::common::had_map_utils::getLaneletLayer(m_map_provider->m_map);
         requested_areas = autoware::common::had_map_utils::getAreaLayer(m_map_provider->m_map);
-        linestrings = autoware::common::had_map_utils::getLineStringLayer(
-          m_map_provider->m_map);
       } else {
         requested_lanelets = m_map_provider->m_map->laneletLayer.search(geom_bbox);
         requested_areas = m_map_provider->m_map->areaLayer.search(geom_bbox);
-        linestrings = m_map_provider->m_map->lineStringLayer.search(geom_bbox);
       }
-      lanelet::LineStrings3d parking_linestrings =
-        autoware::common::had_map_utils::subtypeLineStrings(
-        linestrings, "parking_spot");
-      lanelet::LineStrings3d parking_access_linestrings =
-        autoware::common::had_map_utils::subtypeLineStrings(
-        linestrings, "parking_access");
-      lanelet::LineStrings3d pickup_dropoff_linestrings =
-        autoware::common::had_map_utils::subtypeLineStrings(
-        linestrings, "parking_spot,drop_off,pick_up");
-      requested_linestrings.insert(
-        requested_linestrings.end(),
-        parking_linestrings.begin(),
-        parking_linestrings.end());
-      requested_linestrings.insert(
-        requested_linestrings.end(),
-        parking_access_linestrings.begin(),
-        parking_access_linestrings.end());
-      requested_linestrings.insert(
-        requested_linestrings.end(),
-        pickup_dropoff_linestrings.begin(),
-        pickup_dropoff_linestrings.end());
+      for (const char * const subtype :
+        {"parking_spot", "parking_access", "parking_spot,drop_off,pick_up"})
+      {
+        const lanelet::LineStrings3d subtype_linestrings = geom_bound_requested ?
+          m_subtypes->lineStrings(subtype, geom_bbox) : m_subtypes->lineStrings(subtype);
+        requested_linestrings.insert(
+          requested_linestrings.end(),
+          subtype_linestrings.begin(),
+          subtype_linestrings.end());
+      }
     }
   }
   requested_map = lanelet::utils::createMap({requested_lanelets}, {requested_areas});
@@ -186,7 +243,19 @@ void Lanelet2MapProviderNode::handle_request(
     requested_map->add(*i);
   }
   autoware::common::had_map_utils::toBinaryMsg(requested_map, msg);
+  // The version of the whole map, a client can't compare the versions of different submaps
+  msg.map_version = m_full_map_bin.map_version;
   response->map = msg;
+
+  if (m_submap_cache_size > 0U) {
+    if (m_submap_cache_order.size() >= m_submap_cache_size) {
+      // Evict the oldest submap
+      (void)m_submap_cache.erase(m_submap_cache_order.front());
+      m_submap_cache_order.pop_front();
+    }
+    (void)m_submap_cache.emplace(key, std::move(msg));
+    m_submap_cache_order.push_back(key);
+  }
 }
 
 }  // namespace lanelet2_map_provider
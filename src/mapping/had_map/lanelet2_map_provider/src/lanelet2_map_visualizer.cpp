@@ -23,8 +23,13 @@
 #include <geometry_msgs/msg/point.hpp>
 #include <common/types.hpp>
 
+#include <tf2/exceptions.h>
+
 #include <chrono>
 #include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
 #include <unordered_set>
 
 #include "lanelet2_map_provider/lanelet2_map_provider.hpp"
@@ -46,15 +51,6 @@ namespace autoware
 {
 namespace lanelet2_map_provider
 {
-void insertMarkerArray(
-  visualization_msgs::msg::MarkerArray & a1,
-  const visualization_msgs::msg::MarkerArray & a2)
-{
-  if (a2.markers.size() > 0) {
-    a1.markers.insert(a1.markers.end(), a2.markers.begin(), a2.markers.end());
-  }
-}
-
 void Lanelet2MapVisualizer::visualize_map_callback(
   rclcpp::Client<autoware_auto_msgs::srv::HADMapService>::SharedFuture response)
 {
@@ -86,19 +82,10 @@ void Lanelet2MapVisualizer::visualize_map_callback(
   autoware::common::had_map_utils::setColor(
     &color_pickup_dropoff, 0.9f, 0.2f, 0.1f, 0.7f);
 
-  visualization_msgs::msg::MarkerArray map_marker_array;
-
-  rclcpp::Time marker_t = rclcpp::Time(0);
-  insertMarkerArray(
-    map_marker_array,
-    autoware::common::had_map_utils::laneletsBoundaryAsMarkerArray(
-      marker_t, lls,
-      color_lane_bounds, true));
-  insertMarkerArray(
-    map_marker_array,
-    autoware::common::had_map_utils::laneletsAsTriangleMarkerArray(
-      marker_t,
-      "lanelet_triangles", lls, color_lanelets));
+  // The markers of the whole map are generated once, then only their tiles get published
+  auto tiles = std::make_unique<autoware::common::had_map_utils::MapMarkerTiles>(m_tile_size);
+  tiles->addLaneletsBoundary(lls, color_lane_bounds, true);
+  tiles->addLaneletsTriangles("lanelet_triangles", lls, color_lanelets);
 
   // for parking spots defined as areas (LaneletOSM definition)
   auto ll_areas = autoware::common::had_map_utils::getAreaLayer(sub_map);
@@ -107,33 +94,69 @@ void Lanelet2MapVisualizer::visualize_map_callback(
     ll_areas,
     "parking_access");
 
-  insertMarkerArray(
-    map_marker_array,
-    autoware::common::had_map_utils::areasBoundaryAsMarkerArray(
-      marker_t, "parking_area_bounds",
-      ll_parking_areas, color_parking_bounds));
-  insertMarkerArray(
-    map_marker_array,
-    autoware::common::had_map_utils::areasBoundaryAsMarkerArray(
-      marker_t, "parking_access_area_bounds",
-      ll_parking_access_areas, color_parking_bounds));
-  insertMarkerArray(
-    map_marker_array,
-    autoware::common::had_map_utils::areasAsTriangleMarkerArray(
-      marker_t, "parking_area_triangles",
-      ll_parking_areas, color_parking));
-  insertMarkerArray(
-    map_marker_array,
-    autoware::common::had_map_utils::areasAsTriangleMarkerArray(
-      marker_t, "parking_access_area_triangles",
-      ll_parking_access_areas, color_parking_access));
-
-  m_viz_pub->publish(map_marker_array);
+  tiles->addAreasBoundary("parking_area_bounds", ll_parking_areas, color_parking_bounds);
+  tiles->addAreasBoundary(
+    "parking_access_area_bounds", ll_parking_access_areas, color_parking_bounds);
+  tiles->addAreasTriangles("parking_area_triangles", ll_parking_areas, color_parking);
+  tiles->addAreasTriangles(
+    "parking_access_area_triangles", ll_parking_access_areas, color_parking_access);
+
+  m_tiles = std::move(tiles);
+  m_visible_tiles.clear();
+  m_published = false;
+  publish_visible_tiles();
+}
+
+void Lanelet2MapVisualizer::publish_visible_tiles()
+{
+  if (!m_tiles) {
+    return;
+  }
+
+  std::set<autoware::common::had_map_utils::MapTileKey> visible;
+  bool8_t found_position = false;
+  if ((m_visible_radius > 0.0) && !m_follow_frame.empty()) {
+    try {
+      const auto tf = m_tf_buffer.lookupTransform("map", m_follow_frame, tf2::TimePointZero);
+      visible = m_tiles->tilesNear(
+        tf.transform.translation.x, tf.transform.translation.y, m_visible_radius);
+      found_position = true;
+    } catch (const tf2::TransformException &) {
+      RCLCPP_INFO_ONCE(
+        this->get_logger(), "No transform from map to %s yet, showing the whole map",
+        m_follow_frame.c_str());
+    }
+  }
+  if (!found_position) {
+    visible = m_tiles->tilesNear(0.0, 0.0, 0.0);
+  }
+
+  if (m_published && (visible == m_visible_tiles)) {
+    return;
+  }
+  m_viz_pub->publish(m_tiles->markersFor(visible, m_visible_tiles));
+  m_visible_tiles = visible;
+  m_published = true;
 }
 
 Lanelet2MapVisualizer::Lanelet2MapVisualizer(const rclcpp::NodeOptions & options)
-: Node("lanelet2_map_visualizer", options)
+: Node("lanelet2_map_visualizer", options),
+  m_tf_listener(m_tf_buffer, std::shared_ptr<rclcpp::Node>(this, [](auto) {}), false)
 {
+  m_tile_size = declare_parameter("tile_size", 100.0);
+  m_visible_radius = declare_parameter("visible_radius", 300.0);
+  m_follow_frame = declare_parameter("follow_frame", std::string{"base_link"});
+  const auto update_period_ms = declare_parameter("update_period_ms", 500);
+  if ((m_tile_size < 0.0) || (m_visible_radius < 0.0)) {
+    throw std::domain_error("tile_size and visible_radius must not be negative");
+  }
+  if (update_period_ms <= 0) {
+    throw std::domain_error("update_period_ms must be positive");
+  }
+  m_timer = this->create_wall_timer(
+    std::chrono::milliseconds(update_period_ms),
+    std::bind(&Lanelet2MapVisualizer::publish_visible_tiles, this));
+
   m_client =
     this->create_client<autoware_auto_msgs::srv::HADMapService>("HAD_Map_Service");
 
@@ -0,0 +1,42 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+/// \file
+/// \brief This file defines the localizer types shared by the mapper and its pose graph back end
+
+#ifndef NDT_MAPPING_NODES__LOCALIZER_TYPES_HPP_
+#define NDT_MAPPING_NODES__LOCALIZER_TYPES_HPP_
+
+#include <ndt/ndt_localizer.hpp>
+#include <optimization/newtons_method_optimizer.hpp>
+#include <optimization/line_search/more_thuente_line_search.hpp>
+
+namespace autoware
+{
+namespace mapping
+{
+namespace ndt_mapping_nodes
+{
+using Optimizer = common::optimization::NewtonsMethodOptimizer<
+  common::optimization::MoreThuenteLineSearch>;
+using NDTMap = localization::ndt::DynamicNDTMap;
+using Localizer = localization::ndt::P2DNDTLocalizer<Optimizer, NDTMap>;
+using P2DNDTConfig = localization::ndt::P2DNDTLocalizerConfig;
+}  // namespace ndt_mapping_nodes
+}  // namespace mapping
+}  // namespace autoware
+
+#endif  // NDT_MAPPING_NODES__LOCALIZER_TYPES_HPP_
@@ -0,0 +1,172 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+/// \file
+/// \brief This file defines the offline batch ndt mapper and its processing pipeline
+
+#ifndef NDT_MAPPING_NODES__NDT_BATCH_MAPPER_HPP_
+#define NDT_MAPPING_NODES__NDT_BATCH_MAPPER_HPP_
+
+#include <ndt_mapping_nodes/ndt_mapping_nodes.hpp>
+#include <ndt_mapping_nodes/visibility_control.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace autoware
+{
+namespace mapping
+{
+namespace ndt_mapping_nodes
+{
+
+/// \brief Blocking queue of bounded size between two stages of the batch mapping pipeline.
+/// \tparam T Type of the elements.
+template<typename T>
+class BoundedQueue
+{
+public:
+  /// \brief Constructor
+  /// \param capacity Maximum number of elements in the queue, at least 1.
+  explicit BoundedQueue(const std::size_t capacity)
+  : m_capacity{std::max(capacity, static_cast<std::size_t>(1U))} {}
+
+  /// \brief Push an element, waiting while the queue is full.
+  /// \param value Element to push.
+  /// \return False if the queue was closed, the element is then dropped.
+  bool8_t push(T && value)
+  {
+    std::unique_lock<std::mutex> lock{m_mutex};
+    m_not_full.wait(lock, [this]() {return m_closed || (m_queue.size() < m_capacity);});
+    if (m_closed) {
+      return false;
+    }
+    m_queue.emplace_back(std::forward<T>(value));
+    lock.unlock();
+    m_not_empty.notify_one();
+    return true;
+  }
+
+  /// \brief Pop an element, waiting while the queue is empty.
+  /// \param value Popped element.
+  /// \return False if the queue is closed and empty.
+  bool8_t pop(T & value)
+  {
+    std::unique_lock<std::mutex> lock{m_mutex};
+    m_not_empty.wait(lock, [this]() {return m_closed || !m_queue.empty();});
+    if (m_queue.empty()) {
+      return false;
+    }
+    value = std::move(m_queue.front());
+    m_queue.pop_front();
+    lock.unlock();
+    m_not_full.notify_one();
+    return true;
+  }
+
+  /// \brief Close the queue. Pushing fails from now on, popping fails once the queue is empty.
+  void close()
+  {
+    {
+      std::lock_guard<std::mutex> lock{m_mutex};
+      m_closed = true;
+    }
+    m_not_empty.notify_all();
+    m_not_full.notify_all();
+  }
+
+private:
+  std::size_t m_capacity;
+  std::deque<T> m_queue;
+  bool8_t m_closed{false};
+  std::mutex m_mutex;
+  std::condition_variable m_not_empty;
+  std::condition_variable m_not_full;
+};
+
+/// \brief Mapper registering a recorded sequence of scans into a `DualVoxelMap`, the same way as
+/// `P2DNDTVoxelMapperNode` but without waiting for the scans to arrive in real time. The map is
+/// never cleared so that the result is one map of the whole sequence.
+class NDT_MAPPING_NODES_PUBLIC NDTBatchMapper
+{
+public:
+  using Cloud = sensor_msgs::msg::PointCloud2;
+
+  /// \brief Constructor
+  /// \param localizer Localizer registering the scans.
+  /// \param map Map the registered scans are inserted into.
+  /// \param localizer_map_config Voxel grid configuration of the ndt map written by `write()`.
+  NDTBatchMapper(
+    std::unique_ptr<Localizer> localizer,
+    std::unique_ptr<VoxelMap> map,
+    const NDTMap::Config & localizer_map_config);
+
+  /// \brief Register a scan against the map and insert it into the map. The first scan is
+  /// inserted at the origin of the map.
+  /// \param scan Scan to add, in the sensor frame.
+  /// \return False if the scan couldn't be registered, it is then not inserted.
+  bool8_t add_scan(const Cloud & scan);
+
+  /// \brief Write the map as a `.pcd` point cloud and as a `.ndtmap` binary ndt map that can be
+  /// loaded into a `StaticNDTMap`.
+  /// \param file_name_prefix File name prefix of both files.
+  void write(const std::string & file_name_prefix) const;
+
+  /// \brief Number of scans inserted into the map.
+  std::size_t num_registered_scans() const noexcept;
+
+  /// Get the map.
+  const VoxelMap & map() const noexcept;
+
+private:
+  std::unique_ptr<Localizer> m_localizer;
+  std::unique_ptr<VoxelMap> m_map;
+  NDTMap::Config m_localizer_map_config;
+  geometry_msgs::msg::TransformStamped m_previous_transform;
+  Cloud m_increment;
+  std::size_t m_num_registered_scans{0U};
+};
+
+/// \brief Run the batch mapping pipeline. Reading, downsampling and registering the scans run
+/// in three threads connected by bounded queues, so that reading and downsampling the next
+/// scans overlap with the registration, which is sequential. An exception thrown by a stage
+/// stops the pipeline and is rethrown from this function.
+/// \param read_scan Read the next scan, nullptr at the end of the input. Called from the reader
+/// thread.
+/// \param downsample Downsample a scan, called from the preprocessing thread.
+/// \param mapper Mapper the scans are added to in order, from the calling thread.
+/// \param queue_size Maximum number of scans waiting between two stages.
+/// \return Number of scans read.
+NDT_MAPPING_NODES_PUBLIC std::size_t run_batch_mapping(
+  const std::function<std::unique_ptr<sensor_msgs::msg::PointCloud2>()> & read_scan,
+  const std::function<std::unique_ptr<sensor_msgs::msg::PointCloud2>(
+    const sensor_msgs::msg::PointCloud2 &)> & downsample,
+  NDTBatchMapper & mapper,
+  const std::size_t queue_size);
+
+}  // namespace ndt_mapping_nodes
+}  // namespace mapping
+}  // namespace autoware
+
+#endif  // NDT_MAPPING_NODES__NDT_BATCH_MAPPER_HPP_
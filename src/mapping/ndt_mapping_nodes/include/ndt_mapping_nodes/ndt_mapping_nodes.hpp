@@ -21,18 +21,23 @@
 #define NDT_MAPPING_NODES__NDT_MAPPING_NODES_HPP_
 
 #include <ndt_mapping_nodes/visibility_control.hpp>
+#include <ndt_mapping_nodes/localizer_types.hpp>
+#include <ndt_mapping_nodes/pose_graph_backend.hpp>
 #include <sensor_msgs/msg/point_cloud2.hpp>
 #include <point_cloud_mapping/point_cloud_map.hpp>
 #include <point_cloud_mapping/policies.hpp>
-#include <ndt/ndt_localizer.hpp>
-#include <optimization/newtons_method_optimizer.hpp>
-#include <optimization/line_search/more_thuente_line_search.hpp>
 #include <helper_functions/float_comparisons.hpp>
 #include <tf2_msgs/msg/tf_message.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <string>
 #include <limits>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <utility>
 
 namespace autoware
@@ -41,12 +46,7 @@ namespace mapping
 {
 namespace ndt_mapping_nodes
 {
-using Optimizer = common::optimization::NewtonsMethodOptimizer<
-  common::optimization::MoreThuenteLineSearch>;
-using NDTMap = localization::ndt::DynamicNDTMap;
 using VoxelMap = point_cloud_mapping::DualVoxelMap<NDTMap>;
-using Localizer = localization::ndt::P2DNDTLocalizer<Optimizer, NDTMap>;
-using P2DNDTConfig = localization::ndt::P2DNDTLocalizerConfig;
 using WritePolicy = mapping::point_cloud_mapping::CapacityTrigger;
 using ClearPolicy = mapping::point_cloud_mapping::CapacityTrigger;
 using PrefixPolicy = mapping::point_cloud_mapping::TimeStampPrefixGenerator;
@@ -66,6 +66,7 @@ public:
   using Cloud = sensor_msgs::msg::PointCloud2;
   using RegistrationSummary = localization::localization_common::OptimizedRegistrationSummary;
   using PointXYZI = common::types::PointXYZI;
+  using PclCloud = pcl::PointCloud<pcl::PointXYZI>;
   // Static asserts to make sure the policies are valid
   static_assert(
     std::is_base_of<mapping::point_cloud_mapping::TriggerPolicyBase<WriteTriggerPolicyT>,
@@ -104,6 +105,15 @@ public:
 
   ~P2DNDTVoxelMapperNode()
   {
+    if (m_writer_thread.joinable()) {
+      // The writer thread finishes the queued writes before exiting
+      {
+        std::lock_guard<std::mutex> lock{m_writer_mutex};
+        m_writer_stop = true;
+      }
+      m_writer_cv.notify_one();
+      m_writer_thread.join();
+    }
     if (m_map_ptr->size() > 0U) {
       const auto & file_name_prefix = m_prefix_generator.get(m_base_fn_prefix);
       RCLCPP_DEBUG(get_logger(), "The map is written to" + file_name_prefix + ".pcd");
@@ -157,24 +167,39 @@ private:
       this->declare_parameter("localizer.optimizer.gradient_tolerance").template get<float64_t>()
     };
 
-    m_localizer_ptr = std::make_unique<Localizer>(
-      localizer_config,
-      Optimizer{
-            common::optimization::MoreThuenteLineSearch{
-              static_cast<float32_t>(this->declare_parameter(
-                "localizer.optimizer.line_search.step_max")
-              .template get<float32_t>()),
-              static_cast<float32_t>(this->declare_parameter(
-                "localizer.optimizer.line_search.step_min")
-              .template get<float32_t>()),
-              common::optimization::MoreThuenteLineSearch::OptimizationDirection::kMaximization
-            },
-            optimization_options},
-      outlier_ratio);
+    const common::optimization::MoreThuenteLineSearch line_search{
+      static_cast<float32_t>(this->declare_parameter(
+        "localizer.optimizer.line_search.step_max")
+      .template get<float32_t>()),
+      static_cast<float32_t>(this->declare_parameter(
+        "localizer.optimizer.line_search.step_min")
+      .template get<float32_t>()),
+      common::optimization::MoreThuenteLineSearch::OptimizationDirection::kMaximization
+    };
+    const auto make_localizer = [&localizer_config, &line_search, &optimization_options,
+        outlier_ratio]() {
+        return std::make_unique<Localizer>(
+          localizer_config, Optimizer{line_search, optimization_options}, outlier_ratio);
+      };
+    m_localizer_ptr = make_localizer();
     const auto & map_frame_id = this->declare_parameter("map.frame_id").template get<std::string>();
+    // The map is only tiled if a tile size is given
+    point_cloud_mapping::TilingConfig tiling_config;
+    tiling_config.tile_size = static_cast<float32_t>(
+      this->declare_parameter("map.tile_size", 0.0));
+    tiling_config.active_radius = static_cast<uint32_t>(
+      std::max(this->declare_parameter("map.active_tile_radius", 1), 0));
+    tiling_config.directory = this->declare_parameter("map.tile_directory", std::string{"."});
+    // The localizer map forgets old observations only if a maximum age or count is given
+    NDTMap::Forgetting forgetting;
+    forgetting.max_voxel_age = std::chrono::milliseconds{
+      std::max(this->declare_parameter("localizer.map.max_voxel_age_ms", 0), 0)};
+    forgetting.max_points_per_voxel = static_cast<uint64_t>(
+      std::max(this->declare_parameter("localizer.map.max_points_per_voxel", 0), 0));
     m_map_ptr = std::make_unique<VoxelMap>(
       parse_grid_config("map"), map_frame_id,
-      NDTMap{parse_grid_config("localizer.map")});
+      NDTMap{parse_grid_config("localizer.map"), localization::ndt::CellLookupMode::SINGLE,
+        forgetting}, tiling_config);
 
     if (this->declare_parameter("publish_map_increment").template get<bool8_t>()) {
       m_increment_publisher = this->template create_publisher<sensor_msgs::msg::PointCloud2>(
@@ -190,6 +215,32 @@ private:
         rclcpp::QoS{rclcpp::KeepLast{m_pose_publisher->get_queue_size()}});
     }
 
+    // The pose graph back end closes loops with its own localizer on a worker thread
+    if (declare_parameter("pose_graph.enabled", false)) {
+      PoseGraphConfig pose_graph_config;
+      pose_graph_config.keyframe_distance = declare_parameter(
+        "pose_graph.keyframe_distance", pose_graph_config.keyframe_distance);
+      pose_graph_config.loop_search_radius = declare_parameter(
+        "pose_graph.loop_search_radius", pose_graph_config.loop_search_radius);
+      pose_graph_config.min_loop_keyframe_gap = static_cast<std::size_t>(std::max(
+          declare_parameter("pose_graph.min_loop_keyframe_gap", 30), 1));
+      pose_graph_config.min_loop_closure_interval = static_cast<std::size_t>(std::max(
+          declare_parameter("pose_graph.min_loop_closure_interval", 10), 0));
+      pose_graph_config.num_loop_map_keyframes = static_cast<std::size_t>(std::max(
+          declare_parameter("pose_graph.num_loop_map_keyframes", 5), 0));
+      pose_graph_config.max_loop_correction = declare_parameter(
+        "pose_graph.max_loop_correction", pose_graph_config.max_loop_correction);
+      pose_graph_config.max_iterations = static_cast<std::size_t>(std::max(
+          declare_parameter("pose_graph.max_iterations", 10), 1));
+      m_pose_graph = std::make_unique<PoseGraphBackend>(
+        pose_graph_config, make_localizer(), parse_grid_config("localizer.map"));
+    }
+
+    // Write the maps from a background thread so that the registration doesn't wait for them
+    if (declare_parameter("async_write", true)) {
+      m_writer_thread = std::thread{[this]() {writer_loop();}};
+    }
+
     m_previous_transform.transform.rotation.set__w(1.0);
     m_previous_transform.header.frame_id = m_map_ptr->frame_id();
     point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI> msg_initializer{m_cached_increment,
@@ -218,6 +269,10 @@ private:
         RCLCPP_WARN(get_logger(), "Invalid pose estimate. The result is ignored.");
         return;
       }
+      if (m_pose_graph) {
+        (void)m_pose_graph->add_scan(pose_out, *msg_ptr);
+        apply_pose_graph_correction(pose_out);
+      }
       // Transform the measurement into the map frame and insert it into the map.
       const auto & increment = get_map_increment(*msg_ptr, pose_out);
       m_pose_publisher->publish(pose_out);
@@ -230,14 +285,30 @@ private:
       }
       if (m_write_trigger.ready(*m_map_ptr)) {
         const auto & file_name_prefix = m_prefix_generator.get(m_base_fn_prefix);
-        m_map_ptr->write(file_name_prefix);
-        RCLCPP_DEBUG(get_logger(), "The map is written to" + file_name_prefix + ".pcd");
+        if (m_writer_thread.joinable()) {
+          // Copying the map is much faster than writing it, the copy is written in the background
+          auto snapshot = std::make_unique<PclCloud>(m_map_ptr->snapshot());
+          {
+            std::lock_guard<std::mutex> lock{m_writer_mutex};
+            m_write_queue.emplace_back(file_name_prefix, std::move(snapshot));
+          }
+          m_writer_cv.notify_one();
+        } else {
+          m_map_ptr->write(file_name_prefix);
+          RCLCPP_DEBUG(get_logger(), "The map is written to" + file_name_prefix + ".pcd");
+        }
       }
       if (m_clear_trigger.ready(*m_map_ptr)) {
         RCLCPP_DEBUG(get_logger(), "The map is cleared.");
         m_map_ptr->clear();
       }
 
+      // Keep the tiles around the vehicle in memory, this rebuilds the localizer map if tiles
+      // were stored or read back.
+      if (m_map_ptr->set_position(pose_out.pose.pose.position.x, pose_out.pose.pose.position.y)) {
+        RCLCPP_DEBUG(get_logger(), "Map tiles were stored or read back.");
+      }
+
       // Update the map after a possible clearance and not before so that the map is never fully
       // empty.
       m_map_ptr->update(increment);
@@ -247,6 +318,53 @@ private:
     }
   }
 
+  /// Write the queued map snapshots until the node is destroyed.
+  void writer_loop()
+  {
+    std::unique_lock<std::mutex> lock{m_writer_mutex};
+    while (true) {
+      m_writer_cv.wait(lock, [this]() {return m_writer_stop || !m_write_queue.empty();});
+      if (m_write_queue.empty()) {
+        // Stopped and nothing is left to write
+        return;
+      }
+      auto write_request = std::move(m_write_queue.front());
+      m_write_queue.pop_front();
+      lock.unlock();
+      try {
+        VoxelMap::write(*write_request.second, write_request.first);
+        RCLCPP_DEBUG(get_logger(), "The map is written to" + write_request.first + ".pcd");
+      } catch (const std::exception & e) {
+        RCLCPP_ERROR(get_logger(), "Failed to write the map: %s", e.what());
+      }
+      lock.lock();
+    }
+  }
+
+  /// If the pose graph was optimized after a loop closure, correct the pose and rebuild the map
+  /// from the optimized keyframes.
+  /// \param pose Registered pose of the current scan, corrected in place.
+  void apply_pose_graph_correction(PoseWithCovarianceStamped & pose)
+  {
+    Pose correction;
+    if (!m_pose_graph->take_optimized_keyframes(m_keyframes, correction)) {
+      return;
+    }
+    pose.pose.pose = to_msg(correction * to_pose(pose.pose.pose));
+    RCLCPP_DEBUG(
+      get_logger(), "Rebuilding the map from %zu optimized keyframes.", m_keyframes.size());
+    m_map_ptr->clear();
+    for (const auto & keyframe : m_keyframes) {
+      PoseWithCovarianceStamped keyframe_pose;
+      keyframe_pose.header.stamp = keyframe.scan->header.stamp;
+      keyframe_pose.header.frame_id = m_map_ptr->frame_id();
+      keyframe_pose.pose.pose = to_msg(keyframe.pose);
+      (void)m_map_ptr->set_position(keyframe_pose.pose.pose.position.x,
+        keyframe_pose.pose.pose.position.y);
+      m_map_ptr->update(get_map_increment(*keyframe.scan, keyframe_pose));
+    }
+  }
+
   bool8_t validate_output(
     const RegistrationSummary & summary)
   {
@@ -364,6 +482,15 @@ private:
   PrefixGeneratorT m_prefix_generator{};
   bool8_t m_map_initialized{false};
   std::string m_base_fn_prefix;
+  // Background writing of the map snapshots, see `writer_loop()`
+  std::mutex m_writer_mutex;
+  std::condition_variable m_writer_cv;
+  std::deque<std::pair<std::string, std::unique_ptr<PclCloud>>> m_write_queue;
+  bool8_t m_writer_stop{false};
+  std::thread m_writer_thread;
+  // Optional loop closing back end, see `apply_pose_graph_correction()`
+  std::unique_ptr<PoseGraphBackend> m_pose_graph;
+  Keyframes m_keyframes;
 };
 
 }  // namespace ndt_mapping_nodes
@@ -0,0 +1,113 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+/// \file
+/// \brief This file defines a pose graph of keyframe poses and its sparse optimization
+
+#ifndef NDT_MAPPING_NODES__POSE_GRAPH_HPP_
+#define NDT_MAPPING_NODES__POSE_GRAPH_HPP_
+
+#include <common/types.hpp>
+#include <ndt_mapping_nodes/visibility_control.hpp>
+#include <Eigen/Geometry>
+#include <Eigen/StdVector>
+
+#include <cstddef>
+#include <vector>
+
+namespace autoware
+{
+namespace mapping
+{
+namespace ndt_mapping_nodes
+{
+using autoware::common::types::float64_t;
+
+using Pose = Eigen::Isometry3d;
+using Matrix6d = Eigen::Matrix<float64_t, 6, 6>;
+using Vector6d = Eigen::Matrix<float64_t, 6, 1>;
+
+/// \brief Relative pose measurement between two nodes of a pose graph
+struct PoseGraphEdge
+{
+  /// Index of the first node.
+  std::size_t from;
+  /// Index of the second node.
+  std::size_t to;
+  /// Measured pose of the second node in the frame of the first node.
+  Pose measurement;
+  /// Information matrix of the measurement, translation first and rotation second.
+  Matrix6d information;
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+using Poses = std::vector<Pose, Eigen::aligned_allocator<Pose>>;
+using PoseGraphEdges = std::vector<PoseGraphEdge, Eigen::aligned_allocator<PoseGraphEdge>>;
+
+/// \brief Graph of poses connected by relative pose measurements. The poses are optimized with
+/// Gauss-Newton iterations on the sparse normal equations, starting from the current poses so
+/// that the graph can be re-optimized incrementally after adding measurements. The first node is
+/// fixed to anchor the graph.
+class NDT_MAPPING_NODES_PUBLIC PoseGraph
+{
+public:
+  /// \brief Add a node.
+  /// \param pose Initial estimate of the pose.
+  /// \return Index of the node.
+  std::size_t add_node(const Pose & pose);
+
+  /// \brief Add a relative pose measurement between two nodes.
+  /// \param edge The measurement.
+  /// \throw std::out_of_range If a node of the edge doesn't exist.
+  void add_edge(const PoseGraphEdge & edge);
+
+  /// \brief Optimize the poses of the nodes.
+  /// \param max_iterations Maximum number of iterations.
+  /// \param step_tolerance The optimization stops when no pose moves more than this.
+  /// \return Number of iterations run.
+  /// \throw std::runtime_error If the normal equations cannot be solved.
+  std::size_t optimize(const std::size_t max_iterations, const float64_t step_tolerance = 1.0e-6);
+
+  /// \brief Residual of an edge for the current poses, translation first and rotation vector
+  /// second.
+  Vector6d residual(const PoseGraphEdge & edge) const;
+
+  /// \brief Sum of the squared residuals of all edges weighted by their information.
+  float64_t error() const;
+
+  /// Get the pose of a node.
+  const Pose & pose(const std::size_t idx) const;
+  /// Set the pose of a node.
+  void set_pose(const std::size_t idx, const Pose & pose);
+  /// Number of nodes.
+  std::size_t num_nodes() const noexcept;
+  /// Get the edges.
+  const PoseGraphEdges & edges() const noexcept;
+
+private:
+  Poses m_poses;
+  PoseGraphEdges m_edges;
+};
+
+/// \brief Apply an increment to a pose, the rotation being given as a rotation vector.
+NDT_MAPPING_NODES_PUBLIC Pose apply_increment(const Pose & pose, const Vector6d & increment);
+
+}  // namespace ndt_mapping_nodes
+}  // namespace mapping
+}  // namespace autoware
+
+#endif  // NDT_MAPPING_NODES__POSE_GRAPH_HPP_
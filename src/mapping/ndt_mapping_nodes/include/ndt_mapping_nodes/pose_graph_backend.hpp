@@ -0,0 +1,181 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+/// \file
+/// \brief This file defines the loop closing pose graph back end of the ndt mapper
+
+#ifndef NDT_MAPPING_NODES__POSE_GRAPH_BACKEND_HPP_
+#define NDT_MAPPING_NODES__POSE_GRAPH_BACKEND_HPP_
+
+#include <ndt_mapping_nodes/localizer_types.hpp>
+#include <ndt_mapping_nodes/pose_graph.hpp>
+#include <ndt_mapping_nodes/visibility_control.hpp>
+#include <boost/geometry.hpp>
+#include <boost/geometry/index/rtree.hpp>
+#include <geometry_msgs/msg/pose.hpp>
+#include <geometry_msgs/msg/pose_with_covariance_stamped.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace autoware
+{
+namespace mapping
+{
+namespace ndt_mapping_nodes
+{
+using autoware::common::types::bool8_t;
+using autoware::common::types::float32_t;
+
+/// \brief Configuration of the pose graph back end
+struct PoseGraphConfig
+{
+  /// Minimum distance in meters between two keyframes.
+  float64_t keyframe_distance{2.0};
+  /// Maximum distance in meters between a keyframe and a revisited keyframe.
+  float64_t loop_search_radius{10.0};
+  /// Minimum number of keyframes between a keyframe and a revisited keyframe.
+  std::size_t min_loop_keyframe_gap{30U};
+  /// Minimum number of keyframes between two loop closures, so that a revisit doesn't close a
+  /// loop at every keyframe.
+  std::size_t min_loop_closure_interval{10U};
+  /// Number of keyframes on each side of the revisited keyframe making the map a keyframe is
+  /// registered against.
+  std::size_t num_loop_map_keyframes{5U};
+  /// Maximum distance in meters between the pose of a keyframe and its registered pose.
+  float64_t max_loop_correction{5.0};
+  /// Maximum number of iterations of the graph optimization after a loop closure.
+  std::size_t max_iterations{10U};
+};
+
+/// \brief Keyframe of the pose graph, a scan in its own frame and its pose in the map frame
+struct Keyframe
+{
+  Pose pose;
+  std::shared_ptr<const sensor_msgs::msg::PointCloud2> scan;
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+using Keyframes = std::vector<Keyframe, Eigen::aligned_allocator<Keyframe>>;
+
+/// \brief Pose graph back end of the mapper. Registered scans far enough from the previous
+/// keyframe become keyframes, connected to the previous keyframe by their relative pose. A
+/// worker thread looks for a previous keyframe near each new keyframe in an R-tree of the
+/// keyframe positions, registers the new keyframe against the map of the keyframes around it
+/// with a `P2DNDTLocalizer`, and adds the result as a loop closure to the graph. The graph is then
+/// optimized, starting from the current poses, and the mapper can take the optimized keyframes
+/// to rebuild its map.
+class NDT_MAPPING_NODES_PUBLIC PoseGraphBackend
+{
+public:
+  using Cloud = sensor_msgs::msg::PointCloud2;
+
+  /// \brief Constructor, starts the worker thread.
+  /// \param config Configuration.
+  /// \param localizer Localizer registering the keyframes at a revisit, used by the worker thread
+  /// only.
+  /// \param loop_map_config Voxel grid configuration of the maps the keyframes are registered
+  /// against.
+  PoseGraphBackend(
+    const PoseGraphConfig & config,
+    std::unique_ptr<Localizer> localizer,
+    const NDTMap::Config & loop_map_config);
+
+  /// \brief Destructor, stops the worker thread. Loop searches that didn't start are dropped.
+  ~PoseGraphBackend();
+
+  PoseGraphBackend(const PoseGraphBackend &) = delete;
+  PoseGraphBackend & operator=(const PoseGraphBackend &) = delete;
+
+  /// \brief Add a registered scan, it is kept as a keyframe if it is far enough from the
+  /// previous keyframe.
+  /// \param pose Registered pose of the scan in the map frame.
+  /// \param scan The scan in the sensor frame.
+  /// \return True if the scan became a keyframe.
+  bool8_t add_scan(const geometry_msgs::msg::PoseWithCovarianceStamped & pose, const Cloud & scan);
+
+  /// \brief Get the keyframes if the graph was optimized since the last call. All the poses given
+  /// by the mapper must then be corrected, i.e. multiplied by the correction from the left, so
+  /// that the following scans are registered in the frame of the optimized graph.
+  /// \param keyframes The keyframes with their optimized poses.
+  /// \param correction Correction of the poses of the mapper.
+  /// \return True if the graph was optimized and the outputs were set.
+  bool8_t take_optimized_keyframes(Keyframes & keyframes, Pose & correction);
+
+  /// \brief Block until the worker thread has processed the keyframes added so far.
+  void wait_until_idle();
+
+  /// \brief Number of keyframes.
+  std::size_t num_keyframes() const;
+
+  /// \brief Number of loop closures added to the graph.
+  std::size_t num_loop_closures() const;
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+private:
+  using IndexPoint = boost::geometry::model::point<float64_t, 3, boost::geometry::cs::cartesian>;
+  using IndexValue = std::pair<IndexPoint, std::size_t>;
+  using Index = boost::geometry::index::rtree<IndexValue, boost::geometry::index::rstar<16>>;
+
+  /// Process the loop searches until the back end is destroyed.
+  void worker_loop();
+  /// Look for a loop closure of the given keyframe and optimize the graph if one is found.
+  void search_loop(const std::size_t keyframe_idx);
+  /// Rebuild the index from the current poses, lock must be held.
+  void rebuild_index();
+
+  PoseGraphConfig m_config;
+  std::unique_ptr<Localizer> m_localizer;
+  NDTMap::Config m_loop_map_config;
+  mutable std::mutex m_mutex;
+  std::condition_variable m_job_cv;
+  std::condition_variable m_idle_cv;
+  std::deque<std::size_t> m_jobs;
+  bool8_t m_busy{false};
+  bool8_t m_stop{false};
+  PoseGraph m_graph;
+  std::vector<std::shared_ptr<const Cloud>> m_scans;
+  Index m_index;
+  std::string m_frame_id;
+  // Last keyframe pose given by the mapper, in the frame of the mapper
+  Pose m_last_mapper_pose{Pose::Identity()};
+  bool8_t m_optimized{false};
+  std::size_t m_num_loop_closures{0U};
+  std::size_t m_last_loop_keyframe{0U};
+  std::thread m_worker;
+};
+
+/// \brief Convert a pose message into a pose.
+NDT_MAPPING_NODES_PUBLIC Pose to_pose(const geometry_msgs::msg::Pose & msg);
+
+/// \brief Convert a pose into a pose message.
+NDT_MAPPING_NODES_PUBLIC geometry_msgs::msg::Pose to_msg(const Pose & pose);
+
+}  // namespace ndt_mapping_nodes
+}  // namespace mapping
+}  // namespace autoware
+
+#endif  // NDT_MAPPING_NODES__POSE_GRAPH_BACKEND_HPP_
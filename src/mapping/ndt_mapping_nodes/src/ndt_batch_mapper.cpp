@@ -0,0 +1,214 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#include <ndt_mapping_nodes/ndt_batch_mapper.hpp>
+#include <ndt/ndt_map_binary.hpp>
+#include <point_cloud_msg_wrapper/point_cloud_msg_wrapper.hpp>
+
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace autoware
+{
+namespace mapping
+{
+namespace ndt_mapping_nodes
+{
+namespace
+{
+using PointXYZI = common::types::PointXYZI;
+using Cloud = NDTBatchMapper::Cloud;
+using CloudPtr = std::unique_ptr<Cloud>;
+
+/// Convert a registered pose into the transform of the scan into the map frame.
+geometry_msgs::msg::TransformStamped pose_to_transform(
+  const geometry_msgs::msg::PoseWithCovarianceStamped & pose_msg,
+  const std::string & child_frame_id)
+{
+  geometry_msgs::msg::TransformStamped tf_stamped{};
+  tf_stamped.header = pose_msg.header;
+  tf_stamped.child_frame_id = child_frame_id;
+  const auto & tf_trans = pose_msg.pose.pose.position;
+  const auto & tf_rot = pose_msg.pose.pose.orientation;
+  tf_stamped.transform.translation.set__x(tf_trans.x).set__y(tf_trans.y).set__z(tf_trans.z);
+  tf_stamped.transform.rotation.set__x(tf_rot.x).set__y(tf_rot.y).set__z(tf_rot.z).
+  set__w(tf_rot.w);
+  return tf_stamped;
+}
+}  // namespace
+
+NDTBatchMapper::NDTBatchMapper(
+  std::unique_ptr<Localizer> localizer,
+  std::unique_ptr<VoxelMap> map,
+  const NDTMap::Config & localizer_map_config)
+: m_localizer{std::move(localizer)},
+  m_map{std::move(map)},
+  m_localizer_map_config{localizer_map_config}
+{
+  if (!m_localizer || !m_map) {
+    throw std::invalid_argument("NDTBatchMapper: the localizer and the map must be given");
+  }
+  m_previous_transform.transform.rotation.set__w(1.0);
+  m_previous_transform.header.frame_id = m_map->frame_id();
+  point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI> msg_initializer{m_increment,
+    m_map->frame_id()};
+}
+
+bool8_t NDTBatchMapper::add_scan(const Cloud & scan)
+{
+  m_previous_transform.header.stamp = scan.header.stamp;
+  geometry_msgs::msg::TransformStamped transform = m_previous_transform;
+  if (!m_map->empty()) {
+    localization::localization_common::OptimizedRegistrationSummary summary{};
+    geometry_msgs::msg::PoseWithCovarianceStamped pose;
+    try {
+      pose = m_localizer->register_measurement(
+        scan, m_previous_transform, m_map->localizer_map(), &summary);
+    } catch (const std::exception &) {
+      return false;
+    }
+    // Like in the mapper node, only a numerical failure makes the result unusable
+    if (summary.optimization_summary().termination_type() ==
+      common::optimization::TerminationType::FAILURE)
+    {
+      return false;
+    }
+    transform = pose_to_transform(pose, scan.header.frame_id);
+  }
+  // The first scan defines the origin of the map
+  transform.child_frame_id = scan.header.frame_id;
+
+  point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI> inc_modifier{m_increment};
+  inc_modifier.clear();
+  inc_modifier.resize(point_cloud_msg_wrapper::PointCloud2View<PointXYZI>{scan}.size());
+  tf2::doTransform(scan, m_increment, transform);
+
+  (void)m_map->set_position(transform.transform.translation.x, transform.transform.translation.y);
+  m_map->update(m_increment);
+  m_previous_transform = transform;
+  ++m_num_registered_scans;
+  return true;
+}
+
+void NDTBatchMapper::write(const std::string & file_name_prefix) const
+{
+  const auto snapshot = m_map->snapshot();
+  VoxelMap::write(snapshot, file_name_prefix);
+  if (m_map->num_stored_tiles() == 0U) {
+    (void)localization::ndt::write_ndt_map_binary(
+      m_map->localizer_map(), file_name_prefix + ".ndtmap");
+    return;
+  }
+  // Only the active tiles are in the localizer map, the ndt map of the whole map is built from the
+  // centroids the same way as the localizer map of a tiled map.
+  Cloud cloud;
+  point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI> modifier{cloud, m_map->frame_id()};
+  modifier.reserve(snapshot.size());
+  for (const auto & pt : snapshot) {
+    modifier.push_back(PointXYZI{pt.x, pt.y, pt.z, pt.intensity});
+  }
+  cloud.header.stamp = m_previous_transform.header.stamp;
+  NDTMap ndt_map{m_localizer_map_config};
+  ndt_map.insert(cloud);
+  (void)localization::ndt::write_ndt_map_binary(ndt_map, file_name_prefix + ".ndtmap");
+}
+
+std::size_t NDTBatchMapper::num_registered_scans() const noexcept
+{
+  return m_num_registered_scans;
+}
+
+const VoxelMap & NDTBatchMapper::map() const noexcept
+{
+  return *m_map;
+}
+
+std::size_t run_batch_mapping(
+  const std::function<std::unique_ptr<sensor_msgs::msg::PointCloud2>()> & read_scan,
+  const std::function<std::unique_ptr<sensor_msgs::msg::PointCloud2>(
+    const sensor_msgs::msg::PointCloud2 &)> & downsample,
+  NDTBatchMapper & mapper,
+  const std::size_t queue_size)
+{
+  BoundedQueue<CloudPtr> read_queue{queue_size};
+  BoundedQueue<CloudPtr> downsampled_queue{queue_size};
+  std::mutex error_mutex;
+  std::exception_ptr error{nullptr};
+  // Stop all the stages on the first error
+  const auto fail = [&]() {
+      {
+        std::lock_guard<std::mutex> lock{error_mutex};
+        if (!error) {
+          error = std::current_exception();
+        }
+      }
+      read_queue.close();
+      downsampled_queue.close();
+    };
+
+  std::size_t num_read_scans{0U};
+  std::thread reader{[&]() {
+      try {
+        for (auto scan = read_scan(); scan; scan = read_scan()) {
+          ++num_read_scans;
+          if (!read_queue.push(std::move(scan))) {
+            break;
+          }
+        }
+        read_queue.close();
+      } catch (...) {
+        fail();
+      }
+    }};
+  std::thread preprocessor{[&]() {
+      try {
+        CloudPtr scan;
+        while (read_queue.pop(scan)) {
+          if (!downsampled_queue.push(downsample(*scan))) {
+            break;
+          }
+        }
+        downsampled_queue.close();
+      } catch (...) {
+        fail();
+      }
+    }};
+
+  try {
+    CloudPtr scan;
+    while (downsampled_queue.pop(scan)) {
+      if (scan) {
+        (void)mapper.add_scan(*scan);
+      }
+    }
+  } catch (...) {
+    fail();
+  }
+  reader.join();
+  preprocessor.join();
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  return num_read_scans;
+}
+
+}  // namespace ndt_mapping_nodes
+}  // namespace mapping
+}  // namespace autoware
@@ -0,0 +1,182 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#include <ndt_mapping_nodes/ndt_batch_mapper.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <rclcpp/serialization.hpp>
+#include <rclcpp/serialized_message.hpp>
+#include <rosbag2_cpp/converter_options.hpp>
+#include <rosbag2_cpp/readers/sequential_reader.hpp>
+#include <rosbag2_cpp/storage_options.hpp>
+#include <voxel_grid_nodes/algorithm/voxel_cloud_centroid.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace
+{
+using autoware::mapping::ndt_mapping_nodes::Localizer;
+using autoware::mapping::ndt_mapping_nodes::NDTBatchMapper;
+using autoware::mapping::ndt_mapping_nodes::NDTMap;
+using autoware::mapping::ndt_mapping_nodes::Optimizer;
+using autoware::mapping::ndt_mapping_nodes::P2DNDTConfig;
+using autoware::mapping::ndt_mapping_nodes::VoxelMap;
+using autoware::common::types::float32_t;
+using autoware::common::types::float64_t;
+using autoware::perception::filters::voxel_grid::Config;
+using autoware::perception::filters::voxel_grid::PointXYZ;
+using sensor_msgs::msg::PointCloud2;
+
+/// Parse a voxel grid configuration from the parameters under the given prefix.
+Config parse_grid_config(rclcpp::Node & node, const std::string & prefix)
+{
+  const auto get_point_param = [&node](const std::string & config_name_prefix) {
+      PointXYZ point;
+      point.x = static_cast<float32_t>(node.declare_parameter(config_name_prefix + ".x").
+        get<float32_t>());
+      point.y = static_cast<float32_t>(node.declare_parameter(config_name_prefix + ".y").
+        get<float32_t>());
+      point.z = static_cast<float32_t>(node.declare_parameter(config_name_prefix + ".z").
+        get<float32_t>());
+      return point;
+    };
+  const auto capacity = static_cast<std::size_t>(
+    node.declare_parameter(prefix + ".capacity").get<std::size_t>());
+  return Config{get_point_param(prefix + ".min_point"), get_point_param(prefix + ".max_point"),
+    get_point_param(prefix + ".voxel_size"), capacity};
+}
+
+/// Create the localizer from the same parameters as the ndt mapper node.
+std::unique_ptr<Localizer> make_localizer(rclcpp::Node & node)
+{
+  const P2DNDTConfig localizer_config{
+    static_cast<uint32_t>(node.declare_parameter("localizer.scan.capacity").get<uint32_t>()),
+    std::chrono::milliseconds(
+      static_cast<uint64_t>(
+        node.declare_parameter("localizer.guess_time_tolerance_ms").get<uint64_t>()))
+  };
+  const auto outlier_ratio{
+    node.declare_parameter("localizer.optimization.outlier_ratio").get<float64_t>()};
+  const autoware::common::optimization::OptimizationOptions optimization_options{
+    static_cast<uint64_t>(
+      node.declare_parameter("localizer.optimizer.max_iterations").get<uint64_t>()),
+    node.declare_parameter("localizer.optimizer.score_tolerance").get<float64_t>(),
+    node.declare_parameter("localizer.optimizer.parameter_tolerance").get<float64_t>(),
+    node.declare_parameter("localizer.optimizer.gradient_tolerance").get<float64_t>()
+  };
+  using autoware::common::optimization::MoreThuenteLineSearch;
+  return std::make_unique<Localizer>(
+    localizer_config,
+    Optimizer{
+      MoreThuenteLineSearch{
+        static_cast<float32_t>(
+          node.declare_parameter("localizer.optimizer.line_search.step_max").get<float32_t>()),
+        static_cast<float32_t>(
+          node.declare_parameter("localizer.optimizer.line_search.step_min").get<float32_t>()),
+        MoreThuenteLineSearch::OptimizationDirection::kMaximization
+      },
+      optimization_options},
+    outlier_ratio);
+}
+}  // namespace
+
+/// Offline mapping of the point clouds of a rosbag2 bag. The parameters of the ndt mapper node
+/// configure the mapper, see param/ndt_batch_mapper.param.yaml for the others.
+int32_t main(const int32_t argc, char * argv[])
+{
+  int32_t ret = 0;
+  try {
+    rclcpp::init(argc, argv);
+    // Only used to read the parameters
+    rclcpp::Node node{"ndt_batch_mapper"};
+
+    auto localizer = make_localizer(node);
+    autoware::mapping::point_cloud_mapping::TilingConfig tiling_config;
+    tiling_config.tile_size = static_cast<float32_t>(node.declare_parameter("map.tile_size", 0.0));
+    tiling_config.active_radius = static_cast<uint32_t>(
+      std::max(node.declare_parameter("map.active_tile_radius", 1), 0));
+    tiling_config.directory = node.declare_parameter("map.tile_directory", std::string{"."});
+    const auto localizer_map_config = parse_grid_config(node, "localizer.map");
+    auto map = std::make_unique<VoxelMap>(
+      parse_grid_config(node, "map"),
+      node.declare_parameter("map.frame_id").get<std::string>(),
+      NDTMap{localizer_map_config}, tiling_config);
+    NDTBatchMapper mapper{std::move(localizer), std::move(map), localizer_map_config};
+
+    rosbag2_cpp::StorageOptions storage_options{};
+    storage_options.uri = node.declare_parameter("bag.uri").get<std::string>();
+    storage_options.storage_id = node.declare_parameter("bag.storage_id", std::string{"sqlite3"});
+    rosbag2_cpp::ConverterOptions converter_options{};
+    converter_options.input_serialization_format = "cdr";
+    converter_options.output_serialization_format = "cdr";
+    rosbag2_cpp::readers::SequentialReader reader;
+    reader.open(storage_options, converter_options);
+    const auto topic = node.declare_parameter("bag.topic").get<std::string>();
+
+    // Reading and deserializing run on the reader thread of the pipeline
+    const rclcpp::Serialization<PointCloud2> serialization;
+    const auto read_scan = [&reader, &topic, &serialization]() -> std::unique_ptr<PointCloud2> {
+        while (reader.has_next()) {
+          const auto bag_message = reader.read_next();
+          if (bag_message->topic_name != topic) {
+            continue;
+          }
+          const rclcpp::SerializedMessage serialized_message{*bag_message->serialized_data};
+          auto scan = std::make_unique<PointCloud2>();
+          serialization.deserialize_message(&serialized_message, scan.get());
+          return scan;
+        }
+        return nullptr;
+      };
+
+    // Same downsampling as the voxel grid node in front of the ndt mapper node
+    autoware::perception::filters::voxel_grid_nodes::algorithm::VoxelCloudCentroid downsampler{
+      parse_grid_config(node, "downsample.config")};
+    const auto downsample = [&downsampler](const PointCloud2 & scan) {
+        downsampler.insert(scan);
+        return downsampler.release();
+      };
+
+    const auto queue_size =
+      static_cast<std::size_t>(std::max(node.declare_parameter("queue_size", 8), 1));
+    const auto num_scans =
+      autoware::mapping::ndt_mapping_nodes::run_batch_mapping(
+      read_scan, downsample, mapper, queue_size);
+
+    const auto file_name_prefix = node.declare_parameter("file_name_prefix").get<std::string>();
+    mapper.write(file_name_prefix);
+    std::cout << "Registered " << mapper.num_registered_scans() << " of " << num_scans <<
+      " scans, the map is written to " << file_name_prefix << ".pcd and " << file_name_prefix <<
+      ".ndtmap" << std::endl;
+
+    if (!rclcpp::shutdown()) {
+      throw std::runtime_error{"Could not shutdown rclcpp"};
+    }
+  } catch (const std::exception & e) {
+    std::cerr << e.what();
+    ret = __LINE__;
+  } catch (...) {
+    std::cerr << "Unknown error occured";
+    ret = __LINE__;
+  }
+
+  return ret;
+}
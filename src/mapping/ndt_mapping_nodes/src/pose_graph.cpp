@@ -0,0 +1,197 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#include <ndt_mapping_nodes/pose_graph.hpp>
+#include <Eigen/SparseCholesky>
+
+#include <stdexcept>
+#include <vector>
+
+namespace autoware
+{
+namespace mapping
+{
+namespace ndt_mapping_nodes
+{
+namespace
+{
+using Triplets = std::vector<Eigen::Triplet<float64_t>>;
+
+constexpr Eigen::Index BLOCK_SIZE = 6;
+// Step of the numerical differentiation of the residuals
+constexpr float64_t DIFF_STEP = 1.0e-6;
+// Damping keeping the normal equations solvable for nodes that aren't constrained in some
+// direction
+constexpr float64_t DAMPING = 1.0e-9;
+
+Vector6d residual_of(const Pose & from, const Pose & to, const Pose & measurement)
+{
+  const Pose error = measurement.inverse() * (from.inverse() * to);
+  const Eigen::AngleAxisd rotation{error.rotation()};
+  Vector6d residual;
+  residual.head<3>() = error.translation();
+  residual.tail<3>() = rotation.angle() * rotation.axis();
+  return residual;
+}
+
+void add_block(
+  Triplets & triplets, const Eigen::Index row, const Eigen::Index col, const Matrix6d & block)
+{
+  for (Eigen::Index i = 0; i < BLOCK_SIZE; ++i) {
+    for (Eigen::Index j = 0; j < BLOCK_SIZE; ++j) {
+      triplets.emplace_back(row + i, col + j, block(i, j));
+    }
+  }
+}
+}  // namespace
+
+Pose apply_increment(const Pose & pose, const Vector6d & increment)
+{
+  Pose delta = Pose::Identity();
+  const float64_t angle = increment.tail<3>().norm();
+  if (angle > 0.0) {
+    delta.linear() = Eigen::AngleAxisd{angle, increment.tail<3>() / angle}.toRotationMatrix();
+  }
+  delta.translation() = increment.head<3>();
+  return pose * delta;
+}
+
+std::size_t PoseGraph::add_node(const Pose & pose)
+{
+  m_poses.push_back(pose);
+  return m_poses.size() - 1U;
+}
+
+void PoseGraph::add_edge(const PoseGraphEdge & edge)
+{
+  if ((edge.from >= m_poses.size()) || (edge.to >= m_poses.size())) {
+    throw std::out_of_range("PoseGraph: the nodes of an edge must exist");
+  }
+  m_edges.push_back(edge);
+}
+
+std::size_t PoseGraph::optimize(const std::size_t max_iterations, const float64_t step_tolerance)
+{
+  if ((m_poses.size() < 2U) || m_edges.empty()) {
+    return 0U;
+  }
+  // The first node is fixed, the others are the variables
+  const auto num_variables = static_cast<Eigen::Index>(m_poses.size() - 1U) * BLOCK_SIZE;
+  const auto variable_offset = [](const std::size_t node) {
+      return static_cast<Eigen::Index>(node - 1U) * BLOCK_SIZE;
+    };
+  Triplets triplets;
+  std::size_t iteration = 0U;
+  while (iteration < max_iterations) {
+    ++iteration;
+    triplets.clear();
+    Eigen::VectorXd gradient = Eigen::VectorXd::Zero(num_variables);
+    for (const auto & edge : m_edges) {
+      const Pose & from = m_poses[edge.from];
+      const Pose & to = m_poses[edge.to];
+      const Vector6d residual = residual_of(from, to, edge.measurement);
+      // Jacobians of the residual with respect to increments of both poses
+      Matrix6d jac_from;
+      Matrix6d jac_to;
+      for (Eigen::Index k = 0; k < BLOCK_SIZE; ++k) {
+        Vector6d step = Vector6d::Zero();
+        step(k) = DIFF_STEP;
+        jac_from.col(k) = (residual_of(apply_increment(from, step), to, edge.measurement) -
+          residual_of(apply_increment(from, -step), to, edge.measurement)) / (2.0 * DIFF_STEP);
+        jac_to.col(k) = (residual_of(from, apply_increment(to, step), edge.measurement) -
+          residual_of(from, apply_increment(to, -step), edge.measurement)) / (2.0 * DIFF_STEP);
+      }
+      const Matrix6d weighted_from = jac_from.transpose() * edge.information;
+      const Matrix6d weighted_to = jac_to.transpose() * edge.information;
+      if (edge.from > 0U) {
+        const auto row = variable_offset(edge.from);
+        add_block(triplets, row, row, weighted_from * jac_from);
+        gradient.segment<6>(row) += weighted_from * residual;
+      }
+      if (edge.to > 0U) {
+        const auto row = variable_offset(edge.to);
+        add_block(triplets, row, row, weighted_to * jac_to);
+        gradient.segment<6>(row) += weighted_to * residual;
+      }
+      if ((edge.from > 0U) && (edge.to > 0U)) {
+        const Matrix6d off_diagonal = weighted_from * jac_to;
+        add_block(triplets, variable_offset(edge.from), variable_offset(edge.to), off_diagonal);
+        add_block(
+          triplets, variable_offset(edge.to), variable_offset(edge.from), off_diagonal.transpose());
+      }
+    }
+    for (Eigen::Index i = 0; i < num_variables; ++i) {
+      triplets.emplace_back(i, i, DAMPING);
+    }
+    Eigen::SparseMatrix<float64_t> hessian{num_variables, num_variables};
+    hessian.setFromTriplets(triplets.begin(), triplets.end());
+    const Eigen::SimplicialLDLT<Eigen::SparseMatrix<float64_t>> solver{hessian};
+    if (solver.info() != Eigen::Success) {
+      throw std::runtime_error("PoseGraph: could not factorize the normal equations");
+    }
+    const Eigen::VectorXd increment = solver.solve(-gradient);
+    if (solver.info() != Eigen::Success) {
+      throw std::runtime_error("PoseGraph: could not solve the normal equations");
+    }
+    for (std::size_t node = 1U; node < m_poses.size(); ++node) {
+      m_poses[node] = apply_increment(
+        m_poses[node], increment.segment<6>(variable_offset(node)));
+    }
+    if (increment.lpNorm<Eigen::Infinity>() < step_tolerance) {
+      break;
+    }
+  }
+  return iteration;
+}
+
+Vector6d PoseGraph::residual(const PoseGraphEdge & edge) const
+{
+  return residual_of(m_poses.at(edge.from), m_poses.at(edge.to), edge.measurement);
+}
+
+float64_t PoseGraph::error() const
+{
+  float64_t sum = 0.0;
+  for (const auto & edge : m_edges) {
+    const Vector6d res = residual(edge);
+    sum += res.dot(edge.information * res);
+  }
+  return sum;
+}
+
+const Pose & PoseGraph::pose(const std::size_t idx) const
+{
+  return m_poses.at(idx);
+}
+
+void PoseGraph::set_pose(const std::size_t idx, const Pose & pose)
+{
+  m_poses.at(idx) = pose;
+}
+
+std::size_t PoseGraph::num_nodes() const noexcept
+{
+  return m_poses.size();
+}
+
+const PoseGraphEdges & PoseGraph::edges() const noexcept
+{
+  return m_edges;
+}
+
+}  // namespace ndt_mapping_nodes
+}  // namespace mapping
+}  // namespace autoware
@@ -0,0 +1,315 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#include <ndt_mapping_nodes/pose_graph_backend.hpp>
+#include <point_cloud_msg_wrapper/point_cloud_msg_wrapper.hpp>
+
+#include <algorithm>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace autoware
+{
+namespace mapping
+{
+namespace ndt_mapping_nodes
+{
+namespace
+{
+using PointXYZI = common::types::PointXYZI;
+namespace bgi = boost::geometry::index;
+}  // namespace
+
+Pose to_pose(const geometry_msgs::msg::Pose & msg)
+{
+  Pose pose = Pose::Identity();
+  pose.translation() << msg.position.x, msg.position.y, msg.position.z;
+  pose.linear() = Eigen::Quaterniond{
+    msg.orientation.w, msg.orientation.x, msg.orientation.y, msg.orientation.z}.
+  normalized().toRotationMatrix();
+  return pose;
+}
+
+geometry_msgs::msg::Pose to_msg(const Pose & pose)
+{
+  geometry_msgs::msg::Pose msg;
+  const Eigen::Quaterniond rotation{pose.rotation()};
+  msg.position.set__x(pose.translation().x()).set__y(pose.translation().y()).
+  set__z(pose.translation().z());
+  msg.orientation.set__x(rotation.x()).set__y(rotation.y()).set__z(rotation.z()).
+  set__w(rotation.w());
+  return msg;
+}
+
+PoseGraphBackend::PoseGraphBackend(
+  const PoseGraphConfig & config,
+  std::unique_ptr<Localizer> localizer,
+  const NDTMap::Config & loop_map_config)
+: m_config{config},
+  m_localizer{std::move(localizer)},
+  m_loop_map_config{loop_map_config}
+{
+  if (!m_localizer) {
+    throw std::invalid_argument("PoseGraphBackend: a localizer must be given");
+  }
+  m_worker = std::thread{[this]() {worker_loop();}};
+}
+
+PoseGraphBackend::~PoseGraphBackend()
+{
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_stop = true;
+  }
+  m_job_cv.notify_one();
+  m_worker.join();
+}
+
+bool8_t PoseGraphBackend::add_scan(
+  const geometry_msgs::msg::PoseWithCovarianceStamped & pose,
+  const Cloud & scan)
+{
+  const Pose mapper_pose = to_pose(pose.pose.pose);
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    const auto num_keyframes = m_graph.num_nodes();
+    if ((num_keyframes > 0U) &&
+      ((mapper_pose.translation() - m_last_mapper_pose.translation()).norm() <
+      m_config.keyframe_distance))
+    {
+      return false;
+    }
+    std::size_t idx = 0U;
+    if (num_keyframes == 0U) {
+      idx = m_graph.add_node(mapper_pose);
+      m_frame_id = pose.header.frame_id;
+    } else {
+      // The relative pose doesn't depend on corrections of the graph made in the meantime
+      const Pose odometry = m_last_mapper_pose.inverse() * mapper_pose;
+      const auto previous = num_keyframes - 1U;
+      idx = m_graph.add_node(m_graph.pose(previous) * odometry);
+      m_graph.add_edge(PoseGraphEdge{previous, idx, odometry, Matrix6d::Identity()});
+    }
+    m_last_mapper_pose = mapper_pose;
+    m_scans.push_back(std::make_shared<const Cloud>(scan));
+    const auto & position = m_graph.pose(idx).translation();
+    m_index.insert(IndexValue{IndexPoint{position.x(), position.y(), position.z()}, idx});
+    m_jobs.push_back(idx);
+  }
+  m_job_cv.notify_one();
+  return true;
+}
+
+bool8_t PoseGraphBackend::take_optimized_keyframes(Keyframes & keyframes, Pose & correction)
+{
+  std::lock_guard<std::mutex> lock{m_mutex};
+  if (!m_optimized) {
+    return false;
+  }
+  m_optimized = false;
+  const Pose & last_pose = m_graph.pose(m_graph.num_nodes() - 1U);
+  correction = last_pose * m_last_mapper_pose.inverse();
+  // The mapper applies the correction, so its poses are in the frame of the graph from now on
+  m_last_mapper_pose = last_pose;
+  keyframes.clear();
+  keyframes.reserve(m_scans.size());
+  for (std::size_t idx = 0U; idx < m_scans.size(); ++idx) {
+    keyframes.push_back(Keyframe{m_graph.pose(idx), m_scans[idx]});
+  }
+  return true;
+}
+
+void PoseGraphBackend::wait_until_idle()
+{
+  std::unique_lock<std::mutex> lock{m_mutex};
+  m_idle_cv.wait(lock, [this]() {return m_jobs.empty() && !m_busy;});
+}
+
+std::size_t PoseGraphBackend::num_keyframes() const
+{
+  std::lock_guard<std::mutex> lock{m_mutex};
+  return m_graph.num_nodes();
+}
+
+std::size_t PoseGraphBackend::num_loop_closures() const
+{
+  std::lock_guard<std::mutex> lock{m_mutex};
+  return m_num_loop_closures;
+}
+
+void PoseGraphBackend::worker_loop()
+{
+  std::unique_lock<std::mutex> lock{m_mutex};
+  while (true) {
+    m_job_cv.wait(lock, [this]() {return m_stop || !m_jobs.empty();});
+    if (m_stop) {
+      return;
+    }
+    // If the registration is slower than the keyframes arrive, only the latest keyframe is
+    // searched, the following keyframes of a revisit will close the loop anyway.
+    const auto keyframe_idx = m_jobs.back();
+    m_jobs.clear();
+    m_busy = true;
+    lock.unlock();
+    search_loop(keyframe_idx);
+    lock.lock();
+    m_busy = false;
+    if (m_jobs.empty()) {
+      m_idle_cv.notify_all();
+    }
+  }
+}
+
+void PoseGraphBackend::search_loop(const std::size_t keyframe_idx)
+{
+  // Find the closest keyframe that is old enough and copy what the registration needs, so that
+  // the mapper can add keyframes while the worker registers.
+  std::size_t candidate_idx = 0U;
+  Pose keyframe_pose;
+  Pose candidate_pose;
+  std::shared_ptr<const Cloud> keyframe_scan;
+  Keyframes map_keyframes;
+  std::string frame_id;
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    if ((keyframe_idx < m_config.min_loop_keyframe_gap) ||
+      ((m_num_loop_closures > 0U) &&
+      (keyframe_idx < (m_last_loop_keyframe + m_config.min_loop_closure_interval))))
+    {
+      return;
+    }
+    const auto max_candidate_idx = keyframe_idx - m_config.min_loop_keyframe_gap;
+    keyframe_pose = m_graph.pose(keyframe_idx);
+    const auto & position = keyframe_pose.translation();
+    const IndexPoint query{position.x(), position.y(), position.z()};
+    std::vector<IndexValue> candidates;
+    (void)m_index.query(
+      bgi::nearest(query, 1U) && bgi::satisfies(
+        [max_candidate_idx](const IndexValue & value) {return value.second <= max_candidate_idx;}),
+      std::back_inserter(candidates));
+    if (candidates.empty() ||
+      (boost::geometry::distance(query, candidates.front().first) > m_config.loop_search_radius))
+    {
+      return;
+    }
+    candidate_idx = candidates.front().second;
+    candidate_pose = m_graph.pose(candidate_idx);
+    keyframe_scan = m_scans[keyframe_idx];
+    const auto first = candidate_idx - std::min(candidate_idx, m_config.num_loop_map_keyframes);
+    const auto last = std::min(candidate_idx + m_config.num_loop_map_keyframes, max_candidate_idx);
+    for (auto idx = first; idx <= last; ++idx) {
+      map_keyframes.push_back(Keyframe{m_graph.pose(idx), m_scans[idx]});
+    }
+    frame_id = m_frame_id;
+  }
+
+  // Map of the keyframes around the candidate in the map frame
+  Cloud map_cloud;
+  {
+    point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI> modifier{map_cloud, frame_id};
+    for (const auto & map_keyframe : map_keyframes) {
+      const point_cloud_msg_wrapper::PointCloud2View<PointXYZI> view{*map_keyframe.scan};
+      for (const auto & pt : view) {
+        const Eigen::Vector3d transformed = map_keyframe.pose * Eigen::Vector3d{
+          static_cast<float64_t>(pt.x), static_cast<float64_t>(pt.y), static_cast<float64_t>(pt.z)};
+        modifier.push_back(PointXYZI{static_cast<float32_t>(transformed.x()),
+            static_cast<float32_t>(transformed.y()), static_cast<float32_t>(transformed.z()),
+            pt.intensity});
+      }
+    }
+  }
+  // The map must not be newer than the scan registered against it
+  map_cloud.header.stamp = map_keyframes.front().scan->header.stamp;
+  NDTMap loop_map{m_loop_map_config};
+  loop_map.insert(map_cloud);
+
+  geometry_msgs::msg::TransformStamped guess;
+  guess.header.stamp = keyframe_scan->header.stamp;
+  guess.header.frame_id = frame_id;
+  guess.child_frame_id = keyframe_scan->header.frame_id;
+  const auto guess_pose = to_msg(keyframe_pose);
+  guess.transform.translation.set__x(guess_pose.position.x).set__y(guess_pose.position.y).
+  set__z(guess_pose.position.z);
+  guess.transform.rotation = guess_pose.orientation;
+
+  Pose registered_pose;
+  try {
+    localization::localization_common::OptimizedRegistrationSummary summary{};
+    const auto result =
+      m_localizer->register_measurement(*keyframe_scan, guess, loop_map, &summary);
+    if (summary.optimization_summary().termination_type() ==
+      common::optimization::TerminationType::FAILURE)
+    {
+      return;
+    }
+    registered_pose = to_pose(result.pose.pose);
+  } catch (const std::exception &) {
+    return;
+  }
+  if ((registered_pose.translation() - keyframe_pose.translation()).norm() >
+    m_config.max_loop_correction)
+  {
+    return;
+  }
+
+  // Optimize a copy of the graph so that the mapper can add keyframes in the meantime
+  PoseGraph graph;
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_graph.add_edge(
+      PoseGraphEdge{candidate_idx, keyframe_idx, candidate_pose.inverse() * registered_pose,
+        Matrix6d::Identity()});
+    m_last_loop_keyframe = keyframe_idx;
+    ++m_num_loop_closures;
+    graph = m_graph;
+  }
+  try {
+    (void)graph.optimize(m_config.max_iterations);
+  } catch (const std::runtime_error &) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock{m_mutex};
+  const auto num_optimized = graph.num_nodes();
+  const Pose last_correction =
+    graph.pose(num_optimized - 1U) * m_graph.pose(num_optimized - 1U).inverse();
+  for (std::size_t idx = 0U; idx < m_graph.num_nodes(); ++idx) {
+    // Keyframes added during the optimization move with the last optimized keyframe
+    m_graph.set_pose(
+      idx, (idx < num_optimized) ? graph.pose(idx) : (last_correction * m_graph.pose(idx)));
+  }
+  rebuild_index();
+  m_optimized = true;
+}
+
+void PoseGraphBackend::rebuild_index()
+{
+  std::vector<IndexValue> values;
+  values.reserve(m_graph.num_nodes());
+  for (std::size_t idx = 0U; idx < m_graph.num_nodes(); ++idx) {
+    const auto & position = m_graph.pose(idx).translation();
+    values.emplace_back(IndexPoint{position.x(), position.y(), position.z()}, idx);
+  }
+  // The packing constructor builds a better tree than inserting the keyframes one by one
+  m_index = Index{values.begin(), values.end()};
+}
+
+}  // namespace ndt_mapping_nodes
+}  // namespace mapping
+}  // namespace autoware
@@ -0,0 +1,141 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#include <gtest/gtest.h>
+#include <ndt_mapping_nodes/ndt_batch_mapper.hpp>
+#include <point_cloud_msg_wrapper/point_cloud_msg_wrapper.hpp>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+
+using autoware::mapping::ndt_mapping_nodes::BoundedQueue;
+using autoware::mapping::ndt_mapping_nodes::Localizer;
+using autoware::mapping::ndt_mapping_nodes::NDTBatchMapper;
+using autoware::mapping::ndt_mapping_nodes::NDTMap;
+using autoware::mapping::ndt_mapping_nodes::Optimizer;
+using autoware::mapping::ndt_mapping_nodes::VoxelMap;
+using autoware::mapping::ndt_mapping_nodes::run_batch_mapping;
+using autoware::perception::filters::voxel_grid::Config;
+using autoware::perception::filters::voxel_grid::PointXYZ;
+using autoware::common::types::PointXYZI;
+using sensor_msgs::msg::PointCloud2;
+
+namespace
+{
+Config make_grid_config(const float voxel_size)
+{
+  PointXYZ min_point;
+  min_point.x = -100.0F;
+  min_point.y = -100.0F;
+  min_point.z = -10.0F;
+  PointXYZ max_point;
+  max_point.x = 100.0F;
+  max_point.y = 100.0F;
+  max_point.z = 10.0F;
+  PointXYZ voxel;
+  voxel.x = voxel_size;
+  voxel.y = voxel_size;
+  voxel.z = voxel_size;
+  return Config{min_point, max_point, voxel, 100000U};
+}
+
+NDTBatchMapper make_mapper()
+{
+  using autoware::common::optimization::MoreThuenteLineSearch;
+  const autoware::localization::ndt::P2DNDTLocalizerConfig localizer_config{
+    100000U, std::chrono::milliseconds{750}};
+  const autoware::common::optimization::OptimizationOptions options{40U, 0.1, 0.1, 0.1};
+  auto localizer = std::make_unique<Localizer>(
+    localizer_config,
+    Optimizer{MoreThuenteLineSearch{0.12F, 0.001F,
+        MoreThuenteLineSearch::OptimizationDirection::kMaximization}, options},
+    0.55);
+  const auto localizer_map_config = make_grid_config(3.5F);
+  auto map = std::make_unique<VoxelMap>(
+    make_grid_config(1.0F), "map", NDTMap{localizer_map_config});
+  return NDTBatchMapper{std::move(localizer), std::move(map), localizer_map_config};
+}
+
+/// Scan of a box of points around the sensor
+std::unique_ptr<PointCloud2> make_scan(const int32_t seconds)
+{
+  auto scan = std::make_unique<PointCloud2>();
+  point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI> modifier{*scan, "base_link"};
+  for (int32_t x = -10; x <= 10; ++x) {
+    for (int32_t y = -10; y <= 10; ++y) {
+      modifier.push_back(PointXYZI{static_cast<float>(x), static_cast<float>(y),
+          static_cast<float>((x * y) % 3), 1.0F});
+    }
+  }
+  scan->header.stamp.sec = seconds;
+  return scan;
+}
+
+std::unique_ptr<PointCloud2> copy_scan(const PointCloud2 & scan)
+{
+  return std::make_unique<PointCloud2>(scan);
+}
+}  // namespace
+
+TEST(TestBoundedQueue, KeepsOrderAndCloses)
+{
+  BoundedQueue<int32_t> queue{2U};
+  std::thread producer{[&queue]() {
+      for (int32_t value = 0; value < 100; ++value) {
+        EXPECT_TRUE(queue.push(std::move(value)));
+      }
+      queue.close();
+    }};
+  int32_t value{-1};
+  for (int32_t expected = 0; expected < 100; ++expected) {
+    ASSERT_TRUE(queue.pop(value));
+    EXPECT_EQ(value, expected);
+  }
+  EXPECT_FALSE(queue.pop(value));
+  producer.join();
+  EXPECT_FALSE(queue.push(0));
+}
+
+TEST(TestNDTBatchMapper, MapsAllScans)
+{
+  auto mapper = make_mapper();
+  int32_t num_scans{0};
+  const auto read_scan = [&num_scans]() -> std::unique_ptr<PointCloud2> {
+      if (num_scans == 5) {
+        return nullptr;
+      }
+      ++num_scans;
+      return make_scan(num_scans);
+    };
+  EXPECT_EQ(run_batch_mapping(read_scan, copy_scan, mapper, 2U), 5U);
+  // The first scan is always inserted at the origin
+  EXPECT_GE(mapper.num_registered_scans(), 1U);
+  EXPECT_GT(mapper.map().size(), 0U);
+}
+
+TEST(TestNDTBatchMapper, RethrowsStageErrors)
+{
+  auto mapper = make_mapper();
+  const auto read_scan = []() {return make_scan(1);};
+  const auto downsample = [](const PointCloud2 &) -> std::unique_ptr<PointCloud2> {
+      throw std::runtime_error{"downsampling failed"};
+    };
+  EXPECT_THROW(run_batch_mapping(read_scan, downsample, mapper, 2U), std::runtime_error);
+  EXPECT_EQ(mapper.num_registered_scans(), 0U);
+}
@@ -0,0 +1,162 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#include <gtest/gtest.h>
+#include <ndt_mapping_nodes/pose_graph.hpp>
+#include <ndt_mapping_nodes/pose_graph_backend.hpp>
+#include <point_cloud_msg_wrapper/point_cloud_msg_wrapper.hpp>
+
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+
+using autoware::mapping::ndt_mapping_nodes::Matrix6d;
+using autoware::mapping::ndt_mapping_nodes::Keyframes;
+using autoware::mapping::ndt_mapping_nodes::Localizer;
+using autoware::mapping::ndt_mapping_nodes::Optimizer;
+using autoware::mapping::ndt_mapping_nodes::Pose;
+using autoware::mapping::ndt_mapping_nodes::PoseGraphBackend;
+using autoware::mapping::ndt_mapping_nodes::PoseGraphConfig;
+using autoware::mapping::ndt_mapping_nodes::PoseGraph;
+using autoware::mapping::ndt_mapping_nodes::PoseGraphEdge;
+using autoware::mapping::ndt_mapping_nodes::Poses;
+using autoware::mapping::ndt_mapping_nodes::Vector6d;
+using autoware::mapping::ndt_mapping_nodes::apply_increment;
+
+namespace
+{
+constexpr std::size_t NUM_POSES = 20U;
+
+/// Poses on a circle of radius 10 m, heading along the circle
+Poses make_circle()
+{
+  Poses poses;
+  for (std::size_t idx = 0U; idx < NUM_POSES; ++idx) {
+    const double angle = 2.0 * M_PI * static_cast<double>(idx) / static_cast<double>(NUM_POSES);
+    Pose pose = Pose::Identity();
+    pose.translation() << 10.0 * std::sin(angle), 10.0 - 10.0 * std::cos(angle), 0.0;
+    pose.linear() = Eigen::AngleAxisd{angle, Eigen::Vector3d::UnitZ()}.toRotationMatrix();
+    poses.push_back(pose);
+  }
+  return poses;
+}
+
+PoseGraphEdge make_edge(const std::size_t from, const std::size_t to, const Pose & measurement)
+{
+  return PoseGraphEdge{from, to, measurement, Matrix6d::Identity()};
+}
+}  // namespace
+
+TEST(TestPoseGraph, ConvergesToConsistentPoses)
+{
+  const auto truth = make_circle();
+  PoseGraph graph;
+  Vector6d offset;
+  offset << 0.3, -0.2, 0.1, 0.02, -0.01, 0.05;
+  for (std::size_t idx = 0U; idx < NUM_POSES; ++idx) {
+    // The first node is fixed, so it is not perturbed
+    EXPECT_EQ(graph.add_node((idx == 0U) ? truth[idx] : apply_increment(truth[idx], offset)), idx);
+  }
+  for (std::size_t idx = 0U; idx < NUM_POSES; ++idx) {
+    const auto next = (idx + 1U) % NUM_POSES;
+    graph.add_edge(make_edge(idx, next, truth[idx].inverse() * truth[next]));
+  }
+  EXPECT_GT(graph.error(), 1.0e-3);
+  EXPECT_GT(graph.optimize(20U), 0U);
+  EXPECT_LT(graph.error(), 1.0e-12);
+  for (std::size_t idx = 0U; idx < NUM_POSES; ++idx) {
+    EXPECT_LT((graph.pose(idx).translation() - truth[idx].translation()).norm(), 1.0e-6);
+    EXPECT_TRUE(graph.pose(idx).linear().isApprox(truth[idx].linear(), 1.0e-6));
+  }
+}
+
+TEST(TestPoseGraph, LoopClosureReducesDrift)
+{
+  const auto truth = make_circle();
+  // Odometry that slightly overestimates every turn
+  const Pose bias{Eigen::AngleAxisd{0.01, Eigen::Vector3d::UnitZ()}};
+  PoseGraph graph;
+  (void)graph.add_node(truth[0U]);
+  for (std::size_t idx = 1U; idx < NUM_POSES; ++idx) {
+    const Pose odometry = truth[idx - 1U].inverse() * truth[idx] * bias;
+    (void)graph.add_node(graph.pose(idx - 1U) * odometry);
+    graph.add_edge(make_edge(idx - 1U, idx, odometry));
+  }
+  const auto last = NUM_POSES - 1U;
+  const auto drift = (graph.pose(last).translation() - truth[last].translation()).norm();
+  ASSERT_GT(drift, 0.5);
+
+  // The revisit of the first pose is measured exactly
+  graph.add_edge(make_edge(last, 0U, truth[last].inverse() * truth[0U]));
+  (void)graph.optimize(20U);
+  const auto corrected_drift = (graph.pose(last).translation() - truth[last].translation()).norm();
+  EXPECT_LT(corrected_drift, 0.2 * drift);
+}
+
+TEST(TestPoseGraph, RejectsEdgesOfUnknownNodes)
+{
+  PoseGraph graph;
+  (void)graph.add_node(Pose::Identity());
+  EXPECT_THROW(graph.add_edge(make_edge(0U, 1U, Pose::Identity())), std::out_of_range);
+  EXPECT_EQ(graph.optimize(10U), 0U);
+}
+
+TEST(TestPoseGraphBackend, KeepsDistantScansAsKeyframes)
+{
+  using autoware::common::optimization::MoreThuenteLineSearch;
+  using autoware::perception::filters::voxel_grid::PointXYZ;
+  auto localizer = std::make_unique<Localizer>(
+    autoware::localization::ndt::P2DNDTLocalizerConfig{1000U, std::chrono::milliseconds{750}},
+    Optimizer{MoreThuenteLineSearch{0.12F, 0.001F,
+        MoreThuenteLineSearch::OptimizationDirection::kMaximization},
+      autoware::common::optimization::OptimizationOptions{10U, 0.1, 0.1, 0.1}},
+    0.55);
+  PointXYZ min_point;
+  min_point.x = -100.0F;
+  min_point.y = -100.0F;
+  min_point.z = -10.0F;
+  PointXYZ max_point;
+  max_point.x = 100.0F;
+  max_point.y = 100.0F;
+  max_point.z = 10.0F;
+  PointXYZ voxel_size;
+  voxel_size.x = 3.5F;
+  voxel_size.y = 3.5F;
+  voxel_size.z = 3.5F;
+  PoseGraphConfig config;
+  config.keyframe_distance = 2.0;
+  PoseGraphBackend backend{config, std::move(localizer), {min_point, max_point, voxel_size, 1000U}};
+
+  sensor_msgs::msg::PointCloud2 scan;
+  point_cloud_msg_wrapper::PointCloud2Modifier<autoware::common::types::PointXYZI> modifier{
+    scan, "base_link"};
+  modifier.push_back(autoware::common::types::PointXYZI{1.0F, 2.0F, 0.0F, 1.0F});
+  geometry_msgs::msg::PoseWithCovarianceStamped pose;
+  pose.header.frame_id = "map";
+  pose.pose.pose.orientation.w = 1.0;
+  for (int32_t step = 0; step < 10; ++step) {
+    pose.pose.pose.position.x = static_cast<double>(step);
+    // Every other scan is at least 2 m away from the previous keyframe
+    EXPECT_EQ(backend.add_scan(pose, scan), (step % 2) == 0);
+  }
+  backend.wait_until_idle();
+  EXPECT_EQ(backend.num_keyframes(), 5U);
+  // The path has no revisit, so there is nothing to correct
+  EXPECT_EQ(backend.num_loop_closures(), 0U);
+  Keyframes keyframes;
+  Pose correction;
+  EXPECT_FALSE(backend.take_optimized_keyframes(keyframes, correction));
+}
@@ -33,6 +33,15 @@
 #pragma GCC diagnostic ignored "-Wuseless-cast"
 #include <pcl/io/pcd_io.h>
 #pragma GCC diagnostic pop
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <set>
 #include <vector>
 #include <string>
 #include <unordered_map>
@@ -61,6 +70,21 @@ struct POINT_CLOUD_MAPPING_PUBLIC MapUpdateSummary
   std::size_t num_added_pts;
 };
 using common::types::float32_t;
+using common::types::float64_t;
+using common::types::bool8_t;
+
+/// Configuration of the tiling of a `DualVoxelMap`. The map is split into square tiles in the
+/// x-y plane. Only the tiles around the current position are kept in memory, the others are
+/// written to files and read back once the position comes near them again.
+struct POINT_CLOUD_MAPPING_PUBLIC TilingConfig
+{
+  /// Edge length of a tile in meters. The map isn't tiled if it isn't positive.
+  float32_t tile_size{0.0F};
+  /// Tiles up to this number of tiles away from the tile of the position are kept in memory.
+  uint32_t active_radius{1U};
+  /// Existing directory the tiles are written to.
+  std::string directory{"."};
+};
 
 enum class Requires {};
 
@@ -96,6 +120,8 @@ struct LocalizationMapConstraint
 /// A voxel grid is used for accumulating the lidar scans in a downsampled manner. A separate
 /// map is stored for the localizer implementation. The expected interface is defined via the
 /// `Requires` keyword.
+/// The map can be tiled with a `TilingConfig` to map large areas in bounded memory, see
+/// `set_position()`.
 template<typename LocalizerMapT, Requires = LocalizationMapConstraint<LocalizerMapT>::value>
 class POINT_CLOUD_MAPPING_PUBLIC DualVoxelMap
 {
@@ -107,13 +133,16 @@ public:
   /// \param grid_config Grid configuration of the underlying voxel grid.
   /// \param frame_id Frame id of the map.
   /// \param localizer_map Localizer map to be stored.
+  /// \param tiling_config Tiling of the map, the map isn't tiled by default.
   explicit DualVoxelMap(
     const perception::filters::voxel_grid::Config & grid_config,
     const std::string & frame_id,
-    LocalizerMapT && localizer_map
+    LocalizerMapT && localizer_map,
+    const TilingConfig & tiling_config = TilingConfig{}
   )
   : m_grid_config{grid_config}, m_frame_id{frame_id},
-    m_localizer_map{std::forward<LocalizerMapT>(localizer_map)} {}
+    m_localizer_map{std::forward<LocalizerMapT>(localizer_map)},
+    m_tiling_config{tiling_config} {}
 
   /// Try to extend the map with the given point cloud.
   /// \param observation Point cloud in the "map" frame to add to the map.
@@ -152,28 +181,134 @@ public:
     return ret;
   }
 
-  /// Convert the voxel grid to a point cloud and write it to a pcd file.
+  /// Convert the voxel grid to a point cloud and write it to a binary pcd file. The stored tiles
+  /// of a tiled map are written too.
   /// \param file_name_prefix File name prefix of the file.
   void write(const std::string & file_name_prefix) const
+  {
+    write(snapshot(), file_name_prefix);
+  }
+
+  /// Write a snapshot of the map to a binary pcd file. This doesn't access the map, so the
+  /// snapshot can be written from another thread while the map is updated.
+  /// \param snapshot Snapshot of the map, see `snapshot()`.
+  /// \param file_name_prefix File name prefix of the file.
+  static void write(
+    const pcl::PointCloud<pcl::PointXYZI> & snapshot,
+    const std::string & file_name_prefix)
+  {
+    if (pcl::io::savePCDFileBinary(file_name_prefix + ".pcd", snapshot) != 0) {
+      throw std::runtime_error("DualVoxelMap: could not write " + file_name_prefix + ".pcd");
+    }
+  }
+
+  /// Copy the centroids of the voxel grid, including the stored tiles of a tiled map, to a
+  /// point cloud. This is a copy of the map that is much cheaper than writing it.
+  /// \return The point cloud.
+  pcl::PointCloud<pcl::PointXYZI> snapshot() const
   {
     // TODO(yunus.caliskan) Remove dynamic allocations.
     // pcl cloud is constructed here and the map is copied to it for sake
     // of simplicity to be able to use the pcl library's pcd writer.
     pcl::PointCloud<pcl::PointXYZI> cloud;
     cloud.reserve(m_grid.size());
+    const auto add_point = [&cloud](const Voxel & vx) {
+        pcl::PointXYZI pt;
+        const auto & vx_pt = vx.get();
+        pt.x = vx_pt.x;
+        pt.y = vx_pt.y;
+        pt.z = vx_pt.z;
+        pt.intensity = vx_pt.intensity;
+        cloud.push_back(pt);
+      };
+    // Voxels of stored tiles are merged with the stored tile, they were observed again while the
+    // tile was stored.
+    std::map<TileIndex, Grid> voxels_of_stored_tiles;
     for (const auto & vx : m_grid) {
-      pcl::PointXYZI pt;
-      const auto & vx_pt = vx.second.get();
-      pt.x = vx_pt.x;
-      pt.y = vx_pt.y;
-      pt.z = vx_pt.z;
-      pt.intensity = vx_pt.intensity;
-      cloud.push_back(pt);
+      const auto tile = tile_of_voxel(vx.first);
+      if (m_stored_tiles.find(tile) == m_stored_tiles.end()) {
+        add_point(vx.second);
+      } else {
+        (void)voxels_of_stored_tiles[tile].emplace(vx.first, vx.second);
+      }
+    }
+    for (const auto & tile : m_stored_tiles) {
+      Grid tile_grid;
+      read_tile(tile, tile_grid);
+      for (const auto & vx : voxels_of_stored_tiles[tile]) {
+        merge_voxel(tile_grid, vx.first, vx.second);
+      }
+      for (const auto & vx : tile_grid) {
+        add_point(vx.second);
+      }
     }
-    pcl::io::savePCDFile(file_name_prefix + ".pcd", cloud);
+    return cloud;
   }
 
-  /// Size of the voxel grid.
+  /// Update the position around which the tiles of a tiled map are kept in memory. The voxels
+  /// of the tiles that are now too far from the position are written to their tile files and
+  /// removed from memory, and the stored tiles that are near the position again are read back.
+  /// If tiles were written or read, the localizer map is rebuilt from the voxels in memory so
+  /// that registration continues against the local map. The position is only observed when it
+  /// changes tile, so that the voxels of a scan outside of the active tiles are kept until then.
+  /// \param x X coordinate of the position in the map frame.
+  /// \param y Y coordinate of the position in the map frame.
+  /// \return True if tiles were written or read.
+  bool8_t set_position(const float64_t x, const float64_t y)
+  {
+    if (!tiled()) {
+      return false;
+    }
+    const TileIndex center_tile{tile_coordinate(x, m_grid_config.get_min_point().x),
+      tile_coordinate(y, m_grid_config.get_min_point().y)};
+    if (m_has_position && (center_tile == m_center_tile)) {
+      return false;
+    }
+    m_has_position = true;
+    m_center_tile = center_tile;
+
+    // Store the voxels of the inactive tiles, grouped by tile
+    std::map<TileIndex, std::vector<std::pair<uint64_t, Voxel>>> inactive_voxels;
+    for (auto it = m_grid.begin(); it != m_grid.end(); ) {
+      const auto tile = tile_of_voxel(it->first);
+      if (active(tile)) {
+        ++it;
+      } else {
+        inactive_voxels[tile].emplace_back(it->first, it->second);
+        it = m_grid.erase(it);
+      }
+    }
+    for (const auto & tile_voxels : inactive_voxels) {
+      write_tile(tile_voxels.first, tile_voxels.second);
+    }
+
+    // Read back the stored active tiles
+    bool8_t read_tiles = false;
+    for (auto it = m_stored_tiles.begin(); it != m_stored_tiles.end(); ) {
+      if (active(*it)) {
+        read_tile(*it, m_grid);
+        (void)std::remove(tile_file_name(*it).c_str());
+        it = m_stored_tiles.erase(it);
+        read_tiles = true;
+      } else {
+        ++it;
+      }
+    }
+
+    if (inactive_voxels.empty() && !read_tiles) {
+      return false;
+    }
+    rebuild_localizer_map();
+    return true;
+  }
+
+  /// Number of tiles of a tiled map that are stored in files instead of in memory.
+  std::size_t num_stored_tiles() const noexcept
+  {
+    return m_stored_tiles.size();
+  }
+
+  /// Size of the voxel grid in memory.
   std::size_t size() const noexcept
   {
     return m_grid.size();
@@ -183,11 +318,15 @@ public:
   {
     return m_grid_config.get_capacity();
   }
-  /// Clear the voxel grid.
+  /// Clear the voxel grid. The stored tiles of a tiled map are removed too.
   void clear()
   {
     m_grid.clear();
     m_localizer_map.clear();
+    for (const auto & tile : m_stored_tiles) {
+      (void)std::remove(tile_file_name(tile).c_str());
+    }
+    m_stored_tiles.clear();
   }
   /// Get the localizer map
   const LocalizerMapT & localizer_map() const noexcept
@@ -207,11 +346,151 @@ public:
   }
 
 private:
+  using Voxel = perception::filters::voxel_grid::CentroidVoxel<common::types::PointXYZI>;
+  using Grid = std::unordered_map<uint64_t, Voxel>;
+  using TileIndex = std::pair<int64_t, int64_t>;
+  /// Size of a voxel in a tile file: index, number of points, x, y, z and intensity
+  static constexpr std::size_t VOXEL_RECORD_SIZE{sizeof(uint64_t) + sizeof(uint32_t) +
+    (4U * sizeof(float32_t))};
+
+  bool8_t tiled() const noexcept
+  {
+    return m_tiling_config.tile_size > 0.0F;
+  }
+
+  int64_t tile_coordinate(const float64_t coordinate, const float32_t min_coordinate) const
+  {
+    return static_cast<int64_t>(std::floor(
+             (coordinate - static_cast<float64_t>(min_coordinate)) /
+             static_cast<float64_t>(m_tiling_config.tile_size)));
+  }
+
+  /// The tile of a voxel only depends on its index so that a voxel is always in the same tile.
+  TileIndex tile_of_voxel(const uint64_t voxel_idx) const
+  {
+    if (!tiled()) {
+      return TileIndex{0, 0};
+    }
+    const auto center =
+      m_grid_config.centroid<perception::filters::voxel_grid::PointXYZ>(voxel_idx);
+    return TileIndex{
+      tile_coordinate(static_cast<float64_t>(center.x), m_grid_config.get_min_point().x),
+      tile_coordinate(static_cast<float64_t>(center.y), m_grid_config.get_min_point().y)};
+  }
+
+  bool8_t active(const TileIndex & tile) const noexcept
+  {
+    const auto radius = static_cast<int64_t>(m_tiling_config.active_radius);
+    return (std::abs(tile.first - m_center_tile.first) <= radius) &&
+           (std::abs(tile.second - m_center_tile.second) <= radius);
+  }
+
+  std::string tile_file_name(const TileIndex & tile) const
+  {
+    return m_tiling_config.directory + "/" + m_frame_id + "_tile_" +
+           std::to_string(tile.first) + "_" + std::to_string(tile.second) + ".bin";
+  }
+
+  /// Add a voxel to a grid, merge it with the voxel of the same index if there is one.
+  static void merge_voxel(Grid & grid, const uint64_t voxel_idx, const Voxel & voxel)
+  {
+    const auto it = grid.find(voxel_idx);
+    if (it == grid.end()) {
+      (void)grid.emplace(voxel_idx, voxel);
+      return;
+    }
+    const auto count = it->second.count() + voxel.count();
+    const auto weight = static_cast<float32_t>(voxel.count()) / static_cast<float32_t>(count);
+    auto centroid = it->second.get();
+    const auto & other = voxel.get();
+    centroid.x += (other.x - centroid.x) * weight;
+    centroid.y += (other.y - centroid.y) * weight;
+    centroid.z += (other.z - centroid.z) * weight;
+    centroid.intensity += (other.intensity - centroid.intensity) * weight;
+    it->second = Voxel{centroid, count};
+  }
+
+  /// Append voxels to the file of their tile. The file is truncated when the tile is first
+  /// stored so that the files of a previous map are not read.
+  void write_tile(const TileIndex & tile, const std::vector<std::pair<uint64_t, Voxel>> & voxels)
+  {
+    const bool8_t stored = m_stored_tiles.find(tile) != m_stored_tiles.end();
+    std::ofstream file{tile_file_name(tile),
+      std::ios::binary | (stored ? std::ios::app : std::ios::trunc)};
+    if (!file) {
+      throw std::runtime_error("DualVoxelMap: could not write tile file " + tile_file_name(tile));
+    }
+    std::vector<char> buffer(voxels.size() * VOXEL_RECORD_SIZE);
+    char * record = buffer.data();
+    for (const auto & vx : voxels) {
+      const uint32_t count = vx.second.count();
+      const auto & pt = vx.second.get();
+      const std::array<float32_t, 4U> fields{pt.x, pt.y, pt.z, pt.intensity};
+      (void)std::memcpy(record, &vx.first, sizeof(vx.first));
+      (void)std::memcpy(&record[sizeof(vx.first)], &count, sizeof(count));
+      (void)std::memcpy(&record[sizeof(vx.first) + sizeof(count)], fields.data(), sizeof(fields));
+      record = &record[VOXEL_RECORD_SIZE];
+    }
+    (void)file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    if (!file) {
+      throw std::runtime_error("DualVoxelMap: could not write tile file " + tile_file_name(tile));
+    }
+    (void)m_stored_tiles.insert(tile);
+  }
+
+  /// Read the voxels of a stored tile and merge them into a grid.
+  void read_tile(const TileIndex & tile, Grid & grid) const
+  {
+    std::ifstream file{tile_file_name(tile), std::ios::binary};
+    if (!file) {
+      throw std::runtime_error("DualVoxelMap: could not read tile file " + tile_file_name(tile));
+    }
+    const std::vector<char> buffer{std::istreambuf_iterator<char>{file},
+      std::istreambuf_iterator<char>{}};
+    for (std::size_t offset = 0U; (offset + VOXEL_RECORD_SIZE) <= buffer.size();
+      offset += VOXEL_RECORD_SIZE)
+    {
+      const char * const record = &buffer[offset];
+      uint64_t voxel_idx;
+      uint32_t count;
+      std::array<float32_t, 4U> fields;
+      (void)std::memcpy(&voxel_idx, record, sizeof(voxel_idx));
+      (void)std::memcpy(&count, &record[sizeof(voxel_idx)], sizeof(count));
+      (void)std::memcpy(
+        fields.data(), &record[sizeof(voxel_idx) + sizeof(count)], sizeof(fields));
+      if (count > 0U) {
+        common::types::PointXYZI pt{fields[0U], fields[1U], fields[2U], fields[3U]};
+        merge_voxel(grid, voxel_idx, Voxel{pt, count});
+      }
+    }
+  }
+
+  /// Rebuild the localizer map from the centroids of the voxels in memory.
+  void rebuild_localizer_map()
+  {
+    using PointXYZI = autoware::common::types::PointXYZI;
+    point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI> modifier{m_localizer_cloud,
+      m_frame_id};
+    modifier.clear();
+    modifier.reserve(m_grid.size());
+    for (const auto & vx : m_grid) {
+      modifier.push_back(vx.second.get());
+    }
+    m_localizer_map.clear();
+    if (!m_grid.empty()) {
+      m_localizer_map.insert(m_localizer_cloud);
+    }
+  }
+
   perception::filters::voxel_grid::Config m_grid_config;
-  std::unordered_map<uint64_t,
-    perception::filters::voxel_grid::CentroidVoxel<common::types::PointXYZI>> m_grid;
+  Grid m_grid;
   std::string m_frame_id;
   LocalizerMapT m_localizer_map;
+  TilingConfig m_tiling_config;
+  std::set<TileIndex> m_stored_tiles;
+  TileIndex m_center_tile{0, 0};
+  bool8_t m_has_position{false};
+  Cloud m_localizer_cloud;
 };
 }  // namespace point_cloud_mapping
 }  // namespace mapping
@@ -33,6 +33,7 @@ using autoware::mapping::point_cloud_mapping::MapUpdateType;
 using autoware::mapping::point_cloud_mapping::PclCloud;
 using autoware::mapping::point_cloud_mapping::VoxelMapContext;
 using autoware::mapping::point_cloud_mapping::DualVoxelMap;
+using autoware::mapping::point_cloud_mapping::TilingConfig;
 
 class VoxelMapTest : public ::testing::Test, public VoxelMapContext {};
 
@@ -93,6 +94,58 @@ TEST_F(VoxelMapTest, basic_io) {
   EXPECT_THROW(add_update(2U, MapUpdateType::NEW, false_frame), std::runtime_error);
 }
 
+TEST_F(VoxelMapTest, tiled_map) {
+  constexpr auto map_frame = "map";
+  constexpr auto num_cells = 10U;
+  const auto grid_config = autoware::perception::filters::voxel_grid::Config(
+    m_min_point, m_max_point, m_voxel_size, 100U);
+  // Cells 0 to 4 are in the tile (0, 0) and cells 5 to 9 in the tile (1, 1)
+  TilingConfig tiling_config;
+  tiling_config.tile_size = 5.0F;
+  tiling_config.active_radius = 0U;
+  DualVoxelMap<DummyLocalizationMap> map{grid_config, map_frame, DummyLocalizationMap{},
+    tiling_config};
+  const auto pc = autoware::mapping::point_cloud_mapping::make_pc_deviated(
+    num_cells, 0U, map_frame, FIXED_DEVIATION);
+  (void)map.update(pc);
+  EXPECT_EQ(map.size(), num_cells);
+
+  const std::string fname_prefix{"tiled_map_test_fname"};
+  const auto fname = fname_prefix + ".pcd";
+  auto check_written_map = [&map, &fname_prefix, &fname, num_cells]() {
+      map.write(fname_prefix);
+      PclCloud pcl_cloud;
+      pcl::io::loadPCDFile(fname, pcl_cloud);
+      autoware::mapping::point_cloud_mapping::check_pc(pcl_cloud, num_cells);
+      remove(fname.c_str());
+    };
+
+  // The tile (1, 1) is stored
+  EXPECT_TRUE(map.set_position(1.0, 1.0));
+  EXPECT_EQ(map.size(), num_cells / 2U);
+  EXPECT_EQ(map.num_stored_tiles(), 1U);
+  EXPECT_FALSE(map.set_position(2.0, 2.0));
+  check_written_map();
+
+  // Revisiting the tile (1, 1) reads it back and stores the tile (0, 0)
+  EXPECT_TRUE(map.set_position(7.0, 7.0));
+  EXPECT_EQ(map.size(), num_cells / 2U);
+  EXPECT_EQ(map.num_stored_tiles(), 1U);
+  check_written_map();
+
+  // Observing a stored tile again merges the observations with the stored voxels
+  (void)map.update(pc);
+  EXPECT_EQ(map.size(), num_cells);
+  check_written_map();
+  EXPECT_TRUE(map.set_position(1.0, 1.0));
+  EXPECT_EQ(map.size(), num_cells / 2U);
+  check_written_map();
+
+  map.clear();
+  EXPECT_EQ(map.size(), 0U);
+  EXPECT_EQ(map.num_stored_tiles(), 0U);
+}
+
 //////////////////////// helper function implementations ///////////////////////
 
 void autoware::mapping::point_cloud_mapping::check_pc(PclCloud & pc, std::size_t size)
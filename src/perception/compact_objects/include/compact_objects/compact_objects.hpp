@@ -0,0 +1,172 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief A compact representation of object lists, with fixed size records and shapes that
+///        are only sent when they change
+
+#ifndef COMPACT_OBJECTS__COMPACT_OBJECTS_HPP_
+#define COMPACT_OBJECTS__COMPACT_OBJECTS_HPP_
+
+#include <compact_objects/visibility_control.hpp>
+
+#include <autoware_auto_msgs/msg/detected_objects.hpp>
+#include <autoware_auto_msgs/msg/shape.hpp>
+#include <autoware_auto_msgs/msg/tracked_objects.hpp>
+#include <common/types.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace autoware
+{
+namespace perception
+{
+namespace compact_objects
+{
+using autoware::common::types::bool8_t;
+using autoware::common::types::float32_t;
+
+/// \brief Name of the single uint8 field of a compact object list
+constexpr const char * COMPACT_OBJECTS_FIELD = "compact_objects";
+/// \brief Maximum number of classifications of an object in a compact record
+constexpr std::size_t MAX_CLASSIFICATIONS = 8U;
+/// \brief Shape id of the objects without shape
+constexpr uint32_t NO_SHAPE = 0U;
+
+/// \brief Configuration of the CompactObjectsEncoder
+struct COMPACT_OBJECTS_PUBLIC CompactObjectsConfig
+{
+  /// Step that the vertices relative to the centroid and the heights are rounded to, 0 keeps
+  /// them at float32 precision. Shapes that are equal after the rounding are only sent once.
+  float32_t shape_resolution_m{0.01F};
+  /// Every this many frames all shapes are sent again, so that a subscriber that joined late or
+  /// missed a frame can decode the frames from there on
+  std::size_t key_frame_interval{10U};
+};
+
+/// \brief Check if a point cloud is the output of a CompactObjectsEncoder
+/// \param[in] cloud the point cloud to check
+/// \return true if the cloud has the single field of a compact object list
+COMPACT_OBJECTS_PUBLIC bool8_t is_compact_objects(const sensor_msgs::msg::PointCloud2 & cloud);
+
+/// \brief Encodes DetectedObjects and TrackedObjects into a compact object list.
+///
+/// Each object is a record of fixed size, with its classifications and kinematics, that refers
+/// to its shape by id. The shapes are relative to the centroids of their objects, so that the
+/// shape of an object that keeps its outline while it moves isn't sent again. The definition of
+/// a shape is only sent with the first frame that uses it, and with every key frame. The result
+/// is a PointCloud2 with the header of the input and the bytes in the single uint8 field
+/// COMPACT_OBJECTS_FIELD, so that it's serialized as one block, and records like any other cloud.
+///
+/// The frames of one encoder build on each other, so an encoder should only feed one topic.
+class COMPACT_OBJECTS_PUBLIC CompactObjectsEncoder
+{
+public:
+  /// \brief Constructor
+  /// \param[in] config rounding of the shapes and the key frame interval
+  /// \throw std::domain_error if the resolution is negative or not finite, or the key frame
+  ///        interval is 0
+  explicit CompactObjectsEncoder(const CompactObjectsConfig & config);
+
+  /// \brief Encode detected objects. The data of the output is reused.
+  /// \param[in] objects the objects to encode
+  /// \param[out] compact the compact object list
+  /// \throw std::runtime_error if an object has more than MAX_CLASSIFICATIONS classifications
+  ///        or a shape can't be represented
+  void encode(
+    const autoware_auto_msgs::msg::DetectedObjects & objects,
+    sensor_msgs::msg::PointCloud2 & compact);
+
+  /// \brief Encode tracked objects. All shapes of an object are sent as one shape id.
+  /// \param[in] objects the objects to encode
+  /// \param[out] compact the compact object list
+  /// \throw std::runtime_error if an object has more than MAX_CLASSIFICATIONS classifications
+  ///        or a shape can't be represented
+  void encode(
+    const autoware_auto_msgs::msg::TrackedObjects & objects,
+    sensor_msgs::msg::PointCloud2 & compact);
+
+  /// \brief Make the next frame a key frame, e.g. when frames were skipped
+  void reset() noexcept;
+
+private:
+  template<typename ObjectsT>
+  void encode_objects(const ObjectsT & objects, sensor_msgs::msg::PointCloud2 & compact);
+  /// Get the id of a shape, and append its definition to the frame if it's new
+  uint32_t shape_id(
+    const autoware_auto_msgs::msg::Shape * shapes, std::size_t num_shapes,
+    const geometry_msgs::msg::Point & centroid);
+
+  const CompactObjectsConfig m_config;
+  /// The ids of the rounded shapes of the previous frame, which the decoder knows
+  std::map<std::vector<int64_t>, uint32_t> m_known_shapes;
+  /// The ids of the rounded shapes of the current frame
+  std::map<std::vector<int64_t>, uint32_t> m_frame_shapes;
+  /// Scratch buffers: the rounded shape, the records and the new shape definitions
+  std::vector<int64_t> m_key;
+  std::vector<uint8_t> m_records;
+  std::vector<uint8_t> m_definitions;
+  std::size_t m_num_definitions{0U};
+  uint32_t m_next_shape_id{NO_SHAPE + 1U};
+  std::size_t m_frames_since_key_frame{0U};
+  bool8_t m_key_frame{true};
+};
+
+/// \brief Restores the object lists encoded by a CompactObjectsEncoder
+class COMPACT_OBJECTS_PUBLIC CompactObjectsDecoder
+{
+public:
+  /// \brief Restore detected objects.
+  /// \param[in] compact the compact object list
+  /// \param[out] objects the restored objects with the header of the compact object list, with
+  ///        the shapes rounded like for the encoder
+  /// \throw std::runtime_error if the data isn't a complete compact list of detected objects, or
+  ///        it refers to a shape that was sent in a frame this decoder didn't get. The decoder
+  ///        can continue with the next key frame.
+  void decode(
+    const sensor_msgs::msg::PointCloud2 & compact,
+    autoware_auto_msgs::msg::DetectedObjects & objects);
+
+  /// \brief Restore tracked objects.
+  /// \param[in] compact the compact object list
+  /// \param[out] objects the restored objects with the header of the compact object list
+  /// \throw std::runtime_error if the data isn't a complete compact list of tracked objects, or
+  ///        it refers to a shape that was sent in a frame this decoder didn't get. The decoder
+  ///        can continue with the next key frame.
+  void decode(
+    const sensor_msgs::msg::PointCloud2 & compact,
+    autoware_auto_msgs::msg::TrackedObjects & objects);
+
+private:
+  template<typename ObjectsT>
+  void decode_objects(const sensor_msgs::msg::PointCloud2 & compact, ObjectsT & objects);
+
+  /// The shapes relative to the centroid by id, that the following frames can refer to
+  std::unordered_map<uint32_t, std::vector<autoware_auto_msgs::msg::Shape>> m_shapes;
+  /// The shapes that are defined in the current frame
+  std::unordered_map<uint32_t, std::vector<autoware_auto_msgs::msg::Shape>> m_new_shapes;
+  /// The shapes that the current frame refers to
+  std::unordered_map<uint32_t, std::vector<autoware_auto_msgs::msg::Shape>> m_frame_shapes;
+};
+
+}  // namespace compact_objects
+}  // namespace perception
+}  // namespace autoware
+
+#endif  // COMPACT_OBJECTS__COMPACT_OBJECTS_HPP_
@@ -0,0 +1,661 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "compact_objects/compact_objects.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace autoware
+{
+namespace perception
+{
+namespace compact_objects
+{
+namespace
+{
+using autoware::common::types::float64_t;
+using autoware_auto_msgs::msg::DetectedObject;
+using autoware_auto_msgs::msg::DetectedObjects;
+using autoware_auto_msgs::msg::Shape;
+using autoware_auto_msgs::msg::TrackedObject;
+using autoware_auto_msgs::msg::TrackedObjects;
+using Shapes = std::vector<Shape>;
+
+/// The data starts with "ACO" and the version of the format
+constexpr std::array<uint8_t, 4U> kMagic{{0x41U, 0x43U, 0x4FU, 0x01U}};
+constexpr uint8_t kDetectedObjects = 0x01U;
+constexpr uint8_t kTrackedObjects = 0x02U;
+constexpr uint8_t kKeyFrame = 0x01U;
+/// Magic, kind, flags, 2 reserved bytes, and the sizes of the record, object and definition counts
+constexpr std::size_t kHeaderSize = 20U;
+/// Shape id, existence probability, classification count, flags, orientation availability, a
+/// reserved byte, the classifications, and the centroid, orientation, position covariance and
+/// twist with covariance as float64
+constexpr std::size_t kDetectedRecordSize =
+  12U + (5U * MAX_CLASSIFICATIONS) + (8U * (3U + 4U + 9U + 6U + 36U));
+/// The object id, the detected record, and the acceleration with covariance
+constexpr std::size_t kTrackedRecordSize = 8U + kDetectedRecordSize + (8U * (6U + 36U));
+/// The smallest definition is a shape id and a shape count, the smallest shape a height and a
+/// point count
+constexpr std::size_t kMinDefinitionSize = 8U;
+constexpr std::size_t kMinShapeSize = 8U;
+constexpr std::size_t kPointSize = 3U * sizeof(float32_t);
+constexpr uint8_t kHasPositionCovariance = 0x01U;
+constexpr uint8_t kHasTwist = 0x02U;
+constexpr uint8_t kHasTwistCovariance = 0x04U;
+constexpr uint8_t kIsStationary = 0x01U;
+/// Rounded values are exact integers in a float64
+constexpr float64_t kMaxQuantized = 4503599627370496.0;
+
+/// Reads the data of a compact object list, and throws instead of reading past its end
+class Reader
+{
+public:
+  Reader(const uint8_t * const data, const std::size_t size)
+  : m_data{data}, m_size{size} {}
+
+  uint8_t u8()
+  {
+    if (m_pos >= m_size) {
+      throw std::runtime_error{"CompactObjectsDecoder: the compact object list is truncated"};
+    }
+    return m_data[m_pos++];
+  }
+
+  uint32_t u32()
+  {
+    uint32_t value = 0U;
+    for (uint32_t shift = 0U; shift < 32U; shift += 8U) {
+      value |= static_cast<uint32_t>(u8()) << shift;
+    }
+    return value;
+  }
+
+  uint64_t u64()
+  {
+    uint64_t value = 0U;
+    for (uint32_t shift = 0U; shift < 64U; shift += 8U) {
+      value |= static_cast<uint64_t>(u8()) << shift;
+    }
+    return value;
+  }
+
+  float32_t f32()
+  {
+    const auto bits = u32();
+    float32_t value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  float64_t f64()
+  {
+    const auto bits = u64();
+    float64_t value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  template<std::size_t N>
+  void f64s(std::array<float64_t, N> & values)
+  {
+    for (auto & value : values) {
+      value = f64();
+    }
+  }
+
+  std::size_t remaining() const noexcept
+  {
+    return m_size - m_pos;
+  }
+
+  void seek(const std::size_t pos)
+  {
+    if (pos > m_size) {
+      throw std::runtime_error{"CompactObjectsDecoder: the compact object list is truncated"};
+    }
+    m_pos = pos;
+  }
+
+private:
+  const uint8_t * m_data;
+  std::size_t m_size;
+  std::size_t m_pos{0U};
+};
+
+void put_u32(std::vector<uint8_t> & out, const uint32_t value)
+{
+  for (uint32_t shift = 0U; shift < 32U; shift += 8U) {
+    out.push_back(static_cast<uint8_t>(value >> shift));
+  }
+}
+
+void put_u64(std::vector<uint8_t> & out, const uint64_t value)
+{
+  for (uint32_t shift = 0U; shift < 64U; shift += 8U) {
+    out.push_back(static_cast<uint8_t>(value >> shift));
+  }
+}
+
+void put_f32(std::vector<uint8_t> & out, const float32_t value)
+{
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  put_u32(out, bits);
+}
+
+void put_f64(std::vector<uint8_t> & out, const float64_t value)
+{
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  put_u64(out, bits);
+}
+
+template<std::size_t N>
+void put_f64s(std::vector<uint8_t> & out, const std::array<float64_t, N> & values)
+{
+  for (const auto value : values) {
+    put_f64(out, value);
+  }
+}
+
+void put_point(std::vector<uint8_t> & out, const geometry_msgs::msg::Point & point)
+{
+  put_f64(out, point.x);
+  put_f64(out, point.y);
+  put_f64(out, point.z);
+}
+
+void get_point(Reader & reader, geometry_msgs::msg::Point & point)
+{
+  point.x = reader.f64();
+  point.y = reader.f64();
+  point.z = reader.f64();
+}
+
+void put_quaternion(std::vector<uint8_t> & out, const geometry_msgs::msg::Quaternion & q)
+{
+  put_f64(out, q.x);
+  put_f64(out, q.y);
+  put_f64(out, q.z);
+  put_f64(out, q.w);
+}
+
+void get_quaternion(Reader & reader, geometry_msgs::msg::Quaternion & q)
+{
+  q.x = reader.f64();
+  q.y = reader.f64();
+  q.z = reader.f64();
+  q.w = reader.f64();
+}
+
+void put_vector3(std::vector<uint8_t> & out, const geometry_msgs::msg::Vector3 & vector)
+{
+  put_f64(out, vector.x);
+  put_f64(out, vector.y);
+  put_f64(out, vector.z);
+}
+
+void get_vector3(Reader & reader, geometry_msgs::msg::Vector3 & vector)
+{
+  vector.x = reader.f64();
+  vector.y = reader.f64();
+  vector.z = reader.f64();
+}
+
+/// The part of the records that detected and tracked objects share, up to the twist
+template<typename ObjectT>
+void put_common(
+  std::vector<uint8_t> & out, const ObjectT & object, const uint32_t shape_id,
+  const uint8_t flags)
+{
+  if (object.classification.size() > MAX_CLASSIFICATIONS) {
+    throw std::runtime_error{"CompactObjectsEncoder: an object has too many classifications"};
+  }
+  put_u32(out, shape_id);
+  put_f32(out, object.existence_probability);
+  out.push_back(static_cast<uint8_t>(object.classification.size()));
+  out.push_back(flags);
+  out.push_back(object.kinematics.orientation_availability);
+  out.push_back(0U);
+  for (std::size_t idx = 0U; idx < MAX_CLASSIFICATIONS; ++idx) {
+    out.push_back(
+      (idx < object.classification.size()) ?
+      object.classification[idx].classification : uint8_t{0U});
+  }
+  for (std::size_t idx = 0U; idx < MAX_CLASSIFICATIONS; ++idx) {
+    put_f32(
+      out, (idx < object.classification.size()) ? object.classification[idx].probability : 0.0F);
+  }
+  put_point(out, object.kinematics.centroid_position);
+  put_quaternion(out, object.kinematics.orientation);
+  put_f64s(out, object.kinematics.position_covariance);
+  put_vector3(out, object.kinematics.twist.twist.linear);
+  put_vector3(out, object.kinematics.twist.twist.angular);
+  put_f64s(out, object.kinematics.twist.covariance);
+}
+
+/// Read what put_common() wrote
+/// \return the shape id and the flags
+template<typename ObjectT>
+std::pair<uint32_t, uint8_t> get_common(Reader & reader, ObjectT & object)
+{
+  const auto shape_id = reader.u32();
+  object.existence_probability = reader.f32();
+  const auto num_classifications = reader.u8();
+  const auto flags = reader.u8();
+  object.kinematics.orientation_availability = reader.u8();
+  (void)reader.u8();
+  if (num_classifications > MAX_CLASSIFICATIONS) {
+    throw std::runtime_error{"CompactObjectsDecoder: an object has too many classifications"};
+  }
+  object.classification.resize(num_classifications);
+  std::array<uint8_t, MAX_CLASSIFICATIONS> classes{};
+  for (auto & cls : classes) {
+    cls = reader.u8();
+  }
+  for (std::size_t idx = 0U; idx < MAX_CLASSIFICATIONS; ++idx) {
+    const auto probability = reader.f32();
+    if (idx < object.classification.size()) {
+      object.classification[idx].classification = classes[idx];
+      object.classification[idx].probability = probability;
+    }
+  }
+  get_point(reader, object.kinematics.centroid_position);
+  get_quaternion(reader, object.kinematics.orientation);
+  reader.f64s(object.kinematics.position_covariance);
+  get_vector3(reader, object.kinematics.twist.twist.linear);
+  get_vector3(reader, object.kinematics.twist.twist.angular);
+  reader.f64s(object.kinematics.twist.covariance);
+  return {shape_id, flags};
+}
+
+void put_record(std::vector<uint8_t> & out, const DetectedObject & object, const uint32_t shape_id)
+{
+  const auto & kinematics = object.kinematics;
+  put_common(
+    out, object, shape_id,
+    static_cast<uint8_t>((kinematics.has_position_covariance ? kHasPositionCovariance : 0U) |
+    (kinematics.has_twist ? kHasTwist : 0U) |
+    (kinematics.has_twist_covariance ? kHasTwistCovariance : 0U)));
+}
+
+uint32_t get_record(Reader & reader, DetectedObject & object)
+{
+  const auto shape_and_flags = get_common(reader, object);
+  auto & kinematics = object.kinematics;
+  kinematics.has_position_covariance = (shape_and_flags.second & kHasPositionCovariance) != 0U;
+  kinematics.has_twist = (shape_and_flags.second & kHasTwist) != 0U;
+  kinematics.has_twist_covariance = (shape_and_flags.second & kHasTwistCovariance) != 0U;
+  return shape_and_flags.first;
+}
+
+void put_record(std::vector<uint8_t> & out, const TrackedObject & object, const uint32_t shape_id)
+{
+  put_u64(out, object.object_id);
+  put_common(
+    out, object, shape_id, object.kinematics.is_stationary ? kIsStationary : uint8_t{0U});
+  put_vector3(out, object.kinematics.acceleration.accel.linear);
+  put_vector3(out, object.kinematics.acceleration.accel.angular);
+  put_f64s(out, object.kinematics.acceleration.covariance);
+}
+
+uint32_t get_record(Reader & reader, TrackedObject & object)
+{
+  object.object_id = reader.u64();
+  const auto shape_and_flags = get_common(reader, object);
+  object.kinematics.is_stationary = (shape_and_flags.second & kIsStationary) != 0U;
+  get_vector3(reader, object.kinematics.acceleration.accel.linear);
+  get_vector3(reader, object.kinematics.acceleration.accel.angular);
+  reader.f64s(object.kinematics.acceleration.covariance);
+  return shape_and_flags.first;
+}
+
+uint8_t kind(const DetectedObjects &) {return kDetectedObjects;}
+uint8_t kind(const TrackedObjects &) {return kTrackedObjects;}
+std::size_t record_size(const DetectedObjects &) {return kDetectedRecordSize;}
+std::size_t record_size(const TrackedObjects &) {return kTrackedRecordSize;}
+const Shape * shapes(const DetectedObject & object) {return &object.shape;}
+const Shape * shapes(const TrackedObject & object) {return object.shape.data();}
+std::size_t num_shapes(const DetectedObject &) {return 1U;}
+std::size_t num_shapes(const TrackedObject & object) {return object.shape.size();}
+
+/// Move the shapes relative to the centroid back to the object
+void set_shapes(
+  const Shapes & relative, const geometry_msgs::msg::Point & centroid, Shape * const shapes)
+{
+  for (std::size_t idx = 0U; idx < relative.size(); ++idx) {
+    shapes[idx].height = relative[idx].height;
+    shapes[idx].polygon.points.resize(relative[idx].polygon.points.size());
+    for (std::size_t pt_idx = 0U; pt_idx < relative[idx].polygon.points.size(); ++pt_idx) {
+      const auto & offset = relative[idx].polygon.points[pt_idx];
+      auto & pt = shapes[idx].polygon.points[pt_idx];
+      pt.x = static_cast<float32_t>(centroid.x + static_cast<float64_t>(offset.x));
+      pt.y = static_cast<float32_t>(centroid.y + static_cast<float64_t>(offset.y));
+      pt.z = static_cast<float32_t>(centroid.z + static_cast<float64_t>(offset.z));
+    }
+  }
+}
+
+void set_shapes(const Shapes & relative, DetectedObject & object)
+{
+  if (relative.size() != 1U) {
+    throw std::runtime_error{"CompactObjectsDecoder: a detected object needs exactly one shape"};
+  }
+  set_shapes(relative, object.kinematics.centroid_position, &object.shape);
+}
+
+void set_shapes(const Shapes & relative, TrackedObject & object)
+{
+  object.shape.resize(relative.size());
+  set_shapes(relative, object.kinematics.centroid_position, object.shape.data());
+}
+
+int64_t quantize(const float64_t value, const float32_t resolution)
+{
+  if (resolution > 0.0F) {
+    const auto scaled = value / static_cast<float64_t>(resolution);
+    // Also rejects NaN
+    if (!(std::fabs(scaled) < kMaxQuantized)) {
+      throw std::runtime_error{"CompactObjectsEncoder: a shape can't be rounded"};
+    }
+    return std::llround(scaled);
+  }
+  const auto value32 = static_cast<float32_t>(value);
+  uint32_t bits;
+  std::memcpy(&bits, &value32, sizeof(bits));
+  return static_cast<int64_t>(bits);
+}
+
+float32_t dequantize(const int64_t code, const float32_t resolution)
+{
+  if (resolution > 0.0F) {
+    return static_cast<float32_t>(static_cast<float64_t>(code) *
+           static_cast<float64_t>(resolution));
+  }
+  const auto bits = static_cast<uint32_t>(code);
+  float32_t value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+}  // namespace
+
+bool8_t is_compact_objects(const sensor_msgs::msg::PointCloud2 & cloud)
+{
+  return (cloud.fields.size() == 1U) && (cloud.fields[0U].name == COMPACT_OBJECTS_FIELD) &&
+         (cloud.fields[0U].datatype == sensor_msgs::msg::PointField::UINT8) &&
+         (cloud.point_step == 1U) && (cloud.height == 1U) && (cloud.data.size() == cloud.width);
+}
+
+CompactObjectsEncoder::CompactObjectsEncoder(const CompactObjectsConfig & config)
+: m_config{config}
+{
+  if (!std::isfinite(m_config.shape_resolution_m) || (m_config.shape_resolution_m < 0.0F)) {
+    throw std::domain_error{"CompactObjectsEncoder: shape_resolution_m must be finite and >= 0"};
+  }
+  if (m_config.key_frame_interval == 0U) {
+    throw std::domain_error{"CompactObjectsEncoder: key_frame_interval must be positive"};
+  }
+}
+
+void CompactObjectsEncoder::encode(
+  const autoware_auto_msgs::msg::DetectedObjects & objects,
+  sensor_msgs::msg::PointCloud2 & compact)
+{
+  encode_objects(objects, compact);
+}
+
+void CompactObjectsEncoder::encode(
+  const autoware_auto_msgs::msg::TrackedObjects & objects,
+  sensor_msgs::msg::PointCloud2 & compact)
+{
+  encode_objects(objects, compact);
+}
+
+void CompactObjectsEncoder::reset() noexcept
+{
+  m_key_frame = true;
+}
+
+template<typename ObjectsT>
+void CompactObjectsEncoder::encode_objects(
+  const ObjectsT & objects,
+  sensor_msgs::msg::PointCloud2 & compact)
+{
+  if (objects.objects.size() > std::numeric_limits<uint32_t>::max()) {
+    throw std::runtime_error{"CompactObjectsEncoder: too many objects"};
+  }
+  // Each object adds at most one shape. The ids only start over with a key frame, when the
+  // decoder forgets the previous ones.
+  const auto max_new_id = std::numeric_limits<uint32_t>::max() - objects.objects.size();
+  if (m_next_shape_id > max_new_id) {
+    m_next_shape_id = NO_SHAPE + 1U;
+    m_key_frame = true;
+  }
+  if (m_frames_since_key_frame >= m_config.key_frame_interval) {
+    m_key_frame = true;
+  }
+  if (m_key_frame) {
+    m_known_shapes.clear();
+  }
+  m_frame_shapes.clear();
+  m_records.clear();
+  m_definitions.clear();
+  m_num_definitions = 0U;
+  for (const auto & object : objects.objects) {
+    put_record(
+      m_records, object,
+      shape_id(shapes(object), num_shapes(object), object.kinematics.centroid_position));
+  }
+
+  auto & out = compact.data;
+  out.clear();
+  out.reserve(kHeaderSize + m_records.size() + m_definitions.size());
+  for (const auto magic : kMagic) {
+    out.push_back(magic);
+  }
+  out.push_back(kind(objects));
+  out.push_back(m_key_frame ? kKeyFrame : uint8_t{0U});
+  out.push_back(0U);
+  out.push_back(0U);
+  put_u32(out, static_cast<uint32_t>(record_size(objects)));
+  put_u32(out, static_cast<uint32_t>(objects.objects.size()));
+  put_u32(out, static_cast<uint32_t>(m_num_definitions));
+  out.insert(out.end(), m_records.cbegin(), m_records.cend());
+  out.insert(out.end(), m_definitions.cbegin(), m_definitions.cend());
+
+  compact.header = objects.header;
+  if (!is_compact_objects(compact)) {
+    sensor_msgs::msg::PointField field;
+    field.name = COMPACT_OBJECTS_FIELD;
+    field.offset = 0U;
+    field.datatype = sensor_msgs::msg::PointField::UINT8;
+    field.count = 1U;
+    compact.fields.assign(1U, field);
+  }
+  compact.height = 1U;
+  compact.width = static_cast<uint32_t>(out.size());
+  compact.point_step = 1U;
+  compact.row_step = compact.width;
+  compact.is_bigendian = false;
+  compact.is_dense = true;
+
+  // The decoder knows the shapes of this frame from now on, and only those
+  std::swap(m_known_shapes, m_frame_shapes);
+  m_frames_since_key_frame = m_key_frame ? 1U : (m_frames_since_key_frame + 1U);
+  m_key_frame = false;
+}
+
+uint32_t CompactObjectsEncoder::shape_id(
+  const autoware_auto_msgs::msg::Shape * const shapes, const std::size_t num_shapes,
+  const geometry_msgs::msg::Point & centroid)
+{
+  if (num_shapes == 0U) {
+    return NO_SHAPE;
+  }
+  const auto resolution = m_config.shape_resolution_m;
+  m_key.clear();
+  m_key.push_back(static_cast<int64_t>(num_shapes));
+  for (std::size_t idx = 0U; idx < num_shapes; ++idx) {
+    const auto & points = shapes[idx].polygon.points;
+    m_key.push_back(quantize(static_cast<float64_t>(shapes[idx].height), resolution));
+    m_key.push_back(static_cast<int64_t>(points.size()));
+    for (const auto & pt : points) {
+      m_key.push_back(quantize(static_cast<float64_t>(pt.x) - centroid.x, resolution));
+      m_key.push_back(quantize(static_cast<float64_t>(pt.y) - centroid.y, resolution));
+      m_key.push_back(quantize(static_cast<float64_t>(pt.z) - centroid.z, resolution));
+    }
+  }
+  const auto frame_it = m_frame_shapes.find(m_key);
+  if (frame_it != m_frame_shapes.end()) {
+    return frame_it->second;
+  }
+  const auto known_it = m_known_shapes.find(m_key);
+  if (known_it != m_known_shapes.end()) {
+    return m_frame_shapes.emplace(m_key, known_it->second).first->second;
+  }
+
+  const auto id = m_next_shape_id++;
+  put_u32(m_definitions, id);
+  put_u32(m_definitions, static_cast<uint32_t>(num_shapes));
+  auto code = m_key.cbegin() + 1;
+  for (std::size_t idx = 0U; idx < num_shapes; ++idx) {
+    put_f32(m_definitions, dequantize(*code++, resolution));
+    const auto num_points = static_cast<std::size_t>(*code++);
+    if (num_points > std::numeric_limits<uint32_t>::max()) {
+      throw std::runtime_error{"CompactObjectsEncoder: a shape has too many points"};
+    }
+    put_u32(m_definitions, static_cast<uint32_t>(num_points));
+    for (std::size_t coord = 0U; coord < (3U * num_points); ++coord) {
+      put_f32(m_definitions, dequantize(*code++, resolution));
+    }
+  }
+  ++m_num_definitions;
+  m_frame_shapes.emplace(m_key, id);
+  return id;
+}
+
+void CompactObjectsDecoder::decode(
+  const sensor_msgs::msg::PointCloud2 & compact,
+  autoware_auto_msgs::msg::DetectedObjects & objects)
+{
+  decode_objects(compact, objects);
+}
+
+void CompactObjectsDecoder::decode(
+  const sensor_msgs::msg::PointCloud2 & compact,
+  autoware_auto_msgs::msg::TrackedObjects & objects)
+{
+  decode_objects(compact, objects);
+}
+
+template<typename ObjectsT>
+void CompactObjectsDecoder::decode_objects(
+  const sensor_msgs::msg::PointCloud2 & compact,
+  ObjectsT & objects)
+{
+  if (!is_compact_objects(compact)) {
+    throw std::runtime_error{"CompactObjectsDecoder: the cloud isn't a compact object list"};
+  }
+  Reader reader{compact.data.data(), compact.data.size()};
+  for (const auto magic : kMagic) {
+    if (reader.u8() != magic) {
+      throw std::runtime_error{"CompactObjectsDecoder: unknown format of the compact objects"};
+    }
+  }
+  if (reader.u8() != kind(objects)) {
+    throw std::runtime_error{"CompactObjectsDecoder: the compact objects are of another type"};
+  }
+  const auto flags = reader.u8();
+  (void)reader.u8();
+  (void)reader.u8();
+  if (((flags & ~kKeyFrame) != 0U) || (reader.u32() != record_size(objects))) {
+    throw std::runtime_error{"CompactObjectsDecoder: unknown format of the compact objects"};
+  }
+  const bool8_t key_frame = (flags & kKeyFrame) != 0U;
+  const std::size_t num_objects = reader.u32();
+  const std::size_t num_definitions = reader.u32();
+  if ((num_objects > (reader.remaining() / record_size(objects))) ||
+    (num_definitions > (reader.remaining() / kMinDefinitionSize)))
+  {
+    throw std::runtime_error{"CompactObjectsDecoder: the compact object list is truncated"};
+  }
+
+  // The definitions follow the records
+  const auto records_pos = kHeaderSize;
+  reader.seek(records_pos + (num_objects * record_size(objects)));
+  m_new_shapes.clear();
+  for (std::size_t def = 0U; def < num_definitions; ++def) {
+    const auto id = reader.u32();
+    const std::size_t count = reader.u32();
+    if ((id == NO_SHAPE) || (count == 0U) || (count > (reader.remaining() / kMinShapeSize))) {
+      throw std::runtime_error{"CompactObjectsDecoder: malformed shape definition"};
+    }
+    auto & shapes = m_new_shapes[id];
+    shapes.resize(count);
+    for (auto & shape : shapes) {
+      shape.height = reader.f32();
+      const std::size_t num_points = reader.u32();
+      if (num_points > (reader.remaining() / kPointSize)) {
+        throw std::runtime_error{"CompactObjectsDecoder: the compact object list is truncated"};
+      }
+      shape.polygon.points.resize(num_points);
+      for (auto & pt : shape.polygon.points) {
+        pt.x = reader.f32();
+        pt.y = reader.f32();
+        pt.z = reader.f32();
+      }
+    }
+  }
+
+  reader.seek(records_pos);
+  m_frame_shapes.clear();
+  objects.objects.resize(num_objects);
+  for (auto & object : objects.objects) {
+    const auto id = get_record(reader, object);
+    if (id == NO_SHAPE) {
+      set_shapes(Shapes{}, object);
+      continue;
+    }
+    auto frame_it = m_frame_shapes.find(id);
+    if (frame_it == m_frame_shapes.end()) {
+      const auto new_it = m_new_shapes.find(id);
+      const auto known_it = m_shapes.find(id);
+      if (new_it != m_new_shapes.end()) {
+        frame_it = m_frame_shapes.emplace(id, std::move(new_it->second)).first;
+        m_new_shapes.erase(new_it);
+      } else if ((!key_frame) && (known_it != m_shapes.end())) {
+        frame_it = m_frame_shapes.emplace(id, known_it->second).first;
+      } else {
+        throw std::runtime_error{
+                "CompactObjectsDecoder: unknown shape, a frame was missed or the decoder started "
+                "after the last key frame"};
+      }
+    }
+    set_shapes(frame_it->second, object);
+  }
+  objects.header = compact.header;
+  std::swap(m_shapes, m_frame_shapes);
+}
+
+}  // namespace compact_objects
+}  // namespace perception
+}  // namespace autoware
@@ -0,0 +1,301 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <compact_objects/compact_objects.hpp>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using autoware::common::types::float32_t;
+using autoware::common::types::float64_t;
+using autoware::perception::compact_objects::CompactObjectsConfig;
+using autoware::perception::compact_objects::CompactObjectsDecoder;
+using autoware::perception::compact_objects::CompactObjectsEncoder;
+using autoware::perception::compact_objects::is_compact_objects;
+using autoware_auto_msgs::msg::DetectedObject;
+using autoware_auto_msgs::msg::DetectedObjects;
+using autoware_auto_msgs::msg::ObjectClassification;
+using autoware_auto_msgs::msg::Shape;
+using autoware_auto_msgs::msg::TrackedObject;
+using autoware_auto_msgs::msg::TrackedObjects;
+using sensor_msgs::msg::PointCloud2;
+
+namespace
+{
+/// An upright box around a centroid, like the shapes of the euclidean cluster
+Shape make_box(
+  const float64_t x, const float64_t y, const float32_t length, const float32_t width)
+{
+  Shape shape;
+  shape.height = 1.5F;
+  for (const auto & corner : std::vector<std::pair<float32_t, float32_t>>{
+      {1.0F, 1.0F}, {-1.0F, 1.0F}, {-1.0F, -1.0F}, {1.0F, -1.0F}})
+  {
+    geometry_msgs::msg::Point32 pt;
+    pt.x = static_cast<float32_t>(x) + (0.5F * length * corner.first);
+    pt.y = static_cast<float32_t>(y) + (0.5F * width * corner.second);
+    pt.z = -0.25F;
+    shape.polygon.points.push_back(pt);
+  }
+  return shape;
+}
+
+DetectedObject make_detection(const float64_t x, const float64_t y, const float32_t length)
+{
+  DetectedObject object;
+  object.existence_probability = 0.75F;
+  ObjectClassification classification;
+  classification.classification = ObjectClassification::CAR;
+  classification.probability = 0.8F;
+  object.classification.push_back(classification);
+  classification.classification = ObjectClassification::TRUCK;
+  classification.probability = 0.2F;
+  object.classification.push_back(classification);
+  object.kinematics.centroid_position.x = x;
+  object.kinematics.centroid_position.y = y;
+  object.kinematics.centroid_position.z = 0.5;
+  object.kinematics.position_covariance[4U] = 0.25;
+  object.kinematics.has_position_covariance = true;
+  object.kinematics.twist.twist.linear.x = 3.0;
+  object.kinematics.twist.covariance[35U] = 0.5;
+  object.kinematics.has_twist = true;
+  object.shape = make_box(x, y, length, 2.0F);
+  return object;
+}
+
+TrackedObject make_track(const uint64_t id, const float64_t x, const float64_t y)
+{
+  TrackedObject object;
+  object.object_id = id;
+  object.existence_probability = 0.5F;
+  ObjectClassification classification;
+  classification.classification = ObjectClassification::PEDESTRIAN;
+  classification.probability = 1.0F;
+  object.classification.push_back(classification);
+  object.kinematics.centroid_position.x = x;
+  object.kinematics.centroid_position.y = y;
+  object.kinematics.position_covariance[0U] = 0.1;
+  object.kinematics.orientation.z = 0.6;
+  object.kinematics.orientation.w = 0.8;
+  object.kinematics.twist.twist.angular.z = 0.3;
+  object.kinematics.acceleration.accel.linear.y = -1.0;
+  object.kinematics.acceleration.covariance[7U] = 2.0;
+  object.kinematics.is_stationary = true;
+  object.shape.push_back(make_box(x, y, 0.5F, 0.5F));
+  return object;
+}
+
+void expect_shape_near(const Shape & expected, const Shape & actual, const float32_t tolerance)
+{
+  EXPECT_NEAR(expected.height, actual.height, tolerance);
+  ASSERT_EQ(expected.polygon.points.size(), actual.polygon.points.size());
+  for (std::size_t idx = 0U; idx < expected.polygon.points.size(); ++idx) {
+    EXPECT_NEAR(expected.polygon.points[idx].x, actual.polygon.points[idx].x, tolerance);
+    EXPECT_NEAR(expected.polygon.points[idx].y, actual.polygon.points[idx].y, tolerance);
+    EXPECT_NEAR(expected.polygon.points[idx].z, actual.polygon.points[idx].z, tolerance);
+  }
+}
+
+DetectedObjects make_detections(const float64_t offset)
+{
+  DetectedObjects objects;
+  objects.header.frame_id = "base_link";
+  objects.header.stamp.sec = 12;
+  objects.objects.push_back(make_detection(10.0 + offset, -2.0, 4.0F));
+  objects.objects.push_back(make_detection(-5.0 + offset, 3.0, 4.0F));
+  return objects;
+}
+}  // namespace
+
+TEST(TestCompactObjects, detected_objects_round_trip)
+{
+  CompactObjectsEncoder encoder{CompactObjectsConfig{}};
+  CompactObjectsDecoder decoder;
+  auto objects = make_detections(0.0);
+  objects.objects[1U].classification.clear();
+  objects.objects[1U].kinematics.has_twist = false;
+  objects.objects[1U].kinematics.has_twist_covariance = true;
+  PointCloud2 compact;
+  encoder.encode(objects, compact);
+  EXPECT_TRUE(is_compact_objects(compact));
+  EXPECT_EQ(compact.header.frame_id, "base_link");
+
+  DetectedObjects decoded;
+  decoder.decode(compact, decoded);
+  EXPECT_EQ(decoded.header.frame_id, "base_link");
+  EXPECT_EQ(decoded.header.stamp.sec, 12);
+  ASSERT_EQ(decoded.objects.size(), 2U);
+  for (std::size_t idx = 0U; idx < objects.objects.size(); ++idx) {
+    const auto & expected = objects.objects[idx];
+    const auto & actual = decoded.objects[idx];
+    EXPECT_EQ(actual.existence_probability, expected.existence_probability);
+    ASSERT_EQ(actual.classification.size(), expected.classification.size());
+    for (std::size_t cls = 0U; cls < expected.classification.size(); ++cls) {
+      EXPECT_EQ(
+        actual.classification[cls].classification, expected.classification[cls].classification);
+      EXPECT_EQ(actual.classification[cls].probability, expected.classification[cls].probability);
+    }
+    EXPECT_EQ(actual.kinematics.centroid_position.x, expected.kinematics.centroid_position.x);
+    EXPECT_EQ(actual.kinematics.centroid_position.z, expected.kinematics.centroid_position.z);
+    EXPECT_EQ(actual.kinematics.position_covariance, expected.kinematics.position_covariance);
+    EXPECT_EQ(actual.kinematics.has_position_covariance, true);
+    EXPECT_EQ(actual.kinematics.twist.twist.linear.x, 3.0);
+    EXPECT_EQ(actual.kinematics.twist.covariance, expected.kinematics.twist.covariance);
+    EXPECT_EQ(actual.kinematics.has_twist, expected.kinematics.has_twist);
+    EXPECT_EQ(actual.kinematics.has_twist_covariance, expected.kinematics.has_twist_covariance);
+    expect_shape_near(expected.shape, actual.shape, 0.005F + 1.0e-5F);
+  }
+}
+
+TEST(TestCompactObjects, tracked_objects_round_trip)
+{
+  CompactObjectsEncoder encoder{CompactObjectsConfig{0.0F, 10U}};
+  CompactObjectsDecoder decoder;
+  TrackedObjects objects;
+  objects.objects.push_back(make_track(7U, 1.0, 2.0));
+  objects.objects.push_back(make_track(std::numeric_limits<uint64_t>::max(), 30.0, -4.0));
+  objects.objects[1U].shape.push_back(make_box(30.0, -4.0, 2.0F, 1.0F));
+  objects.objects.push_back(make_track(9U, 0.0, 0.0));
+  objects.objects[2U].shape.clear();
+  PointCloud2 compact;
+  encoder.encode(objects, compact);
+
+  TrackedObjects decoded;
+  decoder.decode(compact, decoded);
+  ASSERT_EQ(decoded.objects.size(), 3U);
+  for (std::size_t idx = 0U; idx < objects.objects.size(); ++idx) {
+    const auto & expected = objects.objects[idx];
+    const auto & actual = decoded.objects[idx];
+    EXPECT_EQ(actual.object_id, expected.object_id);
+    EXPECT_EQ(actual.kinematics.orientation.z, 0.6);
+    EXPECT_EQ(actual.kinematics.orientation.w, 0.8);
+    EXPECT_EQ(actual.kinematics.twist.twist.angular.z, 0.3);
+    EXPECT_EQ(actual.kinematics.acceleration.accel.linear.y, -1.0);
+    EXPECT_EQ(
+      actual.kinematics.acceleration.covariance, expected.kinematics.acceleration.covariance);
+    EXPECT_TRUE(actual.kinematics.is_stationary);
+    ASSERT_EQ(actual.shape.size(), expected.shape.size());
+    for (std::size_t shape = 0U; shape < expected.shape.size(); ++shape) {
+      expect_shape_near(expected.shape[shape], actual.shape[shape], 1.0e-5F);
+    }
+  }
+}
+
+TEST(TestCompactObjects, shapes_are_only_sent_when_they_change)
+{
+  CompactObjectsEncoder encoder{CompactObjectsConfig{0.01F, 100U}};
+  CompactObjectsDecoder decoder;
+  PointCloud2 first;
+  PointCloud2 moved;
+  PointCloud2 changed;
+  // Both objects have the same outline, so even the first frame only defines it once
+  encoder.encode(make_detections(0.0), first);
+  const auto objects = make_detections(1.5);
+  encoder.encode(objects, moved);
+  auto changed_objects = make_detections(3.0);
+  changed_objects.objects[0U].shape = make_box(13.0, -2.0, 5.0F, 2.0F);
+  encoder.encode(changed_objects, changed);
+  const auto definition_size = first.data.size() - moved.data.size();
+  EXPECT_GT(definition_size, 0U);
+  EXPECT_EQ(changed.data.size(), moved.data.size() + definition_size);
+
+  DetectedObjects decoded;
+  decoder.decode(first, decoded);
+  decoder.decode(moved, decoded);
+  ASSERT_EQ(decoded.objects.size(), 2U);
+  expect_shape_near(objects.objects[0U].shape, decoded.objects[0U].shape, 0.006F);
+  expect_shape_near(objects.objects[1U].shape, decoded.objects[1U].shape, 0.006F);
+  decoder.decode(changed, decoded);
+  expect_shape_near(changed_objects.objects[0U].shape, decoded.objects[0U].shape, 0.006F);
+  expect_shape_near(changed_objects.objects[1U].shape, decoded.objects[1U].shape, 0.006F);
+}
+
+TEST(TestCompactObjects, late_decoder_recovers_with_key_frame)
+{
+  CompactObjectsEncoder encoder{CompactObjectsConfig{0.01F, 3U}};
+  CompactObjectsDecoder decoder;
+  CompactObjectsDecoder late_decoder;
+  PointCloud2 compact;
+  DetectedObjects decoded;
+  for (std::size_t frame = 0U; frame < 7U; ++frame) {
+    auto objects = make_detections(0.1 * static_cast<float64_t>(frame));
+    // A new outline in every frame
+    objects.objects[0U].shape = make_box(
+      objects.objects[0U].kinematics.centroid_position.x, -2.0,
+      4.0F + (0.1F * static_cast<float32_t>(frame)), 2.0F);
+    encoder.encode(objects, compact);
+    decoder.decode(compact, decoded);
+    expect_shape_near(objects.objects[0U].shape, decoded.objects[0U].shape, 0.006F);
+    if (frame == 0U) {
+      continue;
+    }
+    // The late decoder gets the frames from the second one on, and can decode the frames from
+    // the second key frame on
+    if (frame < 3U) {
+      EXPECT_THROW(late_decoder.decode(compact, decoded), std::runtime_error);
+    } else {
+      late_decoder.decode(compact, decoded);
+      expect_shape_near(objects.objects[1U].shape, decoded.objects[1U].shape, 0.006F);
+    }
+  }
+
+  // After a reset, the next frame defines all shapes again
+  encoder.reset();
+  encoder.encode(make_detections(1.0), compact);
+  CompactObjectsDecoder new_decoder;
+  EXPECT_NO_THROW(new_decoder.decode(compact, decoded));
+}
+
+TEST(TestCompactObjects, bad_input)
+{
+  EXPECT_THROW(CompactObjectsEncoder(CompactObjectsConfig{-0.1F, 10U}), std::domain_error);
+  EXPECT_THROW(
+    CompactObjectsEncoder(
+      CompactObjectsConfig{std::numeric_limits<float32_t>::quiet_NaN(), 10U}),
+    std::domain_error);
+  EXPECT_THROW(CompactObjectsEncoder(CompactObjectsConfig{0.1F, 0U}), std::domain_error);
+
+  CompactObjectsEncoder encoder{CompactObjectsConfig{}};
+  auto objects = make_detections(0.0);
+  objects.objects[0U].classification.resize(9U);
+  PointCloud2 compact;
+  EXPECT_THROW(encoder.encode(objects, compact), std::runtime_error);
+  objects.objects[0U].shape.polygon.points[0U].x = std::numeric_limits<float32_t>::infinity();
+  objects.objects[0U].classification.resize(1U);
+  EXPECT_THROW(encoder.encode(objects, compact), std::runtime_error);
+
+  encoder.encode(make_detections(0.0), compact);
+  CompactObjectsDecoder decoder;
+  // A list of detected objects isn't a list of tracked objects
+  TrackedObjects tracked;
+  EXPECT_THROW(decoder.decode(compact, tracked), std::runtime_error);
+  // Other clouds aren't compact object lists
+  auto cloud = compact;
+  cloud.point_step = 4U;
+  DetectedObjects decoded;
+  EXPECT_THROW(decoder.decode(cloud, decoded), std::runtime_error);
+  // Every truncation is detected
+  for (std::size_t size = 0U; size < compact.data.size(); ++size) {
+    cloud = compact;
+    cloud.data.resize(size);
+    cloud.width = static_cast<uint32_t>(size);
+    cloud.row_step = cloud.width;
+    EXPECT_THROW(decoder.decode(cloud, decoded), std::runtime_error) << size;
+  }
+  EXPECT_NO_THROW(decoder.decode(compact, decoded));
+}
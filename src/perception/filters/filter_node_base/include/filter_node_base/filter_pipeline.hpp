@@ -0,0 +1,99 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \copyright Copyright 2021 the Autoware Foundation
+/// \file
+/// \brief This file defines the FilterStage and FilterPipeline classes.
+
+#ifndef FILTER_NODE_BASE__FILTER_PIPELINE_HPP_
+#define FILTER_NODE_BASE__FILTER_PIPELINE_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "filter_node_base/visibility_control.hpp"
+#include "sensor_msgs/msg/point_cloud2.hpp"
+
+
+namespace autoware
+{
+namespace perception
+{
+namespace filters
+{
+namespace filter_node_base
+{
+
+/// \class FilterStage
+/// \brief The abstract class for filters that can be chained in a FilterPipeline
+///
+/// Instead of creating a new point cloud, a stage narrows down the selection of the points of the
+/// input cloud that are kept, so the points are only copied once after the last stage.
+class FILTER_NODE_BASE_PUBLIC FilterStage
+{
+public:
+  virtual ~FilterStage() {}
+
+  /** \brief Remove the points that do not pass this filter from the selection
+   * \param input The input point cloud, shared by all stages of a pipeline and not modified
+   * \param indices The indices of the selected points in ascending order, replaced by the ones that
+   * pass this filter, still in ascending order
+   */
+  virtual void filter(
+    const sensor_msgs::msg::PointCloud2 & input,
+    std::vector<std::size_t> & indices) = 0;
+};
+
+/// \class FilterPipeline
+/// \brief Applies several filter stages one after the other to a point cloud, e.g. in the
+/// callback of a single node instead of a chain of nodes which each publish an intermediate cloud
+class FILTER_NODE_BASE_PUBLIC FilterPipeline
+{
+public:
+  /** \brief Add a stage after all stages that were added before
+   * \param stage The stage, must not be null
+   * \throw std::invalid_argument If the stage is null
+   */
+  void add_stage(std::shared_ptr<FilterStage> stage);
+
+  /** \brief The number of stages of the pipeline */
+  std::size_t size() const noexcept;
+
+  /** \brief Run all stages on the input and copy the points that pass all of them
+   *
+   * Stops early once no point is left. Exceptions thrown by a stage are passed on.
+   *
+   * \param input The input point cloud
+   * \param output The output point cloud, replaced by the points of input which pass all stages,
+   * with all their fields, as a single row. Must not be the same message as input
+   * \throw std::runtime_error If input has less data than its size
+   */
+  void filter(
+    const sensor_msgs::msg::PointCloud2 & input,
+    sensor_msgs::msg::PointCloud2 & output);
+
+private:
+  /** \brief The stages in the order in which they are applied */
+  std::vector<std::shared_ptr<FilterStage>> stages_;
+
+  /** \brief The selection passed between the stages, kept to avoid allocations */
+  std::vector<std::size_t> indices_;
+};
+}  // namespace filter_node_base
+}  // namespace filters
+}  // namespace perception
+}  // namespace autoware
+
+#endif  // FILTER_NODE_BASE__FILTER_PIPELINE_HPP_
@@ -0,0 +1,93 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "filter_node_base/filter_pipeline.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+
+namespace autoware
+{
+namespace perception
+{
+namespace filters
+{
+namespace filter_node_base
+{
+
+void FilterPipeline::add_stage(std::shared_ptr<FilterStage> stage)
+{
+  if (!stage) {
+    throw std::invalid_argument("FilterPipeline: A stage must not be null");
+  }
+  stages_.push_back(std::move(stage));
+}
+
+std::size_t FilterPipeline::size() const noexcept
+{
+  return stages_.size();
+}
+
+void FilterPipeline::filter(
+  const sensor_msgs::msg::PointCloud2 & input,
+  sensor_msgs::msg::PointCloud2 & output)
+{
+  const std::size_t num_points = static_cast<std::size_t>(input.width) * input.height;
+  const std::size_t min_data_size = (num_points == 0U) ? 0U :
+    (static_cast<std::size_t>(input.height - 1U) * input.row_step +
+    static_cast<std::size_t>(input.width) * input.point_step);
+  if (input.data.size() < min_data_size) {
+    throw std::runtime_error("FilterPipeline: Point cloud data is smaller than its size");
+  }
+
+  indices_.resize(num_points);
+  std::iota(indices_.begin(), indices_.end(), std::size_t{0U});
+  for (const auto & stage : stages_) {
+    if (indices_.empty()) {
+      break;
+    }
+    stage->filter(input, indices_);
+  }
+
+  // Compact the selected points into a single row
+  output.header = input.header;
+  output.fields = input.fields;
+  output.is_bigendian = input.is_bigendian;
+  output.point_step = input.point_step;
+  output.height = 1U;
+  output.width = static_cast<std::uint32_t>(indices_.size());
+  output.row_step = output.width * output.point_step;
+  output.is_dense = input.is_dense;
+  output.data.resize(static_cast<std::size_t>(output.row_step));
+  for (std::size_t j = 0U; j < indices_.size(); ++j) {
+    const std::size_t idx = indices_[j];
+    if (idx >= num_points) {
+      throw std::runtime_error("FilterPipeline: A stage selected a point that is not in the cloud");
+    }
+    const std::size_t offset = (idx / input.width) * input.row_step +
+      (idx % input.width) * input.point_step;
+    std::memcpy(&output.data[j * output.point_step], &input.data[offset], output.point_step);
+  }
+}
+
+}  // namespace filter_node_base
+}  // namespace filters
+}  // namespace perception
+}  // namespace autoware
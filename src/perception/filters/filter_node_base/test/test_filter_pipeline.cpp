@@ -0,0 +1,135 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "common/types.hpp"
+#include "filter_node_base/filter_pipeline.hpp"
+#include "point_cloud_msg_wrapper/point_cloud_msg_wrapper.hpp"
+
+#include "gtest/gtest.h"
+
+namespace
+{
+using autoware::common::types::float32_t;
+using autoware::common::types::PointXYZI;
+using autoware::perception::filters::filter_node_base::FilterPipeline;
+using autoware::perception::filters::filter_node_base::FilterStage;
+using sensor_msgs::msg::PointCloud2;
+
+/* \class MinXStage
+ * \brief Keeps the points with an x coordinate of at least min_x and counts the selected points
+ */
+class MinXStage : public FilterStage
+{
+public:
+  explicit MinXStage(const float32_t min_x)
+  : min_x_(min_x) {}
+
+  void filter(const PointCloud2 & input, std::vector<std::size_t> & indices) override
+  {
+    const point_cloud_msg_wrapper::PointCloud2View<PointXYZI> view{input};
+    num_selected_ += indices.size();
+    indices.erase(
+      std::remove_if(
+        indices.begin(), indices.end(),
+        [this, &view](const std::size_t idx) {return view[idx].x < min_x_;}),
+      indices.end());
+  }
+
+  std::size_t num_selected_{0U};
+
+private:
+  float32_t min_x_;
+};
+
+/* \class EveryOtherStage
+ * \brief Keeps every other selected point
+ */
+class EveryOtherStage : public FilterStage
+{
+public:
+  void filter(const PointCloud2 &, std::vector<std::size_t> & indices) override
+  {
+    std::vector<std::size_t> kept;
+    for (std::size_t j = 0U; j < indices.size(); j += 2U) {
+      kept.push_back(indices[j]);
+    }
+    indices = kept;
+  }
+};
+
+PointCloud2 make_cloud(const std::vector<float32_t> & xs)
+{
+  PointCloud2 cloud;
+  point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI> modifier{cloud, "base_link"};
+  for (const auto x : xs) {
+    PointXYZI point;
+    point.x = x;
+    point.intensity = 2.0F * x;
+    modifier.push_back(point);
+  }
+  cloud.row_step = cloud.width * cloud.point_step;
+  return cloud;
+}
+
+// The stages are applied in order and the result is compacted into one row
+TEST(TestFilterPipeline, TestChainedStages) {
+  FilterPipeline pipeline;
+  const auto min_x_stage = std::make_shared<MinXStage>(2.0F);
+  pipeline.add_stage(min_x_stage);
+  pipeline.add_stage(std::make_shared<EveryOtherStage>());
+  EXPECT_EQ(pipeline.size(), 2U);
+
+  const auto input = make_cloud({0.0F, 3.0F, 1.0F, 4.0F, 5.0F, 9.0F, 2.0F});
+  PointCloud2 output;
+  pipeline.filter(input, output);
+
+  EXPECT_EQ(min_x_stage->num_selected_, 7U);
+  EXPECT_EQ(output.header.frame_id, input.header.frame_id);
+  EXPECT_EQ(output.fields, input.fields);
+  EXPECT_EQ(output.height, 1U);
+  EXPECT_EQ(output.row_step, output.width * output.point_step);
+  const point_cloud_msg_wrapper::PointCloud2View<PointXYZI> view{output};
+  ASSERT_EQ(view.size(), 3U);
+  EXPECT_FLOAT_EQ(view[0U].x, 3.0F);
+  EXPECT_FLOAT_EQ(view[1U].x, 5.0F);
+  EXPECT_FLOAT_EQ(view[2U].x, 2.0F);
+  EXPECT_FLOAT_EQ(view[2U].intensity, 4.0F);
+
+  // The stages are not called once all points are removed
+  FilterPipeline empty_pipeline;
+  empty_pipeline.add_stage(std::make_shared<MinXStage>(10.0F));
+  const auto unused_stage = std::make_shared<MinXStage>(0.0F);
+  empty_pipeline.add_stage(unused_stage);
+  empty_pipeline.filter(input, output);
+  EXPECT_EQ(output.width, 0U);
+  EXPECT_TRUE(output.data.empty());
+  EXPECT_EQ(unused_stage->num_selected_, 0U);
+}
+
+// Invalid stages and clouds are rejected
+TEST(TestFilterPipeline, TestInvalidInput) {
+  FilterPipeline pipeline;
+  EXPECT_THROW(pipeline.add_stage(nullptr), std::invalid_argument);
+
+  auto input = make_cloud({0.0F, 1.0F});
+  input.data.pop_back();
+  PointCloud2 output;
+  EXPECT_THROW(pipeline.filter(input, output), std::runtime_error);
+}
+}  // namespace
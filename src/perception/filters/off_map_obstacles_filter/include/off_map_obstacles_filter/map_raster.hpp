@@ -0,0 +1,103 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+/// \copyright Copyright 2021 The Autoware Foundation
+/// \file
+/// \brief This file defines the map_raster class.
+
+#ifndef OFF_MAP_OBSTACLES_FILTER__MAP_RASTER_HPP_
+#define OFF_MAP_OBSTACLES_FILTER__MAP_RASTER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "common/types.hpp"
+#include "lanelet2_core/primitives/Polygon.h"
+#include "off_map_obstacles_filter/visibility_control.hpp"
+
+namespace autoware
+{
+namespace off_map_obstacles_filter
+{
+
+using float64_t = autoware::common::types::float64_t;
+
+/// \brief Raster of the map polygons in square cells. Each cell is known to be entirely on one of
+/// the polygons, entirely off all of them, or is partially covered. Summed area tables of the
+/// cells answer for any axis-aligned box in constant time whether it is entirely on or off the map.
+class OFF_MAP_OBSTACLES_FILTER_PUBLIC MapRaster
+{
+public:
+  /// \brief How much of a box is covered by the map.
+  enum class Coverage : uint8_t
+  {
+    kOffMap,
+    kOnMap,
+    kPartial
+  };
+
+  /// \brief Above this number of cells, the cells are enlarged to bound the memory of the raster.
+  static constexpr std::size_t MAX_NUM_CELLS = 1UL << 21U;
+
+  /// \brief Constructor, rasterizes the polygons.
+  /// \param polygons The map polygons, in the map frame.
+  /// \param resolution The side length of the cells. The cells are larger if the bounding box of
+  /// the polygons would need more than MAX_NUM_CELLS cells.
+  /// \throw std::domain_error If the resolution is not positive and finite.
+  MapRaster(const std::vector<lanelet::BasicPolygon2d> & polygons, float64_t resolution);
+
+  /// \brief Get how much of an axis-aligned box is covered by the map. A box that touches a
+  /// partially covered cell is reported as kPartial, even if it is entirely on or off the map.
+  /// \param min_x The minimum x coordinate of the box in the map frame.
+  /// \param min_y The minimum y coordinate of the box in the map frame.
+  /// \param max_x The maximum x coordinate of the box in the map frame.
+  /// \param max_y The maximum y coordinate of the box in the map frame.
+  /// \return The coverage of the box.
+  Coverage get_coverage(float64_t min_x, float64_t min_y, float64_t max_x, float64_t max_y) const;
+
+  /// \brief Get the side length of the cells, which may be larger than the requested resolution.
+  float64_t get_cell_size() const;
+
+private:
+  /// \brief Rasterize a single polygon and merge it into m_cells.
+  void add_polygon(const lanelet::BasicPolygon2d & polygon);
+  /// \brief Number of cells of a summed area table in the cell rectangle, bounds inclusive.
+  uint32_t sum(
+    const std::vector<uint32_t> & table, std::size_t col_begin, std::size_t row_begin,
+    std::size_t col_end, std::size_t row_end) const;
+
+  /// The bounding box of the polygons grown by a cell.
+  float64_t m_min_x {0.0};
+  float64_t m_min_y {0.0};
+  float64_t m_max_x {0.0};
+  float64_t m_max_y {0.0};
+  float64_t m_cell_size {0.0};
+  std::size_t m_num_cols {0U};
+  std::size_t m_num_rows {0U};
+  /// Row major cells, only used during construction.
+  std::vector<Coverage> m_cells;
+  /// Scratch space for rasterizing a single polygon.
+  std::vector<Coverage> m_polygon_cells;
+  /// Summed area tables of the cells on and off the map, with an extra first row and column.
+  std::vector<uint32_t> m_on_map_sums;
+  std::vector<uint32_t> m_off_map_sums;
+};
+
+}  // namespace off_map_obstacles_filter
+}  // namespace autoware
+
+#endif  // OFF_MAP_OBSTACLES_FILTER__MAP_RASTER_HPP_
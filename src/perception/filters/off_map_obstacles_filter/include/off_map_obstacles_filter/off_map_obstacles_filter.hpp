@@ -27,7 +27,9 @@
 #include "common/types.hpp"
 
 #include "geometry_msgs/msg/transform_stamped.hpp"
+#include "had_map_utils/had_map_query.hpp"
 #include "lanelet2_core/LaneletMap.h"
+#include "off_map_obstacles_filter/map_raster.hpp"
 #include "off_map_obstacles_filter/visibility_control.hpp"
 #include "visualization_msgs/msg/marker_array.hpp"
 
@@ -47,7 +49,14 @@ public:
   /// \param map The lanelet map, correctly transformed into the map frame.
   /// \param overlap_threshold What fraction of a bbox needs to overlap the map to be considered
   /// "on the map".
-  OffMapObstaclesFilter(std::shared_ptr<lanelet::LaneletMap> map, float64_t overlap_threshold);
+  /// \param raster_resolution The cell size of a raster of the map, which decides most bboxes
+  /// without intersecting polygons. Only bboxes near the edge of the map need the exact test. 0
+  /// disables the raster.
+  /// \throw std::domain_error If the raster resolution is negative or not finite.
+  /// \throw std::invalid_argument If the map is null.
+  OffMapObstaclesFilter(
+    std::shared_ptr<lanelet::LaneletMap> map, float64_t overlap_threshold,
+    float64_t raster_resolution = 0.0);
 
   /// \brief A function for debugging the transformation and conversion of boxes in the base_link
   /// frame to lanelet polygons in the map frame.
@@ -68,10 +77,14 @@ public:
 private:
   /// The full lanelet map.
   const std::shared_ptr<lanelet::LaneletMap> m_map;
+  /// The areas of the map by subtype, to look up the parking areas.
+  const common::had_map_utils::SubtypeIndex m_subtypes;
   /// What fraction of a bbox needs to overlap the map to be considered "on the map".
   /// Note that the default value will always be overwritten by the constructor, it's just here to
   /// be safe.
   const float64_t m_overlap_threshold {1.0};
+  /// Raster of the lanelets and parking areas, null if disabled.
+  std::unique_ptr<const MapRaster> m_raster;
 };
 
 }  // namespace off_map_obstacles_filter
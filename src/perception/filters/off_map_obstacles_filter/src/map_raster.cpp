@@ -0,0 +1,260 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#include "off_map_obstacles_filter/map_raster.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace autoware
+{
+
+namespace off_map_obstacles_filter
+{
+
+constexpr std::size_t MapRaster::MAX_NUM_CELLS;
+
+/// \brief Crossing number test, only used for points that are not close to the boundary.
+static bool point_is_in_polygon(
+  const lanelet::BasicPolygon2d & polygon, const float64_t x, const float64_t y)
+{
+  bool is_inside = false;
+  for (std::size_t idx = 0U; idx < polygon.size(); ++idx) {
+    const auto & start = polygon[idx];
+    const auto & end = polygon[(idx + 1U) % polygon.size()];
+    if ((start.y() > y) != (end.y() > y)) {
+      const float64_t x_crossing =
+        start.x() + (y - start.y()) * (end.x() - start.x()) / (end.y() - start.y());
+      if (x < x_crossing) {
+        is_inside = !is_inside;
+      }
+    }
+  }
+  return is_inside;
+}
+
+/// \brief Convert a coordinate in units of cells to a cell index, clamped to the raster.
+static std::size_t to_index(const float64_t value, const std::size_t size)
+{
+  return static_cast<std::size_t>(
+    std::min(std::max(std::floor(value), 0.0), static_cast<float64_t>(size - 1U)));
+}
+
+MapRaster::MapRaster(
+  const std::vector<lanelet::BasicPolygon2d> & polygons,
+  const float64_t resolution)
+{
+  if (!std::isfinite(resolution) || (resolution <= 0.0)) {
+    throw std::domain_error("MapRaster: resolution must be positive");
+  }
+  float64_t min_x = std::numeric_limits<float64_t>::max();
+  float64_t min_y = std::numeric_limits<float64_t>::max();
+  float64_t max_x = std::numeric_limits<float64_t>::lowest();
+  float64_t max_y = std::numeric_limits<float64_t>::lowest();
+  for (const auto & polygon : polygons) {
+    for (const auto & point : polygon) {
+      min_x = std::min(min_x, point.x());
+      min_y = std::min(min_y, point.y());
+      max_x = std::max(max_x, point.x());
+      max_y = std::max(max_y, point.y());
+    }
+  }
+  m_cell_size = resolution;
+  if (min_x > max_x) {
+    // No polygons, everything is off the map
+    return;
+  }
+
+  // Grow the cells until the grid with a margin of one cell around the polygons has few enough
+  auto count_cells = [](const float64_t extent, const float64_t size) {
+      return static_cast<std::size_t>(std::floor(extent / size)) + 3U;
+    };
+  while (count_cells(max_x - min_x, m_cell_size) * count_cells(max_y - min_y, m_cell_size) >
+    MAX_NUM_CELLS)
+  {
+    m_cell_size *= 2.0;
+  }
+  m_num_cols = count_cells(max_x - min_x, m_cell_size);
+  m_num_rows = count_cells(max_y - min_y, m_cell_size);
+  m_min_x = min_x - m_cell_size;
+  m_min_y = min_y - m_cell_size;
+  m_max_x = m_min_x + static_cast<float64_t>(m_num_cols) * m_cell_size;
+  m_max_y = m_min_y + static_cast<float64_t>(m_num_rows) * m_cell_size;
+
+  m_cells.assign(m_num_cols * m_num_rows, Coverage::kOffMap);
+  for (const auto & polygon : polygons) {
+    if (polygon.size() >= 3U) {
+      add_polygon(polygon);
+    }
+  }
+
+  m_on_map_sums.assign((m_num_cols + 1U) * (m_num_rows + 1U), 0U);
+  m_off_map_sums.assign((m_num_cols + 1U) * (m_num_rows + 1U), 0U);
+  const std::size_t stride = m_num_cols + 1U;
+  for (std::size_t row = 0U; row < m_num_rows; ++row) {
+    for (std::size_t col = 0U; col < m_num_cols; ++col) {
+      const Coverage cell = m_cells[row * m_num_cols + col];
+      const std::size_t idx = (row + 1U) * stride + col + 1U;
+      m_on_map_sums[idx] = m_on_map_sums[idx - 1U] + m_on_map_sums[idx - stride] -
+        m_on_map_sums[idx - stride - 1U] + ((cell == Coverage::kOnMap) ? 1U : 0U);
+      m_off_map_sums[idx] = m_off_map_sums[idx - 1U] + m_off_map_sums[idx - stride] -
+        m_off_map_sums[idx - stride - 1U] + ((cell == Coverage::kOffMap) ? 1U : 0U);
+    }
+  }
+  m_cells = std::vector<Coverage>{};
+  m_polygon_cells = std::vector<Coverage>{};
+}
+
+void MapRaster::add_polygon(const lanelet::BasicPolygon2d & polygon)
+{
+  // Rasterize the polygon into the window of cells around its bounding box
+  float64_t min_x = std::numeric_limits<float64_t>::max();
+  float64_t min_y = std::numeric_limits<float64_t>::max();
+  float64_t max_x = std::numeric_limits<float64_t>::lowest();
+  float64_t max_y = std::numeric_limits<float64_t>::lowest();
+  for (const auto & point : polygon) {
+    min_x = std::min(min_x, point.x());
+    min_y = std::min(min_y, point.y());
+    max_x = std::max(max_x, point.x());
+    max_y = std::max(max_y, point.y());
+  }
+  const std::size_t col_begin = to_index((min_x - m_min_x) / m_cell_size - 1.0, m_num_cols);
+  const std::size_t row_begin = to_index((min_y - m_min_y) / m_cell_size - 1.0, m_num_rows);
+  const std::size_t col_end = to_index((max_x - m_min_x) / m_cell_size + 1.0, m_num_cols);
+  const std::size_t row_end = to_index((max_y - m_min_y) / m_cell_size + 1.0, m_num_rows);
+  const std::size_t num_cols = col_end - col_begin + 1U;
+  const std::size_t num_rows = row_end - row_begin + 1U;
+  m_polygon_cells.assign(num_cols * num_rows, Coverage::kOffMap);
+
+  // Mark the cells along the edges, and their neighbors, as partially covered, so that rounding
+  // can not move a box across the boundary
+  for (std::size_t idx = 0U; idx < polygon.size(); ++idx) {
+    const auto & start = polygon[idx];
+    const auto & end = polygon[(idx + 1U) % polygon.size()];
+    // Edge in units of cells from the corner of the window
+    const float64_t u0 = (start.x() - m_min_x) / m_cell_size - static_cast<float64_t>(col_begin);
+    const float64_t v0 = (start.y() - m_min_y) / m_cell_size - static_cast<float64_t>(row_begin);
+    const float64_t u1 = (end.x() - m_min_x) / m_cell_size - static_cast<float64_t>(col_begin);
+    const float64_t v1 = (end.y() - m_min_y) / m_cell_size - static_cast<float64_t>(row_begin);
+    const float64_t v_min = std::min(v0, v1);
+    const float64_t v_max = std::max(v0, v1);
+    for (std::size_t row = to_index(v_min, num_rows); row <= to_index(v_max, num_rows); ++row) {
+      // Part of the edge within the row
+      float64_t u_lo = std::min(u0, u1);
+      float64_t u_hi = std::max(u0, u1);
+      if (v1 != v0) {
+        const float64_t v_lo = std::max(v_min, static_cast<float64_t>(row));
+        const float64_t v_hi = std::min(v_max, static_cast<float64_t>(row + 1U));
+        const float64_t u_at_lo = u0 + (u1 - u0) * ((v_lo - v0) / (v1 - v0));
+        const float64_t u_at_hi = u0 + (u1 - u0) * ((v_hi - v0) / (v1 - v0));
+        u_lo = std::min(u_at_lo, u_at_hi);
+        u_hi = std::max(u_at_lo, u_at_hi);
+      }
+      const std::size_t mark_col_begin = to_index(u_lo - 1.0, num_cols);
+      const std::size_t mark_col_end = to_index(u_hi + 1.0, num_cols);
+      const std::size_t mark_row_begin = (row > 0U) ? (row - 1U) : 0U;
+      const std::size_t mark_row_end = std::min(row + 1U, num_rows - 1U);
+      for (std::size_t mark_row = mark_row_begin; mark_row <= mark_row_end; ++mark_row) {
+        std::fill(
+          m_polygon_cells.begin() +
+          static_cast<std::ptrdiff_t>(mark_row * num_cols + mark_col_begin),
+          m_polygon_cells.begin() +
+          static_cast<std::ptrdiff_t>(mark_row * num_cols + mark_col_end + 1U),
+          Coverage::kPartial);
+      }
+    }
+  }
+
+  // The boundary does not cross a run of other cells in a row, so the whole run is on the same
+  // side of it as the center of its first cell. Merge the result, a cell entirely on one polygon
+  // is on the map no matter what the other polygons cover
+  for (std::size_t row = 0U; row < num_rows; ++row) {
+    Coverage run_coverage = Coverage::kPartial;
+    for (std::size_t col = 0U; col < num_cols; ++col) {
+      const Coverage cell = m_polygon_cells[row * num_cols + col];
+      if (cell == Coverage::kPartial) {
+        run_coverage = Coverage::kPartial;
+      } else if (run_coverage == Coverage::kPartial) {
+        const float64_t center_x =
+          m_min_x + (static_cast<float64_t>(col_begin + col) + 0.5) * m_cell_size;
+        const float64_t center_y =
+          m_min_y + (static_cast<float64_t>(row_begin + row) + 0.5) * m_cell_size;
+        run_coverage = point_is_in_polygon(polygon, center_x, center_y) ?
+          Coverage::kOnMap : Coverage::kOffMap;
+      }
+      Coverage & map_cell = m_cells[(row_begin + row) * m_num_cols + col_begin + col];
+      if ((run_coverage == Coverage::kOnMap) ||
+        ((run_coverage == Coverage::kPartial) && (map_cell == Coverage::kOffMap)))
+      {
+        map_cell = run_coverage;
+      }
+    }
+  }
+}
+
+MapRaster::Coverage MapRaster::get_coverage(
+  const float64_t min_x, const float64_t min_y,
+  const float64_t max_x, const float64_t max_y) const
+{
+  if (!(min_x <= max_x) || !(min_y <= max_y)) {
+    // Not a number
+    return Coverage::kPartial;
+  }
+  if ((m_num_cols == 0U) || (max_x < m_min_x) || (max_y < m_min_y) || (min_x > m_max_x) ||
+    (min_y > m_max_y))
+  {
+    return Coverage::kOffMap;
+  }
+  const std::size_t col_begin = to_index((min_x - m_min_x) / m_cell_size, m_num_cols);
+  const std::size_t row_begin = to_index((min_y - m_min_y) / m_cell_size, m_num_rows);
+  const std::size_t col_end = to_index((max_x - m_min_x) / m_cell_size, m_num_cols);
+  const std::size_t row_end = to_index((max_y - m_min_y) / m_cell_size, m_num_rows);
+  const auto num_cells =
+    static_cast<uint32_t>((col_end - col_begin + 1U) * (row_end - row_begin + 1U));
+  // The cells beyond the raster are off the map
+  const bool is_within_raster =
+    (min_x >= m_min_x) && (min_y >= m_min_y) && (max_x <= m_max_x) && (max_y <= m_max_y);
+  if (is_within_raster &&
+    (sum(m_on_map_sums, col_begin, row_begin, col_end, row_end) == num_cells))
+  {
+    return Coverage::kOnMap;
+  }
+  if (sum(m_off_map_sums, col_begin, row_begin, col_end, row_end) == num_cells) {
+    return Coverage::kOffMap;
+  }
+  return Coverage::kPartial;
+}
+
+float64_t MapRaster::get_cell_size() const
+{
+  return m_cell_size;
+}
+
+uint32_t MapRaster::sum(
+  const std::vector<uint32_t> & table, const std::size_t col_begin, const std::size_t row_begin,
+  const std::size_t col_end, const std::size_t row_end) const
+{
+  const std::size_t stride = m_num_cols + 1U;
+  return table[(row_end + 1U) * stride + col_end + 1U] - table[row_begin * stride + col_end + 1U] -
+         table[(row_end + 1U) * stride + col_begin] + table[row_begin * stride + col_begin];
+}
+
+}  // namespace off_map_obstacles_filter
+
+}  // namespace autoware
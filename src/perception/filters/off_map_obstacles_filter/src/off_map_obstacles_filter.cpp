@@ -16,8 +16,12 @@
 
 #include "off_map_obstacles_filter/off_map_obstacles_filter.hpp"
 
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <memory>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 
 #include "common/types.hpp"
@@ -42,15 +46,47 @@ using float32_t = autoware::common::types::float32_t;
 using float64_t = autoware::common::types::float64_t;
 namespace utils = lanelet::utils;
 
+/// \brief The subtypes of the parking areas that count as part of the map, if they have a cad_id.
+static constexpr std::array<const char *, 2U> kDrivableAreaSubtypes {{
+  "parking_access", "parking_spot"}};
+
 OffMapObstaclesFilter::OffMapObstaclesFilter(
   std::shared_ptr<lanelet::LaneletMap> map,
-  float64_t overlap_threshold)
-: m_map{map}, m_overlap_threshold{overlap_threshold} {}
+  float64_t overlap_threshold,
+  float64_t raster_resolution)
+: m_map{map}, m_subtypes{map}, m_overlap_threshold{overlap_threshold}
+{
+  if (!std::isfinite(raster_resolution) || (raster_resolution < 0.0)) {
+    throw std::domain_error("OffMapObstaclesFilter: raster_resolution must not be negative");
+  }
+  if (raster_resolution > 0.0) {
+    // The same polygons as the exact test in bbox_is_on_map() uses
+    std::vector<lanelet::BasicPolygon2d> polygons;
+    for (const auto & lanelet : m_map->laneletLayer) {
+      lanelet::BasicPolygon2d polygon;
+      for (const auto & p : lanelet.polygon2d()) {
+        polygon.push_back(lanelet::BasicPoint2d{p.x(), p.y()});
+      }
+      polygons.push_back(std::move(polygon));
+    }
+    for (const char * const subtype : kDrivableAreaSubtypes) {
+      for (const auto & area : m_subtypes.areas(subtype)) {
+        if (!area.hasAttribute("cad_id")) {continue;}
+        lanelet::BasicPolygon2d polygon;
+        for (const auto & p : area.outerBoundPolygon()) {
+          polygon.push_back(lanelet::BasicPoint2d{p.x(), p.y()});
+        }
+        polygons.push_back(std::move(polygon));
+      }
+    }
+    m_raster = std::make_unique<const MapRaster>(polygons, raster_resolution);
+  }
+}
 
 /// \param bbox The bounding box with coordinates in the base_link frame.
 /// \param map_from_base_link The transform that transforms things from base_link to map.
-/// \return A polygon with the four corners of the bounding box projected into 2D.
-static lanelet::Polygon2d polygon_for_bbox(
+/// \return The four corners of the bounding box projected into 2D, in clockwise order.
+static std::array<Eigen::Vector2f, 4U> corners_for_bbox(
   const Eigen::Isometry2f & map_from_base_link,
   const autoware_auto_msgs::msg::BoundingBox & bbox)
 {
@@ -76,12 +112,17 @@ static lanelet::Polygon2d polygon_for_bbox(
     (Eigen::Vector2f::Zero() + dx + dy));
   const Eigen::Vector2f p3 = map_from_base_link * (centroid + orientation *
     (Eigen::Vector2f::Zero() + dx - dy));
+  return {p0, p1, p2, p3};
+}
 
+/// \param corners The corners of a bounding box in the map frame, from corners_for_bbox().
+/// \return A polygon with the four corners of the bounding box.
+static lanelet::Polygon2d polygon_for_corners(const std::array<Eigen::Vector2f, 4U> & corners)
+{
   lanelet::Polygon2d bbox_poly;
-  bbox_poly.push_back(lanelet::Point2d{utils::getId(), p0.x(), p0.y()});
-  bbox_poly.push_back(lanelet::Point2d{utils::getId(), p1.x(), p1.y()});
-  bbox_poly.push_back(lanelet::Point2d{utils::getId(), p2.x(), p2.y()});
-  bbox_poly.push_back(lanelet::Point2d{utils::getId(), p3.x(), p3.y()});
+  for (const auto & corner : corners) {
+    bbox_poly.push_back(lanelet::Point2d{utils::getId(), corner.x(), corner.y()});
+  }
   return bbox_poly;
 }
 
@@ -111,7 +152,7 @@ visualization_msgs::msg::MarkerArray OffMapObstaclesFilter::bboxes_in_map_frame_
   visualization_msgs::msg::MarkerArray array;
   int id = 0;
   for (const auto & bbox : msg.boxes) {
-    const auto polygon = polygon_for_bbox(map_from_base_link_isometry.cast<float32_t>(), bbox);
+    const auto polygon = corners_for_bbox(map_from_base_link_isometry.cast<float32_t>(), bbox);
     visualization_msgs::msg::Marker marker;
     marker.header = msg.header;
     marker.header.frame_id = "map";
@@ -158,17 +199,41 @@ visualization_msgs::msg::MarkerArray OffMapObstaclesFilter::bboxes_in_map_frame_
 
 /// \brief Checks if a bbox is on the map.
 /// \param map The lanelet map, correctly transformed into the map frame.
+/// \param subtypes The areas of the map by subtype.
 /// \param map_from_base_link An Isometry2d that can be used to transform Eigen Vectors.
 /// \param overlap_threshold What fraction of a bbox needs to overlap the map to be considered
 /// "on the map".
+/// \param raster A raster of the map that decides the bboxes away from its edges, or null.
 /// \param bbox An obstacle bounding box.
 static bool bbox_is_on_map(
   const lanelet::LaneletMap & map,
+  const common::had_map_utils::SubtypeIndex & subtypes,
   const Eigen::Isometry2f & map_from_base_link,
   const float64_t overlap_threshold,
+  const MapRaster * const raster,
   const autoware_auto_msgs::msg::BoundingBox & bbox)
 {
-  const lanelet::Polygon2d bbox_poly = polygon_for_bbox(map_from_base_link, bbox);
+  const std::array<Eigen::Vector2f, 4U> corners = corners_for_bbox(map_from_base_link, bbox);
+  if (raster) {
+    // The axis-aligned bounds of the bbox, if they are entirely on or off the map so is the bbox
+    Eigen::Vector2f min_corner = corners[0];
+    Eigen::Vector2f max_corner = corners[0];
+    for (const auto & corner : corners) {
+      min_corner = min_corner.cwiseMin(corner);
+      max_corner = max_corner.cwiseMax(corner);
+    }
+    const MapRaster::Coverage coverage = raster->get_coverage(
+      static_cast<float64_t>(min_corner.x()), static_cast<float64_t>(min_corner.y()),
+      static_cast<float64_t>(max_corner.x()), static_cast<float64_t>(max_corner.y()));
+    if ((coverage == MapRaster::Coverage::kOnMap) && (overlap_threshold <= 1.0)) {
+      return true;
+    }
+    if ((coverage == MapRaster::Coverage::kOffMap) && (overlap_threshold > 0.0)) {
+      return false;
+    }
+  }
+
+  const lanelet::Polygon2d bbox_poly = polygon_for_corners(corners);
   // See https://github.com/fzi-forschungszentrum-informatik/Lanelet2/blob/master/lanelet2_core/doc/GeometryPrimer.md
   const lanelet::ConstHybridPolygon2d bbox_poly_hybrid = utils::toHybrid(bbox_poly);
   const float64_t total_area = lanelet::geometry::area(bbox_poly_hybrid);
@@ -176,7 +241,6 @@ static bool bbox_is_on_map(
   // Now find possibly-intersecting lanelets and areas
   const lanelet::BoundingBox2d bbox_bbox = lanelet::geometry::boundingBox2d(bbox_poly);
   const std::vector<lanelet::ConstLanelet> ll_candidates = map.laneletLayer.search(bbox_bbox);
-  const std::vector<lanelet::ConstArea> area_candidates = map.areaLayer.search(bbox_bbox);
 
   // The output point type needs to be the same, but it seems easier to use boost's builtin polygon
   // as the (multi)polygon type for the output.
@@ -193,26 +257,28 @@ static bool bbox_is_on_map(
       ll_poly.push_back(lanelet::Point2d{utils::getId(), p.x(), p.y()});
     }
     lanelet::ConstHybridPolygon2d ll_poly_hybrid = utils::toHybrid(ll_poly);
+    output.clear();
     boost::geometry::intersection(ll_poly_hybrid, bbox_poly_hybrid, output);
     overlap_area += boost::geometry::area(output);
     if (overlap_area / total_area >= overlap_threshold) {
       return true;
     }
   }
-  for (const auto candidate : area_candidates) {
-    if (!candidate.hasAttribute("subtype") || !candidate.hasAttribute("cad_id")) {continue;}
-    if (candidate.attribute("subtype") != "parking_access" &&
-      candidate.attribute("subtype") != "parking_spot") {continue;}
-    // Annoying – this seems to be the only way to do the intersection
-    lanelet::Polygon2d area_poly;
-    for (const auto p : candidate.outerBoundPolygon()) {
-      area_poly.push_back(lanelet::Point2d{utils::getId(), p.x(), p.y()});
-    }
-    lanelet::ConstHybridPolygon2d area_poly_hybrid = utils::toHybrid(area_poly);
-    boost::geometry::intersection(area_poly_hybrid, bbox_poly_hybrid, output);
-    overlap_area += boost::geometry::area(output);
-    if (overlap_area / total_area >= overlap_threshold) {
-      return true;
+  for (const char * const subtype : kDrivableAreaSubtypes) {
+    for (const auto & candidate : subtypes.areas(subtype, bbox_bbox)) {
+      if (!candidate.hasAttribute("cad_id")) {continue;}
+      // Annoying – this seems to be the only way to do the intersection
+      lanelet::Polygon2d area_poly;
+      for (const auto p : candidate.outerBoundPolygon()) {
+        area_poly.push_back(lanelet::Point2d{utils::getId(), p.x(), p.y()});
+      }
+      lanelet::ConstHybridPolygon2d area_poly_hybrid = utils::toHybrid(area_poly);
+      output.clear();
+      boost::geometry::intersection(area_poly_hybrid, bbox_poly_hybrid, output);
+      overlap_area += boost::geometry::area(output);
+      if (overlap_area / total_area >= overlap_threshold) {
+        return true;
+      }
     }
   }
   return false;
@@ -229,8 +295,8 @@ void OffMapObstaclesFilter::remove_off_map_bboxes(
       msg.boxes.end(),
       [this, &map_from_base_link_isometry](const auto & bbox) {
         return !bbox_is_on_map(
-          *this->m_map, map_from_base_link_isometry.cast<float32_t>(),
-          this->m_overlap_threshold, bbox);
+          *this->m_map, this->m_subtypes, map_from_base_link_isometry.cast<float32_t>(),
+          this->m_overlap_threshold, this->m_raster.get(), bbox);
       }),
     msg.boxes.end());
 }
@@ -4,7 +4,7 @@
 // you may not use this file except in compliance with the License.
 // You may obtain a copy of the License at
 //
-//     http://www.apache.org/licenses/LICENSE-2.0
+//     http://www.apache.org/licenses/LICENSE-2.0
 //
 // Unless required by applicable law or agreed to in writing, software
 // distributed under the License is distributed on an "AS IS" BASIS,
@@ -14,9 +14,153 @@
 //
 // Co-developed by Tier IV, Inc. and Apex.AI, Inc.
 
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
 #include "gtest/gtest.h"
+#include "lanelet2_core/primitives/Lanelet.h"
+#include "lanelet2_core/utility/Utilities.h"
+#include "off_map_obstacles_filter/map_raster.hpp"
 #include "off_map_obstacles_filter/off_map_obstacles_filter.hpp"
 
+using autoware::common::types::float32_t;
+using autoware::common::types::float64_t;
+using autoware::off_map_obstacles_filter::MapRaster;
+using autoware::off_map_obstacles_filter::OffMapObstaclesFilter;
+using autoware_auto_msgs::msg::BoundingBox;
+using autoware_auto_msgs::msg::BoundingBoxArray;
+
+namespace
+{
+lanelet::BasicPolygon2d make_rectangle(
+  const float64_t min_x, const float64_t min_y,
+  const float64_t max_x, const float64_t max_y)
+{
+  lanelet::BasicPolygon2d polygon;
+  polygon.push_back(lanelet::BasicPoint2d{min_x, min_y});
+  polygon.push_back(lanelet::BasicPoint2d{min_x, max_y});
+  polygon.push_back(lanelet::BasicPoint2d{max_x, max_y});
+  polygon.push_back(lanelet::BasicPoint2d{max_x, min_y});
+  return polygon;
+}
+
+// A single straight lanelet covering x in [0, 10] and y in [0, 50]
+std::shared_ptr<lanelet::LaneletMap> make_map()
+{
+  lanelet::Points3d left_points, right_points;
+  for (int32_t i = 0; i <= 5; ++i) {
+    const float64_t y = 10.0 * static_cast<float64_t>(i);
+    left_points.push_back(lanelet::Point3d(lanelet::utils::getId(), 0.0, y, 0.0));
+    right_points.push_back(lanelet::Point3d(lanelet::utils::getId(), 10.0, y, 0.0));
+  }
+  lanelet::Lanelet ll(
+    lanelet::utils::getId(),
+    lanelet::LineString3d(lanelet::utils::getId(), left_points),
+    lanelet::LineString3d(lanelet::utils::getId(), right_points));
+  return std::shared_ptr<lanelet::LaneletMap>(lanelet::utils::createMap({ll}));
+}
+
+BoundingBox make_box(const float32_t x, const float32_t y, const float32_t size)
+{
+  BoundingBox box;
+  box.centroid.x = x;
+  box.centroid.y = y;
+  box.size.x = size;
+  box.size.y = size;
+  box.orientation.w = 1.0F;
+  return box;
+}
+
+geometry_msgs::msg::TransformStamped identity_transform()
+{
+  geometry_msgs::msg::TransformStamped tfs;
+  tfs.transform.rotation.w = 1.0;
+  return tfs;
+}
+}  // namespace
+
+TEST(test_map_raster, coverage_of_boxes) {
+  const MapRaster raster{{make_rectangle(0.0, 0.0, 10.0, 10.0)}, 0.5};
+  EXPECT_EQ(raster.get_coverage(2.0, 2.0, 4.0, 4.0), MapRaster::Coverage::kOnMap);
+  EXPECT_EQ(raster.get_coverage(20.0, 20.0, 22.0, 22.0), MapRaster::Coverage::kOffMap);
+  EXPECT_EQ(raster.get_coverage(-5.0, 2.0, -3.0, 4.0), MapRaster::Coverage::kOffMap);
+  EXPECT_EQ(raster.get_coverage(9.0, 4.0, 11.0, 5.0), MapRaster::Coverage::kPartial);
+  // Larger than the map
+  EXPECT_EQ(raster.get_coverage(-1.0, -1.0, 11.0, 11.0), MapRaster::Coverage::kPartial);
+  EXPECT_EQ(raster.get_coverage(-1.0, -1.0, -1.0, 100.0), MapRaster::Coverage::kOffMap);
+}
+
+TEST(test_map_raster, union_of_polygons) {
+  // An L shape of two rectangles, the corner of the bounding box is off the map
+  const MapRaster raster{
+    {make_rectangle(0.0, 0.0, 10.0, 2.0), make_rectangle(0.0, 0.0, 2.0, 10.0)}, 0.25};
+  EXPECT_EQ(raster.get_coverage(0.5, 0.5, 1.5, 1.5), MapRaster::Coverage::kOnMap);
+  EXPECT_EQ(raster.get_coverage(7.0, 0.5, 8.0, 1.5), MapRaster::Coverage::kOnMap);
+  EXPECT_EQ(raster.get_coverage(0.5, 7.0, 1.5, 8.0), MapRaster::Coverage::kOnMap);
+  EXPECT_EQ(raster.get_coverage(5.0, 5.0, 8.0, 8.0), MapRaster::Coverage::kOffMap);
+}
+
+TEST(test_map_raster, degenerate_inputs) {
+  EXPECT_THROW(MapRaster({make_rectangle(0.0, 0.0, 1.0, 1.0)}, 0.0), std::domain_error);
+  EXPECT_THROW(MapRaster({make_rectangle(0.0, 0.0, 1.0, 1.0)}, -1.0), std::domain_error);
+  const MapRaster empty{{}, 1.0};
+  EXPECT_EQ(empty.get_coverage(0.0, 0.0, 1.0, 1.0), MapRaster::Coverage::kOffMap);
+  const MapRaster raster{{make_rectangle(0.0, 0.0, 10.0, 10.0)}, 1.0};
+  const float64_t nan = std::numeric_limits<float64_t>::quiet_NaN();
+  EXPECT_EQ(raster.get_coverage(nan, 2.0, 4.0, 4.0), MapRaster::Coverage::kPartial);
+  // The cells grow to bound the memory
+  const MapRaster large{{make_rectangle(0.0, 0.0, 10000.0, 10000.0)}, 0.1};
+  EXPECT_GT(large.get_cell_size(), 0.1);
+  EXPECT_EQ(large.get_coverage(100.0, 100.0, 200.0, 200.0), MapRaster::Coverage::kOnMap);
+}
+
 TEST(test_off_map_obstacles_filter, test_remove_off_map_bboxes) {
-  // Not implemented yet
+  const auto map = make_map();
+  for (const float64_t raster_resolution : {0.0, 1.0}) {
+    // Half of the third box overlaps the map
+    BoundingBoxArray boxes;
+    boxes.boxes.push_back(make_box(5.0F, 25.0F, 2.0F));
+    boxes.boxes.push_back(make_box(30.0F, 25.0F, 2.0F));
+    boxes.boxes.push_back(make_box(10.0F, 25.0F, 2.0F));
+    BoundingBoxArray boxes_strict = boxes;
+
+    const OffMapObstaclesFilter filter{map, 0.2, raster_resolution};
+    filter.remove_off_map_bboxes(identity_transform(), boxes);
+    ASSERT_EQ(boxes.boxes.size(), 2U);
+    EXPECT_FLOAT_EQ(boxes.boxes[0U].centroid.x, 5.0F);
+    EXPECT_FLOAT_EQ(boxes.boxes[1U].centroid.x, 10.0F);
+
+    const OffMapObstaclesFilter filter_strict{map, 0.6, raster_resolution};
+    filter_strict.remove_off_map_bboxes(identity_transform(), boxes_strict);
+    ASSERT_EQ(boxes_strict.boxes.size(), 1U);
+    EXPECT_FLOAT_EQ(boxes_strict.boxes[0U].centroid.x, 5.0F);
+  }
+  EXPECT_THROW(OffMapObstaclesFilter(map, 0.2, -1.0), std::domain_error);
+}
+
+TEST(test_off_map_obstacles_filter, raster_matches_exact) {
+  const auto map = make_map();
+  BoundingBoxArray boxes;
+  for (float32_t x = -5.0F; x < 15.0F; x += 0.7F) {
+    for (float32_t y = -5.0F; y < 55.0F; y += 1.3F) {
+      boxes.boxes.push_back(make_box(x, y, 1.5F));
+    }
+  }
+  BoundingBoxArray boxes_raster = boxes;
+  // Rotate and shift the boxes, rotated boxes are tested by the raster with their bounds
+  geometry_msgs::msg::TransformStamped tfs = identity_transform();
+  tfs.transform.translation.x = 0.3;
+  tfs.transform.rotation.z = std::sin(0.1);
+  tfs.transform.rotation.w = std::cos(0.1);
+  OffMapObstaclesFilter{map, 0.5, 0.0}.remove_off_map_bboxes(tfs, boxes);
+  OffMapObstaclesFilter{map, 0.5, 0.5}.remove_off_map_bboxes(tfs, boxes_raster);
+  ASSERT_EQ(boxes.boxes.size(), boxes_raster.boxes.size());
+  for (std::size_t i = 0U; i < boxes.boxes.size(); ++i) {
+    EXPECT_FLOAT_EQ(boxes.boxes[i].centroid.x, boxes_raster.boxes[i].centroid.x);
+    EXPECT_FLOAT_EQ(boxes.boxes[i].centroid.y, boxes_raster.boxes[i].centroid.y);
+  }
 }
@@ -80,6 +80,8 @@ private:
   tf2_ros::TransformListener m_tf2_listener;
   /// Stores the overlap before the filter has been constructed
   float64_t m_overlap_threshold{1.0};  // Placeholder value
+  /// Stores the cell size of the map raster before the filter has been constructed, 0 disables it
+  float64_t m_raster_resolution{0.0};
 };
 }  // namespace off_map_obstacles_filter_nodes
 }  // namespace autoware
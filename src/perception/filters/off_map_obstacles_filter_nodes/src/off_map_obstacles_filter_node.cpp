@@ -16,8 +16,10 @@
 
 #include "off_map_obstacles_filter_nodes/off_map_obstacles_filter_node.hpp"
 
+#include <cmath>
 #include <functional>
 #include <memory>
+#include <stdexcept>
 #include <string>
 
 #include "had_map_utils/had_map_conversion.hpp"
@@ -50,8 +52,13 @@ OffMapObstaclesFilterNode::OffMapObstaclesFilterNode(const rclcpp::NodeOptions &
       rmw_qos_profile_services_default)),
   m_tf2_buffer(this->get_clock()),
   m_tf2_listener(m_tf2_buffer),
-  m_overlap_threshold(declare_parameter("overlap_threshold").get<float64_t>())
+  m_overlap_threshold(declare_parameter("overlap_threshold").get<float64_t>()),
+  m_raster_resolution(
+    declare_parameter("raster_resolution", rclcpp::ParameterValue(0.0)).get<float64_t>())
 {
+  if (!std::isfinite(m_raster_resolution) || (m_raster_resolution < 0.0)) {
+    throw std::domain_error("raster_resolution must not be negative");
+  }
   while (!m_map_client_ptr->wait_for_service(1s)) {
     if (!rclcpp::ok()) {
       RCLCPP_ERROR(get_logger(), "Interrupted while waiting for service.");
@@ -77,9 +84,9 @@ OffMapObstaclesFilterNode::OffMapObstaclesFilterNode(const rclcpp::NodeOptions &
 void OffMapObstaclesFilterNode::map_response(
   const rclcpp::Client<HADMapService>::SharedFuture future)
 {
-  auto lanelet_map_ptr = std::make_shared<lanelet::LaneletMap>();
-  autoware::common::had_map_utils::fromBinaryMsg(future.get()->map, lanelet_map_ptr);
-  m_filter = std::make_unique<OffMapObstaclesFilter>(lanelet_map_ptr, m_overlap_threshold);
+  auto lanelet_map_ptr = autoware::common::had_map_utils::fromBinaryMsgShared(future.get()->map);
+  m_filter = std::make_unique<OffMapObstaclesFilter>(
+    lanelet_map_ptr, m_overlap_threshold, m_raster_resolution);
 }
 
 void OffMapObstaclesFilterNode::process_bounding_boxes(const ObstacleMsg::SharedPtr msg) const
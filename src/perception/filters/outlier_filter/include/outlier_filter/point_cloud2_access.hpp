@@ -0,0 +1,182 @@
+// Copyright 2021 Tier IV, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \copyright Copyright 2021 Tier IV, Inc.
+/// \file
+/// \brief This file defines helpers for reading and copying points of PointCloud2 messages.
+
+#ifndef OUTLIER_FILTER__POINT_CLOUD2_ACCESS_HPP_
+#define OUTLIER_FILTER__POINT_CLOUD2_ACCESS_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "sensor_msgs/msg/point_cloud2.hpp"
+
+
+namespace autoware
+{
+namespace perception
+{
+namespace filters
+{
+namespace outlier_filter
+{
+/** \brief Namespace for implementation details shared by the filters */
+namespace details
+{
+
+/** \brief Get the offset of a float32 field within a point of a PointCloud2
+ * \param cloud The point cloud
+ * \param name The name of the field
+ * \return The byte offset of the field
+ * \throw std::runtime_error If the cloud has no float32 field of that name
+ */
+inline std::uint32_t get_float_field_offset(
+  const sensor_msgs::msg::PointCloud2 & cloud,
+  const std::string & name)
+{
+  for (const auto & field : cloud.fields) {
+    if ((field.name == name) && (field.datatype == sensor_msgs::msg::PointField::FLOAT32)) {
+      return field.offset;
+    }
+  }
+  throw std::runtime_error("outlier_filter: Point cloud has no float32 " + name + " field");
+}
+
+/** \brief Get the offset of a point in the data of a PointCloud2, rows may be padded
+ * \param cloud The point cloud
+ * \param idx The index of the point, in row major order
+ * \return The byte offset of the point
+ */
+inline std::size_t get_point_offset(
+  const sensor_msgs::msg::PointCloud2 & cloud,
+  const std::size_t idx)
+{
+  return (idx / cloud.width) * cloud.row_step + (idx % cloud.width) * cloud.point_step;
+}
+
+/** \brief Read a float32 field of all points of a PointCloud2
+ * \param cloud The point cloud
+ * \param name The name of the field to read
+ * \param values The values of the field, resized to the number of points
+ * \throw std::runtime_error If the field is missing or the data is smaller than the size of the
+ * cloud
+ */
+inline void read_float_field(
+  const sensor_msgs::msg::PointCloud2 & cloud,
+  const std::string & name,
+  std::vector<float> & values)
+{
+  const std::uint32_t offset = get_float_field_offset(cloud, name);
+  const std::size_t num_points = static_cast<std::size_t>(cloud.width) * cloud.height;
+  if ((num_points > 0U) &&
+    ((get_point_offset(cloud, num_points - 1U) + cloud.point_step > cloud.data.size()) ||
+    (offset + sizeof(float) > cloud.point_step)))
+  {
+    throw std::runtime_error("outlier_filter: Point cloud data is smaller than its size");
+  }
+  values.resize(num_points);
+  for (std::size_t i = 0; i < num_points; ++i) {
+    std::memcpy(&values[i], &cloud.data[get_point_offset(cloud, i) + offset], sizeof(float));
+  }
+}
+
+/** \brief Read a float32 field of a subset of the points of a PointCloud2
+ * \param cloud The point cloud
+ * \param name The name of the field to read
+ * \param indices The indices of the points to read
+ * \param values The values of the field, resized to the number of indices
+ * \throw std::runtime_error If the field is missing, an index is not a point of the cloud or the
+ * data is smaller than the size of the cloud
+ */
+inline void read_float_field(
+  const sensor_msgs::msg::PointCloud2 & cloud,
+  const std::string & name,
+  const std::vector<std::size_t> & indices,
+  std::vector<float> & values)
+{
+  const std::uint32_t offset = get_float_field_offset(cloud, name);
+  const std::size_t num_points = static_cast<std::size_t>(cloud.width) * cloud.height;
+  for (const auto idx : indices) {
+    if (idx >= num_points) {
+      throw std::runtime_error("outlier_filter: Selected point is not in the point cloud");
+    }
+  }
+  if ((num_points > 0U) &&
+    ((get_point_offset(cloud, num_points - 1U) + cloud.point_step > cloud.data.size()) ||
+    (offset + sizeof(float) > cloud.point_step)))
+  {
+    throw std::runtime_error("outlier_filter: Point cloud data is smaller than its size");
+  }
+  values.resize(indices.size());
+  for (std::size_t j = 0; j < indices.size(); ++j) {
+    std::memcpy(
+      &values[j], &cloud.data[get_point_offset(cloud, indices[j]) + offset], sizeof(float));
+  }
+}
+
+/** \brief Keep the selected indices at the given positions
+ * \param positions Positions within indices in ascending order
+ * \param indices The selection, replaced by the entries at the positions
+ */
+inline void select_indices(
+  const std::vector<std::size_t> & positions,
+  std::vector<std::size_t> & indices)
+{
+  // The positions are ascending, so every entry is read before it is overwritten
+  for (std::size_t j = 0; j < positions.size(); ++j) {
+    indices[j] = indices[positions[j]];
+  }
+  indices.resize(positions.size());
+}
+
+/** \brief Copy a subset of the points of a PointCloud2 with all their fields
+ * \param input The point cloud to copy from
+ * \param indices The indices of the points to copy, in the order of the output
+ * \param output The point cloud to copy to, replaced by the points as a single row. Must not be the
+ * same message as input
+ */
+inline void copy_points(
+  const sensor_msgs::msg::PointCloud2 & input,
+  const std::vector<std::size_t> & indices,
+  sensor_msgs::msg::PointCloud2 & output)
+{
+  output.header = input.header;
+  output.fields = input.fields;
+  output.is_bigendian = input.is_bigendian;
+  output.point_step = input.point_step;
+  output.height = 1U;
+  output.width = static_cast<std::uint32_t>(indices.size());
+  output.row_step = output.width * output.point_step;
+  output.is_dense = input.is_dense;
+  output.data.resize(static_cast<std::size_t>(output.row_step));
+  for (std::size_t j = 0; j < indices.size(); ++j) {
+    std::memcpy(
+      &output.data[j * output.point_step], &input.data[get_point_offset(input, indices[j])],
+      output.point_step);
+  }
+}
+
+}  // namespace details
+}  // namespace outlier_filter
+}  // namespace filters
+}  // namespace perception
+}  // namespace autoware
+
+#endif  // OUTLIER_FILTER__POINT_CLOUD2_ACCESS_HPP_
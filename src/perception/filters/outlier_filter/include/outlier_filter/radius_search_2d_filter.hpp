@@ -19,12 +19,13 @@
 #ifndef OUTLIER_FILTER__RADIUS_SEARCH_2D_FILTER_HPP_
 #define OUTLIER_FILTER__RADIUS_SEARCH_2D_FILTER_HPP_
 
+#include <cstddef>
 #include <vector>
-#include <memory>
 
 #include "outlier_filter/visibility_control.hpp"
 
-#include "pcl/search/pcl_search.h"
+#include "pcl/point_cloud.h"
+#include "pcl/point_types.h"
 #include "sensor_msgs/msg/point_cloud2.hpp"
 
 
@@ -41,7 +42,11 @@ namespace radius_search_2d_filter
 {
 
 /** \class RadiusSearch2DFilter
- * \brief Library for using a radius based 2D filtering algorithm on a PCL pointcloud
+ * \brief Library for using a radius based 2D filtering algorithm on a pointcloud. The points are
+ * sorted into a flat 2D grid with cells no smaller than the search radius, so that the neighbors of
+ * a point are all in the 3 x 3 cells around it. Neighbors are only counted, and counting stops once
+ * the minimum number of neighbors is reached. The buffers are kept between calls, so that filtering
+ * only allocates when a cloud is larger than all previous ones.
  */
 class OUTLIER_FILTER_PUBLIC RadiusSearch2DFilter
 {
@@ -54,12 +59,35 @@ public:
 
   /** \brief Filter function that runs the radius search algorithm.
    * \param input The input point cloud for filtering
-   * \param output The output point cloud
+   * \param output The output point cloud, the points that are not outliers are appended to it
    */
   void OUTLIER_FILTER_PUBLIC filter(
     const pcl::PointCloud<pcl::PointXYZ> & input,
     pcl::PointCloud<pcl::PointXYZ> & output);
 
+  /** \brief Filter function that runs the radius search algorithm directly on a PointCloud2
+   * message.
+   * \param input The input point cloud for filtering, must have float32 x and y fields
+   * \param output The output point cloud, replaced by the points of input which are not outliers,
+   * with all their fields, as a single row. Must not be the same message as input
+   * \throw std::runtime_error If input has no float32 x or y field, or less data than its size
+   */
+  void OUTLIER_FILTER_PUBLIC filter(
+    const sensor_msgs::msg::PointCloud2 & input,
+    sensor_msgs::msg::PointCloud2 & output);
+
+  /** \brief Filter function that runs the radius search algorithm on the selected points of a
+   * PointCloud2 message only, without copying any points, e.g. to chain several filters.
+   * \param input The input point cloud for filtering, must have float32 x and y fields
+   * \param indices The indices of the points to filter in ascending order, replaced by the ones
+   * that are not outliers among them
+   * \throw std::runtime_error If input has no float32 x or y field, an index is not a point of
+   * input or input has less data than its size
+   */
+  void OUTLIER_FILTER_PUBLIC filter(
+    const sensor_msgs::msg::PointCloud2 & input,
+    std::vector<std::size_t> & indices);
+
   /** \brief Update dynamically configurable parameters
    * \param search_radius Parameter that updates the search_radius_ member variable
    * \param min_neighbors Parameter that updates the min_neighbors_ member variable
@@ -77,8 +105,30 @@ private:
   /** \brief Minimum number of surrounding neighbors for a point to not be considered an outlier */
   int min_neighbors_;
 
-  /** \brief PCL Search object used to perform the radial search */
-  std::shared_ptr<pcl::search::Search<pcl::PointXY>> kd_tree_;
+  /** \brief Find the points with at least min_neighbors_ points, including themselves, within
+   * search_radius_. Reads xs_ and ys_ and writes inliers_
+   */
+  void OUTLIER_FILTER_LOCAL find_inliers();
+
+  /** \brief Coordinates of the points of the current cloud */
+  std::vector<float> xs_;
+  std::vector<float> ys_;
+
+  /** \brief Indices of the points that are not outliers, in ascending order */
+  std::vector<std::size_t> inliers_;
+
+  /** \brief Grid cell of each point of the current cloud */
+  std::vector<std::size_t> point_cells_;
+
+  /** \brief Start of each cell in cell_xs_ and cell_ys_, followed by the number of points */
+  std::vector<std::size_t> cell_offsets_;
+
+  /** \brief Insertion position of each cell while sorting the points into the grid */
+  std::vector<std::size_t> cell_cursors_;
+
+  /** \brief Coordinates of the points sorted by grid cell */
+  std::vector<float> cell_xs_;
+  std::vector<float> cell_ys_;
 };
 }  // namespace radius_search_2d_filter
 }  // namespace outlier_filter
@@ -19,13 +19,15 @@
 #ifndef OUTLIER_FILTER__VOXEL_GRID_OUTLIER_FILTER_HPP_
 #define OUTLIER_FILTER__VOXEL_GRID_OUTLIER_FILTER_HPP_
 
-#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
 
 #include "outlier_filter/visibility_control.hpp"
 
+#include "pcl/point_cloud.h"
+#include "pcl/point_types.h"
 #include "sensor_msgs/msg/point_cloud2.hpp"
-#include "pcl/filters/voxel_grid.h"
-#include "pcl/search/pcl_search.h"
 
 
 namespace autoware
@@ -41,7 +43,12 @@ namespace voxel_grid_outlier_filter
 {
 
 /** \class VoxelGridOutlierFilter
- * \brief Library for applying voxel-based filtering on a PCL pointcloud
+ * \brief Library for applying voxel-based filtering on a pointcloud. Points are kept if their voxel
+ * contains at least voxel_points_threshold points. The voxels are aligned to multiples of the voxel
+ * size, as in pcl::VoxelGrid, and indexed with voxel_grid::Config over the bounds of each cloud.
+ * The voxel indices of all points are sorted in a flat array and counted in one pass, and the
+ * points are kept or dropped in a second. The buffers are kept between calls, so that filtering
+ * only allocates when a cloud is larger than all previous ones.
  */
 class OUTLIER_FILTER_PUBLIC VoxelGridOutlierFilter
 {
@@ -56,14 +63,42 @@ public:
     float voxel_size_x, float voxel_size_y,
     float voxel_size_z, uint32_t voxel_points_threshold);
 
-  /** \brief Filter function that runs the radius search algorithm.
+  /** \brief Filter function that runs the voxel grid algorithm.
    * \param input The input point cloud for filtering
-   * \param output The output point cloud
+   * \param output The output point cloud, the points that are not outliers are appended to it
+   * \throw std::domain_error If a voxel size is smaller than voxel_grid::Config::MIN_VOXEL_SIZE_M
+   * or the cloud spans too many voxels to be indexed
    */
   void OUTLIER_FILTER_PUBLIC filter(
     const pcl::PointCloud<pcl::PointXYZ> & input,
     pcl::PointCloud<pcl::PointXYZ> & output);
 
+  /** \brief Filter function that runs the voxel grid algorithm directly on a PointCloud2 message.
+   * \param input The input point cloud for filtering, must have float32 x, y and z fields
+   * \param output The output point cloud, replaced by the points of input which are not outliers,
+   * with all their fields, as a single row. Must not be the same message as input
+   * \throw std::runtime_error If input has no float32 x, y or z field, or less data than its size
+   * \throw std::domain_error If a voxel size is smaller than voxel_grid::Config::MIN_VOXEL_SIZE_M
+   * or the cloud spans too many voxels to be indexed
+   */
+  void OUTLIER_FILTER_PUBLIC filter(
+    const sensor_msgs::msg::PointCloud2 & input,
+    sensor_msgs::msg::PointCloud2 & output);
+
+  /** \brief Filter function that runs the voxel grid algorithm on the selected points of a
+   * PointCloud2 message only, without copying any points, e.g. to chain several filters.
+   * \param input The input point cloud for filtering, must have float32 x, y and z fields
+   * \param indices The indices of the points to filter in ascending order, replaced by the ones
+   * that are not outliers among them
+   * \throw std::runtime_error If input has no float32 x, y or z field, an index is not a point of
+   * input or input has less data than its size
+   * \throw std::domain_error If a voxel size is smaller than voxel_grid::Config::MIN_VOXEL_SIZE_M
+   * or the selected points span too many voxels to be indexed
+   */
+  void OUTLIER_FILTER_PUBLIC filter(
+    const sensor_msgs::msg::PointCloud2 & input,
+    std::vector<std::size_t> & indices);
+
   /** \brief Update dynamically configurable parameters
    * \param voxel_size_x Parameter that updates the voxel_size_x_ member variable
    * \param voxel_size_y Parameter that updates the voxel_size_y_ member variable
@@ -94,8 +129,27 @@ private:
   /** \brief Minimum number of points per voxel */
   uint32_t voxel_points_threshold_;
 
-  /** \brief Assembles a 3D grid over the pointcloud for filtering */
-  std::shared_ptr<pcl::VoxelGrid<pcl::PointXYZ>> voxel_filter_;
+  /** \brief Find the points whose voxel contains at least voxel_points_threshold_ points. Reads
+   * xs_, ys_ and zs_ and writes inliers_
+   */
+  void OUTLIER_FILTER_LOCAL find_inliers();
+
+  /** \brief Coordinates of the points of the current cloud */
+  std::vector<float> xs_;
+  std::vector<float> ys_;
+  std::vector<float> zs_;
+
+  /** \brief Indices of the points that are not outliers, in ascending order */
+  std::vector<std::size_t> inliers_;
+
+  /** \brief Voxel index of each finite point of the current cloud */
+  std::vector<std::uint64_t> point_voxels_;
+
+  /** \brief Sorted voxel indices, compacted to the distinct occupied voxels */
+  std::vector<std::uint64_t> voxels_;
+
+  /** \brief Number of points in each voxel of voxels_ */
+  std::vector<std::size_t> voxel_counts_;
 };
 
 }  // namespace voxel_grid_outlier_filter
@@ -16,8 +16,12 @@
 #include <memory>
 
 #include "outlier_filter/radius_search_2d_filter.hpp"
+#include "outlier_filter/point_cloud2_access.hpp"
 
-#include "pcl/search/kdtree.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
 
 namespace autoware
 {
@@ -33,27 +37,173 @@ namespace radius_search_2d_filter
 RadiusSearch2DFilter::RadiusSearch2DFilter(double search_radius, int min_neighbors)
 : search_radius_(search_radius), min_neighbors_(min_neighbors)
 {
-  kd_tree_ = std::make_shared<pcl::search::KdTree<pcl::PointXY>>(false);
 }
 
 void RadiusSearch2DFilter::filter(
   const pcl::PointCloud<pcl::PointXYZ> & input,
   pcl::PointCloud<pcl::PointXYZ> & output)
 {
-  pcl::PointCloud<pcl::PointXY>::Ptr xy_cloud(new pcl::PointCloud<pcl::PointXY>());
-  xy_cloud->points.resize(input.points.size());
+  xs_.resize(input.points.size());
+  ys_.resize(input.points.size());
   for (size_t i = 0; i < input.points.size(); ++i) {
-    xy_cloud->points[i].x = input.points[i].x;
-    xy_cloud->points[i].y = input.points[i].y;
+    xs_[i] = input.points[i].x;
+    ys_[i] = input.points[i].y;
   }
 
-  std::vector<int> k_indices(xy_cloud->points.size());
-  std::vector<float> k_dists(xy_cloud->points.size());
-  kd_tree_->setInputCloud(xy_cloud);
-  for (size_t i = 0; i < xy_cloud->points.size(); ++i) {
-    auto k = kd_tree_->radiusSearch(static_cast<int>(i), search_radius_, k_indices, k_dists);
-    if (k >= min_neighbors_) {
-      output.points.push_back(input.points.at(i));
+  find_inliers();
+  for (const auto i : inliers_) {
+    output.points.push_back(input.points[i]);
+  }
+  output.width = static_cast<std::uint32_t>(output.points.size());
+  output.height = 1U;
+}
+
+void RadiusSearch2DFilter::filter(
+  const sensor_msgs::msg::PointCloud2 & input,
+  sensor_msgs::msg::PointCloud2 & output)
+{
+  details::read_float_field(input, "x", xs_);
+  details::read_float_field(input, "y", ys_);
+
+  find_inliers();
+  details::copy_points(input, inliers_, output);
+}
+
+void RadiusSearch2DFilter::filter(
+  const sensor_msgs::msg::PointCloud2 & input,
+  std::vector<std::size_t> & indices)
+{
+  details::read_float_field(input, "x", indices, xs_);
+  details::read_float_field(input, "y", indices, ys_);
+
+  find_inliers();
+  details::select_indices(inliers_, indices);
+}
+
+void RadiusSearch2DFilter::find_inliers()
+{
+  const std::size_t num_points = xs_.size();
+  inliers_.clear();
+  // A point is always its own neighbor, points with non-finite coordinates have no neighbors
+  if (min_neighbors_ <= 0) {
+    for (std::size_t i = 0; i < num_points; ++i) {
+      inliers_.push_back(i);
+    }
+    return;
+  }
+  if (min_neighbors_ == 1) {
+    for (std::size_t i = 0; i < num_points; ++i) {
+      if (std::isfinite(xs_[i]) && std::isfinite(ys_[i])) {
+        inliers_.push_back(i);
+      }
+    }
+    return;
+  }
+  float min_x = std::numeric_limits<float>::max();
+  float max_x = std::numeric_limits<float>::lowest();
+  float min_y = std::numeric_limits<float>::max();
+  float max_y = std::numeric_limits<float>::lowest();
+  std::size_t num_finite = 0;
+  for (std::size_t i = 0; i < num_points; ++i) {
+    if (std::isfinite(xs_[i]) && std::isfinite(ys_[i])) {
+      min_x = std::min(min_x, xs_[i]);
+      max_x = std::max(max_x, xs_[i]);
+      min_y = std::min(min_y, ys_[i]);
+      max_y = std::max(max_y, ys_[i]);
+      ++num_finite;
+    }
+  }
+  if (num_finite == 0) {
+    return;
+  }
+
+  // Cells narrower than the radius would need a larger neighborhood. For clouds that are sparse
+  // over a large area, the cells are made larger to keep the number of cells close to the number
+  // of points.
+  const float radius = static_cast<float>(search_radius_);
+  const float radius2 = (radius > 0.0F) ? (radius * radius) : 0.0F;
+  const double extent_x = static_cast<double>(max_x) - static_cast<double>(min_x);
+  const double extent_y = static_cast<double>(max_y) - static_cast<double>(min_y);
+  const double max_num_cells = 2.0 * static_cast<double>(num_finite) + 64.0;
+  // The cells are slightly larger than the radius, as the float comparison of the squared distance
+  // can accept points marginally outside of it
+  double cell_size = (search_radius_ > 0.0) ? (search_radius_ * (1.0 + 1e-5)) : 1.0;
+  const auto count_cells = [extent_x, extent_y](double size) {
+      return (std::floor(extent_x / size) + 1.0) * (std::floor(extent_y / size) + 1.0);
+    };
+  if (count_cells(cell_size) > max_num_cells) {
+    cell_size *= std::sqrt(count_cells(cell_size) / max_num_cells);
+    while (count_cells(cell_size) > max_num_cells) {
+      cell_size *= 2.0;
+    }
+  }
+  const double inv_cell_size = 1.0 / cell_size;
+  const auto cell_x = [min_x, inv_cell_size](float x) {
+      return static_cast<std::size_t>((static_cast<double>(x) - static_cast<double>(min_x)) *
+             inv_cell_size);
+    };
+  const auto cell_y = [min_y, inv_cell_size](float y) {
+      return static_cast<std::size_t>((static_cast<double>(y) - static_cast<double>(min_y)) *
+             inv_cell_size);
+    };
+  const std::size_t num_cells_x = cell_x(max_x) + 1U;
+  const std::size_t num_cells_y = cell_y(max_y) + 1U;
+  const std::size_t num_cells = num_cells_x * num_cells_y;
+
+  // Counting sort of the points by cell
+  point_cells_.resize(num_points);
+  cell_offsets_.assign(num_cells + 1U, 0U);
+  for (std::size_t i = 0; i < num_points; ++i) {
+    if (std::isfinite(xs_[i]) && std::isfinite(ys_[i])) {
+      point_cells_[i] = cell_y(ys_[i]) * num_cells_x + cell_x(xs_[i]);
+      ++cell_offsets_[point_cells_[i] + 1U];
+    }
+  }
+  for (std::size_t c = 1U; c <= num_cells; ++c) {
+    cell_offsets_[c] += cell_offsets_[c - 1U];
+  }
+  cell_cursors_.assign(cell_offsets_.begin(), cell_offsets_.end() - 1);
+  cell_xs_.resize(num_finite);
+  cell_ys_.resize(num_finite);
+  for (std::size_t i = 0; i < num_points; ++i) {
+    if (std::isfinite(xs_[i]) && std::isfinite(ys_[i])) {
+      const std::size_t pos = cell_cursors_[point_cells_[i]]++;
+      cell_xs_[pos] = xs_[i];
+      cell_ys_[pos] = ys_[i];
+    }
+  }
+
+  // Count the neighbors in the 3 x 3 cells around each point, until there are enough
+  const std::size_t min_neighbors = static_cast<std::size_t>(min_neighbors_);
+  for (std::size_t i = 0; i < num_points; ++i) {
+    if (!std::isfinite(xs_[i]) || !std::isfinite(ys_[i])) {
+      continue;
+    }
+    const float x = xs_[i];
+    const float y = ys_[i];
+    const std::size_t cx = point_cells_[i] % num_cells_x;
+    const std::size_t cy = point_cells_[i] / num_cells_x;
+    const std::size_t first_x = (cx > 0U) ? (cx - 1U) : 0U;
+    const std::size_t last_x = std::min(cx + 1U, num_cells_x - 1U);
+    const std::size_t first_y = (cy > 0U) ? (cy - 1U) : 0U;
+    const std::size_t last_y = std::min(cy + 1U, num_cells_y - 1U);
+    std::size_t count = 0;
+    for (std::size_t ky = first_y; (ky <= last_y) && (count < min_neighbors); ++ky) {
+      for (std::size_t kx = first_x; (kx <= last_x) && (count < min_neighbors); ++kx) {
+        const std::size_t c = ky * num_cells_x + kx;
+        for (std::size_t k = cell_offsets_[c];
+          (k < cell_offsets_[c + 1U]) && (count < min_neighbors); ++k)
+        {
+          const float dx = cell_xs_[k] - x;
+          const float dy = cell_ys_[k] - y;
+          if (dx * dx + dy * dy <= radius2) {
+            ++count;
+          }
+        }
+      }
+    }
+    if (count >= min_neighbors) {
+      inliers_.push_back(i);
     }
   }
 }
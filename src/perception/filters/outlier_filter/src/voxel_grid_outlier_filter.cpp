@@ -13,8 +13,14 @@
 // limitations under the License.
 
 #include "outlier_filter/voxel_grid_outlier_filter.hpp"
+#include "outlier_filter/point_cloud2_access.hpp"
 
-#include <memory>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "voxel_grid/config.hpp"
 
 namespace autoware
 {
@@ -27,40 +33,148 @@ namespace outlier_filter
 namespace voxel_grid_outlier_filter
 {
 
+using autoware::perception::filters::voxel_grid::Config;
+
+namespace
+{
+// Voxel index of points with non-finite coordinates, larger than any index of a Config
+constexpr std::uint64_t NO_VOXEL = std::numeric_limits<std::uint64_t>::max();
+}  // namespace
+
 VoxelGridOutlierFilter::VoxelGridOutlierFilter(
   float voxel_size_x, float voxel_size_y, float voxel_size_z,
   uint32_t voxel_points_threshold)
 : voxel_size_x_(voxel_size_x), voxel_size_y_(voxel_size_y), voxel_size_z_(voxel_size_z),
   voxel_points_threshold_(voxel_points_threshold)
 {
-  voxel_filter_ = std::make_shared<pcl::VoxelGrid<pcl::PointXYZ>>();
 }
 
 void VoxelGridOutlierFilter::filter(
   const pcl::PointCloud<pcl::PointXYZ> & input,
   pcl::PointCloud<pcl::PointXYZ> & output)
 {
-  pcl::PointCloud<pcl::PointXYZ>::Ptr pcl_voxelized_input(new pcl::PointCloud<pcl::PointXYZ>);
-  pcl_voxelized_input->points.reserve(input.points.size());
-
-  // Set parameters for voxel filter object
-  pcl::PointCloud<pcl::PointXYZ>::ConstPtr pc_input(new pcl::PointCloud<pcl::PointXYZ>(input));
-  voxel_filter_->setInputCloud(pc_input);
-  // Leaf size set to true to save a copy of the tree layout for faster access when invoking
-  // getCentroidIndexAt
-  // Ref: https://pointclouds.org/documentation/classpcl_1_1_voxel_grid.html#a57f1511c023294989ab5ae83bc439ae3
-  voxel_filter_->setSaveLeafLayout(true);
-  voxel_filter_->setLeafSize(voxel_size_x_, voxel_size_y_, voxel_size_z_);
-  voxel_filter_->setMinimumPointsNumberPerVoxel(voxel_points_threshold_);
-  voxel_filter_->filter(*pcl_voxelized_input);
-
-  output.points.reserve(input.points.size());
+  xs_.resize(input.points.size());
+  ys_.resize(input.points.size());
+  zs_.resize(input.points.size());
   for (size_t i = 0; i < input.points.size(); ++i) {
-    const int index = voxel_filter_->getCentroidIndexAt(
-      voxel_filter_->getGridCoordinates(
-        input.points.at(i).x, input.points.at(i).y, input.points.at(i).z));
-    if (index != -1) {  // not empty voxel
-      output.points.push_back(input.points.at(i));
+    xs_[i] = input.points[i].x;
+    ys_[i] = input.points[i].y;
+    zs_[i] = input.points[i].z;
+  }
+
+  find_inliers();
+  for (const auto i : inliers_) {
+    output.points.push_back(input.points[i]);
+  }
+  output.width = static_cast<std::uint32_t>(output.points.size());
+  output.height = 1U;
+}
+
+void VoxelGridOutlierFilter::filter(
+  const sensor_msgs::msg::PointCloud2 & input,
+  sensor_msgs::msg::PointCloud2 & output)
+{
+  details::read_float_field(input, "x", xs_);
+  details::read_float_field(input, "y", ys_);
+  details::read_float_field(input, "z", zs_);
+
+  find_inliers();
+  details::copy_points(input, inliers_, output);
+}
+
+void VoxelGridOutlierFilter::filter(
+  const sensor_msgs::msg::PointCloud2 & input,
+  std::vector<std::size_t> & indices)
+{
+  details::read_float_field(input, "x", indices, xs_);
+  details::read_float_field(input, "y", indices, ys_);
+  details::read_float_field(input, "z", indices, zs_);
+
+  find_inliers();
+  details::select_indices(inliers_, indices);
+}
+
+void VoxelGridOutlierFilter::find_inliers()
+{
+  const std::size_t num_points = xs_.size();
+  inliers_.clear();
+  voxel_grid::PointXYZ min_point;
+  min_point.x = std::numeric_limits<float>::max();
+  min_point.y = std::numeric_limits<float>::max();
+  min_point.z = std::numeric_limits<float>::max();
+  voxel_grid::PointXYZ max_point;
+  max_point.x = std::numeric_limits<float>::lowest();
+  max_point.y = std::numeric_limits<float>::lowest();
+  max_point.z = std::numeric_limits<float>::lowest();
+  std::size_t num_finite = 0U;
+  for (std::size_t i = 0; i < num_points; ++i) {
+    if (std::isfinite(xs_[i]) && std::isfinite(ys_[i]) && std::isfinite(zs_[i])) {
+      min_point.x = std::min(min_point.x, xs_[i]);
+      min_point.y = std::min(min_point.y, ys_[i]);
+      min_point.z = std::min(min_point.z, zs_[i]);
+      max_point.x = std::max(max_point.x, xs_[i]);
+      max_point.y = std::max(max_point.y, ys_[i]);
+      max_point.z = std::max(max_point.z, zs_[i]);
+      ++num_finite;
+    }
+  }
+  // Points with non-finite coordinates are in no voxel and always removed
+  if (num_finite == 0U) {
+    return;
+  }
+
+  // Align the grid to multiples of the voxel size like pcl::VoxelGrid, so that the voxels do not
+  // move with the extent of the cloud. A margin of voxels beyond the last point ensures that
+  // rounding never clamps a point into the voxel of another one
+  voxel_grid::PointXYZ voxel_size;
+  voxel_size.x = voxel_size_x_;
+  voxel_size.y = voxel_size_y_;
+  voxel_size.z = voxel_size_z_;
+  const auto align = [](float & min, float & max, const float size) {
+      min = std::floor(min / size) * size;
+      max = min + (std::floor((max - min) / size) + 3.0F) * size;
+    };
+  align(min_point.x, max_point.x, voxel_size.x);
+  align(min_point.y, max_point.y, voxel_size.y);
+  align(min_point.z, max_point.z, voxel_size.z);
+  const Config config{min_point, max_point, voxel_size, num_finite};
+
+  point_voxels_.resize(num_points);
+  voxels_.clear();
+  for (std::size_t i = 0; i < num_points; ++i) {
+    if (std::isfinite(xs_[i]) && std::isfinite(ys_[i]) && std::isfinite(zs_[i])) {
+      voxel_grid::PointXYZ point;
+      point.x = xs_[i];
+      point.y = ys_[i];
+      point.z = zs_[i];
+      point_voxels_[i] = config.index(point);
+      voxels_.push_back(point_voxels_[i]);
+    } else {
+      point_voxels_[i] = NO_VOXEL;
+    }
+  }
+
+  // Count the points of each voxel in the sorted indices
+  std::sort(voxels_.begin(), voxels_.end());
+  voxel_counts_.clear();
+  std::size_t num_voxels = 0U;
+  for (std::size_t j = 0; j < voxels_.size(); ++j) {
+    if ((j == 0U) || (voxels_[j] != voxels_[num_voxels - 1U])) {
+      voxels_[num_voxels] = voxels_[j];
+      voxel_counts_.push_back(0U);
+      ++num_voxels;
+    }
+    ++voxel_counts_[num_voxels - 1U];
+  }
+  voxels_.resize(num_voxels);
+
+  for (std::size_t i = 0; i < num_points; ++i) {
+    if (point_voxels_[i] != NO_VOXEL) {
+      const auto voxel_it = std::lower_bound(voxels_.begin(), voxels_.end(), point_voxels_[i]);
+      const auto count = voxel_counts_[static_cast<std::size_t>(voxel_it - voxels_.begin())];
+      if (count >= voxel_points_threshold_) {
+        inliers_.push_back(i);
+      }
     }
   }
 }
@@ -14,6 +14,7 @@
 
 #include <vector>
 #include <memory>
+#include <stdexcept>
 
 #include "gtest/gtest.h"
 #include "pcl_conversions/pcl_conversions.h"
@@ -154,3 +155,102 @@ TEST(RadiusSearch2DFilter, test_decrease_search_radius) {
   // Min neighbours increased, not enough neighbours all points should fail checks
   check_pc({}, output);
 }
+
+/* TEST 6: The PointCloud2 filter gives the same result as the PCL filter
+ *   x       x        x
+ * x x x         -> x x x
+ *   x                x
+ */
+TEST(RadiusSearch2DFilter, test_point_cloud2_outlier_point) {
+  auto filter = std::make_shared<RadiusSearch2DFilter>(0.5, 5);
+  std::vector<pcl::PointXYZ> points = {
+    make_point(0.0f, 0.0f, 0.0f),
+    make_point(0.2f, 0.0f, 0.0f),
+    make_point(0.8f, 0.2f, 0.0f),
+    make_point(0.0f, 0.2f, 0.0f),
+    make_point(-0.2f, 0.0f, 0.0f),
+    make_point(0.0f, -0.2f, 1.0f)};
+  auto time0 = std::chrono::system_clock::now();
+  auto t0 = to_msg_time(time0);
+  sensor_msgs::msg::PointCloud2 input;
+  pcl::toROSMsg(make_pc(points, t0), input);
+
+  // Run the filter
+  sensor_msgs::msg::PointCloud2 output;
+  filter->filter(input, output);
+
+  // Perform checks on the output pointcloud
+  EXPECT_EQ(output.header, input.header);
+  EXPECT_EQ(output.fields, input.fields);
+  EXPECT_EQ(output.height, 1U);
+  EXPECT_EQ(output.row_step, output.width * output.point_step);
+  pcl::PointCloud<pcl::PointXYZ> pcl_output;
+  pcl::fromROSMsg(output, pcl_output);
+  points.erase(points.begin() + 2);
+  check_pc(points, pcl_output);
+}
+
+/* TEST 7: The PointCloud2 filter requires x and y fields
+ */
+TEST(RadiusSearch2DFilter, test_point_cloud2_missing_field) {
+  auto filter = std::make_shared<RadiusSearch2DFilter>(1.0, 5);
+  sensor_msgs::msg::PointCloud2 input;
+  sensor_msgs::msg::PointCloud2 output;
+  EXPECT_THROW(filter->filter(input, output), std::runtime_error);
+}
+
+/* TEST 8: The neighbors of points far apart are found in a cloud that spans a large area
+ *   x x              x x
+ *   x x  ...  x  ->  x x  ...
+ */
+TEST(RadiusSearch2DFilter, test_sparse_large_cloud) {
+  auto filter = std::make_shared<RadiusSearch2DFilter>(0.5, 4);
+  std::vector<pcl::PointXYZ> points;
+  for (const float offset : {-1000.0f, 0.0f, 2500.0f}) {
+    points.push_back(make_point(offset, offset, 0.0f));
+    points.push_back(make_point(offset + 0.3f, offset, 0.0f));
+    points.push_back(make_point(offset, offset + 0.3f, 0.0f));
+    points.push_back(make_point(offset + 0.3f, offset + 0.3f, 0.0f));
+  }
+  std::vector<pcl::PointXYZ> expected = points;
+  points.push_back(make_point(10.0f, 0.0f, 0.0f));
+  auto time0 = std::chrono::system_clock::now();
+  auto t0 = to_msg_time(time0);
+  auto input = make_pc(points, t0);
+
+  // Run the filter
+  pcl::PointCloud<pcl::PointXYZ> output;
+  filter->filter(input, output);
+
+  // Only the isolated point is removed
+  check_pc(expected, output);
+}
+
+/* TEST 9: Filtering selected points only counts the selected points as neighbors
+ */
+TEST(RadiusSearch2DFilter, test_point_cloud2_selected_points) {
+  auto filter = std::make_shared<RadiusSearch2DFilter>(0.5, 5);
+  std::vector<pcl::PointXYZ> points = {
+    make_point(0.0f, 0.0f, 0.0f),
+    make_point(0.2f, 0.0f, 0.0f),
+    make_point(0.8f, 0.2f, 0.0f),
+    make_point(0.0f, 0.2f, 0.0f),
+    make_point(-0.2f, 0.0f, 0.0f),
+    make_point(0.0f, -0.2f, 1.0f)};
+  auto time0 = std::chrono::system_clock::now();
+  auto t0 = to_msg_time(time0);
+  sensor_msgs::msg::PointCloud2 input;
+  pcl::toROSMsg(make_pc(points, t0), input);
+
+  std::vector<std::size_t> indices = {0U, 1U, 2U, 3U, 4U, 5U};
+  filter->filter(input, indices);
+  EXPECT_EQ(indices, (std::vector<std::size_t>{0U, 1U, 3U, 4U, 5U}));
+
+  // Without the center point, no point has enough neighbors
+  indices = {1U, 2U, 3U, 4U, 5U};
+  filter->filter(input, indices);
+  EXPECT_TRUE(indices.empty());
+
+  indices = {6U};
+  EXPECT_THROW(filter->filter(input, indices), std::runtime_error);
+}
@@ -12,10 +12,13 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <limits>
 #include <memory>
+#include <stdexcept>
 #include <vector>
 
 #include "gtest/gtest.h"
+#include "pcl_conversions/pcl_conversions.h"
 #include "outlier_filter/voxel_grid_outlier_filter.hpp"
 #include "outlier_filter_test_utils.hpp"
 
@@ -122,3 +125,108 @@ TEST(VoxelGridOutlierFilterTest, test_line) {
   points.pop_back();
   check_pc(points, output);
 }
+
+/* TEST 4: The PointCloud2 filter gives the same result as the PCL filter
+ *     |            |
+ *  xx |  x      xx |
+ *     |            |
+ * --------- -> ---------
+ *     |            |
+ *  x  |  x         |
+ *     |            |
+ */
+TEST(VoxelGridOutlierFilterTest, test_point_cloud2_two_close_points) {
+  auto filter =
+    std::make_shared<VoxelGridOutlierFilter>(1.0f, 1.0f, 1.0f, static_cast<uint32_t>(2));
+  std::vector<pcl::PointXYZ> points = {
+    make_point(-1.0f, 1.0f, 0.0f),
+    make_point(-0.8f, 1.0f, 0.0f),
+    make_point(-1.0f, -1.0f, 0.0f),
+    make_point(1.0f, 1.0f, 0.0f),
+    make_point(1.0f, -1.0f, 0.0f)};
+  auto time0 = std::chrono::system_clock::now();
+  auto t0 = to_msg_time(time0);
+  sensor_msgs::msg::PointCloud2 input;
+  pcl::toROSMsg(make_pc(points, t0), input);
+
+  // Run the filter
+  sensor_msgs::msg::PointCloud2 output;
+  filter->filter(input, output);
+
+  // Perform the check
+  EXPECT_EQ(output.header, input.header);
+  EXPECT_EQ(output.fields, input.fields);
+  EXPECT_EQ(output.height, 1U);
+  EXPECT_EQ(output.row_step, output.width * output.point_step);
+  pcl::PointCloud<pcl::PointXYZ> pcl_output;
+  pcl::fromROSMsg(output, pcl_output);
+  std::vector<pcl::PointXYZ> filter_points = {
+    make_point(-1.0f, 1.0f, 0.0f),
+    make_point(-0.8f, 1.0f, 0.0f)
+  };
+  check_pc(filter_points, pcl_output);
+}
+
+/* TEST 5: Points with non-finite coordinates are removed
+ */
+TEST(VoxelGridOutlierFilterTest, test_non_finite_points) {
+  auto filter =
+    std::make_shared<VoxelGridOutlierFilter>(1.0f, 1.0f, 1.0f, static_cast<uint32_t>(1));
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  std::vector<pcl::PointXYZ> points = {
+    make_point(-1.0f, 1.0f, 0.0f),
+    make_point(nan, 1.0f, 0.0f),
+    make_point(1.0f, -1.0f, std::numeric_limits<float>::infinity())};
+  auto time0 = std::chrono::system_clock::now();
+  auto t0 = to_msg_time(time0);
+  auto input = make_pc(points, t0);
+
+  // Run the filter
+  pcl::PointCloud<pcl::PointXYZ> output;
+  filter->filter(input, output);
+
+  // Perform the check
+  points.resize(1U);
+  check_pc(points, output);
+}
+
+/* TEST 6: Voxels that are too small for the grid are rejected
+ */
+TEST(VoxelGridOutlierFilterTest, test_too_small_voxel) {
+  auto filter =
+    std::make_shared<VoxelGridOutlierFilter>(0.0f, 1.0f, 1.0f, static_cast<uint32_t>(1));
+  std::vector<pcl::PointXYZ> points = {make_point(0.0f, 0.0f, 0.0f)};
+  auto time0 = std::chrono::system_clock::now();
+  auto t0 = to_msg_time(time0);
+  auto input = make_pc(points, t0);
+
+  pcl::PointCloud<pcl::PointXYZ> output;
+  EXPECT_THROW(filter->filter(input, output), std::domain_error);
+}
+
+/* TEST 7: Filtering selected points only counts these points in the voxels
+ */
+TEST(VoxelGridOutlierFilterTest, test_point_cloud2_selected_points) {
+  auto filter =
+    std::make_shared<VoxelGridOutlierFilter>(1.0f, 1.0f, 1.0f, static_cast<uint32_t>(2));
+  std::vector<pcl::PointXYZ> points = {
+    make_point(-1.0f, 1.0f, 0.0f),
+    make_point(-0.8f, 1.0f, 0.0f),
+    make_point(-1.0f, -1.0f, 0.0f),
+    make_point(1.0f, 1.0f, 0.0f),
+    make_point(1.0f, -1.0f, 0.0f),
+    make_point(1.2f, -1.0f, 0.0f)};
+  auto time0 = std::chrono::system_clock::now();
+  auto t0 = to_msg_time(time0);
+  sensor_msgs::msg::PointCloud2 input;
+  pcl::toROSMsg(make_pc(points, t0), input);
+
+  std::vector<std::size_t> indices = {0U, 1U, 2U, 3U, 4U, 5U};
+  filter->filter(input, indices);
+  EXPECT_EQ(indices, (std::vector<std::size_t>{0U, 1U, 4U, 5U}));
+
+  // The remaining point of a voxel is an outlier
+  indices = {0U, 2U, 3U, 4U, 5U};
+  filter->filter(input, indices);
+  EXPECT_EQ(indices, (std::vector<std::size_t>{4U, 5U}));
+}
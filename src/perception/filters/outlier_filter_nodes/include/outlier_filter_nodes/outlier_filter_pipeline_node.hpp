@@ -0,0 +1,113 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \copyright Copyright 2021 the Autoware Foundation
+/// \file
+/// \brief This file defines the OutlierFilterPipelineNode class.
+
+#ifndef OUTLIER_FILTER_NODES__OUTLIER_FILTER_PIPELINE_NODE_HPP_
+#define OUTLIER_FILTER_NODES__OUTLIER_FILTER_PIPELINE_NODE_HPP_
+
+#include <memory>
+#include <vector>
+
+#include "common/types.hpp"
+#include "outlier_filter_nodes/visibility_control.hpp"
+
+#include "filter_node_base/filter_node_base.hpp"
+#include "filter_node_base/filter_pipeline.hpp"
+#include "outlier_filter/radius_search_2d_filter.hpp"
+#include "outlier_filter/voxel_grid_outlier_filter.hpp"
+#include "rclcpp/rclcpp.hpp"
+
+
+namespace autoware
+{
+namespace perception
+{
+namespace filters
+{
+namespace outlier_filter_nodes
+{
+
+/// \class OutlierFilterPipelineNode
+/// \brief Node inheriting from FilterNodeBase that applies several outlier filters in one
+//   callback. The filters only narrow down the selection of points of the input cloud, which is
+//   copied once into the output cloud after the last filter.
+class OUTLIER_FILTER_NODES_PUBLIC OutlierFilterPipelineNode final : public filter_node_base::
+  FilterNodeBase
+{
+public:
+  /** \brief The default constructor for the OutlierFilterPipelineNode class
+   * \param options An rclcpp::NodeOptions object to pass on to the FilterNodeBase class
+   * \throw std::domain_error If the stages are empty, unknown or appear more than once
+   */
+  explicit OutlierFilterPipelineNode(const rclcpp::NodeOptions & options);
+
+protected:
+  /** \brief Implementation of the FilterNodeBase class abstract filter method
+   *
+   * Runs the filters in the order of the `stages` parameter on the input point cloud and returns
+   * the points that pass all of them, with all their fields, via the output argument.
+   *
+   * \param input The input point cloud dataset.
+   * \param output The resultant filtered PointCloud2
+   */
+  OUTLIER_FILTER_NODES_PUBLIC void filter(
+    const sensor_msgs::msg::PointCloud2 & input,
+    sensor_msgs::msg::PointCloud2 & output) override;
+
+  /** \brief Implementation of the FilterNodeBase class abstract get_node_parameters method
+   *
+   * Updates the parameters of the filters of the pipeline, which are prefixed by the name of their
+   * stage, e.g. `radius_search_2d.search_radius`.
+   *
+   * \param p Vector of rclcpp::Parameters belonging to the node
+   * \return rcl_interfaces::msg::SetParametersResult Result of retrieving the parameter
+   */
+  OUTLIER_FILTER_NODES_PUBLIC rcl_interfaces::msg::SetParametersResult get_node_parameters(
+    const std::vector<rclcpp::Parameter> & p) override;
+
+private:
+  /** \brief The filters in the order in which they are applied */
+  filter_node_base::FilterPipeline pipeline_;
+
+  /** \brief The RadiusSearch2DFilter of the pipeline, null if it is not one of the stages */
+  std::shared_ptr<perception::filters::outlier_filter::radius_search_2d_filter::
+    RadiusSearch2DFilter> radius_search_2d_filter_;
+
+  /** \brief Value of the search radius (passed into radius_search_2d_filter_) */
+  common::types::float64_t search_radius_{};
+
+  /** \brief Value of the minimum neighbors for points (passed into radius_search_2d_filter_) */
+  std::int64_t min_neighbors_{};
+
+  /** \brief The VoxelGridOutlierFilter of the pipeline, null if it is not one of the stages */
+  std::shared_ptr<perception::filters::outlier_filter::voxel_grid_outlier_filter::
+    VoxelGridOutlierFilter> voxel_grid_outlier_filter_;
+
+  /** \brief Value of the voxel dimensions (passed into voxel_grid_outlier_filter_) */
+  common::types::float64_t voxel_size_x_{};
+  common::types::float64_t voxel_size_y_{};
+  common::types::float64_t voxel_size_z_{};
+
+  /** \brief Value of the points threshold (passed into voxel_grid_outlier_filter_) */
+  std::int64_t voxel_points_threshold_{};
+};
+}  // namespace outlier_filter_nodes
+}  // namespace filters
+}  // namespace perception
+}  // namespace autoware
+
+#endif  // OUTLIER_FILTER_NODES__OUTLIER_FILTER_PIPELINE_NODE_HPP_
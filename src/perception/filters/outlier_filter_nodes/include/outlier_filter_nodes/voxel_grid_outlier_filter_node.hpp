@@ -54,9 +54,9 @@ public:
 protected:
   /** \brief Implementation of the FilterNodeBase class abstract filter method
    *
-   * Converts the point cloud into the PCL::PointCloud<pcl::PointXYZ> type to be processed by the
-   * VoxelGridOutlierFilter library. The method then returns the filter point cloud via the output
-   * argument.
+   * Passes the point cloud directly to the VoxelGridOutlierFilter library, which keeps all fields
+   * of the points that are not outliers. The method then returns the filtered point cloud via the
+   * output argument.
    *
    * \param input The input point cloud dataset.
    * \param output The resultant filtered PointCloud2
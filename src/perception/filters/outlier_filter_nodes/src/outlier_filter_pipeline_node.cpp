@@ -0,0 +1,161 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "outlier_filter_nodes/outlier_filter_pipeline_node.hpp"
+
+
+namespace autoware
+{
+namespace perception
+{
+namespace filters
+{
+namespace outlier_filter_nodes
+{
+
+using float64_t = autoware::common::types::float64_t;
+using float32_t = autoware::common::types::float32_t;
+
+using RadiusSearch2DFilter =
+  autoware::perception::filters::outlier_filter::radius_search_2d_filter::
+  RadiusSearch2DFilter;
+using VoxelGridOutlierFilter =
+  autoware::perception::filters::outlier_filter::voxel_grid_outlier_filter::
+  VoxelGridOutlierFilter;
+
+namespace
+{
+constexpr auto kRadiusSearch2DStage = "radius_search_2d";
+constexpr auto kVoxelGridOutlierStage = "voxel_grid_outlier";
+
+/// \brief Adapts an outlier filter library class to a stage of a FilterPipeline
+template<typename FilterT>
+class OutlierFilterStage : public filter_node_base::FilterStage
+{
+public:
+  explicit OutlierFilterStage(std::shared_ptr<FilterT> filter)
+  : filter_(std::move(filter)) {}
+
+  void filter(
+    const sensor_msgs::msg::PointCloud2 & input,
+    std::vector<std::size_t> & indices) override
+  {
+    filter_->filter(input, indices);
+  }
+
+private:
+  std::shared_ptr<FilterT> filter_;
+};
+
+std::string param_name(const char * stage, const char * name)
+{
+  return std::string{stage} + "." + name;
+}
+}  // namespace
+
+OutlierFilterPipelineNode::OutlierFilterPipelineNode(const rclcpp::NodeOptions & options)
+: FilterNodeBase("outlier_filter_pipeline_node", options)
+{
+  const auto stages = declare_parameter("stages").get<std::vector<std::string>>();
+  if (stages.empty()) {
+    throw std::domain_error("OutlierFilterPipelineNode: No stages given");
+  }
+  for (const auto & stage : stages) {
+    if (stage == kRadiusSearch2DStage && !radius_search_2d_filter_) {
+      search_radius_ = declare_parameter(
+        param_name(kRadiusSearch2DStage, "search_radius")).get<float64_t>();
+      min_neighbors_ = declare_parameter(
+        param_name(kRadiusSearch2DStage, "min_neighbors")).get<std::int64_t>();
+      radius_search_2d_filter_ = std::make_shared<RadiusSearch2DFilter>(
+        search_radius_, static_cast<int>(min_neighbors_));
+      pipeline_.add_stage(
+        std::make_shared<OutlierFilterStage<RadiusSearch2DFilter>>(radius_search_2d_filter_));
+    } else if (stage == kVoxelGridOutlierStage && !voxel_grid_outlier_filter_) {
+      voxel_size_x_ = declare_parameter(
+        param_name(kVoxelGridOutlierStage, "voxel_size_x")).get<float64_t>();
+      voxel_size_y_ = declare_parameter(
+        param_name(kVoxelGridOutlierStage, "voxel_size_y")).get<float64_t>();
+      voxel_size_z_ = declare_parameter(
+        param_name(kVoxelGridOutlierStage, "voxel_size_z")).get<float64_t>();
+      voxel_points_threshold_ = declare_parameter(
+        param_name(kVoxelGridOutlierStage, "voxel_points_threshold")).get<std::int64_t>();
+      voxel_grid_outlier_filter_ = std::make_shared<VoxelGridOutlierFilter>(
+        static_cast<float32_t>(voxel_size_x_), static_cast<float32_t>(voxel_size_y_),
+        static_cast<float32_t>(voxel_size_z_),
+        static_cast<std::uint32_t>(voxel_points_threshold_));
+      pipeline_.add_stage(
+        std::make_shared<OutlierFilterStage<VoxelGridOutlierFilter>>(
+          voxel_grid_outlier_filter_));
+    } else {
+      throw std::domain_error(
+              "OutlierFilterPipelineNode: Unknown or repeated stage " + stage);
+    }
+  }
+
+  set_param_callback();
+}
+
+void OutlierFilterPipelineNode::filter(
+  const sensor_msgs::msg::PointCloud2 & input,
+  sensor_msgs::msg::PointCloud2 & output)
+{
+  pipeline_.filter(input, output);
+}
+
+rcl_interfaces::msg::SetParametersResult OutlierFilterPipelineNode::get_node_parameters(
+  const std::vector<rclcpp::Parameter> & p)
+{
+  rcl_interfaces::msg::SetParametersResult result;
+  result.successful = true;
+  result.reason = "";
+
+  using filter_node_base::get_param;
+  if (radius_search_2d_filter_) {
+    get_param<float64_t>(p, param_name(kRadiusSearch2DStage, "search_radius"), search_radius_);
+    get_param<std::int64_t>(
+      p, param_name(kRadiusSearch2DStage, "min_neighbors"), min_neighbors_);
+    radius_search_2d_filter_->update_parameters(search_radius_, static_cast<int>(min_neighbors_));
+  }
+  if (voxel_grid_outlier_filter_) {
+    get_param<float64_t>(p, param_name(kVoxelGridOutlierStage, "voxel_size_x"), voxel_size_x_);
+    get_param<float64_t>(p, param_name(kVoxelGridOutlierStage, "voxel_size_y"), voxel_size_y_);
+    get_param<float64_t>(p, param_name(kVoxelGridOutlierStage, "voxel_size_z"), voxel_size_z_);
+    get_param<std::int64_t>(
+      p, param_name(kVoxelGridOutlierStage, "voxel_points_threshold"), voxel_points_threshold_);
+    voxel_grid_outlier_filter_->update_parameters(
+      static_cast<float32_t>(voxel_size_x_), static_cast<float32_t>(voxel_size_y_),
+      static_cast<float32_t>(voxel_size_z_),
+      static_cast<std::uint32_t>(voxel_points_threshold_));
+  }
+
+  return result;
+}
+
+}  // namespace outlier_filter_nodes
+}  // namespace filters
+}  // namespace perception
+}  // namespace autoware
+
+#include "rclcpp_components/register_node_macro.hpp"
+
+// This acts as an entry point, allowing the component to be
+// discoverable when its library is being loaded into a running process
+RCLCPP_COMPONENTS_REGISTER_NODE(
+  autoware::perception::filters::outlier_filter_nodes::OutlierFilterPipelineNode)
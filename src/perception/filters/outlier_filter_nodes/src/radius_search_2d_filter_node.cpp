@@ -17,7 +17,6 @@
 
 #include "outlier_filter_nodes/radius_search_2d_filter_node.hpp"
 
-#include "pcl_conversions/pcl_conversions.h"
 
 
 namespace autoware
@@ -52,14 +51,8 @@ void RadiusSearch2DFilterNode::filter(
   const sensor_msgs::msg::PointCloud2 & input,
   sensor_msgs::msg::PointCloud2 & output)
 {
-  pcl::PointCloud<pcl::PointXYZ> pcl_input;
-  pcl::PointCloud<pcl::PointXYZ> pcl_output;
-  pcl::fromROSMsg(input, pcl_input);
-
-  // Perform filtering
-  radius_search_2d_filter_->filter(pcl_input, pcl_output);
-
-  pcl::toROSMsg(pcl_output, output);
+  // Perform filtering directly on the message, which also keeps all fields of the points
+  radius_search_2d_filter_->filter(input, output);
 }
 
 rcl_interfaces::msg::SetParametersResult RadiusSearch2DFilterNode::get_node_parameters(
@@ -17,8 +17,6 @@
 
 #include "outlier_filter_nodes/voxel_grid_outlier_filter_node.hpp"
 
-#include "pcl_conversions/pcl_conversions.h"
-
 
 namespace autoware
 {
@@ -55,14 +53,8 @@ VoxelGridOutlierFilterNode::VoxelGridOutlierFilterNode(const rclcpp::NodeOptions
 void VoxelGridOutlierFilterNode::filter(
   const sensor_msgs::msg::PointCloud2 & input, sensor_msgs::msg::PointCloud2 & output)
 {
-  pcl::PointCloud<pcl::PointXYZ> pcl_input;
-  pcl::PointCloud<pcl::PointXYZ> pcl_output;
-  pcl::fromROSMsg(input, pcl_input);
-
-  // Perform filtering
-  voxel_grid_outlier_filter_->filter(pcl_input, pcl_output);
-
-  pcl::toROSMsg(pcl_output, output);
+  // Perform filtering directly on the message, which also keeps all fields of the points
+  voxel_grid_outlier_filter_->filter(input, output);
 }
 
 rcl_interfaces::msg::SetParametersResult VoxelGridOutlierFilterNode::get_node_parameters(
@@ -20,6 +20,7 @@
 #include <point_cloud_filter_transform_nodes/visibility_control.hpp>
 #include <rclcpp/rclcpp.hpp>
 #include <lidar_utils/point_cloud_utils.hpp>
+#include <overload_management/load_monitor.hpp>
 #include <sensor_msgs/msg/point_cloud2.hpp>
 
 #include <memory>
@@ -54,6 +55,8 @@ TransformStamped get_transform(
 
 /// \brief Base class to subscribe to raw point cloud and transform and filter it to publish
 ///        filtered point cloud. Calls angle filter, distance filter and static transformer.
+///        While the perception pipeline is overloaded, the points beyond `overload.max_radius`
+///        are dropped as well, see overload_management::LoadMonitor.
 class POINT_CLOUD_FILTER_TRANSFORM_NODES_PUBLIC PointCloud2FilterTransformNode
   : public rclcpp::Node
 {
@@ -63,15 +66,18 @@ public:
   explicit PointCloud2FilterTransformNode(const rclcpp::NodeOptions & node_options);
 
 protected:
-  /// \brief Call distance & angle filter and then static transformer for all the points
+  /// \brief Call distance & angle filter and then static transformer for all the points. The
+  ///        distance filter of the degraded node has the reduced range
   /// \param msg Raw point cloud
   /// \return Filtered and Transformed point cloud.
   /// \throws std::runtime_error on unexpected input contents or not enough output capacity
   const PointCloud2 & filter_and_transform(const PointCloud2 & msg);
 
-  /// \brief Run main subscribe -> filter & transform -> publish loop
+  /// \brief Run main subscribe -> filter & transform -> publish loop. If intra-process
+  ///        communication is enabled, the output cloud is published as a unique pointer so that
+  ///        intra-process subscribers receive it without a copy.
   void process_filtered_transformed_message(
-    const PointCloud2::SharedPtr msg);
+    const PointCloud2::ConstSharedPtr msg);
 
   template<typename PointType>
   /// \brief Check if the point is within the specified angle and radius limits
@@ -101,6 +107,8 @@ private:
   using StaticTransformer = autoware::common::lidar_utils::StaticTransformer;
   AngleFilter m_angle_filter;
   DistanceFilter m_distance_filter;
+  /// The distance filter while the node is degraded, it drops the far range
+  DistanceFilter m_overload_distance_filter;
   const std::string m_input_frame_id;
   const std::string m_output_frame_id;
   std::unique_ptr<StaticTransformer> m_static_transformer;
@@ -112,6 +120,9 @@ private:
   const size_t m_expected_num_subscribers;
   const std::size_t m_pcl_size;
   PointCloud2 m_filtered_transformed_msg;
+  const bool8_t m_use_intra_process;
+  autoware::common::overload_management::LoadMonitor m_load_monitor;
+  const autoware::common::overload_management::CallbackId m_points_load_id;
 };
 
 }  // namespace point_cloud_filter_transform_nodes
@@ -17,6 +17,7 @@
 #include <common/types.hpp>
 #include <point_cloud_filter_transform_nodes/point_cloud_filter_transform_node.hpp>
 #include <rclcpp_components/register_node_macro.hpp>
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <map>
@@ -31,11 +32,13 @@ namespace filters
 /// \brief Boilerplate Apex.OS nodes around point_cloud_filter_transform_nodes
 namespace point_cloud_filter_transform_nodes
 {
-using autoware::common::lidar_utils::add_point_to_cloud;
+using autoware::common::lidar_utils::filter_and_transform_points;
 using autoware::common::lidar_utils::has_intensity_and_throw_if_no_xyz;
+using autoware::common::lidar_utils::release_pcl_msg;
 using autoware::common::lidar_utils::reset_pcl_msg;
 using autoware::common::lidar_utils::resize_pcl_msg;
 using autoware::common::lidar_utils::sanitize_point_cloud;
+using autoware::common::overload_management::LoadScope;
 using autoware::common::types::float64_t;
 using autoware::common::types::PointXYZIF;
 using geometry_msgs::msg::TransformStamped;
@@ -69,6 +72,13 @@ PointCloud2FilterTransformNode::PointCloud2FilterTransformNode(
   m_distance_filter{
     static_cast<float32_t>(declare_parameter("min_radius").get<float64_t>()),
     static_cast<float32_t>(declare_parameter("max_radius").get<float64_t>())},
+  m_overload_distance_filter{
+    static_cast<float32_t>(get_parameter("min_radius").as_double()),
+    static_cast<float32_t>(declare_parameter(
+      "overload.max_radius",
+      std::max(
+        get_parameter("min_radius").as_double(),
+        0.5 * get_parameter("max_radius").as_double())))},
   m_input_frame_id{declare_parameter("input_frame_id").get<std::string>()},
   m_output_frame_id{declare_parameter("output_frame_id").get<std::string>()},
   m_init_timeout{std::chrono::milliseconds{declare_parameter("init_timeout_ms").get<int32_t>()}},
@@ -82,7 +92,11 @@ PointCloud2FilterTransformNode::PointCloud2FilterTransformNode(
     static_cast<size_t>(declare_parameter("expected_num_publishers").get<int32_t>())},
   m_expected_num_subscribers{
     static_cast<size_t>(declare_parameter("expected_num_subscribers").get<int32_t>())},
-  m_pcl_size{static_cast<size_t>(declare_parameter("pcl_size").get<int32_t>())}
+  m_pcl_size{static_cast<size_t>(declare_parameter("pcl_size").get<int32_t>())},
+  m_use_intra_process{node_options.use_intra_process_comms()},
+  // The far range is the first work the perception pipeline sheds
+  m_load_monitor{*this, 1},
+  m_points_load_id{m_load_monitor.add_callback("points", 20.0)}
 {  /// Declare transform parameters with the namespace
   this->declare_parameter("static_transformer.quaternion.x");
   this->declare_parameter("static_transformer.quaternion.y");
@@ -156,42 +170,18 @@ const PointCloud2 & PointCloud2FilterTransformNode::filter_and_transform(const P
             m_input_frame_id + ", got: " + msg.header.frame_id);
   }
 
-  sensor_msgs::PointCloud2ConstIterator<float32_t> x_it(msg, "x");
-  sensor_msgs::PointCloud2ConstIterator<float32_t> y_it(msg, "y");
-  sensor_msgs::PointCloud2ConstIterator<float32_t> z_it(msg, "z");
-
-  auto && intensity_it = autoware::common::lidar_utils::IntensityIteratorWrapper(msg);
-
   auto point_cloud_idx = 0U;
   reset_pcl_msg(m_filtered_transformed_msg, m_pcl_size, point_cloud_idx);
   m_filtered_transformed_msg.header.stamp = msg.header.stamp;
 
-  for (size_t it = 0; it < (msg.data.size() / 16); it++) {
-    PointXYZIF pt;
-    pt.x = *x_it;
-    pt.y = *y_it;
-    pt.z = *z_it;
-    intensity_it.get_current_value(pt.intensity);
-
-    if (point_not_filtered(pt)) {
-      auto transformed_point = transform_point(pt);
-      transformed_point.intensity = pt.intensity;
-      if (!add_point_to_cloud(
-          m_filtered_transformed_msg, transformed_point, point_cloud_idx))
-      {
-        throw std::runtime_error(
-                "Overran cloud msg point capacity");
-      }
-    }
-
-    ++x_it;
-    ++y_it;
-    ++z_it;
-    intensity_it.next();
-
-    if (intensity_it.eof()) {
-      break;
-    }
+  if (!filter_and_transform_points(
+      msg, m_angle_filter,
+      m_load_monitor.degraded() ? m_overload_distance_filter : m_distance_filter,
+      *m_static_transformer,
+      m_filtered_transformed_msg, point_cloud_idx))
+  {
+    throw std::runtime_error(
+            "Overran cloud msg point capacity");
   }
   resize_pcl_msg(m_filtered_transformed_msg, point_cloud_idx);
   return m_filtered_transformed_msg;
@@ -199,10 +189,15 @@ const PointCloud2 & PointCloud2FilterTransformNode::filter_and_transform(const P
 
 void
 PointCloud2FilterTransformNode::process_filtered_transformed_message(
-  const PointCloud2::SharedPtr msg)
+  const PointCloud2::ConstSharedPtr msg)
 {
-  const auto filtered_transformed_msg = filter_and_transform(*msg);
-  m_pub_ptr->publish(filtered_transformed_msg);
+  const LoadScope load_scope{m_load_monitor, m_points_load_id};
+  const auto & filtered_transformed_msg = filter_and_transform(*msg);
+  if (m_use_intra_process) {
+    m_pub_ptr->publish(release_pcl_msg(m_filtered_transformed_msg, m_pcl_size));
+  } else {
+    m_pub_ptr->publish(filtered_transformed_msg);
+  }
 }
 
 }  // namespace point_cloud_filter_transform_nodes
@@ -0,0 +1,154 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#ifndef POINT_CLOUD_FUSION__DESKEW_HPP_
+#define POINT_CLOUD_FUSION__DESKEW_HPP_
+
+#include <point_cloud_fusion/visibility_control.hpp>
+
+#include <common/types.hpp>
+#include <Eigen/Geometry>
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+namespace autoware
+{
+namespace perception
+{
+namespace filters
+{
+namespace point_cloud_fusion
+{
+using autoware::common::types::bool8_t;
+using autoware::common::types::float32_t;
+
+/// \brief Configuration of the motion compensation of rotating lidar sweeps. A sweep is split
+/// into azimuth blocks, and all points of a block are compensated with the ego motion at the
+/// center time of the block.
+class POINT_CLOUD_FUSION_PUBLIC DeskewConfig
+{
+public:
+  /// \brief constructor
+  /// \param[in] sweep_duration Duration of a sweep. The stamp of a cloud is the start of its
+  /// sweep.
+  /// \param[in] num_blocks Number of azimuth blocks per sweep.
+  /// \param[in] start_azimuth Azimuth in the frame of the input cloud at which a sweep starts.
+  /// \param[in] clockwise True if the sensor rotates clockwise when seen from above, i.e. the
+  /// azimuth decreases over the sweep.
+  /// \param[in] pose_buffer_capacity Number of poses kept to interpolate the ego motion.
+  /// \param[in] max_extrapolation Maximum time after the newest pose that the ego motion is
+  /// extrapolated to. Needed because odometry usually lags behind the end of a sweep.
+  /// \throws std::domain_error if a duration is negative or the number of blocks or the
+  /// capacity is 0.
+  explicit DeskewConfig(
+    std::chrono::nanoseconds sweep_duration = std::chrono::milliseconds{100},
+    std::size_t num_blocks = 36U,
+    float32_t start_azimuth = 0.0F,
+    bool8_t clockwise = true,
+    std::size_t pose_buffer_capacity = 100U,
+    std::chrono::nanoseconds max_extrapolation = std::chrono::milliseconds{100});
+
+  std::chrono::nanoseconds sweep_duration() const noexcept;
+  std::size_t num_blocks() const noexcept;
+  float32_t start_azimuth() const noexcept;
+  bool8_t clockwise() const noexcept;
+  std::size_t pose_buffer_capacity() const noexcept;
+  std::chrono::nanoseconds max_extrapolation() const noexcept;
+
+  /// \brief Get the azimuth block of a point.
+  /// \param[in] x x coordinate of the point in the frame of the input cloud.
+  /// \param[in] y y coordinate of the point in the frame of the input cloud.
+  /// \return Index of the block in [0, num_blocks).
+  std::size_t block(float32_t x, float32_t y) const noexcept;
+
+  /// \brief Get the center time of a block relative to the start of the sweep.
+  std::chrono::nanoseconds block_time(std::size_t block) const noexcept;
+
+private:
+  std::chrono::nanoseconds m_sweep_duration;
+  std::size_t m_num_blocks;
+  float32_t m_start_azimuth;
+  bool8_t m_clockwise;
+  std::size_t m_pose_buffer_capacity;
+  std::chrono::nanoseconds m_max_extrapolation;
+};
+
+/// \brief Ring buffer of stamped ego poses in a fixed frame, e.g. from odometry, that poses
+/// at arbitrary times in between are interpolated from.
+class POINT_CLOUD_FUSION_PUBLIC PoseBuffer
+{
+public:
+  using TransformT = Eigen::Affine3f;
+
+  /// \brief constructor
+  /// \param[in] capacity Number of poses kept.
+  /// \param[in] max_extrapolation Maximum time after the newest pose that poses are extrapolated
+  /// to with the velocity between the two newest poses.
+  /// \throws std::domain_error if the capacity is 0 or the extrapolation time is negative.
+  explicit PoseBuffer(
+    std::size_t capacity,
+    std::chrono::nanoseconds max_extrapolation = std::chrono::nanoseconds::zero());
+
+  /// \brief Add a pose, replacing the oldest one if the buffer is full.
+  /// \param[in] stamp Time of the pose since the epoch.
+  /// \param[in] pose Pose of the ego frame in the fixed frame.
+  /// \return False if the pose is not newer than the newest pose and was ignored.
+  bool8_t insert(std::chrono::nanoseconds stamp, const TransformT & pose);
+
+  /// \brief Interpolate the pose at a time between the oldest and the newest pose, or
+  /// extrapolate it shortly after the newest pose. The translation is interpolated linearly, the
+  /// rotation spherically.
+  /// \param[in] stamp Time since the epoch.
+  /// \param[out] pose Interpolated pose.
+  /// \return False if the time isn't covered by the buffer.
+  bool8_t interpolate(std::chrono::nanoseconds stamp, TransformT & pose) const;
+
+  /// \brief Get the number of poses in the buffer.
+  std::size_t size() const noexcept;
+
+  /// \brief Remove all poses.
+  void clear() noexcept;
+
+private:
+  struct StampedPose
+  {
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    std::chrono::nanoseconds stamp;
+    Eigen::Quaternionf rotation;
+    Eigen::Vector3f translation;
+  };
+
+  /// \brief Interpolate between two poses. Ratios above 1 extrapolate.
+  static void blend(
+    const StampedPose & before, const StampedPose & after,
+    std::chrono::nanoseconds stamp, TransformT & pose) noexcept;
+
+  /// \brief Get the pose with the given age rank, 0 being the oldest.
+  const StampedPose & at(std::size_t idx) const noexcept;
+
+  std::vector<StampedPose, Eigen::aligned_allocator<StampedPose>> m_poses;
+  std::chrono::nanoseconds m_max_extrapolation;
+  std::size_t m_oldest{0U};
+  std::size_t m_size{0U};
+};
+
+}  // namespace point_cloud_fusion
+}  // namespace filters
+}  // namespace perception
+}  // namespace autoware
+
+#endif  // POINT_CLOUD_FUSION__DESKEW_HPP_
@@ -17,10 +17,14 @@
 #ifndef POINT_CLOUD_FUSION__POINT_CLOUD_FUSION_HPP_
 #define POINT_CLOUD_FUSION__POINT_CLOUD_FUSION_HPP_
 
+#include <point_cloud_fusion/deskew.hpp>
 #include <point_cloud_fusion/visibility_control.hpp>
 
 #include <common/types.hpp>
 #include <lidar_utils/point_cloud_utils.hpp>
+#include <Eigen/Geometry>
+#include <array>
+#include <memory>
 #include <vector>
 
 namespace autoware
@@ -41,32 +45,114 @@ public:
     INSERT_FAILED
   };  // enum class Error
   using PointCloudMsgT = sensor_msgs::msg::PointCloud2;
+  using TransformT = Eigen::Affine3f;
+  using Transforms = std::vector<TransformT, Eigen::aligned_allocator<TransformT>>;
 
   /// \brief     constructor
   /// \param[in] cloud_capacity
-  /// \param[in] input_topics_size
+  /// \param[in] input_topics_size Maximum number of messages fused at once.
+  /// \param[in] num_threads Number of threads the clouds are copied with. 1 copies the clouds
+  /// on the calling thread only.
+  /// \throws    std::domain_error if the number of threads is 0.
   explicit PointCloudFusion(
     uint32_t cloud_capacity,
-    size_t input_topics_size);
+    size_t input_topics_size,
+    size_t num_threads = 1U);
 
   /// \brief This function goes through all of the messages and adds them to the concatenated
-  /// point cloud. If a pointcloud cannot be transformed to the output frame, it's ignored. If
-  /// concatenation exceeds the maximum capacity, fusion stops and the partially concatenated cloud
-  /// is still published.
+  /// point cloud. The slice of the concatenated cloud of each message is computed up front, so
+  /// the messages are copied into their slices independently and possibly in parallel. If
+  /// concatenation exceeds the maximum capacity, no points are copied.
+  /// \param[in]  msgs msgs to be fused. They must have float32 x, y, z and intensity fields. Null
+  /// messages are skipped, so a partial set of messages can be fused.
+  /// \param[out] cloud_concatenated fused msgs. It must be initialized with
+  /// `common::lidar_utils::init_pcl_msg` and the cloud capacity.
+  /// \return     Size of the concatenated pointcloud.
+  /// \throws     Error::TOO_LARGE if the clouds exceed the capacity.
+  /// \throws     Error::INSERT_FAILED if the concatenated cloud is too small.
+  /// \throws     std::domain_error if there are more messages than input topics.
+  uint32_t fuse_pc_msgs(
+    const std::vector<PointCloudMsgT::ConstSharedPtr> & msgs,
+    PointCloudMsgT & cloud_concatenated);
+
+  /// \brief Same as `fuse_pc_msgs(msgs, cloud_concatenated)`, but each message is transformed to
+  /// the output frame while it is copied.
   /// \param[in]  msgs msgs to be fused.
+  /// \param[in]  transforms Transforms from the frame of each message to the output frame.
   /// \param[out] cloud_concatenated fused msgs.
   /// \return     Size of the concatenated pointcloud.
+  /// \throws     std::domain_error if there is not one transform per message.
+  uint32_t fuse_pc_msgs(
+    const std::vector<PointCloudMsgT::ConstSharedPtr> & msgs,
+    const Transforms & transforms,
+    PointCloudMsgT & cloud_concatenated);
+
+  /// \brief Fuse the first `input_topics_size` of up to 8 messages. See
+  /// `fuse_pc_msgs(msgs, cloud_concatenated)`.
+  /// \throws     std::domain_error if there are more than 8 input topics.
   uint32_t fuse_pc_msgs(
     const std::array<PointCloudMsgT::ConstSharedPtr, 8> & msgs,
     PointCloudMsgT & cloud_concatenated);
 
+  /// \brief Fuse and transform the first `input_topics_size` of up to 8 messages. See
+  /// `fuse_pc_msgs(msgs, transforms, cloud_concatenated)`.
+  /// \throws     std::domain_error if there are more than 8 input topics.
+  uint32_t fuse_pc_msgs(
+    const std::array<PointCloudMsgT::ConstSharedPtr, 8> & msgs,
+    const std::array<TransformT, 8> & transforms,
+    PointCloudMsgT & cloud_concatenated);
+
+  /// \brief Compensate the ego motion during the sweeps of the fused clouds. Each azimuth block
+  /// of a cloud is transformed from the ego pose at the time of the block to the ego pose at the
+  /// latest stamp of the fused messages, which is the stamp of the fused cloud. The ego poses are
+  /// interpolated from `pose_buffer()` and the compensation is applied while the points are
+  /// copied. Messages whose sweeps aren't covered by the pose buffer are fused uncompensated.
+  /// \param[in] config Configuration of the sweeps.
+  void enable_deskew(const DeskewConfig & config);
+
+  /// \brief Get the buffer of ego poses that the motion compensation is interpolated from.
+  /// \throws std::logic_error if deskewing is not enabled.
+  PoseBuffer & pose_buffer();
+
+  /// \brief Get the number of messages of the last fusion that couldn't be compensated.
+  size_t num_uncompensated_msgs() const noexcept;
+
 private:
-  void concatenate_pointcloud(
-    const PointCloudMsgT & pc_in, PointCloudMsgT & pc_out,
-    uint32_t & concat_idx) const;
+  /// \brief Compute the transform of each azimuth block of each message.
+  void compute_block_transforms(
+    const PointCloudMsgT::ConstSharedPtr * msgs,
+    const TransformT * transforms,
+    size_t num_msgs);
+
+  /// \brief Fuse `num_msgs` messages with one transform each.
+  uint32_t fuse(
+    const PointCloudMsgT::ConstSharedPtr * msgs,
+    const TransformT * transforms,
+    size_t num_msgs,
+    PointCloudMsgT & cloud_concatenated);
+
+  /// \brief Copy the points with the concatenated indices [begin_idx, end_idx). Called by each
+  /// thread with its share of the concatenated cloud.
+  void copy_points(
+    const PointCloudMsgT::ConstSharedPtr * msgs,
+    const TransformT * transforms,
+    size_t num_msgs,
+    PointCloudMsgT & cloud_concatenated,
+    uint32_t begin_idx,
+    uint32_t end_idx) const;
 
   uint32_t m_cloud_capacity;
   size_t m_input_topics_size;
+  size_t m_num_threads;
+  // Index of the first point of each message in the concatenated cloud.
+  std::vector<uint32_t> m_offsets;
+  Transforms m_identity_transforms;
+  // Motion compensation. The pose buffer is only allocated if deskewing is enabled.
+  DeskewConfig m_deskew_config{};
+  std::unique_ptr<PoseBuffer> m_pose_buffer;
+  Transforms m_block_transforms;
+  std::vector<bool8_t> m_compensated;
+  size_t m_num_uncompensated_msgs{0U};
 };
 
 }  // namespace point_cloud_fusion
@@ -0,0 +1,211 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#include <point_cloud_fusion/deskew.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace autoware
+{
+namespace perception
+{
+namespace filters
+{
+namespace point_cloud_fusion
+{
+namespace
+{
+using common::types::float64_t;
+constexpr auto kTwoPi = 6.28318530717958647692F;
+}  // namespace
+
+DeskewConfig::DeskewConfig(
+  const std::chrono::nanoseconds sweep_duration,
+  const std::size_t num_blocks,
+  const float32_t start_azimuth,
+  const bool8_t clockwise,
+  const std::size_t pose_buffer_capacity,
+  const std::chrono::nanoseconds max_extrapolation)
+: m_sweep_duration{sweep_duration},
+  m_num_blocks{num_blocks},
+  m_start_azimuth{start_azimuth},
+  m_clockwise{clockwise},
+  m_pose_buffer_capacity{pose_buffer_capacity},
+  m_max_extrapolation{max_extrapolation}
+{
+  if (m_sweep_duration < std::chrono::nanoseconds::zero()) {
+    throw std::domain_error("DeskewConfig: Sweep duration must not be negative.");
+  }
+  if (m_num_blocks == 0U) {
+    throw std::domain_error("DeskewConfig: Number of blocks must be positive.");
+  }
+  if (m_pose_buffer_capacity == 0U) {
+    throw std::domain_error("DeskewConfig: Pose buffer capacity must be positive.");
+  }
+  if (m_max_extrapolation < std::chrono::nanoseconds::zero()) {
+    throw std::domain_error("DeskewConfig: Extrapolation time must not be negative.");
+  }
+}
+
+std::chrono::nanoseconds DeskewConfig::sweep_duration() const noexcept
+{
+  return m_sweep_duration;
+}
+
+std::size_t DeskewConfig::num_blocks() const noexcept
+{
+  return m_num_blocks;
+}
+
+float32_t DeskewConfig::start_azimuth() const noexcept
+{
+  return m_start_azimuth;
+}
+
+bool8_t DeskewConfig::clockwise() const noexcept
+{
+  return m_clockwise;
+}
+
+std::size_t DeskewConfig::pose_buffer_capacity() const noexcept
+{
+  return m_pose_buffer_capacity;
+}
+
+std::chrono::nanoseconds DeskewConfig::max_extrapolation() const noexcept
+{
+  return m_max_extrapolation;
+}
+
+std::size_t DeskewConfig::block(const float32_t x, const float32_t y) const noexcept
+{
+  const auto azimuth = std::atan2(y, x);
+  auto swept = m_clockwise ? (m_start_azimuth - azimuth) : (azimuth - m_start_azimuth);
+  swept -= kTwoPi * std::floor(swept / kTwoPi);
+  const auto block = static_cast<std::size_t>(
+    std::max((swept / kTwoPi) * static_cast<float32_t>(m_num_blocks), 0.0F));
+  return std::min(block, m_num_blocks - 1U);
+}
+
+std::chrono::nanoseconds DeskewConfig::block_time(const std::size_t block) const noexcept
+{
+  return (m_sweep_duration * static_cast<std::chrono::nanoseconds::rep>((2U * block) + 1U)) /
+         static_cast<std::chrono::nanoseconds::rep>(2U * m_num_blocks);
+}
+
+PoseBuffer::PoseBuffer(
+  const std::size_t capacity,
+  const std::chrono::nanoseconds max_extrapolation)
+: m_poses(capacity),
+  m_max_extrapolation{max_extrapolation}
+{
+  if (capacity == 0U) {
+    throw std::domain_error("PoseBuffer: Capacity must be positive.");
+  }
+  if (m_max_extrapolation < std::chrono::nanoseconds::zero()) {
+    throw std::domain_error("PoseBuffer: Extrapolation time must not be negative.");
+  }
+}
+
+bool8_t PoseBuffer::insert(const std::chrono::nanoseconds stamp, const TransformT & pose)
+{
+  if ((m_size > 0U) && (stamp <= at(m_size - 1U).stamp)) {
+    return false;
+  }
+  StampedPose * slot = nullptr;
+  if (m_size < m_poses.size()) {
+    slot = &m_poses[(m_oldest + m_size) % m_poses.size()];
+    ++m_size;
+  } else {
+    slot = &m_poses[m_oldest];
+    m_oldest = (m_oldest + 1U) % m_poses.size();
+  }
+  slot->stamp = stamp;
+  slot->rotation = Eigen::Quaternionf{pose.rotation()};
+  slot->translation = pose.translation();
+  return true;
+}
+
+bool8_t PoseBuffer::interpolate(const std::chrono::nanoseconds stamp, TransformT & pose) const
+{
+  if ((m_size == 0U) || (stamp < at(0U).stamp) ||
+    (stamp > (at(m_size - 1U).stamp + m_max_extrapolation)))
+  {
+    return false;
+  }
+  if (stamp > at(m_size - 1U).stamp) {
+    // Extrapolate with the velocity between the two newest poses.
+    if (m_size == 1U) {
+      pose = Eigen::Translation3f{at(0U).translation} * at(0U).rotation;
+      return true;
+    }
+    blend(at(m_size - 2U), at(m_size - 1U), stamp, pose);
+    return true;
+  }
+  // Find the first pose that is not older than the stamp.
+  std::size_t first = 0U;
+  std::size_t count = m_size;
+  while (count > 0U) {
+    const auto step = count / 2U;
+    if (at(first + step).stamp < stamp) {
+      first += step + 1U;
+      count -= step + 1U;
+    } else {
+      count = step;
+    }
+  }
+  const auto & after = at(first);
+  if ((first == 0U) || (after.stamp == stamp)) {
+    pose = Eigen::Translation3f{after.translation} * after.rotation;
+    return true;
+  }
+  blend(at(first - 1U), after, stamp, pose);
+  return true;
+}
+
+void PoseBuffer::blend(
+  const StampedPose & before, const StampedPose & after,
+  const std::chrono::nanoseconds stamp, TransformT & pose) noexcept
+{
+  const auto ratio = static_cast<float32_t>(
+    static_cast<float64_t>((stamp - before.stamp).count()) /
+    static_cast<float64_t>((after.stamp - before.stamp).count()));
+  pose = Eigen::Translation3f{before.translation + (ratio * (after.translation -
+      before.translation))} * before.rotation.slerp(ratio, after.rotation);
+}
+
+std::size_t PoseBuffer::size() const noexcept
+{
+  return m_size;
+}
+
+void PoseBuffer::clear() noexcept
+{
+  m_oldest = 0U;
+  m_size = 0U;
+}
+
+const PoseBuffer::StampedPose & PoseBuffer::at(const std::size_t idx) const noexcept
+{
+  return m_poses[(m_oldest + idx) % m_poses.size()];
+}
+
+}  // namespace point_cloud_fusion
+}  // namespace filters
+}  // namespace perception
+}  // namespace autoware
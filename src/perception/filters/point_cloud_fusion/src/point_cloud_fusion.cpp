@@ -16,6 +16,14 @@
 
 #include <point_cloud_fusion/point_cloud_fusion.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
 namespace autoware
 {
 namespace perception
@@ -24,62 +32,332 @@ namespace filters
 {
 namespace point_cloud_fusion
 {
+namespace
+{
+using common::types::bool8_t;
+using common::types::float32_t;
+using PointCloudMsgT = PointCloudFusion::PointCloudMsgT;
+
+/// Byte offsets of the fields of a point that are fused.
+struct PointLayout
+{
+  uint32_t x;
+  uint32_t y;
+  uint32_t z;
+  uint32_t intensity;
+};
+
+uint32_t float32_field_offset(const PointCloudMsgT & msg, const std::string & name)
+{
+  const auto field_it = std::find_if(
+    msg.fields.begin(), msg.fields.end(),
+    [&name](const sensor_msgs::msg::PointField & field) {return field.name == name;});
+  if ((field_it == msg.fields.end()) ||
+    (field_it->datatype != sensor_msgs::msg::PointField::FLOAT32))
+  {
+    throw std::runtime_error("Point cloud has no float32 field " + name + ".");
+  }
+  return field_it->offset;
+}
+
+PointLayout point_layout(const PointCloudMsgT & msg)
+{
+  return PointLayout{float32_field_offset(msg, "x"), float32_field_offset(msg, "y"),
+    float32_field_offset(msg, "z"), float32_field_offset(msg, "intensity")};
+}
+
+/// Check if the points are stored as contiguous x, y, z, intensity float32 values.
+bool8_t is_packed_xyzi(const PointCloudMsgT & msg, const PointLayout & layout)
+{
+  return (msg.point_step == (4U * sizeof(float32_t))) && (layout.x == 0U) &&
+         (layout.y == sizeof(float32_t)) && (layout.z == (2U * sizeof(float32_t))) &&
+         (layout.intensity == (3U * sizeof(float32_t)));
+}
+
+/// Transform and copy `num_points` points to a packed x, y, z, intensity buffer. Points are
+/// processed as columns of a 4xN matrix, so the fixed-size 4x4 product is vectorized over the
+/// four channels of a point. The intensity is passed through.
+void transform_packed_points(
+  const float32_t * const in, float32_t * const out, const Eigen::Index num_points,
+  const PointCloudFusion::TransformT & transform)
+{
+  using PackedPoints = Eigen::Matrix<float32_t, 4, Eigen::Dynamic>;
+  Eigen::Matrix4f kernel{Eigen::Matrix4f::Identity()};
+  kernel.topLeftCorner<3, 3>() = transform.linear();
+  Eigen::Vector4f offset{Eigen::Vector4f::Zero()};
+  offset.head<3>() = transform.translation();
+
+  const Eigen::Map<const PackedPoints> in_points{in, 4, num_points};
+  Eigen::Map<PackedPoints> out_points{out, 4, num_points};
+  out_points.noalias() = kernel * in_points;
+  out_points.colwise() += offset;
+}
+
+float32_t read_float32(const uint8_t * const data)
+{
+  float32_t value;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+void write_point(
+  uint8_t * const data, const PointLayout & layout, const Eigen::Vector3f & point,
+  const float32_t intensity)
+{
+  std::memcpy(data + layout.x, &point[0], sizeof(float32_t));
+  std::memcpy(data + layout.y, &point[1], sizeof(float32_t));
+  std::memcpy(data + layout.z, &point[2], sizeof(float32_t));
+  std::memcpy(data + layout.intensity, &intensity, sizeof(float32_t));
+}
+
+std::chrono::nanoseconds to_duration(const builtin_interfaces::msg::Time & stamp)
+{
+  return std::chrono::seconds(stamp.sec) + std::chrono::nanoseconds(stamp.nanosec);
+}
+}  // namespace
 
 PointCloudFusion::PointCloudFusion(
   uint32_t cloud_capacity,
-  size_t input_topics_size)
+  size_t input_topics_size,
+  size_t num_threads)
 : m_cloud_capacity(cloud_capacity),
-  m_input_topics_size(input_topics_size)
+  m_input_topics_size(input_topics_size),
+  m_num_threads(num_threads),
+  m_offsets(input_topics_size + 1U, 0U),
+  m_identity_transforms(input_topics_size, TransformT::Identity()),
+  m_compensated(input_topics_size, false)
+{
+  if (m_num_threads == 0U) {
+    throw std::domain_error("PointCloudFusion: Number of threads must be positive.");
+  }
+}
+
+void PointCloudFusion::enable_deskew(const DeskewConfig & config)
+{
+  m_deskew_config = config;
+  m_pose_buffer = std::make_unique<PoseBuffer>(
+    config.pose_buffer_capacity(), config.max_extrapolation());
+  m_block_transforms.resize(m_input_topics_size * config.num_blocks());
+}
+
+PoseBuffer & PointCloudFusion::pose_buffer()
+{
+  if (!m_pose_buffer) {
+    throw std::logic_error("PointCloudFusion: Deskewing is not enabled.");
+  }
+  return *m_pose_buffer;
+}
+
+size_t PointCloudFusion::num_uncompensated_msgs() const noexcept
 {
+  return m_num_uncompensated_msgs;
 }
 
 uint32_t PointCloudFusion::fuse_pc_msgs(
-  const std::array<PointCloudMsgT::ConstSharedPtr, 8> & msgs,
+  const std::vector<PointCloudMsgT::ConstSharedPtr> & msgs,
   PointCloudMsgT & cloud_concatenated)
 {
-  uint32_t pc_concat_idx = 0;
+  if (msgs.size() > m_input_topics_size) {
+    throw std::domain_error("PointCloudFusion: More messages than input topics.");
+  }
+  return fuse(msgs.data(), m_identity_transforms.data(), msgs.size(), cloud_concatenated);
+}
 
-  for (size_t i = 0; i < m_input_topics_size; ++i) {
-    concatenate_pointcloud(*msgs[i], cloud_concatenated, pc_concat_idx);
+uint32_t PointCloudFusion::fuse_pc_msgs(
+  const std::vector<PointCloudMsgT::ConstSharedPtr> & msgs,
+  const Transforms & transforms,
+  PointCloudMsgT & cloud_concatenated)
+{
+  if (msgs.size() > m_input_topics_size) {
+    throw std::domain_error("PointCloudFusion: More messages than input topics.");
+  }
+  if (transforms.size() != msgs.size()) {
+    throw std::domain_error("PointCloudFusion: Each message needs exactly one transform.");
   }
-  return pc_concat_idx;
+  return fuse(msgs.data(), transforms.data(), msgs.size(), cloud_concatenated);
 }
 
-void PointCloudFusion::concatenate_pointcloud(
-  const sensor_msgs::msg::PointCloud2 & pc_in,
-  sensor_msgs::msg::PointCloud2 & pc_out,
-  uint32_t & concat_idx) const
+uint32_t PointCloudFusion::fuse_pc_msgs(
+  const std::array<PointCloudMsgT::ConstSharedPtr, 8> & msgs,
+  PointCloudMsgT & cloud_concatenated)
 {
-  if ((pc_in.width + concat_idx) > m_cloud_capacity) {
-    throw Error::TOO_LARGE;
+  if (m_input_topics_size > msgs.size()) {
+    throw std::domain_error("PointCloudFusion: More than 8 input topics need a vector of msgs.");
   }
+  return fuse(msgs.data(), m_identity_transforms.data(), m_input_topics_size, cloud_concatenated);
+}
 
-  sensor_msgs::PointCloud2ConstIterator<float32_t> x_it_in(pc_in, "x");
-  sensor_msgs::PointCloud2ConstIterator<float32_t> y_it_in(pc_in, "y");
-  sensor_msgs::PointCloud2ConstIterator<float32_t> z_it_in(pc_in, "z");
-  sensor_msgs::PointCloud2ConstIterator<float32_t> intensity_it_in(pc_in, "intensity");
+uint32_t PointCloudFusion::fuse_pc_msgs(
+  const std::array<PointCloudMsgT::ConstSharedPtr, 8> & msgs,
+  const std::array<TransformT, 8> & transforms,
+  PointCloudMsgT & cloud_concatenated)
+{
+  if (m_input_topics_size > msgs.size()) {
+    throw std::domain_error("PointCloudFusion: More than 8 input topics need a vector of msgs.");
+  }
+  return fuse(msgs.data(), transforms.data(), m_input_topics_size, cloud_concatenated);
+}
 
-  while (x_it_in != x_it_in.end() &&
-    y_it_in != y_it_in.end() &&
-    z_it_in != z_it_in.end() &&
-    intensity_it_in != intensity_it_in.end())
-  {
-    common::types::PointXYZIF pt;
-    pt.x = *x_it_in;
-    pt.y = *y_it_in;
-    pt.z = *z_it_in;
-    pt.intensity = *intensity_it_in;
-
-    if (common::lidar_utils::add_point_to_cloud(pc_out, pt, concat_idx)) {
-      ++x_it_in;
-      ++y_it_in;
-      ++z_it_in;
-      ++intensity_it_in;
-    } else {
-      // Somehow the point could be inserted to the concatenated cloud. Something regarding
-      // the cloud sizes must be off.
+uint32_t PointCloudFusion::fuse(
+  const PointCloudMsgT::ConstSharedPtr * const msgs,
+  const TransformT * const transforms,
+  const size_t num_msgs,
+  PointCloudMsgT & cloud_concatenated)
+{
+  // Compute the slice of each message in the concatenated cloud. All checks are done up front
+  // so the copies can't fail.
+  m_offsets[0U] = 0U;
+  for (size_t i = 0; i < num_msgs; ++i) {
+    if (!msgs[i]) {
+      m_offsets[i + 1U] = m_offsets[i];
+      continue;
+    }
+    const auto & msg = *msgs[i];
+    const auto num_points = std::size_t{msg.width} * std::size_t{msg.height};
+    if ((num_points + m_offsets[i]) > m_cloud_capacity) {
+      throw Error::TOO_LARGE;
+    }
+    (void) point_layout(msg);
+    if (msg.data.size() < (num_points * msg.point_step)) {
       throw Error::INSERT_FAILED;
     }
+    m_offsets[i + 1U] = m_offsets[i] + static_cast<uint32_t>(num_points);
+  }
+  const auto total_size = m_offsets[num_msgs];
+  (void) point_layout(cloud_concatenated);
+  if (cloud_concatenated.data.size() <
+    (std::size_t{total_size} * std::size_t{cloud_concatenated.point_step}))
+  {
+    // Somehow the points couldn't be inserted to the concatenated cloud. Something regarding
+    // the cloud sizes must be off.
+    throw Error::INSERT_FAILED;
+  }
+  if (m_pose_buffer) {
+    compute_block_transforms(msgs, transforms, num_msgs);
+  }
+
+  // Split the concatenated cloud evenly between the threads, regardless of the message borders.
+  const auto num_threads = std::max(
+    std::min(m_num_threads, static_cast<size_t>(total_size)), size_t{1U});
+  const auto chunk_begin = [total_size, num_threads](const size_t chunk) {
+      return static_cast<uint32_t>((std::size_t{total_size} * chunk) / num_threads);
+    };
+  std::vector<std::thread> workers;
+  workers.reserve(num_threads - 1U);
+  for (size_t chunk = 1U; chunk < num_threads; ++chunk) {
+    workers.emplace_back(
+      [this, msgs, transforms, num_msgs, &cloud_concatenated, &chunk_begin, chunk] {
+        copy_points(msgs, transforms, num_msgs, cloud_concatenated, chunk_begin(chunk),
+        chunk_begin(chunk + 1U));
+      });
+  }
+  copy_points(msgs, transforms, num_msgs, cloud_concatenated, 0U, chunk_begin(1U));
+  for (auto & worker : workers) {
+    worker.join();
+  }
+  return total_size;
+}
+
+void PointCloudFusion::compute_block_transforms(
+  const PointCloudMsgT::ConstSharedPtr * const msgs,
+  const TransformT * const transforms,
+  const size_t num_msgs)
+{
+  // The clouds are compensated to the ego pose at the stamp of the fused cloud.
+  auto reference_stamp = std::chrono::nanoseconds::min();
+  for (size_t i = 0; i < num_msgs; ++i) {
+    if (msgs[i]) {
+      reference_stamp = std::max(reference_stamp, to_duration(msgs[i]->header.stamp));
+    }
+  }
+  TransformT reference_pose;
+  const auto has_reference = m_pose_buffer->interpolate(reference_stamp, reference_pose);
+  const TransformT reference_inverse = has_reference ?
+    reference_pose.inverse(Eigen::Isometry) : TransformT::Identity();
+
+  const auto num_blocks = m_deskew_config.num_blocks();
+  m_num_uncompensated_msgs = 0U;
+  for (size_t i = 0; i < num_msgs; ++i) {
+    m_compensated[i] = false;
+    if (!msgs[i]) {
+      continue;
+    }
+    const auto stamp = to_duration(msgs[i]->header.stamp);
+    auto compensated = has_reference;
+    for (size_t block = 0U; compensated && (block < num_blocks); ++block) {
+      TransformT block_pose;
+      if (!m_pose_buffer->interpolate(stamp + m_deskew_config.block_time(block), block_pose)) {
+        compensated = false;
+        break;
+      }
+      m_block_transforms[(i * num_blocks) + block] = reference_inverse * block_pose *
+        transforms[i];
+    }
+    m_compensated[i] = compensated;
+    if (!compensated) {
+      ++m_num_uncompensated_msgs;
+    }
+  }
+}
+
+void PointCloudFusion::copy_points(
+  const PointCloudMsgT::ConstSharedPtr * const msgs,
+  const TransformT * const transforms,
+  const size_t num_msgs,
+  PointCloudMsgT & cloud_concatenated,
+  const uint32_t begin_idx,
+  const uint32_t end_idx) const
+{
+  const auto out_layout = point_layout(cloud_concatenated);
+  const auto out_packed = is_packed_xyzi(cloud_concatenated, out_layout);
+  for (size_t i = 0; i < num_msgs; ++i) {
+    const auto begin = std::max(begin_idx, m_offsets[i]);
+    const auto end = std::min(end_idx, m_offsets[i + 1U]);
+    if (begin >= end) {
+      continue;
+    }
+    const auto & msg = *msgs[i];
+    const auto & transform = transforms[i];
+    const auto layout = point_layout(msg);
+    const auto * in = &msg.data[std::size_t{begin - m_offsets[i]} * msg.point_step];
+    auto * out = &cloud_concatenated.data[std::size_t{begin} * cloud_concatenated.point_step];
+    const auto num_points = end - begin;
+
+    if (m_pose_buffer && m_compensated[i]) {
+      // Transform each point with the motion compensation of its azimuth block.
+      const auto * const block_transforms =
+        &m_block_transforms[i * m_deskew_config.num_blocks()];
+      for (uint32_t j = 0U; j < num_points; ++j) {
+        const Eigen::Vector3f point{read_float32(in + layout.x), read_float32(in + layout.y),
+          read_float32(in + layout.z)};
+        const auto & block_transform = block_transforms[m_deskew_config.block(point.x(),
+          point.y())];
+        write_point(out, out_layout, block_transform * point, read_float32(in + layout.intensity));
+        in += msg.point_step;
+        out += cloud_concatenated.point_step;
+      }
+      continue;
+    }
+
+    if (out_packed && is_packed_xyzi(msg, layout)) {
+      if (transform.matrix() == Eigen::Matrix4f::Identity()) {
+        std::memcpy(out, in, std::size_t{num_points} * msg.point_step);
+      } else {
+        transform_packed_points(
+          reinterpret_cast<const float32_t *>(in), reinterpret_cast<float32_t *>(out),
+          static_cast<Eigen::Index>(num_points), transform);
+      }
+      continue;
+    }
+
+    // Generic layout: gather each point, transform it and scatter it into the output.
+    for (uint32_t j = 0U; j < num_points; ++j) {
+      const Eigen::Vector3f point{read_float32(in + layout.x), read_float32(in + layout.y),
+        read_float32(in + layout.z)};
+      write_point(out, out_layout, transform * point, read_float32(in + layout.intensity));
+      in += msg.point_step;
+      out += cloud_concatenated.point_step;
+    }
   }
 }
 
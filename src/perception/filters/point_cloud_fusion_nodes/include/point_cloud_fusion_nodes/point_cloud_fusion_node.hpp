@@ -20,13 +20,18 @@
 #include <message_filters/subscriber.h>
 #include <message_filters/sync_policies/approximate_time.h>
 #include <message_filters/synchronizer.h>
+#include <latency_tracing/tracer.hpp>
+#include <nav_msgs/msg/odometry.hpp>
 #include <sensor_msgs/msg/point_cloud2.hpp>
 #include <lidar_utils/point_cloud_utils.hpp>
 #include <tf2_ros/transform_listener.h>
 #include <rclcpp/rclcpp.hpp>
 #include <point_cloud_fusion/point_cloud_fusion.hpp>
+#include <point_cloud_fusion_nodes/stamp_window_synchronizer.hpp>
 #include <point_cloud_fusion_nodes/visibility_control.hpp>
+#include <shared_memory_transport/shared_memory_transport.hpp>
 #include <common/types.hpp>
+#include <chrono>
 #include <string>
 #include <memory>
 #include <vector>
@@ -42,7 +47,9 @@ namespace filters
 namespace point_cloud_fusion_nodes
 {
 /// \brief Class that fuses multiple point clouds from different sources into one by concatanating
-/// them.
+/// them. The clouds are either synchronized by a `message_filters::Synchronizer` with the
+/// `ApproximateTime` policy, which supports up to 8 sources, or by a `StampWindowSynchronizer`,
+/// which supports any number of sources.
 class POINT_CLOUD_FUSION_NODES_PUBLIC PointCloudFusionNode : public rclcpp::Node
 {
 public:
@@ -61,6 +68,13 @@ private:
 
   void init();
 
+  /// \brief Subscribe to the inputs through a `message_filters::Synchronizer`.
+  void init_approximate_time();
+
+  /// \brief Subscribe to each input directly and synchronize them with a
+  /// `StampWindowSynchronizer`.
+  void init_stamp_window(std::chrono::nanoseconds stamp_window, std::chrono::nanoseconds timeout);
+
   std::chrono::nanoseconds convert_msg_time(builtin_interfaces::msg::Time stamp);
 
   void pointcloud_callback(
@@ -69,15 +83,40 @@ private:
     const PointCloudMsgT::ConstSharedPtr & msg5, const PointCloudMsgT::ConstSharedPtr & msg6,
     const PointCloudMsgT::ConstSharedPtr & msg7, const PointCloudMsgT::ConstSharedPtr & msg8);
 
+  /// \brief Insert a message into its slot and fuse the set once it is complete.
+  void latest_cloud_callback(std::size_t input_idx, const PointCloudMsgT::ConstSharedPtr & msg);
+
+  /// \brief Fuse the partial set of messages once its deadline expired.
+  void deadline_callback();
+
+  /// \brief Fuse the messages in `m_msgs` and publish the result. Null messages are skipped.
+  void fuse_and_publish();
+
+  /// \brief Add the ego pose of an odometry message to the motion compensation.
+  void odometry_callback(const nav_msgs::msg::Odometry::ConstSharedPtr & msg);
+
   std::unique_ptr<point_cloud_fusion::PointCloudFusion> m_core;
   PointCloudT m_cloud_concatenated;
   std::unique_ptr<message_filters::Subscriber<PointCloudMsgT>> m_cloud_subscribers[8];
   std::unique_ptr<message_filters::Synchronizer<SyncPolicyT>> m_cloud_synchronizer;
+  std::vector<rclcpp::Subscription<PointCloudMsgT>::SharedPtr> m_latest_cloud_subscriptions;
+  std::unique_ptr<StampWindowSynchronizer> m_stamp_window_synchronizer;
+  rclcpp::TimerBase::SharedPtr m_deadline_timer;
+  rclcpp::Subscription<nav_msgs::msg::Odometry>::SharedPtr m_odometry_subscription;
   rclcpp::Publisher<PointCloudMsgT>::SharedPtr m_cloud_publisher;
+  // Publishes the fused clouds through shared memory, if enabled.
+  std::unique_ptr<common::shared_memory_transport::SharedMemoryPublisher<PointCloudMsgT>>
+  m_shared_memory_publisher;
+  // Messages of the set that is fused.
+  std::vector<PointCloudMsgT::ConstSharedPtr> m_msgs;
 
   std::vector<std::string> m_input_topics;
   std::string m_output_frame_id;
   uint32_t m_cloud_capacity;
+  std::size_t m_num_threads;
+  std::string m_synchronization_mode;
+  // The stage of the node in the latency traces of the clouds.
+  autoware::common::latency_tracing::StageId m_trace_stage;
 };
 }  // namespace point_cloud_fusion_nodes
 }  // namespace filters
@@ -0,0 +1,101 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#ifndef POINT_CLOUD_FUSION_NODES__STAMP_WINDOW_SYNCHRONIZER_HPP_
+#define POINT_CLOUD_FUSION_NODES__STAMP_WINDOW_SYNCHRONIZER_HPP_
+
+#include <common/types.hpp>
+#include <point_cloud_fusion_nodes/visibility_control.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+namespace autoware
+{
+namespace perception
+{
+namespace filters
+{
+namespace point_cloud_fusion_nodes
+{
+using autoware::common::types::bool8_t;
+
+/// \brief Synchronizes point clouds from any number of inputs by keeping only the latest message
+/// of each input in a slot. A set is complete as soon as every input has a message and all
+/// stamps lie within the stamp window. Messages that are older than the window relative to the
+/// newest pending message can't be part of a complete set anymore and are dropped. The deadline
+/// of a set starts with its first message, so a set with missing inputs can be taken once it
+/// expired. Inserting doesn't allocate. This class is not thread safe.
+class POINT_CLOUD_FUSION_NODES_PUBLIC StampWindowSynchronizer
+{
+public:
+  using MsgT = sensor_msgs::msg::PointCloud2;
+  using Clock = std::chrono::steady_clock;
+
+  /// \brief constructor
+  /// \param[in] num_inputs Number of inputs.
+  /// \param[in] stamp_window Maximum difference between the stamps of a complete set.
+  /// \param[in] timeout Time after the first message of a set after which the set expires.
+  /// \throws std::domain_error if there are no inputs, the window is negative or the timeout is
+  /// not positive.
+  StampWindowSynchronizer(
+    std::size_t num_inputs,
+    std::chrono::nanoseconds stamp_window,
+    std::chrono::nanoseconds timeout);
+
+  /// \brief Insert a message, replacing the pending message of its input.
+  /// \param[in] input Index of the input.
+  /// \param[in] msg Message.
+  /// \param[in] now Arrival time of the message.
+  /// \return True if the pending set is complete.
+  /// \throws std::out_of_range if the input doesn't exist.
+  /// \throws std::domain_error if the message is null.
+  bool8_t insert(std::size_t input, const MsgT::ConstSharedPtr & msg, Clock::time_point now);
+
+  /// \brief Check if the deadline of a pending set expired.
+  /// \param[in] now Current time.
+  bool8_t expired(Clock::time_point now) const noexcept;
+
+  /// \brief Move the pending messages out and start a new set.
+  /// \param[out] msgs Messages, indexed by their input. Inputs without a message are null.
+  /// \return Number of messages that were pending.
+  std::size_t take(std::vector<MsgT::ConstSharedPtr> & msgs);
+
+  /// \brief Check if no message is pending.
+  bool8_t empty() const noexcept;
+
+  /// \brief Get the deadline of the pending set. Only meaningful if a message is pending.
+  Clock::time_point deadline() const noexcept;
+
+  /// \brief Get the number of inputs.
+  std::size_t num_inputs() const noexcept;
+
+private:
+  std::vector<MsgT::ConstSharedPtr> m_slots;
+  std::vector<std::chrono::nanoseconds> m_stamps;
+  std::size_t m_num_pending{0U};
+  std::chrono::nanoseconds m_stamp_window;
+  std::chrono::nanoseconds m_timeout;
+  Clock::time_point m_deadline{};
+};
+}  // namespace point_cloud_fusion_nodes
+}  // namespace filters
+}  // namespace perception
+}  // namespace autoware
+
+#endif  // POINT_CLOUD_FUSION_NODES__STAMP_WINDOW_SYNCHRONIZER_HPP_
@@ -20,6 +20,8 @@
 #include <tf2_sensor_msgs/tf2_sensor_msgs.h>
 
 #include <algorithm>
+#include <array>
+#include <chrono>
 #include <memory>
 #include <string>
 #include <vector>
@@ -42,7 +44,11 @@ PointCloudFusionNode::PointCloudFusionNode(
   m_cloud_publisher(create_publisher<PointCloudMsgT>("output_topic", rclcpp::QoS(10))),
   m_input_topics(static_cast<std::size_t>(declare_parameter("number_of_sources").get<int>())),
   m_output_frame_id(declare_parameter("output_frame_id").get<std::string>()),
-  m_cloud_capacity(static_cast<uint32_t>(declare_parameter("cloud_size").get<int>()))
+  m_cloud_capacity(static_cast<uint32_t>(declare_parameter("cloud_size").get<int>())),
+  m_num_threads(static_cast<std::size_t>(declare_parameter("number_of_threads", 1))),
+  m_synchronization_mode(declare_parameter("synchronization.mode", "approximate_time")),
+  m_trace_stage(common::latency_tracing::Tracer::instance().register_stage(
+      get_fully_qualified_name()))
 {
   for (size_t i = 0; i < m_input_topics.size(); ++i) {
     m_input_topics[i] = "input_topic" + std::to_string(i + 1);
@@ -54,12 +60,53 @@ void PointCloudFusionNode::init()
 {
   m_core = std::make_unique<point_cloud_fusion::PointCloudFusion>(
     m_cloud_capacity,
-    m_input_topics.size());
+    m_input_topics.size(),
+    m_num_threads);
 
   common::lidar_utils::init_pcl_msg(
     m_cloud_concatenated, m_output_frame_id,
     m_cloud_capacity);
 
+  m_msgs.resize(m_input_topics.size(), nullptr);
+
+  if (declare_parameter("deskew.enabled", false)) {
+    m_core->enable_deskew(
+      point_cloud_fusion::DeskewConfig{
+        std::chrono::milliseconds{declare_parameter("deskew.sweep_duration_ms", 100)},
+        static_cast<std::size_t>(declare_parameter("deskew.num_blocks", 36)),
+        static_cast<float32_t>(declare_parameter("deskew.start_azimuth", 0.0)),
+        declare_parameter("deskew.clockwise", true),
+        static_cast<std::size_t>(declare_parameter("deskew.pose_buffer_size", 100)),
+        std::chrono::milliseconds{declare_parameter("deskew.max_extrapolation_ms", 100)}});
+    m_odometry_subscription = create_subscription<nav_msgs::msg::Odometry>(
+      "odometry", rclcpp::QoS(10),
+      [this](const nav_msgs::msg::Odometry::ConstSharedPtr msg) {odometry_callback(msg);});
+  }
+
+  if (declare_parameter("shared_memory.enabled", false)) {
+    m_shared_memory_publisher = std::make_unique<
+      common::shared_memory_transport::SharedMemoryPublisher<PointCloudMsgT>>(
+      *this, "output_topic_shared_memory", rclcpp::QoS(10),
+      static_cast<std::size_t>(declare_parameter("shared_memory.slot_count", 4)),
+      static_cast<std::size_t>(m_cloud_concatenated.point_step) * m_cloud_capacity);
+  }
+
+  if (m_synchronization_mode == "approximate_time") {
+    init_approximate_time();
+  } else if (m_synchronization_mode == "stamp_window") {
+    const auto stamp_window_ms = declare_parameter("synchronization.stamp_window_ms", 50);
+    const auto timeout_ms = declare_parameter("synchronization.timeout_ms", 100);
+    init_stamp_window(std::chrono::milliseconds{stamp_window_ms},
+      std::chrono::milliseconds{timeout_ms});
+  } else {
+    throw std::domain_error(
+            "Unknown synchronization mode: " + m_synchronization_mode +
+            ". Must be approximate_time or stamp_window.");
+  }
+}
+
+void PointCloudFusionNode::init_approximate_time()
+{
   if (m_input_topics.size() > 8 || m_input_topics.size() < 2) {
     throw std::domain_error(
             "Number of sources for point cloud fusion must be between 2 and 8."
@@ -87,6 +134,32 @@ void PointCloudFusionNode::init()
       std::placeholders::_6, std::placeholders::_7, std::placeholders::_8));
 }
 
+void PointCloudFusionNode::init_stamp_window(
+  const std::chrono::nanoseconds stamp_window,
+  const std::chrono::nanoseconds timeout)
+{
+  if (m_input_topics.size() < 2) {
+    throw std::domain_error(
+            "Number of sources for point cloud fusion must be at least 2."
+            " Found: " + std::to_string(m_input_topics.size()));
+  }
+
+  m_stamp_window_synchronizer = std::make_unique<StampWindowSynchronizer>(
+    m_input_topics.size(), stamp_window, timeout);
+
+  // The timer is armed by the first message of each set, so it fires at the deadline of the set.
+  m_deadline_timer = create_wall_timer(timeout, [this] {deadline_callback();});
+  m_deadline_timer->cancel();
+
+  m_latest_cloud_subscriptions.reserve(m_input_topics.size());
+  for (size_t i = 0; i < m_input_topics.size(); ++i) {
+    m_latest_cloud_subscriptions.push_back(
+      create_subscription<PointCloudMsgT>(
+        m_input_topics[i], rclcpp::QoS(10),
+        [this, i](const PointCloudMsgT::ConstSharedPtr msg) {latest_cloud_callback(i, msg);}));
+  }
+}
+
 std::chrono::nanoseconds PointCloudFusionNode::convert_msg_time(builtin_interfaces::msg::Time stamp)
 {
   return std::chrono::seconds(stamp.sec) + std::chrono::nanoseconds(stamp.nanosec);
@@ -99,25 +172,71 @@ PointCloudFusionNode::pointcloud_callback(
   const PointCloudMsgT::ConstSharedPtr & msg5, const PointCloudMsgT::ConstSharedPtr & msg6,
   const PointCloudMsgT::ConstSharedPtr & msg7, const PointCloudMsgT::ConstSharedPtr & msg8)
 {
-  std::array<PointCloudMsgT::ConstSharedPtr, 8> msgs{msg1, msg2, msg3, msg4, msg5, msg6, msg7,
-    msg8};
+  const std::array<PointCloudMsgT::ConstSharedPtr, 8> msgs{msg1, msg2, msg3, msg4, msg5, msg6,
+    msg7, msg8};
+  std::copy_n(msgs.begin(), m_msgs.size(), m_msgs.begin());
+  fuse_and_publish();
+}
+
+void PointCloudFusionNode::latest_cloud_callback(
+  const std::size_t input_idx,
+  const PointCloudMsgT::ConstSharedPtr & msg)
+{
+  const auto was_empty = m_stamp_window_synchronizer->empty();
+  if (m_stamp_window_synchronizer->insert(input_idx, msg, StampWindowSynchronizer::Clock::now())) {
+    m_deadline_timer->cancel();
+    (void) m_stamp_window_synchronizer->take(m_msgs);
+    fuse_and_publish();
+  } else if (was_empty) {
+    // A new set was started.
+    m_deadline_timer->reset();
+  }
+}
+
+void PointCloudFusionNode::deadline_callback()
+{
+  if (!m_stamp_window_synchronizer->expired(StampWindowSynchronizer::Clock::now())) {
+    return;
+  }
+  m_deadline_timer->cancel();
+  const auto num_msgs = m_stamp_window_synchronizer->take(m_msgs);
+  RCLCPP_WARN_THROTTLE(
+    get_logger(), *get_clock(), 1000,
+    "Only %zu of %zu pointclouds arrived before the deadline. Fusing the partial set.",
+    num_msgs, m_msgs.size());
+  fuse_and_publish();
+}
 
+void PointCloudFusionNode::fuse_and_publish()
+{
+  common::latency_tracing::TraceScope trace{common::latency_tracing::Tracer::instance(),
+    m_trace_stage};
   uint32_t pc_concat_idx = 0;
   // reset pointcloud before using
   common::lidar_utils::reset_pcl_msg(
     m_cloud_concatenated, m_cloud_capacity,
     pc_concat_idx);
 
-  auto latest_stamp = msgs[0]->header.stamp;
+  builtin_interfaces::msg::Time latest_stamp{};
   auto total_size = 0U;
 
   // Get the latest time stamp of the point clouds and find the total size after concatenation
-  for (uint32_t msg_idx = 0; msg_idx < m_input_topics.size(); ++msg_idx) {
-    const auto & stamp = msgs[msg_idx]->header.stamp;
+  for (const auto & msg : m_msgs) {
+    if (!msg) {
+      continue;
+    }
+    const auto & stamp = msg->header.stamp;
     if (convert_msg_time(stamp) > convert_msg_time(latest_stamp)) {
       latest_stamp = stamp;
     }
-    total_size += msgs[msg_idx]->width;
+    total_size += msg->width;
+  }
+  // The fused cloud continues the traces of all inputs under the latest stamp.
+  trace.set_trace_id(common::latency_tracing::to_trace_id(latest_stamp));
+  for (const auto & msg : m_msgs) {
+    if (msg) {
+      trace.link(common::latency_tracing::to_trace_id(msg->header.stamp));
+    }
   }
 
   if (total_size > m_cloud_capacity) {
@@ -129,7 +248,7 @@ PointCloudFusionNode::pointcloud_callback(
   // Go through all the messages and fuse them.
   uint32_t fused_cloud_size = 0;
   try {
-    fused_cloud_size = m_core->fuse_pc_msgs(msgs, m_cloud_concatenated);
+    fused_cloud_size = m_core->fuse_pc_msgs(m_msgs, m_cloud_concatenated);
   } catch (point_cloud_fusion::PointCloudFusion::Error fuse_error) {
     if (fuse_error == point_cloud_fusion::PointCloudFusion::Error::TOO_LARGE) {
       RCLCPP_WARN(get_logger(), "Pointcloud is too large to be fused and will be ignored.");
@@ -139,13 +258,47 @@ PointCloudFusionNode::pointcloud_callback(
       RCLCPP_ERROR(get_logger(), "Unknown error.");
     }
   }
+  if (m_core->num_uncompensated_msgs() > 0U) {
+    RCLCPP_WARN_THROTTLE(
+      get_logger(), *get_clock(), 1000,
+      "No odometry covers the sweeps of %zu pointclouds. They are fused without motion "
+      "compensation.", m_core->num_uncompensated_msgs());
+  }
+  // Don't keep the inputs alive until the next set.
+  std::fill(m_msgs.begin(), m_msgs.end(), nullptr);
 
   if (fused_cloud_size > 0) {
     // Resize and publish.
     common::lidar_utils::resize_pcl_msg(m_cloud_concatenated, fused_cloud_size);
 
     m_cloud_concatenated.header.stamp = latest_stamp;
-    m_cloud_publisher->publish(m_cloud_concatenated);
+    if (!m_shared_memory_publisher) {
+      m_cloud_publisher->publish(m_cloud_concatenated);
+    } else {
+      // Subscribers in other processes read the cloud from shared memory. The regular topic is
+      // only serialized for the subscribers that still use it.
+      if (!m_shared_memory_publisher->publish(m_cloud_concatenated)) {
+        RCLCPP_WARN_THROTTLE(
+          get_logger(), *get_clock(), 1000,
+          "All shared memory slots are still read, the fused cloud is not published on "
+          "output_topic_shared_memory.");
+      }
+      if (m_cloud_publisher->get_subscription_count() > 0U) {
+        m_cloud_publisher->publish(m_cloud_concatenated);
+      }
+    }
+  }
+}
+void PointCloudFusionNode::odometry_callback(const nav_msgs::msg::Odometry::ConstSharedPtr & msg)
+{
+  const auto & position = msg->pose.pose.position;
+  const auto & orientation = msg->pose.pose.orientation;
+  const Eigen::Affine3d pose = Eigen::Translation3d{position.x, position.y, position.z} *
+    Eigen::Quaterniond{orientation.w, orientation.x, orientation.y, orientation.z};
+  const auto stamp = convert_msg_time(msg->header.stamp);
+  if (!m_core->pose_buffer().insert(stamp, pose.cast<float32_t>())) {
+    RCLCPP_WARN_THROTTLE(
+      get_logger(), *get_clock(), 1000, "Ignoring odometry that is not newer than the last one.");
   }
 }
 }  // namespace point_cloud_fusion_nodes
@@ -0,0 +1,132 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#include <point_cloud_fusion_nodes/stamp_window_synchronizer.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace autoware
+{
+namespace perception
+{
+namespace filters
+{
+namespace point_cloud_fusion_nodes
+{
+namespace
+{
+std::chrono::nanoseconds to_duration(const builtin_interfaces::msg::Time & stamp)
+{
+  return std::chrono::seconds(stamp.sec) + std::chrono::nanoseconds(stamp.nanosec);
+}
+}  // namespace
+
+StampWindowSynchronizer::StampWindowSynchronizer(
+  const std::size_t num_inputs,
+  const std::chrono::nanoseconds stamp_window,
+  const std::chrono::nanoseconds timeout)
+: m_slots(num_inputs, nullptr),
+  m_stamps(num_inputs, std::chrono::nanoseconds::zero()),
+  m_stamp_window{stamp_window},
+  m_timeout{timeout}
+{
+  if (num_inputs == 0U) {
+    throw std::domain_error("StampWindowSynchronizer: Number of inputs must be positive.");
+  }
+  if (m_stamp_window < std::chrono::nanoseconds::zero()) {
+    throw std::domain_error("StampWindowSynchronizer: Stamp window must not be negative.");
+  }
+  if (m_timeout <= std::chrono::nanoseconds::zero()) {
+    throw std::domain_error("StampWindowSynchronizer: Timeout must be positive.");
+  }
+}
+
+bool8_t StampWindowSynchronizer::insert(
+  const std::size_t input,
+  const MsgT::ConstSharedPtr & msg,
+  const Clock::time_point now)
+{
+  if (input >= m_slots.size()) {
+    throw std::out_of_range(
+            "StampWindowSynchronizer: Input " + std::to_string(input) + " doesn't exist.");
+  }
+  if (!msg) {
+    throw std::domain_error("StampWindowSynchronizer: Message must not be null.");
+  }
+  if (m_num_pending == 0U) {
+    m_deadline = now + m_timeout;
+  }
+  if (!m_slots[input]) {
+    ++m_num_pending;
+  }
+  m_slots[input] = msg;
+  m_stamps[input] = to_duration(msg->header.stamp);
+
+  auto newest = m_stamps[input];
+  for (std::size_t i = 0U; i < m_slots.size(); ++i) {
+    if (m_slots[i]) {
+      newest = std::max(newest, m_stamps[i]);
+    }
+  }
+  // Drop the messages that can't be in a set with the newest one anymore.
+  for (std::size_t i = 0U; i < m_slots.size(); ++i) {
+    if (m_slots[i] && ((newest - m_stamps[i]) > m_stamp_window)) {
+      m_slots[i] = nullptr;
+      --m_num_pending;
+    }
+  }
+  return m_num_pending == m_slots.size();
+}
+
+bool8_t StampWindowSynchronizer::expired(const Clock::time_point now) const noexcept
+{
+  return (m_num_pending > 0U) && (now >= m_deadline);
+}
+
+std::size_t StampWindowSynchronizer::take(std::vector<MsgT::ConstSharedPtr> & msgs)
+{
+  msgs.resize(m_slots.size());
+  for (std::size_t i = 0U; i < m_slots.size(); ++i) {
+    msgs[i] = std::move(m_slots[i]);
+    m_slots[i] = nullptr;
+  }
+  const auto num_taken = m_num_pending;
+  m_num_pending = 0U;
+  return num_taken;
+}
+
+bool8_t StampWindowSynchronizer::empty() const noexcept
+{
+  return m_num_pending == 0U;
+}
+
+StampWindowSynchronizer::Clock::time_point StampWindowSynchronizer::deadline() const noexcept
+{
+  return m_deadline;
+}
+
+std::size_t StampWindowSynchronizer::num_inputs() const noexcept
+{
+  return m_slots.size();
+}
+}  // namespace point_cloud_fusion_nodes
+}  // namespace filters
+}  // namespace perception
+}  // namespace autoware
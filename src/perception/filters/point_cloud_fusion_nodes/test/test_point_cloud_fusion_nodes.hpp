@@ -22,12 +22,16 @@
 #include <point_cloud_fusion_nodes/point_cloud_fusion_node.hpp>
 #include <sensor_msgs/point_cloud2_iterator.hpp>
 #include <common/types.hpp>
+#include <array>
+#include <cmath>
+#include <cstring>
 #include <memory>
 #include <string>
 #include <vector>
 
 using autoware::common::types::bool8_t;
 using autoware::common::types::float32_t;
+using autoware::perception::filters::point_cloud_fusion::PoseBuffer;
 
 class TestPCF : public ::testing::Test
 {
@@ -201,4 +205,208 @@ TEST_F(TestPCF, test_basic_fusion) {
   EXPECT_TRUE(test_completed);
 }
 
+TEST(TestPCFCore, parallel_transformed_fusion) {
+  using autoware::perception::filters::point_cloud_fusion::PointCloudFusion;
+  const auto stamp = to_msg_time(std::chrono::system_clock::now());
+  std::array<sensor_msgs::msg::PointCloud2::ConstSharedPtr, 8> msgs{
+    std::make_shared<sensor_msgs::msg::PointCloud2>(make_pc({1, 2, 3}, stamp)),
+    std::make_shared<sensor_msgs::msg::PointCloud2>(make_pc({4, 5}, stamp))};
+  std::array<PointCloudFusion::TransformT, 8> transforms;
+  transforms.fill(PointCloudFusion::TransformT::Identity());
+  transforms[1U] = Eigen::Translation3f{10.0F, 0.0F, 0.0F} *
+    Eigen::AngleAxisf{static_cast<float32_t>(M_PI_2), Eigen::Vector3f::UnitZ()};
+
+  for (const auto num_threads : {1U, 2U, 4U}) {
+    PointCloudFusion fusion{100U, 2U, num_threads};
+    sensor_msgs::msg::PointCloud2 fused;
+    autoware::common::lidar_utils::init_pcl_msg(fused, "base_link", 100U);
+    ASSERT_EQ(fusion.fuse_pc_msgs(msgs, transforms, fused), 5U);
+    autoware::common::lidar_utils::resize_pcl_msg(fused, 5U);
+
+    // The second cloud is rotated by 90 degrees around z and translated by 10 along x.
+    const std::vector<std::array<float32_t, 4>> expected{
+      {1.0F, 1.0F, 1.0F, 1.0F}, {2.0F, 2.0F, 2.0F, 2.0F}, {3.0F, 3.0F, 3.0F, 3.0F},
+      {6.0F, 4.0F, 4.0F, 4.0F}, {5.0F, 5.0F, 5.0F, 5.0F}};
+    sensor_msgs::PointCloud2ConstIterator<float32_t> x_it(fused, "x");
+    sensor_msgs::PointCloud2ConstIterator<float32_t> y_it(fused, "y");
+    sensor_msgs::PointCloud2ConstIterator<float32_t> z_it(fused, "z");
+    sensor_msgs::PointCloud2ConstIterator<float32_t> intensity_it(fused, "intensity");
+    for (const auto & point : expected) {
+      EXPECT_NEAR(*x_it, point[0U], 1e-5F);
+      EXPECT_NEAR(*y_it, point[1U], 1e-5F);
+      EXPECT_FLOAT_EQ(*z_it, point[2U]);
+      EXPECT_FLOAT_EQ(*intensity_it, point[3U]);
+      ++x_it;
+      ++y_it;
+      ++z_it;
+      ++intensity_it;
+    }
+
+    PointCloudFusion small_fusion{4U, 2U, num_threads};
+    EXPECT_THROW(small_fusion.fuse_pc_msgs(msgs, fused), PointCloudFusion::Error);
+  }
+  EXPECT_THROW(PointCloudFusion(100U, 2U, 0U), std::domain_error);
+}
+
+TEST(TestPCFCore, dynamic_partial_fusion) {
+  using autoware::perception::filters::point_cloud_fusion::PointCloudFusion;
+  const auto stamp = to_msg_time(std::chrono::system_clock::now());
+  // More than 8 inputs, some of them missing.
+  std::vector<sensor_msgs::msg::PointCloud2::ConstSharedPtr> msgs(10U, nullptr);
+  uint32_t expected_size = 0U;
+  for (auto i = 0U; i < msgs.size(); i += 3U) {
+    msgs[i] = std::make_shared<sensor_msgs::msg::PointCloud2>(
+      make_pc({static_cast<int32_t>(i), static_cast<int32_t>(i)}, stamp));
+    expected_size += 2U;
+  }
+
+  PointCloudFusion fusion{100U, msgs.size(), 2U};
+  sensor_msgs::msg::PointCloud2 fused;
+  autoware::common::lidar_utils::init_pcl_msg(fused, "base_link", 100U);
+  ASSERT_EQ(fusion.fuse_pc_msgs(msgs, fused), expected_size);
+  sensor_msgs::PointCloud2ConstIterator<float32_t> x_it(fused, "x");
+  for (auto i = 0U; i < msgs.size(); i += 3U) {
+    EXPECT_FLOAT_EQ(*x_it, static_cast<float32_t>(i));
+    ++x_it;
+    EXPECT_FLOAT_EQ(*x_it, static_cast<float32_t>(i));
+    ++x_it;
+  }
+
+  const PointCloudFusion::Transforms transforms(msgs.size() - 1U);
+  EXPECT_THROW(fusion.fuse_pc_msgs(msgs, transforms, fused), std::domain_error);
+  PointCloudFusion small_fusion{100U, msgs.size() - 1U};
+  EXPECT_THROW(small_fusion.fuse_pc_msgs(msgs, fused), std::domain_error);
+  const std::array<sensor_msgs::msg::PointCloud2::ConstSharedPtr, 8> array_msgs{};
+  EXPECT_THROW(small_fusion.fuse_pc_msgs(array_msgs, fused), std::domain_error);
+}
+
+TEST(TestPCFCore, pose_buffer) {
+  using std::chrono::milliseconds;
+  PoseBuffer buffer{3U, milliseconds{50}};
+  PoseBuffer::TransformT pose;
+  EXPECT_FALSE(buffer.interpolate(milliseconds{0}, pose));
+
+  // The ego frame moves by 1 m along x and turns by 0.1 rad every 100 ms.
+  const auto make_pose = [](const float32_t step) -> PoseBuffer::TransformT {
+      return Eigen::Translation3f{step, 0.0F, 0.0F} *
+             Eigen::AngleAxisf{0.1F * step, Eigen::Vector3f::UnitZ()};
+    };
+  for (auto step = 0; step < 4; ++step) {
+    EXPECT_TRUE(buffer.insert(milliseconds{100 * step}, make_pose(static_cast<float32_t>(step))));
+  }
+  EXPECT_FALSE(buffer.insert(milliseconds{300}, make_pose(3.0F)));
+  EXPECT_EQ(buffer.size(), 3U);
+
+  // The oldest pose was replaced.
+  EXPECT_FALSE(buffer.interpolate(milliseconds{50}, pose));
+  const std::vector<std::pair<int32_t, float32_t>> expected{
+    {100, 1.0F}, {150, 1.5F}, {275, 2.75F}, {300, 3.0F}, {350, 3.5F}};
+  for (const auto & stamp_step : expected) {
+    ASSERT_TRUE(buffer.interpolate(milliseconds{stamp_step.first}, pose));
+    EXPECT_TRUE(pose.isApprox(make_pose(stamp_step.second), 1e-5F));
+  }
+  EXPECT_FALSE(buffer.interpolate(milliseconds{351}, pose));
+
+  buffer.clear();
+  EXPECT_EQ(buffer.size(), 0U);
+  EXPECT_THROW(PoseBuffer(0U), std::domain_error);
+}
+
+TEST(TestPCFCore, deskewed_fusion) {
+  using autoware::perception::filters::point_cloud_fusion::DeskewConfig;
+  using autoware::perception::filters::point_cloud_fusion::PointCloudFusion;
+  using std::chrono::milliseconds;
+  // Four blocks of 25 ms, counterclockwise from the x axis.
+  const DeskewConfig config{milliseconds{100}, 4U, 0.0F, false, 10U, milliseconds{0}};
+  EXPECT_EQ(config.block(1.0F, 0.1F), 0U);
+  EXPECT_EQ(config.block(-1.0F, 0.1F), 1U);
+  EXPECT_EQ(config.block(-1.0F, -0.1F), 2U);
+  EXPECT_EQ(config.block(1.0F, -0.1F), 3U);
+  EXPECT_EQ(config.block_time(1U), std::chrono::microseconds{37500});
+  const DeskewConfig clockwise_config{milliseconds{100}, 4U, 0.0F, true};
+  EXPECT_EQ(clockwise_config.block(1.0F, -0.1F), 0U);
+  EXPECT_EQ(clockwise_config.block(1.0F, 0.1F), 3U);
+
+  // The seeds are placed at 45 and 135 degrees, i.e. in the first two blocks.
+  const auto stamp = to_msg_time(std::chrono::system_clock::time_point{std::chrono::seconds{10}});
+  auto msg = std::make_shared<sensor_msgs::msg::PointCloud2>(make_pc({1, 1}, stamp));
+  float32_t second_x = -1.0F;
+  std::memcpy(&msg->data[msg->point_step], &second_x, sizeof(second_x));
+  const std::vector<sensor_msgs::msg::PointCloud2::ConstSharedPtr> msgs{msg};
+
+  PointCloudFusion fusion{10U, 1U};
+  EXPECT_THROW(fusion.pose_buffer(), std::logic_error);
+  fusion.enable_deskew(config);
+  sensor_msgs::msg::PointCloud2 fused;
+  autoware::common::lidar_utils::init_pcl_msg(fused, "base_link", 10U);
+
+  // Without odometry, the cloud is copied as is.
+  ASSERT_EQ(fusion.fuse_pc_msgs(msgs, fused), 2U);
+  EXPECT_EQ(fusion.num_uncompensated_msgs(), 1U);
+
+  // The ego frame moves with 10 m/s along x.
+  for (auto step = 0; step < 3; ++step) {
+    fusion.pose_buffer().insert(
+      std::chrono::seconds{10} + milliseconds{100 * step},
+      PoseBuffer::TransformT{Eigen::Translation3f{static_cast<float32_t>(step), 0.0F, 0.0F}});
+  }
+  ASSERT_EQ(fusion.fuse_pc_msgs(msgs, fused), 2U);
+  EXPECT_EQ(fusion.num_uncompensated_msgs(), 0U);
+  sensor_msgs::PointCloud2ConstIterator<float32_t> x_it(fused, "x");
+  sensor_msgs::PointCloud2ConstIterator<float32_t> y_it(fused, "y");
+  EXPECT_NEAR(*x_it, 1.125F, 1e-5F);
+  EXPECT_FLOAT_EQ(*y_it, 1.0F);
+  ++x_it;
+  ++y_it;
+  EXPECT_NEAR(*x_it, -1.0F + 0.375F, 1e-5F);
+  EXPECT_FLOAT_EQ(*y_it, 1.0F);
+}
+
+TEST(TestStampWindowSynchronizer, synchronization) {
+  using autoware::perception::filters::point_cloud_fusion_nodes::StampWindowSynchronizer;
+  using std::chrono::milliseconds;
+  const auto make_msg = [](const std::chrono::system_clock::time_point stamp) {
+      return std::make_shared<sensor_msgs::msg::PointCloud2>(make_pc({1}, to_msg_time(stamp)));
+    };
+  const auto stamp = std::chrono::system_clock::now();
+  const auto now = StampWindowSynchronizer::Clock::now();
+  StampWindowSynchronizer synchronizer{3U, milliseconds{10}, milliseconds{100}};
+  std::vector<sensor_msgs::msg::PointCloud2::ConstSharedPtr> msgs;
+  EXPECT_TRUE(synchronizer.empty());
+  EXPECT_FALSE(synchronizer.expired(now + milliseconds{1000}));
+
+  // A set is complete once all inputs are within the window. Newer messages replace older ones.
+  EXPECT_FALSE(synchronizer.insert(0U, make_msg(stamp), now));
+  EXPECT_EQ(synchronizer.deadline(), now + milliseconds{100});
+  EXPECT_FALSE(synchronizer.insert(1U, make_msg(stamp + milliseconds{5}), now));
+  const auto replaced_msg = make_msg(stamp + milliseconds{8});
+  EXPECT_FALSE(synchronizer.insert(1U, replaced_msg, now + milliseconds{10}));
+  EXPECT_EQ(synchronizer.deadline(), now + milliseconds{100});
+  EXPECT_TRUE(synchronizer.insert(2U, make_msg(stamp + milliseconds{2}), now));
+  EXPECT_EQ(synchronizer.take(msgs), 3U);
+  ASSERT_EQ(msgs.size(), 3U);
+  EXPECT_EQ(msgs[1U], replaced_msg);
+  EXPECT_TRUE(synchronizer.empty());
+
+  // Messages outside of the window of the newest message are dropped.
+  EXPECT_FALSE(synchronizer.insert(0U, make_msg(stamp), now));
+  EXPECT_FALSE(synchronizer.insert(1U, make_msg(stamp + milliseconds{20}), now));
+  EXPECT_FALSE(synchronizer.insert(2U, make_msg(stamp + milliseconds{25}), now));
+  EXPECT_FALSE(synchronizer.expired(now + milliseconds{99}));
+  EXPECT_TRUE(synchronizer.expired(now + milliseconds{100}));
+  EXPECT_EQ(synchronizer.take(msgs), 2U);
+  EXPECT_EQ(msgs[0U], nullptr);
+  EXPECT_NE(msgs[1U], nullptr);
+  EXPECT_NE(msgs[2U], nullptr);
+  EXPECT_FALSE(synchronizer.expired(now + milliseconds{1000}));
+
+  EXPECT_THROW(synchronizer.insert(3U, make_msg(stamp), now), std::out_of_range);
+  EXPECT_THROW(synchronizer.insert(0U, nullptr, now), std::domain_error);
+  EXPECT_THROW(
+    StampWindowSynchronizer(0U, milliseconds{10}, milliseconds{100}), std::domain_error);
+  EXPECT_THROW(
+    StampWindowSynchronizer(3U, milliseconds{-1}, milliseconds{100}), std::domain_error);
+  EXPECT_THROW(StampWindowSynchronizer(3U, milliseconds{10}, milliseconds{0}), std::domain_error);
+}
+
 #endif  // TEST_POINT_CLOUD_FUSION_NODES_HPP_
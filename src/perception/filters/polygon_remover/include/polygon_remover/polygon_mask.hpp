@@ -0,0 +1,120 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \copyright Copyright 2021 The Autoware Foundation
+/// \file
+/// \brief This file defines the polygon_mask class.
+
+#ifndef POLYGON_REMOVER__POLYGON_MASK_HPP_
+#define POLYGON_REMOVER__POLYGON_MASK_HPP_
+
+#include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
+#include <polygon_remover/visibility_control.hpp>
+#include <common/types.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace autoware
+{
+namespace perception
+{
+namespace filters
+{
+namespace polygon_remover
+{
+
+/// \brief Rasterization of a polygon into a grid of square cells over its bounding box. Each cell
+///        is known to be inside or outside of the polygon, unless the boundary of the polygon
+///        passes through or next to it. Only points in such boundary cells need an exact test.
+class POLYGON_REMOVER_PUBLIC PolygonMask
+{
+public:
+  using float32_t = autoware::common::types::float32_t;
+  using float64_t = autoware::common::types::float64_t;
+  typedef CGAL::Exact_predicates_inexact_constructions_kernel K;
+  typedef K::Point_2 PointCgal;
+
+  /// \brief Classification of a cell of the mask
+  enum class CellType : uint8_t
+  {
+    kOutside,
+    kInside,
+    kBoundary
+  };
+
+  /// \brief Above this number of cells, the cells are enlarged to bound the memory of the mask
+  static constexpr std::size_t MAX_NUM_CELLS = 1UL << 22U;
+
+  /// \brief Rasterize a polygon, reusing the memory of a previous polygon
+  /// \param polygon Vertices of the polygon, at least 3
+  /// \param resolution Side length of the cells, the cells are larger if the bounding box of the
+  ///                   polygon would need more than MAX_NUM_CELLS cells
+  /// \throw std::length_error If the polygon has less than 3 vertices
+  /// \throw std::domain_error If the resolution is not positive and finite
+  void build(const std::vector<PointCgal> & polygon, float32_t resolution);
+
+  /// \brief Get the type of the cell a point falls into
+  /// \param x X coordinate of the point
+  /// \param y Y coordinate of the point
+  /// \return kOutside if the point is outside the polygon, kInside if it is inside and
+  ///         kBoundary if it needs an exact test, which includes non-finite points
+  CellType get_cell_type(float32_t x, float32_t y) const
+  {
+    if ((x < m_min_x) || (x > m_max_x) || (y < m_min_y) || (y > m_max_y)) {
+      return CellType::kOutside;
+    }
+    if (!(x >= m_min_x) || !(y >= m_min_y)) {
+      // Not a number
+      return CellType::kBoundary;
+    }
+    return m_cells[get_row(y) * m_num_cols + get_col(x)];
+  }
+
+  /// \brief Get the side length of the cells, which may be larger than the requested resolution
+  float32_t get_cell_size() const;
+
+private:
+  std::size_t get_col(const float32_t x) const
+  {
+    const auto col = static_cast<std::size_t>((x - m_min_x) * m_cell_size_inv);
+    return (col < m_num_cols) ? col : (m_num_cols - 1U);
+  }
+  std::size_t get_row(const float32_t y) const
+  {
+    const auto row = static_cast<std::size_t>((y - m_min_y) * m_cell_size_inv);
+    return (row < m_num_rows) ? row : (m_num_rows - 1U);
+  }
+  /// \brief Mark the cells along an edge, and their neighbors, as boundary cells
+  void mark_edge(const PointCgal & start, const PointCgal & end);
+
+  // Bounding box of the polygon grown by a cell, empty until build() has been called
+  float32_t m_min_x{1.0F};
+  float32_t m_min_y{1.0F};
+  float32_t m_max_x{0.0F};
+  float32_t m_max_y{0.0F};
+  float32_t m_cell_size{0.0F};
+  float32_t m_cell_size_inv{0.0F};
+  std::size_t m_num_cols{0U};
+  std::size_t m_num_rows{0U};
+  // Row major cells
+  std::vector<CellType> m_cells;
+};
+
+}  // namespace polygon_remover
+}  // namespace filters
+}  // namespace perception
+}  // namespace autoware
+
+#endif  // POLYGON_REMOVER__POLYGON_MASK_HPP_
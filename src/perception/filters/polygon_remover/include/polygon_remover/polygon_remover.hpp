@@ -21,6 +21,7 @@
 
 #include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
 #include <CGAL/Polygon_2_algorithms.h>
+#include <polygon_remover/polygon_mask.hpp>
 #include <polygon_remover/visibility_control.hpp>
 #include <common/types.hpp>
 #include <sensor_msgs/msg/point_cloud2.hpp>
@@ -56,8 +57,16 @@ public:
   typedef CGAL::Exact_predicates_inexact_constructions_kernel K;
   typedef K::Point_2 PointCgal;
   using bool8_t = autoware::common::types::bool8_t;
+  using float32_t = autoware::common::types::float32_t;
 
-  explicit PolygonRemover(bool8_t will_visualize);
+  /// \brief Constructor
+  /// \param will_visualize Whether to build a marker of the stored polygon
+  /// \param mask_resolution Cell size of the mask that update_polygon() rasterizes the stored
+  ///                        polygon into. Only points in cells that the boundary of the polygon
+  ///                        passes through or next to are tested exactly against the polygon.
+  ///                        0 tests every point exactly
+  /// \throw std::domain_error If mask_resolution is negative or not finite
+  explicit PolygonRemover(bool8_t will_visualize, float32_t mask_resolution = 0.0F);
 
   /// \brief Removes the given geometry_msgs polygon from the given cloud and returns it.
   /// \param cloud_in Input Point Cloud Shared Pointer
@@ -91,6 +100,13 @@ public:
   PointCloud2::SharedPtr remove_updated_polygon_from_cloud(
     const PointCloud2::ConstSharedPtr & cloud_in);
 
+  /// \brief Removes the stored polygon from the point cloud into a preallocated point cloud.
+  /// \param cloud_in Input Point Cloud
+  /// \param cloud_out Output Point Cloud, must be empty or the output of a previous call. Its
+  ///                  memory is reused, so that filtering does not allocate once the output has
+  ///                  held a cloud of the size of the input
+  void remove_updated_polygon_from_cloud(const PointCloud2 & cloud_in, PointCloud2 & cloud_out);
+
   bool8_t polygon_is_initialized() const;
 
   /// \brief Set the frame id of marker which will be used for visualization
@@ -105,6 +121,8 @@ private:
   bool8_t polygon_is_initialized_;
   bool8_t will_visualize_;
   std::vector<PointCgal> polygon_cgal_;
+  float32_t mask_resolution_;
+  PolygonMask polygon_mask_;
   Marker marker_;
 };
 
@@ -0,0 +1,154 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
+#include <CGAL/Polygon_2_algorithms.h>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include "polygon_remover/polygon_mask.hpp"
+
+namespace autoware
+{
+namespace perception
+{
+namespace filters
+{
+namespace polygon_remover
+{
+using K = CGAL::Exact_predicates_inexact_constructions_kernel;
+using PointCgal = K::Point_2;
+using autoware::common::types::float32_t;
+using autoware::common::types::float64_t;
+
+constexpr std::size_t PolygonMask::MAX_NUM_CELLS;
+
+void PolygonMask::build(const std::vector<PointCgal> & polygon, const float32_t resolution)
+{
+  if (polygon.size() < 3) {
+    throw std::length_error("Polygon vertex count should be larger than 2.");
+  }
+  if (!std::isfinite(resolution) || (resolution <= 0.0F)) {
+    throw std::domain_error("Polygon mask resolution should be positive.");
+  }
+  float64_t min_x = polygon.front().x();
+  float64_t min_y = polygon.front().y();
+  float64_t max_x = min_x;
+  float64_t max_y = min_y;
+  for (const auto & vertex : polygon) {
+    min_x = std::min(min_x, vertex.x());
+    min_y = std::min(min_y, vertex.y());
+    max_x = std::max(max_x, vertex.x());
+    max_y = std::max(max_y, vertex.y());
+  }
+
+  // Grow the cells until the grid with a margin of one cell around the polygon has few enough
+  float64_t cell_size = static_cast<float64_t>(resolution);
+  auto count_cells = [](const float64_t extent, const float64_t size) {
+      return static_cast<std::size_t>(std::floor(extent / size)) + 3U;
+    };
+  while (count_cells(max_x - min_x, cell_size) * count_cells(max_y - min_y, cell_size) >
+    MAX_NUM_CELLS)
+  {
+    cell_size *= 2.0;
+  }
+  m_num_cols = count_cells(max_x - min_x, cell_size);
+  m_num_rows = count_cells(max_y - min_y, cell_size);
+  m_cell_size = static_cast<float32_t>(cell_size);
+  m_cell_size_inv = 1.0F / m_cell_size;
+  m_min_x = static_cast<float32_t>(min_x - cell_size);
+  m_min_y = static_cast<float32_t>(min_y - cell_size);
+  m_max_x = m_min_x + static_cast<float32_t>(m_num_cols) * m_cell_size;
+  m_max_y = m_min_y + static_cast<float32_t>(m_num_rows) * m_cell_size;
+
+  m_cells.assign(m_num_cols * m_num_rows, CellType::kOutside);
+  for (std::size_t idx = 0U; idx < polygon.size(); ++idx) {
+    mark_edge(polygon[idx], polygon[(idx + 1U) % polygon.size()]);
+  }
+
+  // The boundary does not cross a run of other cells in a row, so the whole run is on the same
+  // side of it as the center of its first cell
+  for (std::size_t row = 0U; row < m_num_rows; ++row) {
+    CellType run_type = CellType::kBoundary;
+    for (std::size_t col = 0U; col < m_num_cols; ++col) {
+      CellType & cell = m_cells[row * m_num_cols + col];
+      if (cell == CellType::kBoundary) {
+        run_type = CellType::kBoundary;
+        continue;
+      }
+      if (run_type == CellType::kBoundary) {
+        const PointCgal center{
+          static_cast<float64_t>(m_min_x) + (static_cast<float64_t>(col) + 0.5) * cell_size,
+          static_cast<float64_t>(m_min_y) + (static_cast<float64_t>(row) + 0.5) * cell_size};
+        const auto side = CGAL::bounded_side_2(polygon.begin(), polygon.end(), center, K());
+        run_type = (side == CGAL::ON_UNBOUNDED_SIDE) ? CellType::kOutside : CellType::kInside;
+      }
+      cell = run_type;
+    }
+  }
+}
+
+float32_t PolygonMask::get_cell_size() const
+{
+  return m_cell_size;
+}
+
+void PolygonMask::mark_edge(const PointCgal & start, const PointCgal & end)
+{
+  // Edge in units of cells from the corner of the grid
+  const float64_t cell_size = static_cast<float64_t>(m_cell_size);
+  const float64_t u0 = (start.x() - static_cast<float64_t>(m_min_x)) / cell_size;
+  const float64_t v0 = (start.y() - static_cast<float64_t>(m_min_y)) / cell_size;
+  const float64_t u1 = (end.x() - static_cast<float64_t>(m_min_x)) / cell_size;
+  const float64_t v1 = (end.y() - static_cast<float64_t>(m_min_y)) / cell_size;
+  const float64_t v_min = std::min(v0, v1);
+  const float64_t v_max = std::max(v0, v1);
+  auto to_index = [](const float64_t value, const std::size_t size) {
+      return static_cast<std::size_t>(
+        std::min(std::max(std::floor(value), 0.0), static_cast<float64_t>(size - 1U)));
+    };
+  const std::size_t row_begin = to_index(v_min, m_num_rows);
+  const std::size_t row_end = to_index(v_max, m_num_rows);
+  for (std::size_t row = row_begin; row <= row_end; ++row) {
+    // Part of the edge within the row
+    float64_t u_lo = std::min(u0, u1);
+    float64_t u_hi = std::max(u0, u1);
+    if (v1 != v0) {
+      const float64_t v_lo = std::max(v_min, static_cast<float64_t>(row));
+      const float64_t v_hi = std::min(v_max, static_cast<float64_t>(row + 1U));
+      const float64_t u_at_lo = u0 + (u1 - u0) * ((v_lo - v0) / (v1 - v0));
+      const float64_t u_at_hi = u0 + (u1 - u0) * ((v_hi - v0) / (v1 - v0));
+      u_lo = std::min(u_at_lo, u_at_hi);
+      u_hi = std::max(u_at_lo, u_at_hi);
+    }
+    // Also mark the neighboring cells, so that rounding of the points can not move them across
+    // the boundary
+    const std::size_t col_begin = to_index(u_lo - 1.0, m_num_cols);
+    const std::size_t col_end = to_index(u_hi + 1.0, m_num_cols);
+    const std::size_t mark_row_begin = (row > 0U) ? (row - 1U) : 0U;
+    const std::size_t mark_row_end = std::min(row + 1U, m_num_rows - 1U);
+    for (std::size_t mark_row = mark_row_begin; mark_row <= mark_row_end; ++mark_row) {
+      std::fill(
+        m_cells.begin() + static_cast<std::ptrdiff_t>(mark_row * m_num_cols + col_begin),
+        m_cells.begin() + static_cast<std::ptrdiff_t>(mark_row * m_num_cols + col_end + 1U),
+        CellType::kBoundary);
+    }
+  }
+}
+
+}  // namespace polygon_remover
+}  // namespace filters
+}  // namespace perception
+}  // namespace autoware
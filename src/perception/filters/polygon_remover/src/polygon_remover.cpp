@@ -17,6 +17,8 @@
 #include <point_cloud_msg_wrapper/point_cloud_msg_wrapper.hpp>
 #include <common/types.hpp>
 #include <geometry_msgs/msg/polygon.hpp>
+#include <cmath>
+#include <stdexcept>
 #include <tuple>
 #include <memory>
 #include <string>
@@ -37,11 +39,62 @@ using Polygon = geometry_msgs::msg::Polygon;
 using K = CGAL::Exact_predicates_inexact_constructions_kernel;
 using PointCgal = K::Point_2;
 using autoware::common::types::bool8_t;
+using autoware::common::types::float32_t;
 
-PolygonRemover::PolygonRemover(bool8_t will_visualize)
+namespace
+{
+using CloudModifier = point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI>;
+using CloudView = point_cloud_msg_wrapper::PointCloud2View<PointXYZI>;
+
+bool8_t point_is_outside_polygon(
+  const std::vector<PointCgal> & polyline_polygon,
+  const PointXYZI & point)
+{
+  auto result = CGAL::bounded_side_2(
+    polyline_polygon.begin(), polyline_polygon.end(),
+    PointCgal(point.x, point.y), K());
+  return result == CGAL::ON_UNBOUNDED_SIDE;  // not INSIDE or ON the polygon
+}
+
+/// \brief Copies the points of cloud_in for which is_outside is true to cloud_out, reusing the
+///        memory of cloud_out
+template<typename IsOutsideT>
+void copy_points_outside(
+  const PointCloud2 & cloud_in,
+  PointCloud2 & cloud_out,
+  const IsOutsideT & is_outside)
+{
+  if (cloud_out.fields.empty()) {
+    // Initialize the fields of a new cloud
+    CloudModifier{cloud_out, cloud_in.header.frame_id}.clear();
+  }
+  cloud_out.header = cloud_in.header;
+  CloudModifier cloud_modifier_filtered(cloud_out);
+
+  CloudView cloud_view_in(cloud_in);
+  cloud_modifier_filtered.resize(static_cast<uint32_t>(cloud_view_in.size()));
+
+  auto new_end = std::copy_if(
+    cloud_view_in.cbegin(),
+    cloud_view_in.cend(),
+    cloud_modifier_filtered.begin(),
+    is_outside);
+
+  cloud_modifier_filtered.resize(
+    static_cast<uint32_t>(std::distance(
+      cloud_modifier_filtered.begin(),
+      new_end)));
+}
+}  // namespace
+
+PolygonRemover::PolygonRemover(bool8_t will_visualize, float32_t mask_resolution)
 : polygon_is_initialized_{false},
-  will_visualize_{will_visualize}
+  will_visualize_{will_visualize},
+  mask_resolution_{mask_resolution}
 {
+  if (!std::isfinite(mask_resolution) || (mask_resolution < 0.0F)) {
+    throw std::domain_error("Polygon mask resolution should be zero or positive.");
+  }
 }
 
 PointCloud2::SharedPtr PolygonRemover::remove_polygon_geometry_from_cloud(
@@ -58,35 +111,10 @@ PointCloud2::SharedPtr PolygonRemover::remove_polygon_cgal_from_cloud(
   const std::vector<PointCgal> & polyline_polygon)
 {
   PointCloud2::SharedPtr cloud_filtered_ptr = std::make_shared<PointCloud2>();
-
-  using CloudModifier = point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI>;
-  using CloudView = point_cloud_msg_wrapper::PointCloud2View<PointXYZI>;
-
-  CloudModifier cloud_modifier_filtered(*cloud_filtered_ptr, "");
-  cloud_filtered_ptr->header = cloud_in_ptr->header;
-
-  CloudView cloud_view_in(*cloud_in_ptr);
-  cloud_modifier_filtered.resize(static_cast<uint32_t>(cloud_view_in.size()));
-
-  auto point_is_outside_polygon = [&polyline_polygon](const PointXYZI & point) {
-      auto result = CGAL::bounded_side_2(
-        polyline_polygon.begin(), polyline_polygon.end(),
-        PointCgal(point.x, point.y), K());
-      return result == CGAL::ON_UNBOUNDED_SIDE;  // not INSIDE or ON the polygon
-    };
-
-  auto new_end = std::copy_if(
-    cloud_view_in.cbegin(),
-    cloud_view_in.cend(),
-    cloud_modifier_filtered.begin(),
-    [&point_is_outside_polygon](const PointXYZI & point) {
-      return point_is_outside_polygon(point);
+  copy_points_outside(
+    *cloud_in_ptr, *cloud_filtered_ptr, [&polyline_polygon](const PointXYZI & point) {
+      return point_is_outside_polygon(polyline_polygon, point);
     });
-
-  cloud_modifier_filtered.resize(
-    static_cast<uint32_t>(std::distance(
-      cloud_modifier_filtered.begin(),
-      new_end)));
   return cloud_filtered_ptr;
 }
 
@@ -112,6 +140,9 @@ std::vector<PointCgal> PolygonRemover::polygon_geometry_to_cgal(
 void PolygonRemover::update_polygon(const Polygon::ConstSharedPtr & polygon_in)
 {
   polygon_cgal_ = polygon_geometry_to_cgal(polygon_in);
+  if (mask_resolution_ > 0.0F) {
+    polygon_mask_.build(polygon_cgal_, mask_resolution_);
+  }
   if (will_visualize_) {
     marker_.ns = "ns_polygon_remover";
     marker_.id = 0;
@@ -170,15 +201,41 @@ void PolygonRemover::update_polygon(const Polygon::ConstSharedPtr & polygon_in)
 
 PointCloud2::SharedPtr PolygonRemover::remove_updated_polygon_from_cloud(
   const PointCloud2::ConstSharedPtr & cloud_in)
+{
+  PointCloud2::SharedPtr cloud_filtered_ptr = std::make_shared<PointCloud2>();
+  remove_updated_polygon_from_cloud(*cloud_in, *cloud_filtered_ptr);
+  return cloud_filtered_ptr;
+}
+
+void PolygonRemover::remove_updated_polygon_from_cloud(
+  const PointCloud2 & cloud_in,
+  PointCloud2 & cloud_out)
 {
   if (will_visualize_) {
-    set_marker_frame_id(cloud_in->header.frame_id);
+    set_marker_frame_id(cloud_in.header.frame_id);
   }
   if (!polygon_is_initialized_) {
     throw std::runtime_error(
             "Polygon is not initialized. Please use `update_polygon` first.");
   }
-  return remove_polygon_cgal_from_cloud(cloud_in, polygon_cgal_);
+  if (mask_resolution_ <= 0.0F) {
+    copy_points_outside(
+      cloud_in, cloud_out, [this](const PointXYZI & point) {
+        return point_is_outside_polygon(polygon_cgal_, point);
+      });
+    return;
+  }
+  copy_points_outside(
+    cloud_in, cloud_out, [this](const PointXYZI & point) {
+      switch (polygon_mask_.get_cell_type(point.x, point.y)) {
+        case PolygonMask::CellType::kOutside:
+          return true;
+        case PolygonMask::CellType::kInside:
+          return false;
+        default:
+          return point_is_outside_polygon(polygon_cgal_, point);
+      }
+    });
 }
 
 bool8_t PolygonRemover::polygon_is_initialized() const
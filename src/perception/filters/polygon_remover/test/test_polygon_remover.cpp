@@ -17,6 +17,8 @@
 #include <geometry_msgs/msg/polygon.hpp>
 #include <random>
 #include <memory>
+#include <stdexcept>
+#include <vector>
 #include "gtest/gtest.h"
 #include "polygon_remover/polygon_remover.hpp"
 
@@ -180,3 +182,65 @@ TEST(test_polygon_remover, shape_to_polyline_polygon) {
   CloudModifier cloud_modifier_filtered(*cloud_filtered_ptr);
   EXPECT_EQ(cloud_modifier_filtered.size(), count_points_outside_rect);
 }
+
+TEST(test_polygon_remover, mask_matches_exact_test) {
+  using PolygonRemover = autoware::perception::filters::polygon_remover::PolygonRemover;
+  PolygonRemover polygon_remover_exact(false);
+  PolygonRemover polygon_remover_mask(false, 0.1F);
+  EXPECT_THROW(PolygonRemover(false, -0.1F), std::domain_error);
+
+  // Concave star, with points on its vertices and edges in addition to random ones
+  Polygon::SharedPtr shape = std::make_shared<Polygon>();
+  const std::vector<float32_t> vertices{
+    0.0F, -23.916F, 0.21031F, -10.228F, 23.8108F, -6.61647F, 10.8577F, -2.18663F,
+    14.7159F, 21.3748F, 6.50012F, 10.4246F, -14.7159F, 21.3748F, -6.8404F, 10.1773F,
+    -23.8108F, -6.61647F, -10.7277F, -2.58666F};
+  for (std::size_t i = 0U; i < vertices.size(); i += 2U) {
+    shape->points.emplace_back(make_point_geo(vertices[i], vertices[i + 1U], 0.0F));
+  }
+  polygon_remover_exact.update_polygon(shape);
+  polygon_remover_mask.update_polygon(shape);
+
+  PointCloud2::SharedPtr cloud_input_ptr = std::make_shared<PointCloud2>();
+  using CloudModifier = point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI>;
+  CloudModifier cloud_modifier_input(*cloud_input_ptr, "");
+  std::mt19937 mt(19940426);
+  std::uniform_real_distribution<float32_t> dist(-30.0F, 30.0F);
+  for (uint32_t i = 0; i < 10000U; ++i) {
+    PointXYZI point;
+    point.x = dist(mt);
+    point.y = dist(mt);
+    cloud_modifier_input.push_back(point);
+  }
+  for (std::size_t i = 0U; i < vertices.size(); i += 2U) {
+    const std::size_t j = (i + 2U) % vertices.size();
+    PointXYZI point;
+    point.x = vertices[i];
+    point.y = vertices[i + 1U];
+    cloud_modifier_input.push_back(point);
+    point.x = 0.5F * (vertices[i] + vertices[j]);
+    point.y = 0.5F * (vertices[i + 1U] + vertices[j + 1U]);
+    cloud_modifier_input.push_back(point);
+  }
+
+  PointCloud2::SharedPtr cloud_exact_ptr =
+    polygon_remover_exact.remove_updated_polygon_from_cloud(cloud_input_ptr);
+  // Filter twice into the same cloud to reuse its memory
+  PointCloud2 cloud_mask;
+  polygon_remover_mask.remove_updated_polygon_from_cloud(*cloud_input_ptr, cloud_mask);
+  polygon_remover_mask.remove_updated_polygon_from_cloud(*cloud_input_ptr, cloud_mask);
+
+  using CloudView = point_cloud_msg_wrapper::PointCloud2View<PointXYZI>;
+  CloudView cloud_view_exact(*cloud_exact_ptr);
+  CloudView cloud_view_mask(cloud_mask);
+  CloudView cloud_view_input(*cloud_input_ptr);
+  ASSERT_EQ(cloud_view_exact.size(), cloud_view_mask.size());
+  EXPECT_LT(cloud_view_mask.size(), cloud_view_input.size());
+  auto mask_it = cloud_view_mask.cbegin();
+  for (const auto & point_exact : cloud_view_exact) {
+    EXPECT_EQ(point_exact.x, mask_it->x);
+    EXPECT_EQ(point_exact.y, mask_it->y);
+    ++mask_it;
+  }
+  EXPECT_EQ(cloud_mask.header, cloud_input_ptr->header);
+}
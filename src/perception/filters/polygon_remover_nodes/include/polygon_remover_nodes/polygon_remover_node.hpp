@@ -64,6 +64,10 @@ private:
   polygon_remover::PolygonRemover::SharedPtr polygon_remover_;
 
   bool8_t will_visualize_;
+  // Cell size of the polygon mask, 0 tests every point exactly against the polygon
+  autoware::common::types::float64_t mask_resolution_;
+  // Output cloud, kept to reuse its memory
+  PointCloud2 cloud_filtered_;
 
   enum class WorkingMode
   {
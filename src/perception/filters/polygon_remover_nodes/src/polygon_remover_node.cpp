@@ -19,6 +19,7 @@
 #include <memory>
 #include <string>
 #include <map>
+#include <stdexcept>
 #include <vector>
 
 namespace autoware
@@ -53,7 +54,8 @@ PolygonRemoverNode::PolygonRemoverNode(const rclcpp::NodeOptions & options)
         &PolygonRemoverNode::callback_cloud,
         this,
         std::placeholders::_1))},
-  will_visualize_{declare_parameter("will_visualize").get<bool8_t>()}
+  will_visualize_{declare_parameter("will_visualize").get<bool8_t>()},
+  mask_resolution_{declare_parameter("mask_resolution", 0.0)}
 {
   auto make_point = [](float x, float y, float z) {
       geometry_msgs::msg::Point32 point_32;
@@ -81,7 +83,11 @@ PolygonRemoverNode::PolygonRemoverNode(const rclcpp::NodeOptions & options)
     throw std::runtime_error("Please set working_mode to be one of: " + str_list_of_keys);
   }
 
-  polygon_remover_ = std::make_shared<polygon_remover::PolygonRemover>(will_visualize_);
+  if (!(mask_resolution_ >= 0.0)) {
+    throw std::domain_error("mask_resolution must be zero or positive.");
+  }
+  polygon_remover_ = std::make_shared<polygon_remover::PolygonRemover>(
+    will_visualize_, static_cast<float>(mask_resolution_));
 
   // Initialize based on working_mode
   switch (map_string_to_working_mode_.at(working_mode_str)) {
@@ -130,10 +136,9 @@ void PolygonRemoverNode::callback_cloud(const PointCloud2::ConstSharedPtr cloud_
     return;
   }
 
-  PointCloud2::SharedPtr cloud_filtered_ptr =
-    polygon_remover_->remove_updated_polygon_from_cloud(cloud_in_ptr);
+  polygon_remover_->remove_updated_polygon_from_cloud(*cloud_in_ptr, cloud_filtered_);
 
-  pub_cloud_ptr_->publish(*cloud_filtered_ptr);
+  pub_cloud_ptr_->publish(cloud_filtered_);
 
   if (will_visualize_) {
     pub_marker_ptr_->publish(polygon_remover_->get_marker());
@@ -0,0 +1,195 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+/// \file
+/// \brief This file defines a ground filter algorithm on a polar elevation grid
+
+#ifndef RAY_GROUND_CLASSIFIER__GRID_GROUND_CLASSIFIER_HPP_
+#define RAY_GROUND_CLASSIFIER__GRID_GROUND_CLASSIFIER_HPP_
+
+#include <common/types.hpp>
+#include <ray_ground_classifier/visibility_control.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace autoware
+{
+namespace perception
+{
+namespace filters
+{
+namespace ray_ground_classifier
+{
+using autoware::common::types::PointPtrBlock;
+using autoware::common::types::PointXYZIF;
+using autoware::common::types::bool8_t;
+using autoware::common::types::float32_t;
+
+/// \brief Partitions whole clouds into ground and nonground points on a polar elevation grid
+///        around the sensor. Unlike RayGroundClassifier, it doesn't depend on the order of the
+///        points along rays, so it also works on sparse clouds fused from several lidars.
+///
+/// The points are binned into the cells of rings and sectors while the minimum and maximum
+/// height of each cell are tracked, in a single pass over the points. The ground is then grown
+/// outward along each sector from the ground below the sensor: an occupied cell whose minimum
+/// height is within the slope band of the last ground cell of the sector is ground, otherwise
+/// the last ground height is carried over. The ground heights are smoothed over neighbouring
+/// sectors, and each point is ground if it is at most the height threshold above the ground of
+/// its cell. All steps are linear in the number of points and cells, and the ground of disjoint
+/// sector ranges can be estimated and smoothed concurrently.
+class RAY_GROUND_CLASSIFIER_PUBLIC GridGroundClassifier
+{
+public:
+  /// \brief Configuration object for GridGroundClassifier
+  class RAY_GROUND_CLASSIFIER_PUBLIC Config
+  {
+public:
+    /// \brief Constructor
+    /// \param[in] sensor_height_m How high the sensor is off the ground
+    /// \param[in] num_sectors Number of azimuth bins of the grid
+    /// \param[in] num_rings Number of range bins of the grid
+    /// \param[in] max_range_m Outer radius of the grid, points beyond it are nonground
+    /// \param[in] max_slope_deg Maximum slope of the ground between the cells of a sector
+    /// \param[in] max_step_m Height difference that is tolerated on top of the slope between two
+    ///                       ground cells, e.g. for curbs or noise
+    /// \param[in] height_thresh_m Points at most this high above the ground of their cell are
+    ///                            ground
+    /// \throw std::runtime_error If the grid is empty, a distance is not positive or the slope
+    ///                           is outside of (0, 90)
+    Config(
+      const float32_t sensor_height_m,
+      const std::size_t num_sectors,
+      const std::size_t num_rings,
+      const float32_t max_range_m,
+      const float32_t max_slope_deg,
+      const float32_t max_step_m,
+      const float32_t height_thresh_m);
+
+    /// \brief Get z value (meters) of the ground in sensor frame, -sensor_height
+    float32_t get_ground_z() const;
+    /// \brief Get number of azimuth bins
+    std::size_t get_num_sectors() const;
+    /// \brief Get number of range bins
+    std::size_t get_num_rings() const;
+    /// \brief Get the outer radius of the grid in meters
+    float32_t get_max_range() const;
+    /// \brief Get the radial extent of a cell in meters
+    float32_t get_ring_width() const;
+    /// \brief Get the maximum ground slope as a ratio, rise / run
+    float32_t get_max_slope() const;
+    /// \brief Get the tolerated height step between ground cells in meters
+    float32_t get_max_step() const;
+    /// \brief Get the height above the ground up to which points are ground in meters
+    float32_t get_height_thresh() const;
+
+private:
+    const float32_t m_ground_z_m;
+    const std::size_t m_num_sectors;
+    const std::size_t m_num_rings;
+    const float32_t m_max_range_m;
+    const float32_t m_max_slope;
+    const float32_t m_max_step_m;
+    const float32_t m_height_thresh_m;
+  };  // class Config
+
+  /// \brief A cell of the elevation grid
+  struct ElevationCell
+  {
+    /// \brief Height of the lowest point, larger than max_z if the cell is empty
+    float32_t min_z;
+    /// \brief Height of the highest point
+    float32_t max_z;
+    /// \brief Smoothed ground height, valid after smooth_ground()
+    float32_t ground_z;
+  };  // struct ElevationCell
+
+  /// \brief Constructor
+  /// \param[in] cfg Configuration of the grid
+  /// \param[in] capacity Maximum number of points of a cloud
+  GridGroundClassifier(const Config & cfg, const std::size_t capacity);
+
+  /// \brief Drop all inserted points and clear the grid
+  void reset();
+
+  /// \brief Insert a point of the current cloud. The point is referred to until reset()
+  /// \param[in] pt The point to insert
+  /// \throw std::runtime_error If the capacity is exceeded
+  void insert(const PointXYZIF * pt);
+
+  /// \brief Grow the ground outward along a range of sectors. Disjoint ranges can be
+  ///        estimated concurrently once all points are inserted
+  /// \param[in] first_sector First sector of the range
+  /// \param[in] last_sector One past the last sector of the range
+  /// \throw std::out_of_range If the range exceeds the number of sectors
+  void estimate_ground(const std::size_t first_sector, const std::size_t last_sector);
+
+  /// \brief Smooth the ground heights of a range of sectors over their neighbouring sectors.
+  ///        Disjoint ranges can be smoothed concurrently once the ground of all sectors is
+  ///        estimated
+  /// \param[in] first_sector First sector of the range
+  /// \param[in] last_sector One past the last sector of the range
+  /// \throw std::out_of_range If the range exceeds the number of sectors
+  void smooth_ground(const std::size_t first_sector, const std::size_t last_sector);
+
+  /// \brief Label the inserted points with the smoothed ground
+  /// \param[out] ground_block Gets filled with the ground points, in the order of insertion
+  /// \param[out] nonground_block Gets filled with the nonground points, in the order of
+  ///                             insertion
+  void label(PointPtrBlock & ground_block, PointPtrBlock & nonground_block) const;
+
+  /// \brief Estimate and smooth the ground of all sectors and label the inserted points
+  /// \param[out] ground_block Gets filled with the ground points, in the order of insertion
+  /// \param[out] nonground_block Gets filled with the nonground points, in the order of
+  ///                             insertion
+  void partition(PointPtrBlock & ground_block, PointPtrBlock & nonground_block);
+
+  /// \brief Get the cell of the grid
+  /// \param[in] sector Azimuth bin, counterclockwise from the negative x axis
+  /// \param[in] ring Range bin
+  /// \return The cell
+  /// \throw std::out_of_range If the cell doesn't exist
+  const ElevationCell & get_cell(const std::size_t sector, const std::size_t ring) const;
+
+  /// \brief Get the configuration
+  const Config & get_config() const;
+
+private:
+  /// \brief Check a range of sectors
+  RAY_GROUND_CLASSIFIER_LOCAL void check_sectors(
+    const std::size_t first_sector,
+    const std::size_t last_sector) const;
+
+  const Config m_config;
+  const std::size_t m_capacity;
+  /// Cells of all sectors, the rings of a sector are contiguous
+  std::vector<ElevationCell> m_cells;
+  /// Ground heights grown along the sectors, before the smoothing
+  std::vector<float32_t> m_sector_ground;
+  /// Nonzero if the ground height of the cell was measured rather than carried over. Not a
+  /// vector<bool>, so that disjoint sectors can be written concurrently
+  std::vector<uint8_t> m_measured;
+  /// Inserted points and the indices of their cells
+  std::vector<const PointXYZIF *> m_points;
+  std::vector<std::size_t> m_point_cells;
+};  // class GridGroundClassifier
+}  // namespace ray_ground_classifier
+}  // namespace filters
+}  // namespace perception
+}  // namespace autoware
+
+#endif  // RAY_GROUND_CLASSIFIER__GRID_GROUND_CLASSIFIER_HPP_
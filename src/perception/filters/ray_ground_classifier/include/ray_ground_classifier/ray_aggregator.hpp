@@ -49,6 +49,17 @@ using autoware::common::types::float32_t;
 class RAY_GROUND_CLASSIFIER_PUBLIC RayAggregator
 {
 public:
+  /// \brief How the points of a ray are sorted by radius before the ray is handed out
+  enum class SortMode : uint8_t
+  {
+    /// \brief Comparison sort, O(n log n) in the number of points of the ray
+    COMPARISON = 0U,
+    /// \brief Binary insertion sort. The points are already binned by angle on insertion, so
+    ///        only the small rays are sorted, which is cache friendly and fast for nearly
+    ///        sorted rays, e.g. from rotating lidars
+    INSERTION
+  };  // enum class SortMode
+
   /// \brief Configuration object for RayAggregator
   class RAY_GROUND_CLASSIFIER_PUBLIC Config
   {
@@ -59,11 +70,13 @@ public:
     /// \param[in] ray_width_rad Width of ray, defines number of rays
     /// \param[in] min_ray_points Number of points needed in a ray before it's ready for
     ///                           partitioning
+    /// \param[in] sort_mode How the points of a ray are sorted
     Config(
       const float32_t min_ray_angle_rad,
       const float32_t max_ray_angle_rad,
       const float32_t ray_width_rad,
-      const std::size_t min_ray_points);
+      const std::size_t min_ray_points,
+      const SortMode sort_mode = SortMode::COMPARISON);
 
     /// \brief Get number of rays
     /// \return Value
@@ -81,6 +94,9 @@ public:
     ///        max_ray_angle = -300
     /// \return Value
     bool8_t domain_crosses_180() const;
+    /// \brief Get how the points of a ray are sorted
+    /// \return Value
+    SortMode get_sort_mode() const;
 
 private:
     const std::size_t m_min_ray_points;
@@ -88,14 +104,27 @@ private:
     const float32_t m_ray_width_rad;
     const float32_t m_min_angle_rad;
     const bool8_t m_domain_crosses_180;
+    const SortMode m_sort_mode;
   };  // class Config
 
   /// \brief Constructor
   /// \param[in] cfg Configuration class
   explicit RayAggregator(const Config & cfg);
-  /// \brief Ready all the non empty rays. To be called once all insertions are done.
+  /// \brief Ready all the non empty rays. To be called once all insertions are done. Also ends
+  /// the current chunk, see end_of_chunk().
   /// not thread safe
   void end_of_scan();
+  /// \brief Ready all the non empty rays that did not get any point since the last call. To be
+  /// called after the points of a part of a scan (chunk) are inserted. For sensors that sweep over
+  /// the rays, e.g. rotating lidars, these rays are complete and can be classified before the
+  /// scan ends.
+  /// not thread safe
+  void end_of_chunk();
+  /// \brief Get the index of the oldest chunk that rays which were not gotten yet have points
+  /// from. Chunks are counted by the calls to end_of_chunk() and end_of_scan(). Points of older
+  /// chunks are not referenced anymore, so their memory can be released.
+  /// \return Index of the oldest referenced chunk, or of the current chunk if no ray is pending
+  std::size_t get_oldest_pending_chunk() const;
   /// \brief Insert point into set of rays. Concurrent inserts are safe
   /// \param[in] pt Point to be inserted
   /// \return true if the insertion suceeded and false if an end of scan is detected
@@ -156,7 +185,11 @@ private:
   /// \brief How many rays are ready for processing
   /// \return Value
   std::size_t get_ready_ray_count() const;
-  /// \brief Get next ray that is ready for partitioning
+  /// \brief How many rays the aggregator has, which bounds the number of ready rays
+  /// \return Value
+  std::size_t get_num_rays() const;
+  /// \brief Get next ray that is ready for partitioning. The ray is sorted according to the
+  ///        sort mode of the configuration.
   /// Concurrent calls are thread safe
   /// \return Const reference to next ray ready for processing
   /// \throw std::runtime_error If no ray is ready
@@ -186,6 +219,10 @@ private:
 
   // which rays are ready to be reset etc. TODO(c.ho) fold this into an internal ray class
   std::vector<RayState> m_ray_state;
+  // chunk of the first and of the last point of each ray
+  std::vector<std::size_t> m_ray_first_chunk;
+  std::vector<std::size_t> m_ray_last_chunk;
+  std::size_t m_chunk_idx;
 };  // class RayAggregator
 }  // namespace ray_ground_classifier
 }  // namespace filters
@@ -0,0 +1,268 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#include <ray_ground_classifier/grid_ground_classifier.hpp>
+#include <ray_ground_classifier/ray_ground_point_classifier.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace autoware
+{
+namespace perception
+{
+namespace filters
+{
+namespace ray_ground_classifier
+{
+namespace
+{
+/// Cell index of the points outside of the grid
+constexpr std::size_t NO_CELL = std::numeric_limits<std::size_t>::max();
+}  // namespace
+
+GridGroundClassifier::Config::Config(
+  const float32_t sensor_height_m,
+  const std::size_t num_sectors,
+  const std::size_t num_rings,
+  const float32_t max_range_m,
+  const float32_t max_slope_deg,
+  const float32_t max_step_m,
+  const float32_t height_thresh_m)
+: m_ground_z_m(-sensor_height_m),
+  m_num_sectors(num_sectors),
+  m_num_rings(num_rings),
+  m_max_range_m(max_range_m),
+  m_max_slope(tanf(static_cast<float32_t>(deg2rad(static_cast<float64_t>(max_slope_deg))))),
+  m_max_step_m(max_step_m),
+  m_height_thresh_m(height_thresh_m)
+{
+  if ((num_sectors == 0U) || (num_rings == 0U)) {
+    throw std::runtime_error("grid ground classifier: grid must have sectors and rings");
+  }
+  if (!(max_range_m > 0.0F) || !(max_step_m > 0.0F) || !(height_thresh_m > 0.0F)) {
+    throw std::runtime_error("grid ground classifier: config distances must be positive");
+  }
+  if (!(max_slope_deg > 0.0F) || !(max_slope_deg < 90.0F)) {
+    throw std::runtime_error("grid ground classifier: max slope must be in (0, 90)");
+  }
+}
+
+float32_t GridGroundClassifier::Config::get_ground_z() const
+{
+  return m_ground_z_m;
+}
+
+std::size_t GridGroundClassifier::Config::get_num_sectors() const
+{
+  return m_num_sectors;
+}
+
+std::size_t GridGroundClassifier::Config::get_num_rings() const
+{
+  return m_num_rings;
+}
+
+float32_t GridGroundClassifier::Config::get_max_range() const
+{
+  return m_max_range_m;
+}
+
+float32_t GridGroundClassifier::Config::get_ring_width() const
+{
+  return m_max_range_m / static_cast<float32_t>(m_num_rings);
+}
+
+float32_t GridGroundClassifier::Config::get_max_slope() const
+{
+  return m_max_slope;
+}
+
+float32_t GridGroundClassifier::Config::get_max_step() const
+{
+  return m_max_step_m;
+}
+
+float32_t GridGroundClassifier::Config::get_height_thresh() const
+{
+  return m_height_thresh_m;
+}
+
+GridGroundClassifier::GridGroundClassifier(const Config & cfg, const std::size_t capacity)
+: m_config(cfg),
+  m_capacity(capacity),
+  m_cells(cfg.get_num_sectors() * cfg.get_num_rings()),
+  m_sector_ground(m_cells.size()),
+  m_measured(m_cells.size())
+{
+  m_points.reserve(capacity);
+  m_point_cells.reserve(capacity);
+  reset();
+}
+
+void GridGroundClassifier::reset()
+{
+  m_points.clear();
+  m_point_cells.clear();
+  const ElevationCell empty{std::numeric_limits<float32_t>::max(),
+    std::numeric_limits<float32_t>::lowest(), m_config.get_ground_z()};
+  std::fill(m_cells.begin(), m_cells.end(), empty);
+}
+
+void GridGroundClassifier::insert(const PointXYZIF * pt)
+{
+  if (m_points.size() >= m_capacity) {
+    throw std::runtime_error("GridGroundClassifier: point capacity overrun");
+  }
+  const auto range = sqrtf((pt->x * pt->x) + (pt->y * pt->y));
+  auto cell_idx = NO_CELL;
+  if (range < m_config.get_max_range()) {
+    const auto num_sectors = m_config.get_num_sectors();
+    const auto num_rings = m_config.get_num_rings();
+    const auto sector = std::min(
+      static_cast<std::size_t>(
+        ((atan2f(pt->y, pt->x) + PI) / TAU) * static_cast<float32_t>(num_sectors)),
+      num_sectors - 1U);
+    const auto ring = std::min(
+      static_cast<std::size_t>(range / m_config.get_ring_width()), num_rings - 1U);
+    cell_idx = (sector * num_rings) + ring;
+    auto & cell = m_cells[cell_idx];
+    cell.min_z = std::min(cell.min_z, pt->z);
+    cell.max_z = std::max(cell.max_z, pt->z);
+  }
+  m_points.push_back(pt);
+  m_point_cells.push_back(cell_idx);
+}
+
+void GridGroundClassifier::estimate_ground(
+  const std::size_t first_sector,
+  const std::size_t last_sector)
+{
+  check_sectors(first_sector, last_sector);
+  const auto num_rings = m_config.get_num_rings();
+  const auto ring_width = m_config.get_ring_width();
+  for (auto sector = first_sector; sector < last_sector; ++sector) {
+    // The ground is grown from below the sensor
+    auto last_ground_z = m_config.get_ground_z();
+    auto last_ground_range = 0.0F;
+    for (std::size_t ring = 0U; ring < num_rings; ++ring) {
+      const auto cell_idx = (sector * num_rings) + ring;
+      const auto & cell = m_cells[cell_idx];
+      const auto range = (static_cast<float32_t>(ring) + 0.5F) * ring_width;
+      const auto max_diff =
+        (m_config.get_max_slope() * (range - last_ground_range)) + m_config.get_max_step();
+      const bool8_t is_ground = (cell.min_z <= cell.max_z) &&
+        (fabsf(cell.min_z - last_ground_z) <= max_diff);
+      if (is_ground) {
+        last_ground_z = cell.min_z;
+        last_ground_range = range;
+      }
+      m_sector_ground[cell_idx] = last_ground_z;
+      m_measured[cell_idx] = is_ground ? 1U : 0U;
+    }
+  }
+}
+
+void GridGroundClassifier::smooth_ground(
+  const std::size_t first_sector,
+  const std::size_t last_sector)
+{
+  check_sectors(first_sector, last_sector);
+  const auto num_sectors = m_config.get_num_sectors();
+  const auto num_rings = m_config.get_num_rings();
+  for (auto sector = first_sector; sector < last_sector; ++sector) {
+    const auto prev_sector = (sector + num_sectors - 1U) % num_sectors;
+    const auto next_sector = (sector + 1U) % num_sectors;
+    for (std::size_t ring = 0U; ring < num_rings; ++ring) {
+      // Mean of the measured ground of the cell and its neighbours at the same range
+      auto sum = 0.0F;
+      auto count = 0.0F;
+      for (const auto neighbour : {prev_sector, sector, next_sector}) {
+        const auto neighbour_idx = (neighbour * num_rings) + ring;
+        if (m_measured[neighbour_idx] != 0U) {
+          sum += m_sector_ground[neighbour_idx];
+          count += 1.0F;
+        }
+        if (num_sectors == 1U) {
+          break;
+        }
+      }
+      const auto cell_idx = (sector * num_rings) + ring;
+      m_cells[cell_idx].ground_z = (count > 0.0F) ? (sum / count) : m_sector_ground[cell_idx];
+    }
+  }
+}
+
+void GridGroundClassifier::label(
+  PointPtrBlock & ground_block,
+  PointPtrBlock & nonground_block) const
+{
+  ground_block.clear();
+  nonground_block.clear();
+  for (std::size_t idx = 0U; idx < m_points.size(); ++idx) {
+    const auto cell_idx = m_point_cells[idx];
+    const auto pt = m_points[idx];
+    if ((cell_idx != NO_CELL) &&
+      ((pt->z - m_cells[cell_idx].ground_z) <= m_config.get_height_thresh()))
+    {
+      ground_block.push_back(pt);
+    } else {
+      nonground_block.push_back(pt);
+    }
+  }
+}
+
+void GridGroundClassifier::partition(
+  PointPtrBlock & ground_block,
+  PointPtrBlock & nonground_block)
+{
+  estimate_ground(0U, m_config.get_num_sectors());
+  smooth_ground(0U, m_config.get_num_sectors());
+  label(ground_block, nonground_block);
+}
+
+const GridGroundClassifier::ElevationCell & GridGroundClassifier::get_cell(
+  const std::size_t sector,
+  const std::size_t ring) const
+{
+  if ((sector >= m_config.get_num_sectors()) || (ring >= m_config.get_num_rings())) {
+    throw std::out_of_range("GridGroundClassifier: cell doesn't exist");
+  }
+  return m_cells[(sector * m_config.get_num_rings()) + ring];
+}
+
+const GridGroundClassifier::Config & GridGroundClassifier::get_config() const
+{
+  return m_config;
+}
+
+void GridGroundClassifier::check_sectors(
+  const std::size_t first_sector,
+  const std::size_t last_sector) const
+{
+  if ((first_sector > last_sector) || (last_sector > m_config.get_num_sectors())) {
+    throw std::out_of_range(
+            "GridGroundClassifier: sectors " + std::to_string(first_sector) + " to " +
+            std::to_string(last_sector) + " don't exist");
+  }
+}
+}  // namespace ray_ground_classifier
+}  // namespace filters
+}  // namespace perception
+}  // namespace autoware
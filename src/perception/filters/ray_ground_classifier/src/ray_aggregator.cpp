@@ -44,12 +44,14 @@ RayAggregator::Config::Config(
   const float32_t min_ray_angle_rad,
   const float32_t max_ray_angle_rad,
   const float32_t ray_width_rad,
-  const std::size_t min_ray_points)
+  const std::size_t min_ray_points,
+  const SortMode sort_mode)
 : m_min_ray_points(min_ray_points),
   m_num_rays(),
   m_ray_width_rad(ray_width_rad),
   m_min_angle_rad(min_ray_angle_rad),
-  m_domain_crosses_180(max_ray_angle_rad < min_ray_angle_rad)
+  m_domain_crosses_180(max_ray_angle_rad < min_ray_angle_rad),
+  m_sort_mode(sort_mode)
 {
   if (m_domain_crosses_180) {
     const float32_t angle_range = (PI - min_ray_angle_rad) +
@@ -93,6 +95,11 @@ bool8_t RayAggregator::Config::domain_crosses_180() const
   return m_domain_crosses_180;
 }
 ////////////////////////////////////////////////////////////////////////////////
+RayAggregator::SortMode RayAggregator::Config::get_sort_mode() const
+{
+  return m_sort_mode;
+}
+////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 RayAggregator::RayAggregator(const Config & cfg)
 : m_cfg(cfg),
@@ -100,7 +107,10 @@ RayAggregator::RayAggregator(const Config & cfg)
   m_ready_indices(m_cfg.get_num_rays()),
   m_ready_start_idx{},      // zero initialization
   m_num_ready{},      // zero initialization
-  m_ray_state(m_cfg.get_num_rays())
+  m_ray_state(m_cfg.get_num_rays()),
+  m_ray_first_chunk(m_cfg.get_num_rays(), 0U),
+  m_ray_last_chunk(m_cfg.get_num_rays(), 0U),
+  m_chunk_idx{}      // zero initialization
 {
   m_rays.clear();  // capacity unchanged
   const std::size_t ray_size =
@@ -127,6 +137,34 @@ void RayAggregator::end_of_scan()
       }
     }
   }
+  ++m_chunk_idx;
+}
+////////////////////////////////////////////////////////////////////////////////
+void RayAggregator::end_of_chunk()
+{
+  for (std::size_t idx = 0U; idx < m_rays.size(); ++idx) {
+    // Rays that the sensor moved past are complete.
+    if ((RayState::NOT_READY == m_ray_state[idx]) && (!m_rays[idx].empty()) &&
+      (m_ray_last_chunk[idx] != m_chunk_idx))
+    {
+      m_ray_state[idx] = RayState::READY;
+      const std::size_t jdx = (m_ready_start_idx + m_num_ready) % m_ready_indices.size();
+      m_ready_indices[jdx] = idx;
+      ++m_num_ready;
+    }
+  }
+  ++m_chunk_idx;
+}
+////////////////////////////////////////////////////////////////////////////////
+std::size_t RayAggregator::get_oldest_pending_chunk() const
+{
+  std::size_t oldest = m_chunk_idx;
+  for (std::size_t idx = 0U; idx < m_rays.size(); ++idx) {
+    if ((RayState::RESET != m_ray_state[idx]) && (!m_rays[idx].empty())) {
+      oldest = std::min(oldest, m_ray_first_chunk[idx]);
+    }
+  }
+  return oldest;
 }
 ////////////////////////////////////////////////////////////////////////////////
 bool8_t RayAggregator::insert(const PointXYZIFR & pt)
@@ -144,6 +182,10 @@ bool8_t RayAggregator::insert(const PointXYZIFR & pt)
     if (ray.size() >= ray.capacity()) {
       throw std::runtime_error("RayAggregator: Ray capacity overrun! Use smaller bins");
     }
+    if (ray.empty()) {
+      m_ray_first_chunk[idx] = m_chunk_idx;
+    }
+    m_ray_last_chunk[idx] = m_chunk_idx;
     // insert point to ray, do some presorting
     ray.push_back(pt);
     // TODO(c.ho) get push_heap working to amortize sorting burden
@@ -191,6 +233,11 @@ std::size_t RayAggregator::get_ready_ray_count() const
   return m_num_ready;
 }
 ////////////////////////////////////////////////////////////////////////////////
+std::size_t RayAggregator::get_num_rays() const
+{
+  return m_rays.size();
+}
+////////////////////////////////////////////////////////////////////////////////
 const Ray & RayAggregator::get_next_ray()
 {
   // move the if out from the sequential section by nullifying the operations if false
@@ -207,7 +254,14 @@ const Ray & RayAggregator::get_next_ray()
 
   Ray & ret = m_rays[idx];
   // Sort ray
-  std::sort(ret.begin(), ret.end());
+  if (SortMode::INSERTION == m_cfg.get_sort_mode()) {
+    for (auto it = ret.begin(); it != ret.end(); ++it) {
+      // Stable: a point goes behind all points that are not larger
+      (void)std::rotate(std::upper_bound(ret.begin(), it, *it), it, it + 1);
+    }
+  } else {
+    std::sort(ret.begin(), ret.end());
+  }
   // ready to be reset on next insertion to this item
   m_ray_state[idx] = RayState::RESET;
 
@@ -0,0 +1,199 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#include <common/types.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "ray_ground_classifier/grid_ground_classifier.hpp"
+
+using autoware::common::types::PointPtrBlock;
+using autoware::common::types::PointXYZIF;
+using autoware::common::types::float32_t;
+using autoware::perception::filters::ray_ground_classifier::GridGroundClassifier;
+
+namespace
+{
+constexpr float32_t SENSOR_HEIGHT = 2.0F;
+
+GridGroundClassifier::Config make_config()
+{
+  return GridGroundClassifier::Config{SENSOR_HEIGHT, 180U, 100U, 50.0F, 10.0F, 0.15F, 0.2F};
+}
+
+PointXYZIF make_point(const float32_t x, const float32_t y, const float32_t z)
+{
+  PointXYZIF pt;
+  pt.x = x;
+  pt.y = y;
+  pt.z = z;
+  return pt;
+}
+
+/// Points on a ground rising along x with a slope, on rings around the sensor like the returns
+/// of a lidar
+std::vector<PointXYZIF> make_ground(const float32_t slope, const float32_t radius)
+{
+  std::vector<PointXYZIF> points;
+  for (auto range = 0.25F; range < radius; range += 0.25F) {
+    for (auto azimuth_deg = 0; azimuth_deg < 360; ++azimuth_deg) {
+      const auto azimuth = static_cast<float32_t>(azimuth_deg) * 0.0174533F;
+      const auto x = range * cosf(azimuth);
+      points.push_back(make_point(x, range * sinf(azimuth), (slope * x) - SENSOR_HEIGHT));
+    }
+  }
+  return points;
+}
+
+/// Points on the faces of a box standing on the flat ground
+void add_box(
+  std::vector<PointXYZIF> & points, const float32_t x_min, const float32_t x_max,
+  const float32_t y_min, const float32_t y_max, const float32_t height)
+{
+  for (auto z = 0.3F; z < height; z += 0.1F) {
+    for (auto s = 0.0F; s <= 1.0F; s += 0.05F) {
+      points.push_back(make_point(x_min + (s * (x_max - x_min)), y_min, z - SENSOR_HEIGHT));
+      points.push_back(make_point(x_min, y_min + (s * (y_max - y_min)), z - SENSOR_HEIGHT));
+      points.push_back(make_point(x_max, y_min + (s * (y_max - y_min)), z - SENSOR_HEIGHT));
+    }
+  }
+}
+
+std::size_t count_below(const PointPtrBlock & block, const float32_t z)
+{
+  return static_cast<std::size_t>(std::count_if(
+           block.begin(), block.end(), [z](const PointXYZIF * pt) {return pt->z < z;}));
+}
+}  // namespace
+
+TEST(grid_ground_classifier, bad_config) {
+  EXPECT_THROW(
+    GridGroundClassifier::Config(SENSOR_HEIGHT, 0U, 100U, 50.0F, 10.0F, 0.15F, 0.2F),
+    std::runtime_error);
+  EXPECT_THROW(
+    GridGroundClassifier::Config(SENSOR_HEIGHT, 180U, 0U, 50.0F, 10.0F, 0.15F, 0.2F),
+    std::runtime_error);
+  EXPECT_THROW(
+    GridGroundClassifier::Config(SENSOR_HEIGHT, 180U, 100U, 0.0F, 10.0F, 0.15F, 0.2F),
+    std::runtime_error);
+  EXPECT_THROW(
+    GridGroundClassifier::Config(SENSOR_HEIGHT, 180U, 100U, 50.0F, 90.0F, 0.15F, 0.2F),
+    std::runtime_error);
+  EXPECT_THROW(
+    GridGroundClassifier::Config(SENSOR_HEIGHT, 180U, 100U, 50.0F, 10.0F, 0.15F, -0.2F),
+    std::runtime_error);
+
+  GridGroundClassifier classifier{make_config(), 1U};
+  const auto pt = make_point(1.0F, 0.0F, 0.0F);
+  classifier.insert(&pt);
+  EXPECT_THROW(classifier.insert(&pt), std::runtime_error);
+  EXPECT_THROW(classifier.estimate_ground(0U, 181U), std::out_of_range);
+  EXPECT_THROW(classifier.smooth_ground(2U, 1U), std::out_of_range);
+  EXPECT_THROW(classifier.get_cell(0U, 100U), std::out_of_range);
+}
+
+TEST(grid_ground_classifier, flat_ground_with_obstacles) {
+  auto points = make_ground(0.0F, 40.0F);
+  const auto num_ground = points.size();
+  add_box(points, 10.0F, 14.0F, -1.0F, 1.0F, 1.5F);
+  add_box(points, -20.0F, -18.0F, 5.0F, 9.0F, 3.0F);
+  // Beyond the grid
+  points.push_back(make_point(60.0F, 0.0F, -SENSOR_HEIGHT));
+
+  GridGroundClassifier classifier{make_config(), points.size()};
+  for (const auto & pt : points) {
+    classifier.insert(&pt);
+  }
+  PointPtrBlock ground;
+  PointPtrBlock nonground;
+  classifier.partition(ground, nonground);
+  EXPECT_EQ(ground.size(), num_ground);
+  EXPECT_EQ(nonground.size(), points.size() - num_ground);
+  EXPECT_EQ(count_below(ground, 0.25F - SENSOR_HEIGHT), ground.size());
+  EXPECT_EQ(nonground.back(), &points.back());
+
+  // The elevation of the cell at the front face of the first box
+  const auto & cell = classifier.get_cell(90U, 20U);
+  EXPECT_FLOAT_EQ(cell.min_z, -SENSOR_HEIGHT);
+  EXPECT_GT(cell.max_z, 1.0F - SENSOR_HEIGHT);
+  EXPECT_FLOAT_EQ(cell.ground_z, -SENSOR_HEIGHT);
+
+  // A cloud in a different order gives the same labels
+  std::vector<const PointXYZIF *> shuffled;
+  for (const auto & pt : points) {
+    shuffled.push_back(&pt);
+  }
+  std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937{42U});
+  classifier.reset();
+  for (const auto pt : shuffled) {
+    classifier.insert(pt);
+  }
+  PointPtrBlock shuffled_ground;
+  PointPtrBlock shuffled_nonground;
+  classifier.partition(shuffled_ground, shuffled_nonground);
+  std::sort(ground.begin(), ground.end());
+  std::sort(shuffled_ground.begin(), shuffled_ground.end());
+  EXPECT_EQ(ground, shuffled_ground);
+}
+
+TEST(grid_ground_classifier, slope) {
+  // A ramp of 7% is ground everywhere, even 40m away where it is 2.8m above the sensor ground
+  auto points = make_ground(0.07F, 40.0F);
+  const auto num_ground = points.size();
+  // A wall on top of the ramp
+  for (auto z = 0.5F; z < 3.0F; z += 0.1F) {
+    for (auto y = -5.0F; y < 5.0F; y += 0.2F) {
+      points.push_back(make_point(30.0F, y, (0.07F * 30.0F) + z - SENSOR_HEIGHT));
+    }
+  }
+  GridGroundClassifier classifier{make_config(), points.size()};
+  for (const auto & pt : points) {
+    classifier.insert(&pt);
+  }
+  PointPtrBlock ground;
+  PointPtrBlock nonground;
+  classifier.partition(ground, nonground);
+  EXPECT_EQ(ground.size(), num_ground);
+  EXPECT_EQ(nonground.size(), points.size() - num_ground);
+}
+
+TEST(grid_ground_classifier, sector_ranges) {
+  auto points = make_ground(0.03F, 45.0F);
+  add_box(points, 10.0F, 14.0F, -1.0F, 1.0F, 1.5F);
+  GridGroundClassifier classifier{make_config(), points.size()};
+  for (const auto & pt : points) {
+    classifier.insert(&pt);
+  }
+  PointPtrBlock ground;
+  PointPtrBlock nonground;
+  classifier.partition(ground, nonground);
+
+  // The sectors can be processed in disjoint ranges, e.g. by different threads
+  classifier.estimate_ground(100U, 180U);
+  classifier.estimate_ground(0U, 100U);
+  classifier.smooth_ground(0U, 45U);
+  classifier.smooth_ground(45U, 180U);
+  PointPtrBlock split_ground;
+  PointPtrBlock split_nonground;
+  classifier.label(split_ground, split_nonground);
+  EXPECT_EQ(ground, split_ground);
+  EXPECT_EQ(nonground, split_nonground);
+}
@@ -18,6 +18,10 @@
 #include <ray_ground_classifier/ray_aggregator.hpp>
 #include <ray_ground_classifier/ray_ground_point_classifier.hpp>
 #include <common/types.hpp>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iostream>
 #include <vector>
 
 using autoware::common::types::PointXYZIF;
@@ -59,6 +63,7 @@ TEST(ray_aggregator, basic) {
   RayAggregator::Config cfg{-3.14159F, 3.14159F, 0.1F, min_ray_points};
   RayAggregator agg{cfg};
   EXPECT_EQ(min_ray_points, cfg.get_min_ray_points());
+  EXPECT_EQ(cfg.get_num_rays(), agg.get_num_rays());
   // Do this twice, expect same result to exercise internal reset logic
   for (uint32_t jdx = 0U; jdx < 3U; ++jdx) {
     // insert points along one ray
@@ -332,3 +337,123 @@ TEST(ray_aggregator, reset_bug) {
     check_one_ray_fn(pts);
   }
 }
+
+// Rays that get no points in a chunk are ready, and the chunks they reference are tracked
+TEST(ray_aggregator, chunks) {
+  RayAggregator::Config cfg{-3.14159F, 3.14159F, 0.1F, 10};
+  RayAggregator agg{cfg};
+  EXPECT_EQ(agg.get_oldest_pending_chunk(), 0U);
+
+  // Two points along 0 deg, one point along 90 deg
+  std::array<PointXYZIF, 3U> chunk0;
+  chunk0[0U].x = 1.0F; chunk0[0U].y = 0.01F;
+  chunk0[1U].x = 2.0F; chunk0[1U].y = 0.02F;
+  chunk0[2U].x = 0.01F; chunk0[2U].y = 1.0F;
+  EXPECT_TRUE(agg.insert(chunk0.cbegin(), chunk0.cend()));
+  agg.end_of_chunk();
+  // Both rays just got points, so they may not be complete yet
+  EXPECT_FALSE(agg.is_ray_ready());
+  EXPECT_EQ(agg.get_oldest_pending_chunk(), 0U);
+
+  // Only the ray along 90 deg continues
+  std::array<PointXYZIF, 1U> chunk1;
+  chunk1[0U].x = 0.02F; chunk1[0U].y = 2.0F;
+  EXPECT_TRUE(agg.insert(chunk1.cbegin(), chunk1.cend()));
+  agg.end_of_chunk();
+  ASSERT_EQ(agg.get_ready_ray_count(), 1U);
+  const auto & ray = agg.get_next_ray();
+  EXPECT_EQ(ray.size(), 2U);
+  EXPECT_EQ(ray[0U].get_point_pointer(), &chunk0[0U]);
+  // The ray along 90 deg still has points of the first chunk
+  EXPECT_EQ(agg.get_oldest_pending_chunk(), 0U);
+
+  agg.end_of_chunk();
+  ASSERT_EQ(agg.get_ready_ray_count(), 1U);
+  EXPECT_EQ(agg.get_next_ray().size(), 2U);
+  EXPECT_FALSE(agg.is_ray_ready());
+  // Nothing is pending anymore
+  EXPECT_EQ(agg.get_oldest_pending_chunk(), 3U);
+
+  // A new point along 0 deg starts a new ray in the current chunk
+  std::array<PointXYZIF, 1U> chunk3;
+  chunk3[0U].x = 3.0F; chunk3[0U].y = 0.03F;
+  EXPECT_TRUE(agg.insert(chunk3.cbegin(), chunk3.cend()));
+  EXPECT_EQ(agg.get_oldest_pending_chunk(), 3U);
+  agg.end_of_scan();
+  ASSERT_EQ(agg.get_ready_ray_count(), 1U);
+  EXPECT_EQ(agg.get_next_ray().size(), 1U);
+  EXPECT_EQ(agg.get_oldest_pending_chunk(), 4U);
+}
+
+// Both sort modes give the same rays; prints the runtime of both on a simulated VLP16 scan
+TEST(ray_aggregator, sort_modes) {
+  // 16 lasers in firing order, 2 degrees apart, 1800 firings per rotation
+  const std::array<int32_t, 16U> elevation_deg{
+    -15, 1, -13, 3, -11, 5, -9, 7, -7, 9, -5, 11, -3, 13, -1, 15};
+  const uint32_t num_firings = 1800U;
+  std::vector<PointXYZIF> points;
+  points.reserve(num_firings * elevation_deg.size());
+  for (uint32_t idx = 0U; idx < num_firings; ++idx) {
+    const float32_t azimuth = (static_cast<float32_t>(idx) * 6.28318F) /
+      static_cast<float32_t>(num_firings);
+    for (const auto deg : elevation_deg) {
+      const float32_t elevation = static_cast<float32_t>(deg) * 3.14159F / 180.0F;
+      // Flat ground 1.8m below the sensor, or a wall 30m away
+      float32_t range = 30.0F / cosf(elevation);
+      if (elevation < 0.0F) {
+        range = std::min(range, -1.8F / sinf(elevation));
+      }
+      PointXYZIF pt;
+      pt.x = range * cosf(elevation) * cosf(azimuth);
+      pt.y = range * cosf(elevation) * sinf(azimuth);
+      pt.z = range * sinf(elevation);
+      pt.id = static_cast<uint16_t>(idx);
+      points.push_back(pt);
+    }
+  }
+
+  const auto run = [&points](RayAggregator & agg, std::vector<Ray> & rays) {
+      rays.clear();
+      EXPECT_TRUE(agg.insert(points.data(), points.data() + points.size()));
+      agg.end_of_scan();
+      while (agg.is_ray_ready()) {
+        rays.push_back(agg.get_next_ray());
+      }
+    };
+  RayAggregator comparison_agg{RayAggregator::Config{-3.14159F, 3.14159F, 0.01F, 512U}};
+  RayAggregator insertion_agg{RayAggregator::Config{-3.14159F, 3.14159F, 0.01F, 512U,
+      RayAggregator::SortMode::INSERTION}};
+  EXPECT_EQ(insertion_agg.get_num_rays(), comparison_agg.get_num_rays());
+  std::vector<Ray> comparison_rays;
+  std::vector<Ray> insertion_rays;
+  run(comparison_agg, comparison_rays);
+  run(insertion_agg, insertion_rays);
+  ASSERT_EQ(comparison_rays.size(), insertion_rays.size());
+  ASSERT_GT(comparison_rays.size(), 0U);
+  for (std::size_t idx = 0U; idx < comparison_rays.size(); ++idx) {
+    const auto & comparison_ray = comparison_rays[idx];
+    const auto & insertion_ray = insertion_rays[idx];
+    ASSERT_EQ(comparison_ray.size(), insertion_ray.size());
+    for (std::size_t jdx = 0U; jdx < comparison_ray.size(); ++jdx) {
+      if (jdx > 0U) {
+        EXPECT_FALSE(insertion_ray[jdx] < insertion_ray[jdx - 1U]);
+      }
+      EXPECT_FLOAT_EQ(comparison_ray[jdx].get_r(), insertion_ray[jdx].get_r());
+      EXPECT_FLOAT_EQ(comparison_ray[jdx].get_z(), insertion_ray[jdx].get_z());
+    }
+  }
+
+  const auto time = [&run](RayAggregator & agg, std::vector<Ray> & rays) {
+      constexpr uint32_t num_iter = 20U;
+      const auto start = std::chrono::steady_clock::now();
+      for (uint32_t iter = 0U; iter < num_iter; ++iter) {
+        run(agg, rays);
+      }
+      const auto diff = std::chrono::steady_clock::now() - start;
+      return static_cast<float32_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(diff).count()) /
+             (1000.0F * static_cast<float32_t>(num_iter));
+    };
+  std::cout << "Comparison sort,\truntime = " << time(comparison_agg, comparison_rays) << "ms\n";
+  std::cout << "Insertion sort,\truntime = " << time(insertion_agg, insertion_rays) << "ms\n";
+}
@@ -0,0 +1,147 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+/// \file
+/// \brief This file defines a helper that partitions the ready rays of an aggregator on a pool of
+///        threads
+
+#ifndef RAY_GROUND_CLASSIFIER_NODES__PARALLEL_RAY_PARTITIONER_HPP_
+#define RAY_GROUND_CLASSIFIER_NODES__PARALLEL_RAY_PARTITIONER_HPP_
+
+#include <common/types.hpp>
+#include <ray_ground_classifier_nodes/visibility_control.hpp>
+#include <ray_ground_classifier/ray_aggregator.hpp>
+#include <ray_ground_classifier/ray_ground_classifier.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace autoware
+{
+namespace perception
+{
+namespace filters
+{
+namespace ray_ground_classifier_nodes
+{
+using autoware::common::types::bool8_t;
+using autoware::common::types::PointPtrBlock;
+
+/// \brief Partitions the ready rays of a RayAggregator on a fixed pool of threads. Each thread
+///        owns a copy of the classifier and a contiguous range of the rays. The ground and
+///        nonground counts of the threads are prefix summed, so every thread then writes its
+///        points into its own range of the output clouds. The output is the same as partitioning
+///        the rays one after the other. Nothing is allocated after construction.
+class RAY_GROUND_CLASSIFIER_NODES_PUBLIC ParallelRayPartitioner
+{
+public:
+  using PointCloud2 = sensor_msgs::msg::PointCloud2;
+
+  /// \brief Constructor, starts the threads
+  /// \param[in] classifier Classifier that every thread gets a copy of
+  /// \param[in] num_threads Number of threads including the calling thread, which always
+  ///                        takes part in the work
+  /// \param[in] max_rays Maximum number of rays that are ready at once, e.g. the number of rays
+  ///                     of the aggregator
+  /// \param[in] cloud_capacity Capacity of the output clouds in points
+  /// \throw std::domain_error If the number of threads is 0
+  ParallelRayPartitioner(
+    const ray_ground_classifier::RayGroundClassifier & classifier,
+    std::size_t num_threads,
+    std::size_t max_rays,
+    std::size_t cloud_capacity);
+  /// \brief Destructor, stops and joins the threads
+  ~ParallelRayPartitioner();
+
+  ParallelRayPartitioner(const ParallelRayPartitioner &) = delete;
+  ParallelRayPartitioner & operator=(const ParallelRayPartitioner &) = delete;
+
+  /// \brief Partition all ready rays of the aggregator and append them to the output clouds
+  /// \param[inout] aggregator Aggregator to take the ready rays from
+  /// \param[inout] ground_msg Cloud that the ground points are written to
+  /// \param[inout] ground_idx Index of the next ground point, advanced by the number of points
+  /// \param[inout] nonground_msg Cloud that the nonground points are written to
+  /// \param[inout] nonground_idx Index of the next nonground point, advanced by the number of
+  ///                             points
+  /// \throw std::runtime_error If an output cloud is full or a ray can't be partitioned, in
+  ///                           which case no point is written
+  void partition(
+    ray_ground_classifier::RayAggregator & aggregator,
+    PointCloud2 & ground_msg,
+    uint32_t & ground_idx,
+    PointCloud2 & nonground_msg,
+    uint32_t & nonground_idx);
+
+  /// \brief Get the number of threads including the calling thread
+  std::size_t get_num_threads() const;
+
+private:
+  enum class Phase
+  {
+    CLASSIFY,
+    WRITE
+  };  // enum class Phase
+
+  struct Worker
+  {
+    explicit Worker(
+      const ray_ground_classifier::RayGroundClassifier & classifier,
+      std::size_t cloud_capacity);
+    ray_ground_classifier::RayGroundClassifier classifier;
+    // Output of a single ray
+    PointPtrBlock ray_ground;
+    PointPtrBlock ray_nonground;
+    // Output of all rays of the worker, in the order of the rays
+    PointPtrBlock ground;
+    PointPtrBlock nonground;
+    // Index of the first point of the worker in the output clouds
+    uint32_t ground_offset;
+    uint32_t nonground_offset;
+    bool8_t failed;
+    bool8_t overrun;
+  };  // struct Worker
+
+  /// \brief Run all workers for one phase and wait until they are done
+  RAY_GROUND_CLASSIFIER_NODES_LOCAL void run_phase(Phase phase);
+  /// \brief Do the work of one worker in the current phase
+  RAY_GROUND_CLASSIFIER_NODES_LOCAL void work(std::size_t worker_idx);
+  /// \brief Loop of the pool threads
+  RAY_GROUND_CLASSIFIER_NODES_LOCAL void thread_loop(std::size_t worker_idx);
+
+  std::vector<Worker> m_workers;
+  std::vector<const ray_ground_classifier::Ray *> m_rays;
+  const std::size_t m_cloud_capacity;
+  // State of the current call, only valid during partition()
+  PointCloud2 * m_ground_msg;
+  PointCloud2 * m_nonground_msg;
+  Phase m_phase;
+  // Synchronization with the pool threads
+  std::mutex m_mutex;
+  std::condition_variable m_start_cv;
+  std::condition_variable m_done_cv;
+  std::size_t m_generation;
+  std::size_t m_num_busy;
+  bool8_t m_stop;
+  std::vector<std::thread> m_threads;
+};  // class ParallelRayPartitioner
+}  // namespace ray_ground_classifier_nodes
+}  // namespace filters
+}  // namespace perception
+}  // namespace autoware
+#endif  // RAY_GROUND_CLASSIFIER_NODES__PARALLEL_RAY_PARTITIONER_HPP_
@@ -21,11 +21,15 @@
 #define RAY_GROUND_CLASSIFIER_NODES__RAY_GROUND_CLASSIFIER_CLOUD_NODE_HPP_
 
 #include <common/types.hpp>
+#include <latency_tracing/tracer.hpp>
 #include <lidar_utils/point_cloud_utils.hpp>
+#include <ray_ground_classifier_nodes/parallel_ray_partitioner.hpp>
 #include <ray_ground_classifier_nodes/visibility_control.hpp>
+#include <ray_ground_classifier/grid_ground_classifier.hpp>
 #include <ray_ground_classifier/ray_aggregator.hpp>
 #include <ray_ground_classifier/ray_ground_classifier.hpp>
 #include <rclcpp/rclcpp.hpp>
+#include <rt_memory/allocation_diagnostics.hpp>
 #include <sensor_msgs/msg/point_cloud2.hpp>
 
 #include <memory>
@@ -60,9 +64,45 @@ public:
 private:
   /// \brief Resets state of ray aggregator and messages
   RAY_GROUND_CLASSIFIER_NODES_LOCAL void reset();
+  /// \brief Check the frame and the layout of an input cloud
+  /// \throw std::runtime_error if the cloud is malformed or from an unexpected frame
+  RAY_GROUND_CLASSIFIER_NODES_LOCAL void validate(const PointCloud2 & msg);
+  /// \brief Partition all ready rays of the aggregator into the output clouds
+  /// \throw std::runtime_error if an output cloud is full
+  RAY_GROUND_CLASSIFIER_NODES_LOCAL void partition_ready_rays();
+  /// \brief Structured mode: partition a cloud with the layout of PointXYZIF, where
+  ///        consecutive points with the same id form a ray, e.g. a firing of a Velodyne
+  /// \throw std::runtime_error if an output cloud is full
+  RAY_GROUND_CLASSIFIER_NODES_LOCAL void partition_structured(const PointCloud2 & msg);
+  /// \brief Grid mode: partition a whole cloud on the elevation grid of m_grid_classifier,
+  ///        regardless of the order of its points
+  /// \throw std::runtime_error if the cloud exceeds pcl_size or an output cloud is full
+  RAY_GROUND_CLASSIFIER_NODES_LOCAL void partition_grid(const PointCloud2 & msg);
+  /// \brief Partition the points in m_ray_block as one ray into the output clouds
+  /// \throw std::runtime_error if an output cloud is full
+  RAY_GROUND_CLASSIFIER_NODES_LOCAL void partition_ray_block();
+  /// \brief Add partitioned points to the output clouds
+  /// \throw std::runtime_error if an output cloud is full
+  RAY_GROUND_CLASSIFIER_NODES_LOCAL void add_to_clouds(
+    const PointPtrBlock & ground_blk,
+    const PointPtrBlock & nonground_blk);
+  /// \brief Resize the output clouds down to their actual sizes and publish them
+  RAY_GROUND_CLASSIFIER_NODES_LOCAL void publish_clouds();
+  /// \brief Streaming mode: insert a part of a scan, then partition and publish the rays that
+  ///        the sensor moved past. The chunks are kept as long as pending rays point into them.
+  RAY_GROUND_CLASSIFIER_NODES_LOCAL void chunk_callback(const PointCloud2::ConstSharedPtr msg);
   // Algorithmic core
   ray_ground_classifier::RayGroundClassifier m_classifier;
   ray_ground_classifier::RayAggregator m_aggregator;
+  // Only set if the grid engine is selected, see partition_grid()
+  std::unique_ptr<ray_ground_classifier::GridGroundClassifier> m_grid_classifier;
+  // Only set if the rays are partitioned by more than one thread
+  std::unique_ptr<ParallelRayPartitioner> m_partitioner;
+  // Structured mode, see partition_structured()
+  const bool8_t m_is_structured;
+  PointPtrBlock m_ray_block;
+  PointPtrBlock m_ground_block;
+  PointPtrBlock m_nonground_block;
   // preallocated message
   PointCloud2 m_ground_msg;
   PointCloud2 m_nonground_msg;
@@ -70,15 +110,28 @@ private:
   const std::string m_frame_id;
   // Basic stateful stuff, will get refactored after we have a proper state machine implementation
   bool8_t m_has_failed;
+  // Streaming mode, see chunk_callback()
+  const bool8_t m_streaming;
+  const std::size_t m_max_chunks;
+  std::vector<PointCloud2::ConstSharedPtr> m_chunks;
+  // index of the first kept chunk in the count of the aggregator
+  std::size_t m_first_chunk_idx;
   // publishers and subscribers
   const std::chrono::nanoseconds m_timeout;
   const rclcpp::Subscription<PointCloud2>::SharedPtr m_raw_sub_ptr;
   const std::shared_ptr<rclcpp::Publisher<PointCloud2>> m_ground_pub_ptr;
   const std::shared_ptr<rclcpp::Publisher<PointCloud2>> m_nonground_pub_ptr;
   /// \brief Read samples from the subscription
-  void callback(const PointCloud2::SharedPtr msg);
+  void callback(const PointCloud2::ConstSharedPtr msg);
   uint32_t m_ground_pc_idx;
   uint32_t m_nonground_pc_idx;
+  // If true, the clouds are published as unique pointers for intra-process subscribers
+  const bool8_t m_use_intra_process;
+  /// The stage of the node in the latency traces of the clouds
+  const autoware::common::latency_tracing::StageId m_trace_stage;
+  /// Heap allocations of the cloud callbacks, published if `allocation_profiling.enabled` is set
+  autoware::common::rt_memory::AllocationDiagnostics m_allocation_diagnostics;
+  const autoware::common::rt_memory::CallbackId m_callback_allocations;
 };  // class RayGroundFilterDriverNode
 }  // namespace ray_ground_classifier_nodes
 }  // namespace filters
@@ -0,0 +1,245 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+#include <lidar_utils/point_cloud_utils.hpp>
+#include <ray_ground_classifier_nodes/parallel_ray_partitioner.hpp>
+
+#include <stdexcept>
+
+namespace autoware
+{
+namespace perception
+{
+namespace filters
+{
+namespace ray_ground_classifier_nodes
+{
+////////////////////////////////////////////////////////////////////////////////
+using autoware::common::lidar_utils::add_point_to_cloud_raw;
+using autoware::common::types::POINT_BLOCK_CAPACITY;
+
+ParallelRayPartitioner::Worker::Worker(
+  const ray_ground_classifier::RayGroundClassifier & classifier,
+  const std::size_t cloud_capacity)
+: classifier(classifier),
+  ray_ground(POINT_BLOCK_CAPACITY),
+  ray_nonground(POINT_BLOCK_CAPACITY),
+  ground(cloud_capacity),
+  nonground(cloud_capacity),
+  ground_offset{0U},
+  nonground_offset{0U},
+  failed{false},
+  overrun{false}
+{
+  // capacity unchanged
+  ray_ground.clear();
+  ray_nonground.clear();
+  ground.clear();
+  nonground.clear();
+}
+////////////////////////////////////////////////////////////////////////////////
+ParallelRayPartitioner::ParallelRayPartitioner(
+  const ray_ground_classifier::RayGroundClassifier & classifier,
+  const std::size_t num_threads,
+  const std::size_t max_rays,
+  const std::size_t cloud_capacity)
+: m_cloud_capacity{cloud_capacity},
+  m_ground_msg{nullptr},
+  m_nonground_msg{nullptr},
+  m_phase{Phase::CLASSIFY},
+  m_generation{0U},
+  m_num_busy{0U},
+  m_stop{false}
+{
+  if (num_threads == 0U) {
+    throw std::domain_error("ParallelRayPartitioner: Number of threads must be positive");
+  }
+  m_rays.reserve(max_rays);
+  m_workers.reserve(num_threads);
+  for (std::size_t idx = 0U; idx < num_threads; ++idx) {
+    m_workers.emplace_back(classifier, cloud_capacity);
+  }
+  // The calling thread is worker 0
+  m_threads.reserve(num_threads - 1U);
+  for (std::size_t idx = 1U; idx < num_threads; ++idx) {
+    m_threads.emplace_back(&ParallelRayPartitioner::thread_loop, this, idx);
+  }
+}
+////////////////////////////////////////////////////////////////////////////////
+ParallelRayPartitioner::~ParallelRayPartitioner()
+{
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_stop = true;
+  }
+  m_start_cv.notify_all();
+  for (auto & thread : m_threads) {
+    thread.join();
+  }
+}
+////////////////////////////////////////////////////////////////////////////////
+void ParallelRayPartitioner::partition(
+  ray_ground_classifier::RayAggregator & aggregator,
+  PointCloud2 & ground_msg,
+  uint32_t & ground_idx,
+  PointCloud2 & nonground_msg,
+  uint32_t & nonground_idx)
+{
+  // Taking the rays sorts them, so it stays sequential
+  m_rays.clear();
+  while (aggregator.is_ray_ready()) {
+    if (m_rays.size() >= m_rays.capacity()) {
+      throw std::runtime_error("ParallelRayPartitioner: More ready rays than expected");
+    }
+    m_rays.push_back(&aggregator.get_next_ray());
+  }
+  if (m_rays.empty()) {
+    return;
+  }
+  run_phase(Phase::CLASSIFY);
+
+  // Prefix sum of the counts of the workers
+  std::size_t ground_offset = ground_idx;
+  std::size_t nonground_offset = nonground_idx;
+  for (auto & worker : m_workers) {
+    if (worker.failed) {
+      throw std::runtime_error("ParallelRayPartitioner: Failed to partition a ray");
+    }
+    if (worker.overrun) {
+      throw std::runtime_error("ParallelRayPartitioner: Overran output msg point capacity");
+    }
+    worker.ground_offset = static_cast<uint32_t>(ground_offset);
+    worker.nonground_offset = static_cast<uint32_t>(nonground_offset);
+    ground_offset += worker.ground.size();
+    nonground_offset += worker.nonground.size();
+  }
+  if (ground_offset > m_cloud_capacity) {
+    throw std::runtime_error("RayGroundClassifierNode: Overran ground msg point capacity");
+  }
+  if (nonground_offset > m_cloud_capacity) {
+    throw std::runtime_error("RayGroundClassifierNode: Overran nonground msg point capacity");
+  }
+
+  m_ground_msg = &ground_msg;
+  m_nonground_msg = &nonground_msg;
+  run_phase(Phase::WRITE);
+  m_ground_msg = nullptr;
+  m_nonground_msg = nullptr;
+  for (const auto & worker : m_workers) {
+    if (worker.failed) {
+      throw std::runtime_error("ParallelRayPartitioner: Output cloud smaller than its capacity");
+    }
+  }
+  ground_idx = static_cast<uint32_t>(ground_offset);
+  nonground_idx = static_cast<uint32_t>(nonground_offset);
+}
+////////////////////////////////////////////////////////////////////////////////
+std::size_t ParallelRayPartitioner::get_num_threads() const
+{
+  return m_workers.size();
+}
+////////////////////////////////////////////////////////////////////////////////
+void ParallelRayPartitioner::run_phase(const Phase phase)
+{
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_phase = phase;
+    m_num_busy = m_threads.size();
+    ++m_generation;
+  }
+  m_start_cv.notify_all();
+  work(0U);
+  std::unique_lock<std::mutex> lock{m_mutex};
+  m_done_cv.wait(lock, [this] {return m_num_busy == 0U;});
+}
+////////////////////////////////////////////////////////////////////////////////
+void ParallelRayPartitioner::work(const std::size_t worker_idx)
+{
+  Worker & worker = m_workers[worker_idx];
+  if (Phase::CLASSIFY == m_phase) {
+    worker.ground.clear();
+    worker.nonground.clear();
+    worker.failed = false;
+    worker.overrun = false;
+    // Contiguous range of rays, so the order of the output matches the order of the rays
+    const std::size_t begin = (m_rays.size() * worker_idx) / m_workers.size();
+    const std::size_t end = (m_rays.size() * (worker_idx + 1U)) / m_workers.size();
+    try {
+      for (std::size_t idx = begin; idx < end; ++idx) {
+        worker.ray_ground.clear();
+        worker.ray_nonground.clear();
+        worker.classifier.partition(*m_rays[idx], worker.ray_ground, worker.ray_nonground);
+        if ((worker.ground.size() + worker.ray_ground.size() > m_cloud_capacity) ||
+          (worker.nonground.size() + worker.ray_nonground.size() > m_cloud_capacity))
+        {
+          // The offsets are not negative, so the output clouds would overrun too
+          worker.overrun = true;
+          break;
+        }
+        (void)worker.ground.insert(
+          worker.ground.end(), worker.ray_ground.begin(), worker.ray_ground.end());
+        (void)worker.nonground.insert(
+          worker.nonground.end(), worker.ray_nonground.begin(), worker.ray_nonground.end());
+      }
+    } catch (const std::exception &) {
+      worker.failed = true;
+    }
+  } else {
+    for (std::size_t idx = 0U; idx < worker.ground.size(); ++idx) {
+      if (!add_point_to_cloud_raw(
+          *m_ground_msg, *worker.ground[idx], worker.ground_offset + static_cast<uint32_t>(idx)))
+      {
+        worker.failed = true;
+      }
+    }
+    for (std::size_t idx = 0U; idx < worker.nonground.size(); ++idx) {
+      if (!add_point_to_cloud_raw(
+          *m_nonground_msg, *worker.nonground[idx],
+          worker.nonground_offset + static_cast<uint32_t>(idx)))
+      {
+        worker.failed = true;
+      }
+    }
+  }
+}
+////////////////////////////////////////////////////////////////////////////////
+void ParallelRayPartitioner::thread_loop(const std::size_t worker_idx)
+{
+  std::size_t generation = 0U;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock{m_mutex};
+      m_start_cv.wait(lock, [this, generation] {return m_stop || (m_generation != generation);});
+      if (m_stop) {
+        return;
+      }
+      generation = m_generation;
+    }
+    work(worker_idx);
+    bool8_t is_last = false;
+    {
+      std::lock_guard<std::mutex> lock{m_mutex};
+      --m_num_busy;
+      is_last = (m_num_busy == 0U);
+    }
+    if (is_last) {
+      m_done_cv.notify_one();
+    }
+  }
+}
+}  // namespace ray_ground_classifier_nodes
+}  // namespace filters
+}  // namespace perception
+}  // namespace autoware
@@ -20,7 +20,10 @@
 #include <rclcpp_components/register_node_macro.hpp>
 #include <stdlib.h>
 
+#include <algorithm>
+#include <cstddef>
 #include <limits>
+#include <memory>
 #include <string>
 
 namespace autoware
@@ -34,12 +37,15 @@ namespace ray_ground_classifier_nodes
 ////////////////////////////////////////////////////////////////////////////////
 using autoware::common::types::PointXYZIF;
 using autoware::common::types::float32_t;
+using autoware::common::types::POINT_BLOCK_CAPACITY;
 using autoware::perception::filters::ray_ground_classifier::PointPtrBlock;
 
 using std::placeholders::_1;
 
 using autoware::common::lidar_utils::has_intensity_and_throw_if_no_xyz;
+using autoware::common::lidar_utils::has_pointxyzif_layout;
 using autoware::common::lidar_utils::init_pcl_msg;
+using autoware::common::lidar_utils::release_pcl_msg;
 using autoware::common::lidar_utils::add_point_to_cloud_raw;
 
 RayGroundClassifierCloudNode::RayGroundClassifierCloudNode(
@@ -69,30 +75,89 @@ RayGroundClassifierCloudNode::RayGroundClassifierCloudNode(
             "aggregator.max_ray_angle_rad").get<float32_t>()),
           static_cast<float32_t>(declare_parameter("aggregator.ray_width_rad").get<float32_t>()),
           static_cast<std::size_t>(
-            declare_parameter("aggregator.max_ray_points").get<std::size_t>())
+            declare_parameter("aggregator.max_ray_points").get<std::size_t>()),
+          declare_parameter("aggregator.insertion_sort", false) ?
+          ray_ground_classifier::RayAggregator::SortMode::INSERTION :
+          ray_ground_classifier::RayAggregator::SortMode::COMPARISON
         }),
+  m_is_structured(declare_parameter("is_structured", false)),
   m_pcl_size(static_cast<std::size_t>(declare_parameter("pcl_size").get<std::size_t>())),
   m_frame_id(declare_parameter("frame_id").get<std::string>().c_str()),
   m_has_failed(false),
+  m_streaming(declare_parameter("streaming.enabled", false)),
+  m_max_chunks(static_cast<std::size_t>(declare_parameter("streaming.max_chunks", 1000))),
+  m_first_chunk_idx{0U},
   m_timeout(std::chrono::milliseconds{declare_parameter("cloud_timeout_ms").get<uint16_t>()}),
   m_raw_sub_ptr(create_subscription<PointCloud2>(
       "points_in",
-      rclcpp::QoS(10), std::bind(&RayGroundClassifierCloudNode::callback, this, _1))),
+      rclcpp::QoS(10), std::bind(
+        m_streaming ? &RayGroundClassifierCloudNode::chunk_callback :
+        &RayGroundClassifierCloudNode::callback, this, _1))),
   m_ground_pub_ptr(create_publisher<PointCloud2>(
       "points_ground", rclcpp::QoS(10))),
   m_nonground_pub_ptr(create_publisher<PointCloud2>(
       "points_nonground", rclcpp::QoS(10))),
   m_ground_pc_idx{0},
-  m_nonground_pc_idx{0}
+  m_nonground_pc_idx{0},
+  m_use_intra_process{node_options.use_intra_process_comms()},
+  m_trace_stage{autoware::common::latency_tracing::Tracer::instance().register_stage(
+      get_fully_qualified_name())},
+  m_allocation_diagnostics{*this},
+  m_callback_allocations{m_allocation_diagnostics.add_callback(
+      m_streaming ? "chunk_callback" : "callback")}
 {
   // initialize messages
   init_pcl_msg(m_ground_msg, m_frame_id.c_str(), m_pcl_size);
   init_pcl_msg(m_nonground_msg, m_frame_id.c_str(), m_pcl_size);
+  m_ray_block.reserve(POINT_BLOCK_CAPACITY);
+  m_ground_block.reserve(POINT_BLOCK_CAPACITY);
+  m_nonground_block.reserve(POINT_BLOCK_CAPACITY);
+  const auto num_threads = declare_parameter("number_of_threads", 1);
+  if (num_threads < 1) {
+    throw std::runtime_error("RayGroundClassifierCloudNode: number_of_threads must be > 0");
+  }
+  const auto engine = declare_parameter("engine", std::string{"ray"});
+  if (engine == "grid") {
+    if (m_streaming) {
+      throw std::runtime_error("RayGroundClassifierCloudNode: the grid engine can't stream");
+    }
+    m_grid_classifier = std::make_unique<ray_ground_classifier::GridGroundClassifier>(
+      ray_ground_classifier::GridGroundClassifier::Config{
+        static_cast<float32_t>(get_parameter("classifier.sensor_height_m").as_double()),
+        static_cast<std::size_t>(declare_parameter("grid.num_sectors", 360)),
+        static_cast<std::size_t>(declare_parameter("grid.num_rings", 160)),
+        static_cast<float32_t>(declare_parameter("grid.max_range_m", 80.0)),
+        static_cast<float32_t>(declare_parameter("grid.max_slope_deg", 10.0)),
+        static_cast<float32_t>(declare_parameter("grid.max_step_m", 0.15)),
+        static_cast<float32_t>(declare_parameter("grid.height_thresh_m", 0.2))},
+      m_pcl_size);
+    m_ground_block.reserve(m_pcl_size);
+    m_nonground_block.reserve(m_pcl_size);
+  } else if (engine != "ray") {
+    throw std::runtime_error("RayGroundClassifierCloudNode: engine must be \"ray\" or \"grid\"");
+  }
+  if ((num_threads > 1) && !m_grid_classifier) {
+    m_partitioner = std::make_unique<ParallelRayPartitioner>(
+      m_classifier, static_cast<std::size_t>(num_threads), m_aggregator.get_num_rays(),
+      m_pcl_size);
+  }
+  if (m_streaming) {
+    if (m_max_chunks == 0U) {
+      throw std::runtime_error("RayGroundClassifierCloudNode: streaming.max_chunks must be > 0");
+    }
+    m_chunks.reserve(m_max_chunks);
+  }
 }
 ////////////////////////////////////////////////////////////////////////////////
 void
-RayGroundClassifierCloudNode::callback(const PointCloud2::SharedPtr msg)
+RayGroundClassifierCloudNode::callback(const PointCloud2::ConstSharedPtr msg)
 {
+  // The partitioned clouds keep the stamp, so they continue the trace of the input
+  const autoware::common::rt_memory::AllocationScope allocations{
+    m_allocation_diagnostics.profiler(), m_callback_allocations};
+  autoware::common::latency_tracing::TraceScope trace{
+    autoware::common::latency_tracing::Tracer::instance(), m_trace_stage};
+  trace.set_trace_id(autoware::common::latency_tracing::to_trace_id(msg->header.stamp));
   PointXYZIF pt_tmp;
   pt_tmp.id = static_cast<uint16_t>(PointXYZIF::END_OF_SCAN_ID);
   const ray_ground_classifier::PointXYZIFR eos_pt{&pt_tmp};
@@ -100,27 +165,25 @@ RayGroundClassifierCloudNode::callback(const PointCloud2::SharedPtr msg)
   try {
     // Reset messages and aggregator to ensure they are in a good state
     reset();
-    // Verify header
-    if (msg->header.frame_id != m_ground_msg.header.frame_id) {
-      throw std::runtime_error(
-              "RayGroundClassifierCloudNode: raw topic from unexpected "
-              "frame (expected '" + m_ground_msg.header.frame_id +
-              "', got '" + msg->header.frame_id + "')");
-    }
-    // Verify the consistency of PointCloud msg
-    const auto data_length = msg->width * msg->height * msg->point_step;
-    if ((msg->data.size() != msg->row_step) || (data_length != msg->row_step)) {
-      throw std::runtime_error("RayGroundClassifierCloudNode: Malformed PointCloud2");
-    }
-    // Verify the point cloud format and assign correct point_step
-    if (!has_intensity_and_throw_if_no_xyz(msg)) {
-      RCLCPP_WARN(
-        this->get_logger(),
-        "RayGroundClassifierNode Warning: PointCloud doesn't have intensity field");
-    }
+    validate(*msg);
     // Harvest timestamp
     m_nonground_msg.header.stamp = msg->header.stamp;
     m_ground_msg.header.stamp = msg->header.stamp;
+    if (m_grid_classifier) {
+      partition_grid(*msg);
+      publish_clouds();
+      return;
+    }
+    if (m_is_structured) {
+      if (has_pointxyzif_layout(*msg)) {
+        partition_structured(*msg);
+        publish_clouds();
+        return;
+      }
+      RCLCPP_WARN_ONCE(
+        this->get_logger(),
+        "RayGroundClassifierCloudNode: input cloud has no id field, treating it as unstructured");
+    }
     // Add all points to aggregator
     // Iterate through the data, but skip intensity in case the point cloud does not have it.
     // For example:
@@ -128,7 +191,6 @@ RayGroundClassifierCloudNode::callback(const PointCloud2::SharedPtr msg)
     // point_step = 4
     // x y z i a b c x y z i a b c
     // ^------       ^------
-    size_t num_ready = 0;
     bool8_t has_encountered_unknown_exception = false;
     bool8_t abort = false;
 
@@ -138,10 +200,10 @@ RayGroundClassifierCloudNode::callback(const PointCloud2::SharedPtr msg)
         continue;
       }
       try {
-        PointXYZIF * pt;
+        const PointXYZIF * pt;
         // TODO(c.ho) Fix below deviation after #2131 is in
         //lint -e{925, 9110} Need to convert pointers and use bit for external API NOLINT
-        pt = reinterpret_cast<PointXYZIF *>(&msg->data[idx]);
+        pt = reinterpret_cast<const PointXYZIF *>(&msg->data[idx]);
         // don't bother inserting the points almost (0,0).
         // Too many of those makes the bin 0 overflow
         if ((fabsf(pt->x) > std::numeric_limits<decltype(pt->x)>::epsilon()) ||
@@ -178,61 +240,26 @@ RayGroundClassifierCloudNode::callback(const PointCloud2::SharedPtr msg)
     // if abort, we skip all remaining the parallel work to be able to return/throw
     if (!abort) {
       m_aggregator.end_of_scan();
-      num_ready = m_aggregator.get_ready_ray_count();
 
       // Partition each ray
-      for (size_t i = 0; i < num_ready; i++) {
-        if (abort) {
-          continue;
-        }
-        // Note: if an exception occurs in this loop, the aggregator can get into a bad state
-        // (e.g. overrun capacity)
-        PointPtrBlock ground_blk;
-        PointPtrBlock nonground_blk;
-        try {
-          auto ray = m_aggregator.get_next_ray();
-          // partition: should never fail, guaranteed to have capacity via other checks
-          m_classifier.partition(ray, ground_blk, nonground_blk);
-
-          // Add ray to point clouds
-          for (auto & ground_point : ground_blk) {
-            uint32_t local_ground_pc_idx;
-
-            local_ground_pc_idx = m_ground_pc_idx++;
-            if (!add_point_to_cloud_raw(
-                m_ground_msg, *ground_point,
-                local_ground_pc_idx))
-            {
-              throw std::runtime_error(
-                      "RayGroundClassifierNode: Overran ground msg point capacity");
-            }
-          }
-          for (auto & nonground_point : nonground_blk) {
-            uint32_t local_nonground_pc_idx;
-            local_nonground_pc_idx = m_nonground_pc_idx++;
-            if (!add_point_to_cloud_raw(
-                m_nonground_msg, *nonground_point,
-                local_nonground_pc_idx))
-            {
-              throw std::runtime_error(
-                      "RayGroundClassifierNode: Overran nonground msg point capacity");
-            }
-          }
-        } catch (const std::runtime_error & e) {
-          m_has_failed = true;
-          RCLCPP_INFO(this->get_logger(), e.what());
-          abort = true;
-        } catch (const std::exception & e) {
-          m_has_failed = true;
-          RCLCPP_INFO(this->get_logger(), e.what());
-          abort = true;
-        } catch (...) {
-          RCLCPP_INFO(
-            this->get_logger(),
-            "RayGroundClassifierCloudNode has encountered an unknown failure");
-          abort = true;
-          has_encountered_unknown_exception = true;
-        }
+      // Note: if an exception occurs here, the aggregator can get into a bad state
+      // (e.g. overrun capacity)
+      try {
+        partition_ready_rays();
+      } catch (const std::runtime_error & e) {
+        m_has_failed = true;
+        RCLCPP_INFO(this->get_logger(), e.what());
+        abort = true;
+      } catch (const std::exception & e) {
+        m_has_failed = true;
+        RCLCPP_INFO(this->get_logger(), e.what());
+        abort = true;
+      } catch (...) {
+        RCLCPP_INFO(
+          this->get_logger(),
+          "RayGroundClassifierCloudNode has encountered an unknown failure");
+        abort = true;
+        has_encountered_unknown_exception = true;
       }
     }
 
@@ -248,12 +275,7 @@ RayGroundClassifierCloudNode::callback(const PointCloud2::SharedPtr msg)
       return;
     }
 
-    // Resize the clouds down to their actual sizes.
-    autoware::common::lidar_utils::resize_pcl_msg(m_ground_msg, m_ground_pc_idx);
-    autoware::common::lidar_utils::resize_pcl_msg(m_nonground_msg, m_nonground_pc_idx);
-    // publish: nonground first for the possible microseconds of latency
-    m_nonground_pub_ptr->publish(m_nonground_msg);
-    m_ground_pub_ptr->publish(m_ground_msg);
+    publish_clouds();
   } catch (const std::runtime_error & e) {
     m_has_failed = true;
     RCLCPP_INFO(this->get_logger(), e.what());
@@ -268,6 +290,216 @@ RayGroundClassifierCloudNode::callback(const PointCloud2::SharedPtr msg)
   }
 }
 ////////////////////////////////////////////////////////////////////////////////
+void
+RayGroundClassifierCloudNode::chunk_callback(const PointCloud2::ConstSharedPtr msg)
+{
+  const autoware::common::rt_memory::AllocationScope allocations{
+    m_allocation_diagnostics.profiler(), m_callback_allocations};
+  autoware::common::latency_tracing::TraceScope trace{
+    autoware::common::latency_tracing::Tracer::instance(), m_trace_stage};
+  trace.set_trace_id(autoware::common::latency_tracing::to_trace_id(msg->header.stamp));
+  try {
+    validate(*msg);
+  } catch (const std::exception & e) {
+    // The pending rays are still valid, so just skip the chunk
+    m_has_failed = true;
+    RCLCPP_INFO(this->get_logger(), e.what());
+    return;
+  }
+  try {
+    // Make room by classifying everything that is pending, as if the scan ended
+    if (m_chunks.size() >= m_max_chunks) {
+      autoware::common::lidar_utils::reset_pcl_msg(m_ground_msg, m_pcl_size, m_ground_pc_idx);
+      autoware::common::lidar_utils::reset_pcl_msg(
+        m_nonground_msg, m_pcl_size, m_nonground_pc_idx);
+      m_nonground_msg.header.stamp = m_chunks.back()->header.stamp;
+      m_ground_msg.header.stamp = m_chunks.back()->header.stamp;
+      m_aggregator.end_of_scan();
+      partition_ready_rays();
+      if ((m_ground_pc_idx > 0U) || (m_nonground_pc_idx > 0U)) {
+        publish_clouds();
+      }
+      m_chunks.clear();
+      m_first_chunk_idx = m_aggregator.get_oldest_pending_chunk();
+    }
+    // The rays point into the chunk, so it is kept until they are partitioned
+    m_chunks.push_back(msg);
+    autoware::common::lidar_utils::reset_pcl_msg(m_ground_msg, m_pcl_size, m_ground_pc_idx);
+    autoware::common::lidar_utils::reset_pcl_msg(m_nonground_msg, m_pcl_size, m_nonground_pc_idx);
+    m_nonground_msg.header.stamp = msg->header.stamp;
+    m_ground_msg.header.stamp = msg->header.stamp;
+
+    bool8_t end_of_scan = false;
+    for (std::size_t idx = 0U; idx < msg->data.size(); idx += msg->point_step) {
+      //lint -e{925, 9110} Need to convert pointers and use bit for external API NOLINT
+      const auto * const pt = reinterpret_cast<const PointXYZIF *>(&msg->data[idx]);
+      // don't bother inserting the points almost (0,0).
+      // Too many of those makes the bin 0 overflow
+      if ((fabsf(pt->x) > std::numeric_limits<decltype(pt->x)>::epsilon()) ||
+        (fabsf(pt->y) > std::numeric_limits<decltype(pt->y)>::epsilon()))
+      {
+        if (!m_aggregator.insert(pt)) {
+          // All pending rays are partitioned once the chunk is inserted
+          end_of_scan = true;
+        }
+      } else if (!add_point_to_cloud_raw(m_nonground_msg, *pt, m_nonground_pc_idx++)) {
+        throw std::runtime_error("RayGroundClassifierNode: Overran nonground msg point capacity");
+      }
+    }
+    if (end_of_scan) {
+      m_aggregator.end_of_scan();
+    } else {
+      m_aggregator.end_of_chunk();
+    }
+    partition_ready_rays();
+
+    // Release the chunks that no pending ray points into anymore
+    const auto oldest = m_aggregator.get_oldest_pending_chunk();
+    const auto num_released = std::min(oldest - m_first_chunk_idx, m_chunks.size());
+    (void)m_chunks.erase(
+      m_chunks.begin(), m_chunks.begin() + static_cast<std::ptrdiff_t>(num_released));
+    m_first_chunk_idx = oldest;
+
+    // Only publish sectors with points
+    if ((m_ground_pc_idx > 0U) || (m_nonground_pc_idx > 0U)) {
+      publish_clouds();
+    }
+  } catch (const std::exception & e) {
+    m_has_failed = true;
+    RCLCPP_INFO(this->get_logger(), e.what());
+    // Drop all pending rays and the chunks they point into
+    m_aggregator.end_of_scan();
+    m_aggregator.reset();
+    m_chunks.clear();
+    m_first_chunk_idx = m_aggregator.get_oldest_pending_chunk();
+  } catch (...) {
+    RCLCPP_INFO(
+      this->get_logger(),
+      "RayGroundClassifierCloudNode has encountered an unknown failure");
+    throw;
+  }
+}
+////////////////////////////////////////////////////////////////////////////////
+void RayGroundClassifierCloudNode::validate(const PointCloud2 & msg)
+{
+  // Verify header
+  if (msg.header.frame_id != m_ground_msg.header.frame_id) {
+    throw std::runtime_error(
+            "RayGroundClassifierCloudNode: raw topic from unexpected "
+            "frame (expected '" + m_ground_msg.header.frame_id +
+            "', got '" + msg.header.frame_id + "')");
+  }
+  // Verify the consistency of PointCloud msg
+  const auto data_length = msg.width * msg.height * msg.point_step;
+  if ((msg.data.size() != msg.row_step) || (data_length != msg.row_step)) {
+    throw std::runtime_error("RayGroundClassifierCloudNode: Malformed PointCloud2");
+  }
+  // Verify the point cloud format and assign correct point_step
+  if (!has_intensity_and_throw_if_no_xyz(msg)) {
+    RCLCPP_WARN(
+      this->get_logger(),
+      "RayGroundClassifierNode Warning: PointCloud doesn't have intensity field");
+  }
+}
+////////////////////////////////////////////////////////////////////////////////
+void RayGroundClassifierCloudNode::partition_ready_rays()
+{
+  if (m_partitioner) {
+    m_partitioner->partition(
+      m_aggregator, m_ground_msg, m_ground_pc_idx, m_nonground_msg, m_nonground_pc_idx);
+    return;
+  }
+  while (m_aggregator.is_ray_ready()) {
+    PointPtrBlock ground_blk;
+    PointPtrBlock nonground_blk;
+    const auto & ray = m_aggregator.get_next_ray();
+    // partition: should never fail, guaranteed to have capacity via other checks
+    m_classifier.partition(ray, ground_blk, nonground_blk);
+
+    // Add ray to point clouds
+    add_to_clouds(ground_blk, nonground_blk);
+  }
+}
+////////////////////////////////////////////////////////////////////////////////
+void RayGroundClassifierCloudNode::partition_structured(const PointCloud2 & msg)
+{
+  m_ray_block.clear();
+  for (std::size_t idx = 0U; idx < msg.data.size(); idx += msg.point_step) {
+    //lint -e{925, 9110} Need to convert pointers and use bit for external API NOLINT
+    const auto * const pt = reinterpret_cast<const PointXYZIF *>(&msg.data[idx]);
+    // Points at almost (0,0), e.g. without return, can't be classified along a ray
+    if ((fabsf(pt->x) <= std::numeric_limits<decltype(pt->x)>::epsilon()) &&
+      (fabsf(pt->y) <= std::numeric_limits<decltype(pt->y)>::epsilon()))
+    {
+      if (!add_point_to_cloud_raw(m_nonground_msg, *pt, m_nonground_pc_idx++)) {
+        throw std::runtime_error("RayGroundClassifierNode: Overran nonground msg point capacity");
+      }
+      continue;
+    }
+    // A new id starts a new ray
+    if ((!m_ray_block.empty()) &&
+      ((m_ray_block.front()->id != pt->id) || (m_ray_block.size() >= POINT_BLOCK_CAPACITY)))
+    {
+      partition_ray_block();
+    }
+    m_ray_block.push_back(pt);
+  }
+  partition_ray_block();
+}
+////////////////////////////////////////////////////////////////////////////////
+void RayGroundClassifierCloudNode::partition_grid(const PointCloud2 & msg)
+{
+  m_grid_classifier->reset();
+  for (std::size_t idx = 0U; idx < msg.data.size(); idx += msg.point_step) {
+    //lint -e{925, 9110} Need to convert pointers and use bit for external API NOLINT
+    m_grid_classifier->insert(reinterpret_cast<const PointXYZIF *>(&msg.data[idx]));
+  }
+  m_grid_classifier->partition(m_ground_block, m_nonground_block);
+  add_to_clouds(m_ground_block, m_nonground_block);
+}
+////////////////////////////////////////////////////////////////////////////////
+void RayGroundClassifierCloudNode::partition_ray_block()
+{
+  if (m_ray_block.empty()) {
+    return;
+  }
+  // The block holds a single ray, so the result fits into the blocks
+  m_classifier.structured_partition(m_ray_block, m_ground_block, m_nonground_block);
+  add_to_clouds(m_ground_block, m_nonground_block);
+  m_ray_block.clear();
+}
+////////////////////////////////////////////////////////////////////////////////
+void RayGroundClassifierCloudNode::add_to_clouds(
+  const PointPtrBlock & ground_blk,
+  const PointPtrBlock & nonground_blk)
+{
+  for (const auto ground_point : ground_blk) {
+    if (!add_point_to_cloud_raw(m_ground_msg, *ground_point, m_ground_pc_idx++)) {
+      throw std::runtime_error("RayGroundClassifierNode: Overran ground msg point capacity");
+    }
+  }
+  for (const auto nonground_point : nonground_blk) {
+    if (!add_point_to_cloud_raw(m_nonground_msg, *nonground_point, m_nonground_pc_idx++)) {
+      throw std::runtime_error("RayGroundClassifierNode: Overran nonground msg point capacity");
+    }
+  }
+}
+////////////////////////////////////////////////////////////////////////////////
+void RayGroundClassifierCloudNode::publish_clouds()
+{
+  // Resize the clouds down to their actual sizes.
+  autoware::common::lidar_utils::resize_pcl_msg(m_ground_msg, m_ground_pc_idx);
+  autoware::common::lidar_utils::resize_pcl_msg(m_nonground_msg, m_nonground_pc_idx);
+  // publish: nonground first for the possible microseconds of latency
+  if (m_use_intra_process) {
+    m_nonground_pub_ptr->publish(release_pcl_msg(m_nonground_msg, m_pcl_size));
+    m_ground_pub_ptr->publish(release_pcl_msg(m_ground_msg, m_pcl_size));
+  } else {
+    m_nonground_pub_ptr->publish(m_nonground_msg);
+    m_ground_pub_ptr->publish(m_ground_msg);
+  }
+}
+////////////////////////////////////////////////////////////////////////////////
 void RayGroundClassifierCloudNode::reset()
 {
   // reset aggregator: Needed in case an error is thrown during partitioning of cloud
@@ -17,6 +17,7 @@
 
 #include <rclcpp/rclcpp.hpp>
 
+#include <ray_ground_classifier_nodes/parallel_ray_partitioner.hpp>
 #include <ray_ground_classifier_nodes/ray_ground_classifier_cloud_node.hpp>
 #include <sensor_msgs/msg/point_cloud2.hpp>
 #include <string>
@@ -106,18 +107,8 @@ public:
   std::shared_ptr<rclcpp::Publisher<PointCloud2>> m_pub_raw_points;
 };
 
-TEST(ray_ground_classifier_pcl_validation, filter_test)
+std::vector<rclcpp::Parameter> make_params(const int32_t cloud_size, const char8_t * const frame_id)
 {
-  rclcpp::init(0, nullptr);
-
-  using autoware::perception::filters::ray_ground_classifier_nodes::RayGroundClassifierCloudNode;
-  std::shared_ptr<RayGroundClassifierCloudNode> ray_gnd_ptr;
-  std::shared_ptr<RayGroundPclValidationTester> ray_gnd_validation_tester;
-  const uint32_t mini_cloud_size = 10U;
-
-  const int32_t cloud_size{55000U};
-  const char8_t * const frame_id{"base_link"};
-
   std::vector<rclcpp::Parameter> params;
 
   params.emplace_back("frame_id", frame_id);
@@ -142,6 +133,23 @@ TEST(ray_ground_classifier_pcl_validation, filter_test)
   params.emplace_back("aggregator.ray_width_rad", 0.01);
   params.emplace_back("aggregator.max_ray_points", 512);
 
+  return params;
+}
+
+TEST(ray_ground_classifier_pcl_validation, filter_test)
+{
+  rclcpp::init(0, nullptr);
+
+  using autoware::perception::filters::ray_ground_classifier_nodes::RayGroundClassifierCloudNode;
+  std::shared_ptr<RayGroundClassifierCloudNode> ray_gnd_ptr;
+  std::shared_ptr<RayGroundPclValidationTester> ray_gnd_validation_tester;
+  const uint32_t mini_cloud_size = 10U;
+
+  const int32_t cloud_size{55000U};
+  const char8_t * const frame_id{"base_link"};
+
+  std::vector<rclcpp::Parameter> params = make_params(cloud_size, frame_id);
+
   rclcpp::NodeOptions node_options;
   node_options.parameter_overrides(params);
 
@@ -206,3 +214,232 @@ TEST(ray_ground_classifier_pcl_validation, filter_test)
       expected_nongnd_pcl_size, expected_num_received));
   rclcpp::shutdown();
 }
+
+TEST(ray_ground_classifier_pcl_validation, streaming_test)
+{
+  rclcpp::init(0, nullptr);
+
+  using autoware::perception::filters::ray_ground_classifier_nodes::RayGroundClassifierCloudNode;
+  const uint32_t chunk_size = 5U;
+
+  std::vector<rclcpp::Parameter> params = make_params(55000, "base_link");
+  params.emplace_back("streaming.enabled", true);
+
+  rclcpp::NodeOptions node_options;
+  node_options.parameter_overrides(params);
+  const auto ray_gnd_ptr = std::make_shared<RayGroundClassifierCloudNode>(node_options);
+  const auto ray_gnd_validation_tester = std::make_shared<RayGroundPclValidationTester>();
+
+  rclcpp::executors::SingleThreadedExecutor exec;
+  exec.add_node(ray_gnd_ptr->get_node_base_interface());
+  exec.add_node(ray_gnd_validation_tester);
+
+  // Two halves of a ring of ground points, each point in its own ray, and an empty chunk
+  std::vector<std::string> field_names{"x", "y", "z", "intensity", "timestamp"};
+  const auto first_chunk = create_custom_pcl<float32_t>(field_names, chunk_size);
+  const auto second_chunk = create_custom_pcl<float32_t>(field_names, chunk_size);
+  const auto empty_chunk = create_custom_pcl<float32_t>(field_names, 0U);
+  for (uint32_t i = 0; i < 2U * chunk_size; i++) {
+    float32_t angle = (i * autoware::common::types::TAU) / (2U * chunk_size);
+    const float32_t radius_ring_1 = 0.5;
+    autoware::common::types::PointXYZF pt{
+      std::cos(angle) * radius_ring_1, std::sin(angle) * radius_ring_1, 0.0F};
+    uint32_t tmp_i = i % chunk_size;
+    add_point_to_cloud(*((i < chunk_size) ? first_chunk : second_chunk), pt, tmp_i);
+  }
+
+  while (ray_gnd_validation_tester->m_pub_raw_points->get_subscription_count() < 1) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1LL});
+  }
+
+  const auto spin_until = [&exec, &ray_gnd_validation_tester](const std::size_t num) {
+      // Wait up to 5s but return early if we can
+      for (auto iter = 0U; iter < 500U; ++iter) {
+        exec.spin_some();
+        if (ray_gnd_validation_tester->m_ground_points.size() >= num) {
+          break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+    };
+
+  // The rays of a chunk are only complete once the next chunk didn't add to them
+  ray_gnd_validation_tester->m_pub_raw_points->publish(*first_chunk);
+  ray_gnd_validation_tester->m_pub_raw_points->publish(*second_chunk);
+  spin_until(1U);
+  EXPECT_TRUE(ray_gnd_validation_tester->receive_correct_ground_pcls(4U * 4U * chunk_size, 1U));
+  ray_gnd_validation_tester->m_pub_raw_points->publish(*empty_chunk);
+  spin_until(2U);
+  EXPECT_TRUE(ray_gnd_validation_tester->receive_correct_ground_pcls(4U * 4U * chunk_size, 2U));
+  EXPECT_TRUE(ray_gnd_validation_tester->receive_correct_nonground_pcls(0U, 2U));
+  rclcpp::shutdown();
+}
+
+TEST(ray_ground_classifier_pcl_validation, structured_test)
+{
+  rclcpp::init(0, nullptr);
+
+  using autoware::common::lidar_utils::add_point_to_cloud_raw;
+  using autoware::common::lidar_utils::init_pcl_msg_with_id;
+  using autoware::common::types::PointXYZIF;
+  using autoware::perception::filters::ray_ground_classifier_nodes::RayGroundClassifierCloudNode;
+  const uint32_t num_firings = 4U;
+  const uint32_t points_per_firing = 5U;
+
+  std::vector<rclcpp::Parameter> params = make_params(55000, "base_link");
+  params.emplace_back("is_structured", true);
+
+  rclcpp::NodeOptions node_options;
+  node_options.parameter_overrides(params);
+  const auto ray_gnd_ptr = std::make_shared<RayGroundClassifierCloudNode>(node_options);
+  const auto ray_gnd_validation_tester = std::make_shared<RayGroundPclValidationTester>();
+
+  rclcpp::executors::SingleThreadedExecutor exec;
+  exec.add_node(ray_gnd_ptr->get_node_base_interface());
+  exec.add_node(ray_gnd_validation_tester);
+
+  // Flat ground along a few azimuths, the points of a firing share its id
+  sensor_msgs::msg::PointCloud2 cloud;
+  init_pcl_msg_with_id(cloud, "base_link", num_firings * points_per_firing);
+  uint32_t point_idx = 0U;
+  for (uint32_t firing = 0U; firing < num_firings; ++firing) {
+    const float32_t angle = (static_cast<float32_t>(firing) * autoware::common::types::TAU) /
+      static_cast<float32_t>(num_firings);
+    for (uint32_t i = 0U; i < points_per_firing; ++i) {
+      const float32_t radius = 1.0F + static_cast<float32_t>(i);
+      PointXYZIF pt;
+      pt.x = std::cos(angle) * radius;
+      pt.y = std::sin(angle) * radius;
+      pt.z = 0.0F;
+      pt.intensity = 0.0F;
+      pt.id = static_cast<uint16_t>(firing);
+      ASSERT_TRUE(add_point_to_cloud_raw(cloud, pt, point_idx));
+      ++point_idx;
+    }
+  }
+
+  while (ray_gnd_validation_tester->m_pub_raw_points->get_subscription_count() < 1) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1LL});
+  }
+
+  ray_gnd_validation_tester->m_pub_raw_points->publish(cloud);
+
+  // Wait up to 5s but return early if we can
+  for (auto iter = 0U; iter < 500U; ++iter) {
+    exec.spin_some();
+    if (!ray_gnd_validation_tester->m_ground_points.empty() &&
+      !ray_gnd_validation_tester->m_nonground_points.empty())
+    {
+      break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  // The id field isn't forwarded, so the output has 4 float fields
+  EXPECT_TRUE(
+    ray_gnd_validation_tester->receive_correct_ground_pcls(
+      4U * 4U * num_firings * points_per_firing, 1U));
+  EXPECT_TRUE(ray_gnd_validation_tester->receive_correct_nonground_pcls(0U, 1U));
+  rclcpp::shutdown();
+}
+
+TEST(ray_ground_classifier_parallel_partition, matches_sequential)
+{
+  using autoware::common::lidar_utils::add_point_to_cloud_raw;
+  using autoware::common::lidar_utils::init_pcl_msg;
+  using autoware::common::types::PointXYZIF;
+  using autoware::perception::filters::ray_ground_classifier::RayAggregator;
+  using autoware::perception::filters::ray_ground_classifier::RayGroundClassifier;
+  using autoware::perception::filters::ray_ground_classifier_nodes::ParallelRayPartitioner;
+  const uint32_t capacity = 2000U;
+
+  RayGroundClassifier classifier{autoware::perception::filters::ray_ground_classifier::Config{
+      0.0F, 20.0F, 7.0F, 70.0F, 0.05F, 3.3F, 3.6F, 5.0F}};
+  const RayAggregator::Config agg_cfg{-3.14159F, 3.14159F, 0.01F, 512U};
+  // Rings of points at different heights, so both ground and nonground points are in the rays
+  std::vector<PointXYZIF> points;
+  for (uint32_t i = 0U; i < 1000U; ++i) {
+    const float32_t angle = (static_cast<float32_t>(i % 200U) * autoware::common::types::TAU) /
+      200.0F;
+    const float32_t radius = 1.0F + static_cast<float32_t>(i / 200U);
+    PointXYZIF pt;
+    pt.x = std::cos(angle) * radius;
+    pt.y = std::sin(angle) * radius;
+    pt.z = ((i / 200U) == 3U) ? 1.0F : 0.0F;
+    pt.intensity = static_cast<float32_t>(i);
+    points.push_back(pt);
+  }
+
+  // Sequential reference
+  RayAggregator seq_agg{agg_cfg};
+  sensor_msgs::msg::PointCloud2 seq_ground;
+  sensor_msgs::msg::PointCloud2 seq_nonground;
+  init_pcl_msg(seq_ground, "base_link", capacity);
+  init_pcl_msg(seq_nonground, "base_link", capacity);
+  uint32_t seq_ground_idx = 0U;
+  uint32_t seq_nonground_idx = 0U;
+  for (const auto & pt : points) {
+    ASSERT_TRUE(seq_agg.insert(&pt));
+  }
+  seq_agg.end_of_scan();
+  while (seq_agg.is_ray_ready()) {
+    autoware::common::types::PointPtrBlock ground_blk;
+    autoware::common::types::PointPtrBlock nonground_blk;
+    classifier.partition(seq_agg.get_next_ray(), ground_blk, nonground_blk);
+    for (const auto pt : ground_blk) {
+      ASSERT_TRUE(add_point_to_cloud_raw(seq_ground, *pt, seq_ground_idx++));
+    }
+    for (const auto pt : nonground_blk) {
+      ASSERT_TRUE(add_point_to_cloud_raw(seq_nonground, *pt, seq_nonground_idx++));
+    }
+  }
+  ASSERT_GT(seq_ground_idx, 0U);
+  ASSERT_GT(seq_nonground_idx, 0U);
+
+  for (const std::size_t num_threads : {1U, 2U, 3U, 8U}) {
+    RayAggregator agg{agg_cfg};
+    ParallelRayPartitioner partitioner{classifier, num_threads, agg.get_num_rays(), capacity};
+    EXPECT_EQ(partitioner.get_num_threads(), num_threads);
+    sensor_msgs::msg::PointCloud2 ground;
+    sensor_msgs::msg::PointCloud2 nonground;
+    init_pcl_msg(ground, "base_link", capacity);
+    init_pcl_msg(nonground, "base_link", capacity);
+    // Twice, to check that the workers are reset in between
+    for (uint32_t iter = 0U; iter < 2U; ++iter) {
+      uint32_t ground_idx = 0U;
+      uint32_t nonground_idx = 0U;
+      for (const auto & pt : points) {
+        ASSERT_TRUE(agg.insert(&pt));
+      }
+      agg.end_of_scan();
+      partitioner.partition(agg, ground, ground_idx, nonground, nonground_idx);
+      EXPECT_FALSE(agg.is_ray_ready());
+      ASSERT_EQ(ground_idx, seq_ground_idx);
+      ASSERT_EQ(nonground_idx, seq_nonground_idx);
+      EXPECT_EQ(ground.data, seq_ground.data);
+      EXPECT_EQ(nonground.data, seq_nonground.data);
+    }
+  }
+
+  // Too small output clouds
+  RayAggregator agg{agg_cfg};
+  ParallelRayPartitioner partitioner{classifier, 4U, agg.get_num_rays(), 100U};
+  sensor_msgs::msg::PointCloud2 ground;
+  sensor_msgs::msg::PointCloud2 nonground;
+  init_pcl_msg(ground, "base_link", 100U);
+  init_pcl_msg(nonground, "base_link", 100U);
+  uint32_t ground_idx = 0U;
+  uint32_t nonground_idx = 0U;
+  for (const auto & pt : points) {
+    ASSERT_TRUE(agg.insert(&pt));
+  }
+  agg.end_of_scan();
+  EXPECT_THROW(
+    partitioner.partition(agg, ground, ground_idx, nonground, nonground_idx),
+    std::runtime_error);
+  EXPECT_EQ(ground_idx, 0U);
+  EXPECT_EQ(nonground_idx, 0U);
+
+  EXPECT_THROW(
+    ParallelRayPartitioner(classifier, 0U, agg.get_num_rays(), capacity), std::domain_error);
+}
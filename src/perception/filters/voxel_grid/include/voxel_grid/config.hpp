@@ -75,6 +75,14 @@ public:
   /// \brief Gets the capacity of the voxel grid
   /// \return Fixed value
   uint64_t get_capacity() const;
+  /// \brief Gets the index offset between two voxels adjacent in the y direction, which is also
+  ///        the number of voxels in the x direction
+  /// \return Fixed value
+  uint64_t get_y_stride() const;
+  /// \brief Gets the index offset between two voxels adjacent in the z direction, which is also
+  ///        the number of voxels in an x-y slice
+  /// \return Fixed value
+  uint64_t get_z_stride() const;
   /// \brief Computes index for a given point given the voxelgrid configuration parameters
   /// \param[in] pt The point for which the voxel index will be computed
   /// \return The index of the voxel for which this point will fall into
@@ -0,0 +1,260 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+/// \file
+/// \brief This file defines a voxel grid that sorts the points by voxel index instead of hashing
+
+#ifndef VOXEL_GRID__FLAT_VOXEL_GRID_HPP_
+#define VOXEL_GRID__FLAT_VOXEL_GRID_HPP_
+
+#include <voxel_grid/config.hpp>
+#include <voxel_grid/voxels.hpp>
+#include <common/types.hpp>
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace autoware
+{
+namespace perception
+{
+namespace filters
+{
+namespace voxel_grid
+{
+namespace details
+{
+/// \brief Get the number of bits of the largest voxel index of a configuration
+/// \param[in] cfg The configuration of the voxel grid
+/// \return The number of bits that the voxel indices use
+inline uint32_t index_bits(const Config & cfg)
+{
+  uint32_t bits = 0U;
+  for (uint64_t max_key = cfg.index(cfg.get_max_point()); max_key > 0U; max_key >>= 1U) {
+    ++bits;
+  }
+  return bits;
+}
+
+/// \brief Stable LSD radix sort of keys by a range of their bits, a permutation is sorted along
+///        with them. The tmp arrays are used as scratch space.
+/// \param[inout] keys The keys to sort
+/// \param[inout] order The permutation that is reordered along with the keys
+/// \param[in] keys_tmp Scratch space of the same size as the keys
+/// \param[in] order_tmp Scratch space of the same size as the permutation
+/// \param[in] num_keys The number of keys
+/// \param[in] begin_bit The lowest bit to sort by
+/// \param[in] end_bit One past the highest bit to sort by, all keys are assumed to be equal in
+///                    the bits above
+inline void radix_sort(
+  uint64_t * keys, uint32_t * order, uint64_t * keys_tmp, uint32_t * order_tmp,
+  const std::size_t num_keys, const uint32_t begin_bit, const uint32_t end_bit)
+{
+  constexpr uint32_t RADIX_BITS = 8U;
+  constexpr std::size_t RADIX_SIZE = 1U << RADIX_BITS;
+  constexpr uint64_t RADIX_MASK = RADIX_SIZE - 1U;
+  if (num_keys == 0U) {
+    return;
+  }
+  uint64_t * const keys_out = keys;
+  uint32_t * const order_out = order;
+  std::array<std::size_t, RADIX_SIZE> counts;
+  for (uint32_t shift = begin_bit; shift < end_bit; shift += RADIX_BITS) {
+    counts.fill(0U);
+    for (std::size_t idx = 0U; idx < num_keys; ++idx) {
+      ++counts[(keys[idx] >> shift) & RADIX_MASK];
+    }
+    // A pass where all keys have the same digit wouldn't change the order
+    if (counts[(keys[0U] >> shift) & RADIX_MASK] == num_keys) {
+      continue;
+    }
+    std::size_t offset = 0U;
+    for (auto & count : counts) {
+      const std::size_t next = offset + count;
+      count = offset;
+      offset = next;
+    }
+    for (std::size_t idx = 0U; idx < num_keys; ++idx) {
+      const std::size_t dst = counts[(keys[idx] >> shift) & RADIX_MASK]++;
+      keys_tmp[dst] = keys[idx];
+      order_tmp[dst] = order[idx];
+    }
+    std::swap(keys, keys_tmp);
+    std::swap(order, order_tmp);
+  }
+  // After an odd number of passes, the result is in the scratch space
+  if (keys != keys_out) {
+    (void)std::copy(keys, keys + num_keys, keys_out);
+    (void)std::copy(order, order + num_keys, order_out);
+  }
+}
+}  // namespace details
+
+/// \brief A voxel grid for downsampling point clouds that keeps the inserted points in flat
+///        arrays. On reduce, the points are radix sorted by voxel index and each run of points
+///        with the same index is reduced into a voxel. All memory is allocated on construction,
+///        and the voxels are output in ascending index order, so the output is deterministic.
+/// \tparam VoxelT The underlying voxel type, assumed to be a child class of Voxel with the
+///                addition of the add_observation(PointT) and configure(Config, uint64_t) methods
+template<typename VoxelT>
+class VOXEL_GRID_PUBLIC FlatVoxelGrid
+{
+public:
+  using point_t = typename VoxelT::point_t;
+  /// \brief Pairs of voxel index and voxel, ordered by index
+  using Voxels = std::vector<std::pair<uint64_t, VoxelT>>;
+
+  /// \brief Constructor
+  /// \param[in] cfg The configuration class, its capacity bounds the number of voxels
+  /// \param[in] point_capacity The maximum number of points inserted between two reductions
+  /// \throw std::domain_error If the point capacity doesn't fit into 32 bits
+  FlatVoxelGrid(const Config & cfg, const std::size_t point_capacity)
+  : m_config(cfg),
+    // Only sort the digits that the largest index uses
+    m_key_bits{details::index_bits(cfg)},
+    m_point_capacity{point_capacity}
+  {
+    if (m_point_capacity > static_cast<std::size_t>(std::numeric_limits<uint32_t>::max())) {
+      throw std::domain_error{"FlatVoxelGrid: point capacity must fit into 32 bits"};
+    }
+    m_points.reserve(m_point_capacity);
+    m_keys.reserve(m_point_capacity);
+    m_keys_tmp.reserve(m_point_capacity);
+    m_order.reserve(m_point_capacity);
+    m_order_tmp.reserve(m_point_capacity);
+    m_voxels.reserve(m_config.get_capacity());
+  }
+
+  /// \brief Inserts a point into the voxel grid, it is only stored until the next reduction
+  /// \param[in] pt The point to insert
+  /// \throw std::length_error If the point capacity is reached
+  void insert(const point_t & pt)
+  {
+    if (m_points.size() >= m_point_capacity) {
+      throw std::length_error{"FlatVoxelGrid: insertion would overrun point capacity"};
+    }
+    m_keys.push_back(m_config.index(pt));
+    m_points.push_back(pt);
+  }
+  /// \brief Inserts many points into the voxel grid, dispatches to the core insert method.
+  /// \tparam IT The iterator type
+  /// \param[in] begin The starting iterator
+  /// \param[in] end An iterator pointing one past the last element to be inserted.
+  template<typename IT>
+  void insert(const IT begin, const IT end)
+  {
+    for (IT it = begin; it != end; ++it) {
+      insert(*it);
+    }
+  }
+
+  /// \brief Reduces all points inserted since the last reduction into voxels, and removes the
+  ///        points. Points of a voxel are added to it in the order of insertion.
+  /// \return The voxels in ascending index order, valid until the next reduction or clear
+  /// \throw std::length_error If the number of voxels would exceed the capacity of the config,
+  ///                          in which case the grid is cleared
+  const Voxels & reduce()
+  {
+    sort();
+    m_voxels.clear();
+    for (std::size_t idx = 0U; idx < m_keys.size(); ++idx) {
+      const uint64_t key = m_keys[idx];
+      if (m_voxels.empty() || (m_voxels.back().first != key)) {
+        if (m_voxels.size() >= m_config.get_capacity()) {
+          clear();
+          throw std::length_error{"FlatVoxelGrid: reduction would overrun capacity"};
+        }
+        m_voxels.emplace_back(key, VoxelT{});
+        //lint -e{523} NOLINT This is to support multiple voxel implementations
+        m_voxels.back().second.configure(m_config, key);
+      }
+      m_voxels.back().second.add_observation(m_points[m_order[idx]]);
+    }
+    m_points.clear();
+    m_keys.clear();
+    return m_voxels;
+  }
+
+  /// \brief Resets the state of the voxel grid
+  void clear()
+  {
+    m_points.clear();
+    m_keys.clear();
+    m_voxels.clear();
+  }
+  /// \brief Returns the number of points inserted since the last reduction
+  std::size_t size() const
+  {
+    return m_points.size();
+  }
+  /// \brief Returns the preallocated point capacity of the voxel grid
+  /// \return The preallocated point capacity
+  std::size_t point_capacity() const
+  {
+    return m_point_capacity;
+  }
+  /// \brief Returns the preallocated voxel capacity of the voxel grid
+  /// \return The preallocated voxel capacity
+  std::size_t capacity() const
+  {
+    return m_config.get_capacity();
+  }
+  /// \brief Whether no point was inserted since the last reduction
+  /// \return True or false
+  bool8_t empty() const
+  {
+    return m_points.empty();
+  }
+
+private:
+  /// \brief Sort the keys, m_order is permuted along with them
+  void sort()
+  {
+    const std::size_t num_points = m_keys.size();
+    // Within capacity, so nothing is allocated
+    m_keys_tmp.resize(num_points);
+    m_order.resize(num_points);
+    m_order_tmp.resize(num_points);
+    for (std::size_t idx = 0U; idx < num_points; ++idx) {
+      m_order[idx] = static_cast<uint32_t>(idx);
+    }
+    details::radix_sort(
+      m_keys.data(), m_order.data(), m_keys_tmp.data(), m_order_tmp.data(), num_points, 0U,
+      m_key_bits);
+  }
+
+  const Config m_config;
+  uint32_t m_key_bits;
+  const std::size_t m_point_capacity;
+  std::vector<point_t> m_points;
+  // Voxel index of each point, sorted in place on reduction
+  std::vector<uint64_t> m_keys;
+  std::vector<uint64_t> m_keys_tmp;
+  // Index of the point of each sorted key
+  std::vector<uint32_t> m_order;
+  std::vector<uint32_t> m_order_tmp;
+  Voxels m_voxels;
+};  // class FlatVoxelGrid
+
+}  // namespace voxel_grid
+}  // namespace filters
+}  // namespace perception
+}  // namespace autoware
+
+#endif  // VOXEL_GRID__FLAT_VOXEL_GRID_HPP_
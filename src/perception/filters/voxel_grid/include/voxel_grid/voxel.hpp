@@ -54,6 +54,14 @@ public:
     m_centroid(pt)
   {
   }
+  /// \brief Restore a voxel from its centroid and its number of points, e.g. after storing it
+  /// \param[in] pt The centroid of the points of the voxel
+  /// \param[in] num_points The number of points the voxel was created from
+  Voxel(const PointT & pt, const uint32_t num_points)
+  : m_num_points(num_points),
+    m_centroid(pt)
+  {
+  }
   /// \brief Conversion operator to bool, pass through to occupied
   /// \return Whether or not the object is occuped
   explicit operator bool() const
@@ -121,6 +121,16 @@ uint64_t Config::get_capacity() const
 {
   return m_capacity;
 }
+////////////////////////////////////////////////////////////////////////////////
+uint64_t Config::get_y_stride() const
+{
+  return m_y_stride;
+}
+////////////////////////////////////////////////////////////////////////////////
+uint64_t Config::get_z_stride() const
+{
+  return m_z_stride;
+}
 
 }  // namespace voxel_grid
 }  // namespace filters
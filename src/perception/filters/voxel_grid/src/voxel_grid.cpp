@@ -15,6 +15,7 @@
 // Co-developed by Tier IV, Inc. and Apex.AI, Inc.
 
 #include "common/types.hpp"
+#include "voxel_grid/flat_voxel_grid.hpp"
 #include "voxel_grid/voxel_grid.hpp"
 
 namespace autoware
@@ -31,6 +32,10 @@ template class VoxelGrid<ApproximateVoxel<PointXYZ>>;
 template class VoxelGrid<ApproximateVoxel<autoware::common::types::PointXYZIF>>;
 template class VoxelGrid<CentroidVoxel<PointXYZ>>;
 template class VoxelGrid<CentroidVoxel<autoware::common::types::PointXYZIF>>;
+template class FlatVoxelGrid<ApproximateVoxel<PointXYZ>>;
+template class FlatVoxelGrid<ApproximateVoxel<autoware::common::types::PointXYZIF>>;
+template class FlatVoxelGrid<CentroidVoxel<PointXYZ>>;
+template class FlatVoxelGrid<CentroidVoxel<autoware::common::types::PointXYZIF>>;
 }  // namespace voxel_grid
 }  // namespace filters
 }  // namespace perception
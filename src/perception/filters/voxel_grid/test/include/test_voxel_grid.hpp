@@ -18,8 +18,10 @@
 #define TEST_VOXEL_GRID_HPP_
 
 #include <common/types.hpp>
+#include <algorithm>
 #include <memory>
 #include <limits>
+#include "voxel_grid/flat_voxel_grid.hpp"
 #include "voxel_grid/voxel_grid.hpp"
 
 using autoware::perception::filters::voxel_grid::PointXYZ;
@@ -28,6 +30,7 @@ using autoware::perception::filters::voxel_grid::Voxel;
 using autoware::perception::filters::voxel_grid::ApproximateVoxel;
 using autoware::perception::filters::voxel_grid::CentroidVoxel;
 using autoware::perception::filters::voxel_grid::VoxelGrid;
+using autoware::perception::filters::voxel_grid::FlatVoxelGrid;
 using autoware::perception::filters::voxel_grid::PointXYZIF;
 using autoware::common::types::bool8_t;
 using autoware::common::types::float32_t;
@@ -762,4 +765,86 @@ TYPED_TEST(TypedVoxelGridTest, approximate_voxel_grid)
   EXPECT_THROW(grid.insert(*(this->obs_points1.end() - 1)), std::length_error);
   EXPECT_THROW(grid.insert(*(this->obs_points1.end() - 2)), std::length_error);
 }
+
+/// basic i/o for the sort based voxel grid
+TYPED_TEST(TypedVoxelGridTest, flat_centroid_voxel_grid)
+{
+  FlatVoxelGrid<CentroidVoxel<TypeParam>> grid{*this->cfg_ptr, this->obs_points1.size()};
+  this->ref_points1[0U] = this->make(-0.75F, -0.75F, -0.75F);
+  this->ref_points1[1U] = this->make(0.75F, -0.75F, -0.75F);
+  this->ref_points1[2U] = this->make(-0.75F, 0.75F, -0.75F);
+  this->ref_points1[3U] = this->make(0.75F, 0.75F, -0.75F);
+  this->ref_points1[4U] = this->make(-0.75F, -0.75F, 0.75F);
+  this->ref_points1[5U] = this->make(0.75F, -0.75F, 0.75F);
+  this->ref_points1[6U] = this->make(-0.75F, 0.75F, 0.75F);
+  EXPECT_TRUE(grid.empty());
+  EXPECT_EQ(grid.capacity(), this->capacity);
+  EXPECT_EQ(grid.point_capacity(), this->obs_points1.size());
+  EXPECT_TRUE(grid.reduce().empty());
+  // Insert in reverse, the voxels still come out by ascending index
+  for (std::size_t idx = this->obs_points1.size() - 2U; idx > 0U; --idx) {
+    grid.insert(this->obs_points1[idx - 1U]);
+  }
+  EXPECT_EQ(grid.size(), this->obs_points1.size() - 2U);
+  const auto & voxels = grid.reduce();
+  EXPECT_TRUE(grid.empty());
+  ASSERT_EQ(voxels.size(), this->ref_points1.size() - 1U);
+  for (std::size_t idx = 0U; idx < voxels.size(); ++idx) {
+    EXPECT_EQ(voxels[idx].first, idx);
+    EXPECT_EQ(voxels[idx].second.count(), 2U);
+    EXPECT_TRUE(this->check(voxels[idx].second.get(), this->ref_points1[idx]));
+  }
+  // Bad case: too many voxels
+  grid.insert(this->obs_points1.begin(), this->obs_points1.end());
+  EXPECT_THROW(grid.insert(this->obs_points1[0U]), std::length_error);
+  EXPECT_THROW(grid.reduce(), std::length_error);
+  EXPECT_TRUE(grid.empty());
+}
+
+/// The sort based voxel grid matches the hash based one
+TYPED_TEST(TypedVoxelGridTest, flat_matches_hashed)
+{
+  PointXYZ min_point;
+  min_point.x = -50.0F;
+  min_point.y = -50.0F;
+  min_point.z = -5.0F;
+  PointXYZ max_point;
+  max_point.x = 50.0F;
+  max_point.y = 50.0F;
+  max_point.z = 5.0F;
+  PointXYZ voxel_size;
+  voxel_size.x = 0.5F;
+  voxel_size.y = 0.5F;
+  voxel_size.z = 0.5F;
+  const std::size_t num_points = 10000U;
+  const Config cfg{min_point, max_point, voxel_size, num_points};
+  VoxelGrid<CentroidVoxel<TypeParam>> hashed{cfg};
+  FlatVoxelGrid<CentroidVoxel<TypeParam>> flat{cfg, num_points};
+  for (std::size_t idx = 0U; idx < num_points; ++idx) {
+    // Deterministic scatter that puts several points into most voxels
+    const float32_t x = static_cast<float32_t>((idx * 37U) % 400U) * 0.25F - 50.0F;
+    const float32_t y = static_cast<float32_t>((idx * 91U) % 300U) * 0.25F - 40.0F;
+    const float32_t z = static_cast<float32_t>((idx * 13U) % 31U) * 0.3F - 4.5F;
+    const auto pt = this->make(x, y, z);
+    hashed.insert(pt);
+    flat.insert(pt);
+  }
+  const auto & voxels = flat.reduce();
+  ASSERT_EQ(voxels.size(), hashed.size());
+  for (std::size_t idx = 0U; idx < voxels.size(); ++idx) {
+    if (idx > 0U) {
+      EXPECT_LT(voxels[idx - 1U].first, voxels[idx].first);
+    }
+    const auto it = std::find_if(
+      hashed.begin(), hashed.end(), [&voxels, idx](const auto & kv) {
+        return kv.first == voxels[idx].first;
+      });
+    ASSERT_NE(it, hashed.end());
+    // Same points in the same order, so the same floating point operations
+    EXPECT_EQ(it->second.count(), voxels[idx].second.count());
+    EXPECT_EQ(it->second.get().x, voxels[idx].second.get().x);
+    EXPECT_EQ(it->second.get().y, voxels[idx].second.get().y);
+    EXPECT_EQ(it->second.get().z, voxels[idx].second.get().z);
+  }
+}
 #endif  // TEST_VOXEL_GRID_HPP_
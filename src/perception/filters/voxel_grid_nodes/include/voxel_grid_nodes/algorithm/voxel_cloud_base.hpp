@@ -23,6 +23,7 @@
 #include <sensor_msgs/msg/point_cloud2.hpp>
 #include <voxel_grid/voxel_grid.hpp>
 #include <voxel_grid_nodes/visibility_control.hpp>
+#include <memory>
 #include <string>
 
 namespace autoware
@@ -53,6 +54,11 @@ public:
   /// \return The downsampled point cloud
   virtual const sensor_msgs::msg::PointCloud2 & get() = 0;
 
+  /// \brief Get accumulated downsampled points like get(), but move them out instead of
+  ///        returning a reference to the internal cloud, which is reallocated for the next call.
+  /// \return The downsampled point cloud
+  virtual std::unique_ptr<sensor_msgs::msg::PointCloud2> release() = 0;
+
 protected:
   using PointXYZIF = autoware::perception::filters::voxel_grid::PointXYZIF;
 
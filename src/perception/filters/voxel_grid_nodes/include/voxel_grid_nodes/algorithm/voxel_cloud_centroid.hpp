@@ -48,6 +48,10 @@ public:
   /// \return The downsampled point cloud
   const sensor_msgs::msg::PointCloud2 & get() override;
 
+  /// \brief Get accumulated downsampled points and move them out of the internal cloud
+  /// \return The downsampled point cloud
+  std::unique_ptr<sensor_msgs::msg::PointCloud2> release() override;
+
 private:
   sensor_msgs::msg::PointCloud2 m_cloud;
   voxel_grid::VoxelGrid<voxel_grid::CentroidVoxel<PointXYZIF>> m_grid;
@@ -0,0 +1,78 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+/// \file
+/// \brief This file defines an instance of the VoxelCloudBase interface based on FlatVoxelGrid
+#ifndef VOXEL_GRID_NODES__ALGORITHM__VOXEL_CLOUD_FLAT_HPP_
+#define VOXEL_GRID_NODES__ALGORITHM__VOXEL_CLOUD_FLAT_HPP_
+
+#include <voxel_grid/flat_voxel_grid.hpp>
+#include <voxel_grid_nodes/algorithm/voxel_cloud_base.hpp>
+
+#include <cstddef>
+#include <memory>
+
+namespace autoware
+{
+namespace perception
+{
+namespace filters
+{
+namespace voxel_grid_nodes
+{
+namespace algorithm
+{
+/// \brief An instantiation of VoxelCloudBase that sorts the points by voxel index instead of
+///        hashing them. The output points are ordered by voxel index.
+/// \tparam VoxelT The voxel type, CentroidVoxel or ApproximateVoxel of PointXYZIF
+template<typename VoxelT>
+class VOXEL_GRID_NODES_PUBLIC VoxelCloudFlat : public VoxelCloudBase
+{
+public:
+  /// \brief Constructor
+  /// \param[in] cfg Configuration struct for the voxel grid
+  /// \param[in] point_capacity Maximum number of points inserted between two calls to get
+  VoxelCloudFlat(const voxel_grid::Config & cfg, std::size_t point_capacity);
+
+  /// \brief Inserts points into the voxel grid data structure, overwrites internal header
+  /// \param[in] msg A point cloud to insert into the voxel grid. Assumed to have the structure XYZI
+  void insert(const sensor_msgs::msg::PointCloud2 & msg) override;
+
+  /// \brief Get accumulated downsampled points. Internally resets the internal grid. Header is
+  ///        taken from last insert
+  /// \return The downsampled point cloud
+  const sensor_msgs::msg::PointCloud2 & get() override;
+
+  /// \brief Get accumulated downsampled points and move them out of the internal cloud
+  /// \return The downsampled point cloud
+  std::unique_ptr<sensor_msgs::msg::PointCloud2> release() override;
+
+private:
+  sensor_msgs::msg::PointCloud2 m_cloud;
+  voxel_grid::FlatVoxelGrid<VoxelT> m_grid;
+};  // VoxelCloudFlat
+
+using VoxelCloudFlatCentroid =
+  VoxelCloudFlat<voxel_grid::CentroidVoxel<voxel_grid::PointXYZIF>>;
+using VoxelCloudFlatApproximate =
+  VoxelCloudFlat<voxel_grid::ApproximateVoxel<voxel_grid::PointXYZIF>>;
+}  // namespace algorithm
+}  // namespace voxel_grid_nodes
+}  // namespace filters
+}  // namespace perception
+}  // namespace autoware
+
+#endif  // VOXEL_GRID_NODES__ALGORITHM__VOXEL_CLOUD_FLAT_HPP_
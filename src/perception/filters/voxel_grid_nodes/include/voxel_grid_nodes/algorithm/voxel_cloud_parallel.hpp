@@ -0,0 +1,122 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+/// \file
+/// \brief This file defines an instance of the VoxelCloudBase interface that downsamples on
+///        several threads
+#ifndef VOXEL_GRID_NODES__ALGORITHM__VOXEL_CLOUD_PARALLEL_HPP_
+#define VOXEL_GRID_NODES__ALGORITHM__VOXEL_CLOUD_PARALLEL_HPP_
+
+#include <voxel_grid/flat_voxel_grid.hpp>
+#include <voxel_grid_nodes/algorithm/voxel_cloud_base.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace autoware
+{
+namespace perception
+{
+namespace filters
+{
+namespace voxel_grid_nodes
+{
+namespace algorithm
+{
+/// \brief An instantiation of VoxelCloudBase that downsamples like VoxelCloudFlat, but on several
+///        threads. The points are first bucketed by the high bits of their voxel index, and the
+///        buckets are split into one contiguous range of indices per thread with about the same
+///        number of points. Each thread then sorts and reduces its range into its own voxels,
+///        and writes them to its part of the output cloud. So the output is the same as the one
+///        of VoxelCloudFlat, regardless of the number of threads.
+/// \tparam VoxelT The voxel type, CentroidVoxel or ApproximateVoxel of PointXYZIF
+template<typename VoxelT>
+class VOXEL_GRID_NODES_PUBLIC VoxelCloudParallel : public VoxelCloudBase
+{
+public:
+  /// \brief Constructor
+  /// \param[in] cfg Configuration struct for the voxel grid
+  /// \param[in] point_capacity Maximum number of points inserted between two calls to get
+  /// \param[in] num_threads Number of threads including the calling thread
+  /// \throw std::domain_error If the number of threads is 0 or the point capacity doesn't fit
+  ///                          into 32 bits
+  VoxelCloudParallel(
+    const voxel_grid::Config & cfg,
+    std::size_t point_capacity,
+    std::size_t num_threads);
+
+  /// \brief Inserts points into the voxel grid data structure, overwrites internal header
+  /// \param[in] msg A point cloud to insert into the voxel grid. Assumed to have the structure XYZI
+  /// \throw std::length_error If the point capacity is exceeded
+  void insert(const sensor_msgs::msg::PointCloud2 & msg) override;
+
+  /// \brief Get accumulated downsampled points. Internally resets the internal grid. Header is
+  ///        taken from last insert
+  /// \return The downsampled point cloud
+  /// \throw std::length_error If there are more voxels than the capacity of the config
+  const sensor_msgs::msg::PointCloud2 & get() override;
+
+  /// \brief Get accumulated downsampled points and move them out of the internal cloud
+  /// \return The downsampled point cloud
+  std::unique_ptr<sensor_msgs::msg::PointCloud2> release() override;
+
+  /// \brief Get the number of threads including the calling thread
+  std::size_t get_num_threads() const;
+
+private:
+  using Voxels = std::vector<std::pair<uint64_t, VoxelT>>;
+
+  /// \brief Bucket the keys by their high bits and split the buckets between the threads
+  VOXEL_GRID_NODES_LOCAL void partition();
+  /// \brief Sort and reduce the points of a thread into its voxels
+  VOXEL_GRID_NODES_LOCAL void reduce(std::size_t thread_idx);
+  /// \brief Write the voxels of a thread into the output cloud
+  VOXEL_GRID_NODES_LOCAL void write(std::size_t thread_idx);
+  /// \brief Run a member function for every thread, the calling thread takes the first one
+  VOXEL_GRID_NODES_LOCAL void run(void (VoxelCloudParallel::* fn)(std::size_t));
+
+  const voxel_grid::Config m_config;
+  const std::size_t m_point_capacity;
+  const std::size_t m_num_threads;
+  const uint32_t m_key_bits;
+  const uint32_t m_bucket_shift;
+  sensor_msgs::msg::PointCloud2 m_cloud;
+  std::vector<PointXYZIF> m_points;
+  std::vector<uint64_t> m_keys;
+  std::vector<uint64_t> m_keys_tmp;
+  std::vector<uint32_t> m_order;
+  std::vector<uint32_t> m_order_tmp;
+  std::vector<std::size_t> m_bucket_counts;
+  // State of every thread: range of sorted points, voxels and their offset in the output cloud
+  std::vector<std::size_t> m_begin;
+  std::vector<Voxels> m_voxels;
+  std::vector<uint32_t> m_voxel_offsets;
+  std::vector<uint8_t> m_overrun;
+};  // VoxelCloudParallel
+
+using VoxelCloudParallelCentroid =
+  VoxelCloudParallel<voxel_grid::CentroidVoxel<voxel_grid::PointXYZIF>>;
+using VoxelCloudParallelApproximate =
+  VoxelCloudParallel<voxel_grid::ApproximateVoxel<voxel_grid::PointXYZIF>>;
+}  // namespace algorithm
+}  // namespace voxel_grid_nodes
+}  // namespace filters
+}  // namespace perception
+}  // namespace autoware
+
+#endif  // VOXEL_GRID_NODES__ALGORITHM__VOXEL_CLOUD_PARALLEL_HPP_
@@ -21,6 +21,7 @@
 #define VOXEL_GRID_NODES__VOXEL_CLOUD_NODE_HPP_
 
 #include <voxel_grid_nodes/algorithm/voxel_cloud_base.hpp>
+#include <overload_management/load_monitor.hpp>
 #include <rclcpp/rclcpp.hpp>
 #include <common/types.hpp>
 #include <memory>
@@ -40,7 +41,10 @@ namespace voxel_grid_nodes
 rmw_qos_durability_policy_t parse_durability_parameter(
   const std::string & durability);
 
-/// \brief Boilerplate node that subscribes to point clouds and publishes a downsampled version
+/// \brief Boilerplate node that subscribes to point clouds and publishes a downsampled version.
+///        While the perception pipeline is overloaded, the clouds are downsampled with voxels
+///        that are `overload.voxel_size_scale` times larger, see
+///        overload_management::LoadMonitor.
 class VOXEL_GRID_NODES_PUBLIC VoxelCloudNode : public rclcpp::Node
 {
 public:
@@ -49,21 +53,42 @@ public:
   VoxelCloudNode(
     const rclcpp::NodeOptions & node_options);
 
-  /// \brief Core run loop
-  void callback(const sensor_msgs::msg::PointCloud2::SharedPtr msg);
+  /// \brief Core run loop. If intra-process communication is enabled, the downsampled cloud
+  ///        is published as a unique pointer so that intra-process subscribers receive it
+  ///        without a copy.
+  void callback(const sensor_msgs::msg::PointCloud2::ConstSharedPtr msg);
 
 private:
-  /// \brief Initialize state transition callbacks and voxel grid
+  /// \brief Initialize a voxel grid
   /// \param[in] cfg Configuration object for voxel grid
   /// \param[in] is_approximate whether to instantiate an approximate or centroid voxel grid
-  void VOXEL_GRID_NODES_LOCAL init(const voxel_grid::Config & cfg, const bool8_t is_approximate);
+  /// \return The voxel grid
+  static std::unique_ptr<algorithm::VoxelCloudBase> VOXEL_GRID_NODES_LOCAL init(
+    const voxel_grid::Config & cfg, const bool8_t is_approximate);
+  /// \brief Initialize a voxel grid that sorts the points by voxel index instead of hashing them
+  /// \param[in] cfg Configuration object for voxel grid
+  /// \param[in] is_approximate whether to instantiate an approximate or centroid voxel grid
+  /// \param[in] point_capacity maximum number of points of an input cloud
+  /// \param[in] num_threads number of threads to downsample on
+  /// \return The voxel grid
+  static std::unique_ptr<algorithm::VoxelCloudBase> VOXEL_GRID_NODES_LOCAL init_flat(
+    const voxel_grid::Config & cfg,
+    const bool8_t is_approximate,
+    const std::size_t point_capacity,
+    const std::size_t num_threads);
 
   using Message = sensor_msgs::msg::PointCloud2;
 
   const rclcpp::Subscription<Message>::SharedPtr m_sub_ptr;
   const std::shared_ptr<rclcpp::Publisher<Message>> m_pub_ptr;
   std::unique_ptr<algorithm::VoxelCloudBase> m_voxelgrid_ptr;
+  /// The voxel grid with the larger voxels while the node is degraded, null if overload
+  /// management is off
+  std::unique_ptr<algorithm::VoxelCloudBase> m_overload_voxelgrid_ptr;
   bool8_t m_has_failed;
+  const bool8_t m_use_intra_process;
+  autoware::common::overload_management::LoadMonitor m_load_monitor;
+  const autoware::common::overload_management::CallbackId m_points_load_id;
 };  // VoxelCloudNode
 }  // namespace voxel_grid_nodes
 }  // namespace filters
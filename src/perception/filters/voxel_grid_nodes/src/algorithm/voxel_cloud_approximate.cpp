@@ -14,13 +14,12 @@
 //
 // Co-developed by Tier IV, Inc. and Apex.AI, Inc.
 
-#include <cstring>
-
 #include "lidar_utils/point_cloud_utils.hpp"
+#include "lidar_utils/point_layout.hpp"
 #include "voxel_grid_nodes/algorithm/voxel_cloud_approximate.hpp"
 
 using autoware::common::lidar_utils::add_point_to_cloud;
-using autoware::common::lidar_utils::has_intensity_and_throw_if_no_xyz;
+using autoware::common::lidar_utils::PointCloudView;
 
 namespace autoware
 {
@@ -53,26 +52,12 @@ void VoxelCloudApproximate::insert(
   if ((msg.data.size() != msg.row_step) || (data_length != msg.row_step)) {
     throw std::runtime_error("VoxelCloudApproximate: Malformed PointCloud2");
   }
-  // Verify the point cloud format and assign correct point_step
-  constexpr auto field_size = sizeof(decltype(autoware::common::types::PointXYZIF::x));
-  auto point_step = 4U * field_size;
-  if (!has_intensity_and_throw_if_no_xyz(msg)) {
-    point_step = 3U * field_size;
-  }
+  // Verify the point cloud format once, x, y and z are required and intensity is optional
+  const PointCloudView<PointXYZIF> view{msg, 3U, 4U};
 
-  // Iterate through the data, but skip intensity in case the point cloud does not have it.
-  // For example:
-  //
-  // point_step = 4
-  // x y z i a b c x y z i a b c
-  // ^------       ^------
-  for (std::size_t idx = 0U; idx < msg.data.size(); idx += msg.point_step) {
-    PointXYZIF pt;
-    //lint -e{925, 9110} Need to convert pointers and use bit for external API NOLINT
-    (void)memmove(
-      static_cast<void *>(&pt.x),
-      static_cast<const void *>(&msg.data[idx]),
-      point_step);
+  // Iterate through the points, intensity is 0 in case the point cloud does not have it
+  for (std::size_t idx = 0U; idx < view.size(); ++idx) {
+    const PointXYZIF pt = view[idx];
     m_grid.insert(pt);
   }
   // TODO(c.ho) overlay?
@@ -95,6 +80,13 @@ const sensor_msgs::msg::PointCloud2 & VoxelCloudApproximate::get()
 
   return m_cloud;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+std::unique_ptr<sensor_msgs::msg::PointCloud2> VoxelCloudApproximate::release()
+{
+  (void)get();
+  return autoware::common::lidar_utils::release_pcl_msg(m_cloud, m_grid.capacity());
+}
 }  // namespace algorithm
 }  // namespace voxel_grid_nodes
 }  // namespace filters
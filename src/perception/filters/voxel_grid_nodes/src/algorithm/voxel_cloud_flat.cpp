@@ -0,0 +1,97 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#include "lidar_utils/point_cloud_utils.hpp"
+#include "lidar_utils/point_layout.hpp"
+#include "voxel_grid_nodes/algorithm/voxel_cloud_flat.hpp"
+
+using autoware::common::lidar_utils::add_point_to_cloud;
+using autoware::common::lidar_utils::PointCloudView;
+
+namespace autoware
+{
+namespace perception
+{
+namespace filters
+{
+namespace voxel_grid_nodes
+{
+namespace algorithm
+{
+template<typename VoxelT>
+VoxelCloudFlat<VoxelT>::VoxelCloudFlat(
+  const voxel_grid::Config & cfg,
+  const std::size_t point_capacity)
+: VoxelCloudBase(),
+  m_cloud(),
+  m_grid(cfg, point_capacity)
+{
+  // frame id is arbitrary, not the responsibility of this component
+  autoware::common::lidar_utils::init_pcl_msg(m_cloud, "base_link", cfg.get_capacity());
+}
+
+template<typename VoxelT>
+void VoxelCloudFlat<VoxelT>::insert(
+  const sensor_msgs::msg::PointCloud2 & msg)
+{
+  m_cloud.header = msg.header;
+
+  // Verify the consistency of PointCloud msg
+  const auto data_length = msg.width * msg.height * msg.point_step;
+  if ((msg.data.size() != msg.row_step) || (data_length != msg.row_step)) {
+    throw std::runtime_error("VoxelCloudFlat: Malformed PointCloud2");
+  }
+  // Verify the point cloud format once, x, y and z are required and intensity is optional
+  const PointCloudView<PointXYZIF> view{msg, 3U, 4U};
+
+  // Iterate through the points, intensity is 0 in case the point cloud does not have it
+  for (std::size_t idx = 0U; idx < view.size(); ++idx) {
+    const PointXYZIF pt = view[idx];
+    m_grid.insert(pt);
+  }
+}
+
+template<typename VoxelT>
+const sensor_msgs::msg::PointCloud2 & VoxelCloudFlat<VoxelT>::get()
+{
+  // resetting the index for the pointcloud iterators
+  autoware::common::lidar_utils::reset_pcl_msg(m_cloud, m_grid.capacity(), m_point_cloud_idx);
+
+  for (const auto & it : m_grid.reduce()) {
+    const auto & pt = it.second.get();
+    (void)add_point_to_cloud(m_cloud, pt, m_point_cloud_idx);
+    // Don't need to check if cloud can't fit since it has the same capacity as the grid
+    // reduce will throw if the grid is at capacity
+  }
+  autoware::common::lidar_utils::resize_pcl_msg(m_cloud, m_point_cloud_idx);
+
+  return m_cloud;
+}
+
+template<typename VoxelT>
+std::unique_ptr<sensor_msgs::msg::PointCloud2> VoxelCloudFlat<VoxelT>::release()
+{
+  (void)get();
+  return autoware::common::lidar_utils::release_pcl_msg(m_cloud, m_grid.capacity());
+}
+
+template class VoxelCloudFlat<voxel_grid::CentroidVoxel<voxel_grid::PointXYZIF>>;
+template class VoxelCloudFlat<voxel_grid::ApproximateVoxel<voxel_grid::PointXYZIF>>;
+}  // namespace algorithm
+}  // namespace voxel_grid_nodes
+}  // namespace filters
+}  // namespace perception
+}  // namespace autoware
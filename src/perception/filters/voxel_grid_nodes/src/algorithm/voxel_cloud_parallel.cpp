@@ -0,0 +1,248 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+#include "lidar_utils/point_cloud_utils.hpp"
+#include "lidar_utils/point_layout.hpp"
+#include "voxel_grid_nodes/algorithm/voxel_cloud_parallel.hpp"
+
+using autoware::common::lidar_utils::add_point_to_cloud_raw;
+using autoware::common::lidar_utils::PointCloudView;
+
+namespace autoware
+{
+namespace perception
+{
+namespace filters
+{
+namespace voxel_grid_nodes
+{
+namespace algorithm
+{
+namespace
+{
+// Number of high bits of the voxel index that the points are bucketed by
+constexpr uint32_t BUCKET_BITS = 10U;
+}  // namespace
+
+template<typename VoxelT>
+VoxelCloudParallel<VoxelT>::VoxelCloudParallel(
+  const voxel_grid::Config & cfg,
+  const std::size_t point_capacity,
+  const std::size_t num_threads)
+: VoxelCloudBase(),
+  m_config(cfg),
+  m_point_capacity{point_capacity},
+  m_num_threads{num_threads},
+  m_key_bits{voxel_grid::details::index_bits(cfg)},
+  m_bucket_shift{(m_key_bits > BUCKET_BITS) ? (m_key_bits - BUCKET_BITS) : 0U},
+  m_cloud()
+{
+  if (m_num_threads == 0U) {
+    throw std::domain_error("VoxelCloudParallel: Number of threads must be positive");
+  }
+  if (m_point_capacity > static_cast<std::size_t>(std::numeric_limits<uint32_t>::max())) {
+    throw std::domain_error("VoxelCloudParallel: Point capacity must fit into 32 bits");
+  }
+  // frame id is arbitrary, not the responsibility of this component
+  autoware::common::lidar_utils::init_pcl_msg(m_cloud, "base_link", cfg.get_capacity());
+  m_points.reserve(m_point_capacity);
+  m_keys.reserve(m_point_capacity);
+  m_keys_tmp.reserve(m_point_capacity);
+  m_order.reserve(m_point_capacity);
+  m_order_tmp.reserve(m_point_capacity);
+  m_bucket_counts.resize(std::size_t{1U} << BUCKET_BITS);
+  m_begin.resize(m_num_threads + 1U);
+  m_voxels.resize(m_num_threads);
+  for (auto & voxels : m_voxels) {
+    voxels.reserve(cfg.get_capacity());
+  }
+  m_voxel_offsets.resize(m_num_threads);
+  m_overrun.resize(m_num_threads);
+}
+
+template<typename VoxelT>
+void VoxelCloudParallel<VoxelT>::insert(
+  const sensor_msgs::msg::PointCloud2 & msg)
+{
+  m_cloud.header = msg.header;
+
+  // Verify the consistency of PointCloud msg
+  const auto data_length = msg.width * msg.height * msg.point_step;
+  if ((msg.data.size() != msg.row_step) || (data_length != msg.row_step)) {
+    throw std::runtime_error("VoxelCloudParallel: Malformed PointCloud2");
+  }
+  // Verify the point cloud format once, x, y and z are required and intensity is optional
+  const PointCloudView<PointXYZIF> view{msg, 3U, 4U};
+
+  // Iterate through the points, intensity is 0 in case the point cloud does not have it
+  for (std::size_t idx = 0U; idx < view.size(); ++idx) {
+    if (m_points.size() >= m_point_capacity) {
+      throw std::length_error("VoxelCloudParallel: insertion would overrun point capacity");
+    }
+    const PointXYZIF pt = view[idx];
+    m_keys.push_back(m_config.index(pt));
+    m_points.push_back(pt);
+  }
+}
+
+template<typename VoxelT>
+const sensor_msgs::msg::PointCloud2 & VoxelCloudParallel<VoxelT>::get()
+{
+  // resetting the index for the pointcloud iterators
+  autoware::common::lidar_utils::reset_pcl_msg(
+    m_cloud, m_config.get_capacity(), m_point_cloud_idx);
+
+  if (!m_points.empty()) {
+    partition();
+    run(&VoxelCloudParallel::reduce);
+    m_points.clear();
+    m_keys.clear();
+    // The parts of the threads are concatenated in the output cloud
+    std::size_t num_voxels = 0U;
+    bool8_t overrun = false;
+    for (std::size_t thread_idx = 0U; thread_idx < m_num_threads; ++thread_idx) {
+      overrun = overrun || (m_overrun[thread_idx] != 0U);
+      m_voxel_offsets[thread_idx] = static_cast<uint32_t>(num_voxels);
+      num_voxels += m_voxels[thread_idx].size();
+    }
+    if (overrun || (num_voxels > m_config.get_capacity())) {
+      throw std::length_error("VoxelCloudParallel: reduction would overrun capacity");
+    }
+    run(&VoxelCloudParallel::write);
+    m_point_cloud_idx = static_cast<uint32_t>(num_voxels);
+  }
+  autoware::common::lidar_utils::resize_pcl_msg(m_cloud, m_point_cloud_idx);
+
+  return m_cloud;
+}
+
+template<typename VoxelT>
+std::unique_ptr<sensor_msgs::msg::PointCloud2> VoxelCloudParallel<VoxelT>::release()
+{
+  (void)get();
+  return autoware::common::lidar_utils::release_pcl_msg(m_cloud, m_config.get_capacity());
+}
+
+template<typename VoxelT>
+std::size_t VoxelCloudParallel<VoxelT>::get_num_threads() const
+{
+  return m_num_threads;
+}
+
+template<typename VoxelT>
+void VoxelCloudParallel<VoxelT>::partition()
+{
+  const std::size_t num_points = m_keys.size();
+  // Within capacity, so nothing is allocated
+  m_keys_tmp.resize(num_points);
+  m_order.resize(num_points);
+  m_order_tmp.resize(num_points);
+  std::fill(m_bucket_counts.begin(), m_bucket_counts.end(), 0U);
+  for (const auto key : m_keys) {
+    ++m_bucket_counts[key >> m_bucket_shift];
+  }
+  // A thread gets whole buckets until it has about its share of the points
+  std::size_t thread_idx = 1U;
+  std::size_t offset = 0U;
+  m_begin[0U] = 0U;
+  for (auto & count : m_bucket_counts) {
+    while ((thread_idx < m_num_threads) && (offset >= ((num_points * thread_idx) / m_num_threads)))
+    {
+      m_begin[thread_idx] = offset;
+      ++thread_idx;
+    }
+    const std::size_t next = offset + count;
+    count = offset;
+    offset = next;
+  }
+  for (; thread_idx <= m_num_threads; ++thread_idx) {
+    m_begin[thread_idx] = num_points;
+  }
+  // Stable counting sort by bucket
+  for (std::size_t idx = 0U; idx < num_points; ++idx) {
+    const std::size_t dst = m_bucket_counts[m_keys[idx] >> m_bucket_shift]++;
+    m_keys_tmp[dst] = m_keys[idx];
+    m_order_tmp[dst] = static_cast<uint32_t>(idx);
+  }
+  m_keys.swap(m_keys_tmp);
+  m_order.swap(m_order_tmp);
+}
+
+template<typename VoxelT>
+void VoxelCloudParallel<VoxelT>::reduce(const std::size_t thread_idx)
+{
+  Voxels & voxels = m_voxels[thread_idx];
+  voxels.clear();
+  m_overrun[thread_idx] = 0U;
+  const std::size_t begin = m_begin[thread_idx];
+  const std::size_t end = m_begin[thread_idx + 1U];
+  // The range has whole buckets, so it only mixes with the ranges of other threads once sorted
+  voxel_grid::details::radix_sort(
+    m_keys.data() + begin, m_order.data() + begin, m_keys_tmp.data() + begin,
+    m_order_tmp.data() + begin, end - begin, 0U, m_key_bits);
+  for (std::size_t idx = begin; idx < end; ++idx) {
+    const uint64_t key = m_keys[idx];
+    if (voxels.empty() || (voxels.back().first != key)) {
+      if (voxels.size() >= m_config.get_capacity()) {
+        m_overrun[thread_idx] = 1U;
+        return;
+      }
+      voxels.emplace_back(key, VoxelT{});
+      //lint -e{523} NOLINT This is to support multiple voxel implementations
+      voxels.back().second.configure(m_config, key);
+    }
+    voxels.back().second.add_observation(m_points[m_order[idx]]);
+  }
+}
+
+template<typename VoxelT>
+void VoxelCloudParallel<VoxelT>::write(const std::size_t thread_idx)
+{
+  const Voxels & voxels = m_voxels[thread_idx];
+  const uint32_t offset = m_voxel_offsets[thread_idx];
+  for (std::size_t idx = 0U; idx < voxels.size(); ++idx) {
+    // Don't need to check if cloud can't fit since the number of voxels was checked
+    (void)add_point_to_cloud_raw(
+      m_cloud, voxels[idx].second.get(), offset + static_cast<uint32_t>(idx));
+  }
+}
+
+template<typename VoxelT>
+void VoxelCloudParallel<VoxelT>::run(void (VoxelCloudParallel::* fn)(std::size_t))
+{
+  std::vector<std::thread> workers;
+  workers.reserve(m_num_threads - 1U);
+  for (std::size_t thread_idx = 1U; thread_idx < m_num_threads; ++thread_idx) {
+    workers.emplace_back([this, fn, thread_idx] {(this->*fn)(thread_idx);});
+  }
+  (this->*fn)(0U);
+  for (auto & worker : workers) {
+    worker.join();
+  }
+}
+
+template class VoxelCloudParallel<voxel_grid::CentroidVoxel<voxel_grid::PointXYZIF>>;
+template class VoxelCloudParallel<voxel_grid::ApproximateVoxel<voxel_grid::PointXYZIF>>;
+}  // namespace algorithm
+}  // namespace voxel_grid_nodes
+}  // namespace filters
+}  // namespace perception
+}  // namespace autoware
@@ -20,6 +20,8 @@
 #include <voxel_grid_nodes/voxel_cloud_node.hpp>
 #include <voxel_grid_nodes/algorithm/voxel_cloud_approximate.hpp>
 #include <voxel_grid_nodes/algorithm/voxel_cloud_centroid.hpp>
+#include <voxel_grid_nodes/algorithm/voxel_cloud_flat.hpp>
+#include <voxel_grid_nodes/algorithm/voxel_cloud_parallel.hpp>
 #include <common/types.hpp>
 #include <rclcpp_components/register_node_macro.hpp>
 
@@ -30,6 +32,8 @@
 using autoware::common::types::bool8_t;
 using autoware::common::types::uchar8_t;
 using autoware::common::types::float32_t;
+using autoware::common::types::float64_t;
+using autoware::common::overload_management::LoadScope;
 
 namespace autoware
 {
@@ -66,7 +70,11 @@ VoxelCloudNode::VoxelCloudNode(
         )
       )
     )},
-  m_has_failed{false}
+  m_has_failed{false},
+  m_use_intra_process{node_options.use_intra_process_comms()},
+  // Coarser voxels are the second work the perception pipeline sheds
+  m_load_monitor{*this, 2},
+  m_points_load_id{m_load_monitor.add_callback("points", 20.0)}
 {
   // Build config manually (messages only have default constructors)
   voxel_grid::PointXYZ min_point;
@@ -84,16 +92,59 @@ VoxelCloudNode::VoxelCloudNode(
   const std::size_t capacity =
     static_cast<std::size_t>(declare_parameter("config.capacity").get<std::size_t>());
   const voxel_grid::Config cfg{min_point, max_point, voxel_size, capacity};
+  const bool8_t is_approximate = declare_parameter("is_approximate").get<bool8_t>();
+  const bool8_t use_flat_grid = declare_parameter("flat_grid.enabled", false);
+  const auto num_threads = declare_parameter("number_of_threads", 1);
+  if (num_threads < 1) {
+    throw std::runtime_error("VoxelCloudNode: number_of_threads must be positive");
+  }
+  const auto voxel_size_scale = declare_parameter("overload.voxel_size_scale", 2.0);
+  if (voxel_size_scale < 1.0) {
+    throw std::runtime_error("VoxelCloudNode: overload.voxel_size_scale must be at least 1");
+  }
+  voxel_grid::PointXYZ coarse_voxel_size;
+  coarse_voxel_size.x = static_cast<float32_t>(static_cast<float64_t>(voxel_size.x) *
+    voxel_size_scale);
+  coarse_voxel_size.y = static_cast<float32_t>(static_cast<float64_t>(voxel_size.y) *
+    voxel_size_scale);
+  coarse_voxel_size.z = static_cast<float32_t>(static_cast<float64_t>(voxel_size.z) *
+    voxel_size_scale);
+  const voxel_grid::Config coarse_cfg{min_point, max_point, coarse_voxel_size, capacity};
   // Init
-  init(cfg, declare_parameter("is_approximate").get<bool8_t>());
+  if (use_flat_grid || (num_threads > 1)) {
+    const auto point_capacity = declare_parameter("flat_grid.point_capacity", 300000);
+    if (point_capacity < 1) {
+      throw std::runtime_error("VoxelCloudNode: flat_grid.point_capacity must be positive");
+    }
+    m_voxelgrid_ptr = init_flat(
+      cfg, is_approximate, static_cast<std::size_t>(point_capacity),
+      static_cast<std::size_t>(num_threads));
+    if (m_load_monitor.enabled()) {
+      m_overload_voxelgrid_ptr = init_flat(
+        coarse_cfg, is_approximate, static_cast<std::size_t>(point_capacity),
+        static_cast<std::size_t>(num_threads));
+    }
+  } else {
+    m_voxelgrid_ptr = init(cfg, is_approximate);
+    if (m_load_monitor.enabled()) {
+      m_overload_voxelgrid_ptr = init(coarse_cfg, is_approximate);
+    }
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void VoxelCloudNode::callback(const sensor_msgs::msg::PointCloud2::SharedPtr msg)
+void VoxelCloudNode::callback(const sensor_msgs::msg::PointCloud2::ConstSharedPtr msg)
 {
+  const LoadScope load_scope{m_load_monitor, m_points_load_id};
   try {
-    m_voxelgrid_ptr->insert(*msg);
-    m_pub_ptr->publish(m_voxelgrid_ptr->get());
+    auto & voxelgrid = (m_overload_voxelgrid_ptr && m_load_monitor.degraded()) ?
+      *m_overload_voxelgrid_ptr : *m_voxelgrid_ptr;
+    voxelgrid.insert(*msg);
+    if (m_use_intra_process) {
+      m_pub_ptr->publish(voxelgrid.release());
+    } else {
+      m_pub_ptr->publish(voxelgrid.get());
+    }
   } catch (const std::exception & e) {
     std::string err_msg{get_name()};
     err_msg += ": " + std::string(e.what());
@@ -107,17 +158,37 @@ void VoxelCloudNode::callback(const sensor_msgs::msg::PointCloud2::SharedPtr msg
   }
 }
 ////////////////////////////////////////////////////////////////////////////////
-void VoxelCloudNode::init(const voxel_grid::Config & cfg, const bool8_t is_approximate)
+std::unique_ptr<algorithm::VoxelCloudBase> VoxelCloudNode::init(
+  const voxel_grid::Config & cfg, const bool8_t is_approximate)
 {
   // construct voxel grid
   if (is_approximate) {
-    m_voxelgrid_ptr = std::make_unique<algorithm::VoxelCloudApproximate>(cfg);
-  } else {
-    m_voxelgrid_ptr = std::make_unique<algorithm::VoxelCloudCentroid>(cfg);
+    return std::make_unique<algorithm::VoxelCloudApproximate>(cfg);
   }
+  return std::make_unique<algorithm::VoxelCloudCentroid>(cfg);
 }
 
 /////////////////////////////////////////////////////////////////////////////
+std::unique_ptr<algorithm::VoxelCloudBase> VoxelCloudNode::init_flat(
+  const voxel_grid::Config & cfg,
+  const bool8_t is_approximate,
+  const std::size_t point_capacity,
+  const std::size_t num_threads)
+{
+  // construct voxel grid
+  if (num_threads > 1U) {
+    if (is_approximate) {
+      return std::make_unique<algorithm::VoxelCloudParallelApproximate>(
+        cfg, point_capacity, num_threads);
+    }
+    return std::make_unique<algorithm::VoxelCloudParallelCentroid>(
+      cfg, point_capacity, num_threads);
+  } else if (is_approximate) {
+    return std::make_unique<algorithm::VoxelCloudFlatApproximate>(cfg, point_capacity);
+  }
+  return std::make_unique<algorithm::VoxelCloudFlatCentroid>(cfg, point_capacity);
+}
+
 rmw_qos_durability_policy_t parse_durability_parameter(
   const std::string & durability)
 {
@@ -19,10 +19,16 @@
 #include <rclcpp/rclcpp.hpp>
 #include <voxel_grid_nodes/algorithm/voxel_cloud_approximate.hpp>
 #include <voxel_grid_nodes/algorithm/voxel_cloud_centroid.hpp>
+#include <voxel_grid_nodes/algorithm/voxel_cloud_flat.hpp>
+#include <voxel_grid_nodes/algorithm/voxel_cloud_parallel.hpp>
 #include <voxel_grid_nodes/voxel_cloud_node.hpp>
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
 #include <memory>
 #include <vector>
 
@@ -32,6 +38,9 @@ using autoware::perception::filters::voxel_grid::Config;
 using autoware::perception::filters::voxel_grid_nodes::algorithm::VoxelCloudBase;
 using autoware::perception::filters::voxel_grid_nodes::algorithm::VoxelCloudApproximate;
 using autoware::perception::filters::voxel_grid_nodes::algorithm::VoxelCloudCentroid;
+using autoware::perception::filters::voxel_grid_nodes::algorithm::VoxelCloudFlatApproximate;
+using autoware::perception::filters::voxel_grid_nodes::algorithm::VoxelCloudFlatCentroid;
+using autoware::perception::filters::voxel_grid_nodes::algorithm::VoxelCloudParallelCentroid;
 using autoware::perception::filters::voxel_grid::PointXYZIF;
 
 using autoware::common::types::bool8_t;
@@ -214,6 +223,146 @@ TEST_F(CloudAlgorithm, centroid)
   EXPECT_EQ(alg_ptr->get().width, 0U);
 }
 
+TEST_F(CloudAlgorithm, flat)
+{
+  this->ref_points1[0U] = this->make(-0.75F, -0.75F, -0.75F);
+  this->ref_points1[1U] = this->make(0.75F, -0.75F, -0.75F);
+  this->ref_points1[2U] = this->make(-0.75F, 0.75F, -0.75F);
+  this->ref_points1[3U] = this->make(0.75F, 0.75F, -0.75F);
+  this->ref_points1[4U] = this->make(-0.75F, -0.75F, 0.75F);
+  this->ref_points1[5U] = this->make(0.75F, -0.75F, 0.75F);
+  this->ref_points1[6U] = this->make(-0.75F, 0.75F, 0.75F);
+  this->ref_points1[7U] = this->make(0.75F, 0.75F, 0.75F);
+  // initialize
+  alg_ptr = std::make_unique<VoxelCloudFlatCentroid>(*cfg_ptr, 2U * obs_points1.size());
+  // check empty
+  EXPECT_EQ(alg_ptr->get().width, 0U);
+  // add points
+  alg_ptr->insert(cloud1);
+  // get
+  EXPECT_TRUE(check(alg_ptr->get(), 4U));
+  // check empty
+  EXPECT_EQ(alg_ptr->get().width, 0U);
+  // add more points
+  alg_ptr->insert(cloud1);
+  alg_ptr->insert(cloud2);
+  // get again
+  const auto & cloud = alg_ptr->get();
+  EXPECT_EQ(cloud.width, ref_points1.size());
+  EXPECT_TRUE(check(cloud, ref_points1.size()));
+  // check empty
+  EXPECT_EQ(alg_ptr->get().width, 0U);
+  // too many points
+  alg_ptr->insert(cloud2);
+  alg_ptr->insert(cloud2);
+  EXPECT_THROW(alg_ptr->insert(cloud1), std::length_error);
+
+  this->ref_points1[0U] = this->make(-0.5F, -0.5F, -0.5F);
+  this->ref_points1[1U] = this->make(0.5F, -0.5F, -0.5F);
+  this->ref_points1[2U] = this->make(-0.5F, 0.5F, -0.5F);
+  this->ref_points1[3U] = this->make(0.5F, 0.5F, -0.5F);
+  alg_ptr = std::make_unique<VoxelCloudFlatApproximate>(*cfg_ptr, obs_points1.size());
+  alg_ptr->insert(cloud1);
+  const auto released = alg_ptr->release();
+  ASSERT_NE(released, nullptr);
+  EXPECT_EQ(released->width, 4U);
+  EXPECT_TRUE(check(*released, 4U));
+}
+
+TEST_F(CloudAlgorithm, parallel)
+{
+  VoxelCloudFlatCentroid flat{*cfg_ptr, 2U * obs_points1.size()};
+  flat.insert(cloud1);
+  flat.insert(cloud2);
+  const auto expected = flat.get();
+  EXPECT_THROW(VoxelCloudParallelCentroid(*cfg_ptr, obs_points1.size(), 0U), std::domain_error);
+  for (std::size_t num_threads = 1U; num_threads <= 4U; ++num_threads) {
+    VoxelCloudParallelCentroid parallel{*cfg_ptr, 2U * obs_points1.size(), num_threads};
+    EXPECT_EQ(parallel.get_num_threads(), num_threads);
+    // check empty
+    EXPECT_EQ(parallel.get().width, 0U);
+    parallel.insert(cloud1);
+    parallel.insert(cloud2);
+    // same points in the same order as on a single thread
+    const auto & cloud = parallel.get();
+    EXPECT_EQ(cloud.width, expected.width);
+    EXPECT_EQ(cloud.data, expected.data);
+    EXPECT_EQ(parallel.get().width, 0U);
+    // too many points
+    parallel.insert(cloud2);
+    parallel.insert(cloud2);
+    EXPECT_THROW(parallel.insert(cloud1), std::length_error);
+  }
+}
+
+// Not a pass/fail test, prints the run time on clouds of the size of a fused scan
+TEST(voxel_cloud_parallel, benchmark)
+{
+  PointXYZ min_point;
+  min_point.x = -130.0F;
+  min_point.y = -130.0F;
+  min_point.z = -3.0F;
+  PointXYZ max_point;
+  max_point.x = 130.0F;
+  max_point.y = 130.0F;
+  max_point.z = 3.0F;
+  PointXYZ voxel_size;
+  voxel_size.x = 0.2F;
+  voxel_size.y = 0.2F;
+  voxel_size.z = 0.2F;
+  const std::size_t num_points = 300000U;
+  const Config cfg{min_point, max_point, voxel_size, num_points};
+  // Denser close to the sensor, like a lidar scan
+  sensor_msgs::msg::PointCloud2 cloud;
+  point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZIF> mod{cloud, "frame_id"};
+  for (std::size_t idx = 0U; idx < num_points; ++idx) {
+    const float32_t ring = static_cast<float32_t>(idx % 32U);
+    const float32_t angle = static_cast<float32_t>(idx / 32U) * 0.00067F;
+    const float32_t radius = 3.0F + (ring * ring * 0.1F);
+    PointXYZIF pt;
+    pt.x = radius * std::cos(angle);
+    pt.y = radius * std::sin(angle);
+    pt.z = -2.0F + (ring * 0.1F);
+    pt.intensity = ring;
+    mod.push_back(pt);
+  }
+  VoxelCloudFlatCentroid flat{cfg, num_points};
+  flat.insert(cloud);
+  const auto expected = flat.get();
+  for (const std::size_t num_threads : {1U, 2U, 4U, 8U}) {
+    VoxelCloudParallelCentroid parallel{cfg, num_points, num_threads};
+    auto best = std::chrono::nanoseconds::max();
+    for (auto iter = 0U; iter < 5U; ++iter) {
+      const auto start = std::chrono::steady_clock::now();
+      parallel.insert(cloud);
+      const auto & output = parallel.get();
+      best = std::min(best, std::chrono::steady_clock::now() - start);
+      ASSERT_EQ(output.data, expected.data);
+    }
+    std::cout << num_threads << " threads: " <<
+      std::chrono::duration_cast<std::chrono::microseconds>(best).count() << " us for " <<
+      num_points << " points" << std::endl;
+  }
+}
+
+TEST_F(CloudAlgorithm, release)
+{
+  this->ref_points1[0U] = this->make(-0.5F, -0.5F, -0.5F);
+  this->ref_points1[1U] = this->make(0.5F, -0.5F, -0.5F);
+  this->ref_points1[2U] = this->make(-0.5F, 0.5F, -0.5F);
+  this->ref_points1[3U] = this->make(0.5F, 0.5F, -0.5F);
+  alg_ptr = std::make_unique<VoxelCloudApproximate>(*cfg_ptr);
+  alg_ptr->insert(cloud1);
+  const auto released = alg_ptr->release();
+  ASSERT_NE(released, nullptr);
+  EXPECT_EQ(released->width, 4U);
+  EXPECT_TRUE(check(*released, 4U));
+  // the internal cloud is reinitialized and the grid is empty
+  EXPECT_EQ(alg_ptr->get().width, 0U);
+  alg_ptr->insert(cloud1);
+  EXPECT_TRUE(check(alg_ptr->get(), 4U));
+}
+
 TEST(voxel_grid_nodes, instantiate)
 {
   // Basic test to ensure that VoxelCloudNode can be instantiated
@@ -0,0 +1,165 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief A rolling 2D occupancy grid around the ego vehicle, updated with the obstacle points of
+///        each cloud
+
+#ifndef OCCUPANCY_GRID__OCCUPANCY_GRID_HPP_
+#define OCCUPANCY_GRID__OCCUPANCY_GRID_HPP_
+
+#include <occupancy_grid/visibility_control.hpp>
+
+#include <common/types.hpp>
+#include <nav_msgs/msg/occupancy_grid.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace autoware
+{
+namespace perception
+{
+namespace occupancy_grid
+{
+using autoware::common::types::bool8_t;
+using autoware::common::types::float32_t;
+using autoware::common::types::float64_t;
+
+/// \brief Bounds of the log-odds of the cells, a cell that was never observed is at 0
+constexpr int8_t MIN_LOG_ODDS = -100;
+constexpr int8_t MAX_LOG_ODDS = 100;
+
+/// \brief Configuration of the RollingOccupancyGrid, the log-odds are in the units of the cells
+///        between MIN_LOG_ODDS and MAX_LOG_ODDS
+struct OCCUPANCY_GRID_PUBLIC OccupancyGridConfig
+{
+  /// Side length of the square cells in meters
+  float32_t resolution_m{0.2F};
+  /// Number of cells along each side of the square grid
+  std::size_t size_cells{512U};
+  /// Added to the log-odds of a cell with an obstacle point
+  int8_t hit_increment{30};
+  /// Subtracted from the log-odds of a cell that a ray to an obstacle point passes through
+  int8_t miss_decrement{10};
+  /// Cells with at least these log-odds are occupied
+  int8_t occupied_threshold{30};
+  /// Cells with at most these log-odds are free
+  int8_t free_threshold{-20};
+  /// Obstacle points further than this from the sensor are ignored
+  float32_t max_range_m{50.0F};
+};
+
+/// \brief A point in the plane of the fixed frame of the grid
+struct OCCUPANCY_GRID_PUBLIC Point2d
+{
+  float64_t x{0.0};
+  float64_t y{0.0};
+};
+
+/// \brief What is known about a cell
+enum class CellState : uint8_t
+{
+  UNKNOWN = 0U,
+  FREE,
+  OCCUPIED
+};
+
+/// \brief A square log-odds occupancy grid in a fixed frame, e.g. odom, which follows the ego
+///        vehicle. The cells are stored in a ring buffer in both directions, so that moving the
+///        grid only resets the rows and columns that scroll in, and each cloud only updates the
+///        cells of its rays.
+class OCCUPANCY_GRID_PUBLIC RollingOccupancyGrid
+{
+public:
+  /// \brief Constructor of a grid centered on the origin of the fixed frame, with all cells
+  ///        unknown
+  /// \param[in] config The configuration
+  /// \throw std::domain_error If the resolution or the range isn't positive, if the size is 0 or
+  ///                          above 2^15, if the increments aren't positive, or if the free
+  ///                          threshold isn't below the occupied one
+  explicit RollingOccupancyGrid(const OccupancyGridConfig & config);
+
+  /// \brief Move the grid so that a position is at its center, on whole cells. The cells that
+  ///        scroll in are unknown.
+  /// \param[in] position The position in the fixed frame, e.g. of the ego vehicle
+  void recenter(const Point2d & position);
+
+  /// \brief Update the grid with the obstacle points of a cloud: the cells of the points become
+  ///        more occupied and the cells in between the sensor and the points more free. Each
+  ///        cell is updated at most once per call, a cell with a point isn't cleared by the rays
+  ///        to other points.
+  /// \param[in] sensor The position of the sensor in the fixed frame. If it is outside of the
+  ///                   grid, the cells are not cleared.
+  /// \param[in] obstacles The obstacle points in the fixed frame, e.g. the nonground points
+  void update(const Point2d & sensor, const std::vector<Point2d> & obstacles);
+
+  /// \brief Get the state of the cell of a point
+  /// \param[in] point The point in the fixed frame
+  /// \return The state of the cell, unknown outside of the grid
+  CellState state(const Point2d & point) const noexcept;
+
+  /// \brief Get the log-odds of the cell of a point
+  /// \param[in] point The point in the fixed frame
+  /// \return The log-odds of the cell, 0 outside of the grid
+  int8_t log_odds(const Point2d & point) const noexcept;
+
+  /// \brief Write the grid into a message, the header isn't changed. Unknown cells are -1, the
+  ///        others are their log-odds mapped linearly from [MIN_LOG_ODDS, MAX_LOG_ODDS] onto
+  ///        [0, 100], so that cells at 0 are unknown.
+  /// \param[out] grid The message, its data is resized to the number of cells
+  void to_msg(nav_msgs::msg::OccupancyGrid & grid) const;
+
+  /// \brief Get the corner of the grid with the smallest coordinates, in the fixed frame
+  /// \return The corner of the grid
+  Point2d origin() const noexcept;
+
+  /// \brief Get the configuration
+  /// \return The configuration
+  const OccupancyGridConfig & get_config() const noexcept;
+
+private:
+  /// Index of the cell of a coordinate in the fixed frame, in cells of the fixed frame
+  OCCUPANCY_GRID_LOCAL int64_t to_cell(const float64_t coordinate) const noexcept;
+  /// Position of a cell of the fixed frame in the ring buffer along one direction
+  OCCUPANCY_GRID_LOCAL std::size_t wrap(const int64_t cell) const noexcept;
+  /// Storage index of the cell of a point, or false if it is outside of the grid
+  OCCUPANCY_GRID_LOCAL bool8_t find_cell(const Point2d & point, std::size_t & index) const noexcept;
+  /// Reset the cells of a range of columns (or rows) of the fixed frame
+  OCCUPANCY_GRID_LOCAL void clear_columns(const int64_t begin, const int64_t end);
+  OCCUPANCY_GRID_LOCAL void clear_rows(const int64_t begin, const int64_t end);
+  /// Lower the log-odds of the cells from the sensor towards a point, without the cell of the
+  /// point, until the grid ends
+  OCCUPANCY_GRID_LOCAL void clear_ray(const Point2d & sensor, const Point2d & point);
+
+  OccupancyGridConfig m_config;
+  std::size_t m_size;
+  // The cell of the fixed frame of the corner of the grid
+  int64_t m_origin_col;
+  int64_t m_origin_row;
+  // Row major ring buffer, the cell (col, row) of the fixed frame is at
+  // wrap(row) * m_size + wrap(col)
+  std::vector<int8_t> m_cells;
+  // The update in which each cell was last hit or cleared, so that it changes once per update:
+  // 2 * n if it was hit in update n and 2 * n + 1 if it was cleared
+  std::vector<uint32_t> m_stamps;
+  std::vector<std::size_t> m_hit_cells;
+  uint32_t m_hit_stamp;
+};  // class RollingOccupancyGrid
+}  // namespace occupancy_grid
+}  // namespace perception
+}  // namespace autoware
+
+#endif  // OCCUPANCY_GRID__OCCUPANCY_GRID_HPP_
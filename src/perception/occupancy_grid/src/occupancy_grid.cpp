@@ -0,0 +1,318 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "occupancy_grid/occupancy_grid.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+
+namespace autoware
+{
+namespace perception
+{
+namespace occupancy_grid
+{
+namespace
+{
+constexpr std::size_t MAX_SIZE_CELLS = 1U << 15U;
+
+const OccupancyGridConfig & validate(const OccupancyGridConfig & config)
+{
+  if (!std::isfinite(config.resolution_m) || (config.resolution_m <= 0.0F)) {
+    throw std::domain_error{"RollingOccupancyGrid: the resolution must be positive"};
+  }
+  if ((config.size_cells == 0U) || (config.size_cells > MAX_SIZE_CELLS)) {
+    throw std::domain_error{"RollingOccupancyGrid: the size must be in [1, 2^15] cells"};
+  }
+  if ((config.hit_increment <= 0) || (config.miss_decrement <= 0)) {
+    throw std::domain_error{"RollingOccupancyGrid: the log-odds increments must be positive"};
+  }
+  if ((config.free_threshold >= config.occupied_threshold) ||
+    (config.free_threshold < MIN_LOG_ODDS) || (config.occupied_threshold > MAX_LOG_ODDS))
+  {
+    throw std::domain_error{
+            "RollingOccupancyGrid: the thresholds must be ordered and within the log-odds bounds"};
+  }
+  if (!std::isfinite(config.max_range_m) || (config.max_range_m <= 0.0F)) {
+    throw std::domain_error{"RollingOccupancyGrid: the range must be positive"};
+  }
+  return config;
+}
+
+// Message value of the log-odds of a cell
+int8_t to_occupancy(const int8_t log_odds)
+{
+  if (log_odds == 0) {
+    return -1;
+  }
+  return static_cast<int8_t>((static_cast<int32_t>(log_odds) - MIN_LOG_ODDS) / 2);
+}
+}  // namespace
+
+RollingOccupancyGrid::RollingOccupancyGrid(const OccupancyGridConfig & config)
+: m_config{validate(config)},
+  m_size{config.size_cells},
+  m_origin_col{-static_cast<int64_t>(config.size_cells / 2U)},
+  m_origin_row{-static_cast<int64_t>(config.size_cells / 2U)},
+  m_cells(config.size_cells * config.size_cells, 0),
+  m_stamps(config.size_cells * config.size_cells, 0U),
+  m_hit_cells{},
+  m_hit_stamp{0U}
+{
+}
+
+void RollingOccupancyGrid::recenter(const Point2d & position)
+{
+  const auto half_size = static_cast<int64_t>(m_size / 2U);
+  const auto size = static_cast<int64_t>(m_size);
+  const auto origin_col = to_cell(position.x) - half_size;
+  const auto origin_row = to_cell(position.y) - half_size;
+  const auto col_shift = origin_col - m_origin_col;
+  const auto row_shift = origin_row - m_origin_row;
+  if ((std::llabs(col_shift) >= size) || (std::llabs(row_shift) >= size)) {
+    std::fill(m_cells.begin(), m_cells.end(), int8_t{0});
+  } else {
+    // Only the columns and rows that scroll in are reset, they hold the ones that scrolled out
+    if (col_shift > 0) {
+      clear_columns(m_origin_col + size, origin_col + size);
+    } else if (col_shift < 0) {
+      clear_columns(origin_col, m_origin_col);
+    }
+    if (row_shift > 0) {
+      clear_rows(m_origin_row + size, origin_row + size);
+    } else if (row_shift < 0) {
+      clear_rows(origin_row, m_origin_row);
+    }
+  }
+  m_origin_col = origin_col;
+  m_origin_row = origin_row;
+}
+
+void RollingOccupancyGrid::update(const Point2d & sensor, const std::vector<Point2d> & obstacles)
+{
+  if (m_hit_stamp >= (std::numeric_limits<uint32_t>::max() - 3U)) {
+    std::fill(m_stamps.begin(), m_stamps.end(), 0U);
+    m_hit_stamp = 0U;
+  }
+  m_hit_stamp += 2U;
+  const auto max_range = static_cast<float64_t>(m_config.max_range_m);
+  const auto in_range = [&sensor, max_range](const Point2d & point) {
+      return std::hypot(point.x - sensor.x, point.y - sensor.y) <= max_range;
+    };
+
+  // The cells with points first, so that the rays don't clear them
+  m_hit_cells.clear();
+  for (const auto & point : obstacles) {
+    std::size_t index = 0U;
+    if (in_range(point) && find_cell(point, index) && (m_stamps[index] != m_hit_stamp)) {
+      m_stamps[index] = m_hit_stamp;
+      m_hit_cells.push_back(index);
+    }
+  }
+  std::size_t sensor_index = 0U;
+  if (find_cell(sensor, sensor_index)) {
+    for (const auto & point : obstacles) {
+      if (in_range(point)) {
+        clear_ray(sensor, point);
+      }
+    }
+  }
+  for (const auto index : m_hit_cells) {
+    m_cells[index] = static_cast<int8_t>(std::min(
+        static_cast<int32_t>(m_cells[index]) + m_config.hit_increment, int32_t{MAX_LOG_ODDS}));
+  }
+}
+
+CellState RollingOccupancyGrid::state(const Point2d & point) const noexcept
+{
+  std::size_t index = 0U;
+  if (!find_cell(point, index)) {
+    return CellState::UNKNOWN;
+  }
+  const auto value = m_cells[index];
+  if (value >= m_config.occupied_threshold) {
+    return CellState::OCCUPIED;
+  }
+  if (value <= m_config.free_threshold) {
+    return CellState::FREE;
+  }
+  return CellState::UNKNOWN;
+}
+
+int8_t RollingOccupancyGrid::log_odds(const Point2d & point) const noexcept
+{
+  std::size_t index = 0U;
+  return find_cell(point, index) ? m_cells[index] : int8_t{0};
+}
+
+void RollingOccupancyGrid::to_msg(nav_msgs::msg::OccupancyGrid & grid) const
+{
+  const auto resolution = static_cast<float64_t>(m_config.resolution_m);
+  grid.info.resolution = m_config.resolution_m;
+  grid.info.width = static_cast<uint32_t>(m_size);
+  grid.info.height = static_cast<uint32_t>(m_size);
+  grid.info.origin.position.x = static_cast<float64_t>(m_origin_col) * resolution;
+  grid.info.origin.position.y = static_cast<float64_t>(m_origin_row) * resolution;
+  grid.info.origin.position.z = 0.0;
+  grid.info.origin.orientation.x = 0.0;
+  grid.info.origin.orientation.y = 0.0;
+  grid.info.origin.orientation.z = 0.0;
+  grid.info.origin.orientation.w = 1.0;
+  grid.data.resize(m_size * m_size);
+  // Each row of the ring buffer is unrolled in two contiguous pieces
+  const auto first_col = wrap(m_origin_col);
+  for (std::size_t row = 0U; row < m_size; ++row) {
+    const auto source = m_cells.begin() +
+      static_cast<std::ptrdiff_t>(wrap(m_origin_row + static_cast<int64_t>(row)) * m_size);
+    const auto target = grid.data.begin() + static_cast<std::ptrdiff_t>(row * m_size);
+    const auto split = source + static_cast<std::ptrdiff_t>(first_col);
+    const auto next = std::transform(split, source + static_cast<std::ptrdiff_t>(m_size), target,
+        to_occupancy);
+    (void)std::transform(source, split, next, to_occupancy);
+  }
+}
+
+Point2d RollingOccupancyGrid::origin() const noexcept
+{
+  const auto resolution = static_cast<float64_t>(m_config.resolution_m);
+  Point2d corner;
+  corner.x = static_cast<float64_t>(m_origin_col) * resolution;
+  corner.y = static_cast<float64_t>(m_origin_row) * resolution;
+  return corner;
+}
+
+const OccupancyGridConfig & RollingOccupancyGrid::get_config() const noexcept
+{
+  return m_config;
+}
+
+int64_t RollingOccupancyGrid::to_cell(const float64_t coordinate) const noexcept
+{
+  return static_cast<int64_t>(
+    std::floor(coordinate / static_cast<float64_t>(m_config.resolution_m)));
+}
+
+std::size_t RollingOccupancyGrid::wrap(const int64_t cell) const noexcept
+{
+  const auto size = static_cast<int64_t>(m_size);
+  return static_cast<std::size_t>(((cell % size) + size) % size);
+}
+
+bool8_t RollingOccupancyGrid::find_cell(const Point2d & point, std::size_t & index) const noexcept
+{
+  if (!std::isfinite(point.x) || !std::isfinite(point.y)) {
+    return false;
+  }
+  const auto col = to_cell(point.x);
+  const auto row = to_cell(point.y);
+  const auto size = static_cast<int64_t>(m_size);
+  if ((col < m_origin_col) || (col >= m_origin_col + size) ||
+    (row < m_origin_row) || (row >= m_origin_row + size))
+  {
+    return false;
+  }
+  index = (wrap(row) * m_size) + wrap(col);
+  return true;
+}
+
+void RollingOccupancyGrid::clear_columns(const int64_t begin, const int64_t end)
+{
+  for (auto col = begin; col < end; ++col) {
+    const auto storage_col = wrap(col);
+    for (std::size_t row = 0U; row < m_size; ++row) {
+      m_cells[(row * m_size) + storage_col] = 0;
+    }
+  }
+}
+
+void RollingOccupancyGrid::clear_rows(const int64_t begin, const int64_t end)
+{
+  for (auto row = begin; row < end; ++row) {
+    const auto first = m_cells.begin() + static_cast<std::ptrdiff_t>(wrap(row) * m_size);
+    std::fill(first, first + static_cast<std::ptrdiff_t>(m_size), int8_t{0});
+  }
+}
+
+void RollingOccupancyGrid::clear_ray(const Point2d & sensor, const Point2d & point)
+{
+  // Walk the cells crossed by the segment, in cells relative to the corner of the grid
+  const auto resolution = static_cast<float64_t>(m_config.resolution_m);
+  const auto start_x = (sensor.x / resolution) - static_cast<float64_t>(m_origin_col);
+  const auto start_y = (sensor.y / resolution) - static_cast<float64_t>(m_origin_row);
+  const auto end_x = (point.x / resolution) - static_cast<float64_t>(m_origin_col);
+  const auto end_y = (point.y / resolution) - static_cast<float64_t>(m_origin_row);
+  auto col = static_cast<int64_t>(std::floor(start_x));
+  auto row = static_cast<int64_t>(std::floor(start_y));
+  const auto end_col = static_cast<int64_t>(std::floor(end_x));
+  const auto end_row = static_cast<int64_t>(std::floor(end_y));
+  const auto dx = end_x - start_x;
+  const auto dy = end_y - start_y;
+  const int64_t col_step = (dx > 0.0) ? 1 : -1;
+  const int64_t row_step = (dy > 0.0) ? 1 : -1;
+  constexpr auto infinity = std::numeric_limits<float64_t>::infinity();
+  const auto col_delta = (dx != 0.0) ? (1.0 / std::fabs(dx)) : infinity;
+  const auto row_delta = (dy != 0.0) ? (1.0 / std::fabs(dy)) : infinity;
+  auto next_col_t = (dx > 0.0) ? ((static_cast<float64_t>(col + 1) - start_x) * col_delta) :
+    ((start_x - static_cast<float64_t>(col)) * col_delta);
+  auto next_row_t = (dy > 0.0) ? ((static_cast<float64_t>(row + 1) - start_y) * row_delta) :
+    ((start_y - static_cast<float64_t>(row)) * row_delta);
+  if (dx == 0.0) {
+    next_col_t = infinity;
+  }
+  if (dy == 0.0) {
+    next_row_t = infinity;
+  }
+
+  // The position in the ring buffer follows the steps, and each step goes towards the end cell,
+  // so the number of steps is bounded even if rounding picks another path
+  const auto size = static_cast<int64_t>(m_size);
+  auto storage_col = wrap(m_origin_col + col);
+  auto storage_row = wrap(m_origin_row + row);
+  const auto num_steps = std::llabs(end_col - col) + std::llabs(end_row - row);
+  for (int64_t step = 0; step < num_steps; ++step) {
+    const auto index = (storage_row * m_size) + storage_col;
+    // Earlier updates have smaller stamps
+    if (m_stamps[index] < m_hit_stamp) {
+      m_stamps[index] = m_hit_stamp + 1U;
+      m_cells[index] = static_cast<int8_t>(std::max(
+          static_cast<int32_t>(m_cells[index]) - m_config.miss_decrement,
+          int32_t{MIN_LOG_ODDS}));
+    }
+    if ((next_col_t < next_row_t) ? (col != end_col) : (row == end_row)) {
+      col += col_step;
+      next_col_t += col_delta;
+      if ((col < 0) || (col >= size)) {
+        break;
+      }
+      storage_col = (col_step > 0) ?
+        ((storage_col + 1U == m_size) ? 0U : (storage_col + 1U)) :
+        ((storage_col == 0U) ? (m_size - 1U) : (storage_col - 1U));
+    } else {
+      row += row_step;
+      next_row_t += row_delta;
+      if ((row < 0) || (row >= size)) {
+        break;
+      }
+      storage_row = (row_step > 0) ?
+        ((storage_row + 1U == m_size) ? 0U : (storage_row + 1U)) :
+        ((storage_row == 0U) ? (m_size - 1U) : (storage_row - 1U));
+    }
+  }
+}
+}  // namespace occupancy_grid
+}  // namespace perception
+}  // namespace autoware
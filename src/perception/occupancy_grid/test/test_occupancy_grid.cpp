@@ -0,0 +1,163 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <occupancy_grid/occupancy_grid.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+using autoware::perception::occupancy_grid::CellState;
+using autoware::perception::occupancy_grid::OccupancyGridConfig;
+using autoware::perception::occupancy_grid::Point2d;
+using autoware::perception::occupancy_grid::RollingOccupancyGrid;
+using autoware::perception::occupancy_grid::MAX_LOG_ODDS;
+using autoware::common::types::float64_t;
+
+namespace
+{
+Point2d point(const float64_t x, const float64_t y)
+{
+  Point2d pt;
+  pt.x = x;
+  pt.y = y;
+  return pt;
+}
+
+// 1 m cells so that the cell centers are easy to write down
+OccupancyGridConfig make_config()
+{
+  OccupancyGridConfig config;
+  config.resolution_m = 1.0F;
+  config.size_cells = 40U;
+  config.max_range_m = 15.0F;
+  return config;
+}
+}  // namespace
+
+TEST(RollingOccupancyGrid, bad_config)
+{
+  auto config = make_config();
+  config.resolution_m = 0.0F;
+  EXPECT_THROW(RollingOccupancyGrid{config}, std::domain_error);
+  config = make_config();
+  config.size_cells = 0U;
+  EXPECT_THROW(RollingOccupancyGrid{config}, std::domain_error);
+  config = make_config();
+  config.miss_decrement = 0;
+  EXPECT_THROW(RollingOccupancyGrid{config}, std::domain_error);
+  config = make_config();
+  config.free_threshold = config.occupied_threshold;
+  EXPECT_THROW(RollingOccupancyGrid{config}, std::domain_error);
+  config = make_config();
+  config.max_range_m = -1.0F;
+  EXPECT_THROW(RollingOccupancyGrid{config}, std::domain_error);
+}
+
+TEST(RollingOccupancyGrid, hits_and_rays)
+{
+  RollingOccupancyGrid grid{make_config()};
+  const auto sensor = point(0.5, 0.5);
+  // two points behind each other, a diagonal one, and one out of range
+  const std::vector<Point2d> obstacles{
+    point(5.5, 0.5), point(10.5, 0.5), point(-4.5, -4.5), point(0.5, 18.5)};
+  for (int32_t i = 0; i < 5; ++i) {
+    grid.update(sensor, obstacles);
+  }
+  for (const auto & obstacle : {point(5.5, 0.5), point(10.5, 0.5), point(-4.5, -4.5)}) {
+    EXPECT_EQ(grid.state(obstacle), CellState::OCCUPIED);
+    EXPECT_EQ(grid.log_odds(obstacle), MAX_LOG_ODDS);
+  }
+  for (const auto & cleared : {point(0.5, 0.5), point(3.5, 0.5), point(8.5, 0.5),
+      point(-2.5, -2.5)})
+  {
+    EXPECT_EQ(grid.state(cleared), CellState::FREE);
+  }
+  // beyond the points, off the rays, out of range and out of the grid
+  for (const auto & unknown : {point(12.5, 0.5), point(3.5, 3.5), point(0.5, 17.5),
+      point(0.5, 8.5), point(25.5, 0.5)})
+  {
+    EXPECT_EQ(grid.state(unknown), CellState::UNKNOWN);
+    EXPECT_EQ(grid.log_odds(unknown), 0);
+  }
+
+  // an obstacle that went away is cleared by the rays through it
+  for (int32_t i = 0; i < 20; ++i) {
+    grid.update(sensor, {point(10.5, 0.5)});
+  }
+  EXPECT_EQ(grid.state(point(5.5, 0.5)), CellState::FREE);
+  EXPECT_EQ(grid.state(point(10.5, 0.5)), CellState::OCCUPIED);
+}
+
+TEST(RollingOccupancyGrid, recenter)
+{
+  RollingOccupancyGrid grid{make_config()};
+  grid.update(point(0.5, 0.5), {point(5.5, 0.5)});
+  ASSERT_EQ(grid.state(point(5.5, 0.5)), CellState::OCCUPIED);
+  EXPECT_DOUBLE_EQ(grid.origin().x, -20.0);
+  EXPECT_DOUBLE_EQ(grid.origin().y, -20.0);
+
+  // the cells stay at their place in the fixed frame
+  grid.recenter(point(13.7, -8.2));
+  EXPECT_DOUBLE_EQ(grid.origin().x, -7.0);
+  EXPECT_DOUBLE_EQ(grid.origin().y, -29.0);
+  EXPECT_EQ(grid.state(point(5.5, 0.5)), CellState::OCCUPIED);
+  EXPECT_LT(grid.log_odds(point(3.5, 0.5)), 0);
+
+  // the cells that scrolled out and in again are unknown
+  grid.recenter(point(40.0, 0.0));
+  EXPECT_EQ(grid.state(point(5.5, 0.5)), CellState::UNKNOWN);
+  grid.recenter(point(0.0, 0.0));
+  EXPECT_EQ(grid.state(point(5.5, 0.5)), CellState::UNKNOWN);
+  EXPECT_EQ(grid.log_odds(point(3.5, 0.5)), 0);
+
+  // same after a jump over the whole grid
+  grid.update(point(0.5, 0.5), {point(5.5, 0.5)});
+  grid.recenter(point(500.0, 500.0));
+  grid.recenter(point(0.0, 0.0));
+  EXPECT_EQ(grid.state(point(5.5, 0.5)), CellState::UNKNOWN);
+}
+
+TEST(RollingOccupancyGrid, to_msg)
+{
+  RollingOccupancyGrid grid{make_config()};
+  grid.recenter(point(-7.3, 11.9));
+  grid.update(point(-7.3, 11.9), {point(-1.1, 20.2), point(-14.0, 5.0), point(-7.0, 0.0)});
+  nav_msgs::msg::OccupancyGrid msg;
+  grid.to_msg(msg);
+  ASSERT_EQ(msg.info.width, 40U);
+  ASSERT_EQ(msg.info.height, 40U);
+  ASSERT_EQ(msg.data.size(), 1600U);
+  EXPECT_DOUBLE_EQ(msg.info.origin.position.x, grid.origin().x);
+  EXPECT_DOUBLE_EQ(msg.info.origin.position.y, grid.origin().y);
+  std::size_t num_known = 0U;
+  for (uint32_t row = 0U; row < msg.info.height; ++row) {
+    for (uint32_t col = 0U; col < msg.info.width; ++col) {
+      const auto center = point(
+        msg.info.origin.position.x + static_cast<float64_t>(col) + 0.5,
+        msg.info.origin.position.y + static_cast<float64_t>(row) + 0.5);
+      const auto log_odds = static_cast<int32_t>(grid.log_odds(center));
+      const auto value = msg.data[(row * msg.info.width) + col];
+      if (log_odds == 0) {
+        EXPECT_EQ(value, -1);
+      } else {
+        ++num_known;
+        EXPECT_EQ(static_cast<int32_t>(value), (log_odds + 100) / 2);
+      }
+    }
+  }
+  EXPECT_GT(num_known, 10U);
+}
@@ -0,0 +1,81 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief This file defines the OccupancyGridNode class.
+
+#ifndef OCCUPANCY_GRID_NODES__OCCUPANCY_GRID_NODE_HPP_
+#define OCCUPANCY_GRID_NODES__OCCUPANCY_GRID_NODE_HPP_
+
+#include <occupancy_grid_nodes/visibility_control.hpp>
+
+#include <common/types.hpp>
+#include <latency_tracing/tracer.hpp>
+#include <nav_msgs/msg/occupancy_grid.hpp>
+#include <occupancy_grid/occupancy_grid.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
+#include <tf2_ros/buffer.h>
+#include <tf2_ros/transform_listener.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace autoware
+{
+namespace perception
+{
+namespace occupancy_grid_nodes
+{
+using autoware::common::types::float32_t;
+
+/// \brief Maintains a rolling occupancy grid around the origin of the clouds in a fixed frame
+///        from the obstacle points, e.g. the nonground output of the ray ground classifier, and
+///        publishes it after each cloud
+class OCCUPANCY_GRID_NODES_PUBLIC OccupancyGridNode : public rclcpp::Node
+{
+  using PointCloud2 = sensor_msgs::msg::PointCloud2;
+  using OccupancyGrid = nav_msgs::msg::OccupancyGrid;
+
+public:
+  /// \brief Parameter constructor
+  /// \param[in] node_options Additional options to control creation of the node.
+  /// \throw std::domain_error If a parameter is out of its range
+  explicit OccupancyGridNode(const rclcpp::NodeOptions & node_options);
+
+private:
+  /// \brief Update and publish the grid with a cloud, which is dropped if its pose in the fixed
+  ///        frame isn't known
+  void OCCUPANCY_GRID_NODES_LOCAL handle(const PointCloud2::ConstSharedPtr msg_ptr);
+
+  const std::string m_fixed_frame;
+  /// Points of the clouds outside of these heights in the frame of the cloud are ignored
+  const float32_t m_min_z;
+  const float32_t m_max_z;
+  occupancy_grid::RollingOccupancyGrid m_grid;
+  std::vector<occupancy_grid::Point2d> m_points;
+  OccupancyGrid m_grid_msg;
+  std::shared_ptr<tf2_ros::Buffer> m_tf_buffer;
+  std::shared_ptr<tf2_ros::TransformListener> m_tf_listener;
+  const rclcpp::Publisher<OccupancyGrid>::SharedPtr m_grid_pub_ptr;
+  const rclcpp::Subscription<PointCloud2>::SharedPtr m_cloud_sub_ptr;
+  /// The stage of the node in the latency traces of the clouds
+  const autoware::common::latency_tracing::StageId m_trace_stage;
+};  // class OccupancyGridNode
+}  // namespace occupancy_grid_nodes
+}  // namespace perception
+}  // namespace autoware
+
+#endif  // OCCUPANCY_GRID_NODES__OCCUPANCY_GRID_NODE_HPP_
@@ -0,0 +1,39 @@
+# Copyright 2021 The Autoware Foundation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Launch the occupancy grid node on the nonground points of the ray ground classifier."""
+
+import os
+
+from ament_index_python import get_package_share_directory
+import launch.substitutions
+import launch_ros.actions
+
+
+def generate_launch_description():
+    """Launch the occupancy grid node on the nonground points of the ray ground classifier."""
+    default_param_file_path = os.path.join(
+        get_package_share_directory('occupancy_grid_nodes'),
+        'param',
+        'defaults.param.yaml')
+    param_file = launch.substitutions.LaunchConfiguration(
+        'params', default=[default_param_file_path])
+
+    occupancy_grid_node_runner = launch_ros.actions.Node(
+        package='occupancy_grid_nodes',
+        executable='occupancy_grid_node_exe',
+        parameters=[param_file],
+        remappings=[("points_in", "points_nonground")])
+
+    return launch.LaunchDescription([occupancy_grid_node_runner])
@@ -0,0 +1,157 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <occupancy_grid_nodes/occupancy_grid_node.hpp>
+
+#include <lidar_utils/point_layout.hpp>
+#include <rclcpp_components/register_node_macro.hpp>
+#include <tf2/exceptions.h>
+#include <tf2_ros/buffer_interface.h>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+using autoware::common::types::float64_t;
+using autoware::perception::occupancy_grid::MAX_LOG_ODDS;
+using autoware::perception::occupancy_grid::MIN_LOG_ODDS;
+using autoware::perception::occupancy_grid::OccupancyGridConfig;
+
+namespace autoware
+{
+namespace perception
+{
+namespace occupancy_grid_nodes
+{
+namespace
+{
+int8_t declare_log_odds(rclcpp::Node & node, const std::string & name, const int8_t default_value)
+{
+  const auto value = node.declare_parameter(name, static_cast<int64_t>(default_value));
+  if ((value < MIN_LOG_ODDS) || (value > MAX_LOG_ODDS)) {
+    throw std::domain_error{"OccupancyGridNode: " + name + " must be in [-100, 100]"};
+  }
+  return static_cast<int8_t>(value);
+}
+
+OccupancyGridConfig declare_config(rclcpp::Node & node)
+{
+  OccupancyGridConfig config;
+  config.resolution_m = static_cast<float32_t>(node.declare_parameter(
+      "grid.resolution_m", static_cast<float64_t>(config.resolution_m)));
+  const auto size_cells = node.declare_parameter(
+    "grid.size_cells", static_cast<int64_t>(config.size_cells));
+  if (size_cells < 1) {
+    throw std::domain_error{"OccupancyGridNode: grid.size_cells must be positive"};
+  }
+  config.size_cells = static_cast<std::size_t>(size_cells);
+  config.hit_increment = declare_log_odds(node, "grid.hit_increment", config.hit_increment);
+  config.miss_decrement = declare_log_odds(node, "grid.miss_decrement", config.miss_decrement);
+  config.occupied_threshold =
+    declare_log_odds(node, "grid.occupied_threshold", config.occupied_threshold);
+  config.free_threshold = declare_log_odds(node, "grid.free_threshold", config.free_threshold);
+  config.max_range_m = static_cast<float32_t>(node.declare_parameter(
+      "max_range_m", static_cast<float64_t>(config.max_range_m)));
+  return config;
+}
+}  // namespace
+
+OccupancyGridNode::OccupancyGridNode(const rclcpp::NodeOptions & node_options)
+: Node("occupancy_grid_node", node_options),
+  m_fixed_frame{declare_parameter("fixed_frame", std::string{"odom"})},
+  m_min_z{static_cast<float32_t>(declare_parameter("min_z_m", -10.0))},
+  m_max_z{static_cast<float32_t>(declare_parameter("max_z_m", 3.0))},
+  m_grid{declare_config(*this)},
+  m_tf_buffer{std::make_shared<tf2_ros::Buffer>(get_clock())},
+  m_tf_listener{std::make_shared<tf2_ros::TransformListener>(
+      *m_tf_buffer, std::shared_ptr<rclcpp::Node>(this, [](auto) {}), false)},
+  m_grid_pub_ptr{create_publisher<OccupancyGrid>("occupancy_grid", rclcpp::QoS{10})},
+  m_cloud_sub_ptr{create_subscription<PointCloud2>(
+      "points_in", rclcpp::QoS{10},
+      [this](const PointCloud2::ConstSharedPtr msg) {handle(msg);})},
+  m_trace_stage{common::latency_tracing::Tracer::instance().register_stage(
+      get_fully_qualified_name())}
+{
+  if (!(m_min_z < m_max_z)) {
+    throw std::domain_error{"OccupancyGridNode: min_z_m must be below max_z_m"};
+  }
+  const auto & config = m_grid.get_config();
+  m_grid_msg.header.frame_id = m_fixed_frame;
+  m_grid_msg.data.reserve(config.size_cells * config.size_cells);
+}
+
+void OccupancyGridNode::handle(const PointCloud2::ConstSharedPtr msg_ptr)
+{
+  // The grid keeps the stamp of the cloud, so it continues the trace of the cloud
+  common::latency_tracing::TraceScope trace{common::latency_tracing::Tracer::instance(),
+    m_trace_stage};
+  trace.set_trace_id(common::latency_tracing::to_trace_id(msg_ptr->header.stamp));
+
+  geometry_msgs::msg::TransformStamped transform;
+  try {
+    transform = m_tf_buffer->lookupTransform(
+      m_fixed_frame, msg_ptr->header.frame_id, tf2_ros::fromMsg(msg_ptr->header.stamp));
+  } catch (const tf2::TransformException & ex) {
+    RCLCPP_WARN(
+      get_logger(), "Cannot transform %s to %s, dropping the cloud: %s",
+      msg_ptr->header.frame_id.c_str(), m_fixed_frame.c_str(), ex.what());
+    return;
+  }
+
+  try {
+    // Only the rows of the rotation onto the plane of the fixed frame are needed
+    const auto & q = transform.transform.rotation;
+    const auto r00 = 1.0 - (2.0 * ((q.y * q.y) + (q.z * q.z)));
+    const auto r01 = 2.0 * ((q.x * q.y) - (q.w * q.z));
+    const auto r02 = 2.0 * ((q.x * q.z) + (q.w * q.y));
+    const auto r10 = 2.0 * ((q.x * q.y) + (q.w * q.z));
+    const auto r11 = 1.0 - (2.0 * ((q.x * q.x) + (q.z * q.z)));
+    const auto r12 = 2.0 * ((q.y * q.z) - (q.w * q.x));
+    occupancy_grid::Point2d sensor;
+    sensor.x = transform.transform.translation.x;
+    sensor.y = transform.transform.translation.y;
+
+    const common::lidar_utils::PointCloudView<common::types::PointXYZI> view{*msg_ptr, 3U, 3U};
+    m_points.clear();
+    m_points.reserve(view.size());
+    for (std::size_t idx = 0U; idx < view.size(); ++idx) {
+      const auto pt = view[idx];
+      if ((pt.z < m_min_z) || (pt.z > m_max_z)) {
+        continue;
+      }
+      const auto x = static_cast<float64_t>(pt.x);
+      const auto y = static_cast<float64_t>(pt.y);
+      const auto z = static_cast<float64_t>(pt.z);
+      occupancy_grid::Point2d point;
+      point.x = sensor.x + (r00 * x) + (r01 * y) + (r02 * z);
+      point.y = sensor.y + (r10 * x) + (r11 * y) + (r12 * z);
+      m_points.push_back(point);
+    }
+
+    // The rays start at the origin of the frame of the cloud
+    m_grid.recenter(sensor);
+    m_grid.update(sensor, m_points);
+    m_grid.to_msg(m_grid_msg);
+    m_grid_msg.header.stamp = msg_ptr->header.stamp;
+    m_grid_msg.info.map_load_time = msg_ptr->header.stamp;
+    m_grid_pub_ptr->publish(m_grid_msg);
+  } catch (const std::exception & e) {
+    RCLCPP_ERROR(get_logger(), e.what());
+  }
+}
+}  // namespace occupancy_grid_nodes
+}  // namespace perception
+}  // namespace autoware
+
+RCLCPP_COMPONENTS_REGISTER_NODE(autoware::perception::occupancy_grid_nodes::OccupancyGridNode)
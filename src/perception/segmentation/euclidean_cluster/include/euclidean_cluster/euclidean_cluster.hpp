@@ -22,10 +22,18 @@
 #include <autoware_auto_msgs/msg/bounding_box_array.hpp>
 #include <autoware_auto_msgs/msg/detected_objects.hpp>
 #include <autoware_auto_msgs/msg/point_clusters.hpp>
+#include <geometry/bounding_box_2d.hpp>
 #include <geometry/spatial_hash.hpp>
 #include <euclidean_cluster/visibility_control.hpp>
 #include <common/types.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <vector>
 #include <utility>
 
@@ -72,6 +80,10 @@ public:
   /// \brief Get core point
   /// \return Reference to internally stored point
   const PointXYZI & get_point() const;
+  /// \brief Get the index of the point in the order the points were inserted into EuclideanCluster
+  ///        since the last clustering, which ClusterIndices refers to the points by
+  /// \return The insertion index, 0 if the point wasn't inserted
+  uint32_t get_index() const;
   /// \brief Explicit conversion operator from PointXYZIR to msg type PointXYZIF
   /// \return a PointXYZIF type
   explicit operator autoware_auto_msgs::msg::PointXYZIF() const;
@@ -81,12 +93,34 @@ private:
   // uncomfortable doing it that way (12 vs 20 bytes)
   PointXYZI m_point;
   float32_t m_r_xy;
+  uint32_t m_index = 0U;
+  // Only the clustering assigns the insertion index
+  friend class EuclideanCluster;
 };  // class PointXYZIR
 
+/// \brief Pose of the frame of the points in a fixed frame, e.g. odom, projected onto the plane
+struct EUCLIDEAN_CLUSTER_PUBLIC FramePose
+{
+  float32_t x = 0.0f;
+  float32_t y = 0.0f;
+  float32_t yaw = 0.0f;
+};  // struct FramePose
+
 using HashConfig = autoware::common::geometry::spatial_hash::Config2d;
 using Hash = autoware::common::geometry::spatial_hash::SpatialHash2d<PointXYZIR>;
 using Clusters = autoware_auto_msgs::msg::PointClusters;
 
+/// \brief Clusters as the indices of their points into the inserted points instead of copies of
+///        the points, e.g. into the cloud that the points were read from. The layout is the one of
+///        Clusters: the points of all clusters one after the other, and the end of each cluster
+struct EUCLIDEAN_CLUSTER_PUBLIC ClusterIndices
+{
+  /// The insertion indices of the points, see PointXYZIR::get_index()
+  std::vector<uint32_t> point_indices;
+  /// The offset one past the last point of each cluster in point_indices
+  std::vector<uint32_t> cluster_boundary;
+};  // struct ClusterIndices
+
 /// \brief Configuration class for euclidean cluster
 /// In the future this can become a base class with subclasses defining different
 /// threshold functions. This configuration's threshold function currently assumes isotropy, and
@@ -147,6 +181,8 @@ private:
 /// according to euclidean distance. This can be thought of as a graph-based
 /// approach where points are vertices and edges are defined by euclidean distance
 /// The input to this should be nonground points pased through a voxel grid.
+/// With more than one thread, the connected components are instead found with a lock-free
+/// union-find over a grid of columns, see cluster(Clusters &).
 class EUCLIDEAN_CLUSTER_PUBLIC EuclideanCluster
 {
 public:
@@ -155,12 +191,41 @@ public:
     NONE = 0U,
     TOO_MANY_CLUSTERS
   };  // enum class Error
+  /// \brief How the single threaded clustering searches for connected points
+  enum class Search : uint8_t
+  {
+    /// Breadth-first search with a near neighbor query around every point
+    POINTS = 0U,
+    /// Union-find over occupied cells, which finds neighboring cells without near neighbor
+    /// queries
+    VOXELS,
+    /// Voxel search on cells that are fixed in the frame of set_frame_pose(), which reuses the
+    /// connectivity of the cells that didn't change since the previous frame
+    INCREMENTAL_VOXELS
+  };  // enum class Search
   /// \brief Constructor
   /// \param[in] cfg The configuration of the clustering algorithm, contains threshold function
   /// \param[in] hash_cfg The configuration of the underlying spatial hash, controls the maximum
   ///                     number of points in a scene
   EuclideanCluster(const Config & cfg, const HashConfig & hash_cfg);
-  /// \brief Insert an individual point
+  /// \brief Constructor
+  /// \param[in] cfg The configuration of the clustering algorithm, contains threshold function
+  /// \param[in] hash_cfg The configuration of the underlying spatial hash, controls the maximum
+  ///                     number of points in a scene
+  /// \param[in] num_threads The number of threads used for clustering, including the calling
+  ///                        thread. With one thread, clustering uses the given search
+  /// \param[in] search How connected points are searched for with a single thread
+  /// \param[in] refresh_interval With Search::INCREMENTAL_VOXELS, every this many frames the
+  ///                             connectivity of all cells is computed from scratch
+  /// \throw std::domain_error If the number of threads is 0, if there is more than one and a
+  ///                          voxel search is used, if a voxel search is used and the smallest
+  ///                          threshold is not positive, if the capacity of the hash doesn't
+  ///                          fit into the 32 bit insertion indices, or if the search is
+  ///                          Search::INCREMENTAL_VOXELS and the refresh interval is 0
+  EuclideanCluster(
+    const Config & cfg, const HashConfig & hash_cfg, const std::size_t num_threads,
+    const Search search = Search::POINTS, const std::size_t refresh_interval = 10U);
+  /// \brief Insert an individual point, it is given the next insertion index
   /// \param[in] pt The point to insert
   /// \throw std::length_error If the underlying spatial hash is full
   void insert(const PointXYZIR & pt);
@@ -183,8 +248,37 @@ public:
   /// \brief Compute the clusters from the inserted points, where the final clusters object lives in
   ///        another scope.
   /// \param[inout] clusters The clusters object
+  ///
+  /// \note With more than one thread, the points of a cluster and the clusters themselves are
+  ///       ordered by their position in the grid rather than by the search order. The set of
+  ///       clusters is the same.
   void cluster(Clusters & clusters);
 
+  /// \brief Compute the clusters from the inserted points as the insertion indices of their
+  ///        points, without copying the points. The clusters are the same as with
+  ///        cluster(Clusters &), and the next inserted point gets index 0 again
+  /// \param[inout] clusters The clusters object
+  void cluster(ClusterIndices & clusters);
+
+  /// \brief Set the pose of the frame of the points of the next frame in a fixed frame, so that
+  ///        Search::INCREMENTAL_VOXELS finds the cells of the static parts of the scene again
+  ///        while the sensor moves
+  /// \param[in] pose The pose of the frame of the points, e.g. from the odometry
+  void set_frame_pose(const FramePose & pose);
+
+  /// \brief Forget the previous frame, e.g. when its pose is unknown or the scene jumped, so
+  ///        that the next frame is clustered from scratch
+  void reset_history();
+
+  /// \brief Get the number of cells whose connectivity was reused from the previous frame in the
+  ///        last clustering, only nonzero with Search::INCREMENTAL_VOXELS
+  /// \return The number of reused cells
+  std::size_t get_num_reused_cells() const;
+
+  /// \brief Get the number of threads used for clustering, including the calling thread
+  /// \return The number of threads
+  std::size_t get_num_threads() const;
+
   /// \brief Gets last error, intended to be used with clustering with internal cluster result
   /// This is a separate function rather than using an exception because the main error mode is
   /// exceeding preallocated cluster capacity. However, throwing an exception would throw away
@@ -206,26 +300,128 @@ private:
     float32_t x = 0.0f;
     float32_t y = 0.0f;
   };  // struct PointXYZ
+  // The clustering writes either Clusters or ClusterIndices, the templates are instantiated for
+  // both in the source file
+  /// \brief Clear the clusters, cluster with the configured search and restart the indices
+  template<typename ClustersT>
+  EUCLIDEAN_CLUSTER_LOCAL void cluster_dispatch(ClustersT & clusters);
   /// \brief Do the clustering process, with no error checking
-  EUCLIDEAN_CLUSTER_LOCAL void cluster_impl(Clusters & clusters);
+  template<typename ClustersT>
+  EUCLIDEAN_CLUSTER_LOCAL void cluster_impl(ClustersT & clusters);
   /// \brief Compute the next cluster, seeded by the given point, and grown using the remaining
   ///         points still contained in the hash
-  EUCLIDEAN_CLUSTER_LOCAL void cluster(Clusters & clusters, const Hash::IT it);
+  template<typename ClustersT>
+  EUCLIDEAN_CLUSTER_LOCAL void cluster(ClustersT & clusters, const Hash::IT it);
   /// \brief Add all near neighbors of a point to a given cluster
+  template<typename ClustersT>
   EUCLIDEAN_CLUSTER_LOCAL void add_neighbors_to_last_cluster(
-    Clusters & clusters, const PointXY pt);
-  /// \brief Adds a point to the last cluster, internal version since no error checking is needed
-  EUCLIDEAN_CLUSTER_LOCAL static void add_point_to_last_cluster(
-    Clusters & clusters, const PointXYZIR & pt);
-  /// \brief Get a specified point from the cluster
-  EUCLIDEAN_CLUSTER_LOCAL static PointXY get_point_from_last_cluster(
-    const Clusters & clusters, const std::size_t cls_pt_idx);
-  EUCLIDEAN_CLUSTER_LOCAL static std::size_t last_cluster_size(const Clusters & clusters);
+    ClustersT & clusters, const PointXY pt);
+  /// \brief Adds a point to the last cluster and to the points whose neighbors are searched,
+  ///        internal version since no error checking is needed
+  template<typename ClustersT>
+  EUCLIDEAN_CLUSTER_LOCAL void add_point_to_last_cluster(
+    ClustersT & clusters, const PointXYZIR & pt);
+
+  /// \brief A point sorted into the grid of the parallel clustering
+  struct GridPoint
+  {
+    PointXYZIR point;
+    uint32_t row;
+  };  // struct GridPoint
+  /// \brief Bounds of the points that were taken out of the hash
+  struct PointBounds
+  {
+    float32_t min_x;
+    float32_t max_x;
+    float32_t min_y;
+    float32_t max_y;
+    float32_t max_r;
+  };  // struct PointBounds
+  /// \brief Move the points out of the hash into m_points
+  /// \return False if there are no points
+  EUCLIDEAN_CLUSTER_LOCAL bool8_t take_points(PointBounds & bounds);
+  /// \brief Write the components of the points in m_grid that are large enough as clusters
+  template<typename ClustersT>
+  EUCLIDEAN_CLUSTER_LOCAL void write_components(
+    ClustersT & clusters, const std::size_t num_points);
+  /// \brief Do the clustering process on occupied cells: the points are sorted into cells whose
+  ///        diagonal is the smallest threshold, so all points of a cell are connected. Each cell
+  ///        is then merged with the cells within reach of its threshold if any of their points
+  ///        are connected, the cells are found by binary search in the sorted cells
+  template<typename ClustersT>
+  EUCLIDEAN_CLUSTER_LOCAL void cluster_voxels(ClustersT & clusters);
+  /// \brief Find the cells of the previous frame that are still there with as many points, and
+  ///        merge the cells of each component of the previous frame whose cells all are
+  EUCLIDEAN_CLUSTER_LOCAL void reuse_previous_cells(const std::size_t num_cells);
+  /// \brief Keep the cells of this frame and their components for the next frame
+  EUCLIDEAN_CLUSTER_LOCAL void store_history(const std::size_t num_cells, const bool8_t reused);
+  /// \brief Whether any point of a cell is connected to any point of another cell
+  EUCLIDEAN_CLUSTER_LOCAL bool8_t cells_connected(
+    const std::size_t cell, const std::size_t other) const;
+  /// \brief Do the clustering process on multiple threads: the points are sorted into columns as
+  ///        wide as the largest threshold, every thread links the neighbors within its own range
+  ///        of columns, and then the neighbors across the boundaries of the ranges
+  template<typename ClustersT>
+  EUCLIDEAN_CLUSTER_LOCAL void cluster_parallel(ClustersT & clusters);
+  /// \brief Sort the columns of a thread by row and link the neighbors within them
+  EUCLIDEAN_CLUSTER_LOCAL void link_local(const std::size_t thread_idx);
+  /// \brief Link the neighbors between the last column of a thread and the next column
+  EUCLIDEAN_CLUSTER_LOCAL void link_boundary(const std::size_t thread_idx);
+  /// \brief Link a point to the points of a column whose rows are at most one apart from its own
+  EUCLIDEAN_CLUSTER_LOCAL void link_to_column(
+    const std::size_t pt_idx, const std::size_t column_begin, const std::size_t column_end);
+  /// \brief Whether two points satisfy the threshold of each other
+  EUCLIDEAN_CLUSTER_LOCAL bool8_t is_connected(const std::size_t idx, const std::size_t jdx) const;
+  /// \brief Link two points if they satisfy the threshold of each other
+  EUCLIDEAN_CLUSTER_LOCAL void link_if_connected(const std::size_t idx, const std::size_t jdx);
+  /// \brief Find the root of a point with path halving, the root of a component is always its
+  ///        smallest point index
+  EUCLIDEAN_CLUSTER_LOCAL uint32_t find_root(uint32_t idx);
+  /// \brief Merge the components of two points, safe to call concurrently
+  EUCLIDEAN_CLUSTER_LOCAL void merge(uint32_t idx, uint32_t jdx);
+  /// \brief Run a member function on all threads, the calling thread takes index 0
+  EUCLIDEAN_CLUSTER_LOCAL void run(void (EuclideanCluster::* fn)(std::size_t));
 
   const Config m_config;
   Hash m_hash;
   Error m_last_error;
   std::vector<bool8_t> m_seen;
+  const std::size_t m_num_threads;
+  const Search m_search;
+  uint32_t m_num_inserted;
+  // State of the breadth-first search: the points of the current cluster whose neighbors are
+  // searched, so that the search doesn't read them back from the output
+  std::vector<PointXY> m_frontier;
+  // State of the union-find clustering, only allocated if it is used
+  std::vector<PointXYZIR> m_points;
+  std::vector<GridPoint> m_grid;
+  std::vector<std::atomic<uint32_t>> m_parents;
+  std::vector<uint32_t> m_labels;
+  // State of the parallel clustering
+  std::vector<uint32_t> m_point_columns;
+  std::vector<std::size_t> m_column_offsets;
+  std::vector<std::size_t> m_column_cursor;
+  std::vector<std::size_t> m_thread_columns;
+  // State of the voxel search: cell key and point index, sorted by cell
+  std::vector<std::pair<uint64_t, uint32_t>> m_cell_keys;
+  std::vector<uint64_t> m_cells;
+  std::vector<std::size_t> m_cell_offsets;
+  const float32_t m_min_threshold;
+  // State of the incremental voxel search: the cells of the previous frame with their number of
+  // points and the root of their component, and per component the number of cells that weren't
+  // found again and the first cell of this frame that reuses it, and per cell of this frame the
+  // cell of the previous frame that it matches
+  FramePose m_frame_pose;
+  const std::size_t m_refresh_interval;
+  std::size_t m_frames_since_refresh;
+  std::vector<uint64_t> m_previous_cells;
+  std::vector<uint32_t> m_previous_cell_sizes;
+  std::vector<uint32_t> m_previous_cell_roots;
+  std::vector<uint32_t> m_missing_cells;
+  std::vector<uint32_t> m_component_seeds;
+  std::vector<bool8_t> m_reused_cells;
+  std::vector<uint32_t> m_matched_cells;
+  std::size_t m_num_reused_cells;
 };  // class EuclideanCluster
 
 /// \brief Common euclidean cluster functions not intended for external use
@@ -239,9 +435,23 @@ enum class BboxMethod
 {
   Eigenbox,
   LFit,
+  /// L-fit by a coarse to fine search of the orientation, see lfit_search_bounding_box_2d
+  LFitSearch,
 };
+/// \brief Compute the bounding box of a single cluster
+/// \param[inout] clusters A set of clusters, the points of the cluster may get shuffled
+/// \param[in] cls_id The index of the cluster
+/// \param[in] method Whether to use the eigenboxes or an L-Fit algorithm.
+/// \param[in] compute_height Compute the height of the bounding box as well.
+/// \param[out] box The bounding box, only written if the cluster is not empty
+/// \returns False if the cluster is empty and no box was computed
+/// \throw std::exception If the box can't be fitted to the points of the cluster
+EUCLIDEAN_CLUSTER_PUBLIC
+bool8_t compute_bounding_box(
+  Clusters & clusters, const std::size_t cls_id, const BboxMethod method,
+  const bool compute_height, BoundingBox & box);
 /// \brief Compute bounding boxes from clusters
-/// \param[in] method Whether to use the eigenboxes or L-Fit algorithm.
+/// \param[in] method Whether to use the eigenboxes or an L-Fit algorithm.
 /// \param[in] compute_height Compute the height of the bounding box as well.
 /// \param[inout] clusters A set of clusters for which to compute the bounding boxes. Individual
 ///                        clusters may get their points shuffled.
@@ -249,6 +459,146 @@ enum class BboxMethod
 EUCLIDEAN_CLUSTER_PUBLIC
 BoundingBoxArray compute_bounding_boxes(
   Clusters & clusters, const BboxMethod method, const bool compute_height);
+
+/// \brief Forward iterator over the points of a cluster of ClusterIndices, which reads the points
+///        from the inserted points through the indices instead of from a copy of them
+/// \tparam PointsT The inserted points, indexed by insertion index with operator[], e.g. a
+///                 std::vector or a view of the cloud that the points were read from
+template<typename PointsT>
+class IndexedPointIterator
+{
+public:
+  using reference = decltype(std::declval<const PointsT &>()[std::size_t{}]);
+  using value_type = typename std::decay<reference>::type;
+  using difference_type = std::ptrdiff_t;
+  using pointer = void;
+  using iterator_category = std::forward_iterator_tag;
+
+  IndexedPointIterator() = default;
+  /// \brief Constructor
+  /// \param[in] points The inserted points, they must outlive the iterator
+  /// \param[in] index The index of the point the iterator points to
+  IndexedPointIterator(const PointsT & points, const uint32_t * const index)
+  : m_points{&points},
+    m_index{index}
+  {
+  }
+  reference operator*() const
+  {
+    return (*m_points)[static_cast<std::size_t>(*m_index)];
+  }
+  IndexedPointIterator & operator++()
+  {
+    ++m_index;
+    return *this;
+  }
+  IndexedPointIterator operator++(int)
+  {
+    const auto ret = *this;
+    ++m_index;
+    return ret;
+  }
+  bool8_t operator==(const IndexedPointIterator & other) const
+  {
+    return m_index == other.m_index;
+  }
+  bool8_t operator!=(const IndexedPointIterator & other) const
+  {
+    return m_index != other.m_index;
+  }
+
+private:
+  const PointsT * m_points = nullptr;
+  const uint32_t * m_index = nullptr;
+};  // class IndexedPointIterator
+
+/// \brief Compute the bounding box of a single cluster of ClusterIndices, the points are read
+///        through the indices
+/// \param[inout] clusters A set of clusters as indices, the indices of the cluster may get
+///                        shuffled
+/// \param[in] points The inserted points that the indices refer to
+/// \param[in] cls_id The index of the cluster
+/// \param[in] method Whether to use the eigenboxes or an L-Fit algorithm.
+/// \param[in] compute_height Compute the height of the bounding box as well.
+/// \param[out] box The bounding box, only written if the cluster is not empty
+/// \returns False if the cluster is empty and no box was computed
+/// \throw std::exception If the box can't be fitted to the points of the cluster
+/// \tparam PointsT The type of the inserted points, see IndexedPointIterator
+template<typename PointsT>
+bool8_t compute_bounding_box(
+  ClusterIndices & clusters, const PointsT & points, const std::size_t cls_id,
+  const BboxMethod method, const bool compute_height, BoundingBox & box)
+{
+  namespace bounding_box = common::geometry::bounding_box;
+  uint32_t * const first = clusters.point_indices.data() +
+    ((cls_id == 0U) ? 0U : clusters.cluster_boundary[cls_id - 1U]);
+  uint32_t * const last = clusters.point_indices.data() + clusters.cluster_boundary[cls_id];
+  if (first == last) {
+    return false;
+  }
+  using IT = IndexedPointIterator<PointsT>;
+  const IT begin{points, first};
+  const IT end{points, last};
+
+  switch (method) {
+    case BboxMethod::Eigenbox:
+      box = bounding_box::eigenbox_2d(begin, end);
+      break;
+    case BboxMethod::LFit:
+      {
+        // As lfit_bounding_box_2d, but the indices are sorted instead of the points
+        const auto cov = bounding_box::details::covariance_2d(begin, end);
+        if (cov.num_points <= 1U) {
+          throw std::domain_error("LFit requires >= 2 points!");
+        }
+        using PointT = typename IT::value_type;
+        PointT eig1;
+        PointT eig2;
+        (void)bounding_box::details::eig_2d(cov, eig1, eig2);
+        const bounding_box::details::LFitCompare<PointT> compare{eig1};
+        std::partial_sort(
+          first, last, last, [&points, &compare](const uint32_t a, const uint32_t b) {
+            return compare(points[std::size_t{a}], points[std::size_t{b}]);
+          });
+        box = bounding_box::details::lfit_bounding_box_2d_impl(begin, end, cov.num_points);
+      }
+      break;
+    case BboxMethod::LFitSearch:
+      box = bounding_box::lfit_search_bounding_box_2d(begin, end);
+      break;
+  }
+
+  if (compute_height) {
+    bounding_box::compute_height(begin, end, box);
+  }
+  return true;
+}
+/// \brief Compute bounding boxes from clusters of ClusterIndices
+/// \param[inout] clusters A set of clusters as indices for which to compute the bounding boxes.
+///                        Individual clusters may get their indices shuffled.
+/// \param[in] points The inserted points that the indices refer to
+/// \param[in] method Whether to use the eigenboxes or an L-Fit algorithm.
+/// \param[in] compute_height Compute the height of the bounding box as well.
+/// \returns Bounding boxes
+/// \tparam PointsT The type of the inserted points, see IndexedPointIterator
+template<typename PointsT>
+BoundingBoxArray compute_bounding_boxes(
+  ClusterIndices & clusters, const PointsT & points, const BboxMethod method,
+  const bool compute_height)
+{
+  BoundingBoxArray boxes;
+  for (uint32_t cls_id = 0U; cls_id < clusters.cluster_boundary.size(); cls_id++) {
+    try {
+      BoundingBox box;
+      if (compute_bounding_box(clusters, points, cls_id, method, compute_height, box)) {
+        boxes.boxes.push_back(box);
+      }
+    } catch (const std::exception & e) {
+      std::cerr << e.what() << std::endl;
+    }
+  }
+  return boxes;
+}
 /// \brief Convert this bounding box to a DetectedObjects message
 /// \param[in] boxes A bounding box array
 /// \returns A DetectedObjects message with the bounding boxes inside
@@ -17,7 +17,10 @@
 #include <cstring>
 //lint -e537 NOLINT Repeated include file: pclint vs cpplint
 #include <algorithm>
+#include <cmath>
+#include <limits>
 #include <string>
+#include <thread>
 //lint -e537 NOLINT Repeated include file: pclint vs cpplint
 #include <utility>
 #include "euclidean_cluster/euclidean_cluster.hpp"
@@ -31,6 +34,33 @@ namespace segmentation
 {
 namespace euclidean_cluster
 {
+using autoware::common::types::float64_t;
+namespace
+{
+bool8_t is_voxel_search(const EuclideanCluster::Search search)
+{
+  return (EuclideanCluster::Search::VOXELS == search) ||
+         (EuclideanCluster::Search::INCREMENTAL_VOXELS == search);
+}
+
+// The clustering writes the points of the clusters either as copies or as insertion indices
+Clusters::_points_type & output_points(Clusters & clusters)
+{
+  return clusters.points;
+}
+std::vector<uint32_t> & output_points(ClusterIndices & clusters)
+{
+  return clusters.point_indices;
+}
+autoware_auto_msgs::msg::PointXYZIF output_point(const Clusters &, const PointXYZIR & pt)
+{
+  return static_cast<autoware_auto_msgs::msg::PointXYZIF>(pt);
+}
+uint32_t output_point(const ClusterIndices &, const PointXYZIR & pt)
+{
+  return pt.get_index();
+}
+}  // namespace
 ////////////////////////////////////////////////////////////////////////////////
 PointXYZIR::PointXYZIR(const common::types::PointXYZIF & pt)
 : m_point{pt.x, pt.y, pt.z, pt.intensity},
@@ -64,6 +94,11 @@ const PointXYZI & PointXYZIR::get_point() const
   return m_point;
 }
 ////////////////////////////////////////////////////////////////////////////////
+uint32_t PointXYZIR::get_index() const
+{
+  return m_index;
+}
+////////////////////////////////////////////////////////////////////////////////
 PointXYZIR::operator autoware_auto_msgs::msg::PointXYZIF() const
 {
   /*lint -e{1793} it's safe to call non-const member function on a temporary in this case*/
@@ -121,10 +156,81 @@ const std::string & Config::frame_id() const
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 EuclideanCluster::EuclideanCluster(const Config & cfg, const HashConfig & hash_cfg)
+: EuclideanCluster(cfg, hash_cfg, 1U)
+{}
+////////////////////////////////////////////////////////////////////////////////
+EuclideanCluster::EuclideanCluster(
+  const Config & cfg,
+  const HashConfig & hash_cfg,
+  const std::size_t num_threads,
+  const Search search,
+  const std::size_t refresh_interval)
 : m_config(cfg),
   m_hash(hash_cfg),
-  m_last_error(Error::NONE)
-{}
+  m_last_error(Error::NONE),
+  m_num_threads(num_threads),
+  m_search(search),
+  m_num_inserted(0U),
+  m_parents(((num_threads > 1U) || is_voxel_search(search)) ? hash_cfg.get_capacity() : 0U),
+  // The threshold is linear in r until it saturates, so its minimum is at one of the ends
+  m_min_threshold(
+    std::min(cfg.threshold(0.0F), cfg.threshold(std::numeric_limits<float32_t>::max()))),
+  m_refresh_interval(refresh_interval),
+  m_frames_since_refresh(0U),
+  m_num_reused_cells(0U)
+{
+  if (m_num_threads == 0U) {
+    throw std::domain_error{"EuclideanCluster: Number of threads must be positive"};
+  }
+  if ((m_num_threads > 1U) && is_voxel_search(m_search)) {
+    throw std::domain_error{"EuclideanCluster: Voxel search only runs on a single thread"};
+  }
+  if ((Search::INCREMENTAL_VOXELS == m_search) && (m_refresh_interval == 0U)) {
+    throw std::domain_error{"EuclideanCluster: Refresh interval must be positive"};
+  }
+  const std::size_t capacity = hash_cfg.get_capacity();
+  // The insertion indices are 32 bit
+  if (capacity > static_cast<std::size_t>(std::numeric_limits<uint32_t>::max())) {
+    throw std::domain_error{"EuclideanCluster: Capacity must fit into 32 bits"};
+  }
+  if ((m_num_threads == 1U) && !is_voxel_search(m_search)) {
+    m_frontier.reserve(capacity);
+  }
+  if ((m_num_threads > 1U) || is_voxel_search(m_search)) {
+    if (capacity >= static_cast<std::size_t>(std::numeric_limits<uint32_t>::max())) {
+      throw std::domain_error{"EuclideanCluster: Capacity must fit into 32 bits"};
+    }
+    m_points.reserve(capacity);
+    m_grid.resize(capacity);
+    m_labels.resize(capacity);
+  }
+  if (m_num_threads > 1U) {
+    m_point_columns.reserve(capacity);
+    // The number of columns is bounded by the capacity, see cluster_parallel()
+    m_column_offsets.reserve(capacity + 2U);
+    m_column_cursor.reserve(capacity + 1U);
+    m_thread_columns.resize(m_num_threads + 1U);
+  }
+  if (is_voxel_search(m_search)) {
+    if (!std::isnormal(m_min_threshold) || (m_min_threshold < 0.0F)) {
+      throw std::domain_error{"EuclideanCluster: Voxel search needs a positive threshold"};
+    }
+    m_cell_keys.reserve(capacity);
+    // There are at most as many occupied cells as points
+    m_cells.reserve(capacity);
+    m_cell_offsets.reserve(capacity + 1U);
+  }
+  if (Search::INCREMENTAL_VOXELS == m_search) {
+    m_previous_cells.reserve(capacity);
+    m_previous_cell_sizes.reserve(capacity);
+    m_previous_cell_roots.reserve(capacity);
+    // Components are identified by their root, which is a point index
+    m_missing_cells.resize(capacity);
+    m_component_seeds.resize(capacity);
+    m_reused_cells.reserve(capacity);
+    m_matched_cells.reserve(capacity);
+  }
+}
 ////////////////////////////////////////////////////////////////////////////////
 bool Config::match_clusters_size(const Clusters & clusters) const
 {
@@ -140,16 +246,62 @@ bool Config::match_clusters_size(const Clusters & clusters) const
 ////////////////////////////////////////////////////////////////////////////////
 void EuclideanCluster::insert(const PointXYZIR & pt)
 {
+  PointXYZIR indexed_pt{pt};
+  indexed_pt.m_index = m_num_inserted;
   // can't do anything with return values
-  (void)m_hash.insert(pt);
+  (void)m_hash.insert(indexed_pt);
+  // Only counted once inserted, so the indices of the inserted points have no gaps
+  ++m_num_inserted;
 }
 ////////////////////////////////////////////////////////////////////////////////
 void EuclideanCluster::cluster(Clusters & clusters)
+{
+  cluster_dispatch(clusters);
+}
+////////////////////////////////////////////////////////////////////////////////
+void EuclideanCluster::cluster(ClusterIndices & clusters)
+{
+  cluster_dispatch(clusters);
+}
+////////////////////////////////////////////////////////////////////////////////
+template<typename ClustersT>
+void EuclideanCluster::cluster_dispatch(ClustersT & clusters)
 {
   // Clean the previous clustering result
-  clusters.points.clear();
+  output_points(clusters).clear();
   clusters.cluster_boundary.clear();
-  cluster_impl(clusters);
+  if (m_num_threads > 1U) {
+    cluster_parallel(clusters);
+  } else if (is_voxel_search(m_search)) {
+    cluster_voxels(clusters);
+  } else {
+    cluster_impl(clusters);
+  }
+  // The hash is empty again, the next points are of the next frame
+  m_num_inserted = 0U;
+}
+////////////////////////////////////////////////////////////////////////////////
+void EuclideanCluster::set_frame_pose(const FramePose & pose)
+{
+  m_frame_pose = pose;
+}
+////////////////////////////////////////////////////////////////////////////////
+void EuclideanCluster::reset_history()
+{
+  m_previous_cells.clear();
+  m_previous_cell_sizes.clear();
+  m_previous_cell_roots.clear();
+  m_frames_since_refresh = 0U;
+}
+////////////////////////////////////////////////////////////////////////////////
+std::size_t EuclideanCluster::get_num_reused_cells() const
+{
+  return m_num_reused_cells;
+}
+////////////////////////////////////////////////////////////////////////////////
+std::size_t EuclideanCluster::get_num_threads() const
+{
+  return m_num_threads;
 }
 ////////////////////////////////////////////////////////////////////////////////
 void EuclideanCluster::throw_stored_error() const
@@ -174,7 +326,8 @@ const Config & EuclideanCluster::get_config() const
   return m_config;
 }
 ////////////////////////////////////////////////////////////////////////////////
-void EuclideanCluster::cluster_impl(Clusters & clusters)
+template<typename ClustersT>
+void EuclideanCluster::cluster_impl(ClustersT & clusters)
 {
   m_last_error = Error::NONE;
   auto it = m_hash.begin();
@@ -185,7 +338,8 @@ void EuclideanCluster::cluster_impl(Clusters & clusters)
   }
 }
 ////////////////////////////////////////////////////////////////////////////////
-void EuclideanCluster::cluster(Clusters & clusters, const Hash::IT it)
+template<typename ClustersT>
+void EuclideanCluster::cluster(ClustersT & clusters, const Hash::IT it)
 {
   // init new cluster
   if (clusters.cluster_boundary.size() >= m_config.max_num_clusters()) {
@@ -200,13 +354,14 @@ void EuclideanCluster::cluster(Clusters & clusters, const Hash::IT it)
       clusters.cluster_boundary.emplace_back(clusters.cluster_boundary.back());
     }
     // Seed cluster with new point
+    m_frontier.clear();
     add_point_to_last_cluster(clusters, it->second);
     // Erase returns the element after the removed element but it is not useful here
     (void)m_hash.erase(it);
     // Start clustering process
     std::size_t last_cls_pt_idx = 0U;
-    while (last_cls_pt_idx < last_cluster_size(clusters)) {
-      const auto pt = get_point_from_last_cluster(clusters, last_cls_pt_idx);
+    while (last_cls_pt_idx < m_frontier.size()) {
+      const auto pt = m_frontier[last_cls_pt_idx];
       add_neighbors_to_last_cluster(clusters, pt);
       // Increment seed point
       ++last_cls_pt_idx;
@@ -219,8 +374,9 @@ void EuclideanCluster::cluster(Clusters & clusters, const Hash::IT it)
   }
 }
 ////////////////////////////////////////////////////////////////////////////////
+template<typename ClustersT>
 void EuclideanCluster::add_neighbors_to_last_cluster(
-  Clusters & clusters,
+  ClustersT & clusters,
   const EuclideanCluster::PointXY pt)
 {
   // TODO(c.ho) make this more generic... also duplicated work..
@@ -243,45 +399,507 @@ void EuclideanCluster::add_neighbors_to_last_cluster(
   }
 }
 ////////////////////////////////////////////////////////////////////////////////
-void EuclideanCluster::add_point_to_last_cluster(Clusters & clusters, const PointXYZIR & pt)
+template<typename ClustersT>
+void EuclideanCluster::add_point_to_last_cluster(ClustersT & clusters, const PointXYZIR & pt)
 {
+  auto & points = output_points(clusters);
   // If there are non-valid points in the container due to rejecting small clusters,
   // overwrite the non-valid points, otherwise emplace new point
-  if (clusters.cluster_boundary.back() < clusters.points.size()) {
-    clusters.points[clusters.cluster_boundary.back()] =
-      static_cast<autoware_auto_msgs::msg::PointXYZIF>(pt);
+  if (clusters.cluster_boundary.back() < points.size()) {
+    points[clusters.cluster_boundary.back()] = output_point(clusters, pt);
   } else {
-    clusters.points.emplace_back(static_cast<autoware_auto_msgs::msg::PointXYZIF>(pt));
+    points.emplace_back(output_point(clusters, pt));
   }
   clusters.cluster_boundary.back() = clusters.cluster_boundary.back() + 1U;
+  m_frontier.push_back(PointXY{pt.get_point().x, pt.get_point().y});
+}
+////////////////////////////////////////////////////////////////////////////////
+bool8_t EuclideanCluster::take_points(PointBounds & bounds)
+{
+  // Take the points out of the hash, the hash is only used as storage here
+  m_points.clear();
+  for (const auto & bin_pt : m_hash) {
+    m_points.push_back(bin_pt.second);
+  }
+  m_hash.clear();
+  bounds.min_x = std::numeric_limits<float32_t>::max();
+  bounds.max_x = std::numeric_limits<float32_t>::lowest();
+  bounds.min_y = std::numeric_limits<float32_t>::max();
+  bounds.max_y = std::numeric_limits<float32_t>::lowest();
+  bounds.max_r = 0.0F;
+  for (const auto & pt : m_points) {
+    bounds.min_x = std::min(bounds.min_x, pt.get_point().x);
+    bounds.max_x = std::max(bounds.max_x, pt.get_point().x);
+    bounds.min_y = std::min(bounds.min_y, pt.get_point().y);
+    bounds.max_y = std::max(bounds.max_y, pt.get_point().y);
+    bounds.max_r = std::max(bounds.max_r, pt.get_r());
+  }
+  return !m_points.empty();
 }
 ////////////////////////////////////////////////////////////////////////////////
-EuclideanCluster::PointXY EuclideanCluster::get_point_from_last_cluster(
-  const Clusters & clusters,
-  const std::size_t cls_pt_idx)
+template<typename ClustersT>
+void EuclideanCluster::cluster_parallel(ClustersT & clusters)
 {
-  const std::size_t num_of_clusters = clusters.cluster_boundary.size();
-  // num_of_clusters will be at least 1
-  const auto points_idx = (num_of_clusters < 2U) ?
-    cls_pt_idx : (cls_pt_idx + clusters.cluster_boundary[num_of_clusters - 2U]);
-  return PointXY{clusters.points[points_idx].x, clusters.points[points_idx].y};
+  m_last_error = Error::NONE;
+  PointBounds bounds;
+  if (!take_points(bounds)) {
+    return;
+  }
+  const std::size_t num_points = m_points.size();
+  const float32_t min_x = bounds.min_x;
+  const float32_t min_y = bounds.min_y;
+  // The threshold is linear in r until it saturates, so its maximum is at one of the ends. Cells
+  // at least as large as the largest threshold only have neighbors in the adjacent cells; the
+  // padding keeps rounding from pushing neighbors two cells apart. Cells are also large enough
+  // that the number of columns and rows is bounded by the capacity.
+  const float32_t extent = std::max(bounds.max_x - min_x, bounds.max_y - min_y);
+  const float32_t cell_size = std::max(
+    std::max(m_config.threshold(0.0F), m_config.threshold(bounds.max_r)) * 1.001F,
+    std::max(extent / static_cast<float32_t>(m_hash.capacity()),
+    std::numeric_limits<float32_t>::min()));
+  const auto num_columns = std::min(
+    static_cast<std::size_t>((bounds.max_x - min_x) / cell_size) + 1U, m_hash.capacity() + 1U);
+
+  // Counting sort of the points by column, stable so that the output is deterministic
+  m_point_columns.clear();
+  m_column_offsets.assign(num_columns + 1U, 0U);
+  for (const auto & pt : m_points) {
+    const auto column = std::min(
+      static_cast<std::size_t>((pt.get_point().x - min_x) / cell_size), num_columns - 1U);
+    m_point_columns.push_back(static_cast<uint32_t>(column));
+    ++m_column_offsets[column + 1U];
+  }
+  for (std::size_t idx = 1U; idx < m_column_offsets.size(); ++idx) {
+    m_column_offsets[idx] += m_column_offsets[idx - 1U];
+  }
+  m_column_cursor.assign(m_column_offsets.begin(), m_column_offsets.end() - 1);
+  for (std::size_t idx = 0U; idx < num_points; ++idx) {
+    GridPoint & grid_pt = m_grid[m_column_cursor[m_point_columns[idx]]++];
+    grid_pt.point = m_points[idx];
+    grid_pt.row = static_cast<uint32_t>((m_points[idx].get_point().y - min_y) / cell_size);
+  }
+  // Balance the number of points, threads get whole columns
+  std::size_t column = 0U;
+  for (std::size_t thread_idx = 0U; thread_idx < m_num_threads; ++thread_idx) {
+    const std::size_t target = (num_points * thread_idx) / m_num_threads;
+    while (m_column_offsets[column] < target) {
+      ++column;
+    }
+    m_thread_columns[thread_idx] = column;
+  }
+  m_thread_columns[m_num_threads] = num_columns;
+
+  run(&EuclideanCluster::link_local);
+  run(&EuclideanCluster::link_boundary);
+  write_components(clusters, num_points);
 }
 ////////////////////////////////////////////////////////////////////////////////
-std::size_t EuclideanCluster::last_cluster_size(const Clusters & clusters)
+template<typename ClustersT>
+void EuclideanCluster::cluster_voxels(ClustersT & clusters)
 {
-  const std::size_t num_of_clusters = clusters.cluster_boundary.size();
-  if (num_of_clusters < 2U) {
-    return clusters.cluster_boundary.front();
+  m_last_error = Error::NONE;
+  m_num_reused_cells = 0U;
+  const bool8_t incremental = (Search::INCREMENTAL_VOXELS == m_search);
+  PointBounds bounds;
+  if (!take_points(bounds)) {
+    reset_history();
+    return;
+  }
+  const std::size_t num_points = m_points.size();
+  // Any two points in a cell are within the smallest threshold of each other, the padding keeps
+  // rounding from breaking that
+  const float32_t cell_size = m_min_threshold * 0.999F * 0.70710678F;
+  constexpr uint64_t ROW_MASK = 0xFFFFFFFFU;
+  const float32_t max_idx = static_cast<float32_t>(std::numeric_limits<int32_t>::max());
+  m_cell_keys.clear();
+  if (incremental) {
+    // The cells are fixed in the frame of the pose, so that the static parts of the scene fall
+    // into the same cells while the sensor moves. Index 2^31 is the origin so that negative
+    // coordinates fit, which needs double precision.
+    const float64_t cos_yaw = std::cos(static_cast<float64_t>(m_frame_pose.yaw));
+    const float64_t sin_yaw = std::sin(static_cast<float64_t>(m_frame_pose.yaw));
+    const float64_t fixed_cell_size = static_cast<float64_t>(cell_size);
+    const auto to_fixed_cell = [fixed_cell_size](const float64_t coordinate) {
+        const float64_t idx = std::floor(coordinate / fixed_cell_size) + 2147483648.0;
+        return static_cast<uint64_t>(std::min(std::max(idx, 0.0), 4294967295.0));
+      };
+    for (std::size_t idx = 0U; idx < num_points; ++idx) {
+      const PointXYZI & pt = m_points[idx].get_point();
+      const auto px = static_cast<float64_t>(pt.x);
+      const auto py = static_cast<float64_t>(pt.y);
+      const uint64_t cx =
+        to_fixed_cell(((cos_yaw * px) - (sin_yaw * py)) + static_cast<float64_t>(m_frame_pose.x));
+      const uint64_t cy =
+        to_fixed_cell(((sin_yaw * px) + (cos_yaw * py)) + static_cast<float64_t>(m_frame_pose.y));
+      m_cell_keys.emplace_back((cx << 32U) | cy, static_cast<uint32_t>(idx));
+    }
   } else {
-    const auto cluster_size =
-      clusters.cluster_boundary[num_of_clusters - 1U] -
-      clusters.cluster_boundary[num_of_clusters - 2U];
-    return cluster_size;
+    for (std::size_t idx = 0U; idx < num_points; ++idx) {
+      const PointXYZI & pt = m_points[idx].get_point();
+      const auto cx = static_cast<uint64_t>(std::min((pt.x - bounds.min_x) / cell_size, max_idx));
+      const auto cy = static_cast<uint64_t>(std::min((pt.y - bounds.min_y) / cell_size, max_idx));
+      m_cell_keys.emplace_back((cx << 32U) | cy, static_cast<uint32_t>(idx));
+    }
+  }
+  std::sort(m_cell_keys.begin(), m_cell_keys.end());
+
+  // Every cell is a star around its first point
+  m_cells.clear();
+  m_cell_offsets.clear();
+  for (std::size_t idx = 0U; idx < num_points; ++idx) {
+    const uint64_t key = m_cell_keys[idx].first;
+    if (m_cells.empty() || (key != m_cells.back())) {
+      m_cells.push_back(key);
+      m_cell_offsets.push_back(idx);
+    }
+    m_grid[idx].point = m_points[m_cell_keys[idx].second];
+    m_grid[idx].row = static_cast<uint32_t>(key & ROW_MASK);
+    m_parents[idx].store(static_cast<uint32_t>(m_cell_offsets.back()));
+  }
+  const std::size_t num_cells = m_cells.size();
+  m_cell_offsets.push_back(num_points);
+  // The previous frame is reused until it is time for a refresh
+  const bool8_t reuse = incremental && !m_previous_cells.empty() &&
+    (m_frames_since_refresh < m_refresh_interval);
+  if (reuse) {
+    reuse_previous_cells(num_cells);
+  }
+
+  for (std::size_t cell = 0U; cell < num_cells; ++cell) {
+    const auto first = static_cast<uint32_t>(m_cell_offsets[cell]);
+    const uint64_t cx = m_cells[cell] >> 32U;
+    const uint64_t cy = m_cells[cell] & ROW_MASK;
+    // Connected points are within the threshold of both, so within the largest threshold of the
+    // points of this cell
+    float32_t cell_threshold = 0.0F;
+    for (std::size_t idx = first; idx < m_cell_offsets[cell + 1U]; ++idx) {
+      cell_threshold = std::max(cell_threshold, m_config.threshold(m_grid[idx].point));
+    }
+    const auto reach = static_cast<uint64_t>(cell_threshold / cell_size) + 1U;
+    // Only look forward in the order of the cells, so every pair of cells is seen once
+    for (uint64_t ox = cx; ox <= (cx + reach); ++ox) {
+      const uint64_t first_y = (ox == cx) ? (cy + 1U) : ((cy > reach) ? (cy - reach) : 0U);
+      const uint64_t last_key = (ox << 32U) | std::min(cy + reach, ROW_MASK);
+      auto it = std::lower_bound(
+        m_cells.begin() + static_cast<std::ptrdiff_t>(cell + 1U), m_cells.end(),
+        (ox << 32U) | first_y);
+      for (; (it != m_cells.end()) && (*it <= last_key); ++it) {
+        // Skip cells whose closest points are too far apart
+        const uint64_t oy = *it & ROW_MASK;
+        const uint64_t dx = ox - cx;
+        const uint64_t dy = (oy > cy) ? (oy - cy) : (cy - oy);
+        const auto gap_x = static_cast<float32_t>((dx > 0U) ? (dx - 1U) : 0U);
+        const auto gap_y = static_cast<float32_t>((dy > 0U) ? (dy - 1U) : 0U);
+        if ((((gap_x * gap_x) + (gap_y * gap_y)) * cell_size * cell_size) >
+          (cell_threshold * cell_threshold))
+        {
+          continue;
+        }
+        const auto other = static_cast<std::size_t>(it - m_cells.begin());
+        // Reused cells are connected as in the previous frame, which they already are
+        if (reuse && m_reused_cells[cell] && m_reused_cells[other]) {
+          continue;
+        }
+        const auto other_first = static_cast<uint32_t>(m_cell_offsets[other]);
+        if ((find_root(first) != find_root(other_first)) && cells_connected(cell, other)) {
+          merge(first, other_first);
+        }
+      }
+    }
+  }
+  write_components(clusters, num_points);
+  if (incremental) {
+    store_history(num_cells, reuse);
+  }
+}
+////////////////////////////////////////////////////////////////////////////////
+void EuclideanCluster::reuse_previous_cells(const std::size_t num_cells)
+{
+  constexpr uint32_t NO_CELL = std::numeric_limits<uint32_t>::max();
+  const std::size_t num_previous = m_previous_cells.size();
+  for (std::size_t prev = 0U; prev < num_previous; ++prev) {
+    const uint32_t root = m_previous_cell_roots[prev];
+    m_missing_cells[root] = 0U;
+    m_component_seeds[root] = NO_CELL;
+  }
+  for (std::size_t prev = 0U; prev < num_previous; ++prev) {
+    ++m_missing_cells[m_previous_cell_roots[prev]];
+  }
+  // Both frames' cells are sorted, a cell is unchanged if its number of points is the same.
+  // m_reused_cells marks the unchanged cells until it is known which components are complete.
+  m_reused_cells.assign(num_cells, false);
+  m_matched_cells.resize(num_cells);
+  std::size_t prev = 0U;
+  for (std::size_t cell = 0U; (cell < num_cells) && (prev < num_previous); ++cell) {
+    while ((prev < num_previous) && (m_previous_cells[prev] < m_cells[cell])) {
+      ++prev;
+    }
+    if ((prev < num_previous) && (m_previous_cells[prev] == m_cells[cell]) &&
+      (m_previous_cell_sizes[prev] == (m_cell_offsets[cell + 1U] - m_cell_offsets[cell])))
+    {
+      m_reused_cells[cell] = true;
+      m_matched_cells[cell] = static_cast<uint32_t>(prev);
+      --m_missing_cells[m_previous_cell_roots[prev]];
+      ++prev;
+    }
+  }
+  // A component whose cells all are unchanged is still connected, and connected to no other cell
+  // of the previous frame. Components that lost or changed a cell can have split, so all of
+  // their cells are searched again.
+  for (std::size_t cell = 0U; cell < num_cells; ++cell) {
+    if (!m_reused_cells[cell]) {
+      continue;
+    }
+    const uint32_t root = m_previous_cell_roots[m_matched_cells[cell]];
+    if (m_missing_cells[root] != 0U) {
+      m_reused_cells[cell] = false;
+      continue;
+    }
+    const auto first = static_cast<uint32_t>(m_cell_offsets[cell]);
+    if (NO_CELL == m_component_seeds[root]) {
+      m_component_seeds[root] = first;
+    } else {
+      merge(m_component_seeds[root], first);
+    }
+    ++m_num_reused_cells;
+  }
+}
+////////////////////////////////////////////////////////////////////////////////
+void EuclideanCluster::store_history(const std::size_t num_cells, const bool8_t reused)
+{
+  m_previous_cells.assign(m_cells.begin(), m_cells.end());
+  m_previous_cell_sizes.clear();
+  m_previous_cell_roots.clear();
+  for (std::size_t cell = 0U; cell < num_cells; ++cell) {
+    m_previous_cell_sizes.push_back(
+      static_cast<uint32_t>(m_cell_offsets[cell + 1U] - m_cell_offsets[cell]));
+    // The paths are fully compressed by write_components()
+    m_previous_cell_roots.push_back(m_parents[m_cell_offsets[cell]].load());
+  }
+  m_frames_since_refresh = reused ? (m_frames_since_refresh + 1U) : 1U;
+}
+////////////////////////////////////////////////////////////////////////////////
+bool8_t EuclideanCluster::cells_connected(const std::size_t cell, const std::size_t other) const
+{
+  for (std::size_t idx = m_cell_offsets[cell]; idx < m_cell_offsets[cell + 1U]; ++idx) {
+    for (std::size_t jdx = m_cell_offsets[other]; jdx < m_cell_offsets[other + 1U]; ++jdx) {
+      if (is_connected(idx, jdx)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+////////////////////////////////////////////////////////////////////////////////
+template<typename ClustersT>
+void EuclideanCluster::write_components(ClustersT & clusters, const std::size_t num_points)
+{
+  // Roots are the smallest index of their component, so clusters come out ordered by them
+  for (std::size_t idx = 0U; idx < num_points; ++idx) {
+    m_labels[idx] = 0U;
+  }
+  for (std::size_t idx = 0U; idx < num_points; ++idx) {
+    // Fully compress the paths, the threads are done
+    const uint32_t root = find_root(static_cast<uint32_t>(idx));
+    m_parents[idx].store(root);
+    ++m_labels[root];
+  }
+  constexpr uint32_t NO_CLUSTER = std::numeric_limits<uint32_t>::max();
+  std::size_t num_clustered = 0U;
+  for (std::size_t idx = 0U; idx < num_points; ++idx) {
+    if (m_parents[idx].load() != idx) {
+      continue;
+    }
+    // Replace the size of the component by its cluster index
+    const uint32_t size = m_labels[idx];
+    m_labels[idx] = NO_CLUSTER;
+    if (size < m_config.min_cluster_size()) {
+      continue;
+    }
+    if (clusters.cluster_boundary.size() >= m_config.max_num_clusters()) {
+      m_last_error = Error::TOO_MANY_CLUSTERS;
+      continue;
+    }
+    m_labels[idx] = static_cast<uint32_t>(clusters.cluster_boundary.size());
+    clusters.cluster_boundary.emplace_back(static_cast<uint32_t>(num_clustered));
+    num_clustered += size;
+  }
+  // The boundaries are the start offsets of the clusters until the points are scattered
+  auto & points = output_points(clusters);
+  points.resize(num_clustered);
+  for (std::size_t idx = 0U; idx < num_points; ++idx) {
+    const uint32_t label = m_labels[m_parents[idx].load()];
+    if (NO_CLUSTER != label) {
+      points[clusters.cluster_boundary[label]++] = output_point(clusters, m_grid[idx].point);
+    }
+  }
+}
+////////////////////////////////////////////////////////////////////////////////
+void EuclideanCluster::link_local(const std::size_t thread_idx)
+{
+  const std::size_t first_column = m_thread_columns[thread_idx];
+  const std::size_t last_column = m_thread_columns[thread_idx + 1U];
+  for (std::size_t column = first_column; column < last_column; ++column) {
+    std::sort(
+      m_grid.begin() + static_cast<std::ptrdiff_t>(m_column_offsets[column]),
+      m_grid.begin() + static_cast<std::ptrdiff_t>(m_column_offsets[column + 1U]),
+      [](const GridPoint & a, const GridPoint & b) {return a.row < b.row;});
+  }
+  for (std::size_t idx = m_column_offsets[first_column];
+    idx < m_column_offsets[last_column]; ++idx)
+  {
+    m_parents[idx].store(static_cast<uint32_t>(idx));
+  }
+  for (std::size_t column = first_column; column < last_column; ++column) {
+    const std::size_t column_end = m_column_offsets[column + 1U];
+    for (std::size_t idx = m_column_offsets[column]; idx < column_end; ++idx) {
+      // Only look forward within the column, every pair is seen once
+      for (std::size_t jdx = idx + 1U;
+        (jdx < column_end) && (m_grid[jdx].row <= (m_grid[idx].row + 1U)); ++jdx)
+      {
+        link_if_connected(idx, jdx);
+      }
+      // The next column of the last column belongs to the next thread
+      if ((column + 1U) < last_column) {
+        link_to_column(idx, column_end, m_column_offsets[column + 2U]);
+      }
+    }
+  }
+}
+////////////////////////////////////////////////////////////////////////////////
+void EuclideanCluster::link_boundary(const std::size_t thread_idx)
+{
+  const std::size_t first_column = m_thread_columns[thread_idx];
+  const std::size_t last_column = m_thread_columns[thread_idx + 1U];
+  // Threads without columns have no boundary, the next column is handled by the previous thread
+  if ((first_column == last_column) || ((last_column + 1U) >= m_column_offsets.size())) {
+    return;
+  }
+  for (std::size_t idx = m_column_offsets[last_column - 1U];
+    idx < m_column_offsets[last_column]; ++idx)
+  {
+    link_to_column(idx, m_column_offsets[last_column], m_column_offsets[last_column + 1U]);
+  }
+}
+////////////////////////////////////////////////////////////////////////////////
+void EuclideanCluster::link_to_column(
+  const std::size_t pt_idx,
+  const std::size_t column_begin,
+  const std::size_t column_end)
+{
+  const uint32_t row = m_grid[pt_idx].row;
+  const auto begin = m_grid.begin() + static_cast<std::ptrdiff_t>(column_begin);
+  const auto end = m_grid.begin() + static_cast<std::ptrdiff_t>(column_end);
+  const auto first = std::lower_bound(
+    begin, end, (row > 0U) ? (row - 1U) : 0U,
+    [](const GridPoint & grid_pt, const uint32_t value) {return grid_pt.row < value;});
+  for (auto it = first; (it != end) && (it->row <= (row + 1U)); ++it) {
+    link_if_connected(pt_idx, static_cast<std::size_t>(it - m_grid.begin()));
+  }
+}
+////////////////////////////////////////////////////////////////////////////////
+bool8_t EuclideanCluster::is_connected(const std::size_t idx, const std::size_t jdx) const
+{
+  const PointXYZIR & pt = m_grid[idx].point;
+  const PointXYZIR & qt = m_grid[jdx].point;
+  const float32_t dx = pt.get_point().x - qt.get_point().x;
+  const float32_t dy = pt.get_point().y - qt.get_point().y;
+  const float32_t dist = sqrtf((dx * dx) + (dy * dy));
+  // Ensure that threshold is satisfied bidirectionally
+  return (dist <= m_config.threshold(pt)) && (dist <= m_config.threshold(qt));
+}
+////////////////////////////////////////////////////////////////////////////////
+void EuclideanCluster::link_if_connected(const std::size_t idx, const std::size_t jdx)
+{
+  if (is_connected(idx, jdx)) {
+    merge(static_cast<uint32_t>(idx), static_cast<uint32_t>(jdx));
+  }
+}
+////////////////////////////////////////////////////////////////////////////////
+uint32_t EuclideanCluster::find_root(uint32_t idx)
+{
+  while (true) {
+    uint32_t parent = m_parents[idx].load();
+    if (parent == idx) {
+      return idx;
+    }
+    const uint32_t grandparent = m_parents[parent].load();
+    if (grandparent != parent) {
+      // Parents only ever move closer to the root, so a failed exchange is harmless
+      (void)m_parents[idx].compare_exchange_weak(parent, grandparent);
+    }
+    idx = grandparent;
+  }
+}
+////////////////////////////////////////////////////////////////////////////////
+void EuclideanCluster::merge(uint32_t idx, uint32_t jdx)
+{
+  while (true) {
+    idx = find_root(idx);
+    jdx = find_root(jdx);
+    if (idx == jdx) {
+      return;
+    }
+    // Link the larger root below the smaller one, so no cycle can form
+    if (idx < jdx) {
+      std::swap(idx, jdx);
+    }
+    uint32_t expected = idx;
+    if (m_parents[idx].compare_exchange_strong(expected, jdx)) {
+      return;
+    }
+    // Another thread linked the root in the meantime, retry from the new roots
+  }
+}
+////////////////////////////////////////////////////////////////////////////////
+void EuclideanCluster::run(void (EuclideanCluster::* fn)(std::size_t))
+{
+  std::vector<std::thread> workers;
+  workers.reserve(m_num_threads - 1U);
+  for (std::size_t thread_idx = 1U; thread_idx < m_num_threads; ++thread_idx) {
+    workers.emplace_back([this, fn, thread_idx] {(this->*fn)(thread_idx);});
+  }
+  (this->*fn)(0U);
+  for (auto & worker : workers) {
+    worker.join();
   }
 }
 ////////////////////////////////////////////////////////////////////////////////
 namespace details
 {
+bool8_t compute_bounding_box(
+  Clusters & clusters, const std::size_t cls_id, const BboxMethod method,
+  const bool compute_height, BoundingBox & box)
+{
+  const auto iter_pair = common::lidar_utils::get_cluster(clusters, cls_id);
+  if (iter_pair.first == iter_pair.second) {
+    return false;
+  }
+
+  switch (method) {
+    case BboxMethod::Eigenbox: box =
+        common::geometry::bounding_box::eigenbox_2d(
+          iter_pair.first,
+          iter_pair.second);
+      break;
+    case BboxMethod::LFit:     box =
+        common::geometry::bounding_box::lfit_bounding_box_2d(
+          iter_pair.first,
+          iter_pair.second);
+      break;
+    case BboxMethod::LFitSearch: box =
+        common::geometry::bounding_box::lfit_search_bounding_box_2d(
+          iter_pair.first,
+          iter_pair.second);
+      break;
+  }
+
+  if (compute_height) {
+    common::geometry::bounding_box::compute_height(iter_pair.first, iter_pair.second, box);
+  }
+  return true;
+}
+////////////////////////////////////////////////////////////////////////////////
 BoundingBoxArray compute_bounding_boxes(
   Clusters & clusters, const BboxMethod method,
   const bool compute_height)
@@ -289,27 +907,9 @@ BoundingBoxArray compute_bounding_boxes(
   BoundingBoxArray boxes;
   for (uint32_t cls_id = 0U; cls_id < clusters.cluster_boundary.size(); cls_id++) {
     try {
-      const auto iter_pair = common::lidar_utils::get_cluster(clusters, cls_id);
-      if (iter_pair.first == iter_pair.second) {
-        continue;
-      }
-
-      switch (method) {
-        case BboxMethod::Eigenbox: boxes.boxes.push_back(
-            common::geometry::bounding_box::eigenbox_2d(
-              iter_pair.first,
-              iter_pair.second));
-          break;
-        case BboxMethod::LFit:     boxes.boxes.push_back(
-            common::geometry::bounding_box::lfit_bounding_box_2d(
-              iter_pair.first,
-              iter_pair.second));
-          break;
-      }
-
-      if (compute_height) {
-        common::geometry::bounding_box::compute_height(
-          iter_pair.first, iter_pair.second, boxes.boxes.back());
+      BoundingBox box;
+      if (compute_bounding_box(clusters, cls_id, method, compute_height, box)) {
+        boxes.boxes.push_back(box);
       }
     } catch (const std::exception & e) {
       std::cerr << e.what() << std::endl;
@@ -33,6 +33,7 @@ using Pt = autoware_auto_msgs::msg::PointXYZIF;
 using autoware::perception::segmentation::euclidean_cluster::details::compute_bounding_boxes;
 using autoware::perception::segmentation::euclidean_cluster::details::BboxMethod;
 using autoware::perception::segmentation::euclidean_cluster::details::convert_to_detected_objects;
+using autoware::perception::segmentation::euclidean_cluster::ClusterIndices;
 
 class BoundingBoxComputationTest : public ::testing::Test
 {
@@ -141,6 +142,21 @@ TEST_F(BoundingBoxComputationTest, basic_lfit_2d)
   }
 }
 
+TEST_F(BoundingBoxComputationTest, basic_lfit_search_2d)
+{
+  const std::vector<Pt> l_shape{make_pt(0.F, 0.F), make_pt(0.F, 1.F), make_pt(0.F, 2.F),
+    make_pt(1.F, 0.F), make_pt(2.F, 0.F), make_pt(3.F, 0.F), make_pt(4.F, 0.F)};
+  auto clusters = make_clusters({l_shape, l_shape});
+
+  BoundingBoxArray boxes_msg = compute_bounding_boxes(clusters, BboxMethod::LFitSearch, false);
+  ASSERT_EQ(boxes_msg.boxes.size(), 2U);
+  const std::vector<Pt> expected_corners{make_pt(0, 0), make_pt(4, 0), make_pt(4, 2),
+    make_pt(0, 2)};
+  for (const auto & box : boxes_msg.boxes) {
+    test_corners(box, expected_corners, 0.05F);
+  }
+}
+
 TEST_F(BoundingBoxComputationTest, basic_eigen_2d) {
   auto clusters = make_clusters(
     {pt_vector, pt_vector});
@@ -158,6 +174,49 @@ TEST_F(BoundingBoxComputationTest, basic_eigen_2d) {
   }
 }
 
+// Boxes fitted through the indices of the clusters into the points are the ones fitted to copies
+// of the points
+TEST_F(BoundingBoxComputationTest, indices_match_points)
+{
+  auto pt_vector_3d = pt_vector;
+  pt_vector_3d[0U].z = -2.F;
+  pt_vector_3d[1U].z = 2.F;
+  auto clusters = make_clusters({pt_vector_3d, {}, pt_vector_3d});
+  // The points of both clusters are interleaved, with a point of no cluster after each
+  std::vector<Pt> points;
+  ClusterIndices indices;
+  for (uint32_t cls_id = 0U; cls_id < 2U; ++cls_id) {
+    for (std::size_t idx = 0U; idx < pt_vector_3d.size(); ++idx) {
+      indices.point_indices.push_back(static_cast<uint32_t>((3U * idx) + cls_id));
+    }
+    indices.cluster_boundary.push_back(static_cast<uint32_t>(indices.point_indices.size()));
+    if (cls_id == 0U) {
+      indices.cluster_boundary.push_back(indices.cluster_boundary.back());
+    }
+  }
+  for (const auto & pt : pt_vector_3d) {
+    points.push_back(pt);
+    points.push_back(pt);
+    points.push_back(make_pt(100.F, 100.F));
+  }
+  for (const auto method : {BboxMethod::LFit, BboxMethod::LFitSearch, BboxMethod::Eigenbox}) {
+    auto copied = clusters;
+    const auto expected = compute_bounding_boxes(copied, method, true);
+    auto indexed = indices;
+    const auto boxes = compute_bounding_boxes(indexed, points, method, true);
+    ASSERT_EQ(boxes.boxes.size(), 2U);
+    ASSERT_EQ(boxes.boxes.size(), expected.boxes.size());
+    for (std::size_t idx = 0U; idx < boxes.boxes.size(); ++idx) {
+      EXPECT_FLOAT_EQ(boxes.boxes[idx].centroid.x, expected.boxes[idx].centroid.x);
+      EXPECT_FLOAT_EQ(boxes.boxes[idx].centroid.y, expected.boxes[idx].centroid.y);
+      EXPECT_FLOAT_EQ(boxes.boxes[idx].centroid.z, expected.boxes[idx].centroid.z);
+      EXPECT_FLOAT_EQ(boxes.boxes[idx].size.x, expected.boxes[idx].size.x);
+      EXPECT_FLOAT_EQ(boxes.boxes[idx].size.y, expected.boxes[idx].size.y);
+      EXPECT_FLOAT_EQ(boxes.boxes[idx].size.z, expected.boxes[idx].size.z);
+    }
+  }
+}
+
 TEST_F(BoundingBoxComputationTest, basic_lfit_3d)
 {
   auto pt_vector_3d = pt_vector;
@@ -19,6 +19,11 @@
 
 #include <common/types.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
 #include <vector>
 #include <utility>
 
@@ -154,4 +159,289 @@ TEST(euclidean_cluster, no_cluster)
   EXPECT_EQ(res.cluster_boundary.size(), 0U);
   EXPECT_EQ(cls.get_error(), EuclideanCluster::Error::NONE);
 }
+/// everything plus noise, clustered on multiple threads
+TEST(euclidean_cluster, parallel_multi_object)
+{
+  // setup
+  Config cfg{"bar", 10U, 100U, 1.0F, 1.0F, 10.0F};
+  HashConfig hcfg{-130.0F, 130.0F, -130.0F, 130.0F, 1.0F, 10000U};
+  EuclideanCluster cls{cfg, hcfg, 3U};
+  EXPECT_EQ(cls.get_num_threads(), 3U);
+  Clusters res;
+  std::vector<std::pair<float, float>> output1;
+  std::vector<std::pair<float, float>> output2;
+  std::vector<std::pair<float, float>> output3;
+  std::vector<std::pair<float, float>> output4;
+  // L
+  insert_line(output1, cls, 11.0F, 16.0F, 16.0F, 21.0F, 0.9F);
+  insert_ring(cls, 70.0F, 30U);  // noise ring
+  insert_line(output1, cls, 5.0F, 20.0F, 11.0F, 16.0F, 0.9F);
+  // bar
+  insert_line(output2, cls, 5.0F, 10.0F, 0.0F, 5.0F, 0.3F);
+  // mesh
+  insert_mesh(output3, cls, -10.0F, -10.0F, -20.0F, -20.0F, 0.5F, 0.5F);
+  insert_ring(cls, 50.0F, 30U);  // noise ring
+  // bracket
+  insert_line(output4, cls, -10.0F, 5.0F, -5.0F, 5.0F, 0.9F);
+  insert_line(output4, cls, -5.0F, 5.0F, -5.0F, 15.0F, 0.9F);
+  insert_ring(cls, 90.0F, 30U);  // noise ring
+  insert_line(output4, cls, -15.0F, 17.0F, -4.0F, 14.0F, 0.9F);
+
+  cls.cluster(res);
+  ASSERT_EQ(res.cluster_boundary.size(), 4U);
+  std::vector<std::vector<std::pair<float, float>> *> outputs =
+  {&output1, &output2, &output3, &output4};
+  check_clusters(res, outputs);
+  EXPECT_EQ(res.points.size(), output1.size() + output2.size() + output3.size() + output4.size());
+  EXPECT_EQ(cls.get_error(), EuclideanCluster::Error::NONE);
+
+  // push another point to force a reset
+  insert_point(cls, 0.0F, 0.0F);
+  cls.cluster(res);
+  EXPECT_EQ(res.cluster_boundary.size(), 0U);
+  EXPECT_EQ(cls.get_error(), EuclideanCluster::Error::NONE);
+}
+
+using ClusterSet = std::vector<std::vector<std::pair<float32_t, float32_t>>>;
+/// clusters as sorted sets of points, to compare clusterings that differ in order
+inline ClusterSet to_set(const Clusters & clusters)
+{
+  ClusterSet ret;
+  for (uint32_t idx = 0U; idx < clusters.cluster_boundary.size(); ++idx) {
+    const auto range = get_cluster(clusters, idx);
+    ret.emplace_back();
+    for (auto it = range.first; it != range.second; ++it) {
+      ret.back().emplace_back(it->x, it->y);
+    }
+    std::sort(ret.back().begin(), ret.back().end());
+  }
+  std::sort(ret.begin(), ret.end());
+  return ret;
+}
+
+/// random scenes give the same clusters on any number of threads
+TEST(euclidean_cluster, parallel_matches_serial)
+{
+  Config cfg{"bar", 3U, 10000U, 0.3F, 1.2F, 60.0F};
+  HashConfig hcfg{-130.0F, 130.0F, -130.0F, 130.0F, 1.0F, 20000U};
+  std::mt19937 gen{42U};
+  std::uniform_real_distribution<float32_t> dist{-60.0F, 60.0F};
+  std::vector<std::pair<float32_t, float32_t>> points;
+  for (uint32_t idx = 0U; idx < 20000U; ++idx) {
+    const float32_t x = dist(gen);
+    points.emplace_back(x, dist(gen));
+  }
+  EuclideanCluster serial{cfg, hcfg};
+  for (const auto & pt : points) {
+    insert_point(serial, pt.first, pt.second);
+  }
+  Clusters expected;
+  serial.cluster(expected);
+  ASSERT_GT(expected.cluster_boundary.size(), 1U);
+  for (const std::size_t num_threads : {2U, 4U, 7U}) {
+    EuclideanCluster parallel{cfg, hcfg, num_threads};
+    for (const auto & pt : points) {
+      insert_point(parallel, pt.first, pt.second);
+    }
+    Clusters res;
+    parallel.cluster(res);
+    EXPECT_EQ(to_set(res), to_set(expected)) << num_threads;
+    EXPECT_EQ(parallel.get_error(), serial.get_error());
+  }
+}
+
+/// clusters past the maximum are dropped and reported
+TEST(euclidean_cluster, parallel_too_many_clusters)
+{
+  Config cfg{"bar", 1U, 2U, 0.5F, 0.5F, 10.0F};
+  HashConfig hcfg{-130.0F, 130.0F, -130.0F, 130.0F, 1.0F, 100U};
+  EXPECT_THROW(EuclideanCluster(cfg, hcfg, 0U), std::domain_error);
+  EuclideanCluster cls{cfg, hcfg, 2U};
+  insert_point(cls, 0.0F, 0.0F);
+  insert_point(cls, 10.0F, 0.0F);
+  insert_point(cls, 20.0F, 0.0F);
+  Clusters res;
+  cls.cluster(res);
+  EXPECT_EQ(res.cluster_boundary.size(), 2U);
+  EXPECT_EQ(res.points.size(), 2U);
+  EXPECT_EQ(cls.get_error(), EuclideanCluster::Error::TOO_MANY_CLUSTERS);
+}
+/// objects of gaussian blobs at lidar like distances
+inline std::vector<std::pair<float32_t, float32_t>> make_blobs(
+  const uint32_t num_objects, const uint32_t points_per_object, const float32_t spread)
+{
+  std::mt19937 gen{7U};
+  std::uniform_real_distribution<float32_t> range{5.0F, 105.0F};
+  std::uniform_real_distribution<float32_t> angle{-3.14159F, 3.14159F};
+  std::normal_distribution<float32_t> noise{0.0F, spread};
+  std::vector<std::pair<float32_t, float32_t>> points;
+  for (uint32_t obj = 0U; obj < num_objects; ++obj) {
+    const float32_t r = range(gen);
+    const float32_t th = angle(gen);
+    for (uint32_t idx = 0U; idx < points_per_object; ++idx) {
+      const float32_t x = (r * std::cos(th)) + noise(gen);
+      points.emplace_back(x, (r * std::sin(th)) + noise(gen));
+    }
+  }
+  return points;
+}
+
+/// the voxel search gives the same clusters as the point search
+TEST(euclidean_cluster, voxels_match_serial)
+{
+  Config cfg{"bar", 3U, 10000U, 0.3F, 1.2F, 60.0F};
+  HashConfig hcfg{-130.0F, 130.0F, -130.0F, 130.0F, 1.0F, 20000U};
+  EXPECT_THROW(
+    EuclideanCluster(cfg, hcfg, 2U, EuclideanCluster::Search::VOXELS), std::domain_error);
+  std::mt19937 gen{42U};
+  std::uniform_real_distribution<float32_t> dist{-60.0F, 60.0F};
+  std::vector<std::pair<float32_t, float32_t>> uniform;
+  for (uint32_t idx = 0U; idx < 20000U; ++idx) {
+    const float32_t x = dist(gen);
+    uniform.emplace_back(x, dist(gen));
+  }
+  for (const auto & points : {uniform, make_blobs(100U, 150U, 0.7F)}) {
+    EuclideanCluster serial{cfg, hcfg};
+    EuclideanCluster voxels{cfg, hcfg, 1U, EuclideanCluster::Search::VOXELS};
+    // twice, to check that the state is reset
+    for (uint32_t iter = 0U; iter < 2U; ++iter) {
+      for (const auto & pt : points) {
+        insert_point(serial, pt.first, pt.second);
+        insert_point(voxels, pt.first, pt.second);
+      }
+      Clusters expected;
+      serial.cluster(expected);
+      ASSERT_GT(expected.cluster_boundary.size(), 1U);
+      Clusters res;
+      voxels.cluster(res);
+      EXPECT_EQ(to_set(res), to_set(expected));
+      EXPECT_EQ(voxels.get_error(), serial.get_error());
+    }
+  }
+}
+
+/// clustering into indices gives the same clusters as clustering into points, for every search
+TEST(euclidean_cluster, indices_match_points)
+{
+  using autoware::perception::segmentation::euclidean_cluster::ClusterIndices;
+  Config cfg{"bar", 3U, 10000U, 0.3F, 1.2F, 60.0F};
+  HashConfig hcfg{-130.0F, 130.0F, -130.0F, 130.0F, 1.0F, 20000U};
+  const auto points = make_blobs(100U, 150U, 0.7F);
+  const std::vector<std::pair<std::size_t, EuclideanCluster::Search>> configs{
+    {1U, EuclideanCluster::Search::POINTS}, {1U, EuclideanCluster::Search::VOXELS},
+    {3U, EuclideanCluster::Search::POINTS}};
+  for (const auto & config : configs) {
+    EuclideanCluster copying{cfg, hcfg, config.first, config.second};
+    EuclideanCluster indexing{cfg, hcfg, config.first, config.second};
+    // twice, to check that the indices restart
+    for (uint32_t iter = 0U; iter < 2U; ++iter) {
+      for (const auto & pt : points) {
+        insert_point(copying, pt.first, pt.second);
+        insert_point(indexing, pt.first, pt.second);
+      }
+      Clusters expected;
+      copying.cluster(expected);
+      ASSERT_GT(expected.cluster_boundary.size(), 1U);
+      ClusterIndices res;
+      indexing.cluster(res);
+      ASSERT_EQ(res.cluster_boundary, expected.cluster_boundary);
+      ASSERT_EQ(res.point_indices.size(), expected.points.size());
+      for (std::size_t idx = 0U; idx < res.point_indices.size(); ++idx) {
+        const auto & pt = points[res.point_indices[idx]];
+        EXPECT_EQ(pt.first, expected.points[idx].x);
+        EXPECT_EQ(pt.second, expected.points[idx].y);
+      }
+      EXPECT_EQ(indexing.get_error(), copying.get_error());
+    }
+  }
+}
+
+/// the incremental voxel search gives the same clusters as the point search while the sensor
+/// moves through a static scene that changes in places, and reuses the unchanged cells
+TEST(euclidean_cluster, incremental_voxels_match_serial)
+{
+  // reuse is only exact if the threshold doesn't depend on the distance to the moving sensor
+  Config cfg{"bar", 3U, 10000U, 0.5F, 0.5F, 60.0F};
+  HashConfig hcfg{-130.0F, 130.0F, -130.0F, 130.0F, 1.0F, 20000U};
+  EXPECT_THROW(
+    EuclideanCluster(cfg, hcfg, 2U, EuclideanCluster::Search::INCREMENTAL_VOXELS),
+    std::domain_error);
+  EXPECT_THROW(
+    EuclideanCluster(cfg, hcfg, 1U, EuclideanCluster::Search::INCREMENTAL_VOXELS, 0U),
+    std::domain_error);
+  // the scene in the fixed frame
+  auto world = make_blobs(100U, 100U, 0.7F);
+  EuclideanCluster incremental{cfg, hcfg, 1U, EuclideanCluster::Search::INCREMENTAL_VOXELS, 5U};
+  for (uint32_t frame = 0U; frame < 8U; ++frame) {
+    if (frame == 3U) {
+      // an object leaves
+      world.erase(world.begin(), world.begin() + 100);
+    } else if (frame == 6U) {
+      // an object moves, onto another one
+      for (std::size_t idx = 0U; idx < 100U; ++idx) {
+        world[idx].first = world[150U].first + (0.01F * static_cast<float32_t>(idx % 10U));
+        world[idx].second = world[150U].second + (0.01F * static_cast<float32_t>(idx / 10U));
+      }
+    }
+    FramePose pose;
+    pose.x = 2.0F * static_cast<float32_t>(frame);
+    pose.y = -0.5F * static_cast<float32_t>(frame);
+    pose.yaw = 0.05F * static_cast<float32_t>(frame);
+    incremental.set_frame_pose(pose);
+    EuclideanCluster serial{cfg, hcfg};
+    for (const auto & pt : world) {
+      // into the frame of the sensor
+      const float32_t dx = pt.first - pose.x;
+      const float32_t dy = pt.second - pose.y;
+      const float32_t x = (std::cos(pose.yaw) * dx) + (std::sin(pose.yaw) * dy);
+      const float32_t y = (std::cos(pose.yaw) * dy) - (std::sin(pose.yaw) * dx);
+      insert_point(serial, x, y);
+      insert_point(incremental, x, y);
+    }
+    Clusters expected;
+    serial.cluster(expected);
+    ASSERT_GT(expected.cluster_boundary.size(), 1U);
+    Clusters res;
+    incremental.cluster(res);
+    EXPECT_EQ(to_set(res), to_set(expected)) << "frame " << frame;
+    // nothing to reuse in the first frame and in the refresh after 5 frames
+    if ((frame == 0U) || (frame == 5U)) {
+      EXPECT_EQ(incremental.get_num_reused_cells(), 0U);
+    } else {
+      EXPECT_GT(incremental.get_num_reused_cells(), 0U) << "frame " << frame;
+    }
+  }
+  // the history can be dropped
+  incremental.reset_history();
+  for (const auto & pt : world) {
+    insert_point(incremental, pt.first, pt.second);
+  }
+  Clusters res;
+  incremental.cluster(res);
+  EXPECT_EQ(incremental.get_num_reused_cells(), 0U);
+}
+
+// Not a pass/fail test, prints the run time of both searches on a lidar like scene
+TEST(euclidean_cluster, voxels_benchmark)
+{
+  Config cfg{"bar", 10U, 100000U, 0.5F, 1.5F, 60.0F};
+  HashConfig hcfg{-130.0F, 130.0F, -130.0F, 130.0F, 1.0F, 100000U};
+  const auto points = make_blobs(300U, 250U, 0.7F);
+  for (const auto search : {EuclideanCluster::Search::POINTS, EuclideanCluster::Search::VOXELS}) {
+    EuclideanCluster cls{cfg, hcfg, 1U, search};
+    auto best = std::chrono::nanoseconds::max();
+    Clusters res;
+    for (uint32_t iter = 0U; iter < 5U; ++iter) {
+      for (const auto & pt : points) {
+        insert_point(cls, pt.first, pt.second);
+      }
+      const auto start = std::chrono::steady_clock::now();
+      cls.cluster(res);
+      best = std::min(best, std::chrono::steady_clock::now() - start);
+    }
+    std::cout << ((EuclideanCluster::Search::VOXELS == search) ? "voxels: " : "points: ") <<
+      std::chrono::duration_cast<std::chrono::microseconds>(best).count() << " us for " <<
+      points.size() << " points, " << res.cluster_boundary.size() << " clusters" << std::endl;
+  }
+}
 #endif  // TEST_EUCLIDEAN_CLUSTER_HPP_
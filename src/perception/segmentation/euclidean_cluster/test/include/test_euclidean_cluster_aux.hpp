@@ -36,6 +36,7 @@ using autoware::perception::segmentation::euclidean_cluster::HashConfig;
 using autoware::perception::segmentation::euclidean_cluster::Config;
 using autoware::perception::segmentation::euclidean_cluster::EuclideanCluster;
 using autoware::perception::segmentation::euclidean_cluster::Clusters;
+using autoware::perception::segmentation::euclidean_cluster::FramePose;
 using autoware::common::lidar_utils::get_cluster;
 using autoware::common::types::bool8_t;
 using autoware::common::types::float32_t;
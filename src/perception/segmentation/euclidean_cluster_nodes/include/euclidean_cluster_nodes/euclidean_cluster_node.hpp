@@ -24,7 +24,13 @@
 #include <euclidean_cluster_nodes/visibility_control.hpp>
 #include <autoware_auto_msgs/msg/bounding_box_array.hpp>
 #include <autoware_auto_msgs/msg/detected_objects.hpp>
+#include <compact_objects/compact_objects.hpp>
 #include <euclidean_cluster/euclidean_cluster.hpp>
+#include <euclidean_cluster_nodes/parallel_box_fitter.hpp>
+#include <latency_tracing/tracer.hpp>
+#include <overload_management/load_monitor.hpp>
+#include <tf2_ros/buffer.h>
+#include <tf2_ros/transform_listener.h>
 #include <visualization_msgs/msg/marker_array.hpp>
 #include <voxel_grid_nodes/algorithm/voxel_cloud_approximate.hpp>
 #include <common/types.hpp>
@@ -42,13 +48,16 @@ namespace euclidean_cluster_nodes
 {
 using autoware::common::types::bool8_t;
 using Clusters = euclidean_cluster::Clusters;
+using ClusterIndices = euclidean_cluster::ClusterIndices;
 using visualization_msgs::msg::Marker;
 using visualization_msgs::msg::MarkerArray;
 using BoundingBox = autoware_auto_msgs::msg::BoundingBox;
 using BoundingBoxArray = autoware_auto_msgs::msg::BoundingBoxArray;
 using DetectedObjects = autoware_auto_msgs::msg::DetectedObjects;
 /// \brief Combined object detection node, primarily does clustering, can also do in-place
-///        downsampling and bounding box formation
+///        downsampling and bounding box formation. While the perception pipeline is overloaded,
+///        at most `overload.max_points` points of a cloud are clustered, see
+///        overload_management::LoadMonitor.
 class EUCLIDEAN_CLUSTER_NODES_PUBLIC EuclideanClusterNode : public rclcpp::Node
 {
   using PointCloud2 = sensor_msgs::msg::PointCloud2;
@@ -61,14 +70,18 @@ public:
     const rclcpp::NodeOptions & node_options);
 
 private:
-  /// \brief Main callback function
-  void EUCLIDEAN_CLUSTER_NODES_LOCAL handle(const PointCloud2::SharedPtr msg_ptr);
+  /// \brief Main callback function. Takes a const pointer so that an intra-process publisher
+  ///        can hand over its cloud without a copy
+  void EUCLIDEAN_CLUSTER_NODES_LOCAL handle(const PointCloud2::ConstSharedPtr msg_ptr);
   /// \brief Insert directly into clustering algorithm
   void EUCLIDEAN_CLUSTER_NODES_LOCAL insert_plain(const PointCloud2 & cloud);
-  /// \brief Pass points through a voxel grid before inserting into clustering algorithm
-  void EUCLIDEAN_CLUSTER_NODES_LOCAL insert_voxel(const PointCloud2 & cloud);
-  /// \brief Dispatch to appropriate insertion method
-  void EUCLIDEAN_CLUSTER_NODES_LOCAL insert(const PointCloud2 & cloud);
+  /// \brief Pass points through a voxel grid, the points of the returned cloud are to be inserted
+  ///        into the clustering algorithm
+  EUCLIDEAN_CLUSTER_NODES_LOCAL const PointCloud2 & downsample(const PointCloud2 & cloud);
+  /// \brief Keep every n-th point of a cloud with more points than the budget of the degraded
+  ///        node, the points of the returned cloud are to be inserted into the clustering
+  ///        algorithm
+  EUCLIDEAN_CLUSTER_NODES_LOCAL const PointCloud2 & limit_points(const PointCloud2 & cloud);
   /// \brief Updates cluster meta-information, and publishes
   void EUCLIDEAN_CLUSTER_NODES_LOCAL publish_clusters(
     Clusters & clusters,
@@ -77,19 +90,59 @@ private:
   void EUCLIDEAN_CLUSTER_NODES_LOCAL handle_clusters(
     Clusters & clusters,
     const std_msgs::msg::Header & header);
+  /// \brief Compute the bounding boxes of clusters of indices, reading the points from the cloud
+  ///        that was inserted, and publish them
+  void EUCLIDEAN_CLUSTER_NODES_LOCAL handle_cluster_indices(
+    ClusterIndices & clusters,
+    const PointCloud2 & cloud,
+    const std_msgs::msg::Header & header);
+  /// \brief Publish the bounding boxes, as detected objects and as markers
+  void EUCLIDEAN_CLUSTER_NODES_LOCAL publish_boxes(
+    BoundingBoxArray & boxes,
+    const std_msgs::msg::Header & header);
+  /// \brief Publish the detected objects in the formats that have subscribers. Without the
+  ///        compact output, the full format is always published.
+  void EUCLIDEAN_CLUSTER_NODES_LOCAL publish_detected_objects(const DetectedObjects & objects);
+  /// \brief Hand the pose of the cloud in the fixed frame to the incremental search, or make it
+  ///        start over if the pose isn't known
+  void EUCLIDEAN_CLUSTER_NODES_LOCAL update_frame_pose(const std_msgs::msg::Header & header);
 
+  /// The group of the cloud subscription, from the parameter callback_groups.points. The node
+  /// keeps it alive, it only holds a weak reference otherwise
+  const rclcpp::CallbackGroup::SharedPtr m_points_group;
   // pub/sub
   const rclcpp::Subscription<PointCloud2>::SharedPtr m_cloud_sub_ptr;
   const rclcpp::Publisher<Clusters>::SharedPtr m_cluster_pub_ptr;
   const rclcpp::Publisher<BoundingBoxArray>::SharedPtr m_box_pub_ptr;
   const rclcpp::Publisher<DetectedObjects>::SharedPtr m_detected_objects_pub_ptr;
   const rclcpp::Publisher<MarkerArray>::SharedPtr m_marker_pub_ptr;
+  /// Publisher and encoder of the compact detected objects, if compact_output.enabled is set
+  const rclcpp::Publisher<PointCloud2>::SharedPtr m_compact_objects_pub_ptr;
+  std::unique_ptr<compact_objects::CompactObjectsEncoder> m_compact_encoder_ptr;
+  PointCloud2 m_compact_objects;
   // algorithms
   euclidean_cluster::EuclideanCluster m_cluster_alg;
   Clusters m_clusters;
+  /// The clusters as indices into the inserted cloud, if cluster.index_output is set
+  ClusterIndices m_cluster_indices;
   std::unique_ptr<VoxelAlgorithm> m_voxel_ptr;
-  const bool8_t m_use_lfit;
+  std::unique_ptr<ParallelBoxFitter> m_box_fitter_ptr;
+  BoundingBoxArray m_boxes;
+  const euclidean_cluster::details::BboxMethod m_bbox_method;
   const bool8_t m_use_z;
+  const bool8_t m_index_output;
+  /// The fixed frame of the incremental search and the transforms into it, if
+  /// cluster.incremental.enabled is set
+  std::string m_fixed_frame;
+  std::shared_ptr<tf2_ros::Buffer> m_tf_buffer;
+  std::shared_ptr<tf2_ros::TransformListener> m_tf_listener;
+  /// The stage of the node in the latency traces of the clouds
+  const autoware::common::latency_tracing::StageId m_trace_stage;
+  /// The points that are clustered while the node is degraded
+  const std::size_t m_overload_max_points;
+  PointCloud2 m_limited_cloud;
+  autoware::common::overload_management::LoadMonitor m_load_monitor;
+  const autoware::common::overload_management::CallbackId m_cloud_load_id;
 };  // class EuclideanClusterNode
 }  // namespace euclidean_cluster_nodes
 }  // namespace segmentation
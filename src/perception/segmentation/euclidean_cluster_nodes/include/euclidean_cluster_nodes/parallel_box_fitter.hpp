@@ -0,0 +1,138 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+/// \file
+/// \brief This file defines a helper that fits the bounding boxes of clusters on a pool of threads
+
+#ifndef EUCLIDEAN_CLUSTER_NODES__PARALLEL_BOX_FITTER_HPP_
+#define EUCLIDEAN_CLUSTER_NODES__PARALLEL_BOX_FITTER_HPP_
+
+#include <autoware_auto_msgs/msg/bounding_box_array.hpp>
+#include <common/types.hpp>
+#include <euclidean_cluster/euclidean_cluster.hpp>
+#include <euclidean_cluster_nodes/visibility_control.hpp>
+#include <lidar_utils/point_layout.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace autoware
+{
+namespace perception
+{
+namespace segmentation
+{
+namespace euclidean_cluster_nodes
+{
+using autoware::common::types::bool8_t;
+
+/// \brief Fits the bounding boxes of clusters on a fixed pool of threads. The threads take
+///        clusters one at a time until none are left, so a few large clusters don't hold up the
+///        others. Every cluster has its own preallocated slot for its box, and the boxes are
+///        gathered in the order of the clusters, so the output is the same as fitting the
+///        clusters one after the other. Nothing is allocated after construction.
+class EUCLIDEAN_CLUSTER_NODES_PUBLIC ParallelBoxFitter
+{
+public:
+  using Clusters = euclidean_cluster::Clusters;
+  using ClusterIndices = euclidean_cluster::ClusterIndices;
+  /// The points that ClusterIndices refer to, a view of the cloud the points were inserted from
+  using PointsView = common::lidar_utils::PointCloudView<common::types::PointXYZI>;
+  using BboxMethod = euclidean_cluster::details::BboxMethod;
+  using BoundingBox = autoware_auto_msgs::msg::BoundingBox;
+  using BoundingBoxArray = autoware_auto_msgs::msg::BoundingBoxArray;
+
+  /// \brief Constructor, starts the threads
+  /// \param[in] method Whether to use the eigenboxes or L-Fit algorithm
+  /// \param[in] compute_height Compute the height of the bounding boxes as well
+  /// \param[in] num_threads Number of threads including the calling thread, which always
+  ///                        takes part in the work
+  /// \param[in] max_num_clusters Maximum number of clusters that are fitted at once
+  /// \throw std::domain_error If the number of threads is 0
+  ParallelBoxFitter(
+    BboxMethod method,
+    bool8_t compute_height,
+    std::size_t num_threads,
+    std::size_t max_num_clusters);
+  /// \brief Destructor, stops and joins the threads
+  ~ParallelBoxFitter();
+
+  ParallelBoxFitter(const ParallelBoxFitter &) = delete;
+  ParallelBoxFitter & operator=(const ParallelBoxFitter &) = delete;
+
+  /// \brief Fit a bounding box to every cluster. Clusters that are empty or that a box can't be
+  ///        fitted to are skipped, as with euclidean_cluster::details::compute_bounding_boxes
+  /// \param[inout] clusters The clusters, individual clusters may get their points shuffled
+  /// \param[out] boxes The boxes are written to boxes.boxes, in the order of the clusters. Its
+  ///                   capacity should be at least the maximum number of clusters
+  /// \throw std::length_error If there are more clusters than the maximum, in which case no box
+  ///                          is computed
+  void compute(Clusters & clusters, BoundingBoxArray & boxes);
+
+  /// \brief Fit a bounding box to every cluster of indices, the points are read through the
+  ///        indices as with euclidean_cluster::details::compute_bounding_boxes
+  /// \param[inout] clusters The clusters, individual clusters may get their indices shuffled
+  /// \param[in] points The points that the indices refer to
+  /// \param[out] boxes The boxes are written to boxes.boxes, in the order of the clusters. Its
+  ///                   capacity should be at least the maximum number of clusters
+  /// \throw std::length_error If there are more clusters than the maximum, in which case no box
+  ///                          is computed
+  void compute(ClusterIndices & clusters, const PointsView & points, BoundingBoxArray & boxes);
+
+  /// \brief Get the number of threads including the calling thread
+  std::size_t get_num_threads() const;
+
+private:
+  /// \brief Fit the clusters of the current call and gather the boxes
+  EUCLIDEAN_CLUSTER_NODES_LOCAL void fit(std::size_t num_clusters, BoundingBoxArray & boxes);
+  /// \brief Run all workers and wait until they are done
+  EUCLIDEAN_CLUSTER_NODES_LOCAL void run();
+  /// \brief Fit boxes to clusters until none are left
+  EUCLIDEAN_CLUSTER_NODES_LOCAL void work();
+  /// \brief Loop of the pool threads
+  EUCLIDEAN_CLUSTER_NODES_LOCAL void thread_loop();
+
+  const BboxMethod m_method;
+  const bool8_t m_compute_height;
+  const std::size_t m_num_threads;
+  // One slot per cluster
+  std::vector<BoundingBox> m_boxes;
+  // Not std::vector<bool>, whose elements can't be written from different threads
+  std::vector<uint8_t> m_valid;
+  // State of the current call, only valid during compute(). Either the clusters or the indices
+  // and their points are set
+  Clusters * m_clusters;
+  ClusterIndices * m_cluster_indices;
+  const PointsView * m_points;
+  std::size_t m_num_clusters;
+  std::atomic<std::size_t> m_next_cluster;
+  // Synchronization with the pool threads
+  std::mutex m_mutex;
+  std::condition_variable m_start_cv;
+  std::condition_variable m_done_cv;
+  std::size_t m_generation;
+  std::size_t m_num_busy;
+  bool8_t m_stop;
+  std::vector<std::thread> m_threads;
+};  // class ParallelBoxFitter
+}  // namespace euclidean_cluster_nodes
+}  // namespace segmentation
+}  // namespace perception
+}  // namespace autoware
+#endif  // EUCLIDEAN_CLUSTER_NODES__PARALLEL_BOX_FITTER_HPP_
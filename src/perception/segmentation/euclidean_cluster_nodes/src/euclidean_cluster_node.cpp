@@ -22,17 +22,29 @@
 #include <autoware_auto_msgs/msg/bounding_box_array.hpp>
 #include <autoware_auto_msgs/msg/detected_objects.hpp>
 #include <common/types.hpp>
+#include <executor_topology/callback_groups.hpp>
 #include <lidar_utils/point_cloud_utils.hpp>
+#include <lidar_utils/point_layout.hpp>
 #include <rclcpp_components/register_node_macro.hpp>
 #include <rclcpp/rclcpp.hpp>
+#include <tf2/exceptions.h>
+#include <tf2_ros/buffer_interface.h>
 
+#include <cmath>
+#include <cstring>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <utility>
 
 using autoware::common::types::bool8_t;
 using autoware::common::types::float32_t;
+using autoware::common::types::float64_t;
+using autoware::perception::compact_objects::CompactObjectsConfig;
+using autoware::perception::compact_objects::CompactObjectsEncoder;
 using autoware::perception::segmentation::euclidean_cluster::details::BboxMethod;
+using autoware::perception::segmentation::euclidean_cluster::EuclideanCluster;
+using autoware::common::overload_management::LoadScope;
 using BoundingBoxArray = autoware_auto_msgs::msg::BoundingBoxArray;
 using DetectedObjects = autoware_auto_msgs::msg::DetectedObjects;
 
@@ -44,14 +56,87 @@ namespace segmentation
 {
 namespace euclidean_cluster_nodes
 {
+namespace
+{
+std::size_t declare_number_of_threads(rclcpp::Node & node)
+{
+  const auto num_threads = node.declare_parameter("number_of_threads", 1);
+  if (num_threads < 1) {
+    throw std::runtime_error("EuclideanClusterNode: number_of_threads must be positive");
+  }
+  return static_cast<std::size_t>(num_threads);
+}
+
+EuclideanCluster::Search declare_search(rclcpp::Node & node)
+{
+  if (node.declare_parameter("cluster.incremental.enabled", false)) {
+    return EuclideanCluster::Search::INCREMENTAL_VOXELS;
+  }
+  return node.declare_parameter("cluster.use_voxel_search", false) ?
+         EuclideanCluster::Search::VOXELS : EuclideanCluster::Search::POINTS;
+}
+
+std::size_t declare_refresh_interval(rclcpp::Node & node)
+{
+  const auto refresh_interval = node.declare_parameter(
+    "cluster.incremental.refresh_interval", static_cast<int64_t>(10));
+  if (refresh_interval < 1) {
+    throw std::domain_error{"EuclideanClusterNode: refresh_interval must be positive"};
+  }
+  return static_cast<std::size_t>(refresh_interval);
+}
+
+BboxMethod declare_bbox_method(rclcpp::Node & node)
+{
+  if (!node.declare_parameter("use_lfit").get<bool8_t>()) {
+    return BboxMethod::Eigenbox;
+  }
+  return node.declare_parameter("lfit.use_angle_search", false) ?
+         BboxMethod::LFitSearch : BboxMethod::LFit;
+}
+
+CompactObjectsConfig declare_compact_config(rclcpp::Node & node)
+{
+  CompactObjectsConfig config;
+  config.shape_resolution_m = static_cast<float32_t>(node.declare_parameter(
+      "compact_output.shape_resolution_m", static_cast<float64_t>(config.shape_resolution_m)));
+  const auto key_frame_interval = node.declare_parameter(
+    "compact_output.key_frame_interval", static_cast<int64_t>(config.key_frame_interval));
+  if (key_frame_interval < 1) {
+    throw std::domain_error{"EuclideanClusterNode: key_frame_interval must be positive"};
+  }
+  config.key_frame_interval = static_cast<std::size_t>(key_frame_interval);
+  return config;
+}
+
+std::size_t declare_overload_max_points(rclcpp::Node & node)
+{
+  const auto max_points = node.declare_parameter(
+    "overload.max_points", node.get_parameter("max_cloud_size").as_int() / 2);
+  if (max_points < 1) {
+    throw std::domain_error{"EuclideanClusterNode: overload.max_points must be positive"};
+  }
+  return static_cast<std::size_t>(max_points);
+}
+
+rclcpp::SubscriptionOptions subscription_options(const rclcpp::CallbackGroup::SharedPtr & group)
+{
+  rclcpp::SubscriptionOptions options;
+  options.callback_group = group;
+  return options;
+}
+}  // namespace
 ////////////////////////////////////////////////////////////////////////////////
 EuclideanClusterNode::EuclideanClusterNode(
   const rclcpp::NodeOptions & node_options)
 : Node("euclidean_cluster_cloud_node", node_options),
+  // handle() works on the members, i.e. it isn't reentrant
+  m_points_group{common::executor_topology::declare_callback_group(*this, "points")},
   m_cloud_sub_ptr{create_subscription<PointCloud2>(
       "points_in",
       rclcpp::QoS(10),
-      [this](const PointCloud2::SharedPtr msg) {handle(msg);})},
+      [this](const PointCloud2::ConstSharedPtr msg) {handle(msg);},
+      subscription_options(m_points_group))},
   m_cluster_pub_ptr{declare_parameter("use_cluster").get<bool8_t>() ?
   create_publisher<Clusters>(
     "points_clustered",
@@ -68,6 +153,10 @@ m_marker_pub_ptr{get_parameter("use_box").as_bool() ?
   create_publisher<MarkerArray>(
     "lidar_bounding_boxes_viz", rclcpp::QoS{10}) :
   nullptr},
+m_compact_objects_pub_ptr{declare_parameter("compact_output.enabled", false) ?
+  create_publisher<PointCloud2>(
+    "lidar_detected_objects_compact", rclcpp::QoS{10}) :
+  nullptr},
 m_cluster_alg{
   euclidean_cluster::Config{
     declare_parameter("cluster.frame_id").get<std::string>().c_str(),
@@ -84,18 +173,54 @@ m_cluster_alg{
     static_cast<float32_t>(declare_parameter("hash.min_y").get<float32_t>()),
     static_cast<float32_t>(declare_parameter("hash.max_y").get<float32_t>()),
     static_cast<float32_t>(declare_parameter("hash.side_length").get<float32_t>()),
-    static_cast<std::size_t>(declare_parameter("max_cloud_size").get<std::size_t>())
-  }
+    static_cast<std::size_t>(declare_parameter("max_cloud_size").get<std::size_t>()),
+    declare_parameter("hash.use_flat_grid", false) ?
+    common::geometry::spatial_hash::StorageBackend::FLAT_GRID :
+    common::geometry::spatial_hash::StorageBackend::HASH_MAP
+  },
+  declare_number_of_threads(*this),
+  declare_search(*this),
+  declare_refresh_interval(*this)
 },
 m_clusters{},
 m_voxel_ptr{nullptr},  // Because voxel config's Point types don't accept positional arguments
-m_use_lfit{declare_parameter("use_lfit").get<bool8_t>()},
-m_use_z{declare_parameter("use_z").get<bool8_t>()}
+m_box_fitter_ptr{nullptr},
+m_bbox_method{declare_bbox_method(*this)},
+m_use_z{declare_parameter("use_z").get<bool8_t>()},
+m_index_output{declare_parameter("cluster.index_output", false)},
+m_trace_stage{common::latency_tracing::Tracer::instance().register_stage(
+    get_fully_qualified_name())},
+m_overload_max_points{declare_overload_max_points(*this)},
+// Fewer clustered points are the third work the perception pipeline sheds
+m_load_monitor{*this, 3},
+m_cloud_load_id{m_load_monitor.add_callback("points", 50.0)}
 {
   // Sanity check
   if ((!m_detected_objects_pub_ptr) && (!m_box_pub_ptr) && (!m_cluster_pub_ptr)) {
     throw std::domain_error{"EuclideanClusterNode: No publisher topics provided"};
   }
+  // The clusters of indices only make the boxes, the points aren't copied to be published
+  if (m_index_output) {
+    if (m_cluster_pub_ptr) {
+      throw std::domain_error{"EuclideanClusterNode: cluster.index_output needs use_cluster off"};
+    }
+    m_cluster_indices.point_indices.reserve(
+      static_cast<std::size_t>(get_parameter("max_cloud_size").as_int()));
+    m_cluster_indices.cluster_boundary.reserve(m_cluster_alg.get_config().max_num_clusters());
+  }
+  if (m_compact_objects_pub_ptr) {
+    if (!m_detected_objects_pub_ptr) {
+      throw std::domain_error{"EuclideanClusterNode: compact_output needs use_detected_objects"};
+    }
+    m_compact_encoder_ptr = std::make_unique<CompactObjectsEncoder>(declare_compact_config(*this));
+  }
+  // The incremental search needs the motion of the sensor between the clouds
+  if (get_parameter("cluster.incremental.enabled").as_bool()) {
+    m_fixed_frame = declare_parameter("cluster.incremental.fixed_frame", std::string{"odom"});
+    m_tf_buffer = std::make_shared<tf2_ros::Buffer>(get_clock());
+    m_tf_listener = std::make_shared<tf2_ros::TransformListener>(
+      *m_tf_buffer, std::shared_ptr<rclcpp::Node>(this, [](auto) {}), false);
+  }
   // Initialize voxel grid
   if (declare_parameter("downsample").get<bool8_t>()) {
     filters::voxel_grid::PointXYZ min_point;
@@ -124,43 +249,70 @@ m_use_z{declare_parameter("use_z").get<bool8_t>()}
               static_cast<std::size_t>(get_parameter("max_cloud_size").as_int())
             });
   }
+  // Fit the boxes on a pool of threads
+  if ((m_cluster_alg.get_num_threads() > 1U) && (m_box_pub_ptr || m_detected_objects_pub_ptr)) {
+    const std::size_t max_num_clusters = m_cluster_alg.get_config().max_num_clusters();
+    m_box_fitter_ptr = std::make_unique<ParallelBoxFitter>(
+      m_bbox_method, m_use_z,
+      m_cluster_alg.get_num_threads(), max_num_clusters);
+    m_boxes.boxes.reserve(max_num_clusters);
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void EuclideanClusterNode::insert_plain(const PointCloud2 & cloud)
 {
-  using euclidean_cluster::PointXYZI;
-  const auto indices = common::lidar_utils::sanitize_point_cloud(cloud);
-  if (indices.point_step != cloud.point_step) {
+  // Verify the point cloud format once, x, y and z are required and intensity is optional
+  const common::lidar_utils::PointCloudView<common::types::PointXYZI> view{cloud, 3U};
+  if (!view.has_field(3U)) {
     std::cout << "Using only a subset of Point cloud fields" << std::endl;
   }
-  if (indices.data_length != cloud.data.size()) {
-    std::cout << "Misaligned data: Using only a subset of Point cloud data" << std::endl;
-  }
-  // Insert via memcpy to ensure proper aliasing
-  for (auto idx = 0U; idx < indices.data_length; idx += cloud.point_step) {
-    using euclidean_cluster::PointXYZI;
-    PointXYZI pt;
-    void * const dest = &pt;
-    const void * const src = &cloud.data[idx];
-    (void)std::memcpy(dest, src, indices.point_step);
-    m_cluster_alg.insert(euclidean_cluster::PointXYZIR{pt});
+  for (std::size_t idx = 0U; idx < view.size(); ++idx) {
+    const common::types::PointXYZI pt = view[idx];
+    const euclidean_cluster::PointXYZI cluster_pt{pt.x, pt.y, pt.z, pt.intensity};
+    m_cluster_alg.insert(euclidean_cluster::PointXYZIR{cluster_pt});
   }
 }
 ////////////////////////////////////////////////////////////////////////////////
-void EuclideanClusterNode::insert_voxel(const PointCloud2 & cloud)
+const sensor_msgs::msg::PointCloud2 & EuclideanClusterNode::downsample(const PointCloud2 & cloud)
 {
   m_voxel_ptr->insert(cloud);
-  insert_plain(m_voxel_ptr->get());
+  return m_voxel_ptr->get();
 }
 ////////////////////////////////////////////////////////////////////////////////
-void EuclideanClusterNode::insert(const PointCloud2 & cloud)
+const sensor_msgs::msg::PointCloud2 & EuclideanClusterNode::limit_points(const PointCloud2 & cloud)
 {
-  if (m_voxel_ptr) {
-    insert_voxel(cloud);
-  } else {
-    insert_plain(cloud);
+  const std::size_t num_points = static_cast<std::size_t>(cloud.width) * cloud.height;
+  if (num_points <= m_overload_max_points) {
+    return cloud;
+  }
+  if ((static_cast<std::size_t>(cloud.point_step) * cloud.width > cloud.row_step) ||
+    (static_cast<std::size_t>(cloud.row_step) * cloud.height > cloud.data.size()))
+  {
+    throw std::runtime_error{"EuclideanClusterNode: the cloud is smaller than its layout"};
+  }
+  // Every n-th point, so that the kept points cover the whole cloud
+  const std::size_t stride = (num_points + m_overload_max_points - 1U) / m_overload_max_points;
+  const std::size_t num_kept = (num_points + stride - 1U) / stride;
+  m_limited_cloud.header = cloud.header;
+  m_limited_cloud.fields = cloud.fields;
+  m_limited_cloud.is_bigendian = cloud.is_bigendian;
+  m_limited_cloud.point_step = cloud.point_step;
+  m_limited_cloud.is_dense = cloud.is_dense;
+  m_limited_cloud.height = 1U;
+  m_limited_cloud.width = static_cast<uint32_t>(num_kept);
+  m_limited_cloud.row_step = static_cast<uint32_t>(num_kept * cloud.point_step);
+  m_limited_cloud.data.resize(m_limited_cloud.row_step);
+  std::size_t kept = 0U;
+  for (std::size_t idx = 0U; idx < num_points; idx += stride) {
+    const std::size_t row = idx / cloud.width;
+    const std::size_t column = idx % cloud.width;
+    (void)std::memcpy(
+      &m_limited_cloud.data[kept * cloud.point_step],
+      &cloud.data[(row * cloud.row_step) + (column * cloud.point_step)], cloud.point_step);
+    ++kept;
   }
+  return m_limited_cloud;
 }
 ////////////////////////////////////////////////////////////////////////////////
 void EuclideanClusterNode::publish_clusters(
@@ -171,6 +323,23 @@ void EuclideanClusterNode::publish_clusters(
   m_cluster_pub_ptr->publish(clusters);
 }
 ////////////////////////////////////////////////////////////////////////////////
+void EuclideanClusterNode::publish_detected_objects(const DetectedObjects & objects)
+{
+  if (m_compact_objects_pub_ptr) {
+    // The shapes only build on the previous frames while someone decodes them
+    if (m_compact_objects_pub_ptr->get_subscription_count() > 0U) {
+      m_compact_encoder_ptr->encode(objects, m_compact_objects);
+      m_compact_objects_pub_ptr->publish(m_compact_objects);
+    } else {
+      m_compact_encoder_ptr->reset();
+    }
+    if (m_detected_objects_pub_ptr->get_subscription_count() == 0U) {
+      return;
+    }
+  }
+  m_detected_objects_pub_ptr->publish(objects);
+}
+////////////////////////////////////////////////////////////////////////////////
 void EuclideanClusterNode::handle_clusters(
   Clusters & clusters,
   const std_msgs::msg::Header & header)
@@ -183,22 +352,42 @@ void EuclideanClusterNode::handle_clusters(
     return;
   }
 
-  BoundingBoxArray boxes;
-  if (m_use_lfit) {
-    boxes = euclidean_cluster::details::compute_bounding_boxes(clusters, BboxMethod::LFit, m_use_z);
+  BoundingBoxArray & boxes = m_boxes;
+  if (m_box_fitter_ptr) {
+    m_box_fitter_ptr->compute(clusters, boxes);
+  } else {
+    boxes = euclidean_cluster::details::compute_bounding_boxes(clusters, m_bbox_method, m_use_z);
+  }
+  publish_boxes(boxes, header);
+}
+////////////////////////////////////////////////////////////////////////////////
+void EuclideanClusterNode::handle_cluster_indices(
+  ClusterIndices & clusters,
+  const PointCloud2 & cloud,
+  const std_msgs::msg::Header & header)
+{
+  // The layout was verified when the points were inserted
+  const ParallelBoxFitter::PointsView points{cloud, 3U};
+  BoundingBoxArray & boxes = m_boxes;
+  if (m_box_fitter_ptr) {
+    m_box_fitter_ptr->compute(clusters, points, boxes);
   } else {
     boxes = euclidean_cluster::details::compute_bounding_boxes(
-      clusters, BboxMethod::Eigenbox,
-      m_use_z);
+      clusters, points, m_bbox_method, m_use_z);
   }
+  publish_boxes(boxes, header);
+}
+////////////////////////////////////////////////////////////////////////////////
+void EuclideanClusterNode::publish_boxes(
+  BoundingBoxArray & boxes,
+  const std_msgs::msg::Header & header)
+{
   boxes.header.stamp = header.stamp;
   boxes.header.frame_id = header.frame_id;
   m_box_pub_ptr->publish(boxes);
 
   if (m_detected_objects_pub_ptr) {
-    const auto detected_objects_msg =
-      euclidean_cluster::details::convert_to_detected_objects(boxes);
-    m_detected_objects_pub_ptr->publish(detected_objects_msg);
+    publish_detected_objects(euclidean_cluster::details::convert_to_detected_objects(boxes));
   }
 
   // Also publish boxes for visualization
@@ -235,18 +424,62 @@ void EuclideanClusterNode::handle_clusters(
   m_marker_pub_ptr->publish(marker_array);
 }
 ////////////////////////////////////////////////////////////////////////////////
-void EuclideanClusterNode::handle(const PointCloud2::SharedPtr msg_ptr)
+void EuclideanClusterNode::update_frame_pose(const std_msgs::msg::Header & header)
 {
+  geometry_msgs::msg::TransformStamped transform;
   try {
+    transform = m_tf_buffer->lookupTransform(
+      m_fixed_frame, header.frame_id, tf2_ros::fromMsg(header.stamp));
+  } catch (const tf2::TransformException & ex) {
+    RCLCPP_WARN(
+      get_logger(), "Cannot transform %s to %s, clustering from scratch: %s",
+      header.frame_id.c_str(), m_fixed_frame.c_str(), ex.what());
+    m_cluster_alg.reset_history();
+    return;
+  }
+  const auto & rotation = transform.transform.rotation;
+  euclidean_cluster::FramePose pose;
+  pose.x = static_cast<float32_t>(transform.transform.translation.x);
+  pose.y = static_cast<float32_t>(transform.transform.translation.y);
+  pose.yaw = static_cast<float32_t>(std::atan2(
+      2.0 * ((rotation.w * rotation.z) + (rotation.x * rotation.y)),
+      1.0 - (2.0 * ((rotation.y * rotation.y) + (rotation.z * rotation.z)))));
+  m_cluster_alg.set_frame_pose(pose);
+}
+////////////////////////////////////////////////////////////////////////////////
+void EuclideanClusterNode::handle(const PointCloud2::ConstSharedPtr msg_ptr)
+{
+  // The clusters and boxes keep the stamp, so they continue the trace of the cloud
+  common::latency_tracing::TraceScope trace{common::latency_tracing::Tracer::instance(),
+    m_trace_stage};
+  trace.set_trace_id(common::latency_tracing::to_trace_id(msg_ptr->header.stamp));
+  const LoadScope load_scope{m_load_monitor, m_cloud_load_id};
+  try {
+    // The cloud whose points are inserted, which the clusters of indices refer to
+    const PointCloud2 * cloud_ptr = msg_ptr.get();
     try {
-      insert(*msg_ptr);
+      if (m_voxel_ptr) {
+        cloud_ptr = &downsample(*msg_ptr);
+      }
+      if (m_load_monitor.degraded()) {
+        cloud_ptr = &limit_points(*cloud_ptr);
+      }
+      insert_plain(*cloud_ptr);
     } catch (const std::length_error & e) {
       // Hit limits of inserting, can still cluster, but in bad state
       RCLCPP_WARN(get_logger(), e.what());
     }
-    m_cluster_alg.cluster(m_clusters);
-    //lint -e{523} NOLINT empty functions to make this modular
-    handle_clusters(m_clusters, msg_ptr->header);
+    if (m_tf_buffer) {
+      update_frame_pose(msg_ptr->header);
+    }
+    if (m_index_output) {
+      m_cluster_alg.cluster(m_cluster_indices);
+      handle_cluster_indices(m_cluster_indices, *cloud_ptr, msg_ptr->header);
+    } else {
+      m_cluster_alg.cluster(m_clusters);
+      //lint -e{523} NOLINT empty functions to make this modular
+      handle_clusters(m_clusters, msg_ptr->header);
+    }
     m_cluster_alg.throw_stored_error();
   } catch (const std::exception & e) {
     RCLCPP_ERROR(get_logger(), e.what());
@@ -0,0 +1,176 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+#include <euclidean_cluster_nodes/parallel_box_fitter.hpp>
+
+#include <iostream>
+#include <stdexcept>
+
+namespace autoware
+{
+namespace perception
+{
+namespace segmentation
+{
+namespace euclidean_cluster_nodes
+{
+////////////////////////////////////////////////////////////////////////////////
+ParallelBoxFitter::ParallelBoxFitter(
+  const BboxMethod method,
+  const bool8_t compute_height,
+  const std::size_t num_threads,
+  const std::size_t max_num_clusters)
+: m_method{method},
+  m_compute_height{compute_height},
+  m_num_threads{num_threads},
+  m_boxes(max_num_clusters),
+  m_valid(max_num_clusters),
+  m_clusters{nullptr},
+  m_cluster_indices{nullptr},
+  m_points{nullptr},
+  m_num_clusters{0U},
+  m_next_cluster{0U},
+  m_generation{0U},
+  m_num_busy{0U},
+  m_stop{false}
+{
+  if (num_threads == 0U) {
+    throw std::domain_error("ParallelBoxFitter: Number of threads must be positive");
+  }
+  // The calling thread is the first worker
+  m_threads.reserve(num_threads - 1U);
+  for (std::size_t idx = 1U; idx < num_threads; ++idx) {
+    m_threads.emplace_back(&ParallelBoxFitter::thread_loop, this);
+  }
+}
+////////////////////////////////////////////////////////////////////////////////
+ParallelBoxFitter::~ParallelBoxFitter()
+{
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_stop = true;
+  }
+  m_start_cv.notify_all();
+  for (auto & thread : m_threads) {
+    thread.join();
+  }
+}
+////////////////////////////////////////////////////////////////////////////////
+void ParallelBoxFitter::compute(Clusters & clusters, BoundingBoxArray & boxes)
+{
+  boxes.boxes.clear();
+  if (clusters.cluster_boundary.size() > m_boxes.size()) {
+    throw std::length_error("ParallelBoxFitter: More clusters than expected");
+  }
+  m_clusters = &clusters;
+  fit(clusters.cluster_boundary.size(), boxes);
+  m_clusters = nullptr;
+}
+////////////////////////////////////////////////////////////////////////////////
+void ParallelBoxFitter::compute(
+  ClusterIndices & clusters, const PointsView & points,
+  BoundingBoxArray & boxes)
+{
+  boxes.boxes.clear();
+  if (clusters.cluster_boundary.size() > m_boxes.size()) {
+    throw std::length_error("ParallelBoxFitter: More clusters than expected");
+  }
+  m_cluster_indices = &clusters;
+  m_points = &points;
+  fit(clusters.cluster_boundary.size(), boxes);
+  m_cluster_indices = nullptr;
+  m_points = nullptr;
+}
+////////////////////////////////////////////////////////////////////////////////
+void ParallelBoxFitter::fit(const std::size_t num_clusters, BoundingBoxArray & boxes)
+{
+  m_num_clusters = num_clusters;
+  m_next_cluster.store(0U);
+  run();
+  for (std::size_t idx = 0U; idx < m_num_clusters; ++idx) {
+    if (m_valid[idx] != 0U) {
+      boxes.boxes.push_back(m_boxes[idx]);
+    }
+  }
+}
+////////////////////////////////////////////////////////////////////////////////
+std::size_t ParallelBoxFitter::get_num_threads() const
+{
+  return m_num_threads;
+}
+////////////////////////////////////////////////////////////////////////////////
+void ParallelBoxFitter::run()
+{
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_num_busy = m_threads.size();
+    ++m_generation;
+  }
+  m_start_cv.notify_all();
+  work();
+  std::unique_lock<std::mutex> lock{m_mutex};
+  m_done_cv.wait(lock, [this] {return m_num_busy == 0U;});
+}
+////////////////////////////////////////////////////////////////////////////////
+void ParallelBoxFitter::work()
+{
+  while (true) {
+    const std::size_t idx = m_next_cluster.fetch_add(1U);
+    if (idx >= m_num_clusters) {
+      return;
+    }
+    // Clusters are disjoint ranges of points, so the fits don't touch each other's points
+    try {
+      const bool8_t valid = (m_clusters != nullptr) ?
+        euclidean_cluster::details::compute_bounding_box(
+        *m_clusters, idx, m_method, m_compute_height, m_boxes[idx]) :
+        euclidean_cluster::details::compute_bounding_box(
+        *m_cluster_indices, *m_points, idx, m_method, m_compute_height, m_boxes[idx]);
+      m_valid[idx] = valid ? 1U : 0U;
+    } catch (const std::exception & e) {
+      m_valid[idx] = 0U;
+      std::cerr << e.what() << std::endl;
+    }
+  }
+}
+////////////////////////////////////////////////////////////////////////////////
+void ParallelBoxFitter::thread_loop()
+{
+  std::size_t generation = 0U;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock{m_mutex};
+      m_start_cv.wait(lock, [this, generation] {return m_stop || (m_generation != generation);});
+      if (m_stop) {
+        return;
+      }
+      generation = m_generation;
+    }
+    work();
+    bool8_t is_last = false;
+    {
+      std::lock_guard<std::mutex> lock{m_mutex};
+      --m_num_busy;
+      is_last = (m_num_busy == 0U);
+    }
+    if (is_last) {
+      m_done_cv.notify_one();
+    }
+  }
+}
+}  // namespace euclidean_cluster_nodes
+}  // namespace segmentation
+}  // namespace perception
+}  // namespace autoware
@@ -19,10 +19,14 @@
 
 #include <rclcpp/rclcpp.hpp>
 #include <euclidean_cluster_nodes/euclidean_cluster_node.hpp>
+#include <euclidean_cluster_nodes/parallel_box_fitter.hpp>
+#include <lidar_utils/point_cloud_utils.hpp>
 
 #include <vector>
 
 using autoware::perception::segmentation::euclidean_cluster_nodes::EuclideanClusterNode;
+using autoware::perception::segmentation::euclidean_cluster_nodes::ParallelBoxFitter;
+using autoware::common::types::float32_t;
 
 class EuclideanClusterNodesTest : public ::testing::Test
 {
@@ -121,6 +125,11 @@ TEST_F(EuclideanClusterNodesTest, instantiate)
   node_options.parameter_overrides(params);
 
   ASSERT_NO_THROW(EuclideanClusterNode{node_options});
+
+  // The clusters of indices can't be published
+  params.emplace_back("cluster.index_output", true);
+  node_options.parameter_overrides(params);
+  ASSERT_THROW(EuclideanClusterNode{node_options}, std::domain_error);
 }
 
 
@@ -243,4 +252,115 @@ TEST_F(EuclideanClusterNodesTest, instantiate_downsample)
   ASSERT_NO_THROW(EuclideanClusterNode{node_options});
 }
 
+TEST(ParallelBoxFitter, matches_serial)
+{
+  using autoware::perception::segmentation::euclidean_cluster::details::compute_bounding_boxes;
+  // Rotated rectangles of different sizes, an empty cluster, and one too small for LFit
+  ParallelBoxFitter::Clusters clusters;
+  for (uint32_t cls_id = 0U; cls_id < 20U; ++cls_id) {
+    const float32_t yaw = 0.1F * static_cast<float32_t>(cls_id);
+    const float32_t width = 1.0F + (0.1F * static_cast<float32_t>(cls_id));
+    uint32_t num_points = 4U * (cls_id + 2U);
+    if (cls_id == 5U) {
+      num_points = 0U;
+    } else if (cls_id == 6U) {
+      num_points = 1U;
+    }
+    for (uint32_t idx = 0U; idx < num_points; ++idx) {
+      const float32_t u = static_cast<float32_t>(idx % 4U) * width;
+      const float32_t v = static_cast<float32_t>(idx / 4U) * 0.5F;
+      autoware_auto_msgs::msg::PointXYZIF pt;
+      pt.x = (10.0F * static_cast<float32_t>(cls_id)) + (u * cosf(yaw)) - (v * sinf(yaw));
+      pt.y = (u * sinf(yaw)) + (v * cosf(yaw));
+      pt.z = 0.1F * static_cast<float32_t>(idx);
+      clusters.points.push_back(pt);
+    }
+    clusters.cluster_boundary.push_back(static_cast<uint32_t>(clusters.points.size()));
+  }
+  for (const auto method : {ParallelBoxFitter::BboxMethod::LFit,
+      ParallelBoxFitter::BboxMethod::Eigenbox})
+  {
+    // Fitting shuffles the points, so both start from the same clusters
+    auto serial_clusters = clusters;
+    const auto expected = compute_bounding_boxes(serial_clusters, method, true);
+    ParallelBoxFitter fitter{method, true, 3U, 20U};
+    EXPECT_EQ(fitter.get_num_threads(), 3U);
+    auto parallel_clusters = clusters;
+    ParallelBoxFitter::BoundingBoxArray boxes;
+    fitter.compute(parallel_clusters, boxes);
+    ASSERT_EQ(boxes.boxes.size(), expected.boxes.size());
+    for (std::size_t idx = 0U; idx < boxes.boxes.size(); ++idx) {
+      EXPECT_FLOAT_EQ(boxes.boxes[idx].centroid.x, expected.boxes[idx].centroid.x);
+      EXPECT_FLOAT_EQ(boxes.boxes[idx].centroid.y, expected.boxes[idx].centroid.y);
+      EXPECT_FLOAT_EQ(boxes.boxes[idx].centroid.z, expected.boxes[idx].centroid.z);
+      EXPECT_FLOAT_EQ(boxes.boxes[idx].size.x, expected.boxes[idx].size.x);
+      EXPECT_FLOAT_EQ(boxes.boxes[idx].size.y, expected.boxes[idx].size.y);
+    }
+  }
+  ParallelBoxFitter fitter{ParallelBoxFitter::BboxMethod::LFit, false, 2U, 19U};
+  ParallelBoxFitter::BoundingBoxArray boxes;
+  EXPECT_THROW(fitter.compute(clusters, boxes), std::length_error);
+  EXPECT_THROW(
+    ParallelBoxFitter(ParallelBoxFitter::BboxMethod::LFit, false, 0U, 1U), std::domain_error);
+}
+
+TEST(ParallelBoxFitter, indices_match_serial)
+{
+  using autoware::perception::segmentation::euclidean_cluster::details::compute_bounding_boxes;
+  // Rotated rectangles, with an empty cluster. The cloud has the points in reverse order
+  ParallelBoxFitter::Clusters clusters;
+  for (uint32_t cls_id = 0U; cls_id < 10U; ++cls_id) {
+    const float32_t yaw = 0.2F * static_cast<float32_t>(cls_id);
+    const uint32_t num_points = (cls_id == 3U) ? 0U : (4U * (cls_id + 2U));
+    for (uint32_t idx = 0U; idx < num_points; ++idx) {
+      const float32_t u = static_cast<float32_t>(idx % 4U);
+      const float32_t v = static_cast<float32_t>(idx / 4U) * 0.5F;
+      autoware_auto_msgs::msg::PointXYZIF pt;
+      pt.x = (10.0F * static_cast<float32_t>(cls_id)) + (u * cosf(yaw)) - (v * sinf(yaw));
+      pt.y = (u * sinf(yaw)) + (v * cosf(yaw));
+      pt.z = 0.1F * static_cast<float32_t>(idx);
+      clusters.points.push_back(pt);
+    }
+    clusters.cluster_boundary.push_back(static_cast<uint32_t>(clusters.points.size()));
+  }
+  const auto num_points = static_cast<uint32_t>(clusters.points.size());
+  sensor_msgs::msg::PointCloud2 cloud;
+  autoware::common::lidar_utils::init_pcl_msg(cloud, "base_link", num_points);
+  uint32_t cloud_idx = 0U;
+  ParallelBoxFitter::ClusterIndices indices;
+  indices.cluster_boundary = clusters.cluster_boundary;
+  for (uint32_t idx = 0U; idx < num_points; ++idx) {
+    const auto & cluster_pt = clusters.points[num_points - 1U - idx];
+    autoware::common::types::PointXYZIF pt;
+    pt.x = cluster_pt.x;
+    pt.y = cluster_pt.y;
+    pt.z = cluster_pt.z;
+    (void)autoware::common::lidar_utils::add_point_to_cloud(cloud, pt, cloud_idx);
+    indices.point_indices.push_back(num_points - 1U - idx);
+  }
+  const ParallelBoxFitter::PointsView points{cloud, 3U};
+  for (const auto method : {ParallelBoxFitter::BboxMethod::LFit,
+      ParallelBoxFitter::BboxMethod::LFitSearch, ParallelBoxFitter::BboxMethod::Eigenbox})
+  {
+    auto serial_clusters = clusters;
+    const auto expected = compute_bounding_boxes(serial_clusters, method, true);
+    ParallelBoxFitter fitter{method, true, 3U, 10U};
+    auto parallel_indices = indices;
+    ParallelBoxFitter::BoundingBoxArray boxes;
+    fitter.compute(parallel_indices, points, boxes);
+    ASSERT_EQ(boxes.boxes.size(), 9U);
+    ASSERT_EQ(boxes.boxes.size(), expected.boxes.size());
+    for (std::size_t idx = 0U; idx < boxes.boxes.size(); ++idx) {
+      EXPECT_FLOAT_EQ(boxes.boxes[idx].centroid.x, expected.boxes[idx].centroid.x);
+      EXPECT_FLOAT_EQ(boxes.boxes[idx].centroid.y, expected.boxes[idx].centroid.y);
+      EXPECT_FLOAT_EQ(boxes.boxes[idx].centroid.z, expected.boxes[idx].centroid.z);
+      EXPECT_FLOAT_EQ(boxes.boxes[idx].size.x, expected.boxes[idx].size.x);
+      EXPECT_FLOAT_EQ(boxes.boxes[idx].size.y, expected.boxes[idx].size.y);
+    }
+  }
+  ParallelBoxFitter fitter{ParallelBoxFitter::BboxMethod::LFit, false, 2U, 9U};
+  ParallelBoxFitter::BoundingBoxArray boxes;
+  EXPECT_THROW(fitter.compute(indices, points, boxes), std::length_error);
+}
+
 #endif  // TEST_EUCLIDEAN_CLUSTER_NODES_HPP_
@@ -20,14 +20,15 @@
 #include <autoware_auto_msgs/msg/detected_object.hpp>
 #include <autoware_auto_msgs/msg/object_classification.hpp>
 #include <helper_functions/float_comparisons.hpp>
-#include <state_estimation/kalman_filter/kalman_filter.hpp>
-#include <state_estimation/measurement/linear_measurement.hpp>
 #include <state_vector/variable.hpp>
 #include <tracking/track_class_variable.hpp>
 #include <tracking/visibility_control.hpp>
 
+#include <atomic>
+#include <cmath>
 #include <iostream>
 #include <limits>
+#include <stdexcept>
 
 namespace autoware
 {
@@ -39,24 +40,22 @@ namespace tracking
 ///
 /// @brief      A class for tracking classification information that works on any set of variables.
 ///
-/// @details    Under the hood, this class uses the autoware::common::state_estimation::KalmanFilter
-///             class with a special state vector containing all the relevant classes that we aim to
-///             track. The state vector directly holds the probabilities in its values. If the
-///             observation covariance for any particular observation is the same for all observed
-///             classes, then the underlying vector is guaranteed to represent probabilities that
-///             always sum up to 1.
+/// @details    This class is a correction-only Kalman filter on a special state vector containing
+///             all the relevant classes that we aim to track. The state vector directly holds the
+///             probabilities in its values. The observation covariance of an observation is the
+///             same for all classes and the initial covariance is a multiple of the identity, so
+///             the covariance of the state always stays a multiple of the identity. The filter
+///             therefore only stores a single variance and the correction boils down to blending
+///             the state with the observation by a scalar gain, which is the same as the dense
+///             Kalman filter correction but costs O(n) instead of O(n^3) for n classes. It also
+///             guarantees that the underlying vector represents probabilities that always sum
+///             up to 1.
 ///
 /// @tparam     ClassificationStateT  A state that defines all classes that can be tracked.
 ///
 template<typename ClassificationStateT>
 class TRACKING_PUBLIC GenericClassificationTracker
 {
-  /// A convenience typedef for the underlying Kalman filter.
-  using ClassTrackerKalmanFilter =
-    decltype(common::state_estimation::make_correction_only_kalman_filter(
-      std::declval<ClassificationStateT>(),
-      std::declval<typename ClassificationStateT::Matrix>()));
-
 public:
   /// Default constructor.
   GenericClassificationTracker() = default;
@@ -95,10 +94,7 @@ public:
     const autoware_auto_msgs::msg::DetectedObject::_classification_type & classification_vector,
     const common::types::float32_t observation_covariance)
   {
-    auto measurement =
-      common::state_estimation::LinearMeasurement<ClassificationStateT>::create_with_stddev(
-      ClassificationStateT::Vector::Constant(0.0F),
-      ClassificationStateT::Vector::Constant(observation_covariance));
+    ClassificationStateT measurement{};
     for (const auto & classification : classification_vector) {
       // We can use the classification as a direct index into the state because within this class we
       // guarantee that the variable that corresponds to a certain index within the
@@ -107,18 +103,28 @@ public:
       if (std::isnan(classification.probability)) {
         throw std::domain_error("Provided classification probability is NAN.");
       }
-      measurement.state()[classification.classification] = classification.probability;
+      measurement[classification.classification] = classification.probability;
     }
-    const auto sum = measurement.state().vector().sum();
+    const auto sum = measurement.vector().sum();
     if (sum > 1.0F) {
       throw std::domain_error("Sum of all probabilities in the classification of an object is > 1");
     } else if (sum < 1.0F) {
       // Any gap in the total probability mass contributes to the likelihood of an unknown state.
-      std::cerr << "WARNING: Sum of all classification probabilities is less than one. "
-        "Assigning the missing probability to the UNKNOWN class." << std::endl;
-      measurement.state()[autoware_auto_msgs::msg::ObjectClassification::UNKNOWN] = 1.0F - sum;
+      // This is common for detectors that only report their top class, so only warn once instead
+      // of writing to the console for every detection.
+      static std::atomic<bool> s_warned{false};
+      if (!s_warned.exchange(true)) {
+        std::cerr << "WARNING: Sum of all classification probabilities is less than one. "
+          "Assigning the missing probability to the UNKNOWN class." << std::endl;
+      }
+      measurement[autoware_auto_msgs::msg::ObjectClassification::UNKNOWN] = 1.0F - sum;
     }
-    m_tracker.correct(measurement);
+    // The Kalman filter correction with the observation covariance (observation_covariance^2) * I
+    // and the state covariance m_variance * I.
+    const auto observation_variance = observation_covariance * observation_covariance;
+    const auto gain = m_variance * (1.0F / (m_variance + observation_variance));
+    m_state.vector() += gain * (measurement.vector() - m_state.vector());
+    m_variance -= gain * m_variance;
   }
 
   ///
@@ -129,7 +135,7 @@ public:
   std::uint8_t most_likely_class() const
   {
     std::uint8_t index_of_the_max_value{};
-    m_tracker.state().vector().maxCoeff(&index_of_the_max_value);
+    m_state.vector().maxCoeff(&index_of_the_max_value);
     return index_of_the_max_value;
   }
 
@@ -145,14 +151,17 @@ public:
     for (uint8_t label = 0U; label < ClassificationStateT::size(); ++label) {
       autoware_auto_msgs::msg::ObjectClassification object_classification;
       object_classification.classification = label;
-      object_classification.probability = m_tracker.state()[label];
+      object_classification.probability = m_state[label];
       classification_vector.emplace_back(object_classification);
     }
     return classification_vector;
   }
 
   /// @brief      Expose the underlying state for utility purposes.
-  const ClassificationStateT & state() const noexcept {return m_tracker.state();}
+  const ClassificationStateT & state() const noexcept {return m_state;}
+
+  /// @brief      Expose the variance of each of the class probabilities.
+  autoware::common::types::float32_t variance() const noexcept {return m_variance;}
 
   /// @brief      Expose the observation covariance.
   autoware::common::types::float32_t default_observation_covariance() const noexcept
@@ -173,11 +182,12 @@ private:
   }
 
 
-  /// The underlying Kalman filter.
-  ClassTrackerKalmanFilter m_tracker = common::state_estimation::make_correction_only_kalman_filter(
-    create_initial_classification_vector(),
-    std::numeric_limits<common::types::float32_t>::max() *
-    ClassificationStateT::Matrix::Identity());
+  /// The class probabilities.
+  ClassificationStateT m_state{create_initial_classification_vector()};
+
+  /// The variance of each class probability, the state covariance is this times the identity.
+  autoware::common::types::float32_t m_variance{
+    std::numeric_limits<common::types::float32_t>::max()};
 
   /// The default observation covariance.
   autoware::common::types::float32_t m_default_observation_covariance{0.1F};
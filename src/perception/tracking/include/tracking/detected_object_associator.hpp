@@ -18,7 +18,7 @@
 
 #include <autoware_auto_msgs/msg/detected_objects.hpp>
 #include <common/types.hpp>
-#include <hungarian_assigner/hungarian_assigner.hpp>
+#include <hungarian_assigner/sparse_assigner.hpp>
 #include <tracking/tracker_types.hpp>
 #include <tracking/tracked_object.hpp>
 
@@ -74,7 +74,7 @@ private:
 class TRACKING_PUBLIC DetectedObjectAssociator
 {
 public:
-  using Assigner = autoware::fusion::hungarian_assigner::hungarian_assigner_c<MAX_NUM_TRACKS>;
+  using Assigner = autoware::fusion::hungarian_assigner::sparse_assigner_c<MAX_NUM_TRACKS>;
   /// \brief Constructor
   /// \param association_cfg Config object containing parameters to be used
   explicit DetectedObjectAssociator(const DataAssociationConfig & association_cfg);
@@ -91,14 +91,24 @@ private:
   /// \brief Reset internal states of the associator
   void reset();
 
-  /// \brief Loop through all detections and tracks and set weights between them in the assigner
+  /// \brief Loop through all detections and the tracks within their distance gate and set
+  ///        weights between them in the assigner
   void compute_weights(
     const autoware_auto_msgs::msg::DetectedObjects & detections,
     const std::vector<TrackedObject> & tracks);
 
-  /// \brief Check if the given track and detection are similar enough to compute weight
-  bool consider_associating(
-    const autoware_auto_msgs::msg::DetectedObject & detection, const TrackedObject & track) const;
+  /// \brief Store the centroids, inverse position covariances and areas of the tracks as arrays
+  ///        sorted by x, so that gating is a binary search and rows are scored in one loop
+  void cache_tracks(const std::vector<TrackedObject> & tracks);
+
+  /// \brief Set the weights between a detection and all tracks that it can be associated with
+  void compute_row(
+    const autoware_auto_msgs::msg::DetectedObject & detection, const size_t det_idx,
+    const std::vector<TrackedObject> & tracks);
+
+  /// \brief Squared distance threshold between a detection and a track centroid
+  float32_t distance_threshold_squared(
+    const autoware_auto_msgs::msg::DetectedObject & detection) const;
 
   /// Set weight in the assigner (Has to determine which idx is row and which is column)
   void set_weight(const float32_t weight, const size_t det_idx, const size_t track_idx);
@@ -113,6 +123,17 @@ private:
   size_t m_num_tracks;
   size_t m_num_detections;
   bool m_had_errors = false;
+  // Tracks with a valid shape in structure of arrays layout, sorted by centroid x
+  std::vector<size_t> m_track_order;
+  std::vector<float32_t> m_track_x;
+  std::vector<float32_t> m_track_y;
+  std::vector<float32_t> m_track_area;
+  // Inverse of the position covariance, NaN if it has no closed form inverse
+  std::vector<float32_t> m_track_inv_xx;
+  std::vector<float32_t> m_track_inv_xy;
+  std::vector<float32_t> m_track_inv_yy;
+  // Weight of each sorted track for the current detection, negative if it can't be associated
+  std::vector<float32_t> m_row_weights;
 };
 
 
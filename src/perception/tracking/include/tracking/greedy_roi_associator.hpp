@@ -53,6 +53,41 @@ struct TRACKING_PUBLIC IOUHeuristic
   }
 };
 
+namespace details
+{
+/// \brief Index of the axis-aligned extents of the ROIs of a message in the image. The IoU of a
+///        projection and a ROI can only be positive if their extents overlap, so the index is used
+///        to skip the other ROIs without computing the IoU.
+class TRACKING_PUBLIC RoiExtentIndex
+{
+public:
+  using float32_t = common::types::float32_t;
+  /// \brief Constructor, builds the index
+  /// \param rois ROIs to index. ROIs without polygon points are left out.
+  explicit RoiExtentIndex(const autoware_auto_msgs::msg::ClassifiedRoiArray & rois);
+  /// \brief Find the ROIs whose extent overlaps with the extent of a projection, in
+  ///        O(log n + k) for k ROIs whose x extent starts within the widest ROI width of the
+  ///        projection
+  /// \param projection Projection of a shape
+  /// \param[out] candidates Indices of the overlapping ROIs in ascending order, cleared first
+  void query(const Projection & projection, std::vector<std::size_t> & candidates) const;
+
+private:
+  struct Extent
+  {
+    float32_t min_x;
+    float32_t max_x;
+    float32_t min_y;
+    float32_t max_y;
+    std::size_t roi_idx;
+  };
+  // Sorted by min_x
+  std::vector<Extent> m_extents;
+  // Width of the widest extent, bounds how far left of a query a candidate can start
+  float32_t m_max_width{0.0F};
+};
+}  // namespace details
+
 struct GreedyRoiAssociatorConfig
 {
   CameraIntrinsics intrinsics;
@@ -99,12 +134,14 @@ public:
   ) const;
 
 private:
-  // Scan the ROIs to find the best matching roi for a given shape by projecting it onto image
-  // frame
+  // Find the best matching roi for a given shape by projecting it onto image frame. Only the
+  // ROIs whose extent overlaps with the extent of the projection are scored.
   std::size_t project_and_match_detection(
     const std::vector<geometry_msgs::msg::Point32> & object_shape_in_camera_frame,
     const std::unordered_set<std::size_t> & available_roi_indices,
-    const autoware_auto_msgs::msg::ClassifiedRoiArray & rois) const;
+    const autoware_auto_msgs::msg::ClassifiedRoiArray & rois,
+    const details::RoiExtentIndex & roi_index,
+    std::vector<std::size_t> & candidates) const;
 
   CameraModel m_camera;
   IOUHeuristic m_iou_func{};
@@ -33,11 +33,15 @@
 #include "autoware_auto_msgs/msg/tracked_objects.hpp"
 #include "common/types.hpp"
 #include "geometry_msgs/msg/transform_stamped.hpp"
+#include "measurement_conversion/measurement_typedefs.hpp"
 #include "nav_msgs/msg/odometry.hpp"
 #include "tracking/detected_object_associator.hpp"
 #include "tracking/greedy_roi_associator.hpp"
+#include "tracking/parallel_track_predictor.hpp"
 #include "tracking/track_creator.hpp"
+#include "tracking/track_store.hpp"
 #include "tracking/tracked_object.hpp"
+#include "tracking/tracker_types.hpp"
 #include "state_vector/common_states.hpp"
 #include "state_estimation/kalman_filter/kalman_filter.hpp"
 #include "motion_model/linear_motion_model.hpp"
@@ -74,6 +78,25 @@ enum class TrackerUpdateStatus
 
 
 /// \brief Output of MultiObjectTracker::update.
+/// Time spent in the stages of an update with detections, to find out how they scale.
+struct TRACKING_PUBLIC TrackerUpdateTimings
+{
+  /// Transforming the detections into the tracking frame.
+  std::chrono::nanoseconds transform{0};
+  /// Predicting the tracks forward to the time of the detections.
+  std::chrono::nanoseconds predict{0};
+  /// Associating the detections with the tracks.
+  std::chrono::nanoseconds associate{0};
+  /// Updating the tracks with the associated detections.
+  std::chrono::nanoseconds update{0};
+  /// Creating tracks from the detections that are not associated.
+  std::chrono::nanoseconds create{0};
+  /// Removing the tracks that were not seen for too long.
+  std::chrono::nanoseconds prune{0};
+  /// Building the output message.
+  std::chrono::nanoseconds output{0};
+};
+
 struct TRACKING_PUBLIC TrackerUpdateResult
 {
   /// The tracking output. It can be nullptr when the status is not Ok.
@@ -82,6 +105,8 @@ struct TRACKING_PUBLIC TrackerUpdateResult
   TrackerUpdateStatus status;
   /// How many of the input objects are not present in the output.
   int ignored = 0;
+  /// Time spent in the stages of the update. Only set when the status is Ok.
+  TrackerUpdateTimings timings;
 };
 
 /// \brief Options for object tracking, with sensible defaults.
@@ -99,6 +124,11 @@ struct TRACKING_PUBLIC MultiObjectTrackerOptions
   std::size_t pruning_ticks_threshold = std::numeric_limits<std::size_t>::max();
   /// The frame in which to do tracking.
   std::string frame = "map";  // This default probably does not need to be changed.
+  /// Number of threads that predict the tracks forward, including the calling thread.
+  std::size_t num_prediction_threads = 1U;
+  /// Number of tracks to reserve memory for, so that creating and removing tracks does not
+  /// allocate as long as there are not more tracks than this.
+  std::size_t track_capacity = MAX_NUM_TRACKS;
 };
 
 
@@ -112,6 +142,7 @@ private:
 
 public:
   /// Constructor
+  /// \throw std::domain_error If the number of prediction threads is 0
   explicit MultiObjectTracker(MultiObjectTrackerOptions options);
 
   /// \brief Update the tracks with the specified detections and return the tracks at the current
@@ -131,22 +162,42 @@ public:
     const ClassifiedRoiArrayMsg & rois,
     const geometry_msgs::msg::Transform & tf_camera_from_track);
 
+  /// \brief Get the tracks extrapolated to a time with their motion models, e.g. to the time of
+  /// publication so that consumers don't get tracks that are already stale. The tracks themselves
+  /// are not changed, so this can be called any number of times between updates.
+  /// \param[in] stamp The time to extrapolate to, not before the last update with detections.
+  /// \return A result object containing the extrapolated tracks, stamped with the given time, or
+  /// the status WentBackInTime and no tracks if the time is before the last update. Only the
+  /// predict and output timings are set.
+  TrackerUpdateResult extrapolate(const builtin_interfaces::msg::Time & stamp);
+
 private:
   /// Check that the input data is valid.
   TrackerUpdateStatus validate(
     const DetectedObjectsMsg & detections,
     const nav_msgs::msg::Odometry & detection_frame_odometry);
 
-  /// Transform the detections into the tracker frame.
+  /// Transform the detections into the tracker frame and convert their positions into
+  /// measurements.
   void transform(
     DetectedObjectsMsg & detections,
     const nav_msgs::msg::Odometry & detection_frame_odometry);
 
   /// Convert the internal tracked object representation to the ROS message type.
-  TrackedObjectsMsg convert_to_msg(const builtin_interfaces::msg::Time & stamp) const;
+  TrackedObjectsMsg convert_to_msg(
+    std::vector<TrackedObject> & tracks,
+    const builtin_interfaces::msg::Time & stamp) const;
 
   /// The tracked objects, also called "tracks".
-  std::vector<TrackedObject> m_objects;
+  TrackStore m_tracks;
+
+  /// The positions of the detections of the current update in the tracking frame, in the order
+  /// of the detections. Kept as a member so that its memory is reused across updates.
+  common::state_estimation::MeasurementVector<TrackedObject::PositionMeasurement> m_measurements;
+
+  /// Copies of the tracks that extrapolate() predicts. Kept as a member so that copying the tracks
+  /// reuses the buffers of the previous copies.
+  std::vector<TrackedObject> m_extrapolated_tracks;
 
   /// Timestamp of the last update.
   std::chrono::system_clock::time_point m_last_update;
@@ -154,6 +205,10 @@ private:
   /// Configuration values.
   MultiObjectTrackerOptions m_options;
 
+  /// Thread pool for predicting the tracks forward. Held by pointer so that the tracker stays
+  /// movable.
+  std::unique_ptr<ParallelTrackPredictor> m_predictor;
+
   /// Associator for matching observations to tracks.
   DetectedObjectAssociator m_object_associator;
 
@@ -0,0 +1,104 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+/// \copyright Copyright 2021 The Autoware Foundation
+/// \file
+/// \brief This file defines a helper that predicts tracks forward on a pool of threads.
+
+#ifndef TRACKING__PARALLEL_TRACK_PREDICTOR_HPP_
+#define TRACKING__PARALLEL_TRACK_PREDICTOR_HPP_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "common/types.hpp"
+#include "tracking/tracked_object.hpp"
+#include "tracking/visibility_control.hpp"
+
+namespace autoware
+{
+namespace perception
+{
+namespace tracking
+{
+
+/// \brief Predicts tracks forward on a fixed pool of threads. The tracks are independent of each
+///        other, so each thread predicts a contiguous range of the track array. The result is the
+///        same as predicting the tracks one after the other.
+class TRACKING_PUBLIC ParallelTrackPredictor
+{
+public:
+  /// \brief Below this number of tracks per thread, the tracks are predicted on the calling
+  ///        thread only, since waking up the pool would take longer than the prediction
+  static constexpr std::size_t MIN_TRACKS_PER_THREAD = 16U;
+
+  /// \brief Constructor, starts the threads
+  /// \param[in] num_threads Number of threads including the calling thread, which always
+  ///                        takes part in the work
+  /// \throw std::domain_error If the number of threads is 0
+  explicit ParallelTrackPredictor(std::size_t num_threads);
+  /// \brief Destructor, stops and joins the threads
+  ~ParallelTrackPredictor();
+
+  ParallelTrackPredictor(const ParallelTrackPredictor &) = delete;
+  ParallelTrackPredictor & operator=(const ParallelTrackPredictor &) = delete;
+
+  /// \brief Predict all tracks forward
+  /// \param[inout] tracks The tracks to predict
+  /// \param[in] dt The time to predict the tracks forward by
+  /// \throw std::runtime_error If predicting a track failed on one of the pool threads
+  void predict(std::vector<TrackedObject> & tracks, std::chrono::nanoseconds dt);
+
+  /// \brief Get the number of threads including the calling thread
+  std::size_t get_num_threads() const;
+
+private:
+  struct Worker
+  {
+    // Set if predicting one of the tracks of the worker threw
+    common::types::bool8_t failed = false;
+  };
+
+  /// \brief Predict the range of tracks of one worker
+  TRACKING_LOCAL void work(std::size_t worker_idx);
+  /// \brief Loop of the pool threads
+  TRACKING_LOCAL void thread_loop(std::size_t worker_idx);
+
+  const std::size_t m_num_threads;
+  // State of the current call, only valid during predict()
+  std::vector<TrackedObject> * m_tracks;
+  std::chrono::nanoseconds m_dt;
+  std::size_t m_num_workers;
+  std::vector<Worker> m_workers;
+  // Synchronization with the pool threads
+  std::mutex m_mutex;
+  std::condition_variable m_start_cv;
+  std::condition_variable m_done_cv;
+  std::size_t m_generation;
+  std::size_t m_num_busy;
+  common::types::bool8_t m_stop;
+  std::vector<std::thread> m_threads;
+};
+
+}  // namespace tracking
+}  // namespace perception
+}  // namespace autoware
+
+#endif  // TRACKING__PARALLEL_TRACK_PREDICTOR_HPP_
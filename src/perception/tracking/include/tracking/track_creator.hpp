@@ -22,6 +22,7 @@
 #include <common/types.hpp>
 #include <message_filters/cache.h>
 #include <tracking/greedy_roi_associator.hpp>
+#include <tracking/track_store.hpp>
 #include <tracking/tracked_object.hpp>
 #include <tracking/tracker_types.hpp>
 #include <tracking/visibility_control.hpp>
@@ -82,8 +83,9 @@ public:
   CreationPolicyBase(const float64_t default_variance, const float64_t noise_variance);
 
   /// Function to create new tracks based on previously supplied detection data
-  /// \return Struct containing new tracks and unused detections
-  virtual TracksAndLeftovers create() = 0;
+  /// \param tracks Store to add the new tracks to
+  /// \return Detections that were not used to create tracks
+  virtual autoware_auto_msgs::msg::DetectedObjects create(TrackStore & tracks) = 0;
 
   /// \brief Keep tracks of all unassigned lidar clusters. Clears the previously passed clusters
   /// \param clusters DetectedObjects msg output by the lidar clustering algorithm
@@ -120,7 +122,7 @@ class LidarOnlyPolicy : public CreationPolicyBase
 {
 public:
   LidarOnlyPolicy(const float64_t default_variance, const float64_t noise_variance);
-  TracksAndLeftovers create() override;
+  autoware_auto_msgs::msg::DetectedObjects create(TrackStore & tracks) override;
 
   void add_objects(
     const autoware_auto_msgs::msg::DetectedObjects & clusters,
@@ -144,7 +146,7 @@ public:
   LidarClusterIfVisionPolicy(
     const VisionPolicyConfig & cfg, const float64_t default_variance,
     const float64_t noise_variance);
-  TracksAndLeftovers create() override;
+  autoware_auto_msgs::msg::DetectedObjects create(TrackStore & tracks) override;
 
   void add_objects(
     const autoware_auto_msgs::msg::DetectedObjects & clusters,
@@ -176,7 +178,17 @@ public:
   /// \brief Create new tracks based on the policy and unassociated detections. Call the
   ///        appropriate add_unassigned_* functions before calling this.
   /// \return vector of newly created TrackedObject objects
-  inline TracksAndLeftovers create_tracks() {return m_policy_object->create();}
+  TracksAndLeftovers create_tracks();
+
+  /// \brief Create new tracks based on the policy and unassociated detections, directly in a
+  ///        track store so that removed tracks are reused. Call the appropriate add_unassigned_*
+  ///        functions before calling this.
+  /// \param tracks Store to add the new tracks to
+  /// \return Detections that were not used to create tracks
+  inline autoware_auto_msgs::msg::DetectedObjects create_tracks(TrackStore & tracks)
+  {
+    return m_policy_object->create(tracks);
+  }
 
   /// Function to add unassigned detections. This function just passes through the arguments.
   /// The actual implementation is handled by the individual policy implementation classes.
@@ -0,0 +1,109 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+/// \copyright Copyright 2021 The Autoware Foundation
+/// \file
+/// \brief This file defines a pooled container for the tracks of the tracker.
+
+#ifndef TRACKING__TRACK_STORE_HPP_
+#define TRACKING__TRACK_STORE_HPP_
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "autoware_auto_msgs/msg/detected_object.hpp"
+#include "common/types.hpp"
+#include "tracking/tracked_object.hpp"
+#include "tracking/visibility_control.hpp"
+
+namespace autoware
+{
+namespace perception
+{
+namespace tracking
+{
+
+/// \brief Container for the live tracks that keeps removed tracks on a free list. A new track
+///        reuses a removed one, including the buffers in its message, so that track creation and
+///        removal don't allocate once the store has held as many tracks as it does at peak. The
+///        live tracks are kept contiguous so that they can be passed to the associators as they
+///        are.
+class TRACKING_PUBLIC TrackStore
+{
+public:
+  using DetectedObjectMsg = autoware_auto_msgs::msg::DetectedObject;
+
+  /// \brief Constructor, reserves space for the given number of live and removed tracks. More
+  ///        tracks than this can be held, but adding them allocates.
+  /// \param[in] capacity The number of tracks to reserve space for
+  explicit TrackStore(std::size_t capacity);
+
+  /// \brief Add a track initialized from a detection, reusing a removed track if there is one
+  /// \param[in] detection A detection from which to initialize the track. Must have a pose.
+  /// \param[in] default_variance See TrackedObject
+  /// \param[in] noise_variance See TrackedObject
+  /// \return The new track
+  /// \throws std::runtime_error if the detection does not have a pose.
+  TrackedObject & emplace(
+    const DetectedObjectMsg & detection, common::types::float64_t default_variance,
+    common::types::float64_t noise_variance);
+
+  /// \brief Remove all tracks for which the predicate is true. Each removed track is replaced by
+  ///        the last track, so that removing a track costs one move. This does not preserve the
+  ///        order of the tracks.
+  /// \param[in] predicate Function taking a const TrackedObject & and returning whether to remove
+  ///                      the track
+  template<typename PredicateT>
+  void remove_if(PredicateT && predicate)
+  {
+    std::size_t idx = 0U;
+    while (idx < m_tracks.size()) {
+      if (predicate(static_cast<const TrackedObject &>(m_tracks[idx]))) {
+        m_free.push_back(std::move(m_tracks[idx]));
+        if (idx + 1U != m_tracks.size()) {
+          m_tracks[idx] = std::move(m_tracks.back());
+        }
+        m_tracks.pop_back();
+      } else {
+        ++idx;
+      }
+    }
+  }
+
+  /// \brief Get the live tracks
+  inline std::vector<TrackedObject> & tracks() {return m_tracks;}
+  /// \brief Get the live tracks
+  inline const std::vector<TrackedObject> & tracks() const {return m_tracks;}
+  /// \brief Get the number of live tracks
+  inline std::size_t size() const {return m_tracks.size();}
+  /// \brief Get the number of removed tracks that are kept for reuse
+  inline std::size_t num_free() const {return m_free.size();}
+  /// \brief Get the number of tracks that the store was constructed for
+  inline std::size_t capacity() const {return m_capacity;}
+
+private:
+  std::size_t m_capacity;
+  std::vector<TrackedObject> m_tracks;
+  // Removed tracks, the last one is reused first
+  std::vector<TrackedObject> m_free;
+};
+
+}  // namespace tracking
+}  // namespace perception
+}  // namespace autoware
+
+#endif  // TRACKING__TRACK_STORE_HPP_
@@ -29,6 +29,7 @@
 #include "autoware_auto_msgs/msg/shape.hpp"
 #include "autoware_auto_msgs/msg/tracked_objects.hpp"
 #include "common/types.hpp"
+#include "measurement_conversion/measurement_typedefs.hpp"
 #include "motion_model/linear_motion_model.hpp"
 #include "state_estimation/kalman_filter/kalman_filter.hpp"
 #include "state_estimation/noise_model/wiener_noise.hpp"
@@ -56,6 +57,7 @@ public:
   using DetectedObjectMsg = autoware_auto_msgs::msg::DetectedObject;
   using ObjectClassifications = autoware_auto_msgs::msg::TrackedObject::_classification_type;
   using ShapeMsg = autoware_auto_msgs::msg::Shape;
+  using PositionMeasurement = autoware::common::state_estimation::PoseMeasurementXYZ64;
 
   /// Constructor
   /// \param detection A detection from which to initialize this object. Must have a pose.
@@ -66,6 +68,18 @@ public:
   TrackedObject(
     const DetectedObjectMsg & detection, common::types::float64_t default_variance,
     common::types::float64_t noise_variance);
+
+  /// Reinitialize this object from a detection, as if it had been newly constructed. The buffers
+  /// of the message are kept, so this does not allocate if the detection fits into them.
+  /// \param detection A detection from which to initialize this object. Must have a pose.
+  /// \param default_variance All variables will initially have this variance where the detection
+  /// does not contain one.
+  /// \param noise_variance The sigma for the acceleration noise
+  /// \throws std::runtime_error if the detection does not have a pose.
+  void reset(
+    const DetectedObjectMsg & detection, common::types::float64_t default_variance,
+    common::types::float64_t noise_variance);
+
   /// Extrapolate the track forward.
   // TODO(nikolai.morin): Change signature to use absolute time after #1002
   void predict(std::chrono::nanoseconds dt);
@@ -73,6 +87,12 @@ public:
   /// Adjust the track to the detection.
   void update(const DetectedObjectMsg & detection);
 
+  /// Adjust the track to the detection, with its position already converted to a measurement.
+  /// \param detection The detection, for everything but the position.
+  /// \param measurement The position of the detection. Its covariance is replaced by the default
+  /// variance if the detection has no position covariance.
+  void update(const DetectedObjectMsg & detection, const PositionMeasurement & measurement);
+
   /// Update just the classification state of the track
   void update(const ObjectClassifications & obj_type);
 
@@ -107,6 +127,9 @@ public:
   }
 
 private:
+  /// Set a new object id and fill the message and classifier from the detection.
+  void initialize_from(const DetectedObjectMsg & detection);
+
   /// The final to-be-published object.
   TrackedObjectMsg m_msg;
   /// The state estimator.
@@ -21,7 +21,9 @@
 #include <helper_functions/mahalanobis_distance.hpp>
 
 #include <algorithm>
+#include <cmath>
 #include <limits>
+#include <stdexcept>
 #include <vector>
 
 namespace autoware
@@ -37,6 +39,24 @@ using autoware::common::types::float32_t;
 
 constexpr std::size_t AssociatorResult::UNASSIGNED;
 
+namespace
+{
+/// \brief Compute the area of a shape
+/// \return False if the area is zero or the points of the shape are not ordered, in which case
+///         the shape can't be associated
+bool checked_area(const autoware_auto_msgs::msg::Shape & shape, float32_t & area)
+{
+  static constexpr float32_t kAreaEps = 1e-3F;
+  try {
+    area = common::geometry::area_checked_2d(
+      shape.polygon.points.begin(), shape.polygon.points.end());
+  } catch (const std::domain_error &) {
+    return false;
+  }
+  return !common::helper_functions::comparisons::abs_eq_zero(area, kAreaEps);
+}
+}  // namespace
+
 DataAssociationConfig::DataAssociationConfig(
   const float32_t max_distance,
   const float32_t max_area_ratio,
@@ -46,7 +66,17 @@ DataAssociationConfig::DataAssociationConfig(
   m_consider_edge_for_big_detections(consider_edge_for_big_detections) {}
 
 DetectedObjectAssociator::DetectedObjectAssociator(const DataAssociationConfig & association_cfg)
-: m_association_cfg(association_cfg) {}
+: m_association_cfg(association_cfg)
+{
+  m_track_order.reserve(MAX_NUM_TRACKS);
+  m_track_x.reserve(MAX_NUM_TRACKS);
+  m_track_y.reserve(MAX_NUM_TRACKS);
+  m_track_area.reserve(MAX_NUM_TRACKS);
+  m_track_inv_xx.reserve(MAX_NUM_TRACKS);
+  m_track_inv_xy.reserve(MAX_NUM_TRACKS);
+  m_track_inv_yy.reserve(MAX_NUM_TRACKS);
+  m_row_weights.reserve(MAX_NUM_TRACKS);
+}
 
 AssociatorResult DetectedObjectAssociator::assign(
   const autoware_auto_msgs::msg::DetectedObjects & detections,
@@ -66,8 +96,8 @@ AssociatorResult DetectedObjectAssociator::assign(
       static_cast<assigner_idx_t>(tracks.size()));
   }
   compute_weights(detections, tracks);
-  // TODO(gowtham.ranganathan): Revisit this after #979 since till then assigner will always
-  //  return true
+  // The sparse assigner always succeeds, tracks or detections without an assignment are reported
+  // as unassigned
   (void)m_assigner.assign();
 
   return extract_result();
@@ -87,96 +117,131 @@ void DetectedObjectAssociator::compute_weights(
   const autoware_auto_msgs::msg::DetectedObjects & detections,
   const std::vector<TrackedObject> & tracks)
 {
+  if (detections.objects.empty() || tracks.empty()) {
+    return;
+  }
+  cache_tracks(tracks);
   for (size_t det_idx = 0U; det_idx < detections.objects.size(); ++det_idx) {
-    for (size_t track_idx = 0U; track_idx < tracks.size(); ++track_idx) {
-      const auto & track = tracks[track_idx];
-      const auto & detection = detections.objects[det_idx];
-
-      try {
-        if (consider_associating(detection, track)) {
-          Eigen::Matrix<float32_t, NUM_OBJ_POSE_DIM, 1> sample;
-          sample(0, 0) = static_cast<float32_t>(detection.kinematics.centroid_position.x);
-          sample(1, 0) = static_cast<float32_t>(detection.kinematics.centroid_position.y);
-
-          Eigen::Matrix<float32_t, NUM_OBJ_POSE_DIM,
-            1> mean{track.centroid().cast<float32_t>()};
-
-          Eigen::Matrix<float32_t, NUM_OBJ_POSE_DIM,
-            NUM_OBJ_POSE_DIM> cov = track.position_covariance().cast<float32_t>();
-
-          const auto dist = autoware::common::helper_functions::calculate_mahalanobis_distance(
-            sample, mean, cov);
-
-          set_weight(dist, det_idx, track_idx);
-        }
-      } catch (const std::runtime_error & e) {
-        m_had_errors = true;
-      } catch (const std::domain_error & e) {
-        m_had_errors = true;
-      }
-    }
+    compute_row(detections.objects[det_idx], det_idx, tracks);
   }
 }
 
-bool DetectedObjectAssociator::consider_associating(
-  const autoware_auto_msgs::msg::DetectedObject & detection,
-  const TrackedObject & track) const
+void DetectedObjectAssociator::cache_tracks(const std::vector<TrackedObject> & tracks)
 {
-  const auto get_shortest_edge_size_squared = [&]() -> float32_t {
-      float32_t retval = std::numeric_limits<float32_t>::max();
-      for (auto current = detection.shape.polygon.points.begin();
-        current != detection.shape.polygon.points.end(); ++current)
-      {
-        auto next = common::geometry::details::circular_next(
-          detection.shape.polygon.points.begin(), detection.shape.polygon.points.end(), current);
-        retval = std::min(retval, common::geometry::squared_distance_2d(*current, *next));
-      }
-      return retval;
-    };
-
-  const float32_t det_area = common::geometry::area_checked_2d(
-    detection.shape.polygon.points.begin(), detection.shape.polygon.points.end());
-
-  // TODO(gowtham.ranganathan): Add support for articulated objects
-  const float32_t track_area = common::geometry::area_checked_2d(
-    track.shape().polygon.points.begin(), track.shape().polygon.points.end());
-  static constexpr float32_t kAreaEps = 1e-3F;
-
-  if (common::helper_functions::comparisons::abs_eq_zero(det_area, kAreaEps) ||
-    common::helper_functions::comparisons::abs_eq_zero(track_area, kAreaEps))
-  {
-    throw std::runtime_error("Detection or track area is zero");
+  m_track_order.clear();
+  for (size_t track_idx = 0U; track_idx < tracks.size(); ++track_idx) {
+    m_track_order.push_back(track_idx);
   }
+  std::sort(
+    m_track_order.begin(), m_track_order.end(), [&tracks](const size_t lhs, const size_t rhs) {
+      return static_cast<float32_t>(tracks[lhs].centroid().x()) <
+      static_cast<float32_t>(tracks[rhs].centroid().x());
+    });
+
+  m_track_x.clear();
+  m_track_y.clear();
+  m_track_area.clear();
+  m_track_inv_xx.clear();
+  m_track_inv_xy.clear();
+  m_track_inv_yy.clear();
+  size_t num_valid = 0U;
+  for (const auto track_idx : m_track_order) {
+    const auto & track = tracks[track_idx];
+    float32_t area = 0.0F;
+    if (!checked_area(track.shape(), area)) {
+      // Such a track can't be associated with any detection
+      m_had_errors = true;
+      continue;
+    }
+    m_track_order[num_valid] = track_idx;
+    ++num_valid;
+    m_track_x.push_back(static_cast<float32_t>(track.centroid().x()));
+    m_track_y.push_back(static_cast<float32_t>(track.centroid().y()));
+    m_track_area.push_back(area);
+    // Only the lower triangle is used, as in the LDLT decomposition of the generic computation
+    const Eigen::Matrix<float32_t, NUM_OBJ_POSE_DIM, NUM_OBJ_POSE_DIM> cov =
+      track.position_covariance().cast<float32_t>();
+    const float32_t det = (cov(0, 0) * cov(1, 1)) - (cov(1, 0) * cov(1, 0));
+    const float32_t det_inv =
+      std::isnormal(det) ? (1.0F / det) : std::numeric_limits<float32_t>::quiet_NaN();
+    m_track_inv_xx.push_back(cov(1, 1) * det_inv);
+    m_track_inv_xy.push_back(-cov(1, 0) * det_inv);
+    m_track_inv_yy.push_back(cov(0, 0) * det_inv);
+  }
+  m_track_order.resize(num_valid);
+  m_row_weights.resize(num_valid);
+}
 
-  const float32_t area_ratio = det_area / track_area;
-
-  geometry_msgs::msg::Point track_centroid{};
-  track_centroid.x = track.centroid().x();
-  track_centroid.y = track.centroid().y();
-
-  const auto compute_distance_threshold = [&get_shortest_edge_size_squared, this]() -> float32_t {
-      if (m_association_cfg.consider_edge_for_big_detections()) {
-        return std::max(
-          m_association_cfg.get_max_distance_squared(),
-          get_shortest_edge_size_squared());
-      } else {
-        return m_association_cfg.get_max_distance_squared();
-      }
-    };
-
-  if (common::geometry::squared_distance_2d(
-      detection.kinematics.centroid_position,
-      track_centroid) > compute_distance_threshold())
-  {
-    return false;
+void DetectedObjectAssociator::compute_row(
+  const autoware_auto_msgs::msg::DetectedObject & detection, const size_t det_idx,
+  const std::vector<TrackedObject> & tracks)
+{
+  float32_t det_area = 0.0F;
+  if (!checked_area(detection.shape, det_area)) {
+    m_had_errors = true;
+    return;
+  }
+  const auto det_x = static_cast<float32_t>(detection.kinematics.centroid_position.x);
+  const auto det_y = static_cast<float32_t>(detection.kinematics.centroid_position.y);
+  const float32_t threshold = distance_threshold_squared(detection);
+  // Only tracks within the threshold along x can pass the distance gate, padded for rounding
+  const float32_t gate = (std::sqrt(threshold) * 1.001F) + 1.0e-3F;
+  const auto first = static_cast<size_t>(
+    std::lower_bound(m_track_x.begin(), m_track_x.end(), det_x - gate) - m_track_x.begin());
+  const auto last = static_cast<size_t>(
+    std::upper_bound(m_track_x.begin(), m_track_x.end(), det_x + gate) - m_track_x.begin());
+  const float32_t max_area_ratio = m_association_cfg.get_max_area_ratio();
+  const float32_t min_area_ratio = m_association_cfg.get_max_area_ratio_inv();
+  // Branch free, so that the compiler can vectorize it
+  for (size_t idx = first; idx < last; ++idx) {
+    const float32_t dx = det_x - m_track_x[idx];
+    const float32_t dy = det_y - m_track_y[idx];
+    const float32_t area_ratio = det_area / m_track_area[idx];
+    // C.inv() * diff, the vector whose norm calculate_mahalanobis_distance() returns
+    const float32_t ex = (m_track_inv_xx[idx] * dx) + (m_track_inv_xy[idx] * dy);
+    const float32_t ey = (m_track_inv_xy[idx] * dx) + (m_track_inv_yy[idx] * dy);
+    const bool keep = (((dx * dx) + (dy * dy)) <= threshold) &&
+      (area_ratio < max_area_ratio) && (area_ratio > min_area_ratio);
+    m_row_weights[idx] = keep ? std::sqrt((ex * ex) + (ey * ey)) : -1.0F;
   }
 
-  if (area_ratio < m_association_cfg.get_max_area_ratio()) {
-    if (area_ratio > m_association_cfg.get_max_area_ratio_inv()) {
-      return true;
+  for (size_t idx = first; idx < last; ++idx) {
+    float32_t weight = m_row_weights[idx];
+    if (weight < 0.0F) {
+      continue;
+    }
+    const auto & track = tracks[m_track_order[idx]];
+    if (std::isnan(weight)) {
+      // The covariance has no closed form inverse, fall back to the generic computation
+      Eigen::Matrix<float32_t, NUM_OBJ_POSE_DIM, 1> sample;
+      sample(0, 0) = det_x;
+      sample(1, 0) = det_y;
+      const Eigen::Matrix<float32_t, NUM_OBJ_POSE_DIM, 1> mean{track.centroid().cast<float32_t>()};
+      const Eigen::Matrix<float32_t, NUM_OBJ_POSE_DIM, NUM_OBJ_POSE_DIM> cov =
+        track.position_covariance().cast<float32_t>();
+      weight = autoware::common::helper_functions::calculate_mahalanobis_distance(
+        sample, mean, cov);
     }
+    set_weight(weight, det_idx, m_track_order[idx]);
+  }
+}
+
+float32_t DetectedObjectAssociator::distance_threshold_squared(
+  const autoware_auto_msgs::msg::DetectedObject & detection) const
+{
+  if (!m_association_cfg.consider_edge_for_big_detections()) {
+    return m_association_cfg.get_max_distance_squared();
+  }
+  float32_t shortest_edge_squared = std::numeric_limits<float32_t>::max();
+  for (auto current = detection.shape.polygon.points.begin();
+    current != detection.shape.polygon.points.end(); ++current)
+  {
+    auto next = common::geometry::details::circular_next(
+      detection.shape.polygon.points.begin(), detection.shape.polygon.points.end(), current);
+    shortest_edge_squared =
+      std::min(shortest_edge_squared, common::geometry::squared_distance_2d(*current, *next));
   }
-  return false;
+  return std::max(m_association_cfg.get_max_distance_squared(), shortest_edge_squared);
 }
 
 void DetectedObjectAssociator::set_weight(
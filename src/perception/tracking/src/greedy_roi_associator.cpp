@@ -81,9 +81,12 @@ AssociatorResult GreedyRoiAssociator::assign(
 {
   AssociatorResult result = create_and_init_result(rois.rois.size(), tracks.size());
   const details::ShapeTransformer transformer{tf_camera_from_track};
+  const details::RoiExtentIndex roi_index{rois};
+  std::vector<std::size_t> candidates;
   for (auto track_idx = 0U; track_idx < tracks.size(); ++track_idx) {
     const auto matched_detection_idx = project_and_match_detection(
-      transformer(tracks[track_idx].shape()), result.unassigned_detection_indices, rois);
+      transformer(tracks[track_idx].shape()), result.unassigned_detection_indices, rois,
+      roi_index, candidates);
 
     handle_matching_output(matched_detection_idx, track_idx, result);
   }
@@ -99,10 +102,13 @@ AssociatorResult GreedyRoiAssociator::assign(
 {
   AssociatorResult result = create_and_init_result(rois.rois.size(), objects.objects.size());
   const details::ShapeTransformer transformer{tf_camera_from_object};
+  const details::RoiExtentIndex roi_index{rois};
+  std::vector<std::size_t> candidates;
 
   for (auto object_idx = 0U; object_idx < objects.objects.size(); ++object_idx) {
     auto detection_idx = project_and_match_detection(
-      transformer(objects.objects[object_idx].shape), result.unassigned_detection_indices, rois);
+      transformer(objects.objects[object_idx].shape), result.unassigned_detection_indices, rois,
+      roi_index, candidates);
 
     handle_matching_output(detection_idx, object_idx, result);
   }
@@ -113,7 +119,9 @@ AssociatorResult GreedyRoiAssociator::assign(
 std::size_t GreedyRoiAssociator::project_and_match_detection(
   const std::vector<geometry_msgs::msg::Point32> & object_shape_in_camera_frame,
   const std::unordered_set<std::size_t> & available_roi_indices,
-  const autoware_auto_msgs::msg::ClassifiedRoiArray & rois) const
+  const autoware_auto_msgs::msg::ClassifiedRoiArray & rois,
+  const details::RoiExtentIndex & roi_index,
+  std::vector<std::size_t> & candidates) const
 {
   const auto & maybe_projection = m_camera.project(object_shape_in_camera_frame);
 
@@ -122,18 +130,86 @@ std::size_t GreedyRoiAssociator::project_and_match_detection(
     return AssociatorResult::UNASSIGNED;
   }
 
+  roi_index.query(maybe_projection.value(), candidates);
   auto max_score = 0.0F;
   std::size_t max_score_idx = AssociatorResult::UNASSIGNED;
-  for (const auto idx : available_roi_indices) {
+  for (const auto idx : candidates) {
+    if (available_roi_indices.count(idx) == 0U) {
+      continue;
+    }
     const auto score = m_iou_func(maybe_projection.value().shape, rois.rois[idx].polygon.points);
-    max_score = std::max(score, max_score);
-    max_score_idx = idx;
+    // Candidates are in ascending order, so ties go to the ROI with the lower index
+    if (score > max_score) {
+      max_score = score;
+      max_score_idx = idx;
+    }
   }
   return max_score > m_iou_threshold ? max_score_idx : AssociatorResult::UNASSIGNED;
 }
 
 namespace details
 {
+RoiExtentIndex::RoiExtentIndex(const autoware_auto_msgs::msg::ClassifiedRoiArray & rois)
+{
+  m_extents.reserve(rois.rois.size());
+  for (std::size_t idx = 0U; idx < rois.rois.size(); ++idx) {
+    const auto & points = rois.rois[idx].polygon.points;
+    if (points.empty()) {
+      continue;
+    }
+    Extent extent{points.front().x, points.front().x, points.front().y, points.front().y, idx};
+    for (const auto & pt : points) {
+      extent.min_x = std::min(extent.min_x, pt.x);
+      extent.max_x = std::max(extent.max_x, pt.x);
+      extent.min_y = std::min(extent.min_y, pt.y);
+      extent.max_y = std::max(extent.max_y, pt.y);
+    }
+    m_max_width = std::max(m_max_width, extent.max_x - extent.min_x);
+    m_extents.push_back(extent);
+  }
+  std::sort(
+    m_extents.begin(), m_extents.end(), [](const Extent & lhs, const Extent & rhs) {
+      return lhs.min_x < rhs.min_x;
+    });
+}
+
+void RoiExtentIndex::query(
+  const Projection & projection,
+  std::vector<std::size_t> & candidates) const
+{
+  candidates.clear();
+  if (projection.shape.empty()) {
+    return;
+  }
+  auto min_x = projection.shape.front().x;
+  auto max_x = min_x;
+  auto min_y = projection.shape.front().y;
+  auto max_y = min_y;
+  for (const auto & pt : projection.shape) {
+    min_x = std::min(min_x, pt.x);
+    max_x = std::max(max_x, pt.x);
+    min_y = std::min(min_y, pt.y);
+    max_y = std::max(max_y, pt.y);
+  }
+  // Extents starting right of the projection can't overlap it, and neither can extents starting
+  // more than the widest extent left of it
+  auto it = std::upper_bound(
+    m_extents.begin(), m_extents.end(), max_x, [](const float32_t value, const Extent & extent) {
+      return value < extent.min_x;
+    });
+  const auto leftmost_start = min_x - m_max_width;
+  while (it != m_extents.begin()) {
+    --it;
+    if (it->min_x < leftmost_start) {
+      break;
+    }
+    if ((it->max_x >= min_x) && (it->min_y <= max_y) && (it->max_y >= min_y)) {
+      candidates.push_back(it->roi_idx);
+    }
+  }
+  std::sort(candidates.begin(), candidates.end());
+}
+
 ShapeTransformer::ShapeTransformer(const geometry_msgs::msg::Transform & tf)
 : m_transformer{tf}
 {
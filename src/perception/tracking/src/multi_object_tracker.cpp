@@ -17,11 +17,14 @@
 #include "tracking/multi_object_tracker.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <memory>
+#include <vector>
 
 #include "autoware_auto_tf2/tf2_autoware_auto_msgs.hpp"
 #include "geometry_msgs/msg/quaternion.hpp"
+#include "measurement_conversion/measurement_transformation.hpp"
 #include "tf2_eigen/tf2_eigen.h"
 #include "time_utils/time_utils.hpp"
 
@@ -75,9 +78,15 @@ geometry_msgs::msg::TransformStamped to_transform(const nav_msgs::msg::Odometry
 
 
 MultiObjectTracker::MultiObjectTracker(MultiObjectTrackerOptions options)
-: m_options(options), m_object_associator(options.object_association_config),
+: m_tracks{options.track_capacity},
+  m_options(options),
+  m_predictor(std::make_unique<ParallelTrackPredictor>(options.num_prediction_threads)),
+  m_object_associator(options.object_association_config),
   m_vision_associator{options.vision_association_config},
-  m_track_creator(options.track_creator_config) {}
+  m_track_creator(options.track_creator_config)
+{
+  m_extrapolated_tracks.reserve(options.track_capacity);
+}
 
 TrackerUpdateResult MultiObjectTracker::update(
   DetectedObjectsMsg detections,
@@ -89,10 +98,20 @@ TrackerUpdateResult MultiObjectTracker::update(
     return result;
   }
 
+  // Measure each stage from the end of the previous one
+  using Clock = std::chrono::steady_clock;
+  auto stage_start = Clock::now();
+  const auto end_stage = [&stage_start](std::chrono::nanoseconds & duration) {
+      const auto now = Clock::now();
+      duration = now - stage_start;
+      stage_start = now;
+    };
+
   // ==================================
   // Transform detections
   // ==================================
   this->transform(detections, detection_frame_odometry);
+  end_stage(result.timings.transform);
 
   // ==================================
   // Predict tracks forward
@@ -100,62 +119,60 @@ TrackerUpdateResult MultiObjectTracker::update(
   // TODO(nikolai.morin): Simplify after #1002
   const auto target_time = time_utils::from_message(detections.header.stamp);
   const auto dt = target_time - m_last_update;
-  for (auto & object : m_objects) {
-    object.predict(dt);
-  }
+  m_predictor->predict(m_tracks.tracks(), dt);
+  end_stage(result.timings.predict);
 
   // ==================================
   // Associate observations with tracks
   // ==================================
   AssociatorResult association;
-  association = m_object_associator.assign(detections, this->m_objects);
+  association = m_object_associator.assign(detections, m_tracks.tracks());
   if (association.had_errors) {
     result.status = TrackerUpdateStatus::InvalidShape;
   }
+  end_stage(result.timings.associate);
 
   // ==================================
   // Update tracks with observations
   // ==================================
-  for (size_t track_idx = 0; track_idx < m_objects.size(); ++track_idx) {
+  auto & tracks = m_tracks.tracks();
+  for (size_t track_idx = 0; track_idx < tracks.size(); ++track_idx) {
     size_t detection_idx = association.track_assignments[track_idx];
     if (detection_idx == AssociatorResult::UNASSIGNED) {
       continue;
     }
     const auto & detection = detections.objects[detection_idx];
-    m_objects[track_idx].update(detection);
+    tracks[track_idx].update(detection, m_measurements[detection_idx]);
   }
   for (const size_t track_idx : association.unassigned_track_indices) {
-    m_objects[track_idx].no_update();
+    tracks[track_idx].no_update();
   }
+  end_stage(result.timings.update);
 
   // ==================================
   // Initialize new tracks
   // ==================================
   m_track_creator.add_objects(detections, association);
-  {
-    auto && ret = m_track_creator.create_tracks();
-    m_objects.insert(
-      m_objects.end(),
-      std::make_move_iterator(ret.tracks.begin()),
-      std::make_move_iterator(ret.tracks.end()));
-  }
+  m_track_creator.create_tracks(m_tracks);
+  end_stage(result.timings.create);
 
   // ==================================
   // Prune tracks
   // ==================================
-  const auto last = std::remove_if(
-    m_objects.begin(), m_objects.end(), [this](const auto & object) {
+  m_tracks.remove_if(
+    [this](const TrackedObject & object) {
       return object.should_be_removed(
         this->m_options.pruning_time_threshold,
         this->m_options.pruning_ticks_threshold);
     });
-  m_objects.erase(last, m_objects.end());
+  end_stage(result.timings.prune);
 
   // ==================================
   // Build result
   // ==================================
-  result.objects =
-    std::make_unique<TrackedObjectsMsg>(this->convert_to_msg(detections.header.stamp));
+  result.objects = std::make_unique<TrackedObjectsMsg>(
+    this->convert_to_msg(m_tracks.tracks(), detections.header.stamp));
+  end_stage(result.timings.output);
   result.status = TrackerUpdateStatus::Ok;
   m_last_update = target_time;
 
@@ -166,17 +183,40 @@ void MultiObjectTracker::update(
   const ClassifiedRoiArrayMsg & rois,
   const geometry_msgs::msg::Transform & tf_camera_from_track)
 {
-  const auto association = m_vision_associator.assign(rois, m_objects, tf_camera_from_track);
+  auto & tracks = m_tracks.tracks();
+  const auto association = m_vision_associator.assign(rois, tracks, tf_camera_from_track);
 
-  for (size_t i = 0U; i < m_objects.size(); ++i) {
+  for (size_t i = 0U; i < tracks.size(); ++i) {
     const auto & maybe_roi_idx = association.track_assignments[i];
     if (maybe_roi_idx != AssociatorResult::UNASSIGNED) {
-      m_objects[i].update(rois.rois[maybe_roi_idx].classifications);
+      tracks[i].update(rois.rois[maybe_roi_idx].classifications);
     }
   }
   m_track_creator.add_objects(rois, association);
 }
 
+TrackerUpdateResult MultiObjectTracker::extrapolate(const builtin_interfaces::msg::Time & stamp)
+{
+  TrackerUpdateResult result;
+  const auto target_time = time_utils::from_message(stamp);
+  if (target_time < m_last_update) {
+    result.status = TrackerUpdateStatus::WentBackInTime;
+    return result;
+  }
+  using Clock = std::chrono::steady_clock;
+  const auto predict_start = Clock::now();
+  // Assigning to the elements of the previous copies reuses the buffers of their messages
+  m_extrapolated_tracks = m_tracks.tracks();
+  m_predictor->predict(m_extrapolated_tracks, target_time - m_last_update);
+  const auto output_start = Clock::now();
+  result.timings.predict = output_start - predict_start;
+  result.objects =
+    std::make_unique<TrackedObjectsMsg>(this->convert_to_msg(m_extrapolated_tracks, stamp));
+  result.timings.output = Clock::now() - output_start;
+  result.status = TrackerUpdateStatus::Ok;
+  return result;
+}
+
 TrackerUpdateStatus MultiObjectTracker::validate(
   const DetectedObjectsMsg & detections,
   const nav_msgs::msg::Odometry & detection_frame_odometry)
@@ -212,28 +252,29 @@ void MultiObjectTracker::transform(
   // Convert the odometry to TransformStamped for use with tf2::doTransform.
   const geometry_msgs::msg::TransformStamped tf_msg__tracking__detection = to_transform(
     detection_frame_odometry);
-  // Hoisted outside the loop
-  Eigen::Vector3d centroid_detection = Eigen::Vector3d::Zero();
-  Eigen::Vector3d centroid_tracking = Eigen::Vector3d::Zero();
+  // Convert the positions of all detections into measurements in the tracking frame at once.
+  // For the covariance, doing this properly is difficult. We'll ignore the rotational part. This
+  // is a practical solution since only the yaw covariance is relevant, and the yaw covariance is
+  // unaffected by the transformation, which preserves the z axis.
+  // An even more accurate implementation could additionally include the odometry covariance.
+  common::state_estimation::detections_to_transformed_measurements(
+    detections, tf__tracking__detection, m_measurements);
 
   detections.header.frame_id = m_options.frame;
-  for (auto & detection : detections.objects) {
+  for (std::size_t i = 0U; i < detections.objects.size(); ++i) {
+    auto & detection = detections.objects[i];
     // Transform the shape. If needed, this can potentially be made more efficient by not using
     // tf2::doTransform, which converts the TransformStamped message to a different representation
     // in each call.
     tf2::doTransform(detection.shape.polygon, detection.shape.polygon, tf_msg__tracking__detection);
-    // Transform the pose.
-    tf2::fromMsg(detection.kinematics.centroid_position, centroid_detection);
-    centroid_tracking = tf__tracking__detection * centroid_detection;
-    detection.kinematics.centroid_position = tf2::toMsg(centroid_tracking);
+    // The association and the track creation use the message, so it's kept consistent with the
+    // measurements.
+    const auto & measurement = m_measurements[i];
+    detection.kinematics.centroid_position = tf2::toMsg(measurement.state().vector());
     if (detection.kinematics.has_position_covariance) {
-      // Doing this properly is difficult. We'll ignore the rotational part. This is a practical
-      // solution since only the yaw covariance is relevant, and the yaw covariance is
-      // unaffected by the transformation, which preserves the z axis.
-      // An even more accurate implementation could additionally include the odometry covariance.
       Eigen::Map<Eigen::Matrix<double, 3, 3, Eigen::RowMajor>> cov(
         detection.kinematics.position_covariance.data());
-      cov = rot_d * cov * rot_d.transpose();
+      cov = measurement.covariance();
     }
     // Transform the twist.
     if (detection.kinematics.has_twist) {
@@ -252,15 +293,17 @@ void MultiObjectTracker::transform(
 }
 
 MultiObjectTracker::TrackedObjectsMsg MultiObjectTracker::convert_to_msg(
+  std::vector<TrackedObject> & tracks,
   const builtin_interfaces::msg::Time & stamp) const
 {
   TrackedObjectsMsg array;
   array.header.stamp = stamp;
   array.header.frame_id = m_options.frame;
-  array.objects.reserve(m_objects.size());
+  array.objects.reserve(tracks.size());
+  // msg() fills the message in place, so the tracks are taken by reference to avoid copying them
   std::transform(
-    m_objects.begin(), m_objects.end(), std::back_inserter(array.objects), [](
-      TrackedObject o) {return o.msg();});
+    tracks.begin(), tracks.end(), std::back_inserter(array.objects), [](
+      TrackedObject & o) {return o.msg();});
   return array;
 }
 
@@ -0,0 +1,150 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#include "tracking/parallel_track_predictor.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace autoware
+{
+namespace perception
+{
+namespace tracking
+{
+
+using common::types::bool8_t;
+
+constexpr std::size_t ParallelTrackPredictor::MIN_TRACKS_PER_THREAD;
+
+ParallelTrackPredictor::ParallelTrackPredictor(const std::size_t num_threads)
+: m_num_threads{num_threads},
+  m_tracks{nullptr},
+  m_dt{std::chrono::nanoseconds::zero()},
+  m_num_workers{1U},
+  m_generation{0U},
+  m_num_busy{0U},
+  m_stop{false}
+{
+  if (num_threads == 0U) {
+    throw std::domain_error("ParallelTrackPredictor: Number of threads must be positive");
+  }
+  m_workers.resize(num_threads);
+  // The calling thread is worker 0
+  m_threads.reserve(num_threads - 1U);
+  for (std::size_t idx = 1U; idx < num_threads; ++idx) {
+    m_threads.emplace_back(&ParallelTrackPredictor::thread_loop, this, idx);
+  }
+}
+
+ParallelTrackPredictor::~ParallelTrackPredictor()
+{
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_stop = true;
+  }
+  m_start_cv.notify_all();
+  for (auto & thread : m_threads) {
+    thread.join();
+  }
+}
+
+void ParallelTrackPredictor::predict(
+  std::vector<TrackedObject> & tracks,
+  const std::chrono::nanoseconds dt)
+{
+  m_num_workers = std::min(m_num_threads, tracks.size() / MIN_TRACKS_PER_THREAD);
+  if (m_num_workers <= 1U) {
+    for (auto & track : tracks) {
+      track.predict(dt);
+    }
+    return;
+  }
+  m_tracks = &tracks;
+  m_dt = dt;
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_num_busy = m_threads.size();
+    ++m_generation;
+  }
+  m_start_cv.notify_all();
+  work(0U);
+  {
+    std::unique_lock<std::mutex> lock{m_mutex};
+    m_done_cv.wait(lock, [this] {return m_num_busy == 0U;});
+  }
+  m_tracks = nullptr;
+  if (std::any_of(
+      m_workers.begin(), m_workers.end(), [](const Worker & worker) {return worker.failed;}))
+  {
+    throw std::runtime_error("ParallelTrackPredictor: Failed to predict a track");
+  }
+}
+
+std::size_t ParallelTrackPredictor::get_num_threads() const
+{
+  return m_num_threads;
+}
+
+void ParallelTrackPredictor::work(const std::size_t worker_idx)
+{
+  Worker & worker = m_workers[worker_idx];
+  worker.failed = false;
+  if (worker_idx >= m_num_workers) {
+    return;
+  }
+  // Contiguous range of tracks, so that the threads don't share cache lines except at the ends
+  auto & tracks = *m_tracks;
+  const std::size_t begin = (tracks.size() * worker_idx) / m_num_workers;
+  const std::size_t end = (tracks.size() * (worker_idx + 1U)) / m_num_workers;
+  try {
+    for (std::size_t idx = begin; idx < end; ++idx) {
+      tracks[idx].predict(m_dt);
+    }
+  } catch (const std::exception &) {
+    worker.failed = true;
+  }
+}
+
+void ParallelTrackPredictor::thread_loop(const std::size_t worker_idx)
+{
+  std::size_t generation = 0U;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock{m_mutex};
+      m_start_cv.wait(lock, [this, generation] {return m_stop || (m_generation != generation);});
+      if (m_stop) {
+        return;
+      }
+      generation = m_generation;
+    }
+    work(worker_idx);
+    bool8_t is_last = false;
+    {
+      std::lock_guard<std::mutex> lock{m_mutex};
+      --m_num_busy;
+      is_last = (m_num_busy == 0U);
+    }
+    if (is_last) {
+      m_done_cv.notify_one();
+    }
+  }
+}
+
+}  // namespace tracking
+}  // namespace perception
+}  // namespace autoware
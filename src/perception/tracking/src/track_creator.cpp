@@ -17,9 +17,9 @@
 #include <time_utils/time_utils.hpp>
 #include <tracking/track_creator.hpp>
 
-#include <functional>
+#include <cstddef>
 #include <memory>
-#include <set>
+#include <utility>
 #include <vector>
 
 namespace autoware
@@ -63,14 +63,12 @@ void LidarOnlyPolicy::add_objects(
   m_lidar_clusters = populate_unassigned_lidar_detections(clusters, associator_result);
 }
 
-TracksAndLeftovers LidarOnlyPolicy::create()
+autoware_auto_msgs::msg::DetectedObjects LidarOnlyPolicy::create(TrackStore & tracks)
 {
-  TracksAndLeftovers retval;
   for (const auto & cluster : m_lidar_clusters.objects) {
-    retval.tracks.emplace_back(
-      TrackedObject(cluster, m_default_variance, m_noise_variance));
+    tracks.emplace(cluster, m_default_variance, m_noise_variance);
   }
-  return retval;
+  return autoware_auto_msgs::msg::DetectedObjects{};
 }
 
 void LidarClusterIfVisionPolicy::add_objects(
@@ -96,10 +94,8 @@ LidarClusterIfVisionPolicy::LidarClusterIfVisionPolicy(
   m_vision_rois_cache_ptr->setCacheSize(kVisionCacheSize);
 }
 
-TracksAndLeftovers LidarClusterIfVisionPolicy::create()
+autoware_auto_msgs::msg::DetectedObjects LidarClusterIfVisionPolicy::create(TrackStore & tracks)
 {
-  TracksAndLeftovers retval;
-  retval.detections_leftover = m_lidar_clusters;
   // For foxy time has to be initialized explicitly with sec, nanosec constructor to use the
   // correct clock source when querying message_filters::cache.
   // Refer: https://github.com/ros2/message_filters/issues/32
@@ -110,37 +106,34 @@ TracksAndLeftovers LidarClusterIfVisionPolicy::create()
   const auto vision_msg_matches = m_vision_rois_cache_ptr->getInterval(before, after);
 
   if (vision_msg_matches.empty()) {
-    return retval;
+    return m_lidar_clusters;
   }
 
   const auto & vision_msg = *vision_msg_matches.back();
 
   const auto result = m_associator.assign(
     vision_msg, m_lidar_clusters, m_cfg.tf_camera_from_base_link);
-  std::set<size_t, std::greater<>> lidar_idx_to_erase;
 
-  for (size_t cluster_idx = 0U; cluster_idx < m_lidar_clusters.objects.size();
-    cluster_idx++)
-  {
-    if (result.track_assignments[cluster_idx] != AssociatorResult::UNASSIGNED) {
-      lidar_idx_to_erase.insert(cluster_idx);
+  // Move the clusters that are not associated to a vision roi to the front in a single pass,
+  // erasing the associated ones one by one is quadratic in the number of clusters
+  auto & clusters = m_lidar_clusters.objects;
+  std::size_t num_leftover = 0U;
+  for (std::size_t cluster_idx = 0U; cluster_idx < clusters.size(); ++cluster_idx) {
+    const auto roi_idx = result.track_assignments[cluster_idx];
+    if (roi_idx == AssociatorResult::UNASSIGNED) {
+      if (num_leftover != cluster_idx) {
+        clusters[num_leftover] = std::move(clusters[cluster_idx]);
+      }
+      ++num_leftover;
+    } else {
       // TrackedObject constructor uses the classification field in the DetectedObject to
       // initialize track class. So assign the class from the associated ROI to the cluster.
-      m_lidar_clusters.objects[cluster_idx].classification = vision_msg.rois[result
-          .track_assignments[cluster_idx]].classifications;
-      retval.tracks.emplace_back(
-        TrackedObject(
-          m_lidar_clusters.objects[cluster_idx],
-          m_default_variance, m_noise_variance));
+      clusters[cluster_idx].classification = vision_msg.rois[roi_idx].classifications;
+      tracks.emplace(clusters[cluster_idx], m_default_variance, m_noise_variance);
     }
   }
-
-  // Erase lidar clusters that are associated to a vision roi
-  for (const auto idx : lidar_idx_to_erase) {
-    m_lidar_clusters.objects.erase(m_lidar_clusters.objects.begin() + static_cast<int32_t>(idx));
-  }
-  retval.detections_leftover = m_lidar_clusters;
-  return retval;
+  clusters.erase(clusters.begin() + static_cast<std::ptrdiff_t>(num_leftover), clusters.end());
+  return m_lidar_clusters;
 }
 
 TrackCreator::TrackCreator(const TrackCreatorConfig & config)
@@ -167,6 +160,15 @@ TrackCreator::TrackCreator(const TrackCreatorConfig & config)
   }
 }
 
+TracksAndLeftovers TrackCreator::create_tracks()
+{
+  TrackStore store{0U};
+  TracksAndLeftovers retval;
+  retval.detections_leftover = create_tracks(store);
+  retval.tracks = std::move(store.tracks());
+  return retval;
+}
+
 }  // namespace tracking
 }  // namespace perception
 }  // namespace autoware
@@ -0,0 +1,54 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#include "tracking/track_store.hpp"
+
+#include <utility>
+
+namespace autoware
+{
+namespace perception
+{
+namespace tracking
+{
+
+using common::types::float64_t;
+
+TrackStore::TrackStore(const std::size_t capacity)
+: m_capacity{capacity}
+{
+  m_tracks.reserve(capacity);
+  m_free.reserve(capacity);
+}
+
+TrackedObject & TrackStore::emplace(
+  const DetectedObjectMsg & detection, const float64_t default_variance,
+  const float64_t noise_variance)
+{
+  if (m_free.empty()) {
+    m_tracks.emplace_back(detection, default_variance, noise_variance);
+  } else {
+    // Reinitialize before moving, so that a throw leaves the store unchanged
+    m_free.back().reset(detection, default_variance, noise_variance);
+    m_tracks.push_back(std::move(m_free.back()));
+    m_free.pop_back();
+  }
+  return m_tracks.back();
+}
+
+}  // namespace tracking
+}  // namespace perception
+}  // namespace autoware
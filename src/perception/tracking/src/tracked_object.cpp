@@ -23,6 +23,7 @@
 
 #include <algorithm>
 #include <stdexcept>
+#include <utility>
 
 namespace autoware
 {
@@ -114,12 +115,37 @@ TrackedObject::TrackedObject(
 : m_msg{},
   m_ekf{init_ekf(detection, default_variance, noise_variance)},
   m_default_variance{default_variance}
+{
+  initialize_from(detection);
+}
+
+void TrackedObject::reset(
+  const DetectedObjectMsg & detection, float64_t default_variance,
+  float64_t noise_variance)
+{
+  // Move the vectors out and back in to keep their buffers
+  auto classification = std::move(m_msg.classification);
+  auto shape = std::move(m_msg.shape);
+  m_msg = TrackedObjectMsg{};
+  m_msg.classification = std::move(classification);
+  m_msg.shape = std::move(shape);
+  m_ekf = init_ekf(detection, default_variance, noise_variance);
+  m_time_since_last_seen = std::chrono::nanoseconds::zero();
+  m_ticks_since_last_seen = 0;
+  m_ticks_alive = 1;
+  m_default_variance = default_variance;
+  m_classifier = ClassificationTracker{};
+  initialize_from(detection);
+}
+
+void TrackedObject::initialize_from(const DetectedObjectMsg & detection)
 {
   static uint64_t object_id = 0;
   m_msg.object_id = ++object_id;
   m_msg.existence_probability = detection.existence_probability;
   m_msg.classification = detection.classification;
-  m_msg.shape.push_back(detection.shape);
+  m_msg.shape.resize(1U);
+  m_msg.shape[0] = detection.shape;
   // Kinematics are owned by the EKF and only filled in in the msg() getter
   m_classifier.update(detection.classification);
 }
@@ -132,12 +158,6 @@ void TrackedObject::predict(std::chrono::nanoseconds dt)
 
 void TrackedObject::update(const DetectedObjectMsg & detection)
 {
-  m_time_since_last_seen = std::chrono::nanoseconds::zero();
-  m_ticks_alive++;
-  m_ticks_since_last_seen = 0;
-  // Update the shape
-  m_msg.shape = {detection.shape};
-
   // It needs to be determined which parts of the DetectedObject message are set, and can be used
   // to update the state. Also, even if a variable is set, its covariance might not be set.
   autoware_auto_msgs::msg::RelativePositionWithCovarianceStamped position;
@@ -145,8 +165,20 @@ void TrackedObject::update(const DetectedObjectMsg & detection)
   position.position.y = detection.kinematics.centroid_position.y;
   position.position.z = detection.kinematics.centroid_position.z;
   position.covariance = detection.kinematics.position_covariance;
-  auto pose_measurement =
-    convert_to<Stamped<PoseMeasurementXYZ64>>::from(position).measurement;
+  update(detection, convert_to<Stamped<PoseMeasurementXYZ64>>::from(position).measurement);
+}
+
+void TrackedObject::update(
+  const DetectedObjectMsg & detection,
+  const PositionMeasurement & measurement)
+{
+  m_time_since_last_seen = std::chrono::nanoseconds::zero();
+  m_ticks_alive++;
+  m_ticks_since_last_seen = 0;
+  // Update the shape, assigning the element reuses the buffer of its polygon
+  m_msg.shape[0] = detection.shape;
+
+  auto pose_measurement = measurement;
   if (!detection.kinematics.has_position_covariance) {
     pose_measurement.covariance() = m_default_variance *
       PoseMeasurementXYZ64::State::Matrix::Identity();
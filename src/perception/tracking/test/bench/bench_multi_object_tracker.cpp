@@ -0,0 +1,146 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#include <benchmark/benchmark.h>
+#include <nav_msgs/msg/odometry.hpp>
+#include <tracking/multi_object_tracker.hpp>
+#include <tracking_test_framework/scenario.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace
+{
+using autoware::common::types::float64_t;
+using autoware::perception::tracking::MultiObjectTracker;
+using autoware::perception::tracking::MultiObjectTrackerOptions;
+using autoware::perception::tracking::TrackCreationPolicy;
+using autoware::perception::tracking::TrackerUpdateStatus;
+using autoware::perception::tracking::TrackerUpdateTimings;
+using autoware::tracking_test_framework::Scenario;
+using autoware::tracking_test_framework::ScenarioConfig;
+using DetectedObjects = autoware_auto_msgs::msg::DetectedObjects;
+
+constexpr std::chrono::milliseconds kFramePeriod{100};
+constexpr std::size_t kNumFrames = 50U;
+
+MultiObjectTrackerOptions make_options()
+{
+  MultiObjectTrackerOptions options{{4.0F, 2.5F, true}, {},
+    {TrackCreationPolicy::LidarClusterOnly, 1.0F, 1.0F}};
+  // Tracks of clutter and of occluded objects go away soon, so that the number of tracks stays
+  // below the capacity of the association
+  options.pruning_ticks_threshold = 3U;
+  return options;
+}
+
+/// The detections of all frames, generated up front since the ray casting is slower than the
+/// tracking
+std::vector<DetectedObjects> make_frames(
+  const std::size_t num_objects, const std::size_t num_clutter)
+{
+  ScenarioConfig config{};
+  config.num_cars = num_objects / 2U;
+  config.num_pedestrians = num_objects - config.num_cars;
+  config.num_clutter = num_clutter;
+  config.miss_probability = 0.05F;
+  Scenario scenario{config};
+  std::vector<DetectedObjects> frames;
+  for (std::size_t frame_idx = 0U; frame_idx < kNumFrames; ++frame_idx) {
+    frames.push_back(scenario.next_frame(kFramePeriod));
+  }
+  return frames;
+}
+
+void add(TrackerUpdateTimings & sum, const TrackerUpdateTimings & timings)
+{
+  sum.transform += timings.transform;
+  sum.predict += timings.predict;
+  sum.associate += timings.associate;
+  sum.update += timings.update;
+  sum.create += timings.create;
+  sum.prune += timings.prune;
+  sum.output += timings.output;
+}
+
+/// Replay a generated scenario into a new tracker, one iteration is one update. The counters
+/// split the average time of an update into its stages
+void BenchMultiObjectTrackerUpdate(benchmark::State & state)
+{
+  const auto frames = make_frames(
+    static_cast<std::size_t>(state.range(0)), static_cast<std::size_t>(state.range(1)));
+  nav_msgs::msg::Odometry odometry{};
+  odometry.header.frame_id = "map";
+  odometry.child_frame_id = frames.front().header.frame_id;
+  odometry.pose.pose.orientation.w = 1.0;
+
+  auto tracker = std::make_unique<MultiObjectTracker>(make_options());
+  std::size_t frame_idx = 0U;
+  TrackerUpdateTimings sum{};
+  std::size_t num_detections = 0U;
+  std::size_t num_tracks = 0U;
+  for (auto _ : state) {
+    if (frame_idx == frames.size()) {
+      // Start over, the tracker can't go back in time
+      state.PauseTiming();
+      tracker = std::make_unique<MultiObjectTracker>(make_options());
+      frame_idx = 0U;
+      state.ResumeTiming();
+    }
+    const auto & detections = frames[frame_idx];
+    odometry.header.stamp = detections.header.stamp;
+    auto result = tracker->update(detections, odometry);
+    if (result.status != TrackerUpdateStatus::Ok) {
+      state.SkipWithError("The tracker update failed");
+      break;
+    }
+    add(sum, result.timings);
+    num_detections += detections.objects.size();
+    num_tracks += result.objects->objects.size();
+    benchmark::DoNotOptimize(result);
+    ++frame_idx;
+  }
+  const auto per_update = [&state](const std::chrono::nanoseconds duration) {
+      return benchmark::Counter(
+        std::chrono::duration<float64_t, std::micro>{duration}.count(),
+        benchmark::Counter::kAvgIterations);
+    };
+  state.counters["transform_us"] = per_update(sum.transform);
+  state.counters["predict_us"] = per_update(sum.predict);
+  state.counters["associate_us"] = per_update(sum.associate);
+  state.counters["update_us"] = per_update(sum.update);
+  state.counters["create_us"] = per_update(sum.create);
+  state.counters["prune_us"] = per_update(sum.prune);
+  state.counters["output_us"] = per_update(sum.output);
+  state.counters["detections"] = benchmark::Counter(
+    static_cast<float64_t>(num_detections), benchmark::Counter::kAvgIterations);
+  state.counters["tracks"] = benchmark::Counter(
+    static_cast<float64_t>(num_tracks), benchmark::Counter::kAvgIterations);
+}
+
+void TrackerArgs(benchmark::internal::Benchmark * bench)
+{
+  bench->ArgNames({"objects", "clutter"});
+  for (const int64_t num_objects : {16, 32, 64, 128}) {
+    bench->Args({num_objects, 0});
+    bench->Args({num_objects, 16});
+  }
+}
+}  // namespace
+
+BENCHMARK(BenchMultiObjectTrackerUpdate)->Apply(TrackerArgs)->Unit(benchmark::kMicrosecond);
@@ -143,3 +143,19 @@ TEST(ClassificaitonTrackerTest, OverconfidentObject) {
   ClassificationTracker tracker;
   EXPECT_THROW(tracker.update(overconfident_object.classification), std::domain_error);
 }
+
+TEST(ClassificaitonTrackerTest, SparseUpdatesKeepProbabilities) {
+  const DetectedObject car = create_object(
+    {{autoware_auto_msgs::msg::ObjectClassification::CAR, 1.0F}});
+  const DetectedObject maybe_truck = create_object(
+    {{autoware_auto_msgs::msg::ObjectClassification::TRUCK, 0.6F}});
+  ClassificationTracker tracker;
+  auto variance = tracker.variance();
+  for (const auto & object : {car, maybe_truck, car, car, maybe_truck}) {
+    tracker.update(object.classification, 1.0F);
+    // The probabilities still sum up to 1 and the track only gets more certain.
+    EXPECT_NEAR(tracker.state().vector().sum(), 1.0F, 1e-5F);
+    EXPECT_LE(tracker.variance(), variance);
+    variance = tracker.variance();
+  }
+}
@@ -230,3 +230,48 @@ TEST_F(AssociationTester, area_gating_fails)
     }
   }
 }
+
+// Tracks out of order along x, each with a detection just inside the distance gate, and a
+// detection just outside of it. Tracks are sorted by x internally, so this makes sure that the
+// results still refer to the input order.
+TEST_F(AssociationTester, distance_gating_unsorted_tracks)
+{
+  const auto num_tracks = 6U;
+
+  std::vector<tracking::TrackedObject> tracked_object_vec{};
+  DetectedObjects detections_msg;
+
+  for (size_t i = 0U; i < num_tracks; ++i) {
+    DetectedObject current_track;
+    current_track.shape = create_square(4.0F);
+    // 0, 100, 200, ... in the order 300, 200, 100, 0, 500, 400
+    const auto slot = ((i * 5U) + 3U) % num_tracks;
+    current_track.kinematics.centroid_position.x = 100.0 * static_cast<double>(slot);
+    current_track.kinematics.centroid_position.y = 5.0;
+    current_track.kinematics.position_covariance = m_some_covariance;
+    current_track.kinematics.has_position_covariance = true;
+    tracked_object_vec.emplace_back(current_track, 0.0, 0.0);
+
+    DetectedObject current_detection;
+    current_detection.shape = create_square(4.0F);
+    current_detection.kinematics.centroid_position = current_track.kinematics.centroid_position;
+    current_detection.kinematics.centroid_position.x -= 6.0;
+    current_detection.kinematics.centroid_position.y += 7.9;
+    current_detection.kinematics.position_covariance = m_some_covariance;
+    detections_msg.objects.push_back(current_detection);
+  }
+  // Just over the max distance of 10 from the track at 200
+  DetectedObject far_detection = detections_msg.objects.front();
+  far_detection.kinematics.centroid_position.x = 206.0;
+  far_detection.kinematics.centroid_position.y = 13.01;
+  detections_msg.objects.push_back(far_detection);
+
+  const auto ret = m_associator.assign(detections_msg, tracked_object_vec);
+
+  EXPECT_TRUE(ret.unassigned_track_indices.empty());
+  ASSERT_EQ(ret.unassigned_detection_indices.size(), 1U);
+  EXPECT_EQ(*ret.unassigned_detection_indices.begin(), num_tracks);
+  for (size_t track_idx = 0U; track_idx < num_tracks; ++track_idx) {
+    EXPECT_EQ(ret.track_assignments[track_idx], track_idx);
+  }
+}
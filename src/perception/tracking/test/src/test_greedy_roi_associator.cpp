@@ -15,6 +15,7 @@
 // Co-developed by Tier IV, Inc. and Apex.AI, Inc.
 
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <tracking/greedy_roi_associator.hpp>
 #include <tracking/projection.hpp>
 #include <vector>
@@ -112,6 +113,33 @@ TYPED_TEST(TestRoiAssociation, correct_association) {
   ASSERT_EQ(result.unassigned_track_indices.size(), 0U);
 }
 
+// Of two overlapping ROIs, the one with the higher IoU is associated, regardless of the order
+TYPED_TEST(TestRoiAssociation, best_match_association) {
+  this->add_object(make_pt(10.0F, 10.0F, 10), 5.0F, 5.0F, 2.0F);
+  const auto projection = this->camera.project(expand_shape_to_vector(this->get_ith_shape(0U)));
+  ASSERT_TRUE(projection);
+  const auto exact_roi = projection_to_roi(projection.value());
+  auto min_x = exact_roi.polygon.points.front().x;
+  auto max_x = min_x;
+  for (const auto & pt : exact_roi.polygon.points) {
+    min_x = std::min(min_x, pt.x);
+    max_x = std::max(max_x, pt.x);
+  }
+  auto shifted_roi = exact_roi;
+  for (auto & pt : shifted_roi.polygon.points) {
+    pt.x += 0.3F * (max_x - min_x);
+  }
+  for (const auto exact_idx : {0U, 1U}) {
+    ClassifiedRoiArray rois;
+    rois.rois.push_back(exact_idx == 0U ? exact_roi : shifted_roi);
+    rois.rois.push_back(exact_idx == 0U ? shifted_roi : exact_roi);
+    const auto result = this->associator.assign(rois, this->objects, make_identity());
+    EXPECT_EQ(result.track_assignments.front(), exact_idx);
+    ASSERT_EQ(result.unassigned_detection_indices.size(), 1U);
+    EXPECT_EQ(*result.unassigned_detection_indices.begin(), 1U - exact_idx);
+  }
+}
+
 TYPED_TEST(TestRoiAssociation, out_of_image_test) {
   ClassifiedRoiArray rois;
 
@@ -229,3 +257,31 @@ TYPED_TEST(TestRoiAssociation, combined_association_test) {
       .unassigned_detection_indices.end());
   }
 }
+
+// The index only returns the ROIs whose extent overlaps with the extent of the projection
+TEST(TestRoiExtentIndex, overlapping_rois) {
+  const auto make_box = [](float32_t min_x, float32_t min_y, float32_t max_x, float32_t max_y) {
+      ClassifiedRoi roi;
+      roi.polygon.points = {make_pt(min_x, min_y, 0.0F), make_pt(max_x, min_y, 0.0F),
+        make_pt(max_x, max_y, 0.0F), make_pt(min_x, max_y, 0.0F)};
+      return roi;
+    };
+  ClassifiedRoiArray rois;
+  rois.rois.push_back(make_box(0.0F, 0.0F, 100.0F, 10.0F));  // Wide, overlaps from the left
+  rois.rois.push_back(make_box(60.0F, 0.0F, 70.0F, 10.0F));  // Inside
+  rois.rois.push_back(make_box(60.0F, 20.0F, 70.0F, 30.0F));  // Overlaps in x only
+  rois.rois.push_back(make_box(80.0F, 0.0F, 90.0F, 10.0F));  // Right of the projection
+  rois.rois.push_back(ClassifiedRoi{});  // No points
+  rois.rois.push_back(make_box(10.0F, 5.0F, 52.0F, 6.0F));  // Overlaps at the left edge
+  const tracking::details::RoiExtentIndex index{rois};
+
+  Projection projection;
+  projection.shape = {make_pt(50.0F, 2.0F, 0.0F), make_pt(75.0F, 2.0F, 0.0F),
+    make_pt(60.0F, 8.0F, 0.0F)};
+  std::vector<std::size_t> candidates{42U};
+  index.query(projection, candidates);
+  EXPECT_EQ(candidates, (std::vector<std::size_t>{0U, 1U, 5U}));
+
+  index.query(Projection{}, candidates);
+  EXPECT_TRUE(candidates.empty());
+}
@@ -18,6 +18,7 @@
 #include "autoware_auto_msgs/msg/detected_objects.hpp"
 #include "nav_msgs/msg/odometry.hpp"
 #include "tracking/multi_object_tracker.hpp"
+#include "tracking/test_utils.hpp"
 
 using Tracker = autoware::perception::tracking::MultiObjectTracker;
 using CreationPolicies = autoware::perception::tracking::TrackCreationPolicy;
@@ -67,3 +68,34 @@ TEST_F(MultiObjectTrackerTest, test_frame_orientation_validation) {
   const auto result = m_tracker.update(m_detections, m_odom);
   EXPECT_EQ(result.status, Status::FrameNotGravityAligned);
 }
+
+TEST_F(MultiObjectTrackerTest, test_extrapolation) {
+  autoware_auto_msgs::msg::DetectedObject detection;
+  detection.shape = make_rectangular_shape(make_pt(10.0F, 0.0F, 0.0F), 1.0F, 2.0F, 1.5F);
+  detection.kinematics.centroid_position.x = 10.0;
+  detection.kinematics.has_twist = true;
+  detection.kinematics.twist.twist.linear.x = 2.0;
+  m_detections.objects.push_back(detection);
+  ASSERT_EQ(m_tracker.update(m_detections, m_odom).status, Status::Ok);
+
+  auto stamp = m_detections.header.stamp;
+  stamp.nanosec = 500000000U;
+  const auto extrapolated = m_tracker.extrapolate(stamp);
+  ASSERT_EQ(extrapolated.status, Status::Ok);
+  EXPECT_EQ(extrapolated.objects->header.stamp, stamp);
+  ASSERT_EQ(extrapolated.objects->objects.size(), 1U);
+  const auto & kinematics = extrapolated.objects->objects[0U].kinematics;
+  EXPECT_NEAR(kinematics.centroid_position.x, 11.0, 1e-6);
+  // The uncertainty grows with the prediction
+  const auto current = m_tracker.extrapolate(m_detections.header.stamp);
+  ASSERT_EQ(current.objects->objects.size(), 1U);
+  EXPECT_GT(
+    kinematics.position_covariance[0],
+    current.objects->objects[0U].kinematics.position_covariance[0]);
+
+  // The tracks themselves are not predicted
+  EXPECT_NEAR(current.objects->objects[0U].kinematics.centroid_position.x, 10.0, 1e-6);
+
+  stamp.sec = 999;
+  EXPECT_EQ(m_tracker.extrapolate(stamp).status, Status::WentBackInTime);
+}
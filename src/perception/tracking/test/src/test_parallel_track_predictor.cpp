@@ -0,0 +1,82 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#include <chrono>
+#include <stdexcept>
+#include <vector>
+
+#include "autoware_auto_msgs/msg/detected_object.hpp"
+#include "gtest/gtest.h"
+#include "tracking/parallel_track_predictor.hpp"
+#include "tracking/tracked_object.hpp"
+
+using autoware::perception::tracking::ParallelTrackPredictor;
+using autoware::perception::tracking::TrackedObject;
+using DetectedObjectMsg = autoware_auto_msgs::msg::DetectedObject;
+
+namespace
+{
+std::vector<TrackedObject> make_tracks(const std::size_t num_tracks)
+{
+  std::vector<TrackedObject> tracks;
+  DetectedObjectMsg msg;
+  msg.kinematics.has_twist = true;
+  for (std::size_t idx = 0U; idx < num_tracks; ++idx) {
+    const auto val = static_cast<double>(idx);
+    msg.kinematics.centroid_position.x = val;
+    msg.kinematics.centroid_position.y = -2.0 * val;
+    msg.kinematics.twist.twist.linear.x = 0.1 * val;
+    msg.kinematics.twist.twist.linear.y = 1.0 - 0.05 * val;
+    tracks.emplace_back(msg, 1.0 + 0.01 * val, 3.0);
+  }
+  return tracks;
+}
+
+void expect_same(std::vector<TrackedObject> & lhs, std::vector<TrackedObject> & rhs)
+{
+  ASSERT_EQ(lhs.size(), rhs.size());
+  for (std::size_t idx = 0U; idx < lhs.size(); ++idx) {
+    const auto & lhs_kinematics = lhs[idx].msg().kinematics;
+    const auto & rhs_kinematics = rhs[idx].msg().kinematics;
+    EXPECT_EQ(lhs_kinematics.centroid_position, rhs_kinematics.centroid_position);
+    EXPECT_EQ(lhs_kinematics.twist, rhs_kinematics.twist);
+    EXPECT_EQ(lhs_kinematics.position_covariance, rhs_kinematics.position_covariance);
+  }
+}
+}  // namespace
+
+TEST(test_parallel_track_predictor, bad_threads) {
+  EXPECT_THROW(ParallelTrackPredictor{0U}, std::domain_error);
+}
+
+// Predicting on the pool gives the same tracks as predicting them one after the other, also
+// when there are too few tracks to use all threads
+TEST(test_parallel_track_predictor, matches_serial) {
+  ParallelTrackPredictor predictor{4U};
+  EXPECT_EQ(predictor.get_num_threads(), 4U);
+  for (const std::size_t num_tracks : {0U, 5U, 40U, 203U}) {
+    auto parallel_tracks = make_tracks(num_tracks);
+    auto serial_tracks = make_tracks(num_tracks);
+    for (int iter = 1; iter <= 3; ++iter) {
+      const std::chrono::milliseconds dt{50 * iter};
+      predictor.predict(parallel_tracks, dt);
+      for (auto & track : serial_tracks) {
+        track.predict(dt);
+      }
+      expect_same(parallel_tracks, serial_tracks);
+    }
+  }
+}
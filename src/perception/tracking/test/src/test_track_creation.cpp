@@ -260,3 +260,39 @@ TEST_F(TestTrackCreator, test_lidar_if_vision_out_of_time_range)
   const auto ret = creator.create_tracks();
   EXPECT_EQ(ret.tracks.size(), 0U);
 }
+
+// Matched and unmatched clusters interleaved, the leftover keeps the order of the clusters
+TEST_F(TestTrackCreator, test_lidar_if_vision_leftover_order)
+{
+  TrackCreator creator{{CreationPolicies::LidarClusterIfVision, 1.0F, 1.0F,
+    this->vision_policy_cfg}};
+  auto now_time = time_utils::to_message(
+    std::chrono::system_clock::time_point{std::chrono::system_clock::now()});
+
+  // Add lidar
+  DetectedObjects lidar_detections;
+  lidar_detections.header.stamp = now_time;
+  lidar_detections.objects.push_back(this->unmatched_objects[0]);
+  lidar_detections.objects.push_back(this->object_roi_pairs[0].first);
+  lidar_detections.objects.push_back(this->unmatched_objects[1]);
+  lidar_detections.objects.push_back(this->object_roi_pairs[1].first);
+  AssociatorResult lidar_track_assn;
+  lidar_track_assn.unassigned_detection_indices = {0, 1, 2, 3};
+  creator.add_objects(lidar_detections, lidar_track_assn);
+
+  // Add vision
+  ClassifiedRoiArray vision_detections;
+  vision_detections.header.stamp = now_time;
+  vision_detections.rois.push_back(this->object_roi_pairs[1].second);
+  vision_detections.rois.push_back(this->object_roi_pairs[0].second);
+  AssociatorResult vision_track_assn;
+  vision_track_assn.unassigned_detection_indices = {0, 1};
+  creator.add_objects(vision_detections, vision_track_assn);
+
+  // Test
+  const auto ret = creator.create_tracks();
+  EXPECT_EQ(ret.tracks.size(), 2U);
+  ASSERT_EQ(ret.detections_leftover.objects.size(), 2U);
+  EXPECT_EQ(ret.detections_leftover.objects[0U].shape, this->unmatched_objects[0].shape);
+  EXPECT_EQ(ret.detections_leftover.objects[1U].shape, this->unmatched_objects[1].shape);
+}
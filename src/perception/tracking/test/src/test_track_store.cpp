@@ -0,0 +1,120 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#include <chrono>
+#include <vector>
+
+#include "autoware_auto_msgs/msg/detected_object.hpp"
+#include "autoware_auto_msgs/msg/object_classification.hpp"
+#include "geometry_msgs/msg/point32.hpp"
+#include "gtest/gtest.h"
+#include "tracking/track_store.hpp"
+#include "tracking/tracked_object.hpp"
+
+using autoware::perception::tracking::TrackStore;
+using autoware::perception::tracking::TrackedObject;
+using DetectedObjectMsg = autoware_auto_msgs::msg::DetectedObject;
+
+namespace
+{
+DetectedObjectMsg make_detection(const double x, const std::size_t num_points)
+{
+  DetectedObjectMsg msg;
+  msg.existence_probability = 0.5F;
+  msg.kinematics.centroid_position.x = x;
+  msg.kinematics.centroid_position.y = 2.0 * x;
+  msg.kinematics.has_twist = true;
+  msg.kinematics.twist.twist.linear.x = -x;
+  geometry_msgs::msg::Point32 point;
+  for (std::size_t idx = 0U; idx < num_points; ++idx) {
+    point.x = static_cast<float>(x) + static_cast<float>(idx);
+    msg.shape.polygon.points.push_back(point);
+  }
+  autoware_auto_msgs::msg::ObjectClassification classification;
+  classification.classification = autoware_auto_msgs::msg::ObjectClassification::CAR;
+  classification.probability = 1.0F;
+  msg.classification.push_back(classification);
+  return msg;
+}
+
+bool has_x(TrackedObject & track, const double x)
+{
+  return track.msg().kinematics.centroid_position.x == x;
+}
+}  // namespace
+
+// Removed tracks are kept and reused for new tracks
+TEST(test_track_store, reuses_removed_tracks) {
+  constexpr double kDefaultVariance = 1.0;
+  constexpr double kNoiseVariance = 3.0;
+  TrackStore store{4U};
+  EXPECT_EQ(store.capacity(), 4U);
+  for (const double x : {0.0, 1.0, 2.0}) {
+    store.emplace(make_detection(x, 4U), kDefaultVariance, kNoiseVariance);
+  }
+  EXPECT_EQ(store.size(), 3U);
+  EXPECT_EQ(store.num_free(), 0U);
+
+  store.remove_if([](const TrackedObject & track) {return track.centroid().x() == 1.0;});
+  ASSERT_EQ(store.size(), 2U);
+  EXPECT_EQ(store.num_free(), 1U);
+  // The last track takes the place of the removed one
+  EXPECT_TRUE(has_x(store.tracks()[0U], 0.0));
+  EXPECT_TRUE(has_x(store.tracks()[1U], 2.0));
+  const auto removed_id = store.tracks()[1U].msg().object_id;
+
+  // The reused track uses the buffers of the removed one, and is not distinguishable from a new
+  // track
+  const auto detection = make_detection(5.0, 3U);
+  auto & track = store.emplace(detection, kDefaultVariance, kNoiseVariance);
+  EXPECT_EQ(store.size(), 3U);
+  EXPECT_EQ(store.num_free(), 0U);
+  EXPECT_EQ(&track, &store.tracks().back());
+  TrackedObject expected{detection, kDefaultVariance, kNoiseVariance};
+  const auto & msg = track.msg();
+  const auto & expected_msg = expected.msg();
+  EXPECT_NE(msg.object_id, removed_id);
+  EXPECT_EQ(msg.existence_probability, expected_msg.existence_probability);
+  EXPECT_EQ(msg.classification, expected_msg.classification);
+  EXPECT_EQ(msg.kinematics, expected_msg.kinematics);
+  ASSERT_EQ(msg.shape.size(), 1U);
+  EXPECT_EQ(msg.shape, expected_msg.shape);
+  EXPECT_FALSE(track.should_be_removed(std::chrono::milliseconds{1}, 1U));
+
+  store.remove_if([](const TrackedObject &) {return true;});
+  EXPECT_EQ(store.size(), 0U);
+  EXPECT_EQ(store.num_free(), 3U);
+}
+
+// Resetting a track that has been predicted and updated gives the same state as constructing it
+TEST(test_track_store, reset_matches_construction) {
+  TrackedObject track{make_detection(1.0, 6U), 1.0, 3.0};
+  track.predict(std::chrono::milliseconds{100});
+  track.update(make_detection(1.5, 2U));
+  track.predict(std::chrono::milliseconds{100});
+  track.no_update();
+
+  const auto detection = make_detection(-3.0, 4U);
+  track.reset(detection, 2.0, 1.0);
+  TrackedObject expected{detection, 2.0, 1.0};
+  EXPECT_EQ(track.msg().kinematics, expected.msg().kinematics);
+  EXPECT_EQ(track.msg().classification, expected.msg().classification);
+  EXPECT_EQ(track.msg().shape, expected.msg().shape);
+  EXPECT_FALSE(track.should_be_removed(std::chrono::nanoseconds{1}, 1U));
+  track.predict(std::chrono::milliseconds{100});
+  expected.predict(std::chrono::milliseconds{100});
+  EXPECT_EQ(track.msg().kinematics, expected.msg().kinematics);
+}
@@ -23,7 +23,9 @@
 
 #include <autoware_auto_msgs/msg/detected_objects.hpp>
 #include <autoware_auto_msgs/msg/tracked_objects.hpp>
+#include <compact_objects/compact_objects.hpp>
 #include <geometry_msgs/msg/pose_with_covariance_stamped.hpp>
+#include <latency_tracing/tracer.hpp>
 #include <message_filters/cache.h>
 #include <message_filters/subscriber.h>
 #include <message_filters/sync_policies/approximate_time.h>
@@ -31,15 +33,24 @@
 #include <message_filters/time_synchronizer.h>
 #include <mpark_variant_vendor/variant.hpp>
 #include <nav_msgs/msg/odometry.hpp>
+#include <overload_management/load_monitor.hpp>
 #include <rclcpp/rclcpp.hpp>
+#include <rt_memory/allocation_diagnostics.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
 #include <tf2/buffer_core.h>
 #include <tf2_ros/transform_listener.h>
 #include <tf2_msgs/msg/tf_message.hpp>
 #include <tracking/multi_object_tracker.hpp>
 #include <tracking_nodes/visibility_control.hpp>
 
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <utility>
 
 namespace autoware
 {
@@ -48,7 +59,9 @@ namespace tracking_nodes
 
 /// \class MultiObjectTrackerNode
 /// \brief ROS 2 Node for tracking. Subscribes to DetectedObjects and Odometry or
-///        PoseWithCovairanceStamped (depends on use_ndt param) and produces TrackedObjects
+///        PoseWithCovairanceStamped (depends on use_ndt param) and produces TrackedObjects.
+///        With the async_modalities param, the subscription callbacks only match the messages
+///        with odometry and queue them, and a separate thread updates the tracker in time order.
 class TRACKING_NODES_PUBLIC MultiObjectTrackerNode : public rclcpp::Node
 {
   using DetectedObjects = autoware_auto_msgs::msg::DetectedObjects;
@@ -65,6 +78,8 @@ class TRACKING_NODES_PUBLIC MultiObjectTrackerNode : public rclcpp::Node
 public:
   /// \brief Constructor
   explicit MultiObjectTrackerNode(const rclcpp::NodeOptions & options);
+  /// \brief Destructor, stops the sequencing thread if there is one
+  ~MultiObjectTrackerNode() override;
 
   /// Callback for matching detections + odom messages.
   /// This unusual signature is mandated by message_filters.
@@ -83,8 +98,38 @@ public:
   struct ProcessVision;
 
 private:
+  template<typename MsgT>
+  using UpdateQueue =
+    std::deque<std::pair<typename MsgT::ConstSharedPtr, Odometry::ConstSharedPtr>>;
+
   geometry_msgs::msg::Transform compute_tf_camera_from_odom(const nav_msgs::msg::Odometry & odom);
 
+  /// Process the matched messages right away, or queue them for the sequencing thread in async
+  /// mode
+  void dispatch(
+    const DetectedObjects::ConstSharedPtr & objs,
+    const Odometry::ConstSharedPtr & odom);
+  /// Process the matched messages right away, or queue them for the sequencing thread in async
+  /// mode
+  void dispatch(
+    const ClassifiedRoiArray::ConstSharedPtr & rois,
+    const Odometry::ConstSharedPtr & odom);
+  /// Add an update to a queue, dropping the oldest one if the queue is full
+  template<typename MsgT>
+  void enqueue(
+    UpdateQueue<MsgT> & queue, const typename MsgT::ConstSharedPtr & msg,
+    const Odometry::ConstSharedPtr & odom, const char * modality);
+  /// Loop of the sequencing thread, applies the queued updates to the tracker oldest first
+  void sequence_updates();
+  /// Publish the tracks of a successful update, extrapolated to the time of publication if
+  /// extrapolation.enabled is set
+  void publish_update(
+    std::unique_ptr<autoware_auto_msgs::msg::TrackedObjects> objects,
+    const builtin_interfaces::msg::Time & detection_stamp);
+  /// Publish the tracked objects in the formats that have subscribers. Without the compact
+  /// output, the full format is always published.
+  void publish(std::unique_ptr<autoware_auto_msgs::msg::TrackedObjects> objects);
+
   bool8_t m_use_vision = true;
   /// The actual tracker implementation.
   autoware::perception::tracking::MultiObjectTracker m_tracker;
@@ -103,8 +148,43 @@ private:
 
   /// Publisher for tracked objects.
   rclcpp::Publisher<autoware_auto_msgs::msg::TrackedObjects>::SharedPtr m_pub;
+  /// Publisher and encoder of the compact format, if compact_output.enabled is set
+  rclcpp::Publisher<sensor_msgs::msg::PointCloud2>::SharedPtr m_compact_pub;
+  std::unique_ptr<autoware::perception::compact_objects::CompactObjectsEncoder> m_compact_encoder;
+  sensor_msgs::msg::PointCloud2 m_compact_msg;
   tf2::BufferCore m_tf_buffer;
   tf2_ros::TransformListener m_tf_listener;
+
+  /// Whether the published tracks are extrapolated from the detection time to the time of
+  /// publication plus m_extrapolation_horizon
+  bool8_t m_extrapolate = false;
+  std::chrono::nanoseconds m_extrapolation_horizon{0};
+  /// Whether the tracker is updated on the sequencing thread
+  bool8_t m_async_modalities = false;
+  /// Maximum number of queued updates per modality in async mode
+  std::size_t m_modality_queue_depth = 0U;
+  /// Callback groups of the modalities in async mode, so that a multi-threaded executor can run
+  /// them in parallel
+  rclcpp::CallbackGroup::SharedPtr m_lidar_callback_group;
+  rclcpp::CallbackGroup::SharedPtr m_vision_callback_group;
+  /// Queued updates in async mode, protected by m_queue_mutex
+  UpdateQueue<DetectedObjects> m_lidar_queue;
+  UpdateQueue<ClassifiedRoiArray> m_vision_queue;
+  bool8_t m_stop_sequencer = false;
+  std::mutex m_queue_mutex;
+  std::condition_variable m_queue_cv;
+  std::thread m_sequencer;
+  /// The stage of the node in the latency traces of the detections
+  autoware::common::latency_tracing::StageId m_trace_stage = 0U;
+  /// Heap allocations of the tracker updates, published if `allocation_profiling.enabled` is set
+  autoware::common::rt_memory::AllocationDiagnostics m_allocation_diagnostics;
+  autoware::common::rt_memory::CallbackId m_lidar_allocations = 0U;
+  autoware::common::rt_memory::CallbackId m_vision_allocations = 0U;
+  /// Time of the tracker updates against their budgets, if `overload.enabled` is set. The
+  /// vision updates are dropped while the node is degraded
+  autoware::common::overload_management::LoadMonitor m_load_monitor;
+  autoware::common::overload_management::CallbackId m_lidar_load = 0U;
+  autoware::common::overload_management::CallbackId m_vision_load = 0U;
 };
 
 /// Struct to call the process function with correct arguments for the different types of cache
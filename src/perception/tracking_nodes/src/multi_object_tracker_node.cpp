@@ -22,6 +22,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <utility>
 #include <vector>
@@ -34,6 +35,8 @@ namespace tracking_nodes
 
 using autoware::common::types::float32_t;
 using autoware::common::types::float64_t;
+using autoware::perception::compact_objects::CompactObjectsConfig;
+using autoware::perception::compact_objects::CompactObjectsEncoder;
 using autoware::perception::tracking::MultiObjectTracker;
 using autoware::perception::tracking::MultiObjectTrackerOptions;
 using autoware::perception::tracking::TrackCreatorConfig;
@@ -42,6 +45,7 @@ using autoware::perception::tracking::TrackerUpdateStatus;
 using autoware::perception::tracking::GreedyRoiAssociatorConfig;
 using autoware::perception::tracking::CameraIntrinsics;
 using autoware::perception::tracking::VisionPolicyConfig;
+using autoware::perception::tracking::MAX_NUM_TRACKS;
 using autoware_auto_msgs::msg::DetectedObjects;
 using autoware_auto_msgs::msg::TrackedObjects;
 using nav_msgs::msg::Odometry;
@@ -108,6 +112,15 @@ MultiObjectTracker init_tracker(rclcpp::Node & node, const bool8_t use_vision)
     static_cast<std::size_t>(node.declare_parameter(
       "pruning_ticks_threshold").get<int64_t>());
   const std::string frame = node.declare_parameter("track_frame_id", "odom");
+  const auto num_prediction_threads = node.declare_parameter("num_prediction_threads", 1);
+  if (num_prediction_threads < 1) {
+    throw std::domain_error("num_prediction_threads must be positive");
+  }
+  const auto track_capacity = node.declare_parameter(
+    "track_capacity", static_cast<int64_t>(MAX_NUM_TRACKS));
+  if (track_capacity < 0) {
+    throw std::domain_error("track_capacity must not be negative");
+  }
 
   TrackCreatorConfig creator_config{};
   GreedyRoiAssociatorConfig vision_config{};
@@ -151,10 +164,25 @@ MultiObjectTracker init_tracker(rclcpp::Node & node, const bool8_t use_vision)
 
   MultiObjectTrackerOptions options{
     {max_distance, max_area_ratio, consider_edge_for_big_detections}, vision_config,
-    creator_config, pruning_time_threshold, pruning_ticks_threshold, frame};
+    creator_config, pruning_time_threshold, pruning_ticks_threshold, frame,
+    static_cast<std::size_t>(num_prediction_threads), static_cast<std::size_t>(track_capacity)};
   return MultiObjectTracker{options};
 }
 
+CompactObjectsConfig declare_compact_config(rclcpp::Node & node)
+{
+  CompactObjectsConfig config;
+  config.shape_resolution_m = static_cast<float32_t>(node.declare_parameter(
+      "compact_output.shape_resolution_m", static_cast<float64_t>(config.shape_resolution_m)));
+  const auto key_frame_interval = node.declare_parameter(
+    "compact_output.key_frame_interval", static_cast<int64_t>(config.key_frame_interval));
+  if (key_frame_interval < 1) {
+    throw std::domain_error("compact_output.key_frame_interval must be positive");
+  }
+  config.key_frame_interval = static_cast<std::size_t>(key_frame_interval);
+  return config;
+}
+
 std::string status_to_string(TrackerUpdateStatus status)
 {
   // Use a switch statement without default since it warns when not all cases are handled.
@@ -212,8 +240,45 @@ MultiObjectTrackerNode::MultiObjectTrackerNode(const rclcpp::NodeOptions & optio
   m_history_depth(static_cast<size_t>(this->declare_parameter("history_depth", 20))),
   m_use_ndt(this->declare_parameter("use_ndt", true)),
   m_pub(create_publisher<TrackedObjects>("tracked_objects", m_history_depth)),
-  m_tf_listener{m_tf_buffer}
+  m_tf_listener{m_tf_buffer},
+  m_async_modalities{this->declare_parameter("async_modalities", false)},
+  m_trace_stage{autoware::common::latency_tracing::Tracer::instance().register_stage(
+      get_fully_qualified_name())},
+  m_allocation_diagnostics{*this},
+  // The vision association is the last work the perception pipeline sheds
+  m_load_monitor{*this, 4}
 {
+  m_lidar_allocations = m_allocation_diagnostics.add_callback("lidar_update");
+  m_lidar_load = m_load_monitor.add_callback("lidar_update", 30.0);
+  if (m_use_vision) {
+    m_vision_allocations = m_allocation_diagnostics.add_callback("vision_update");
+    m_vision_load = m_load_monitor.add_callback("vision_update", 20.0);
+  }
+  const auto modality_queue_depth = this->declare_parameter("modality_queue_depth", 2);
+  if (modality_queue_depth < 1) {
+    throw std::domain_error("modality_queue_depth must be positive");
+  }
+  m_modality_queue_depth = static_cast<std::size_t>(modality_queue_depth);
+  m_extrapolate = this->declare_parameter("extrapolation.enabled", false);
+  const auto extrapolation_horizon_ms = this->declare_parameter("extrapolation.horizon_ms", 0);
+  if (extrapolation_horizon_ms < 0) {
+    throw std::domain_error("extrapolation.horizon_ms must not be negative");
+  }
+  m_extrapolation_horizon = std::chrono::milliseconds{extrapolation_horizon_ms};
+  if (this->declare_parameter("compact_output.enabled", false)) {
+    m_compact_encoder = std::make_unique<CompactObjectsEncoder>(declare_compact_config(*this));
+    m_compact_pub = create_publisher<sensor_msgs::msg::PointCloud2>(
+      "tracked_objects_compact", m_history_depth);
+  }
+  rclcpp::SubscriptionOptions lidar_options;
+  rclcpp::SubscriptionOptions vision_options;
+  if (m_async_modalities) {
+    m_lidar_callback_group = create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive);
+    m_vision_callback_group = create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive);
+    lidar_options.callback_group = m_lidar_callback_group;
+    vision_options.callback_group = m_vision_callback_group;
+  }
+
   if (m_use_ndt) {
     m_pose_or_odom_sub.emplace<OdomSubscriber>(
       this, "ego_state", rclcpp::QoS(m_history_depth).get_rmw_qos_profile());
@@ -230,7 +295,7 @@ MultiObjectTrackerNode::MultiObjectTrackerNode(const rclcpp::NodeOptions & optio
     "detected_objects", rclcpp::QoS(m_history_depth), [this]
       (autoware_auto_msgs::msg::DetectedObjects::ConstSharedPtr msg) {
       mpark::visit(ProcessLidar{this, msg}, m_pose_or_odom_cache);
-    });
+    }, lidar_options);
 
   // Initialize vision callbacks if vision is configured to be used:
   if (m_use_vision) {
@@ -239,23 +304,44 @@ MultiObjectTrackerNode::MultiObjectTrackerNode(const rclcpp::NodeOptions & optio
         "classified_rois", rclcpp::QoS(m_history_depth), [this]
           (ClassifiedRoiArray::ConstSharedPtr msg) {
           mpark::visit(ProcessVision{this, msg}, m_pose_or_odom_cache);
-        }));
+        }, vision_options));
 
     tf2::Transform temp;
     tf2::fromMsg(get_tf_camera_from_base_link_from_params(*this), temp);
     m_maybe_tf_camera_from_base_link.emplace(temp);
   }
+
+  if (m_async_modalities) {
+    m_sequencer = std::thread{&MultiObjectTrackerNode::sequence_updates, this};
+  }
+}
+
+MultiObjectTrackerNode::~MultiObjectTrackerNode()
+{
+  if (m_sequencer.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock{m_queue_mutex};
+      m_stop_sequencer = true;
+    }
+    m_queue_cv.notify_one();
+    m_sequencer.join();
+  }
 }
 
 void MultiObjectTrackerNode::process(
   const DetectedObjects::ConstSharedPtr & objs,
   const Odometry::ConstSharedPtr & odom)
 {
+  const autoware::common::rt_memory::AllocationScope allocations{
+    m_allocation_diagnostics.profiler(), m_lidar_allocations};
+  const autoware::common::overload_management::LoadScope load{m_load_monitor, m_lidar_load};
+  // The tracked objects keep the stamp, so they continue the trace of the detections
+  autoware::common::latency_tracing::TraceScope trace{
+    autoware::common::latency_tracing::Tracer::instance(), m_trace_stage};
+  trace.set_trace_id(autoware::common::latency_tracing::to_trace_id(objs->header.stamp));
   TrackerUpdateResult result = m_tracker.update(*objs, *odom);
   if (result.status == TrackerUpdateStatus::Ok) {
-    // The tracker returns its result in a unique_ptr, so the more efficient publish(unique_ptr<T>)
-    // overload can be used.
-    m_pub->publish(std::move(result.objects));
+    publish_update(std::move(result.objects), objs->header.stamp);
   } else {
     RCLCPP_WARN(
       get_logger(), "Tracker update for vision detection at time %d.%d failed. Reason: %s",
@@ -264,14 +350,152 @@ void MultiObjectTrackerNode::process(
   }
 }
 
+void MultiObjectTrackerNode::publish_update(
+  std::unique_ptr<TrackedObjects> objects,
+  const builtin_interfaces::msg::Time & detection_stamp)
+{
+  if (m_extrapolate) {
+    // Never before the detections, e.g. if the clock of the node lags behind their stamps
+    const rclcpp::Time detection_time{detection_stamp, get_clock()->get_clock_type()};
+    auto target_time = now() + rclcpp::Duration{m_extrapolation_horizon};
+    if (target_time < detection_time) {
+      target_time = detection_time;
+    }
+    // All tracks are predicted in one pass on the prediction threads of the tracker
+    TrackerUpdateResult extrapolated = m_tracker.extrapolate(target_time);
+    if (extrapolated.status == TrackerUpdateStatus::Ok) {
+      objects = std::move(extrapolated.objects);
+    } else {
+      RCLCPP_WARN(
+        get_logger(), "Publishing the tracks unextrapolated, extrapolation failed. Reason: %s",
+        status_to_string(extrapolated.status).c_str());
+    }
+  }
+  publish(std::move(objects));
+}
+
+void MultiObjectTrackerNode::publish(std::unique_ptr<TrackedObjects> objects)
+{
+  if (m_compact_pub) {
+    // The shapes only build on the previous frames while someone decodes them
+    if (m_compact_pub->get_subscription_count() > 0U) {
+      try {
+        m_compact_encoder->encode(*objects, m_compact_msg);
+        m_compact_pub->publish(m_compact_msg);
+      } catch (const std::runtime_error & e) {
+        RCLCPP_WARN(get_logger(), "Couldn't encode the compact tracked objects: %s", e.what());
+        m_compact_encoder->reset();
+      }
+    } else {
+      m_compact_encoder->reset();
+    }
+    if (m_pub->get_subscription_count() == 0U) {
+      return;
+    }
+  }
+  // The tracker returns its result in a unique_ptr, so the more efficient publish(unique_ptr<T>)
+  // overload can be used.
+  m_pub->publish(std::move(objects));
+}
+
 void MultiObjectTrackerNode::process(
   const ClassifiedRoiArray::ConstSharedPtr & rois,
   const Odometry::ConstSharedPtr & odom)
 {
+  const autoware::common::rt_memory::AllocationScope allocations{
+    m_allocation_diagnostics.profiler(), m_vision_allocations};
+  const autoware::common::overload_management::LoadScope load{m_load_monitor, m_vision_load};
   const auto tf_camera_from_track = compute_tf_camera_from_odom(*odom);
   m_tracker.update(*rois, tf_camera_from_track);
 }
 
+void MultiObjectTrackerNode::dispatch(
+  const DetectedObjects::ConstSharedPtr & objs,
+  const Odometry::ConstSharedPtr & odom)
+{
+  if (m_async_modalities) {
+    enqueue<DetectedObjects>(m_lidar_queue, objs, odom, "lidar");
+  } else {
+    process(objs, odom);
+  }
+}
+
+void MultiObjectTrackerNode::dispatch(
+  const ClassifiedRoiArray::ConstSharedPtr & rois,
+  const Odometry::ConstSharedPtr & odom)
+{
+  // Dropped before they are queued, so that they don't delay the lidar updates in async mode
+  if (m_load_monitor.degraded()) {
+    return;
+  }
+  if (m_async_modalities) {
+    enqueue<ClassifiedRoiArray>(m_vision_queue, rois, odom, "vision");
+  } else {
+    process(rois, odom);
+  }
+}
+
+template<typename MsgT>
+void MultiObjectTrackerNode::enqueue(
+  UpdateQueue<MsgT> & queue, const typename MsgT::ConstSharedPtr & msg,
+  const Odometry::ConstSharedPtr & odom, const char * modality)
+{
+  bool8_t dropped = false;
+  {
+    std::lock_guard<std::mutex> lock{m_queue_mutex};
+    if (queue.size() >= m_modality_queue_depth) {
+      queue.pop_front();
+      dropped = true;
+    }
+    queue.emplace_back(msg, odom);
+  }
+  m_queue_cv.notify_one();
+  if (dropped) {
+    RCLCPP_WARN(get_logger(), "Tracker is falling behind, dropped the oldest %s msg", modality);
+  }
+}
+
+void MultiObjectTrackerNode::sequence_updates()
+{
+  while (true) {
+    std::pair<DetectedObjects::ConstSharedPtr, Odometry::ConstSharedPtr> lidar_update;
+    std::pair<ClassifiedRoiArray::ConstSharedPtr, Odometry::ConstSharedPtr> vision_update;
+    {
+      std::unique_lock<std::mutex> lock{m_queue_mutex};
+      m_queue_cv.wait(
+        lock, [this] {
+          return m_stop_sequencer || !m_lidar_queue.empty() || !m_vision_queue.empty();
+        });
+      if (m_stop_sequencer) {
+        return;
+      }
+      // Apply the oldest queued update first. Updates that have not arrived yet are not waited
+      // for, so each update only waits for the ones queued before it.
+      const bool8_t take_lidar = !m_lidar_queue.empty() &&
+        (m_vision_queue.empty() ||
+        (rclcpp::Time{m_lidar_queue.front().first->header.stamp} <=
+        rclcpp::Time{m_vision_queue.front().first->header.stamp}));
+      if (take_lidar) {
+        lidar_update = std::move(m_lidar_queue.front());
+        m_lidar_queue.pop_front();
+      } else {
+        vision_update = std::move(m_vision_queue.front());
+        m_vision_queue.pop_front();
+      }
+    }
+    // There is no caller to pass an error to on this thread, so it is logged
+    try {
+      if (lidar_update.first) {
+        process(lidar_update.first, lidar_update.second);
+      } else {
+        process(vision_update.first, vision_update.second);
+      }
+    } catch (const std::exception & e) {
+      RCLCPP_ERROR(get_logger(), "Tracker update failed: %s", e.what());
+    }
+  }
+}
+
 geometry_msgs::msg::Transform MultiObjectTrackerNode::compute_tf_camera_from_odom(
   const nav_msgs::msg::Odometry & odom)
 {
@@ -301,7 +525,7 @@ void MultiObjectTrackerNode::ProcessLidar::operator()(
     RCLCPP_WARN(m_node_ptr->get_logger(), "No matching odom msg received for obj msg");
     return;
   }
-  m_node_ptr->process(m_msg, get_closest_match(matched_msgs, m_msg->header.stamp));
+  m_node_ptr->dispatch(m_msg, get_closest_match(matched_msgs, m_msg->header.stamp));
 }
 
 void MultiObjectTrackerNode::ProcessLidar::operator()(
@@ -312,7 +536,7 @@ void MultiObjectTrackerNode::ProcessLidar::operator()(
     RCLCPP_WARN(m_node_ptr->get_logger(), "No matching odom msg received for obj msg");
     return;
   }
-  m_node_ptr->process(m_msg, to_odom(get_closest_match(matched_msgs, m_msg->header.stamp)));
+  m_node_ptr->dispatch(m_msg, to_odom(get_closest_match(matched_msgs, m_msg->header.stamp)));
 }
 
 MultiObjectTrackerNode::ProcessVision::ProcessVision(
@@ -333,8 +557,9 @@ void MultiObjectTrackerNode::ProcessVision::operator()(
   const auto matched_msgs = cache_ptr->getInterval(m_left_interval, m_right_interval);
   if (matched_msgs.empty()) {
     RCLCPP_WARN(m_node_ptr->get_logger(), "No matching odom msg received for vision msg");
+    return;
   }
-  m_node_ptr->process(m_msg, get_closest_match(matched_msgs, m_msg->header.stamp));
+  m_node_ptr->dispatch(m_msg, get_closest_match(matched_msgs, m_msg->header.stamp));
 }
 
 void MultiObjectTrackerNode::ProcessVision::operator()(
@@ -343,8 +568,9 @@ void MultiObjectTrackerNode::ProcessVision::operator()(
   const auto matched_msgs = cache_ptr->getInterval(m_left_interval, m_right_interval);
   if (matched_msgs.empty()) {
     RCLCPP_WARN(m_node_ptr->get_logger(), "No matching pose msg received for vision msg");
+    return;
   }
-  m_node_ptr->process(m_msg, to_odom(get_closest_match(matched_msgs, m_msg->header.stamp)));
+  m_node_ptr->dispatch(m_msg, to_odom(get_closest_match(matched_msgs, m_msg->header.stamp)));
 }
 
 
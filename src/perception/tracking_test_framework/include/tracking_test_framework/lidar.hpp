@@ -46,8 +46,10 @@ public:
   /// \brief Method to get intersection points with the object clusters and lidar beams
   /// \param[in] objects std::vector holding unique_ptr to the TrackedObjects : Car, Pedestrian
   /// \param[in] closest_only the boolean to determine if closest intersection to be
-  /// returned or all
-  /// \return returns the intersection points
+  /// returned or all. With the closest only, a beam stops at the first object it hits, so that
+  /// the objects behind it are occluded
+  /// \return returns the intersection points of each object that is hit by a beam, in the order
+  /// of the objects
   std::vector<ObjIntersections> get_intersections_per_object(
     const std::vector<std::unique_ptr<TrackedObject>> & objects,
     const bool closest_only) const;
@@ -0,0 +1,109 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+/// \copyright Copyright 2021 The Autoware Foundation
+/// \file
+/// \brief This file defines the class which generates a reproducible Scene with many objects and
+/// replays its detections frame by frame, e.g. to measure how the tracking scales
+
+#ifndef TRACKING_TEST_FRAMEWORK__SCENARIO_HPP_
+#define TRACKING_TEST_FRAMEWORK__SCENARIO_HPP_
+
+#include <tracking_test_framework/scene.hpp>
+
+#include <autoware_auto_msgs/msg/detected_objects.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace autoware
+{
+namespace tracking_test_framework
+{
+
+/// \brief Parameters of a generated Scenario
+struct TRACKING_TEST_FRAMEWORK_PUBLIC ScenarioConfig
+{
+  /// seed of the random numbers, the same seed gives the same scenario with every compiler
+  std::uint64_t seed{42U};
+  /// number of Cars in the scene
+  std::size_t num_cars{50U};
+  /// number of Pedestrians in the scene
+  std::size_t num_pedestrians{50U};
+  /// the objects start uniformly distributed over a ring around the LiDAR between these ranges.
+  /// Together with the number of objects this sets the density and thus the occlusion
+  autoware::common::types::float32_t min_range{5.0F};
+  autoware::common::types::float32_t max_range{60.0F};
+  /// number of false detections in every frame, uniformly distributed over the same ring
+  std::size_t num_clutter{0U};
+  /// probability that an object which the LiDAR sees is not detected anyway
+  autoware::common::types::float32_t miss_probability{0.0F};
+  /// number of ticks in LiDAR scan space between 0 to 2*PI
+  std::uint32_t num_azimuth_ticks{1800U};
+  /// max range of the LiDAR
+  autoware::common::types::float32_t lidar_range{100.0F};
+  /// objects with fewer intersections with the LiDAR beams are not detected
+  std::size_t min_num_points{3U};
+  /// frame id of the detections, the LiDAR is at its origin
+  std::string frame_id{"base_link"};
+};
+
+/// \brief This is the class which generates a Scene of randomly placed Cars and Pedestrians
+/// that move with random speeds and turn rates, and gets its detections frame by frame.
+/// Occlusion follows from the LiDAR, which only sees the closest object along each beam
+class TRACKING_TEST_FRAMEWORK_PUBLIC Scenario
+{
+public:
+  /// \brief constructor
+  /// \param[in] config parameters of the scenario
+  /// \throws std::domain_error if the ranges or the miss probability are invalid
+  explicit Scenario(const ScenarioConfig & config);
+
+  /// \brief Method to move the objects forward and get the detections of the next frame
+  /// \param[in] dt_in_ms time interval in milliseconds since the previous frame
+  /// \return returns the detections, stamped with the time since the start of the scenario
+  autoware_auto_msgs::msg::DetectedObjects next_frame(const std::chrono::milliseconds dt_in_ms);
+
+private:
+  /// \brief Method to get the next random number between min and max
+  autoware::common::types::float32_t uniform(
+    const autoware::common::types::float32_t min,
+    const autoware::common::types::float32_t max);
+
+  /// \brief Method to get a random position that is uniformly distributed over the ring
+  Eigen::Vector2f position_in_ring();
+
+  /// \brief Method to create the objects of the Scene
+  std::vector<std::unique_ptr<TrackedObject>> make_objects();
+
+  /// Parameters of the scenario
+  ScenarioConfig m_config;
+  /// State of the splitmix64 random number generator, whose numbers don't depend on the
+  /// standard library, unlike the standard distributions
+  std::uint64_t m_random_state;
+  /// The Scene with the objects
+  Scene m_scene;
+  /// Time since the start of the scenario
+  std::chrono::nanoseconds m_time{0};
+};
+}  // namespace tracking_test_framework
+}  // namespace autoware
+
+#endif  // TRACKING_TEST_FRAMEWORK__SCENARIO_HPP_
@@ -27,6 +27,7 @@
 #include <autoware_auto_msgs/msg/detected_objects.hpp>
 
 #include <chrono>
+#include <cstddef>
 #include <memory>
 #include <vector>
 
@@ -50,10 +51,12 @@ public:
   /// \brief Method to get DetectedObjects of the TrackedObjects in the Scene with LiDAR
   /// \param[in] closest_only the boolean to determine if closest intersection to be
   /// returned or all
+  /// \param[in] min_num_points objects with fewer intersections are not detected, like a
+  /// clustering would drop them. The bounding box fit needs at least 2 points for a Car
   /// \return returns the DetectedObjects filled with the TrackedObjects information in
   /// the scene
   autoware_auto_msgs::msg::DetectedObjects get_detected_objects_array(
-    const bool closest_only) const;
+    const bool closest_only, const std::size_t min_num_points = 1U) const;
 
 private:
   /// \brief Method to get intersection points of the TrackedObject put in the Scene with LiDAR
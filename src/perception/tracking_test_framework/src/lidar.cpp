@@ -17,6 +17,7 @@
 #include <tracking_test_framework/lidar.hpp>
 
 #include <algorithm>
+#include <limits>
 #include <memory>
 #include <vector>
 
@@ -44,40 +45,44 @@ Lidar::Lidar(
 std::vector<ObjIntersections> Lidar::get_intersections_per_object(
   const std::vector<std::unique_ptr<TrackedObject>> & objects, const bool closest_only) const
 {
-  std::vector<ObjIntersections> intersections{};
+  // One entry per object, so that the points of different objects are never mixed up
+  std::vector<ObjIntersections> intersections(objects.size());
+  for (size_t obj_idx = 0; obj_idx < objects.size(); ++obj_idx) {
+    intersections[obj_idx].obj_type = objects[obj_idx]->object_type();
+  }
   for (const auto & beam : m_beams) {
-    std::vector<ObjIntersections> intersections_all_objects{};
-    for (const auto & object : objects) {
-      ObjIntersections intersections_current;
-      intersections_current.points = object->intersect_with_line(beam, closest_only);
-      intersections_current.obj_type = object->object_type();
-      if (!intersections_current.points.empty()) {
-        intersections_all_objects.push_back(intersections_current);
+    // The beam stops at the first object it hits, the ones behind it are occluded
+    size_t closest_idx = objects.size();
+    Eigen::Vector2f closest_point{Eigen::Vector2f::Zero()};
+    autoware::common::types::float32_t closest_distance =
+      std::numeric_limits<autoware::common::types::float32_t>::max();
+    for (size_t obj_idx = 0; obj_idx < objects.size(); ++obj_idx) {
+      const auto points = objects[obj_idx]->intersect_with_line(beam, closest_only);
+      if (points.empty()) {
+        continue;
       }
-    }
-
-    if (!intersections_all_objects.empty()) {
       if (closest_only) {
-        intersections.resize(1);
-        // prune all but nearest point
-        sort(
-          intersections_all_objects.begin(), intersections_all_objects.end(),
-          [&](const ObjIntersections & isec_a, const ObjIntersections & isec_b) {
-            return (isec_a.points[0] - m_position).norm() < (isec_b.points[0] - m_position).norm();
-          });
-        intersections[0].obj_type = intersections_all_objects[0].obj_type;
-        intersections[0].points.push_back(intersections_all_objects[0].points[0]);
-      } else {
-        intersections.resize(intersections_all_objects.size());
-        for (size_t isec_idx = 0; isec_idx < intersections_all_objects.size(); ++isec_idx) {
-          intersections[isec_idx].obj_type = intersections_all_objects[isec_idx].obj_type;
-          intersections[isec_idx].points.insert(
-            intersections[isec_idx].points.end(), intersections_all_objects[isec_idx].points
-            .begin(), intersections_all_objects[isec_idx].points.end());
+        const auto distance = (points[0] - m_position).norm();
+        if (distance < closest_distance) {
+          closest_distance = distance;
+          closest_point = points[0];
+          closest_idx = obj_idx;
         }
+      } else {
+        auto & object_points = intersections[obj_idx].points;
+        object_points.insert(object_points.end(), points.begin(), points.end());
       }
     }
+    if (closest_idx < objects.size()) {
+      intersections[closest_idx].points.push_back(closest_point);
+    }
   }
+  // Only the objects that were hit are returned, in the order of the objects
+  intersections.erase(
+    std::remove_if(
+      intersections.begin(), intersections.end(),
+      [](const ObjIntersections & isec) {return isec.points.empty();}),
+    intersections.end());
   return intersections;
 }
 
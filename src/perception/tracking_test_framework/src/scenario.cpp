@@ -0,0 +1,164 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Co-developed by Tier IV, Inc. and Apex.AI, Inc.
+
+#include <tracking_test_framework/scenario.hpp>
+
+#include <autoware_auto_msgs/msg/object_classification.hpp>
+#include <time_utils/time_utils.hpp>
+
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace autoware
+{
+namespace tracking_test_framework
+{
+namespace
+{
+using autoware::common::types::float32_t;
+
+/// Size of a Car in 2D \f$(x ,y)\f$
+const Eigen::Vector2f kCarSize{4.5F, 1.8F};
+/// Side length of the square shape of a false detection
+constexpr float32_t kClutterSize = 0.5F;
+
+const ScenarioConfig & validate(const ScenarioConfig & config)
+{
+  if ((config.min_range < 0.0F) || (config.max_range <= config.min_range)) {
+    throw std::domain_error("Scenario: the object ranges must satisfy 0 <= min < max");
+  }
+  if ((config.miss_probability < 0.0F) || (config.miss_probability > 1.0F)) {
+    throw std::domain_error("Scenario: the miss probability must be in [0, 1]");
+  }
+  return config;
+}
+
+autoware_auto_msgs::msg::DetectedObject make_clutter(const Eigen::Vector2f & center)
+{
+  autoware_auto_msgs::msg::DetectedObject detected_object_msg{};
+  detected_object_msg.existence_probability = 1.0;
+  autoware_auto_msgs::msg::ObjectClassification classification;
+  classification.classification = autoware_auto_msgs::msg::ObjectClassification::UNKNOWN;
+  classification.probability = 1.0;
+  detected_object_msg.classification.push_back(classification);
+  constexpr float32_t half_size = 0.5F * kClutterSize;
+  for (const auto & corner : {Eigen::Vector2f{half_size, half_size},
+      Eigen::Vector2f{-half_size, half_size}, Eigen::Vector2f{-half_size, -half_size},
+      Eigen::Vector2f{half_size, -half_size}})
+  {
+    geometry_msgs::msg::Point32 pt;
+    pt.x = center.x() + corner.x();
+    pt.y = center.y() + corner.y();
+    pt.z = 0.0F;
+    detected_object_msg.shape.polygon.points.push_back(pt);
+  }
+  detected_object_msg.shape.height = 1.5;
+  detected_object_msg.kinematics.centroid_position.x = static_cast<double>(center.x());
+  detected_object_msg.kinematics.centroid_position.y = static_cast<double>(center.y());
+  detected_object_msg.kinematics.centroid_position.z = 0.0;
+  detected_object_msg.kinematics.has_position_covariance = false;
+  detected_object_msg.kinematics.has_twist = false;
+  detected_object_msg.kinematics.has_twist_covariance = false;
+  return detected_object_msg;
+}
+}  // namespace
+
+Scenario::Scenario(const ScenarioConfig & config)
+: m_config(validate(config)), m_random_state(config.seed),
+  m_scene(Lidar{Eigen::Vector2f::Zero(), config.num_azimuth_ticks, config.lidar_range},
+    make_objects())
+{}
+
+autoware_auto_msgs::msg::DetectedObjects Scenario::next_frame(
+  const std::chrono::milliseconds dt_in_ms)
+{
+  m_scene.move_all_objects(dt_in_ms);
+  m_time += dt_in_ms;
+
+  auto detections = m_scene.get_detected_objects_array(true, m_config.min_num_points);
+  if (m_config.miss_probability > 0.0F) {
+    // Compact in place, so that the random numbers are drawn in the order of the objects
+    auto & objects = detections.objects;
+    std::size_t num_kept = 0U;
+    for (std::size_t obj_idx = 0U; obj_idx < objects.size(); ++obj_idx) {
+      if (uniform(0.0F, 1.0F) >= m_config.miss_probability) {
+        objects[num_kept] = std::move(objects[obj_idx]);
+        ++num_kept;
+      }
+    }
+    objects.resize(num_kept);
+  }
+  for (std::size_t clutter_idx = 0U; clutter_idx < m_config.num_clutter; ++clutter_idx) {
+    detections.objects.push_back(make_clutter(position_in_ring()));
+  }
+  detections.header.frame_id = m_config.frame_id;
+  detections.header.stamp = time_utils::to_message(
+    std::chrono::system_clock::time_point{
+      std::chrono::duration_cast<std::chrono::system_clock::duration>(m_time)});
+  return detections;
+}
+
+float32_t Scenario::uniform(const float32_t min, const float32_t max)
+{
+  // splitmix64
+  m_random_state += 0x9E3779B97F4A7C15ULL;
+  std::uint64_t z = m_random_state;
+  z = (z ^ (z >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27U)) * 0x94D049BB133111EBULL;
+  z = z ^ (z >> 31U);
+  // The upper 24 bits fit exactly into the mantissa, so the fraction is in [0, 1)
+  const auto fraction = static_cast<float32_t>(z >> 40U) / 16777216.0F;
+  return min + (fraction * (max - min));
+}
+
+Eigen::Vector2f Scenario::position_in_ring()
+{
+  // Uniform over the area, not over the range
+  const float32_t range = std::sqrt(
+    uniform(
+      m_config.min_range * m_config.min_range,
+      m_config.max_range * m_config.max_range));
+  const float32_t angle = uniform(0.0F, autoware::common::types::TAU);
+  return Eigen::Vector2f{range * std::cos(angle), range * std::sin(angle)};
+}
+
+std::vector<std::unique_ptr<TrackedObject>> Scenario::make_objects()
+{
+  std::vector<std::unique_ptr<TrackedObject>> objects;
+  objects.reserve(m_config.num_cars + m_config.num_pedestrians);
+  for (std::size_t car_idx = 0U; car_idx < m_config.num_cars; ++car_idx) {
+    const auto position = position_in_ring();
+    const auto speed = uniform(0.0F, 15.0F);
+    const auto orientation = uniform(0.0F, 360.0F);
+    const auto turn_rate = uniform(-10.0F, 10.0F);
+    objects.emplace_back(std::make_unique<Car>(position, speed, orientation, turn_rate, kCarSize));
+  }
+  for (std::size_t pedestrian_idx = 0U; pedestrian_idx < m_config.num_pedestrians;
+    ++pedestrian_idx)
+  {
+    const auto position = position_in_ring();
+    const auto speed = uniform(0.0F, 2.0F);
+    const auto orientation = uniform(0.0F, 360.0F);
+    const auto turn_rate = uniform(-30.0F, 30.0F);
+    objects.emplace_back(std::make_unique<Pedestrian>(position, speed, orientation, turn_rate));
+  }
+  return objects;
+}
+
+}  // namespace tracking_test_framework
+}  // namespace autoware
@@ -20,6 +20,7 @@
 #include <geometry/bounding_box_2d.hpp>
 #include <time_utils/time_utils.hpp>
 
+#include <cstddef>
 #include <memory>
 #include <vector>
 #include <utility>
@@ -47,13 +48,16 @@ std::vector<ObjIntersections> Scene::get_intersections_with_lidar(
 }
 
 autoware_auto_msgs::msg::DetectedObjects Scene::get_detected_objects_array(
-  const bool closest_only) const
+  const bool closest_only, const std::size_t min_num_points) const
 {
   std::vector<ObjIntersections> intersections_all_objects =
     this->get_intersections_with_lidar(closest_only);
 
   autoware_auto_msgs::msg::DetectedObjects detected_object_msg_array{};
   for (const auto & intersection_per_object : intersections_all_objects) {
+    if (intersection_per_object.points.size() < min_num_points) {
+      continue;
+    }
     /// Fill Shape with all intersections of LiDAR and each object
     geometry_msgs::msg::Polygon polygon{};
     autoware_auto_msgs::msg::BoundingBox bounding_box{};
@@ -57,7 +57,8 @@ Car::Car(
 
 void Car::update_shape()
 {
-  m_shape = std::make_unique<Rectangle>(Rectangle{this->position(), m_size, this->orientation()});
+  m_shape = std::make_unique<Rectangle>(
+    Rectangle{this->position(), m_size, utils::to_degrees(this->orientation())});
 }
 
 Pedestrian::Pedestrian(
@@ -17,8 +17,10 @@
 #include <gtest/gtest.h>
 
 #include <geometry/common_2d.hpp>
+#include <tracking_test_framework/scenario.hpp>
 #include <tracking_test_framework/scene.hpp>
 
+#include <chrono>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -216,3 +218,100 @@ TEST(test_tracking_test_framework, test_1232_fix_scaling_factor) {
   auto detections_msg = scene.get_detected_objects_array(true);
   ASSERT_EQ(detections_msg.objects.size(), 1U);
 }
+
+TEST(test_tracking_test_framework, test_scene_keeps_objects_apart) {
+  autoware::tracking_test_framework::Lidar lidar{Eigen::Vector2f{0.0, 0.0}, 360, 50.0};
+  std::vector<std::unique_ptr<autoware::tracking_test_framework::TrackedObject>> objects;
+  objects.emplace_back(
+    std::make_unique<autoware::tracking_test_framework::Car>(
+      Eigen::Vector2f{10.0, 0.0}, 0, 0.0, 0.0, Eigen::Vector2f{4.0, 2.0}));
+  objects.emplace_back(
+    std::make_unique<autoware::tracking_test_framework::Pedestrian>(
+      Eigen::Vector2f{0.0, 10.0}, 0, 0.0, 0.0));
+  // Occluded by the car
+  objects.emplace_back(
+    std::make_unique<autoware::tracking_test_framework::Pedestrian>(
+      Eigen::Vector2f{20.0, 0.0}, 0, 0.0, 0.0));
+  autoware::tracking_test_framework::Scene scene{lidar, std::move(objects)};
+
+  const auto detections = scene.get_detected_objects_array(true, 3U);
+  ASSERT_EQ(detections.objects.size(), 2U);
+  EXPECT_EQ(
+    detections.objects[0].classification[0].classification,
+    autoware_auto_msgs::msg::ObjectClassification::CAR);
+  EXPECT_NEAR(detections.objects[0].kinematics.centroid_position.y, 0.0, 1.0);
+  EXPECT_EQ(
+    detections.objects[1].classification[0].classification,
+    autoware_auto_msgs::msg::ObjectClassification::PEDESTRIAN);
+  EXPECT_NEAR(detections.objects[1].kinematics.centroid_position.x, 0.0, 1.0);
+}
+
+TEST(test_tracking_test_framework, test_scenario_is_reproducible) {
+  autoware::tracking_test_framework::ScenarioConfig config{};
+  config.num_cars = 20U;
+  config.num_pedestrians = 20U;
+  config.num_clutter = 5U;
+  config.miss_probability = 0.1F;
+  config.num_azimuth_ticks = 720U;
+  autoware::tracking_test_framework::Scenario scenario{config};
+  autoware::tracking_test_framework::Scenario same_scenario{config};
+  config.seed = 43U;
+  autoware::tracking_test_framework::Scenario other_scenario{config};
+
+  bool any_difference = false;
+  for (int frame = 0; frame < 5; ++frame) {
+    const auto detections = scenario.next_frame(std::chrono::milliseconds{100});
+    const auto same_detections = same_scenario.next_frame(std::chrono::milliseconds{100});
+    const auto other_detections = other_scenario.next_frame(std::chrono::milliseconds{100});
+    EXPECT_EQ(detections.header.frame_id, "base_link");
+    EXPECT_EQ(detections.header.stamp.sec, 0);
+    EXPECT_EQ(detections.header.stamp.nanosec, (frame + 1) * 100000000U);
+    // The clutter comes on top of the objects, some of which are occluded or missed
+    EXPECT_GE(detections.objects.size(), config.num_clutter);
+    EXPECT_LE(
+      detections.objects.size(),
+      config.num_cars + config.num_pedestrians + config.num_clutter);
+    ASSERT_EQ(detections.objects.size(), same_detections.objects.size());
+    for (std::size_t i = 0U; i < detections.objects.size(); ++i) {
+      EXPECT_EQ(
+        detections.objects[i].kinematics.centroid_position.x,
+        same_detections.objects[i].kinematics.centroid_position.x);
+      EXPECT_EQ(
+        detections.objects[i].kinematics.centroid_position.y,
+        same_detections.objects[i].kinematics.centroid_position.y);
+    }
+    any_difference = any_difference ||
+      (detections.objects.size() != other_detections.objects.size()) ||
+      (detections.objects[0].kinematics.centroid_position.x !=
+      other_detections.objects[0].kinematics.centroid_position.x);
+  }
+  EXPECT_TRUE(any_difference);
+}
+
+TEST(test_tracking_test_framework, test_scenario_clutter_and_misses) {
+  autoware::tracking_test_framework::ScenarioConfig config{};
+  config.num_azimuth_ticks = 720U;
+  config.num_clutter = 7U;
+  config.miss_probability = 1.0F;
+  autoware::tracking_test_framework::Scenario scenario{config};
+  const auto detections = scenario.next_frame(std::chrono::milliseconds{100});
+  ASSERT_EQ(detections.objects.size(), config.num_clutter);
+  for (const auto & detection : detections.objects) {
+    const auto range = std::hypot(
+      detection.kinematics.centroid_position.x, detection.kinematics.centroid_position.y);
+    EXPECT_GE(range, config.min_range - epsilon);
+    EXPECT_LE(range, config.max_range + epsilon);
+    EXPECT_EQ(
+      detection.classification[0].classification,
+      autoware_auto_msgs::msg::ObjectClassification::UNKNOWN);
+  }
+
+  config.miss_probability = 1.5F;
+  EXPECT_THROW(
+    autoware::tracking_test_framework::Scenario{config}, std::domain_error);
+  config.miss_probability = 0.0F;
+  config.min_range = 10.0F;
+  config.max_range = 10.0F;
+  EXPECT_THROW(
+    autoware::tracking_test_framework::Scenario{config}, std::domain_error);
+}
@@ -20,6 +20,7 @@
 #define BEHAVIOR_PLANNER__BEHAVIOR_PLANNER_HPP_
 
 #include <behavior_planner/visibility_control.hpp>
+#include <behavior_planner/request_manager.hpp>
 #include <behavior_planner/trajectory_manager.hpp>
 
 // Autoware packages
@@ -62,13 +63,6 @@ using autoware::common::types::uchar8_t;
 using autoware::common::types::bool8_t;
 using autoware::common::types::float32_t;
 
-enum PlannerType
-{
-  LANE,
-  PARKING,
-  UNKNOWN
-};
-
 /// \brief Enum representing the direction that a vehicle will park
 ///        in a parking spot relative to the spot's entrance
 enum class ParkingDirection
@@ -104,9 +98,11 @@ public:
   bool8_t is_vehicle_stopped(const State & state);
 
   RouteWithType get_current_subroute(const State & ego_state);
+  /// \brief Index of the current subroute in get_subroutes()
+  std::size_t get_current_subroute_index() const;
   PlannerType get_planner_type();
   uchar8_t get_desired_gear(const State & state);
-  std::vector<RouteWithType> get_subroutes();
+  const std::vector<RouteWithType> & get_subroutes() const;
 
   // relay to trajectory_manager
   bool8_t is_trajectory_ready();
@@ -115,7 +111,8 @@ public:
   size_t get_remaining_length(const State & state);
 
 private:
-  RouteWithType get_current_subroute();
+  /// \brief The current subroute without a copy, for the checks of every cycle
+  const RouteWithType & get_current_subroute() const;
 
   /// \brief Function to calculate if target parking orientation is HEAD_IN or TOE_IN
   /// \param[in] parking_point RoutePoint with heading for the target parking location
@@ -0,0 +1,99 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \copyright Copyright 2021 The Autoware Foundation
+/// \file
+/// \brief This file defines the bookkeeping of trajectory requests to the planners.
+
+#ifndef BEHAVIOR_PLANNER__REQUEST_MANAGER_HPP_
+#define BEHAVIOR_PLANNER__REQUEST_MANAGER_HPP_
+
+#include <behavior_planner/visibility_control.hpp>
+
+#include <common/types.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace autoware
+{
+namespace behavior_planner
+{
+
+using autoware::common::types::bool8_t;
+
+enum PlannerType
+{
+  LANE,
+  PARKING,
+  UNKNOWN
+};
+
+using RequestId = uint64_t;
+
+/// \class RequestManager
+/// \brief Class that keeps track of the trajectory requests that are in flight. Each request has
+///        an id and is for one subroute, so that a trajectory which arrives late can still be
+///        used once the vehicle reaches its subroute. Requests for subroutes that were left or
+///        of a previous route are stale: they are preempted and their results are dropped.
+///        Each planner only plans one trajectory at a time, see is_planner_busy()
+class BEHAVIOR_PLANNER_PUBLIC RequestManager
+{
+public:
+  /// \brief Register a new request
+  /// \param[in] subroute Index of the subroute that the trajectory is requested for
+  /// \param[in] planner_type The planner that the request is sent to
+  /// \return The id of the request
+  RequestId start(std::size_t subroute, PlannerType planner_type);
+
+  /// \brief Remove a request once its result arrived or it was rejected
+  /// \param[in] id The id of the request
+  /// \return Whether the request was still pending, i.e. whether its result is to be used
+  bool8_t finish(RequestId id);
+
+  /// \brief Preempt the requests for subroutes before a subroute, e.g. the current one
+  /// \param[in] subroute The first subroute whose requests are kept
+  /// \return Ids of the preempted requests, to be cancelled
+  std::vector<RequestId> preempt_before(std::size_t subroute);
+
+  /// \brief Preempt all requests, e.g. when the route changes
+  /// \return Ids of the preempted requests, to be cancelled
+  std::vector<RequestId> preempt_all();
+
+  /// \brief Whether a request was started for a subroute and is still pending
+  bool8_t has_request_for(std::size_t subroute) const;
+  /// \brief Whether a request was started and is still pending
+  bool8_t is_pending(RequestId id) const;
+  /// \brief Whether a planner is working on a pending request
+  bool8_t is_planner_busy(PlannerType planner_type) const;
+  /// \brief Whether any request is pending
+  bool8_t has_pending() const;
+
+private:
+  struct Request
+  {
+    RequestId id;
+    std::size_t subroute;
+    PlannerType planner_type;
+  };
+
+  std::vector<Request> m_pending;
+  RequestId m_next_id{0U};
+};
+
+}  // namespace behavior_planner
+}  // namespace autoware
+
+#endif  // BEHAVIOR_PLANNER__REQUEST_MANAGER_HPP_
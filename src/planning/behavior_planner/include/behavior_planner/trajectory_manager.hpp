@@ -66,12 +66,23 @@ public:
   void set_trajectory(const Trajectory & trajectory);
   Trajectory get_trajectory(const State & state);
   size_t get_remaining_length(const State & state);
+  /// \brief First velocity of the selected sub trajectory from the vehicle on that isn't zero,
+  ///        i.e. whether the vehicle has to drive forward or backward next
+  /// \param[in] state The state of the vehicle
+  /// \return The velocity, zero if the sub trajectory only stops
+  float32_t get_upcoming_velocity(const State & state);
   bool8_t is_trajectory_ready();
   bool8_t has_arrived_subgoal(const State & state);
 
 private:
   void set_sub_trajectories();
-  std::size_t get_closest_state(const State & state, const Trajectory & trajectory);
+  /// \brief Select the next sub trajectory when the vehicle has stopped at the end of the current
+  void select_sub_trajectory(const State & state);
+  /// \brief Move the cursor to the point of the selected sub trajectory that is closest to the
+  ///        state. The vehicle only moves forward along a sub trajectory, so only a few points
+  ///        ahead of the cursor are searched, which keeps the cost per cycle constant
+  /// \return The index of the closest point
+  std::size_t update_closest_index(const State & state);
   Trajectory crop_from_current_state(const Trajectory & trajectory, const State & state);
   void set_time_from_start(Trajectory * trajectory);
 
@@ -79,7 +90,11 @@ private:
   const PlannerConfig m_config;
   Trajectory m_trajectory;
   std::vector<Trajectory> m_sub_trajectories;
+  /// Number of points of the sub trajectories after each one
+  std::vector<size_t> m_points_after;
   size_t m_selected_trajectory;
+  /// Index of the point of the selected sub trajectory that is closest to the vehicle
+  size_t m_closest_index;
 };
 
 }  // namespace behavior_planner
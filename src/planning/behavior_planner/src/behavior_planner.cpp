@@ -265,14 +265,20 @@ RouteWithType BehaviorPlanner::get_current_subroute(const State & ego_state)
   return updated_subroute;
 }
 
-RouteWithType BehaviorPlanner::get_current_subroute()
+const RouteWithType & BehaviorPlanner::get_current_subroute() const
 {
-  if (!is_route_ready()) {
-    return RouteWithType();
+  static const RouteWithType empty_subroute{};
+  if (m_subroutes.empty()) {
+    return empty_subroute;
   }
   return m_subroutes.at(m_current_subroute);
 }
 
+std::size_t BehaviorPlanner::get_current_subroute_index() const
+{
+  return m_current_subroute;
+}
+
 ParkingDirection BehaviorPlanner::get_parking_direction(
   const RoutePoint & parking_point,
   const RoutePoint & closest_lane_point)
@@ -394,19 +400,15 @@ size_t BehaviorPlanner::get_remaining_length(const State & state)
 
 uchar8_t BehaviorPlanner::get_desired_gear(const State & state)
 {
-  const auto trajectory = get_trajectory(state);
-  for (const auto & pt : trajectory.points) {
-    if (pt.longitudinal_velocity_mps > std::numeric_limits<float32_t>::epsilon()) {
-      return VehicleStateCommand::GEAR_DRIVE;
-    }
-    if (pt.longitudinal_velocity_mps < -std::numeric_limits<float32_t>::epsilon()) {
-      return VehicleStateCommand::GEAR_REVERSE;
-    }
+  // only look at the velocities ahead instead of building the trajectory
+  const auto velocity = m_trajectory_manager.get_upcoming_velocity(state);
+  if (velocity < -std::numeric_limits<float32_t>::epsilon()) {
+    return VehicleStateCommand::GEAR_REVERSE;
   }
   return VehicleStateCommand::GEAR_DRIVE;
 }
 
-std::vector<RouteWithType> BehaviorPlanner::get_subroutes()
+const std::vector<RouteWithType> & BehaviorPlanner::get_subroutes() const
 {
   return m_subroutes;
 }
@@ -0,0 +1,97 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "behavior_planner/request_manager.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace autoware
+{
+namespace behavior_planner
+{
+
+RequestId RequestManager::start(const std::size_t subroute, const PlannerType planner_type)
+{
+  const auto id = m_next_id++;
+  m_pending.push_back({id, subroute, planner_type});
+  return id;
+}
+
+bool8_t RequestManager::finish(const RequestId id)
+{
+  const auto it = std::find_if(
+    m_pending.begin(), m_pending.end(),
+    [id](const Request & request) {return request.id == id;});
+  if (it == m_pending.end()) {
+    return false;
+  }
+  m_pending.erase(it);
+  return true;
+}
+
+std::vector<RequestId> RequestManager::preempt_before(const std::size_t subroute)
+{
+  std::vector<RequestId> preempted;
+  for (const auto & request : m_pending) {
+    if (request.subroute < subroute) {
+      preempted.push_back(request.id);
+    }
+  }
+  m_pending.erase(
+    std::remove_if(
+      m_pending.begin(), m_pending.end(),
+      [subroute](const Request & request) {return request.subroute < subroute;}),
+    m_pending.end());
+  return preempted;
+}
+
+std::vector<RequestId> RequestManager::preempt_all()
+{
+  std::vector<RequestId> preempted;
+  for (const auto & request : m_pending) {
+    preempted.push_back(request.id);
+  }
+  m_pending.clear();
+  return preempted;
+}
+
+bool8_t RequestManager::has_request_for(const std::size_t subroute) const
+{
+  return std::any_of(
+    m_pending.begin(), m_pending.end(),
+    [subroute](const Request & request) {return request.subroute == subroute;});
+}
+
+bool8_t RequestManager::is_pending(const RequestId id) const
+{
+  return std::any_of(
+    m_pending.begin(), m_pending.end(),
+    [id](const Request & request) {return request.id == id;});
+}
+
+bool8_t RequestManager::is_planner_busy(const PlannerType planner_type) const
+{
+  return std::any_of(
+    m_pending.begin(), m_pending.end(),
+    [planner_type](const Request & request) {return request.planner_type == planner_type;});
+}
+
+bool8_t RequestManager::has_pending() const
+{
+  return !m_pending.empty();
+}
+
+}  // namespace behavior_planner
+}  // namespace autoware
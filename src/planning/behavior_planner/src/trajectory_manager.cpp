@@ -28,8 +28,16 @@ using autoware::common::geometry::minus_2d;
 using autoware::common::geometry::norm_2d;
 using motion::motion_common::to_angle;
 
+namespace
+{
+/// Number of points ahead of the cursor that are searched for the closest point
+constexpr std::size_t kClosestPointSearchWindow = 10U;
+}  // namespace
+
 TrajectoryManager::TrajectoryManager(const PlannerConfig & config)
-: m_config(config)
+: m_config(config),
+  m_selected_trajectory(0),
+  m_closest_index(0)
 {
 }
 
@@ -37,7 +45,9 @@ void TrajectoryManager::clear_trajectory()
 {
   m_trajectory.points.clear();
   m_sub_trajectories.clear();
+  m_points_after.clear();
   m_selected_trajectory = 0;
+  m_closest_index = 0;
 }
 
 void TrajectoryManager::set_trajectory(const Trajectory & trajectory)
@@ -65,6 +75,7 @@ void TrajectoryManager::set_sub_trajectories()
 
   if (m_trajectory.points.empty()) {
     m_sub_trajectories.push_back(m_trajectory);
+    m_points_after.push_back(0);
     return;
   }
 
@@ -84,6 +95,14 @@ void TrajectoryManager::set_sub_trajectories()
   if (!sub_trajectory.points.empty()) {
     m_sub_trajectories.push_back(sub_trajectory);
   }
+
+  // remaining points after each sub trajectory, so that the remaining length is a lookup
+  m_points_after.resize(m_sub_trajectories.size());
+  size_t points_after = 0;
+  for (size_t i = m_sub_trajectories.size(); i > 0; i--) {
+    m_points_after[i - 1] = points_after;
+    points_after += m_sub_trajectories[i - 1].points.size();
+  }
 }
 
 bool8_t TrajectoryManager::is_trajectory_ready()
@@ -91,9 +110,7 @@ bool8_t TrajectoryManager::is_trajectory_ready()
   return !m_sub_trajectories.empty();
 }
 
-std::size_t TrajectoryManager::get_closest_state(
-  const State & current_state,
-  const Trajectory & trajectory)
+std::size_t TrajectoryManager::update_closest_index(const State & current_state)
 {
   const auto distance_from_current_state =
     [this, &current_state](const TrajectoryPoint & other_state) {
@@ -103,40 +120,62 @@ std::size_t TrajectoryManager::get_closest_state(
       return distance + m_config.heading_weight * angle_diff;
     };
 
-  const auto comparison_function =
-    [&distance_from_current_state](const TrajectoryPoint & one, const TrajectoryPoint & two)
-    {return distance_from_current_state(one) < distance_from_current_state(two);};
-
-  const auto minimum_index_iterator =
-    std::min_element(
-    std::begin(trajectory.points), std::end(trajectory.points),
-    comparison_function);
-  auto minimum_idx = std::distance(std::begin(trajectory.points), minimum_index_iterator);
+  // the cursor only moves forward, if the vehicle moved more than the window it catches up over
+  // the next cycles
+  const auto & points = m_sub_trajectories.at(m_selected_trajectory).points;
+  const auto window_end = std::min(m_closest_index + kClosestPointSearchWindow, points.size());
+  auto min_distance = std::numeric_limits<float32_t>::max();
+  for (size_t i = m_closest_index; i < window_end; i++) {
+    const float32_t distance = distance_from_current_state(points[i]);
+    if (distance < min_distance) {
+      min_distance = distance;
+      m_closest_index = i;
+    }
+  }
 
-  return static_cast<std::size_t>(minimum_idx);
+  return m_closest_index;
 }
 
 size_t TrajectoryManager::get_remaining_length(const State & state)
 {
   // remaining length of current selected sub trajectory
   const auto & current_trajectory = m_sub_trajectories.at(m_selected_trajectory);
-  const size_t closest_index = get_closest_state(state, current_trajectory);
+  const size_t closest_index = update_closest_index(state);
   size_t remaining_length = current_trajectory.points.size() - closest_index;
 
   // remaining length including rest of sub trajectories
-  for (size_t i = m_selected_trajectory + 1; i < m_sub_trajectories.size(); i++) {
-    remaining_length += m_sub_trajectories.at(i).points.size();
-  }
+  remaining_length += m_points_after.at(m_selected_trajectory);
 
   return remaining_length;
 }
 
+float32_t TrajectoryManager::get_upcoming_velocity(const State & state)
+{
+  select_sub_trajectory(state);
+  const auto & points = m_sub_trajectories.at(m_selected_trajectory).points;
+  if (points.empty()) {
+    return 0.0f;
+  }
+  auto index = update_closest_index(state);
+
+  // same start as the cropped trajectory
+  if (index + 1 < points.size()) {
+    index += 1;
+  }
+  for (size_t i = index; i < points.size(); i++) {
+    if (std::abs(points[i].longitudinal_velocity_mps) > std::numeric_limits<float32_t>::epsilon()) {
+      return points[i].longitudinal_velocity_mps;
+    }
+  }
+  return 0.0f;
+}
+
 Trajectory TrajectoryManager::crop_from_current_state(
   const Trajectory & trajectory,
   const State & state)
 {
   if (trajectory.points.empty()) {return trajectory;}
-  auto index = get_closest_state(state, trajectory);
+  auto index = update_closest_index(state);
 
   // we always want trajectory to start from front of vehicle so increment index
   if (index + 1 < trajectory.points.size()) {
@@ -179,7 +218,7 @@ void TrajectoryManager::set_time_from_start(Trajectory * trajectory)
   }
 }
 
-Trajectory TrajectoryManager::get_trajectory(const State & state)
+void TrajectoryManager::select_sub_trajectory(const State & state)
 {
   // select new sub_trajectory when vehicle is at stop
   if (std::abs(state.state.longitudinal_velocity_mps) < m_config.stop_velocity_thresh) {
@@ -188,10 +227,19 @@ Trajectory TrajectoryManager::get_trajectory(const State & state)
 
     // increment index to select new sub_trajectory if vehicle has arrived the end of sub_trajectory
     if (distance < m_config.goal_distance_thresh) {
+      const auto previous_trajectory = m_selected_trajectory;
       m_selected_trajectory++;
       m_selected_trajectory = std::min(m_selected_trajectory, m_sub_trajectories.size() - 1);
+      if (m_selected_trajectory != previous_trajectory) {
+        m_closest_index = 0;
+      }
     }
   }
+}
+
+Trajectory TrajectoryManager::get_trajectory(const State & state)
+{
+  select_sub_trajectory(state);
 
   // TODO(mitsudome-r) implement trajectory refine functions if needed to integrate with controller
   const auto & input = m_sub_trajectories.at(m_selected_trajectory);
@@ -0,0 +1,63 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gtest/gtest.h"
+#include "behavior_planner/request_manager.hpp"
+
+#include <vector>
+
+using autoware::behavior_planner::PlannerType;
+using autoware::behavior_planner::RequestId;
+using autoware::behavior_planner::RequestManager;
+
+TEST(TestRequestManager, TracksRequests)
+{
+  RequestManager manager;
+  EXPECT_FALSE(manager.has_pending());
+  const auto current = manager.start(0U, PlannerType::PARKING);
+  const auto next = manager.start(1U, PlannerType::LANE);
+  EXPECT_NE(current, next);
+  EXPECT_TRUE(manager.has_request_for(0U));
+  EXPECT_TRUE(manager.has_request_for(1U));
+  EXPECT_FALSE(manager.has_request_for(2U));
+  EXPECT_TRUE(manager.is_planner_busy(PlannerType::LANE));
+  EXPECT_TRUE(manager.is_planner_busy(PlannerType::PARKING));
+
+  EXPECT_TRUE(manager.finish(next));
+  EXPECT_FALSE(manager.is_pending(next));
+  EXPECT_FALSE(manager.is_planner_busy(PlannerType::LANE));
+  // A second result for the same request is dropped
+  EXPECT_FALSE(manager.finish(next));
+  EXPECT_TRUE(manager.is_pending(current));
+}
+
+TEST(TestRequestManager, PreemptsStaleRequests)
+{
+  RequestManager manager;
+  const auto first = manager.start(0U, PlannerType::LANE);
+  const auto second = manager.start(1U, PlannerType::PARKING);
+  const auto third = manager.start(2U, PlannerType::LANE);
+
+  // The vehicle moved on to the second subroute
+  EXPECT_EQ(manager.preempt_before(1U), std::vector<RequestId>{first});
+  EXPECT_FALSE(manager.finish(first));
+  EXPECT_TRUE(manager.is_pending(second));
+
+  // A new route
+  EXPECT_EQ(manager.preempt_all(), (std::vector<RequestId>{second, third}));
+  EXPECT_FALSE(manager.has_pending());
+  EXPECT_FALSE(manager.finish(third));
+  // Ids aren't reused, so results of the previous route can't be mistaken for new ones
+  EXPECT_NE(manager.start(2U, PlannerType::LANE), third);
+}
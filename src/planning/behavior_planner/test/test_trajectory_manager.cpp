@@ -0,0 +1,103 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gtest/gtest.h"
+#include "behavior_planner/trajectory_manager.hpp"
+
+using autoware::behavior_planner::PlannerConfig;
+using autoware::behavior_planner::State;
+using autoware::behavior_planner::Trajectory;
+using autoware::behavior_planner::TrajectoryManager;
+using autoware::behavior_planner::TrajectoryPoint;
+using autoware::common::types::float32_t;
+
+namespace
+{
+PlannerConfig make_config()
+{
+  PlannerConfig config;
+  config.goal_distance_thresh = 0.5f;
+  config.stop_velocity_thresh = 0.1f;
+  config.heading_weight = 0.1f;
+  config.subroute_goal_offset_lane2parking = 0.0f;
+  config.subroute_goal_offset_parking2lane = 0.0f;
+  config.cg_to_vehicle_center = 0.0f;
+  return config;
+}
+
+State make_state(const float32_t x, const float32_t velocity)
+{
+  State state;
+  state.state.x = x;
+  state.state.longitudinal_velocity_mps = velocity;
+  return state;
+}
+
+// 15 points forward along x and 15 points back in reverse
+Trajectory make_trajectory()
+{
+  Trajectory trajectory;
+  for (size_t i = 0; i < 15; i++) {
+    TrajectoryPoint pt;
+    pt.x = static_cast<float32_t>(i);
+    pt.longitudinal_velocity_mps = 1.0f;
+    trajectory.points.push_back(pt);
+  }
+  for (size_t i = 0; i < 15; i++) {
+    TrajectoryPoint pt;
+    pt.x = static_cast<float32_t>(14 - i);
+    pt.longitudinal_velocity_mps = -1.0f;
+    trajectory.points.push_back(pt);
+  }
+  trajectory.points.back().longitudinal_velocity_mps = 0.0f;
+  return trajectory;
+}
+}  // namespace
+
+TEST(TestTrajectoryManager, RemainingLengthFollowsVehicle)
+{
+  TrajectoryManager manager{make_config()};
+  manager.set_trajectory(make_trajectory());
+  ASSERT_TRUE(manager.is_trajectory_ready());
+  EXPECT_EQ(manager.get_remaining_length(make_state(0.0f, 1.0f)), 30U);
+  EXPECT_EQ(manager.get_remaining_length(make_state(5.0f, 1.0f)), 25U);
+  EXPECT_EQ(manager.get_remaining_length(make_state(12.0f, 1.0f)), 18U);
+  // The vehicle doesn't move backward along a sub trajectory, e.g. on a localization jump
+  EXPECT_EQ(manager.get_remaining_length(make_state(2.0f, 1.0f)), 18U);
+}
+
+TEST(TestTrajectoryManager, CursorCatchesUp)
+{
+  TrajectoryManager manager{make_config()};
+  manager.set_trajectory(make_trajectory());
+  // Further ahead than one search window
+  EXPECT_EQ(manager.get_remaining_length(make_state(13.0f, 1.0f)), 21U);
+  EXPECT_EQ(manager.get_remaining_length(make_state(13.0f, 1.0f)), 17U);
+}
+
+TEST(TestTrajectoryManager, SelectsNextSubTrajectory)
+{
+  TrajectoryManager manager{make_config()};
+  manager.set_trajectory(make_trajectory());
+  EXPECT_FLOAT_EQ(manager.get_upcoming_velocity(make_state(10.0f, 1.0f)), 1.0f);
+  // Stopped at the end of the forward part
+  const auto stopped = make_state(14.0f, 0.0f);
+  EXPECT_FLOAT_EQ(manager.get_upcoming_velocity(stopped), -1.0f);
+  EXPECT_EQ(manager.get_remaining_length(stopped), 15U);
+  const auto trajectory = manager.get_trajectory(make_state(10.0f, -1.0f));
+  ASSERT_FALSE(trajectory.points.empty());
+  EXPECT_FLOAT_EQ(trajectory.points.front().longitudinal_velocity_mps, -1.0f);
+  // Only the last point, which stops, is left
+  EXPECT_FLOAT_EQ(manager.get_upcoming_velocity(make_state(0.0f, -1.0f)), 0.0f);
+}
@@ -37,6 +37,7 @@
 #include <autoware_auto_msgs/srv/had_map_service.hpp>
 #include <autoware_auto_msgs/srv/modify_trajectory.hpp>
 #include <behavior_planner/behavior_planner.hpp>
+#include <startup_tracking/startup_tracker.hpp>
 
 //  Other ROS packages
 #include <lanelet2_core/LaneletMap.h>
@@ -46,6 +47,8 @@
 // others
 #include <string>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 namespace autoware
 {
@@ -63,6 +66,7 @@ using autoware_auto_msgs::msg::VehicleStateCommand;
 using autoware_auto_msgs::msg::VehicleStateReport;
 using State = autoware_auto_msgs::msg::VehicleKinematicState;
 using autoware::behavior_planner::PlannerType;
+using autoware::behavior_planner::RequestId;
 using autoware::behavior_planner::RouteWithType;
 
 using autoware::common::types::bool8_t;
@@ -75,11 +79,15 @@ using autoware::common::types::float64_t;
 class BEHAVIOR_PLANNER_NODES_PUBLIC BehaviorPlannerNode : public rclcpp::Node
 {
 public:
-  /// \brief default constructor, starts the planner
+  /// \brief default constructor, starts the planner. The topics are set up once the planners
+  ///        and services it depends on are available
   /// \param[in] options name of the node for rclcpp internals
   explicit BehaviorPlannerNode(const rclcpp::NodeOptions & options);
 
 private:
+  common::startup_tracking::StartupTracker m_startup_tracker;
+  common::startup_tracking::StartupGate m_startup_gate;
+
   //  ROS Interface
   rclcpp_action::Client<PlanTrajectoryAction>::SharedPtr m_lane_planner_client;
   rclcpp_action::Client<PlanTrajectoryAction>::SharedPtr m_parking_planner_client;
@@ -106,8 +114,19 @@ private:
   State m_ego_state;
   uchar8_t m_current_gear;
 
-  // bools to manage states
-  bool8_t m_requesting_trajectory;
+  // trajectory requests to the planners that are in flight
+  struct PendingGoal
+  {
+    rclcpp_action::Client<PlanTrajectoryAction>::SharedPtr client;
+    PlanTrajectoryGoalHandle::SharedPtr goal_handle;
+  };
+  behavior_planner::RequestManager m_requests;
+  // goal handles of the accepted requests, to cancel them when they are preempted
+  std::unordered_map<RequestId, PendingGoal> m_pending_goals;
+  // result of the request for the next subroute, which is planned while the current one is driven
+  Trajectory m_next_subroute_trajectory;
+  std::size_t m_next_subroute{0U};
+  bool8_t m_has_next_subroute_trajectory{false};
 
   // transforms
   std::shared_ptr<tf2_ros::Buffer> m_tf_buffer;
@@ -123,17 +142,29 @@ private:
   void modify_trajectory_response(rclcpp::Client<ModifyTrajectory>::SharedFuture future);
   void clear_trajectory_cache();
 
-  void goal_response_callback(std::shared_future<PlanTrajectoryGoalHandle::SharedPtr> future);
+  void goal_response_callback(
+    RequestId id,
+    const rclcpp_action::Client<PlanTrajectoryAction>::SharedPtr & client,
+    std::shared_future<PlanTrajectoryGoalHandle::SharedPtr> future);
   void feedback_callback(
     PlanTrajectoryGoalHandle::SharedPtr goal_handle,
     const std::shared_ptr<const PlanTrajectoryAction::Feedback> feedback);
-  void result_callback(const PlanTrajectoryGoalHandle::WrappedResult & result);
+  void result_callback(
+    RequestId id, std::size_t subroute,
+    const PlanTrajectoryGoalHandle::WrappedResult & result);
 
   // other functions
   void init();
+  /// \brief Set up the subscriptions and publishers, once the dependencies are available
+  void init_topics();
   Trajectory refine_trajectory(const State & ego_state, const Trajectory & input);
   State transform_to_map(const State & state);
-  void request_trajectory(const RouteWithType & route_with_type);
+  /// \brief Send a trajectory request unless the planner is still busy with another one
+  void request_trajectory(const RouteWithType & route_with_type, std::size_t subroute);
+  /// \brief Request the lane trajectory of the next subroute ahead of time, so that the vehicle
+  ///        can go on right away when it arrives at the goal of the current subroute
+  void request_next_subroute_trajectory();
+  void cancel_requests(const std::vector<RequestId> & ids);
 };
 }  // namespace behavior_planner_nodes
 }  // namespace autoware
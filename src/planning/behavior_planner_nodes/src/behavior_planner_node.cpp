@@ -35,9 +35,6 @@ BehaviorPlannerNode::BehaviorPlannerNode(const rclcpp::NodeOptions & options)
 
 void BehaviorPlannerNode::init()
 {
-  using rclcpp::QoS;
-  using namespace std::chrono_literals;
-
   // Setup planner
   const auto cg_to_front_m =
     static_cast<float32_t>(declare_parameter("vehicle.cg_to_front_m").get<float64_t>());
@@ -81,45 +78,26 @@ void BehaviorPlannerNode::init()
     this->get_node_waitables_interface(),
     "plan_parking_trajectory");
 
-  // wait until action clients are ready
-  while (!m_lane_planner_client->wait_for_action_server(1s)) {
-    if (!rclcpp::ok()) {
-      RCLCPP_ERROR(get_logger(), "Interrupted while waiting for action server.");
-      rclcpp::shutdown();
-      return;
-    }
-    RCLCPP_INFO(get_logger(), "Waiting for action server...");
-  }
-  while (!m_parking_planner_client->wait_for_action_server(1s)) {
-    if (!rclcpp::ok()) {
-      RCLCPP_ERROR(get_logger(), "Interrupted while waiting for action server.");
-      rclcpp::shutdown();
-      return;
-    }
-    RCLCPP_INFO(get_logger(), "Waiting for action server...");
-  }
-
   m_map_client = this->create_client<HADMapService>("HAD_Map_Service");
-  while (!m_map_client->wait_for_service(1s)) {
-    if (!rclcpp::ok()) {
-      RCLCPP_ERROR(get_logger(), "Interrupted while waiting for service.");
-      rclcpp::shutdown();
-      return;
-    }
-    RCLCPP_INFO(get_logger(), "Waiting for service...");
-  }
 
+  // The planners and services are waited for at the same time, while the node spins. The
+  // topics are only set up once all of them are available.
+  m_startup_gate.require(
+    "lane_planner", [this]() {return m_lane_planner_client->action_server_is_ready();});
+  m_startup_gate.require(
+    "parking_planner", [this]() {return m_parking_planner_client->action_server_is_ready();});
+  m_startup_gate.require("map_service", [this]() {return m_map_client->service_is_ready();});
   if (declare_parameter("enable_object_collision_estimator").get<bool>()) {
     m_modify_trajectory_client = this->create_client<ModifyTrajectory>("estimate_collision");
-    while (!m_modify_trajectory_client->wait_for_service(1s)) {
-      if (!rclcpp::ok()) {
-        RCLCPP_ERROR(get_logger(), "Interrupted while waiting for service.");
-        rclcpp::shutdown();
-        return;
-      }
-      RCLCPP_INFO(get_logger(), "Waiting for service...");
-    }
+    m_startup_gate.require(
+      "collision_estimator", [this]() {return m_modify_trajectory_client->service_is_ready();});
   }
+  m_startup_gate.open_when_ready([this]() {init_topics();});
+}
+
+void BehaviorPlannerNode::init_topics()
+{
+  using rclcpp::QoS;
 
   // Setup subscribers
   m_ego_state_sub = this->create_subscription<State>(
@@ -146,15 +124,23 @@ void BehaviorPlannerNode::init()
 }
 
 void BehaviorPlannerNode::goal_response_callback(
+  const RequestId id,
+  const rclcpp_action::Client<PlanTrajectoryAction>::SharedPtr & client,
   std::shared_future<PlanTrajectoryGoalHandle::SharedPtr> future)
 {
-  if (!future.get()) {
+  const auto goal_handle = future.get();
+  if (!goal_handle) {
     RCLCPP_ERROR(get_logger(), "Goal was rejected by server");
+    // the trajectory is requested again on the next state if it is still needed
+    m_requests.finish(id);
     return;
-  } else {
-    // start requesting trajectory
-    m_requesting_trajectory = true;
   }
+  if (!m_requests.is_pending(id)) {
+    // preempted before the planner accepted it
+    client->async_cancel_goal(goal_handle);
+    return;
+  }
+  m_pending_goals[id] = PendingGoal{client, goal_handle};
 }
 
 void BehaviorPlannerNode::feedback_callback(
@@ -167,8 +153,16 @@ void BehaviorPlannerNode::feedback_callback(
   (void) feedback;
 }
 
-void BehaviorPlannerNode::result_callback(const PlanTrajectoryGoalHandle::WrappedResult & result)
+void BehaviorPlannerNode::result_callback(
+  const RequestId id, const std::size_t subroute,
+  const PlanTrajectoryGoalHandle::WrappedResult & result)
 {
+  m_pending_goals.erase(id);
+  if (!m_requests.finish(id)) {
+    RCLCPP_INFO(get_logger(), "Dropped trajectory of a preempted request");
+    return;
+  }
+
   if (result.result->result == PlanTrajectoryAction::Result::SUCCESS &&
     !result.result->trajectory.points.empty())
   {
@@ -181,10 +175,14 @@ void BehaviorPlannerNode::result_callback(const PlanTrajectoryGoalHandle::Wrappe
   trajectory.header.frame_id = "map";
   m_debug_trajectory_pub->publish(trajectory);
 
-  m_planner->set_trajectory(result.result->trajectory);
-
-  // finished requesting trajectory
-  m_requesting_trajectory = false;
+  if (subroute == m_planner->get_current_subroute_index()) {
+    m_planner->set_trajectory(result.result->trajectory);
+  } else {
+    // planned ahead, used when the vehicle arrives at the subroute
+    m_next_subroute_trajectory = result.result->trajectory;
+    m_next_subroute = subroute;
+    m_has_next_subroute_trajectory = true;
+  }
 }
 
 State BehaviorPlannerNode::transform_to_map(const State & state)
@@ -207,7 +205,9 @@ State BehaviorPlannerNode::transform_to_map(const State & state)
   return transformed_state;
 }
 
-void BehaviorPlannerNode::request_trajectory(const RouteWithType & route_with_type)
+void BehaviorPlannerNode::request_trajectory(
+  const RouteWithType & route_with_type,
+  const std::size_t subroute)
 {
   using std::placeholders::_1;
   using std::placeholders::_2;
@@ -215,29 +215,44 @@ void BehaviorPlannerNode::request_trajectory(const RouteWithType & route_with_ty
   const auto & route = route_with_type.route;
   const auto & planner_type = route_with_type.planner_type;
 
+  rclcpp_action::Client<PlanTrajectoryAction>::SharedPtr client;
+  switch (planner_type) {
+    case behavior_planner::PlannerType::LANE:
+      client = m_lane_planner_client;
+      break;
+    case behavior_planner::PlannerType::PARKING:
+      client = m_parking_planner_client;
+      break;
+    default:
+      return;
+  }
+  // planners reject goals while they are planning
+  if (m_requests.is_planner_busy(planner_type)) {
+    return;
+  }
+  const auto id = m_requests.start(subroute, planner_type);
+
   auto action_goal = PlanTrajectoryAction::Goal();
   action_goal.sub_route = route;
 
   auto send_goal_options = rclcpp_action::Client<PlanTrajectoryAction>::SendGoalOptions();
-  send_goal_options.goal_response_callback = std::bind(
-    &BehaviorPlannerNode::goal_response_callback,
-    this, _1);
+  send_goal_options.goal_response_callback =
+    [this, id, client](std::shared_future<PlanTrajectoryGoalHandle::SharedPtr> future) {
+      goal_response_callback(id, client, future);
+    };
   send_goal_options.feedback_callback = std::bind(
     &BehaviorPlannerNode::feedback_callback, this, _1,
     _2);
-  send_goal_options.result_callback = std::bind(&BehaviorPlannerNode::result_callback, this, _1);
-
-  switch (planner_type) {
-    case behavior_planner::PlannerType::LANE:
-      m_lane_planner_client->async_send_goal(action_goal, send_goal_options);
-      RCLCPP_INFO(get_logger(), "Sent lane trajectory action goal");
-      break;
-    case behavior_planner::PlannerType::PARKING:
-      m_parking_planner_client->async_send_goal(action_goal, send_goal_options);
-      RCLCPP_INFO(get_logger(), "Sent parking trajectory action goal");
-      break;
-    default:
-      break;
+  send_goal_options.result_callback =
+    [this, id, subroute](const PlanTrajectoryGoalHandle::WrappedResult & result) {
+      result_callback(id, subroute, result);
+    };
+
+  client->async_send_goal(action_goal, send_goal_options);
+  if (planner_type == behavior_planner::PlannerType::LANE) {
+    RCLCPP_INFO(get_logger(), "Sent lane trajectory action goal for subroute %zu", subroute);
+  } else {
+    RCLCPP_INFO(get_logger(), "Sent parking trajectory action goal for subroute %zu", subroute);
   }
   m_debug_subroute_pub->publish(route);
 }
@@ -260,27 +275,37 @@ void BehaviorPlannerNode::on_ego_state(const State::SharedPtr & msg)
   // check if we need new trajectory
   // make sure we are not requesting trajectory if we already have
   static auto previous_output_arrived_goal = std::chrono::system_clock::now();
-  if (!m_requesting_trajectory) {
-    if (m_planner->has_arrived_goal(m_ego_state)) {
-      // TODO(mitsudome-r): replace this with throttled output in foxy
-      const auto now = std::chrono::system_clock::now();
-      const auto throttle_time = std::chrono::duration<float64_t>(3);
-      if (now - previous_output_arrived_goal > throttle_time) {
-        RCLCPP_INFO(get_logger(), "Trying to change gear");
-        previous_output_arrived_goal = now;
-      }
-      RCLCPP_INFO_ONCE(get_logger(), "Reached goal. Wait for another route");
-    } else if (m_planner->has_arrived_subroute_goal(m_ego_state)) {
-      // send next subroute
-      m_planner->set_next_subroute();
-      request_trajectory(m_planner->get_current_subroute(m_ego_state));
-      m_requesting_trajectory = true;
-    } else if (m_planner->needs_new_trajectory(m_ego_state)) {
-      // update trajectory for current subroute
-      request_trajectory(m_planner->get_current_subroute(m_ego_state));
-      m_requesting_trajectory = true;
+  if (m_planner->has_arrived_goal(m_ego_state)) {
+    // TODO(mitsudome-r): replace this with throttled output in foxy
+    const auto now = std::chrono::system_clock::now();
+    const auto throttle_time = std::chrono::duration<float64_t>(3);
+    if (now - previous_output_arrived_goal > throttle_time) {
+      RCLCPP_INFO(get_logger(), "Trying to change gear");
+      previous_output_arrived_goal = now;
+    }
+    RCLCPP_INFO_ONCE(get_logger(), "Reached goal. Wait for another route");
+  } else if (m_planner->has_arrived_subroute_goal(m_ego_state)) {
+    // switch to next subroute, requests for the previous one are stale
+    m_planner->set_next_subroute();
+    const auto subroute = m_planner->get_current_subroute_index();
+    cancel_requests(m_requests.preempt_before(subroute));
+    if (m_has_next_subroute_trajectory && (m_next_subroute == subroute) &&
+      !m_next_subroute_trajectory.points.empty())
+    {
+      RCLCPP_INFO(get_logger(), "Using trajectory that was planned ahead");
+      m_planner->set_trajectory(m_next_subroute_trajectory);
+    } else if (!m_requests.has_request_for(subroute)) {
+      request_trajectory(m_planner->get_current_subroute(m_ego_state), subroute);
+    }
+    m_has_next_subroute_trajectory = false;
+  } else if (m_planner->needs_new_trajectory(m_ego_state)) {
+    // update trajectory for current subroute, unless it is already being planned
+    const auto subroute = m_planner->get_current_subroute_index();
+    if (!m_requests.has_request_for(subroute)) {
+      request_trajectory(m_planner->get_current_subroute(m_ego_state), subroute);
     }
   }
+  request_next_subroute_trajectory();
 
   if (!m_planner->is_trajectory_ready()) {
     return;
@@ -333,6 +358,41 @@ void BehaviorPlannerNode::on_ego_state(const State::SharedPtr & msg)
   }
 }
 
+void BehaviorPlannerNode::request_next_subroute_trajectory()
+{
+  const auto current_subroute = m_planner->get_current_subroute_index();
+  const auto next_subroute = current_subroute + 1U;
+  const auto & subroutes = m_planner->get_subroutes();
+  // only lane trajectories are planned ahead, the start of a lane subroute is known beforehand
+  if ((next_subroute >= subroutes.size()) ||
+    (subroutes[next_subroute].planner_type != PlannerType::LANE))
+  {
+    return;
+  }
+  // the current subroute goes first, and the next one is only requested once
+  if (!m_planner->is_trajectory_ready() || m_requests.has_request_for(current_subroute) ||
+    m_requests.has_request_for(next_subroute) ||
+    (m_has_next_subroute_trajectory && (m_next_subroute == next_subroute)))
+  {
+    return;
+  }
+  auto route_with_type = subroutes[next_subroute];
+  route_with_type.route.header = m_ego_state.header;
+  request_trajectory(route_with_type, next_subroute);
+}
+
+void BehaviorPlannerNode::cancel_requests(const std::vector<RequestId> & ids)
+{
+  for (const auto id : ids) {
+    // requests that weren't accepted yet are cancelled in goal_response_callback()
+    const auto it = m_pending_goals.find(id);
+    if (it != m_pending_goals.end()) {
+      it->second.client->async_cancel_goal(it->second.goal_handle);
+      m_pending_goals.erase(it);
+    }
+  }
+}
+
 void BehaviorPlannerNode::on_vehicle_state_report(const VehicleStateReport::SharedPtr & msg)
 {
   m_current_gear = msg->gear;
@@ -340,13 +400,6 @@ void BehaviorPlannerNode::on_vehicle_state_report(const VehicleStateReport::Shar
 
 void BehaviorPlannerNode::on_route(const HADMapRoute::SharedPtr & msg)
 {
-  if (m_requesting_trajectory) {
-    RCLCPP_ERROR(
-      get_logger(),
-      "Route was rejected. Route cannot be updated while communicating with trajectory planners.");
-    return;
-  }
-
   if (!m_planner->is_vehicle_stopped(m_ego_state)) {
     RCLCPP_ERROR(
       get_logger(), "Route was rejected. Route cannot be update while the vehicle is moving");
@@ -386,18 +439,21 @@ void BehaviorPlannerNode::modify_trajectory_response(
 
 void BehaviorPlannerNode::map_response(rclcpp::Client<HADMapService>::SharedFuture future)
 {
-  m_lanelet_map_ptr = std::make_shared<lanelet::LaneletMap>();
-  autoware::common::had_map_utils::fromBinaryMsg(future.get()->map, m_lanelet_map_ptr);
+  m_lanelet_map_ptr = autoware::common::had_map_utils::fromBinaryMsgShared(future.get()->map);
 
   RCLCPP_INFO(get_logger(), "Received map");
 
+  // requests for the previous route are stale
+  cancel_requests(m_requests.preempt_all());
+  m_has_next_subroute_trajectory = false;
+
   // TODO(mitsudome-r) move to handle_accepted() when synchronous service is available
   m_planner->set_route(*m_route, m_lanelet_map_ptr);
 
-  const auto subroutes = m_planner->get_subroutes();
+  const auto & subroutes = m_planner->get_subroutes();
   Trajectory checkpoints;
   checkpoints.header.frame_id = "map";
-  for (const auto subroute : subroutes) {
+  for (const auto & subroute : subroutes) {
     TrajectoryPoint trajectory_start_point;
     trajectory_start_point.x = static_cast<float32_t>(subroute.route.start_point.position.x);
     trajectory_start_point.y = static_cast<float32_t>(subroute.route.start_point.position.y);
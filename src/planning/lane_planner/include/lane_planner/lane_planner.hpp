@@ -19,6 +19,7 @@
 #ifndef LANE_PLANNER__LANE_PLANNER_HPP_
 #define LANE_PLANNER__LANE_PLANNER_HPP_
 
+#include <lane_planner/route_segment_index.hpp>
 #include <lane_planner/visibility_control.hpp>
 
 #include <autoware_auto_msgs/msg/vehicle_kinematic_state.hpp>
@@ -31,6 +32,7 @@
 
 #include <lanelet2_core/LaneletMap.h>
 #include <lanelet2_core/primitives/Point.h>
+#include <lanelet2_traffic_rules/TrafficRules.h>
 
 #include <iostream>
 #include <vector>
@@ -90,6 +92,20 @@ private:
   LanePlannerConfig m_planner_config;
 
   TrajectorySmoother m_trajectory_smoother;
+  lanelet::traffic_rules::TrafficRulesPtr m_traffic_rules;
+
+  // Lanelets of the previously planned route, and the range of them the trajectory covered
+  std::vector<lanelet::Id> m_route_lanelet_ids{};
+  size_t m_route_start_index{0U};
+  size_t m_route_end_index{0U};
+  // Index of the centerlines of the previously planned route, and the map it was built from
+  RouteSegmentIndex m_route_index{};
+  LaneletMapConstPtr m_route_map{};
+
+  size_t get_start_lanelet(
+    const lanelet::ConstLanelets & lanelets,
+    const LaneletMapConstPtr & map,
+    const TrajectoryPoint & start_point);
 
   // trajectory planning sub functions
   TrajectoryPoints generate_base_trajectory(
@@ -0,0 +1,100 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \copyright Copyright 2021 The Autoware Foundation
+/// \file
+/// \brief This file defines the RouteSegmentIndex class.
+
+#ifndef LANE_PLANNER__ROUTE_SEGMENT_INDEX_HPP_
+#define LANE_PLANNER__ROUTE_SEGMENT_INDEX_HPP_
+
+#include <lane_planner/visibility_control.hpp>
+
+#include <common/types.hpp>
+
+#include <lanelet2_core/LaneletMap.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace autoware
+{
+namespace lane_planner
+{
+using autoware::common::types::bool8_t;
+using autoware::common::types::float64_t;
+
+/// \brief A static 2D grid over the centerline segments of the lanelets of a route, to find the
+///        lanelet whose centerline is closest to a point without checking all of them
+class LANE_PLANNER_PUBLIC RouteSegmentIndex
+{
+public:
+  /// The default cell size, in the order of the length of the centerline segments
+  static constexpr float64_t DEFAULT_CELL_SIZE_M = 10.0;
+
+  /// \brief Constructor of an empty index
+  RouteSegmentIndex() = default;
+
+  /// \brief Constructor, indexes the 2D centerlines of the lanelets
+  /// \param[in] lanelets The lanelets of the route
+  /// \param[in] cell_size The size of the grid cells in meters, it is increased for large routes
+  ///            to bound the number of cells
+  /// \throw std::domain_error If the cell size isn't positive and finite
+  explicit RouteSegmentIndex(
+    const lanelet::ConstLanelets & lanelets,
+    float64_t cell_size = DEFAULT_CELL_SIZE_M);
+
+  /// \brief Find the lanelet whose centerline is closest to a point, the first one of the route
+  ///        if several are equally close
+  /// \param[in] point The point
+  /// \return The index of the lanelet in the route, or the number of lanelets of the route if it
+  ///         has no centerline points
+  std::size_t closest_lanelet(const lanelet::BasicPoint2d & point) const;
+
+  /// \brief Whether the index has no segments
+  bool8_t empty() const noexcept;
+
+private:
+  // Plain coordinates rather than Eigen types, which need an aligned allocator in a vector
+  struct Segment
+  {
+    float64_t start_x;
+    float64_t start_y;
+    float64_t end_x;
+    float64_t end_y;
+    std::size_t lanelet_index;
+  };
+
+  /// Update the closest lanelet with a segment, the lanelet that comes first wins ties
+  void check_segment(
+    const Segment & segment, const lanelet::BasicPoint2d & point,
+    float64_t & best_distance, std::size_t & best_lanelet) const;
+
+  std::vector<Segment> m_segments{};
+  std::size_t m_num_lanelets{0U};
+  // The segments of the cells in row major order, cell i holds the segments from m_cell_begin[i]
+  // to m_cell_begin[i + 1] in m_cell_segments
+  std::vector<std::size_t> m_cell_begin{};
+  std::vector<uint32_t> m_cell_segments{};
+  float64_t m_min_x{0.0};
+  float64_t m_min_y{0.0};
+  float64_t m_cell_size{DEFAULT_CELL_SIZE_M};
+  std::size_t m_num_cols{0U};
+  std::size_t m_num_rows{0U};
+};
+}  // namespace lane_planner
+}  // namespace autoware
+
+#endif  // LANE_PLANNER__ROUTE_SEGMENT_INDEX_HPP_
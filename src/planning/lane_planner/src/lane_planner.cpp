@@ -21,6 +21,8 @@
 #include <geometry/common_2d.hpp>
 #include <limits>
 #include <algorithm>
+#include <utility>
+#include <vector>
 
 namespace autoware
 {
@@ -49,34 +51,66 @@ float32_t calculate_curvature(
   return curvature;
 }
 
-size_t get_closest_lanelet(const lanelet::ConstLanelets & lanelets, const TrajectoryPoint & point)
-{
-  float64_t closest_distance = std::numeric_limits<float64_t>::max();
-  size_t closest_index = 0;
-  for (size_t i = 0; i < lanelets.size(); i++) {
-    const auto & llt = lanelets.at(i);
-    const auto & point2d = lanelet::Point2d(lanelet::InvalId, point.x, point.y).basicPoint2d();
-    // TODO(mitsudome-r): change this implementation to remove dependency to boost
-    const float64_t distance = lanelet::geometry::distanceToCenterline2d(llt, point2d);
-    if (distance < closest_distance) {
-      closest_distance = distance;
-      closest_index = i;
-    }
-  }
-  return closest_index;
-}
-
-
 LanePlanner::LanePlanner(
   const VehicleConfig & vehicle_param,
   const TrajectorySmootherConfig & config,
   const LanePlannerConfig & planner_config)
 : m_vehicle_param(vehicle_param),
   m_planner_config(planner_config),
-  m_trajectory_smoother(config)
+  m_trajectory_smoother(config),
+  // using Germany Location since it is default location for Lanelet2
+  // TODO(mitsudome-r): create define default location for Autoware
+  m_traffic_rules(lanelet::traffic_rules::TrafficRulesFactory::create(
+      lanelet::Locations::Germany,
+      lanelet::Participants::Vehicle))
 {
 }
 
+size_t LanePlanner::get_start_lanelet(
+  const lanelet::ConstLanelets & lanelets,
+  const LaneletMapConstPtr & map,
+  const TrajectoryPoint & start_point)
+{
+  std::vector<lanelet::Id> route_lanelet_ids;
+  route_lanelet_ids.reserve(lanelets.size());
+  for (const auto & llt : lanelets) {
+    route_lanelet_ids.push_back(llt.id());
+  }
+
+  const lanelet::BasicPoint2d point2d =
+    lanelet::Point2d(lanelet::InvalId, start_point.x, start_point.y).basicPoint2d();
+
+  // On the same route, the start point only moves within the lanelets covered by the previous
+  // trajectory, whose number does not depend on the length of the route
+  if ((route_lanelet_ids == m_route_lanelet_ids) && (m_route_end_index < lanelets.size())) {
+    float64_t closest_distance = std::numeric_limits<float64_t>::max();
+    size_t closest_index = lanelets.size();
+    for (size_t i = m_route_start_index; i <= m_route_end_index; i++) {
+      const auto & llt = lanelets.at(i);
+      if (lanelet::geometry::inside(llt, point2d)) {
+        const float64_t distance = lanelet::geometry::distanceToCenterline2d(llt, point2d);
+        if (distance < closest_distance) {
+          closest_distance = distance;
+          closest_index = i;
+        }
+      }
+    }
+    if (closest_index < lanelets.size()) {
+      return closest_index;
+    }
+  }
+
+  // Otherwise from the closest centerline of the whole route, which is indexed once per route
+  // and map, so that it does not cost a check of every segment of the route
+  if ((route_lanelet_ids != m_route_lanelet_ids) || (map != m_route_map) || m_route_index.empty()) {
+    m_route_index = RouteSegmentIndex{lanelets};
+    m_route_map = map;
+    m_route_lanelet_ids = std::move(route_lanelet_ids);
+  }
+  const auto closest_index = m_route_index.closest_lanelet(point2d);
+  return (closest_index < lanelets.size()) ? closest_index : 0U;
+}
+
 autoware_auto_msgs::msg::TrajectoryPoint convertToTrajectoryPoint(
   const lanelet::ConstPoint3d & pt,
   const float32_t velocity)
@@ -163,26 +197,30 @@ TrajectoryPoints LanePlanner::generate_base_trajectory(
   trajectory_goal_point.y = static_cast<float32_t>(had_map_route.goal_point.position.y);
   trajectory_goal_point.heading = had_map_route.goal_point.heading;
 
-  const auto start_index = get_closest_lanelet(lanelets, trajectory_start_point);
+  const auto start_index = get_start_lanelet(lanelets, map, trajectory_start_point);
 
   TrajectoryPoints trajectory_points;
 
-  // using Germany Location since it is default location for Lanelet2
-  // TODO(mitsudome-r): create define default location for Autoware
-  lanelet::traffic_rules::TrafficRulesPtr traffic_rules_ptr =
-    lanelet::traffic_rules::TrafficRulesFactory::create(
-    lanelet::Locations::Germany,
-    lanelet::Participants::Vehicle);
+  // The trajectory is cut to its capacity, the point after the last one is still needed for its
+  // heading and steering angle. Lanelets beyond are not visited, so that planning does not
+  // depend on the length of the route.
+  const auto max_num_points = static_cast<size_t>(Trajectory::CAPACITY) + 1U;
 
   // set position and velocity
   trajectory_points.push_back(trajectory_start_point);
-  for (size_t i = start_index; i < lanelets.size(); i++) {
+  m_route_start_index = start_index;
+  m_route_end_index = start_index;
+  for (size_t i = start_index;
+    (i < lanelets.size()) && (trajectory_points.size() < max_num_points); i++)
+  {
     const auto & lanelet = lanelets.at(i);
-    const auto & centerline = autoware::common::had_map_utils::generateFineCenterline(
+    // shared with the other users of the lanelet in the process, generated once per lanelet
+    const auto centerline = autoware::common::had_map_utils::getFineCenterline(
       lanelet,
       m_planner_config.trajectory_resolution);
     const auto speed_limit =
-      static_cast<float32_t>(traffic_rules_ptr->speedLimit(lanelet).speedLimit.value());
+      static_cast<float32_t>(m_traffic_rules->speedLimit(lanelet).speedLimit.value());
+    m_route_end_index = i;
 
     float64_t start_length = 0;
     if (i == start_index) {
@@ -199,7 +237,9 @@ TrajectoryPoints LanePlanner::generate_base_trajectory(
 
     float64_t accumulated_length = 0;
     // skip first point to avoid inserting overlaps
-    for (size_t j = 1; j < centerline.size(); j++) {
+    for (size_t j = 1; (j < centerline.size()) && (trajectory_points.size() < max_num_points);
+      j++)
+    {
       const auto llt_prev_pt = centerline[j - 1];
       const auto llt_pt = centerline[j];
       accumulated_length += lanelet::geometry::distance2d(to2D(llt_prev_pt), to2D(llt_pt));
@@ -208,7 +248,9 @@ TrajectoryPoints LanePlanner::generate_base_trajectory(
       trajectory_points.push_back(convertToTrajectoryPoint(llt_pt, speed_limit));
     }
   }
-  trajectory_points.push_back(trajectory_goal_point);
+  if (trajectory_points.size() < max_num_points) {
+    trajectory_points.push_back(trajectory_goal_point);
+  }
   return trajectory_points;
 }
 
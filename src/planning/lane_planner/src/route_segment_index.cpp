@@ -0,0 +1,211 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lane_planner/route_segment_index.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace autoware
+{
+namespace lane_planner
+{
+namespace
+{
+/// The number of cells is bounded by this many per segment, but at least MIN_MAX_CELLS
+constexpr std::size_t MAX_CELLS_PER_SEGMENT = 4U;
+constexpr std::size_t MIN_MAX_CELLS = 1024U;
+
+std::size_t to_cell(const float64_t coordinate, const float64_t min, const float64_t cell_size)
+{
+  return static_cast<std::size_t>(std::floor((coordinate - min) / cell_size));
+}
+}  // namespace
+
+constexpr float64_t RouteSegmentIndex::DEFAULT_CELL_SIZE_M;
+
+RouteSegmentIndex::RouteSegmentIndex(
+  const lanelet::ConstLanelets & lanelets,
+  const float64_t cell_size)
+: m_num_lanelets{lanelets.size()},
+  m_cell_size{cell_size}
+{
+  if (!std::isfinite(cell_size) || (cell_size <= 0.0)) {
+    throw std::domain_error{"RouteSegmentIndex: the cell size must be positive"};
+  }
+
+  for (std::size_t i = 0U; i < lanelets.size(); ++i) {
+    const auto centerline = lanelets[i].centerline2d();
+    if (centerline.size() == 1U) {
+      const auto & point = centerline[0U];
+      m_segments.push_back({point.x(), point.y(), point.x(), point.y(), i});
+    }
+    for (std::size_t j = 1U; j < centerline.size(); ++j) {
+      const auto & start = centerline[j - 1U];
+      const auto & end = centerline[j];
+      m_segments.push_back({start.x(), start.y(), end.x(), end.y(), i});
+    }
+  }
+  if (m_segments.empty()) {
+    return;
+  }
+  if (m_segments.size() > static_cast<std::size_t>(std::numeric_limits<uint32_t>::max())) {
+    throw std::domain_error{"RouteSegmentIndex: too many centerline segments"};
+  }
+
+  m_min_x = std::numeric_limits<float64_t>::max();
+  m_min_y = std::numeric_limits<float64_t>::max();
+  auto max_x = std::numeric_limits<float64_t>::lowest();
+  auto max_y = std::numeric_limits<float64_t>::lowest();
+  for (const auto & segment : m_segments) {
+    m_min_x = std::min({m_min_x, segment.start_x, segment.end_x});
+    m_min_y = std::min({m_min_y, segment.start_y, segment.end_y});
+    max_x = std::max({max_x, segment.start_x, segment.end_x});
+    max_y = std::max({max_y, segment.start_y, segment.end_y});
+  }
+
+  // Coarsen the grid of routes that are large compared to their number of segments
+  const auto max_cells = std::max(MAX_CELLS_PER_SEGMENT * m_segments.size(), MIN_MAX_CELLS);
+  while (true) {
+    m_num_cols = to_cell(max_x, m_min_x, m_cell_size) + 1U;
+    m_num_rows = to_cell(max_y, m_min_y, m_cell_size) + 1U;
+    if ((m_num_cols <= max_cells) && (m_num_rows <= max_cells / m_num_cols)) {
+      break;
+    }
+    m_cell_size *= 2.0;
+  }
+
+  // Each segment goes into all cells of its bounding box, counted first and then filled in
+  const auto for_each_cell = [this](const Segment & segment, auto && function) {
+      const auto col_begin =
+        to_cell(std::min(segment.start_x, segment.end_x), m_min_x, m_cell_size);
+      const auto col_end = to_cell(std::max(segment.start_x, segment.end_x), m_min_x, m_cell_size);
+      const auto row_begin =
+        to_cell(std::min(segment.start_y, segment.end_y), m_min_y, m_cell_size);
+      const auto row_end = to_cell(std::max(segment.start_y, segment.end_y), m_min_y, m_cell_size);
+      for (auto row = row_begin; row <= row_end; ++row) {
+        for (auto col = col_begin; col <= col_end; ++col) {
+          function((row * m_num_cols) + col);
+        }
+      }
+    };
+  m_cell_begin.assign((m_num_cols * m_num_rows) + 1U, 0U);
+  for (const auto & segment : m_segments) {
+    for_each_cell(segment, [this](const std::size_t cell) {++m_cell_begin[cell + 1U];});
+  }
+  for (std::size_t cell = 1U; cell < m_cell_begin.size(); ++cell) {
+    m_cell_begin[cell] += m_cell_begin[cell - 1U];
+  }
+  m_cell_segments.resize(m_cell_begin.back());
+  std::vector<std::size_t> cell_end{m_cell_begin.begin(), m_cell_begin.end() - 1};
+  for (std::size_t i = 0U; i < m_segments.size(); ++i) {
+    for_each_cell(
+      m_segments[i], [this, i, &cell_end](const std::size_t cell) {
+        m_cell_segments[cell_end[cell]++] = static_cast<uint32_t>(i);
+      });
+  }
+}
+
+std::size_t RouteSegmentIndex::closest_lanelet(const lanelet::BasicPoint2d & point) const
+{
+  auto best_distance = std::numeric_limits<float64_t>::max();
+  auto best_lanelet = m_num_lanelets;
+  if (m_segments.empty()) {
+    return best_lanelet;
+  }
+
+  const auto col_coordinate = std::floor((point.x() - m_min_x) / m_cell_size);
+  const auto row_coordinate = std::floor((point.y() - m_min_y) / m_cell_size);
+  if ((col_coordinate < 0.0) || (row_coordinate < 0.0) ||
+    (col_coordinate >= static_cast<float64_t>(m_num_cols)) ||
+    (row_coordinate >= static_cast<float64_t>(m_num_rows)))
+  {
+    // Far from the route the rings would mostly be empty, check all segments instead
+    for (const auto & segment : m_segments) {
+      check_segment(segment, point, best_distance, best_lanelet);
+    }
+    return best_lanelet;
+  }
+
+  // Search rings of cells around the cell of the point. The cells outside of ring r are at least
+  // r cells away, so the search ends once the best segment is closer than that.
+  const auto col = static_cast<std::size_t>(col_coordinate);
+  const auto row = static_cast<std::size_t>(row_coordinate);
+  const auto max_ring = std::max(
+    {col, m_num_cols - 1U - col, row, m_num_rows - 1U - row});
+  const auto check_cell = [this, &point, &best_distance, &best_lanelet](
+    const std::size_t cell_row, const std::size_t cell_col) {
+      const auto cell = (cell_row * m_num_cols) + cell_col;
+      for (auto i = m_cell_begin[cell]; i < m_cell_begin[cell + 1U]; ++i) {
+        check_segment(m_segments[m_cell_segments[i]], point, best_distance, best_lanelet);
+      }
+    };
+  for (std::size_t ring = 0U; ring <= max_ring; ++ring) {
+    const auto row_begin = (row >= ring) ? (row - ring) : 0U;
+    const auto row_end = std::min(row + ring, m_num_rows - 1U);
+    const auto col_begin = (col >= ring) ? (col - ring) : 0U;
+    const auto col_end = std::min(col + ring, m_num_cols - 1U);
+    for (auto cell_row = row_begin; cell_row <= row_end; ++cell_row) {
+      const bool8_t full_row = (cell_row + ring == row) || (cell_row == row + ring);
+      if (full_row) {
+        for (auto cell_col = col_begin; cell_col <= col_end; ++cell_col) {
+          check_cell(cell_row, cell_col);
+        }
+      } else {
+        if (col >= ring) {
+          check_cell(cell_row, col - ring);
+        }
+        if (col + ring < m_num_cols) {
+          check_cell(cell_row, col + ring);
+        }
+      }
+    }
+    if (best_distance < (static_cast<float64_t>(ring) * m_cell_size)) {
+      break;
+    }
+  }
+  return best_lanelet;
+}
+
+bool8_t RouteSegmentIndex::empty() const noexcept
+{
+  return m_segments.empty();
+}
+
+void RouteSegmentIndex::check_segment(
+  const Segment & segment, const lanelet::BasicPoint2d & point,
+  float64_t & best_distance, std::size_t & best_lanelet) const
+{
+  const auto dx = segment.end_x - segment.start_x;
+  const auto dy = segment.end_y - segment.start_y;
+  const auto length2 = (dx * dx) + (dy * dy);
+  auto fraction = 0.0;
+  if (length2 > 0.0) {
+    fraction = (((point.x() - segment.start_x) * dx) + ((point.y() - segment.start_y) * dy)) /
+      length2;
+    fraction = std::min(std::max(fraction, 0.0), 1.0);
+  }
+  const auto distance = std::hypot(
+    segment.start_x + (fraction * dx) - point.x(), segment.start_y + (fraction * dy) - point.y());
+  if ((distance < best_distance) ||
+    ((distance == best_distance) && (segment.lanelet_index < best_lanelet)))
+  {
+    best_distance = distance;
+    best_lanelet = segment.lanelet_index;
+  }
+}
+}  // namespace lane_planner
+}  // namespace autoware
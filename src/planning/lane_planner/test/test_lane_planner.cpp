@@ -21,6 +21,7 @@
 using autoware_auto_msgs::msg::MapPrimitive;
 using autoware_auto_msgs::msg::HADMapRoute;
 using autoware_auto_msgs::msg::HADMapSegment;
+using autoware_auto_msgs::msg::Trajectory;
 using autoware_auto_msgs::msg::TrajectoryPoint;
 
 using motion::motion_common::VehicleConfig;
@@ -77,6 +78,11 @@ class LanePlannerTest : public ::testing::Test
 {
 public:
   LanePlannerTest()
+  {
+    m_planner_ptr = create_planner();
+  }
+
+  static std::shared_ptr<autoware::lane_planner::LanePlanner> create_planner()
   {
     const VehicleConfig vehicle_param{
       1.0F,  // cg_to_front_m:
@@ -96,7 +102,7 @@ public:
     const autoware::lane_planner::LanePlannerConfig planner_config{
       2.0F  // trajectory_resolution
     };
-    m_planner_ptr = std::make_shared<autoware::lane_planner::LanePlanner>(
+    return std::make_shared<autoware::lane_planner::LanePlanner>(
       vehicle_param, config,
       planner_config);
   }
@@ -188,3 +194,47 @@ TEST_F(LanePlannerTest, plan_invalid_route)
   // return trajectory should be empty if there is no valid lane
   ASSERT_TRUE(trajectory.points.empty());
 }
+
+TEST_F(LanePlannerTest, plan_long_route)
+{
+  // lane longer than the trajectory capacity with the resolution of 2 meters
+  const auto lane_id = lanelet::utils::getId();
+  constexpr float64_t velocity_mps = 1.0;
+  constexpr size_t n_points = 500;
+  const auto lanelet_map_ptr = getALaneletMapWithLaneId(lane_id, velocity_mps, n_points);
+  auto had_map_route = getARoute(lane_id, 499.0F);
+
+  const auto trajectory = m_planner_ptr->plan_trajectory(had_map_route, lanelet_map_ptr);
+  ASSERT_EQ(trajectory.points.size(), static_cast<size_t>(Trajectory::CAPACITY));
+
+  // replanning further along the same route gives the same trajectory as a new planner
+  had_map_route.start_point.position.y = 100.0;
+  const auto replanned = m_planner_ptr->plan_trajectory(had_map_route, lanelet_map_ptr);
+  const auto expected = create_planner()->plan_trajectory(had_map_route, lanelet_map_ptr);
+  ASSERT_EQ(replanned.points.size(), expected.points.size());
+  for (size_t i = 0; i < expected.points.size(); i++) {
+    EXPECT_FLOAT_EQ(replanned.points[i].x, expected.points[i].x);
+    EXPECT_FLOAT_EQ(replanned.points[i].y, expected.points[i].y);
+    EXPECT_FLOAT_EQ(
+      replanned.points[i].longitudinal_velocity_mps,
+      expected.points[i].longitudinal_velocity_mps);
+  }
+  EXPECT_FLOAT_EQ(replanned.points.front().y, 100.0F);
+}
+
+TEST_F(LanePlannerTest, plan_updated_map)
+{
+  // same lane ID in a new map with a longer lane
+  const auto lane_id = lanelet::utils::getId();
+  constexpr float64_t velocity_mps = 1.0;
+  const auto had_map_route = getARoute(lane_id, 19.0F);
+
+  const auto short_map_ptr = getALaneletMapWithLaneId(lane_id, velocity_mps, 10);
+  const auto short_trajectory = m_planner_ptr->plan_trajectory(had_map_route, short_map_ptr);
+  const auto long_map_ptr = getALaneletMapWithLaneId(lane_id, velocity_mps, 20);
+  const auto long_trajectory = m_planner_ptr->plan_trajectory(had_map_route, long_map_ptr);
+
+  // the centerline of the previous map is not reused
+  ASSERT_FALSE(short_trajectory.points.empty());
+  ASSERT_GT(long_trajectory.points.size(), short_trajectory.points.size());
+}
@@ -0,0 +1,106 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <lane_planner/route_segment_index.hpp>
+#include <lanelet2_core/LaneletMap.h>
+#include <lanelet2_core/geometry/Lanelet.h>
+#include <lanelet2_core/primitives/Lanelet.h>
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+#include "gtest/gtest.h"
+
+using autoware::lane_planner::RouteSegmentIndex;
+using autoware::common::types::float64_t;
+
+namespace
+{
+// A winding route of lanelets of 4 centerline segments of 2.5 meters each
+lanelet::ConstLanelets getAWindingRoute(const size_t n_lanelets)
+{
+  lanelet::ConstLanelets lanelets;
+  float64_t x = 0.0;
+  float64_t y = 0.0;
+  float64_t heading = 0.0;
+  for (size_t i = 0; i < n_lanelets; i++) {
+    lanelet::Points3d left_points, right_points, center_points;
+    for (size_t j = 0; j < 5; j++) {
+      if (j > 0) {
+        heading += 0.1 * std::sin(0.05 * static_cast<float64_t>(4 * i + j));
+        x += 2.5 * std::cos(heading);
+        y += 2.5 * std::sin(heading);
+      }
+      const auto dx = -std::sin(heading);
+      const auto dy = std::cos(heading);
+      left_points.push_back(lanelet::Point3d(lanelet::utils::getId(), x + dx, y + dy, 0));
+      right_points.push_back(lanelet::Point3d(lanelet::utils::getId(), x - dx, y - dy, 0));
+      center_points.push_back(lanelet::Point3d(lanelet::utils::getId(), x, y, 0));
+    }
+    lanelet::Lanelet ll(
+      lanelet::utils::getId(),
+      lanelet::LineString3d(lanelet::utils::getId(), left_points),
+      lanelet::LineString3d(lanelet::utils::getId(), right_points));
+    ll.setCenterline(lanelet::LineString3d(lanelet::utils::getId(), center_points));
+    lanelets.push_back(ll);
+  }
+  return lanelets;
+}
+}  // namespace
+
+TEST(TestRouteSegmentIndex, closest_lanelet)
+{
+  // a long route, and a small cell size so that the grid is coarsened
+  const auto lanelets = getAWindingRoute(600);
+  for (const auto cell_size : {RouteSegmentIndex::DEFAULT_CELL_SIZE_M, 0.1}) {
+    const RouteSegmentIndex index{lanelets, cell_size};
+    ASSERT_FALSE(index.empty());
+
+    // points on, next to and away from the route, some outside of the grid
+    std::mt19937 generator{42U};
+    std::uniform_int_distribution<size_t> lanelet_distribution{0U, lanelets.size() - 1U};
+    std::normal_distribution<float64_t> offset_distribution{0.0, 20.0};
+    for (size_t i = 0; i < 500; i++) {
+      const auto & centerline = lanelets.at(lanelet_distribution(generator)).centerline2d();
+      const lanelet::BasicPoint2d point{
+        centerline.front().x() + offset_distribution(generator),
+        centerline.front().y() + offset_distribution(generator)};
+
+      float64_t expected_distance = std::numeric_limits<float64_t>::max();
+      for (const auto & llt : lanelets) {
+        expected_distance =
+          std::min(expected_distance, lanelet::geometry::distanceToCenterline2d(llt, point));
+      }
+      const auto closest = index.closest_lanelet(point);
+      ASSERT_LT(closest, lanelets.size());
+      EXPECT_NEAR(
+        lanelet::geometry::distanceToCenterline2d(lanelets.at(closest), point),
+        expected_distance, 1.0e-9);
+    }
+  }
+}
+
+TEST(TestRouteSegmentIndex, empty)
+{
+  const RouteSegmentIndex index{};
+  EXPECT_TRUE(index.empty());
+  EXPECT_EQ(index.closest_lanelet(lanelet::BasicPoint2d{1.0, 2.0}), 0U);
+
+  EXPECT_THROW(RouteSegmentIndex(getAWindingRoute(1), 0.0), std::domain_error);
+  EXPECT_THROW(
+    RouteSegmentIndex(getAWindingRoute(1), std::numeric_limits<float64_t>::quiet_NaN()),
+    std::domain_error);
+}
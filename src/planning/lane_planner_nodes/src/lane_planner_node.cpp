@@ -39,11 +39,20 @@ LanePlannerNode::LanePlannerNode(const rclcpp::NodeOptions & node_options)
     static_cast<Real>(declare_parameter("vehicle.front_overhang_m").get<float32_t>()),
     static_cast<Real>(declare_parameter("vehicle.rear_overhang_m").get<float32_t>())
   };
-  const TrajectorySmootherConfig config{
+  TrajectorySmootherConfig config{
     static_cast<float32_t>(
       declare_parameter("gaussian_smoother.standard_deviation").get<float64_t>()),
     static_cast<uint32_t>(declare_parameter("gaussian_smoother.kernel_size").get<uint64_t>())
   };
+  // Optional smoothing within acceleration and jerk limits instead of the gaussian filter
+  config.mode = motion::planning::trajectory_smoother::smoothing_mode_from_string(
+    declare_parameter("gaussian_smoother.mode", std::string{"gaussian"}));
+  config.max_acceleration_mps2 =
+    static_cast<float32_t>(declare_parameter("gaussian_smoother.max_acceleration_mps2", 1.0));
+  config.max_deceleration_mps2 =
+    static_cast<float32_t>(declare_parameter("gaussian_smoother.max_deceleration_mps2", 2.0));
+  config.max_jerk_mps3 =
+    static_cast<float32_t>(declare_parameter("gaussian_smoother.max_jerk_mps3", 1.0));
   const lane_planner::LanePlannerConfig planner_config{
     static_cast<float32_t>(
       declare_parameter("lane_planner.trajectory_resolution").get<float64_t>())
@@ -15,6 +15,7 @@
 #include <lane_planner_nodes/lane_planner_node.hpp>
 #include <had_map_utils/had_map_conversion.hpp>
 
+#include <chrono>
 #include <memory>
 
 #include "gtest/gtest.h"
@@ -140,19 +141,24 @@ TEST_F(LanePlannerNodeTest, plan_simple_trajectory)
 {
   using namespace std::chrono_literals;
 
-  const auto is_action_ready = m_trajectory_client->wait_for_action_server(5s);
-  ASSERT_TRUE(is_action_ready);
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(m_fake_node);
+  executor.add_node(m_planner_ptr);
 
+  // The planner offers its action server once it found the map service
+  const auto deadline = std::chrono::steady_clock::now() + 5s;
+  while (!m_trajectory_client->action_server_is_ready() &&
+    (std::chrono::steady_clock::now() < deadline))
+  {
+    executor.spin_some(10ms);
+  }
+  ASSERT_TRUE(m_trajectory_client->action_server_is_ready());
 
   auto goal = PlanTrajectory::Goal();
   goal.sub_route = get_route(m_lane_id, 5);
 
   auto goal_handle_future = m_trajectory_client->async_send_goal(goal);
 
-  rclcpp::executors::SingleThreadedExecutor executor;
-  executor.add_node(m_fake_node);
-  executor.add_node(m_planner_ptr);
-
   const auto goal_return_code = executor.spin_until_future_complete(goal_handle_future, 10s);
   ASSERT_EQ(goal_return_code, rclcpp::executor::FutureReturnCode::SUCCESS);
   auto goal_handle = goal_handle_future.get();
@@ -26,6 +26,9 @@
 #include <lanelet2_routing/RoutingGraph.h>
 #include <lanelet2_routing/RoutingGraphContainer.h>
 #include <lanelet2_traffic_rules/TrafficRulesFactory.h>
+// boost
+#include <boost/geometry.hpp>
+#include <boost/geometry/index/rtree.hpp>
 // autoware
 #include <lanelet2_global_planner/visibility_control.hpp>
 #include <autoware_auto_msgs/msg/trajectory_point.hpp>
@@ -34,9 +37,12 @@
 #include <chrono>
 #include <string>
 #include <memory>
+#include <mutex>
+#include <deque>
 #include <vector>
 #include <cmath>
 #include <unordered_map>
+#include <utility>
 #include <regex>
 
 using autoware::common::types::float64_t;
@@ -57,6 +63,8 @@ public:
   Lanelet2GlobalPlanner() = default;
 
   void load_osm_map(const std::string & file, float64_t lat, float64_t lon, float64_t alt);
+  /// \brief Build the lookup tables and the routing graph of osm_map. It must be called again
+  /// whenever osm_map changes.
   void parse_lanelet_element();
   bool8_t plan_route(
     TrajectoryPoint & start, TrajectoryPoint & end,
@@ -102,10 +110,21 @@ public:
     const lanelet::Point3d & point, const lanelet::Id & parking_id) const;
   std::string get_primitive_type(const lanelet::Id & prim_id);
   lanelet::Id find_nearparking_from_point(const lanelet::Point3d & point) const;
+  /// \brief Find the parking spots whose centers are the nearest to a point
+  /// \param point The point
+  /// \param num Maximum number of parking spots to return
+  /// \return The parking spot IDs, the nearest first
+  std::vector<lanelet::Id> find_nearparkings_from_point(
+    const lanelet::Point3d & point,
+    const std::size_t num) const;
   lanelet::Id find_nearroute_from_parking(const lanelet::Id & park_id) const;
   lanelet::Id find_parkingaccess_from_parking(const lanelet::Id & park_id) const;
   std::vector<lanelet::Id> find_lane_from_parkingaccess(const lanelet::Id & parkaccess_id) const;
   lanelet::Id find_lane_id(const lanelet::Id & cad_id) const;
+  /// \brief Find the shortest route from one of the from lanelets to one of the to lanelets.
+  /// The routes of the last requests are kept: a request repeating one of them, or with the same
+  /// to lanelets and a from lanelet on one of these routes, e.g. because the vehicle moved along
+  /// it, is answered from them without a search of the routing graph.
   std::vector<lanelet::Id> get_lane_route(
     const std::vector<lanelet::Id> & from_id,
     const std::vector<lanelet::Id> & to) const;
@@ -116,7 +135,36 @@ public:
   std::shared_ptr<lanelet::LaneletMap> osm_map;
 
 private:
+  /// A route found by get_lane_route
+  struct CachedRoute
+  {
+    std::vector<lanelet::Id> from_id;
+    std::vector<lanelet::Id> to_id;
+    std::vector<lanelet::Id> route;
+  };
+  /// Number of routes kept by get_lane_route
+  static constexpr std::size_t ROUTE_CACHE_SIZE = 16U;
+
+  /// \brief Look up a cached route for a request, must be called with route_cache_mutex locked
+  /// \return true if the route was found
+  bool8_t find_cached_route(
+    const std::vector<lanelet::Id> & from_id,
+    const std::vector<lanelet::Id> & to_id,
+    std::vector<lanelet::Id> & route) const;
+
+  lanelet::traffic_rules::TrafficRulesPtr traffic_rules;
+  lanelet::routing::RoutingGraphUPtr routing_graph;
+  mutable std::mutex route_cache_mutex;
+  mutable std::deque<CachedRoute> route_cache;
+  using ParkingCenter =
+    boost::geometry::model::point<float64_t, 3, boost::geometry::cs::cartesian>;
+  /// A parking center and the index of the parking in parking_id_list
+  using ParkingIndexValue = std::pair<ParkingCenter, std::size_t>;
+
   std::vector<lanelet::Id> parking_id_list;
+  /// R-tree of the centers of the parkings of parking_id_list which have a boundary
+  boost::geometry::index::rtree<ParkingIndexValue, boost::geometry::index::rstar<16>>
+  parking_index;
   std::unordered_map<lanelet::Id, std::vector<lanelet::Id>> parking_lane_map;
   std::unordered_map<lanelet::Id, std::vector<lanelet::Id>> parking2access_map;
   std::unordered_map<lanelet::Id, std::vector<lanelet::Id>> access2lane_map;
@@ -22,6 +22,7 @@
 #include <motion_common/motion_common.hpp>
 
 #include <algorithm>
+#include <iterator>
 #include <limits>
 #include <memory>
 #include <regex>
@@ -47,6 +48,11 @@ void Lanelet2GlobalPlanner::load_osm_map(
   if (osm_map) {
     osm_map.reset();
   }
+  routing_graph.reset();
+  {
+    std::lock_guard<std::mutex> lock{route_cache_mutex};
+    route_cache.clear();
+  }
   osm_map = load(
     file, lanelet::projection::UtmProjector(
       lanelet::Origin({lat, lon, alt})));
@@ -137,6 +143,27 @@ void Lanelet2GlobalPlanner::parse_lanelet_element()
         }
       }
     }  // end for
+
+    // spatial index of the parking centers, for the search of the nearest parkings
+    std::vector<ParkingIndexValue> parking_centers;
+    parking_centers.reserve(parking_id_list.size());
+    for (std::size_t idx = 0U; idx < parking_id_list.size(); ++idx) {
+      lanelet::Id parking_id = parking_id_list[idx];
+      lanelet::Point3d center;
+      if (compute_parking_center(parking_id, center)) {
+        parking_centers.emplace_back(ParkingCenter{center.x(), center.y(), center.z()}, idx);
+      }
+    }
+    // the range constructor packs the tree, which is faster than inserting one by one
+    parking_index = decltype(parking_index)(parking_centers.begin(), parking_centers.end());
+
+    // the routing graph is built once per map and shared by all the route requests
+    traffic_rules = lanelet::traffic_rules::TrafficRulesFactory::create(
+      lanelet::Locations::Germany,
+      lanelet::Participants::Vehicle);
+    routing_graph = lanelet::routing::RoutingGraph::build(*osm_map, *traffic_rules);
+    std::lock_guard<std::mutex> lock{route_cache_mutex};
+    route_cache.clear();
   }
 }
 
@@ -339,32 +366,34 @@ std::string Lanelet2GlobalPlanner::get_primitive_type(const lanelet::Id & prim_i
 lanelet::Id Lanelet2GlobalPlanner::find_nearparking_from_point(const lanelet::Point3d & point)
 const
 {
-  // loop through parking space to find the closest distance error
-  float64_t min_dist = 1e9;
-  auto it = std::min_element(
-    std::begin(parking_id_list),
-    std::end(parking_id_list),
-    [ =, &min_dist](lanelet::Id park_id1, lanelet::Id park_id2)
-    {
-      // compute parking center point
-      lanelet::Point3d p1;
-      lanelet::Point3d p2;
-      if (compute_parking_center(park_id1, p1) &&
-      compute_parking_center(park_id2, p2))
-      {
-        float64_t dist1 = p2p_euclidean(p1, point);
-        float64_t dist2 = p2p_euclidean(p2, point);
-        min_dist = (dist1 < dist2) ? dist1 : dist2;
-        return dist1 < dist2;
-      } else {
-        return false;
-      }
-    });
-
-  // get parking id
   // Improvement- Check if the parking point is too far away?
   //              Check if min_dist below the threshold
-  return parking_id_list[static_cast<size_t>(std::distance(std::begin(parking_id_list), it))];
+  const auto nearest = find_nearparkings_from_point(point, 1U);
+  return nearest.empty() ? parking_id_list[0U] : nearest[0U];
+}
+
+std::vector<lanelet::Id> Lanelet2GlobalPlanner::find_nearparkings_from_point(
+  const lanelet::Point3d & point, const std::size_t num) const
+{
+  namespace bg = boost::geometry;
+  const ParkingCenter query_point{point.x(), point.y(), point.z()};
+  std::vector<ParkingIndexValue> nearest;
+  nearest.reserve(num);
+  (void)parking_index.query(
+    bg::index::nearest(query_point, static_cast<uint32_t>(num)), std::back_inserter(nearest));
+  // the order of the results of a nearest query is not specified
+  std::sort(
+    nearest.begin(), nearest.end(),
+    [&query_point](const ParkingIndexValue & lhs, const ParkingIndexValue & rhs) {
+      return bg::comparable_distance(lhs.first, query_point) <
+      bg::comparable_distance(rhs.first, query_point);
+    });
+  std::vector<lanelet::Id> parking_ids;
+  parking_ids.reserve(nearest.size());
+  for (const auto & value : nearest) {
+    parking_ids.push_back(parking_id_list[value.second]);
+  }
+  return parking_ids;
 }
 
 lanelet::Id Lanelet2GlobalPlanner::find_nearroute_from_parking(const lanelet::Id & park_id)
@@ -428,19 +457,55 @@ lanelet::Id Lanelet2GlobalPlanner::find_lane_id(const lanelet::Id & cad_id) cons
   return lane_id;
 }
 
+bool8_t Lanelet2GlobalPlanner::find_cached_route(
+  const std::vector<lanelet::Id> & from_id, const std::vector<lanelet::Id> & to_id,
+  std::vector<lanelet::Id> & route) const
+{
+  for (const auto & cached : route_cache) {
+    if ((cached.from_id == from_id) && (cached.to_id == to_id)) {
+      route = cached.route;
+      return true;
+    }
+  }
+  // a from lanelet on a route to the same lanelets: the rest of this route is still the way to go
+  for (const auto & cached : route_cache) {
+    if (cached.to_id != to_id) {
+      continue;
+    }
+    for (auto start_id : from_id) {
+      const auto it = std::find(cached.route.begin(), cached.route.end(), start_id);
+      if (it != cached.route.end()) {
+        route.assign(it, cached.route.end());
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 std::vector<lanelet::Id> Lanelet2GlobalPlanner::get_lane_route(
   const std::vector<lanelet::Id> & from_id, const std::vector<lanelet::Id> & to_id) const
 {
-  lanelet::traffic_rules::TrafficRulesPtr trafficRules =
-    lanelet::traffic_rules::TrafficRulesFactory::create(
-    lanelet::Locations::Germany,
-    lanelet::Participants::Vehicle);
-  lanelet::routing::RoutingGraphUPtr routingGraph =
-    lanelet::routing::RoutingGraph::build(*osm_map, *trafficRules);
+  std::lock_guard<std::mutex> lock{route_cache_mutex};
+  std::vector<lanelet::Id> shortest_route;
+  if (find_cached_route(from_id, to_id, shortest_route)) {
+    return shortest_route;
+  }
+
+  // fall back to a graph for this request if parse_lanelet_element wasn't called
+  lanelet::routing::RoutingGraphUPtr request_graph;
+  const lanelet::routing::RoutingGraph * routingGraph = routing_graph.get();
+  if (!routingGraph) {
+    lanelet::traffic_rules::TrafficRulesPtr trafficRules =
+      lanelet::traffic_rules::TrafficRulesFactory::create(
+      lanelet::Locations::Germany,
+      lanelet::Participants::Vehicle);
+    request_graph = lanelet::routing::RoutingGraph::build(*osm_map, *trafficRules);
+    routingGraph = request_graph.get();
+  }
 
   // plan a shortest path without a lane change from the given from:to combination
   float64_t shortest_length = std::numeric_limits<float64_t>::max();
-  std::vector<lanelet::Id> shortest_route;
   for (auto start_id : from_id) {
     for (auto end_id : to_id) {
       lanelet::ConstLanelet fromLanelet = osm_map->laneletLayer.get(start_id);
@@ -463,6 +528,12 @@ std::vector<lanelet::Id> Lanelet2GlobalPlanner::get_lane_route(
     }
   }
 
+  if (!shortest_route.empty()) {
+    if (route_cache.size() >= ROUTE_CACHE_SIZE) {
+      route_cache.pop_front();
+    }
+    route_cache.push_back(CachedRoute{from_id, to_id, shortest_route});
+  }
   return shortest_route;
 }
 
@@ -285,6 +285,21 @@ TEST_F(TestGlobalPlannerFullMap, test_find_route_mutiple_lanes)
   EXPECT_GT(route_id.size(), 0u);
 }
 
+// test that repeated requests, and requests from further along a route, reuse the route
+TEST_F(TestGlobalPlannerFullMap, test_find_route_cached)
+{
+  const std::vector<lanelet::Id> start_lane_id{6392};
+  const std::vector<lanelet::Id> end_lane_id{6518};
+  const auto route_id = node_ptr->get_lane_route(start_lane_id, end_lane_id);
+  ASSERT_GT(route_id.size(), 2u);
+  EXPECT_EQ(node_ptr->get_lane_route(start_lane_id, end_lane_id), route_id);
+
+  // start moved along the route
+  const std::vector<lanelet::Id> moved_start_lane_id{route_id[2]};
+  const std::vector<lanelet::Id> rest_of_route(route_id.begin() + 2, route_id.end());
+  EXPECT_EQ(node_ptr->get_lane_route(moved_start_lane_id, end_lane_id), rest_of_route);
+}
+
 TEST_F(TestGlobalPlannerFullMap, test_find_parking_from_point)
 {
   // Vehicle location in the map frame: -25.9749 102.129 -1.74268
@@ -300,6 +315,17 @@ TEST_F(TestGlobalPlannerFullMap, test_find_parking_from_point)
   EXPECT_EQ(parking_id_2, 8113);
 }
 
+TEST_F(TestGlobalPlannerFullMap, test_find_nearest_parkings_from_point)
+{
+  lanelet::Point3d position(lanelet::utils::getId(), -25.97, 102.12, -1.74);
+  const auto parking_ids = node_ptr->find_nearparkings_from_point(position, 3U);
+  ASSERT_EQ(parking_ids.size(), 3u);
+  EXPECT_EQ(parking_ids[0], 101930);
+  EXPECT_NE(parking_ids[1], parking_ids[0]);
+  EXPECT_NE(parking_ids[2], parking_ids[1]);
+  EXPECT_TRUE(node_ptr->find_nearparkings_from_point(position, 0U).empty());
+}
+
 TEST_F(TestGlobalPlannerFullMap, test_plan_full_route)
 {
   // take the parking spot from previous test
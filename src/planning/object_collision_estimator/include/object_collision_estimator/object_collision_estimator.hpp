@@ -19,13 +19,18 @@
 #include <autoware_auto_msgs/msg/trajectory_point.hpp>
 #include <autoware_auto_msgs/msg/bounding_box_array.hpp>
 #include <autoware_auto_msgs/msg/bounding_box.hpp>
+#include <autoware_auto_msgs/msg/tracked_objects.hpp>
+#include <geometry_msgs/msg/point32.hpp>
 #include <motion_common/config.hpp>
+#include <motion_common/trajectory_view.hpp>
 #include <trajectory_smoother/trajectory_smoother.hpp>
 #include <common/types.hpp>
 #include <algorithm>
 #include <vector>
 #include <cmath>
 
+#include "object_collision_estimator/obstacle_grid.hpp"
+#include "object_collision_estimator/occupancy_layer.hpp"
 #include "object_collision_estimator/visibility_control.hpp"
 
 namespace motion
@@ -41,6 +46,8 @@ using autoware_auto_msgs::msg::Trajectory;
 using autoware_auto_msgs::msg::TrajectoryPoint;
 using autoware_auto_msgs::msg::BoundingBox;
 using autoware_auto_msgs::msg::BoundingBoxArray;
+using autoware_auto_msgs::msg::TrackedObjects;
+using geometry_msgs::msg::Point32;
 using autoware::common::types::float32_t;
 using autoware::common::types::PI;
 
@@ -54,6 +61,15 @@ typedef struct
   float32_t safety_factor;
   float32_t stop_margin;
   float32_t min_obstacle_dimension_m;
+
+  // duration for which obstacles with a velocity are predicted to move, they stay at their last
+  // predicted position after it. Obstacles are static if it is not positive.
+  float32_t prediction_horizon_s;
+  // duration of the time slices of the spatio-temporal obstacle index
+  float32_t prediction_time_step_s;
+
+  // cells of the occupancy grid with at least this value in [0, 100] are obstacles
+  int8_t occupied_threshold;
 } ObjectCollisionEstimatorConfig;
 
 /// \brief Given a trajectory and a list of obstacles, detect possible collision points between the
@@ -72,7 +88,8 @@ public:
   /// \brief Update the list of obstacles
   /// \details The collision estimator stores a list of obstacle. Coordinates should be in the same
   ///          frame as the the trajectories. When this function is called, the old list is replaced
-  ///          with the new list passed as the parameter.
+  ///          with the new list passed as the parameter, and the obstacles are indexed in a grid so
+  ///          that each trajectory point is only tested against the obstacles near it.
   ///          Modify bounding boxes with edges smaller than min_obstacle_dimension_m by computing
   ///          new corners from their centroid and orientation values. The orientation and centroid
   ///          of the modified bounding boxes are left unchanged.
@@ -85,6 +102,30 @@ public:
   std::vector<BoundingBox> updateObstacles(
     const BoundingBoxArray & bounding_boxes) noexcept;
 
+  /// \brief Update the list of obstacles with obstacles moving with a constant velocity
+  /// \details Same as updateObstacles(const BoundingBoxArray &), but each obstacle moves with its
+  ///          velocity from the time of the header of the bounding boxes, for up to
+  ///          prediction_horizon_s seconds. A trajectory point then only collides with an obstacle
+  ///          if it overlaps the obstacle at the time the vehicle reaches the point, i.e. the time
+  ///          of the header of the trajectory plus the time_from_start of the point.
+  /// \param[in] bounding_boxes A array of bounding boxes representing a list of obstacles
+  /// \param[in] velocities The velocity of each obstacle in m/s, in the frame of the obstacles.
+  ///            Only x and y are used. Obstacles without a velocity are static.
+  /// \returns A vector of obstacles modified for being smaller than min_obstacle_dimension_m
+  std::vector<BoundingBox> updateObstacles(
+    const BoundingBoxArray & bounding_boxes, const std::vector<Point32> & velocities) noexcept;
+
+  /// \brief Update the occupancy grid, whose occupied cells are obstacles in addition to the
+  ///        bounding boxes
+  /// \details The grid is typically built from the points of the obstacles that the object
+  ///          detection misses, e.g. the nonground points of the ray ground classifier. Each
+  ///          waypoint box is also tested against the occupied cells under it, with an O(1) lookup
+  ///          per cell. The occupied cells are static, the grid replaces the previous one.
+  /// \param[in] grid The occupancy grid, in its own frame
+  /// \param[in] to_grid The transform from the frame of the trajectories to the frame of the grid
+  void updateOccupancyGrid(
+    const OccupancyGrid & grid, const geometry_msgs::msg::Transform & to_grid) noexcept;
+
   /// \brief Perform collision detection given an trajectory
   /// \details the list of obstacles should be passed to the estimator with a prior call to
   ///          updateObstacles. When a collision is detected, the trajectory is modified in place
@@ -102,8 +143,22 @@ private:
   BoundingBoxArray m_obstacles{};
   BoundingBoxArray m_trajectory_bboxes{};
   TrajectorySmoother m_smoother;
+  ObstacleGrid m_obstacle_grid{};
+  OccupancyLayer m_occupancy_layer;
+  std::vector<std::size_t> m_candidates{};
+  std::vector<decltype(BoundingBox::corners)> m_candidate_corners{};
+  autoware::motion::motion_common::TrajectoryView m_trajectory_view{};
 };
 
+/// \brief Convert tracked objects into obstacles for the collision estimator
+/// \param[in] objects The tracked objects. The bounding box of an obstacle is the minimum perimeter
+///            box of the first shape of the object, objects without shape are skipped.
+/// \param[out] obstacles The bounding boxes of the objects, with the header of the objects
+/// \param[out] velocities The velocity of each obstacle, from the twist of the object
+OBJECT_COLLISION_ESTIMATOR_PUBLIC void trackedObjectsToObstacles(
+  const TrackedObjects & objects, BoundingBoxArray & obstacles,
+  std::vector<Point32> & velocities) noexcept;
+
 }  // namespace object_collision_estimator
 }  // namespace planning
 }  // namespace motion
@@ -0,0 +1,158 @@
+// Copyright 2021 Arm Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_COLLISION_ESTIMATOR__OBSTACLE_GRID_HPP_
+#define OBJECT_COLLISION_ESTIMATOR__OBSTACLE_GRID_HPP_
+
+#include <autoware_auto_msgs/msg/bounding_box.hpp>
+#include <autoware_auto_msgs/msg/bounding_box_array.hpp>
+#include <geometry_msgs/msg/point32.hpp>
+#include <common/types.hpp>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "object_collision_estimator/visibility_control.hpp"
+
+namespace motion
+{
+namespace planning
+{
+namespace object_collision_estimator
+{
+
+using autoware_auto_msgs::msg::BoundingBox;
+using autoware_auto_msgs::msg::BoundingBoxArray;
+using autoware::common::types::bool8_t;
+using autoware::common::types::float32_t;
+using geometry_msgs::msg::Point32;
+
+/// \brief Axis-aligned bounding box in the x-y plane
+typedef struct
+{
+  float32_t min_x;
+  float32_t min_y;
+  float32_t max_x;
+  float32_t max_y;
+} AxisAlignedBox;
+
+/// \brief Compute the axis-aligned box enclosing the corners of a bounding box
+/// \param[in] box A bounding box
+/// \returns The axis-aligned box of the corners
+OBJECT_COLLISION_ESTIMATOR_PUBLIC AxisAlignedBox make_axis_aligned_box(
+  const BoundingBox & box) noexcept;
+
+/// \brief Check if two axis-aligned boxes overlap, touching boxes overlap
+/// \param[in] a An axis-aligned box
+/// \param[in] b Another axis-aligned box
+/// \returns True if the boxes overlap
+OBJECT_COLLISION_ESTIMATOR_PUBLIC bool8_t overlap(
+  const AxisAlignedBox & a, const AxisAlignedBox & b) noexcept;
+
+/// \brief Broad phase of the collision detection. The axis-aligned boxes of the obstacles are
+///        stored in the cells of a uniform grid they overlap, so that a query only looks at the
+///        obstacles in the cells overlapped by the query box instead of all obstacles.
+///        Obstacles can move with a constant velocity. The prediction horizon is then split into
+///        time slices, each with its own grid holding the boxes swept by the moving obstacles
+///        during the slice, so that a query at a given time only looks at the obstacles near the
+///        query box at that time. Static obstacles are stored once for all times.
+class OBJECT_COLLISION_ESTIMATOR_PUBLIC ObstacleGrid
+{
+public:
+  /// \brief Construct an empty grid
+  /// \param[in] cell_size Size of the square cells in meters. Queries are cheapest when the query
+  ///            boxes span about one cell.
+  /// \param[in] time_step Duration of the time slices in seconds.
+  explicit ObstacleGrid(const float32_t cell_size = 10.0F, const float32_t time_step = 1.0F)
+  noexcept;
+
+  /// \brief Replace the obstacles of the grid with static obstacles
+  /// \param[in] obstacles The obstacles, their indices are returned by the queries
+  void build(const BoundingBoxArray & obstacles) noexcept;
+
+  /// \brief Replace the obstacles of the grid with obstacles moving with a constant velocity
+  /// \param[in] obstacles The obstacles at time 0, their indices are returned by the queries
+  /// \param[in] velocities Velocity of each obstacle in m/s, only x and y are used. Obstacles
+  ///            without a velocity are static.
+  /// \param[in] horizon Duration of the prediction in seconds, obstacles stay at their predicted
+  ///            position after it. Obstacles are static if it isn't positive.
+  void build(
+    const BoundingBoxArray & obstacles, const std::vector<Point32> & velocities,
+    const float32_t horizon) noexcept;
+
+  /// \brief Find the obstacles whose axis-aligned box overlaps a given box
+  /// \param[in] box The query box
+  /// \param[out] candidates Indices of the overlapping obstacles in increasing order, without
+  ///             duplicates. Only their axis-aligned boxes overlap, they still need an exact test.
+  void query(const AxisAlignedBox & box, std::vector<std::size_t> & candidates) const noexcept;
+
+  /// \brief Find the obstacles whose axis-aligned box overlaps a given box at a given time
+  /// \param[in] box The query box
+  /// \param[in] time Time of the query in seconds, relative to the time of the obstacles
+  /// \param[out] candidates Indices of the overlapping obstacles in increasing order, without
+  ///             duplicates. Only their axis-aligned boxes overlap, they still need an exact test
+  ///             with the obstacles moved by their displacement.
+  void query(
+    const AxisAlignedBox & box, const float32_t time,
+    std::vector<std::size_t> & candidates) const noexcept;
+
+  /// \brief Get the predicted displacement of an obstacle
+  /// \param[in] idx Index of the obstacle
+  /// \param[in] time Time in seconds, relative to the time of the obstacles
+  /// \returns The displacement of the obstacle from time 0, z is 0
+  Point32 displacement(const std::size_t idx, const float32_t time) const noexcept;
+
+  /// \brief Get the number of obstacles in the grid
+  /// \returns The number of obstacles
+  std::size_t size() const noexcept {return m_boxes.size();}
+
+private:
+  using Cells = std::unordered_map<uint64_t, std::vector<std::size_t>>;
+
+  // Obstacles spanning more cells are not stored in the cells but tested by every query, and
+  // queries spanning more cells test all obstacles
+  static constexpr int64_t MAX_CELLS_PER_OBSTACLE{256};
+  // Bounds the memory of long horizons with short time steps
+  static constexpr std::size_t MAX_NUM_TIME_SLICES{100U};
+
+  /// Store an obstacle in the cells overlapped by a box
+  void insert(const std::size_t idx, const AxisAlignedBox & box, Cells & cells) noexcept;
+  /// Add the obstacles stored in the cells overlapped by a box, possibly several times
+  void collect(
+    const AxisAlignedBox & box, const Cells & cells,
+    std::vector<std::size_t> & candidates) const noexcept;
+  /// Clamp a time into the prediction horizon
+  float32_t prediction_time(const float32_t time) const noexcept;
+  /// Get the box of an obstacle at a given time
+  AxisAlignedBox box_at(const std::size_t idx, const float32_t time) const noexcept;
+  int32_t cell_index(const float32_t coordinate) const noexcept;
+  static uint64_t cell_key(const int32_t x_index, const int32_t y_index) noexcept;
+
+  float32_t m_cell_size;
+  float32_t m_time_step;
+  float32_t m_slice_duration;
+  float32_t m_horizon{0.0F};
+  std::vector<AxisAlignedBox> m_boxes{};
+  std::vector<Point32> m_velocities{};
+  Cells m_static_cells{};
+  // One grid of the moving obstacles per time slice
+  std::vector<Cells> m_time_slices{};
+  std::vector<std::size_t> m_large_obstacles{};
+};
+
+}  // namespace object_collision_estimator
+}  // namespace planning
+}  // namespace motion
+
+#endif  // OBJECT_COLLISION_ESTIMATOR__OBSTACLE_GRID_HPP_
@@ -0,0 +1,101 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_COLLISION_ESTIMATOR__OCCUPANCY_LAYER_HPP_
+#define OBJECT_COLLISION_ESTIMATOR__OCCUPANCY_LAYER_HPP_
+
+#include <autoware_auto_msgs/msg/bounding_box.hpp>
+#include <geometry_msgs/msg/transform.hpp>
+#include <nav_msgs/msg/occupancy_grid.hpp>
+#include <common/types.hpp>
+#include <cstdint>
+#include <vector>
+
+#include "object_collision_estimator/visibility_control.hpp"
+
+namespace motion
+{
+namespace planning
+{
+namespace object_collision_estimator
+{
+
+using autoware_auto_msgs::msg::BoundingBox;
+using autoware::common::types::bool8_t;
+using autoware::common::types::float32_t;
+using autoware::common::types::float64_t;
+using nav_msgs::msg::OccupancyGrid;
+
+/// \brief Occupied cells of an occupancy grid, e.g. the one of the occupancy_grid package, as
+///        obstacles without a shape. The grid is in its own frame, the queries are in the frame of
+///        the trajectories and are transformed into the cells on the fly, so that a point is
+///        looked up in O(1).
+class OBJECT_COLLISION_ESTIMATOR_PUBLIC OccupancyLayer
+{
+public:
+  /// \brief Construct an empty layer, in which nothing is occupied
+  /// \param[in] occupied_threshold Cells with at least this value in [0, 100] are occupied,
+  ///            unknown cells never are
+  explicit OccupancyLayer(const int8_t occupied_threshold = 65) noexcept;
+
+  /// \brief Replace the grid of the layer
+  /// \param[in] grid The occupancy grid, its origin may be rotated
+  /// \param[in] to_grid The transform from the frame of the queries to the frame of the grid,
+  ///            only its translation in x and y and its yaw are used
+  void update(const OccupancyGrid & grid, const geometry_msgs::msg::Transform & to_grid);
+
+  /// \brief Remove the grid, nothing is occupied afterwards
+  void clear() noexcept;
+
+  /// \brief Check if the cell of a point is occupied
+  /// \param[in] x The x coordinate of the point in the frame of the queries
+  /// \param[in] y The y coordinate of the point in the frame of the queries
+  /// \returns True if the point is in an occupied cell, false outside of the grid
+  bool8_t occupied(const float32_t x, const float32_t y) const noexcept;
+
+  /// \brief Check if a box overlaps an occupied cell. Only the cells in the axis-aligned box of
+  ///        the box in the grid are visited, and only the occupied ones are tested exactly.
+  /// \param[in] box The box, e.g. of the ego vehicle at a waypoint, in the frame of the queries
+  /// \returns True if an occupied cell overlaps the box, touching counts
+  bool8_t overlaps(const BoundingBox & box) const noexcept;
+
+  /// \brief Check if the layer has a grid
+  /// \returns True if there is no grid, or if it doesn't have any cell
+  bool8_t empty() const noexcept {return m_cells.empty();}
+
+private:
+  /// Transform a point of the frame of the queries into the continuous cell coordinates of the
+  /// grid, in which the cell (col, row) spans [col, col + 1) x [row, row + 1)
+  void to_cell(const float32_t x, const float32_t y, float64_t & col, float64_t & row)
+  const noexcept;
+  /// Check the value of a cell in the grid
+  bool8_t is_occupied(const std::size_t col, const std::size_t row) const noexcept;
+
+  int8_t m_occupied_threshold;
+  std::size_t m_width{0U};
+  std::size_t m_height{0U};
+  // Rotation and translation from the frame of the queries to the cell coordinates, scaled by
+  // the inverse of the resolution
+  float64_t m_cos{1.0};
+  float64_t m_sin{0.0};
+  float64_t m_col_offset{0.0};
+  float64_t m_row_offset{0.0};
+  std::vector<int8_t> m_cells{};
+};
+
+}  // namespace object_collision_estimator
+}  // namespace planning
+}  // namespace motion
+
+#endif  // OBJECT_COLLISION_ESTIMATOR__OCCUPANCY_LAYER_HPP_
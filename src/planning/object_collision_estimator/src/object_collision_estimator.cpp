@@ -17,9 +17,12 @@
 #include <geometry_msgs/msg/point32.hpp>
 #include <geometry/bounding_box/bounding_box_common.hpp>
 #include <geometry/bounding_box/rotating_calipers.hpp>
+#include <time_utils/time_utils.hpp>
 #include <common/types.hpp>
 #include <algorithm>
-#include <list>
+#include <chrono>
+#include <cmath>
+#include <exception>
 #include <vector>
 
 #include "object_collision_estimator/object_collision_estimator.hpp"
@@ -38,6 +41,8 @@ using autoware::common::geometry::plus_2d;
 using autoware::common::geometry::rotate_2d;
 using autoware::common::geometry::times_2d;
 using autoware::common::types::float32_t;
+using autoware::common::types::float64_t;
+using autoware::motion::motion_common::TrajectoryView;
 using motion::motion_common::to_angle;
 using motion::planning::trajectory_smoother::TrajectorySmoother;
 using geometry_msgs::msg::Point32;
@@ -67,92 +72,63 @@ BoundingBox waypointToBox(
   lr *= safety_factor;
   wh *= safety_factor;
 
-  // Create a list of corners for the vehicle
-  std::list<Point32> vehicle_corners;
-
-  {     // Front left
-    auto p = Point32{};
-    p.x = pt.x + (lf * ch) - (wh * sh);
-    p.y = pt.y + (lf * sh) + (wh * ch);
-    vehicle_corners.push_back(p);
-  }
-  {     // Front right
-    auto p = Point32{};
-    p.x = pt.x + (lf * ch) + (wh * sh);
-    p.y = pt.y + (lf * sh) - (wh * ch);
-    vehicle_corners.push_back(p);
-  }
-  {     // Rear right
-    auto p = Point32{};
-    p.x = pt.x - (lr * ch) + (wh * sh);
-    p.y = pt.y - (lr * sh) - (wh * ch);
-    vehicle_corners.push_back(p);
-  }
-  {     // Rear left
-    auto p = Point32{};
-    p.x = pt.x - (lr * ch) - (wh * sh);
-    p.y = pt.y - (lr * sh) + (wh * ch);
-    vehicle_corners.push_back(p);
-  }
-
-  return minimum_perimeter_bounding_box(vehicle_corners);
-}
-
-/// \brief Determine if a obstacle is too far away from a way point given a distance threshold
-/// \param way_point a trajectory way point
-/// \param obstacle_bbox a bounding box with 4 corners representing the obstacle
-/// \param distance_threshold the minimum distance for a obstacle to be determined too far away
-/// \return bool8_t Return true if the bounding box of the obstacle is at least distance_threshold
-///         away from the way point.
-bool8_t isTooFarAway(
-  const TrajectoryPoint & way_point, const BoundingBox & obstacle_bbox,
-  const float32_t distance_threshold)
-{
-  bool is_too_far_away{true};
-  auto distance_threshold_squared = distance_threshold * distance_threshold;
-
-  for (const auto & corner : obstacle_bbox.corners) {
-    auto dx = corner.x - way_point.x;
-    auto dy = corner.y - way_point.y;
-    auto distance_squared = (dx * dx) + (dy * dy);
-
-    if (distance_threshold_squared > distance_squared) {
-      is_too_far_away = false;
-      break;
-    }
-  }
-
-  return is_too_far_away;
+  // The footprint is already a rectangle, so the box is built from its corners in counterclockwise
+  // order instead of searching the minimum perimeter box of a convex hull. The second edge points
+  // along the heading, which is the convention of rotating calipers boxes.
+  BoundingBox box{};
+  auto & corners = box.corners;
+  // Rear left
+  corners[0U].x = pt.x - (lr * ch) - (wh * sh);
+  corners[0U].y = pt.y - (lr * sh) + (wh * ch);
+  // Rear right
+  corners[1U].x = pt.x - (lr * ch) + (wh * sh);
+  corners[1U].y = pt.y - (lr * sh) - (wh * ch);
+  // Front right
+  corners[2U].x = pt.x + (lf * ch) + (wh * sh);
+  corners[2U].y = pt.y + (lf * sh) - (wh * ch);
+  // Front left
+  corners[3U].x = pt.x + (lf * ch) - (wh * sh);
+  corners[3U].y = pt.y + (lf * sh) + (wh * ch);
+
+  box.size.x = 2.0F * wh;
+  box.size.y = lf + lr;
+  // Half the perimeter, like minimum_perimeter_bounding_box
+  box.value = box.size.x + box.size.y;
+  box.orientation.w = std::cos(heading * 0.5F);
+  box.orientation.z = std::sin(heading * 0.5F);
+  box.centroid = times_2d(plus_2d(corners[0U], corners[2U]), 0.5F);
+
+  return box;
 }
 
 /// \brief Detect possible collision between a trajectory and a list of obstacle bounding boxes.
 ///        Return the index in the trajectory where the first collision happens.
 /// \param trajectory Planned trajectory of ego vehicle.
 /// \param obstacles Array of bounding boxes of detected obstacles.
+/// \param obstacle_grid Broad phase grid built from the obstacles.
+/// \param occupancy_layer Occupied cells of the occupancy grid, which are static obstacles.
 /// \param vehicle_param Configuration regarding the dimensions of the ego vehicle
 /// \param safety_factor A factor to inflate the size of the vehicle so to avoid getting too close
 ///                      to obstacles.
 /// \param waypoint_bboxes A list of bounding boxes around each waypoint in the trajectory
+/// \param time_offset Time of the start of the trajectory in seconds, relative to the time of the
+///                    obstacles
+/// \param candidates Scratch space for the obstacles found by the broad phase
+/// \param candidate_corners Scratch space for the corners of the candidates at the waypoint time
 /// \return int32_t The index into the trajectory points where the first collision happens. If no
 ///         collision is detected, -1 is returned.
 int32_t detectCollision(
   const Trajectory & trajectory,
   const BoundingBoxArray & obstacles,
+  const ObstacleGrid & obstacle_grid,
+  const OccupancyLayer & occupancy_layer,
   const VehicleConfig & vehicle_param,
   const float32_t safety_factor,
-  BoundingBoxArray & waypoint_bboxes)
+  BoundingBoxArray & waypoint_bboxes,
+  const float32_t time_offset,
+  std::vector<std::size_t> & candidates,
+  std::vector<decltype(BoundingBox::corners)> & candidate_corners)
 {
-  // find the dimension of the ego vehicle.
-  const auto vehicle_length =
-    vehicle_param.front_overhang() + vehicle_param.length_cg_front_axel() +
-    vehicle_param.length_cg_rear_axel() + vehicle_param.rear_overhang();
-  const auto vehicle_width = vehicle_param.width();
-  const auto vehicle_diagonal = sqrtf(
-    (vehicle_width * vehicle_width) + (vehicle_length * vehicle_length));
-
-  // define a distance threshold to filter obstacles that are too far away to cause any collision.
-  const float32_t distance_threshold{vehicle_diagonal * safety_factor};
-
   int32_t collision_index = -1;
 
   waypoint_bboxes.boxes.clear();
@@ -164,19 +140,36 @@ int32_t detectCollision(
     // calculate a bounding box given a trajectory point
     const auto & waypoint_bbox = waypoint_bboxes.boxes.at(i);
 
-    // Check for collisions with all perceived obstacles
-    for (const auto & obstacle_bbox : obstacles.boxes) {
-      if (!isTooFarAway(
-          trajectory.points[i], obstacle_bbox,
-          distance_threshold) && autoware::common::geometry::intersect(
-          waypoint_bbox.corners.begin(), waypoint_bbox.corners.end(),
-          obstacle_bbox.corners.begin(), obstacle_bbox.corners.end()))
-      {
-        // Collision detected, set end index (non-inclusive), this will end outer loop immediately
-        collision_index = static_cast<decltype(collision_index)>(i);
-        break;
+    // The occupied cells are static, the lookup doesn't need the time of the waypoint
+    if (occupancy_layer.overlaps(waypoint_bbox)) {
+      // Collision detected, this will end outer loop immediately
+      collision_index = static_cast<decltype(collision_index)>(i);
+      continue;
+    }
+
+    // Time at which the vehicle is at the waypoint, moving obstacles are tested at their
+    // predicted position at that time
+    const auto time = time_offset + std::chrono::duration_cast<std::chrono::duration<float32_t>>(
+      time_utils::from_message(trajectory.points[i].time_from_start)).count();
+
+    // Only the obstacles whose axis-aligned box overlaps the one of the vehicle can collide
+    obstacle_grid.query(make_axis_aligned_box(waypoint_bbox), time, candidates);
+    candidate_corners.clear();
+    for (const auto obstacle_idx : candidates) {
+      const auto displacement = obstacle_grid.displacement(obstacle_idx, time);
+      candidate_corners.push_back(obstacles.boxes[obstacle_idx].corners);
+      for (auto & corner : candidate_corners.back()) {
+        corner = plus_2d(corner, displacement);
       }
     }
+    // The faces of the vehicle box are computed once for all candidates, without allocation
+    if (autoware::common::geometry::find_intersecting(
+        waypoint_bbox.corners, candidate_corners.cbegin(), candidate_corners.cend()) !=
+      candidate_corners.cend())
+    {
+      // Collision detected, set end index (non-inclusive), this will end outer loop immediately
+      collision_index = static_cast<decltype(collision_index)>(i);
+    }
   }
 
   return collision_index;
@@ -184,55 +177,70 @@ int32_t detectCollision(
 
 /// \brief Returns the index that vehicle should stop when the object colliding index
 ///        and stop distance is given
-/// \param trajectory Planned trajectory of ego vehicle.
+/// \param trajectory_view Arc length and geometry of the planned trajectory of ego vehicle.
 /// \param collision_index Index of trajectory point that collides with and obstacle
 /// \param stop_margin Distance between the control point of vehicle (CoG or base_link) and obstacle
 /// \return int32_t The index into the trajectory points where vehicle should stop.
 int32_t getStopIndex(
-  const Trajectory & trajectory,
+  const TrajectoryView & trajectory_view,
   const int32_t collision_index,
   const float32_t stop_margin) noexcept
 {
   if (collision_index < 0) {
     return collision_index;
   }
-  int32_t stop_index = collision_index;
-  float32_t accumulated_distance = 0;
-
-  for (int32_t i = collision_index; i >= 1; i--) {
-    const auto & prev_pt = trajectory.points.at(static_cast<std::size_t>(i - 1));
-    const auto & pt = trajectory.points.at(static_cast<std::size_t>(i));
-
-    const auto dx = prev_pt.x - pt.x;
-    const auto dy = prev_pt.y - pt.y;
-    accumulated_distance += std::hypot(dx, dy);
-    if (accumulated_distance >= stop_margin) {
-      stop_index = i;
-      break;
-    }
+  // The stop index is the one after the last point at least stop_margin before the collision.
+  // The tolerance absorbs the rounding of the cumulative arc length, e.g. for a margin of exactly
+  // the length of the segments.
+  constexpr float64_t tolerance = 1.0E-6;
+  const auto collision_idx = static_cast<std::size_t>(collision_index);
+  const auto stop_s =
+    (trajectory_view.s()[collision_idx] - static_cast<float64_t>(stop_margin)) + tolerance;
+  const auto segment_idx = trajectory_view.find_segment_index(stop_s, collision_idx);
+  if ((collision_idx == 0U) || (trajectory_view.s()[segment_idx] > stop_s)) {
+    return collision_index;
   }
-  return stop_index;
+  return static_cast<int32_t>(std::min(segment_idx + 1U, collision_idx));
 }
 
 ObjectCollisionEstimator::ObjectCollisionEstimator(
   ObjectCollisionEstimatorConfig config,
   TrajectorySmoother smoother) noexcept
-: m_config(config), m_smoother(smoother)
+: m_config(config), m_smoother(smoother), m_occupancy_layer{config.occupied_threshold}
 {
   // safety factor could not be smaller than 1
   if (m_config.safety_factor < 1.0f) {
     m_config.safety_factor = 1.0f;
   }
+
+  // The inflated vehicle diagonal bounds the axis-aligned box of the vehicle at any heading, so
+  // that a waypoint query visits at most 4 cells of the obstacle grid.
+  const auto & vehicle_param = m_config.vehicle_config;
+  const auto vehicle_length =
+    vehicle_param.front_overhang() + vehicle_param.length_cg_front_axel() +
+    vehicle_param.length_cg_rear_axel() + vehicle_param.rear_overhang();
+  const auto vehicle_width = vehicle_param.width();
+  m_obstacle_grid = ObstacleGrid{
+    std::hypot(vehicle_length, vehicle_width) * m_config.safety_factor,
+    m_config.prediction_time_step_s};
+  m_trajectory_view.reserve(Trajectory::CAPACITY);
 }
 
 void ObjectCollisionEstimator::updatePlan(Trajectory & trajectory) noexcept
 {
   // Collision detection
+  // Moving obstacles are predicted from the time of the obstacles to the time of the waypoints
+  const auto time_offset = std::chrono::duration_cast<std::chrono::duration<float32_t>>(
+    time_utils::from_message(trajectory.header.stamp) -
+    time_utils::from_message(m_obstacles.header.stamp)).count();
   auto collision_index = detectCollision(
-    trajectory, m_obstacles, m_config.vehicle_config,
-    m_config.safety_factor, m_trajectory_bboxes);
+    trajectory, m_obstacles, m_obstacle_grid, m_occupancy_layer, m_config.vehicle_config,
+    m_config.safety_factor, m_trajectory_bboxes, time_offset, m_candidates,
+    m_candidate_corners);
 
-  auto trajectory_end_idx = getStopIndex(trajectory, collision_index, m_config.stop_margin);
+  m_trajectory_view.update(trajectory.points);
+  auto trajectory_end_idx =
+    getStopIndex(m_trajectory_view, collision_index, m_config.stop_margin);
 
   if (trajectory_end_idx >= 0) {
     // Cut trajectory short to just before the collision point
@@ -255,6 +263,12 @@ void ObjectCollisionEstimator::updatePlan(Trajectory & trajectory) noexcept
 
 std::vector<BoundingBox> ObjectCollisionEstimator::updateObstacles(
   const BoundingBoxArray & bounding_boxes) noexcept
+{
+  return updateObstacles(bounding_boxes, std::vector<Point32>{});
+}
+
+std::vector<BoundingBox> ObjectCollisionEstimator::updateObstacles(
+  const BoundingBoxArray & bounding_boxes, const std::vector<Point32> & velocities) noexcept
 {
   m_obstacles = bounding_boxes;
 
@@ -288,9 +302,45 @@ std::vector<BoundingBox> ObjectCollisionEstimator::updateObstacles(
     }
   }
 
+  m_obstacle_grid.build(m_obstacles, velocities, m_config.prediction_horizon_s);
+
   return modified_obstacles;
 }
 
+void ObjectCollisionEstimator::updateOccupancyGrid(
+  const OccupancyGrid & grid, const geometry_msgs::msg::Transform & to_grid) noexcept
+{
+  m_occupancy_layer.update(grid, to_grid);
+}
+
+void trackedObjectsToObstacles(
+  const TrackedObjects & objects, BoundingBoxArray & obstacles,
+  std::vector<Point32> & velocities) noexcept
+{
+  obstacles.header = objects.header;
+  obstacles.boxes.clear();
+  velocities.clear();
+  // reused between the objects, the hull is formed in place
+  std::vector<Point32> shape_points;
+  for (const auto & object : objects.objects) {
+    if (object.shape.empty()) {
+      continue;
+    }
+    shape_points.assign(
+      object.shape.front().polygon.points.begin(), object.shape.front().polygon.points.end());
+    try {
+      obstacles.boxes.push_back(minimum_perimeter_bounding_box(shape_points));
+    } catch (const std::exception &) {
+      // Degenerate shapes don't have a bounding box
+      continue;
+    }
+    Point32 velocity{};
+    velocity.x = static_cast<float32_t>(object.kinematics.twist.twist.linear.x);
+    velocity.y = static_cast<float32_t>(object.kinematics.twist.twist.linear.y);
+    velocities.push_back(velocity);
+  }
+}
+
 }  // namespace object_collision_estimator
 }  // namespace planning
 }  // namespace motion
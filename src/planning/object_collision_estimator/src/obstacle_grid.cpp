@@ -0,0 +1,245 @@
+// Copyright 2021 Arm Limited
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "object_collision_estimator/obstacle_grid.hpp"
+
+namespace motion
+{
+namespace planning
+{
+namespace object_collision_estimator
+{
+
+constexpr int64_t ObstacleGrid::MAX_CELLS_PER_OBSTACLE;
+constexpr std::size_t ObstacleGrid::MAX_NUM_TIME_SLICES;
+
+AxisAlignedBox make_axis_aligned_box(const BoundingBox & box) noexcept
+{
+  AxisAlignedBox ret{
+    std::numeric_limits<float32_t>::max(), std::numeric_limits<float32_t>::max(),
+    std::numeric_limits<float32_t>::lowest(), std::numeric_limits<float32_t>::lowest()};
+  for (const auto & corner : box.corners) {
+    ret.min_x = std::min(ret.min_x, corner.x);
+    ret.min_y = std::min(ret.min_y, corner.y);
+    ret.max_x = std::max(ret.max_x, corner.x);
+    ret.max_y = std::max(ret.max_y, corner.y);
+  }
+  return ret;
+}
+
+bool8_t overlap(const AxisAlignedBox & a, const AxisAlignedBox & b) noexcept
+{
+  return (a.min_x <= b.max_x) && (b.min_x <= a.max_x) &&
+         (a.min_y <= b.max_y) && (b.min_y <= a.max_y);
+}
+
+ObstacleGrid::ObstacleGrid(const float32_t cell_size, const float32_t time_step) noexcept
+: m_cell_size{cell_size > 0.0F ? cell_size : 10.0F},
+  m_time_step{time_step > 0.0F ? time_step : 1.0F},
+  m_slice_duration{m_time_step}
+{
+}
+
+void ObstacleGrid::build(const BoundingBoxArray & obstacles) noexcept
+{
+  build(obstacles, std::vector<Point32>{}, 0.0F);
+}
+
+void ObstacleGrid::build(
+  const BoundingBoxArray & obstacles, const std::vector<Point32> & velocities,
+  const float32_t horizon) noexcept
+{
+  m_boxes.clear();
+  m_velocities.clear();
+  m_static_cells.clear();
+  m_large_obstacles.clear();
+
+  m_horizon = std::isfinite(horizon) ? std::max(horizon, 0.0F) : 0.0F;
+  const auto num_time_slices = static_cast<std::size_t>(
+    std::min(std::ceil(m_horizon / m_time_step), static_cast<float32_t>(MAX_NUM_TIME_SLICES)));
+  // The slices are longer if their number is bounded
+  m_slice_duration = (num_time_slices > 0U) ?
+    std::max(m_time_step, m_horizon / static_cast<float32_t>(num_time_slices)) : m_time_step;
+  // Keep the buckets of the slices that are reused
+  m_time_slices.resize(num_time_slices);
+  for (auto & cells : m_time_slices) {
+    cells.clear();
+  }
+
+  for (std::size_t i = 0U; i < obstacles.boxes.size(); ++i) {
+    m_boxes.push_back(make_axis_aligned_box(obstacles.boxes[i]));
+    Point32 velocity{};
+    if ((i < velocities.size()) && std::isfinite(velocities[i].x) &&
+      std::isfinite(velocities[i].y))
+    {
+      velocity.x = velocities[i].x;
+      velocity.y = velocities[i].y;
+    }
+    m_velocities.push_back(velocity);
+
+    const auto & box = m_boxes.back();
+    if (!std::isfinite(box.min_x) || !std::isfinite(box.min_y) ||
+      !std::isfinite(box.max_x) || !std::isfinite(box.max_y))
+    {
+      m_large_obstacles.push_back(i);
+    } else if ((num_time_slices == 0U) || ((velocity.x == 0.0F) && (velocity.y == 0.0F))) {
+      insert(i, box, m_static_cells);
+    } else {
+      for (std::size_t slice = 0U; slice < num_time_slices; ++slice) {
+        // The motion is linear, so the box swept during the slice spans the boxes at its ends
+        const auto start = box_at(i, static_cast<float32_t>(slice) * m_slice_duration);
+        const auto end = box_at(i, static_cast<float32_t>(slice + 1U) * m_slice_duration);
+        const AxisAlignedBox swept{
+          std::min(start.min_x, end.min_x), std::min(start.min_y, end.min_y),
+          std::max(start.max_x, end.max_x), std::max(start.max_y, end.max_y)};
+        insert(i, swept, m_time_slices[slice]);
+      }
+    }
+  }
+  // An obstacle could be too large in some slices only
+  std::sort(m_large_obstacles.begin(), m_large_obstacles.end());
+  m_large_obstacles.erase(
+    std::unique(m_large_obstacles.begin(), m_large_obstacles.end()), m_large_obstacles.end());
+}
+
+void ObstacleGrid::query(
+  const AxisAlignedBox & box, std::vector<std::size_t> & candidates) const noexcept
+{
+  query(box, 0.0F, candidates);
+}
+
+void ObstacleGrid::query(
+  const AxisAlignedBox & box, const float32_t time,
+  std::vector<std::size_t> & candidates) const noexcept
+{
+  candidates.clear();
+
+  const auto min_x_index = cell_index(box.min_x);
+  const auto min_y_index = cell_index(box.min_y);
+  const auto max_x_index = cell_index(box.max_x);
+  const auto max_y_index = cell_index(box.max_y);
+  const auto num_cells = (int64_t{max_x_index} - int64_t{min_x_index} + 1) *
+    (int64_t{max_y_index} - int64_t{min_y_index} + 1);
+  if (num_cells > MAX_CELLS_PER_OBSTACLE) {
+    // Testing all obstacles is cheaper than visiting that many cells
+    for (std::size_t idx = 0U; idx < m_boxes.size(); ++idx) {
+      candidates.push_back(idx);
+    }
+  } else {
+    candidates.insert(candidates.end(), m_large_obstacles.begin(), m_large_obstacles.end());
+    collect(box, m_static_cells, candidates);
+    if (!m_time_slices.empty()) {
+      const auto slice = std::min(
+        static_cast<std::size_t>(prediction_time(time) / m_slice_duration),
+        m_time_slices.size() - 1U);
+      collect(box, m_time_slices[slice], candidates);
+    }
+    // An obstacle spanning several cells is found once per cell
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+  }
+
+  // The cells and the boxes swept during a time slice are larger than the boxes at the query time
+  candidates.erase(
+    std::remove_if(
+      candidates.begin(), candidates.end(),
+      [this, &box, time](const std::size_t idx) {return !overlap(box, box_at(idx, time));}),
+    candidates.end());
+}
+
+Point32 ObstacleGrid::displacement(const std::size_t idx, const float32_t time) const noexcept
+{
+  const auto dt = prediction_time(time);
+  Point32 ret{};
+  ret.x = m_velocities[idx].x * dt;
+  ret.y = m_velocities[idx].y * dt;
+  return ret;
+}
+
+void ObstacleGrid::insert(
+  const std::size_t idx, const AxisAlignedBox & box, Cells & cells) noexcept
+{
+  const auto min_x_index = cell_index(box.min_x);
+  const auto min_y_index = cell_index(box.min_y);
+  const auto max_x_index = cell_index(box.max_x);
+  const auto max_y_index = cell_index(box.max_y);
+  const auto num_cells = (int64_t{max_x_index} - int64_t{min_x_index} + 1) *
+    (int64_t{max_y_index} - int64_t{min_y_index} + 1);
+  if (num_cells > MAX_CELLS_PER_OBSTACLE) {
+    m_large_obstacles.push_back(idx);
+    return;
+  }
+  for (auto x_index = min_x_index; x_index <= max_x_index; ++x_index) {
+    for (auto y_index = min_y_index; y_index <= max_y_index; ++y_index) {
+      cells[cell_key(x_index, y_index)].push_back(idx);
+    }
+  }
+}
+
+void ObstacleGrid::collect(
+  const AxisAlignedBox & box, const Cells & cells,
+  std::vector<std::size_t> & candidates) const noexcept
+{
+  if (cells.empty()) {
+    return;
+  }
+  const auto min_x_index = cell_index(box.min_x);
+  const auto min_y_index = cell_index(box.min_y);
+  const auto max_x_index = cell_index(box.max_x);
+  const auto max_y_index = cell_index(box.max_y);
+  for (auto x_index = min_x_index; x_index <= max_x_index; ++x_index) {
+    for (auto y_index = min_y_index; y_index <= max_y_index; ++y_index) {
+      const auto cell = cells.find(cell_key(x_index, y_index));
+      if (cell != cells.end()) {
+        candidates.insert(candidates.end(), cell->second.begin(), cell->second.end());
+      }
+    }
+  }
+}
+
+float32_t ObstacleGrid::prediction_time(const float32_t time) const noexcept
+{
+  return std::isfinite(time) ? std::max(0.0F, std::min(time, m_horizon)) : 0.0F;
+}
+
+AxisAlignedBox ObstacleGrid::box_at(const std::size_t idx, const float32_t time) const noexcept
+{
+  const auto offset = displacement(idx, time);
+  const auto & box = m_boxes[idx];
+  return AxisAlignedBox{
+    box.min_x + offset.x, box.min_y + offset.y, box.max_x + offset.x, box.max_y + offset.y};
+}
+
+int32_t ObstacleGrid::cell_index(const float32_t coordinate) const noexcept
+{
+  // Clamp so that the cast is defined for far away and non-finite coordinates
+  constexpr auto LIMIT = 1.0e9F;
+  const auto index = std::floor(coordinate / m_cell_size);
+  return static_cast<int32_t>(std::isnan(index) ? 0.0F : std::max(-LIMIT, std::min(index, LIMIT)));
+}
+
+uint64_t ObstacleGrid::cell_key(const int32_t x_index, const int32_t y_index) noexcept
+{
+  return (static_cast<uint64_t>(static_cast<uint32_t>(x_index)) << 32U) |
+         static_cast<uint64_t>(static_cast<uint32_t>(y_index));
+}
+
+}  // namespace object_collision_estimator
+}  // namespace planning
+}  // namespace motion
@@ -0,0 +1,172 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <geometry/intersection.hpp>
+#include <geometry_msgs/msg/point32.hpp>
+#include <geometry_msgs/msg/quaternion.hpp>
+#include <common/types.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+#include "object_collision_estimator/occupancy_layer.hpp"
+
+namespace motion
+{
+namespace planning
+{
+namespace object_collision_estimator
+{
+
+using geometry_msgs::msg::Point32;
+
+namespace
+{
+float64_t yaw(const geometry_msgs::msg::Quaternion & q) noexcept
+{
+  return std::atan2(2.0 * ((q.w * q.z) + (q.x * q.y)), 1.0 - (2.0 * ((q.y * q.y) + (q.z * q.z))));
+}
+
+Point32 make_point(const float64_t x, const float64_t y) noexcept
+{
+  Point32 pt{};
+  pt.x = static_cast<float32_t>(x);
+  pt.y = static_cast<float32_t>(y);
+  return pt;
+}
+}  // namespace
+
+OccupancyLayer::OccupancyLayer(const int8_t occupied_threshold) noexcept
+: m_occupied_threshold{occupied_threshold}
+{
+}
+
+void OccupancyLayer::update(
+  const OccupancyGrid & grid, const geometry_msgs::msg::Transform & to_grid)
+{
+  m_width = grid.info.width;
+  m_height = grid.info.height;
+  if ((grid.info.resolution <= 0.0F) || (grid.data.size() != (m_width * m_height))) {
+    // A malformed grid has no occupied cell rather than some at the wrong place
+    clear();
+    return;
+  }
+  m_cells.assign(grid.data.begin(), grid.data.end());
+
+  // The cell coordinates are the ones of the frame of the grid, moved to the origin of the grid,
+  // rotated by its orientation and scaled by its resolution
+  const auto & origin = grid.info.origin;
+  const auto origin_yaw = yaw(origin.orientation);
+  const auto yaw_to_cells = yaw(to_grid.rotation) - origin_yaw;
+  const auto scale = 1.0 / static_cast<float64_t>(grid.info.resolution);
+  m_cos = std::cos(yaw_to_cells) * scale;
+  m_sin = std::sin(yaw_to_cells) * scale;
+  const auto dx = to_grid.translation.x - origin.position.x;
+  const auto dy = to_grid.translation.y - origin.position.y;
+  const auto origin_cos = std::cos(origin_yaw);
+  const auto origin_sin = std::sin(origin_yaw);
+  m_col_offset = ((origin_cos * dx) + (origin_sin * dy)) * scale;
+  m_row_offset = ((origin_cos * dy) - (origin_sin * dx)) * scale;
+}
+
+void OccupancyLayer::clear() noexcept
+{
+  m_cells.clear();
+  m_width = 0U;
+  m_height = 0U;
+}
+
+bool8_t OccupancyLayer::occupied(const float32_t x, const float32_t y) const noexcept
+{
+  float64_t col = 0.0;
+  float64_t row = 0.0;
+  to_cell(x, y, col, row);
+  // Also rejects NaN
+  if (!((col >= 0.0) && (row >= 0.0) && (col < static_cast<float64_t>(m_width)) &&
+    (row < static_cast<float64_t>(m_height))))
+  {
+    return false;
+  }
+  return is_occupied(static_cast<std::size_t>(col), static_cast<std::size_t>(row));
+}
+
+bool8_t OccupancyLayer::overlaps(const BoundingBox & box) const noexcept
+{
+  if (empty()) {
+    return false;
+  }
+  std::array<Point32, 4U> corners{};
+  auto min_col = std::numeric_limits<float64_t>::max();
+  auto min_row = std::numeric_limits<float64_t>::max();
+  auto max_col = std::numeric_limits<float64_t>::lowest();
+  auto max_row = std::numeric_limits<float64_t>::lowest();
+  for (std::size_t idx = 0U; idx < corners.size(); ++idx) {
+    float64_t col = 0.0;
+    float64_t row = 0.0;
+    to_cell(box.corners[idx].x, box.corners[idx].y, col, row);
+    corners[idx] = make_point(col, row);
+    min_col = std::min(min_col, col);
+    min_row = std::min(min_row, row);
+    max_col = std::max(max_col, col);
+    max_row = std::max(max_row, row);
+  }
+  const auto width = static_cast<float64_t>(m_width);
+  const auto height = static_cast<float64_t>(m_height);
+  // Also rejects NaN
+  if (!((max_col >= 0.0) && (max_row >= 0.0) && (min_col < width) && (min_row < height))) {
+    return false;
+  }
+  const auto col_begin = static_cast<std::size_t>(std::max(min_col, 0.0));
+  const auto row_begin = static_cast<std::size_t>(std::max(min_row, 0.0));
+  const auto col_end = static_cast<std::size_t>(std::min(std::floor(max_col) + 1.0, width));
+  const auto row_end = static_cast<std::size_t>(std::min(std::floor(max_row) + 1.0, height));
+  for (auto row = row_begin; row < row_end; ++row) {
+    for (auto col = col_begin; col < col_end; ++col) {
+      if (!is_occupied(col, row)) {
+        continue;
+      }
+      // The cells of the axis-aligned box can still be outside of a rotated box
+      const auto x = static_cast<float64_t>(col);
+      const auto y = static_cast<float64_t>(row);
+      const std::array<Point32, 4U> cell{
+        make_point(x, y), make_point(x + 1.0, y), make_point(x + 1.0, y + 1.0),
+        make_point(x, y + 1.0)};
+      if (autoware::common::geometry::intersect(corners, cell)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void OccupancyLayer::to_cell(
+  const float32_t x, const float32_t y, float64_t & col, float64_t & row) const noexcept
+{
+  const auto px = static_cast<float64_t>(x);
+  const auto py = static_cast<float64_t>(y);
+  col = ((m_cos * px) - (m_sin * py)) + m_col_offset;
+  row = ((m_sin * px) + (m_cos * py)) + m_row_offset;
+}
+
+bool8_t OccupancyLayer::is_occupied(const std::size_t col, const std::size_t row) const noexcept
+{
+  const auto value = m_cells[(row * m_width) + col];
+  // Unknown cells are -1
+  return (value >= 0) && (value >= m_occupied_threshold);
+}
+
+}  // namespace object_collision_estimator
+}  // namespace planning
+}  // namespace motion
@@ -17,11 +17,17 @@
 #include <common/types.hpp>
 #include <gtest/gtest.h>
 #include <chrono>
+#include <cmath>
+#include <vector>
 
 #include "object_collision_estimator/object_collision_estimator.hpp"
 
 using motion::planning::object_collision_estimator::ObjectCollisionEstimator;
 using motion::planning::object_collision_estimator::ObjectCollisionEstimatorConfig;
+using motion::planning::object_collision_estimator::AxisAlignedBox;
+using motion::planning::object_collision_estimator::ObstacleGrid;
+using motion::planning::object_collision_estimator::OccupancyLayer;
+using motion::planning::object_collision_estimator::trackedObjectsToObstacles;
 using motion::planning::trajectory_smoother::TrajectorySmoother;
 using motion::motion_testing::constant_velocity_trajectory;
 using autoware::common::types::float32_t;
@@ -30,6 +36,7 @@ using autoware_auto_msgs::msg::Trajectory;
 using autoware_auto_msgs::msg::TrajectoryPoint;
 using autoware_auto_msgs::msg::BoundingBox;
 using autoware_auto_msgs::msg::BoundingBoxArray;
+using autoware_auto_msgs::msg::TrackedObjects;
 
 const auto make_point(const float32_t x, const float32_t y)
 {
@@ -39,6 +46,20 @@ const auto make_point(const float32_t x, const float32_t y)
   return p;
 }
 
+BoundingBox make_square(const float32_t x, const float32_t y, const float32_t size)
+{
+  BoundingBox box{};
+  box.centroid = make_point(x, y);
+  box.size = make_point(size, size);
+  box.corners = {
+    make_point(x - size / 2, y - size / 2),
+    make_point(x + size / 2, y - size / 2),
+    make_point(x + size / 2, y + size / 2),
+    make_point(x - size / 2, y + size / 2)
+  };
+  return box;
+}
+
 void object_collision_estimator_test(
   std::size_t trajectory_length,
   std::size_t obstacle_bbox_idx,
@@ -60,6 +81,9 @@ void object_collision_estimator_test(
     1.1,  // safety factor
     0.0,  // stop_margin
     0.0004,  // min_obstacle_dimension_m
+    0.0,  // prediction_horizon_s
+    1.0,  // prediction_time_step_s
+    65,  // occupied_threshold
   };
   TrajectorySmoother smoother{{5, 25}};
 
@@ -161,3 +185,253 @@ TEST(object_collision_estimator, no_obstacle) {
 TEST(object_collision_estimator, small_obstacle) {
   object_collision_estimator_test(100, 40, 0.0003);
 }
+
+TEST(obstacle_grid, query) {
+  BoundingBoxArray obstacles{};
+  // Spans 4 cells
+  obstacles.boxes.push_back(make_square(0.0F, 0.0F, 2.0F));
+  obstacles.boxes.push_back(make_square(5.5F, 5.5F, 1.0F));
+  obstacles.boxes.push_back(make_square(-50.0F, 20.0F, 1.0F));
+  // Spans too many cells to be stored in them
+  obstacles.boxes.push_back(make_square(500.0F, 500.0F, 1000.0F));
+
+  ObstacleGrid grid{4.0F};
+  grid.build(obstacles);
+  EXPECT_EQ(grid.size(), 4U);
+
+  std::vector<std::size_t> candidates;
+  grid.query(AxisAlignedBox{-0.5F, -0.5F, 6.0F, 6.0F}, candidates);
+  EXPECT_EQ(candidates, (std::vector<std::size_t>{0U, 1U, 3U}));
+
+  // Overlaps the cells of the first obstacle but not its box
+  grid.query(AxisAlignedBox{-3.0F, -3.0F, -2.0F, -2.0F}, candidates);
+  EXPECT_TRUE(candidates.empty());
+
+  grid.query(AxisAlignedBox{-51.0F, 19.0F, -49.0F, 21.0F}, candidates);
+  EXPECT_EQ(candidates, (std::vector<std::size_t>{2U}));
+
+  // Queries spanning many cells test all obstacles
+  grid.query(AxisAlignedBox{-100.0F, -100.0F, 100.0F, 100.0F}, candidates);
+  EXPECT_EQ(candidates.size(), 4U);
+
+  grid.build(BoundingBoxArray{});
+  grid.query(AxisAlignedBox{-0.5F, -0.5F, 6.0F, 6.0F}, candidates);
+  EXPECT_TRUE(candidates.empty());
+}
+
+TEST(object_collision_estimator, many_obstacles) {
+  ObjectCollisionEstimatorConfig config{
+    {1, 1, 0, 0, 1000, 0, 2, 0.5, 0.5},
+    1.1,  // safety factor
+    0.0,  // stop_margin
+    0.0004,  // min_obstacle_dimension_m
+    0.0,  // prediction_horizon_s
+    1.0,  // prediction_time_step_s
+    65,  // occupied_threshold
+  };
+  ObjectCollisionEstimator estimator{config, TrajectorySmoother{{5, 25}}};
+  const std::chrono::milliseconds dt(100);
+  auto trajectory = constant_velocity_trajectory(
+    0, 0, 1, 10,
+    std::chrono::duration_cast<std::chrono::nanoseconds>(dt));
+  trajectory.points.resize(100U);
+
+  // Obstacles 5m on both sides of the trajectory, whose heading is 1 rad, and one blocking it
+  BoundingBoxArray obstacles{};
+  const auto offset_x = -5.0F * std::sin(1.0F);
+  const auto offset_y = 5.0F * std::cos(1.0F);
+  for (const auto & pt : trajectory.points) {
+    obstacles.boxes.push_back(make_square(pt.x + offset_x, pt.y + offset_y, 0.5F));
+    obstacles.boxes.push_back(make_square(pt.x - offset_x, pt.y - offset_y, 0.5F));
+  }
+  const auto & blocking_point = trajectory.points[60U];
+  obstacles.boxes.push_back(make_square(blocking_point.x, blocking_point.y, 0.5F));
+
+  (void)estimator.updateObstacles(obstacles);
+  estimator.updatePlan(trajectory);
+  EXPECT_EQ(trajectory.points.size(), 59U);
+  EXPECT_EQ(estimator.getTrajectoryBoundingBox().boxes.size(), 100U);
+}
+
+TEST(obstacle_grid, moving_obstacles) {
+  BoundingBoxArray obstacles{};
+  obstacles.boxes.push_back(make_square(0.0F, 0.0F, 1.0F));
+  obstacles.boxes.push_back(make_square(0.0F, 10.0F, 1.0F));
+  // Moves along x at 2 m/s, the other obstacle is static
+  std::vector<geometry_msgs::msg::Point32> velocities{make_point(2.0F, 0.0F)};
+
+  ObstacleGrid grid{4.0F, 0.5F};
+  grid.build(obstacles, velocities, 5.0F);
+  EXPECT_EQ(grid.size(), 2U);
+
+  std::vector<std::size_t> candidates;
+  const AxisAlignedBox start{-1.0F, -1.0F, 1.0F, 1.0F};
+  const AxisAlignedBox end{5.0F, -1.0F, 7.0F, 1.0F};
+  grid.query(start, 0.0F, candidates);
+  EXPECT_EQ(candidates, (std::vector<std::size_t>{0U}));
+  grid.query(end, 0.0F, candidates);
+  EXPECT_TRUE(candidates.empty());
+  grid.query(start, 3.0F, candidates);
+  EXPECT_TRUE(candidates.empty());
+  grid.query(end, 3.0F, candidates);
+  EXPECT_EQ(candidates, (std::vector<std::size_t>{0U}));
+  EXPECT_FLOAT_EQ(grid.displacement(0U, 3.0F).x, 6.0F);
+  EXPECT_FLOAT_EQ(grid.displacement(0U, 3.0F).y, 0.0F);
+
+  // The obstacle stops at the end of the horizon
+  EXPECT_FLOAT_EQ(grid.displacement(0U, 100.0F).x, 10.0F);
+  grid.query(AxisAlignedBox{9.0F, -1.0F, 11.0F, 1.0F}, 100.0F, candidates);
+  EXPECT_EQ(candidates, (std::vector<std::size_t>{0U}));
+
+  // Static obstacles are found at all times
+  grid.query(AxisAlignedBox{-1.0F, 9.0F, 1.0F, 11.0F}, 4.2F, candidates);
+  EXPECT_EQ(candidates, (std::vector<std::size_t>{1U}));
+  EXPECT_FLOAT_EQ(grid.displacement(1U, 4.2F).x, 0.0F);
+}
+
+TEST(object_collision_estimator, moving_obstacle) {
+  ObjectCollisionEstimatorConfig config{
+    {1, 1, 0, 0, 1000, 0, 2, 0.5, 0.5},
+    1.1,  // safety factor
+    0.0,  // stop_margin
+    0.0004,  // min_obstacle_dimension_m
+    10.0,  // prediction_horizon_s
+    0.5,  // prediction_time_step_s
+    65,  // occupied_threshold
+  };
+  ObjectCollisionEstimator estimator{config, TrajectorySmoother{{5, 25}}};
+  const std::chrono::milliseconds dt(100);
+  const auto original_trajectory = constant_velocity_trajectory(
+    0, 0, 0, 10,
+    std::chrono::duration_cast<std::chrono::nanoseconds>(dt));
+  ASSERT_EQ(original_trajectory.points.size(), 100U);
+
+  // An obstacle on the trajectory 60m ahead, which the vehicle reaches in 6s, and a tracked object
+  // with the same shape crossing the trajectory at 5 m/s, gone before the vehicle gets there
+  TrackedObjects objects{};
+  objects.header = original_trajectory.header;
+  objects.objects.resize(1U);
+  const auto square = make_square(60.0F, 0.0F, 1.0F);
+  objects.objects[0U].shape.resize(1U);
+  objects.objects[0U].shape[0U].polygon.points.assign(square.corners.begin(), square.corners.end());
+  objects.objects[0U].kinematics.twist.twist.linear.y = 5.0;
+  BoundingBoxArray obstacles{};
+  std::vector<geometry_msgs::msg::Point32> velocities;
+  trackedObjectsToObstacles(objects, obstacles, velocities);
+  ASSERT_EQ(obstacles.boxes.size(), 1U);
+  ASSERT_EQ(velocities.size(), 1U);
+  EXPECT_FLOAT_EQ(velocities[0U].y, 5.0F);
+
+  // Static, the obstacle blocks the trajectory
+  auto trajectory = original_trajectory;
+  (void)estimator.updateObstacles(obstacles);
+  estimator.updatePlan(trajectory);
+  EXPECT_LT(trajectory.points.size(), 60U);
+
+  // Moving, the trajectory stays free
+  trajectory = original_trajectory;
+  (void)estimator.updateObstacles(obstacles, velocities);
+  estimator.updatePlan(trajectory);
+  EXPECT_EQ(trajectory.points.size(), 100U);
+
+  // Moving towards the trajectory, the obstacle arrives when the vehicle does
+  velocities[0U].y = 0.0F;
+  velocities[0U].x = -5.0F;
+  obstacles.boxes[0U] = make_square(90.0F, 0.0F, 1.0F);
+  trajectory = original_trajectory;
+  (void)estimator.updateObstacles(obstacles, velocities);
+  estimator.updatePlan(trajectory);
+  EXPECT_LT(trajectory.points.size(), 61U);
+  EXPECT_GT(trajectory.points.size(), 55U);
+}
+
+TEST(occupancy_layer, lookup) {
+  // A rotated 10 x 10 grid of 0.5 m cells, one occupied, one free and one unknown cell, with the
+  // queries in a frame shifted by 1 m in x from the one of the grid
+  nav_msgs::msg::OccupancyGrid grid{};
+  grid.info.resolution = 0.5F;
+  grid.info.width = 10U;
+  grid.info.height = 10U;
+  grid.info.origin.position.x = 2.0;
+  grid.info.origin.position.y = -1.0;
+  grid.info.origin.orientation.w = std::cos(M_PI / 4.0);
+  grid.info.origin.orientation.z = std::sin(M_PI / 4.0);
+  grid.data.assign(100U, 0);
+  // cell (col 4, row 2), around (2.0 - 1.25, -1.0 + 2.25) in the frame of the grid
+  grid.data[(2U * 10U) + 4U] = 100;
+  grid.data[(2U * 10U) + 5U] = -1;
+  geometry_msgs::msg::Transform to_grid{};
+  to_grid.translation.x = 1.0;
+  to_grid.rotation.w = 1.0;
+
+  OccupancyLayer layer{65};
+  EXPECT_TRUE(layer.empty());
+  EXPECT_FALSE(layer.occupied(-0.25F, 1.25F));
+  layer.update(grid, to_grid);
+  EXPECT_FALSE(layer.empty());
+  EXPECT_TRUE(layer.occupied(-0.25F, 1.25F));
+  EXPECT_FALSE(layer.occupied(-0.25F, 1.75F));
+  EXPECT_FALSE(layer.occupied(-0.25F, 2.75F));
+  EXPECT_FALSE(layer.occupied(100.0F, 1.25F));
+  // A box next to the cell, and moved over its corner
+  auto box = make_square(-0.25F, 0.7F, 0.5F);
+  EXPECT_FALSE(layer.overlaps(box));
+  box = make_square(-0.5F, 0.9F, 0.5F);
+  EXPECT_TRUE(layer.overlaps(box));
+  // A box rotated by 45 degrees off the corner of the cell, whose axis-aligned box covers it
+  const auto half_diagonal = 0.5F / std::sqrt(2.0F);
+  box.corners = {
+    make_point(0.25F - half_diagonal, 0.75F),
+    make_point(0.25F, 0.75F - half_diagonal),
+    make_point(0.25F + half_diagonal, 0.75F),
+    make_point(0.25F, 0.75F + half_diagonal)};
+  EXPECT_FALSE(layer.overlaps(box));
+
+  layer.clear();
+  EXPECT_FALSE(layer.occupied(-0.25F, 1.25F));
+  // Malformed grids are ignored
+  grid.data.resize(99U);
+  layer.update(grid, to_grid);
+  EXPECT_TRUE(layer.empty());
+}
+
+TEST(object_collision_estimator, occupancy_grid) {
+  ObjectCollisionEstimatorConfig config{
+    {1, 1, 0, 0, 1000, 0, 2, 0.5, 0.5},
+    1.1,  // safety factor
+    0.0,  // stop_margin
+    0.0004,  // min_obstacle_dimension_m
+    0.0,  // prediction_horizon_s
+    1.0,  // prediction_time_step_s
+    65,  // occupied_threshold
+  };
+  ObjectCollisionEstimator estimator{config, TrajectorySmoother{{5, 25}}};
+  const std::chrono::milliseconds dt(100);
+  const auto original_trajectory = constant_velocity_trajectory(
+    0, 0, 0, 10,
+    std::chrono::duration_cast<std::chrono::nanoseconds>(dt));
+  ASSERT_EQ(original_trajectory.points.size(), 100U);
+
+  // A grid of 1 m cells from (0, -50) in the frame of the trajectory, with an occupied cell on the
+  // trajectory 60 m ahead
+  nav_msgs::msg::OccupancyGrid grid{};
+  grid.info.resolution = 1.0F;
+  grid.info.width = 100U;
+  grid.info.height = 100U;
+  grid.info.origin.position.y = -50.0;
+  grid.info.origin.orientation.w = 1.0;
+  grid.data.assign(10000U, -1);
+  geometry_msgs::msg::Transform to_grid{};
+  to_grid.rotation.w = 1.0;
+  estimator.updateOccupancyGrid(grid, to_grid);
+  auto trajectory = original_trajectory;
+  estimator.updatePlan(trajectory);
+  EXPECT_EQ(trajectory.points.size(), 100U);
+
+  grid.data[(50U * 100U) + 60U] = 100;
+  estimator.updateOccupancyGrid(grid, to_grid);
+  trajectory = original_trajectory;
+  estimator.updatePlan(trajectory);
+  EXPECT_LT(trajectory.points.size(), 60U);
+  EXPECT_GT(trajectory.points.size(), 50U);
+}
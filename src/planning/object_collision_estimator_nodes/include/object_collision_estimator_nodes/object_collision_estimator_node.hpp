@@ -14,6 +14,10 @@
 
 #include <autoware_auto_msgs/srv/modify_trajectory.hpp>
 #include <autoware_auto_msgs/msg/bounding_box_array.hpp>
+#include <autoware_auto_msgs/msg/tracked_objects.hpp>
+#include <geometry_msgs/msg/point32.hpp>
+#include <latency_tracing/tracer.hpp>
+#include <nav_msgs/msg/occupancy_grid.hpp>
 #include <visualization_msgs/msg/marker_array.hpp>
 #include <visualization_msgs/msg/marker.hpp>
 #include <tf2_ros/transform_listener.h>
@@ -21,6 +25,7 @@
 #include <rclcpp/rclcpp.hpp>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "object_collision_estimator/object_collision_estimator.hpp"
 #include "object_collision_estimator_nodes/visibility_control.hpp"
@@ -37,6 +42,9 @@ namespace object_collision_estimator_nodes
 
 using motion::planning::object_collision_estimator::ObjectCollisionEstimator;
 using autoware_auto_msgs::msg::BoundingBoxArray;
+using autoware_auto_msgs::msg::TrackedObjects;
+using geometry_msgs::msg::Point32;
+using nav_msgs::msg::OccupancyGrid;
 using visualization_msgs::msg::MarkerArray;
 using visualization_msgs::msg::Marker;
 
@@ -65,18 +73,40 @@ private:
   /// \brief Pointer to the subscriber listening for a list of obstacles
   rclcpp::Subscription<BoundingBoxArray>::SharedPtr m_obstacles_sub{nullptr};
 
+  /// \brief Pointer to the subscriber listening for tracked objects, used instead of the
+  ///        obstacles when they are predicted
+  rclcpp::Subscription<TrackedObjects>::SharedPtr m_tracked_objects_sub{nullptr};
+
+  /// \brief Pointer to the subscriber listening for an occupancy grid, whose occupied cells are
+  ///        obstacles as well
+  rclcpp::Subscription<OccupancyGrid>::SharedPtr m_occupancy_grid_sub{nullptr};
+
   /// \brief Pointer to the publisher for bounding boxes of the target trajectory
   rclcpp::Publisher<MarkerArray>::SharedPtr m_trajectory_bbox_pub{nullptr};
 
   /// \brief Helper function to handle modified bounding boxes when updating the obstacles.
   /// \param[in] bbox_array An array of bounding boxes representing a list of obstacles
-  void update_obstacles(const BoundingBoxArray & bbox_array);
+  /// \param[in] velocities The velocity of each obstacle, empty for static obstacles
+  void update_obstacles(
+    const BoundingBoxArray & bbox_array,
+    const std::vector<Point32> & velocities);
 
   /// \brief Callback function for the obstacles topic
   /// \param[in] msg ROS2 message from the obstacle topic containing an array of bounding boxes
   ///                representing obstacles found by the perception pipeline.
   void on_bounding_box(const BoundingBoxArray::SharedPtr & msg);
 
+  /// \brief Callback function for the tracked objects topic
+  /// \param[in] msg ROS2 message from the tracked objects topic. The objects are transformed into
+  ///                the target frame with the transform at their stamp, they are dropped if it
+  ///                isn't available.
+  void on_tracked_objects(const TrackedObjects::SharedPtr & msg);
+
+  /// \brief Callback function for the occupancy grid topic
+  /// \param[in] msg The occupancy grid. It is used with the transform from the target frame to
+  ///                its frame at its stamp, it is dropped if it isn't available.
+  void on_occupancy_grid(const OccupancyGrid::SharedPtr & msg);
+
   /// \brief Pointer to an instance of object collision estimator. It performs the main task of
   ///        estimating collisions and modifying the trajectory.
   std::unique_ptr<ObjectCollisionEstimator> m_estimator{nullptr};
@@ -107,12 +137,25 @@ private:
   /// \brief The staleness threshold for objects in milliseconds
   std::chrono::milliseconds m_staleness_threshold_ms{};
 
+  /// \brief The stage of the obstacle updates in the latency traces
+  autoware::common::latency_tracing::StageId m_obstacles_trace_stage{0U};
+
+  /// \brief The stage of the collision estimations in the latency traces, which link the last
+  ///        obstacles to the trajectory
+  autoware::common::latency_tracing::StageId m_estimation_trace_stage{0U};
+
   /// \brief Hard coded node name
   static constexpr const char * OBJECT_COLLISION_ESTIMATOR_NODE_NAME =
     "object_collision_estimator_node";
 
   /// \brief Hard coded topic name on which obstacle bounding boxes are received.
   static constexpr const char * OBSTACLE_TOPIC = "obstacle_topic";
+
+  /// \brief Hard coded topic name on which tracked objects are received.
+  static constexpr const char * TRACKED_OBJECTS_TOPIC = "tracked_objects";
+
+  /// \brief Hard coded topic name on which the occupancy grid is received.
+  static constexpr const char * OCCUPANCY_GRID_TOPIC = "occupancy_grid";
 };
 
 }  // namespace object_collision_estimator_nodes
@@ -20,6 +20,8 @@
 #include <common/types.hpp>
 #include <string>
 #include <memory>
+#include <stdexcept>
+#include <vector>
 
 #include "object_collision_estimator_nodes/object_collision_estimator_node.hpp"
 #include "object_collision_estimator_nodes/visualize.hpp"
@@ -35,6 +37,7 @@ namespace object_collision_estimator_nodes
 using namespace std::chrono_literals;
 using motion::planning::object_collision_estimator::ObjectCollisionEstimatorConfig;
 using motion::planning::object_collision_estimator::ObjectCollisionEstimator;
+using motion::planning::object_collision_estimator::trackedObjectsToObstacles;
 using motion::planning::trajectory_smoother::TrajectorySmootherConfig;
 using motion::planning::trajectory_smoother::TrajectorySmoother;
 using motion::motion_common::VehicleConfig;
@@ -90,7 +93,7 @@ ObjectCollisionEstimatorNode::ObjectCollisionEstimatorNode(const rclcpp::NodeOpt
     static_cast<float32_t>(declare_parameter(
       "min_obstacle_dimension_m"
     ).get<float32_t>());
-  const TrajectorySmootherConfig smoother_config {
+  TrajectorySmootherConfig smoother_config {
     static_cast<float32_t>(declare_parameter(
       "trajectory_smoother.kernel_std"
     ).get<float32_t>()),
@@ -98,6 +101,15 @@ ObjectCollisionEstimatorNode::ObjectCollisionEstimatorNode(const rclcpp::NodeOpt
       "trajectory_smoother.kernel_size"
     ).get<uint32_t>())
   };
+  // Optional smoothing within acceleration and jerk limits instead of the gaussian filter
+  smoother_config.mode = motion::planning::trajectory_smoother::smoothing_mode_from_string(
+    declare_parameter("trajectory_smoother.mode", std::string{"gaussian"}));
+  smoother_config.max_acceleration_mps2 = static_cast<float32_t>(
+    declare_parameter("trajectory_smoother.max_acceleration_mps2", 1.0));
+  smoother_config.max_deceleration_mps2 = static_cast<float32_t>(
+    declare_parameter("trajectory_smoother.max_deceleration_mps2", 2.0));
+  smoother_config.max_jerk_mps3 = static_cast<float32_t>(
+    declare_parameter("trajectory_smoother.max_jerk_mps3", 1.0));
 
   // Object staleness time threshold
   m_staleness_threshold_ms = std::chrono::milliseconds(
@@ -112,12 +124,32 @@ ObjectCollisionEstimatorNode::ObjectCollisionEstimatorNode(const rclcpp::NodeOpt
       "target_frame_id"
     ).get<std::string>());
 
+  // Optional prediction of the obstacles from their tracked velocity
+  const auto prediction_enabled = declare_parameter("prediction.enabled", false);
+  const auto prediction_horizon_s =
+    static_cast<float32_t>(declare_parameter("prediction.horizon_s", 5.0));
+  const auto prediction_time_step_s =
+    static_cast<float32_t>(declare_parameter("prediction.time_step_s", 0.5));
+
+  // Optional occupancy grid, e.g. of the nonground points, in addition to the obstacles
+  const auto occupancy_grid_enabled = declare_parameter("occupancy_grid.enabled", false);
+  const auto occupied_threshold = declare_parameter("occupancy_grid.occupied_threshold", 65);
+  if ((occupied_threshold < 0) || (occupied_threshold > 100)) {
+    throw std::domain_error{"occupancy_grid.occupied_threshold must be in [0, 100]"};
+  }
+
   // Create an object collision estimator
   const ObjectCollisionEstimatorConfig config {vehicle_param, safety_factor, stop_margin,
-    min_obstacle_dimension_m};
+    min_obstacle_dimension_m, prediction_horizon_s, prediction_time_step_s,
+    static_cast<int8_t>(occupied_threshold)};
   const TrajectorySmoother smoother{smoother_config};
   m_estimator = std::make_unique<ObjectCollisionEstimator>(config, smoother);
 
+  auto & tracer = autoware::common::latency_tracing::Tracer::instance();
+  m_obstacles_trace_stage = tracer.register_stage(get_fully_qualified_name());
+  m_estimation_trace_stage =
+    tracer.register_stage(std::string{get_fully_qualified_name()} + "/estimate_collision");
+
   // Set up service interface for collision_detection
   m_service_interface = create_service<autoware_auto_msgs::srv::ModifyTrajectory>(
     "estimate_collision",
@@ -126,10 +158,23 @@ ObjectCollisionEstimatorNode::ObjectCollisionEstimatorNode(const rclcpp::NodeOpt
       estimate_collision(request, response);
     });
 
-  // Create subscriber and subscribe to the obstacles topic
-  m_obstacles_sub = Node::create_subscription<BoundingBoxArray>(
-    OBSTACLE_TOPIC, QoS{10},
-    [this](const BoundingBoxArray::SharedPtr msg) {this->on_bounding_box(msg);});
+  // Create subscriber and subscribe to the obstacles topic, or to the tracked objects which have
+  // a velocity if the obstacles are predicted
+  if (prediction_enabled) {
+    m_tracked_objects_sub = Node::create_subscription<TrackedObjects>(
+      TRACKED_OBJECTS_TOPIC, QoS{10},
+      [this](const TrackedObjects::SharedPtr msg) {this->on_tracked_objects(msg);});
+  } else {
+    m_obstacles_sub = Node::create_subscription<BoundingBoxArray>(
+      OBSTACLE_TOPIC, QoS{10},
+      [this](const BoundingBoxArray::SharedPtr msg) {this->on_bounding_box(msg);});
+  }
+
+  if (occupancy_grid_enabled) {
+    m_occupancy_grid_sub = Node::create_subscription<OccupancyGrid>(
+      OCCUPANCY_GRID_TOPIC, QoS{1},
+      [this](const OccupancyGrid::SharedPtr msg) {this->on_occupancy_grid(msg);});
+  }
 
   m_trajectory_bbox_pub =
     create_publisher<MarkerArray>("debug/trajectory_bounding_boxes", QoS{10});
@@ -141,9 +186,11 @@ ObjectCollisionEstimatorNode::ObjectCollisionEstimatorNode(const rclcpp::NodeOpt
     std::shared_ptr<rclcpp::Node>(this, [](auto) {}), false);
 }
 
-void ObjectCollisionEstimatorNode::update_obstacles(const BoundingBoxArray & bbox_array)
+void ObjectCollisionEstimatorNode::update_obstacles(
+  const BoundingBoxArray & bbox_array,
+  const std::vector<Point32> & velocities)
 {
-  const auto modified_obstacles = m_estimator->updateObstacles(bbox_array);
+  const auto modified_obstacles = m_estimator->updateObstacles(bbox_array, velocities);
 
   for (const auto & modified_obstacle : modified_obstacles) {
     RCLCPP_WARN(
@@ -155,10 +202,13 @@ void ObjectCollisionEstimatorNode::update_obstacles(const BoundingBoxArray & bbo
 
 void ObjectCollisionEstimatorNode::on_bounding_box(const BoundingBoxArray::SharedPtr & msg)
 {
+  autoware::common::latency_tracing::TraceScope trace{
+    autoware::common::latency_tracing::Tracer::instance(), m_obstacles_trace_stage};
+  trace.set_trace_id(autoware::common::latency_tracing::to_trace_id(msg->header.stamp));
   // Update most recent bounding boxes internally
   if (msg->header.frame_id == m_target_frame_id) {
     // No transform needed, update bounding boxes directly
-    update_obstacles(*msg);
+    update_obstacles(*msg, {});
 
     // keep track of the timestamp of the lastest successful obstacle message
     m_last_obstacle_msg_time = msg->header.stamp;
@@ -190,7 +240,7 @@ void ObjectCollisionEstimatorNode::on_bounding_box(const BoundingBoxArray::Share
             this->m_wall_timer->cancel();
             this->m_wall_timer = nullptr;
             auto msg_transformed = this->m_tf_buffer->transform(*msg, m_target_frame_id);
-            update_obstacles(msg_transformed);
+            update_obstacles(msg_transformed, {});
 
             // keep track of the timestamp of the lastest successful obstacle message
             this->m_last_obstacle_msg_time = msg_transformed.header.stamp;
@@ -207,10 +257,73 @@ void ObjectCollisionEstimatorNode::on_bounding_box(const BoundingBoxArray::Share
   }
 }
 
+void ObjectCollisionEstimatorNode::on_tracked_objects(const TrackedObjects::SharedPtr & msg)
+{
+  autoware::common::latency_tracing::TraceScope trace{
+    autoware::common::latency_tracing::Tracer::instance(), m_obstacles_trace_stage};
+  trace.set_trace_id(autoware::common::latency_tracing::to_trace_id(msg->header.stamp));
+  BoundingBoxArray obstacles;
+  std::vector<Point32> velocities;
+  trackedObjectsToObstacles(*msg, obstacles, velocities);
+
+  if (obstacles.header.frame_id != m_target_frame_id) {
+    // The objects are predicted from their stamp, waiting for a transform would make them stale
+    geometry_msgs::msg::TransformStamped transform;
+    try {
+      transform = m_tf_buffer->lookupTransform(
+        m_target_frame_id, obstacles.header.frame_id,
+        tf2_ros::fromMsg(obstacles.header.stamp));
+    } catch (const tf2::TransformException & ex) {
+      RCLCPP_WARN(
+        this->get_logger(), "on_tracked_objects cannot transform %s to %s: %s",
+        obstacles.header.frame_id.c_str(), m_target_frame_id.c_str(), ex.what());
+      return;
+    }
+    tf2::doTransform(obstacles, obstacles, transform);
+    // Velocities are only rotated
+    transform.transform.translation = geometry_msgs::msg::Vector3{};
+    for (auto & velocity : velocities) {
+      tf2::doTransform(velocity, velocity, transform);
+    }
+  }
+  update_obstacles(obstacles, velocities);
+
+  // keep track of the timestamp of the lastest successful obstacle message
+  m_last_obstacle_msg_time = obstacles.header.stamp;
+}
+
+void ObjectCollisionEstimatorNode::on_occupancy_grid(const OccupancyGrid::SharedPtr & msg)
+{
+  // The queries come from the target frame, the grid stays in its own frame
+  geometry_msgs::msg::TransformStamped transform;
+  if (msg->header.frame_id == m_target_frame_id) {
+    transform.transform.rotation.w = 1.0;
+  } else {
+    try {
+      transform = m_tf_buffer->lookupTransform(
+        msg->header.frame_id, m_target_frame_id, tf2_ros::fromMsg(msg->header.stamp));
+    } catch (const tf2::TransformException & ex) {
+      RCLCPP_WARN(
+        this->get_logger(), "on_occupancy_grid cannot transform %s to %s: %s",
+        m_target_frame_id.c_str(), msg->header.frame_id.c_str(), ex.what());
+      return;
+    }
+  }
+  m_estimator->updateOccupancyGrid(*msg, transform.transform);
+}
+
 void ObjectCollisionEstimatorNode::estimate_collision(
   const std::shared_ptr<autoware_auto_msgs::srv::ModifyTrajectory::Request> request,
   std::shared_ptr<autoware_auto_msgs::srv::ModifyTrajectory::Response> response)
 {
+  // The trajectory continues the trace of the obstacles it was checked against
+  autoware::common::latency_tracing::TraceScope trace{
+    autoware::common::latency_tracing::Tracer::instance(), m_estimation_trace_stage};
+  trace.set_trace_id(
+    autoware::common::latency_tracing::to_trace_id(request->original_trajectory.header.stamp));
+  trace.link(
+    autoware::common::latency_tracing::to_trace_id(
+      static_cast<builtin_interfaces::msg::Time>(m_last_obstacle_msg_time)));
   rclcpp::Time request_time{request->original_trajectory.header.stamp,
     m_last_obstacle_msg_time.get_clock_type()};
   auto elapsed_time = request_time - m_last_obstacle_msg_time;
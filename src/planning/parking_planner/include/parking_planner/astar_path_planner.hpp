@@ -15,9 +15,13 @@
 #define PARKING_PLANNER__ASTAR_PATH_PLANNER_HPP_
 
 #include <common/types.hpp>
+#include <chrono>
 #include <cmath>
+#include <memory>
 #include <vector>
 
+#include "geometry.hpp"
+#include "heuristic_table.hpp"
 #include "parking_planner_types.hpp"
 #include "visibility_control.hpp"
 
@@ -35,22 +39,93 @@ static constexpr float64_t DELTA_LONGITUDINAL = 0.125;
 static const float64_t DELTA_HEADING = MY_PI / 24.0;
 static constexpr float64_t MAX_EXPLORATION_RADIUS = 30.0;
 static constexpr size_t MAX_NUM_EXPLORATION_NODES = 1000000;
+static constexpr float64_t DISTANCE_GRID_CELL_SIZE = 2.0 * DELTA_LONGITUDINAL;
+
+/// \brief Configuration of the A* path planner
+struct PARKING_PLANNER_PUBLIC AstarConfig
+{
+  /// Wall-clock time after which the planner returns the best path found so far. There is no
+  /// deadline if it is zero.
+  std::chrono::nanoseconds time_budget{std::chrono::nanoseconds::zero()};
+  /// Weight of the heuristic in the first search. A larger weight finds a path faster, at most
+  /// this factor longer than the shortest one. 1 is plain A*.
+  float64_t initial_epsilon{1.0};
+  /// Decrease of the weight after each path found, the searches stop after the one with weight 1
+  float64_t epsilon_decrement{0.5};
+  /// Obstacle-free cost to the goal, used as heuristic where it covers the states. The distance
+  /// to the goal is used everywhere if it is null.
+  std::shared_ptr<const HeuristicTable> heuristic_table{};
+};
+
+/// \brief Grid of the distance from the cell centers to the closest obstacle, used to classify
+///        vehicle positions as free or colliding at any heading without testing the polytopes.
+///        A position is free if the circle around the vehicle's rotation center enclosing its
+///        bounding box is clear of obstacles, and colliding if the circle inscribed in the box
+///        contains an obstacle.
+class PARKING_PLANNER_PUBLIC ObstacleDistanceGrid
+{
+public:
+  /// \brief Result of the classification of a vehicle position
+  enum class CollisionCheck
+  {
+    FREE,
+    COLLISION,
+    UNKNOWN  ///< The exact test is needed
+  };
+
+  /// \brief Precompute the distances in a square area
+  /// \param[in] vehicle_bounding_box Bounding box of the vehicle at the origin with heading 0
+  /// \param[in] obstacles List of bounding boxes of the obstacles
+  /// \param[in] center Center of the area
+  /// \param[in] half_size Half of the side length of the area
+  /// \param[in] cell_size Side length of the cells
+  ObstacleDistanceGrid(
+    const Polytope2D<float64_t> & vehicle_bounding_box,
+    const std::vector<Polytope2D<float64_t>> & obstacles,
+    const Point2D<float64_t> & center,
+    const float64_t half_size,
+    const float64_t cell_size);
+
+  /// \brief Classify a vehicle position in constant time
+  /// \param[in] position Position of the rotation center of the vehicle
+  /// \return The classification, UNKNOWN outside of the area
+  CollisionCheck check(const Point2D<float64_t> & position) const noexcept;
+
+private:
+  float64_t m_min_x;
+  float64_t m_min_y;
+  float64_t m_cell_size;
+  std::size_t m_num_cells;
+  /// Distance from the cell centers to any point of their cell
+  float64_t m_half_diagonal;
+  float64_t m_outer_radius;
+  float64_t m_inner_radius;
+  /// Distances are only computed up to this value, enough to classify positions as free
+  float64_t m_max_distance;
+  std::vector<float64_t> m_distances;
+};
 
 class PARKING_PLANNER_PUBLIC AstarPathPlanner
 {
 public:
-  /// \brief Create an A* path planner
+  /// \brief Create an A* path planner without deadline
   AstarPathPlanner() = default;
 
+  /// \brief Create an A* path planner
+  /// \param[in] config Configuration, see AstarConfig
+  explicit AstarPathPlanner(const AstarConfig & config);
+
   /// \brief Plan a collision-free but not necessarily dynamically feasible path from a given
-  ///        starting state to a given ending state.
+  ///        starting state to a given ending state. This is an anytime weighted A*: searches with
+  ///        a decreasing weight of the heuristic are run until the weight reaches 1 or the time
+  ///        budget runs out, and the shortest path found is returned.
   /// \param[in] current_state Starting vehicle state for the path planning
   /// \param[in] goal_state Desired final state for the path planning
   /// \param[in] vehicle_bounding_box Bounding box of the vehicle, used for collision checking
   /// \param[in] obstacles List of bounding boxes of the obstacles to be avoided
   /// \return A path is returned in all cases. On success, the path starts at current_state
-  //          and ends at goal_state. On failure, the path is length 1 and only contains the
-  //          current_state.
+  //          and ends at goal_state. On failure, including when no path was found before the
+  //          deadline, the path is length 1 and only contains the current_state.
   std::vector<VehicleState<float64_t>>
   plan_astar(
     const VehicleState<float64_t> & current_state,
@@ -58,8 +133,33 @@ public:
     const Polytope2D<float64_t> & vehicle_bounding_box,
     const std::vector<Polytope2D<float64_t>> & obstacles) const;
 
+  /// \brief Plan a path like the other overload, stopping at a given deadline at the latest
+  /// \param[in] current_state Starting vehicle state for the path planning
+  /// \param[in] goal_state Desired final state for the path planning
+  /// \param[in] vehicle_bounding_box Bounding box of the vehicle, used for collision checking
+  /// \param[in] obstacles List of bounding boxes of the obstacles to be avoided
+  /// \param[in] deadline Time after which the best path found so far is returned, the time
+  ///            budget of the configuration still applies if it ends earlier
+  /// \return The path, see the other overload
+  std::vector<VehicleState<float64_t>>
+  plan_astar(
+    const VehicleState<float64_t> & current_state,
+    const VehicleState<float64_t> & goal_state,
+    const Polytope2D<float64_t> & vehicle_bounding_box,
+    const std::vector<Polytope2D<float64_t>> & obstacles,
+    const std::chrono::steady_clock::time_point deadline) const;
+
 private:
-  // Currently no state
+  std::vector<VehicleState<float64_t>>
+  plan_astar(
+    const VehicleState<float64_t> & current_state,
+    const VehicleState<float64_t> & goal_state,
+    const Polytope2D<float64_t> & vehicle_bounding_box,
+    const std::vector<Polytope2D<float64_t>> & obstacles,
+    const bool has_deadline,
+    const std::chrono::steady_clock::time_point deadline) const;
+
+  AstarConfig m_config{};
 };
 
 }  // namespace parking_planner
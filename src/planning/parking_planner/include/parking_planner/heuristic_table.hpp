@@ -0,0 +1,96 @@
+// Copyright 2021 Embotech AG, Zurich, Switzerland. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef PARKING_PLANNER__HEURISTIC_TABLE_HPP_
+#define PARKING_PLANNER__HEURISTIC_TABLE_HPP_
+
+#include <common/types.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "visibility_control.hpp"
+
+namespace autoware
+{
+namespace motion
+{
+namespace planning
+{
+namespace parking_planner
+{
+using autoware::common::types::float64_t;
+
+/// \brief Half of the side length in meters of the area covered by the pregenerated table
+static constexpr float64_t DEFAULT_HEURISTIC_TABLE_HALF_SIZE = 8.0;
+
+/// \brief Table of the obstacle-free cost from a pose to the goal using the motion primitives of
+///        the A* path planner, over the poses relative to the goal. Unlike the distance to the
+///        goal, it accounts for the maneuvers needed to reach the goal heading.
+///        The table is generated offline by the build, see generate_heuristic_table.cpp, and
+///        loaded at run time.
+class PARKING_PLANNER_PUBLIC HeuristicTable
+{
+public:
+  /// \brief Compute the table with a breadth-first search backwards from the goal. States are
+  ///        discretized like in the A* search, with the continuous state of the first visit
+  ///        of a cell being expanded.
+  /// \param[in] half_size Half of the side length of the covered area in meters
+  explicit HeuristicTable(const float64_t half_size = DEFAULT_HEURISTIC_TABLE_HALF_SIZE);
+
+  /// \brief Load a table saved by save()
+  /// \param[in] path Path of the file
+  /// \return The table
+  /// \throw std::runtime_error If the file can't be read or was generated with different
+  ///        motion primitives
+  static HeuristicTable load(const std::string & path);
+
+  /// \brief Get the path of the table generated and installed by the build
+  /// \return The path of the installed table
+  static std::string default_path();
+
+  /// \brief Save the table
+  /// \param[in] path Path of the file
+  /// \throw std::runtime_error If the file can't be written
+  void save(const std::string & path) const;
+
+  /// \brief Look up the cost to the goal
+  /// \param[in] x Position of the vehicle along the goal heading, relative to the goal
+  /// \param[in] y Position of the vehicle across the goal heading, relative to the goal
+  /// \param[in] heading Heading of the vehicle relative to the goal heading
+  /// \param[out] cost Length of the shortest path to the goal
+  /// \return False if the pose isn't covered by the table
+  bool lookup(
+    const float64_t x, const float64_t y, const float64_t heading,
+    float64_t & cost) const noexcept;
+
+private:
+  /// Marks the cells that weren't reached
+  static constexpr uint16_t UNREACHED = UINT16_MAX;
+
+  std::size_t index(const float64_t x, const float64_t y, const float64_t heading) const noexcept;
+
+  /// Number of cells on each side of the goal cell
+  std::size_t m_half_num_positions{0U};
+  std::size_t m_num_positions{0U};
+  std::size_t m_num_headings{0U};
+  /// Number of motion primitives to the goal per cell
+  std::vector<uint16_t> m_steps{};
+};
+
+}  // namespace parking_planner
+}  // namespace planning
+}  // namespace motion
+}  // namespace autoware
+
+#endif  // PARKING_PLANNER__HEURISTIC_TABLE_HPP_
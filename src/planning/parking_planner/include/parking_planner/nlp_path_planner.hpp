@@ -37,17 +37,47 @@ namespace parking_planner
 {
 
 using autoware::common::types::float64_t;
+
+/// \brief Primal and dual solution of an NLP solve, used as initial guess of a later solve
+struct NLPWarmStart
+{
+  /// Optimization variables, the trajectory followed by the obstacle variables
+  std::vector<float64_t> m_variables;
+  /// Multipliers of the variable bounds, in the order of the variables
+  std::vector<float64_t> m_variable_multipliers;
+  /// Multipliers of the constraints
+  std::vector<float64_t> m_constraint_multipliers;
+  /// Number of obstacles of the solve, the obstacle variables only fit a problem with the same
+  /// obstacles
+  std::size_t m_num_obstacles;
+};
+
 struct NLPResults
 {
   // cppcheck-suppress syntaxError
   Trajectory<float64_t> m_trajectory;
   casadi::Dict m_solve_info;
+  NLPWarmStart m_warm_start;
+  /// Value of the cost function at the solution
+  float64_t m_cost;
 };
 
+/// \brief Shift a warm start forward in time, for a solve starting later along the trajectory.
+///        The variables of each stage take the values of the stage num_steps later, the last
+///        stage is repeated. The constraint multipliers are reset if the warm start is shifted,
+///        since the constraints aren't ordered by stage.
+/// \param[in] warm_start The solution of the previous solve
+/// \param[in] num_steps Number of stages the vehicle moved along the trajectory
+/// \return The shifted warm start
+PARKING_PLANNER_PUBLIC NLPWarmStart shift_warm_start(
+  const NLPWarmStart & warm_start, const std::size_t num_steps);
+
 class PARKING_PLANNER_PUBLIC NLPPathPlanner
 {
 public:
-  /// \brief Create an NLP-based trajectory planner
+  /// \brief Create an NLP-based trajectory planner. The solvers are loaded once and reused by
+  ///        all solves, so that a planner must not be used by several threads at once. The same
+  ///        applies to copies of it, which share the solvers.
   /// \param[in] cost_weights Cost function weight parameters
   /// \param[in] lower_state_bounds Lower bounds on the state variables, valid across the entire
   ///            horizon
@@ -83,6 +113,26 @@ public:
     const BicycleModelParameters<float64_t> & model_parameters
   ) const;
 
+  /// \brief Plan a dynamically feasible, collision-free path, starting the solver from the
+  ///        solution of a previous solve. This typically takes fewer iterations when replanning
+  ///        with the previous solution shifted by shift_warm_start().
+  /// \param[in] current_state Starting vehicle state for the path planning
+  /// \param[in] goal_state Desired final state for the path planning
+  /// \param[in] initial_guess Initial guess used instead of the warm start if the warm start
+  ///            doesn't fit the problem, i.e. its size or number of obstacles differ
+  /// \param[in] obstacles The obstacles to avoid
+  /// \param[in] model_parameters Physical model parameters of the vehicle
+  /// \param[in] warm_start Primal and dual solution of a previous solve
+  /// \return Planning results, see the other overload
+  NLPResults plan_nlp(
+    const VehicleState<float64_t> & current_state,
+    const VehicleState<float64_t> & goal_state,
+    const Trajectory<float64_t> & initial_guess,
+    const std::vector<Polytope2D<float64_t>> & obstacles,
+    const BicycleModelParameters<float64_t> & model_parameters,
+    const NLPWarmStart & warm_start
+  ) const;
+
   /// \brief Check a given trajectory for feasibility in terms of dynamics, variable bounds and
   ///        obstacle avoidance.
   /// \param[in] trajectory The trajectory to check
@@ -102,11 +152,25 @@ public:
   ) const;
 
 private:
+  /// Solve the NLP, with the warm start if it isn't null and fits the problem
+  NLPResults solve(
+    const VehicleState<float64_t> & current_state,
+    const VehicleState<float64_t> & goal_state,
+    const Trajectory<float64_t> & initial_guess,
+    const std::vector<Polytope2D<float64_t>> & obstacles,
+    const BicycleModelParameters<float64_t> & model_parameters,
+    const NLPWarmStart * const warm_start
+  ) const;
+
   NLPCostWeights<float64_t> m_cost_weights;
   VehicleState<float64_t> m_lower_state_bounds;
   VehicleState<float64_t> m_upper_state_bounds;
   VehicleCommand<float64_t> m_lower_command_bounds;
   VehicleCommand<float64_t> m_upper_command_bounds;
+  /// Solver started from the given initial guess with default multipliers
+  casadi::Function m_solver;
+  /// Solver started from the given initial guess and multipliers
+  casadi::Function m_warm_solver;
 };
 
 
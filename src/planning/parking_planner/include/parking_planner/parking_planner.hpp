@@ -23,6 +23,7 @@
 #include <autoware_auto_msgs/msg/trajectory.hpp>
 #include <common/types.hpp>
 #include <lanelet2_core/LaneletMap.h>
+#include <chrono>
 #include <vector>
 
 #include "astar_path_planner.hpp"
@@ -66,11 +67,15 @@ public:
   /// \param[in] nlp_iterations The number of iterations required by the solver
   /// \param[in] nlp_proc_time NLP process time, in seconds
   /// \param[in] status Status of the result
+  /// \param[in] warm_start Solution of the NLP, to warm start a replan
+  /// \param[in] nlp_cost Value of the NLP cost function at the solution
   PlanningResult(
     const Trajectory<float64_t> trajectory,
     const std::size_t nlp_iterations,
     const float64_t nlp_proc_time,
-    const PlanningStatus status);
+    const PlanningStatus status,
+    const NLPWarmStart & warm_start = NLPWarmStart{},
+    const float64_t nlp_cost = 0.0);
 
   const Trajectory<float64_t> & get_trajectory() const noexcept
   {
@@ -88,6 +93,14 @@ public:
   {
     return m_status;
   }
+  const NLPWarmStart & get_warm_start() const noexcept
+  {
+    return m_warm_start;
+  }
+  float64_t get_nlp_cost() const noexcept
+  {
+    return m_nlp_cost;
+  }
 
 private:
   /// Trajectory computed for this result
@@ -101,6 +114,12 @@ private:
 
   /// Status of the solution
   PlanningStatus m_status;
+
+  /// Primal and dual solution of the NLP
+  NLPWarmStart m_warm_start;
+
+  /// Cost of the solution of the NLP
+  float64_t m_nlp_cost;
 };  // class PlanningResult
 
 /// \brief Parking motion planner
@@ -115,13 +134,15 @@ public:
   /// \param[in] upper_state_bounds Upper bounds on the states (applied throught the horizon)
   /// \param[in] lower_command_bounds Lower bounds on the commands (applied throught the horizon)
   /// \param[in] upper_command_bounds Upper bounds on the commands (applied throught the horizon)
+  /// \param[in] astar_config Configuration of the A* planner finding the initial path
   ParkingPlanner(
     const BicycleModelParameters<float64_t> & parameters,
     const NLPCostWeights<float64_t> & nlp_weights,
     const VehicleState<float64_t> & lower_state_bounds,
     const VehicleState<float64_t> & upper_state_bounds,
     const VehicleCommand<float64_t> & lower_command_bounds,
-    const VehicleCommand<float64_t> & upper_command_bounds);
+    const VehicleCommand<float64_t> & upper_command_bounds,
+    const AstarConfig & astar_config = AstarConfig{});
 
   /// \brief Plan a maneuver in a synchronous manner. This call blocks.
   /// \param[in] current_state State of the vehicle at the start of the maneuver
@@ -133,6 +154,39 @@ public:
     const VehicleState<float64_t> & goal_state,
     const std::vector<Polytope2D<float64_t>> & obstacles) const;
 
+  /// \brief Replan a maneuver, starting the NLP from a previous solution instead of an A* path.
+  ///        The A* planner is only run if the warm start doesn't fit the problem, i.e. it was
+  ///        computed with a different number of obstacles. This call blocks.
+  /// \param[in] current_state State of the vehicle at the start of the maneuver
+  /// \param[in] goal_state State the vehicle should be in at the end of the maneuver
+  /// \param[in] obstacles List of static obstacles to avoid, in the form of polyhedra
+  /// \param[in] warm_start Solution of a previous plan, see PlanningResult::get_warm_start(),
+  ///            typically shifted with shift_warm_start() by the time since that plan
+  /// \return Result of the planning procedure
+  PlanningResult plan(
+    const VehicleState<float64_t> & current_state,
+    const VehicleState<float64_t> & goal_state,
+    const std::vector<Polytope2D<float64_t>> & obstacles,
+    const NLPWarmStart & warm_start) const;
+
+  /// \brief Plan a maneuver to the best of several goal states, e.g. forward and reverse entry
+  ///        into a parking spot. The A* searches for the goals run concurrently. The NLP starts
+  ///        with the first path found and the other paths as they come, one at a time, while the
+  ///        remaining searches continue. This call blocks.
+  /// \param[in] current_state State of the vehicle at the start of the maneuver
+  /// \param[in] goal_states The acceptable states at the end of the maneuver
+  /// \param[in] obstacles List of static obstacles to avoid, in the form of polyhedra
+  /// \param[in] time_budget Wall-clock time after which the searches stop and no new NLP is
+  ///            started once a feasible plan was found, no limit if zero. A running NLP is
+  ///            finished, so that the call can take longer.
+  /// \return The feasible result with the lowest NLP cost. If there is none, an unsuccessful
+  ///         result.
+  /// \throw std::domain_error If there are no goal states or the time budget is negative
+  PlanningResult plan(
+    const VehicleState<float64_t> & current_state,
+    const std::vector<VehicleState<float64_t>> & goal_states,
+    const std::vector<Polytope2D<float64_t>> & obstacles,
+    const std::chrono::nanoseconds time_budget) const;
 
   const BicycleModelParameters<float64_t> & get_parameters() const
   {
@@ -140,6 +194,21 @@ public:
   }
 
 private:
+  /// \brief Plan a maneuver, see the public overloads
+  PlanningResult plan(
+    const VehicleState<float64_t> & current_state,
+    const VehicleState<float64_t> & goal_state,
+    const std::vector<Polytope2D<float64_t>> & obstacles,
+    const NLPWarmStart * const warm_start) const;
+
+  /// \brief Run the NLP from an initial guess and check its solution
+  PlanningResult smooth(
+    const VehicleState<float64_t> & current_state,
+    const VehicleState<float64_t> & adapted_goal_state,
+    const Trajectory<float64_t> & trajectory_guess,
+    const std::vector<Polytope2D<float64_t>> & obstacles,
+    const NLPWarmStart * const warm_start) const;
+
   /// \brief Create a full Trajectory data structure from just a list of states. This is used
   ///        in the translation of the Astar output to an initial guess for the NLP. If the input
   ///        does not match the desired length, it is adapted to that length by simple means.
@@ -12,7 +12,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 #include <common/types.hpp>
+#include <chrono>
 #include <cmath>
+#include <limits>
+#include <stdexcept>
 #include <vector>
 #include <utility>
 #include <queue>
@@ -112,11 +115,171 @@ static uint64_t map_state_on_discretized_grid(
   return h_quant * num_position_steps * num_position_steps + y_quant * num_position_steps + x_quant;
 }
 
-std::vector<VehicleState<float64_t>> AstarPathPlanner::plan_astar(
+namespace
+{
+enum class SearchStatus
+{
+  FOUND,
+  NOT_FOUND,
+  TIMED_OUT
+};
+
+// Number of expansions between two checks of the clock
+constexpr size_t DEADLINE_CHECK_INTERVAL = 64;
+
+// Tolerance of the classification by the distance grid, so that rounding errors don't make
+// it disagree with the exact test at the boundary
+constexpr float64_t DISTANCE_GRID_TOLERANCE = 1.0e-6;
+
+bool inside_polygon(
+  const Point2D<float64_t> & point, const std::vector<Point2D<float64_t>> & vertices)
+{
+  // Crossing number, so that the order of the vertices doesn't matter
+  bool inside = false;
+  const auto & p = point.get_coord();
+  for (size_t i = 0, j = vertices.size() - 1; i < vertices.size(); j = i++) {
+    const auto & a = vertices[i].get_coord();
+    const auto & b = vertices[j].get_coord();
+    if (((a.second > p.second) != (b.second > p.second)) &&
+      (p.first < (b.first - a.first) * (p.second - a.second) / (b.second - a.second) + a.first))
+    {
+      inside = !inside;
+    }
+  }
+  return inside;
+}
+
+float64_t distance_to_segment(
+  const Point2D<float64_t> & point, const Point2D<float64_t> & a, const Point2D<float64_t> & b)
+{
+  const Point2D<float64_t> ab = b - a;
+  const float64_t length_squared = ab.dot(ab);
+  const float64_t t = (length_squared > 0.0) ?
+    std::max(0.0, std::min(1.0, (point - a).dot(ab) / length_squared)) : 0.0;
+  return (point - (a + ab * t)).norm2();
+}
+
+float64_t distance_to_polygon(
+  const Point2D<float64_t> & point, const std::vector<Point2D<float64_t>> & vertices)
+{
+  if (inside_polygon(point, vertices)) {
+    return 0.0;
+  }
+  float64_t distance = std::numeric_limits<float64_t>::max();
+  for (size_t i = 0, j = vertices.size() - 1; i < vertices.size(); j = i++) {
+    distance = std::min(distance, distance_to_segment(point, vertices[j], vertices[i]));
+  }
+  return distance;
+}
+}  // namespace
+
+ObstacleDistanceGrid::ObstacleDistanceGrid(
+  const Polytope2D<float64_t> & vehicle_bounding_box,
+  const std::vector<Polytope2D<float64_t>> & obstacles,
+  const Point2D<float64_t> & center,
+  const float64_t half_size,
+  const float64_t cell_size)
+: m_min_x{center.get_coord().first - half_size},
+  m_min_y{center.get_coord().second - half_size},
+  m_cell_size{cell_size},
+  m_num_cells{static_cast<std::size_t>(std::ceil(2.0 * half_size / cell_size))},
+  m_half_diagonal{cell_size * std::sqrt(0.5)},
+  m_outer_radius{0.0},
+  m_inner_radius{0.0}
+{
+  // The vehicle rotates around the origin of its bounding box
+  const Point2D<float64_t> origin{};
+  const auto & vehicle_vertices = vehicle_bounding_box.get_vertices();
+  for (const auto & vertex : vehicle_vertices) {
+    m_outer_radius = std::max(m_outer_radius, vertex.norm2());
+  }
+  if (!vehicle_vertices.empty() && inside_polygon(origin, vehicle_vertices)) {
+    m_inner_radius = std::numeric_limits<float64_t>::max();
+    for (size_t i = 0, j = vehicle_vertices.size() - 1; i < vehicle_vertices.size(); j = i++) {
+      m_inner_radius = std::min(
+        m_inner_radius, distance_to_segment(origin, vehicle_vertices[j], vehicle_vertices[i]));
+    }
+  }
+  m_max_distance = m_outer_radius + 2.0 * m_half_diagonal;
+  m_distances.assign(m_num_cells * m_num_cells, m_max_distance);
+
+  // Only the cells closer than the maximum distance to an obstacle are updated by it
+  const auto to_index = [this](const float64_t coordinate, const float64_t min) {
+      const auto index = std::floor((coordinate - min) / m_cell_size);
+      return static_cast<std::size_t>(
+        std::max(0.0, std::min(index, static_cast<float64_t>(m_num_cells) - 1.0)));
+    };
+  for (const auto & obstacle : obstacles) {
+    const auto & vertices = obstacle.get_vertices();
+    if (vertices.empty()) {
+      continue;
+    }
+    auto min_x = std::numeric_limits<float64_t>::max();
+    auto min_y = std::numeric_limits<float64_t>::max();
+    auto max_x = std::numeric_limits<float64_t>::lowest();
+    auto max_y = std::numeric_limits<float64_t>::lowest();
+    for (const auto & vertex : vertices) {
+      min_x = std::min(min_x, vertex.get_coord().first);
+      min_y = std::min(min_y, vertex.get_coord().second);
+      max_x = std::max(max_x, vertex.get_coord().first);
+      max_y = std::max(max_y, vertex.get_coord().second);
+    }
+    if ((max_x + m_max_distance < m_min_x) || (max_y + m_max_distance < m_min_y) ||
+      (min_x - m_max_distance > m_min_x + static_cast<float64_t>(m_num_cells) * m_cell_size) ||
+      (min_y - m_max_distance > m_min_y + static_cast<float64_t>(m_num_cells) * m_cell_size))
+    {
+      continue;
+    }
+    const auto first_x = to_index(min_x - m_max_distance, m_min_x);
+    const auto last_x = to_index(max_x + m_max_distance, m_min_x);
+    const auto first_y = to_index(min_y - m_max_distance, m_min_y);
+    const auto last_y = to_index(max_y + m_max_distance, m_min_y);
+    for (auto y_index = first_y; y_index <= last_y; ++y_index) {
+      for (auto x_index = first_x; x_index <= last_x; ++x_index) {
+        const Point2D<float64_t> cell_center{
+          m_min_x + (static_cast<float64_t>(x_index) + 0.5) * m_cell_size,
+          m_min_y + (static_cast<float64_t>(y_index) + 0.5) * m_cell_size};
+        auto & distance = m_distances[y_index * m_num_cells + x_index];
+        distance = std::min(distance, distance_to_polygon(cell_center, vertices));
+      }
+    }
+  }
+}
+
+ObstacleDistanceGrid::CollisionCheck ObstacleDistanceGrid::check(
+  const Point2D<float64_t> & position) const noexcept
+{
+  const auto x = std::floor((position.get_coord().first - m_min_x) / m_cell_size);
+  const auto y = std::floor((position.get_coord().second - m_min_y) / m_cell_size);
+  const auto num_cells = static_cast<float64_t>(m_num_cells);
+  if (!(x >= 0.0) || !(y >= 0.0) || !(x < num_cells) || !(y < num_cells)) {
+    return CollisionCheck::UNKNOWN;
+  }
+  // The distance from the position is within the half diagonal of the one from the cell center
+  const auto distance =
+    m_distances[static_cast<std::size_t>(y) * m_num_cells + static_cast<std::size_t>(x)];
+  if (distance - m_half_diagonal > m_outer_radius + DISTANCE_GRID_TOLERANCE) {
+    return CollisionCheck::FREE;
+  }
+  if (distance + m_half_diagonal < m_inner_radius - DISTANCE_GRID_TOLERANCE) {
+    return CollisionCheck::COLLISION;
+  }
+  return CollisionCheck::UNKNOWN;
+}
+
+/// Run a weighted A* search, the path is only set if the goal is found
+static SearchStatus search_astar(
   const VehicleState<float64_t> & current_state,
   const VehicleState<float64_t> & goal_state,
   const Polytope2D<float64_t> & vehicle_bounding_box,
-  const std::vector<Polytope2D<float64_t>> & obstacles) const
+  const std::vector<Polytope2D<float64_t>> & obstacles,
+  const ObstacleDistanceGrid & distance_grid,
+  const HeuristicTable * const heuristic_table,
+  const float64_t epsilon,
+  const bool has_deadline,
+  const std::chrono::steady_clock::time_point deadline,
+  std::vector<VehicleState<float64_t>> & path,
+  float64_t & path_cost)
 {
   // Prepare data structure definitions
   using StateTransition = std::pair<std::pair<VehicleState<float64_t>, VehicleState<float64_t>>,
@@ -140,6 +303,37 @@ std::vector<VehicleState<float64_t>> AstarPathPlanner::plan_astar(
   OpenSet open_set(my_compare_queue_element);
   ClosedSet closed_set;
 
+  const auto collides = [&](const VehicleState<float64_t> & state) {
+      switch (distance_grid.check(Point2D<float64_t>(state.get_x(), state.get_y()))) {
+        case ObstacleDistanceGrid::CollisionCheck::FREE:
+          return false;
+        case ObstacleDistanceGrid::CollisionCheck::COLLISION:
+          return true;
+        default:
+          return check_collision_bounding_box_vs_obstacles(state, vehicle_bounding_box, obstacles);
+      }
+    };
+
+  // The table accounts for the maneuvers to the goal heading, the distance is still larger
+  // where the table is coarse or doesn't cover the state
+  const auto cos_goal_heading = std::cos(goal_state.get_heading());
+  const auto sin_goal_heading = std::sin(goal_state.get_heading());
+  const auto heuristic = [&](const VehicleState<float64_t> & state, const float64_t dist_to_goal) {
+      float64_t table_cost = 0.0;
+      if (heuristic_table) {
+        const auto dx = state.get_x() - goal_state.get_x();
+        const auto dy = state.get_y() - goal_state.get_y();
+        if (heuristic_table->lookup(
+            cos_goal_heading * dx + sin_goal_heading * dy,
+            cos_goal_heading * dy - sin_goal_heading * dx,
+            state.get_heading() - goal_state.get_heading(), table_cost))
+        {
+          return std::max(dist_to_goal, table_cost);
+        }
+      }
+      return dist_to_goal;
+    };
+
   // Initialize data structures for the given problem data
   Point2D<float64_t> vect_current_to_goal = Point2D<float64_t>(
     current_state.get_x(),
@@ -149,13 +343,19 @@ std::vector<VehicleState<float64_t>> AstarPathPlanner::plan_astar(
   uint64_t current_discrete = map_state_on_discretized_grid(current_state, goal_state);
   uint64_t goal_discrete = map_state_on_discretized_grid(goal_state, goal_state);
   open_set.push(
-    {{dist_current_to_goal, 0},
+    {{epsilon * heuristic(current_state, dist_current_to_goal), 0},
       {{current_state, current_state},
         {current_discrete, current_discrete}}});
 
   // Run the main exploration loop
+  bool found = false;
   size_t num_nodes_left = parking_planner::MAX_NUM_EXPLORATION_NODES;
   while (!open_set.empty() && (0 != num_nodes_left--)) {
+    if (has_deadline && ((num_nodes_left % DEADLINE_CHECK_INTERVAL) == 0U) &&
+      (std::chrono::steady_clock::now() > deadline))
+    {
+      return SearchStatus::TIMED_OUT;
+    }
     QueueElement top_element = open_set.top();
     open_set.pop();
     const float64_t & f_cost = top_element.first.second;
@@ -165,10 +365,12 @@ std::vector<VehicleState<float64_t>> AstarPathPlanner::plan_astar(
     if (!closed_set.count(to_discrete)) {
       closed_set[to_discrete] = top_element.second;
       if (to_discrete == goal_discrete) {
+        found = true;
+        path_cost = f_cost;
         break;
       }
 
-      if (!check_collision_bounding_box_vs_obstacles(to_state, vehicle_bounding_box, obstacles)) {
+      if (!collides(to_state)) {
         const std::vector<VehicleState<float64_t>> expanded_states =
           expand_state_longitudinal_with_heading(to_state);
         for (const VehicleState<float64_t> & next_state : expanded_states) {
@@ -180,7 +382,7 @@ std::vector<VehicleState<float64_t>> AstarPathPlanner::plan_astar(
               Point2D<float64_t>(goal_state.get_x(), goal_state.get_y());
             float64_t dist_to_goal = vect_to_goal.norm2();
             if (dist_to_goal < parking_planner::MAX_EXPLORATION_RADIUS) {
-              float64_t next_g_cost = f_cost + dist_to_goal;
+              float64_t next_g_cost = f_cost + epsilon * heuristic(next_state, dist_to_goal);
               open_set.push(
                 {{next_g_cost, next_f_cost},
                   {{to_state, next_state},
@@ -191,18 +393,101 @@ std::vector<VehicleState<float64_t>> AstarPathPlanner::plan_astar(
       }
     }
   }
+  if (!found) {
+    return SearchStatus::NOT_FOUND;
+  }
 
   // Done exploring, assemble the output path from the results
-  std::vector<VehicleState<float64_t>> result;
+  path.clear();
   uint64_t destination_discrete = goal_discrete;
   while (0 != closed_set.count(destination_discrete) &&
     (destination_discrete != current_discrete))
   {
-    result.emplace_back(closed_set[destination_discrete].first.first);
+    path.emplace_back(closed_set[destination_discrete].first.first);
     destination_discrete = closed_set[destination_discrete].second.first;
   }
-  result.push_back(current_state);
-  std::reverse(result.begin(), result.end());
+  path.push_back(current_state);
+  std::reverse(path.begin(), path.end());
+  return SearchStatus::FOUND;
+}
+
+AstarPathPlanner::AstarPathPlanner(const AstarConfig & config)
+: m_config{config}
+{
+  if (m_config.time_budget < std::chrono::nanoseconds::zero()) {
+    throw std::domain_error{"The time budget of the A* planner must not be negative"};
+  }
+  if (!(m_config.initial_epsilon >= 1.0)) {
+    throw std::domain_error{"The initial heuristic weight of the A* planner must be at least 1"};
+  }
+  if (!(m_config.epsilon_decrement > 0.0)) {
+    throw std::domain_error{"The heuristic weight decrement of the A* planner must be positive"};
+  }
+}
+
+std::vector<VehicleState<float64_t>> AstarPathPlanner::plan_astar(
+  const VehicleState<float64_t> & current_state,
+  const VehicleState<float64_t> & goal_state,
+  const Polytope2D<float64_t> & vehicle_bounding_box,
+  const std::vector<Polytope2D<float64_t>> & obstacles) const
+{
+  return plan_astar(
+    current_state, goal_state, vehicle_bounding_box, obstacles,
+    m_config.time_budget > std::chrono::nanoseconds::zero(),
+    std::chrono::steady_clock::now() + m_config.time_budget);
+}
+
+std::vector<VehicleState<float64_t>> AstarPathPlanner::plan_astar(
+  const VehicleState<float64_t> & current_state,
+  const VehicleState<float64_t> & goal_state,
+  const Polytope2D<float64_t> & vehicle_bounding_box,
+  const std::vector<Polytope2D<float64_t>> & obstacles,
+  const std::chrono::steady_clock::time_point deadline) const
+{
+  const auto now = std::chrono::steady_clock::now();
+  return plan_astar(
+    current_state, goal_state, vehicle_bounding_box, obstacles, true,
+    (m_config.time_budget > std::chrono::nanoseconds::zero()) ?
+    std::min(deadline, now + m_config.time_budget) : deadline);
+}
+
+std::vector<VehicleState<float64_t>> AstarPathPlanner::plan_astar(
+  const VehicleState<float64_t> & current_state,
+  const VehicleState<float64_t> & goal_state,
+  const Polytope2D<float64_t> & vehicle_bounding_box,
+  const std::vector<Polytope2D<float64_t>> & obstacles,
+  const bool has_deadline,
+  const std::chrono::steady_clock::time_point deadline) const
+{
+
+  // The expanded states stay within the exploration radius of the goal
+  const ObstacleDistanceGrid distance_grid{
+    vehicle_bounding_box, obstacles, Point2D<float64_t>(goal_state.get_x(), goal_state.get_y()),
+    parking_planner::MAX_EXPLORATION_RADIUS + parking_planner::DELTA_LONGITUDINAL,
+    parking_planner::DISTANCE_GRID_CELL_SIZE};
+
+  // Each search with a smaller weight can only replace the path by a shorter one
+  std::vector<VehicleState<float64_t>> result{current_state};
+  float64_t result_cost = std::numeric_limits<float64_t>::max();
+  std::vector<VehicleState<float64_t>> path;
+  float64_t epsilon = m_config.initial_epsilon;
+  while (true) {
+    float64_t path_cost = 0.0;
+    const auto status = search_astar(
+      current_state, goal_state, vehicle_bounding_box, obstacles, distance_grid,
+      m_config.heuristic_table.get(), epsilon, has_deadline, deadline, path, path_cost);
+    if (status != SearchStatus::FOUND) {
+      break;
+    }
+    if (path_cost < result_cost) {
+      result_cost = path_cost;
+      result.swap(path);
+    }
+    if ((epsilon <= 1.0) || (has_deadline && (std::chrono::steady_clock::now() > deadline))) {
+      break;
+    }
+    epsilon = std::max(1.0, epsilon - m_config.epsilon_decrement);
+  }
   return result;
 }
 
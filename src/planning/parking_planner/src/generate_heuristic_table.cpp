@@ -0,0 +1,44 @@
+// Copyright 2021 Embotech AG, Zurich, Switzerland. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// This file is to be built and run standalone to produce the heuristic table of the A* path
+// planner, which is then loaded at runtime. This is done by the CMake build process.
+//
+// The table depends on the motion primitives of the A* search only, not on the obstacles, so
+// it is generated once instead of at every start of the planner.
+
+#include <exception>
+#include <iostream>
+#include <string>
+
+#include "parking_planner/heuristic_table.hpp"
+
+using autoware::motion::planning::parking_planner::HeuristicTable;
+
+int main(int argc, char * argv[])
+{
+  if (argc != 2) {
+    std::cerr << "Path argument missing. The path argument specifies where the heuristic " <<
+      "table will be put by the build system." << std::endl;
+    return 1;
+  }
+
+  try {
+    HeuristicTable{}.save(std::string(argv[1]));
+  } catch (const std::exception & e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
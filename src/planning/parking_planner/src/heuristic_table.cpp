@@ -0,0 +1,228 @@
+// Copyright 2021 Embotech AG, Zurich, Switzerland. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <common/types.hpp>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "parking_planner/astar_path_planner.hpp"
+#include "parking_planner/heuristic_table.hpp"
+
+namespace autoware
+{
+namespace motion
+{
+namespace planning
+{
+namespace parking_planner
+{
+
+#ifndef PARKING_PLANNER_HEURISTIC_TABLE_PATH
+#define PARKING_PLANNER_HEURISTIC_TABLE_PATH "parking_planner_heuristic_table.bin"
+#endif
+
+namespace
+{
+// Identifies the file format, changed with the layout of the file
+constexpr uint32_t FILE_MAGIC = 0x54485050U;  // "PPHT"
+constexpr uint32_t FILE_VERSION = 1U;
+
+template<typename T>
+void write_value(std::ofstream & file, const T & value)
+{
+  file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template<typename T>
+T read_value(std::ifstream & file)
+{
+  T value{};
+  file.read(reinterpret_cast<char *>(&value), sizeof(T));
+  return value;
+}
+}  // namespace
+
+constexpr uint16_t HeuristicTable::UNREACHED;
+
+HeuristicTable::HeuristicTable(const float64_t half_size)
+{
+  if (!(half_size > 0.0)) {
+    throw std::domain_error{"The heuristic table must cover a positive area"};
+  }
+  m_half_num_positions =
+    static_cast<std::size_t>(std::ceil(half_size / parking_planner::DELTA_LONGITUDINAL));
+  m_num_positions = 2U * m_half_num_positions + 1U;
+  m_num_headings =
+    static_cast<std::size_t>(std::round(2.0 * MY_PI / parking_planner::DELTA_HEADING));
+  m_steps.assign(m_num_positions * m_num_positions * m_num_headings, UNREACHED);
+
+  // The headings stay multiples of the heading step, only the positions are continuous
+  struct Position
+  {
+    float64_t x;
+    float64_t y;
+  };
+  std::vector<Position> positions(m_steps.size(), Position{0.0, 0.0});
+  std::deque<std::pair<std::size_t, std::size_t>> queue;  // cell and heading step
+  const auto half_extent =
+    (static_cast<float64_t>(m_half_num_positions) + 0.5) * parking_planner::DELTA_LONGITUDINAL;
+  const auto goal_idx = index(0.0, 0.0, 0.0);
+  m_steps[goal_idx] = 0U;
+  queue.emplace_back(goal_idx, 0U);
+
+  // All primitives have the same length, so a breadth-first search visits the cells in order of
+  // their cost. The predecessors of a state are the states one of the A* expansions leads to it.
+  while (!queue.empty()) {
+    const auto cell = queue.front().first;
+    const auto heading_step = queue.front().second;
+    queue.pop_front();
+    const auto steps = m_steps[cell];
+    if (steps + 1U >= UNREACHED) {
+      continue;
+    }
+    for (const int64_t heading_change : {-1, 0, 1}) {
+      const auto from_heading_step = static_cast<std::size_t>(
+        (static_cast<int64_t>(heading_step + m_num_headings) - heading_change) %
+        static_cast<int64_t>(m_num_headings));
+      const auto from_heading =
+        static_cast<float64_t>(from_heading_step) * parking_planner::DELTA_HEADING;
+      const auto delta_x = std::cos(from_heading) * parking_planner::DELTA_LONGITUDINAL;
+      const auto delta_y = std::sin(from_heading) * parking_planner::DELTA_LONGITUDINAL;
+      for (const float64_t direction : {-1.0, 1.0}) {
+        const auto from_x = positions[cell].x - direction * delta_x;
+        const auto from_y = positions[cell].y - direction * delta_y;
+        if ((std::abs(from_x) >= half_extent) || (std::abs(from_y) >= half_extent)) {
+          continue;
+        }
+        const auto from_cell = index(from_x, from_y, from_heading);
+        if (m_steps[from_cell] == UNREACHED) {
+          m_steps[from_cell] = static_cast<uint16_t>(steps + 1U);
+          positions[from_cell] = Position{from_x, from_y};
+          queue.emplace_back(from_cell, from_heading_step);
+        }
+      }
+    }
+  }
+}
+
+HeuristicTable HeuristicTable::load(const std::string & path)
+{
+  std::ifstream file{path, std::ios::binary};
+  if (!file) {
+    throw std::runtime_error{"Could not open the heuristic table " + path};
+  }
+  if ((read_value<uint32_t>(file) != FILE_MAGIC) || (read_value<uint32_t>(file) != FILE_VERSION)) {
+    throw std::runtime_error{"Not a heuristic table of this version: " + path};
+  }
+  // A table of other motion primitives would make the search expand the wrong states first
+  const auto delta_longitudinal = read_value<float64_t>(file);
+  const auto delta_heading = read_value<float64_t>(file);
+  if ((delta_longitudinal != parking_planner::DELTA_LONGITUDINAL) ||
+    (delta_heading != parking_planner::DELTA_HEADING))
+  {
+    throw std::runtime_error{"The heuristic table was generated for other motion primitives"};
+  }
+  HeuristicTable table{};
+  table.m_half_num_positions = read_value<uint64_t>(file);
+  table.m_num_positions = 2U * table.m_half_num_positions + 1U;
+  table.m_num_headings = read_value<uint64_t>(file);
+  if (!file || (table.m_num_headings !=
+    static_cast<std::size_t>(std::round(2.0 * MY_PI / parking_planner::DELTA_HEADING))) ||
+    (table.m_half_num_positions > (1U << 16U)))
+  {
+    throw std::runtime_error{"Invalid heuristic table header: " + path};
+  }
+  table.m_steps.resize(table.m_num_positions * table.m_num_positions * table.m_num_headings);
+  file.read(
+    reinterpret_cast<char *>(table.m_steps.data()),
+    static_cast<std::streamsize>(table.m_steps.size() * sizeof(uint16_t)));
+  if (!file) {
+    throw std::runtime_error{"Truncated heuristic table: " + path};
+  }
+  return table;
+}
+
+std::string HeuristicTable::default_path()
+{
+  return PARKING_PLANNER_HEURISTIC_TABLE_PATH;
+}
+
+void HeuristicTable::save(const std::string & path) const
+{
+  std::ofstream file{path, std::ios::binary | std::ios::trunc};
+  if (!file) {
+    throw std::runtime_error{"Could not create the heuristic table " + path};
+  }
+  write_value(file, FILE_MAGIC);
+  write_value(file, FILE_VERSION);
+  write_value(file, parking_planner::DELTA_LONGITUDINAL);
+  write_value(file, parking_planner::DELTA_HEADING);
+  // Fixed width, independent of the platform
+  const uint64_t half_num_positions = m_half_num_positions;
+  const uint64_t num_headings = m_num_headings;
+  write_value(file, half_num_positions);
+  write_value(file, num_headings);
+  file.write(
+    reinterpret_cast<const char *>(m_steps.data()),
+    static_cast<std::streamsize>(m_steps.size() * sizeof(uint16_t)));
+  if (!file) {
+    throw std::runtime_error{"Could not write the heuristic table " + path};
+  }
+}
+
+bool HeuristicTable::lookup(
+  const float64_t x, const float64_t y, const float64_t heading,
+  float64_t & cost) const noexcept
+{
+  const auto half_extent =
+    (static_cast<float64_t>(m_half_num_positions) + 0.5) * parking_planner::DELTA_LONGITUDINAL;
+  if (m_steps.empty() || !(std::abs(x) < half_extent) || !(std::abs(y) < half_extent) ||
+    !std::isfinite(heading))
+  {
+    return false;
+  }
+  const auto steps = m_steps[index(x, y, heading)];
+  if (steps == UNREACHED) {
+    return false;
+  }
+  cost = static_cast<float64_t>(steps) * parking_planner::DELTA_LONGITUDINAL;
+  return true;
+}
+
+std::size_t HeuristicTable::index(
+  const float64_t x, const float64_t y, const float64_t heading) const noexcept
+{
+  // Same rounding as the discretization of the A* search
+  const auto x_index = static_cast<std::size_t>(
+    static_cast<int64_t>(std::round(x / parking_planner::DELTA_LONGITUDINAL)) +
+    static_cast<int64_t>(m_half_num_positions));
+  const auto y_index = static_cast<std::size_t>(
+    static_cast<int64_t>(std::round(y / parking_planner::DELTA_LONGITUDINAL)) +
+    static_cast<int64_t>(m_half_num_positions));
+  const auto heading_index = static_cast<std::size_t>(
+    static_cast<int64_t>(std::round(
+      (std::remainder(heading, 2.0 * MY_PI) + 2.0 * MY_PI) / parking_planner::DELTA_HEADING)) %
+    static_cast<int64_t>(m_num_headings));
+  return (heading_index * m_num_positions + y_index) * m_num_positions + x_index;
+}
+
+}  // namespace parking_planner
+}  // namespace planning
+}  // namespace motion
+}  // namespace autoware
@@ -22,7 +22,10 @@
 
 #include <casadi/casadi.hpp>
 
+#include <algorithm>
+#include <cstddef>
 #include <iostream>
+#include <limits>
 #include <vector>
 
 #include "parking_planner/configuration.hpp"
@@ -187,6 +190,49 @@ std::vector<NLPObstacle<double>> create_obstacles_from_polyhedra(
   return nlp_obstacle_list;
 }
 
+NLPWarmStart shift_warm_start(const NLPWarmStart & warm_start, const std::size_t num_steps)
+{
+  constexpr auto trajectory_stage_length =
+    VehicleState<double>::get_serialized_length() + VehicleCommand<double>::get_serialized_length();
+  constexpr auto obstacle_stage_length = NLPObstacleStageVariables<double>::get_serialized_length();
+  constexpr auto number_of_variables = HORIZON_LENGTH *
+    (trajectory_stage_length + (MAX_NUMBER_OF_OBSTACLES * obstacle_stage_length));
+
+  NLPWarmStart shifted = warm_start;
+  if ((num_steps == 0U) || (warm_start.m_variables.size() != number_of_variables) ||
+    (warm_start.m_variable_multipliers.size() != number_of_variables))
+  {
+    return shifted;
+  }
+
+  // The variables are the trajectory followed by the variables of each obstacle, all of them
+  // ordered by stage
+  const auto shift_stages = [num_steps](std::vector<double> & variables) {
+      std::size_t block_start = {};
+      const auto shift_block = [num_steps, &variables, &block_start](const std::size_t length) {
+          for (std::size_t k = {}; k < HORIZON_LENGTH; ++k) {
+            const auto from = std::min(k + num_steps, HORIZON_LENGTH - 1U);
+            if (from != k) {
+              const auto source = variables.begin() +
+                static_cast<std::ptrdiff_t>(block_start + (from * length));
+              std::copy(
+                source, source + static_cast<std::ptrdiff_t>(length),
+                variables.begin() + static_cast<std::ptrdiff_t>(block_start + (k * length)));
+            }
+          }
+          block_start += HORIZON_LENGTH * length;
+        };
+      shift_block(trajectory_stage_length);
+      for (std::size_t k = {}; k < MAX_NUMBER_OF_OBSTACLES; ++k) {
+        shift_block(obstacle_stage_length);
+      }
+    };
+  shift_stages(shifted.m_variables);
+  shift_stages(shifted.m_variable_multipliers);
+  std::fill(shifted.m_constraint_multipliers.begin(), shifted.m_constraint_multipliers.end(), 0.0);
+  return shifted;
+}
+
 NLPPathPlanner::NLPPathPlanner(
   const NLPCostWeights<double> & cost_weights,
   const VehicleState<double> & lower_state_bounds,
@@ -200,6 +246,24 @@ NLPPathPlanner::NLPPathPlanner(
   m_upper_state_bounds = upper_state_bounds;
   m_lower_command_bounds = lower_command_bounds;
   m_upper_command_bounds = upper_command_bounds;
+
+  // Loading the callbacks and setting up IPOPT is done once instead of at every solve.
+  // NOTE set print_level to higher for debugging purposes. The hessian approximation has to be
+  // kept the same as in generate_nlp_planner_solver, because different settings lead to different
+  // callbacks being created.
+  const auto callbacks_library = SHARED_LIBRARY_DIRECTORY + "/" + "libparking_planner_callbacks.so";
+  casadi::Dict ipopt_options = {{"hessian_approximation", "limited-memory"}, {"print_level", 0},
+    {"max_iter", 500}};
+  m_solver = casadi::nlpsol("solver", "ipopt", callbacks_library, {{"ipopt", ipopt_options}});
+
+  // A warm start is close to the solution, so the iterates are barely pushed away from the
+  // bounds and the barrier parameter starts small
+  ipopt_options["warm_start_init_point"] = "yes";
+  ipopt_options["warm_start_bound_push"] = 1e-6;
+  ipopt_options["warm_start_mult_bound_push"] = 1e-6;
+  ipopt_options["mu_init"] = 1e-4;
+  m_warm_solver =
+    casadi::nlpsol("warm_solver", "ipopt", callbacks_library, {{"ipopt", ipopt_options}});
 }
 
 template<typename T>
@@ -320,6 +384,30 @@ NLPResults NLPPathPlanner::plan_nlp(
   const std::vector<Polytope2D<double>> & obstacles,
   const BicycleModelParameters<double> & model_parameters
 ) const
+{
+  return solve(current_state, goal_state, initial_guess, obstacles, model_parameters, nullptr);
+}
+
+NLPResults NLPPathPlanner::plan_nlp(
+  const VehicleState<double> & current_state,
+  const VehicleState<double> & goal_state,
+  const Trajectory<double> & initial_guess,
+  const std::vector<Polytope2D<double>> & obstacles,
+  const BicycleModelParameters<double> & model_parameters,
+  const NLPWarmStart & warm_start
+) const
+{
+  return solve(current_state, goal_state, initial_guess, obstacles, model_parameters, &warm_start);
+}
+
+NLPResults NLPPathPlanner::solve(
+  const VehicleState<double> & current_state,
+  const VehicleState<double> & goal_state,
+  const Trajectory<double> & initial_guess,
+  const std::vector<Polytope2D<double>> & obstacles,
+  const BicycleModelParameters<double> & model_parameters,
+  const NLPWarmStart * const warm_start
+) const
 {
   // Assemble solver inputs
   std::vector<NLPObstacle<double>> nlp_obstacles{};
@@ -327,7 +415,8 @@ NLPResults NLPPathPlanner::plan_nlp(
     nlp_obstacles = create_obstacles_from_polyhedra(obstacles, current_state);
   } catch (const std::length_error & e) {
     std::cout << e.what() << std::endl;
-    return NLPResults{Trajectory<float64_t>{}, casadi::Dict{}};
+    return NLPResults{Trajectory<float64_t>{}, casadi::Dict{}, NLPWarmStart{},
+      std::numeric_limits<float64_t>::max()};
   }
   auto p = assemble_parameter_vector(
     current_state, goal_state, model_parameters, nlp_obstacles, m_cost_weights);
@@ -336,25 +425,30 @@ NLPResults NLPPathPlanner::plan_nlp(
     m_lower_state_bounds, m_upper_state_bounds, m_lower_command_bounds, m_upper_command_bounds);
   auto constraint_bounds = create_constraint_bounds();
 
-  // NOTE set print_level to higher for debugging purposes. The hessian approximation has to be
-  // kept the same as in generate_nlp_planner_solver, because different settings lead to different
-  // callbacks being created.
-  casadi::Dict ipopt_options = {{"hessian_approximation", "limited-memory"}, {"print_level", 0},
-    {"max_iter", 500}};
-  casadi::Function solver = casadi::nlpsol(
-    "solver", "ipopt", SHARED_LIBRARY_DIRECTORY + "/" +
-    "libparking_planner_callbacks.so", {{"ipopt", ipopt_options}});
+  // The obstacle variables of the warm start belong to its obstacles
+  const bool use_warm_start = (warm_start != nullptr) &&
+    (warm_start->m_num_obstacles == obstacles.size()) &&
+    (warm_start->m_variables.size() == vars_and_bounds.variables.size()) &&
+    (warm_start->m_variable_multipliers.size() == vars_and_bounds.variables.size()) &&
+    (warm_start->m_constraint_multipliers.size() == constraint_bounds.lower.size());
 
   // Call solver with the assembled data
-  casadi::DMDict res = solver(
-    casadi::DMDict{
-            {"x0", vars_and_bounds.variables},
-            {"p", p},
-            {"ubg", constraint_bounds.upper},
-            {"lbg", constraint_bounds.lower},
-            {"ubx", vars_and_bounds.upper_bounds},
-            {"lbx", vars_and_bounds.lower_bounds},
-          });
+  casadi::DMDict args{
+    {"p", p},
+    {"ubg", constraint_bounds.upper},
+    {"lbg", constraint_bounds.lower},
+    {"ubx", vars_and_bounds.upper_bounds},
+    {"lbx", vars_and_bounds.lower_bounds},
+  };
+  if (use_warm_start) {
+    args["x0"] = warm_start->m_variables;
+    args["lam_x0"] = warm_start->m_variable_multipliers;
+    args["lam_g0"] = warm_start->m_constraint_multipliers;
+  } else {
+    args["x0"] = vars_and_bounds.variables;
+  }
+  const casadi::Function & solver = use_warm_start ? m_warm_solver : m_solver;
+  casadi::DMDict res = solver(args);
 
   // Get some info about the solve
   auto stats = solver.stats();
@@ -362,7 +456,11 @@ NLPResults NLPPathPlanner::plan_nlp(
   // Extract and return results
   std::vector<double> elements = res["x"].get_elements();
   auto resulting_trajectory = disassemble_variable_vector(elements, HORIZON_LENGTH);
-  return NLPResults{resulting_trajectory, stats};
+  const NLPWarmStart solution{
+    elements, res["lam_x"].get_elements(), res["lam_g"].get_elements(), obstacles.size()};
+  const auto cost = res["f"].get_elements();
+  return NLPResults{resulting_trajectory, stats, solution,
+    cost.empty() ? std::numeric_limits<float64_t>::max() : cost.front()};
 }
 
 }  // namespace parking_planner
@@ -22,7 +22,15 @@
 #include <geometry_msgs/msg/point32.hpp>
 #include <motion_common/motion_common.hpp>
 
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <future>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
 #include <vector>
 #include <limits>
 #include <list>
@@ -61,12 +69,16 @@ PlanningResult::PlanningResult(
   const Trajectory<float64_t> trajectory,
   const std::size_t nlp_iterations,
   const float64_t nlp_proc_time,
-  const PlanningStatus status)
+  const PlanningStatus status,
+  const NLPWarmStart & warm_start,
+  const float64_t nlp_cost)
 {
   m_trajectory = trajectory;
   m_nlp_iterations = nlp_iterations;
   m_nlp_proc_time = nlp_proc_time;
   m_status = status;
+  m_warm_start = warm_start;
+  m_nlp_cost = nlp_cost;
 }
 
 
@@ -358,12 +370,13 @@ ParkingPlanner::ParkingPlanner(
   const VehicleState<float64_t> & lower_state_bounds,
   const VehicleState<float64_t> & upper_state_bounds,
   const VehicleCommand<float64_t> & lower_command_bounds,
-  const VehicleCommand<float64_t> & upper_command_bounds
+  const VehicleCommand<float64_t> & upper_command_bounds,
+  const AstarConfig & astar_config
 )
 : m_nlp_planner(nlp_weights, lower_state_bounds, upper_state_bounds,
     lower_command_bounds, upper_command_bounds), m_model_parameters(parameters)
 {
-  m_astar_planner = AstarPathPlanner();
+  m_astar_planner = AstarPathPlanner(astar_config);
 }
 
 
@@ -373,9 +386,26 @@ PlanningResult ParkingPlanner::plan(
   const std::vector<Polytope2D<float64_t>> & obstacles
 ) const
 {
-  // If the starting and target angles would be closer if we shift by 2*pi in either
-  // direction, do that. This will help avoid the planner coming up with "loop" solutions.
-  // TODO(s.me) this should be cleaned up after AVP
+  return plan(current_state, goal_state, obstacles, nullptr);
+}
+
+PlanningResult ParkingPlanner::plan(
+  const VehicleState<float64_t> & current_state,
+  const VehicleState<float64_t> & goal_state,
+  const std::vector<Polytope2D<float64_t>> & obstacles,
+  const NLPWarmStart & warm_start
+) const
+{
+  return plan(current_state, goal_state, obstacles, &warm_start);
+}
+
+// If the starting and target angles would be closer if we shift by 2*pi in either
+// direction, do that. This will help avoid the planner coming up with "loop" solutions.
+// TODO(s.me) this should be cleaned up after AVP
+static VehicleState<float64_t> adapt_goal_heading(
+  const VehicleState<float64_t> & current_state,
+  const VehicleState<float64_t> & goal_state)
+{
   const auto goal_heading = goal_state.get_heading();
   const auto current_heading = current_state.get_heading();
   const auto current_heading_difference = std::abs(goal_heading - current_heading);
@@ -386,23 +416,162 @@ PlanningResult ParkingPlanner::plan(
   } else if (std::abs(goal_heading + (2 * pi) - current_heading) < current_heading_difference) {
     adapted_goal_state.set_heading(goal_heading + (2 * pi) );
   }
+  return adapted_goal_state;
+}
 
-  // Run discretized global A* planner
+PlanningResult ParkingPlanner::plan(
+  const VehicleState<float64_t> & current_state,
+  const VehicleState<float64_t> & goal_state,
+  const std::vector<Polytope2D<float64_t>> & obstacles,
+  const NLPWarmStart * const warm_start
+) const
+{
+  const auto adapted_goal_state = adapt_goal_heading(current_state, goal_state);
+
+  // The previous solution is a better initial guess than the A* path, which is only needed when
+  // the NLP can't use it
+  const bool use_warm_start = (warm_start != nullptr) &&
+    (warm_start->m_num_obstacles == obstacles.size()) &&
+    (warm_start->m_variables.size() >= HORIZON_LENGTH *
+    (VehicleState<float64_t>::get_serialized_length() +
+    VehicleCommand<float64_t>::get_serialized_length()));
+  Trajectory<float64_t> trajectory_guess{};
+  if (use_warm_start) {
+    trajectory_guess = disassemble_variable_vector(warm_start->m_variables, HORIZON_LENGTH);
+  } else {
+    // Run discretized global A* planner
+    const auto vehicle_bounding_box =
+      BicycleModel<float64_t,
+        float64_t>(m_model_parameters).compute_bounding_box(VehicleState<float64_t>{});
+    const std::vector<VehicleState<float64_t>> astar_output =
+      m_astar_planner.plan_astar(
+      current_state,
+      adapted_goal_state,
+      vehicle_bounding_box,
+      obstacles);
+
+    // Translate A* planner output to a trajectory with commands
+    trajectory_guess = this->create_trajectory_from_states(astar_output, HORIZON_LENGTH);
+  }
+
+  return smooth(
+    current_state, adapted_goal_state, trajectory_guess, obstacles,
+    use_warm_start ? warm_start : nullptr);
+}
+
+PlanningResult ParkingPlanner::plan(
+  const VehicleState<float64_t> & current_state,
+  const std::vector<VehicleState<float64_t>> & goal_states,
+  const std::vector<Polytope2D<float64_t>> & obstacles,
+  const std::chrono::nanoseconds time_budget
+) const
+{
+  if (goal_states.empty()) {
+    throw std::domain_error{"At least one goal state is needed"};
+  }
+  if (time_budget < std::chrono::nanoseconds::zero()) {
+    throw std::domain_error{"The time budget must not be negative"};
+  }
+  // The A* searches stop at the deadline, so that waiting for them is bounded
+  const auto deadline = (time_budget == std::chrono::nanoseconds::zero()) ?
+    std::chrono::steady_clock::time_point::max() :
+    std::chrono::steady_clock::now() + time_budget;
+
+  std::vector<VehicleState<float64_t>> adapted_goal_states{};
+  for (const auto & goal_state : goal_states) {
+    adapted_goal_states.push_back(adapt_goal_heading(current_state, goal_state));
+  }
   const auto vehicle_bounding_box =
     BicycleModel<float64_t,
       float64_t>(m_model_parameters).compute_bounding_box(VehicleState<float64_t>{});
-  const std::vector<VehicleState<float64_t>> astar_output =
-    m_astar_planner.plan_astar(
-    current_state,
-    adapted_goal_state,
-    vehicle_bounding_box,
-    obstacles);
-
-  // Translate A* planner output to a trajectory with commands
-  const auto trajectory_guess = this->create_trajectory_from_states(astar_output, HORIZON_LENGTH);
-
-  // Run NLP smoother, warm-started using the A* guess
-  auto nlp_results = m_nlp_planner.plan_nlp(
+
+  // The A* searches run concurrently and hand over their paths in the order they finish. The
+  // NLP solves run in this thread one after the other, since the solvers are shared.
+  std::mutex mutex;
+  std::condition_variable path_cv;
+  std::deque<std::size_t> finished_searches{};
+  std::vector<std::vector<VehicleState<float64_t>>> astar_outputs(goal_states.size());
+  std::vector<std::future<void>> searches{};
+  for (std::size_t k = {}; k < goal_states.size(); ++k) {
+    searches.push_back(
+      std::async(
+        std::launch::async, [&, k]() {
+          std::vector<VehicleState<float64_t>> path{current_state};
+          try {
+            path = m_astar_planner.plan_astar(
+              current_state, adapted_goal_states[k], vehicle_bounding_box, obstacles, deadline);
+          } catch (const std::exception & e) {
+            // Counts as failed search, the other variants may still succeed
+            std::cout << e.what() << std::endl;
+          }
+          {
+            std::lock_guard<std::mutex> lock{mutex};
+            astar_outputs[k].swap(path);
+            finished_searches.push_back(k);
+          }
+          path_cv.notify_one();
+        }));
+  }
+
+  // Keep the feasible plan with the lowest cost, and otherwise the last unsuccessful one
+  std::unique_ptr<PlanningResult> best_result{};
+  std::unique_ptr<PlanningResult> failed_result{};
+  for (std::size_t num_finished = {}; num_finished < goal_states.size(); ++num_finished) {
+    std::vector<VehicleState<float64_t>> astar_output{};
+    std::size_t idx = {};
+    {
+      std::unique_lock<std::mutex> lock{mutex};
+      path_cv.wait(lock, [&finished_searches]() {return !finished_searches.empty();});
+      idx = finished_searches.front();
+      finished_searches.pop_front();
+      astar_output = astar_outputs[idx];
+    }
+    // An A* search that failed only returns the current state
+    if (astar_output.size() < 2U) {
+      continue;
+    }
+    if (best_result && (std::chrono::steady_clock::now() > deadline)) {
+      break;
+    }
+    auto result = smooth(
+      current_state, adapted_goal_states[idx],
+      create_trajectory_from_states(astar_output, HORIZON_LENGTH), obstacles, nullptr);
+    if (result.get_status() != PlanningStatus::OK) {
+      failed_result = std::make_unique<PlanningResult>(result);
+    } else if (!best_result || (result.get_nlp_cost() < best_result->get_nlp_cost())) {
+      best_result = std::make_unique<PlanningResult>(result);
+    }
+  }
+  for (auto & search : searches) {
+    search.wait();
+  }
+
+  if (best_result) {
+    return *best_result;
+  }
+  if (failed_result) {
+    return *failed_result;
+  }
+  // No search found a path, smooth the first one anyway like a plan for a single goal
+  return smooth(
+    current_state, adapted_goal_states.front(),
+    create_trajectory_from_states(astar_outputs.front(), HORIZON_LENGTH), obstacles, nullptr);
+}
+
+PlanningResult ParkingPlanner::smooth(
+  const VehicleState<float64_t> & current_state,
+  const VehicleState<float64_t> & adapted_goal_state,
+  const Trajectory<float64_t> & trajectory_guess,
+  const std::vector<Polytope2D<float64_t>> & obstacles,
+  const NLPWarmStart * const warm_start
+) const
+{
+  // Run NLP smoother, warm-started using the previous solution or the A* guess
+  auto nlp_results = (warm_start != nullptr) ?
+    m_nlp_planner.plan_nlp(
+    current_state, adapted_goal_state, trajectory_guess,
+    obstacles, m_model_parameters, *warm_start) :
+    m_nlp_planner.plan_nlp(
     current_state, adapted_goal_state, trajectory_guess,
     obstacles, m_model_parameters);
   const auto smoothed_trajectory = nlp_results.m_trajectory;
@@ -419,11 +588,13 @@ PlanningResult ParkingPlanner::plan(
 
   // Return final result
   if (trajectory_ok) {
-    return PlanningResult(smoothed_trajectory, nlp_iterations, nlp_proc_time, PlanningStatus::OK);
+    return PlanningResult(
+      smoothed_trajectory, nlp_iterations, nlp_proc_time, PlanningStatus::OK,
+      nlp_results.m_warm_start, nlp_results.m_cost);
   } else {
     return PlanningResult(
       smoothed_trajectory, nlp_iterations, nlp_proc_time,
-      PlanningStatus::NLP_ERROR);
+      PlanningStatus::NLP_ERROR, nlp_results.m_warm_start, nlp_results.m_cost);
   }
 }
 
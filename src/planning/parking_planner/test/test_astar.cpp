@@ -16,6 +16,11 @@
 
 #include <gtest/gtest.h>
 #include <common/types.hpp>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <string>
 #include <vector>
 #include "parking_planner/geometry.hpp"
 #include "parking_planner/parking_planner_types.hpp"
@@ -35,6 +40,9 @@ using BicycleModel =
 using Trajectory = autoware::motion::planning::parking_planner::Trajectory<float64_t>;
 using TrajectoryStep = autoware::motion::planning::parking_planner::TrajectoryStep<float64_t>;
 using autoware::motion::planning::parking_planner::HORIZON_LENGTH;
+using autoware::motion::planning::parking_planner::AstarConfig;
+using autoware::motion::planning::parking_planner::ObstacleDistanceGrid;
+using autoware::motion::planning::parking_planner::HeuristicTable;
 
 
 TEST(astar_path_planner, direct_path_x) {
@@ -454,3 +462,166 @@ TEST(astar_path_planner, infeasible_situation_current_walled) {
   EXPECT_EQ(num_collisions, 0);
   EXPECT_EQ(vehicle_states.size(), 1U);
 }
+
+TEST(astar_path_planner, obstacle_distance_grid) {
+  const Polytope2D vehicle_bounding_box(
+    std::vector<Point2D>({{1.0, 1.0}, {-1.0, 1.0}, {-1.0, -1.0}, {1.0, -1.0}}));
+  const Polytope2D obstacle(
+    std::vector<Point2D>({{1.0, 1.0}, {-1.0, 1.0}, {-1.0, -1.0}, {1.0, -1.0}}));
+
+  const ObstacleDistanceGrid grid(vehicle_bounding_box, {obstacle}, Point2D{}, 10.0, 0.25);
+  using CollisionCheck = ObstacleDistanceGrid::CollisionCheck;
+  EXPECT_EQ(grid.check({0.1, 0.2}), CollisionCheck::COLLISION);
+  EXPECT_EQ(grid.check({7.0, -3.0}), CollisionCheck::FREE);
+  // Close to the obstacle, the result depends on the heading
+  EXPECT_EQ(grid.check({2.2, 0.0}), CollisionCheck::UNKNOWN);
+  EXPECT_EQ(grid.check({2.6, 0.0}), CollisionCheck::FREE);
+  // Outside of the grid
+  EXPECT_EQ(grid.check({11.0, 0.0}), CollisionCheck::UNKNOWN);
+}
+
+TEST(astar_path_planner, anytime_weighted) {
+  const VehicleState current_state(0.0, 0.0, 0.0, 0, 0.0);
+  const VehicleState goal_state(-2.0, -1.5, 0.0, 0, 0.0);
+
+  const auto parameters = BicycleModelParameters(0.8, 0.8, 1.0, 0.1, 0.1);
+  const auto model = BicycleModel(parameters);
+  const auto vehicle_bounding_box = model.compute_bounding_box(VehicleState{});
+
+  const Polytope2D back_parked_car(
+    std::vector<Point2D>({{-4.0, -0.8}, {-6.0, -0.8}, {-6.0, -2.5}, {-4.0, -2.5}}));
+  const Polytope2D front_parked_car(
+    std::vector<Point2D>({{10.0, -0.8}, {0.0, -0.8}, {0.0, -2.5}, {10.0, -2.5}}));
+  const Polytope2D wall_box(
+    std::vector<Point2D>({{10.0, -2.5}, {-5.0, -2.5}, {-5.0, -4.0}, {10.0, -4.0}}));
+  const std::vector<Polytope2D> obstacles({back_parked_car, front_parked_car, wall_box});
+
+  const auto optimal_states = autoware::motion::planning::parking_planner::AstarPathPlanner().
+    plan_astar(current_state, goal_state, vehicle_bounding_box, obstacles);
+
+  AstarConfig config{};
+  config.initial_epsilon = 3.0;
+  config.epsilon_decrement = 1.0;
+  const auto planner = autoware::motion::planning::parking_planner::AstarPathPlanner(config);
+  const std::vector<VehicleState> vehicle_states =
+    planner.plan_astar(current_state, goal_state, vehicle_bounding_box, obstacles);
+
+  // Without deadline, the last search is plain A*
+  EXPECT_GT(vehicle_states.size(), 1U);
+  EXPECT_EQ(vehicle_states.size(), optimal_states.size());
+  int32_t num_collisions = 0;
+  for (auto s : vehicle_states) {
+    for (const auto & obst : obstacles) {
+      Polytope2D v(vehicle_bounding_box);
+      v.rotate_and_shift(s.get_heading(), {0.0, 0.0}, {s.get_x(), s.get_y()});
+      if (obst.intersects_with(v)) {
+        num_collisions++;
+      }
+    }
+  }
+  EXPECT_EQ(num_collisions, 0);
+}
+
+TEST(astar_path_planner, time_budget) {
+  // The infeasible situation explores all reachable states without a deadline
+  const VehicleState current_state(0.0, 0.0, 0.0, 0, 0.0);
+  const VehicleState goal_state(15.0, 0.0, 0.0, 0, 0.0);
+
+  const auto parameters = BicycleModelParameters(0.8, 0.8, 1.0, 0.1, 0.1);
+  const auto model = BicycleModel(parameters);
+  const auto vehicle_bounding_box = model.compute_bounding_box(VehicleState{});
+
+  const Polytope2D wall_box_upper(
+    std::vector<Point2D>({{10.0, 10.0}, {-10.0, 10.0}, {-10.0, 9.0}, {10.0, 9.0}}));
+  const Polytope2D wall_box_lower(
+    std::vector<Point2D>({{10.0, -9.0}, {-10.0, -9.0}, {-10.0, -10.0}, {10.0, -10.0}}));
+  const Polytope2D wall_box_right(
+    std::vector<Point2D>({{10.0, 9.0}, {9.0, 9.0}, {9.0, -9.0}, {10.0, -9.0}}));
+  const Polytope2D wall_box_left(
+    std::vector<Point2D>({{-9.0, 9.0}, {-10.0, 9.0}, {-10.0, -9.0}, {-9.0, -9.0}}));
+  const std::vector<Polytope2D> obstacles({wall_box_upper, wall_box_lower, wall_box_right,
+      wall_box_left});
+
+  AstarConfig config{};
+  config.time_budget = std::chrono::milliseconds(20);
+  const auto planner = autoware::motion::planning::parking_planner::AstarPathPlanner(config);
+
+  const auto start = std::chrono::steady_clock::now();
+  const std::vector<VehicleState> vehicle_states =
+    planner.plan_astar(current_state, goal_state, vehicle_bounding_box, obstacles);
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+
+  // Generous bound, the point is that the search stops long before exploring all states
+  EXPECT_LT(elapsed, std::chrono::milliseconds(500));
+  EXPECT_EQ(vehicle_states.size(), 1U);
+}
+
+TEST(astar_path_planner, heuristic_table) {
+  static constexpr float64_t pi = 3.141592653589793;
+  const HeuristicTable table(2.0);
+
+  float64_t cost = -1.0;
+  ASSERT_TRUE(table.lookup(0.0, 0.0, 0.0, cost));
+  EXPECT_EQ(cost, 0.0);
+  // Driving straight, forwards or backwards
+  ASSERT_TRUE(table.lookup(-1.0, 0.0, 0.0, cost));
+  EXPECT_DOUBLE_EQ(cost, 1.0);
+  ASSERT_TRUE(table.lookup(1.0, 0.0, 0.0, cost));
+  EXPECT_DOUBLE_EQ(cost, 1.0);
+  // Turning takes longer than the distance
+  ASSERT_TRUE(table.lookup(0.0, 0.5, 0.0, cost));
+  EXPECT_GT(cost, 0.5);
+  ASSERT_TRUE(table.lookup(0.0, 0.0, pi, cost));
+  EXPECT_GT(cost, 0.0);
+  EXPECT_FALSE(table.lookup(3.0, 0.0, 0.0, cost));
+
+  const std::string path = "test_heuristic_table.bin";
+  table.save(path);
+  const auto loaded = HeuristicTable::load(path);
+  std::remove(path.c_str());
+  for (const float64_t heading : {0.0, 0.5 * pi, -0.75 * pi}) {
+    float64_t loaded_cost = -1.0;
+    ASSERT_TRUE(table.lookup(1.25, -0.5, heading, cost));
+    ASSERT_TRUE(loaded.lookup(1.25, -0.5, heading, loaded_cost));
+    EXPECT_EQ(cost, loaded_cost);
+  }
+  EXPECT_THROW(HeuristicTable::load(path), std::runtime_error);
+}
+
+TEST(astar_path_planner, heuristic_table_parking) {
+  const VehicleState current_state(0.0, 0.0, 0.0, 0, 0.0);
+  const VehicleState goal_state(-2.0, -1.5, 0.0, 0, 0.0);
+
+  const auto parameters = BicycleModelParameters(0.8, 0.8, 1.0, 0.1, 0.1);
+  const auto model = BicycleModel(parameters);
+  const auto vehicle_bounding_box = model.compute_bounding_box(VehicleState{});
+
+  const Polytope2D back_parked_car(
+    std::vector<Point2D>({{-4.0, -0.8}, {-6.0, -0.8}, {-6.0, -2.5}, {-4.0, -2.5}}));
+  const Polytope2D front_parked_car(
+    std::vector<Point2D>({{10.0, -0.8}, {0.0, -0.8}, {0.0, -2.5}, {10.0, -2.5}}));
+  const Polytope2D wall_box(
+    std::vector<Point2D>({{10.0, -2.5}, {-5.0, -2.5}, {-5.0, -4.0}, {10.0, -4.0}}));
+  const std::vector<Polytope2D> obstacles({back_parked_car, front_parked_car, wall_box});
+
+  AstarConfig config{};
+  config.heuristic_table = std::make_shared<const HeuristicTable>(4.0);
+  const auto planner = autoware::motion::planning::parking_planner::AstarPathPlanner(config);
+  const std::vector<VehicleState> vehicle_states =
+    planner.plan_astar(current_state, goal_state, vehicle_bounding_box, obstacles);
+
+  ASSERT_GT(vehicle_states.size(), 1U);
+  EXPECT_NEAR(vehicle_states.back().get_x(), goal_state.get_x(), 0.2);
+  EXPECT_NEAR(vehicle_states.back().get_y(), goal_state.get_y(), 0.2);
+  int32_t num_collisions = 0;
+  for (auto s : vehicle_states) {
+    for (const auto & obst : obstacles) {
+      Polytope2D v(vehicle_bounding_box);
+      v.rotate_and_shift(s.get_heading(), {0.0, 0.0}, {s.get_x(), s.get_y()});
+      if (obst.intersects_with(v)) {
+        num_collisions++;
+      }
+    }
+  }
+  EXPECT_EQ(num_collisions, 0);
+}
@@ -14,10 +14,12 @@
 #include <gtest/gtest.h>
 #include <common/types.hpp>
 #include <algorithm>
+#include <chrono>
 #include <sstream>
 #include <string>
 #include <vector>
 #include <map>
+#include <stdexcept>
 
 #include "parking_planner/geometry.hpp"
 #include "parking_planner/parking_planner_types.hpp"
@@ -282,3 +284,43 @@ INSTANTIATE_TEST_CASE_P(
     // cppcheck-suppress syntaxError
   ),
 );
+
+TEST(ParkingPlanner, goal_variants_invalid) {
+  const auto planner = ParkingPlanner(
+    BicycleModelParameters(1.0, 1.0, 1.3, 0.1, 0.1), NLPCostWeights<float64_t>(1.0, 1.0, 0.0),
+    VehicleState(-100, -100, -12, -2 * 3.14156, -0.52),
+    VehicleState(+100, +100, +12, +2 * 3.14156, +0.52),
+    VehicleCommand(-10.0, -15), VehicleCommand(+10.0, +15));
+  const VehicleState current_state(0.0, 0.0, 0.0, 0, 0.0);
+  EXPECT_THROW(
+    planner.plan(current_state, std::vector<VehicleState>{}, {}, std::chrono::milliseconds(100)),
+    std::domain_error);
+  EXPECT_THROW(
+    planner.plan(
+      current_state, std::vector<VehicleState>{current_state}, {},
+      std::chrono::milliseconds(-1)),
+    std::domain_error);
+}
+
+TEST(ParkingPlanner, DISABLED_goal_variants) {
+  const auto planner = ParkingPlanner(
+    BicycleModelParameters(1.0, 1.0, 1.3, 0.1, 0.1), NLPCostWeights<float64_t>(1.0, 1.0, 0.0),
+    VehicleState(-100, -100, -12, -2 * 3.14156, -0.52),
+    VehicleState(+100, +100, +12, +2 * 3.14156, +0.52),
+    VehicleCommand(-10.0, -15), VehicleCommand(+10.0, +15));
+  const VehicleState current_state(0.0, 0.0, 0.0, 0, 0.0);
+  // A goal outside of the gap can't be reached, the others can
+  const std::vector<VehicleState> goal_states{
+    VehicleState(-2.0, -1.5, 0.0, 0, 0.0),
+    VehicleState(-2.0, -1.5, 0.0, 3.14159, 0.0),
+    VehicleState(-2.0, -10.0, 0.0, 0, 0.0)};
+
+  const auto result =
+    planner.plan(current_state, goal_states, side_gap_obstacles, std::chrono::seconds(10));
+  EXPECT_EQ(result.get_status(), PlanningStatus::OK);
+  const auto single_result =
+    planner.plan(current_state, goal_states.front(), side_gap_obstacles);
+  if (single_result.get_status() == PlanningStatus::OK) {
+    EXPECT_LE(result.get_nlp_cost(), single_result.get_nlp_cost() + 1e-6);
+  }
+}
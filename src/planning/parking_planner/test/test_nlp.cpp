@@ -39,7 +39,12 @@ using Trajectory = autoware::motion::planning::parking_planner::Trajectory<float
 using TrajectoryStep = autoware::motion::planning::parking_planner::TrajectoryStep<float64_t>;
 using NLPCostWeights = autoware::motion::planning::parking_planner::NLPCostWeights<float64_t>;
 using NLPPathPlanner = autoware::motion::planning::parking_planner::NLPPathPlanner;
+using NLPWarmStart = autoware::motion::planning::parking_planner::NLPWarmStart;
+using NLPObstacleStageVariables =
+  autoware::motion::planning::parking_planner::NLPObstacleStageVariables<float64_t>;
 using autoware::motion::planning::parking_planner::HORIZON_LENGTH;
+using autoware::motion::planning::parking_planner::MAX_NUMBER_OF_OBSTACLES;
+using autoware::motion::planning::parking_planner::shift_warm_start;
 
 
 static Trajectory create_dummy_initial_guess()
@@ -84,3 +89,78 @@ TEST(bicycle_model, simple_solve) {
     parameters);
   const auto trajectory2 = results2.m_trajectory;
 }
+
+TEST(nlp_path_planner, shift_warm_start) {
+  constexpr auto trajectory_stage_length =
+    VehicleState::get_serialized_length() + VehicleCommand::get_serialized_length();
+  constexpr auto obstacle_stage_length = NLPObstacleStageVariables::get_serialized_length();
+  constexpr auto obstacle_length = HORIZON_LENGTH * obstacle_stage_length;
+  constexpr auto trajectory_length = HORIZON_LENGTH * trajectory_stage_length;
+
+  NLPWarmStart warm_start{};
+  for (std::size_t k = {}; k < trajectory_length + MAX_NUMBER_OF_OBSTACLES * obstacle_length;
+    ++k)
+  {
+    warm_start.m_variables.push_back(static_cast<float64_t>(k));
+    warm_start.m_variable_multipliers.push_back(-static_cast<float64_t>(k));
+  }
+  warm_start.m_constraint_multipliers = {1.0, 2.0, 3.0};
+  warm_start.m_num_obstacles = 2U;
+
+  const auto shifted = shift_warm_start(warm_start, 2U);
+  ASSERT_EQ(shifted.m_variables.size(), warm_start.m_variables.size());
+  EXPECT_EQ(shifted.m_num_obstacles, 2U);
+  // Each stage takes the values of the stage two steps later, the last stage is repeated
+  EXPECT_EQ(shifted.m_variables[0], warm_start.m_variables[2U * trajectory_stage_length]);
+  EXPECT_EQ(
+    shifted.m_variables[trajectory_length - 1U], warm_start.m_variables[trajectory_length - 1U]);
+  EXPECT_EQ(
+    shifted.m_variables[(HORIZON_LENGTH - 2U) * trajectory_stage_length],
+    warm_start.m_variables[(HORIZON_LENGTH - 1U) * trajectory_stage_length]);
+  const auto obstacle_start = trajectory_length + obstacle_length;
+  EXPECT_EQ(
+    shifted.m_variables[obstacle_start + 1U],
+    warm_start.m_variables[obstacle_start + 2U * obstacle_stage_length + 1U]);
+  EXPECT_EQ(
+    shifted.m_variable_multipliers[obstacle_start],
+    warm_start.m_variable_multipliers[obstacle_start + 2U * obstacle_stage_length]);
+  EXPECT_EQ(shifted.m_constraint_multipliers, std::vector<float64_t>(3U, 0.0));
+
+  // Without shift, the warm start is unchanged
+  const auto unshifted = shift_warm_start(warm_start, 0U);
+  EXPECT_EQ(unshifted.m_variables, warm_start.m_variables);
+  EXPECT_EQ(unshifted.m_constraint_multipliers, warm_start.m_constraint_multipliers);
+}
+
+TEST(nlp_path_planner, warm_start) {
+  const auto parameters = BicycleModelParameters(1.5, 1.5, 2, 0.5, 0.5);
+  const NLPCostWeights weights(1.0, 1.0, 0.0);
+  const VehicleState lower_state_bounds(-100, -100, -10, -2 * 3.14156, -0.52);
+  const VehicleState upper_state_bounds(+100, +100, +10, +2 * 3.14156, +0.52);
+  const VehicleCommand lower_command_bounds(-3.0, -50);
+  const VehicleCommand upper_command_bounds(+3.0, +50);
+  std::vector<Polytope2D> obstacles{};
+
+  const auto start = VehicleState(5.0, 0.0, 0.0, 0.5, 0.0);
+  const auto goal = VehicleState(-1.0, 1.0, 0.0, 0.0, 0.0);
+  const auto nlp_path_planner = NLPPathPlanner(
+    weights,
+    lower_state_bounds, upper_state_bounds,
+    lower_command_bounds, upper_command_bounds);
+  const auto cold_results = nlp_path_planner.plan_nlp(
+    start, goal, create_dummy_initial_guess(), obstacles, parameters);
+  ASSERT_EQ(cold_results.m_warm_start.m_num_obstacles, obstacles.size());
+  ASSERT_FALSE(cold_results.m_warm_start.m_variables.empty());
+
+  // Replanning the same problem from its solution takes fewer iterations
+  const auto warm_results = nlp_path_planner.plan_nlp(
+    start, goal, create_dummy_initial_guess(), obstacles, parameters,
+    cold_results.m_warm_start);
+  EXPECT_LT(
+    warm_results.m_solve_info.at("iter_count").to_int(),
+    cold_results.m_solve_info.at("iter_count").to_int());
+  ASSERT_EQ(warm_results.m_trajectory.size(), cold_results.m_trajectory.size());
+  EXPECT_NEAR(
+    warm_results.m_trajectory.back().get_state().get_x(),
+    cold_results.m_trajectory.back().get_state().get_x(), 1e-3);
+}
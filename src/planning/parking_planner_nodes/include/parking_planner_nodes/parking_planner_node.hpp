@@ -37,6 +37,7 @@
 #include <rclcpp_action/rclcpp_action.hpp>
 #include <rclcpp/rclcpp.hpp>
 
+#include <chrono>
 #include <string>
 #include <memory>
 #include <vector>
@@ -64,6 +65,9 @@ using ParkerVehicleState = autoware::motion::planning::parking_planner::VehicleS
 using ParkerVehicleCommand = autoware::motion::planning::parking_planner::VehicleCommand<float64_t>;
 using ParkingPolytope = autoware::motion::planning::parking_planner::Polytope2D<float64_t>;
 using ParkingPlanner = autoware::motion::planning::parking_planner::ParkingPlanner;
+using ParkerAstarConfig = autoware::motion::planning::parking_planner::AstarConfig;
+using ParkerHeuristicTable = autoware::motion::planning::parking_planner::HeuristicTable;
+using ParkerNLPWarmStart = autoware::motion::planning::parking_planner::NLPWarmStart;
 using autoware_auto_msgs::msg::TrajectoryPoint;
 using AutowareTrajectory = autoware_auto_msgs::msg::Trajectory;
 
@@ -88,6 +92,21 @@ protected:
   rclcpp::Publisher<autoware_auto_msgs::msg::BoundingBoxArray>::SharedPtr
     m_debug_start_end_publisher;
 
+  // Solution of the last plan, warm starting a replan to the same goal
+  bool m_nlp_warm_start_enabled{false};
+  bool m_has_warm_start{false};
+  ParkerNLPWarmStart m_warm_start{};
+  ParkerVehicleState m_warm_start_goal{};
+  // Goal variant the last plan reached
+  ParkerVehicleState m_warm_start_target{};
+  rclcpp::Time m_warm_start_time{};
+
+  // Goal variants planned concurrently
+  bool m_speculative_goals_enabled{false};
+  bool m_speculative_reverse_entry{true};
+  float64_t m_speculative_longitudinal_offset{0.0};
+  std::chrono::nanoseconds m_speculative_time_budget{std::chrono::nanoseconds::zero()};
+
 private:
   PARKING_PLANNER_NODES_LOCAL void init(
     const VehicleConfig & vehicle_param,
@@ -95,7 +114,8 @@ private:
     const ParkerVehicleState & lower_state_bounds,
     const ParkerVehicleState & upper_state_bounds,
     const ParkerVehicleCommand & lower_command_bounds,
-    const ParkerVehicleCommand & upper_command_bounds
+    const ParkerVehicleCommand & upper_command_bounds,
+    const ParkerAstarConfig & astar_config
   );
 
   PARKING_PLANNER_NODES_LOCAL void debug_publish_obstacles(
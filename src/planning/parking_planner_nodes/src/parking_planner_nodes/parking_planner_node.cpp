@@ -17,6 +17,7 @@
 #include <parking_planner/parking_planner.hpp>
 #include <parking_planner/configuration.hpp>
 #include <parking_planner/geometry.hpp>
+#include <parking_planner/heuristic_table.hpp>
 #include <autoware_auto_msgs/msg/trajectory_point.hpp>
 #include <autoware_auto_msgs/msg/trajectory.hpp>
 #include <lanelet2_core/LaneletMap.h>
@@ -32,11 +33,13 @@
 #include <geometry/bounding_box/rotating_calipers.hpp>
 #include <motion_common/motion_common.hpp>
 #include <chrono>
+#include <cmath>
 #include <algorithm>
 #include <memory>
 #include <limits>
 #include <vector>
 #include <list>
+#include <stdexcept>
 #include <string>
 #include <utility>
 #include <thread>
@@ -132,9 +135,40 @@ ParkingPlannerNode::ParkingPlannerNode(
     f32_param("command_bounds.upper.throttle_mps2"),
   };
 
+  // Bounds the time spent in the A* search, which returns the best path found when it runs out
+  ParkerAstarConfig astar_config{};
+  astar_config.time_budget = std::chrono::milliseconds(
+    declare_parameter("astar.time_budget_ms", 0));
+  astar_config.initial_epsilon = declare_parameter("astar.initial_epsilon", 1.0);
+  astar_config.epsilon_decrement = declare_parameter("astar.epsilon_decrement", 0.5);
+  // The search still works with the distance to the goal as heuristic, but expands more states
+  auto heuristic_table_path =
+    declare_parameter("astar.heuristic_table_path", std::string{});
+  if (heuristic_table_path.empty()) {
+    heuristic_table_path = ParkerHeuristicTable::default_path();
+  }
+  try {
+    astar_config.heuristic_table = std::make_shared<const ParkerHeuristicTable>(
+      ParkerHeuristicTable::load(heuristic_table_path));
+  } catch (const std::runtime_error & e) {
+    RCLCPP_WARN(
+      get_logger(), "Using the distance to the goal as A* heuristic: %s", e.what());
+  }
+
+  // Replans to the same goal start the NLP from the previous solution
+  m_nlp_warm_start_enabled = declare_parameter("nlp.warm_start", true);
+
+  // Ambiguous parking spots are planned for several goal variants at once, keeping the best plan
+  m_speculative_goals_enabled = declare_parameter("speculative_goals.enabled", false);
+  m_speculative_reverse_entry = declare_parameter("speculative_goals.reverse_entry", true);
+  m_speculative_longitudinal_offset =
+    declare_parameter("speculative_goals.longitudinal_offset_m", 0.0);
+  m_speculative_time_budget = std::chrono::milliseconds(
+    declare_parameter("speculative_goals.time_budget_ms", 0));
+
   init(
     vehicle_param, optimization_weights, lower_state_bounds, upper_state_bounds,
-    lower_command_bounds, upper_command_bounds);
+    lower_command_bounds, upper_command_bounds, astar_config);
 }
 
 void ParkingPlannerNode::init(
@@ -143,7 +177,8 @@ void ParkingPlannerNode::init(
   const ParkerVehicleState & lower_state_bounds,
   const ParkerVehicleState & upper_state_bounds,
   const ParkerVehicleCommand & lower_command_bounds,
-  const ParkerVehicleCommand & upper_command_bounds
+  const ParkerVehicleCommand & upper_command_bounds,
+  const ParkerAstarConfig & astar_config
 )
 {
   const ParkerModelParameters model_parameters(
@@ -158,7 +193,7 @@ void ParkingPlannerNode::init(
   m_planner = std::make_unique<autoware::motion::planning::parking_planner::ParkingPlanner>(
     model_parameters, optimization_weights,
     lower_state_bounds,
-    upper_state_bounds, lower_command_bounds, upper_command_bounds);
+    upper_state_bounds, lower_command_bounds, upper_command_bounds, astar_config);
 
   m_debug_obstacles_publisher = this->create_publisher<visualization_msgs::msg::MarkerArray>(
     "parking_debug_obstacles",
@@ -324,7 +359,72 @@ AutowareTrajectory ParkingPlannerNode::plan_trajectory(
 
   this->debug_publish_start_and_end(starting_state, goal_state);
 
-  const auto planner_result = m_planner->plan(starting_state, goal_state, obstacles);
+  // A replan to the same goal starts from the previous solution, shifted by the stages the
+  // vehicle has driven since then
+  const auto same_goal = [this, &goal_state]() {
+      constexpr auto tolerance = 1.0e-3;
+      return (std::abs(goal_state.get_x() - m_warm_start_goal.get_x()) < tolerance) &&
+             (std::abs(goal_state.get_y() - m_warm_start_goal.get_y()) < tolerance) &&
+             (std::abs(goal_state.get_heading() - m_warm_start_goal.get_heading()) < tolerance);
+    };
+  const auto plan_time = now();
+  bool use_warm_start = m_nlp_warm_start_enabled && m_has_warm_start && same_goal();
+  std::size_t elapsed_steps = {};
+  if (use_warm_start) {
+    const auto steps =
+      (plan_time - m_warm_start_time).seconds() / parking_planner::INTEGRATION_STEP_SIZE;
+    use_warm_start = (steps >= 0.0) &&
+      (steps < static_cast<float64_t>(parking_planner::HORIZON_LENGTH));
+    elapsed_steps = use_warm_start ? static_cast<std::size_t>(steps) : 0U;
+  }
+
+  // The variants are the goal shifted along its heading and the goal with the opposite heading
+  constexpr auto pi = 3.14159265358979;
+  std::vector<ParkerVehicleState> goal_variants{goal_state};
+  if (m_speculative_goals_enabled && !use_warm_start) {
+    if (m_speculative_longitudinal_offset > 0.0) {
+      for (const auto direction : {-1.0, 1.0}) {
+        auto variant = goal_state;
+        const auto offset = direction * m_speculative_longitudinal_offset;
+        variant.set_x(goal_state.get_x() + (offset * std::cos(goal_state.get_heading())));
+        variant.set_y(goal_state.get_y() + (offset * std::sin(goal_state.get_heading())));
+        goal_variants.push_back(variant);
+      }
+    }
+    if (m_speculative_reverse_entry) {
+      auto variant = goal_state;
+      variant.set_heading(std::remainder(goal_state.get_heading() + pi, 2.0 * pi));
+      goal_variants.push_back(variant);
+    }
+  }
+
+  const auto planner_result = use_warm_start ?
+    m_planner->plan(
+    starting_state, m_warm_start_target, obstacles,
+    parking_planner::shift_warm_start(m_warm_start, elapsed_steps)) :
+    (goal_variants.size() > 1U) ?
+    m_planner->plan(starting_state, goal_variants, obstacles, m_speculative_time_budget) :
+    m_planner->plan(starting_state, goal_state, obstacles);
+  m_has_warm_start = planner_result.get_status() == ParkingStatus::OK;
+  if (m_has_warm_start && !use_warm_start) {
+    // The variant reached by the plan is the one closest to its end
+    const auto & end_state = planner_result.get_trajectory().back().get_state();
+    const auto distance = [&end_state](const ParkerVehicleState & variant) {
+        const auto heading_difference =
+          std::remainder(end_state.get_heading() - variant.get_heading(), 2.0 * pi);
+        return std::hypot(
+          end_state.get_x() - variant.get_x(), end_state.get_y() - variant.get_y()) +
+               std::abs(heading_difference);
+      };
+    m_warm_start_target = *std::min_element(
+      goal_variants.begin(), goal_variants.end(),
+      [&distance](const auto & a, const auto & b) {return distance(a) < distance(b);});
+  }
+  if (m_has_warm_start) {
+    m_warm_start = planner_result.get_warm_start();
+    m_warm_start_goal = goal_state;
+    m_warm_start_time = plan_time;
+  }
   std::cout << "NLP solution took " << planner_result.get_nlp_iterations() << " iterations" <<
     std::endl;
 
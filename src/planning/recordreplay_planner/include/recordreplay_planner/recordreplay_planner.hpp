@@ -21,11 +21,16 @@
 #include <motion_common/config.hpp>
 #include <common/types.hpp>
 
+#include <cstdint>
 #include <deque>
+#include <fstream>
 #include <string>
 #include <map>
+#include <unordered_map>
+#include <vector>
 
 using autoware::common::types::bool8_t;
+using autoware::common::types::float32_t;
 using autoware::common::types::float64_t;
 
 namespace motion
@@ -82,10 +87,21 @@ public:
   void set_min_record_distance(float64_t min_record_distance);
   float64_t get_min_record_distance() const;
 
-  // Writing/Loading buffered trajectory information to/from disk
+  // Writing/Loading buffered trajectory information to/from disk. Binary files are recognized
+  // when loading, anything else is read as CSV.
   void writeTrajectoryBufferToFile(const std::string & record_path);
+  void writeTrajectoryBufferToBinaryFile(const std::string & record_path);
   void readTrajectoryBufferFromFile(const std::string & replay_path);
 
+  /// \brief Write the recording to a binary file while recording: the states recorded so far
+  ///        are written right away, the following ones as they are recorded
+  /// \param[in] record_path Path of the file, which is overwritten
+  /// \throw std::runtime_error If the file can't be created
+  void startStreamingToBinaryFile(const std::string & record_path);
+  /// \brief Close the file opened by startStreamingToBinaryFile
+  void stopStreamingToBinaryFile();
+  bool8_t is_streaming_to_file() const noexcept;
+
   /**
    * \brief Judges whether current_state has reached the last point in record buffer
    * \param current_state current state of the vehicle
@@ -101,6 +117,27 @@ private:
   // Obtain a trajectory from the internally-stored recording buffer
   RECORDREPLAY_PLANNER_LOCAL const Trajectory & from_record(const State & current_state);
   RECORDREPLAY_PLANNER_LOCAL std::size_t get_closest_state(const State & current_state);
+  // Search only the recorded states around the previously matched one, returns false if the
+  // closest state could lie outside of this window
+  RECORDREPLAY_PLANNER_LOCAL bool8_t get_closest_state_in_window(
+    const State & current_state, std::size_t & closest_idx) const;
+  // Exact search over the whole recording using the spatial index
+  RECORDREPLAY_PLANNER_LOCAL std::size_t get_closest_state_in_index(const State & current_state);
+  RECORDREPLAY_PLANNER_LOCAL void build_index();
+  RECORDREPLAY_PLANNER_LOCAL void readTrajectoryBufferFromBinaryFile(
+    const std::string & replay_path);
+  // Append a newly recorded state to the binary file, if streaming
+  RECORDREPLAY_PLANNER_LOCAL void stream_state(const State & state);
+  RECORDREPLAY_PLANNER_LOCAL float32_t distance(
+    const State & current_state, const State & other_state) const;
+
+  // Number of recorded states searched before and after the previously matched state
+  static constexpr std::size_t WINDOW_SIZE_BEHIND = 10U;
+  static constexpr std::size_t WINDOW_SIZE_AHEAD = 100U;
+  // The window result is discarded if farther than this from the current state, in meters
+  static constexpr float32_t MAX_WINDOW_DISTANCE = 2.0F;
+  // Side length of the cells of the spatial index in meters
+  static constexpr float32_t INDEX_CELL_SIZE = 2.0F;
 
   // Weight of heading in computations of differences between states
   float64_t m_heading_weight = 0.1;
@@ -109,6 +146,20 @@ private:
   std::size_t m_traj_start_idx{};
   std::size_t m_traj_end_idx{};
   std::deque<State> m_record_buffer;
+  // Binary file the recorded states are appended to, if open
+  std::ofstream m_record_file{};
+
+  // Result of the previous closest state search, to start the next search from
+  bool8_t m_has_closest_idx{false};
+  std::size_t m_closest_idx{};
+  // Uniform grid of the indices of the recorded states. Built on the first search after the
+  // recording changed, so once per recording or loaded file.
+  bool8_t m_index_valid{false};
+  std::unordered_map<uint64_t, std::vector<std::size_t>> m_index{};
+  int32_t m_index_min_x{};
+  int32_t m_index_max_x{};
+  int32_t m_index_min_y{};
+  int32_t m_index_max_y{};
   Trajectory m_trajectory{};
   RecordReplayState m_recordreplaystate{RecordReplayState::IDLE};
 };  // class RecordReplayPlanner
@@ -21,8 +21,10 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <sstream>
 #include <string>
@@ -105,6 +107,103 @@ bool loadData(
 
   return true;
 }
+
+// Cell of the spatial index containing the coordinate, saturated to keep far away or invalid
+// coordinates from overflowing
+int32_t to_cell(const float32_t coordinate, const float32_t cell_size)
+{
+  constexpr float64_t LIMIT = 1.0e9;
+  const auto cell = std::floor(static_cast<float64_t>(coordinate / cell_size));
+  return static_cast<int32_t>(std::max(-LIMIT, std::min(cell, LIMIT)));
+}
+
+uint64_t to_key(const int64_t cell_x, const int64_t cell_y)
+{
+  return (static_cast<uint64_t>(static_cast<uint32_t>(cell_x)) << 32U) |
+         static_cast<uint64_t>(static_cast<uint32_t>(cell_y));
+}
+
+// Binary recording files start with a header identifying the format, followed by one fixed size
+// record per state. The number of states follows from the file size, so that states can be
+// appended while recording and a partly written last state is ignored.
+constexpr uint32_t BINARY_FILE_MAGIC = 0x52525042U;  // "BPRR"
+constexpr uint32_t BINARY_FILE_VERSION = 1U;
+
+struct BinaryFileHeader
+{
+  uint32_t magic;
+  uint32_t version;
+  uint32_t record_size;
+  uint32_t reserved;
+};
+
+struct BinaryRecord
+{
+  int32_t stamp_sec;
+  uint32_t stamp_nanosec;
+  int32_t time_from_start_sec;
+  uint32_t time_from_start_nanosec;
+  float32_t x;
+  float32_t y;
+  float32_t heading_real;
+  float32_t heading_imag;
+  float32_t longitudinal_velocity_mps;
+  float32_t lateral_velocity_mps;
+  float32_t acceleration_mps2;
+  float32_t heading_rate_rps;
+  float32_t front_wheel_angle_rad;
+  float32_t rear_wheel_angle_rad;
+};
+static_assert(sizeof(BinaryRecord) == 56U, "Binary record is expected to be packed");
+
+using autoware_auto_msgs::msg::VehicleKinematicState;
+
+void writeBinaryHeader(std::ofstream & ofs)
+{
+  const BinaryFileHeader header{BINARY_FILE_MAGIC, BINARY_FILE_VERSION, sizeof(BinaryRecord), 0U};
+  ofs.write(reinterpret_cast<const char8_t *>(&header), sizeof(header));
+}
+
+void writeBinaryRecord(std::ofstream & ofs, const VehicleKinematicState & state)
+{
+  const auto & s = state.state;
+  const BinaryRecord record{
+    state.header.stamp.sec, state.header.stamp.nanosec,
+    s.time_from_start.sec, s.time_from_start.nanosec,
+    s.x, s.y, s.heading.real, s.heading.imag, s.longitudinal_velocity_mps,
+    s.lateral_velocity_mps, s.acceleration_mps2, s.heading_rate_rps, s.front_wheel_angle_rad,
+    s.rear_wheel_angle_rad};
+  ofs.write(reinterpret_cast<const char8_t *>(&record), sizeof(record));
+}
+
+VehicleKinematicState fromBinaryRecord(const BinaryRecord & record)
+{
+  VehicleKinematicState state;
+  state.header.stamp.sec = record.stamp_sec;
+  state.header.stamp.nanosec = record.stamp_nanosec;
+  auto & s = state.state;
+  s.time_from_start.sec = record.time_from_start_sec;
+  s.time_from_start.nanosec = record.time_from_start_nanosec;
+  s.x = record.x;
+  s.y = record.y;
+  s.heading.real = record.heading_real;
+  s.heading.imag = record.heading_imag;
+  s.longitudinal_velocity_mps = record.longitudinal_velocity_mps;
+  s.lateral_velocity_mps = record.lateral_velocity_mps;
+  s.acceleration_mps2 = record.acceleration_mps2;
+  s.heading_rate_rps = record.heading_rate_rps;
+  s.front_wheel_angle_rad = record.front_wheel_angle_rad;
+  s.rear_wheel_angle_rad = record.rear_wheel_angle_rad;
+  return state;
+}
+
+bool isBinaryFile(const std::string & file_name)
+{
+  std::ifstream ifs(file_name, std::ios::binary);
+  uint32_t magic{};
+  ifs.read(reinterpret_cast<char8_t *>(&magic), sizeof(magic));
+  return ifs && (magic == BINARY_FILE_MAGIC);
+}
 }  // namespace
 namespace motion
 {
@@ -115,6 +214,11 @@ namespace recordreplay_planner
 using geometry_msgs::msg::Point32;
 using motion::motion_common::to_angle;
 
+constexpr std::size_t RecordReplayPlanner::WINDOW_SIZE_BEHIND;
+constexpr std::size_t RecordReplayPlanner::WINDOW_SIZE_AHEAD;
+constexpr float32_t RecordReplayPlanner::MAX_WINDOW_DISTANCE;
+constexpr float32_t RecordReplayPlanner::INDEX_CELL_SIZE;
+
 RecordReplayPlanner::RecordReplayPlanner() {}
 
 // These may do more in the future
@@ -141,6 +245,8 @@ void RecordReplayPlanner::stop_recording() noexcept
 void RecordReplayPlanner::start_replaying() noexcept
 {
   m_recordreplaystate = RecordReplayState::REPLAYING;
+  // The replay may start anywhere along the recording
+  m_has_closest_idx = false;
 }
 
 void RecordReplayPlanner::stop_replaying() noexcept
@@ -151,6 +257,9 @@ void RecordReplayPlanner::stop_replaying() noexcept
 void RecordReplayPlanner::clear_record() noexcept
 {
   m_record_buffer.clear();
+  m_has_closest_idx = false;
+  m_index_valid = false;
+  m_index.clear();
 }
 
 std::size_t RecordReplayPlanner::get_record_length() const noexcept
@@ -190,6 +299,8 @@ bool RecordReplayPlanner::record_state(const State & state_to_record)
 {
   if (m_record_buffer.empty()) {
     m_record_buffer.push_back(state_to_record);
+    m_index_valid = false;
+    stream_state(state_to_record);
     return true;
   }
 
@@ -201,6 +312,8 @@ bool RecordReplayPlanner::record_state(const State & state_to_record)
 
   if (static_cast<float64_t>(distance_sq) >= (m_min_record_distance * m_min_record_distance) ) {
     m_record_buffer.push_back(state_to_record);
+    m_index_valid = false;
+    stream_state(state_to_record);
     return true;
   } else {
     return false;
@@ -213,27 +326,160 @@ const Trajectory & RecordReplayPlanner::plan(const State & current_state)
 }
 
 
+float32_t RecordReplayPlanner::distance(
+  const State & current_state, const State & other_state) const
+{
+  const auto s1 = current_state.state, s2 = other_state.state;
+  return (s1.x - s2.x) * (s1.x - s2.x) + (s1.y - s2.y) * (s1.y - s2.y) +
+         static_cast<float32_t>(m_heading_weight) * std::abs(to_angle(s1.heading - s2.heading));
+}
+
 std::size_t RecordReplayPlanner::get_closest_state(const State & current_state)
 {
-  // Find the closest point to the current state in the stored states buffer
-  const auto distance_from_current_state =
-    [this, &current_state](State & other_state) {
-      const auto s1 = current_state.state, s2 = other_state.state;
-      return (s1.x - s2.x) * (s1.x - s2.x) + (s1.y - s2.y) * (s1.y - s2.y) +
-             static_cast<float32_t>(m_heading_weight) * std::abs(to_angle(s1.heading - s2.heading));
+  // Find the closest point to the current state in the stored states buffer. The vehicle
+  // progresses little between two plans, so the previous match is usually a good start. This
+  // also keeps the match on the current pass where the recording crosses itself.
+  std::size_t closest_idx{};
+  if (!m_has_closest_idx || !get_closest_state_in_window(current_state, closest_idx)) {
+    closest_idx = get_closest_state_in_index(current_state);
+  }
+  m_has_closest_idx = true;
+  m_closest_idx = closest_idx;
+  return closest_idx;
+}
+
+bool8_t RecordReplayPlanner::get_closest_state_in_window(
+  const State & current_state, std::size_t & closest_idx) const
+{
+  const auto record_length = m_record_buffer.size();
+  if (m_closest_idx >= record_length) {
+    return false;
+  }
+  const auto window_begin = m_closest_idx - std::min(m_closest_idx, WINDOW_SIZE_BEHIND);
+  const auto window_end = std::min(record_length, m_closest_idx + WINDOW_SIZE_AHEAD + 1U);
+
+  auto minimum_idx = window_begin;
+  auto minimum_distance = distance(current_state, m_record_buffer[window_begin]);
+  for (auto idx = window_begin + 1U; idx < window_end; ++idx) {
+    const auto idx_distance = distance(current_state, m_record_buffer[idx]);
+    if (idx_distance < minimum_distance) {
+      minimum_idx = idx;
+      minimum_distance = idx_distance;
+    }
+  }
+
+  if ((window_begin > 0U) || (window_end < record_length)) {
+    // A minimum on a border of the window may continue outside of it, and a distant minimum
+    // means that the vehicle is not following the recording around the previous match anymore
+    const auto on_border = ((minimum_idx == window_begin) && (window_begin > 0U)) ||
+      ((minimum_idx + 1U == window_end) && (window_end < record_length));
+    if (on_border || !(minimum_distance <= MAX_WINDOW_DISTANCE * MAX_WINDOW_DISTANCE)) {
+      return false;
+    }
+  }
+  closest_idx = minimum_idx;
+  return true;
+}
+
+std::size_t RecordReplayPlanner::get_closest_state_in_index(const State & current_state)
+{
+  if (!m_index_valid) {
+    build_index();
+  }
+  const auto record_length = m_record_buffer.size();
+  auto minimum_idx = record_length;
+  auto minimum_distance = std::numeric_limits<float32_t>::infinity();
+  const auto update_minimum = [&](const std::size_t idx) {
+      const auto idx_distance = distance(current_state, m_record_buffer[idx]);
+      // Same tie breaking as a linear search
+      if ((idx_distance < minimum_distance) ||
+        ((idx_distance == minimum_distance) && (idx < minimum_idx)))
+      {
+        minimum_idx = idx;
+        minimum_distance = idx_distance;
+      }
     };
-  const auto comparison_function =
-    [&distance_from_current_state](State & one, State & two)
-    {return distance_from_current_state(one) < distance_from_current_state(two);};
 
+  const auto & state = current_state.state;
+  if (record_length > 0U && std::isfinite(state.x) && std::isfinite(state.y)) {
+    const int64_t cell_x = to_cell(state.x, INDEX_CELL_SIZE);
+    const int64_t cell_y = to_cell(state.y, INDEX_CELL_SIZE);
+    // Search rings of cells around the cell of the current state, starting with the first one
+    // that overlaps the recording. Once the rings up to r were searched, the remaining states
+    // are at least r cells away, which bounds their distance from below.
+    const int64_t first_ring = std::max<int64_t>(
+      {0, m_index_min_x - cell_x, cell_x - m_index_max_x, m_index_min_y - cell_y,
+        cell_y - m_index_max_y});
+    const int64_t last_ring = std::max<int64_t>(
+      {cell_x - m_index_min_x, m_index_max_x - cell_x, cell_y - m_index_min_y,
+        m_index_max_y - cell_y});
+    // Sparse recordings spanning a large area are faster to search linearly
+    std::size_t num_visited_cells = 0U;
+    bool8_t linear_search = false;
+    const auto visit_cell = [&](const int64_t x, const int64_t y) {
+        const auto cell = m_index.find(to_key(x, y));
+        if (cell != m_index.end()) {
+          for (const auto idx : cell->second) {
+            update_minimum(idx);
+          }
+        }
+      };
+    for (auto ring = first_ring; (ring <= last_ring) && !linear_search; ++ring) {
+      const auto x_begin = std::max<int64_t>(cell_x - ring, m_index_min_x);
+      const auto x_end = std::min<int64_t>(cell_x + ring, m_index_max_x);
+      for (auto x = x_begin; (x <= x_end) && !linear_search; ++x) {
+        if ((x == cell_x - ring) || (x == cell_x + ring)) {
+          const auto y_begin = std::max<int64_t>(cell_y - ring, m_index_min_y);
+          const auto y_end = std::min<int64_t>(cell_y + ring, m_index_max_y);
+          for (auto y = y_begin; (y <= y_end) && (num_visited_cells <= record_length); ++y) {
+            visit_cell(x, y);
+            ++num_visited_cells;
+          }
+        } else {
+          for (const auto y : {cell_y - ring, cell_y + ring}) {
+            if ((y >= m_index_min_y) && (y <= m_index_max_y)) {
+              visit_cell(x, y);
+            }
+          }
+        }
+        ++num_visited_cells;
+        linear_search = num_visited_cells > record_length;
+      }
+      const auto bound = static_cast<float32_t>(ring) * INDEX_CELL_SIZE;
+      if (!linear_search && (minimum_idx < record_length) &&
+        ((minimum_distance < bound * bound) || (ring == last_ring)))
+      {
+        return minimum_idx;
+      }
+    }
+  }
 
-  const auto minimum_index_iterator =
-    std::min_element(
-    std::begin(m_record_buffer), std::end(m_record_buffer),
-    comparison_function);
-  auto minimum_idx = std::distance(std::begin(m_record_buffer), minimum_index_iterator);
+  minimum_idx = record_length;
+  minimum_distance = std::numeric_limits<float32_t>::infinity();
+  for (std::size_t idx = 0U; idx < record_length; ++idx) {
+    update_minimum(idx);
+  }
+  return (minimum_idx < record_length) ? minimum_idx : 0U;
+}
 
-  return static_cast<std::size_t>(minimum_idx);
+void RecordReplayPlanner::build_index()
+{
+  m_index.clear();
+  m_index_min_x = std::numeric_limits<int32_t>::max();
+  m_index_max_x = std::numeric_limits<int32_t>::lowest();
+  m_index_min_y = std::numeric_limits<int32_t>::max();
+  m_index_max_y = std::numeric_limits<int32_t>::lowest();
+  for (std::size_t idx = 0U; idx < m_record_buffer.size(); ++idx) {
+    const auto & state = m_record_buffer[idx].state;
+    const auto cell_x = to_cell(state.x, INDEX_CELL_SIZE);
+    const auto cell_y = to_cell(state.y, INDEX_CELL_SIZE);
+    m_index[to_key(cell_x, cell_y)].push_back(idx);
+    m_index_min_x = std::min(m_index_min_x, cell_x);
+    m_index_max_x = std::max(m_index_max_x, cell_x);
+    m_index_min_y = std::min(m_index_min_y, cell_y);
+    m_index_max_y = std::max(m_index_max_y, cell_y);
+  }
+  m_index_valid = true;
 }
 
 
@@ -319,6 +565,99 @@ void RecordReplayPlanner::writeTrajectoryBufferToFile(const std::string & record
   ofs.close();
 }
 
+void RecordReplayPlanner::writeTrajectoryBufferToBinaryFile(const std::string & record_path)
+{
+  if (record_path.empty()) {
+    throw std::runtime_error("record_path cannot be empty");
+  }
+
+  std::ofstream ofs;
+  ofs.open(record_path, std::ios::binary | std::ios::trunc);
+  if (!ofs.is_open()) {
+    throw std::runtime_error("Could not open file.");
+  }
+  writeBinaryHeader(ofs);
+  for (const auto & state : m_record_buffer) {
+    writeBinaryRecord(ofs, state);
+  }
+  ofs.close();
+  if (!ofs) {
+    throw std::runtime_error("Could not write file.");
+  }
+}
+
+void RecordReplayPlanner::startStreamingToBinaryFile(const std::string & record_path)
+{
+  if (record_path.empty()) {
+    throw std::runtime_error("record_path cannot be empty");
+  }
+
+  stopStreamingToBinaryFile();
+  m_record_file.open(record_path, std::ios::binary | std::ios::trunc);
+  if (!m_record_file.is_open()) {
+    m_record_file.clear();
+    throw std::runtime_error("Could not open file.");
+  }
+  writeBinaryHeader(m_record_file);
+  for (const auto & state : m_record_buffer) {
+    writeBinaryRecord(m_record_file, state);
+  }
+  m_record_file.flush();
+}
+
+void RecordReplayPlanner::stopStreamingToBinaryFile()
+{
+  if (m_record_file.is_open()) {
+    m_record_file.close();
+  }
+  m_record_file.clear();
+}
+
+bool8_t RecordReplayPlanner::is_streaming_to_file() const noexcept
+{
+  return m_record_file.is_open();
+}
+
+void RecordReplayPlanner::stream_state(const State & state)
+{
+  if (m_record_file.is_open()) {
+    // Flushed so that the file holds the whole recording if the process ends unexpectedly
+    writeBinaryRecord(m_record_file, state);
+    m_record_file.flush();
+  }
+}
+
+void RecordReplayPlanner::readTrajectoryBufferFromBinaryFile(const std::string & replay_path)
+{
+  std::ifstream ifs(replay_path, std::ios::binary | std::ios::ate);
+  if (!ifs) {
+    throw std::runtime_error("Could not open file.");
+  }
+  const auto file_size = static_cast<std::size_t>(ifs.tellg());
+  ifs.seekg(0);
+  BinaryFileHeader header{};
+  ifs.read(reinterpret_cast<char8_t *>(&header), sizeof(header));
+  if (!ifs || (header.magic != BINARY_FILE_MAGIC) || (header.version != BINARY_FILE_VERSION) ||
+    (header.record_size != sizeof(BinaryRecord)))
+  {
+    throw std::runtime_error("Unsupported binary trajectory file: " + replay_path);
+  }
+
+  // All states are read at once, without any parsing
+  std::vector<BinaryRecord> records((file_size - sizeof(header)) / sizeof(BinaryRecord));
+  ifs.read(
+    reinterpret_cast<char8_t *>(records.data()),
+    static_cast<std::streamsize>(records.size() * sizeof(BinaryRecord)));
+  if (!ifs) {
+    throw std::runtime_error("Could not read file.");
+  }
+  // The states were filtered when recording, so they are taken over as they are
+  for (const auto & record : records) {
+    m_record_buffer.push_back(fromBinaryRecord(record));
+  }
+  m_index_valid = false;
+}
+
 void RecordReplayPlanner::readTrajectoryBufferFromFile(const std::string & replay_path)
 {
   if (replay_path.empty()) {
@@ -328,6 +667,11 @@ void RecordReplayPlanner::readTrajectoryBufferFromFile(const std::string & repla
   // Clear current trajectory deque
   clear_record();
 
+  if (isBinaryFile(replay_path)) {
+    readTrajectoryBufferFromBinaryFile(replay_path);
+    return;
+  }
+
   Csv file_data;
   Association map;  // row labeled Association map
   if (!loadData(replay_path, map, file_data)) {
@@ -26,8 +26,12 @@
 #include <chrono>
 #include <set>
 #include <algorithm>
+#include <limits>
+#include <random>
 #include <string>
 #include <cstdio>
+#include <fstream>
+#include <vector>
 
 using motion::planning::recordreplay_planner::RecordReplayPlanner;
 using std::chrono::system_clock;
@@ -275,6 +279,78 @@ TEST(RecordreplayWriteReadTrajectory, WriteReadTrajectory)
   }
 }
 
+// Test write/read trajectory to/from a binary file
+TEST(RecordreplayWriteReadTrajectory, WriteReadBinaryTrajectory)
+{
+  std::string file_name("write_test_binary.trajectory");
+
+  const auto N = 5;
+  auto planner = helper_create_and_record_example(N);
+
+  planner.writeTrajectoryBufferToBinaryFile(file_name);
+  planner.clear_record();
+  planner.readTrajectoryBufferFromFile(file_name);
+
+  EXPECT_EQ(std::remove(file_name.c_str()), 0);
+  ASSERT_EQ(planner.get_record_length(), static_cast<std::size_t>(N));
+
+  // Same replayed trajectory as from the original recording
+  const auto t0 = system_clock::from_time_t({});
+  auto trajectory = planner.plan(make_state(0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, t0));
+  const auto expected = helper_create_and_record_example(N).plan(
+    make_state(0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, t0));
+  ASSERT_EQ(trajectory.points.size(), expected.points.size());
+  for (uint32_t k = {}; k < N; ++k) {
+    EXPECT_EQ(expected.points[k].x, trajectory.points[k].x);
+    EXPECT_EQ(expected.points[k].time_from_start.sec, trajectory.points[k].time_from_start.sec);
+    EXPECT_EQ(
+      expected.points[k].time_from_start.nanosec, trajectory.points[k].time_from_start.nanosec);
+  }
+}
+
+// States recorded while streaming are in the file without writing the buffer at the end
+TEST(RecordreplayWriteReadTrajectory, StreamBinaryTrajectory)
+{
+  std::string file_name("stream_test.trajectory");
+
+  const auto N = 5U;
+  auto planner = helper_create_and_record_example(N);
+  planner.startStreamingToBinaryFile(file_name);
+  EXPECT_TRUE(planner.is_streaming_to_file());
+
+  const auto t0 = system_clock::from_time_t({});
+  for (uint32_t k = N; k < 2U * N; ++k) {
+    planner.record_state(make_state(1.0F * k, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, t0));
+    // Everything recorded so far can be read while still streaming
+    auto reader = RecordReplayPlanner{};
+    reader.readTrajectoryBufferFromFile(file_name);
+    EXPECT_EQ(reader.get_record_length(), static_cast<std::size_t>(k + 1U));
+  }
+  planner.stopStreamingToBinaryFile();
+  EXPECT_FALSE(planner.is_streaming_to_file());
+
+  // Not streamed anymore
+  planner.record_state(make_state(2.0F * N, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, t0));
+  auto reader = RecordReplayPlanner{};
+  reader.readTrajectoryBufferFromFile(file_name);
+  ASSERT_EQ(reader.get_record_length(), static_cast<std::size_t>(2U * N));
+  auto trajectory = reader.plan(make_state(0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, t0));
+  for (uint32_t k = {}; k < 2U * N; ++k) {
+    EXPECT_EQ(1.0F * k, trajectory.points[k].x);
+  }
+
+  // A partly written last state is ignored
+  {
+    std::ofstream ofs(file_name, std::ios::binary | std::ios::app);
+    ofs << "partial";
+  }
+  reader.readTrajectoryBufferFromFile(file_name);
+  EXPECT_EQ(reader.get_record_length(), static_cast<std::size_t>(2U * N));
+
+  EXPECT_EQ(std::remove(file_name.c_str()), 0);
+  EXPECT_THROW(planner.startStreamingToBinaryFile(""), std::runtime_error);
+}
+
 TEST(RecordreplayWriteReadTrajectory, writeTrajectoryEmptyPath)
 {
   const auto N = 5;
@@ -332,3 +408,93 @@ TEST(RecordreplayReachGoal, checkReachGoalCondition)
     EXPECT_TRUE(planner.reached_goal(vehicle_state, distance_thresh, angle_thresh));
   }
 }
+
+// Index of the recorded state closest to the given state, by a linear search over the recording
+std::size_t helper_closest_state_linear(
+  const std::vector<TrajectoryPoint> & record, const TrajectoryPoint & point,
+  const float64_t heading_weight)
+{
+  std::size_t closest_idx = 0U;
+  auto closest_distance = std::numeric_limits<float32_t>::infinity();
+  for (std::size_t idx = 0U; idx < record.size(); ++idx) {
+    const auto & other = record[idx];
+    const auto distance = (point.x - other.x) * (point.x - other.x) +
+      (point.y - other.y) * (point.y - other.y) + static_cast<float32_t>(heading_weight) *
+      std::abs(motion::motion_common::to_angle(point.heading - other.heading));
+    if (distance < closest_distance) {
+      closest_idx = idx;
+      closest_distance = distance;
+    }
+  }
+  return closest_idx;
+}
+
+// The spatial index used to find the closest recorded state has to give the same result as
+// a search over the whole recording
+TEST(recordreplay_sanity_checks, closest_state_matches_linear_search)
+{
+  const auto t0 = system_clock::from_time_t({});
+  std::mt19937 gen{42U};
+  std::uniform_real_distribution<float32_t> step{-0.5F, 0.5F};
+  std::uniform_real_distribution<float32_t> heading{-3.0F, 3.0F};
+
+  for (const float32_t spacing : {1.0F, 100.0F}) {
+    auto planner = RecordReplayPlanner{};
+    planner.set_heading_weight(0.5);
+    std::vector<TrajectoryPoint> record;
+    // Random walk, dense and sparse compared to the index cells
+    float32_t x = 0.0F;
+    float32_t y = 0.0F;
+    for (uint32_t k = {}; k < 2000U; ++k) {
+      x += spacing * step(gen);
+      y += spacing * step(gen);
+      const auto state = make_state(
+        x, y, heading(gen), 0.0F, 0.0F, 0.0F, t0 + k * std::chrono::milliseconds{100LL});
+      ASSERT_TRUE(planner.record_state(state));
+      record.push_back(state.state);
+    }
+
+    std::uniform_real_distribution<float32_t> position{-50.0F * spacing, 50.0F * spacing};
+    for (uint32_t k = {}; k < 500U; ++k) {
+      const auto state =
+        make_state(position(gen), position(gen), heading(gen), 0.0F, 0.0F, 0.0F, t0);
+      // Forget the previous match, which would restrict the search to its neighborhood
+      planner.start_replaying();
+      const auto & trajectory = planner.plan(state);
+      const auto expected_idx = helper_closest_state_linear(record, state.state, 0.5);
+      EXPECT_EQ(record.size() - expected_idx, trajectory.points.size());
+    }
+  }
+}
+
+// Where the recording passes the same place twice, the replay keeps following the current pass
+TEST(recordreplay_sanity_checks, closest_state_follows_current_pass)
+{
+  const auto t0 = system_clock::from_time_t({});
+  const uint32_t N = 100U;
+  const float32_t step = 2.0F * autoware::common::types::PI / static_cast<float32_t>(N);
+  auto planner = RecordReplayPlanner{};
+  planner.set_heading_weight(0.0);
+
+  // Two laps around a circle, the second one slightly outside of the first one
+  for (uint32_t k = {}; k < 2U * N; ++k) {
+    const auto radius = (k < N) ? 10.0F : 10.3F;
+    const auto angle = static_cast<float32_t>(k) * step;
+    planner.record_state(
+      make_state(
+        radius * std::cos(angle), radius * std::sin(angle), 0.0F, 0.0F, 0.0F, 0.0F,
+        t0 + k * std::chrono::milliseconds{100LL}));
+  }
+  ASSERT_EQ(planner.get_record_length(), 2U * N);
+
+  planner.start_replaying();
+  // Start of the second lap
+  EXPECT_EQ(N, planner.plan(make_state(10.3F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, t0)).points.size());
+  // Closer to the first lap than to the second one
+  for (uint32_t k = 1U; k < N; ++k) {
+    const auto angle = static_cast<float32_t>(k) * step;
+    const auto & trajectory = planner.plan(
+      make_state(10.14F * std::cos(angle), 10.14F * std::sin(angle), 0.0F, 0.0F, 0.0F, 0.0F, t0));
+    EXPECT_EQ(N - k, trajectory.points.size());
+  }
+}
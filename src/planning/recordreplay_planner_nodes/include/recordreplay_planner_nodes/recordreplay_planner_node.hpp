@@ -130,6 +130,8 @@ private:
   std::shared_ptr<tf2_ros::TransformListener> tf_listener_;
 
   bool m_enable_object_collision_estimator = false;
+  // Stream recordings to a binary file instead of writing CSV when the recording is canceled
+  bool m_record_binary_file = true;
   float64_t m_goal_distance_threshold_m = {};
   float64_t m_goal_angle_threshold_rad;
 };  // class RecordReplayPlannerNode
@@ -18,6 +18,7 @@
 #include <autoware_auto_tf2/tf2_autoware_auto_msgs.hpp>
 #include <tf2/LinearMath/Quaternion.h>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <utility>
 
@@ -41,6 +42,7 @@ RecordReplayPlannerNode::RecordReplayPlannerNode(const rclcpp::NodeOptions & nod
   const auto min_record_distance = declare_parameter("min_record_distance").get<float64_t>();
   m_goal_distance_threshold_m = declare_parameter("goal_distance_threshold_m").get<float32_t>();
   m_goal_angle_threshold_rad = declare_parameter("goal_angle_threshold_rad").get<float32_t>();
+  m_record_binary_file = declare_parameter("record_binary_file", true);
 
   using rclcpp::QoS;
   using namespace std::chrono_literals;
@@ -269,9 +271,11 @@ rclcpp_action::CancelResponse RecordReplayPlannerNode::record_handle_cancel(
 
     std::string record_path = goal_handle->get_goal()->record_path;
 
-    // If a path is specified
-    if (record_path.length() > 0) {
-      // Write trajectory to file
+    if (m_planner->is_streaming_to_file()) {
+      // All states were written while recording
+      m_planner->stopStreamingToBinaryFile();
+    } else if (record_path.length() > 0) {
+      // Otherwise write trajectory to file if a path is specified
       m_planner->writeTrajectoryBufferToFile(
         goal_handle->get_goal()->record_path);
     }
@@ -287,6 +291,18 @@ void RecordReplayPlannerNode::record_handle_accepted(
   m_recordgoalhandle = goal_handle;
   m_planner->start_recording();
 
+  // Write the states to the file as they are recorded
+  const auto & record_path = goal_handle->get_goal()->record_path;
+  if (m_record_binary_file && (record_path.length() > 0)) {
+    try {
+      m_planner->startStreamingToBinaryFile(record_path);
+    } catch (const std::runtime_error & e) {
+      RCLCPP_ERROR(
+        get_logger(), "Could not record to %s, falling back to CSV: %s", record_path.c_str(),
+        e.what());
+    }
+  }
+
   // If a path was recorded previously, clear the markers
   clear_recorded_markers();
 }
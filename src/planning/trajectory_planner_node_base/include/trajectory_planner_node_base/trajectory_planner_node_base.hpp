@@ -30,6 +30,8 @@
 #include <autoware_auto_msgs/action/plan_trajectory.hpp>
 #include <autoware_auto_msgs/msg/had_map_route.hpp>
 #include <common/types.hpp>
+#include <startup_tracking/startup_tracker.hpp>
+#include <std_msgs/msg/string.hpp>
 
 // external libraries
 #include <lanelet2_core/LaneletMap.h>
@@ -58,7 +60,8 @@ enum class PlannerState
 class TRAJECTORY_PLANNER_NODE_BASE_PUBLIC TrajectoryPlannerNodeBase : public rclcpp::Node
 {
 public:
-  /// \brief default constructor, starts planner
+  /// \brief default constructor, starts planner. The action server is created once the map
+  ///        service is available
   /// \param[in] node_name name of the ROS node
   /// \param[in] action_server_name The name under which the action server will be created
   /// \param[in] options node options for rclcpp Node
@@ -82,9 +85,13 @@ private:
   using PlanTrajectoryAction = autoware_auto_msgs::action::PlanTrajectory;
   using GoalHandle = rclcpp_action::ServerGoalHandle<PlanTrajectoryAction>;
 
+  common::startup_tracking::StartupTracker m_startup_tracker;
+  common::startup_tracking::StartupGate m_startup_gate;
+
   // ROS Interface
   rclcpp_action::Server<PlanTrajectoryAction>::SharedPtr m_planner_server;
   rclcpp::Client<HADMapService>::SharedPtr m_map_client;
+  rclcpp::Subscription<std_msgs::msg::String>::SharedPtr m_map_version_sub;
 
   // callback
   TRAJECTORY_PLANNER_NODE_BASE_LOCAL rclcpp_action::GoalResponse handle_goal(
@@ -95,12 +102,24 @@ private:
   TRAJECTORY_PLANNER_NODE_BASE_LOCAL void handle_accepted(
     const std::shared_ptr<GoalHandle> goal_handle);
   void map_response(rclcpp::Client<HADMapService>::SharedFuture future);
+  void map_version_callback(const std_msgs::msg::String::SharedPtr msg);
+
+  /// \brief Plan the trajectory of the current goal and send the result
+  void plan_goal(const lanelet::LaneletMapPtr & lanelet_map_ptr);
 
   // \brief Validation of trajectory
   bool8_t is_trajectory_valid(const Trajectory & trajectory);
 
   std::shared_ptr<GoalHandle> m_goal_handle{nullptr};
 
+  /// The version of the map that the map provider announced last, empty if none
+  std::string m_map_version;
+  /// The last map request, and the version and map of its response. The map is reused for the
+  /// same request as long as the announced version is the same, without a service call
+  HADMapService::Request m_cached_map_request;
+  std::string m_cached_map_version;
+  lanelet::LaneletMapPtr m_cached_map;
+
   PlannerState m_planner_state;
   bool8_t is_planning();
   void start_planning();
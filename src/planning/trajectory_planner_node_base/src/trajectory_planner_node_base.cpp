@@ -30,31 +30,33 @@ TrajectoryPlannerNodeBase::TrajectoryPlannerNodeBase(
   const std::string & action_server_name,
   const rclcpp::NodeOptions & node_options)
 : Node{node_name, node_options},
+  m_startup_tracker{*this},
+  m_startup_gate{*this, m_startup_tracker},
   m_planner_state{PlannerState::IDLE}
 {
-  using namespace std::literals::chrono_literals;
-
   // Setup Map Service
   m_map_client = this->create_client<HADMapService>("HAD_Map_Service");
 
-  while (!m_map_client->wait_for_service(1s)) {
-    if (!rclcpp::ok()) {
-      RCLCPP_ERROR(get_logger(), "Interrupted while waiting for map server.");
-      rclcpp::shutdown();
-      return;
-    }
-    RCLCPP_INFO(get_logger(), "Waiting for map service...");
-  }
-
-  m_planner_server = rclcpp_action::create_server<PlanTrajectoryAction>(
-    this->get_node_base_interface(),
-    this->get_node_clock_interface(),
-    this->get_node_logging_interface(),
-    this->get_node_waitables_interface(),
-    action_server_name,
-    [this](auto uuid, auto goal) {return this->handle_goal(uuid, goal);},
-    [this](auto goal_handle) {return this->handle_cancel(goal_handle);},
-    [this](auto goal_handle) {return this->handle_accepted(goal_handle);});
+  // The action server is only offered once the map service is available. Other nodes of the
+  // process keep spinning in the meantime.
+  m_startup_gate.require("map_service", [this]() {return m_map_client->service_is_ready();});
+  m_startup_gate.open_when_ready(
+    [this, action_server_name]() {
+      // The provider announces its map, so that a map can be kept until it changes
+      m_map_version_sub = this->create_subscription<std_msgs::msg::String>(
+        "had_map_version", rclcpp::QoS{1U}.transient_local(),
+        [this](const std_msgs::msg::String::SharedPtr msg) {this->map_version_callback(msg);});
+
+      m_planner_server = rclcpp_action::create_server<PlanTrajectoryAction>(
+        this->get_node_base_interface(),
+        this->get_node_clock_interface(),
+        this->get_node_logging_interface(),
+        this->get_node_waitables_interface(),
+        action_server_name,
+        [this](auto uuid, auto goal) {return this->handle_goal(uuid, goal);},
+        [this](auto goal_handle) {return this->handle_cancel(goal_handle);},
+        [this](auto goal_handle) {return this->handle_accepted(goal_handle);});
+    });
 }
 
 bool8_t TrajectoryPlannerNodeBase::is_trajectory_valid(const Trajectory & trajectory)
@@ -122,6 +124,16 @@ void TrajectoryPlannerNodeBase::handle_accepted(
   auto map_request = std::make_shared<HADMapService::Request>();
   *map_request = create_map_request(m_goal_handle->get_goal()->sub_route);
 
+  // The map provider has not announced another map since the same request
+  if (m_cached_map && (*map_request == m_cached_map_request) &&
+    !m_map_version.empty() && (m_map_version == m_cached_map_version))
+  {
+    plan_goal(m_cached_map);
+    return;
+  }
+  m_cached_map_request = *map_request;
+  m_cached_map.reset();
+
   // TODO(mitsudome-r): If synchronized service request is available,
   // replace it with synchronized implementation
   auto result =
@@ -132,9 +144,26 @@ void TrajectoryPlannerNodeBase::handle_accepted(
 
 void TrajectoryPlannerNodeBase::map_response(rclcpp::Client<HADMapService>::SharedFuture future)
 {
-  auto lanelet_map_ptr = std::make_shared<lanelet::LaneletMap>();
-  autoware::common::had_map_utils::fromBinaryMsg(future.get()->map, lanelet_map_ptr);
+  const auto & map_msg = future.get()->map;
+  // Keeping the map also lets fromBinaryMsgShared() return it again for the same data
+  m_cached_map = autoware::common::had_map_utils::fromBinaryMsgShared(map_msg);
+  m_cached_map_version = map_msg.map_version;
+  plan_goal(m_cached_map);
+}
+
+void TrajectoryPlannerNodeBase::map_version_callback(const std_msgs::msg::String::SharedPtr msg)
+{
+  if (msg->data != m_map_version) {
+    RCLCPP_INFO(get_logger(), "Map version changed to %s", msg->data.c_str());
+  }
+  m_map_version = msg->data;
+  if (m_map_version != m_cached_map_version) {
+    m_cached_map.reset();
+  }
+}
 
+void TrajectoryPlannerNodeBase::plan_goal(const lanelet::LaneletMapPtr & lanelet_map_ptr)
+{
   RCLCPP_INFO(get_logger(), "Start planning");
   const auto & trajectory = plan_trajectory(m_goal_handle->get_goal()->sub_route, lanelet_map_ptr);
   RCLCPP_INFO(get_logger(), "Finished planning");
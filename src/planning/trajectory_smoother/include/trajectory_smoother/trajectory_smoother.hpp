@@ -21,6 +21,8 @@
 
 #include "autoware_auto_msgs/msg/trajectory.hpp"
 #include <common/types.hpp>
+#include <cstddef>
+#include <string>
 #include <vector>
 #include <cmath>
 
@@ -35,28 +37,69 @@ namespace trajectory_smoother
 
 using autoware_auto_msgs::msg::Trajectory;
 using autoware::common::types::float32_t;
+using autoware::common::types::float64_t;
+
+/// \brief How the velocity profile is smoothed
+enum class SmoothingMode
+{
+  /// convolve the velocity profile with a gaussian kernel
+  GAUSSIAN,
+  /// keep the velocity profile below the given velocities and within acceleration and jerk limits
+  JERK_LIMITED
+};
+
+/// \brief Parse a smoothing mode, e.g. from a parameter
+/// \param[in] mode "gaussian" or "jerk_limited"
+/// \return The mode
+/// \throw std::domain_error If the mode is unknown
+TRAJECTORY_SMOOTHER_PUBLIC SmoothingMode smoothing_mode_from_string(const std::string & mode);
 
 typedef struct
 {
   float32_t standard_deviation;  // standard deviation of the gaussian kernel
   uint32_t kernel_size;  // length of the gaussian kernel
+  SmoothingMode mode{SmoothingMode::GAUSSIAN};  // how the velocity profile is smoothed
+  float32_t max_acceleration_mps2{1.0F};  // JERK_LIMITED: limit of the acceleration
+  float32_t max_deceleration_mps2{2.0F};  // JERK_LIMITED: limit of the deceleration, positive
+  float32_t max_jerk_mps3{1.0F};  // JERK_LIMITED: limit of the absolute jerk
 } TrajectorySmootherConfig;
 
 
-/// \brief Smooth over the trajectory by passing it through a gaussian filter
+/// \brief Smooth over the velocity profile of a trajectory, either by passing it through a
+///        gaussian filter or by limiting its acceleration and jerk
 class TRAJECTORY_SMOOTHER_PUBLIC TrajectorySmoother
 {
 public:
   /// \brief Initialise the gaussian kernel in the constructor
-  /// \param[in] config Configuration containing parameters for the kernel
+  /// \param[in] config Configuration containing parameters for the kernel and the limits
+  /// \throw std::domain_error If the mode is JERK_LIMITED and a limit is not positive
   explicit TrajectorySmoother(TrajectorySmootherConfig config);
 
-  /// \brief Make the trajectory velocity smooth by passing it through a gaussian filter.
+  /// \brief Make the trajectory velocity smooth.
+  ///
+  /// GAUSSIAN passes the velocities through a gaussian filter, which takes O(n * kernel_size).
+  /// The first and the last point keep their velocities.
+  ///
+  /// JERK_LIMITED takes O(n). The first point keeps its velocity, the last one is not raised,
+  /// so a stop stays a stop. It assumes that the points are evenly spaced in time, with the
+  /// average step of their time_from_start, and that the velocities are not negative. The result
+  /// is never faster than the given velocities, stays within the acceleration, deceleration and
+  /// jerk limits, and sets the accelerations of the points to match. The only exception is the
+  /// step from the first point, if its velocity is too high to follow the limits. Trajectories
+  /// without a positive duration are not changed.
   /// \param[inout] trajectory The trajectory to be smoothed. This is modified in place.
   void Filter(Trajectory & trajectory);
 
 private:
+  /// \brief The JERK_LIMITED mode of Filter()
+  void limit_jerk(Trajectory & trajectory);
+
   std::vector<float32_t> m_kernel{};
+  TrajectorySmootherConfig m_config;
+  /// Buffers of limit_jerk(), kept to not allocate on every call
+  std::vector<float32_t> m_padded_velocities{};
+  std::vector<float32_t> m_minima{};
+  std::vector<std::size_t> m_window{};
 };
 
 }  // namespace trajectory_smoother
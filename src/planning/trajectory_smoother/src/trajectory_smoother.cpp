@@ -15,6 +15,9 @@
 #include "trajectory_smoother/trajectory_smoother.hpp"
 
 #include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
 #include <vector>
 namespace motion
 {
@@ -25,8 +28,39 @@ namespace trajectory_smoother
 
 using autoware::common::types::float32_t;
 
+namespace
+{
+float64_t to_seconds(const builtin_interfaces::msg::Duration & duration)
+{
+  return static_cast<float64_t>(duration.sec) + (static_cast<float64_t>(duration.nanosec) * 1e-9);
+}
+
+bool is_positive(const float32_t value)
+{
+  return std::isfinite(value) && (value > 0.0F);
+}
+}  // namespace
+
+SmoothingMode smoothing_mode_from_string(const std::string & mode)
+{
+  if (mode == "gaussian") {
+    return SmoothingMode::GAUSSIAN;
+  }
+  if (mode == "jerk_limited") {
+    return SmoothingMode::JERK_LIMITED;
+  }
+  throw std::domain_error("TrajectorySmoother: unknown mode " + mode);
+}
+
 TrajectorySmoother::TrajectorySmoother(TrajectorySmootherConfig config)
+: m_config(config)
 {
+  if ((config.mode == SmoothingMode::JERK_LIMITED) &&
+    (!is_positive(config.max_acceleration_mps2) || !is_positive(config.max_deceleration_mps2) ||
+    !is_positive(config.max_jerk_mps3)))
+  {
+    throw std::domain_error("TrajectorySmoother: the limits must be positive");
+  }
   float32_t s = 2 * config.standard_deviation * config.standard_deviation;
   float32_t sum = 0.0;
 
@@ -46,6 +80,10 @@ TrajectorySmoother::TrajectorySmoother(TrajectorySmootherConfig config)
 
 void TrajectorySmoother::Filter(Trajectory & trajectory)
 {
+  if (m_config.mode == SmoothingMode::JERK_LIMITED) {
+    limit_jerk(trajectory);
+    return;
+  }
   if (trajectory.points.size() > 2) {
     // zero out velocity at a few points at the end of trajectory so that the post filter velocity
     // gradually ramp down to zero. The last point would have already been zeroed by the
@@ -84,6 +122,91 @@ void TrajectorySmoother::Filter(Trajectory & trajectory)
   }
 }
 
+void TrajectorySmoother::limit_jerk(Trajectory & trajectory)
+{
+  auto & points = trajectory.points;
+  const std::size_t n = points.size();
+  if (n <= 2U) {
+    return;
+  }
+  const auto duration =
+    to_seconds(points.back().time_from_start) - to_seconds(points.front().time_from_start);
+  if (!(duration > 0.0)) {
+    return;
+  }
+  const auto dt = static_cast<float32_t>(duration / static_cast<float64_t>(n - 1U));
+  const float32_t max_acceleration = m_config.max_acceleration_mps2 * dt;
+  const float32_t max_deceleration = m_config.max_deceleration_mps2 * dt;
+
+  // A moving average over w points of velocities whose steps are within the acceleration limits
+  // has a jerk of at most (max_acceleration + max_deceleration) / (w * dt)
+  const auto min_width = std::ceil(
+    (m_config.max_acceleration_mps2 + m_config.max_deceleration_mps2) /
+    (m_config.max_jerk_mps3 * dt));
+  // Wider windows than the whole trajectory average everything to the same velocity
+  const auto half_width = std::min(
+    static_cast<std::size_t>(std::ceil(std::max(min_width - 1.0F, 0.0F) * 0.5F)), n);
+  const std::size_t width = (2U * half_width) + 1U;
+  const std::size_t pad = 2U * half_width;
+
+  // The highest velocities below the given ones that follow the acceleration limits, from a
+  // forward and a backward pass. They are padded with the values at either end.
+  m_padded_velocities.resize(n + (2U * pad));
+  auto velocity = [this, pad](const std::size_t i) -> float32_t & {
+      return m_padded_velocities[pad + i];
+    };
+  velocity(0U) = std::max(points[0U].longitudinal_velocity_mps, 0.0F);
+  for (std::size_t i = 1U; i < n; ++i) {
+    velocity(i) = std::min(
+      std::max(points[i].longitudinal_velocity_mps, 0.0F), velocity(i - 1U) + max_acceleration);
+  }
+  for (std::size_t i = n - 1U; i > 0U; --i) {
+    velocity(i - 1U) = std::min(velocity(i - 1U), velocity(i) + max_deceleration);
+  }
+  std::fill(m_padded_velocities.begin(), m_padded_velocities.begin() + pad, velocity(0U));
+  std::fill(m_padded_velocities.end() - pad, m_padded_velocities.end(), velocity(n - 1U));
+
+  // Moving minimum over w points. All the minima that the average of a point takes in contain
+  // that point, so the average doesn't exceed its velocity. Both keep the acceleration limits.
+  const std::size_t num_minima = n + pad;
+  m_minima.resize(num_minima);
+  m_window.resize(m_padded_velocities.size());
+  std::size_t front = 0U;
+  std::size_t back = 0U;
+  for (std::size_t k = 0U; k < m_padded_velocities.size(); ++k) {
+    while ((back > front) && (m_padded_velocities[m_window[back - 1U]] >= m_padded_velocities[k])) {
+      --back;
+    }
+    m_window[back] = k;
+    ++back;
+    if (k + 1U >= width) {
+      const std::size_t first = k + 1U - width;
+      if (m_window[front] < first) {
+        ++front;
+      }
+      m_minima[first] = m_padded_velocities[m_window[front]];
+    }
+  }
+
+  // Moving average over w minima
+  float64_t sum = 0.0;
+  for (std::size_t q = 0U; q + 1U < width; ++q) {
+    sum += static_cast<float64_t>(m_minima[q]);
+  }
+  for (std::size_t i = 0U; i < n; ++i) {
+    sum += static_cast<float64_t>(m_minima[i + width - 1U]);
+    if (i > 0U) {
+      points[i].longitudinal_velocity_mps =
+        std::max(static_cast<float32_t>(sum / static_cast<float64_t>(width)), 0.0F);
+    }
+    sum -= static_cast<float64_t>(m_minima[i]);
+  }
+  for (std::size_t i = 0U; i + 1U < n; ++i) {
+    points[i].acceleration_mps2 =
+      (points[i + 1U].longitudinal_velocity_mps - points[i].longitudinal_velocity_mps) / dt;
+  }
+}
+
 }  // namespace trajectory_smoother
 }  // namespace planning
 }  // namespace motion
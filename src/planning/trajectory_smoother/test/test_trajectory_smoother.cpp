@@ -232,3 +232,79 @@ TEST(trajectory_smoother, deceleration_halt) {
   // Constants based on Gaussian filter's performance
   assert_trajectory(trajectory, 4, 3);
 }
+
+/// \brief Configuration of the jerk limited mode
+TrajectorySmootherConfig jerk_limited_config(float max_acc, float max_dec, float max_jerk)
+{
+  TrajectorySmootherConfig config{5.0, 25};
+  config.mode = motion::planning::trajectory_smoother::SmoothingMode::JERK_LIMITED;
+  config.max_acceleration_mps2 = max_acc;
+  config.max_deceleration_mps2 = max_dec;
+  config.max_jerk_mps3 = max_jerk;
+  return config;
+}
+
+/// \brief Assert that the smoothed trajectory is nowhere faster than the original one
+void assert_below(const Trajectory & trajectory, const Trajectory & original)
+{
+  ASSERT_EQ(trajectory.points.size(), original.points.size());
+  for (std::size_t i = 0; i < trajectory.points.size(); ++i) {
+    EXPECT_LE(
+      trajectory.points[i].longitudinal_velocity_mps,
+      original.points[i].longitudinal_velocity_mps + 1e-4F);
+  }
+}
+
+// Constant speed of 10mps. Random noise added. Last velocity point at 0mps.
+TEST(trajectory_smoother, jerk_limited_constant_with_noise) {
+  const std::chrono::milliseconds dt(DT_MS);
+  auto trajectory = constant_velocity_trajectory(
+    0, 0, 1, 10,
+    std::chrono::duration_cast<std::chrono::nanoseconds>(dt));
+  trajectory.points.resize(100);
+  introduce_noise(&trajectory, 10);
+  // Start at the nominal speed, the first velocity is kept
+  trajectory.points.front().longitudinal_velocity_mps = 10.0F;
+  // Zero out last point
+  trajectory.points.back().longitudinal_velocity_mps = 0.0F;
+  const auto original = trajectory;
+
+  TrajectorySmoother smoother(jerk_limited_config(1.5F, 3.0F, 2.0F));
+  smoother.Filter(trajectory);
+
+  // Small margin for the rounding of the finite differences
+  assert_trajectory(trajectory, 3.0F * 1.01F, 2.0F * 1.01F);
+  assert_below(trajectory, original);
+  EXPECT_EQ(trajectory.points.back().longitudinal_velocity_mps, 0.0F);
+}
+
+// Constant speed of 10mps with a stop of 1s in the middle. Last velocity point at 0mps.
+TEST(trajectory_smoother, jerk_limited_intermediate_stop) {
+  const std::chrono::milliseconds dt(DT_MS);
+  auto trajectory = constant_velocity_trajectory(
+    0, 0, 1, 10,
+    std::chrono::duration_cast<std::chrono::nanoseconds>(dt));
+  trajectory.points.resize(100);
+  for (std::size_t i = 40; i < 50; ++i) {
+    trajectory.points[i].longitudinal_velocity_mps = 0.0F;
+  }
+  trajectory.points.back().longitudinal_velocity_mps = 0.0F;
+  const auto original = trajectory;
+
+  TrajectorySmoother smoother(jerk_limited_config(1.0F, 4.0F, 4.0F));
+  smoother.Filter(trajectory);
+
+  assert_trajectory(trajectory, 4.0F * 1.01F, 4.0F * 1.01F);
+  assert_below(trajectory, original);
+  for (const auto & point : trajectory.points) {
+    EXPECT_GE(point.longitudinal_velocity_mps, 0.0F);
+  }
+  // The velocity before the stop is not affected
+  EXPECT_FLOAT_EQ(trajectory.points[3].longitudinal_velocity_mps, 10.0F);
+}
+
+TEST(trajectory_smoother, jerk_limited_bad_limits) {
+  EXPECT_THROW(TrajectorySmoother(jerk_limited_config(0.0F, 1.0F, 1.0F)), std::domain_error);
+  EXPECT_THROW(TrajectorySmoother(jerk_limited_config(1.0F, -1.0F, 1.0F)), std::domain_error);
+  EXPECT_THROW(TrajectorySmoother(jerk_limited_config(1.0F, 1.0F, NAN)), std::domain_error);
+}
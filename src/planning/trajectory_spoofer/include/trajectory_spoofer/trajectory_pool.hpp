@@ -0,0 +1,89 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \copyright Copyright 2021 The Autoware Foundation
+/// \file
+/// \brief This file defines the TrajectoryPool class.
+
+#ifndef TRAJECTORY_SPOOFER__TRAJECTORY_POOL_HPP_
+#define TRAJECTORY_SPOOFER__TRAJECTORY_POOL_HPP_
+
+#include <trajectory_spoofer/visibility_control.hpp>
+
+#include <autoware_auto_msgs/msg/trajectory.hpp>
+#include <builtin_interfaces/msg/time.hpp>
+#include <common/types.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace autoware
+{
+namespace trajectory_spoofer
+{
+using Trajectory = autoware_auto_msgs::msg::Trajectory;
+using TimeMsg = builtin_interfaces::msg::Time;
+
+using autoware::common::types::float32_t;
+
+/// \brief Configuration of a TrajectoryPool
+struct TRAJECTORY_SPOOFER_PUBLIC TrajectoryPoolConfig
+{
+  /// Number of precomputed trajectories
+  std::size_t pool_size{16U};
+  /// Maximum lateral offset of the last point of a trajectory, the offset grows linearly from 0
+  /// at the first point
+  float32_t lateral_perturbation_m{0.1F};
+  /// Maximum offset of the speed of all points of a trajectory
+  float32_t speed_perturbation_mps{0.5F};
+  /// Seed of the perturbations, so that a load test can be repeated
+  uint32_t seed{0U};
+};
+
+/// \class TrajectoryPool
+/// \brief Precomputed, slightly perturbed copies of a trajectory that are handed out in turn, so
+///        that trajectories can be published at high rates without building or allocating them
+class TRAJECTORY_SPOOFER_PUBLIC TrajectoryPool
+{
+public:
+  /// \brief Constructor, computes all trajectories of the pool
+  /// \param[in] base The trajectory that is perturbed, the first trajectory of the pool is the
+  ///            unperturbed one
+  /// \param[in] config Size of the pool and the perturbations
+  /// \throw std::domain_error If the base trajectory is empty, the pool size is 0 or a
+  ///        perturbation is negative or not finite
+  TrajectoryPool(const Trajectory & base, const TrajectoryPoolConfig & config);
+
+  /// \brief Stamp the next trajectory of the pool and return it. Doesn't allocate.
+  /// \param[in] stamp The stamp of the trajectory, which identifies it, e.g. in latency traces
+  /// \return The trajectory, valid until the pool wraps around to it again
+  const Trajectory & next(const TimeMsg & stamp) noexcept;
+
+  /// \brief Number of trajectories in the pool
+  std::size_t size() const noexcept;
+
+  /// \brief Get a trajectory of the pool
+  /// \param[in] index The index of the trajectory, less than size()
+  /// \return The trajectory
+  const Trajectory & at(std::size_t index) const;
+
+private:
+  std::vector<Trajectory> trajectories_;
+  std::size_t next_index_{0U};
+};
+}  // namespace trajectory_spoofer
+}  // namespace autoware
+
+#endif  // TRAJECTORY_SPOOFER__TRAJECTORY_POOL_HPP_
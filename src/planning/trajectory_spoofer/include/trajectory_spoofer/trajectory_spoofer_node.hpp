@@ -19,11 +19,13 @@
 #ifndef TRAJECTORY_SPOOFER__TRAJECTORY_SPOOFER_NODE_HPP_
 #define TRAJECTORY_SPOOFER__TRAJECTORY_SPOOFER_NODE_HPP_
 
+#include <trajectory_spoofer/trajectory_pool.hpp>
 #include <trajectory_spoofer/trajectory_spoofer.hpp>
 
 #include <autoware_auto_msgs/msg/vehicle_kinematic_state.hpp>
 #include <autoware_auto_msgs/msg/trajectory.hpp>
 #include <common/types.hpp>
+#include <latency_tracing/tracer.hpp>
 #include <rclcpp/rclcpp.hpp>
 
 #include <memory>
@@ -58,10 +60,21 @@ private:
 
   Trajectory trajectory_;
 
+  // Load test: the pooled trajectories are published from a timer instead of once per state
+  bool8_t load_test_enabled_;
+  float64_t load_test_rate_hz_;
+  TrajectoryPoolConfig load_test_pool_config_;
+  std::unique_ptr<TrajectoryPool> load_test_pool_;
+  rclcpp::TimerBase::SharedPtr load_test_timer_;
+  autoware::common::latency_tracing::StageId trace_stage_{0U};
+
   std::shared_ptr<TrajectorySpoofer> spoofer_;
   std::shared_ptr<rclcpp::Publisher<Trajectory>> trajectory_pub_;
   std::shared_ptr<rclcpp::Subscription<VehicleKinematicState>> state_sub_;
 
+  void start_load_test();
+  void on_load_test_timer();
+
   TrajectoryType get_trajectory_type_from_string(const std::string & trajectory_type_string)
   {
     if (trajectory_type_string == "straight") {
@@ -77,6 +90,8 @@ public:
   /// \brief default constructor, starts node
   /// \param[in] node_options an rclcpp::NodeOptions object to configure the node
   /// \throw runtime error if failed to start threads or configure node
+  /// \throw std::domain_error if the load test is enabled with a rate that isn't positive, or a
+  ///        number of points that a trajectory can't hold
   explicit TrajectorySpooferNode(const rclcpp::NodeOptions & node_options);
 
   void on_recv_state(VehicleKinematicState::SharedPtr msg);
@@ -0,0 +1,96 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "trajectory_spoofer/trajectory_pool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+namespace autoware
+{
+namespace trajectory_spoofer
+{
+namespace
+{
+bool valid_perturbation(const float32_t perturbation)
+{
+  return std::isfinite(perturbation) && (perturbation >= 0.0F);
+}
+}  // namespace
+
+TrajectoryPool::TrajectoryPool(const Trajectory & base, const TrajectoryPoolConfig & config)
+{
+  if (base.points.empty()) {
+    throw std::domain_error{"TrajectoryPool: the base trajectory is empty"};
+  }
+  if (config.pool_size == 0U) {
+    throw std::domain_error{"TrajectoryPool: the pool size must be positive"};
+  }
+  if (!valid_perturbation(config.lateral_perturbation_m) ||
+    !valid_perturbation(config.speed_perturbation_mps))
+  {
+    throw std::domain_error{"TrajectoryPool: perturbations must be finite and non-negative"};
+  }
+
+  std::mt19937 generator{config.seed};
+  std::uniform_real_distribution<float32_t> lateral{
+    -config.lateral_perturbation_m, config.lateral_perturbation_m};
+  std::uniform_real_distribution<float32_t> speed{
+    -config.speed_perturbation_mps, config.speed_perturbation_mps};
+
+  const auto num_points = base.points.size();
+  trajectories_.reserve(config.pool_size);
+  trajectories_.push_back(base);
+  while (trajectories_.size() < config.pool_size) {
+    trajectories_.push_back(base);
+    const auto lateral_offset = lateral(generator);
+    const auto speed_offset = speed(generator);
+    auto & trajectory = trajectories_.back();
+    for (std::size_t i = 0U; i < num_points; ++i) {
+      auto & point = trajectory.points[i];
+      // The first point stays at the vehicle, the offset grows along the trajectory
+      const auto fraction = (num_points > 1U) ?
+        (static_cast<float32_t>(i) / static_cast<float32_t>(num_points - 1U)) : 0.0F;
+      // Left of the heading, which is a 2d quaternion
+      const auto cos_yaw = 1.0F - 2.0F * point.heading.imag * point.heading.imag;
+      const auto sin_yaw = 2.0F * point.heading.real * point.heading.imag;
+      point.x -= sin_yaw * fraction * lateral_offset;
+      point.y += cos_yaw * fraction * lateral_offset;
+      point.longitudinal_velocity_mps =
+        std::max(point.longitudinal_velocity_mps + speed_offset, 0.0F);
+    }
+  }
+}
+
+const Trajectory & TrajectoryPool::next(const TimeMsg & stamp) noexcept
+{
+  auto & trajectory = trajectories_[next_index_];
+  next_index_ = (next_index_ + 1U) % trajectories_.size();
+  trajectory.header.stamp = stamp;
+  return trajectory;
+}
+
+std::size_t TrajectoryPool::size() const noexcept
+{
+  return trajectories_.size();
+}
+
+const Trajectory & TrajectoryPool::at(const std::size_t index) const
+{
+  return trajectories_.at(index);
+}
+}  // namespace trajectory_spoofer
+}  // namespace autoware
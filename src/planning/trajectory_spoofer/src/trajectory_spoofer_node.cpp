@@ -17,7 +17,9 @@
 
 #include <rclcpp_components/register_node_macro.hpp>
 
+#include <chrono>
 #include <memory>
+#include <stdexcept>
 #include <string>
 
 //lint -e537 NOLINT  // cpplint vs pclint
@@ -35,13 +37,36 @@ TrajectorySpooferNode::TrajectorySpooferNode(const rclcpp::NodeOptions & node_op
     get_trajectory_type_from_string(declare_parameter("trajectory_type", "straight"))},
   length_{static_cast<float32_t>(declare_parameter("length", 10.0))},
   radius_{static_cast<float32_t>(declare_parameter("radius", 12.0))},
+  load_test_enabled_{declare_parameter("load_test.enabled", false)},
+  load_test_rate_hz_{declare_parameter("load_test.rate_hz", 1000.0)},
   spoofer_{std::make_shared<TrajectorySpoofer>(target_speed_)},
   trajectory_pub_{create_publisher<Trajectory>("trajectory", 10)},
   state_sub_{create_subscription<VehicleKinematicState>(
       "vehicle_kinematic_state", rclcpp::QoS{10},
       std::bind(
         &TrajectorySpooferNode::on_recv_state, this, _1))}
-{}
+{
+  load_test_pool_config_.pool_size =
+    static_cast<std::size_t>(declare_parameter("load_test.pool_size", 16));
+  load_test_pool_config_.lateral_perturbation_m =
+    static_cast<float32_t>(declare_parameter("load_test.lateral_perturbation_m", 0.1));
+  load_test_pool_config_.speed_perturbation_mps =
+    static_cast<float32_t>(declare_parameter("load_test.speed_perturbation_mps", 0.5));
+  load_test_pool_config_.seed =
+    static_cast<uint32_t>(declare_parameter("load_test.seed", 0));
+  if (load_test_enabled_) {
+    if (!(load_test_rate_hz_ > 0.0)) {
+      throw std::domain_error{"load_test.rate_hz must be positive"};
+    }
+    if ((num_of_points_ < 2) ||
+      (static_cast<std::size_t>(num_of_points_) > Trajectory::CAPACITY))
+    {
+      throw std::domain_error{"num_of_points must be 2 to Trajectory::CAPACITY in a load test"};
+    }
+    trace_stage_ = autoware::common::latency_tracing::Tracer::instance().register_stage(
+      get_fully_qualified_name());
+  }
+}
 
 void TrajectorySpooferNode::on_recv_state(VehicleKinematicState::SharedPtr msg)
 {
@@ -61,10 +86,39 @@ void TrajectorySpooferNode::on_recv_state(VehicleKinematicState::SharedPtr msg)
     }
   }
 
+  if (load_test_enabled_) {
+    if ((!load_test_timer_) && (trajectory_.points.size() > 0)) {
+      start_load_test();
+    }
+    return;
+  }
+
   if (trajectory_.points.size() > 0) {
     trajectory_pub_->publish(trajectory_);
   }
 }
+
+void TrajectorySpooferNode::start_load_test()
+{
+  load_test_pool_ = std::make_unique<TrajectoryPool>(trajectory_, load_test_pool_config_);
+  const auto period = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::duration<float64_t>(1.0 / load_test_rate_hz_));
+  load_test_timer_ = create_wall_timer(period, [this]() {on_load_test_timer();});
+  RCLCPP_INFO(
+    get_logger(), "Load test: publishing %zu trajectories of %d points at %.1f Hz",
+    load_test_pool_->size(), num_of_points_, load_test_rate_hz_);
+}
+
+void TrajectorySpooferNode::on_load_test_timer()
+{
+  // The trajectory starts a trace, the first command of a controller with it ends it, see
+  // ControllerBaseNode
+  autoware::common::latency_tracing::TraceScope trace{
+    autoware::common::latency_tracing::Tracer::instance(), trace_stage_};
+  const auto & trajectory = load_test_pool_->next(now());
+  trace.set_trace_id(autoware::common::latency_tracing::to_trace_id(trajectory.header.stamp));
+  trajectory_pub_->publish(trajectory);
+}
 }  // namespace trajectory_spoofer
 }  // namespace autoware
 
@@ -0,0 +1,125 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <trajectory_spoofer/trajectory_pool.hpp>
+#include <trajectory_spoofer/trajectory_spoofer.hpp>
+
+#include <autoware_auto_msgs/msg/trajectory.hpp>
+#include <autoware_auto_msgs/msg/vehicle_kinematic_state.hpp>
+#include <common/types.hpp>
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+using autoware_auto_msgs::msg::Trajectory;
+using autoware_auto_msgs::msg::VehicleKinematicState;
+using autoware::trajectory_spoofer::TimeMsg;
+using autoware::trajectory_spoofer::TrajectoryPool;
+using autoware::trajectory_spoofer::TrajectoryPoolConfig;
+using autoware::trajectory_spoofer::TrajectorySpoofer;
+
+using autoware::common::types::float32_t;
+
+namespace
+{
+Trajectory make_base_trajectory()
+{
+  VehicleKinematicState starting_point;
+  starting_point.header.frame_id = "map";
+  starting_point.state.heading = TrajectorySpoofer::to_2d_quaternion(0.5);
+  TrajectorySpoofer spoofer{8.0F};
+  return spoofer.spoof_straight_trajectory(
+    starting_point, static_cast<int32_t>(Trajectory::CAPACITY), 50.0F);
+}
+}  // namespace
+
+TEST(test_trajectory_pool, perturbations)
+{
+  const auto base = make_base_trajectory();
+  TrajectoryPoolConfig config;
+  config.pool_size = 8U;
+  config.lateral_perturbation_m = 0.2F;
+  config.speed_perturbation_mps = 1.0F;
+  const TrajectoryPool pool{base, config};
+  ASSERT_EQ(pool.size(), 8U);
+
+  // The first trajectory is the base one
+  for (std::size_t i = 0U; i < base.points.size(); ++i) {
+    EXPECT_FLOAT_EQ(pool.at(0U).points[i].x, base.points[i].x);
+    EXPECT_FLOAT_EQ(pool.at(0U).points[i].y, base.points[i].y);
+  }
+
+  const auto yaw = TrajectorySpoofer::to_yaw_angle(base.points[0U].heading);
+  for (std::size_t index = 1U; index < pool.size(); ++index) {
+    const auto & trajectory = pool.at(index);
+    ASSERT_EQ(trajectory.points.size(), base.points.size());
+    EXPECT_EQ(trajectory.header.frame_id, base.header.frame_id);
+    // The first point stays at the vehicle
+    EXPECT_FLOAT_EQ(trajectory.points[0U].x, base.points[0U].x);
+    EXPECT_FLOAT_EQ(trajectory.points[0U].y, base.points[0U].y);
+    for (std::size_t i = 0U; i < base.points.size(); ++i) {
+      const auto & point = trajectory.points[i];
+      const auto & base_point = base.points[i];
+      const auto dx = static_cast<float32_t>(point.x - base_point.x);
+      const auto dy = static_cast<float32_t>(point.y - base_point.y);
+      // Only lateral offsets, within the bounds
+      const auto longitudinal = dx * std::cos(yaw) + dy * std::sin(yaw);
+      EXPECT_NEAR(longitudinal, 0.0, 1.0e-4);
+      EXPECT_LE(std::hypot(dx, dy), config.lateral_perturbation_m + 1.0e-4F);
+      EXPECT_LE(
+        std::fabs(point.longitudinal_velocity_mps - base_point.longitudinal_velocity_mps),
+        config.speed_perturbation_mps);
+      // The timing isn't changed
+      EXPECT_EQ(point.time_from_start, base_point.time_from_start);
+    }
+  }
+
+  // The pool is reproducible
+  const TrajectoryPool same_pool{base, config};
+  for (std::size_t index = 0U; index < pool.size(); ++index) {
+    EXPECT_EQ(pool.at(index), same_pool.at(index));
+  }
+}
+
+TEST(test_trajectory_pool, next)
+{
+  TrajectoryPoolConfig config;
+  config.pool_size = 3U;
+  TrajectoryPool pool{make_base_trajectory(), config};
+
+  TimeMsg stamp;
+  for (int32_t i = 0; i < 7; ++i) {
+    stamp.sec = i;
+    const auto & trajectory = pool.next(stamp);
+    EXPECT_EQ(&trajectory, &pool.at(static_cast<std::size_t>(i) % 3U));
+    EXPECT_EQ(trajectory.header.stamp.sec, i);
+  }
+}
+
+TEST(test_trajectory_pool, bad_config)
+{
+  const auto base = make_base_trajectory();
+  TrajectoryPoolConfig config;
+  EXPECT_THROW(TrajectoryPool(Trajectory{}, config), std::domain_error);
+  config.pool_size = 0U;
+  EXPECT_THROW(TrajectoryPool(base, config), std::domain_error);
+  config = TrajectoryPoolConfig{};
+  config.lateral_perturbation_m = -1.0F;
+  EXPECT_THROW(TrajectoryPool(base, config), std::domain_error);
+  config = TrajectoryPoolConfig{};
+  config.speed_perturbation_mps = std::numeric_limits<float32_t>::quiet_NaN();
+  EXPECT_THROW(TrajectoryPool(base, config), std::domain_error);
+}
@@ -12,6 +12,8 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+find_package(ament_cmake_test REQUIRED)
 find_package(ros_testing REQUIRED)
 
+include("${autoware_testing_DIR}/add_performance_test.cmake")
 include("${autoware_testing_DIR}/add_smoke_test.cmake")
@@ -0,0 +1,275 @@
+#! /usr/bin/env python3
+
+# Copyright 2021 the Autoware Foundation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Run a benchmark and compare its results against a stored baseline.
+
+The benchmark is either a Google Benchmark executable, whose repetitions are the samples, or any
+command that writes a CSV file with a latency_ms column, e.g. the timing file of the replay
+player, whose rows are the samples. The median and the 99th percentile of the samples of each
+benchmark are compared against the baseline. The noise of both statistics is estimated by
+bootstrapping the samples, so that a regression is only reported when it exceeds the tolerance
+by more than the noise of the baseline and of the current run.
+"""
+
+import argparse
+import csv
+import json
+import math
+import os
+import random
+import subprocess
+import sys
+import tempfile
+
+# The environment variable that has the test write the current results to the baseline file
+UPDATE_BASELINE_ENV = 'AUTOWARE_UPDATE_PERFORMANCE_BASELINE'
+
+# Conversion of the Google Benchmark time units to nanoseconds
+TIME_UNITS_NS = {'ns': 1.0, 'us': 1.0e3, 'ms': 1.0e6, 's': 1.0e9}
+
+BOOTSTRAP_RESAMPLES = 200
+
+
+def percentile(samples, fraction):
+    """
+    Get a nearest rank percentile, as in latency_tracing.
+
+    @param samples: The samples, sorted
+    @type  samples: list
+    @param fraction: The fraction of the samples at or below the percentile
+    @type  fraction: float
+    @return: The percentile
+    """
+    rank = int(math.ceil(fraction * len(samples)))
+    return samples[max(rank, 1) - 1]
+
+
+def bootstrap_noise(samples, fraction, rng):
+    """
+    Estimate the standard error of a percentile by resampling the samples with replacement.
+
+    @param samples: The samples
+    @type  samples: list
+    @param fraction: The fraction of the percentile
+    @type  fraction: float
+    @param rng: The random generator, seeded so that the estimate is reproducible
+    @type  rng: random.Random
+    @return: The standard deviation of the percentile over the resamples
+    """
+    if len(samples) < 2:
+        return 0.0
+    estimates = []
+    for _ in range(BOOTSTRAP_RESAMPLES):
+        resample = sorted(rng.choice(samples) for _ in samples)
+        estimates.append(percentile(resample, fraction))
+    mean = sum(estimates) / len(estimates)
+    return math.sqrt(sum((e - mean) ** 2 for e in estimates) / (len(estimates) - 1))
+
+
+def summarize(samples_by_name, unit):
+    """
+    Compute the statistics of each benchmark.
+
+    @param samples_by_name: The samples of each benchmark
+    @type  samples_by_name: dict
+    @param unit: The unit of the samples
+    @type  unit: str
+    @return: The statistics of each benchmark, in the format of the baseline file
+    """
+    rng = random.Random(0)
+    ret = {}
+    for name, samples in samples_by_name.items():
+        ordered = sorted(samples)
+        ret[name] = {
+            'unit': unit,
+            'samples': len(ordered),
+            'median': percentile(ordered, 0.5),
+            'median_noise': bootstrap_noise(ordered, 0.5, rng),
+            'p99': percentile(ordered, 0.99),
+            'p99_noise': bootstrap_noise(ordered, 0.99, rng),
+        }
+    return ret
+
+
+def read_google_benchmark(filename):
+    """
+    Read the real time of each repetition from the json output of Google Benchmark.
+
+    The aggregates, e.g. mean and stddev, are skipped, the statistics are computed from the
+    repetitions.
+
+    @param filename: The json file
+    @type  filename: str
+    @return: The samples in nanoseconds by benchmark name
+    """
+    with open(filename, 'r') as file:
+        results = json.load(file)
+    ret = {}
+    for benchmark in results.get('benchmarks', []):
+        if benchmark.get('run_type', 'iteration') != 'iteration' or 'error_occurred' in benchmark:
+            continue
+        name = benchmark.get('run_name', benchmark['name'])
+        scale = TIME_UNITS_NS[benchmark.get('time_unit', 'ns')]
+        ret.setdefault(name, []).append(float(benchmark['real_time']) * scale)
+    return ret
+
+
+def read_timing_csv(filename, name):
+    """
+    Read the latencies of the completed frames from a timing file.
+
+    @param filename: The CSV file, with a latency_ms column that is empty for lost frames
+    @type  filename: str
+    @param name: The name of the benchmark
+    @type  name: str
+    @return: The samples in milliseconds by benchmark name
+    """
+    samples = []
+    with open(filename, 'r') as file:
+        for row in csv.DictReader(file):
+            if row.get('latency_ms', ''):
+                samples.append(float(row['latency_ms']))
+    return {name: samples} if samples else {}
+
+
+def compare(baseline, current, tolerance, p99_tolerance, sigmas):
+    """
+    Compare the current statistics against the baseline.
+
+    A statistic regressed when it grew by more than the tolerance plus the given number of
+    standard errors of the difference.
+
+    @param baseline: The statistics of the baseline
+    @type  baseline: dict
+    @param current: The current statistics
+    @type  current: dict
+    @param tolerance: The accepted relative growth of the median
+    @type  tolerance: float
+    @param p99_tolerance: The accepted relative growth of the 99th percentile
+    @type  p99_tolerance: float
+    @param sigmas: The number of standard errors of noise to accept on top of the tolerance
+    @type  sigmas: float
+    @return: The report lines and whether there was a regression
+    """
+    lines = []
+    regressed = False
+    for name in sorted(set(baseline) | set(current)):
+        if name not in current:
+            lines.append('%s: missing from the current results' % name)
+            regressed = True
+            continue
+        if name not in baseline:
+            lines.append('%s: not in the baseline, median %.4g %s' %
+                         (name, current[name]['median'], current[name]['unit']))
+            continue
+        base = baseline[name]
+        cur = current[name]
+        if base['unit'] != cur['unit']:
+            lines.append('%s: unit %s differs from the baseline unit %s' %
+                         (name, cur['unit'], base['unit']))
+            regressed = True
+            continue
+        for statistic, relative in (('median', tolerance), ('p99', p99_tolerance)):
+            noise = math.hypot(base[statistic + '_noise'], cur[statistic + '_noise'])
+            threshold = relative * base[statistic] + sigmas * noise
+            change = cur[statistic] - base[statistic]
+            if change > threshold:
+                verdict = 'REGRESSION'
+                regressed = True
+            elif -change > threshold:
+                verdict = 'improvement, consider updating the baseline'
+            else:
+                verdict = 'ok'
+            lines.append('%s %s: %.4g -> %.4g %s (%+.1f%%, threshold %.4g): %s' % (
+                name, statistic, base[statistic], cur[statistic], cur['unit'],
+                100.0 * change / base[statistic] if base[statistic] > 0.0 else 0.0,
+                threshold, verdict))
+    return lines, regressed
+
+
+def run_benchmark(args, results_file):
+    """
+    Run the benchmark command and read its samples.
+
+    @param args: The parsed command line arguments
+    @type  args: argparse.Namespace
+    @param results_file: Where the benchmark writes its results
+    @type  results_file: str
+    @return: The samples by benchmark name and their unit
+    """
+    command = [arg.replace('{results}', results_file) for arg in args.command]
+    if args.format == 'google_benchmark':
+        command += ['--benchmark_out=' + results_file,
+                    '--benchmark_out_format=json',
+                    '--benchmark_repetitions=%d' % args.repetitions]
+    print('Running ' + ' '.join(command), flush=True)
+    subprocess.run(command, check=True)
+    if args.format == 'google_benchmark':
+        return read_google_benchmark(results_file), 'ns'
+    return read_timing_csv(results_file, args.name), 'ms'
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument('--name', required=True, help='The name of the test')
+    parser.add_argument('--baseline', required=True, help='The stored baseline json file')
+    parser.add_argument('--output', help='Where to write the current results as json')
+    parser.add_argument('--format', choices=['google_benchmark', 'timing_csv'],
+                        default='google_benchmark')
+    parser.add_argument('--tolerance', type=float, default=0.1)
+    parser.add_argument('--p99-tolerance', type=float, default=0.25)
+    parser.add_argument('--sigmas', type=float, default=3.0)
+    parser.add_argument('--repetitions', type=int, default=10)
+    parser.add_argument('command', nargs=argparse.REMAINDER,
+                        help='The benchmark command, {results} is replaced by the results file')
+    args = parser.parse_args(argv)
+    if args.command and args.command[0] == '--':
+        args.command = args.command[1:]
+    if not args.command:
+        parser.error('no benchmark command given')
+
+    with tempfile.TemporaryDirectory() as folder:
+        samples, unit = run_benchmark(args, os.path.join(folder, 'results'))
+    if not samples:
+        print('The benchmark produced no samples', file=sys.stderr)
+        return 1
+    current = summarize(samples, unit)
+
+    results = json.dumps({'benchmarks': current}, indent=2, sort_keys=True) + '\n'
+    if args.output:
+        os.makedirs(os.path.dirname(os.path.abspath(args.output)), exist_ok=True)
+        with open(args.output, 'w') as file:
+            file.write(results)
+    if os.environ.get(UPDATE_BASELINE_ENV, '') not in ('', '0'):
+        with open(args.baseline, 'w') as file:
+            file.write(results)
+        print('Updated the baseline ' + args.baseline)
+        return 0
+    if not os.path.isfile(args.baseline):
+        print('There is no baseline %s, set %s=1 to create it' %
+              (args.baseline, UPDATE_BASELINE_ENV))
+        return 0
+
+    with open(args.baseline, 'r') as file:
+        baseline = json.load(file)['benchmarks']
+    lines, regressed = compare(baseline, current, args.tolerance, args.p99_tolerance, args.sigmas)
+    print('\n'.join(lines))
+    return 1 if regressed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
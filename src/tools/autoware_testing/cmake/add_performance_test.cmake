@@ -0,0 +1,99 @@
+# Copyright 2021 The Autoware Foundation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Add a performance test, which runs a benchmark and fails when it got
+# slower than a baseline
+# :param name: name of the test
+# :type name: string
+# :param BASELINE: the baseline json file, relative to the current source
+#   directory
+# :type BASELINE: string
+# :param TARGET: the Google Benchmark executable target to run, defaults to
+#   the name of the test
+# :type TARGET: string
+# :param COMMAND: a command that writes a CSV file with a latency_ms column
+#   to {results}, e.g. a replay benchmark, instead of the TARGET
+# :type COMMAND: list of strings
+# :param TOLERANCE: the accepted relative growth of the median, defaults
+#   to 0.1
+# :type TOLERANCE: string
+# :param P99_TOLERANCE: the accepted relative growth of the 99th
+#   percentile, defaults to 0.25
+# :type P99_TOLERANCE: string
+# :param SIGMAS: the standard errors of noise accepted on top of the
+#   tolerance, defaults to 3
+# :type SIGMAS: string
+# :param REPETITIONS: the repetitions of a Google Benchmark executable,
+#   defaults to 10
+# :type REPETITIONS: string
+# :param TIMEOUT: the test timeout in seconds, defaults to 300
+# :type TIMEOUT: string
+
+function(add_performance_test name)
+  cmake_parse_arguments(ARG ""
+    "BASELINE;TARGET;TOLERANCE;P99_TOLERANCE;SIGMAS;REPETITIONS;TIMEOUT"
+    "COMMAND" ${ARGN})
+  if(ARG_UNPARSED_ARGUMENTS)
+    message(FATAL_ERROR "add_performance_test() called with unused "
+      "arguments: ${ARG_UNPARSED_ARGUMENTS}")
+  endif()
+  if(NOT ARG_BASELINE)
+    message(FATAL_ERROR "add_performance_test() requires a BASELINE")
+  endif()
+  if(NOT IS_ABSOLUTE "${ARG_BASELINE}")
+    set(ARG_BASELINE "${CMAKE_CURRENT_SOURCE_DIR}/${ARG_BASELINE}")
+  endif()
+  foreach(option_default "TOLERANCE;0.1" "P99_TOLERANCE;0.25" "SIGMAS;3"
+      "REPETITIONS;10" "TIMEOUT;300")
+    list(GET option_default 0 option)
+    list(GET option_default 1 default)
+    if(NOT ARG_${option})
+      set(ARG_${option} "${default}")
+    endif()
+  endforeach()
+
+  if(ARG_COMMAND)
+    set(format "timing_csv")
+    set(command ${ARG_COMMAND})
+  else()
+    set(format "google_benchmark")
+    if(NOT ARG_TARGET)
+      set(ARG_TARGET "${name}")
+    endif()
+    set(command "$<TARGET_FILE:${ARG_TARGET}>")
+  endif()
+
+  set(script "${autoware_testing_DIR}/../autoware_testing/performance_test.py")
+  set(results "${AMENT_TEST_RESULTS_DIR}/${PROJECT_NAME}")
+  ament_add_test(
+    "${name}"
+    COMMAND
+      "${PYTHON_EXECUTABLE}" "${script}"
+      "--name" "${name}"
+      "--baseline" "${ARG_BASELINE}"
+      "--output" "${results}/${name}.performance.json"
+      "--format" "${format}"
+      "--tolerance" "${ARG_TOLERANCE}"
+      "--p99-tolerance" "${ARG_P99_TOLERANCE}"
+      "--sigmas" "${ARG_SIGMAS}"
+      "--repetitions" "${ARG_REPETITIONS}"
+      "--" ${command}
+    OUTPUT_FILE "${CMAKE_BINARY_DIR}/ament_cmake_performance_test/${name}.txt"
+    GENERATE_RESULT_FOR_RETURN_CODE_ZERO
+    TIMEOUT "${ARG_TIMEOUT}"
+  )
+  # Benchmarks that run concurrently disturb each other
+  set_tests_properties("${name}"
+    PROPERTIES RUN_SERIAL TRUE LABELS "performance")
+endfunction()
@@ -0,0 +1,90 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \copyright Copyright 2021 The Autoware Foundation
+/// \file
+/// \brief This file defines the functions that reduce the data streamed to the web interface.
+
+#ifndef AVP_WEB_INTERFACE__STREAM_DECIMATION_HPP_
+#define AVP_WEB_INTERFACE__STREAM_DECIMATION_HPP_
+
+#include <autoware_auto_msgs/msg/trajectory.hpp>
+#include <common/types.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
+#include <chrono>
+#include <cstddef>
+#include "avp_web_interface/visibility_control.hpp"
+
+namespace autoware
+{
+namespace tools
+{
+namespace avp_web_interface
+{
+using common::types::bool8_t;
+using common::types::float32_t;
+using common::types::float64_t;
+
+/// \class RateLimiter
+/// \brief Decides which messages of a stream to forward so that at most a given rate is
+/// forwarded. Faster streams are thinned out evenly, e.g. every second message of a 10 Hz stream
+/// is forwarded for a 5 Hz limit, also when the messages arrive with some jitter.
+class AVP_WEB_INTERFACE_PUBLIC RateLimiter
+{
+public:
+  /// \brief Constructor
+  /// \param[in] max_rate_hz The maximum rate of forwarded messages
+  /// \throws std::domain_error if max_rate_hz is not positive
+  explicit RateLimiter(const float64_t max_rate_hz);
+
+  /// \brief Check whether to forward a message, the message then counts towards the rate
+  /// \param[in] now The arrival time of the message. A jump of the time, e.g. when a bag is
+  ///            replayed again, restarts the limiter.
+  /// \return True if the message shall be forwarded
+  bool8_t allow(const std::chrono::nanoseconds now);
+
+private:
+  std::chrono::nanoseconds m_min_period;
+  std::chrono::nanoseconds m_next{};
+  bool8_t m_started{false};
+};
+
+/// \brief Thin out the points of a trajectory so that consecutive points are at least a given
+/// distance apart, to be drawn as a line
+/// \param[in] trajectory The trajectory to decimate
+/// \param[in] min_point_distance The minimum distance of consecutive points in meters, not
+///            positive to keep all points
+/// \return The trajectory with the first point, the points that are at least min_point_distance
+///         apart and the last point
+AVP_WEB_INTERFACE_PUBLIC autoware_auto_msgs::msg::Trajectory decimate_trajectory(
+  const autoware_auto_msgs::msg::Trajectory & trajectory, const float32_t min_point_distance);
+
+/// \brief Thin out a point cloud to one point per voxel and only its x, y and z fields
+/// \param[in] cloud_in The cloud to decimate, with FLOAT32 x, y and z fields
+/// \param[in] voxel_size The edge length of the voxels in meters, not positive to keep all points
+/// \param[in] max_points The maximum number of points, the points left after the voxel filter
+///            are sampled evenly down to it. 0 for no limit.
+/// \param[out] cloud_out The unorganized x, y, z cloud with the first point of each voxel. Its
+///             memory is reused.
+/// \throws std::runtime_error if cloud_in lacks a FLOAT32 x, y or z field, or if its data is
+///         smaller than its dimensions
+AVP_WEB_INTERFACE_PUBLIC void decimate_point_cloud(
+  const sensor_msgs::msg::PointCloud2 & cloud_in, const float32_t voxel_size,
+  const std::size_t max_points, sensor_msgs::msg::PointCloud2 & cloud_out);
+
+}  // namespace avp_web_interface
+}  // namespace tools
+}  // namespace autoware
+
+#endif  // AVP_WEB_INTERFACE__STREAM_DECIMATION_HPP_
@@ -0,0 +1,88 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \copyright Copyright 2021 The Autoware Foundation
+/// \file
+/// \brief This file defines the WebRelayNode class.
+
+#ifndef AVP_WEB_INTERFACE__WEB_RELAY_NODE_HPP_
+#define AVP_WEB_INTERFACE__WEB_RELAY_NODE_HPP_
+
+#include <autoware_auto_msgs/msg/bounding_box_array.hpp>
+#include <autoware_auto_msgs/msg/trajectory.hpp>
+#include <autoware_auto_msgs/msg/vehicle_kinematic_state.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
+#include <cstddef>
+#include "avp_web_interface/stream_decimation.hpp"
+#include "avp_web_interface/visibility_control.hpp"
+
+namespace autoware
+{
+namespace tools
+{
+namespace avp_web_interface
+{
+
+/// \class WebRelayNode
+/// \brief ROS 2 Node that republishes the topics shown by the web interface at capped rates, with
+/// decimated trajectories and point clouds, on `web/<topic>`. The browser subscribes to these
+/// through rosbridge instead of the full rate topics, so that a remote monitor over a slow link
+/// and the bridge itself don't get overloaded.
+class AVP_WEB_INTERFACE_PUBLIC WebRelayNode : public rclcpp::Node
+{
+public:
+  /// \brief default constructor, initializes subs and pubs
+  /// \throws std::domain_error if a rate limit is not positive
+  explicit WebRelayNode(const rclcpp::NodeOptions & options);
+
+private:
+  using BoundingBoxArray = autoware_auto_msgs::msg::BoundingBoxArray;
+  using PointCloud2 = sensor_msgs::msg::PointCloud2;
+  using Trajectory = autoware_auto_msgs::msg::Trajectory;
+  using VehicleKinematicState = autoware_auto_msgs::msg::VehicleKinematicState;
+
+  /// \brief Check the rate limit of a stream with the current time
+  bool8_t allow(RateLimiter & limiter);
+
+  void on_vehicle_state(const VehicleKinematicState::SharedPtr msg);
+  void on_trajectory(const Trajectory::SharedPtr msg);
+  void on_objects(const BoundingBoxArray::SharedPtr msg);
+  void on_points(const PointCloud2::SharedPtr msg);
+
+  RateLimiter m_vehicle_state_limiter;
+  RateLimiter m_trajectory_limiter;
+  RateLimiter m_objects_limiter;
+  RateLimiter m_points_limiter;
+  float32_t m_trajectory_min_point_distance;
+  float32_t m_points_voxel_size;
+  std::size_t m_points_max_points;
+  /// \brief Output cloud that is reused for every message
+  PointCloud2 m_points_out;
+
+  rclcpp::Publisher<VehicleKinematicState>::SharedPtr m_vehicle_state_pub;
+  rclcpp::Publisher<Trajectory>::SharedPtr m_trajectory_pub;
+  rclcpp::Publisher<BoundingBoxArray>::SharedPtr m_objects_pub;
+  rclcpp::Publisher<PointCloud2>::SharedPtr m_points_pub;
+  rclcpp::Subscription<VehicleKinematicState>::SharedPtr m_vehicle_state_sub;
+  rclcpp::Subscription<Trajectory>::SharedPtr m_trajectory_sub;
+  rclcpp::Subscription<BoundingBoxArray>::SharedPtr m_objects_sub;
+  rclcpp::Subscription<PointCloud2>::SharedPtr m_points_sub;
+};
+
+}  // namespace avp_web_interface
+}  // namespace tools
+}  // namespace autoware
+
+#endif  // AVP_WEB_INTERFACE__WEB_RELAY_NODE_HPP_
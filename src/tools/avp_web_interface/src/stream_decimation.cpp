@@ -0,0 +1,169 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <sensor_msgs/point_cloud2_iterator.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "avp_web_interface/stream_decimation.hpp"
+
+namespace autoware
+{
+namespace tools
+{
+namespace avp_web_interface
+{
+
+RateLimiter::RateLimiter(const float64_t max_rate_hz)
+{
+  if (!(max_rate_hz > 0.0)) {
+    throw std::domain_error("RateLimiter: the maximum rate must be positive");
+  }
+  m_min_period = std::chrono::nanoseconds{static_cast<std::int64_t>(1.0e9 / max_rate_hz)};
+}
+
+bool8_t RateLimiter::allow(const std::chrono::nanoseconds now)
+{
+  if (m_started && (now < m_next) && (now >= (m_next - m_min_period))) {
+    return false;
+  }
+  // Advancing by the period instead of restarting from now keeps the rate when the messages
+  // arrive slightly early or late. After a gap or a jump of the time the limiter restarts.
+  if (m_started && (now >= m_next) && (now < (m_next + m_min_period))) {
+    m_next += m_min_period;
+  } else {
+    m_next = now + m_min_period;
+  }
+  m_started = true;
+  return true;
+}
+
+autoware_auto_msgs::msg::Trajectory decimate_trajectory(
+  const autoware_auto_msgs::msg::Trajectory & trajectory, const float32_t min_point_distance)
+{
+  if ((min_point_distance <= 0.0F) || (trajectory.points.size() < 3U)) {
+    return trajectory;
+  }
+  autoware_auto_msgs::msg::Trajectory decimated;
+  decimated.header = trajectory.header;
+  const auto min_distance2 = min_point_distance * min_point_distance;
+  decimated.points.push_back(trajectory.points.front());
+  for (std::size_t i = 1U; (i + 1U) < trajectory.points.size(); ++i) {
+    const auto & point = trajectory.points[i];
+    const auto dx = point.x - decimated.points.back().x;
+    const auto dy = point.y - decimated.points.back().y;
+    if (((dx * dx) + (dy * dy)) >= min_distance2) {
+      decimated.points.push_back(point);
+    }
+  }
+  decimated.points.push_back(trajectory.points.back());
+  return decimated;
+}
+
+namespace
+{
+// Voxel indices packed into 21 bits each, voxels that are 2^21 voxels apart share a key
+std::uint64_t voxel_key(
+  const float32_t x, const float32_t y, const float32_t z, const float32_t size)
+{
+  const auto index = [size](const float32_t value) {
+      // Clamped so that the conversion of far away points is defined
+      const auto i = static_cast<std::int64_t>(
+        std::floor(std::min(std::max(value / size, -1.0e15F), 1.0e15F)));
+      return static_cast<std::uint64_t>(i) & 0x1FFFFFU;
+    };
+  return (index(x) << 42U) | (index(y) << 21U) | index(z);
+}
+
+std::size_t float_field_offset(const sensor_msgs::msg::PointCloud2 & cloud, const char * name)
+{
+  for (const auto & field : cloud.fields) {
+    if (field.name == name) {
+      if (field.datatype != sensor_msgs::msg::PointField::FLOAT32) {
+        throw std::runtime_error(std::string{"decimate_point_cloud: field not FLOAT32: "} + name);
+      }
+      return static_cast<std::size_t>(field.offset);
+    }
+  }
+  throw std::runtime_error(std::string{"decimate_point_cloud: missing field "} + name);
+}
+
+float32_t read_float(const std::uint8_t * data)
+{
+  float32_t value;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+}  // namespace
+
+void decimate_point_cloud(
+  const sensor_msgs::msg::PointCloud2 & cloud_in, const float32_t voxel_size,
+  const std::size_t max_points, sensor_msgs::msg::PointCloud2 & cloud_out)
+{
+  const std::size_t x_offset = float_field_offset(cloud_in, "x");
+  const std::size_t y_offset = float_field_offset(cloud_in, "y");
+  const std::size_t z_offset = float_field_offset(cloud_in, "z");
+  const auto point_step = static_cast<std::size_t>(cloud_in.point_step);
+  const std::size_t num_points = static_cast<std::size_t>(cloud_in.width) * cloud_in.height;
+  if ((num_points * point_step) > cloud_in.data.size()) {
+    throw std::runtime_error("decimate_point_cloud: the data is smaller than the dimensions");
+  }
+
+  std::vector<std::size_t> kept;
+  kept.reserve(num_points);
+  std::unordered_set<std::uint64_t> occupied;
+  for (std::size_t i = 0U; i < num_points; ++i) {
+    const auto point = &cloud_in.data[i * point_step];
+    const auto x = read_float(point + x_offset);
+    const auto y = read_float(point + y_offset);
+    const auto z = read_float(point + z_offset);
+    if (!std::isfinite(x) || !std::isfinite(y) || !std::isfinite(z)) {
+      continue;
+    }
+    if ((voxel_size <= 0.0F) || occupied.insert(voxel_key(x, y, z, voxel_size)).second) {
+      kept.push_back(i);
+    }
+  }
+  const std::size_t num_out =
+    ((max_points > 0U) && (kept.size() > max_points)) ? max_points : kept.size();
+
+  cloud_out.header = cloud_in.header;
+  sensor_msgs::PointCloud2Modifier modifier{cloud_out};
+  modifier.setPointCloud2FieldsByString(1, "xyz");
+  modifier.resize(num_out);
+  cloud_out.is_dense = true;
+  if (num_out == 0U) {
+    return;
+  }
+
+  sensor_msgs::PointCloud2Iterator<float32_t> x_out{cloud_out, "x"};
+  sensor_msgs::PointCloud2Iterator<float32_t> y_out{cloud_out, "y"};
+  sensor_msgs::PointCloud2Iterator<float32_t> z_out{cloud_out, "z"};
+  for (std::size_t j = 0U; j < num_out; ++j, ++x_out, ++y_out, ++z_out) {
+    // Sampled evenly over the cloud, instead of only its first part in the scan order
+    const auto point = &cloud_in.data[kept[(j * kept.size()) / num_out] * point_step];
+    *x_out = read_float(point + x_offset);
+    *y_out = read_float(point + y_offset);
+    *z_out = read_float(point + z_offset);
+  }
+}
+
+}  // namespace avp_web_interface
+}  // namespace tools
+}  // namespace autoware
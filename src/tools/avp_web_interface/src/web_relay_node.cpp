@@ -0,0 +1,119 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <stdexcept>
+#include "avp_web_interface/web_relay_node.hpp"
+
+namespace
+{
+// Only the latest message matters for the display, older ones would only add latency
+const std::size_t QOS_HISTORY_DEPTH = 1U;
+}  // namespace
+
+namespace autoware
+{
+namespace tools
+{
+namespace avp_web_interface
+{
+
+WebRelayNode::WebRelayNode(const rclcpp::NodeOptions & options)
+: Node("web_relay", options),
+  m_vehicle_state_limiter{declare_parameter("vehicle_state.max_rate_hz", 5.0)},
+  m_trajectory_limiter{declare_parameter("trajectory.max_rate_hz", 2.0)},
+  m_objects_limiter{declare_parameter("objects.max_rate_hz", 2.0)},
+  m_points_limiter{declare_parameter("points.max_rate_hz", 1.0)},
+  m_trajectory_min_point_distance{
+    static_cast<float32_t>(declare_parameter("trajectory.min_point_distance", 1.0))},
+  m_points_voxel_size{static_cast<float32_t>(declare_parameter("points.voxel_size", 0.5))}
+{
+  const auto max_points = declare_parameter("points.max_points", 5000);
+  if (max_points < 0) {
+    throw std::domain_error("points.max_points must not be negative");
+  }
+  m_points_max_points = static_cast<std::size_t>(max_points);
+
+  const auto qos = rclcpp::QoS{rclcpp::KeepLast{QOS_HISTORY_DEPTH}};
+  m_vehicle_state_pub = create_publisher<VehicleKinematicState>("web/vehicle_state", qos);
+  m_trajectory_pub = create_publisher<Trajectory>("web/trajectory", qos);
+  m_objects_pub = create_publisher<BoundingBoxArray>("web/objects", qos);
+
+  using std::placeholders::_1;
+  m_vehicle_state_sub = create_subscription<VehicleKinematicState>(
+    "vehicle_state", rclcpp::QoS{10}, std::bind(&WebRelayNode::on_vehicle_state, this, _1));
+  m_trajectory_sub = create_subscription<Trajectory>(
+    "trajectory", rclcpp::QoS{10}, std::bind(&WebRelayNode::on_trajectory, this, _1));
+  m_objects_sub = create_subscription<BoundingBoxArray>(
+    "objects", rclcpp::QoS{10}, std::bind(&WebRelayNode::on_objects, this, _1));
+  // Receiving point clouds is expensive by itself, so only subscribe when asked to
+  if (declare_parameter("points.enabled", false)) {
+    m_points_pub = create_publisher<PointCloud2>("web/points", qos);
+    m_points_sub = create_subscription<PointCloud2>(
+      "points", rclcpp::SensorDataQoS{}, std::bind(&WebRelayNode::on_points, this, _1));
+  }
+}
+
+bool8_t WebRelayNode::allow(RateLimiter & limiter)
+{
+  return limiter.allow(std::chrono::nanoseconds{now().nanoseconds()});
+}
+
+void WebRelayNode::on_vehicle_state(const VehicleKinematicState::SharedPtr msg)
+{
+  if (allow(m_vehicle_state_limiter)) {
+    m_vehicle_state_pub->publish(*msg);
+  }
+}
+
+void WebRelayNode::on_trajectory(const Trajectory::SharedPtr msg)
+{
+  if (allow(m_trajectory_limiter)) {
+    m_trajectory_pub->publish(decimate_trajectory(*msg, m_trajectory_min_point_distance));
+  }
+}
+
+void WebRelayNode::on_objects(const BoundingBoxArray::SharedPtr msg)
+{
+  if (allow(m_objects_limiter)) {
+    m_objects_pub->publish(*msg);
+  }
+}
+
+void WebRelayNode::on_points(const PointCloud2::SharedPtr msg)
+{
+  if (!allow(m_points_limiter)) {
+    return;
+  }
+  try {
+    decimate_point_cloud(*msg, m_points_voxel_size, m_points_max_points, m_points_out);
+  } catch (const std::exception & e) {
+    RCLCPP_WARN(get_logger(), "Dropping a point cloud: %s", e.what());
+    return;
+  }
+  m_points_pub->publish(m_points_out);
+}
+
+}  // namespace avp_web_interface
+}  // namespace tools
+}  // namespace autoware
+
+#include "rclcpp_components/register_node_macro.hpp"
+
+// This acts as an entry point, allowing the component to be
+// discoverable when its library is being loaded into a running process
+RCLCPP_COMPONENTS_REGISTER_NODE(autoware::tools::avp_web_interface::WebRelayNode)
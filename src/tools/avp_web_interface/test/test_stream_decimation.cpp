@@ -0,0 +1,151 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <avp_web_interface/stream_decimation.hpp>
+#include <sensor_msgs/point_cloud2_iterator.hpp>
+#include <chrono>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+using autoware::tools::avp_web_interface::RateLimiter;
+using autoware::tools::avp_web_interface::decimate_point_cloud;
+using autoware::tools::avp_web_interface::decimate_trajectory;
+using autoware::tools::avp_web_interface::float32_t;
+using sensor_msgs::msg::PointCloud2;
+using std::chrono::milliseconds;
+
+namespace
+{
+PointCloud2 make_cloud(const std::vector<std::vector<float32_t>> & points)
+{
+  PointCloud2 cloud;
+  cloud.header.frame_id = "lidar";
+  sensor_msgs::PointCloud2Modifier modifier{cloud};
+  modifier.setPointCloud2FieldsByString(2, "xyz", "rgb");
+  modifier.resize(points.size());
+  sensor_msgs::PointCloud2Iterator<float32_t> x{cloud, "x"};
+  sensor_msgs::PointCloud2Iterator<float32_t> y{cloud, "y"};
+  sensor_msgs::PointCloud2Iterator<float32_t> z{cloud, "z"};
+  for (const auto & point : points) {
+    *x = point[0];
+    *y = point[1];
+    *z = point[2];
+    ++x;
+    ++y;
+    ++z;
+  }
+  return cloud;
+}
+}  // namespace
+
+TEST(TestRateLimiter, ThinsOutEvenly)
+{
+  RateLimiter limiter{5.0};
+  std::size_t forwarded = 0U;
+  // A 10 Hz stream with a few milliseconds of jitter for 10 s
+  for (int i = 0; i < 100; ++i) {
+    const auto jitter = milliseconds{(i % 2 == 0) ? 3 : -3};
+    if (limiter.allow(milliseconds{100 * i} + jitter)) {
+      ++forwarded;
+    }
+  }
+  EXPECT_EQ(forwarded, 50U);
+}
+
+TEST(TestRateLimiter, RestartsAfterTimeJump)
+{
+  RateLimiter limiter{1.0};
+  EXPECT_TRUE(limiter.allow(milliseconds{10000}));
+  EXPECT_FALSE(limiter.allow(milliseconds{10500}));
+  // e.g. a bag that is played again
+  EXPECT_TRUE(limiter.allow(milliseconds{0}));
+  EXPECT_FALSE(limiter.allow(milliseconds{500}));
+  EXPECT_TRUE(limiter.allow(milliseconds{1000}));
+}
+
+TEST(TestRateLimiter, RejectsInvalidRate)
+{
+  EXPECT_THROW(RateLimiter{0.0}, std::domain_error);
+  EXPECT_THROW(RateLimiter{std::numeric_limits<double>::quiet_NaN()}, std::domain_error);
+}
+
+TEST(TestDecimateTrajectory, KeepsEndsAndSpacing)
+{
+  autoware_auto_msgs::msg::Trajectory trajectory;
+  trajectory.header.frame_id = "map";
+  for (int i = 0; i <= 40; ++i) {
+    autoware_auto_msgs::msg::TrajectoryPoint point;
+    point.x = 0.25F * static_cast<float32_t>(i);
+    trajectory.points.push_back(point);
+  }
+  const auto decimated = decimate_trajectory(trajectory, 1.0F);
+  EXPECT_EQ(decimated.header.frame_id, "map");
+  ASSERT_EQ(decimated.points.size(), 11U);
+  for (std::size_t i = 0U; i < decimated.points.size(); ++i) {
+    EXPECT_FLOAT_EQ(decimated.points[i].x, static_cast<float32_t>(i));
+  }
+
+  EXPECT_EQ(decimate_trajectory(trajectory, 0.0F).points.size(), trajectory.points.size());
+}
+
+TEST(TestDecimatePointCloud, OnePointPerVoxel)
+{
+  const auto nan = std::numeric_limits<float32_t>::quiet_NaN();
+  const auto cloud = make_cloud(
+    {{0.1F, 0.1F, 0.1F}, {0.2F, 0.3F, 0.4F}, {1.1F, 0.1F, 0.1F}, {nan, 0.0F, 0.0F},
+      {-0.1F, 0.1F, 0.1F}});
+  PointCloud2 decimated;
+  decimate_point_cloud(cloud, 1.0F, 0U, decimated);
+  EXPECT_EQ(decimated.header.frame_id, "lidar");
+  EXPECT_EQ(decimated.height, 1U);
+  ASSERT_EQ(decimated.width, 3U);
+  EXPECT_EQ(decimated.fields.size(), 3U);
+  sensor_msgs::PointCloud2ConstIterator<float32_t> x{decimated, "x"};
+  EXPECT_FLOAT_EQ(*x, 0.1F);
+  ++x;
+  EXPECT_FLOAT_EQ(*x, 1.1F);
+  ++x;
+  EXPECT_FLOAT_EQ(*x, -0.1F);
+
+  decimate_point_cloud(cloud, 0.0F, 0U, decimated);
+  EXPECT_EQ(decimated.width, 4U);
+}
+
+TEST(TestDecimatePointCloud, SamplesDownToMaxPoints)
+{
+  std::vector<std::vector<float32_t>> points;
+  for (int i = 0; i < 100; ++i) {
+    points.push_back({static_cast<float32_t>(i), 0.0F, 0.0F});
+  }
+  PointCloud2 decimated;
+  decimate_point_cloud(make_cloud(points), 0.5F, 10U, decimated);
+  ASSERT_EQ(decimated.width, 10U);
+  sensor_msgs::PointCloud2ConstIterator<float32_t> x{decimated, "x"};
+  for (int i = 0; i < 10; ++i, ++x) {
+    EXPECT_FLOAT_EQ(*x, static_cast<float32_t>(10 * i));
+  }
+}
+
+TEST(TestDecimatePointCloud, RejectsMissingFields)
+{
+  PointCloud2 cloud;
+  sensor_msgs::PointCloud2Modifier modifier{cloud};
+  modifier.setPointCloud2FieldsByString(1, "rgb");
+  modifier.resize(1U);
+  PointCloud2 decimated;
+  EXPECT_THROW(decimate_point_cloud(cloud, 1.0F, 0U, decimated), std::runtime_error);
+}
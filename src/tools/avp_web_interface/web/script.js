@@ -112,4 +112,33 @@ document.addEventListener("DOMContentLoaded", function() {
     registerCallback("park_forward", {x: -96.46856384277344, y: 58.39532775878906}, {z: 0.42554035782814026, w: 0.9049394130706787});
     registerCallback("park_reverse", {x: -98.56259155273438, y: 60.99168395996094}, {z: -0.42844402469653825, w: 0.9035683248663778});
     registerCallback("return", {x: -26.73, y: 108.795}, {z: 0.342, w: 0.939});
+
+    // The web_relay node republishes these topics at capped rates with decimated geometry.
+    // rosbridge sends them CBOR encoded, which is smaller and cheaper to produce than JSON, and
+    // drops messages that come faster than throttle_rate, in milliseconds.
+    function subscribeStatus(topic_name, message_type, throttle_rate, callback) {
+        var topic = new ROSLIB.Topic({
+            ros : ros,
+            name : topic_name,
+            messageType : message_type,
+            compression : 'cbor',
+            throttle_rate : throttle_rate,
+            queue_length : 1
+        });
+        topic.subscribe(callback);
+    }
+
+    function showStatus(name, text) {
+        document.querySelector("[name='" + name + "']").textContent = text;
+    }
+
+    subscribeStatus('/gui/web/vehicle_state', 'autoware_auto_msgs/msg/VehicleKinematicState', 200,
+        (msg) => {
+            showStatus("speed", msg.state.longitudinal_velocity_mps.toFixed(1) + " m/s");
+            showStatus("position", msg.state.x.toFixed(1) + ", " + msg.state.y.toFixed(1));
+        });
+    subscribeStatus('/gui/web/trajectory', 'autoware_auto_msgs/msg/Trajectory', 500,
+        (msg) => { showStatus("trajectory", msg.points.length + " points"); });
+    subscribeStatus('/gui/web/objects', 'autoware_auto_msgs/msg/BoundingBoxArray', 500,
+        (msg) => { showStatus("objects", msg.boxes.length.toString()); });
 })
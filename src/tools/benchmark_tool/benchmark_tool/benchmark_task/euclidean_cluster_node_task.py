@@ -24,6 +24,7 @@ from benchmark_tool.output_formatter.euclidean_cluster_node_output_formatter \
 from benchmark_tool.metric.kitti_3d_object_detection_metric \
     import Kitti3dObjectDetectionMetric
 from benchmark_tool.metric.average_metric import AverageMetric
+from benchmark_tool.metric.resource_usage_metric import ResourceUsageMetric
 from benchmark_tool.time_estimator.time_estimator_header \
     import TimeEstimatorHeader
 from benchmark_tool.player.synced_player import SyncedPlayer
@@ -72,6 +73,7 @@ class EuclideanClusterNodeTask(BenchmarkTask):
         self._time_estimator = None
         self._kitti_3d_metric = None
         self._speed_metric = None
+        self._resource_usage_metric = None
         self._shutdown_counter = 0
         self._speed_formatter = None
         self._limit_frame = -1
@@ -150,6 +152,13 @@ class EuclideanClusterNodeTask(BenchmarkTask):
             self.SPEED_METRIC_OUTPUT_FILENAME
         )
 
+        # Prepare the resource usage metric object, recorded by the sys_info node
+        self._resource_usage_metric = ResourceUsageMetric(
+            self.node,
+            result_path,
+            (result_path + self.SPEED_METRIC_OUTPUT_PATH)
+        )
+
         # Create the Player to play the data to the lidar node
         self._data_player = SyncedPlayer(self.node, self._dataset)
         if not self._data_player.add_track(
@@ -245,3 +254,7 @@ class EuclideanClusterNodeTask(BenchmarkTask):
                                                  "\nMin: %.1f\nAverage: %.1f\nMax: %.1f"):
             error(self.node,
                   "Problem computing speed metrics")
+
+        # Compute the resource usage metric
+        if not self._resource_usage_metric.compute_metric():
+            error(self.node, "Problem computing resource usage metrics")
@@ -18,6 +18,7 @@ from benchmark_tool.benchmark_task.benchmark_task import BenchmarkTask
 from benchmark_tool.output_formatter.generic_stream_formatter \
     import GenericStreamFormatter
 from benchmark_tool.metric.average_metric import AverageMetric
+from benchmark_tool.metric.resource_usage_metric import ResourceUsageMetric
 from benchmark_tool.player.synced_external_player \
     import SyncedExternalPlayer
 from benchmark_tool.time_estimator.time_estimator_header \
@@ -58,6 +59,7 @@ class NdtMatchingTask(BenchmarkTask):
         super(NdtMatchingTask, self).__init__(node)
         self._data_player = None
         self._speed_metric = None
+        self._resource_usage_metric = None
         self._shutdown_counter = 0
         self._speed_formatter = None
 
@@ -100,6 +102,13 @@ class NdtMatchingTask(BenchmarkTask):
             self.SPEED_METRIC_OUTPUT_NAME
         )
 
+        # Prepare the resource usage metric object, recorded by the sys_info node
+        self._resource_usage_metric = ResourceUsageMetric(
+            self.node,
+            result_path,
+            (result_path + self.SPEED_METRIC_OUTPUT_PATH)
+        )
+
         # Create the Player to play the data to the ndt_matching node
         self._data_player = SyncedExternalPlayer(self.node)
         if not self._data_player.add_track(
@@ -168,3 +177,7 @@ class NdtMatchingTask(BenchmarkTask):
             "Time of iteration (ms) :\nMin: %.1f" +
                 "\nAverage: %.1f \nMax: %.1f"):
             error(self.node, "Problem computing speed metrics")
+
+        # Compute the resource usage metric
+        if not self._resource_usage_metric.compute_metric():
+            error(self.node, "Problem computing resource usage metrics")
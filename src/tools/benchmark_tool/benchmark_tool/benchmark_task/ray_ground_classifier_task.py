@@ -20,6 +20,7 @@ from benchmark_tool.dataset.kitti_3d_benchmark_dataset \
 from benchmark_tool.output_formatter.generic_stream_formatter \
     import GenericStreamFormatter
 from benchmark_tool.metric.average_metric import AverageMetric
+from benchmark_tool.metric.resource_usage_metric import ResourceUsageMetric
 from benchmark_tool.time_estimator.time_estimator_header \
     import TimeEstimatorHeader
 from benchmark_tool.player.synced_player_frame_size \
@@ -71,6 +72,7 @@ class RayGroundClassifierTask(BenchmarkTask):
         self._data_player = None
         self._time_estimator = None
         self._speed_metric = None
+        self._resource_usage_metric = None
         self._shutdown_counter = 0
         self._speed_formatter = None
 
@@ -132,6 +134,13 @@ class RayGroundClassifierTask(BenchmarkTask):
             self.SPEED_METRIC_OUTPUT_NAME
         )
 
+        # Prepare the resource usage metric object, recorded by the sys_info node
+        self._resource_usage_metric = ResourceUsageMetric(
+            self.node,
+            result_path,
+            (result_path + self.SPEED_METRIC_OUTPUT_PATH)
+        )
+
         # Prepare the size metric object
         self._pointcloud_size_metric = AverageMetric(
             self.node,
@@ -233,3 +242,7 @@ class RayGroundClassifierTask(BenchmarkTask):
             "Size of the pointcloud fed to the node (bytes): " +
                 "\nMin: %.1f\nAverage: %.1f \nMax: %.1f"):
             error(self.node, "Problem computing size metrics")
+
+        # Compute the resource usage metric
+        if not self._resource_usage_metric.compute_metric():
+            error(self.node, "Problem computing resource usage metrics")
@@ -43,6 +43,8 @@
 #include <numeric>
 #include <string>
 #include <functional>
+#include <future>
+#include <thread>
 
 #include "kittiobjevalmodule.hpp"
 
@@ -358,9 +360,38 @@ Polygon toPolygon(const T & g)
   return poly;
 }
 
+// axis aligned rectangle around an oriented bounding box on the ground plane
+struct tGroundRect
+{
+  float64_t x1, z1, x2, z2;
+};
+
+template<typename T>
+tGroundRect toGroundRect(const T & g)
+{
+  const float64_t c = fabs(cos(g.ry));
+  const float64_t s = fabs(sin(g.ry));
+  const float64_t dx = (c * fabs(g.l) + s * fabs(g.w)) / 2;
+  const float64_t dz = (s * fabs(g.l) + c * fabs(g.w)) / 2;
+  return tGroundRect{g.t1 - dx, g.t3 - dz, g.t1 + dx, g.t3 + dz};
+}
+
+// boxes whose rectangles are apart don't overlap, which is much cheaper to check than
+// intersecting their polygons. Most detection/ground truth pairs of a frame are such pairs.
+inline bool8_t groundRectOverlap(const tDetection & d, const tGroundtruth & g)
+{
+  const tGroundRect a = toGroundRect(d);
+  const tGroundRect b = toGroundRect(g);
+  return a.x1 <= b.x2 && b.x1 <= a.x2 && a.z1 <= b.z2 && b.z1 <= a.z2;
+}
+
 // measure overlap between bird's eye view bounding boxes, parametrized by (ry, l, w, tx, tz)
 inline float64_t groundBoxOverlap(tDetection d, tGroundtruth g, int32_t criterion = -1)
 {
+  if (!groundRectOverlap(d, g)) {
+    return 0;
+  }
+
   Polygon gp = toPolygon(g);
   Polygon dp = toPolygon(d);
 
@@ -385,15 +416,19 @@ inline float64_t groundBoxOverlap(tDetection d, tGroundtruth g, int32_t criterio
 // measure overlap between 3D bounding boxes, parametrized by (ry, h, w, l, tx, ty, tz)
 inline float64_t box3DOverlap(tDetection d, tGroundtruth g, int32_t criterion = -1)
 {
+  float64_t ymax = std::min(d.t2, g.t2);
+  float64_t ymin = std::max(d.t2 - d.h, g.t2 - g.h);
+
+  // the polygons are only intersected for boxes which overlap in height and on the ground plane
+  if (ymax <= ymin || !groundRectOverlap(d, g)) {
+    return 0;
+  }
+
   Polygon gp = toPolygon(g);
   Polygon dp = toPolygon(d);
 
-  std::vector<Polygon> in, un;
+  std::vector<Polygon> in;
   boost::geometry::intersection(gp, dp, in);
-  boost::geometry::union_(gp, dp, un);
-
-  float64_t ymax = std::min(d.t2, g.t2);
-  float64_t ymin = std::max(d.t2 - d.h, g.t2 - g.h);
 
   float64_t inter_area = in.empty() ? 0 : boost::geometry::area(in.front());
   float64_t inter_vol = inter_area * std::max(0.0, ymax - ymin);
@@ -723,6 +758,39 @@ tPrData computeStatistics(
 EVALUATE CLASS-WISE
 =======================================================================*/
 
+// detection scores and no. of ground truth of some frames for the recall discretization
+struct tRecallAccumulator
+{
+  std::vector<float64_t> v;
+  int32_t n_gt;
+  tRecallAccumulator()
+  : n_gt(0) {}
+};
+
+// evaluate consecutive chunks of the frames [0, n_frames) in parallel, with one chunk per hardware
+// thread. eval_chunk(begin, end) evaluates the frames [begin, end) into its own accumulator, so
+// that the threads don't share any state, the accumulators are returned in the order of the frames.
+template<typename Accumulator, typename EvalChunk>
+std::vector<Accumulator> evalFramesInParallel(size_t n_frames, EvalChunk eval_chunk)
+{
+  std::vector<Accumulator> accumulators;
+  if (n_frames == 0) {
+    return accumulators;
+  }
+  const size_t n_threads = std::max(std::thread::hardware_concurrency(), 1U);
+  const size_t chunk_size = (n_frames + n_threads - 1) / n_threads;
+  std::vector<std::future<Accumulator>> workers;
+  for (size_t begin = 0; begin < n_frames; begin += chunk_size) {
+    workers.push_back(
+      std::async(std::launch::async, eval_chunk, begin, std::min(begin + chunk_size, n_frames)));
+  }
+  // get() also forwards the exceptions of the workers
+  for (std::future<Accumulator> & worker : workers) {
+    accumulators.push_back(worker.get());
+  }
+  return accumulators;
+}
+
 bool8_t eval_class(
   FILE * fp_det, FILE * fp_ori, CLASSES current_class,
   const std::vector<std::vector<tGroundtruth>> & groundtruth,
@@ -733,62 +801,76 @@ bool8_t eval_class(
 {
   assert(groundtruth.size() == detections.size());
 
-  // init
-  // total no. of gt (denominator of recall)
-  int32_t n_gt = 0;
-  // detection scores, evaluated for recall discretization
-  std::vector<float64_t> v, thresholds;
   // index of ignored gt detection for current class/difficulty
-  std::vector<std::vector<int32_t>> ignored_gt, ignored_det;
+  std::vector<std::vector<int32_t>> ignored_gt(groundtruth.size()), ignored_det(groundtruth.size());
   // index of dontcare areas, included in ground truth
-  std::vector<std::vector<tGroundtruth>> dontcare;
+  std::vector<std::vector<tGroundtruth>> dontcare(groundtruth.size());
 
   // for all test images do
-  for (uint32_t i = 0; i < groundtruth.size(); i++) {
-    // holds ignored ground truth, ignored detections and dontcare areas for current frame
-    std::vector<int32_t> i_gt, i_det;
-    std::vector<tGroundtruth> dc;
-
-    // only evaluate objects of current class and ignore occluded, truncated objects
-    cleanData(current_class, groundtruth[i], detections[i], i_gt, dc, i_det, n_gt, difficulty);
-    ignored_gt.push_back(i_gt);
-    ignored_det.push_back(i_det);
-    dontcare.push_back(dc);
-
-    // compute statistics to get recall values
-    tPrData pr_tmp = tPrData();
-    pr_tmp = computeStatistics(
-      current_class, groundtruth[i], detections[i], dc, i_gt, i_det, false,
-      boxoverlap, metric);
-
-    // add detection scores to vector over all images
-    for (uint32_t j = 0; j < pr_tmp.v.size(); j++) {
-      v.push_back(pr_tmp.v[j]);
-    }
+  const std::vector<tRecallAccumulator> recall_acc = evalFramesInParallel<tRecallAccumulator>(
+    groundtruth.size(), [&](size_t begin, size_t end) {
+      tRecallAccumulator acc;
+      for (size_t i = begin; i < end; i++) {
+        // only evaluate objects of current class and ignore occluded, truncated objects
+        cleanData(
+          current_class, groundtruth[i], detections[i], ignored_gt[i], dontcare[i],
+          ignored_det[i], acc.n_gt, difficulty);
+
+        // compute statistics to get recall values
+        tPrData pr_tmp = computeStatistics(
+          current_class, groundtruth[i], detections[i], dontcare[i], ignored_gt[i],
+          ignored_det[i], false, boxoverlap, metric);
+
+        // add detection scores to vector over all images
+        acc.v.insert(acc.v.end(), pr_tmp.v.begin(), pr_tmp.v.end());
+      }
+      return acc;
+    });
+
+  // total no. of gt (denominator of recall)
+  int32_t n_gt = 0;
+  // detection scores, evaluated for recall discretization
+  std::vector<float64_t> v;
+  for (const tRecallAccumulator & acc : recall_acc) {
+    n_gt += acc.n_gt;
+    v.insert(v.end(), acc.v.begin(), acc.v.end());
   }
 
   // get scores that must be evaluated for recall discretization
-  thresholds = getThresholds(v, n_gt);
+  const std::vector<float64_t> thresholds = getThresholds(v, n_gt);
 
   // compute TP,FP,FN for relevant scores
-  std::vector<tPrData> pr;
-  pr.assign(thresholds.size(), tPrData());
-  for (uint32_t i = 0; i < groundtruth.size(); i++) {
-    // for all scores/recall thresholds do:
-    for (uint32_t t = 0; t < thresholds.size(); t++) {
-      tPrData tmp = tPrData();
-      tmp = computeStatistics(
-        current_class, groundtruth[i], detections[i], dontcare[i],
-        ignored_gt[i], ignored_det[i], true, boxoverlap, metric,
-        compute_aos, thresholds[t]);
-
-      // add no. of TP, FP, FN, AOS for current frame to total evaluation for current threshold
-      pr[t].tp += tmp.tp;
-      pr[t].fp += tmp.fp;
-      pr[t].fn += tmp.fn;
-      if (tmp.similarity != -1) {
-        pr[t].similarity += tmp.similarity;
+  const std::vector<std::vector<tPrData>> pr_acc = evalFramesInParallel<std::vector<tPrData>>(
+    groundtruth.size(), [&](size_t begin, size_t end) {
+      std::vector<tPrData> acc(thresholds.size());
+      for (size_t i = begin; i < end; i++) {
+        // for all scores/recall thresholds do:
+        for (size_t t = 0; t < thresholds.size(); t++) {
+          tPrData tmp = computeStatistics(
+            current_class, groundtruth[i], detections[i], dontcare[i],
+            ignored_gt[i], ignored_det[i], true, boxoverlap, metric,
+            compute_aos, thresholds[t]);
+
+          // add no. of TP, FP, FN, AOS for current frame to total evaluation for current threshold
+          acc[t].tp += tmp.tp;
+          acc[t].fp += tmp.fp;
+          acc[t].fn += tmp.fn;
+          if (tmp.similarity != -1) {
+            acc[t].similarity += tmp.similarity;
+          }
+        }
       }
+      return acc;
+    });
+
+  // merge the statistics of all frames, in the order of the frames
+  std::vector<tPrData> pr(thresholds.size());
+  for (const std::vector<tPrData> & acc : pr_acc) {
+    for (size_t t = 0; t < thresholds.size(); t++) {
+      pr[t].tp += acc[t].tp;
+      pr[t].fp += acc[t].fp;
+      pr[t].fn += acc[t].fn;
+      pr[t].similarity += acc[t].similarity;
     }
   }
 
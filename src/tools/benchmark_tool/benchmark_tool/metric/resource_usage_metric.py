@@ -0,0 +1,185 @@
+#! /usr/bin/env python3
+
+# Copyright 2021 the Autoware Foundation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import csv
+import os
+from collections import OrderedDict
+from benchmark_tool.metric.metric import Metric
+from benchmark_tool.utility import error, info
+
+
+class ResourceUsageMetric(Metric):
+    """
+    The ResourceUsageMetric class summarizes the resource usage recorded by the sys_info node.
+
+    It reads the cumulative per-thread samples of the CPU time, the context switches and the
+    hardware counters, and computes their rates over the recording for each node and each of its
+    threads. The instructions per cycle and the cache misses per thousand instructions tell nodes
+    that are bound by the memory from nodes that are bound by the computation.
+    """
+
+    DEFAULT_RESULTS_FILE = "resource_usage.csv"
+    DEFAULT_OUTPUT_FILE = "resource_usage_metric.txt"
+
+    # The cumulative counters, as written by the sys_info node
+    COUNTERS = ['user_s', 'system_s', 'voluntary_ctx_switches', 'involuntary_ctx_switches',
+                'cycles', 'instructions', 'cache_misses', 'branch_misses']
+
+    def __init__(self, node, result_folder, output_folder,
+                 result_file_name=None,
+                 metric_file_name=None):
+        """
+        Create a ResourceUsageMetric object.
+
+        @param node: ROS2 node
+        @type  node: rclpy.node.Node
+        @param result_folder: The path on filesystem for the data to be analyzed
+        @type  result_folder: str
+        @param output_folder: The path on filesystem for the output files after the computation of
+            the metric
+        @type  output_folder: str
+        @param result_file_name: The file name for the file containing the data used to compute
+            this metric
+        @type  result_file_name: str
+        @param metric_file_name: The file name for the computed metric
+        @type  metric_file_name: str
+        """
+        super(ResourceUsageMetric, self).__init__(result_folder, output_folder)
+        self.node = node
+
+        if result_file_name is None:
+            self._result_file_name = self.DEFAULT_RESULTS_FILE
+        else:
+            self._result_file_name = result_file_name
+
+        if metric_file_name is None:
+            self._metric_file_name = self.DEFAULT_OUTPUT_FILE
+        else:
+            self._metric_file_name = metric_file_name
+
+    def compute_metric(self):
+        """
+        Start the computation of the metric.
+
+        It takes the difference between the first and the last sample of each thread, and sums
+        the threads of each node. Threads that were sampled only once are left out. Nothing is
+        computed if the sys_info node didn't record the resource usage.
+
+        @return: True on success, False on failure
+        """
+        filename = os.path.join(self._result_folder, self._result_file_name)
+        if not os.path.isfile(filename):
+            return True
+
+        # The first and last sample of each thread, in the order in which they appeared
+        samples = OrderedDict()
+        try:
+            with open(filename, "r") as file:
+                for row in csv.DictReader(file):
+                    key = (row['node'], row['pid'], row['tid'])
+                    if key not in samples:
+                        samples[key] = [row, row, row['thread']]
+                    samples[key][1] = row
+        except Exception as e:
+            error(self.node, "%s" % str(e))
+            return False
+
+        threads = []
+        nodes = OrderedDict()
+        for (node, _, tid), (first, last, thread) in samples.items():
+            duration_s = (int(last['monotonic_ns']) - int(first['monotonic_ns'])) * 1.0e-9
+            if duration_s <= 0.0:
+                continue
+            deltas = self._deltas(first, last)
+            threads.append((node + "/" + thread + "(" + tid + ")", duration_s, deltas))
+            if node not in nodes:
+                nodes[node] = [duration_s, dict.fromkeys(self.COUNTERS, 0.0)]
+            nodes[node][0] = max(nodes[node][0], duration_s)
+            for counter in self.COUNTERS:
+                if deltas[counter] is None or nodes[node][1][counter] is None:
+                    nodes[node][1][counter] = None
+                else:
+                    nodes[node][1][counter] += deltas[counter]
+
+        lines = ["name cpu_percent voluntary_ctx_switches_per_s involuntary_ctx_switches_per_s "
+                 "ipc cache_misses_per_kilo_instruction branch_misses_per_kilo_instruction"]
+        for name, (duration_s, deltas) in nodes.items():
+            lines.append(self._format(name, duration_s, deltas))
+        for name, duration_s, deltas in threads:
+            lines.append(self._format(name, duration_s, deltas))
+
+        if not self._save_metric_file(lines):
+            error(self.node, "Error saving metric file.")
+            return False
+
+        info(self.node, "Resource usage during benchmark:\n" +
+             "\n".join(lines[:1 + len(nodes)]))
+        return True
+
+    def _deltas(self, first, last):
+        """
+        Get the increase of each counter from one sample to another.
+
+        @return: The increases by counter name, None for the counters that weren't recorded
+        """
+        ret = {}
+        for counter in self.COUNTERS:
+            if first[counter] == '' or last[counter] == '':
+                ret[counter] = None
+            else:
+                ret[counter] = float(last[counter]) - float(first[counter])
+        return ret
+
+    def _format(self, name, duration_s, deltas):
+        """
+        Format the rates of one node or thread as a line of the metric file.
+
+        @return: The line, with "nan" for the values that can't be computed
+        """
+        def ratio(numerator, denominator, factor=1.0):
+            if deltas[numerator] is None or deltas[denominator] is None or \
+                    deltas[denominator] <= 0.0:
+                return "nan"
+            return "%.3f" % (factor * deltas[numerator] / deltas[denominator])
+
+        cpu_percent = 100.0 * (deltas['user_s'] + deltas['system_s']) / duration_s
+        return " ".join([
+            name.replace(" ", "_"),
+            "%.1f" % cpu_percent,
+            "%.1f" % (deltas['voluntary_ctx_switches'] / duration_s),
+            "%.1f" % (deltas['involuntary_ctx_switches'] / duration_s),
+            ratio('instructions', 'cycles'),
+            ratio('cache_misses', 'instructions', 1000.0),
+            ratio('branch_misses', 'instructions', 1000.0),
+        ])
+
+    def _save_metric_file(self, lines):
+        """
+        Save the output file with one line per node and thread.
+
+        @param lines: The lines to be saved in the output file
+        @type  lines: list
+        @return: True on success, False on failure
+        """
+        filename = os.path.join(self._output_folder, self._metric_file_name)
+        try:
+            with open(filename, "w") as file:
+                file.write("\n".join(lines) + "\n")
+        except Exception as e:
+            error(self.node, "%s" % str(e))
+            return False
+
+        return True
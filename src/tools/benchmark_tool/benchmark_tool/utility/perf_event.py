@@ -0,0 +1,129 @@
+#! /usr/bin/env python3
+
+# Copyright 2021 the Autoware Foundation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import ctypes
+import os
+import platform
+import struct
+
+# From linux/perf_event.h
+_PERF_TYPE_HARDWARE = 0
+_PERF_FORMAT_TOTAL_TIME_ENABLED = 1 << 0
+_PERF_FORMAT_TOTAL_TIME_RUNNING = 1 << 1
+_PERF_FORMAT_GROUP = 1 << 3
+_PERF_FLAG_FD_CLOEXEC = 1 << 3
+_ATTR_FLAG_EXCLUDE_KERNEL = 1 << 5
+_ATTR_FLAG_EXCLUDE_HV = 1 << 6
+_SYSCALL_NUMBERS = {'x86_64': 298, 'aarch64': 241}
+
+# The counters in the order of the group, the first one leads the group
+HARDWARE_COUNTERS = [
+    ('cycles', 0),
+    ('instructions', 1),
+    ('cache_misses', 3),
+    ('branch_misses', 5),
+]
+
+
+class _PerfEventAttr(ctypes.Structure):
+    # The first version of the structure, which all kernels accept
+    _fields_ = [
+        ('type', ctypes.c_uint32),
+        ('size', ctypes.c_uint32),
+        ('config', ctypes.c_uint64),
+        ('sample_period', ctypes.c_uint64),
+        ('sample_type', ctypes.c_uint64),
+        ('read_format', ctypes.c_uint64),
+        ('flags', ctypes.c_uint64),
+        ('wakeup_events', ctypes.c_uint32),
+        ('bp_type', ctypes.c_uint32),
+        ('config1', ctypes.c_uint64),
+    ]
+
+
+_libc = ctypes.CDLL(None, use_errno=True)
+
+
+def _perf_event_open(tid, config, group_fd):
+    syscall_number = _SYSCALL_NUMBERS.get(platform.machine())
+    if syscall_number is None:
+        raise OSError("perf_event_open is not supported on " + platform.machine())
+    attr = _PerfEventAttr()
+    attr.type = _PERF_TYPE_HARDWARE
+    attr.size = ctypes.sizeof(_PerfEventAttr)
+    attr.config = config
+    attr.read_format = (_PERF_FORMAT_GROUP | _PERF_FORMAT_TOTAL_TIME_ENABLED |
+                        _PERF_FORMAT_TOTAL_TIME_RUNNING)
+    # Only count user space, which doesn't need privileges with the default perf_event_paranoid
+    attr.flags = _ATTR_FLAG_EXCLUDE_KERNEL | _ATTR_FLAG_EXCLUDE_HV
+    fd = _libc.syscall(syscall_number, ctypes.byref(attr), ctypes.c_int(tid), ctypes.c_int(-1),
+                       ctypes.c_int(group_fd), ctypes.c_ulong(_PERF_FLAG_FD_CLOEXEC))
+    if fd < 0:
+        errno = ctypes.get_errno()
+        raise OSError(errno, "perf_event_open failed for thread %d: %s" %
+                      (tid, os.strerror(errno)))
+    return fd
+
+
+class ThreadCounters(object):
+    """
+    The ThreadCounters class counts hardware events of a thread through perf_event_open.
+
+    The counters form a group, so that they are scheduled together and their ratios, e.g. the
+    instructions per cycle, are consistent. They count from the construction on, in user space
+    only. When there are more counters than the PMU can count at once, the counts are scaled by
+    the time the group was running.
+    """
+
+    def __init__(self, tid):
+        """
+        Create a ThreadCounters object and start counting.
+
+        @param tid: The id of the thread to count, as in /proc/<pid>/task
+        @type  tid: int
+        @raise OSError: If the counters can't be opened, e.g. because of perf_event_paranoid or
+            because there is no PMU in a virtual machine
+        """
+        super(ThreadCounters, self).__init__()
+        self._fds = []
+        try:
+            for _, config in HARDWARE_COUNTERS:
+                group_fd = self._fds[0] if self._fds else -1
+                self._fds.append(_perf_event_open(tid, config, group_fd))
+        except OSError:
+            self.close()
+            raise
+
+    def read(self):
+        """
+        Read the counters.
+
+        @return: The count of each of the HARDWARE_COUNTERS by name
+        @raise OSError: If the counters were closed
+        """
+        num_counters = len(HARDWARE_COUNTERS)
+        data = os.read(self._fds[0], 8 * (3 + num_counters))
+        values = struct.unpack('%dQ' % (3 + num_counters), data)
+        time_enabled, time_running = values[1], values[2]
+        scale = float(time_enabled) / time_running if time_running > 0 else 0.0
+        return {name: int(value * scale)
+                for (name, _), value in zip(HARDWARE_COUNTERS, values[3:])}
+
+    def close(self):
+        """Stop counting and release the file descriptors."""
+        for fd in self._fds:
+            os.close(fd)
+        self._fds = []
@@ -0,0 +1,186 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief The dataset loading and the pacing of the native replay player
+
+#ifndef BENCHMARK_TOOL__REPLAY_PLAYER_HPP_
+#define BENCHMARK_TOOL__REPLAY_PLAYER_HPP_
+
+#include <benchmark_tool/visibility_control.hpp>
+#include <common/types.hpp>
+#include <latency_tracing/trace_analysis.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace autoware
+{
+namespace tools
+{
+namespace benchmark_tool
+{
+using autoware::common::types::bool8_t;
+using autoware::common::types::float64_t;
+using autoware::common::latency_tracing::LatencyStatistics;
+
+/// \brief The size of a point of the KITTI velodyne files: x, y, z and the reflectance as float32
+constexpr std::size_t kKittiPointStep{16U};
+
+/// \brief Load the point clouds of a KITTI velodyne folder into memory, e.g.
+///        `<dataset>/training/velodyne` of the 3D object detection benchmark
+/// \param[in] folder The folder with the .bin files, which are loaded in the order of their names
+/// \param[in] max_frames The maximum number of files to load, 0 to load all of them
+/// \return The content of the files
+/// \throw std::runtime_error If the folder or a file can't be read, a file isn't a whole number of
+///        points or there are no .bin files
+BENCHMARK_TOOL_PUBLIC std::vector<std::vector<uint8_t>> load_kitti_point_clouds(
+  const std::string & folder, const std::size_t max_frames = 0U);
+
+/// \brief How the player paces the frames
+enum class ReplayMode : uint8_t
+{
+  /// Publish a frame as soon as fewer than the maximum number of frames are in flight, i.e. in
+  /// lockstep with the completions of the node under test. This measures its maximum throughput
+  LOCKSTEP = 0U,
+  /// Publish the frames at a fixed rate whether the node under test keeps up or not. This
+  /// measures its latency under a given load
+  FIXED_RATE = 1U
+};
+
+/// \brief Get a replay mode from its name
+/// \param[in] mode "lockstep" or "fixed_rate"
+/// \return The mode
+/// \throw std::domain_error If the name is unknown
+BENCHMARK_TOOL_PUBLIC ReplayMode parse_replay_mode(const std::string & mode);
+
+/// \brief The configuration of a replay
+struct BENCHMARK_TOOL_PUBLIC ReplayConfig
+{
+  ReplayMode mode{ReplayMode::LOCKSTEP};
+  /// The number of frames in the dataset
+  std::size_t num_frames{0U};
+  /// How many times the dataset is played
+  std::size_t num_loops{1U};
+  /// The number of frames that may await their completion in lockstep mode
+  std::size_t max_in_flight{1U};
+  /// The period of the publications in fixed rate mode and the spacing of the stamps
+  std::chrono::nanoseconds period{std::chrono::milliseconds{100}};
+  /// The time after which a frame that wasn't completed is counted as lost
+  std::chrono::nanoseconds timeout{std::chrono::seconds{10}};
+};
+
+/// \brief The outcome of a replay
+struct BENCHMARK_TOOL_PUBLIC ReplayResult
+{
+  std::size_t published{0U};
+  std::size_t completed{0U};
+  std::size_t lost{0U};
+  /// From the first publication to the last completion, in seconds
+  float64_t duration{0.0};
+  /// Completed frames per second over the duration
+  float64_t throughput{0.0};
+  /// From the publication of a frame to its completion
+  LatencyStatistics latency{};
+};
+
+/// \brief Decides when the frames of a replay are published and records when they were
+///        published and completed. All times are steady clock times in nanoseconds.
+///
+/// The frames are identified by a sequence number, starting at 1, which the player encodes in
+/// the stamp of the published messages, see stamp_ns(). The node under test passes the stamp on
+/// to its output, from which the player gets the sequence number back, see sequence_of().
+///
+/// The records of all frames are allocated on construction, so that the replay itself doesn't
+/// allocate.
+class BENCHMARK_TOOL_PUBLIC ReplayScheduler
+{
+public:
+  /// \brief Constructor
+  /// \param[in] config The configuration of the replay
+  /// \throw std::domain_error If there are no frames or loops, the period or the timeout isn't
+  ///        positive, or no frame may be in flight in lockstep mode
+  explicit ReplayScheduler(const ReplayConfig & config);
+
+  /// \brief Get the next frame if it is due, and record that it is published now. Frames that
+  ///        are in flight for longer than the timeout are counted as lost before
+  /// \param[in] now_ns The current time
+  /// \return The sequence number of the frame to publish, or 0 if no frame is due
+  uint64_t next(const uint64_t now_ns);
+
+  /// \brief Record that the node under test completed a frame
+  /// \param[in] sequence The sequence number of the frame
+  /// \param[in] now_ns The current time
+  /// \return False if the frame isn't in flight, e.g. because it was already completed or lost
+  bool8_t complete(const uint64_t sequence, const uint64_t now_ns);
+
+  /// \brief Whether all frames were published and none is in flight anymore
+  bool8_t done() const noexcept;
+
+  /// \brief The number of frames the replay publishes, i.e. the last sequence number
+  uint64_t num_sequences() const noexcept;
+
+  /// \brief The index in the dataset of the frame with the given sequence number
+  std::size_t frame_index(const uint64_t sequence) const noexcept;
+
+  /// \brief The stamp of the message of a frame in nanoseconds, i.e. the sequence number times
+  ///        the period
+  uint64_t stamp_ns(const uint64_t sequence) const noexcept;
+
+  /// \brief The sequence number of the frame a stamp belongs to
+  /// \param[in] stamp_ns A stamp in nanoseconds
+  /// \return The sequence number, or 0 if no frame has this stamp
+  uint64_t sequence_of(const uint64_t stamp_ns) const noexcept;
+
+  /// \brief Summarize the replay so far
+  ReplayResult result() const;
+
+  /// \brief Write the times of the published frames as CSV, with one row per frame. The
+  ///        completion and the latency are empty for the frames that weren't completed
+  /// \param[inout] stream The stream to write to
+  void write_timing(std::ostream & stream) const;
+
+private:
+  enum class FrameState : uint8_t
+  {
+    IN_FLIGHT,
+    COMPLETED,
+    LOST
+  };
+
+  struct FrameRecord
+  {
+    uint64_t publish_ns;
+    uint64_t completion_ns;
+    FrameState state;
+  };
+
+  ReplayConfig m_config;
+  uint64_t m_num_sequences;
+  /// The records of the published frames, indexed by the sequence number minus one
+  std::vector<FrameRecord> m_records{};
+  /// The first frame that may still be in flight
+  std::size_t m_oldest{0U};
+  std::size_t m_in_flight{0U};
+  uint64_t m_start_ns{0U};
+};
+}  // namespace benchmark_tool
+}  // namespace tools
+}  // namespace autoware
+
+#endif  // BENCHMARK_TOOL__REPLAY_PLAYER_HPP_
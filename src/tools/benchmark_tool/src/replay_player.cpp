@@ -0,0 +1,259 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "benchmark_tool/replay_player.hpp"
+
+#include <dirent.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace autoware
+{
+namespace tools
+{
+namespace benchmark_tool
+{
+namespace
+{
+bool8_t ends_with(const std::string & value, const std::string & suffix)
+{
+  return (value.size() >= suffix.size()) &&
+         (0 == value.compare(value.size() - suffix.size(), suffix.size(), suffix));
+}
+
+struct DirectoryCloser
+{
+  void operator()(DIR * const directory) const noexcept
+  {
+    (void)::closedir(directory);
+  }
+};
+
+std::vector<std::string> list_files(const std::string & folder, const std::string & suffix)
+{
+  const std::unique_ptr<DIR, DirectoryCloser> directory{::opendir(folder.c_str())};
+  if (!directory) {
+    throw std::runtime_error{"load_kitti_point_clouds: can't open " + folder};
+  }
+  std::vector<std::string> ret;
+  for (auto entry = ::readdir(directory.get()); nullptr != entry;
+    entry = ::readdir(directory.get()))
+  {
+    const std::string name{entry->d_name};
+    if (ends_with(name, suffix)) {
+      ret.push_back(name);
+    }
+  }
+  std::sort(ret.begin(), ret.end());
+  return ret;
+}
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+std::vector<std::vector<uint8_t>> load_kitti_point_clouds(
+  const std::string & folder,
+  const std::size_t max_frames)
+{
+  auto names = list_files(folder, ".bin");
+  if (names.empty()) {
+    throw std::runtime_error{"load_kitti_point_clouds: no .bin files in " + folder};
+  }
+  if ((0U != max_frames) && (names.size() > max_frames)) {
+    names.resize(max_frames);
+  }
+  std::vector<std::vector<uint8_t>> ret;
+  ret.reserve(names.size());
+  for (const auto & name : names) {
+    const auto path = folder + "/" + name;
+    std::ifstream file{path, std::ios::binary};
+    if (!file) {
+      throw std::runtime_error{"load_kitti_point_clouds: can't open " + path};
+    }
+    ret.emplace_back(std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{});
+    if (file.bad() || (0U != (ret.back().size() % kKittiPointStep))) {
+      throw std::runtime_error{"load_kitti_point_clouds: " + path + " isn't a KITTI point cloud"};
+    }
+  }
+  return ret;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ReplayMode parse_replay_mode(const std::string & mode)
+{
+  if ("lockstep" == mode) {
+    return ReplayMode::LOCKSTEP;
+  }
+  if ("fixed_rate" == mode) {
+    return ReplayMode::FIXED_RATE;
+  }
+  throw std::domain_error{"parse_replay_mode: unknown mode " + mode};
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ReplayScheduler::ReplayScheduler(const ReplayConfig & config)
+: m_config{config},
+  m_num_sequences{static_cast<uint64_t>(config.num_frames) * config.num_loops}
+{
+  if (0U == m_num_sequences) {
+    throw std::domain_error{"ReplayScheduler: there are no frames to play"};
+  }
+  if ((config.period.count() <= 0) || (config.timeout.count() <= 0)) {
+    throw std::domain_error{"ReplayScheduler: the period and the timeout must be positive"};
+  }
+  if ((ReplayMode::LOCKSTEP == config.mode) && (0U == config.max_in_flight)) {
+    throw std::domain_error{"ReplayScheduler: at least one frame must be in flight"};
+  }
+  m_records.reserve(static_cast<std::size_t>(m_num_sequences));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+uint64_t ReplayScheduler::next(const uint64_t now_ns)
+{
+  const auto timeout_ns = static_cast<uint64_t>(m_config.timeout.count());
+  // The frames are published in order, so the ones in flight for too long are the oldest ones
+  for (; m_oldest < m_records.size(); ++m_oldest) {
+    auto & record = m_records[m_oldest];
+    if (FrameState::IN_FLIGHT == record.state) {
+      if ((now_ns - record.publish_ns) < timeout_ns) {
+        break;
+      }
+      record.state = FrameState::LOST;
+      --m_in_flight;
+    }
+  }
+
+  if (m_records.size() >= m_num_sequences) {
+    return 0U;
+  }
+  if (m_records.empty()) {
+    m_start_ns = now_ns;
+  }
+  if (ReplayMode::LOCKSTEP == m_config.mode) {
+    if (m_in_flight >= m_config.max_in_flight) {
+      return 0U;
+    }
+  } else {
+    // Frames that are late are published right away, so that the load stays the same
+    const auto due_ns = m_start_ns +
+      (static_cast<uint64_t>(m_records.size()) * static_cast<uint64_t>(m_config.period.count()));
+    if (now_ns < due_ns) {
+      return 0U;
+    }
+  }
+  m_records.push_back(FrameRecord{now_ns, 0U, FrameState::IN_FLIGHT});
+  ++m_in_flight;
+  return static_cast<uint64_t>(m_records.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool8_t ReplayScheduler::complete(const uint64_t sequence, const uint64_t now_ns)
+{
+  if ((0U == sequence) || (sequence > m_records.size())) {
+    return false;
+  }
+  auto & record = m_records[static_cast<std::size_t>(sequence - 1U)];
+  if (FrameState::IN_FLIGHT != record.state) {
+    return false;
+  }
+  record.completion_ns = now_ns;
+  record.state = FrameState::COMPLETED;
+  --m_in_flight;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool8_t ReplayScheduler::done() const noexcept
+{
+  return (m_records.size() >= m_num_sequences) && (0U == m_in_flight);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+uint64_t ReplayScheduler::num_sequences() const noexcept
+{
+  return m_num_sequences;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::size_t ReplayScheduler::frame_index(const uint64_t sequence) const noexcept
+{
+  return static_cast<std::size_t>((sequence - 1U) % m_config.num_frames);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+uint64_t ReplayScheduler::stamp_ns(const uint64_t sequence) const noexcept
+{
+  return sequence * static_cast<uint64_t>(m_config.period.count());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+uint64_t ReplayScheduler::sequence_of(const uint64_t stamp_ns) const noexcept
+{
+  const auto period_ns = static_cast<uint64_t>(m_config.period.count());
+  if (0U != (stamp_ns % period_ns)) {
+    return 0U;
+  }
+  const auto sequence = stamp_ns / period_ns;
+  return (sequence > m_num_sequences) ? 0U : sequence;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ReplayResult ReplayScheduler::result() const
+{
+  ReplayResult ret{};
+  std::vector<int64_t> latencies_ns;
+  uint64_t end_ns{m_start_ns};
+  for (const auto & record : m_records) {
+    end_ns = std::max(end_ns, record.publish_ns);
+    if (FrameState::COMPLETED == record.state) {
+      end_ns = std::max(end_ns, record.completion_ns);
+      latencies_ns.push_back(static_cast<int64_t>(record.completion_ns - record.publish_ns));
+    } else if (FrameState::LOST == record.state) {
+      ++ret.lost;
+    }
+  }
+  ret.published = m_records.size();
+  ret.completed = latencies_ns.size();
+  ret.duration = static_cast<float64_t>(end_ns - m_start_ns) * 1.0e-9;
+  if (ret.duration > 0.0) {
+    ret.throughput = static_cast<float64_t>(ret.completed) / ret.duration;
+  }
+  ret.latency = autoware::common::latency_tracing::compute_statistics(std::move(latencies_ns));
+  return ret;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ReplayScheduler::write_timing(std::ostream & stream) const
+{
+  stream << "sequence,frame,publish_ns,completion_ns,latency_ms\n";
+  for (std::size_t idx = 0U; idx < m_records.size(); ++idx) {
+    const auto & record = m_records[idx];
+    const auto sequence = static_cast<uint64_t>(idx) + 1U;
+    stream << sequence << "," << frame_index(sequence) << "," << record.publish_ns << ",";
+    if (FrameState::COMPLETED == record.state) {
+      stream << record.completion_ns << "," <<
+        (static_cast<float64_t>(record.completion_ns - record.publish_ns) * 1.0e-6);
+    } else {
+      stream << ",";
+    }
+    stream << "\n";
+  }
+}
+}  // namespace benchmark_tool
+}  // namespace tools
+}  // namespace autoware
@@ -0,0 +1,166 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <benchmark_tool/replay_player.hpp>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using autoware::tools::benchmark_tool::kKittiPointStep;
+using autoware::tools::benchmark_tool::load_kitti_point_clouds;
+using autoware::tools::benchmark_tool::parse_replay_mode;
+using autoware::tools::benchmark_tool::ReplayConfig;
+using autoware::tools::benchmark_tool::ReplayMode;
+using autoware::tools::benchmark_tool::ReplayScheduler;
+
+namespace
+{
+constexpr uint64_t kMs = 1000000U;
+
+void write_file(const std::string & path, const std::size_t size)
+{
+  std::ofstream file{path, std::ios::binary};
+  const std::vector<char> data(size, 'a');
+  (void)file.write(data.data(), static_cast<std::streamsize>(data.size()));
+}
+}  // namespace
+
+TEST(TestReplayPlayer, LoadKittiPointClouds)
+{
+  const auto folder = "/tmp/test_replay_player_" + std::to_string(::getpid());
+  ASSERT_EQ(::mkdir(folder.c_str(), 0700), 0);
+  write_file(folder + "/000001.bin", 2U * kKittiPointStep);
+  write_file(folder + "/000000.bin", 3U * kKittiPointStep);
+  write_file(folder + "/000000.txt", 1U);
+
+  const auto frames = load_kitti_point_clouds(folder);
+  ASSERT_EQ(frames.size(), 2U);
+  EXPECT_EQ(frames[0U].size(), 3U * kKittiPointStep);
+  EXPECT_EQ(frames[1U].size(), 2U * kKittiPointStep);
+  EXPECT_EQ(load_kitti_point_clouds(folder, 1U).size(), 1U);
+
+  write_file(folder + "/000002.bin", kKittiPointStep + 1U);
+  EXPECT_THROW(load_kitti_point_clouds(folder), std::runtime_error);
+
+  for (const auto name : {"000000.bin", "000001.bin", "000002.bin", "000000.txt"}) {
+    (void)std::remove((folder + "/" + name).c_str());
+  }
+  EXPECT_THROW(load_kitti_point_clouds(folder), std::runtime_error);
+  (void)::rmdir(folder.c_str());
+  EXPECT_THROW(load_kitti_point_clouds(folder), std::runtime_error);
+}
+
+TEST(TestReplayPlayer, BadConfig)
+{
+  EXPECT_EQ(parse_replay_mode("lockstep"), ReplayMode::LOCKSTEP);
+  EXPECT_EQ(parse_replay_mode("fixed_rate"), ReplayMode::FIXED_RATE);
+  EXPECT_THROW(parse_replay_mode("fast"), std::domain_error);
+
+  ReplayConfig config{};
+  EXPECT_THROW(ReplayScheduler{config}, std::domain_error);
+  config.num_frames = 1U;
+  config.max_in_flight = 0U;
+  EXPECT_THROW(ReplayScheduler{config}, std::domain_error);
+  config.max_in_flight = 1U;
+  config.period = std::chrono::nanoseconds{0};
+  EXPECT_THROW(ReplayScheduler{config}, std::domain_error);
+}
+
+TEST(TestReplayPlayer, Lockstep)
+{
+  ReplayConfig config{};
+  config.num_frames = 2U;
+  config.num_loops = 2U;
+  config.max_in_flight = 2U;
+  config.timeout = std::chrono::milliseconds{50};
+  ReplayScheduler scheduler{config};
+  EXPECT_EQ(scheduler.num_sequences(), 4U);
+
+  EXPECT_EQ(scheduler.next(0U), 1U);
+  EXPECT_EQ(scheduler.next(1U * kMs), 2U);
+  // Two frames are in flight
+  EXPECT_EQ(scheduler.next(2U * kMs), 0U);
+  EXPECT_TRUE(scheduler.complete(1U, 3U * kMs));
+  EXPECT_FALSE(scheduler.complete(1U, 3U * kMs));
+  EXPECT_EQ(scheduler.next(3U * kMs), 3U);
+  EXPECT_EQ(scheduler.frame_index(3U), 0U);
+  // Frame 2 times out and makes room for the last one, which is then completed
+  EXPECT_EQ(scheduler.next(52U * kMs), 4U);
+  EXPECT_FALSE(scheduler.complete(2U, 53U * kMs));
+  EXPECT_FALSE(scheduler.done());
+  EXPECT_TRUE(scheduler.complete(3U, 53U * kMs));
+  EXPECT_TRUE(scheduler.complete(4U, 70U * kMs));
+  EXPECT_EQ(scheduler.next(71U * kMs), 0U);
+  EXPECT_TRUE(scheduler.done());
+
+  const auto result = scheduler.result();
+  EXPECT_EQ(result.published, 4U);
+  EXPECT_EQ(result.completed, 3U);
+  EXPECT_EQ(result.lost, 1U);
+  EXPECT_DOUBLE_EQ(result.duration, 0.07);
+  EXPECT_NEAR(result.throughput, 3.0 / 0.07, 1.0e-9);
+  EXPECT_EQ(result.latency.count, 3U);
+  EXPECT_DOUBLE_EQ(result.latency.p50, 18.0);
+  EXPECT_DOUBLE_EQ(result.latency.max, 50.0);
+
+  std::stringstream timing;
+  scheduler.write_timing(timing);
+  std::string line;
+  std::vector<std::string> lines;
+  while (std::getline(timing, line)) {
+    lines.push_back(line);
+  }
+  ASSERT_EQ(lines.size(), 5U);
+  EXPECT_EQ(lines[1U], "1,0,0,3000000,3");
+  EXPECT_EQ(lines[2U], "2,1,1000000,,");
+}
+
+TEST(TestReplayPlayer, FixedRate)
+{
+  ReplayConfig config{};
+  config.mode = ReplayMode::FIXED_RATE;
+  config.num_frames = 3U;
+  config.period = std::chrono::milliseconds{10};
+  ReplayScheduler scheduler{config};
+
+  const auto start = 1000U * kMs;
+  EXPECT_EQ(scheduler.next(start), 1U);
+  EXPECT_EQ(scheduler.next(start + 5U * kMs), 0U);
+  // Frames don't wait for the completion of the previous ones
+  EXPECT_EQ(scheduler.next(start + 10U * kMs), 2U);
+  // Late frames are published right away
+  EXPECT_EQ(scheduler.next(start + 35U * kMs), 3U);
+  EXPECT_EQ(scheduler.next(start + 35U * kMs), 0U);
+
+  // The stamps are multiples of the period
+  EXPECT_EQ(scheduler.stamp_ns(2U), 20U * kMs);
+  EXPECT_EQ(scheduler.sequence_of(20U * kMs), 2U);
+  EXPECT_EQ(scheduler.sequence_of(21U * kMs), 0U);
+  EXPECT_EQ(scheduler.sequence_of(40U * kMs), 0U);
+  for (uint64_t sequence = 1U; sequence <= 3U; ++sequence) {
+    EXPECT_TRUE(scheduler.complete(sequence, start + 40U * kMs));
+  }
+  EXPECT_TRUE(scheduler.done());
+  EXPECT_DOUBLE_EQ(scheduler.result().latency.max, 40.0);
+}
@@ -0,0 +1,98 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief A native player that replays a dataset to the node under test as fast as it completes
+///        the frames or at a fixed rate
+
+#ifndef BENCHMARK_TOOL_NODES__REPLAY_PLAYER_NODE_HPP_
+#define BENCHMARK_TOOL_NODES__REPLAY_PLAYER_NODE_HPP_
+
+#include <benchmark_tool/replay_player.hpp>
+#include <benchmark_tool_nodes/visibility_control.hpp>
+#include <builtin_interfaces/msg/time.hpp>
+#include <common/types.hpp>
+#include <latency_tracing/tracer.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace autoware
+{
+namespace tools
+{
+namespace benchmark_tool_nodes
+{
+using autoware::common::types::bool8_t;
+
+/// \brief Replays the point clouds of a KITTI dataset from memory and measures how long the node
+///        under test takes to complete each of them.
+///
+/// All frames are loaded on construction. The clouds are published as unique pointers, so
+/// that a node under test in the same container with intra-process communication enabled gets
+/// them without a copy. The node under test completes a frame by publishing a message with the
+/// stamp of the cloud on the completion topic, which the player times as soon as it receives it.
+/// In lockstep mode, the completion releases the next frame right away, see
+/// benchmark_tool::ReplayMode.
+///
+/// When all frames are completed or lost, the player logs the throughput and the latencies and
+/// writes the times of each frame to the timing file, if any.
+class BENCHMARK_TOOL_NODES_PUBLIC ReplayPlayerNode : public rclcpp::Node
+{
+public:
+  /// \brief Constructor
+  /// \param[in] options The node options
+  /// \throw std::runtime_error If the dataset can't be loaded
+  /// \throw std::domain_error If a parameter is invalid
+  explicit ReplayPlayerNode(const rclcpp::NodeOptions & options);
+
+private:
+  using PointCloud2 = sensor_msgs::msg::PointCloud2;
+
+  /// Subscribe to the completion topic, for any message with a header
+  template<typename MsgT>
+  void create_completion_subscription(const std::string & topic);
+  void on_completion(const builtin_interfaces::msg::Time & stamp);
+  void on_timer();
+  /// Publish the frames that are due, the mutex must be held
+  void play();
+  /// Fill a message with the next frame, so that copying a frame doesn't count as latency
+  void stage_next_frame();
+  void finish();
+
+  std::vector<std::vector<uint8_t>> m_frames;
+  benchmark_tool::ReplayScheduler m_scheduler;
+  std::string m_frame_id;
+  std::size_t m_min_subscribers;
+  std::string m_timing_file;
+  std::unique_ptr<PointCloud2> m_staged_msg{};
+  uint64_t m_staged_sequence{0U};
+  bool8_t m_started{false};
+  bool8_t m_finished{false};
+  std::mutex m_mutex{};
+  autoware::common::latency_tracing::StageId m_trace_stage;
+  rclcpp::Publisher<PointCloud2>::SharedPtr m_publisher;
+  rclcpp::SubscriptionBase::SharedPtr m_completion_sub{};
+  rclcpp::TimerBase::SharedPtr m_timer;
+};
+}  // namespace benchmark_tool_nodes
+}  // namespace tools
+}  // namespace autoware
+
+#endif  // BENCHMARK_TOOL_NODES__REPLAY_PLAYER_NODE_HPP_
@@ -104,7 +104,8 @@ def launch_node(context, *args, **kwargs):
         ],
         parameters=[
             {'result_path': LaunchConfiguration('result_path')},
-            {'sampling_rate': 1}
+            {'sampling_rate': 1},
+            {'benchmarked_processes': LaunchConfiguration('sys_info_benchmarked_processes')}
         ],
         on_exit=[
             launch.actions.LogInfo(msg="sys_info exited")
@@ -249,6 +250,12 @@ def generate_launch_description():
             default_value='False',
             description='Record system metrics during the benchmark',
         ),
+        launch.actions.DeclareLaunchArgument(
+            'sys_info_benchmarked_processes',
+            default_value='benchmark_tool_nodes',
+            description='Comma separated parts of the command lines of the benchmarked '
+                        'processes, whose threads the system metrics are recorded for',
+        ),
         launch.actions.DeclareLaunchArgument(
             'cyclone_dds_info_record',
             default_value='False',
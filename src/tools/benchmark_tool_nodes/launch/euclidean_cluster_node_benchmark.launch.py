@@ -163,6 +163,8 @@ def generate_launch_description():
                 'rosbag_record_subfolder': LaunchConfiguration('rosbag_record_subfolder'),
                 'ros_info_record': LaunchConfiguration('ros_info_record'),
                 'sys_info_record': LaunchConfiguration('sys_info_record'),
+                'sys_info_benchmarked_processes':
+                    'ray_ground_classifier_cloud_node_exe,euclidean_cluster_node_exe',
                 'cyclone_dds_info_record': LaunchConfiguration('cyclone_dds_info_record'),
             }.items()
         )
@@ -241,6 +241,9 @@ def generate_launch_description():
                 'rosbag_record_subfolder': LaunchConfiguration('rosbag_record_subfolder'),
                 'ros_info_record': LaunchConfiguration('ros_info_record'),
                 'sys_info_record': LaunchConfiguration('sys_info_record'),
+                'sys_info_benchmarked_processes':
+                    'point_cloud_filter_transform_node_exe,voxel_grid_node_exe,'
+                    'p2d_ndt_localizer_exe',
                 'cyclone_dds_info_record': LaunchConfiguration('cyclone_dds_info_record'),
             }.items()
         )
@@ -121,6 +121,11 @@ def generate_launch_description():
             default_value='False',
             description='Record DDS metrics during the benchmark',
         ),
+        launch.actions.DeclareLaunchArgument(
+            'use_intra_process_comms',
+            default_value='False',
+            description='Pass the clouds between the benchmarked nodes without copying them',
+        ),
 
         # Nodes
 
@@ -135,7 +140,10 @@ def generate_launch_description():
                     plugin=('autoware::perception::filters::ray_ground_classifier_nodes'
                             '::RayGroundClassifierCloudNode'),
                     name='ray_ground_classifier_node',
-                    parameters=[configParamsRayGround, {"pcl_size": 210000}]
+                    parameters=[configParamsRayGround, {"pcl_size": 210000}],
+                    extra_arguments=[{
+                        'use_intra_process_comms': LaunchConfiguration('use_intra_process_comms')
+                    }]
                 ),
                 launch_ros.descriptions.ComposableNode(
                     package='euclidean_cluster_nodes',
@@ -143,7 +151,10 @@ def generate_launch_description():
                             '::EuclideanClusterNode'),
                     name='euclidean_cluster_node',
                     parameters=[configParamsEuclideanCluster, {"max_cloud_size": 210000}],
-                    remappings=[("points_in", "/points_nonground")]
+                    remappings=[("points_in", "/points_nonground")],
+                    extra_arguments=[{
+                        'use_intra_process_comms': LaunchConfiguration('use_intra_process_comms')
+                    }]
                 ),
             ],
             target_container='ray_euclidean_container'
@@ -171,6 +182,7 @@ def generate_launch_description():
                 'rosbag_record_subfolder': LaunchConfiguration('rosbag_record_subfolder'),
                 'ros_info_record': LaunchConfiguration('ros_info_record'),
                 'sys_info_record': LaunchConfiguration('sys_info_record'),
+                'sys_info_benchmarked_processes': 'ray_euclidean_container',
                 'cyclone_dds_info_record': LaunchConfiguration('cyclone_dds_info_record'),
             }.items()
         )
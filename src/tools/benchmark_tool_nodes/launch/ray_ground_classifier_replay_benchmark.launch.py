@@ -0,0 +1,119 @@
+# Copyright 2021 the Autoware Foundation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import os
+import launch
+import launch_ros.actions
+import launch_ros.descriptions
+import yaml
+from os.path import join as joinPath
+from launch.substitutions import LaunchConfiguration
+from ament_index_python.packages import get_package_share_directory
+
+
+def generate_launch_description():
+
+    # ray ground classifier parameter file definition.
+    vlp16_lexus_ray_ground_file_path = os.path.join(
+        get_package_share_directory('ray_ground_classifier_nodes'),
+        'param',
+        'vlp16_lexus.param.yaml')
+    with open(vlp16_lexus_ray_ground_file_path, 'r') as file:
+        configParamsRayGround = yaml.safe_load(file)['/**']['ros__parameters']
+
+    # replay player parameter file definition.
+    replay_player_file_path = os.path.join(
+        get_package_share_directory('benchmark_tool_nodes'),
+        'param',
+        'replay_player.param.yaml')
+    with open(replay_player_file_path, 'r') as file:
+        configParamsReplayPlayer = yaml.safe_load(file)['/**']['ros__parameters']
+
+    return launch.LaunchDescription([
+
+        # replay player arguments
+
+        launch.actions.DeclareLaunchArgument(
+            'dataset_path',
+            default_value=joinPath(os.environ['HOME'], 'kitti_data', '3d_bench'),
+            description='Path of the dataset in the system',
+        ),
+        launch.actions.DeclareLaunchArgument(
+            'mode',
+            default_value='lockstep',
+            description='lockstep to measure the maximum throughput, fixed_rate to measure '
+                        'the latency under the load of period_ms',
+        ),
+        launch.actions.DeclareLaunchArgument(
+            'period_ms',
+            default_value='100',
+            description='The period of the frames in fixed_rate mode',
+        ),
+        launch.actions.DeclareLaunchArgument(
+            'max_frames',
+            default_value='0',
+            description='Limit the number of played frames, 0 to play all of them',
+        ),
+        launch.actions.DeclareLaunchArgument(
+            'timing_file',
+            default_value=joinPath(os.environ['HOME'], 'benchmark_result', 'replay_timing.csv'),
+            description='The CSV file with the times of each frame',
+        ),
+        launch.actions.DeclareLaunchArgument(
+            'use_intra_process_comms',
+            default_value='True',
+            description='Pass the clouds to the benchmarked node without copying them',
+        ),
+
+        # Nodes
+
+        launch_ros.actions.ComposableNodeContainer(
+           package='rclcpp_components', executable='component_container',
+           name='ray_ground_replay_container', namespace=''
+        ),
+        launch_ros.actions.LoadComposableNodes(
+            composable_node_descriptions=[
+                launch_ros.descriptions.ComposableNode(
+                    package='ray_ground_classifier_nodes',
+                    plugin=('autoware::perception::filters::ray_ground_classifier_nodes'
+                            '::RayGroundClassifierCloudNode'),
+                    name='ray_ground_classifier_node',
+                    parameters=[configParamsRayGround, {"pcl_size": 210000}],
+                    extra_arguments=[{
+                        'use_intra_process_comms': LaunchConfiguration('use_intra_process_comms')
+                    }]
+                ),
+                launch_ros.descriptions.ComposableNode(
+                    package='benchmark_tool_nodes',
+                    plugin='autoware::tools::benchmark_tool_nodes::ReplayPlayerNode',
+                    name='replay_player_node',
+                    parameters=[
+                        configParamsReplayPlayer,
+                        {
+                            'point_cloud_path': [LaunchConfiguration('dataset_path'),
+                                                 '/training/velodyne'],
+                            'mode': LaunchConfiguration('mode'),
+                            'period_ms': LaunchConfiguration('period_ms'),
+                            'max_frames': LaunchConfiguration('max_frames'),
+                            'timing_file': LaunchConfiguration('timing_file'),
+                        }
+                    ],
+                    extra_arguments=[{
+                        'use_intra_process_comms': LaunchConfiguration('use_intra_process_comms')
+                    }]
+                ),
+            ],
+            target_container='ray_ground_replay_container'
+        ),
+    ])
@@ -14,8 +14,12 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+import os
+import time
 import rclpy
-from benchmark_tool.utility import getParameter, error
+from benchmark_tool.metric.resource_usage_metric import ResourceUsageMetric
+from benchmark_tool.utility import getParameter, error, info, warning
+from benchmark_tool.utility.perf_event import HARDWARE_COUNTERS, ThreadCounters
 try:
     import psutil
 except ImportError:
@@ -37,6 +41,18 @@ data = {
 result_path = ''
 sampling_rate = 1
 
+# Per-thread resource usage of the benchmark-related and benchmarked processes
+benchmarked_processes = []
+profiled_processes = {}
+# The processes that aren't profiled, starting with this one and its launcher
+ignored_pids = set([os.getpid(), os.getppid()])
+thread_counters = {}
+hardware_counters = True
+RESOURCE_USAGE_COLUMNS = [
+    'monotonic_ns', 'pid', 'tid', 'node', 'thread', 'user_s', 'system_s',
+    'voluntary_ctx_switches', 'involuntary_ctx_switches'
+] + [name for name, _ in HARDWARE_COUNTERS]
+
 
 def get_processes():
     for p in psutil.process_iter():
@@ -72,6 +88,101 @@ def write_stats():
         f.write(delimiter.join(sections) + '\n')
 
 
+def is_profiled(cmdline):
+    for s in cmdline:
+        if 'benchmark_tool_nodes' in s:
+            return True
+        for name in benchmarked_processes:
+            if name in s:
+                return True
+    return False
+
+
+def node_name(p):
+    # Attribute the process to its ROS node, if it has a single one
+    cmdline = p.cmdline()
+    for s in cmdline:
+        if s.startswith('__node:='):
+            return s[len('__node:='):]
+    name = p.name()
+    if 'python' in name and len(cmdline) > 1:
+        name += '(' + cmdline[1].split('/')[-1] + ')'
+    return name
+
+
+def update_profiled_processes():
+    # Unlike for sys_info.txt, processes that start later are picked up as well
+    for p in psutil.process_iter():
+        if p.pid in profiled_processes or p.pid in ignored_pids:
+            continue
+        try:
+            if is_profiled(p.cmdline()):
+                profiled_processes[p.pid] = (p, node_name(p))
+            else:
+                ignored_pids.add(p.pid)
+        except (psutil.NoSuchProcess, psutil.AccessDenied):
+            ignored_pids.add(p.pid)
+
+
+def read_thread_status(pid, tid):
+    task_path = '/proc/%d/task/%d/' % (pid, tid)
+    with open(task_path + 'comm', 'r') as f:
+        thread_name = f.read().strip()
+    switches = {}
+    with open(task_path + 'status', 'r') as f:
+        for line in f:
+            key, _, value = line.partition(':')
+            if key in ('voluntary_ctxt_switches', 'nonvoluntary_ctxt_switches'):
+                switches[key] = int(value)
+    return (thread_name, switches.get('voluntary_ctxt_switches', 0),
+            switches.get('nonvoluntary_ctxt_switches', 0))
+
+
+def read_thread_counters(node, tid):
+    global hardware_counters
+    if not hardware_counters:
+        return {}
+    if tid not in thread_counters:
+        try:
+            thread_counters[tid] = ThreadCounters(tid)
+        except OSError as e:
+            # Typically perf_event_paranoid or a virtual machine without a PMU
+            warning(node, "Hardware counters disabled: %s" % str(e))
+            hardware_counters = False
+            return {}
+    return thread_counters[tid].read()
+
+
+def write_resource_usage(node):
+    update_profiled_processes()
+    now_ns = time.monotonic_ns()
+    rows = []
+    seen_threads = set()
+    for pid, (p, name) in list(profiled_processes.items()):
+        try:
+            threads = p.threads()
+        except psutil.NoSuchProcess:
+            del profiled_processes[pid]
+            continue
+        for t in threads:
+            try:
+                thread_name, voluntary, involuntary = read_thread_status(pid, t.id)
+                counters = read_thread_counters(node, t.id)
+            except (IOError, OSError):
+                # The thread exited in the meantime
+                continue
+            seen_threads.add(t.id)
+            rows.append([now_ns, pid, t.id, name, thread_name, t.user_time, t.system_time,
+                         voluntary, involuntary] +
+                        [counters.get(counter, '') for counter, _ in HARDWARE_COUNTERS])
+    for tid in list(thread_counters):
+        if tid not in seen_threads:
+            thread_counters.pop(tid).close()
+    with open(os.path.join(result_path, ResourceUsageMetric.DEFAULT_RESULTS_FILE), 'a') as f:
+        for row in rows:
+            f.write(','.join([str(x) for x in row]) + '\n')
+
+
 def main(args=None):
     rclpy.init(args=args)
     node = rclpy.create_node("sys_info")
@@ -79,13 +190,19 @@ def main(args=None):
         namespace='',
         parameters=[
             ('result_path', None),
-            ('sampling_rate', None)
+            ('sampling_rate', None),
+            ('benchmarked_processes', ''),
+            ('hardware_counters', True)
         ]
     )
-    global result_path, sampling_rate
+    global result_path, sampling_rate, benchmarked_processes, hardware_counters
     result_path = getParameter(node, "result_path")
     sampling_rate = getParameter(node, "sampling_rate")
     assert(sampling_rate > 0)
+    # Comma separated parts of the command lines of the benchmarked nodes, e.g. their executables
+    benchmarked_processes = [
+        x.strip() for x in getParameter(node, "benchmarked_processes").split(',') if x.strip()]
+    hardware_counters = getParameter(node, "hardware_counters")
 
     get_processes()
     names = []
@@ -107,7 +224,12 @@ def main(args=None):
     with open(result_path + '/sys_info.txt', 'w') as f:
         f.write(delimiter.join(sections) + '\n')
 
+    with open(os.path.join(result_path, ResourceUsageMetric.DEFAULT_RESULTS_FILE), 'w') as f:
+        f.write(','.join(RESOURCE_USAGE_COLUMNS) + '\n')
+    info(node, "Recording the resource usage of: %s" % ', '.join(benchmarked_processes))
+
     node.create_timer(1 / sampling_rate, write_stats)
+    node.create_timer(1 / sampling_rate, lambda: write_resource_usage(node))
     while rclpy.ok():
         rclpy.spin_once(node)
 
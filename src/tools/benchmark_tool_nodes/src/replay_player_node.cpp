@@ -0,0 +1,225 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "benchmark_tool_nodes/replay_player_node.hpp"
+
+#include <autoware_auto_msgs/msg/bounding_box_array.hpp>
+#include <autoware_auto_msgs/msg/detected_objects.hpp>
+#include <rclcpp_components/register_node_macro.hpp>
+#include <sensor_msgs/msg/point_field.hpp>
+
+#include <chrono>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace autoware
+{
+namespace tools
+{
+namespace benchmark_tool_nodes
+{
+namespace
+{
+using autoware::common::latency_tracing::to_trace_id;
+using autoware::common::latency_tracing::TraceScope;
+using autoware::common::latency_tracing::Tracer;
+
+/// The period at which the player checks for subscribers, timeouts and due frames
+constexpr std::chrono::milliseconds kPollPeriod{1};
+constexpr uint64_t kNanosecondsPerSecond{1000000000U};
+
+std::size_t declare_size(
+  rclcpp::Node & node, const std::string & name,
+  const int64_t default_value)
+{
+  const auto value = node.declare_parameter(name, default_value);
+  if (value < 0) {
+    throw std::domain_error{"ReplayPlayerNode: " + name + " must not be negative"};
+  }
+  return static_cast<std::size_t>(value);
+}
+
+benchmark_tool::ReplayConfig declare_config(rclcpp::Node & node, const std::size_t num_frames)
+{
+  benchmark_tool::ReplayConfig ret{};
+  ret.mode = benchmark_tool::parse_replay_mode(
+    node.declare_parameter("mode", std::string{"lockstep"}));
+  ret.num_frames = num_frames;
+  ret.num_loops = declare_size(node, "num_loops", 1);
+  ret.max_in_flight = declare_size(node, "max_in_flight", 1);
+  ret.period = std::chrono::milliseconds{node.declare_parameter("period_ms", int64_t{100})};
+  ret.timeout = std::chrono::milliseconds{node.declare_parameter("timeout_ms", int64_t{10000})};
+  return ret;
+}
+
+sensor_msgs::msg::PointField make_field(const std::string & name, const uint32_t offset)
+{
+  sensor_msgs::msg::PointField ret{};
+  ret.name = name;
+  ret.offset = offset;
+  ret.datatype = sensor_msgs::msg::PointField::FLOAT32;
+  ret.count = 1U;
+  return ret;
+}
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+ReplayPlayerNode::ReplayPlayerNode(const rclcpp::NodeOptions & options)
+: Node{"replay_player_node", options},
+  m_frames{benchmark_tool::load_kitti_point_clouds(
+      declare_parameter("point_cloud_path", std::string{}),
+      declare_size(*this, "max_frames", 0))},
+  m_scheduler{declare_config(*this, m_frames.size())},
+  m_frame_id{declare_parameter("frame_id", std::string{"base_link"})},
+  m_min_subscribers{declare_size(*this, "min_subscribers", 1)},
+  m_timing_file{declare_parameter("timing_file", std::string{})},
+  m_trace_stage{Tracer::instance().register_stage(get_fully_qualified_name())},
+  m_publisher{create_publisher<PointCloud2>(
+      declare_parameter("input_topic", std::string{"/points_in"}), rclcpp::QoS{1})}
+{
+  const auto completion_topic =
+    declare_parameter("completion_topic", std::string{"/points_nonground"});
+  const auto completion_type =
+    declare_parameter("completion_msg_type", std::string{"sensor_msgs/msg/PointCloud2"});
+  if ("sensor_msgs/msg/PointCloud2" == completion_type) {
+    create_completion_subscription<PointCloud2>(completion_topic);
+  } else if ("autoware_auto_msgs/msg/BoundingBoxArray" == completion_type) {
+    create_completion_subscription<autoware_auto_msgs::msg::BoundingBoxArray>(completion_topic);
+  } else if ("autoware_auto_msgs/msg/DetectedObjects" == completion_type) {
+    create_completion_subscription<autoware_auto_msgs::msg::DetectedObjects>(completion_topic);
+  } else {
+    throw std::domain_error{"ReplayPlayerNode: unsupported completion_msg_type " +
+            completion_type};
+  }
+  stage_next_frame();
+  m_timer = create_wall_timer(kPollPeriod, [this]() {on_timer();});
+  RCLCPP_INFO(
+    get_logger(), "Loaded %zu frames, waiting for %zu subscribers",
+    m_frames.size(), m_min_subscribers);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+template<typename MsgT>
+void ReplayPlayerNode::create_completion_subscription(const std::string & topic)
+{
+  m_completion_sub = create_subscription<MsgT>(
+    topic, rclcpp::QoS{rclcpp::KeepAll{}},
+    [this](const typename MsgT::SharedPtr msg) {on_completion(msg->header.stamp);});
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ReplayPlayerNode::on_completion(const builtin_interfaces::msg::Time & stamp)
+{
+  // Time the completion before anything else
+  const auto now_ns = Tracer::now_ns();
+  std::lock_guard<std::mutex> lock{m_mutex};
+  const auto sequence = m_scheduler.sequence_of(to_trace_id(stamp));
+  if (!m_scheduler.complete(sequence, now_ns)) {
+    RCLCPP_WARN(
+      get_logger(), "Ignoring a completion of %d.%09u, which isn't a frame in flight",
+      stamp.sec, stamp.nanosec);
+    return;
+  }
+  play();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ReplayPlayerNode::on_timer()
+{
+  std::lock_guard<std::mutex> lock{m_mutex};
+  if (!m_started) {
+    if (m_publisher->get_subscription_count() < m_min_subscribers) {
+      return;
+    }
+    RCLCPP_INFO(get_logger(), "Starting the replay");
+    m_started = true;
+  }
+  play();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ReplayPlayerNode::play()
+{
+  if (!m_started || m_finished) {
+    return;
+  }
+  // The frame of a sequence number that the scheduler hands out is always the staged one
+  for (auto sequence = m_scheduler.next(Tracer::now_ns()); 0U != sequence;
+    sequence = m_scheduler.next(Tracer::now_ns()))
+  {
+    const auto stamp_ns = m_scheduler.stamp_ns(sequence);
+    m_staged_msg->header.stamp.sec = static_cast<int32_t>(stamp_ns / kNanosecondsPerSecond);
+    m_staged_msg->header.stamp.nanosec = static_cast<uint32_t>(stamp_ns % kNanosecondsPerSecond);
+    {
+      TraceScope trace{Tracer::instance(), m_trace_stage};
+      trace.set_trace_id(stamp_ns);
+      m_publisher->publish(std::move(m_staged_msg));
+    }
+    stage_next_frame();
+  }
+  if (m_scheduler.done()) {
+    finish();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ReplayPlayerNode::stage_next_frame()
+{
+  const auto sequence = m_staged_sequence + 1U;
+  if (sequence > m_scheduler.num_sequences()) {
+    return;
+  }
+  const auto & frame = m_frames[m_scheduler.frame_index(sequence)];
+  auto msg = std::make_unique<PointCloud2>();
+  msg->header.frame_id = m_frame_id;
+  msg->height = 1U;
+  msg->width = static_cast<uint32_t>(frame.size() / benchmark_tool::kKittiPointStep);
+  msg->fields = {make_field("x", 0U), make_field("y", 4U), make_field("z", 8U),
+    make_field("intensity", 12U)};
+  msg->is_bigendian = false;
+  msg->point_step = static_cast<uint32_t>(benchmark_tool::kKittiPointStep);
+  msg->row_step = msg->width * msg->point_step;
+  msg->is_dense = false;
+  msg->data = frame;
+  m_staged_msg = std::move(msg);
+  m_staged_sequence = sequence;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ReplayPlayerNode::finish()
+{
+  m_finished = true;
+  m_timer->cancel();
+  const auto result = m_scheduler.result();
+  RCLCPP_INFO(
+    get_logger(), "Replayed %zu frames in %.3f s: %zu completed, %zu lost, %.2f frames/s",
+    result.published, result.duration, result.completed, result.lost, result.throughput);
+  RCLCPP_INFO(
+    get_logger(), "Latency [ms]: mean %.3f, p50 %.3f, p99 %.3f, max %.3f",
+    result.latency.mean, result.latency.p50, result.latency.p99, result.latency.max);
+  if (!m_timing_file.empty()) {
+    std::ofstream file{m_timing_file};
+    m_scheduler.write_timing(file);
+    if (!file) {
+      RCLCPP_ERROR(get_logger(), "Failed to write %s", m_timing_file.c_str());
+    }
+  }
+}
+}  // namespace benchmark_tool_nodes
+}  // namespace tools
+}  // namespace autoware
+
+RCLCPP_COMPONENTS_REGISTER_NODE(autoware::tools::benchmark_tool_nodes::ReplayPlayerNode)
@@ -0,0 +1,115 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief Writing of black box snapshots to rosbag2 bags in the background
+
+#ifndef BLACK_BOX_RECORDER__BAG_DUMPER_HPP_
+#define BLACK_BOX_RECORDER__BAG_DUMPER_HPP_
+
+#include <black_box_recorder/topic_recorder.hpp>
+#include <black_box_recorder/visibility_control.hpp>
+#include <common/types.hpp>
+#include <rclcpp/rclcpp.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace autoware
+{
+namespace tools
+{
+namespace black_box_recorder
+{
+using autoware::common::types::bool8_t;
+
+/// \brief The messages of one topic in a dump
+struct BLACK_BOX_RECORDER_PUBLIC TopicSnapshot
+{
+  /// The recorder of the topic, which serializes the messages. It must outlive the dumper
+  const TopicRecorder * recorder;
+  std::vector<RecordedMessage> messages;
+};
+
+/// \brief The messages of all topics at a trigger
+struct BLACK_BOX_RECORDER_PUBLIC Dump
+{
+  /// Why the dump was taken, it is logged
+  std::string reason;
+  std::vector<TopicSnapshot> topics;
+};
+
+/// \brief Where and how the dumps are written
+struct BLACK_BOX_RECORDER_PUBLIC BagDumperConfig
+{
+  /// The directory of the bags, each dump is a bag black_box_<date>_<time>_<n> in it
+  std::string directory;
+  /// The rosbag2 storage plugin, e.g. sqlite3
+  std::string storage_id;
+  /// The number of dumps that may wait for the writing thread, more are dropped
+  std::size_t max_pending_dumps;
+  /// The CPUs the writing thread runs on, empty for any, e.g. to keep it off the cores of the
+  /// real-time threads
+  std::vector<std::size_t> cpus;
+};
+
+/// \brief Serializes the dumps and writes them to bags on a background thread, so that the
+///        callbacks that trigger a dump only copy the pointers to the messages
+class BLACK_BOX_RECORDER_PUBLIC BagDumper
+{
+public:
+  /// \brief Constructor, starts the writing thread
+  /// \param[in] config Where and how the dumps are written
+  /// \param[in] logger The logger that the written and failed dumps are reported to
+  /// \throw std::domain_error If the directory is empty or no dump may be pending
+  BagDumper(const BagDumperConfig & config, const rclcpp::Logger & logger);
+
+  /// \brief Destructor, writes the pending dumps and stops the thread
+  ~BagDumper();
+
+  BagDumper(const BagDumper &) = delete;
+  BagDumper & operator=(const BagDumper &) = delete;
+
+  /// \brief Queue a dump for writing
+  /// \param[in] dump The dump
+  /// \return False if the dump was dropped, because too many are pending
+  bool8_t enqueue(Dump && dump);
+
+  /// \brief The number of dumps that were written
+  std::size_t num_written() const;
+
+private:
+  void run();
+  void write(const Dump & dump, const std::string & uri) const;
+
+  BagDumperConfig m_config;
+  rclcpp::Logger m_logger;
+  /// Guards the queue, the stop flag and the count
+  mutable std::mutex m_mutex;
+  std::condition_variable m_condition{};
+  std::deque<Dump> m_pending{};
+  bool8_t m_stop{false};
+  std::size_t m_num_written{0U};
+  std::thread m_thread{};
+};
+}  // namespace black_box_recorder
+}  // namespace tools
+}  // namespace autoware
+
+#endif  // BLACK_BOX_RECORDER__BAG_DUMPER_HPP_
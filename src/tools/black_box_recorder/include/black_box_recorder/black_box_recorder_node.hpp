@@ -0,0 +1,80 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief This file defines the BlackBoxRecorderNode class.
+
+#ifndef BLACK_BOX_RECORDER__BLACK_BOX_RECORDER_NODE_HPP_
+#define BLACK_BOX_RECORDER__BLACK_BOX_RECORDER_NODE_HPP_
+
+#include <black_box_recorder/bag_dumper.hpp>
+#include <black_box_recorder/dump_trigger.hpp>
+#include <black_box_recorder/topic_recorder.hpp>
+#include <black_box_recorder/visibility_control.hpp>
+#include <common/types.hpp>
+#include <diagnostic_msgs/msg/diagnostic_array.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <std_srvs/srv/trigger.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace autoware
+{
+namespace tools
+{
+namespace black_box_recorder
+{
+/// \class BlackBoxRecorderNode
+/// \brief ROS 2 Node that keeps the last seconds of a set of topics in memory and writes them
+///        to a bag only when a fault is reported on the diagnostics or the dump service is
+///        called. It is meant to run in the container of the recorded nodes, so that the
+///        messages are shared with them rather than copied.
+class BLACK_BOX_RECORDER_PUBLIC BlackBoxRecorderNode : public rclcpp::Node
+{
+public:
+  /// \brief Constructor, subscribes to the recorded topics and the diagnostics
+  /// \throws std::domain_error If a parameter is invalid or a topic type isn't supported
+  explicit BlackBoxRecorderNode(const rclcpp::NodeOptions & options);
+
+  /// \brief Take the messages of the window ending now and queue them for writing
+  /// \param[in] reason Why the dump is taken, it is logged
+  /// \return False if the dump was dropped, because too many are waiting to be written
+  bool8_t dump(const std::string & reason);
+
+private:
+  using DiagnosticArray = diagnostic_msgs::msg::DiagnosticArray;
+  using Trigger = std_srvs::srv::Trigger;
+
+  void BLACK_BOX_RECORDER_LOCAL on_diagnostics(const DiagnosticArray::ConstSharedPtr msg);
+  void BLACK_BOX_RECORDER_LOCAL on_dump_request(
+    const std::shared_ptr<Trigger::Request> request,
+    std::shared_ptr<Trigger::Response> response);
+
+  /// The length of the recorded window
+  const int64_t m_window_ns;
+  std::vector<std::unique_ptr<TopicRecorder>> m_recorders{};
+  DumpTrigger m_trigger;
+  /// Declared after the recorders, the writing thread serializes with them until it is stopped
+  std::unique_ptr<BagDumper> m_dumper{};
+  rclcpp::Subscription<DiagnosticArray>::SharedPtr m_diagnostics_sub{};
+  rclcpp::Service<Trigger>::SharedPtr m_dump_service{};
+};
+}  // namespace black_box_recorder
+}  // namespace tools
+}  // namespace autoware
+
+#endif  // BLACK_BOX_RECORDER__BLACK_BOX_RECORDER_NODE_HPP_
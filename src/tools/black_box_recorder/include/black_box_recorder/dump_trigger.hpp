@@ -0,0 +1,78 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief The decision to dump the black box on a fault reported on the diagnostics
+
+#ifndef BLACK_BOX_RECORDER__DUMP_TRIGGER_HPP_
+#define BLACK_BOX_RECORDER__DUMP_TRIGGER_HPP_
+
+#include <black_box_recorder/visibility_control.hpp>
+#include <common/types.hpp>
+#include <diagnostic_msgs/msg/diagnostic_array.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace autoware
+{
+namespace tools
+{
+namespace black_box_recorder
+{
+using autoware::common::types::bool8_t;
+
+/// \brief Which faults trigger a dump
+struct BLACK_BOX_RECORDER_PUBLIC DumpTriggerConfig
+{
+  /// The lowest level of a status that triggers, WARN or ERROR. STALE statuses never trigger
+  uint8_t min_level{diagnostic_msgs::msg::DiagnosticStatus::ERROR};
+  /// Only statuses whose name starts with one of these trigger, all of them if it is empty
+  std::vector<std::string> name_prefixes{};
+  /// Faults within this time after a triggered dump don't trigger another one
+  int64_t holdoff_ns{0};
+};
+
+/// \brief Decides whether the statuses on the diagnostics topic, e.g. the faults of the vehicle
+///        interface, trigger a dump
+class BLACK_BOX_RECORDER_PUBLIC DumpTrigger
+{
+public:
+  /// \brief Constructor
+  /// \param[in] config The faults that trigger
+  /// \throw std::domain_error If the level isn't WARN or ERROR or the holdoff is negative
+  explicit DumpTrigger(const DumpTriggerConfig & config);
+
+  /// \brief Check diagnostics for a fault that triggers a dump
+  /// \param[in] diagnostics The received diagnostics
+  /// \param[in] now_ns The time they were received at
+  /// \param[out] reason The name and the message of the first triggering status, if any
+  /// \return Whether to dump, the holdoff starts if so
+  bool8_t check(
+    const diagnostic_msgs::msg::DiagnosticArray & diagnostics, int64_t now_ns,
+    std::string & reason);
+
+private:
+  bool8_t matches(const diagnostic_msgs::msg::DiagnosticStatus & status) const;
+
+  DumpTriggerConfig m_config;
+  int64_t m_last_trigger_ns{std::numeric_limits<int64_t>::min()};
+};
+}  // namespace black_box_recorder
+}  // namespace tools
+}  // namespace autoware
+
+#endif  // BLACK_BOX_RECORDER__DUMP_TRIGGER_HPP_
@@ -0,0 +1,130 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief A ring of the latest messages of a topic within a time window
+
+#ifndef BLACK_BOX_RECORDER__MESSAGE_RING_HPP_
+#define BLACK_BOX_RECORDER__MESSAGE_RING_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace autoware
+{
+namespace tools
+{
+namespace black_box_recorder
+{
+/// \brief Keeps the messages received in the last window, up to a fixed number of them. The
+///        slots are allocated on construction, so pushing doesn't allocate; with shared
+///        pointers as messages, the messages themselves are shared with the other subscribers
+/// \tparam MessageT The type of the stored messages, e.g. a shared pointer to const
+template<typename MessageT>
+class MessageRing
+{
+public:
+  /// \brief A message and the time it was received at
+  struct Entry
+  {
+    int64_t stamp_ns;
+    MessageT message;
+  };
+
+  /// \brief Constructor
+  /// \param[in] capacity The maximum number of messages, the oldest one is dropped when full
+  /// \param[in] window_ns The messages older than this with respect to the latest one are dropped
+  /// \throw std::domain_error If the capacity or the window isn't positive
+  MessageRing(const std::size_t capacity, const int64_t window_ns)
+  : m_entries(capacity),
+    m_window_ns{window_ns}
+  {
+    if (capacity == 0U) {
+      throw std::domain_error{"MessageRing: capacity must be positive"};
+    }
+    if (window_ns <= 0) {
+      throw std::domain_error{"MessageRing: window must be positive"};
+    }
+  }
+
+  /// \brief Add a message, dropping the ones that are out of the window or don't fit
+  /// \param[in] stamp_ns The time the message was received at, not older than the last one
+  /// \param[in] message The message
+  void push(const int64_t stamp_ns, MessageT message)
+  {
+    drop_older_than(stamp_ns - m_window_ns);
+    if (m_size == m_entries.size()) {
+      pop();
+    }
+    auto & entry = m_entries[(m_first + m_size) % m_entries.size()];
+    entry.stamp_ns = stamp_ns;
+    entry.message = std::move(message);
+    ++m_size;
+  }
+
+  /// \brief Copy the messages of the window ending at a time, oldest first
+  /// \param[in] now_ns The end of the window, e.g. the time of a trigger
+  /// \param[out] entries The messages are appended to it
+  void snapshot(const int64_t now_ns, std::vector<Entry> & entries) const
+  {
+    for (std::size_t i = 0U; i < m_size; ++i) {
+      const auto & entry = m_entries[(m_first + i) % m_entries.size()];
+      if ((entry.stamp_ns >= (now_ns - m_window_ns)) && (entry.stamp_ns <= now_ns)) {
+        entries.push_back(entry);
+      }
+    }
+  }
+
+  /// \brief Drop all messages
+  void clear()
+  {
+    while (m_size > 0U) {
+      pop();
+    }
+  }
+
+  /// \brief The number of stored messages
+  std::size_t size() const noexcept {return m_size;}
+  /// \brief The maximum number of stored messages
+  std::size_t capacity() const noexcept {return m_entries.size();}
+
+private:
+  void drop_older_than(const int64_t stamp_ns)
+  {
+    while ((m_size > 0U) && (m_entries[m_first].stamp_ns < stamp_ns)) {
+      pop();
+    }
+  }
+
+  /// Drop the oldest message, releasing it right away
+  void pop()
+  {
+    m_entries[m_first].message = MessageT{};
+    m_first = (m_first + 1U) % m_entries.size();
+    --m_size;
+  }
+
+  std::vector<Entry> m_entries;
+  int64_t m_window_ns;
+  std::size_t m_first{0U};
+  std::size_t m_size{0U};
+};
+}  // namespace black_box_recorder
+}  // namespace tools
+}  // namespace autoware
+
+#endif  // BLACK_BOX_RECORDER__MESSAGE_RING_HPP_
@@ -0,0 +1,160 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief The subscription of a recorded topic and its ring of messages
+
+#ifndef BLACK_BOX_RECORDER__TOPIC_RECORDER_HPP_
+#define BLACK_BOX_RECORDER__TOPIC_RECORDER_HPP_
+
+#include <black_box_recorder/message_ring.hpp>
+#include <black_box_recorder/visibility_control.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <rclcpp/serialization.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace autoware
+{
+namespace tools
+{
+namespace black_box_recorder
+{
+/// \brief A message in a snapshot of a TopicRecorder, whose type only the recorder knows
+struct BLACK_BOX_RECORDER_PUBLIC RecordedMessage
+{
+  /// The time the message was received at
+  int64_t stamp_ns;
+  std::shared_ptr<const void> message;
+};
+
+/// \brief How much of a topic is recorded
+struct BLACK_BOX_RECORDER_PUBLIC TopicRecorderConfig
+{
+  /// The maximum number of kept messages
+  std::size_t capacity;
+  /// Messages older than this are dropped
+  int64_t window_ns;
+};
+
+/// \brief Keeps the latest messages of a topic in a MessageRing. The messages are kept as they
+///        were received, serializing them is left to the dump
+class BLACK_BOX_RECORDER_PUBLIC TopicRecorder
+{
+public:
+  virtual ~TopicRecorder() = default;
+
+  TopicRecorder(const TopicRecorder &) = delete;
+  TopicRecorder & operator=(const TopicRecorder &) = delete;
+
+  /// \brief The recorded topic
+  const std::string & topic() const noexcept;
+  /// \brief The type of the topic, e.g. sensor_msgs/msg/PointCloud2
+  const std::string & type() const noexcept;
+
+  /// \brief Get the messages of the window ending at a time
+  /// \param[in] now_ns The end of the window
+  /// \param[out] messages The messages are appended to it, oldest first
+  virtual void snapshot(int64_t now_ns, std::vector<RecordedMessage> & messages) const = 0;
+
+  /// \brief Serialize a message of a snapshot of this recorder
+  /// \param[in] message The message
+  /// \param[out] serialized The CDR serialized message
+  void serialize(const RecordedMessage & message, rclcpp::SerializedMessage & serialized) const;
+
+protected:
+  TopicRecorder(
+    const std::string & topic, const std::string & type,
+    std::unique_ptr<rclcpp::SerializationBase> serialization);
+
+private:
+  std::string m_topic;
+  std::string m_type;
+  std::unique_ptr<rclcpp::SerializationBase> m_serialization;
+};
+
+/// \brief Records a topic of a known message type. The subscription is best effort, so that it
+///        matches any publisher and never holds one back, and takes the messages as shared
+///        pointers to const, so that with intra-process communication they aren't copied
+/// \tparam MessageT The message type of the topic
+template<typename MessageT>
+class TypedTopicRecorder : public TopicRecorder
+{
+public:
+  /// \brief Constructor, subscribes to the topic
+  /// \param[in] node The node to subscribe with, it stamps the messages with its clock
+  /// \param[in] topic The topic
+  /// \param[in] type The name of the type of the topic
+  /// \param[in] config How much to keep
+  /// \throw std::domain_error If the capacity or the window isn't positive
+  TypedTopicRecorder(
+    rclcpp::Node & node, const std::string & topic, const std::string & type,
+    const TopicRecorderConfig & config)
+  : TopicRecorder{topic, type, std::make_unique<rclcpp::Serialization<MessageT>>()},
+    m_clock{node.get_clock()},
+    m_ring{config.capacity, config.window_ns}
+  {
+    m_subscription = node.create_subscription<MessageT>(
+      topic, rclcpp::SensorDataQoS{},
+      [this](const typename MessageT::ConstSharedPtr msg) {
+        const auto stamp_ns = m_clock->now().nanoseconds();
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_ring.push(stamp_ns, msg);
+      });
+  }
+
+  void snapshot(const int64_t now_ns, std::vector<RecordedMessage> & messages) const override
+  {
+    std::vector<typename Ring::Entry> entries;
+    {
+      std::lock_guard<std::mutex> lock{m_mutex};
+      entries.reserve(m_ring.size());
+      m_ring.snapshot(now_ns, entries);
+    }
+    for (auto & entry : entries) {
+      messages.push_back(RecordedMessage{entry.stamp_ns, std::move(entry.message)});
+    }
+  }
+
+private:
+  using Ring = MessageRing<typename MessageT::ConstSharedPtr>;
+
+  rclcpp::Clock::SharedPtr m_clock;
+  /// Guards the ring, the callbacks and the snapshots may run on different threads
+  mutable std::mutex m_mutex;
+  Ring m_ring;
+  typename rclcpp::Subscription<MessageT>::SharedPtr m_subscription{};
+};
+
+/// \brief Create the recorder of a topic
+/// \param[in] node The node to subscribe with
+/// \param[in] topic The topic
+/// \param[in] type The type of the topic, one of the types listed in the design document
+/// \param[in] config How much to keep
+/// \return The recorder
+/// \throw std::domain_error If the type isn't supported or the config is invalid
+BLACK_BOX_RECORDER_PUBLIC std::unique_ptr<TopicRecorder> make_topic_recorder(
+  rclcpp::Node & node, const std::string & topic, const std::string & type,
+  const TopicRecorderConfig & config);
+}  // namespace black_box_recorder
+}  // namespace tools
+}  // namespace autoware
+
+#endif  // BLACK_BOX_RECORDER__TOPIC_RECORDER_HPP_
@@ -0,0 +1,37 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BLACK_BOX_RECORDER__VISIBILITY_CONTROL_HPP_
+#define BLACK_BOX_RECORDER__VISIBILITY_CONTROL_HPP_
+
+////////////////////////////////////////////////////////////////////////////////
+#if defined(__WIN32)
+  #if defined(BLACK_BOX_RECORDER_BUILDING_DLL) || defined(BLACK_BOX_RECORDER_EXPORTS)
+    #define BLACK_BOX_RECORDER_PUBLIC __declspec(dllexport)
+    #define BLACK_BOX_RECORDER_LOCAL
+  #else  // defined(BLACK_BOX_RECORDER_BUILDING_DLL) || ...
+    #define BLACK_BOX_RECORDER_PUBLIC __declspec(dllimport)
+    #define BLACK_BOX_RECORDER_LOCAL
+  #endif  // defined(BLACK_BOX_RECORDER_BUILDING_DLL) || ...
+#elif defined(__linux__)
+  #define BLACK_BOX_RECORDER_PUBLIC __attribute__((visibility("default")))
+  #define BLACK_BOX_RECORDER_LOCAL __attribute__((visibility("hidden")))
+#elif defined(__APPLE__)
+  #define BLACK_BOX_RECORDER_PUBLIC __attribute__((visibility("default")))
+  #define BLACK_BOX_RECORDER_LOCAL __attribute__((visibility("hidden")))
+#else
+  #error "Unsupported Build Configuration"
+#endif
+
+#endif  // BLACK_BOX_RECORDER__VISIBILITY_CONTROL_HPP_
@@ -0,0 +1,179 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "black_box_recorder/bag_dumper.hpp"
+
+#include <rosbag2_cpp/converter_options.hpp>
+#include <rosbag2_cpp/storage_options.hpp>
+#include <rosbag2_cpp/writers/sequential_writer.hpp>
+#include <rosbag2_storage/serialized_bag_message.hpp>
+#include <rosbag2_storage/topic_metadata.hpp>
+#include <thread_pool/thread_config.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <exception>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace autoware
+{
+namespace tools
+{
+namespace black_box_recorder
+{
+namespace
+{
+/// The name of the bag of a dump, unique within the process
+std::string bag_name(const std::size_t index)
+{
+  const auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+  std::tm local_time{};
+  (void)localtime_r(&now, &local_time);
+  std::ostringstream name;
+  name << "black_box_" << std::put_time(&local_time, "%Y%m%d_%H%M%S") << "_" << index;
+  return name.str();
+}
+
+/// A message of a dump in the order of the bag
+struct BagEntry
+{
+  int64_t stamp_ns;
+  std::size_t topic;
+  const RecordedMessage * message;
+};
+}  // namespace
+
+BagDumper::BagDumper(const BagDumperConfig & config, const rclcpp::Logger & logger)
+: m_config{config},
+  m_logger{logger}
+{
+  if (m_config.directory.empty()) {
+    throw std::domain_error{"BagDumper: the directory must not be empty"};
+  }
+  if (m_config.max_pending_dumps == 0U) {
+    throw std::domain_error{"BagDumper: at least one dump must be allowed to wait"};
+  }
+  autoware::common::thread_pool::validate_thread_config(m_config.cpus, 0);
+  m_thread = std::thread{[this]() {run();}};
+  autoware::common::thread_pool::configure_thread(m_thread, m_config.cpus, 0);
+}
+
+BagDumper::~BagDumper()
+{
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_stop = true;
+  }
+  m_condition.notify_one();
+  m_thread.join();
+}
+
+bool8_t BagDumper::enqueue(Dump && dump)
+{
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    if (m_pending.size() >= m_config.max_pending_dumps) {
+      return false;
+    }
+    m_pending.push_back(std::move(dump));
+  }
+  m_condition.notify_one();
+  return true;
+}
+
+std::size_t BagDumper::num_written() const
+{
+  std::lock_guard<std::mutex> lock{m_mutex};
+  return m_num_written;
+}
+
+void BagDumper::run()
+{
+  std::size_t index = 0U;
+  while (true) {
+    Dump dump;
+    {
+      std::unique_lock<std::mutex> lock{m_mutex};
+      m_condition.wait(lock, [this]() {return m_stop || !m_pending.empty();});
+      // The pending dumps are still written on stop, they may be the ones of the fault that
+      // shuts the stack down
+      if (m_pending.empty()) {
+        return;
+      }
+      dump = std::move(m_pending.front());
+      m_pending.pop_front();
+    }
+    const auto uri = m_config.directory + "/" + bag_name(index++);
+    try {
+      write(dump, uri);
+      RCLCPP_INFO(m_logger, "Dumped the black box to %s (%s)", uri.c_str(), dump.reason.c_str());
+      std::lock_guard<std::mutex> lock{m_mutex};
+      ++m_num_written;
+    } catch (const std::exception & e) {
+      RCLCPP_ERROR(m_logger, "Couldn't dump the black box to %s: %s", uri.c_str(), e.what());
+    }
+  }
+}
+
+void BagDumper::write(const Dump & dump, const std::string & uri) const
+{
+  rosbag2_cpp::StorageOptions storage_options{};
+  storage_options.uri = uri;
+  storage_options.storage_id = m_config.storage_id;
+  rosbag2_cpp::ConverterOptions converter_options{};
+  converter_options.input_serialization_format = "cdr";
+  converter_options.output_serialization_format = "cdr";
+  rosbag2_cpp::writers::SequentialWriter writer;
+  writer.open(storage_options, converter_options);
+
+  std::vector<BagEntry> entries;
+  for (std::size_t topic = 0U; topic < dump.topics.size(); ++topic) {
+    const auto & snapshot = dump.topics[topic];
+    rosbag2_storage::TopicMetadata metadata{};
+    metadata.name = snapshot.recorder->topic();
+    metadata.type = snapshot.recorder->type();
+    metadata.serialization_format = "cdr";
+    writer.create_topic(metadata);
+    for (const auto & message : snapshot.messages) {
+      entries.push_back(BagEntry{message.stamp_ns, topic, &message});
+    }
+  }
+  // The messages of all topics in the order they were received in
+  std::stable_sort(
+    entries.begin(), entries.end(), [](const BagEntry & a, const BagEntry & b) {
+      return a.stamp_ns < b.stamp_ns;
+    });
+  for (const auto & entry : entries) {
+    const auto & recorder = *dump.topics[entry.topic].recorder;
+    auto serialized = std::make_shared<rclcpp::SerializedMessage>();
+    recorder.serialize(*entry.message, *serialized);
+    auto bag_message = std::make_shared<rosbag2_storage::SerializedBagMessage>();
+    // Shares the ownership of the serialized message, which holds the buffer
+    bag_message->serialized_data = std::shared_ptr<rcutils_uint8_array_t>{
+      serialized, &serialized->get_rcl_serialized_message()};
+    bag_message->time_stamp = entry.stamp_ns;
+    bag_message->topic_name = recorder.topic();
+    writer.write(bag_message);
+  }
+}
+}  // namespace black_box_recorder
+}  // namespace tools
+}  // namespace autoware
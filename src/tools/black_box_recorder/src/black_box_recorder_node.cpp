@@ -0,0 +1,174 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "black_box_recorder/black_box_recorder_node.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+const std::uint32_t QOS_HISTORY_DEPTH = 10;
+}  // namespace
+
+namespace autoware
+{
+namespace tools
+{
+namespace black_box_recorder
+{
+using autoware::common::types::float64_t;
+using diagnostic_msgs::msg::DiagnosticStatus;
+
+namespace
+{
+int64_t to_ns(const float64_t seconds, const std::string & name)
+{
+  if (!std::isfinite(seconds) || (seconds < 0.0)) {
+    throw std::domain_error{name + " must be finite and not negative"};
+  }
+  return static_cast<int64_t>(seconds * 1.0e9);
+}
+
+int64_t declare_window_ns(rclcpp::Node & node)
+{
+  const auto window_ns = to_ns(node.declare_parameter("window_s", 10.0), "window_s");
+  if (window_ns == 0) {
+    throw std::domain_error{"window_s must be positive"};
+  }
+  return window_ns;
+}
+
+DumpTriggerConfig declare_trigger_config(rclcpp::Node & node, const int64_t window_ns)
+{
+  DumpTriggerConfig config;
+  const auto level = node.declare_parameter("trigger.min_level", std::string{"error"});
+  if (level == "warn") {
+    config.min_level = DiagnosticStatus::WARN;
+  } else if (level == "error") {
+    config.min_level = DiagnosticStatus::ERROR;
+  } else {
+    throw std::domain_error{"trigger.min_level must be warn or error"};
+  }
+  config.name_prefixes =
+    node.declare_parameter("trigger.name_prefixes", std::vector<std::string>{});
+  // By default a fault doesn't trigger again before the window has been refilled, so that the
+  // dumps of a lasting fault don't overlap
+  config.holdoff_ns = to_ns(
+    node.declare_parameter(
+      "trigger.holdoff_s", static_cast<float64_t>(window_ns) * 1.0e-9), "trigger.holdoff_s");
+  return config;
+}
+
+BagDumperConfig declare_dumper_config(rclcpp::Node & node)
+{
+  BagDumperConfig config;
+  config.directory = node.declare_parameter("dump.directory", std::string{"/tmp/black_box"});
+  config.storage_id = node.declare_parameter("dump.storage_id", std::string{"sqlite3"});
+  const auto max_pending = node.declare_parameter("dump.max_pending", int64_t{2});
+  if (max_pending < 1) {
+    throw std::domain_error{"dump.max_pending must be positive"};
+  }
+  config.max_pending_dumps = static_cast<std::size_t>(max_pending);
+  for (const auto cpu : node.declare_parameter("dump.cpus", std::vector<int64_t>{})) {
+    if (cpu < 0) {
+      throw std::domain_error{"dump.cpus must not be negative"};
+    }
+    config.cpus.push_back(static_cast<std::size_t>(cpu));
+  }
+  return config;
+}
+}  // namespace
+
+BlackBoxRecorderNode::BlackBoxRecorderNode(const rclcpp::NodeOptions & options)
+: Node("black_box_recorder", options),
+  m_window_ns{declare_window_ns(*this)},
+  m_trigger{declare_trigger_config(*this, m_window_ns)}
+{
+  const auto names = declare_parameter("topics.names", std::vector<std::string>{});
+  if (names.empty()) {
+    throw std::domain_error{"topics.names must name at least one topic"};
+  }
+  for (const auto & name : names) {
+    const auto prefix = "topics." + name + ".";
+    const auto topic = declare_parameter(prefix + "topic", name);
+    const auto type = declare_parameter(prefix + "type", std::string{});
+    const auto capacity = declare_parameter(prefix + "capacity", int64_t{0});
+    if (capacity < 1) {
+      throw std::domain_error{prefix + "capacity must be positive"};
+    }
+    m_recorders.push_back(
+      make_topic_recorder(
+        *this, topic, type,
+        TopicRecorderConfig{static_cast<std::size_t>(capacity), m_window_ns}));
+  }
+  m_dumper = std::make_unique<BagDumper>(declare_dumper_config(*this), get_logger());
+  m_diagnostics_sub = create_subscription<DiagnosticArray>(
+    "/diagnostics", rclcpp::QoS(rclcpp::KeepLast(::QOS_HISTORY_DEPTH)),
+    [this](const DiagnosticArray::ConstSharedPtr msg) {on_diagnostics(msg);});
+  m_dump_service = create_service<Trigger>(
+    "~/dump",
+    [this](
+      const std::shared_ptr<Trigger::Request> request,
+      std::shared_ptr<Trigger::Response> response) {on_dump_request(request, response);});
+}
+
+bool8_t BlackBoxRecorderNode::dump(const std::string & reason)
+{
+  const auto now_ns = get_clock()->now().nanoseconds();
+  Dump dump;
+  dump.reason = reason;
+  dump.topics.reserve(m_recorders.size());
+  for (const auto & recorder : m_recorders) {
+    TopicSnapshot snapshot{recorder.get(), {}};
+    recorder->snapshot(now_ns, snapshot.messages);
+    dump.topics.push_back(std::move(snapshot));
+  }
+  if (!m_dumper->enqueue(std::move(dump))) {
+    RCLCPP_WARN(
+      get_logger(), "Dropping a dump, too many are waiting to be written: %s", reason.c_str());
+    return false;
+  }
+  return true;
+}
+
+void BlackBoxRecorderNode::on_diagnostics(const DiagnosticArray::ConstSharedPtr msg)
+{
+  std::string reason;
+  if (m_trigger.check(*msg, get_clock()->now().nanoseconds(), reason)) {
+    (void)dump(reason);
+  }
+}
+
+void BlackBoxRecorderNode::on_dump_request(
+  const std::shared_ptr<Trigger::Request> request,
+  std::shared_ptr<Trigger::Response> response)
+{
+  (void)request;
+  response->success = dump("dump service called");
+  response->message = response->success ? "dump queued" : "too many dumps are waiting";
+}
+
+}  // namespace black_box_recorder
+}  // namespace tools
+}  // namespace autoware
+
+#include "rclcpp_components/register_node_macro.hpp"
+
+RCLCPP_COMPONENTS_REGISTER_NODE(autoware::tools::black_box_recorder::BlackBoxRecorderNode)
@@ -0,0 +1,76 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "black_box_recorder/dump_trigger.hpp"
+
+#include <stdexcept>
+#include <string>
+
+namespace autoware
+{
+namespace tools
+{
+namespace black_box_recorder
+{
+using diagnostic_msgs::msg::DiagnosticStatus;
+
+DumpTrigger::DumpTrigger(const DumpTriggerConfig & config)
+: m_config{config}
+{
+  if ((m_config.min_level != DiagnosticStatus::WARN) &&
+    (m_config.min_level != DiagnosticStatus::ERROR))
+  {
+    throw std::domain_error{"DumpTrigger: the level must be WARN or ERROR"};
+  }
+  if (m_config.holdoff_ns < 0) {
+    throw std::domain_error{"DumpTrigger: the holdoff must not be negative"};
+  }
+}
+
+bool8_t DumpTrigger::check(
+  const diagnostic_msgs::msg::DiagnosticArray & diagnostics, const int64_t now_ns,
+  std::string & reason)
+{
+  // Not now_ns - m_last_trigger_ns, which overflows before the first trigger
+  if (now_ns < m_last_trigger_ns + m_config.holdoff_ns) {
+    return false;
+  }
+  for (const auto & status : diagnostics.status) {
+    if (matches(status)) {
+      m_last_trigger_ns = now_ns;
+      reason = status.name + ": " + status.message;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool8_t DumpTrigger::matches(const DiagnosticStatus & status) const
+{
+  if ((status.level < m_config.min_level) || (status.level == DiagnosticStatus::STALE)) {
+    return false;
+  }
+  if (m_config.name_prefixes.empty()) {
+    return true;
+  }
+  for (const auto & prefix : m_config.name_prefixes) {
+    if (status.name.compare(0U, prefix.size(), prefix) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+}  // namespace black_box_recorder
+}  // namespace tools
+}  // namespace autoware
@@ -0,0 +1,108 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "black_box_recorder/topic_recorder.hpp"
+
+#include <autoware_auto_msgs/msg/ackermann_control_command.hpp>
+#include <autoware_auto_msgs/msg/detected_objects.hpp>
+#include <autoware_auto_msgs/msg/tracked_objects.hpp>
+#include <autoware_auto_msgs/msg/trajectory.hpp>
+#include <autoware_auto_msgs/msg/vehicle_control_command.hpp>
+#include <autoware_auto_msgs/msg/vehicle_kinematic_state.hpp>
+#include <autoware_auto_msgs/msg/vehicle_odometry.hpp>
+#include <autoware_auto_msgs/msg/vehicle_state_command.hpp>
+#include <autoware_auto_msgs/msg/vehicle_state_report.hpp>
+#include <diagnostic_msgs/msg/diagnostic_array.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace autoware
+{
+namespace tools
+{
+namespace black_box_recorder
+{
+TopicRecorder::TopicRecorder(
+  const std::string & topic, const std::string & type,
+  std::unique_ptr<rclcpp::SerializationBase> serialization)
+: m_topic{topic},
+  m_type{type},
+  m_serialization{std::move(serialization)}
+{
+}
+
+const std::string & TopicRecorder::topic() const noexcept
+{
+  return m_topic;
+}
+
+const std::string & TopicRecorder::type() const noexcept
+{
+  return m_type;
+}
+
+void TopicRecorder::serialize(
+  const RecordedMessage & message,
+  rclcpp::SerializedMessage & serialized) const
+{
+  m_serialization->serialize_message(message.message.get(), &serialized);
+}
+
+namespace
+{
+template<typename MessageT>
+std::unique_ptr<TopicRecorder> make_typed(
+  rclcpp::Node & node, const std::string & topic, const std::string & type,
+  const TopicRecorderConfig & config)
+{
+  return std::make_unique<TypedTopicRecorder<MessageT>>(node, topic, type, config);
+}
+}  // namespace
+
+std::unique_ptr<TopicRecorder> make_topic_recorder(
+  rclcpp::Node & node, const std::string & topic, const std::string & type,
+  const TopicRecorderConfig & config)
+{
+  if (type == "sensor_msgs/msg/PointCloud2") {
+    return make_typed<sensor_msgs::msg::PointCloud2>(node, topic, type, config);
+  } else if (type == "autoware_auto_msgs/msg/DetectedObjects") {
+    return make_typed<autoware_auto_msgs::msg::DetectedObjects>(node, topic, type, config);
+  } else if (type == "autoware_auto_msgs/msg/TrackedObjects") {
+    return make_typed<autoware_auto_msgs::msg::TrackedObjects>(node, topic, type, config);
+  } else if (type == "autoware_auto_msgs/msg/Trajectory") {
+    return make_typed<autoware_auto_msgs::msg::Trajectory>(node, topic, type, config);
+  } else if (type == "autoware_auto_msgs/msg/VehicleControlCommand") {
+    return make_typed<autoware_auto_msgs::msg::VehicleControlCommand>(node, topic, type, config);
+  } else if (type == "autoware_auto_msgs/msg/AckermannControlCommand") {
+    return make_typed<autoware_auto_msgs::msg::AckermannControlCommand>(node, topic, type, config);
+  } else if (type == "autoware_auto_msgs/msg/VehicleStateCommand") {
+    return make_typed<autoware_auto_msgs::msg::VehicleStateCommand>(node, topic, type, config);
+  } else if (type == "autoware_auto_msgs/msg/VehicleKinematicState") {
+    return make_typed<autoware_auto_msgs::msg::VehicleKinematicState>(node, topic, type, config);
+  } else if (type == "autoware_auto_msgs/msg/VehicleOdometry") {
+    return make_typed<autoware_auto_msgs::msg::VehicleOdometry>(node, topic, type, config);
+  } else if (type == "autoware_auto_msgs/msg/VehicleStateReport") {
+    return make_typed<autoware_auto_msgs::msg::VehicleStateReport>(node, topic, type, config);
+  } else if (type == "diagnostic_msgs/msg/DiagnosticArray") {
+    return make_typed<diagnostic_msgs::msg::DiagnosticArray>(node, topic, type, config);
+  }
+  throw std::domain_error{"BlackBoxRecorder: type " + type + " of " + topic + " isn't supported"};
+}
+}  // namespace black_box_recorder
+}  // namespace tools
+}  // namespace autoware
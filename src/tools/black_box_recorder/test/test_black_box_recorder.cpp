@@ -0,0 +1,166 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <black_box_recorder/dump_trigger.hpp>
+#include <black_box_recorder/message_ring.hpp>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using autoware::tools::black_box_recorder::DumpTrigger;
+using autoware::tools::black_box_recorder::DumpTriggerConfig;
+using autoware::tools::black_box_recorder::MessageRing;
+using diagnostic_msgs::msg::DiagnosticArray;
+using diagnostic_msgs::msg::DiagnosticStatus;
+
+namespace
+{
+using Ring = MessageRing<std::shared_ptr<const int>>;
+
+std::vector<int> values(const std::vector<Ring::Entry> & entries)
+{
+  std::vector<int> result;
+  for (const auto & entry : entries) {
+    result.push_back(*entry.message);
+  }
+  return result;
+}
+
+DiagnosticArray diagnostics(const uint8_t level, const std::string & name)
+{
+  DiagnosticStatus status;
+  status.level = level;
+  status.name = name;
+  status.message = "fault";
+  DiagnosticArray array;
+  array.status.push_back(status);
+  return array;
+}
+}  // namespace
+
+TEST(TestMessageRing, BadConfig)
+{
+  EXPECT_THROW(Ring(0U, 10), std::domain_error);
+  EXPECT_THROW(Ring(4U, 0), std::domain_error);
+}
+
+TEST(TestMessageRing, DropsOldMessages)
+{
+  Ring ring{8U, 10};
+  for (int i = 0; i < 5; ++i) {
+    ring.push(i * 4, std::make_shared<const int>(i));
+  }
+  // Pushed at 0, 4, 8, 12 and 16, 0 and 4 are outside of the window of the last push
+  EXPECT_EQ(ring.size(), 3U);
+  std::vector<Ring::Entry> entries;
+  ring.snapshot(16, entries);
+  EXPECT_EQ(values(entries), (std::vector<int>{2, 3, 4}));
+}
+
+TEST(TestMessageRing, OverwritesOldestWhenFull)
+{
+  Ring ring{3U, 100};
+  for (int i = 0; i < 5; ++i) {
+    ring.push(i, std::make_shared<const int>(i));
+  }
+  EXPECT_EQ(ring.size(), 3U);
+  EXPECT_EQ(ring.capacity(), 3U);
+  std::vector<Ring::Entry> entries;
+  ring.snapshot(4, entries);
+  EXPECT_EQ(values(entries), (std::vector<int>{2, 3, 4}));
+}
+
+TEST(TestMessageRing, SnapshotWindow)
+{
+  Ring ring{8U, 10};
+  for (int i = 0; i < 4; ++i) {
+    ring.push(i * 2, std::make_shared<const int>(i));
+  }
+  std::vector<Ring::Entry> entries;
+  // Only the window ending at 13 is taken, messages after it are skipped as well
+  ring.snapshot(13, entries);
+  EXPECT_EQ(values(entries), (std::vector<int>{2, 3}));
+  entries.clear();
+  ring.snapshot(5, entries);
+  EXPECT_EQ(values(entries), (std::vector<int>{0, 1, 2}));
+}
+
+TEST(TestMessageRing, ClearReleasesMessages)
+{
+  Ring ring{4U, 10};
+  auto message = std::make_shared<const int>(1);
+  ring.push(0, message);
+  EXPECT_EQ(message.use_count(), 2);
+  ring.clear();
+  EXPECT_EQ(ring.size(), 0U);
+  EXPECT_EQ(message.use_count(), 1);
+}
+
+TEST(TestDumpTrigger, BadConfig)
+{
+  DumpTriggerConfig config;
+  config.min_level = DiagnosticStatus::OK;
+  EXPECT_THROW(DumpTrigger{config}, std::domain_error);
+  config.min_level = DiagnosticStatus::STALE;
+  EXPECT_THROW(DumpTrigger{config}, std::domain_error);
+  config.min_level = DiagnosticStatus::WARN;
+  config.holdoff_ns = -1;
+  EXPECT_THROW(DumpTrigger{config}, std::domain_error);
+}
+
+TEST(TestDumpTrigger, Level)
+{
+  DumpTrigger trigger{DumpTriggerConfig{}};
+  std::string reason;
+  EXPECT_FALSE(trigger.check(diagnostics(DiagnosticStatus::OK, "a"), 0, reason));
+  EXPECT_FALSE(trigger.check(diagnostics(DiagnosticStatus::WARN, "a"), 0, reason));
+  EXPECT_FALSE(trigger.check(diagnostics(DiagnosticStatus::STALE, "a"), 0, reason));
+  EXPECT_TRUE(trigger.check(diagnostics(DiagnosticStatus::ERROR, "a"), 0, reason));
+  EXPECT_EQ(reason, "a: fault");
+
+  DumpTriggerConfig config;
+  config.min_level = DiagnosticStatus::WARN;
+  DumpTrigger warn_trigger{config};
+  EXPECT_TRUE(warn_trigger.check(diagnostics(DiagnosticStatus::WARN, "a"), 0, reason));
+}
+
+TEST(TestDumpTrigger, NamePrefixes)
+{
+  DumpTriggerConfig config;
+  config.name_prefixes = {"/vehicle/", "/planning/"};
+  DumpTrigger trigger{config};
+  std::string reason;
+  EXPECT_FALSE(trigger.check(diagnostics(DiagnosticStatus::ERROR, "/perception/a"), 0, reason));
+  EXPECT_FALSE(trigger.check(diagnostics(DiagnosticStatus::ERROR, "/vehicle"), 0, reason));
+  EXPECT_TRUE(trigger.check(diagnostics(DiagnosticStatus::ERROR, "/planning/a"), 0, reason));
+  EXPECT_EQ(reason, "/planning/a: fault");
+}
+
+TEST(TestDumpTrigger, Holdoff)
+{
+  DumpTriggerConfig config;
+  config.holdoff_ns = 100;
+  DumpTrigger trigger{config};
+  std::string reason;
+  const auto fault = diagnostics(DiagnosticStatus::ERROR, "a");
+  EXPECT_TRUE(trigger.check(fault, 1000, reason));
+  EXPECT_FALSE(trigger.check(fault, 1099, reason));
+  EXPECT_TRUE(trigger.check(fault, 1100, reason));
+  // Statuses that don't trigger don't start the holdoff
+  EXPECT_FALSE(trigger.check(diagnostics(DiagnosticStatus::OK, "a"), 1300, reason));
+  EXPECT_TRUE(trigger.check(fault, 1301, reason));
+}
@@ -19,6 +19,7 @@
 #define GNSS_CONVERSION_NODES__GNSS_CONVERSION_NODE_HPP_
 
 #include <autoware_auto_msgs/msg/relative_position_with_covariance_stamped.hpp>
+#include <builtin_interfaces/msg/time.hpp>
 #include <common/types.hpp>
 #include <gnss_conversion_nodes/visibility_control.hpp>
 #include <rclcpp/clock.hpp>
@@ -27,6 +28,7 @@
 #include <rclcpp/subscription.hpp>
 #include <sensor_msgs/msg/nav_sat_fix.hpp>
 
+#include <Eigen/Core>
 #include <GeographicLib/Geocentric.hpp>
 
 #include <tf2/buffer_core.h>
@@ -60,7 +62,17 @@ public:
 private:
   /// @brief      Callback for the NavSatFix message.
   void GNSS_CONVERSION_NODE_LOCAL nav_sat_fix_callback(
-    const sensor_msgs::msg::NavSatFix::ConstSharedPtr msg) const;
+    const sensor_msgs::msg::NavSatFix::ConstSharedPtr msg);
+
+  /// @brief      Update the transform from the ECEF frame to the output frame. A static transform
+  ///             is cached and only looked up again once per second, to notice a change of the
+  ///             origin, otherwise the transform is looked up at the stamp.
+  ///
+  /// @param[in]  stamp  The stamp of the message to transform.
+  ///
+  /// @throws     tf2::LookupException If the transform is not available.
+  void GNSS_CONVERSION_NODE_LOCAL update_tf__output__ecef(
+    const builtin_interfaces::msg::Time & stamp);
 
   /// Frame id to be set to the output messages.
   std::string m_frame_id{};
@@ -73,6 +85,10 @@ private:
   rclcpp::Subscription<sensor_msgs::msg::NavSatFix>::SharedPtr m_gnss_nav_fix_subscription{};
   /// Covariances to set in the output message as a diagonal.
   std::vector<common::types::float64_t> m_override_variances_diagonal{};
+  /// The output message, the frame ids and the covariance are set once on construction.
+  autoware_auto_msgs::msg::RelativePositionWithCovarianceStamped m_out_msg{};
+  /// Whether the output frame differs from the ECEF frame, so that TF is needed.
+  common::types::bool8_t m_needs_transform{false};
 
   /// A converter used for performing the actual conversions.
   GeographicLib::Geocentric m_wgs84_to_ecef_convertor{};
@@ -81,6 +97,15 @@ private:
   tf2::BufferCore m_tf_buffer;
   /// A TF listener.
   tf2_ros::TransformListener m_tf_listener;
+  /// The rotation of the last transform from the ECEF frame to the output frame. Kept apart from
+  /// the translation, an Eigen::Isometry3d member would need an aligned allocation of the node.
+  Eigen::Matrix3d m_rotation__output__ecef{Eigen::Matrix3d::Identity()};
+  /// The translation of the last transform from the ECEF frame to the output frame.
+  Eigen::Vector3d m_translation__output__ecef{Eigen::Vector3d::Zero()};
+  /// Whether m_tf__output__ecef is a static transform, i.e. holds for all stamps.
+  common::types::bool8_t m_is_transform_static{false};
+  /// When to check next whether the transform is static.
+  rclcpp::Time m_next_static_transform_lookup{0, 0U, RCL_STEADY_TIME};
 
   /// A clock used for logging.
   mutable rclcpp::Clock m_steady_clock{RCL_STEADY_TIME};
@@ -26,6 +26,7 @@
 
 #include <Eigen/Core>
 
+#include <chrono>
 #include <limits>
 #include <memory>
 #include <string>
@@ -43,63 +44,15 @@ static constexpr auto kDefaultChildFrameIdTag = "base_link";
 static constexpr auto kOverrideCovarianceTag = "override_variances";
 static constexpr auto kDefaultFrameId = "earth";
 static constexpr auto kDefaultLoggingInterval = 1000;  // Milliseconds.
+static constexpr std::chrono::nanoseconds kStaticTransformRefreshInterval{std::chrono::seconds{1}};
 
 using autoware_auto_msgs::msg::RelativePositionWithCovarianceStamped;
 
-template<typename ArrayT>
-Eigen::Matrix3d to_eigen(const ArrayT & covariance)
-{
-  if (covariance.size() < 9UL) {
-    throw std::domain_error(
-            "The array representing the covariance matrix does not have enough elements. "
-            "Expected " + std::to_string(9UL) + " but has " + std::to_string(covariance.size()));
-  }
-  return Eigen::Matrix3d{Eigen::Map<const Eigen::Matrix3d>{&covariance[0]}};
-}
-
-template<typename ArrayT>
-void fill_covariance_from_eigen(ArrayT & covariance, const Eigen::Matrix3d & matrix)
-{
-  if (covariance.size() < 9UL) {
-    throw std::domain_error(
-            "The array representing the covariance matrix does not have enough elements. "
-            "Expected " + std::to_string(9UL) + " but has " + std::to_string(covariance.size()));
-  }
-  Eigen::Map<Eigen::Matrix3d>{&covariance[0]} = matrix;
-}
-
-Eigen::Matrix3d rotate_covariance(
-  const Eigen::Isometry3d & tf__new__old,
-  const Eigen::Matrix3d & covariance)
-{
-  return tf__new__old.rotation() * covariance * tf__new__old.rotation().transpose();
-}
-
 geometry_msgs::msg::Point to_point(const Eigen::Vector3d & v)
 {
   return geometry_msgs::build<geometry_msgs::msg::Point>().x(v[0]).y(v[1]).z(v[2]);
 }
 
-
-void switch_frames_if_needed(
-  autoware_auto_msgs::msg::RelativePositionWithCovarianceStamped & msg,
-  const std_msgs::msg::Header::_frame_id_type & new_frame_id,
-  const tf2::BufferCore & buffer)
-{
-  if (new_frame_id == msg.header.frame_id) {return;}
-  const Eigen::Isometry3d tf__new_frame_id__msg_frame_id = tf2::transformToEigen(
-    buffer.lookupTransform(
-      new_frame_id, msg.header.frame_id, tf2_ros::fromMsg(msg.header.stamp)));
-  Eigen::Vector3d position;
-  tf2::fromMsg(msg.position, position);
-  msg.position = to_point(tf__new_frame_id__msg_frame_id * position);
-
-  // Update position covariance
-  fill_covariance_from_eigen(
-    msg.covariance, rotate_covariance(tf__new_frame_id__msg_frame_id, to_eigen(msg.covariance)));
-  msg.header.frame_id = new_frame_id;
-}
-
 }  // namespace
 
 
@@ -130,10 +83,44 @@ GnssConversionNode::GnssConversionNode(const rclcpp::NodeOptions & options)
   if (m_override_variances_diagonal.size() != 3UL) {
     throw std::runtime_error("Override covariance must have exactly 3 entries.");
   }
+  m_needs_transform = (m_frame_id != kDefaultFrameId);
+  m_out_msg.header.frame_id = m_frame_id;
+  m_out_msg.child_frame_id = m_child_frame_id;
+  // The covariance is set in the output frame, so it is the same for all messages
+  const Eigen::Vector3d variances_diagonal{
+    Eigen::Map<const Eigen::Vector3d>{m_override_variances_diagonal.data()}};
+  Eigen::Map<Eigen::Matrix3d>{&m_out_msg.covariance.front()} =
+    variances_diagonal.array().square().matrix().asDiagonal();
+}
+
+void GnssConversionNode::update_tf__output__ecef(
+  const builtin_interfaces::msg::Time & stamp)
+{
+  const auto set_transform = [this](const geometry_msgs::msg::TransformStamped & tf) {
+      const Eigen::Isometry3d tf__output__ecef = tf2::transformToEigen(tf);
+      m_rotation__output__ecef = tf__output__ecef.rotation();
+      m_translation__output__ecef = tf__output__ecef.translation();
+    };
+  const auto now = m_steady_clock.now();
+  if (now >= m_next_static_transform_lookup) {
+    // A static transform has no stamp, look up the latest one to find out
+    const auto latest_tf = m_tf_buffer.lookupTransform(
+      m_frame_id, kDefaultFrameId, tf2::TimePointZero);
+    m_is_transform_static = (latest_tf.header.stamp.sec == 0) &&
+      (latest_tf.header.stamp.nanosec == 0U);
+    if (m_is_transform_static) {
+      set_transform(latest_tf);
+    }
+    m_next_static_transform_lookup = now + rclcpp::Duration{kStaticTransformRefreshInterval};
+  }
+  if (!m_is_transform_static) {
+    set_transform(
+      m_tf_buffer.lookupTransform(m_frame_id, kDefaultFrameId, tf2_ros::fromMsg(stamp)));
+  }
 }
 
 void GnssConversionNode::nav_sat_fix_callback(
-  const sensor_msgs::msg::NavSatFix::ConstSharedPtr msg) const
+  const sensor_msgs::msg::NavSatFix::ConstSharedPtr msg)
 {
   if (msg->status.status == msg->status.STATUS_NO_FIX) {
     RCLCPP_WARN_THROTTLE(
@@ -143,35 +130,29 @@ void GnssConversionNode::nav_sat_fix_callback(
       "GNSS has no fix, so nothing is published.");
     return;
   }
-  RelativePositionWithCovarianceStamped out_msg{};
-  out_msg.header.stamp = msg->header.stamp;
-  out_msg.header.frame_id = kDefaultFrameId;
-  out_msg.child_frame_id = m_child_frame_id;
+  Eigen::Vector3d position;
   m_wgs84_to_ecef_convertor.Forward(
-    msg->latitude, msg->longitude, msg->altitude,
-    out_msg.position.x, out_msg.position.y, out_msg.position.z);
-  try {
-    switch_frames_if_needed(out_msg, m_frame_id, m_tf_buffer);
-  } catch (const tf2::LookupException & exception) {
-    RCLCPP_WARN_THROTTLE(
-      get_logger(),
-      m_steady_clock,
-      kDefaultLoggingInterval,
-      "Skipping publishing of a GNSS pose message.\n"
-      "Could not look up transformation between " +
-      out_msg.header.frame_id + " and " +
-      m_frame_id + " with the exception: " + exception.what());
-    return;
-  }
-  if (!m_override_variances_diagonal.empty()) {
-    const Eigen::Vector3d variances_diagonal{
-      Eigen::Map<const Eigen::Vector3d>{m_override_variances_diagonal.data()}};
-    const auto override_covariance = variances_diagonal.array().square().matrix().asDiagonal();
-    auto pose_covariance = Eigen::Map<Eigen::Matrix3d>{&out_msg.covariance.front()};
-    pose_covariance.topLeftCorner(
-      override_covariance.rows(), override_covariance.cols()) = override_covariance;
+    msg->latitude, msg->longitude, msg->altitude, position[0], position[1], position[2]);
+  if (m_needs_transform) {
+    try {
+      update_tf__output__ecef(msg->header.stamp);
+    } catch (const tf2::LookupException & exception) {
+      RCLCPP_WARN_THROTTLE(
+        get_logger(),
+        m_steady_clock,
+        kDefaultLoggingInterval,
+        "Skipping publishing of a GNSS pose message.\n"
+        "Could not look up transformation between " +
+        std::string{kDefaultFrameId} + " and " +
+        m_frame_id + " with the exception: " + exception.what());
+      return;
+    }
+    position = m_rotation__output__ecef * position + m_translation__output__ecef;
   }
-  m_publisher->publish(out_msg);
+  // Only the stamp and the position change, no message is allocated for publishing
+  m_out_msg.header.stamp = msg->header.stamp;
+  m_out_msg.position = to_point(position);
+  m_publisher->publish(m_out_msg);
 }
 
 }  // namespace gnss_conversion_nodes
@@ -187,6 +187,75 @@ TEST_F(TestGnssConversionNode, PublishAndReceiveMsgConvertToEnu) {
 }
 
 
+/// @test Test conversion of a message from GNSS to local frame coordinates, using a static
+///     ENU <-> ECEF conversion coming from TF, which the node caches.
+TEST_F(TestGnssConversionNode, PublishAndReceiveMsgConvertToEnuWithStaticTf) {
+  sensor_msgs::msg::NavSatFix msg{};
+  msg.header.stamp.set__sec(42).set__nanosec(42);
+  msg.header.frame_id = "fix";
+  msg.position_covariance_type = msg.COVARIANCE_TYPE_DIAGONAL_KNOWN;
+  msg.status.status = msg.status.STATUS_FIX;
+  msg.position_covariance = std::array<autoware::common::types::float64_t, 9UL>{};
+  // Coordinate of the Hofbraeuhaus in Munich.
+  msg.longitude = 11.5777366;
+  msg.latitude = 48.1376098;
+  msg.altitude = 515.0;  // Meters above sea level;
+
+  // Create the node.
+  rclcpp::NodeOptions node_options{};
+  const std::vector<autoware::common::types::float64_t> override_variances{1.0, 2.0, 3.0};
+  node_options.append_parameter_override("override_variances", override_variances);
+  node_options.append_parameter_override("output_frame_id", "map");
+  const auto node{std::make_shared<GnssConversionNode>(node_options)};
+
+  // Set a static transformation between ENU <-> ECEF to the TF buffer. It holds for all stamps.
+  node->tf_buffer().setTransform(get_tf__ecef__enu(msg, "map", "earth"), "test_node", true);
+  msg.header.stamp.set__sec(4242);
+
+  // Check that the received messages are properly converted.
+  RelativePositionWithCovarianceStamped::SharedPtr last_msg{};
+  auto publisher = create_publisher<sensor_msgs::msg::NavSatFix>("wgs84_position");
+  auto subscription = create_subscription<RelativePositionWithCovarianceStamped>(
+    "gnss_position", *node,
+    [&last_msg](
+      const RelativePositionWithCovarianceStamped::SharedPtr received_msg) {
+      last_msg = received_msg;
+    });
+
+  const auto dt{std::chrono::milliseconds{100LL}};
+  const auto max_wait_time{std::chrono::seconds{10LL}};
+  auto time_passed{std::chrono::milliseconds{0LL}};
+  while (!last_msg) {
+    publisher->publish(msg);
+    rclcpp::spin_some(node);
+    rclcpp::spin_some(get_fake_node());
+    std::this_thread::sleep_for(dt);
+    time_passed += dt;
+    if (time_passed > max_wait_time) {
+      FAIL() << "Did not receive a message soon enough.";
+    }
+  }
+  // We expect the coordinates to be 0 as the base of the ENU frame is exactly the ECEF coordinate
+  // we are sending out.
+  EXPECT_EQ("map", last_msg->header.frame_id);
+  EXPECT_NEAR(last_msg->position.x, 0.0, 1.0);
+  EXPECT_NEAR(last_msg->position.y, 0.0, 1.0);
+  EXPECT_NEAR(last_msg->position.z, 0.0, 1.0);
+  // Check the diagonal values.
+  ASSERT_EQ(last_msg->covariance.size(), 9UL);
+  EXPECT_DOUBLE_EQ(override_variances[0] * override_variances[0], last_msg->covariance[0]);
+  EXPECT_DOUBLE_EQ(override_variances[1] * override_variances[1], last_msg->covariance[4]);
+  EXPECT_DOUBLE_EQ(override_variances[2] * override_variances[2], last_msg->covariance[8]);
+
+  for (auto i = 0U; i < last_msg->covariance.size(); ++i) {
+    if ((i == 0) || (i == 4) || (i == 8)) {continue;}
+    EXPECT_DOUBLE_EQ(last_msg->covariance[i], 0.0) << "Off-center value is not 0.0 for i = " << i;
+  }
+
+  SUCCEED();
+}
+
+
 /// @test Test that when there is no fix the message is not converted.
 TEST_F(TestGnssConversionNode, NoConversionWhenNoGnssFix) {
   sensor_msgs::msg::NavSatFix msg{};
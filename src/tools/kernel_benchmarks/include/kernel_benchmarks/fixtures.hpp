@@ -0,0 +1,148 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief Reproducible inputs for the kernel benchmarks
+
+#ifndef KERNEL_BENCHMARKS__FIXTURES_HPP_
+#define KERNEL_BENCHMARKS__FIXTURES_HPP_
+
+#include <common/types.hpp>
+#include <kernel_benchmarks/visibility_control.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace autoware
+{
+namespace tools
+{
+/// \brief Fixtures shared by the microbenchmarks of the core perception, localization, fusion and
+///        control kernels
+namespace kernel_benchmarks
+{
+using autoware::common::types::float32_t;
+using autoware::common::types::PointXYZIF;
+using Cloud = std::vector<PointXYZIF>;
+
+/// \brief Where the scan of a benchmark comes from, the benchmarks take it as their first argument
+enum class ScanSource : int64_t
+{
+  /// A scan that is generated by make_synthetic_scan() with the default configuration
+  SYNTHETIC = 0,
+  /// A KITTI velodyne scan, read from the file in the kRecordedScanVariable environment variable
+  RECORDED = 1
+};
+
+/// \brief The environment variable that holds the path of the recorded scan. Benchmarks of the
+///        recorded scan are only registered if it is set
+constexpr const char * kRecordedScanVariable = "KERNEL_BENCHMARKS_SCAN";
+
+/// \brief Height of the lidar over the ground in both sources, this is the mounting height of the
+///        velodyne in the KITTI dataset
+constexpr float32_t kSensorHeight = 1.73F;
+
+/// \brief A pseudo random number generator (splitmix64) whose numbers are the same with every
+///        compiler and standard library, which is not the case for the standard distributions
+class KERNEL_BENCHMARKS_PUBLIC Random
+{
+public:
+  /// \brief Constructor
+  /// \param[in] seed The seed, the same seed always produces the same sequence
+  explicit Random(uint64_t seed) noexcept;
+
+  /// \brief Get the next number of the sequence
+  /// \return A number that is uniformly distributed over all 64 bit values
+  uint64_t next() noexcept;
+
+  /// \brief Get the next number of the sequence in an interval
+  /// \param[in] min The lower bound of the interval, included
+  /// \param[in] max The upper bound of the interval, excluded
+  /// \return A number that is uniformly distributed over the interval
+  float32_t uniform(float32_t min, float32_t max) noexcept;
+
+private:
+  uint64_t m_state;
+};  // class Random
+
+/// \brief Configuration of a synthetic scan, the defaults resemble a 32 beam spinning lidar in an
+///        urban scene
+struct KERNEL_BENCHMARKS_PUBLIC SyntheticScanConfig
+{
+  /// Number of beams, from the lowest to the highest elevation
+  uint16_t num_rings{32U};
+  /// Number of firings per revolution, each firing is one ray of all beams
+  uint16_t num_azimuths{1800U};
+  float32_t min_elevation_deg{-25.0F};
+  float32_t max_elevation_deg{15.0F};
+  /// Beams that hit nothing within this range give no point
+  float32_t max_range_m{100.0F};
+  /// Number of box shaped obstacles, e.g. cars and buildings, that stand on the ground
+  uint16_t num_boxes{60U};
+  /// Half width of the uniform noise that is added to every range
+  float32_t range_noise_m{0.02F};
+  uint64_t seed{42U};
+};  // struct SyntheticScanConfig
+
+/// \brief Ray cast a scene of a flat ground plane kSensorHeight below the sensor and boxes that
+///        stand on it. Points are ordered by firing, i.e. all beams of the first azimuth come
+///        first, and the id of every point is the index of its azimuth
+/// \param[in] config The configuration of the sensor and the scene
+/// \return The scan in the sensor frame
+/// \throw std::domain_error If there are fewer than 2 rings or no azimuths
+KERNEL_BENCHMARKS_PUBLIC Cloud make_synthetic_scan(
+  const SyntheticScanConfig & config = SyntheticScanConfig{});
+
+/// \brief Read a scan in the format of the KITTI velodyne files, i.e. consecutive x, y, z and
+///        reflectance values as 32 bit floats. Reflectances are scaled from [0, 1] to [0, 255]
+/// \param[in] path The path of the file
+/// \return The scan in the sensor frame, the ids of the points are 0
+/// \throw std::runtime_error If the file cannot be read or its size is not a multiple of a point
+KERNEL_BENCHMARKS_PUBLIC Cloud load_kitti_scan(const std::string & path);
+
+/// \brief Get the scan of a source. It is created on the first call and shared by all benchmarks
+/// \param[in] source The source of the scan
+/// \return The scan of this source
+/// \throw std::runtime_error If the recorded scan is requested but kRecordedScanVariable is not
+///                           set, or the scan cannot be read
+KERNEL_BENCHMARKS_PUBLIC const Cloud & get_scan(ScanSource source);
+
+/// \brief Get the sources that benchmarks can run on, which always includes the synthetic scan
+/// \return The synthetic source, followed by the recorded one if kRecordedScanVariable is set
+KERNEL_BENCHMARKS_PUBLIC std::vector<ScanSource> available_scan_sources();
+
+/// \brief Remove all points that are close to the ground plane, a stand-in for ground filtering
+///        to get inputs for the kernels that run after it
+/// \param[in] cloud The scan in the sensor frame
+/// \param[in] min_height_m The minimum height above the ground plane of the remaining points
+/// \return The points that are higher than min_height_m above the ground
+KERNEL_BENCHMARKS_PUBLIC Cloud remove_ground(const Cloud & cloud, float32_t min_height_m);
+
+/// \brief Split a scan into rays of equal azimuth width, as the ray aggregator does. The id of
+///        every point is set to the index of its ray
+/// \param[in] cloud The scan in the sensor frame
+/// \param[in] num_rays The number of rays of a revolution
+/// \param[in] max_ray_size The maximum number of points of a ray, further points are dropped
+/// \return The rays ordered by azimuth, with the points in the order of the cloud
+/// \throw std::domain_error If there are no rays
+KERNEL_BENCHMARKS_PUBLIC std::vector<Cloud> split_into_rays(
+  const Cloud & cloud, std::size_t num_rays, std::size_t max_ray_size);
+
+}  // namespace kernel_benchmarks
+}  // namespace tools
+}  // namespace autoware
+
+#endif  // KERNEL_BENCHMARKS__FIXTURES_HPP_
@@ -0,0 +1,40 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef KERNEL_BENCHMARKS__VISIBILITY_CONTROL_HPP_
+#define KERNEL_BENCHMARKS__VISIBILITY_CONTROL_HPP_
+
+////////////////////////////////////////////////////////////////////////////////
+#if defined(__WIN32)
+  #if defined(KERNEL_BENCHMARKS_BUILDING_DLL) || defined(KERNEL_BENCHMARKS_EXPORTS)
+    #define KERNEL_BENCHMARKS_PUBLIC __declspec(dllexport)
+    #define KERNEL_BENCHMARKS_LOCAL
+  #else  // defined(KERNEL_BENCHMARKS_BUILDING_DLL) || defined(KERNEL_BENCHMARKS_EXPORTS)
+    #define KERNEL_BENCHMARKS_PUBLIC __declspec(dllimport)
+    #define KERNEL_BENCHMARKS_LOCAL
+  #endif  // defined(KERNEL_BENCHMARKS_BUILDING_DLL) || defined(KERNEL_BENCHMARKS_EXPORTS)
+#elif defined(__linux__)
+  #define KERNEL_BENCHMARKS_PUBLIC __attribute__((visibility("default")))
+  #define KERNEL_BENCHMARKS_LOCAL __attribute__((visibility("hidden")))
+#elif defined(__APPLE__)
+  #define KERNEL_BENCHMARKS_PUBLIC __attribute__((visibility("default")))
+  #define KERNEL_BENCHMARKS_LOCAL __attribute__((visibility("hidden")))
+#elif defined(QNX)
+  #define KERNEL_BENCHMARKS_PUBLIC __attribute__((visibility("default")))
+  #define KERNEL_BENCHMARKS_LOCAL __attribute__((visibility("hidden")))
+#else  // defined(__linux__)
+  #error "Unsupported Build Configuration"
+#endif  // defined(__WIN32)
+
+#endif  // KERNEL_BENCHMARKS__VISIBILITY_CONTROL_HPP_
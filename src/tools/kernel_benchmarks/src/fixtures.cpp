@@ -0,0 +1,270 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "kernel_benchmarks/fixtures.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace autoware
+{
+namespace tools
+{
+namespace kernel_benchmarks
+{
+namespace
+{
+constexpr float32_t kPi = 3.14159265358979F;
+constexpr float32_t kGroundIntensity = 5.0F;
+constexpr float32_t kObstacleIntensity = 40.0F;
+
+/// An axis aligned box that stands on the ground plane
+struct Box
+{
+  std::array<float32_t, 3U> min;
+  std::array<float32_t, 3U> max;
+};
+
+std::vector<Box> make_scene(const SyntheticScanConfig & config, Random & random)
+{
+  std::vector<Box> boxes;
+  boxes.reserve(config.num_boxes);
+  for (uint16_t idx = 0U; idx < config.num_boxes; ++idx) {
+    // Keep the boxes away from the sensor so that it is never inside of one
+    const auto distance = random.uniform(6.0F, 0.6F * config.max_range_m);
+    const auto angle = random.uniform(-kPi, kPi);
+    const auto half_length = random.uniform(0.75F, 2.5F);
+    const auto half_width = random.uniform(0.75F, 1.25F);
+    const auto height = random.uniform(1.4F, 3.0F);
+    const auto x = distance * std::cos(angle);
+    const auto y = distance * std::sin(angle);
+    boxes.push_back(
+      {{x - half_length, y - half_width, -kSensorHeight},
+        {x + half_length, y + half_width, height - kSensorHeight}});
+  }
+  return boxes;
+}
+
+/// Distance along a ray from the origin to a box, or infinity if the ray misses it
+float32_t intersect(const Box & box, const std::array<float32_t, 3U> & direction)
+{
+  auto t_min = 0.0F;
+  auto t_max = std::numeric_limits<float32_t>::infinity();
+  for (std::size_t axis = 0U; axis < 3U; ++axis) {
+    if (std::fabs(direction[axis]) < std::numeric_limits<float32_t>::epsilon()) {
+      if ((box.min[axis] > 0.0F) || (box.max[axis] < 0.0F)) {
+        return std::numeric_limits<float32_t>::infinity();
+      }
+      continue;
+    }
+    const auto t1 = box.min[axis] / direction[axis];
+    const auto t2 = box.max[axis] / direction[axis];
+    t_min = std::max(t_min, std::min(t1, t2));
+    t_max = std::min(t_max, std::max(t1, t2));
+    if (t_min > t_max) {
+      return std::numeric_limits<float32_t>::infinity();
+    }
+  }
+  return t_min;
+}
+
+std::string recorded_scan_path()
+{
+  const char * const path = std::getenv(kRecordedScanVariable);
+  if ((nullptr == path) || ('\0' == path[0U])) {
+    throw std::runtime_error{
+            std::string{"kernel_benchmarks: "} + kRecordedScanVariable +
+            " must be set to the path of a KITTI velodyne scan"};
+  }
+  return std::string{path};
+}
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+Random::Random(const uint64_t seed) noexcept
+: m_state{seed}
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+uint64_t Random::next() noexcept
+{
+  m_state += 0x9E3779B97F4A7C15ULL;
+  auto z = m_state;
+  z = (z ^ (z >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27U)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31U);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+float32_t Random::uniform(const float32_t min, const float32_t max) noexcept
+{
+  // The upper 24 bits fit exactly into the mantissa, so the fraction is in [0, 1)
+  const auto fraction = static_cast<float32_t>(next() >> 40U) / 16777216.0F;
+  return min + (fraction * (max - min));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Cloud make_synthetic_scan(const SyntheticScanConfig & config)
+{
+  if ((config.num_rings < 2U) || (0U == config.num_azimuths)) {
+    throw std::domain_error{"make_synthetic_scan: need at least 2 rings and 1 azimuth"};
+  }
+  Random random{config.seed};
+  const auto boxes = make_scene(config, random);
+  const auto to_rad = kPi / 180.0F;
+  const auto elevation_step = (config.max_elevation_deg - config.min_elevation_deg) /
+    static_cast<float32_t>(config.num_rings - 1U);
+
+  Cloud cloud;
+  cloud.reserve(static_cast<std::size_t>(config.num_rings) * config.num_azimuths);
+  for (uint16_t azimuth_idx = 0U; azimuth_idx < config.num_azimuths; ++azimuth_idx) {
+    const auto azimuth = (2.0F * kPi * static_cast<float32_t>(azimuth_idx)) /
+      static_cast<float32_t>(config.num_azimuths);
+    for (uint16_t ring = 0U; ring < config.num_rings; ++ring) {
+      const auto elevation =
+        (config.min_elevation_deg + (elevation_step * static_cast<float32_t>(ring))) * to_rad;
+      const std::array<float32_t, 3U> direction{
+        std::cos(elevation) * std::cos(azimuth),
+        std::cos(elevation) * std::sin(azimuth),
+        std::sin(elevation)};
+      auto range = std::numeric_limits<float32_t>::infinity();
+      auto intensity = kGroundIntensity;
+      if (direction[2U] < 0.0F) {
+        range = -kSensorHeight / direction[2U];
+      }
+      for (const auto & box : boxes) {
+        const auto box_range = intersect(box, direction);
+        if (box_range < range) {
+          range = box_range;
+          intensity = kObstacleIntensity;
+        }
+      }
+      // Draw the noise for every beam, so that the sequence doesn't depend on what is hit
+      const auto noise = random.uniform(-config.range_noise_m, config.range_noise_m);
+      const auto jitter = random.uniform(0.0F, 10.0F);
+      if (range > config.max_range_m) {
+        continue;
+      }
+      range += noise;
+      PointXYZIF pt{};
+      pt.x = range * direction[0U];
+      pt.y = range * direction[1U];
+      pt.z = range * direction[2U];
+      pt.intensity = intensity + jitter;
+      pt.id = azimuth_idx;
+      cloud.push_back(pt);
+    }
+  }
+  return cloud;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Cloud load_kitti_scan(const std::string & path)
+{
+  std::ifstream file{path, std::ios::binary | std::ios::ate};
+  if (!file) {
+    throw std::runtime_error{"load_kitti_scan: cannot open " + path};
+  }
+  constexpr auto kPointSize = 4U * sizeof(float32_t);
+  const auto size = static_cast<std::size_t>(file.tellg());
+  if (0U != (size % kPointSize)) {
+    throw std::runtime_error{"load_kitti_scan: size of " + path + " is not a multiple of a point"};
+  }
+  std::vector<float32_t> values(size / sizeof(float32_t));
+  file.seekg(0);
+  if (!file.read(reinterpret_cast<char *>(values.data()), static_cast<std::streamsize>(size))) {
+    throw std::runtime_error{"load_kitti_scan: cannot read " + path};
+  }
+  Cloud cloud;
+  cloud.reserve(size / kPointSize);
+  for (std::size_t idx = 0U; idx < values.size(); idx += 4U) {
+    PointXYZIF pt{};
+    pt.x = values[idx];
+    pt.y = values[idx + 1U];
+    pt.z = values[idx + 2U];
+    pt.intensity = 255.0F * values[idx + 3U];
+    cloud.push_back(pt);
+  }
+  return cloud;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const Cloud & get_scan(const ScanSource source)
+{
+  if (ScanSource::RECORDED == source) {
+    static const Cloud recorded{load_kitti_scan(recorded_scan_path())};
+    return recorded;
+  }
+  static const Cloud synthetic{make_synthetic_scan()};
+  return synthetic;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::vector<ScanSource> available_scan_sources()
+{
+  std::vector<ScanSource> sources{ScanSource::SYNTHETIC};
+  const char * const path = std::getenv(kRecordedScanVariable);
+  if ((nullptr != path) && ('\0' != path[0U])) {
+    sources.push_back(ScanSource::RECORDED);
+  }
+  return sources;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Cloud remove_ground(const Cloud & cloud, const float32_t min_height_m)
+{
+  Cloud ret;
+  ret.reserve(cloud.size());
+  const auto min_z = min_height_m - kSensorHeight;
+  (void)std::copy_if(
+    cloud.begin(), cloud.end(), std::back_inserter(ret),
+    [min_z](const PointXYZIF & pt) {return pt.z > min_z;});
+  return ret;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::vector<Cloud> split_into_rays(
+  const Cloud & cloud,
+  const std::size_t num_rays,
+  const std::size_t max_ray_size)
+{
+  if (0U == num_rays) {
+    throw std::domain_error{"split_into_rays: need at least one ray"};
+  }
+  std::vector<Cloud> rays(num_rays);
+  const auto rays_per_rad = static_cast<float32_t>(num_rays) / (2.0F * kPi);
+  for (const auto & pt : cloud) {
+    const auto angle = std::atan2(pt.y, pt.x) + kPi;
+    const auto idx = std::min(
+      static_cast<std::size_t>(std::max(angle * rays_per_rad, 0.0F)), num_rays - 1U);
+    auto & ray = rays[idx];
+    if (ray.size() < max_ray_size) {
+      ray.push_back(pt);
+      ray.back().id = static_cast<uint16_t>(idx);
+    }
+  }
+  return rays;
+}
+
+}  // namespace kernel_benchmarks
+}  // namespace tools
+}  // namespace autoware
@@ -0,0 +1,72 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+#include <euclidean_cluster/euclidean_cluster.hpp>
+#include <kernel_benchmarks/fixtures.hpp>
+
+#include <cstdint>
+
+namespace
+{
+using autoware::common::types::float64_t;
+using autoware::perception::segmentation::euclidean_cluster::Clusters;
+using autoware::perception::segmentation::euclidean_cluster::Config;
+using autoware::perception::segmentation::euclidean_cluster::EuclideanCluster;
+using autoware::perception::segmentation::euclidean_cluster::HashConfig;
+using autoware::tools::kernel_benchmarks::available_scan_sources;
+using autoware::tools::kernel_benchmarks::get_scan;
+using autoware::tools::kernel_benchmarks::remove_ground;
+using autoware::tools::kernel_benchmarks::ScanSource;
+
+constexpr auto kExtent = 130.0F;
+/// Points closer to the ground are removed, as the ground filter would do
+constexpr auto kMinHeight = 0.3F;
+
+/// Cluster the nonground points of a scan with the parameters of the euclidean cluster node. The
+/// points are inserted in every iteration, since clustering empties the spatial hash
+void BenchEuclideanCluster(benchmark::State & state)
+{
+  const auto & scan = get_scan(static_cast<ScanSource>(state.range(0)));
+  const auto nonground = remove_ground(scan, kMinHeight);
+  const auto search = static_cast<EuclideanCluster::Search>(state.range(1));
+  const Config config{"base_link", 10U, 256U, 0.5F, 1.5F, 60.0F};
+  const HashConfig hash_config{-kExtent, kExtent, -kExtent, kExtent, 1.0F, nonground.size()};
+  EuclideanCluster cluster{config, hash_config, 1U, search};
+  Clusters clusters;
+  clusters.clusters.reserve(config.max_num_clusters());
+
+  for (auto _ : state) {
+    cluster.insert(nonground.begin(), nonground.end());
+    cluster.cluster(clusters);
+    benchmark::DoNotOptimize(clusters.clusters.data());
+  }
+  state.SetItemsProcessed(
+    static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(nonground.size()));
+  state.counters["points"] = static_cast<float64_t>(nonground.size());
+  state.counters["clusters"] = static_cast<float64_t>(clusters.clusters.size());
+}
+
+void EuclideanClusterArgs(benchmark::internal::Benchmark * bench)
+{
+  bench->ArgNames({"source", "search"});
+  for (const auto source : available_scan_sources()) {
+    for (const auto search : {EuclideanCluster::Search::POINTS, EuclideanCluster::Search::VOXELS}) {
+      bench->Args({static_cast<int64_t>(source), static_cast<int64_t>(search)});
+    }
+  }
+}
+}  // namespace
+
+BENCHMARK(BenchEuclideanCluster)->Apply(EuclideanClusterArgs)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,114 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+#include <hungarian_assigner/hungarian_assigner.hpp>
+#include <kernel_benchmarks/fixtures.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+using autoware::common::types::bool8_t;
+using autoware::common::types::float32_t;
+using autoware::common::types::float64_t;
+using autoware::fusion::hungarian_assigner::hungarian_assigner_c;
+using autoware::fusion::hungarian_assigner::index_t;
+using autoware::tools::kernel_benchmarks::Random;
+
+constexpr uint16_t kCapacity = 256U;
+constexpr auto kAreaSize = 100.0F;
+constexpr auto kMeasurementNoise = 0.5F;
+/// Detections further away from a track than this are not associated with it if gating is on
+constexpr auto kGateDistance = 5.0F;
+
+struct Weight
+{
+  float32_t weight;
+  index_t track;
+  index_t detection;
+};
+
+/// Distances between tracks and detections of the same objects plus clutter, one detection in
+/// five is clutter. With gating, only the pairs within the gate distance get a weight, which is
+/// what the tracker does.
+std::vector<Weight> make_weights(const index_t num_tracks, const bool8_t gated)
+{
+  Random random{7U};
+  const auto num_detections = std::min(num_tracks + (num_tracks / 4), index_t{kCapacity});
+  std::vector<float32_t> x(static_cast<std::size_t>(num_detections));
+  std::vector<float32_t> y(static_cast<std::size_t>(num_detections));
+  for (std::size_t idx = 0U; idx < x.size(); ++idx) {
+    x[idx] = random.uniform(0.0F, kAreaSize);
+    y[idx] = random.uniform(0.0F, kAreaSize);
+  }
+  std::vector<Weight> weights;
+  for (index_t track = 0; track < num_tracks; ++track) {
+    // Tracks are where their detection is, apart from the measurement noise
+    const auto track_idx = static_cast<std::size_t>(track);
+    const auto track_x = x[track_idx] + random.uniform(-kMeasurementNoise, kMeasurementNoise);
+    const auto track_y = y[track_idx] + random.uniform(-kMeasurementNoise, kMeasurementNoise);
+    for (index_t detection = 0; detection < num_detections; ++detection) {
+      const auto detection_idx = static_cast<std::size_t>(detection);
+      const auto distance = std::hypot(x[detection_idx] - track_x, y[detection_idx] - track_y);
+      if (!gated || (distance < kGateDistance)) {
+        weights.push_back({distance, track, detection});
+      }
+    }
+  }
+  return weights;
+}
+
+/// Solve the association of tracks to detections, including setting up the weight matrix since
+/// assigning destroys it
+void BenchHungarianAssign(benchmark::State & state)
+{
+  const index_t num_tracks{state.range(0)};
+  const auto gated = (0 != state.range(1));
+  const auto weights = make_weights(num_tracks, gated);
+  const auto num_detections = std::min(num_tracks + (num_tracks / 4), index_t{kCapacity});
+  // The assigner forbids heap allocations by Eigen, so it lives on the stack
+  hungarian_assigner_c<kCapacity> assigner;
+
+  std::size_t num_assigned{0U};
+  for (auto _ : state) {
+    assigner.reset(num_tracks, num_detections);
+    for (const auto & weight : weights) {
+      assigner.set_weight(weight.weight, weight.track, weight.detection);
+    }
+    benchmark::DoNotOptimize(assigner.assign());
+  }
+  for (index_t track = 0; track < num_tracks; ++track) {
+    if (hungarian_assigner_c<kCapacity>::UNASSIGNED != assigner.get_assignment(track)) {
+      ++num_assigned;
+    }
+  }
+  state.counters["weights"] = static_cast<float64_t>(weights.size());
+  state.counters["assigned"] = static_cast<float64_t>(num_assigned);
+}
+
+void HungarianArgs(benchmark::internal::Benchmark * bench)
+{
+  bench->ArgNames({"tracks", "gated"});
+  for (const int64_t num_tracks : {16, 32, 64, 128, 192}) {
+    bench->Args({num_tracks, 0});
+    bench->Args({num_tracks, 1});
+  }
+}
+}  // namespace
+
+BENCHMARK(BenchHungarianAssign)->Apply(HungarianArgs)->Unit(benchmark::kMicrosecond);
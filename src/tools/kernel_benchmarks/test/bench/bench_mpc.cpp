@@ -0,0 +1,152 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <autoware_auto_msgs/msg/ackermann_lateral_command.hpp>
+#include <autoware_auto_msgs/msg/trajectory.hpp>
+#include <autoware_auto_msgs/msg/vehicle_kinematic_state.hpp>
+#include <benchmark/benchmark.h>
+#include <geometry_msgs/msg/pose.hpp>
+#include <trajectory_follower/mpc.hpp>
+#include <trajectory_follower/qp_solver/qp_solver_unconstr_fast.hpp>
+#include <trajectory_follower/vehicle_model/vehicle_model_bicycle_dynamics.hpp>
+#include <trajectory_follower/vehicle_model/vehicle_model_bicycle_kinematics.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+
+namespace
+{
+using autoware::common::types::float32_t;
+using autoware::common::types::float64_t;
+namespace trajectory_follower = ::autoware::motion::control::trajectory_follower;
+using autoware_auto_msgs::msg::AckermannLateralCommand;
+using autoware_auto_msgs::msg::Trajectory;
+using autoware_auto_msgs::msg::TrajectoryPoint;
+using autoware_auto_msgs::msg::VehicleKinematicState;
+
+constexpr auto kWheelbase = 2.7;
+constexpr auto kVelocity = 5.0F;
+constexpr auto kTurnRadius = 30.0F;
+constexpr int64_t kNumTrajectoryPoints = 100;
+
+/// The vehicle model that the matrices are generated with
+enum class Model : int64_t
+{
+  KINEMATICS = 0,
+  DYNAMICS = 1
+};
+
+/// A right turn of constant radius with one point per meter
+Trajectory make_trajectory()
+{
+  Trajectory trajectory;
+  for (int64_t idx = 0; idx < kNumTrajectoryPoints; ++idx) {
+    const auto angle = static_cast<float32_t>(idx) / kTurnRadius;
+    TrajectoryPoint pt;
+    pt.x = kTurnRadius * std::sin(angle);
+    pt.y = -kTurnRadius * (1.0F - std::cos(angle));
+    pt.longitudinal_velocity_mps = kVelocity;
+    trajectory.points.push_back(pt);
+  }
+  return trajectory;
+}
+
+std::shared_ptr<trajectory_follower::VehicleModelInterface> make_model(const Model model)
+{
+  if (Model::DYNAMICS == model) {
+    return std::make_shared<trajectory_follower::DynamicsBicycleModel>(
+      kWheelbase, 600.0, 600.0, 600.0, 600.0, 155494.663, 155494.663);
+  }
+  return std::make_shared<trajectory_follower::KinematicsBicycleModel>(kWheelbase, 1.0, 0.1);
+}
+
+/// Compute the steering command of the lateral MPC while following a turn. The matrices of the
+/// prediction are generated in generateMPCMatrix(), which isn't part of the interface, so this
+/// measures a whole control step. The QP is solved with the unconstrained solver, which is a
+/// least squares solve of the size of the horizon, so most of the time goes to the matrices.
+void BenchMPCCalculate(benchmark::State & state)
+{
+  trajectory_follower::MPC mpc;
+  mpc.setVehicleModel(
+    make_model(static_cast<Model>(state.range(1))),
+    (Model::DYNAMICS == static_cast<Model>(state.range(1))) ? "dynamics" : "kinematics");
+  mpc.setQPSolver(std::make_shared<trajectory_follower::QPSolverEigenLeastSquareLLT>());
+
+  // The parameters of the trajectory follower tests
+  trajectory_follower::MPCParam param{};
+  param.prediction_horizon = state.range(0);
+  param.prediction_dt = 0.1;
+  param.zero_ff_steer_deg = 0.5;
+  param.input_delay = 0.0;
+  param.acceleration_limit = 2.0;
+  param.velocity_time_constant = 0.3;
+  param.steer_tau = 0.1;
+  param.weight_lat_error = 1.0;
+  param.weight_heading_error = 1.0;
+  param.weight_heading_error_squared_vel = 1.0;
+  param.weight_terminal_lat_error = 1.0;
+  param.weight_terminal_heading_error = 0.1;
+  param.low_curvature_weight_lat_error = 0.1;
+  param.low_curvature_weight_heading_error = 0.0;
+  param.low_curvature_weight_heading_error_squared_vel = 0.3;
+  param.weight_steering_input = 1.0;
+  param.weight_steering_input_squared_vel = 0.25;
+  param.weight_lat_jerk = 0.0;
+  param.weight_steer_rate = 0.0;
+  param.weight_steer_acc = 0.000001;
+  param.low_curvature_weight_steering_input = 1.0;
+  param.low_curvature_weight_steering_input_squared_vel = 0.25;
+  param.low_curvature_weight_lat_jerk = 0.0;
+  param.low_curvature_weight_steer_rate = 0.0;
+  param.low_curvature_weight_steer_acc = 0.000001;
+  param.low_curvature_thresh_curvature = 0.0;
+  mpc.m_param = param;
+  mpc.m_admissible_position_error = 5.0;
+  mpc.m_admissible_yaw_error_rad = M_PI_2;
+  mpc.m_steer_lim = 0.610865;
+  mpc.m_steer_rate_lim = 2.61799;
+  mpc.m_ctrl_period = 0.03;
+  mpc.m_use_steer_prediction = true;
+  mpc.initializeLowPassFilters(3.0, 5.0);
+  mpc.setReferenceTrajectory(make_trajectory(), 0.1, true, 35, true, 35);
+
+  VehicleKinematicState steer;
+  steer.state.front_wheel_angle_rad = 0.0F;
+  geometry_msgs::msg::Pose pose;
+  pose.position.x = 1.0;
+  pose.position.y = 0.2;
+  AckermannLateralCommand command;
+  int64_t num_failures{0};
+  for (auto _ : state) {
+    if (!mpc.calculateMPC(steer, kVelocity, pose, command)) {
+      ++num_failures;
+    }
+    benchmark::DoNotOptimize(command.steering_tire_angle);
+  }
+  state.counters["failures"] = static_cast<float64_t>(num_failures);
+}
+
+void MPCArgs(benchmark::internal::Benchmark * bench)
+{
+  bench->ArgNames({"horizon", "model"});
+  for (const int64_t horizon : {25, 50, 100}) {
+    for (const auto model : {Model::KINEMATICS, Model::DYNAMICS}) {
+      bench->Args({horizon, static_cast<int64_t>(model)});
+    }
+  }
+}
+}  // namespace
+
+BENCHMARK(BenchMPCCalculate)->Apply(MPCArgs)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,128 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+#include <kernel_benchmarks/fixtures.hpp>
+#include <ndt/ndt_map.hpp>
+#include <ndt/ndt_optimization_problem.hpp>
+#include <ndt/ndt_scan.hpp>
+#include <point_cloud_msg_wrapper/point_cloud_msg_wrapper.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
+
+#include <cstdint>
+
+namespace
+{
+using autoware::common::optimization::ComputeMode;
+using autoware::common::types::float64_t;
+using autoware::common::types::PointXYZI;
+using autoware::localization::ndt::DynamicNDTMap;
+using autoware::localization::ndt::EigenPose;
+using autoware::localization::ndt::P2DNDTObjective;
+using autoware::localization::ndt::P2DNDTOptimizationConfig;
+using autoware::localization::ndt::P2DNDTScan;
+using autoware::localization::ndt::Real;
+using autoware::localization::ndt::StaticNDTMap;
+using autoware::tools::kernel_benchmarks::available_scan_sources;
+using autoware::tools::kernel_benchmarks::Cloud;
+using autoware::tools::kernel_benchmarks::get_scan;
+using autoware::tools::kernel_benchmarks::ScanSource;
+
+constexpr auto kExtent = 130.0F;
+constexpr auto kMapVoxelSize = 2.0F;
+constexpr auto kScanVoxelSize = 1.0F;
+
+/// What the objective computes in an evaluation, the line search only needs the score and the
+/// jacobian, newton steps need the hessian as well
+enum class Derivatives : int64_t
+{
+  SCORE = 0,
+  JACOBIAN = 1,
+  HESSIAN = 2
+};
+
+sensor_msgs::msg::PointCloud2 make_cloud(const Cloud & scan)
+{
+  sensor_msgs::msg::PointCloud2 msg;
+  point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI> modifier{msg, "map"};
+  modifier.reserve(scan.size());
+  for (const auto & pt : scan) {
+    modifier.push_back({pt.x, pt.y, pt.z, pt.intensity});
+  }
+  return msg;
+}
+
+ComputeMode make_mode(const Derivatives derivatives)
+{
+  ComputeMode mode{};
+  (void)mode.set_score();
+  if (Derivatives::SCORE != derivatives) {
+    (void)mode.set_jacobian();
+  }
+  if (Derivatives::HESSIAN == derivatives) {
+    (void)mode.set_hessian();
+  }
+  return mode;
+}
+
+/// Evaluate the P2D objective of a downsampled scan against a map that is built from the same
+/// scan, at a pose that is slightly off, as in the iterations of a localization update
+void BenchNDTObjectiveEvaluate(benchmark::State & state)
+{
+  const auto cloud = make_cloud(get_scan(static_cast<ScanSource>(state.range(0))));
+  const auto mode = make_mode(static_cast<Derivatives>(state.range(1)));
+
+  geometry_msgs::msg::Point32 min_point;
+  min_point.set__x(-kExtent).set__y(-kExtent).set__z(-kExtent);
+  geometry_msgs::msg::Point32 max_point;
+  max_point.set__x(kExtent).set__y(kExtent).set__z(kExtent);
+  geometry_msgs::msg::Point32 voxel_size;
+  voxel_size.set__x(kMapVoxelSize).set__y(kMapVoxelSize).set__z(kMapVoxelSize);
+  const autoware::perception::filters::voxel_grid::Config grid_config{
+    min_point, max_point, voxel_size, 100000U};
+  DynamicNDTMap dynamic_map{grid_config};
+  dynamic_map.insert(cloud);
+  sensor_msgs::msg::PointCloud2 serialized_map;
+  dynamic_map.serialize_as<StaticNDTMap>(serialized_map);
+  StaticNDTMap map{};
+  map.set(serialized_map);
+
+  const P2DNDTScan scan{cloud, cloud.width, kScanVoxelSize};
+  P2DNDTObjective<StaticNDTMap> objective{scan, map, P2DNDTOptimizationConfig{0.55}};
+  EigenPose<Real> pose;
+  pose << 0.3, -0.2, 0.05, 0.0, 0.0, 0.02;
+
+  for (auto _ : state) {
+    objective.evaluate_(pose, mode);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(
+    static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(scan.size()));
+  state.counters["scan_points"] = static_cast<float64_t>(scan.size());
+}
+
+void NDTObjectiveArgs(benchmark::internal::Benchmark * bench)
+{
+  bench->ArgNames({"source", "derivatives"});
+  for (const auto source : available_scan_sources()) {
+    for (const auto derivatives :
+      {Derivatives::SCORE, Derivatives::JACOBIAN, Derivatives::HESSIAN})
+    {
+      bench->Args({static_cast<int64_t>(source), static_cast<int64_t>(derivatives)});
+    }
+  }
+}
+}  // namespace
+
+BENCHMARK(BenchNDTObjectiveEvaluate)->Apply(NDTObjectiveArgs)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,90 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+#include <kernel_benchmarks/fixtures.hpp>
+#include <ray_ground_classifier/ray_ground_classifier.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+using autoware::common::types::float64_t;
+using autoware::common::types::POINT_BLOCK_CAPACITY;
+using autoware::common::types::PointPtrBlock;
+using autoware::perception::filters::ray_ground_classifier::Config;
+using autoware::perception::filters::ray_ground_classifier::RayGroundClassifier;
+using autoware::tools::kernel_benchmarks::available_scan_sources;
+using autoware::tools::kernel_benchmarks::get_scan;
+using autoware::tools::kernel_benchmarks::kSensorHeight;
+using autoware::tools::kernel_benchmarks::ScanSource;
+using autoware::tools::kernel_benchmarks::split_into_rays;
+
+/// Number of rays of a revolution, about the ray width of 0.005 rad of the node
+constexpr std::size_t kNumRays = 1256U;
+
+/// Classify all rays of a scan, which are sorted by the classifier. The output blocks are emptied
+/// when they are full, as the node does when it publishes them
+void BenchRayGroundPartition(benchmark::State & state)
+{
+  const auto rays = split_into_rays(
+    get_scan(static_cast<ScanSource>(state.range(0))), kNumRays, POINT_BLOCK_CAPACITY);
+  const Config config{kSensorHeight, 10.0F, 3.0F, 20.0F, 0.05F, 1.5F, 1.8F, 2.0F};
+  RayGroundClassifier classifier{config};
+  PointPtrBlock ground;
+  PointPtrBlock nonground;
+  ground.reserve(POINT_BLOCK_CAPACITY);
+  nonground.reserve(POINT_BLOCK_CAPACITY);
+
+  std::size_t num_points{0U};
+  std::size_t num_ground{0U};
+  for (auto _ : state) {
+    num_points = 0U;
+    num_ground = 0U;
+    ground.clear();
+    nonground.clear();
+    for (const auto & ray : rays) {
+      for (const auto & pt : ray) {
+        classifier.insert(&pt);
+      }
+      if (!classifier.can_fit_result(ground, nonground)) {
+        num_ground += ground.size();
+        ground.clear();
+        nonground.clear();
+      }
+      classifier.partition(ground, nonground, false);
+      num_points += ray.size();
+    }
+    num_ground += ground.size();
+    benchmark::DoNotOptimize(ground.data());
+    benchmark::DoNotOptimize(nonground.data());
+  }
+  state.SetItemsProcessed(
+    static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(num_points));
+  state.counters["points"] = static_cast<float64_t>(num_points);
+  state.counters["ground_ratio"] =
+    static_cast<float64_t>(num_ground) / static_cast<float64_t>(num_points);
+}
+
+void RayGroundArgs(benchmark::internal::Benchmark * bench)
+{
+  bench->ArgName("source");
+  for (const auto source : available_scan_sources()) {
+    bench->Arg(static_cast<int64_t>(source));
+  }
+}
+}  // namespace
+
+BENCHMARK(BenchRayGroundPartition)->Apply(RayGroundArgs)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,76 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+#include <geometry/spatial_hash.hpp>
+#include <kernel_benchmarks/fixtures.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+using autoware::common::geometry::spatial_hash::Config2d;
+using autoware::common::geometry::spatial_hash::SpatialHash2d;
+using autoware::common::geometry::spatial_hash::StorageBackend;
+using autoware::common::types::float64_t;
+using autoware::tools::kernel_benchmarks::available_scan_sources;
+using autoware::tools::kernel_benchmarks::get_scan;
+using autoware::tools::kernel_benchmarks::PointXYZIF;
+using autoware::tools::kernel_benchmarks::ScanSource;
+
+constexpr auto kExtent = 100.0F;
+constexpr auto kRadius = 0.5F;
+/// Every n-th point of the scan is used as a query point
+constexpr std::size_t kQueryStride = 16U;
+
+/// Fixed radius queries around points of a scan that is stored in a 2D spatial hash, the
+/// neighborhood search of the euclidean clustering
+void BenchSpatialHashNear(benchmark::State & state)
+{
+  const auto & scan = get_scan(static_cast<ScanSource>(state.range(0)));
+  const auto backend = static_cast<StorageBackend>(state.range(1));
+  const Config2d config{-kExtent, kExtent, -kExtent, kExtent, kRadius, scan.size(), backend};
+  SpatialHash2d<PointXYZIF> hash{config};
+  hash.insert(scan.begin(), scan.end());
+  // The flat grid sorts the points on the first query, which is not part of a query
+  (void)hash.near(scan.front(), kRadius);
+
+  std::size_t num_queries{0U};
+  std::size_t num_neighbors{0U};
+  for (auto _ : state) {
+    for (std::size_t idx = 0U; idx < scan.size(); idx += kQueryStride) {
+      const auto & neighbors = hash.near(scan[idx], kRadius);
+      num_neighbors += neighbors.size();
+      ++num_queries;
+      benchmark::DoNotOptimize(neighbors.data());
+    }
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(num_queries));
+  state.counters["neighbors_per_query"] =
+    static_cast<float64_t>(num_neighbors) / static_cast<float64_t>(num_queries);
+}
+
+void SpatialHashArgs(benchmark::internal::Benchmark * bench)
+{
+  bench->ArgNames({"source", "backend"});
+  for (const auto source : available_scan_sources()) {
+    for (const auto backend : {StorageBackend::HASH_MAP, StorageBackend::FLAT_GRID}) {
+      bench->Args({static_cast<int64_t>(source), static_cast<int64_t>(backend)});
+    }
+  }
+}
+}  // namespace
+
+BENCHMARK(BenchSpatialHashNear)->Apply(SpatialHashArgs)->Unit(benchmark::kMicrosecond);
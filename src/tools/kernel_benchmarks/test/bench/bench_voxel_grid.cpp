@@ -0,0 +1,104 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+#include <kernel_benchmarks/fixtures.hpp>
+#include <voxel_grid/flat_voxel_grid.hpp>
+#include <voxel_grid/voxel_grid.hpp>
+#include <voxel_grid/voxels.hpp>
+
+#include <cstdint>
+#include <iterator>
+
+namespace
+{
+using autoware::common::types::float64_t;
+using autoware::perception::filters::voxel_grid::ApproximateVoxel;
+using autoware::perception::filters::voxel_grid::CentroidVoxel;
+using autoware::perception::filters::voxel_grid::Config;
+using autoware::perception::filters::voxel_grid::FlatVoxelGrid;
+using autoware::perception::filters::voxel_grid::PointXYZ;
+using autoware::perception::filters::voxel_grid::VoxelGrid;
+using autoware::tools::kernel_benchmarks::available_scan_sources;
+using autoware::tools::kernel_benchmarks::get_scan;
+using autoware::tools::kernel_benchmarks::PointXYZIF;
+using autoware::tools::kernel_benchmarks::ScanSource;
+
+constexpr auto kExtent = 130.0F;
+constexpr auto kVoxelSize = 0.2F;
+constexpr uint64_t kCapacity = 55000U;
+
+Config make_config()
+{
+  PointXYZ min_point;
+  min_point.set__x(-kExtent).set__y(-kExtent).set__z(-kExtent);
+  PointXYZ max_point;
+  max_point.set__x(kExtent).set__y(kExtent).set__z(kExtent);
+  PointXYZ voxel_size;
+  voxel_size.set__x(kVoxelSize).set__y(kVoxelSize).set__z(kVoxelSize);
+  return Config{min_point, max_point, voxel_size, kCapacity};
+}
+
+/// Insert a scan into the hash map based voxel grid and collect the voxels that were activated,
+/// as the voxel grid node does for every cloud
+template<typename VoxelT>
+void BenchVoxelGridInsert(benchmark::State & state)
+{
+  const auto & scan = get_scan(static_cast<ScanSource>(state.range(0)));
+  VoxelGrid<VoxelT> grid{make_config()};
+
+  std::size_t num_voxels{0U};
+  for (auto _ : state) {
+    grid.clear();
+    grid.insert(scan.begin(), scan.end());
+    const auto & voxels = grid.new_voxels();
+    num_voxels = static_cast<std::size_t>(std::distance(voxels.begin(), voxels.end()));
+  }
+  state.SetItemsProcessed(
+    static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(scan.size()));
+  state.counters["voxels"] = static_cast<float64_t>(num_voxels);
+}
+
+/// Insert a scan into the flat voxel grid and reduce it to centroids
+void BenchFlatVoxelGridInsert(benchmark::State & state)
+{
+  const auto & scan = get_scan(static_cast<ScanSource>(state.range(0)));
+  FlatVoxelGrid<CentroidVoxel<PointXYZIF>> grid{make_config(), scan.size()};
+
+  std::size_t num_voxels{0U};
+  for (auto _ : state) {
+    grid.insert(scan.begin(), scan.end());
+    const auto & voxels = grid.reduce();
+    num_voxels = voxels.size();
+    benchmark::DoNotOptimize(voxels.data());
+  }
+  state.SetItemsProcessed(
+    static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(scan.size()));
+  state.counters["voxels"] = static_cast<float64_t>(num_voxels);
+}
+
+void VoxelGridArgs(benchmark::internal::Benchmark * bench)
+{
+  bench->ArgName("source");
+  for (const auto source : available_scan_sources()) {
+    bench->Arg(static_cast<int64_t>(source));
+  }
+}
+}  // namespace
+
+BENCHMARK_TEMPLATE(BenchVoxelGridInsert, CentroidVoxel<PointXYZIF>)
+->Apply(VoxelGridArgs)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BenchVoxelGridInsert, ApproximateVoxel<PointXYZIF>)
+->Apply(VoxelGridArgs)->Unit(benchmark::kMillisecond);
+BENCHMARK(BenchFlatVoxelGridInsert)->Apply(VoxelGridArgs)->Unit(benchmark::kMillisecond);
@@ -20,9 +20,13 @@
 #include <rclcpp/rclcpp.hpp>
 #include <sensor_msgs/msg/point_cloud2.hpp>
 #include <autoware_auto_msgs/msg/bounding_box_array.hpp>
+#include <lidar_integration/load_ramp.hpp>
 #include <lidar_integration/visibility_control.hpp>
+#include <builtin_interfaces/msg/time.hpp>
 #include <common/types.hpp>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace lidar_integration
 {
@@ -59,10 +63,28 @@ public:
 
   virtual bool8_t is_success() const = 0;
 
+  /// \brief Measure a saturation test: sort the messages into the steps of a ramp which starts
+  ///        with the first message, and time them from their stamp. The expected period is the
+  ///        one at the nominal load. Must be called before spinning
+  /// \param[in] ramp The ramp the spoofers follow
+  /// \param[in] warmup_fraction The part of each step that isn't measured
+  /// \throw std::domain_error If the warm-up fraction isn't in [0, 1)
+  void enable_load_monitor(const LoadRamp & ramp, const float32_t warmup_fraction);
+
+  /// \brief The results of a saturation test
+  /// \return One result per step of the ramp, or none if the load monitor isn't enabled
+  std::vector<LoadStepResult> load_results() const;
+
 protected:
   // Update the statistics
   void callback(const uint32_t size);
 
+  // Update the statistics and the load monitor, if any
+  void callback(const uint32_t size, const builtin_interfaces::msg::Time & stamp);
+
+  // Whether a saturation test is measured, in which case messages aren't logged one by one
+  bool8_t is_load_monitored() const noexcept;
+
   bool8_t is_success(
     const rclcpp::SubscriptionBase * const sub_ptr,
     const char8_t * const src) const;
@@ -84,6 +106,7 @@ private:
   const float32_t m_relative_size_tolerance;
   const uint32_t m_expected_size;
   Statistics m_stats;
+  std::unique_ptr<LoadMonitor> m_load_monitor;
 };  // LidarIntegrationListener
 
 /// Specialization of the listener for point clouds
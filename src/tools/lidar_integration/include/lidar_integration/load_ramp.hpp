@@ -0,0 +1,176 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \file
+/// \brief The load ramp of the saturation tests and the evaluation of its steps
+
+#ifndef LIDAR_INTEGRATION__LOAD_RAMP_HPP_
+#define LIDAR_INTEGRATION__LOAD_RAMP_HPP_
+
+#include <common/types.hpp>
+#include <latency_tracing/trace_analysis.hpp>
+#include <lidar_integration/visibility_control.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace lidar_integration
+{
+using autoware::common::types::float32_t;
+using autoware::common::types::float64_t;
+using autoware::common::latency_tracing::LatencyStatistics;
+
+/// \brief The load of one step of a ramp, relative to the nominal load of the sensor
+struct LIDAR_INTEGRATION_PUBLIC LoadStep
+{
+  /// The factor on the nominal packet or cloud rate
+  float32_t rate_factor;
+  /// The factor on the nominal number of points of a cloud
+  float32_t size_factor;
+};
+
+/// \brief A load that rises in equally long steps from the nominal load to a maximum load.
+///
+/// The spoofers and the listener of a saturation test are configured with the same ramp and
+/// follow it independently, from when they start and from the first message respectively.
+class LIDAR_INTEGRATION_PUBLIC LoadRamp
+{
+public:
+  /// \brief Constructor
+  /// \param[in] num_steps The number of steps, the first one is the nominal load
+  /// \param[in] max_rate_factor The rate factor of the last step
+  /// \param[in] max_size_factor The size factor of the last step
+  /// \param[in] step_duration How long each step lasts
+  /// \throw std::domain_error If there are no steps, a factor is smaller than 1 or the step
+  ///        duration isn't positive
+  LoadRamp(
+    const std::size_t num_steps,
+    const float32_t max_rate_factor,
+    const float32_t max_size_factor,
+    const std::chrono::nanoseconds step_duration);
+
+  std::size_t num_steps() const noexcept;
+
+  /// \brief The load of a step, the factors rise linearly from 1 to their maximum
+  /// \param[in] idx The index of the step, smaller than num_steps()
+  LoadStep step(const std::size_t idx) const noexcept;
+
+  std::chrono::nanoseconds step_duration() const noexcept;
+
+  /// \brief The duration of the whole ramp
+  std::chrono::nanoseconds duration() const noexcept;
+
+  /// \brief The step that is active at a time
+  /// \param[in] elapsed The time since the start of the ramp
+  /// \return The index of the step, or num_steps() if the ramp is over
+  std::size_t step_at(const std::chrono::nanoseconds elapsed) const noexcept;
+
+private:
+  std::size_t m_num_steps;
+  float32_t m_max_rate_factor;
+  float32_t m_max_size_factor;
+  std::chrono::nanoseconds m_step_duration;
+};
+
+/// \brief What the listener measured during one step of a ramp
+struct LIDAR_INTEGRATION_PUBLIC LoadStepResult
+{
+  LoadStep step;
+  /// The messages per second the node under test should output at this step
+  float64_t offered_rate;
+  /// The messages received in the measurement window of the step
+  std::size_t received;
+  /// The received messages per second
+  float64_t throughput;
+  /// The fraction of the offered messages that didn't arrive, 0 if more arrived
+  float64_t drop_rate;
+  /// The mean size of the received messages, e.g. points or boxes
+  float64_t mean_size;
+  /// From the stamp of a message to its reception
+  LatencyStatistics latency;
+};
+
+/// \brief Sorts the messages of a saturation test into the steps of the ramp and evaluates them.
+///
+/// The first part of each step is a warm-up in which the messages aren't counted, so that the
+/// queues of the node under test settle at the new load. Memory for the given number of messages
+/// per step is reserved on construction.
+class LIDAR_INTEGRATION_PUBLIC LoadMonitor
+{
+public:
+  /// \brief Constructor
+  /// \param[in] ramp The ramp the spoofers follow
+  /// \param[in] nominal_rate_hz The rate at which the node under test outputs messages at the
+  ///            nominal load
+  /// \param[in] warmup_fraction The part of each step that isn't measured
+  /// \param[in] reserved_per_step The number of messages to reserve memory for in each step
+  /// \throw std::domain_error If the nominal rate isn't positive or the warm-up fraction isn't
+  ///        in [0, 1)
+  LoadMonitor(
+    const LoadRamp & ramp,
+    const float32_t nominal_rate_hz,
+    const float32_t warmup_fraction,
+    const std::size_t reserved_per_step = 0U);
+
+  /// \brief Record a received message
+  /// \param[in] elapsed The time since the start of the ramp
+  /// \param[in] size The size of the message
+  /// \param[in] latency_ns The time from the stamp of the message to its reception
+  void record(
+    const std::chrono::nanoseconds elapsed,
+    const uint32_t size,
+    const int64_t latency_ns);
+
+  /// \brief Evaluate the steps
+  /// \return One result per step of the ramp
+  std::vector<LoadStepResult> results() const;
+
+private:
+  struct StepRecord
+  {
+    std::vector<int64_t> latencies_ns;
+    uint64_t total_size;
+  };
+
+  LoadRamp m_ramp;
+  float64_t m_nominal_rate_hz;
+  std::chrono::nanoseconds m_warmup;
+  std::vector<StepRecord> m_steps{};
+};
+
+/// \brief Find the first step at which the node under test didn't keep up anymore
+/// \param[in] results The results of the steps, in the order of the ramp
+/// \param[in] max_drop_rate The highest drop rate at which the node keeps up
+/// \param[in] max_p99_latency_ms The highest 99th percentile of the latency at which the node
+///            keeps up
+/// \return The index of the step, or results.size() if the node kept up at all steps
+LIDAR_INTEGRATION_PUBLIC std::size_t find_saturation_point(
+  const std::vector<LoadStepResult> & results,
+  const float64_t max_drop_rate,
+  const float64_t max_p99_latency_ms);
+
+/// \brief Print the results of the steps as a table and the saturation point below it
+/// \param[inout] stream The stream to print to
+/// \param[in] results The results of the steps
+/// \param[in] saturation_point The result of find_saturation_point()
+LIDAR_INTEGRATION_PUBLIC void print_load_results(
+  std::ostream & stream,
+  const std::vector<LoadStepResult> & results,
+  const std::size_t saturation_point);
+}  // namespace lidar_integration
+
+#endif  // LIDAR_INTEGRATION__LOAD_RAMP_HPP_
@@ -21,8 +21,10 @@
 #include <sensor_msgs/msg/point_cloud2.hpp>
 #include <lidar_integration/visibility_control.hpp>
 
+#include <atomic>
 #include <memory>
 #include <random>
+#include <thread>
 
 namespace lidar_integration
 {
@@ -32,7 +34,8 @@ using autoware::common::types::bool8_t;
 using autoware::common::types::char8_t;
 
 /// \brief Spoofs random point clouds which may or may not be properly formatted.
-/// Intended for use with mutation testing
+/// Intended for use with mutation testing. In load mode, it rather spoofs well-formed clouds at
+/// a given rate and size for saturation testing, see set_load().
 class LIDAR_INTEGRATION_PUBLIC PointCloudMutationSpooferNode : public rclcpp::Node
 {
 public:
@@ -50,6 +53,13 @@ public:
 
   void stop();
 
+  /// \brief Switch to load mode: publish well-formed clouds of a synthetic scene at a fixed
+  ///        rate, stamped with the time of their publication. May be called while running
+  /// \param[in] freq The publishing frequency
+  /// \param[in] width The number of points of the clouds
+  /// \throw std::domain_error If the frequency or the width isn't positive
+  void set_load(const float32_t freq, const uint32_t width);
+
 protected:
   void wait_for_matched(
     const uint32_t num_expected_subs,
@@ -58,6 +68,8 @@ protected:
   void task_function();
 
 private:
+  void publish_load_cloud();
+
   rclcpp::Publisher<sensor_msgs::msg::PointCloud2>::SharedPtr m_pub;
   sensor_msgs::msg::PointCloud2 m_msg;
 
@@ -69,6 +81,11 @@ private:
   std::uniform_int_distribution<uint16_t> m_dice;
 
   uint32_t m_sleep_time;
+  /// The publishing period in load mode, 0 if not in load mode
+  std::atomic<int64_t> m_load_period_ns;
+  std::atomic<uint32_t> m_load_width;
+  /// The width of the cloud in m_msg in load mode, only accessed by the task
+  uint32_t m_load_msg_width;
   std::thread m_thread;
   std::atomic_bool m_running;
 };  // Spoofer
@@ -45,6 +45,12 @@ public:
 
   const uint32_t & send_count() const {return m_spoofer.send_count();}
 
+  /// \brief Send the packets faster or slower than the sensor, e.g. for a saturation test. The
+  ///        rotation per packet stays the same, so that the clouds keep their size
+  /// \param[in] factor The factor on the packet rate of the sensor, may be changed while running
+  /// \throw std::domain_error If the factor isn't positive
+  void set_rate_factor(const float32_t factor) {m_spoofer.set_rate_factor(factor);}
+
   /// rpm min speed
   static constexpr float32_t MIN_RPM = 300.0F;
   /// rpm max speed
@@ -62,6 +68,8 @@ public:
 
     const uint32_t & send_count() const {return m_send_count;}
 
+    void set_rate_factor(const float32_t factor);
+
     void start()
     {
       m_thread = std::thread{[this] {task_function();}};
@@ -145,7 +153,8 @@ private:
     Packet m_all_flat_ground_packet;
     Packet m_flat_ground_wall_packet;
     const std::atomic_bool & m_running;
-    const std::chrono::nanoseconds m_send_period;
+    const std::chrono::nanoseconds m_nominal_send_period;
+    std::atomic<int64_t> m_send_period_ns;
     uint16_t m_azimuth_increment;
     uint32_t m_send_count = 0;
     std::thread m_thread;
@@ -15,8 +15,11 @@
 // Co-developed by Tier IV, Inc. and Apex.AI, Inc.
 
 #include <common/types.hpp>
+#include <chrono>
 #include <cmath>
+#include <memory>
 #include <string>
+#include <vector>
 #include "lidar_integration/lidar_integration_listener.hpp"
 
 namespace lidar_integration
@@ -56,7 +59,47 @@ void LidarIntegrationListener::callback(const uint32_t size)
   m_stats.total_size += size;
   m_stats.last_pub_time = right_now;
   ++m_stats.count;
-  RCLCPP_INFO(get_logger(), "callback. count is now: %u", m_stats.count);
+  if (!is_load_monitored()) {
+    RCLCPP_INFO(get_logger(), "callback. count is now: %u", m_stats.count);
+  }
+}
+
+void LidarIntegrationListener::callback(
+  const uint32_t size,
+  const builtin_interfaces::msg::Time & stamp)
+{
+  const auto latency = now() - rclcpp::Time{stamp};
+  callback(size);
+  if (m_load_monitor) {
+    m_load_monitor->record(
+      m_stats.last_pub_time - m_stats.first_pub_time, size, latency.nanoseconds());
+  }
+}
+
+bool8_t LidarIntegrationListener::is_load_monitored() const noexcept
+{
+  return nullptr != m_load_monitor;
+}
+
+void LidarIntegrationListener::enable_load_monitor(
+  const LoadRamp & ramp,
+  const float32_t warmup_fraction)
+{
+  const float32_t nominal_rate_hz = 1.0E6F / m_expected_period_us;
+  // Reserve for the highest rate, so that the measurement doesn't allocate
+  const auto reserved_per_step = static_cast<std::size_t>(
+    static_cast<float64_t>(nominal_rate_hz * ramp.step(ramp.num_steps() - 1U).rate_factor) *
+    std::chrono::duration<float64_t>{ramp.step_duration()}.count()) + 1U;
+  m_load_monitor =
+    std::make_unique<LoadMonitor>(ramp, nominal_rate_hz, warmup_fraction, reserved_per_step);
+  RCLCPP_INFO(
+    get_logger(), "Load monitor enabled: %zu steps of %.1f s", ramp.num_steps(),
+    std::chrono::duration<float64_t>{ramp.step_duration()}.count());
+}
+
+std::vector<LoadStepResult> LidarIntegrationListener::load_results() const
+{
+  return m_load_monitor ? m_load_monitor->results() : std::vector<LoadStepResult>{};
 }
 
 LidarIntegrationListener::LidarIntegrationListener(
@@ -205,8 +248,10 @@ LidarIntegrationPclListener::LidarIntegrationPclListener(
   m_sub_ptr{create_subscription<PointCloud2>(
       topic, rclcpp::QoS(rclcpp::KeepLast(20)),
       [this](const PointCloud2::SharedPtr msg_ptr) {
-        this->callback(msg_ptr->width);
-        RCLCPP_INFO(get_logger(), "\tdata length: %u", msg_ptr->data.size());
+        this->callback(msg_ptr->width, msg_ptr->header.stamp);
+        if (!is_load_monitored()) {
+          RCLCPP_INFO(get_logger(), "\tdata length: %u", msg_ptr->data.size());
+        }
       })}
 {
   RCLCPP_INFO(get_logger(), ("\tpcl_topic1: " + topic).c_str());
@@ -232,7 +277,7 @@ LidarIntegrationBoxListener::LidarIntegrationBoxListener(
   m_sub_ptr{create_subscription<BoundingBoxArray>(
       topic, rclcpp::QoS(rclcpp::KeepLast(20)),
       [this](const BoundingBoxArray::SharedPtr msg_ptr) {
-        this->callback(static_cast<uint32_t>(msg_ptr->boxes.size()));
+        this->callback(static_cast<uint32_t>(msg_ptr->boxes.size()), msg_ptr->header.stamp);
       })}
 {
   RCLCPP_INFO(get_logger(), ("\tbox_topic: " + topic).c_str());
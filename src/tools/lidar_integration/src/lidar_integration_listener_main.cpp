@@ -18,11 +18,14 @@
 #include <signal.h>
 #include <rcutils/cmdline_parser.h>
 #include <rclcpp/rclcpp.hpp>
+#include <algorithm>
+#include <iostream>
 #include <thread>
 #include <chrono>
 #include <string>
 #include <memory>
 #include "lidar_integration/lidar_integration_listener.hpp"
+#include "lidar_integration/load_ramp.hpp"
 #include "lidar_lc_integration_listener.hpp"
 
 using autoware::common::types::float32_t;
@@ -108,6 +111,56 @@ int32_t main(const int32_t argc, char8_t ** const argv)
     if (nullptr != arg) {
       runtime = std::stof(arg);
     }
+    // Saturation test
+    help_msg << "--load_steps\tif positive, measure a load ramp with this many steps\t" <<
+      "Default=0" << std::endl;
+    arg = rcutils_cli_get_option(argv, &argv[argc], "--load_steps");
+    std::size_t load_steps = 0U;
+    if (nullptr != arg) {
+      load_steps = static_cast<std::size_t>(std::stoul(arg));
+    }
+    help_msg << "--load_step_duration\tduration of each step of the load ramp (s)\t" <<
+      "Default=10" << std::endl;
+    arg = rcutils_cli_get_option(argv, &argv[argc], "--load_step_duration");
+    float32_t load_step_duration = 10.0F;
+    if (nullptr != arg) {
+      load_step_duration = std::stof(arg);
+    }
+    help_msg << "--load_max_rate\trate factor of the last step of the load ramp\t" <<
+      "Default=2" << std::endl;
+    arg = rcutils_cli_get_option(argv, &argv[argc], "--load_max_rate");
+    float32_t load_max_rate = 2.0F;
+    if (nullptr != arg) {
+      load_max_rate = std::stof(arg);
+    }
+    help_msg << "--load_max_size\tsize factor of the last step of the load ramp\t" <<
+      "Default=1" << std::endl;
+    arg = rcutils_cli_get_option(argv, &argv[argc], "--load_max_size");
+    float32_t load_max_size = 1.0F;
+    if (nullptr != arg) {
+      load_max_size = std::stof(arg);
+    }
+    help_msg << "--load_warmup\tpart of each step that isn't measured\t" <<
+      "Default=0.2" << std::endl;
+    arg = rcutils_cli_get_option(argv, &argv[argc], "--load_warmup");
+    float32_t load_warmup = 0.2F;
+    if (nullptr != arg) {
+      load_warmup = std::stof(arg);
+    }
+    help_msg << "--load_max_drop_rate\thighest drop rate of an unsaturated step\t" <<
+      "Default=0.05" << std::endl;
+    arg = rcutils_cli_get_option(argv, &argv[argc], "--load_max_drop_rate");
+    float64_t load_max_drop_rate = 0.05;
+    if (nullptr != arg) {
+      load_max_drop_rate = std::stod(arg);
+    }
+    help_msg << "--load_max_latency\thighest p99 latency of an unsaturated step (ms)\t" <<
+      "Default=period" << std::endl;
+    arg = rcutils_cli_get_option(argv, &argv[argc], "--load_max_latency");
+    float64_t load_max_latency = static_cast<float64_t>(period);
+    if (nullptr != arg) {
+      load_max_latency = std::stod(arg);
+    }
     help_msg << "--lifecycle_node\tif present, will assume this is a lifecycle node\t" << std::endl;
     const bool8_t lifecycle_node = rcutils_cli_option_exist(argv, &argv[argc], "--lifecycle_node");
     bool8_t needs_help = rcutils_cli_option_exist(argv, &argv[argc], "-h");
@@ -144,6 +197,17 @@ int32_t main(const int32_t argc, char8_t ** const argv)
       default:
         throw std::logic_error{"Impossible case"};
     }
+    std::unique_ptr<lidar_integration::LoadRamp> load_ramp;
+    if (0U != load_steps) {
+      load_ramp = std::make_unique<lidar_integration::LoadRamp>(
+        load_steps, load_max_rate, load_max_size,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::duration<float32_t>{load_step_duration}));
+      nd_ptr->enable_load_monitor(*load_ramp, load_warmup);
+      // The ramp starts with the first message, leave some time for the nodes to come up
+      runtime = std::max(
+        runtime, std::chrono::duration<float32_t>{load_ramp->duration()}.count() + 10.0F);
+    }
     LIDAR_INTEGRATION_INFO("listener construct");
     rclcpp::executors::SingleThreadedExecutor exec;
 
@@ -177,7 +241,17 @@ int32_t main(const int32_t argc, char8_t ** const argv)
     LIDAR_INTEGRATION_INFO("Listener done");
     LIDAR_INTEGRATION_INFO("Lidar integration test listener is done.");
     ret = 0;
-    if (!nd_ptr->is_success()) {
+    if (load_ramp) {
+      // The period and the size change along the ramp, so only report them
+      const auto results = nd_ptr->load_results();
+      lidar_integration::print_load_results(
+        std::cout, results,
+        lidar_integration::find_saturation_point(results, load_max_drop_rate, load_max_latency));
+      if (0U == results.front().received) {
+        ret = ret + (1 << 0U);
+        LIDAR_INTEGRATION_FATAL("failed: no messages at the nominal load");
+      }
+    } else if (!nd_ptr->is_success()) {
       ret = ret + (1 << 0U);
       LIDAR_INTEGRATION_FATAL("failed");
     }
@@ -0,0 +1,194 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lidar_integration/load_ramp.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <stdexcept>
+#include <utility>
+
+namespace lidar_integration
+{
+////////////////////////////////////////////////////////////////////////////////
+LoadRamp::LoadRamp(
+  const std::size_t num_steps,
+  const float32_t max_rate_factor,
+  const float32_t max_size_factor,
+  const std::chrono::nanoseconds step_duration)
+: m_num_steps{num_steps},
+  m_max_rate_factor{max_rate_factor},
+  m_max_size_factor{max_size_factor},
+  m_step_duration{step_duration}
+{
+  if (0U == num_steps) {
+    throw std::domain_error{"LoadRamp: there must be at least one step"};
+  }
+  if ((max_rate_factor < 1.0F) || (max_size_factor < 1.0F)) {
+    throw std::domain_error{"LoadRamp: the load must not fall below the nominal load"};
+  }
+  if (step_duration.count() <= 0) {
+    throw std::domain_error{"LoadRamp: the step duration must be positive"};
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::size_t LoadRamp::num_steps() const noexcept
+{
+  return m_num_steps;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+LoadStep LoadRamp::step(const std::size_t idx) const noexcept
+{
+  if (1U == m_num_steps) {
+    return LoadStep{m_max_rate_factor, m_max_size_factor};
+  }
+  const auto fraction = static_cast<float32_t>(idx) / static_cast<float32_t>(m_num_steps - 1U);
+  return LoadStep{
+    1.0F + (fraction * (m_max_rate_factor - 1.0F)),
+    1.0F + (fraction * (m_max_size_factor - 1.0F))};
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::chrono::nanoseconds LoadRamp::step_duration() const noexcept
+{
+  return m_step_duration;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::chrono::nanoseconds LoadRamp::duration() const noexcept
+{
+  return m_step_duration * static_cast<int64_t>(m_num_steps);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::size_t LoadRamp::step_at(const std::chrono::nanoseconds elapsed) const noexcept
+{
+  if (elapsed.count() < 0) {
+    return 0U;
+  }
+  return std::min(m_num_steps, static_cast<std::size_t>(elapsed / m_step_duration));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+LoadMonitor::LoadMonitor(
+  const LoadRamp & ramp,
+  const float32_t nominal_rate_hz,
+  const float32_t warmup_fraction,
+  const std::size_t reserved_per_step)
+: m_ramp{ramp},
+  m_nominal_rate_hz{static_cast<float64_t>(nominal_rate_hz)},
+  m_warmup{std::chrono::duration_cast<std::chrono::nanoseconds>(
+      ramp.step_duration() * static_cast<float64_t>(warmup_fraction))}
+{
+  if (nominal_rate_hz <= 0.0F) {
+    throw std::domain_error{"LoadMonitor: the nominal rate must be positive"};
+  }
+  if ((warmup_fraction < 0.0F) || (warmup_fraction >= 1.0F)) {
+    throw std::domain_error{"LoadMonitor: the warm-up fraction must be in [0, 1)"};
+  }
+  m_steps.resize(ramp.num_steps());
+  for (auto & step : m_steps) {
+    step.latencies_ns.reserve(reserved_per_step);
+    step.total_size = 0U;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void LoadMonitor::record(
+  const std::chrono::nanoseconds elapsed,
+  const uint32_t size,
+  const int64_t latency_ns)
+{
+  const auto idx = m_ramp.step_at(elapsed);
+  if (idx >= m_steps.size()) {
+    return;
+  }
+  const auto since_step_start = elapsed - (m_ramp.step_duration() * static_cast<int64_t>(idx));
+  if (since_step_start < m_warmup) {
+    return;
+  }
+  auto & step = m_steps[idx];
+  step.latencies_ns.push_back(latency_ns);
+  step.total_size += size;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::vector<LoadStepResult> LoadMonitor::results() const
+{
+  const auto window_s =
+    std::chrono::duration<float64_t>{m_ramp.step_duration() - m_warmup}.count();
+  std::vector<LoadStepResult> ret;
+  ret.reserve(m_steps.size());
+  for (std::size_t idx = 0U; idx < m_steps.size(); ++idx) {
+    const auto & record = m_steps[idx];
+    LoadStepResult result{};
+    result.step = m_ramp.step(idx);
+    result.offered_rate = m_nominal_rate_hz * static_cast<float64_t>(result.step.rate_factor);
+    result.received = record.latencies_ns.size();
+    result.throughput = static_cast<float64_t>(result.received) / window_s;
+    result.drop_rate = std::max(0.0, 1.0 - (result.throughput / result.offered_rate));
+    if (0U != result.received) {
+      result.mean_size =
+        static_cast<float64_t>(record.total_size) / static_cast<float64_t>(result.received);
+    }
+    result.latency = autoware::common::latency_tracing::compute_statistics(record.latencies_ns);
+    ret.push_back(std::move(result));
+  }
+  return ret;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::size_t find_saturation_point(
+  const std::vector<LoadStepResult> & results,
+  const float64_t max_drop_rate,
+  const float64_t max_p99_latency_ms)
+{
+  const auto saturated = std::find_if(
+    results.begin(), results.end(), [max_drop_rate, max_p99_latency_ms](const auto & result) {
+      return (result.drop_rate > max_drop_rate) || (result.latency.p99 > max_p99_latency_ms);
+    });
+  return static_cast<std::size_t>(std::distance(results.begin(), saturated));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void print_load_results(
+  std::ostream & stream,
+  const std::vector<LoadStepResult> & results,
+  const std::size_t saturation_point)
+{
+  const auto flags = stream.flags();
+  const auto precision = stream.precision();
+  stream << "step,rate_factor,size_factor,offered_hz,throughput_hz,drop_rate,mean_size," <<
+    "p50_ms,p99_ms,max_ms\n";
+  stream << std::fixed << std::setprecision(3);
+  for (std::size_t idx = 0U; idx < results.size(); ++idx) {
+    const auto & result = results[idx];
+    stream << idx << "," << result.step.rate_factor << "," << result.step.size_factor << "," <<
+      result.offered_rate << "," << result.throughput << "," << result.drop_rate << "," <<
+      result.mean_size << "," << result.latency.p50 << "," << result.latency.p99 << "," <<
+      result.latency.max << "\n";
+  }
+  if (saturation_point < results.size()) {
+    const auto & result = results[saturation_point];
+    stream << "Saturated at step " << saturation_point << ": " << result.offered_rate <<
+      " Hz offered, size factor " << result.step.size_factor << "\n";
+  } else {
+    stream << "Not saturated up to the last step\n";
+  }
+  (void)stream.flags(flags);
+  (void)stream.precision(precision);
+}
+}  // namespace lidar_integration
@@ -16,6 +16,10 @@
 
 #include <common/types.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
 #include <string>
 #include <thread>
 
@@ -40,6 +44,9 @@ PointCloudMutationSpooferNode::PointCloudMutationSpooferNode(
   m_dis_data(0, 255),
   m_dice(0, 16),
   m_sleep_time(static_cast<uint32_t>(1000UL / freq)),
+  m_load_period_ns(0),
+  m_load_width(0U),
+  m_load_msg_width(0U),
   m_running(false)
 {
   m_mt.seed(m_rd());
@@ -101,9 +108,56 @@ void PointCloudMutationSpooferNode::stop()
   }
 }
 
+void PointCloudMutationSpooferNode::set_load(const float32_t freq, const uint32_t width)
+{
+  if ((freq <= 0.0F) || (0U == width)) {
+    throw std::domain_error{
+            "PointCloudMutationSpooferNode: the load frequency and width must be positive"};
+  }
+  m_load_width.store(width, std::memory_order_relaxed);
+  m_load_period_ns.store(
+    static_cast<int64_t>(1.0E9 / static_cast<float64_t>(freq)), std::memory_order_relaxed);
+}
+
+void PointCloudMutationSpooferNode::publish_load_cloud()
+{
+  const uint32_t width = m_load_width.load(std::memory_order_relaxed);
+  if (width != m_load_msg_width) {
+    // A ring of points around the sensor, so that filters do their usual amount of work
+    m_msg.width = width;
+    m_msg.row_step = width * m_msg.point_step;
+    m_msg.data.resize(static_cast<std::size_t>(m_msg.row_step));
+    for (uint32_t idx = 0U; idx < width; ++idx) {
+      const float32_t angle =
+        6.2831853F * static_cast<float32_t>(idx) / static_cast<float32_t>(width);
+      const float32_t range = 5.0F + static_cast<float32_t>(idx % 16U) * 3.0F;
+      const float32_t point[4U] = {
+        range * std::cos(angle),
+        range * std::sin(angle),
+        -1.5F + static_cast<float32_t>(idx % 16U) * 0.2F,
+        static_cast<float32_t>(idx % 256U)};
+      (void)std::memcpy(
+        &m_msg.data[static_cast<std::size_t>(idx) * m_msg.point_step], point, sizeof(point));
+    }
+    m_load_msg_width = width;
+  }
+  m_msg.header.stamp = now();
+  m_pub->publish(m_msg);
+}
+
 void PointCloudMutationSpooferNode::task_function()
 {
+  auto next_load_publish = std::chrono::steady_clock::now();
   while (m_running.load(std::memory_order_relaxed)) {
+    const std::chrono::nanoseconds load_period{m_load_period_ns.load(std::memory_order_relaxed)};
+    if (load_period.count() > 0) {
+      publish_load_cloud();
+      // Keep to the rate, but don't make up for publications that were late
+      next_load_publish = std::max(
+        next_load_publish + load_period, std::chrono::steady_clock::now());
+      std::this_thread::sleep_until(next_load_publish);
+      continue;
+    }
     m_msg.width = static_cast<uint32_t>(m_dis_width(m_mt));
 
     uint32_t data_length = static_cast<uint32_t>(m_dis_row_step(m_mt));
@@ -18,8 +18,11 @@
 #include <rcutils/cmdline_parser.h>
 #include <common/types.hpp>
 #include <lidar_integration/lidar_integration_common.hpp>
+#include <lidar_integration/load_ramp.hpp>
 #include <lidar_integration/point_cloud_mutation_spoofer.hpp>
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <string>
 #include <memory>
@@ -87,6 +90,36 @@ int32_t main(const int32_t argc, char8_t ** const argv)
     topic = arg;
   }
 
+  help_msg << "--load_steps\tIf positive, publish well-formed clouds of --w_mean points at " <<
+    "--freq and ramp both up in this many steps instead of running for --runtime\t" <<
+    "Default=0" << std::endl;
+  arg = rcutils_cli_get_option(argv, &argv[argc], "--load_steps");
+  std::size_t load_steps = 0U;
+  if (nullptr != arg) {
+    load_steps = static_cast<std::size_t>(std::stoul(arg));
+  }
+  help_msg << "--load_step_duration\tDuration of each step of the load ramp (s)\t" <<
+    "Default=10" << std::endl;
+  arg = rcutils_cli_get_option(argv, &argv[argc], "--load_step_duration");
+  float32_t load_step_duration = 10.0F;
+  if (nullptr != arg) {
+    load_step_duration = std::stof(arg);
+  }
+  help_msg << "--load_max_rate\tFactor on the frequency at the last step\t" <<
+    "Default=2" << std::endl;
+  arg = rcutils_cli_get_option(argv, &argv[argc], "--load_max_rate");
+  float32_t load_max_rate = 2.0F;
+  if (nullptr != arg) {
+    load_max_rate = std::stof(arg);
+  }
+  help_msg << "--load_max_size\tFactor on the width at the last step\t" <<
+    "Default=1" << std::endl;
+  arg = rcutils_cli_get_option(argv, &argv[argc], "--load_max_size");
+  float32_t load_max_size = 1.0F;
+  if (nullptr != arg) {
+    load_max_size = std::stof(arg);
+  }
+
   bool8_t needs_help = rcutils_cli_option_exist(argv, &argv[argc], "-h");
   needs_help = rcutils_cli_option_exist(argv, &argv[argc], "--help") || needs_help;
   if (needs_help) {
@@ -109,18 +142,47 @@ int32_t main(const int32_t argc, char8_t ** const argv)
     w_std,
     freq
   );
+  std::unique_ptr<lidar_integration::LoadRamp> load_ramp;
+  const auto set_load_step = [&spoof, &load_ramp, freq, w_mean](const std::size_t step) {
+      const auto load = load_ramp->step(step);
+      const auto width = static_cast<uint32_t>(static_cast<float32_t>(w_mean) * load.size_factor);
+      spoof->set_load(freq * load.rate_factor, width);
+      LIDAR_INTEGRATION_INFO(
+        "Load step %zu: %.1f Hz, %u points", step,
+        static_cast<float64_t>(freq * load.rate_factor), width);
+    };
+  if (0U != load_steps) {
+    load_ramp = std::make_unique<lidar_integration::LoadRamp>(
+      load_steps, load_max_rate, load_max_size,
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::duration<float32_t>{load_step_duration}));
+    set_load_step(0U);
+  }
   spoof->init();
   spoof->start();
 
   LIDAR_INTEGRATION_INFO("Spoofer started.");
   std::cout << "Spoofer(s) number is: 1" << std::endl;
 
-  const auto end = std::chrono::seconds(static_cast<int64_t>(runtime)) +
-    std::chrono::steady_clock::now();
+  const auto start = std::chrono::steady_clock::now();
+  auto end = std::chrono::seconds(static_cast<int64_t>(runtime)) + start;
+  if (load_ramp) {
+    // Hold the last step for a while, the listener starts its ramp with the first cloud
+    end = start + load_ramp->duration() + load_ramp->step_duration();
+  }
+  std::size_t load_step = 0U;
   while (rclcpp::ok()) {
-    if (std::chrono::steady_clock::now() > end) {
+    const auto right_now = std::chrono::steady_clock::now();
+    if (right_now > end) {
       break;
     }
+    if (load_ramp) {
+      const auto step = std::min(load_ramp->step_at(right_now - start), load_steps - 1U);
+      if (step != load_step) {
+        load_step = step;
+        set_load_step(step);
+      }
+    }
     std::this_thread::sleep_for(std::chrono::milliseconds(10U));
   }
 
@@ -16,6 +16,9 @@
 
 #include <common/types.hpp>
 
+#include <algorithm>
+#include <stdexcept>
+
 #include "lidar_integration/vlp16_integration_spoofer.hpp"
 
 using autoware::common::types::bool8_t;
@@ -66,8 +69,9 @@ Vlp16IntegrationSpoofer::SpoofTask::SpoofTask(
   m_all_flat_ground_packet({}),
   m_flat_ground_wall_packet({}),
   m_running(running),
-  m_send_period(std::chrono::microseconds(1000000LL / 754LL)),
+  m_nominal_send_period(std::chrono::microseconds(1000000LL / 754LL)),
   // 754 packets/second, from spec sheet
+  m_send_period_ns(m_nominal_send_period.count()),
   m_azimuth_increment(0)
 {
   initialize_packets(rpm);
@@ -78,6 +82,16 @@ Vlp16IntegrationSpoofer::SpoofTask::SpoofTask(
   m_azimuth_increment = static_cast<uint16_t>(dth_tic);
 }
 
+void Vlp16IntegrationSpoofer::SpoofTask::set_rate_factor(const float32_t factor)
+{
+  if (factor <= 0.0F) {
+    throw std::domain_error{"Vlp16IntegrationSpoofer: the rate factor must be positive"};
+  }
+  m_send_period_ns.store(
+    static_cast<int64_t>(static_cast<float64_t>(m_nominal_send_period.count()) / factor),
+    std::memory_order_relaxed);
+}
+
 void Vlp16IntegrationSpoofer::SpoofTask::task_function()
 {
   using namespace std::chrono_literals;   // NOLINT
@@ -87,8 +101,9 @@ void Vlp16IntegrationSpoofer::SpoofTask::task_function()
   bool8_t just_sent_all_ground = true;
   update_packet_azimuth(m_all_flat_ground_packet, m_azimuth_increment);
   while (m_running.load(std::memory_order_relaxed)) {
+    const std::chrono::nanoseconds send_period{m_send_period_ns.load(std::memory_order_relaxed)};
     const steady_clock::time_point right_now(steady_clock::now());
-    if ((right_now - last_send_time) > m_send_period) {
+    if ((right_now - last_send_time) > send_period) {
       if (just_sent_all_ground) {
         // update azimuth
         update_packet_azimuth(
@@ -103,11 +118,16 @@ void Vlp16IntegrationSpoofer::SpoofTask::task_function()
         m_udp_sender.send(m_all_flat_ground_packet);
       }
       just_sent_all_ground = !just_sent_all_ground;
-      last_send_time = right_now;
+      // Keep to the packet rate despite the polling, unless more than a packet behind
+      last_send_time += send_period;
+      if ((right_now - last_send_time) > send_period) {
+        last_send_time = right_now;
+      }
       m_send_count += 1;
     }
 
-    std::this_thread::sleep_for(100us);
+    // Poll fast enough for the packet rate of a saturation test
+    std::this_thread::sleep_for(std::min<std::chrono::nanoseconds>(100us, send_period / 2));
   }
 }
 
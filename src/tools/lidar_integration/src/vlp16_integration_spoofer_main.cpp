@@ -18,8 +18,11 @@
 #include <rcutils/cmdline_parser.h>
 #include <common/types.hpp>
 #include <lidar_integration/lidar_integration_common.hpp>
+#include <lidar_integration/load_ramp.hpp>
 #include <lidar_integration/vlp16_integration_spoofer.hpp>
 
+#include <algorithm>
+#include <memory>
 #include <string>
 #include <thread>
 #include <chrono>
@@ -94,6 +97,22 @@ int32_t main(const int32_t argc, char8_t ** const argv)
     if (nullptr != arg) {
       port4 = static_cast<uint16_t>(std::stoul(arg));
     }
+    // saturation test
+    arg = rcutils_cli_get_option(argv, &argv[argc], "--load_steps");
+    std::size_t load_steps = 0U;
+    if (nullptr != arg) {
+      load_steps = static_cast<std::size_t>(std::stoul(arg));
+    }
+    arg = rcutils_cli_get_option(argv, &argv[argc], "--load_step_duration");
+    float32_t load_step_duration = 10.0F;
+    if (nullptr != arg) {
+      load_step_duration = std::stof(arg);
+    }
+    arg = rcutils_cli_get_option(argv, &argv[argc], "--load_max_rate");
+    float32_t load_max_rate = 2.0F;
+    if (nullptr != arg) {
+      load_max_rate = std::stof(arg);
+    }
     // help
     bool8_t needs_help = rcutils_cli_option_exist(argv, &argv[argc], "-h");
     needs_help = rcutils_cli_option_exist(argv, &argv[argc], "--help") || needs_help;
@@ -125,6 +144,12 @@ int32_t main(const int32_t argc, char8_t ** const argv)
         "Default=127.0.0.1" << std::endl;
       std::cout << "--port4\tTarget port for the fourth spoofer\t" <<
         "Default=5004" << std::endl;
+      std::cout << "--load_steps\tIf positive, ramp the packet rate up in this many steps " <<
+        "instead of running for --runtime\tDefault=0" << std::endl;
+      std::cout << "--load_step_duration\tDuration of each step of the load ramp (s)\t" <<
+        "Default=10" << std::endl;
+      std::cout << "--load_max_rate\tFactor on the packet rate at the last step\t" <<
+        "Default=2" << std::endl;
       throw std::runtime_error{"Exiting due to help"};
     }
 
@@ -159,11 +184,37 @@ int32_t main(const int32_t argc, char8_t ** const argv)
     // FIXME required for integration test due to buffered output
     std::cout << "Spoofer(s) number is: " << spoofer_count << ::std::endl;
 
-    const auto end = std::chrono::steady_clock::now() + std::chrono::seconds(runtime);
+    const auto start = std::chrono::steady_clock::now();
+    auto end = start + std::chrono::seconds(runtime);
+    std::unique_ptr<lidar_integration::LoadRamp> load_ramp;
+    if (0U != load_steps) {
+      // The sizes of the clouds only depend on the rpm
+      load_ramp = std::make_unique<lidar_integration::LoadRamp>(
+        load_steps, load_max_rate, 1.0F,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::duration<float32_t>{load_step_duration}));
+      // Hold the last step for a while, the listener starts its ramp with the first cloud
+      end = start + load_ramp->duration() + load_ramp->step_duration();
+    }
+    std::size_t load_step = load_steps;
     while (rclcpp::ok()) {
-      if (end < std::chrono::steady_clock::now()) {
+      const auto right_now = std::chrono::steady_clock::now();
+      if (end < right_now) {
         break;
       }
+      if (load_ramp) {
+        const auto step = std::min(load_ramp->step_at(right_now - start), load_steps - 1U);
+        if (step != load_step) {
+          load_step = step;
+          const auto rate_factor = load_ramp->step(step).rate_factor;
+          for (auto spoof : {&spoof1, &spoof2, &spoof3, &spoof4}) {
+            spoof->set_rate_factor(rate_factor);
+          }
+          LIDAR_INTEGRATION_INFO(
+            "Load step %zu: packet rate factor %.2f", step,
+            static_cast<float64_t>(rate_factor));
+        }
+      }
       std::this_thread::sleep_for(1ms);
     }
 
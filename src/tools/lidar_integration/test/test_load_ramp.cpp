@@ -0,0 +1,110 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <lidar_integration/load_ramp.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using lidar_integration::find_saturation_point;
+using lidar_integration::LoadMonitor;
+using lidar_integration::LoadRamp;
+using lidar_integration::print_load_results;
+using std::chrono::milliseconds;
+
+namespace
+{
+constexpr int64_t kMs = 1000000;
+}  // namespace
+
+TEST(TestLoadRamp, Steps)
+{
+  EXPECT_THROW(LoadRamp(0U, 2.0F, 1.0F, milliseconds{1000}), std::domain_error);
+  EXPECT_THROW(LoadRamp(2U, 0.5F, 1.0F, milliseconds{1000}), std::domain_error);
+  EXPECT_THROW(LoadRamp(2U, 2.0F, 1.0F, milliseconds{0}), std::domain_error);
+
+  const LoadRamp ramp{3U, 3.0F, 2.0F, milliseconds{1000}};
+  EXPECT_EQ(ramp.num_steps(), 3U);
+  EXPECT_EQ(ramp.duration(), milliseconds{3000});
+  EXPECT_FLOAT_EQ(ramp.step(0U).rate_factor, 1.0F);
+  EXPECT_FLOAT_EQ(ramp.step(1U).rate_factor, 2.0F);
+  EXPECT_FLOAT_EQ(ramp.step(1U).size_factor, 1.5F);
+  EXPECT_FLOAT_EQ(ramp.step(2U).size_factor, 2.0F);
+  EXPECT_EQ(ramp.step_at(milliseconds{-1}), 0U);
+  EXPECT_EQ(ramp.step_at(milliseconds{999}), 0U);
+  EXPECT_EQ(ramp.step_at(milliseconds{1500}), 1U);
+  EXPECT_EQ(ramp.step_at(milliseconds{3000}), 3U);
+
+  // A single step is a sustained load at the maximum
+  const LoadRamp sustained{1U, 4.0F, 1.0F, milliseconds{1000}};
+  EXPECT_FLOAT_EQ(sustained.step(0U).rate_factor, 4.0F);
+}
+
+TEST(TestLoadRamp, Monitor)
+{
+  const LoadRamp ramp{3U, 3.0F, 1.0F, milliseconds{1000}};
+  EXPECT_THROW(LoadMonitor(ramp, 0.0F, 0.2F), std::domain_error);
+  EXPECT_THROW(LoadMonitor(ramp, 10.0F, 1.0F), std::domain_error);
+
+  LoadMonitor monitor{ramp, 10.0F, 0.2F, 32U};
+  // In the warm-up of the first step
+  monitor.record(milliseconds{100}, 100U, 500 * kMs);
+  // All 8 clouds of the measured 0.8 s at 10 Hz arrive
+  for (int64_t idx = 0; idx < 8; ++idx) {
+    monitor.record(milliseconds{250 + (100 * idx)}, 100U, (idx + 1) * kMs);
+  }
+  // 12 of the 16 clouds at 20 Hz arrive
+  for (int64_t idx = 0; idx < 12; ++idx) {
+    monitor.record(milliseconds{1225 + (50 * idx)}, 200U, 20 * kMs);
+  }
+  // None arrive at 30 Hz, and the ones after the ramp are ignored
+  monitor.record(milliseconds{3500}, 100U, kMs);
+
+  const auto results = monitor.results();
+  ASSERT_EQ(results.size(), 3U);
+  EXPECT_EQ(results[0U].received, 8U);
+  EXPECT_DOUBLE_EQ(results[0U].offered_rate, 10.0);
+  EXPECT_NEAR(results[0U].throughput, 10.0, 1.0e-6);
+  EXPECT_NEAR(results[0U].drop_rate, 0.0, 1.0e-6);
+  EXPECT_DOUBLE_EQ(results[0U].mean_size, 100.0);
+  EXPECT_EQ(results[0U].latency.count, 8U);
+  EXPECT_DOUBLE_EQ(results[0U].latency.max, 8.0);
+  EXPECT_EQ(results[1U].received, 12U);
+  EXPECT_NEAR(results[1U].throughput, 15.0, 1.0e-6);
+  EXPECT_NEAR(results[1U].drop_rate, 0.25, 1.0e-6);
+  EXPECT_DOUBLE_EQ(results[1U].mean_size, 200.0);
+  EXPECT_EQ(results[2U].received, 0U);
+  EXPECT_DOUBLE_EQ(results[2U].drop_rate, 1.0);
+
+  EXPECT_EQ(find_saturation_point(results, 0.05, 100.0), 1U);
+  EXPECT_EQ(find_saturation_point(results, 0.3, 100.0), 2U);
+  EXPECT_EQ(find_saturation_point(results, 0.3, 5.0), 0U);
+  EXPECT_EQ(find_saturation_point({results[0U]}, 0.05, 100.0), 1U);
+
+  std::stringstream table;
+  print_load_results(table, results, 1U);
+  std::string line;
+  std::vector<std::string> lines;
+  while (std::getline(table, line)) {
+    lines.push_back(line);
+  }
+  ASSERT_EQ(lines.size(), 5U);
+  EXPECT_EQ(lines[1U], "0,1.000,1.000,10.000,10.000,0.000,100.000,4.000,8.000,8.000");
+  EXPECT_EQ(lines[4U], "Saturated at step 1: 20.000 Hz offered, size factor 1.000");
+}
@@ -0,0 +1,61 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \copyright Copyright 2021 The Autoware Foundation
+/// \file
+/// \brief This file defines the PointCloudDecoderNode class.
+
+#ifndef POINT_CLOUD_CODEC_NODES__POINT_CLOUD_DECODER_NODE_HPP_
+#define POINT_CLOUD_CODEC_NODES__POINT_CLOUD_DECODER_NODE_HPP_
+
+#include <lidar_utils/point_cloud_codec.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
+
+#include "point_cloud_codec_nodes/visibility_control.hpp"
+
+namespace autoware
+{
+namespace tools
+{
+namespace point_cloud_codec_nodes
+{
+
+/// \class PointCloudDecoderNode
+/// \brief ROS 2 Node that restores the point clouds compressed by a PointCloudEncoderNode, e.g.
+/// when a recording is replayed
+class POINT_CLOUD_CODEC_NODES_PUBLIC PointCloudDecoderNode : public rclcpp::Node
+{
+public:
+  /// \brief default constructor, initializes subs and pubs
+  explicit PointCloudDecoderNode(const rclcpp::NodeOptions & options);
+
+private:
+  using PointCloud2 = sensor_msgs::msg::PointCloud2;
+
+  /// \brief Callback for compressed cloud, restores and publishes. A cloud that can't be
+  /// restored is dropped with a warning.
+  void POINT_CLOUD_CODEC_NODES_LOCAL callback_cloud_input(const PointCloud2::ConstSharedPtr msg);
+
+  common::lidar_utils::PointCloudDecoder m_decoder;
+  /// \brief Output cloud that is reused for every message
+  PointCloud2 m_cloud;
+  const rclcpp::Publisher<PointCloud2>::SharedPtr m_pub_ptr;
+  const rclcpp::Subscription<PointCloud2>::SharedPtr m_sub_ptr;
+};
+}  // namespace point_cloud_codec_nodes
+}  // namespace tools
+}  // namespace autoware
+
+#endif  // POINT_CLOUD_CODEC_NODES__POINT_CLOUD_DECODER_NODE_HPP_
@@ -0,0 +1,62 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \copyright Copyright 2021 The Autoware Foundation
+/// \file
+/// \brief This file defines the PointCloudEncoderNode class.
+
+#ifndef POINT_CLOUD_CODEC_NODES__POINT_CLOUD_ENCODER_NODE_HPP_
+#define POINT_CLOUD_CODEC_NODES__POINT_CLOUD_ENCODER_NODE_HPP_
+
+#include <lidar_utils/point_cloud_codec.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
+
+#include "point_cloud_codec_nodes/visibility_control.hpp"
+
+namespace autoware
+{
+namespace tools
+{
+namespace point_cloud_codec_nodes
+{
+
+/// \class PointCloudEncoderNode
+/// \brief ROS 2 Node that compresses point clouds, e.g. to record them. It is meant to run in
+/// the container of the driver, so that the raw clouds don't leave the process.
+class POINT_CLOUD_CODEC_NODES_PUBLIC PointCloudEncoderNode : public rclcpp::Node
+{
+public:
+  /// \brief default constructor, initializes subs and pubs
+  /// \throws std::domain_error if a resolution is negative or not finite
+  explicit PointCloudEncoderNode(const rclcpp::NodeOptions & options);
+
+private:
+  using PointCloud2 = sensor_msgs::msg::PointCloud2;
+
+  /// \brief Callback for input cloud, compresses and publishes. A cloud that can't be compressed
+  /// is dropped with a warning.
+  void POINT_CLOUD_CODEC_NODES_LOCAL callback_cloud_input(const PointCloud2::ConstSharedPtr msg);
+
+  common::lidar_utils::PointCloudEncoder m_encoder;
+  /// \brief Output cloud that is reused for every message
+  PointCloud2 m_compressed;
+  const rclcpp::Publisher<PointCloud2>::SharedPtr m_pub_ptr;
+  const rclcpp::Subscription<PointCloud2>::SharedPtr m_sub_ptr;
+};
+}  // namespace point_cloud_codec_nodes
+}  // namespace tools
+}  // namespace autoware
+
+#endif  // POINT_CLOUD_CODEC_NODES__POINT_CLOUD_ENCODER_NODE_HPP_
@@ -0,0 +1,74 @@
+# Copyright 2021 the Autoware Foundation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Launch a VLS128 driver and a point cloud encoder in one process."""
+
+import os
+
+from ament_index_python import get_package_share_directory
+import launch
+from launch.actions import DeclareLaunchArgument
+from launch.substitutions import LaunchConfiguration
+from launch_ros.actions import ComposableNodeContainer
+from launch_ros.descriptions import ComposableNode
+
+
+def generate_launch_description():
+    """
+    Launch the driver and the encoder as components of one container.
+
+    The raw cloud is handed to the encoder without a copy, only the compressed cloud leaves the
+    process.
+    """
+    driver_param = DeclareLaunchArgument(
+        'driver_param_file',
+        default_value=os.path.join(
+            get_package_share_directory('velodyne_nodes'), 'param/vls128_test.param.yaml'),
+        description='Path to config file for the VLS128 driver node.'
+    )
+    encoder_param = DeclareLaunchArgument(
+        'encoder_param_file',
+        default_value=os.path.join(
+            get_package_share_directory('point_cloud_codec_nodes'), 'param/defaults.param.yaml'),
+        description='Path to config file for the point cloud encoder node.'
+    )
+
+    container = ComposableNodeContainer(
+        name='vls128_compressed_container',
+        namespace='lidar_front',
+        package='rclcpp_components',
+        executable='component_container',
+        composable_node_descriptions=[
+            ComposableNode(
+                package='velodyne_nodes',
+                plugin='autoware::drivers::velodyne_nodes::VLS128DriverNode',
+                name='vls128_driver_node',
+                parameters=[LaunchConfiguration('driver_param_file')],
+                remappings=[('topic', 'points_xyzi')],
+                extra_arguments=[{'use_intra_process_comms': True}]),
+            ComposableNode(
+                package='point_cloud_codec_nodes',
+                plugin='autoware::tools::point_cloud_codec_nodes::PointCloudEncoderNode',
+                name='point_cloud_encoder',
+                parameters=[LaunchConfiguration('encoder_param_file')],
+                remappings=[('points_in', 'points_xyzi')],
+                extra_arguments=[{'use_intra_process_comms': True}]),
+        ],
+        output='screen',
+    )
+
+    return launch.LaunchDescription([
+        driver_param,
+        encoder_param,
+        container])
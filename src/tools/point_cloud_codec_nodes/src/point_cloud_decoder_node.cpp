@@ -0,0 +1,58 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "point_cloud_codec_nodes/point_cloud_decoder_node.hpp"
+
+#include <exception>
+
+namespace
+{
+const std::uint32_t QOS_HISTORY_DEPTH = 10;
+}  // namespace
+
+namespace autoware
+{
+namespace tools
+{
+namespace point_cloud_codec_nodes
+{
+
+PointCloudDecoderNode::PointCloudDecoderNode(const rclcpp::NodeOptions & options)
+: Node("point_cloud_decoder", options),
+  m_pub_ptr{create_publisher<PointCloud2>(
+      "points_out", rclcpp::QoS(rclcpp::KeepLast(::QOS_HISTORY_DEPTH)))},
+  m_sub_ptr{create_subscription<PointCloud2>(
+      "points_compressed", rclcpp::QoS(rclcpp::KeepLast(::QOS_HISTORY_DEPTH)),
+      [this](const PointCloud2::ConstSharedPtr msg) {callback_cloud_input(msg);})}
+{
+}
+
+void PointCloudDecoderNode::callback_cloud_input(const PointCloud2::ConstSharedPtr msg)
+{
+  try {
+    m_decoder.decode(*msg, m_cloud);
+  } catch (const std::exception & e) {
+    RCLCPP_WARN(get_logger(), "Dropping a cloud that can't be restored: %s", e.what());
+    return;
+  }
+  m_pub_ptr->publish(m_cloud);
+}
+
+}  // namespace point_cloud_codec_nodes
+}  // namespace tools
+}  // namespace autoware
+
+#include "rclcpp_components/register_node_macro.hpp"
+
+RCLCPP_COMPONENTS_REGISTER_NODE(autoware::tools::point_cloud_codec_nodes::PointCloudDecoderNode)
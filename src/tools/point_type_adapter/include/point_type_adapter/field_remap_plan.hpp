@@ -0,0 +1,82 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \copyright Copyright 2021 The Autoware Foundation
+/// \file
+/// \brief This file defines the FieldRemapPlan class.
+
+#ifndef POINT_TYPE_ADAPTER__FIELD_REMAP_PLAN_HPP_
+#define POINT_TYPE_ADAPTER__FIELD_REMAP_PLAN_HPP_
+
+#include <common/types.hpp>
+#include <sensor_msgs/msg/point_cloud2.hpp>
+#include <cstdint>
+#include <vector>
+#include "point_type_adapter/visibility_control.hpp"
+
+namespace autoware
+{
+namespace tools
+{
+namespace point_type_adapter
+{
+
+/// \class FieldRemapPlan
+/// \brief Copies the x, y, z and intensity fields of a point cloud layout into
+/// PointXYZI clouds. The layout is checked and the byte offsets of the fields are looked up once
+/// when the plan is made, so converting a cloud is a loop of fixed-offset copies. Clouds that
+/// already are in the PointXYZI layout are copied as a whole.
+class POINT_TYPE_ADAPTER_PUBLIC FieldRemapPlan
+{
+public:
+  using PointCloud2 = sensor_msgs::msg::PointCloud2;
+
+  /// \brief Make the plan for the layout of a cloud
+  /// \param[in] cloud A cloud with the layout to convert, its points are not used
+  /// \throws std::runtime_error if x, y or z are missing or not FLOAT32, or if intensity is
+  ///         missing or neither UINT8 nor FLOAT32
+  explicit FieldRemapPlan(const PointCloud2 & cloud);
+
+  /// \brief Check if a cloud has the layout this plan was made for
+  bool matches(const PointCloud2 & cloud) const;
+
+  /// \brief Check if the layout is the PointXYZI layout, i.e. clouds are copied as a whole
+  bool is_identity() const noexcept;
+
+  /// \brief Convert a cloud with the layout of this plan
+  /// \param[in] cloud_in The cloud to convert
+  /// \param[out] cloud_out A cloud with the PointXYZI fields. Its header and points are
+  ///             overwritten, its memory is reused, so no allocation happens once it held a cloud
+  ///             of the same size. The output is unorganized, i.e. it has a height of 1.
+  /// \throws std::runtime_error if the data of cloud_in is smaller than its dimensions
+  void apply(const PointCloud2 & cloud_in, PointCloud2 & cloud_out) const;
+
+private:
+  using PointField = sensor_msgs::msg::PointField;
+
+  std::vector<PointField> m_fields;
+  std::uint32_t m_point_step;
+  std::uint32_t m_x_offset{};
+  std::uint32_t m_y_offset{};
+  std::uint32_t m_z_offset{};
+  std::uint32_t m_intensity_offset{};
+  decltype(PointField::datatype) m_intensity_datatype{};
+  bool m_identity{false};
+};
+
+}  // namespace point_type_adapter
+}  // namespace tools
+}  // namespace autoware
+
+#endif  // POINT_TYPE_ADAPTER__FIELD_REMAP_PLAN_HPP_
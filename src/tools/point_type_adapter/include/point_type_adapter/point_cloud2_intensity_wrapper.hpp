@@ -61,6 +61,12 @@ public:
     }
   }
 
+  /// \brief Datatype of the intensity field, either UINT8 or FLOAT32
+  decltype(sensor_msgs::msg::PointField::datatype) get_datatype() const
+  {
+    return m_intensity_datatype;
+  }
+
   bool is_end()
   {
     switch (m_intensity_datatype) {
@@ -24,6 +24,8 @@
 #include <common/types.hpp>
 #include <helper_functions/float_comparisons.hpp>
 #include <limits>
+#include <memory>
+#include "point_type_adapter/field_remap_plan.hpp"
 #include "point_type_adapter/visibility_control.hpp"
 #include "point_cloud2_intensity_wrapper.hpp"
 
@@ -47,6 +49,14 @@ public:
   sensor_msgs::msg::PointCloud2::SharedPtr cloud_in_to_cloud_xyzi(
     const sensor_msgs::msg::PointCloud2::ConstSharedPtr cloud_in) const;
 
+  /// \brief Converts CloudX to CloudXYZI into a given cloud. The conversion plan of the
+  /// previous cloud is reused while the layout of the input clouds stays the same.
+  /// \param[in] cloud_in The cloud to convert
+  /// \param[out] cloud_out A cloud made with the PointXYZI fields, its memory is reused
+  /// \throws std::runtime_error if the input cloud doesn't have the required fields
+  void cloud_in_to_cloud_xyzi(
+    const sensor_msgs::msg::PointCloud2 & cloud_in, sensor_msgs::msg::PointCloud2 & cloud_out);
+
 private:
   using PointCloud2 = sensor_msgs::msg::PointCloud2;
   using float32_t = autoware::common::types::float32_t;
@@ -57,6 +67,11 @@ private:
   rclcpp::Publisher<PointCloud2>::SharedPtr pub_ptr_cloud_output_;
   rclcpp::Subscription<PointCloud2>::SharedPtr sub_ptr_cloud_input_;
 
+  /// \brief Plan for the layout of the latest input cloud
+  std::unique_ptr<FieldRemapPlan> plan_;
+  /// \brief Output cloud that is reused for every message
+  PointCloud2 cloud_output_;
+
   /// \brief Callback for input cloud, converts and publishes.
   /// \throws std::exception if it cannot transform.
   void callback_cloud_input(const PointCloud2::SharedPtr msg_ptr);
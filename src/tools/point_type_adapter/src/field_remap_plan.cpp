@@ -0,0 +1,154 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "point_type_adapter/field_remap_plan.hpp"
+
+namespace
+{
+using autoware::common::types::float32_t;
+using autoware::common::types::PointXYZI;
+using sensor_msgs::msg::PointField;
+
+/// \brief Find a field by name and return its offset
+/// \throws std::runtime_error if the field doesn't exist or has none of the allowed datatypes
+std::uint32_t find_field(
+  const std::vector<PointField> & fields, const std::string & name,
+  const std::vector<decltype(PointField::datatype)> & datatypes,
+  std::uint32_t point_step, decltype(PointField::datatype) & datatype)
+{
+  const auto field_it = std::find_if(
+    fields.cbegin(), fields.cend(), [&name](const PointField & field) {
+      return field.name == name;
+    });
+  if (field_it == fields.cend()) {
+    throw std::runtime_error(
+            "Required field \"" + name + "\" doesn't exist in the point cloud.");
+  }
+  if (std::find(datatypes.cbegin(), datatypes.cend(), field_it->datatype) == datatypes.cend()) {
+    throw std::runtime_error(
+            "Type of field \"" + name + "\" not supported: " +
+            std::to_string(field_it->datatype));
+  }
+  const std::uint32_t size = (field_it->datatype == PointField::UINT8) ? 1U : 4U;
+  if (field_it->offset + size > point_step) {
+    throw std::runtime_error("Field \"" + name + "\" exceeds the point step.");
+  }
+  datatype = field_it->datatype;
+  return field_it->offset;
+}
+
+/// \brief Copy count points of one row, the offsets are fixed for the loop so that the compiler
+/// can unroll and vectorize it
+template<typename IntensityT>
+void remap_row(
+  const std::uint8_t * src, const std::size_t point_step, const std::size_t count,
+  const std::uint32_t x_offset, const std::uint32_t y_offset, const std::uint32_t z_offset,
+  const std::uint32_t intensity_offset, std::uint8_t * dst)
+{
+  for (std::size_t i = 0U; i < count; ++i) {
+    const std::uint8_t * point = src + (i * point_step);
+    PointXYZI out;
+    IntensityT intensity;
+    std::memcpy(&out.x, point + x_offset, sizeof(float32_t));
+    std::memcpy(&out.y, point + y_offset, sizeof(float32_t));
+    std::memcpy(&out.z, point + z_offset, sizeof(float32_t));
+    std::memcpy(&intensity, point + intensity_offset, sizeof(IntensityT));
+    out.intensity = intensity;
+    std::memcpy(dst + (i * sizeof(PointXYZI)), &out, sizeof(PointXYZI));
+  }
+}
+}  // namespace
+
+namespace autoware
+{
+namespace tools
+{
+namespace point_type_adapter
+{
+
+FieldRemapPlan::FieldRemapPlan(const PointCloud2 & cloud)
+: m_fields{cloud.fields},
+  m_point_step{cloud.point_step}
+{
+  decltype(PointField::datatype) datatype{};
+  m_x_offset = find_field(m_fields, "x", {PointField::FLOAT32}, m_point_step, datatype);
+  m_y_offset = find_field(m_fields, "y", {PointField::FLOAT32}, m_point_step, datatype);
+  m_z_offset = find_field(m_fields, "z", {PointField::FLOAT32}, m_point_step, datatype);
+  m_intensity_offset = find_field(
+    m_fields, "intensity", {PointField::UINT8, PointField::FLOAT32}, m_point_step,
+    m_intensity_datatype);
+  m_identity = (m_point_step == sizeof(PointXYZI)) &&
+    (m_x_offset == offsetof(PointXYZI, x)) && (m_y_offset == offsetof(PointXYZI, y)) &&
+    (m_z_offset == offsetof(PointXYZI, z)) &&
+    (m_intensity_offset == offsetof(PointXYZI, intensity)) &&
+    (m_intensity_datatype == PointField::FLOAT32);
+}
+
+bool FieldRemapPlan::matches(const PointCloud2 & cloud) const
+{
+  return (cloud.point_step == m_point_step) && (cloud.fields == m_fields);
+}
+
+bool FieldRemapPlan::is_identity() const noexcept
+{
+  return m_identity;
+}
+
+void FieldRemapPlan::apply(const PointCloud2 & cloud_in, PointCloud2 & cloud_out) const
+{
+  const std::size_t width = cloud_in.width;
+  const std::size_t height = cloud_in.height;
+  const std::size_t row_step = cloud_in.row_step;
+  if ((row_step < width * m_point_step) || (cloud_in.data.size() < row_step * height)) {
+    throw std::runtime_error("Point cloud data is smaller than its dimensions.");
+  }
+
+  const std::size_t num_points = width * height;
+  cloud_out.header = cloud_in.header;
+  cloud_out.height = 1U;
+  cloud_out.width = static_cast<std::uint32_t>(num_points);
+  cloud_out.point_step = static_cast<std::uint32_t>(sizeof(PointXYZI));
+  cloud_out.row_step = static_cast<std::uint32_t>(num_points * sizeof(PointXYZI));
+  cloud_out.data.resize(num_points * sizeof(PointXYZI));
+  if (num_points == 0U) {
+    return;
+  }
+
+  const std::size_t row_bytes = width * sizeof(PointXYZI);
+  if (m_identity && (row_step == row_bytes)) {
+    std::memcpy(cloud_out.data.data(), cloud_in.data.data(), num_points * sizeof(PointXYZI));
+    return;
+  }
+  for (std::size_t row = 0U; row < height; ++row) {
+    const auto src = &cloud_in.data[row * row_step];
+    const auto dst = &cloud_out.data[row * row_bytes];
+    if (m_intensity_datatype == PointField::UINT8) {
+      remap_row<std::uint8_t>(
+        src, m_point_step, width, m_x_offset, m_y_offset, m_z_offset, m_intensity_offset, dst);
+    } else {
+      remap_row<float32_t>(
+        src, m_point_step, width, m_x_offset, m_y_offset, m_z_offset, m_intensity_offset, dst);
+    }
+  }
+}
+
+}  // namespace point_type_adapter
+}  // namespace tools
+}  // namespace autoware
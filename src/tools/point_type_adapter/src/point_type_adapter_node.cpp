@@ -13,11 +13,9 @@
 // limitations under the License.
 
 #include <sensor_msgs/msg/point_cloud2.hpp>
-#include <sensor_msgs/point_cloud2_iterator.hpp>
 #include <common/types.hpp>
 #include <point_cloud_msg_wrapper/point_cloud_msg_wrapper.hpp>
 #include <memory>
-#include <algorithm>
 #include <exception>
 #include <string>
 #include <vector>
@@ -26,7 +24,7 @@
 namespace
 {
 const std::uint32_t QOS_HISTORY_DEPTH = 10;
-}
+}  // namespace
 
 namespace autoware
 {
@@ -50,13 +48,15 @@ PointTypeAdapterNode::PointTypeAdapterNode(const rclcpp::NodeOptions & options)
       this,
       std::placeholders::_1)))
 {
+  // Initializes the fields of the output once, the conversion only fills in the points
+  point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI> modifier{cloud_output_, ""};
 }
 
 void PointTypeAdapterNode::callback_cloud_input(const PointCloud2::SharedPtr msg_ptr)
 {
   try {
-    PointCloud2::SharedPtr cloud_out = cloud_in_to_cloud_xyzi(msg_ptr);
-    pub_ptr_cloud_output_->publish(*cloud_out);
+    cloud_in_to_cloud_xyzi(*msg_ptr, cloud_output_);
+    pub_ptr_cloud_output_->publish(cloud_output_);
   } catch (std::exception & ex) {
     RCLCPP_ERROR(
       this->get_logger(),
@@ -68,71 +68,21 @@ void PointTypeAdapterNode::callback_cloud_input(const PointCloud2::SharedPtr msg
 PointCloud2::SharedPtr PointTypeAdapterNode::cloud_in_to_cloud_xyzi(
   const PointCloud2::ConstSharedPtr cloud_in) const
 {
-  using CloudModifier = point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI>;
   PointCloud2::SharedPtr cloud_out_ptr = std::make_shared<PointCloud2>();
+  point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI> modifier{
+    *cloud_out_ptr, cloud_in->header.frame_id};
+  FieldRemapPlan{*cloud_in}.apply(*cloud_in, *cloud_out_ptr);
+  return cloud_out_ptr;
+}
 
-  auto fields_contain_field_with_name_and_datatype = [this](
-    const std::vector<sensor_msgs::msg::PointField> & fields,
-    const std::string & name,
-    uint8_t datatype) {
-      auto iter_search = std::find_if(
-        fields.cbegin(), fields.cend(), [&name](
-          const sensor_msgs::msg::PointField & field) {
-          return field.name == name;
-        });
-      if (iter_search == fields.cend()) {
-        // Given field doesn't exist within given point cloud.
-        RCLCPP_ERROR(
-          this->get_logger(),
-          "Field named \"" + name + "\" doesn't exist within given point cloud.");
-        return false;
-      }
-      // Given field exists within given point cloud, check its type.
-      return iter_search->datatype == datatype;
-    };
-
-  if (!fields_contain_field_with_name_and_datatype(
-      cloud_in->fields, "x",
-      sensor_msgs::msg::PointField::FLOAT32) ||
-    !fields_contain_field_with_name_and_datatype(
-      cloud_in->fields, "y",
-      sensor_msgs::msg::PointField::FLOAT32) ||
-    !fields_contain_field_with_name_and_datatype(
-      cloud_in->fields, "z",
-      sensor_msgs::msg::PointField::FLOAT32))
-  {
-    throw std::runtime_error("x,y,z fields either don't exist or they are not FLOAT32");
-  }
-
-  // Throws if "intensity" field doesn't exist
-  // or the field isn't with uint8_t or float32_t datatypes
-  IntensityIteratorWrapper intensity_iter_wrapper(*cloud_in);
-
-  sensor_msgs::PointCloud2ConstIterator<float32_t> iter_x(*cloud_in, "x");
-  sensor_msgs::PointCloud2ConstIterator<float32_t> iter_y(*cloud_in, "y");
-  sensor_msgs::PointCloud2ConstIterator<float32_t> iter_z(*cloud_in, "z");
-
-
-  CloudModifier cloud_modifier_out(*cloud_out_ptr, cloud_in->header.frame_id);
-  cloud_out_ptr->header = cloud_in->header;
-
-  cloud_modifier_out.reserve(cloud_in->width);
-
-  while (iter_x != iter_x.end() ||
-    iter_y != iter_y.end() ||
-    iter_z != iter_z.end() ||
-    !intensity_iter_wrapper.is_end())
-  {
-    PointXYZI point_xyzi{*iter_x, *iter_y, *iter_z,
-      intensity_iter_wrapper.get_current_value<float32_t>()};
-    cloud_modifier_out.push_back(point_xyzi);
-    iter_x += 1;
-    iter_y += 1;
-    iter_z += 1;
-    intensity_iter_wrapper.increase();
+void PointTypeAdapterNode::cloud_in_to_cloud_xyzi(
+  const PointCloud2 & cloud_in, PointCloud2 & cloud_out)
+{
+  if (!plan_ || !plan_->matches(cloud_in)) {
+    // Throws if x, y, z or intensity don't exist or have unsupported datatypes
+    plan_ = std::make_unique<FieldRemapPlan>(cloud_in);
   }
-
-  return cloud_out_ptr;
+  plan_->apply(cloud_in, cloud_out);
 }
 
 }  // namespace point_type_adapter
@@ -82,3 +82,71 @@ TEST(test_point_type_adapter, test_cloud_converter) {
   EXPECT_EQ(cloud_view_xyzi.at(0), point_xyzi_0);
   EXPECT_EQ(cloud_view_xyzi.at(1), point_xyzi_1);
 }
+
+TEST(test_point_type_adapter, test_field_remap_plan_identity) {
+  using PointXYZI = autoware::common::types::PointXYZI;
+  using autoware::tools::point_type_adapter::FieldRemapPlan;
+  using sensor_msgs::msg::PointCloud2;
+  PointCloud2 cloud_in;
+  point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI> modifier_in(cloud_in, "frame");
+  modifier_in.push_back(PointXYZI{1.0F, 2.0F, 3.0F, 4.0F});
+  modifier_in.push_back(PointXYZI{5.0F, 6.0F, 7.0F, 8.0F});
+
+  FieldRemapPlan plan(cloud_in);
+  EXPECT_TRUE(plan.is_identity());
+  EXPECT_TRUE(plan.matches(cloud_in));
+
+  PointCloud2 cloud_out;
+  point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI> modifier_out(cloud_out, "");
+  plan.apply(cloud_in, cloud_out);
+  EXPECT_EQ(cloud_out.header, cloud_in.header);
+  EXPECT_EQ(cloud_out.data, cloud_in.data);
+  EXPECT_EQ(cloud_out.row_step, cloud_in.row_step);
+}
+
+TEST(test_point_type_adapter, test_field_remap_plan_organized) {
+  using PointXYZI = autoware::common::types::PointXYZI;
+  using autoware::tools::point_type_adapter::FieldRemapPlan;
+  using sensor_msgs::msg::PointCloud2;
+  PointCloud2 cloud_in;
+  point_cloud_msg_wrapper::PointCloud2Modifier<PointSvl> modifier_in(cloud_in, "frame");
+  for (std::uint8_t i = 0U; i < 6U; ++i) {
+    const auto value = static_cast<float32_t>(i);
+    modifier_in.push_back(PointSvl{value, 2.0F * value, 3.0F * value, i, 0.0});
+  }
+  // Two rows of two points, padded with the space of one point at the end of each row
+  cloud_in.height = 2U;
+  cloud_in.width = 2U;
+  cloud_in.row_step = 3U * cloud_in.point_step;
+
+  FieldRemapPlan plan(cloud_in);
+  EXPECT_FALSE(plan.is_identity());
+
+  PointCloud2 cloud_out;
+  point_cloud_msg_wrapper::PointCloud2Modifier<PointXYZI> modifier_out(cloud_out, "");
+  plan.apply(cloud_in, cloud_out);
+  EXPECT_EQ(cloud_out.height, 1U);
+  EXPECT_EQ(cloud_out.width, 4U);
+  point_cloud_msg_wrapper::PointCloud2View<PointXYZI> view_out(cloud_out);
+  EXPECT_EQ(view_out.at(0), (PointXYZI{0.0F, 0.0F, 0.0F, 0.0F}));
+  EXPECT_EQ(view_out.at(1), (PointXYZI{1.0F, 2.0F, 3.0F, 1.0F}));
+  EXPECT_EQ(view_out.at(2), (PointXYZI{3.0F, 6.0F, 9.0F, 3.0F}));
+  EXPECT_EQ(view_out.at(3), (PointXYZI{4.0F, 8.0F, 12.0F, 4.0F}));
+
+  // A cloud whose data doesn't cover its dimensions is rejected
+  cloud_in.height = 3U;
+  EXPECT_THROW(plan.apply(cloud_in, cloud_out), std::runtime_error);
+}
+
+TEST(test_point_type_adapter, test_field_remap_plan_missing_field) {
+  using autoware::tools::point_type_adapter::FieldRemapPlan;
+  using sensor_msgs::msg::PointCloud2;
+  PointCloud2 cloud_in;
+  point_cloud_msg_wrapper::PointCloud2Modifier<PointSvl> modifier_in(cloud_in, "frame");
+  PointCloud2 cloud_other = cloud_in;
+  cloud_other.fields.back().name = "time";
+  EXPECT_FALSE(FieldRemapPlan(cloud_in).matches(cloud_other));
+
+  cloud_in.fields.erase(cloud_in.fields.begin() + 3);
+  EXPECT_THROW(FieldRemapPlan{cloud_in}, std::runtime_error);
+}
@@ -0,0 +1,137 @@
+// Copyright 2021 The Autoware Foundation.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SIMPLE_PLANNING_SIMULATOR__LOCKSTEP_HPP_
+#define SIMPLE_PLANNING_SIMULATOR__LOCKSTEP_HPP_
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/types.hpp"
+#include "simple_planning_simulator/visibility_control.hpp"
+#include "simple_planning_simulator/vehicle_model/sim_model_interface.hpp"
+
+namespace simulation
+{
+namespace simple_planning_simulator
+{
+using autoware::common::types::bool8_t;
+using autoware::common::types::float64_t;
+
+/**
+ * @class LockstepCoordinator
+ * @brief owns the simulated time in lockstep mode: the time only advances by a fixed step once
+ *        every registered consumer has acknowledged the current time, so the simulation runs as
+ *        fast as the slowest consumer instead of at the rate of the wall clock
+ */
+class PLANNING_SIMULATOR_PUBLIC LockstepCoordinator
+{
+public:
+  using Duration = std::chrono::nanoseconds;
+
+  /**
+   * @brief constructor, the simulated time starts at zero
+   * @param [in] step simulated time of one step, must be positive
+   * @param [in] consumers names of the consumers that acknowledge every step, may be empty
+   * @throw std::invalid_argument if the step is not positive or a consumer is given twice
+   */
+  LockstepCoordinator(Duration step, const std::vector<std::string> & consumers);
+
+  /**
+   * @brief record that a consumer has processed everything up to a simulated time
+   * @param [in] consumer name of the consumer
+   * @param [in] time simulated time since the start, older acknowledgements are ignored
+   * @return false if the consumer is not registered
+   */
+  bool8_t acknowledge(const std::string & consumer, Duration time);
+
+  /**
+   * @brief whether every consumer has acknowledged the current time, always true without consumers
+   */
+  bool8_t ready() const noexcept;
+
+  /**
+   * @brief advance the simulated time by one step
+   * @return the new simulated time
+   * @throw std::logic_error if not every consumer has acknowledged the current time
+   */
+  Duration advance();
+
+  /**
+   * @brief get the current simulated time since the start
+   */
+  Duration now() const noexcept {return now_;}
+
+  /**
+   * @brief get the simulated time of one step
+   */
+  Duration step() const noexcept {return step_;}
+
+  /**
+   * @brief get the number of steps taken so far
+   */
+  std::size_t step_count() const noexcept {return step_count_;}
+
+private:
+  Duration step_;
+  Duration now_{Duration::zero()};
+  std::size_t step_count_{0U};
+  std::vector<std::string> consumers_;      //!< @brief registered consumer names
+  std::vector<Duration> acknowledged_;      //!< @brief latest acknowledged time per consumer
+};
+
+/**
+ * @class VehicleFleet
+ * @brief in-process API to step many simulated vehicles together without any ROS communication,
+ *        e.g. for closed-loop tests that drive several vehicles from one process
+ */
+class PLANNING_SIMULATOR_PUBLIC VehicleFleet
+{
+public:
+  /**
+   * @brief add a vehicle to the fleet
+   * @param [in] model vehicle model with its initial state already set
+   * @return index of the vehicle in the fleet
+   * @throw std::invalid_argument if the model is null
+   */
+  std::size_t add(std::shared_ptr<SimModelInterface> model);
+
+  /**
+   * @brief get a vehicle of the fleet, e.g. to set its input before the next step
+   * @param [in] index index returned by add()
+   * @throw std::out_of_range if there is no vehicle at this index
+   */
+  SimModelInterface & vehicle(std::size_t index);
+
+  /**
+   * @brief get the number of vehicles in the fleet
+   */
+  std::size_t size() const noexcept {return vehicles_.size();}
+
+  /**
+   * @brief update the states of all vehicles
+   * @param [in] dt delta time [s]
+   */
+  void step(const float64_t dt);
+
+private:
+  std::vector<std::shared_ptr<SimModelInterface>> vehicles_;
+};
+}  // namespace simple_planning_simulator
+}  // namespace simulation
+
+#endif  // SIMPLE_PLANNING_SIMULATOR__LOCKSTEP_HPP_
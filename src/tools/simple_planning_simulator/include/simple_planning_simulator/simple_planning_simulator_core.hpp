@@ -22,6 +22,7 @@
 #include <memory>
 #include <string>
 #include <random>
+#include <vector>
 
 #include "rclcpp/rclcpp.hpp"
 
@@ -40,6 +41,9 @@
 #include "autoware_auto_msgs/msg/vehicle_state_report.hpp"
 #include "autoware_auto_msgs/msg/complex32.hpp"
 #include "common/types.hpp"
+#include "rosgraph_msgs/msg/clock.hpp"
+
+#include "simple_planning_simulator/lockstep.hpp"
 
 #include "simple_planning_simulator/vehicle_model/sim_model_interface.hpp"
 
@@ -62,6 +66,7 @@ using geometry_msgs::msg::PoseStamped;
 using geometry_msgs::msg::Pose;
 using geometry_msgs::msg::Twist;
 using autoware_auto_msgs::msg::Complex32;
+using rosgraph_msgs::msg::Clock;
 
 class DeltaTime
 {
@@ -114,6 +119,11 @@ private:
   uint32_t timer_sampling_time_ms_;  //!< @brief timer sampling time
   rclcpp::TimerBase::SharedPtr on_timer_;  //!< @brief timer for simulation
 
+  /* lockstep mode */
+  std::unique_ptr<LockstepCoordinator> lockstep_;  //!< @brief simulated time, null if disabled
+  rclcpp::Publisher<Clock>::SharedPtr pub_clock_;
+  std::vector<rclcpp::Subscription<Clock>::SharedPtr> sub_lockstep_acks_;
+
   /* tf */
   tf2_ros::Buffer tf_buffer_;
   tf2_ros::TransformListener tf_listener_;
@@ -128,7 +138,7 @@ private:
   std::string origin_frame_id_;  //!< @brief map frame_id
 
   /* flags */
-  bool8_t is_initialized_;         //!< @brief flag to check the initial position is set
+  bool8_t is_initialized_{false};  //!< @brief flag to check the initial position is set
   bool8_t add_measurement_noise_;  //!< @brief flag to add measurement noise
 
   DeltaTime delta_time_;  //!< @brief to calculate delta time
@@ -177,6 +187,47 @@ private:
    */
   void on_timer();
 
+  /**
+   * @brief create the lockstep coordinator, the /clock publisher and the acknowledgement
+   *        subscriptions, and the timer that drives the simulation in lockstep mode
+   */
+  void initialize_lockstep();
+
+  /**
+   * @brief timer callback in lockstep mode: takes a step if every consumer is done with the
+   *        current one, otherwise publishes the current state again for late joining consumers
+   */
+  void on_lockstep_timer();
+
+  /**
+   * @brief record an acknowledgement of a consumer, and take the next step if it was the last one
+   * @param [in] consumer name of the acknowledgement topic the message was received on
+   * @param [in] msg simulated time up to which the consumer has processed the outputs
+   */
+  void on_lockstep_ack(const std::string & consumer, const Clock::ConstSharedPtr msg);
+
+  /**
+   * @brief advance the simulated time by one step and simulate it
+   */
+  void step_lockstep();
+
+  /**
+   * @brief update vehicle dynamics and publish the results
+   * @param [in] dt delta time [s]
+   */
+  void step_simulation(const float64_t dt);
+
+  /**
+   * @brief publish the current kinematic state, state report and tf, and the time in lockstep mode
+   */
+  void publish_outputs();
+
+  /**
+   * @brief get the time to stamp outputs with: the simulated time in lockstep mode, the time of
+   *        the node clock otherwise
+   */
+  rclcpp::Time current_time();
+
   /**
    * @brief initialize vehicle_model_ptr
    */
@@ -0,0 +1,93 @@
+// Copyright 2021 The Autoware Foundation.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "simple_planning_simulator/lockstep.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace simulation
+{
+namespace simple_planning_simulator
+{
+
+LockstepCoordinator::LockstepCoordinator(
+  const Duration step, const std::vector<std::string> & consumers)
+: step_(step), consumers_(consumers),
+  // No consumer has seen the start yet
+  acknowledged_(consumers.size(), Duration{-1})
+{
+  if (step <= Duration::zero()) {
+    throw std::invalid_argument("Lockstep step must be positive");
+  }
+  for (auto it = consumers_.begin(); it != consumers_.end(); ++it) {
+    if (std::find(consumers_.begin(), it, *it) != it) {
+      throw std::invalid_argument("Lockstep consumer given twice: " + *it);
+    }
+  }
+}
+
+bool8_t LockstepCoordinator::acknowledge(const std::string & consumer, const Duration time)
+{
+  const auto it = std::find(consumers_.begin(), consumers_.end(), consumer);
+  if (it == consumers_.end()) {
+    return false;
+  }
+  auto & acknowledged = acknowledged_[static_cast<std::size_t>(it - consumers_.begin())];
+  acknowledged = std::max(acknowledged, time);
+  return true;
+}
+
+bool8_t LockstepCoordinator::ready() const noexcept
+{
+  return std::all_of(
+    acknowledged_.begin(), acknowledged_.end(),
+    [this](const Duration time) {return time >= now_;});
+}
+
+LockstepCoordinator::Duration LockstepCoordinator::advance()
+{
+  if (!ready()) {
+    throw std::logic_error("Lockstep advanced before every consumer acknowledged the step");
+  }
+  now_ += step_;
+  ++step_count_;
+  return now_;
+}
+
+std::size_t VehicleFleet::add(std::shared_ptr<SimModelInterface> model)
+{
+  if (!model) {
+    throw std::invalid_argument("Vehicle model is null");
+  }
+  vehicles_.emplace_back(std::move(model));
+  return vehicles_.size() - 1U;
+}
+
+SimModelInterface & VehicleFleet::vehicle(const std::size_t index)
+{
+  return *vehicles_.at(index);
+}
+
+void VehicleFleet::step(const float64_t dt)
+{
+  for (const auto & vehicle : vehicles_) {
+    vehicle->update(dt);
+  }
+}
+}  // namespace simple_planning_simulator
+}  // namespace simulation
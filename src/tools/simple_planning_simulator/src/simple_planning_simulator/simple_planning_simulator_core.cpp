@@ -22,6 +22,7 @@
 #include <utility>
 #include <chrono>
 #include <algorithm>
+#include <vector>
 
 #include "simple_planning_simulator/simple_planning_simulator_core.hpp"
 
@@ -102,9 +103,13 @@ SimplePlanningSimulator::SimplePlanningSimulator(const rclcpp::NodeOptions & opt
   pub_tf_ = create_publisher<tf2_msgs::msg::TFMessage>("/tf", QoS{1});
 
   timer_sampling_time_ms_ = static_cast<uint32_t>(declare_parameter("timer_sampling_time_ms", 25));
-  on_timer_ = create_wall_timer(
-    std::chrono::milliseconds(timer_sampling_time_ms_),
-    std::bind(&SimplePlanningSimulator::on_timer, this));
+  if (declare_parameter("lockstep.enabled", false)) {
+    initialize_lockstep();
+  } else {
+    on_timer_ = create_wall_timer(
+      std::chrono::milliseconds(timer_sampling_time_ms_),
+      std::bind(&SimplePlanningSimulator::on_timer, this));
+  }
 
 
   // set vehicle model type
@@ -190,11 +195,69 @@ void SimplePlanningSimulator::on_timer()
     return;
   }
 
-  // update vehicle dynamics
-  {
-    const float64_t dt = delta_time_.get_dt(get_clock()->now());
-    vehicle_model_ptr_->update(dt);
+  step_simulation(delta_time_.get_dt(get_clock()->now()));
+}
+
+void SimplePlanningSimulator::initialize_lockstep()
+{
+  const auto ack_topics =
+    declare_parameter("lockstep.ack_topics", std::vector<std::string>{});
+  const auto republish_period_ms = declare_parameter("lockstep.republish_period_ms", 1000);
+
+  lockstep_ = std::make_unique<LockstepCoordinator>(
+    std::chrono::milliseconds(timer_sampling_time_ms_), ack_topics);
+  pub_clock_ = create_publisher<Clock>("/clock", rclcpp::QoS{10});
+  for (const auto & topic : ack_topics) {
+    sub_lockstep_acks_.push_back(
+      create_subscription<Clock>(
+        topic, rclcpp::QoS{10},
+        [this, topic](const Clock::ConstSharedPtr msg) {on_lockstep_ack(topic, msg);}));
+  }
+  // Without consumers, step whenever the executor is idle, i.e. as fast as possible
+  const auto period = ack_topics.empty() ?
+    std::chrono::milliseconds::zero() : std::chrono::milliseconds(republish_period_ms);
+  on_timer_ = create_wall_timer(
+    period, std::bind(&SimplePlanningSimulator::on_lockstep_timer, this));
+  RCLCPP_INFO(
+    get_logger(), "lockstep mode with %zu consumers, step %u ms", ack_topics.size(),
+    timer_sampling_time_ms_);
+}
+
+void SimplePlanningSimulator::on_lockstep_timer()
+{
+  if (!is_initialized_) {
+    RCLCPP_INFO_THROTTLE(get_logger(), *get_clock(), 5000, "waiting initialization...");
+    return;
+  }
+  if (lockstep_->ready()) {
+    step_lockstep();
+  } else {
+    // The consumer may have missed the last outputs, e.g. while it was still starting up
+    publish_outputs();
   }
+}
+
+void SimplePlanningSimulator::on_lockstep_ack(
+  const std::string & consumer, const Clock::ConstSharedPtr msg)
+{
+  const auto time = std::chrono::nanoseconds(rclcpp::Time(msg->clock).nanoseconds());
+  static_cast<void>(lockstep_->acknowledge(consumer, time));
+  if (is_initialized_ && lockstep_->ready()) {
+    step_lockstep();
+  }
+}
+
+void SimplePlanningSimulator::step_lockstep()
+{
+  const auto step = lockstep_->step();
+  lockstep_->advance();
+  step_simulation(std::chrono::duration<float64_t>(step).count());
+}
+
+void SimplePlanningSimulator::step_simulation(const float64_t dt)
+{
+  // update vehicle dynamics
+  vehicle_model_ptr_->update(dt);
 
   // set current kinematic state
   current_kinematic_state_ = to_kinematic_state(vehicle_model_ptr_);
@@ -203,12 +266,31 @@ void SimplePlanningSimulator::on_timer()
     add_measurement_noise(current_kinematic_state_);
   }
 
+  publish_outputs();
+}
+
+void SimplePlanningSimulator::publish_outputs()
+{
+  if (pub_clock_) {
+    Clock clock;
+    clock.clock = current_time();
+    pub_clock_->publish(clock);
+  }
+
   // publish vehicle state
   publish_kinematic_state(convert_baselink_to_com(current_kinematic_state_, cg_to_rear_m_));
   publish_state_report();
   publish_tf(current_kinematic_state_);
 }
 
+rclcpp::Time SimplePlanningSimulator::current_time()
+{
+  if (lockstep_) {
+    return rclcpp::Time(lockstep_->now().count(), RCL_ROS_TIME);
+  }
+  return get_clock()->now();
+}
+
 void SimplePlanningSimulator::on_initialpose(
   const geometry_msgs::msg::PoseWithCovarianceStamped::ConstSharedPtr msg)
 {
@@ -306,6 +388,7 @@ void SimplePlanningSimulator::set_initial_state(
     state << x, y, yaw, vx, steer, accx;
   }
   vehicle_model_ptr_->setState(state);
+  current_kinematic_state_ = to_kinematic_state(vehicle_model_ptr_);
 
   is_initialized_ = true;
 }
@@ -334,7 +417,7 @@ void SimplePlanningSimulator::publish_kinematic_state(
 {
   VehicleKinematicState msg = state;
   msg.header.frame_id = origin_frame_id_;
-  msg.header.stamp = get_clock()->now();
+  msg.header.stamp = current_time();
 
   pub_kinematic_state_->publish(msg);
 }
@@ -342,7 +425,7 @@ void SimplePlanningSimulator::publish_kinematic_state(
 void SimplePlanningSimulator::publish_state_report()
 {
   VehicleStateReport msg;
-  msg.stamp = get_clock()->now();
+  msg.stamp = current_time();
   msg.mode = VehicleStateReport::MODE_AUTONOMOUS;
   if (current_vehicle_state_cmd_ptr_) {
     msg.gear = current_vehicle_state_cmd_ptr_->gear;
@@ -353,7 +436,7 @@ void SimplePlanningSimulator::publish_state_report()
 void SimplePlanningSimulator::publish_tf(const VehicleKinematicState & state)
 {
   geometry_msgs::msg::TransformStamped tf;
-  tf.header.stamp = get_clock()->now();
+  tf.header.stamp = current_time();
   tf.header.frame_id = origin_frame_id_;
   tf.child_frame_id = simulated_frame_id_;
   tf.transform.translation.x = state.state.x;
@@ -0,0 +1,95 @@
+// Copyright 2021 The Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+
+#include "simple_planning_simulator/lockstep.hpp"
+#include "simple_planning_simulator/vehicle_model/sim_model.hpp"
+
+using simulation::simple_planning_simulator::LockstepCoordinator;
+using simulation::simple_planning_simulator::VehicleFleet;
+using std::chrono::milliseconds;
+
+TEST(test_lockstep, waits_for_every_consumer)
+{
+  LockstepCoordinator lockstep{milliseconds(25), {"planner", "controller"}};
+  EXPECT_EQ(lockstep.now(), milliseconds(0));
+  EXPECT_FALSE(lockstep.ready());
+  EXPECT_THROW(lockstep.advance(), std::logic_error);
+
+  EXPECT_TRUE(lockstep.acknowledge("planner", milliseconds(0)));
+  EXPECT_FALSE(lockstep.ready());
+  EXPECT_FALSE(lockstep.acknowledge("unknown", milliseconds(0)));
+  EXPECT_TRUE(lockstep.acknowledge("controller", milliseconds(0)));
+  EXPECT_TRUE(lockstep.ready());
+  EXPECT_EQ(lockstep.advance(), milliseconds(25));
+  EXPECT_EQ(lockstep.step_count(), 1U);
+
+  // Acknowledgements of the previous step do not count for the new one
+  EXPECT_FALSE(lockstep.ready());
+  EXPECT_TRUE(lockstep.acknowledge("planner", milliseconds(25)));
+  EXPECT_TRUE(lockstep.acknowledge("controller", milliseconds(25)));
+  // An older acknowledgement arriving late does not undo a newer one
+  EXPECT_TRUE(lockstep.acknowledge("controller", milliseconds(0)));
+  EXPECT_TRUE(lockstep.ready());
+}
+
+TEST(test_lockstep, free_running_without_consumers)
+{
+  LockstepCoordinator lockstep{milliseconds(10), {}};
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_TRUE(lockstep.ready());
+    lockstep.advance();
+  }
+  EXPECT_EQ(lockstep.now(), milliseconds(1000));
+  EXPECT_EQ(lockstep.step_count(), 100U);
+}
+
+TEST(test_lockstep, bad_configuration)
+{
+  EXPECT_THROW(LockstepCoordinator(milliseconds(0), {}), std::invalid_argument);
+  EXPECT_THROW(LockstepCoordinator(milliseconds(10), {"a", "b", "a"}), std::invalid_argument);
+}
+
+TEST(test_lockstep, fleet_steps_every_vehicle)
+{
+  VehicleFleet fleet;
+  EXPECT_THROW(fleet.add(nullptr), std::invalid_argument);
+  constexpr float64_t wheelbase = 3.0;
+  for (int i = 0; i < 3; ++i) {
+    const auto model = std::make_shared<SimModelIdealSteerVel>(wheelbase);
+    Eigen::VectorXd input(model->getDimU());
+    // velocity [m/s], steering angle [rad]
+    input << static_cast<float64_t>(i + 1), 0.0;
+    model->setInput(input);
+    EXPECT_EQ(fleet.add(model), static_cast<std::size_t>(i));
+  }
+  ASSERT_EQ(fleet.size(), 3U);
+  EXPECT_THROW(fleet.vehicle(3U), std::out_of_range);
+
+  LockstepCoordinator lockstep{milliseconds(100), {}};
+  while (lockstep.now() < milliseconds(2000)) {
+    lockstep.advance();
+    fleet.step(std::chrono::duration<float64_t>(lockstep.step()).count());
+  }
+  for (std::size_t i = 0U; i < fleet.size(); ++i) {
+    EXPECT_NEAR(fleet.vehicle(i).getX(), 2.0 * static_cast<float64_t>(i + 1U), 1e-6);
+    EXPECT_NEAR(fleet.vehicle(i).getY(), 0.0, 1e-6);
+  }
+}
@@ -0,0 +1,132 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/// \brief This file defines the helpers that limit the rendering load of the displays
+#ifndef COMMON__LEVEL_OF_DETAIL_HPP_
+#define COMMON__LEVEL_OF_DETAIL_HPP_
+
+#include <common/types.hpp>
+#include <geometry_msgs/msg/point.hpp>
+#include <rviz_common/display_context.hpp>
+#include <rviz_common/properties/float_property.hpp>
+#include <rviz_common/properties/property.hpp>
+#include <std_msgs/msg/header.hpp>
+#include <visibility_control.hpp>
+
+namespace autoware
+{
+namespace rviz_plugins
+{
+namespace common
+{
+using autoware::common::types::float32_t;
+using autoware::common::types::float64_t;
+
+/// \brief How much of an element a display draws
+enum class DetailLevel
+{
+  /// Everything, e.g. 3d shapes and labels
+  FULL,
+  /// A cheaper outline without labels
+  REDUCED,
+  /// Nothing
+  HIDDEN
+};
+
+/// \brief Picks the detail level of elements from their distance to the camera
+class AUTOWARE_RVIZ_PLUGINS_PUBLIC LevelOfDetail
+{
+public:
+  /// \brief Draw everything in full detail
+  LevelOfDetail() = default;
+
+  /// \brief Constructor
+  /// \param viewpoint The position of the camera, in the frame of the elements
+  /// \param reduced_distance The distance beyond which elements are drawn in reduced detail, not
+  ///        positive for no limit
+  /// \param hidden_distance The distance beyond which elements are not drawn, not positive for no
+  ///        limit
+  LevelOfDetail(
+    const geometry_msgs::msg::Point & viewpoint, const float64_t reduced_distance,
+    const float64_t hidden_distance);
+
+  /// \brief Get the detail level of an element
+  /// \param position The position of the element, in the frame of the elements
+  /// \return The detail level for the distance of the element to the camera
+  DetailLevel at(const geometry_msgs::msg::Point & position) const;
+
+private:
+  geometry_msgs::msg::Point m_viewpoint{};
+  // Squared distances, negative for no limit
+  float64_t m_reduced_distance2{-1.0};
+  float64_t m_hidden_distance2{-1.0};
+};
+
+/// \brief Limits how often a display renders its latest message. Messages that arrive faster are
+///        coalesced, only the latest one is rendered.
+class AUTOWARE_RVIZ_PLUGINS_PUBLIC UpdateThrottle
+{
+public:
+  /// \brief Request to render, e.g. on a new message or a changed property
+  void request();
+
+  /// \brief Check whether to render, to be called on every update of the display
+  /// \param wall_dt The wall time since the last call in seconds
+  /// \param max_rate_hz The maximum rate of rendering, not positive for no limit
+  /// \return True if a render was requested and is due, the request is then cleared
+  bool poll(const float32_t wall_dt, const float32_t max_rate_hz);
+
+  /// \brief Drop a pending request
+  void reset();
+
+private:
+  bool m_requested{false};
+  // Time since the last render
+  float32_t m_elapsed{0.0F};
+  bool m_rendered{false};
+};
+
+/// \brief Class to define the properties that limit the rendering load of a display
+class AUTOWARE_RVIZ_PLUGINS_PUBLIC RenderingProperties
+{
+public:
+  /// \brief Constructor
+  /// \param parent_property Parent property for the rendering properties. Memory managed by the
+  ///        caller
+  explicit RenderingProperties(rviz_common::properties::Property * parent_property);
+
+  /// \brief The maximum rate at which the display renders messages, 0 for no limit
+  float32_t max_update_rate() const;
+
+  /// \brief Get the level of detail for the elements of a message
+  /// \param context The context of the display, to get the camera and the transform of the
+  ///        message frame
+  /// \param header The header of the message
+  /// \return The level of detail in the frame of the message, full detail everywhere if the
+  ///         transform or the camera aren't available
+  LevelOfDetail level_of_detail(
+    rviz_common::DisplayContext & context, const std_msgs::msg::Header & header) const;
+
+private:
+  rviz_common::properties::Property m_group_property;
+  rviz_common::properties::FloatProperty m_max_update_rate_property;
+  rviz_common::properties::FloatProperty m_reduced_distance_property;
+  rviz_common::properties::FloatProperty m_hidden_distance_property;
+};
+
+}  // namespace common
+}  // namespace rviz_plugins
+}  // namespace autoware
+
+#endif   // COMMON__LEVEL_OF_DETAIL_HPP_
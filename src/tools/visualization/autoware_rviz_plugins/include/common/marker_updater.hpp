@@ -0,0 +1,67 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef COMMON__MARKER_UPDATER_HPP_
+#define COMMON__MARKER_UPDATER_HPP_
+
+#include <rviz_default_plugins/displays/marker/marker_common.hpp>
+#include <std_msgs/msg/header.hpp>
+#include <visualization_msgs/msg/marker.hpp>
+#include <visibility_control.hpp>
+
+#include <set>
+#include <string>
+#include <utility>
+
+namespace autoware
+{
+namespace rviz_plugins
+{
+namespace common
+{
+/// \brief Class to update the markers of a display incrementally. MarkerCommon reuses the
+///        visuals of a marker that is added again with the same namespace, id and type, so
+///        instead of clearing all markers on every message, the display adds its markers with
+///        stable ids and this class deletes only the ones the latest message doesn't have anymore.
+class AUTOWARE_RVIZ_PLUGINS_PUBLIC MarkerUpdater
+{
+public:
+  using Marker = visualization_msgs::msg::Marker;
+  using MarkerCommon = rviz_default_plugins::displays::MarkerCommon;
+
+  /// \brief Add a marker, or update the marker with the same namespace and id in place
+  /// \param marker_common The MarkerCommon of the display
+  /// \param marker The marker, with its namespace and id set
+  void add(MarkerCommon & marker_common, Marker::ConstSharedPtr marker);
+
+  /// \brief Delete the markers that were added for the previous message but not since
+  /// \param marker_common The MarkerCommon of the display
+  /// \param header The header of the current message
+  void finish(MarkerCommon & marker_common, const std_msgs::msg::Header & header);
+
+  /// \brief Forget about all markers, to be called when the markers of the display are cleared
+  void clear();
+
+private:
+  using MarkerId = std::pair<std::string, int32_t>;
+
+  std::set<MarkerId> m_previous_ids;
+  std::set<MarkerId> m_current_ids;
+};
+
+}  // namespace common
+}  // namespace rviz_plugins
+}  // namespace autoware
+
+#endif   // COMMON__MARKER_UPDATER_HPP_
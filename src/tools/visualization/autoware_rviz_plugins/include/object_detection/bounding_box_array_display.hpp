@@ -24,7 +24,10 @@
 #include <rviz_default_plugins/displays/marker_array/marker_array_display.hpp>
 #include <autoware_auto_msgs/msg/bounding_box_array.hpp>
 #include <visibility_control.hpp>
+#include <common/level_of_detail.hpp>
+#include <common/marker_updater.hpp>
 #include <common/types.hpp>
+#include <map>
 #include <memory>
 
 using autoware::common::types::float32_t;
@@ -55,13 +58,22 @@ private Q_SLOTS:
   void updateProperty();
 
 private:
-  // Convert boxes into markers, push them to the display queue
+  // Keep the latest array, it is rendered on the next update that the throttle allows
   void processMessage(BoundingBoxArray::ConstSharedPtr array) override;
-  // Convert box message to a marker message
-  Marker::SharedPtr get_marker(const BoundingBox & box) const;
+  // Convert the boxes into one triangle list marker per label, push them to the display queue
+  void render(const BoundingBoxArray & array);
+  // Get the marker that draws all boxes with the label of the given box
+  Marker & get_batch(const BoundingBox & box);
+  // Get the color property for a label
+  QColor get_color(const BoundingBox::_vehicle_label_type label) const;
 
   std::unique_ptr<MarkerCommon> m_marker_common;
   BoundingBoxArray::ConstSharedPtr msg_cache{};
+  common::RenderingProperties m_rendering_properties;
+  common::UpdateThrottle m_throttle;
+  common::MarkerUpdater m_marker_updater;
+  // One marker with the boxes of a label, by label
+  std::map<int32_t, Marker::SharedPtr> m_batches;
   rviz_common::properties::ColorProperty * no_label_color_property_;
   rviz_common::properties::ColorProperty * car_color_property_;
   rviz_common::properties::ColorProperty * pedestrian_color_property_;
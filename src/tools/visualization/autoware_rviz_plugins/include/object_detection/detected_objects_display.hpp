@@ -35,7 +35,7 @@ public:
   DetectedObjectsDisplay();
 
 private:
-  void processMessage(DetectedObjects::ConstSharedPtr msg) override;
+  void render(const DetectedObjects & msg, const common::LevelOfDetail & lod) override;
 };
 
 }  // namespace object_detection
@@ -76,6 +76,22 @@ AUTOWARE_RVIZ_PLUGINS_PUBLIC visualization_msgs::msg::Marker::SharedPtr get_3d_p
   const autoware_auto_msgs::msg::Shape & shape_msg,
   const std_msgs::msg::ColorRGBA & color_rgba);
 
+/// \brief Append the edges of the given polygon in 2d to a LINE_LIST marker, so that many shapes
+///        can be drawn with a single marker
+/// \param shape_msg Shape msg to be appended
+/// \param marker Marker to append the edges to
+AUTOWARE_RVIZ_PLUGINS_PUBLIC void append_2d_polygon_lines(
+  const autoware_auto_msgs::msg::Shape & shape_msg,
+  visualization_msgs::msg::Marker & marker);
+
+/// \brief Append the edges of the given polygon in 3d to a LINE_LIST marker, so that many shapes
+///        can be drawn with a single marker
+/// \param shape_msg Shape msg to be appended
+/// \param marker Marker to append the edges to
+AUTOWARE_RVIZ_PLUGINS_PUBLIC void append_3d_polygon_lines(
+  const autoware_auto_msgs::msg::Shape & shape_msg,
+  visualization_msgs::msg::Marker & marker);
+
 /// \brief Convert Point32 to Point
 /// \param val Point32 to be converted
 /// \return Point type
@@ -16,6 +16,8 @@
 
 #include <autoware_auto_msgs/msg/object_classification.hpp>
 #include <common/color_alpha_property.hpp>
+#include <common/level_of_detail.hpp>
+#include <common/marker_updater.hpp>
 #include <object_detection/object_polygon_detail.hpp>
 #include <rviz_common/display.hpp>
 #include <rviz_common/properties/color_property.hpp>
@@ -25,6 +27,7 @@
 #include <visibility_control.hpp>
 
 #include <list>
+#include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -37,7 +40,8 @@ namespace object_detection
 {
 /// \brief Base rviz plugin class for all object msg types. The class defines common properties
 ///        for the plugin and also defines common helper functions that can be used by its derived
-///        classes.
+///        classes. Messages are rendered from update() at most at the maximum update rate, the
+///        derived classes implement render() instead of processMessage().
 /// \tparam MsgT TrackedObjects or DetectedObjects type
 template<typename MsgT>
 class AUTOWARE_RVIZ_PLUGINS_PUBLIC ObjectPolygonDisplayBase
@@ -60,7 +64,8 @@ public:
       true,
       "Enable/disable height visualization of the polygon", this
     },
-    m_default_topic{default_topic}
+    m_default_topic{default_topic},
+    m_rendering_properties{this}
   {
     // iterate over default values to create and initialize the properties.
     for (const auto & map_property_it : detail::kDefaultObjectPropertyValues) {
@@ -98,26 +103,85 @@ public:
 
   void update(float wall_dt, float ros_dt) override
   {
+    if ((m_msg_cache != nullptr) &&
+      m_throttle.poll(wall_dt, m_rendering_properties.max_update_rate()))
+    {
+      m_polygon_batches.clear();
+      render(
+        *m_msg_cache,
+        m_rendering_properties.level_of_detail(*this->context_, m_msg_cache->header));
+      for (const auto & batch : m_polygon_batches) {
+        batch.second->header = m_msg_cache->header;
+        add_marker(batch.second);
+      }
+      m_marker_updater.finish(m_marker_common, m_msg_cache->header);
+    }
     m_marker_common.update(wall_dt, ros_dt);
   }
 
   void reset() override
   {
     RosTopicDisplay::reset();
-    m_marker_common.clearMarkers();
+    clear_markers();
+    m_msg_cache.reset();
+    m_throttle.reset();
   }
 
   void clear_markers()
   {
     m_marker_common.clearMarkers();
+    m_marker_updater.clear();
   }
 
+  /// \brief Add a marker or update the marker with the same namespace and id in place. Markers
+  ///        of the previous message that aren't added again are deleted after render().
   void add_marker(visualization_msgs::msg::Marker::ConstSharedPtr marker_ptr)
   {
-    m_marker_common.addMessage(marker_ptr);
+    m_marker_updater.add(m_marker_common, marker_ptr);
   }
 
 protected:
+  /// \brief Render the latest message
+  /// \param msg The message to render
+  /// \param lod Level of detail for the elements of the message
+  virtual void render(const MsgT & msg, const common::LevelOfDetail & lod) = 0;
+
+  /// \brief Add a shape to the polygons drawn in the current render(). All shapes of a class
+  ///        are drawn with a single marker, instead of a marker per shape.
+  /// \tparam ClassificationContainerT List type with ObjectClassificationMsg
+  /// \param shape_msg Shape msg to be drawn
+  /// \param labels List of ObjectClassificationMsg objects
+  /// \param level Detail level of the shape, reduced detail draws the shape in 2d
+  template<typename ClassificationContainerT>
+  void add_to_polygon_batch(
+    const autoware_auto_msgs::msg::Shape & shape_msg, const ClassificationContainerT & labels,
+    const common::DetailLevel level)
+  {
+    if (level == common::DetailLevel::HIDDEN) {
+      return;
+    }
+    if (shape_msg.polygon.points.empty()) {
+      RCLCPP_WARN(rclcpp::get_logger("ObjectPolygonDisplayBase"), "Empty polygon!");
+      return;
+    }
+    const auto property_it = find_polygon_property(labels);
+    auto & batch = m_polygon_batches[property_it->first];
+    if (batch == nullptr) {
+      batch = std::make_shared<Marker>();
+      batch->ns = "polygons";
+      batch->id = static_cast<int32_t>(property_it->first);
+      batch->scale.x = 0.1;
+      batch->type = Marker::LINE_LIST;
+      batch->action = Marker::ADD;
+      batch->color = property_it->second;
+    }
+    if ((level == common::DetailLevel::FULL) && m_display_3d_property.getBool()) {
+      detail::append_3d_polygon_lines(shape_msg, *batch);
+    } else {
+      detail::append_2d_polygon_lines(shape_msg, *batch);
+    }
+  }
+
   /// \brief Convert given shape msg into a Marker
   /// \tparam ClassificationContainerT List type with ObjectClassificationMsg
   /// \param shape_msg Shape msg to be converted
@@ -144,6 +208,16 @@ protected:
   ///         degenerate cases
   template<typename ClassificationContainerT>
   std_msgs::msg::ColorRGBA get_color_rgba(const ClassificationContainerT & labels) const
+  {
+    return find_polygon_property(labels)->second;
+  }
+
+private:
+  /// \brief Get the color and alpha property for the best class in the given list, or for the
+  ///        unknown class if the best class has none
+  template<typename ClassificationContainerT>
+  typename PolygonPropertyMap::const_iterator find_polygon_property(
+    const ClassificationContainerT & labels) const
   {
     static const std::string kLoggerName("ObjectPolygonDisplayBase");
     const auto label = detail::get_best_label(labels, kLoggerName);
@@ -155,10 +229,16 @@ protected:
         "label ", std::to_string(label), "Using property values from UNKNOWN");
       it = m_polygon_properties.find(ObjectClassificationMsg::UNKNOWN);
     }
-    return it->second;
+    return it;
+  }
+
+  // Keep the latest message, it is rendered on the next update that the throttle allows
+  void processMessage(typename MsgT::ConstSharedPtr msg) override
+  {
+    m_msg_cache = msg;
+    m_throttle.request();
   }
 
-private:
   // All rviz plugins should have this. Should be initialized with pointer to this class
   MarkerCommon m_marker_common;
   // List is used to store the properties for classification in case we need to access them:
@@ -169,6 +249,16 @@ private:
   rviz_common::properties::BoolProperty m_display_3d_property;
   // Default topic name to be visualized
   std::string m_default_topic;
+  // Properties to limit the rendering load
+  common::RenderingProperties m_rendering_properties;
+  // Limits the rate at which messages are rendered
+  common::UpdateThrottle m_throttle;
+  // Latest message, rendered on the next update the throttle allows
+  typename MsgT::ConstSharedPtr m_msg_cache{};
+  // Deletes the markers that aren't drawn for the latest message anymore
+  common::MarkerUpdater m_marker_updater;
+  // One marker with the polygons of all objects of a class, by class label
+  std::map<ObjectClassificationMsg::_classification_type, Marker::SharedPtr> m_polygon_batches;
 };
 }  // namespace object_detection
 }  // namespace rviz_plugins
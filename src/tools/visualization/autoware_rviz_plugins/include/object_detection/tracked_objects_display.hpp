@@ -35,7 +35,7 @@ public:
   TrackedObjectsDisplay();
 
 private:
-  void processMessage(TrackedObjects::ConstSharedPtr msg) override;
+  void render(const TrackedObjects & msg, const common::LevelOfDetail & lod) override;
 
   visualization_msgs::msg::Marker::SharedPtr get_marker_ptr_for_track_id(
     const autoware_auto_msgs::msg::TrackedObject & track);
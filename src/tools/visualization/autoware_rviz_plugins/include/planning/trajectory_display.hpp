@@ -24,6 +24,8 @@
 #include <rviz_default_plugins/displays/marker_array/marker_array_display.hpp>
 #include <autoware_auto_msgs/msg/trajectory.hpp>
 #include <visibility_control.hpp>
+#include <common/level_of_detail.hpp>
+#include <common/marker_updater.hpp>
 #include <common/types.hpp>
 #include <memory>
 
@@ -55,8 +57,10 @@ private:
   using Trajectory = autoware_auto_msgs::msg::Trajectory;
   using TrajectoryPoint = autoware_auto_msgs::msg::TrajectoryPoint;
 
-  // Convert boxes into markers, push them to the display queue
+  // Keep the latest trajectory, it is rendered on the next update that the throttle allows
   void processMessage(Trajectory::ConstSharedPtr msg) override;
+  // Convert the trajectory into markers keyed by point index, push them to the display queue
+  void render(const Trajectory & msg);
   // Convert trajectory message to a marker message
   Marker::SharedPtr create_pose_marker(const TrajectoryPoint & point) const;
   Marker::SharedPtr create_velocity_marker(const TrajectoryPoint & point) const;
@@ -68,6 +72,9 @@ private:
   rviz_common::properties::FloatProperty * scale_property_;
   rviz_common::properties::FloatProperty * text_alpha_property_;
   rviz_common::properties::FloatProperty * text_scale_property_;
+  common::RenderingProperties m_rendering_properties;
+  common::UpdateThrottle m_throttle;
+  common::MarkerUpdater m_marker_updater;
 };
 }  // namespace rviz_plugins
 }  // namespace autoware
@@ -0,0 +1,133 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <common/level_of_detail.hpp>
+
+#include <OgreCamera.h>
+#include <OgreQuaternion.h>
+#include <OgreVector3.h>
+#include <rviz_common/frame_manager_iface.hpp>
+#include <rviz_common/view_controller.hpp>
+#include <rviz_common/view_manager.hpp>
+
+namespace autoware
+{
+namespace rviz_plugins
+{
+namespace common
+{
+
+LevelOfDetail::LevelOfDetail(
+  const geometry_msgs::msg::Point & viewpoint, const float64_t reduced_distance,
+  const float64_t hidden_distance)
+: m_viewpoint{viewpoint},
+  m_reduced_distance2{reduced_distance > 0.0 ? reduced_distance * reduced_distance : -1.0},
+  m_hidden_distance2{hidden_distance > 0.0 ? hidden_distance * hidden_distance : -1.0}
+{
+}
+
+DetailLevel LevelOfDetail::at(const geometry_msgs::msg::Point & position) const
+{
+  const auto dx = position.x - m_viewpoint.x;
+  const auto dy = position.y - m_viewpoint.y;
+  const auto dz = position.z - m_viewpoint.z;
+  const auto distance2 = (dx * dx) + (dy * dy) + (dz * dz);
+  if ((m_hidden_distance2 >= 0.0) && (distance2 > m_hidden_distance2)) {
+    return DetailLevel::HIDDEN;
+  }
+  if ((m_reduced_distance2 >= 0.0) && (distance2 > m_reduced_distance2)) {
+    return DetailLevel::REDUCED;
+  }
+  return DetailLevel::FULL;
+}
+
+void UpdateThrottle::request()
+{
+  m_requested = true;
+}
+
+bool UpdateThrottle::poll(const float32_t wall_dt, const float32_t max_rate_hz)
+{
+  m_elapsed += wall_dt;
+  if (!m_requested) {
+    return false;
+  }
+  if (m_rendered && (max_rate_hz > 0.0F) && ((m_elapsed * max_rate_hz) < 1.0F)) {
+    return false;
+  }
+  m_requested = false;
+  m_rendered = true;
+  m_elapsed = 0.0F;
+  return true;
+}
+
+void UpdateThrottle::reset()
+{
+  m_requested = false;
+}
+
+RenderingProperties::RenderingProperties(rviz_common::properties::Property * parent_property)
+: m_group_property("Rendering", QVariant(), "Limits the rendering load of the display.",
+    parent_property),
+  m_max_update_rate_property("Max Update Rate", 10.0F,
+    "Maximum rate in Hz at which messages are rendered, only the latest message is rendered. "
+    "0 for no limit.", &m_group_property),
+  m_reduced_distance_property("Detail Distance", 50.0F,
+    "Distance from the camera in meters beyond which elements are drawn as outlines without "
+    "labels. 0 for no limit.", &m_group_property),
+  m_hidden_distance_property("Max Distance", 0.0F,
+    "Distance from the camera in meters beyond which elements are not drawn. 0 for no limit.",
+    &m_group_property)
+{
+  m_max_update_rate_property.setMin(0.0F);
+  m_reduced_distance_property.setMin(0.0F);
+  m_hidden_distance_property.setMin(0.0F);
+}
+
+float32_t RenderingProperties::max_update_rate() const
+{
+  return m_max_update_rate_property.getFloat();
+}
+
+LevelOfDetail RenderingProperties::level_of_detail(
+  rviz_common::DisplayContext & context, const std_msgs::msg::Header & header) const
+{
+  const auto reduced_distance = static_cast<float64_t>(m_reduced_distance_property.getFloat());
+  const auto hidden_distance = static_cast<float64_t>(m_hidden_distance_property.getFloat());
+  if ((reduced_distance <= 0.0) && (hidden_distance <= 0.0)) {
+    return LevelOfDetail{};
+  }
+  const auto view_manager = context.getViewManager();
+  const auto view = (view_manager != nullptr) ? view_manager->getCurrent() : nullptr;
+  if ((view == nullptr) || (view->getCamera() == nullptr)) {
+    return LevelOfDetail{};
+  }
+  Ogre::Vector3 frame_position;
+  Ogre::Quaternion frame_orientation;
+  if (!context.getFrameManager()->getTransform(header, frame_position, frame_orientation)) {
+    return LevelOfDetail{};
+  }
+  // The scene is in the fixed frame, bring the camera into the frame of the message
+  const auto camera =
+    frame_orientation.Inverse() * (view->getCamera()->getDerivedPosition() - frame_position);
+  geometry_msgs::msg::Point viewpoint;
+  viewpoint.x = static_cast<float64_t>(camera.x);
+  viewpoint.y = static_cast<float64_t>(camera.y);
+  viewpoint.z = static_cast<float64_t>(camera.z);
+  return LevelOfDetail{viewpoint, reduced_distance, hidden_distance};
+}
+
+}  // namespace common
+}  // namespace rviz_plugins
+}  // namespace autoware
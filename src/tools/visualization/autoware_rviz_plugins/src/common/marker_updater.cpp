@@ -0,0 +1,56 @@
+// Copyright 2021 the Autoware Foundation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <common/marker_updater.hpp>
+
+#include <memory>
+
+namespace autoware
+{
+namespace rviz_plugins
+{
+namespace common
+{
+
+void MarkerUpdater::add(MarkerCommon & marker_common, Marker::ConstSharedPtr marker)
+{
+  m_current_ids.emplace(marker->ns, marker->id);
+  marker_common.addMessage(marker);
+}
+
+void MarkerUpdater::finish(MarkerCommon & marker_common, const std_msgs::msg::Header & header)
+{
+  for (const auto & id : m_previous_ids) {
+    if (m_current_ids.find(id) == m_current_ids.end()) {
+      auto marker_ptr = std::make_shared<Marker>();
+      marker_ptr->header = header;
+      marker_ptr->ns = id.first;
+      marker_ptr->id = id.second;
+      marker_ptr->action = Marker::DELETE;
+      marker_common.addMessage(marker_ptr);
+    }
+  }
+  m_previous_ids.swap(m_current_ids);
+  m_current_ids.clear();
+}
+
+void MarkerUpdater::clear()
+{
+  m_previous_ids.clear();
+  m_current_ids.clear();
+}
+
+}  // namespace common
+}  // namespace rviz_plugins
+}  // namespace autoware
@@ -25,10 +25,50 @@ namespace autoware
 {
 namespace rviz_plugins
 {
+namespace
+{
+// Append the 12 triangles of the faces of a box to a triangle list marker. The extents along the
+// axes of the box are swapped like in the scale of a cube marker of the box.
+void append_box_triangles(
+  const autoware_auto_msgs::msg::BoundingBox & box,
+  visualization_msgs::msg::Marker & marker)
+{
+  const auto & q = box.orientation;
+  const auto rotate = [&q, &box](const float32_t x, const float32_t y, const float32_t z) {
+      // v' = v + w * t + q x t, with t = 2 * (q x v)
+      const auto tx = 2.0F * ((q.y * z) - (q.z * y));
+      const auto ty = 2.0F * ((q.z * x) - (q.x * z));
+      const auto tz = 2.0F * ((q.x * y) - (q.y * x));
+      geometry_msgs::msg::Point pt;
+      pt.x = static_cast<float64_t>(box.centroid.x + x + (q.w * tx) + ((q.y * tz) - (q.z * ty)));
+      pt.y = static_cast<float64_t>(box.centroid.y + y + (q.w * ty) + ((q.z * tx) - (q.x * tz)));
+      pt.z = static_cast<float64_t>(box.centroid.z + z + (q.w * tz) + ((q.x * ty) - (q.y * tx)));
+      return pt;
+    };
+  const auto hx = 0.5F * box.size.y;
+  const auto hy = 0.5F * box.size.x;
+  const auto hz = 0.5F * box.size.z;
+  const geometry_msgs::msg::Point corners[8U] = {
+    rotate(-hx, -hy, -hz), rotate(hx, -hy, -hz), rotate(hx, hy, -hz), rotate(-hx, hy, -hz),
+    rotate(-hx, -hy, hz), rotate(hx, -hy, hz), rotate(hx, hy, hz), rotate(-hx, hy, hz)};
+  // Two triangles per face, bottom, top and the four sides
+  static constexpr std::size_t kIndices[36U] = {
+    0U, 2U, 1U, 0U, 3U, 2U,
+    4U, 5U, 6U, 4U, 6U, 7U,
+    0U, 1U, 5U, 0U, 5U, 4U,
+    1U, 2U, 6U, 1U, 6U, 5U,
+    2U, 3U, 7U, 2U, 7U, 6U,
+    3U, 0U, 4U, 3U, 4U, 7U};
+  for (const auto idx : kIndices) {
+    marker.points.push_back(corners[idx]);
+  }
+}
+}  // namespace
 
 BoundingBoxArrayDisplay::BoundingBoxArrayDisplay()
 : rviz_common::RosTopicDisplay<autoware_auto_msgs::msg::BoundingBoxArray>(),
-  m_marker_common(std::make_unique<MarkerCommon>(this))
+  m_marker_common(std::make_unique<MarkerCommon>(this)),
+  m_rendering_properties(this)
 {
   no_label_color_property_ = new rviz_common::properties::ColorProperty(
     "No Label Color", QColor(255.0, 255.0, 255.0), "Color to draw unlabelled boundingboxes.",
@@ -73,76 +113,97 @@ void BoundingBoxArrayDisplay::load(const rviz_common::Config & config)
 
 void BoundingBoxArrayDisplay::updateProperty()
 {
-  if (msg_cache != nullptr) {
-    processMessage(msg_cache);
-  }
+  m_throttle.request();
 }
 
 void BoundingBoxArrayDisplay::processMessage(
   BoundingBoxArray::ConstSharedPtr msg)
 {
   msg_cache = msg;
-  m_marker_common->clearMarkers();
-  for (auto idx = 0U; idx < msg->boxes.size(); idx++) {
-    const auto marker_ptr = get_marker(msg->boxes[idx]);
-    marker_ptr->ns = "bounding_box";
-    marker_ptr->header = msg->header;
-    marker_ptr->id = static_cast<int>(idx);
-    m_marker_common->addMessage(marker_ptr);
-  }
+  m_throttle.request();
 }
 
-visualization_msgs::msg::Marker::SharedPtr BoundingBoxArrayDisplay::get_marker(
-  const BoundingBox & box) const
+void BoundingBoxArrayDisplay::render(const BoundingBoxArray & msg)
 {
-  auto marker = std::make_shared<Marker>();
-
-  marker->type = Marker::CUBE;
-  marker->action = Marker::ADD;
-  marker->color.a = alpha_property_->getFloat();
+  const auto lod = m_rendering_properties.level_of_detail(*context_, msg.header);
+  m_batches.clear();
+  for (const auto & box : msg.boxes) {
+    geometry_msgs::msg::Point centroid;
+    centroid.x = static_cast<float64_t>(box.centroid.x);
+    centroid.y = static_cast<float64_t>(box.centroid.y);
+    centroid.z = static_cast<float64_t>(box.centroid.z);
+    if (lod.at(centroid) == common::DetailLevel::HIDDEN) {
+      continue;
+    }
+    append_box_triangles(box, get_batch(box));
+  }
+  for (const auto & batch : m_batches) {
+    batch.second->header = msg.header;
+    m_marker_updater.add(*m_marker_common, batch.second);
+  }
+  m_marker_updater.finish(*m_marker_common, msg.header);
+}
 
-  QColor color;
+visualization_msgs::msg::Marker & BoundingBoxArrayDisplay::get_batch(const BoundingBox & box)
+{
+  // Labels without their own color property share the marker of the other labels
+  auto batch_id = static_cast<int32_t>(box.vehicle_label);
   switch (box.vehicle_label) {
-    case BoundingBox::NO_LABEL:     // white: non labeled
-      color = no_label_color_property_->getColor();
+    case BoundingBox::NO_LABEL:
+    case BoundingBox::CAR:
+    case BoundingBox::PEDESTRIAN:
+    case BoundingBox::CYCLIST:
+    case BoundingBox::MOTORCYCLE:
       break;
-    case BoundingBox::CAR:          // yellow: car
-      color = car_color_property_->getColor();
+    default:
+      batch_id = -1;
       break;
+  }
+  auto & batch = m_batches[batch_id];
+  if (batch == nullptr) {
+    batch = std::make_shared<Marker>();
+    batch->ns = "bounding_box";
+    batch->id = batch_id;
+    batch->type = Marker::TRIANGLE_LIST;
+    batch->action = Marker::ADD;
+    batch->pose.orientation.w = 1.0;
+    batch->scale.x = 1.0;
+    batch->scale.y = 1.0;
+    batch->scale.z = 1.0;
+    const auto color = get_color(box.vehicle_label);
+    batch->color.r = static_cast<float>(color.redF());
+    batch->color.g = static_cast<float>(color.greenF());
+    batch->color.b = static_cast<float>(color.blueF());
+    batch->color.a = alpha_property_->getFloat();
+  }
+  return *batch;
+}
+
+QColor BoundingBoxArrayDisplay::get_color(const BoundingBox::_vehicle_label_type label) const
+{
+  switch (label) {
+    case BoundingBox::NO_LABEL:     // white: non labeled
+      return no_label_color_property_->getColor();
+    case BoundingBox::CAR:          // yellow: car
+      return car_color_property_->getColor();
     case BoundingBox::PEDESTRIAN:   // blue: pedestrian
-      color = pedestrian_color_property_->getColor();
-      break;
+      return pedestrian_color_property_->getColor();
     case BoundingBox::CYCLIST:      // orange: cyclist
-      color = cyclist_color_property_->getColor();
-      break;
+      return cyclist_color_property_->getColor();
     case BoundingBox::MOTORCYCLE:   // green: motorcycle
-      color = motorcycle_color_property_->getColor();
-      break;
+      return motorcycle_color_property_->getColor();
     default:                        // black: other labels
-      color = other_color_property_->getColor();
-      break;
+      return other_color_property_->getColor();
   }
-
-  marker->color.r = static_cast<float>(color.redF());
-  marker->color.g = static_cast<float>(color.greenF());
-  marker->color.b = static_cast<float>(color.blueF());
-  marker->pose.position.x = static_cast<float64_t>(box.centroid.x);
-  marker->pose.position.y = static_cast<float64_t>(box.centroid.y);
-  marker->pose.position.z = static_cast<float64_t>(box.centroid.z);
-  marker->pose.orientation.x = static_cast<float64_t>(box.orientation.x);
-  marker->pose.orientation.y = static_cast<float64_t>(box.orientation.y);
-  marker->pose.orientation.z = static_cast<float64_t>(box.orientation.z);
-  marker->pose.orientation.w = static_cast<float64_t>(box.orientation.w);
-  marker->scale.y = static_cast<float64_t>(box.size.x);
-  marker->scale.x = static_cast<float64_t>(box.size.y);
-  marker->scale.z = static_cast<float64_t>(box.size.z);
-
-  return marker;
 }
 
-
 void BoundingBoxArrayDisplay::update(float32_t wall_dt, float32_t ros_dt)
 {
+  if ((msg_cache != nullptr) &&
+    m_throttle.poll(wall_dt, m_rendering_properties.max_update_rate()))
+  {
+    render(*msg_cache);
+  }
   m_marker_common->update(wall_dt, ros_dt);
 }
 
@@ -150,6 +211,9 @@ void BoundingBoxArrayDisplay::reset()
 {
   RosTopicDisplay::reset();
   m_marker_common->clearMarkers();
+  m_marker_updater.clear();
+  msg_cache.reset();
+  m_throttle.reset();
 }
 
 }  // namespace rviz_plugins
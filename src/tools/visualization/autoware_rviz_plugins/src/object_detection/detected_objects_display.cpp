@@ -27,16 +27,13 @@ namespace object_detection
 DetectedObjectsDisplay::DetectedObjectsDisplay()
 : ObjectPolygonDisplayBase("detected_objects") {}
 
-void DetectedObjectsDisplay::processMessage(DetectedObjects::ConstSharedPtr msg)
+void DetectedObjectsDisplay::render(
+  const DetectedObjects & msg,
+  const common::LevelOfDetail & lod)
 {
-  clear_markers();
-  int id = 0;
-  for (const auto & object : msg->objects) {
-    // Get marker for shape
-    auto shape_marker_ptr = get_marker_ptr(object.shape, object.classification);
-    shape_marker_ptr->header = msg->header;
-    shape_marker_ptr->id = id++;
-    add_marker(shape_marker_ptr);
+  for (const auto & object : msg.objects) {
+    add_to_polygon_batch(
+      object.shape, object.classification, lod.at(object.kinematics.centroid_position));
   }
 }
 
@@ -68,6 +68,30 @@ visualization_msgs::msg::Marker::SharedPtr get_3d_polygon_marker_ptr(
   marker_ptr->type = Marker::LINE_LIST;
   marker_ptr->action = Marker::ADD;
   marker_ptr->color = color_rgba;
+  append_3d_polygon_lines(shape_msg, *marker_ptr);
+
+  return marker_ptr;
+}
+
+void append_2d_polygon_lines(
+  const autoware_auto_msgs::msg::Shape & shape_msg,
+  visualization_msgs::msg::Marker & marker)
+{
+  const auto & points = shape_msg.polygon.points;
+  for (std::size_t idx = 0U; idx < points.size(); ++idx) {
+    marker.points.push_back(to_point(points[idx]));
+    marker.points.push_back(to_point(points[(idx + 1U) % points.size()]));
+  }
+}
+
+void append_3d_polygon_lines(
+  const autoware_auto_msgs::msg::Shape & shape_msg,
+  visualization_msgs::msg::Marker & marker)
+{
+  if (shape_msg.polygon.points.empty()) {
+    return;
+  }
+  marker.points.reserve(marker.points.size() + (6U * shape_msg.polygon.points.size()));
 
   // To construct a 3d polygon using line list, we need to define all the edges with the two
   // end points. We will first draw lower part of the polygon by inserting all the vertices
@@ -80,34 +104,32 @@ visualization_msgs::msg::Marker::SharedPtr get_3d_polygon_marker_ptr(
   first_pt = to_point(shape_msg.polygon.points.front());
   for (auto it = shape_msg.polygon.points.begin(); it != shape_msg.polygon.points.end(); ++it) {
     geometry_msgs::msg::Point pt = to_point(*it);
-    marker_ptr->points.push_back(pt);
+    marker.points.push_back(pt);
     if (it != shape_msg.polygon.points.begin()) {
-      marker_ptr->points.push_back(pt);
+      marker.points.push_back(pt);
     }
   }
-  marker_ptr->points.push_back(first_pt);
+  marker.points.push_back(first_pt);
 
   // Construct upper polygon
   first_pt.z += static_cast<double>(shape_msg.height);
   for (auto it = shape_msg.polygon.points.begin(); it != shape_msg.polygon.points.end(); ++it) {
     geometry_msgs::msg::Point pt = to_point(*it);
     pt.z += static_cast<double>(shape_msg.height);
-    marker_ptr->points.push_back(pt);
+    marker.points.push_back(pt);
     if (it != shape_msg.polygon.points.begin()) {
-      marker_ptr->points.push_back(pt);
+      marker.points.push_back(pt);
     }
   }
-  marker_ptr->points.push_back(first_pt);
+  marker.points.push_back(first_pt);
 
   // Construct connections between lower and upper polygon
   for (const auto & pt32 : shape_msg.polygon.points) {
     geometry_msgs::msg::Point pt = to_point(pt32);
-    marker_ptr->points.push_back(pt);
+    marker.points.push_back(pt);
     pt.z += static_cast<double>(shape_msg.height);
-    marker_ptr->points.push_back(pt);
+    marker.points.push_back(pt);
   }
-
-  return marker_ptr;
 }
 
 }  // namespace detail
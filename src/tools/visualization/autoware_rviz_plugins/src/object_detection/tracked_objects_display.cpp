@@ -27,22 +27,22 @@ namespace object_detection
 TrackedObjectsDisplay::TrackedObjectsDisplay()
 : ObjectPolygonDisplayBase("tracks") {}
 
-void TrackedObjectsDisplay::processMessage(TrackedObjects::ConstSharedPtr msg)
+void TrackedObjectsDisplay::render(
+  const TrackedObjects & msg,
+  const common::LevelOfDetail & lod)
 {
-  clear_markers();
-  int id = 0;
-  for (const auto & object : msg->objects) {
-    // Get marker for shape
-    auto shape_marker_ptr = get_marker_ptr(object.shape[0], object.classification);
-    shape_marker_ptr->header = msg->header;
-    shape_marker_ptr->id = id++;
-    add_marker(shape_marker_ptr);
+  for (const auto & object : msg.objects) {
+    const auto level = lod.at(object.kinematics.centroid_position);
+    add_to_polygon_batch(object.shape[0], object.classification, level);
 
-    // Get marker for id
-    auto id_marker_ptr = get_marker_ptr_for_track_id(object);
-    id_marker_ptr->header = msg->header;
-    id_marker_ptr->id = id++;
-    add_marker(id_marker_ptr);
+    // Get marker for id, keyed by the id of the track so that it is updated in place
+    if (level == common::DetailLevel::FULL) {
+      auto id_marker_ptr = get_marker_ptr_for_track_id(object);
+      id_marker_ptr->header = msg.header;
+      id_marker_ptr->ns = "track_id";
+      id_marker_ptr->id = static_cast<int32_t>(object.object_id & 0x7FFFFFFFU);
+      add_marker(id_marker_ptr);
+    }
 
     // TODO(gowtham.ranganathan): Add orientation marker once the discussion is over
   }
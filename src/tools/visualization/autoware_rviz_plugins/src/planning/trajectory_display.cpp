@@ -17,6 +17,8 @@
 #include <planning/trajectory_display.hpp>
 #include <common/types.hpp>
 
+#include <array>
+#include <cstdio>
 #include <memory>
 #include <string>
 
@@ -31,7 +33,8 @@ namespace rviz_plugins
 
 TrajectoryDisplay::TrajectoryDisplay()
 : rviz_common::RosTopicDisplay<autoware_auto_msgs::msg::Trajectory>(),
-  m_marker_common(std::make_unique<MarkerCommon>(this))
+  m_marker_common(std::make_unique<MarkerCommon>(this)),
+  m_rendering_properties(this)
 {
   color_property_ = new rviz_common::properties::ColorProperty(
     "Color", QColor(0, 255, 0), "Color to draw the arrow.",
@@ -75,6 +78,11 @@ void TrajectoryDisplay::load(const rviz_common::Config & config)
 
 void TrajectoryDisplay::update(float32_t wall_dt, float32_t ros_dt)
 {
+  if ((msg_cache != nullptr) &&
+    m_throttle.poll(wall_dt, m_rendering_properties.max_update_rate()))
+  {
+    render(*msg_cache);
+  }
   m_marker_common->update(wall_dt, ros_dt);
 }
 
@@ -82,36 +90,51 @@ void TrajectoryDisplay::reset()
 {
   RosTopicDisplay::reset();
   m_marker_common->clearMarkers();
+  m_marker_updater.clear();
+  msg_cache.reset();
+  m_throttle.reset();
 }
 
 void TrajectoryDisplay::updateProperty()
 {
-  if (msg_cache != nullptr) {
-    processMessage(msg_cache);
-  }
+  m_throttle.request();
 }
 
 void TrajectoryDisplay::processMessage(const Trajectory::ConstSharedPtr msg)
 {
   msg_cache = msg;
-  m_marker_common->clearMarkers();
-  auto count = 0;
-  const auto update = [&count, this, header = msg->header](auto marker) -> void {
-      marker->header = header;
-      marker->id = ++count;
-      m_marker_common->addMessage(marker);
+  m_throttle.request();
+}
+
+void TrajectoryDisplay::render(const Trajectory & msg)
+{
+  const auto lod = m_rendering_properties.level_of_detail(*context_, msg.header);
+  // The markers of a point keep their id from message to message, so that MarkerCommon updates
+  // their visuals in place instead of recreating them
+  const auto update = [this, &msg](auto marker, const std::size_t idx) -> void {
+      marker->header = msg.header;
+      marker->id = static_cast<int32_t>(idx);
+      m_marker_updater.add(*m_marker_common, marker);
     };
-  for (std::size_t idx = 0U; idx < msg->points.size(); ++idx) {
-    const auto & point = msg->points[idx];
+  for (std::size_t idx = 0U; idx < msg.points.size(); ++idx) {
+    const auto & point = msg.points[idx];
+    geometry_msgs::msg::Point position;
+    position.x = static_cast<float64_t>(point.x);
+    position.y = static_cast<float64_t>(point.y);
+    const auto level = lod.at(position);
+    if (level == common::DetailLevel::HIDDEN) {
+      continue;
+    }
     {
       const auto traj_marker = create_pose_marker(point);
-      update(traj_marker);
+      update(traj_marker, idx);
     }
-    {
+    if (level == common::DetailLevel::FULL) {
       const auto vel_marker = create_velocity_marker(point);
-      update(vel_marker);
+      update(vel_marker, idx);
     }
   }
+  m_marker_updater.finish(*m_marker_common, msg.header);
 }
 
 visualization_msgs::msg::Marker::SharedPtr TrajectoryDisplay::create_pose_marker(
@@ -162,7 +185,12 @@ visualization_msgs::msg::Marker::SharedPtr TrajectoryDisplay::create_velocity_ma
   marker->color.r = static_cast<float>(color.redF());
   marker->color.g = static_cast<float>(color.greenF());
   marker->color.b = static_cast<float>(color.blueF());
-  marker->text = std::to_string(point.longitudinal_velocity_mps) + "mps";
+  // Round the velocity, so that the text and its geometry only change with a visible difference
+  std::array<char, 32U> text{};
+  (void)std::snprintf(
+    text.data(), text.size(), "%.2fmps",
+    static_cast<float64_t>(point.longitudinal_velocity_mps));
+  marker->text = text.data();
 
   return marker;
 }